@@ -1,6 +1,13 @@
 #include "LLVMCompatibility.h"
 
 #include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/IR/LegacyPassManager.h>
+#include <llvm/Pass.h>
+#include <llvm/Support/Compression.h>
+#include <llvm/Transforms/Scalar.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+#include <llvm/Transforms/Utils/SplitModule.h>
 
 using namespace llvm;
 
@@ -31,9 +38,73 @@ std::unique_ptr<Module> parseBitcode(MemoryBufferRef bufferRef,
   return std::move(module.get());
 }
 
+std::unique_ptr<Module> parseLazyBitcode(MemoryBufferRef bufferRef,
+                                         LLVMContext &context) {
+  auto module = getLazyBitcodeModule(bufferRef, context);
+  if (!module) {
+    logAllUnhandledErrors(module.takeError(), errs(),
+                          "\ngetLazyBitcodeModule failed: ");
+    return std::unique_ptr<Module>();
+  }
+
+  return std::move(module.get());
+}
+
+bool materialize(GlobalValue &value) {
+  auto error = value.materialize();
+  if (error) {
+    logAllUnhandledErrors(std::move(error), errs(), "\nmaterialize failed: ");
+    return false;
+  }
+  return true;
+}
+
+bool materializeAll(Module &module) {
+  auto error = module.materializeAll();
+  if (error) {
+    logAllUnhandledErrors(std::move(error), errs(),
+                          "\nmaterializeAll failed: ");
+    return false;
+  }
+  return true;
+}
+
 void setVersionPrinter(void (*oldPrinter)(),
                        void (*newPrinter)(raw_ostream &)) {
   llvm::cl::SetVersionPrinter(oldPrinter);
 }
 
+bool compress(StringRef input, SmallVectorImpl<char> &output) {
+  return zlib::isAvailable() &&
+         zlib::compress(input, output) == zlib::StatusOK;
+}
+
+bool uncompress(StringRef input, SmallVectorImpl<char> &output,
+                size_t uncompressedSize) {
+  return zlib::isAvailable() &&
+         zlib::uncompress(input, output, uncompressedSize) == zlib::StatusOK;
+}
+
+void splitModule(const Module &module, unsigned partitions,
+                 function_ref<void(std::unique_ptr<Module>)> callback) {
+  bool preserveLocals = true;
+  SplitModule(CloneModule(&module), partitions, callback, preserveLocals);
+}
+
+void writeBitcode(const Module &module, raw_ostream &stream) {
+  WriteBitcodeToFile(&module, stream);
+}
+
+void canonicalizeFunction(Function &function) {
+  legacy::FunctionPassManager passes(function.getParent());
+  passes.add(createPromoteMemoryToRegisterPass());
+  passes.add(createEarlyCSEPass());
+  passes.add(createInstructionCombiningPass());
+  passes.add(createCFGSimplificationPass());
+  passes.add(createDeadCodeEliminationPass());
+  passes.doInitialization();
+  passes.run(function);
+  passes.doFinalization();
+}
+
 } // namespace llvm_compat
@@ -26,7 +26,28 @@ compileModule(orc::SimpleCompiler &compiler, llvm::Module &module);
 
 std::unique_ptr<Module> parseBitcode(MemoryBufferRef bufferRef,
                                      LLVMContext &context);
+/// Reads the declarations only, the function bodies are read on demand.
+/// The module refers to the buffer, which must outlive it.
+std::unique_ptr<Module> parseLazyBitcode(MemoryBufferRef bufferRef,
+                                         LLVMContext &context);
+/// Both return false if the bitcode of a body cannot be read
+bool materialize(GlobalValue &value);
+bool materializeAll(Module &module);
 
 void setVersionPrinter(void (*oldPrinter)(), void (*newPrinter)(raw_ostream &));
 
+/// Both return false when zlib is not available or the operation failed
+bool compress(StringRef input, SmallVectorImpl<char> &output);
+bool uncompress(StringRef input, SmallVectorImpl<char> &output,
+                size_t uncompressedSize);
+
+/// Splits a copy of the module into at most the given number of modules,
+/// the local symbols stay in the same module as their users
+void splitModule(const Module &module, unsigned partitions,
+                 function_ref<void(std::unique_ptr<Module>)> callback);
+void writeBitcode(const Module &module, raw_ostream &stream);
+/// Runs a few cheap function passes, so that code that differs only in
+/// details the optimizer removes ends up the same
+void canonicalizeFunction(Function &function);
+
 } // namespace llvm_compat
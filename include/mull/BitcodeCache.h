@@ -0,0 +1,47 @@
+#pragma once
+
+#include "mull/Config/ConfigurationOptions.h"
+
+#include <llvm/ADT/StringRef.h>
+#include <llvm/Support/MemoryBuffer.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mull {
+
+/// The bitcode files extracted from an executable along with their hashes,
+/// one file per executable under <cache>/bitcode/, named after the path of
+/// the executable. A cache is used as long as the size, the modification
+/// time and the inode of the executable did not change, or else as long as
+/// its content did not. The files of a cache point into the mapped cache,
+/// nothing is copied.
+class BitcodeCache {
+public:
+  /// nullptr unless the cache holds the bitcode of the executable as it is
+  /// now, hashed with the algorithm. `executable` is its content.
+  static std::unique_ptr<BitcodeCache>
+  load(const std::string &cacheDirectory, const std::string &executablePath,
+       llvm::StringRef executable, HashAlgorithm hashAlgorithm);
+
+  /// Replaces the cache of the executable, returns false if it cannot be
+  /// written. The hashes are the ones of the files, in the same order.
+  static bool store(const std::string &cacheDirectory,
+                    const std::string &executablePath,
+                    llvm::StringRef executable, HashAlgorithm hashAlgorithm,
+                    const std::vector<llvm::StringRef> &files,
+                    const std::vector<std::string> &hashes);
+
+  const std::vector<llvm::StringRef> &getFiles() const { return files; }
+  const std::vector<std::string> &getHashes() const { return hashes; }
+
+private:
+  explicit BitcodeCache(std::unique_ptr<llvm::MemoryBuffer> mapping);
+
+  std::unique_ptr<llvm::MemoryBuffer> mapping;
+  std::vector<llvm::StringRef> files;
+  std::vector<std::string> hashes;
+};
+
+} // namespace mull
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <llvm/ADT/STLExtras.h>
+
+#include <string>
+#include <system_error>
+
+namespace llvm {
+class raw_ostream;
+}
+
+namespace mull {
+
+/// Replaces the file of a cache with what `contents` writes. The file is
+/// written under a temporary name next to it and renamed once complete:
+/// several mull processes may share the cache directory, each reads either
+/// the old file or the new one.
+std::error_code
+writeCacheFile(const std::string &path,
+               llvm::function_ref<void(llvm::raw_ostream &)> contents);
+
+} // namespace mull
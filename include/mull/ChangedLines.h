@@ -0,0 +1,52 @@
+#pragma once
+
+#include <map>
+#include <set>
+#include <string>
+
+#include <llvm/ADT/StringRef.h>
+
+namespace mull {
+
+struct SourceLocation;
+
+/// The lines a change touched, per file. Either read from a unified diff,
+/// e.g. the output of `git diff`, or from a list with a file per line:
+/// `path`, `path:line` or `path:first-last`. A file listed without lines
+/// changed as a whole. The paths are usually relative to the root of the
+/// repository, a path matches the end of the full path of a source file.
+class ChangedLines {
+public:
+  struct FileChanges {
+    bool wholeFile;
+    std::set<int> lines;
+
+    FileChanges() : wholeFile(false) {}
+    bool contains(int line) const;
+  };
+
+  static ChangedLines parse(llvm::StringRef text);
+  /// False if the file cannot be read
+  static bool load(const std::string &path, ChangedLines &changes);
+
+  void addLine(const std::string &file, int line);
+  void addFile(const std::string &file);
+  bool empty() const;
+  /// The changes in the list format, the same changes give the same list
+  std::string toString() const;
+
+  /// The changes to the file at the full path, nullptr if it did not change
+  const FileChanges *changesOf(llvm::StringRef path) const;
+  /// Whether the file of the location changed at all
+  bool touches(const SourceLocation &location) const;
+  /// Whether the line of the location changed
+  bool contains(const SourceLocation &location) const;
+
+private:
+  std::map<std::string, FileChanges> files;
+
+  void parseDiff(llvm::StringRef text);
+  void parseList(llvm::StringRef text);
+};
+
+} // namespace mull
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "mull/ExecutionResult.h"
+
+#include <string>
+#include <unordered_map>
+
+namespace mull {
+
+class MutationPoint;
+
+/// The results an interrupted run streamed to its SQLite database before it
+/// died, so that the run resumes with the mutants that did not finish. The
+/// streamed rows only carry the unique identifiers of the mutation points,
+/// which the resumed run finds again as long as the bitcode is the same:
+/// the identifiers carry the hash of their module, so a different build
+/// resumes nothing.
+class Checkpoint {
+public:
+  /// The result of every test that ran against a mutant, by test identifier
+  typedef std::unordered_map<std::string, ExecutionResult> StoredResults;
+
+  /// False, with the reason, when the database cannot be read
+  bool load(const std::string &databasePath, std::string &error);
+
+  /// nullptr when the point has no results in the database
+  const StoredResults *find(MutationPoint &point) const;
+  size_t size() const;
+
+private:
+  std::unordered_map<std::string, StoredResults> mutants;
+};
+
+} // namespace mull
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "mull/Config/ConfigurationOptions.h"
+#include "mull/MemoryBudget.h"
+
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <sys/resource.h>
+#include <thread>
+
+namespace mull {
+
+/// Keeps a sandboxed child from taking down the machine or disturbing the
+/// timings of the other workers, see ChildResourcesConfig. The parent
+/// prepares the limits before every fork, on the thread that forks, and the
+/// child applies them right after it: the rlimits, and the cgroup of the
+/// worker that forked it, created on the first fork of the worker.
+///
+/// A child runs on the CPUs of its worker: the affinity of the thread that
+/// forks is inherited, so with ParallelizationConfig::pinWorkers every child
+/// is pinned to the core of its worker, and prefers the memory of its node,
+/// see ThreadPool::configure.
+class ChildResources {
+public:
+  /// What a child applies. Only async-signal-safe calls are made with it,
+  /// the child of a multi-threaded process may not allocate.
+  struct Limits {
+    /// RLIM_INFINITY means no limit
+    rlim_t addressSpace;
+    rlim_t cpuTime;
+    rlim_t openFiles;
+    /// cgroup.procs of the cgroup of the worker, nullptr means none
+    const char *cgroupProcs;
+    Limits();
+  };
+
+  explicit ChildResources(const ChildResourcesConfig &config);
+  /// Removes the cgroups of the workers, their children are gone by then
+  ~ChildResources();
+
+  /// The address space limit counts from what the child inherits from mull,
+  /// which is measured here
+  Limits prepare();
+  static void apply(const Limits &limits);
+
+  /// nullptr unless there is a memory budget, the sandboxes admit their
+  /// children under it
+  MemoryBudget *memoryBudget() const { return budget.get(); }
+
+private:
+  const char *cgroupOfThisWorker();
+  bool createCgroup(const std::string &path);
+
+  ChildResourcesConfig config;
+  std::mutex mutex;
+  std::map<std::thread::id, size_t> workers;
+  /// The paths of cgroup.procs, a deque so that they never move
+  std::deque<std::string> cgroupProcs;
+  std::deque<std::string> cgroups;
+  bool cgroupsWorking;
+  std::unique_ptr<MemoryBudget> budget;
+};
+
+} // namespace mull
@@ -44,6 +44,8 @@ template <> struct MappingTraits<mull::JunkDetectionConfig> {
     io.mapOptional("enabled", config.toggle);
     io.mapOptional("cxx_compdb_dir", config.cxxCompilationDatabasePath);
     io.mapOptional("cxx_compilation_flags", config.cxxCompilationFlags);
+    io.mapOptional("cxx_shared_pch", config.cxxSharedPrecompiledHeaders);
+    io.mapOptional("cxx_memory_limit", config.cxxMemoryLimit);
   }
 };
 
@@ -72,6 +74,9 @@ template <> struct ScalarEnumerationTraits<mull::RawConfig::Fork> {
     io.enumCase(fork, "enabled", mull::RawConfig::Fork::Enabled);
     io.enumCase(fork, "false", mull::RawConfig::Fork::Disabled);
     io.enumCase(fork, "disabled", mull::RawConfig::Fork::Disabled);
+    io.enumCase(fork, "server", mull::RawConfig::Fork::Server);
+    io.enumCase(fork, "batch", mull::RawConfig::Fork::Batch);
+    io.enumCase(fork, "snapshot", mull::RawConfig::Fork::Snapshot);
   }
 };
 
@@ -109,6 +114,323 @@ template <> struct ScalarEnumerationTraits<mull::RawConfig::EmitDebugInfo> {
   }
 };
 
+template <>
+struct ScalarEnumerationTraits<mull::RawConfig::DropPassedOutput> {
+  static void enumeration(IO &io, mull::RawConfig::DropPassedOutput &value) {
+    io.enumCase(value, "true", mull::RawConfig::DropPassedOutput::Yes);
+    io.enumCase(value, "yes", mull::RawConfig::DropPassedOutput::Yes);
+    io.enumCase(value, "false", mull::RawConfig::DropPassedOutput::No);
+    io.enumCase(value, "no", mull::RawConfig::DropPassedOutput::No);
+  }
+};
+
+template <> struct ScalarEnumerationTraits<mull::RawConfig::MutantSchemata> {
+  static void enumeration(IO &io, mull::RawConfig::MutantSchemata &value) {
+    io.enumCase(value, "true", mull::RawConfig::MutantSchemata::Enabled);
+    io.enumCase(value, "enabled", mull::RawConfig::MutantSchemata::Enabled);
+    io.enumCase(value, "false", mull::RawConfig::MutantSchemata::Disabled);
+    io.enumCase(value, "disabled", mull::RawConfig::MutantSchemata::Disabled);
+  }
+};
+
+template <>
+struct ScalarEnumerationTraits<mull::RawConfig::SplitMutatedFunctions> {
+  static void enumeration(IO &io,
+                          mull::RawConfig::SplitMutatedFunctions &value) {
+    io.enumCase(value, "true",
+                mull::RawConfig::SplitMutatedFunctions::Enabled);
+    io.enumCase(value, "enabled",
+                mull::RawConfig::SplitMutatedFunctions::Enabled);
+    io.enumCase(value, "false",
+                mull::RawConfig::SplitMutatedFunctions::Disabled);
+    io.enumCase(value, "disabled",
+                mull::RawConfig::SplitMutatedFunctions::Disabled);
+  }
+};
+
+template <>
+struct ScalarEnumerationTraits<mull::RawConfig::EquivalentMutantPruning> {
+  static void enumeration(IO &io,
+                          mull::RawConfig::EquivalentMutantPruning &value) {
+    io.enumCase(value, "true",
+                mull::RawConfig::EquivalentMutantPruning::Enabled);
+    io.enumCase(value, "enabled",
+                mull::RawConfig::EquivalentMutantPruning::Enabled);
+    io.enumCase(value, "false",
+                mull::RawConfig::EquivalentMutantPruning::Disabled);
+    io.enumCase(value, "disabled",
+                mull::RawConfig::EquivalentMutantPruning::Disabled);
+  }
+};
+
+template <> struct ScalarEnumerationTraits<mull::RawConfig::SharedProgram> {
+  static void enumeration(IO &io, mull::RawConfig::SharedProgram &value) {
+    io.enumCase(value, "true", mull::RawConfig::SharedProgram::Enabled);
+    io.enumCase(value, "enabled", mull::RawConfig::SharedProgram::Enabled);
+    io.enumCase(value, "false", mull::RawConfig::SharedProgram::Disabled);
+    io.enumCase(value, "disabled", mull::RawConfig::SharedProgram::Disabled);
+  }
+};
+
+template <> struct ScalarEnumerationTraits<mull::RawConfig::ParallelJIT> {
+  static void enumeration(IO &io, mull::RawConfig::ParallelJIT &value) {
+    io.enumCase(value, "true", mull::RawConfig::ParallelJIT::Enabled);
+    io.enumCase(value, "enabled", mull::RawConfig::ParallelJIT::Enabled);
+    io.enumCase(value, "false", mull::RawConfig::ParallelJIT::Disabled);
+    io.enumCase(value, "disabled", mull::RawConfig::ParallelJIT::Disabled);
+  }
+};
+
+template <> struct ScalarEnumerationTraits<mull::RawConfig::LazyJIT> {
+  static void enumeration(IO &io, mull::RawConfig::LazyJIT &value) {
+    io.enumCase(value, "true", mull::RawConfig::LazyJIT::Enabled);
+    io.enumCase(value, "enabled", mull::RawConfig::LazyJIT::Enabled);
+    io.enumCase(value, "false", mull::RawConfig::LazyJIT::Disabled);
+    io.enumCase(value, "disabled", mull::RawConfig::LazyJIT::Disabled);
+  }
+};
+
+template <>
+struct ScalarEnumerationTraits<mull::RawConfig::DeferMutantCloning> {
+  static void enumeration(IO &io, mull::RawConfig::DeferMutantCloning &value) {
+    io.enumCase(value, "true", mull::RawConfig::DeferMutantCloning::Enabled);
+    io.enumCase(value, "enabled", mull::RawConfig::DeferMutantCloning::Enabled);
+    io.enumCase(value, "false", mull::RawConfig::DeferMutantCloning::Disabled);
+    io.enumCase(value, "disabled",
+                mull::RawConfig::DeferMutantCloning::Disabled);
+  }
+};
+
+template <>
+struct ScalarEnumerationTraits<mull::RawConfig::LazyBitcodeLoading> {
+  static void enumeration(IO &io, mull::RawConfig::LazyBitcodeLoading &value) {
+    io.enumCase(value, "true", mull::RawConfig::LazyBitcodeLoading::Enabled);
+    io.enumCase(value, "enabled", mull::RawConfig::LazyBitcodeLoading::Enabled);
+    io.enumCase(value, "false", mull::RawConfig::LazyBitcodeLoading::Disabled);
+    io.enumCase(value, "disabled",
+                mull::RawConfig::LazyBitcodeLoading::Disabled);
+  }
+};
+
+template <>
+struct ScalarEnumerationTraits<mull::RawConfig::InlineInstrumentation> {
+  static void enumeration(IO &io,
+                          mull::RawConfig::InlineInstrumentation &value) {
+    io.enumCase(value, "true", mull::RawConfig::InlineInstrumentation::Enabled);
+    io.enumCase(value, "enabled",
+                mull::RawConfig::InlineInstrumentation::Enabled);
+    io.enumCase(value, "false",
+                mull::RawConfig::InlineInstrumentation::Disabled);
+    io.enumCase(value, "disabled",
+                mull::RawConfig::InlineInstrumentation::Disabled);
+  }
+};
+
+template <>
+struct ScalarEnumerationTraits<mull::RawConfig::CoverageInstrumentation> {
+  static void enumeration(IO &io,
+                          mull::RawConfig::CoverageInstrumentation &value) {
+    io.enumCase(value, "true",
+                mull::RawConfig::CoverageInstrumentation::Enabled);
+    io.enumCase(value, "enabled",
+                mull::RawConfig::CoverageInstrumentation::Enabled);
+    io.enumCase(value, "false",
+                mull::RawConfig::CoverageInstrumentation::Disabled);
+    io.enumCase(value, "disabled",
+                mull::RawConfig::CoverageInstrumentation::Disabled);
+  }
+};
+
+template <>
+struct ScalarEnumerationTraits<mull::RawConfig::GuardedInstrumentation> {
+  static void enumeration(IO &io,
+                          mull::RawConfig::GuardedInstrumentation &value) {
+    io.enumCase(value, "true",
+                mull::RawConfig::GuardedInstrumentation::Enabled);
+    io.enumCase(value, "enabled",
+                mull::RawConfig::GuardedInstrumentation::Enabled);
+    io.enumCase(value, "false",
+                mull::RawConfig::GuardedInstrumentation::Disabled);
+    io.enumCase(value, "disabled",
+                mull::RawConfig::GuardedInstrumentation::Disabled);
+  }
+};
+
+template <>
+struct ScalarEnumerationTraits<mull::RawConfig::ConstructorTemplate> {
+  static void enumeration(IO &io, mull::RawConfig::ConstructorTemplate &value) {
+    io.enumCase(value, "true", mull::RawConfig::ConstructorTemplate::Enabled);
+    io.enumCase(value, "enabled",
+                mull::RawConfig::ConstructorTemplate::Enabled);
+    io.enumCase(value, "false",
+                mull::RawConfig::ConstructorTemplate::Disabled);
+    io.enumCase(value, "disabled",
+                mull::RawConfig::ConstructorTemplate::Disabled);
+  }
+};
+
+template <> struct ScalarEnumerationTraits<mull::RawConfig::DirectTestRun> {
+  static void enumeration(IO &io, mull::RawConfig::DirectTestRun &value) {
+    io.enumCase(value, "true", mull::RawConfig::DirectTestRun::Enabled);
+    io.enumCase(value, "enabled", mull::RawConfig::DirectTestRun::Enabled);
+    io.enumCase(value, "false", mull::RawConfig::DirectTestRun::Disabled);
+    io.enumCase(value, "disabled", mull::RawConfig::DirectTestRun::Disabled);
+  }
+};
+
+template <> struct ScalarEnumerationTraits<mull::RawConfig::ReleaseIR> {
+  static void enumeration(IO &io, mull::RawConfig::ReleaseIR &value) {
+    io.enumCase(value, "true", mull::RawConfig::ReleaseIR::Enabled);
+    io.enumCase(value, "enabled", mull::RawConfig::ReleaseIR::Enabled);
+    io.enumCase(value, "false", mull::RawConfig::ReleaseIR::Disabled);
+    io.enumCase(value, "disabled", mull::RawConfig::ReleaseIR::Disabled);
+  }
+};
+
+template <> struct ScalarEnumerationTraits<mull::RawConfig::JITHugePages> {
+  static void enumeration(IO &io, mull::RawConfig::JITHugePages &value) {
+    io.enumCase(value, "true", mull::RawConfig::JITHugePages::Enabled);
+    io.enumCase(value, "enabled", mull::RawConfig::JITHugePages::Enabled);
+    io.enumCase(value, "false", mull::RawConfig::JITHugePages::Disabled);
+    io.enumCase(value, "disabled", mull::RawConfig::JITHugePages::Disabled);
+  }
+};
+
+template <> struct ScalarEnumerationTraits<mull::RawConfig::BlockCoverage> {
+  static void enumeration(IO &io, mull::RawConfig::BlockCoverage &value) {
+    io.enumCase(value, "true", mull::RawConfig::BlockCoverage::Enabled);
+    io.enumCase(value, "enabled", mull::RawConfig::BlockCoverage::Enabled);
+    io.enumCase(value, "false", mull::RawConfig::BlockCoverage::Disabled);
+    io.enumCase(value, "disabled", mull::RawConfig::BlockCoverage::Disabled);
+  }
+};
+
+template <>
+struct ScalarEnumerationTraits<mull::RawConfig::BoundedCallTree> {
+  static void enumeration(IO &io, mull::RawConfig::BoundedCallTree &value) {
+    io.enumCase(value, "true", mull::RawConfig::BoundedCallTree::Enabled);
+    io.enumCase(value, "enabled", mull::RawConfig::BoundedCallTree::Enabled);
+    io.enumCase(value, "false", mull::RawConfig::BoundedCallTree::Disabled);
+    io.enumCase(value, "disabled",
+                mull::RawConfig::BoundedCallTree::Disabled);
+  }
+};
+
+template <> struct ScalarEnumerationTraits<mull::RawConfig::PerfCounters> {
+  static void enumeration(IO &io, mull::RawConfig::PerfCounters &value) {
+    io.enumCase(value, "true", mull::RawConfig::PerfCounters::Enabled);
+    io.enumCase(value, "enabled", mull::RawConfig::PerfCounters::Enabled);
+    io.enumCase(value, "false", mull::RawConfig::PerfCounters::Disabled);
+    io.enumCase(value, "disabled", mull::RawConfig::PerfCounters::Disabled);
+  }
+};
+
+template <> struct ScalarEnumerationTraits<mull::RawConfig::DirectCalls> {
+  static void enumeration(IO &io, mull::RawConfig::DirectCalls &value) {
+    io.enumCase(value, "true", mull::RawConfig::DirectCalls::Enabled);
+    io.enumCase(value, "enabled", mull::RawConfig::DirectCalls::Enabled);
+    io.enumCase(value, "false", mull::RawConfig::DirectCalls::Disabled);
+    io.enumCase(value, "disabled", mull::RawConfig::DirectCalls::Disabled);
+  }
+};
+
+template <> struct ScalarEnumerationTraits<mull::RawConfig::StopOnSurvivor> {
+  static void enumeration(IO &io, mull::RawConfig::StopOnSurvivor &value) {
+    io.enumCase(value, "true", mull::RawConfig::StopOnSurvivor::Enabled);
+    io.enumCase(value, "enabled", mull::RawConfig::StopOnSurvivor::Enabled);
+    io.enumCase(value, "false", mull::RawConfig::StopOnSurvivor::Disabled);
+    io.enumCase(value, "disabled",
+                mull::RawConfig::StopOnSurvivor::Disabled);
+  }
+};
+
+template <>
+struct ScalarEnumerationTraits<mull::RawConfig::StaticReachability> {
+  static void enumeration(IO &io,
+                          mull::RawConfig::StaticReachability &value) {
+    io.enumCase(value, "true", mull::RawConfig::StaticReachability::Enabled);
+    io.enumCase(value, "enabled",
+                mull::RawConfig::StaticReachability::Enabled);
+    io.enumCase(value, "false",
+                mull::RawConfig::StaticReachability::Disabled);
+    io.enumCase(value, "disabled",
+                mull::RawConfig::StaticReachability::Disabled);
+  }
+};
+
+template <>
+struct ScalarEnumerationTraits<mull::RawConfig::CacheCompression> {
+  static void enumeration(IO &io, mull::RawConfig::CacheCompression &value) {
+    io.enumCase(value, "true", mull::RawConfig::CacheCompression::Enabled);
+    io.enumCase(value, "enabled", mull::RawConfig::CacheCompression::Enabled);
+    io.enumCase(value, "false", mull::RawConfig::CacheCompression::Disabled);
+    io.enumCase(value, "disabled",
+                mull::RawConfig::CacheCompression::Disabled);
+  }
+};
+
+template <>
+struct ScalarEnumerationTraits<mull::RawConfig::MutationSearchCache> {
+  static void enumeration(IO &io, mull::RawConfig::MutationSearchCache &value) {
+    io.enumCase(value, "true", mull::RawConfig::MutationSearchCache::Enabled);
+    io.enumCase(value, "enabled",
+                mull::RawConfig::MutationSearchCache::Enabled);
+    io.enumCase(value, "false",
+                mull::RawConfig::MutationSearchCache::Disabled);
+    io.enumCase(value, "disabled",
+                mull::RawConfig::MutationSearchCache::Disabled);
+  }
+};
+
+template <> struct ScalarEnumerationTraits<mull::RawConfig::TestSearchCache> {
+  static void enumeration(IO &io, mull::RawConfig::TestSearchCache &value) {
+    io.enumCase(value, "true", mull::RawConfig::TestSearchCache::Enabled);
+    io.enumCase(value, "enabled", mull::RawConfig::TestSearchCache::Enabled);
+    io.enumCase(value, "false", mull::RawConfig::TestSearchCache::Disabled);
+    io.enumCase(value, "disabled",
+                mull::RawConfig::TestSearchCache::Disabled);
+  }
+};
+
+template <>
+struct ScalarEnumerationTraits<mull::RawConfig::ReachabilityCache> {
+  static void enumeration(IO &io, mull::RawConfig::ReachabilityCache &value) {
+    io.enumCase(value, "true", mull::RawConfig::ReachabilityCache::Enabled);
+    io.enumCase(value, "enabled", mull::RawConfig::ReachabilityCache::Enabled);
+    io.enumCase(value, "false", mull::RawConfig::ReachabilityCache::Disabled);
+    io.enumCase(value, "disabled",
+                mull::RawConfig::ReachabilityCache::Disabled);
+  }
+};
+
+template <> struct ScalarEnumerationTraits<mull::RawConfig::ProgramLibrary> {
+  static void enumeration(IO &io, mull::RawConfig::ProgramLibrary &value) {
+    io.enumCase(value, "true", mull::RawConfig::ProgramLibrary::Enabled);
+    io.enumCase(value, "enabled", mull::RawConfig::ProgramLibrary::Enabled);
+    io.enumCase(value, "false", mull::RawConfig::ProgramLibrary::Disabled);
+    io.enumCase(value, "disabled", mull::RawConfig::ProgramLibrary::Disabled);
+  }
+};
+
+template <> struct ScalarEnumerationTraits<mull::RawConfig::CachePopulate> {
+  static void enumeration(IO &io, mull::RawConfig::CachePopulate &value) {
+    io.enumCase(value, "true", mull::RawConfig::CachePopulate::Enabled);
+    io.enumCase(value, "enabled", mull::RawConfig::CachePopulate::Enabled);
+    io.enumCase(value, "false", mull::RawConfig::CachePopulate::Disabled);
+    io.enumCase(value, "disabled", mull::RawConfig::CachePopulate::Disabled);
+  }
+};
+
+template <> struct ScalarEnumerationTraits<mull::OutputRetention> {
+  static void enumeration(IO &io, mull::OutputRetention &value) {
+    io.enumCase(value, "full", mull::OutputRetention::Full);
+    io.enumCase(value, "none", mull::OutputRetention::None);
+    io.enumCase(value, "tail", mull::OutputRetention::Tail);
+    io.enumCase(value, "killed", mull::OutputRetention::Killed);
+    io.enumCase(value, "compressed", mull::OutputRetention::Compressed);
+  }
+};
+
 template <> struct ScalarEnumerationTraits<mull::Diagnostics> {
   static void enumeration(IO &io, mull::Diagnostics &value) {
     io.enumCase(value, "none", mull::Diagnostics::None);
@@ -118,11 +440,120 @@ template <> struct ScalarEnumerationTraits<mull::Diagnostics> {
   }
 };
 
+template <> struct ScalarEnumerationTraits<mull::HashAlgorithm> {
+  static void enumeration(IO &io, mull::HashAlgorithm &value) {
+    io.enumCase(value, "md5", mull::HashAlgorithm::MD5);
+    io.enumCase(value, "xxhash64", mull::HashAlgorithm::XXHash64);
+  }
+};
+
+template <> struct ScalarEnumerationTraits<mull::MutantDebugInfo> {
+  static void enumeration(IO &io, mull::MutantDebugInfo &value) {
+    io.enumCase(value, "full", mull::MutantDebugInfo::Full);
+    io.enumCase(value, "line_tables", mull::MutantDebugInfo::LineTables);
+    io.enumCase(value, "none", mull::MutantDebugInfo::None);
+  }
+};
+
 template <> struct MappingTraits<mull::ParallelizationConfig> {
   static void mapping(IO &io, mull::ParallelizationConfig &config) {
     io.mapOptional("workers", config.workers);
     io.mapOptional("test_execution_workers", config.testExecutionWorkers);
     io.mapOptional("mutant_execution_workers", config.mutantExecutionWorkers);
+    io.mapOptional("children_per_worker", config.childrenPerWorker);
+    io.mapOptional("pin_workers", config.pinWorkers);
+    io.mapOptional("auto_tune", config.autoTune);
+    io.mapOptional("worker_processes", config.workerProcesses);
+    io.mapOptional("junk_detection_processes", config.junkDetectionProcesses);
+  }
+};
+
+template <> struct MappingTraits<mull::TimeoutPolicyConfig> {
+  static void mapping(IO &io, mull::TimeoutPolicyConfig &config) {
+    io.mapOptional("runs", config.runs);
+    io.mapOptional("deviations", config.deviations);
+    io.mapOptional("multiplier", config.multiplier);
+    io.mapOptional("floor", config.floor);
+    io.mapOptional("ceiling", config.ceiling);
+  }
+};
+
+template <> struct ScalarEnumerationTraits<mull::SamplingStrategy> {
+  static void enumeration(IO &io, mull::SamplingStrategy &value) {
+    io.enumCase(value, "none", mull::SamplingStrategy::None);
+    io.enumCase(value, "uniform", mull::SamplingStrategy::Uniform);
+    io.enumCase(value, "per_mutator", mull::SamplingStrategy::PerMutator);
+    io.enumCase(value, "per_file", mull::SamplingStrategy::PerFile);
+    io.enumCase(value, "per_function", mull::SamplingStrategy::PerFunction);
+    io.enumCase(value, "time_budget", mull::SamplingStrategy::TimeBudget);
+  }
+};
+
+template <> struct ScalarEnumerationTraits<mull::TestOrder> {
+  static void enumeration(IO &io, mull::TestOrder &value) {
+    io.enumCase(value, "discovery", mull::TestOrder::Discovery);
+    io.enumCase(value, "distance", mull::TestOrder::Distance);
+    io.enumCase(value, "runtime", mull::TestOrder::Runtime);
+    io.enumCase(value, "kill_rate", mull::TestOrder::KillRate);
+  }
+};
+
+template <> struct ScalarEnumerationTraits<mull::MutantOrder> {
+  static void enumeration(IO &io, mull::MutantOrder &value) {
+    io.enumCase(value, "longest_first", mull::MutantOrder::LongestFirst);
+    io.enumCase(value, "feedback", mull::MutantOrder::Feedback);
+  }
+};
+
+template <> struct ScalarEnumerationTraits<mull::DistributedRole> {
+  static void enumeration(IO &io, mull::DistributedRole &value) {
+    io.enumCase(value, "none", mull::DistributedRole::None);
+    io.enumCase(value, "coordinator", mull::DistributedRole::Coordinator);
+    io.enumCase(value, "worker", mull::DistributedRole::Worker);
+  }
+};
+
+template <> struct MappingTraits<mull::DistributedConfig> {
+  static void mapping(IO &io, mull::DistributedConfig &config) {
+    io.mapOptional("role", config.role);
+    io.mapOptional("directory", config.directory);
+    io.mapOptional("chunk", config.chunk);
+    io.mapOptional("lease", config.lease);
+  }
+};
+
+template <> struct MappingTraits<mull::ChildResourcesConfig> {
+  static void mapping(IO &io, mull::ChildResourcesConfig &config) {
+    io.mapOptional("address_space", config.addressSpace);
+    io.mapOptional("cpu_time", config.cpuTime);
+    io.mapOptional("open_files", config.openFiles);
+    io.mapOptional("cgroup_root", config.cgroupRoot);
+    io.mapOptional("cgroup_memory", config.cgroupMemory);
+    io.mapOptional("cgroup_cpu", config.cgroupCPU);
+    io.mapOptional("memory_budget", config.memoryBudget);
+  }
+};
+
+template <> struct MappingTraits<mull::HeapConfig> {
+  static void mapping(IO &io, mull::HeapConfig &config) {
+    io.mapOptional("arenas", config.arenas);
+    io.mapOptional("trim", config.trim);
+  }
+};
+
+template <> struct MappingTraits<mull::ShardConfig> {
+  static void mapping(IO &io, mull::ShardConfig &config) {
+    io.mapOptional("index", config.index);
+    io.mapOptional("count", config.count);
+  }
+};
+
+template <> struct MappingTraits<mull::SamplingConfig> {
+  static void mapping(IO &io, mull::SamplingConfig &config) {
+    io.mapOptional("strategy", config.strategy);
+    io.mapOptional("size", config.size);
+    io.mapOptional("seed", config.seed);
+    io.mapOptional("budget", config.budget);
   }
 };
 
@@ -145,8 +576,73 @@ template <> struct MappingTraits<mull::RawConfig> {
     io.mapOptional("emit_debug_info", config.emitDebugInfo);
     io.mapOptional("diagnostics", config.diagnostics);
     io.mapOptional("timeout", config.timeout);
+    io.mapOptional("timeout_policy", config.timeoutPolicy);
+    io.mapOptional("sampling", config.sampling);
+    io.mapOptional("shard", config.shard);
+    io.mapOptional("test_order", config.testOrder);
+    io.mapOptional("mutant_order", config.mutantOrder);
+    io.mapOptional("batch_kill_size", config.batchKillSize);
+    io.mapOptional("original_test_batch_size", config.originalTestBatchSize);
+    io.mapOptional("loop_budget", config.loopBudget);
+    io.mapOptional("stall_timeout", config.stallTimeout);
+    io.mapOptional("flaky_runs", config.flakyRuns);
+    io.mapOptional("distributed", config.distributed);
+    io.mapOptional("child_resources", config.childResources);
+    io.mapOptional("heap", config.heap);
+    io.mapOptional("result_memory_budget", config.resultMemoryBudget);
     io.mapOptional("max_distance", config.maxDistance);
     io.mapOptional("cache_directory", config.cacheDirectory);
+    io.mapOptional("cache_compression", config.cacheCompression);
+    io.mapOptional("cache_size_limit", config.cacheSizeLimit);
+    io.mapOptional("cache_populate", config.cachePopulate);
+    io.mapOptional("reachability_cache", config.reachabilityCache);
+    io.mapOptional("program_library", config.programLibrary);
+    io.mapOptional("mutation_search_cache", config.mutationSearchCache);
+    io.mapOptional("test_search_cache", config.testSearchCache);
+    io.mapOptional("cache_remote_url", config.cacheRemoteURL);
+    io.mapOptional("changed_lines", config.changedLines);
+    io.mapOptional("previous_results", config.previousResults);
+    io.mapOptional("resume", config.resume);
+    io.mapOptional("kill_matrix", config.killMatrix);
+    io.mapOptional("minimized_tests", config.minimizedTests);
+    io.mapOptional("metrics_endpoint", config.metricsEndpoint);
+    io.mapOptional("hash_algorithm", config.hashAlgorithm);
+    io.mapOptional("codegen_opt_level", config.codegenOptLevel);
+    io.mapOptional("mutant_debug_info", config.mutantDebugInfo);
+    io.mapOptional("parallel_codegen_threshold",
+                   config.parallelCodegenThreshold);
+    io.mapOptional("json_flush_interval", config.jsonFlushInterval);
+    io.mapOptional("sqlite_writers", config.sqliteWriters);
+    io.mapOptional("deadline", config.deadline);
+    io.mapOptional("reachability_sample_period",
+                   config.reachabilitySamplePeriod);
+    io.mapOptional("output_limit", config.outputLimit);
+    io.mapOptional("drop_passed_output", config.dropPassedOutput);
+    io.mapOptional("output_retention", config.outputRetention);
+    io.mapOptional("output_tail", config.outputTail);
+    io.mapOptional("mutant_schemata", config.mutantSchemata);
+    io.mapOptional("split_mutated_functions", config.splitMutatedFunctions);
+    io.mapOptional("equivalent_mutant_pruning",
+                   config.equivalentMutantPruning);
+    io.mapOptional("shared_program", config.sharedProgram);
+    io.mapOptional("lazy_jit", config.lazyJIT);
+    io.mapOptional("parallel_jit", config.parallelJIT);
+    io.mapOptional("defer_mutant_cloning", config.deferMutantCloning);
+    io.mapOptional("lazy_bitcode_loading", config.lazyBitcodeLoading);
+    io.mapOptional("inline_instrumentation", config.inlineInstrumentation);
+    io.mapOptional("coverage_instrumentation", config.coverageInstrumentation);
+    io.mapOptional("guarded_instrumentation", config.guardedInstrumentation);
+    io.mapOptional("constructor_template", config.constructorTemplate);
+    io.mapOptional("fresh_globals_tests", config.freshGlobalsTests);
+    io.mapOptional("direct_test_run", config.directTestRun);
+    io.mapOptional("release_ir", config.releaseIR);
+    io.mapOptional("jit_huge_pages", config.jitHugePages);
+    io.mapOptional("block_coverage", config.blockCoverage);
+    io.mapOptional("bounded_call_tree", config.boundedCallTree);
+    io.mapOptional("perf_counters", config.perfCounters);
+    io.mapOptional("direct_calls", config.directCalls);
+    io.mapOptional("stop_on_survivor", config.stopOnSurvivor);
+    io.mapOptional("static_reachability", config.staticReachability);
     io.mapOptional("junk_detection", config.junkDetection);
     io.mapOptional("parallelization", config.parallelizationConfig);
   }
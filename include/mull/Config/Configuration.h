@@ -11,14 +11,123 @@ class RawConfig;
 
 struct Configuration {
   bool forkEnabled;
+  bool forkServerEnabled;
+  /// All the tests of a mutant run in one child, see BatchProcessSandbox
+  bool forkBatchEnabled;
+  /// The tests of a mutant share a child whose globals are restored after
+  /// each of them, see SnapshotProcessSandbox
+  bool forkSnapshotEnabled;
   bool junkDetectionEnabled;
   bool dryRunEnabled;
   bool failFastEnabled;
   bool cacheEnabled;
+  bool mutantSchemataEnabled;
+  bool splitMutatedFunctionsEnabled;
+  /// Skips the mutants canonicalized the same as their original function,
+  /// and runs the duplicate mutants of a function once,
+  /// see MullModule::hashMutations
+  bool equivalentMutantPruningEnabled;
+  bool sharedProgramEnabled;
+  bool lazyJITEnabled;
+  /// Links the original program and the shared mutated program on several
+  /// threads, see JITLinking::Parallel
+  bool parallelJITEnabled;
+  bool deferMutantCloningEnabled;
+  /// Reads the bodies of the functions only when they are needed
+  bool lazyBitcodeLoadingEnabled;
+  bool inlineInstrumentationEnabled;
+  bool coverageInstrumentationEnabled;
+  /// The instrumentation is skipped at run time unless a test is being run
+  /// for its call tree, so that the mutants reuse the instrumented objects
+  /// of the modules they do not mutate instead of compiling them again
+  bool guardedInstrumentationEnabled;
+  /// The static constructors run once per mutant, in the fork server or the
+  /// batch child, instead of before every test
+  bool constructorTemplateEnabled;
+  /// The names of the tests that run on the globals as the program was
+  /// loaded, with the constructors run again, rather than on the globals the
+  /// constructor template left
+  std::vector<std::string> freshGlobalsTests;
+  /// GoogleTest is initialized once, with the static constructors, and the
+  /// tests run through the UnitTest instead of main, see GoogleTestRunner
+  bool directTestRunEnabled;
+  /// The IR is freed once the mutants are compiled, what the reports need
+  /// is kept aside, see Program::releaseIR
+  bool releaseIREnabled;
+  /// The JIT maps its slabs on huge pages, see SlabMemoryManager
+  bool jitHugePagesEnabled;
+  /// The original run of a test also records the basic blocks it executed,
+  /// a mutant only runs the tests that executed its block
+  bool blockCoverageEnabled;
+  /// The instrumentation stops recording the calls past maxDistance from the
+  /// test body, see InstrumentationInfo::maxDistance
+  bool boundedCallTreeEnabled;
+  /// The forked runs count the hardware events of their tests, see
+  /// PerfCounters
+  bool perfCountersEnabled;
+  /// The forked runs jump straight into the mutated functions rather than
+  /// through their trampolines, see EntryPatch
+  bool directCallsEnabled;
+  /// Gate mode: the run stops as soon as a mutant survives, see Cancellation
+  bool stopOnSurvivorEnabled;
+  /// The testees come from the static call graph of the IR instead of the
+  /// calls the original tests make, see StaticCallGraph
+  bool staticReachabilityEnabled;
 
   int timeout;
+  /// Seconds the run may take, zero means no limit. The mutants that did
+  /// not run by then are left out of the results.
+  int deadline;
+  /// The original tests run without recording their calls and are sampled
+  /// every this many cycles instead, see SampledReachability. Zero when
+  /// they are not sampled.
+  int reachabilitySamplePeriod;
+  /// The timeouts of the tests of the mutants, see TimeoutPolicy
+  TimeoutPolicyConfig timeoutPolicy;
+  /// The mutants that run, see MutantSampler
+  SamplingConfig sampling;
+  /// The slice of the mutants this run takes, see shardMutants
+  ShardConfig shard;
+  /// The order the tests of a mutant run in, see prioritizeReachableTests
+  TestOrder testOrder;
+  /// The order the mutants run in, see MutantOrder
+  MutantOrder mutantOrder;
+  /// Mutants of different functions that run together first, see
+  /// MutantBatchExecutionTask. Zero or one runs every mutant on its own.
+  int batchKillSize;
+  /// Up to this many original tests run one after another in one child, see
+  /// OriginalTestExecutionTask. Zero or one forks a child per test.
+  int originalTestBatchSize;
+  /// A mutant run of a test exits once its mutated functions took this many
+  /// times the back edges the original run of the test took, see
+  /// injectLoopBudget. Zero leaves the loops to the timeout.
+  int loopBudget;
+  /// Milliseconds after which a forked test that neither runs nor does I/O
+  /// is killed as timed out, see ForkProcessSandbox. Zero leaves it to the
+  /// timeout.
+  int stallTimeout;
+  /// Every original test that passed runs this many more times at once, a
+  /// test whose runs disagree is flaky and reaches no mutant. The running
+  /// times feed the timeout policy. Zero runs every test once.
+  int flakyRuns;
+  /// The nodes of a run shared through a directory, see DistributedQueue
+  DistributedConfig distributed;
+  /// What each sandboxed child may use, see ChildResources
+  ChildResourcesConfig childResources;
+  /// How malloc holds the memory of mull, see Heap.h
+  HeapConfig heap;
+  /// Megabytes the results of the mutants may take in memory, past which
+  /// they go to segment files, see setResultMemoryBudget. Zero keeps them
+  /// all in memory.
+  int resultMemoryBudget;
   int maxDistance;
 
+  /// Bytes kept from each of stdout and stderr of a sandboxed run
+  int outputLimit;
+  bool dropPassedOutput;
+  OutputRetention outputRetention;
+  int outputTailBytes;
+
   Diagnostics diagnostics;
 
   std::vector<std::string> bitcodePaths;
@@ -26,6 +135,55 @@ struct Configuration {
   std::vector<std::string> dynamicLibraryPaths;
 
   std::string cacheDirectory;
+  bool cacheCompressionEnabled;
+  /// Megabytes the object cache may take on disk, 0 means no limit
+  int cacheSizeLimit;
+  bool cachePopulateEnabled;
+  /// Reuses the calls of the original tests whose functions did not change,
+  /// see ReachabilityCache
+  bool reachabilityCacheEnabled;
+  /// Links the instrumented program into a shared library kept in the
+  /// cache and loads it on the later runs, see ProgramLibrary
+  bool programLibraryEnabled;
+  /// Reuses the mutation points of the functions of unchanged modules, see
+  /// MutationSearchCache
+  bool mutationSearchCacheEnabled;
+  /// Reuses the tests the finders found in unchanged modules, see
+  /// TestSearchCache
+  bool testSearchCacheEnabled;
+  /// http:// URL of a cache shared between machines, empty means none
+  std::string cacheRemoteURL;
+
+  /// A diff or a list of the changed lines, see ChangedLines. Only the
+  /// mutants on the lines are searched for, unless there are previous results.
+  std::string changedLinesPath;
+  /// The database of a previous run: only the mutants that changed since run
+  /// again, the results of the others are taken from the database
+  std::string previousResultsPath;
+  /// The database the SQLite reporter streamed to during an interrupted run:
+  /// the mutants it completed take their results from it, see Checkpoint
+  std::string resumePath;
+  /// Every mutant runs every test that reaches it, the status of each pair
+  /// goes to a KillMatrix mapped from this file
+  std::string killMatrixPath;
+  /// The smallest set of tests found that kills the mutants the kill matrix
+  /// has killed goes to this file, see minimizeTestSuite
+  std::string minimizedTestsPath;
+  /// "host:port" the live metrics are served at, empty means none, see
+  /// MetricsServer
+  std::string metricsEndpoint;
+  HashAlgorithm hashAlgorithm;
+
+  /// Code generation level, 0 to 3 as the -O of llc. 0 selects instructions
+  /// with FastISel, which suits mutants that only run briefly. The cached
+  /// objects are reused whatever level they were compiled at.
+  int codegenOptLevel;
+  /// What the mutated modules keep of their debug info, see MutantDebugInfo.
+  /// The objects are cached whatever they kept.
+  MutantDebugInfo mutantDebugInfo;
+  /// Megabytes of bitcode above which a module is split and its parts are
+  /// compiled on all the workers, 0 means never
+  int parallelCodegenThreshold;
 
   ParallelizationConfig parallelization;
   std::vector<CustomTestDefinition> customTests;
@@ -9,15 +9,195 @@ enum class Diagnostics { None, Survived, Killed, All };
 
 std::string diagnosticsToString(Diagnostics diagnostics);
 
+/// What is kept from stdout/stderr of every execution result:
+/// - Full: everything
+/// - None: nothing
+/// - Tail: only the last N bytes
+/// - Killed: everything, but only for the runs that did not pass
+/// - Compressed: everything, compressed with zlib
+enum class OutputRetention { Full, None, Tail, Killed, Compressed };
+
+std::string outputRetentionToString(OutputRetention retention);
+
+/// How the bitcode and the mutation points are hashed into the cache keys:
+/// - MD5: the default, keeps the keys of the existing caches
+/// - XXHash64: several times faster on large bitcode files
+enum class HashAlgorithm { MD5, XXHash64 };
+
+std::string hashAlgorithmToString(HashAlgorithm algorithm);
+
+/// What the mutated modules keep of their debug info when they are compiled.
+/// Nothing reads the DWARF of the mutants, their locations were taken when
+/// the mutation points were found:
+/// - Full: all of it, as in the bitcode
+/// - LineTables: only the line tables, for the backtraces of the crashes
+/// - None: nothing, the mutants compile the fastest
+enum class MutantDebugInfo { Full, LineTables, None };
+
+std::string mutantDebugInfoToString(MutantDebugInfo debugInfo);
+
 struct ParallelizationConfig {
   int workers;
   int testExecutionWorkers;
   int mutantExecutionWorkers;
+  /// Sandboxed children each mutant execution worker keeps in flight, for
+  /// the tests of different mutants. With more than one, the processes
+  /// that run the tests are no longer bound to the number of workers, nor
+  /// to the copies of the program the workers load.
+  int childrenPerWorker;
+  bool pinWorkers;
+  /// Each phase that supports it runs its first items with fewer workers
+  /// as well, and the rest with the number of workers that did best, see
+  /// TaskExecutor::setAutoTune
+  bool autoTune;
+  /// Processes the mutants run in, forked once the program is loaded. The
+  /// mutant execution workers are spread over them, and they share the
+  /// mutants on a distributed queue of their own, see
+  /// Driver::startWorkerProcesses. A memory budget applies to each of them.
+  int workerProcesses;
+  /// Helper processes the junk detection runs in, each with the source
+  /// files of its shard, see detectJunkInProcesses. 0 runs it on the
+  /// workers of this process.
+  int junkDetectionProcesses;
   ParallelizationConfig();
   static ParallelizationConfig defaultConfig();
   void normalize();
 };
 
+/// How long a test may run against a mutant, in milliseconds: the mean of
+/// the measured runs of the original test plus `deviations` standard
+/// deviations, times `multiplier`, times the load of the machine when there
+/// are more workers than cores, kept within [floor, ceiling].
+/// A ceiling of 0 means no ceiling.
+struct TimeoutPolicyConfig {
+  /// Runs of each original test that are measured
+  int runs;
+  int deviations;
+  int multiplier;
+  int floor;
+  int ceiling;
+  TimeoutPolicyConfig();
+};
+
+/// Which mutants run when there are too many of them, the others are
+/// dropped before they are cloned:
+/// - None: all of them
+/// - Uniform: `size` mutants picked at random
+/// - PerMutator, PerFile, PerFunction: `size` mutants picked at random, every
+///   mutator (file, function) keeps its share of the mutants
+/// - TimeBudget: as many mutants as the running times of their tests in the
+///   original run fit in `budget` seconds
+enum class SamplingStrategy {
+  None,
+  Uniform,
+  PerMutator,
+  PerFile,
+  PerFunction,
+  TimeBudget
+};
+
+std::string samplingStrategyToString(SamplingStrategy strategy);
+/// Leaves the strategy as it is and returns false for an unknown name
+bool samplingStrategyFromString(const std::string &name,
+                                SamplingStrategy &strategy);
+
+struct SamplingConfig {
+  SamplingStrategy strategy;
+  int size;
+  int seed;
+  /// In seconds
+  int budget;
+  SamplingConfig();
+};
+
+/// One of several jobs that each run a slice of the mutants, e.g. the jobs
+/// of a CI matrix, see shardMutants. A single shard runs every mutant.
+struct ShardConfig {
+  int index;
+  int count;
+  ShardConfig();
+};
+
+/// The order the reachable tests of a mutant run in, so that with fail fast
+/// the test that kills the mutant tends to run first:
+/// - Discovery: the order the tests were found in
+/// - Distance: the tests that call the mutant most directly first
+/// - Runtime: the fastest tests of the original run first
+/// - KillRate: the tests that killed the most mutants in the previous
+///   results first, see PreviousResults
+enum class TestOrder { Discovery, Distance, Runtime, KillRate };
+
+std::string testOrderToString(TestOrder order);
+/// Leaves the order as it is and returns false for an unknown name
+bool testOrderFromString(const std::string &name, TestOrder &order);
+
+/// The order the mutants run in:
+/// - LongestFirst: the most expensive mutants first, so that the run does
+///   not end on a long tail
+/// - Feedback: the mutants a developer acts upon first, so that the
+///   streamed reports show the survivors early, see feedbackFirst
+enum class MutantOrder { LongestFirst, Feedback };
+
+std::string mutantOrderToString(MutantOrder order);
+/// Leaves the order as it is and returns false for an unknown name
+bool mutantOrderFromString(const std::string &name, MutantOrder &order);
+
+/// A run shared by several machines through a directory they all see, see
+/// DistributedQueue. Every node finds the same mutants on its own:
+/// - Coordinator: publishes the mutants to run and reports all the results
+/// - Worker: runs the chunks of the published mutants it claims
+enum class DistributedRole { None, Coordinator, Worker };
+
+std::string distributedRoleToString(DistributedRole role);
+/// Leaves the role as it is and returns false for an unknown name
+bool distributedRoleFromString(const std::string &name,
+                               DistributedRole &role);
+
+struct DistributedConfig {
+  DistributedRole role;
+  std::string directory;
+  /// Mutants claimed at once
+  int chunk;
+  /// In seconds: the chunks of a node that did not report progress for
+  /// that long are run again by another one
+  int lease;
+  DistributedConfig();
+};
+
+/// What a sandboxed child may use, see ChildResources. Zero means no limit.
+/// The cgroup limits apply to all the children of a worker together, in a
+/// cgroup v2 directory of their own under `cgroupRoot`, which has to be
+/// delegated to mull (e.g. a systemd scope with Delegate=yes).
+struct ChildResourcesConfig {
+  /// In megabytes, RLIMIT_AS
+  int addressSpace;
+  /// In seconds, RLIMIT_CPU
+  int cpuTime;
+  /// RLIMIT_NOFILE
+  int openFiles;
+  /// Empty means no cgroups
+  std::string cgroupRoot;
+  /// In megabytes, memory.max of the cgroup of a worker
+  int cgroupMemory;
+  /// In percents of a CPU, cpu.max of the cgroup of a worker
+  int cgroupCPU;
+  /// In megabytes, what mull and all its children may take together, see
+  /// MemoryBudget
+  int memoryBudget;
+  ChildResourcesConfig();
+};
+
+/// How malloc holds the memory of mull, see Heap.h. Both need glibc.
+struct HeapConfig {
+  /// The most arenas malloc spreads the threads over, 0 keeps its default
+  /// of eight per core
+  int arenas;
+  /// Gives the free memory of the arenas back to the system at the end of
+  /// every phase
+  bool trim;
+  HeapConfig();
+};
+
 struct CustomTestDefinition {
   std::string testName;
   std::string methodName;
@@ -11,6 +11,8 @@
 #include <vector>
 
 extern int MullDefaultTimeoutMilliseconds;
+extern int MullDefaultOutputLimitBytes;
+extern int MullDefaultOutputTailBytes;
 
 // We need these forward declarations to make our config friends with the
 // mapping traits.
@@ -31,6 +33,12 @@ struct JunkDetectionConfig {
   std::string detectorName;
   std::string cxxCompilationDatabasePath;
   std::string cxxCompilationFlags;
+  /// Parse the headers included by many files once into a PCH
+  bool cxxSharedPrecompiledHeaders;
+  /// Megabytes the parsed ASTs may take, 0 keeps every AST
+  int cxxMemoryLimit;
+  /// Where the verdicts of the previous runs are kept, empty disables it
+  std::string cacheDirectory;
 
   JunkDetectionConfig();
   bool isEnabled() const;
@@ -41,17 +49,87 @@ struct JunkDetectionConfig {
 
 class RawConfig {
 public:
-  enum class Fork { Disabled, Enabled };
+  enum class Fork { Disabled, Enabled, Server, Batch, Snapshot };
   enum class DryRunMode { Disabled, Enabled };
   enum class FailFastMode { Disabled, Enabled };
   enum class UseCache { No, Yes };
   enum class EmitDebugInfo { No, Yes };
+  enum class DropPassedOutput { No, Yes };
+  enum class MutantSchemata { Disabled, Enabled };
+  enum class SplitMutatedFunctions { Disabled, Enabled };
+  enum class EquivalentMutantPruning { Disabled, Enabled };
+  enum class SharedProgram { Disabled, Enabled };
+  enum class LazyJIT { Disabled, Enabled };
+  enum class ParallelJIT { Disabled, Enabled };
+  enum class DeferMutantCloning { Disabled, Enabled };
+  enum class LazyBitcodeLoading { Disabled, Enabled };
+  enum class InlineInstrumentation { Disabled, Enabled };
+  enum class CoverageInstrumentation { Disabled, Enabled };
+  enum class GuardedInstrumentation { Disabled, Enabled };
+  enum class ConstructorTemplate { Disabled, Enabled };
+  enum class DirectTestRun { Disabled, Enabled };
+  enum class ReleaseIR { Disabled, Enabled };
+  enum class JITHugePages { Disabled, Enabled };
+  enum class BlockCoverage { Disabled, Enabled };
+  enum class BoundedCallTree { Disabled, Enabled };
+  enum class PerfCounters { Disabled, Enabled };
+  enum class DirectCalls { Disabled, Enabled };
+  enum class StopOnSurvivor { Disabled, Enabled };
+  enum class StaticReachability { Disabled, Enabled };
+  enum class CacheCompression { Disabled, Enabled };
+  enum class CachePopulate { Disabled, Enabled };
+  enum class ReachabilityCache { Disabled, Enabled };
+  enum class ProgramLibrary { Disabled, Enabled };
+  enum class MutationSearchCache { Disabled, Enabled };
+  enum class TestSearchCache { Disabled, Enabled };
 
   static std::string forkToString(Fork fork);
   static std::string dryRunToString(DryRunMode dryRun);
   static std::string failFastToString(FailFastMode failFast);
   static std::string cachingToString(UseCache caching);
   static std::string emitDebugInfoToString(EmitDebugInfo emitDebugInfo);
+  static std::string dropPassedOutputToString(DropPassedOutput dropOutput);
+  static std::string mutantSchemataToString(MutantSchemata schemata);
+  static std::string
+  splitMutatedFunctionsToString(SplitMutatedFunctions splitFunctions);
+  static std::string equivalentMutantPruningToString(
+      EquivalentMutantPruning equivalentMutantPruning);
+  static std::string sharedProgramToString(SharedProgram sharedProgram);
+  static std::string lazyJITToString(LazyJIT lazyJIT);
+  static std::string parallelJITToString(ParallelJIT parallelJIT);
+  static std::string
+  deferMutantCloningToString(DeferMutantCloning deferMutantCloning);
+  static std::string
+  lazyBitcodeLoadingToString(LazyBitcodeLoading lazyBitcodeLoading);
+  static std::string
+  inlineInstrumentationToString(InlineInstrumentation inlineInstrumentation);
+  static std::string coverageInstrumentationToString(
+      CoverageInstrumentation coverageInstrumentation);
+  static std::string guardedInstrumentationToString(
+      GuardedInstrumentation guardedInstrumentation);
+  static std::string
+  constructorTemplateToString(ConstructorTemplate constructorTemplate);
+  static std::string directTestRunToString(DirectTestRun directTestRun);
+  static std::string releaseIRToString(ReleaseIR releaseIR);
+  static std::string jitHugePagesToString(JITHugePages jitHugePages);
+  static std::string blockCoverageToString(BlockCoverage blockCoverage);
+  static std::string
+  boundedCallTreeToString(BoundedCallTree boundedCallTree);
+  static std::string perfCountersToString(PerfCounters perfCounters);
+  static std::string directCallsToString(DirectCalls directCalls);
+  static std::string stopOnSurvivorToString(StopOnSurvivor stopOnSurvivor);
+  static std::string
+  staticReachabilityToString(StaticReachability staticReachability);
+  static std::string
+  cacheCompressionToString(CacheCompression cacheCompression);
+  static std::string cachePopulateToString(CachePopulate cachePopulate);
+  static std::string
+  reachabilityCacheToString(ReachabilityCache reachabilityCache);
+  static std::string programLibraryToString(ProgramLibrary programLibrary);
+  static std::string
+  mutationSearchCacheToString(MutationSearchCache mutationSearchCache);
+  static std::string
+  testSearchCacheToString(TestSearchCache testSearchCache);
 
 private:
   std::string bitcodeFileList;
@@ -65,6 +143,7 @@ private:
   std::string objectFileList;
   std::vector<std::string> tests;
   std::vector<std::string> excludeLocations;
+  std::vector<std::string> freshGlobalsTests;
   std::vector<CustomTestDefinition> customTests;
 
   Fork fork;
@@ -75,8 +154,76 @@ private:
   Diagnostics diagnostics;
 
   int timeout;
+  TimeoutPolicyConfig timeoutPolicy;
+  SamplingConfig sampling;
+  ShardConfig shard;
+  TestOrder testOrder;
+  MutantOrder mutantOrder;
+  int batchKillSize;
+  int originalTestBatchSize;
+  int loopBudget;
+  int stallTimeout;
+  int flakyRuns;
+  DistributedConfig distributed;
+  ChildResourcesConfig childResources;
+  HeapConfig heap;
+  int resultMemoryBudget;
   int maxDistance;
   std::string cacheDirectory;
+  CacheCompression cacheCompression;
+  int cacheSizeLimit;
+  CachePopulate cachePopulate;
+  ReachabilityCache reachabilityCache;
+  ProgramLibrary programLibrary;
+  MutationSearchCache mutationSearchCache;
+  TestSearchCache testSearchCache;
+  std::string cacheRemoteURL;
+  std::string changedLines;
+  std::string previousResults;
+  std::string resume;
+  std::string killMatrix;
+  std::string minimizedTests;
+  std::string metricsEndpoint;
+  HashAlgorithm hashAlgorithm;
+  int codegenOptLevel;
+  MutantDebugInfo mutantDebugInfo;
+  int parallelCodegenThreshold;
+  int jsonFlushInterval;
+  /// Threads that write the streamed results of the sqlite reporter, each
+  /// to a database of its own merged into the report at the end
+  int sqliteWriters;
+  /// Seconds the run may take, the mutants that did not run by then are
+  /// left out. Zero means no limit.
+  int deadline;
+  /// Cycles between the samples of the original test runs, zero when their
+  /// calls are not sampled
+  int reachabilitySamplePeriod;
+
+  int outputLimit;
+  DropPassedOutput dropPassedOutput;
+  OutputRetention outputRetention;
+  int outputTail;
+  MutantSchemata mutantSchemata;
+  SplitMutatedFunctions splitMutatedFunctions;
+  EquivalentMutantPruning equivalentMutantPruning;
+  SharedProgram sharedProgram;
+  LazyJIT lazyJIT;
+  ParallelJIT parallelJIT;
+  DeferMutantCloning deferMutantCloning;
+  LazyBitcodeLoading lazyBitcodeLoading;
+  InlineInstrumentation inlineInstrumentation;
+  CoverageInstrumentation coverageInstrumentation;
+  GuardedInstrumentation guardedInstrumentation;
+  ConstructorTemplate constructorTemplate;
+  DirectTestRun directTestRun;
+  ReleaseIR releaseIR;
+  JITHugePages jitHugePages;
+  BlockCoverage blockCoverage;
+  BoundedCallTree boundedCallTree;
+  PerfCounters perfCounters;
+  DirectCalls directCalls;
+  StopOnSurvivor stopOnSurvivor;
+  StaticReachability staticReachability;
 
   JunkDetectionConfig junkDetection;
   ParallelizationConfig parallelizationConfig;
@@ -117,6 +264,7 @@ public:
   const std::vector<std::string> &getReporters() const;
   const std::vector<std::string> &getTests() const;
   const std::vector<std::string> &getExcludeLocations() const;
+  const std::vector<std::string> &getFreshGlobalsTests() const;
 
   const std::vector<CustomTestDefinition> &getCustomTests() const;
 
@@ -127,14 +275,78 @@ public:
   const ParallelizationConfig parallelization() const;
 
   int getTimeout() const;
+  const TimeoutPolicyConfig &getTimeoutPolicy() const;
+  const SamplingConfig &getSampling() const;
+  const ShardConfig &getShard() const;
+  TestOrder getTestOrder() const;
+  MutantOrder getMutantOrder() const;
+  int getBatchKillSize() const;
+  int getOriginalTestBatchSize() const;
+  int getLoopBudget() const;
+  int getStallTimeout() const;
+  int getFlakyRuns() const;
+  const DistributedConfig &getDistributed() const;
+  const ChildResourcesConfig &getChildResources() const;
+  const HeapConfig &getHeap() const;
+  int getResultMemoryBudget() const;
   int getMaxDistance() const;
+  int getOutputLimit() const;
+  OutputRetention getOutputRetention() const;
+  HashAlgorithm getHashAlgorithm() const;
+  int getCodegenOptLevel() const;
+  MutantDebugInfo getMutantDebugInfo() const;
+  int getParallelCodegenThreshold() const;
+  int getJSONFlushInterval() const;
+  int getSQLiteWriters() const;
+  int getDeadline() const;
+  int getReachabilitySamplePeriod() const;
+  int getOutputTail() const;
 
   bool forkEnabled() const;
+  bool forkServerEnabled() const;
+  bool forkBatchEnabled() const;
+  bool forkSnapshotEnabled() const;
   bool cachingEnabled() const;
   bool dryRunModeEnabled() const;
   bool failFastModeEnabled() const;
   bool shouldEmitDebugInfo() const;
   bool junkDetectionEnabled() const;
+  bool shouldDropPassedOutput() const;
+  bool mutantSchemataEnabled() const;
+  bool splitMutatedFunctionsEnabled() const;
+  bool equivalentMutantPruningEnabled() const;
+  bool sharedProgramEnabled() const;
+  bool lazyJITEnabled() const;
+  bool parallelJITEnabled() const;
+  bool deferMutantCloningEnabled() const;
+  bool lazyBitcodeLoadingEnabled() const;
+  bool inlineInstrumentationEnabled() const;
+  bool coverageInstrumentationEnabled() const;
+  bool guardedInstrumentationEnabled() const;
+  bool constructorTemplateEnabled() const;
+  bool directTestRunEnabled() const;
+  bool releaseIREnabled() const;
+  bool jitHugePagesEnabled() const;
+  bool blockCoverageEnabled() const;
+  bool boundedCallTreeEnabled() const;
+  bool perfCountersEnabled() const;
+  bool directCallsEnabled() const;
+  bool stopOnSurvivorEnabled() const;
+  bool staticReachabilityEnabled() const;
+  bool cacheCompressionEnabled() const;
+  int getCacheSizeLimit() const;
+  bool cachePopulateEnabled() const;
+  bool reachabilityCacheEnabled() const;
+  bool programLibraryEnabled() const;
+  bool mutationSearchCacheEnabled() const;
+  bool testSearchCacheEnabled() const;
+  const std::string &getCacheRemoteURL() const;
+  const std::string &getChangedLines() const;
+  const std::string &getPreviousResults() const;
+  const std::string &getResume() const;
+  const std::string &getKillMatrix() const;
+  const std::string &getMinimizedTests() const;
+  const std::string &getMetricsEndpoint() const;
 
   void normalizeParallelizationConfig();
 
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mull {
+
+struct Configuration;
+class MutationPoint;
+class Test;
+
+/// What running mutants takes, in nanoseconds. With fail-fast a mutant
+/// stops at the first of its tests that kills it, so it costs anything from
+/// its first test to all of them. Without fail-fast both are the same.
+struct RunCost {
+  int64_t least;
+  int64_t most;
+
+  RunCost() : least(0), most(0) {}
+  RunCost(int64_t least, int64_t most) : least(least), most(most) {}
+  RunCost &operator+=(const RunCost &other);
+};
+
+/// Predicts the cost of a mutant from the original runs of its reachable
+/// tests: a test takes the mean of its runs, slowed down by the load of the
+/// workers (see TimeoutPolicy::getLoad), plus the overhead of the sandbox.
+class CostModel {
+public:
+  CostModel(int64_t sandboxOverhead, double load, bool failFast);
+  /// The overhead is the mean of what the sandbox added to the original runs
+  /// of the tests, zero without fork
+  CostModel(const Configuration &config, const std::vector<Test> &tests);
+
+  int64_t testCost(const Test &test) const;
+  RunCost mutantCost(const MutationPoint &point) const;
+  int64_t getSandboxOverhead() const { return sandboxOverhead; }
+
+private:
+  int64_t sandboxOverhead;
+  double load;
+  bool failFast;
+};
+
+/// The cost of the mutants per source file, per mutator and overall, the
+/// most expensive entries first
+struct CostEstimate {
+  struct Entry {
+    std::string name;
+    size_t mutants;
+    RunCost cost;
+
+    Entry() : mutants(0) {}
+  };
+
+  std::vector<Entry> files;
+  std::vector<Entry> mutators;
+  Entry overall;
+  size_t workers;
+
+  /// The cost shared by the workers
+  RunCost wallTime(const Entry &entry) const;
+};
+
+CostEstimate estimateCost(const CostModel &model,
+                          const std::vector<MutationPoint *> &points,
+                          size_t workers);
+
+/// The time left of a phase expected to take `estimate` nanoseconds, of
+/// which `done` out of `total` items took `elapsed` so far. The estimate
+/// alone at the start gives way to the rate of the phase as it goes.
+int64_t remainingTime(int64_t estimate, int64_t elapsed, size_t done,
+                      size_t total);
+
+/// E.g. 1h02m, 3m05s, 12s or 250ms
+std::string formatDuration(int64_t nanoseconds);
+
+} // namespace mull
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "mull/ChangedLines.h"
+
+#include <llvm/ADT/StringRef.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace mull {
+
+/// A run the daemon is asked for, one `<key> <value>` per line, up to an
+/// empty line or the end of the input:
+///
+///     test <name>              runs only the test, repeated for more tests
+///     file <path>              mutates only the file, a path as for the
+///                              changed lines, repeated for more files
+///     exclude <pattern>        skips the code as -exclude-location does
+///     stop                     shuts the daemon down
+struct DaemonRequest {
+  std::vector<std::string> tests;
+  ChangedLines files;
+  std::vector<std::string> excludedLocations;
+  bool stop;
+
+  DaemonRequest() : stop(false) {}
+
+  /// False with an error message if a line does not make sense
+  static bool parse(llvm::StringRef text, DaemonRequest &request,
+                    std::string &error);
+};
+
+/// Serves the runs of a process that has the program loaded, compiled and
+/// linked already, over a Unix domain socket. Every run is forked off the
+/// warm process, so that no run sees what another one changed, e.g. the
+/// mutants it inserted into the modules. The output of the run goes to the
+/// client, followed by a last line with the exit status:
+///
+///     mull-daemon: exit <status>
+///
+/// The runs are served one after another, each one uses all the workers.
+class Daemon {
+public:
+  /// The handler runs in the forked child, its result is the exit status
+  typedef std::function<int(const DaemonRequest &)> Handler;
+
+  explicit Daemon(std::string socketPath);
+  ~Daemon();
+
+  /// Creates the socket, replacing the one a previous daemon left behind
+  bool listen();
+  /// Serves the requests until one asks to stop
+  void serve(const Handler &handler);
+
+private:
+  void serveClient(int client, const Handler &handler, bool &stop);
+
+  std::string socketPath;
+  int server;
+};
+
+} // namespace mull
@@ -0,0 +1,20 @@
+#pragma once
+
+namespace llvm {
+class Instruction;
+class StoreInst;
+} // namespace llvm
+
+namespace mull {
+
+/// A store into a local variable that is never read: the variable does not
+/// escape and the function only ever stores into it
+bool isDeadStore(const llvm::StoreInst &store);
+
+/// Whether what the instruction computes or stores can be observed: it
+/// reaches a side effect, a branch or a return, or an instruction that may
+/// trap. The mutants that only change the operands of an instruction that
+/// cannot be observed are equivalent.
+bool isObservable(const llvm::Instruction &instruction);
+
+} // namespace mull
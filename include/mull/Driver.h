@@ -1,17 +1,20 @@
 #pragma once
 
+#include "mull/ExecutionOutput.h"
 #include "mull/ExecutionResult.h"
 #include "mull/ForkProcessSandbox.h"
 #include "mull/IDEDiagnostics.h"
 #include "mull/Instrumentation/Instrumentation.h"
-#include "mull/MutationResult.h"
+#include "mull/MutationResultTable.h"
 #include "mull/Mutators/Mutator.h"
+#include "mull/Parallelization/Tasks/MutantCompilationTask.h"
 #include "mull/TestFrameworks/Test.h"
 #include "mull/Toolchain/Toolchain.h"
 
 #include <llvm/Object/ObjectFile.h>
 
 #include <map>
+#include <sys/types.h>
 
 namespace llvm {
 
@@ -25,12 +28,29 @@ namespace mull {
 struct Configuration;
 
 class Program;
+class ChangedLines;
+class DistributedQueue;
 class Filter;
+class KillMatrix;
+class MutantExecutionTask;
+class PreviousResults;
+class ProgramLibrary;
+class Checkpoint;
+class ReachabilityCache;
+class FunctionAddresses;
+class TestTimings;
 class Result;
 class TestFramework;
 class MutationsFinder;
 class Metrics;
+class MetricsServer;
+struct MemoryMetrics;
 class JunkDetector;
+class MergedTestee;
+class Testee;
+class Reporter;
+enum class RunPhase;
+class JITEngine;
 
 class Driver {
   const Configuration &config;
@@ -49,6 +69,33 @@ class Driver {
   Instrumentation instrumentation;
   Metrics &metrics;
   JunkDetector &junkDetector;
+  ExecutionOutputStore outputStore;
+  std::vector<Reporter *> streamingReporters;
+  /// The state of an incremental run, when the configuration asks for one
+  std::unique_ptr<ChangedLines> changedLines;
+  std::unique_ptr<PreviousResults> previousResults;
+  std::unique_ptr<Checkpoint> checkpoint;
+  std::unique_ptr<ReachabilityCache> reachabilityCache;
+  /// With the sampled reachability, once the original program is linked
+  std::unique_ptr<FunctionAddresses> sampledFunctions;
+  /// Orders the original tests, with the cache
+  std::unique_ptr<TestTimings> testTimings;
+  std::unique_ptr<DistributedQueue> distributedQueue;
+  /// The worker processes forked by this one, and the directory of their
+  /// queue
+  std::vector<pid_t> workerProcesses;
+  std::string workerProcessesQueue;
+  /// Handed over to the result once the mutants ran
+  std::unique_ptr<KillMatrix> killMatrix;
+  /// What the forked children may use, nullptr when they are not limited
+  std::unique_ptr<ChildResources> childResources;
+  bool warm;
+  bool compiled;
+  /// The original program, its objects being added as they are compiled
+  std::unique_ptr<JITEngine> linkingProgram;
+  /// The original program, when it is loaded from a shared library
+  std::unique_ptr<ProgramLibrary> programLibrary;
+  std::unique_ptr<MetricsServer> metricsServer;
 
 public:
   Driver(const Configuration &config, Program &program,
@@ -58,26 +105,116 @@ public:
 
   ~Driver();
 
+  /// Loads the dynamic libraries and compiles the instrumented modules
+  /// ahead of the run, none of which depends on the filter, so that the
+  /// runs of a daemon are forked off a warm process
+  void warmUp();
   std::unique_ptr<Result> Run();
 
+  /// The reporter receives the results of the original tests and of the
+  /// mutants as they are produced, and the end of each phase of the run. It
+  /// must outlive the reporting of the results.
+  void streamResultsTo(Reporter &reporter);
+
 private:
-  void compileInstrumentedBitcodeFiles();
+  void endPhase(RunPhase phase);
+  void prepareIncrementalRun();
+  /// Given an engine, the objects are added to it as they are compiled
+  void compileInstrumentedBitcodeFiles(JITEngine *jit = nullptr);
+  /// Whether the run surely links the instrumented code
+  bool needsInstrumentedCode();
   void loadDynamicLibraries();
+  /// The sizes of what the run holds on to, measured at the end of the run
+  MemoryMetrics memoryMetrics();
 
   std::vector<Test> findTests();
+  /// Links the instrumented program for the original test runs
+  std::unique_ptr<JITEngine> loadOriginalProgram();
+  /// nullptr when the library cannot be linked or loaded, see
+  /// ProgramLibrary
+  std::unique_ptr<JITEngine>
+  loadProgramLibrary(std::vector<llvm::object::ObjectFile *> &objectFiles);
+  /// Adds the tests the program registers at run time, see TestFinder
+  void findRuntimeTests(std::vector<Test> &tests, JITEngine &jit);
   std::vector<MutationPoint *> findMutationPoints(std::vector<Test> &tests);
+  /// Adds the testees of the tests whose calls are cached, returns the
+  /// tests that need to run
+  std::vector<Test *>
+  restoreCachedTestees(std::vector<Test> &tests,
+                       std::vector<std::unique_ptr<Testee>> &testees);
+  /// Where the original program linked the functions, for the samples of
+  /// the original tests
+  std::unique_ptr<FunctionAddresses> mapFunctionAddresses(JITEngine &jit);
+  /// The testees of the tests that passed, from the static call graph of
+  /// the program instead of the calls of their runs
+  std::vector<std::unique_ptr<Testee>>
+  findStaticTestees(std::vector<Test> &tests);
+  std::vector<MutationPoint *>
+  searchMutationPoints(std::vector<MergedTestee> &testees);
+  /// See ParallelizationConfig::junkDetectionProcesses
   std::vector<MutationPoint *>
-  filterOutJunkMutations(std::vector<MutationPoint *> mutationPoints);
+  detectJunkInProcesses(std::vector<MergedTestee> &testees);
 
-  std::vector<std::unique_ptr<MutationResult>>
-  runMutations(std::vector<MutationPoint *> &mutationPoints);
+  void retainMutationPoints(const std::vector<MutationPoint *> &points);
+  /// See MutantSampler
+  std::vector<MutationPoint *>
+  sampleMutationPoints(const std::vector<MutationPoint *> &points);
+  /// See shardMutants
+  std::vector<MutationPoint *>
+  shardMutationPoints(const std::vector<MutationPoint *> &points);
+
+  /// A row per point and a column per test, see KillMatrix
+  void createKillMatrix(const std::vector<MutationPoint *> &points,
+                        const std::vector<Test> &tests);
+  /// See minimizeTestSuite
+  void writeMinimizedTests();
+  MutationResultTable runMutations(std::vector<MutationPoint *> &mutationPoints,
+                                   std::vector<Test> &tests);
+  /// Adds the results of the mutants that did not change since the previous
+  /// run, returns the mutants that did
+  std::vector<MutationPoint *> reusePreviousResults(
+      const std::vector<MutationPoint *> &mutationPoints,
+      MutationResultTable &results);
+
+  /// Adds the results of the mutants the interrupted run completed, returns
+  /// the mutants left to run
+  std::vector<MutationPoint *> resumeCompletedMutants(
+      const std::vector<MutationPoint *> &mutationPoints,
+      MutationResultTable &results);
+
+  /// Gives the duplicate mutants the results of the mutants they duplicate,
+  /// see MutationPoint::getMutantHash
+  void copyDuplicateResults(
+      const std::unordered_map<MutationPoint *, MutationPoint *> &duplicates,
+      MutationResultTable &results);
 
   std::vector<llvm::object::ObjectFile *> AllInstrumentedObjectFiles();
-
-  std::vector<std::unique_ptr<MutationResult>>
-  dryRunMutations(const std::vector<MutationPoint *> &mutationPoints);
-  std::vector<std::unique_ptr<MutationResult>>
-  normalRunMutations(const std::vector<MutationPoint *> &mutationPoints);
+  /// The instrumented objects of the modules none of the points mutate
+  std::vector<llvm::object::ObjectFile *> unmutatedInstrumentedObjectFiles(
+      const MutantCompilationTask::MutationPoints &modulePoints);
+
+  /// Reports what running the mutants would cost, see CostModel
+  MutationResultTable
+  dryRunMutations(const std::vector<MutationPoint *> &mutationPoints,
+                  const std::vector<Test> &tests);
+  /// The tests release their IR along with the program, see
+  /// Configuration::releaseIREnabled
+  MutationResultTable
+  normalRunMutations(const std::vector<MutationPoint *> &mutationPoints,
+                     std::vector<Test> &tests);
+  /// Runs the chunks of the mutants this node claims, see DistributedQueue.
+  /// The coordinator publishes the mutants and adds the results of the
+  /// other nodes. Returns false if the mutants are to run here instead.
+  bool distributedRunMutations(
+      std::vector<MutantExecutionTask> &tasks,
+      const std::vector<MutationPoint *> &mutationPoints,
+      MutationResultTable &results, DistributedRole role);
+  /// Forks the worker processes, see ParallelizationConfig::workerProcesses,
+  /// and sets the role of this process on their queue. Returns the workers
+  /// of this process.
+  int startWorkerProcesses(DistributedRole &role);
+  /// Kills the worker processes unless they are done, and reaps them
+  void stopWorkerProcesses(bool finished);
 };
 
 } // namespace mull
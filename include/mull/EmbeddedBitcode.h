@@ -0,0 +1,23 @@
+#pragma once
+
+#include <llvm/ADT/StringRef.h>
+#include <llvm/Support/MemoryBuffer.h>
+
+#include <vector>
+
+namespace mull {
+
+/// The linker concatenates the bitcode sections of the objects, so a section
+/// of an executable holds many bitcode files in a row. The files are found
+/// by walking the top level blocks of each one, which reads the headers of
+/// the blocks only. The result points into the section, nothing is copied.
+std::vector<llvm::StringRef> splitBitcodeSection(llvm::StringRef section);
+
+/// Collects the sections that hold the bitcode embedded with -fembed-bitcode
+/// (.llvmbc on ELF, __LLVM,__bitcode on Mach-O) without copying them.
+/// Returns false when the buffer is not an object file this can read, e.g.
+/// a universal binary or a Mach-O executable with a bitcode bundle.
+bool findBitcodeSections(llvm::MemoryBufferRef object,
+                         std::vector<llvm::StringRef> &sections);
+
+} // namespace mull
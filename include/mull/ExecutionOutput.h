@@ -0,0 +1,80 @@
+#pragma once
+
+#include "mull/Config/ConfigurationOptions.h"
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mull {
+
+struct ExecutionResult;
+
+/// stdout or stderr of a sandboxed run.
+/// Copies share the same bytes, and so do the identical outputs that went
+/// through the same ExecutionOutputStore.
+class ExecutionOutput {
+public:
+  ExecutionOutput() = default;
+  ExecutionOutput(std::string text);
+  ExecutionOutput(const char *text);
+
+  /// Decompresses the text if needed
+  std::string str() const;
+  size_t size() const;
+  bool empty() const;
+
+  bool isCompressed() const;
+  bool sharesStorageWith(const ExecutionOutput &other) const;
+
+private:
+  struct Storage {
+    std::string bytes;
+    size_t size;
+    bool compressed;
+  };
+
+  explicit ExecutionOutput(std::shared_ptr<const Storage> storage);
+
+  std::shared_ptr<const Storage> storage;
+
+  friend class ExecutionOutputStore;
+};
+
+bool operator==(const ExecutionOutput &output, const std::string &text);
+bool operator==(const ExecutionOutput &output, const char *text);
+std::ostream &operator<<(std::ostream &stream, const ExecutionOutput &output);
+
+/// Applies the retention policy to the outputs of execution results and
+/// deduplicates them by hash, so that, e.g., the identical outputs of passing
+/// tests are stored once. Shared by all the workers.
+class ExecutionOutputStore {
+public:
+  ExecutionOutputStore(OutputRetention retention, size_t tailBytes);
+
+  void retain(ExecutionResult &result);
+
+  /// Number of distinct outputs stored so far
+  size_t uniqueOutputs();
+  /// Bytes held by the distinct outputs, after truncation and compression
+  size_t storedBytes();
+
+private:
+  using StoragePtr = std::shared_ptr<const ExecutionOutput::Storage>;
+
+  ExecutionOutput intern(const std::string &text);
+
+  OutputRetention retention;
+  size_t tailBytes;
+
+  std::mutex mutex;
+  std::unordered_map<size_t, std::vector<StoragePtr>> storages;
+  size_t count;
+  size_t bytes;
+};
+
+} // namespace mull
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "mull/ExecutionOutput.h"
+
+#include <cstdint>
 #include <string>
 
 namespace mull {
@@ -11,7 +14,10 @@ enum ExecutionStatus {
   Crashed = 4,
   AbnormalExit = 5,
   DryRun = 6,
-  FailFast = 7
+  FailFast = 7,
+  /// The mutated functions looped far more than the original run of the
+  /// test, see injectLoopBudget
+  LoopBudgetExceeded = 8
 };
 
 static std::string executionStatusAsString(ExecutionStatus status) {
@@ -32,15 +38,69 @@ static std::string executionStatusAsString(ExecutionStatus status) {
     return "DryRun";
   case FailFast:
     return "FailFast";
+  case LoopBudgetExceeded:
+    return "LoopBudgetExceeded";
   }
 }
 
+/// Where the time of a run in a forked process went, in nanoseconds:
+/// the fork in the parent, the way from the fork to the start of the test,
+/// the test as the child measured it, the way from the end of the test until
+/// the child is reaped, and the time spent reading its output.
+/// All of them are 0 when the run was not forked, only the test is measured
+/// for the tests of a batch that did not start it.
+struct SandboxTimings {
+  int64_t fork;
+  int64_t forkToStart;
+  int64_t test;
+  int64_t reap;
+  int64_t outputRead;
+
+  SandboxTimings()
+      : fork(0), forkToStart(0), test(0), reap(0), outputRead(0) {}
+};
+
+/// What the kernel accounted to the child of a run, see getrusage(2): the
+/// CPU time in microseconds, the peak resident memory in kilobytes, the page
+/// faults and the context switches. A test of a batch gets its own share,
+/// but the peak is the one of the child so far. All of them are 0 when the
+/// run was not forked.
+struct ChildUsage {
+  int64_t userTime;
+  int64_t systemTime;
+  int64_t maxResident;
+  int64_t minorFaults;
+  int64_t majorFaults;
+  int64_t voluntarySwitches;
+  int64_t involuntarySwitches;
+
+  ChildUsage()
+      : userTime(0), systemTime(0), maxResident(0), minorFaults(0),
+        majorFaults(0), voluntarySwitches(0), involuntarySwitches(0) {}
+};
+
+/// The hardware events the test of a run caused, see PerfCounters. All of
+/// them are 0 unless the sandbox counts them, and for a run that crashed or
+/// timed out.
+struct PerfCounts {
+  int64_t instructions;
+  int64_t cycles;
+  int64_t branchMisses;
+  int64_t cacheMisses;
+
+  PerfCounts()
+      : instructions(0), cycles(0), branchMisses(0), cacheMisses(0) {}
+};
+
 struct ExecutionResult {
   ExecutionStatus status;
   int exitStatus;
   long long runningTime;
-  std::string stdoutOutput;
-  std::string stderrOutput;
+  ExecutionOutput stdoutOutput;
+  ExecutionOutput stderrOutput;
+  SandboxTimings timings;
+  ChildUsage usage;
+  PerfCounts counts;
   ExecutionResult()
       : status(ExecutionStatus::Invalid), exitStatus(0), runningTime(0) {}
 
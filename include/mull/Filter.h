@@ -1,10 +1,20 @@
 #pragma once
 
+#include "mull/ChangedLines.h"
+#include "mull/SubstringMatcher.h"
+
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <llvm/IR/Function.h>
 #include <llvm/IR/Instruction.h>
+#include <llvm/Support/Regex.h>
+
+namespace llvm {
+class DIFile;
+}
 
 namespace mull {
 
@@ -19,14 +29,50 @@ public:
 
   void skipByLocation(const std::string &locationSubstring);
   void skipByLocation(const char *locationSubstring);
+  /// The pattern is either a substring of the path, or "glob:" followed by
+  /// a glob matching the end of the path ("**" spans directories), or
+  /// "regex:" followed by an extended regular expression found in the path.
+  /// The pattern must be valid, see validateLocationPattern.
+  void skipByLocationPattern(const std::string &pattern);
+  /// An error message if the pattern cannot be compiled, empty otherwise
+  static std::string validateLocationPattern(const std::string &pattern);
+  /// The patterns that decide whether a function is skipped, empty if none
+  /// is. The same patterns skip the same functions.
+  const std::string &getFunctionPatterns() const;
+  /// The patterns and the changed lines that decide whether an instruction
+  /// is skipped, empty if none is. The same patterns skip the same
+  /// instructions.
+  const std::string &getInstructionPatterns() const;
 
   void includeTest(const std::string &testName);
   void includeTest(const char *testName);
 
+  /// Skips every instruction that is not on one of the lines, including
+  /// the instructions without a location
+  void includeChangedLines(ChangedLines changes);
+
 private:
-  std::vector<std::string> names;
-  std::vector<std::string> locations;
   std::vector<std::string> tests;
+
+  SubstringMatcher names;
+  SubstringMatcher locations;
+  std::vector<llvm::Regex> locationRegexes;
+  std::string functionPatterns;
+  std::string instructionPatterns;
+  bool changedLinesOnly = false;
+  ChangedLines changedLines;
+
+  /// The verdicts are cached, so that every function and every file is
+  /// matched against the patterns once. The filter is shared by the workers.
+  std::mutex verdictsMutex;
+  std::unordered_map<const llvm::Function *, bool> functionVerdicts;
+  std::unordered_map<const llvm::DIFile *, bool> fileVerdicts;
+  std::unordered_map<const llvm::DIFile *, const ChangedLines::FileChanges *>
+      fileChanges;
+
+  bool shouldSkipFile(const llvm::DIFile *file);
+  const ChangedLines::FileChanges *changesOf(const llvm::DIFile *file);
+  void clearVerdicts();
 };
 
 } // namespace mull
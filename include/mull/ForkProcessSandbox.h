@@ -1,29 +1,201 @@
+#pragma once
 
 #include "ExecutionResult.h"
+#include "mull/ChildResources.h"
+#include <cstddef>
 #include <functional>
+#include <mutex>
+#include <vector>
 
 namespace mull {
 
+struct SandboxJob {
+  std::function<ExecutionStatus()> function;
+  long long timeoutMilliseconds;
+  /// What the jobs of a series may share, e.g. the static constructors of
+  /// the program. The sandboxes that fork the jobs from a process of the
+  /// series run the prologue of the first job there once, the others never
+  /// run it: a job has to set itself up unless the prologue ran before it.
+  std::function<void()> prologue;
+
+  SandboxJob(std::function<ExecutionStatus()> function,
+             long long timeoutMilliseconds,
+             std::function<void()> prologue = nullptr)
+      : function(std::move(function)),
+        timeoutMilliseconds(timeoutMilliseconds),
+        prologue(std::move(prologue)) {}
+};
+
 class ProcessSandbox {
 public:
   virtual ~ProcessSandbox() {}
   virtual ExecutionResult run(std::function<ExecutionStatus()> function,
                               long long timeoutMilliseconds) = 0;
+
+  /// Runs the jobs one after another against the same state of the process
+  /// (e.g. all the tests of one mutant), stops as soon as `proceed`
+  /// returns false. Results are in the order of the jobs.
+  virtual std::vector<ExecutionResult>
+  runSeries(const std::vector<SandboxJob> &jobs,
+            const std::function<bool(const ExecutionResult &)> &proceed);
+
+  /// Runs several series, e.g. the tests of several mutants, with up to
+  /// `concurrency` of them in flight at once. Each series runs as runSeries
+  /// runs it. The results are in the order of the series.
+  /// The base sandbox runs the series one after another.
+  virtual std::vector<std::vector<ExecutionResult>>
+  runConcurrentSeries(
+      const std::vector<std::vector<SandboxJob>> &series, size_t concurrency,
+      const std::function<bool(const ExecutionResult &)> &proceed);
 };
 
 class ForkProcessSandbox : public ProcessSandbox {
 public:
   const static int MullExitCode = 227;
-  const static int MullTimeoutCode = 239;
+  /// The child ran out of its loop budget, see mull_loopBudgetExceeded
+  const static int LoopBudgetExitCode = 228;
+  const static size_t DefaultOutputLimit = 1024 * 1024;
+
+  /// outputLimit caps (in bytes) what is kept from each of stdout and stderr
+  /// so that a runaway test does not blow up mull's memory.
+  /// The children are limited by `resources` unless it is nullptr, it has
+  /// to outlive the sandbox. They count the hardware events of their tests
+  /// if perfCounters is set, see PerfCounters.
+  /// A child that neither runs nor does I/O for stallMilliseconds is killed
+  /// and times out, zero waits for the timeout. A test waiting that long on
+  /// a process it started counts as stalled as well.
+  explicit ForkProcessSandbox(size_t outputLimit = DefaultOutputLimit,
+                              bool keepPassedOutput = true,
+                              ChildResources *resources = nullptr,
+                              bool perfCounters = false,
+                              long long stallMilliseconds = 0)
+      : outputLimit(outputLimit), keepPassedOutput(keepPassedOutput),
+        resources(resources), perfCounters(perfCounters),
+        stallMilliseconds(stallMilliseconds) {}
 
   ExecutionResult run(std::function<ExecutionStatus()> function,
-                      long long timeoutMilliseconds);
+                      long long timeoutMilliseconds) override;
+
+  /// The children of all the series are supervised by the calling thread,
+  /// in one poll loop over their pipes and exits
+  std::vector<std::vector<ExecutionResult>> runConcurrentSeries(
+      const std::vector<std::vector<SandboxJob>> &series, size_t concurrency,
+      const std::function<bool(const ExecutionResult &)> &proceed) override;
+
+protected:
+  /// The limits of the next child, prepared on the thread that forks it
+  ChildResources::Limits prepareLimits();
+  /// Admits the next process under the memory budget of the resources, if
+  /// any. Unless `wait` is set, returns false when it does not fit now.
+  bool admitChild(MemoryBudget::Reservation &reservation, bool wait);
+  void releaseChild(const MemoryBudget::Reservation &reservation,
+                    const ChildUsage &usage);
+  /// Runs the function in a child that applies `limits`, for the processes
+  /// forked from a child of mull where the limits cannot be prepared
+  ExecutionResult runLimited(const std::function<ExecutionStatus()> &function,
+                             long long timeoutMilliseconds,
+                             const ChildResources::Limits &limits);
+
+  size_t outputLimit;
+  bool keepPassedOutput;
+  ChildResources *resources;
+  bool perfCounters;
+  long long stallMilliseconds;
+};
+
+/// Forks a server process once per series, the server forks a child per job.
+/// The mull process is forked once per mutant instead of once per test:
+/// page tables of the (huge) JIT address space are copied only once, and
+/// the other workers do not hit copy-on-write faults after every test.
+/// The server runs the prologue of the series before it forks any child,
+/// within the timeout of the first job. The limits of the children are
+/// prepared once per series, the server itself is not limited.
+class ForkServerProcessSandbox : public ForkProcessSandbox {
+public:
+  using ForkProcessSandbox::ForkProcessSandbox;
+
+  std::vector<ExecutionResult> runSeries(
+      const std::vector<SandboxJob> &jobs,
+      const std::function<bool(const ExecutionResult &)> &proceed) override;
+  std::vector<std::vector<ExecutionResult>> runConcurrentSeries(
+      const std::vector<std::vector<SandboxJob>> &series, size_t concurrency,
+      const std::function<bool(const ExecutionResult &)> &proceed) override;
+
+private:
+  /// Keeps the sockets of one server from leaking into another server
+  /// forked concurrently by a different worker
+  std::mutex forkMutex;
+};
+
+/// Runs all the tests of a series in one child, one after another, so that
+/// a mutant with many reachable tests costs one fork instead of one per
+/// test. The child notes the status and the end of the output of every
+/// test in memory shared with the parent, the output goes to files so that
+/// it can be split between the tests.
+/// The child runs the prologue of the series before the first test.
+/// Once the child crashes, the test that was running is run again in a
+/// child of its own to find out whether it crashes on its own, and a new
+/// batch picks up the tests after it. A test that runs out of time is
+/// reported as timed out right away.
+/// The limits apply to the child of a batch as a whole, e.g. the CPU time
+/// limit covers all of its tests.
+class BatchProcessSandbox : public ForkProcessSandbox {
+public:
+  using ForkProcessSandbox::ForkProcessSandbox;
+
+  std::vector<ExecutionResult> runSeries(
+      const std::vector<SandboxJob> &jobs,
+      const std::function<bool(const ExecutionResult &)> &proceed) override;
+  /// The batches of a worker run one at a time
+  std::vector<std::vector<ExecutionResult>> runConcurrentSeries(
+      const std::vector<std::vector<SandboxJob>> &series, size_t concurrency,
+      const std::function<bool(const ExecutionResult &)> &proceed) override;
+
+protected:
+  /// Called in the child once the prologue ran
+  virtual void prepareBatch() {}
+  /// Called in the child right before and right after each test. Once
+  /// finishBatchTest returns false the child ends after the test, and the
+  /// next batch picks up the tests after it.
+  virtual void startBatchTest() {}
+  virtual bool finishBatchTest() { return true; }
+
+private:
+  /// Runs the jobs from `first` on in one child, adds their results.
+  /// Returns false once `proceed` stops the series.
+  bool runBatch(const std::vector<SandboxJob> &jobs, size_t first,
+                const std::function<bool(const ExecutionResult &)> &proceed,
+                std::vector<ExecutionResult> &results);
+};
+
+/// Runs the tests of a series one after another in one child, as the
+/// batches do, and puts the child back as it was before each test: the
+/// writable data sections of the JIT-ed programs (their globals) are copied
+/// once the prologue ran and restored after every test that changed them.
+/// The heap is not copied. A test that leaves the heap in use at another
+/// size than it found it ends the child, the next test gets a fresh one:
+/// the restored globals may point to memory the test freed or moved, e.g.
+/// the buffer of a global vector it grew. So does a test whose globals
+/// cannot be restored. A test that frees and allocates the same number of
+/// bytes is not caught.
+/// Crashes and timeouts are handled as in the batches: the child is thrown
+/// away, a test that crashed runs again in a child of its own. Mull never
+/// runs a test in its own process. The sections of an engine have to be
+/// finalized before its first test, which rules out lazy linking.
+class SnapshotProcessSandbox : public BatchProcessSandbox {
+public:
+  using BatchProcessSandbox::BatchProcessSandbox;
+
+protected:
+  void prepareBatch() override;
+  void startBatchTest() override;
+  bool finishBatchTest() override;
 };
 
 class NullProcessSandbox : public ProcessSandbox {
 public:
   ExecutionResult run(std::function<ExecutionStatus()> function,
-                      long long timeoutMilliseconds);
+                      long long timeoutMilliseconds) override;
 };
 
 } // namespace mull
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "mull/Config/ConfigurationOptions.h"
+
+#include <llvm/ADT/StringRef.h>
+#include <llvm/Support/MD5.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace llvm {
+class Function;
+}
+
+namespace mull {
+
+/// The hashes of the modules end up in the keys of the object cache. An MD5
+/// digest is written as it always was, the other algorithms prefix theirs
+/// with their name, so that the keys of different algorithms never collide.
+class Hasher {
+public:
+  explicit Hasher(HashAlgorithm algorithm);
+
+  void update(llvm::StringRef data);
+  std::string final();
+
+private:
+  static const size_t StripeSize = 32;
+
+  void consumeStripe(const char *stripe);
+
+  HashAlgorithm algorithm;
+  llvm::MD5 md5;
+
+  /// XXH64 state
+  uint64_t accumulators[4];
+  uint64_t totalLength;
+  char stripe[StripeSize];
+  size_t stripeLength;
+};
+
+std::string hashOf(llvm::StringRef data, HashAlgorithm algorithm);
+
+/// Hashes the IR of the function without the numbers of its metadata and
+/// attribute groups, so that the hash only changes with the function itself:
+/// a change elsewhere in the module renumbers them, and moves the function's
+/// debug locations.
+std::string hashOfFunctionBody(const llvm::Function &function);
+/// The same without the name of the function, so that a clone of a function
+/// hashes as the function does
+std::string hashOfFunctionCode(const llvm::Function &function);
+
+} // namespace mull
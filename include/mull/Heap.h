@@ -0,0 +1,22 @@
+#pragma once
+
+namespace mull {
+
+struct HeapConfig;
+
+/// malloc holds the IR of mull: the modules, their clones and whatever the
+/// passes and the JIT build from them are small objects. glibc gives the
+/// threads arenas of their own, up to eight per core, and keeps what is
+/// freed in them for the next allocations, so the resident set stays where
+/// the IR-heavy phases left it long after their IR is gone. The free bytes
+/// of the arenas show up in MemoryUsage::heapFree.
+
+/// Before the workers start: caps the arenas, see HeapConfig
+void configureHeap(const HeapConfig &config);
+
+/// Gives the free memory of the arenas back to the system when
+/// HeapConfig::trim is set. The phases call it before they measure the
+/// memory at their end.
+void trimHeap();
+
+} // namespace mull
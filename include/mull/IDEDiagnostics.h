@@ -2,6 +2,7 @@
 
 #include "ExecutionResult.h"
 #include "mull/Config/ConfigurationOptions.h"
+#include "mull/SourceCache.h"
 
 namespace mull {
 
@@ -16,6 +17,7 @@ public:
 
 class NormalIDEDiagnostics : public IDEDiagnostics {
   Diagnostics diagnostics;
+  SourceCache sourceCache;
 
 public:
   explicit NormalIDEDiagnostics(Diagnostics diagnostics)
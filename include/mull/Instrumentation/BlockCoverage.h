@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace llvm {
+class Function;
+}
+
+namespace mull {
+
+class Test;
+
+/// The basic blocks each test executed in its original run, see
+/// Instrumentation::takeCoveredBlocks. The blocks of all the functions are
+/// numbered in one sequence, the blocks of a function follow its first one
+/// in the order they are laid out in.
+/// The tests are recorded concurrently, the queries come once they are all
+/// recorded.
+class BlockCoverage {
+public:
+  void setFirstBlock(const llvm::Function *function, uint32_t block);
+  /// The blocks are sorted
+  void setCoveredBlocks(const Test *test, std::vector<uint32_t> blocks);
+
+  /// Whether the test executed the block of the function. A test or a
+  /// function that was not recorded is assumed to execute every block,
+  /// e.g. a test restored from the ReachabilityCache.
+  bool executed(const Test *test, const llvm::Function *function,
+                int basicBlockIndex) const;
+
+private:
+  std::unordered_map<const llvm::Function *, uint32_t> firstBlocks;
+  std::unordered_map<const Test *, std::vector<uint32_t>> coveredBlocks;
+  std::mutex mutex;
+};
+
+} // namespace mull
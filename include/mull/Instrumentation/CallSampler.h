@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mull {
+
+/// Samples the thread running a test with perf_event_open(2), in place of
+/// the instrumentation recording its calls: the test runs at native speed.
+/// A sample is taken every `period` cycles, in user space. Where the
+/// machine has branch records (e.g. the LBR of x86), every sample also
+/// holds the last calls the thread made, both their sites and their
+/// targets. Without them only the instruction pointer is sampled, and
+/// without hardware counters it is sampled every `period` nanoseconds.
+/// Like PerfCounters it is opened by the child of a run and only makes
+/// system calls. Nothing is sampled off Linux, or where
+/// perf_event_paranoid does not allow it.
+class CallSampler {
+public:
+  /// Opens nothing when the period is zero
+  explicit CallSampler(uint64_t period);
+  ~CallSampler();
+  CallSampler(const CallSampler &) = delete;
+  CallSampler &operator=(const CallSampler &) = delete;
+
+  bool isSampling() const;
+  bool hasBranchRecords() const;
+
+  /// Stops the sampling and copies the sampled addresses into `samples`,
+  /// laid out as InstrumentationInfo::samples: their count first, then at
+  /// most `capacity` of them. The samples the ring buffer had no room for
+  /// are lost.
+  void drain(uint64_t *samples, uint64_t capacity);
+
+private:
+  /// A power of two
+  static const size_t RingPages = 64;
+
+  int descriptor;
+  bool branchRecords;
+  void *ring;
+  size_t ringSize;
+};
+
+} // namespace mull
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace mull {
+
+/// The call tree mapping of a test run: the caller of every function called,
+/// the function itself for the first function of a chain, zero otherwise.
+///
+/// A test only reaches a tiny part of a large program, so the mapping is a
+/// two-level page table living in one block of shared memory:
+///
+///   [0]              number of pages in use
+///   [1]              offset of the first page
+///   [2, 2 + N)       directory, the offset of the page holding the
+///                    functions [i * PageSize, (i + 1) * PageSize) or zero
+///   [first page...]  the pages, handed out in order
+///
+/// All the offsets count uint32_t words from the start of the block. Only the
+/// pages of the functions reached are written to, and therefore backed by
+/// memory, and need to be cleared once the run is over.
+class CallTreeMapping {
+public:
+  CallTreeMapping() = delete;
+
+  static const uint32_t PageSize = 1024;
+  static const uint32_t DirectoryOffset = 2;
+  /// Directory entry of a page being handed out by another thread
+  static const uint32_t Allocating = UINT32_MAX;
+
+  /// The size of the block in bytes for this many functions
+  static size_t size(size_t functions);
+  /// Prepares a zeroed block
+  static void initialize(uint32_t *mapping, size_t functions);
+
+  /// The entry of the function, the page holding it is handed out if needed
+  static uint32_t *slot(uint32_t *mapping, uint32_t functionIndex);
+  /// Hands out the page holding the function unless it exists already,
+  /// returns its offset
+  static uint32_t allocatePage(uint32_t *mapping, uint32_t functionIndex);
+  /// The entry of the function, zero if its page was never handed out
+  static uint32_t get(const uint32_t *mapping, uint32_t functionIndex);
+
+  /// Collects {caller, function} for every function reached, the caller is
+  /// zero for the first function of a chain, and clears the block
+  static void
+  extractCalls(uint32_t *mapping, size_t functions,
+               std::vector<std::pair<uint32_t, uint32_t>> &calls);
+  /// Clears the pages in use and the directory
+  static void clear(uint32_t *mapping, size_t functions);
+
+  /// The index of the first nonzero word in [begin, end), end if there is
+  /// none. A test reaches few functions: the zero words are skipped a
+  /// vector at a time.
+  static size_t nextNonZero(const uint32_t *words, size_t begin, size_t end);
+};
+
+} // namespace mull
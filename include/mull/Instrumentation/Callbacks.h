@@ -4,6 +4,7 @@
 
 namespace llvm {
 class Function;
+class Instruction;
 class Module;
 class Value;
 } // namespace llvm
@@ -15,13 +16,44 @@ extern "C" void mull_leaveFunction(void **trampoline, uint32_t functionIndex);
 
 class Callbacks {
 public:
+  /// The guarded callbacks run only while the InstrumentationInfo pointer is
+  /// set, so the same code runs with the instrumentation off otherwise
+  explicit Callbacks(bool guarded = false);
+
   void injectCallbacks(llvm::Function *function, uint32_t index,
                        llvm::Value *infoPointer, llvm::Value *offset);
+  /// Same as injectCallbacks, but updates the call tree mapping and the
+  /// shadow stack of InstrumentationInfo with inline code instead of calls.
+  /// The bounded callbacks only record the calls near the test body, see
+  /// DynamicCallTree::enterBounded.
+  void injectInlineCallbacks(llvm::Function *function, uint32_t index,
+                             llvm::Value *infoPointer, llvm::Value *offset,
+                             bool bounded = false);
+  /// Sets the bit of the function in the coverage of InstrumentationInfo
+  void injectCoverageCallback(llvm::Function *function, uint32_t index,
+                              llvm::Value *infoPointer, llvm::Value *offset);
+  /// Marks the byte of every block of the function in the block coverage of
+  /// InstrumentationInfo, the blocks are numbered from firstBlock plus the
+  /// offset. Must be called before the other callbacks split the blocks.
+  void injectBlockCoverage(llvm::Function *function, uint32_t firstBlock,
+                           llvm::Value *infoPointer, llvm::Value *offset);
+  /// Counts the back edges the loops of the function take in the counter of
+  /// InstrumentationInfo, see injectLoopBudget
+  void injectBackEdgeCounter(llvm::Function *function,
+                             llvm::Value *infoPointer);
 
   llvm::Value *injectInstrumentationInfoPointer(llvm::Module *module,
                                                 const char *variableName);
 
   llvm::Value *injectFunctionIndexOffset(llvm::Module *module,
                                          const char *functionIndexOffsetPrefix);
+
+private:
+  bool guarded;
+
+  /// Where the callback goes: in front of the instruction, or behind
+  /// the guard placed in front of it
+  llvm::Instruction *guard(llvm::Value *infoPointer,
+                           llvm::Instruction *insertBefore);
 };
 } // namespace mull
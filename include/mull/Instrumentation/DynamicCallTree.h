@@ -2,8 +2,9 @@
 
 #include "mull/Filter.h"
 
-#include <list>
+#include <cstdint>
 #include <stack>
+#include <utility>
 #include <vector>
 
 #include <llvm/IR/Function.h>
@@ -13,19 +14,39 @@ namespace mull {
 class Test;
 class Testee;
 
-struct CallTree {
-  llvm::Function *function;
-  int level;
-  uint32_t functionsIndex;
-  std::list<std::unique_ptr<CallTree>> children;
-  CallTree(llvm::Function *f) : function(f), level(0), functionsIndex(0) {}
+/// The call tree of a test run. Node N stands for the function N of the
+/// call tree mapping, node 0 is the phony root of the tree.
+/// The nodes live in flat arrays, so that the same tree can be rebuilt for
+/// every test without allocating once the arrays are sized.
+class CallTree {
+public:
+  static const uint32_t None;
+
+  /// Whether the function was called during the run
+  bool contains(uint32_t node) const { return levels[node] >= 0; }
+  uint32_t parent(uint32_t node) const { return parents[node]; }
+  uint32_t firstChild(uint32_t node) const { return firstChildren[node]; }
+  uint32_t nextSibling(uint32_t node) const { return nextSiblings[node]; }
+  int level(uint32_t node) const { return levels[node]; }
+
+private:
+  friend class DynamicCallTree;
+
+  std::vector<uint32_t> parents;
+  std::vector<uint32_t> firstChildren;
+  std::vector<uint32_t> lastChildren;
+  std::vector<uint32_t> nextSiblings;
+  std::vector<int> levels;
+  std::vector<uint32_t> chain;
 };
 
 struct CallTreeFunction {
   llvm::Function *function;
-  CallTree *treeRoot;
+  /// A function that is not instrumented never shows up in a call tree,
+  /// the functions it calls seem to be called by its caller
+  bool instrumented;
 
-  CallTreeFunction(llvm::Function *f) : function(f), treeRoot(nullptr) {}
+  CallTreeFunction(llvm::Function *f) : function(f), instrumented(true) {}
 };
 
 /// TODO: What is the good practice for this? maybe namespace?
@@ -34,18 +55,55 @@ public:
   DynamicCallTree() = delete;
   ~DynamicCallTree() = delete;
 
-  static std::unique_ptr<CallTree>
-  createCallTree(uint32_t *mapping, std::vector<CallTreeFunction> functions);
-  static std::vector<CallTree *> extractTestSubtrees(CallTree *root,
-                                                     Test &test);
+  /// Rebuilds callTree from the mapping, which is zeroed on the way
+  static void createCallTree(uint32_t *mapping,
+                             const std::vector<CallTreeFunction> &functions,
+                             CallTree &callTree);
+  static std::vector<uint32_t>
+  extractTestSubtrees(const CallTree &callTree,
+                      const std::vector<CallTreeFunction> &functions,
+                      Test &test);
   static std::vector<std::unique_ptr<Testee>>
-  createTestees(std::vector<CallTree *> subtrees, Test &test, int maxDistance,
-                Filter &filter);
+  createTestees(const CallTree &callTree,
+                const std::vector<CallTreeFunction> &functions,
+                const std::vector<uint32_t> &subtrees, Test &test,
+                int maxDistance, Filter &filter);
 
+  /// Finds the testees of the test straight from the mapping, without
+  /// building the tree: only the functions that ran are looked at past the
+  /// scan of the mapping, which is zeroed on the way.
+  /// The testees are ordered by distance, then by function index.
+  static std::vector<std::unique_ptr<Testee>>
+  extractTestees(uint32_t *mapping,
+                 const std::vector<CallTreeFunction> &functions,
+                 uint32_t testBody, Test &test, int maxDistance,
+                 Filter &filter);
+  /// The same from the {caller, function} pairs of the functions that ran,
+  /// the caller being zero for the first function of a chain
+  static std::vector<std::unique_ptr<Testee>>
+  extractTestees(std::vector<std::pair<uint32_t, uint32_t>> &calls,
+                 const std::vector<CallTreeFunction> &functions,
+                 uint32_t testBody, Test &test, int maxDistance,
+                 Filter &filter);
+
+  /// Records the caller of the function in its entry of the mapping,
+  /// the top of the stack, unless the function was reached already
+  static void recordCaller(const uint32_t functionIndex, uint32_t *slot,
+                           const std::stack<uint32_t> &stack);
   static void enterFunction(const uint32_t functionIndex, uint32_t *mapping,
                             std::stack<uint32_t> &stack);
   static void leaveFunction(const uint32_t functionIndex, uint32_t *mapping,
                             std::stack<uint32_t> &stack);
+
+  /// With the bounded call tree, whether the function entered at the depth
+  /// of the calling thread is recorded, see InstrumentationInfo::testBody.
+  /// testBodyDepth is where the test body runs on the thread, it is set
+  /// when the test body is entered.
+  static bool enterBounded(uint32_t functionIndex, uint32_t depth,
+                           uint32_t testBody, uint32_t maxDistance,
+                           uint32_t &testBodyDepth);
+  /// The depth is the one of the thread once the function returned
+  static void leaveBounded(uint32_t depth, uint32_t &testBodyDepth);
 };
 
 } // namespace mull
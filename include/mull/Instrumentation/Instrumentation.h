@@ -1,9 +1,13 @@
 #pragma once
 
+#include "mull/Instrumentation/BlockCoverage.h"
 #include "mull/Instrumentation/Callbacks.h"
 #include "mull/Instrumentation/DynamicCallTree.h"
 #include "mull/Testee.h"
 
+#include <mutex>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace llvm {
@@ -15,27 +19,143 @@ class Driver;
 class Test;
 class Filter;
 
+enum class InstrumentationMode {
+  /// Calls to mull_enterFunction/mull_leaveFunction record the call tree
+  Callbacks,
+  /// Inline code records the same call tree
+  InlineCallbacks,
+  /// Inline code sets a bit per function reached, there is no call tree:
+  /// every function reached by a test is at distance 1 from it
+  Coverage,
+  /// Nothing records the calls, the testees are found in the static call
+  /// graph instead, see StaticCallGraph
+  Static
+};
+
 class Instrumentation {
 public:
-  Instrumentation();
+  /// The guarded instrumentation is skipped when no test is being recorded,
+  /// see Callbacks. The block coverage and the back edges are recorded
+  /// along with any mode.
+  explicit Instrumentation(
+      InstrumentationMode mode = InstrumentationMode::Callbacks,
+      bool guarded = false, bool blockCoverage = false,
+      bool backEdges = false);
+  ~Instrumentation();
 
+  /// The functions the filter skips are not instrumented, the test runs
+  /// spend no time recording the calls of e.g. the standard library. Must
+  /// be set before the functions are recorded.
+  void setFilter(Filter *filter);
+  /// The calls further than the distance from the test body are not
+  /// recorded while the tests run, see InstrumentationInfo::testBody.
+  /// Has no effect in the coverage mode.
+  void setMaxDistance(int distance);
+  /// The runs of the tests get a buffer for the addresses sampled from
+  /// them, see InstrumentationInfo::samples
+  void enableSamples();
+  /// With the block coverage the bodies of a lazily loaded module are read,
+  /// the blocks of every function are numbered
   void recordFunctions(llvm::Module *originalModule);
   void insertCallbacks(llvm::Module *instrumentedModule);
 
-  std::vector<std::unique_ptr<Testee>> getTestees(Test &test, Filter &filter,
+  /// The calls of a test run as pairs of a caller and the function it
+  /// called, the caller is null for the first function of a chain. In the
+  /// coverage mode every function that ran is called by null.
+  using Calls = std::vector<std::pair<llvm::Function *, llvm::Function *>>;
+
+  /// Reads the calls the test made, the recording of the run is consumed
+  Calls takeCalls(Test &test);
+  /// The tests that made the same calls from the same test body, e.g. the
+  /// instances of a parameterized test, share the testees found for the
+  /// first of them
+  std::vector<std::unique_ptr<Testee>> getTestees(const Calls &calls,
+                                                  Test &test, Filter &filter,
                                                   int distance);
+  /// Once no test runs anymore
+  void forgetKnownTestees();
+  /// Records the blocks the test executed into the block coverage, does
+  /// nothing without it
+  void takeCoveredBlocks(Test &test);
+  /// nullptr without the block coverage
+  const BlockCoverage *getBlockCoverage() const;
+  /// Records the back edges the test took into it, see Test::getBackEdges.
+  /// Does nothing unless they are counted.
+  void takeBackEdges(Test &test);
+  /// The addresses sampled from the run of the test, none unless the
+  /// samples are enabled
+  std::vector<uint64_t> takeSamples(Test &test);
 
   void setupInstrumentationInfo(Test &test);
   void cleanupInstrumentationInfo(Test &test);
 
   std::map<std::string, uint32_t> &getFunctionOffsetMapping();
+  std::map<std::string, uint32_t> &getBlockOffsetMapping();
 
-  const char *instrumentationInfoVariableName();
-  const char *functionIndexOffsetPrefix();
+  static const char *instrumentationInfoVariableName();
+  static const char *functionIndexOffsetPrefix();
+  static const char *blockIndexOffsetPrefix();
+  /// Distinguishes the objects instrumented in the other modes in the cache
+  std::string cacheSuffix() const;
+  bool isGuarded() const;
 
 private:
   Callbacks callbacks;
+  InstrumentationMode mode;
+  bool guarded;
   std::vector<CallTreeFunction> functions;
   std::map<std::string, uint32_t> functionOffsetMapping;
+  std::unordered_map<const llvm::Function *, uint32_t> functionIndices;
+  bool blockCoverageEnabled;
+  BlockCoverage blockCoverage;
+  std::map<std::string, uint32_t> blockOffsetMapping;
+  uint32_t blockCount;
+  bool backEdgesEnabled;
+  bool samplesEnabled;
+  Filter *filter;
+  /// Negative unless the call tree is bounded
+  int maxDistance;
+
+  /// Memory shared with the forked test processes, reused across the tests
+  /// instead of being mapped for every one of them
+  struct SharedBuffer {
+    void *memory;
+    size_t size;
+  };
+  std::mutex buffersMutex;
+  std::vector<SharedBuffer> freeBuffers;
+  std::vector<uint32_t *> freeShadowStacks;
+
+  /// The testees found for the calls of a test, with no test. The calls
+  /// are only kept as a digest, they can be much larger than the testees.
+  struct KnownTestees {
+    const llvm::Function *testBody;
+    const Filter *filter;
+    int distance;
+    size_t calls;
+    std::string callsDigest;
+    std::vector<Testee> testees;
+  };
+  /// By the hash of the whole key
+  std::mutex knownTesteesMutex;
+  std::unordered_multimap<size_t, KnownTestees> knownTestees;
+  size_t knownTesteesSize;
+
+  std::vector<std::unique_ptr<Testee>>
+  findTestees(const Calls &calls, Test &test, Filter &filter, int distance);
+
+  std::vector<std::unique_ptr<Testee>>
+  getCoveredTestees(const Calls &calls, Test &test, Filter &filter,
+                    int distance);
+  bool isBounded() const;
+  size_t coverageSize() const;
+  size_t blockCoverageSize() const;
+  size_t mappingSize() const;
+  size_t samplesSize() const;
+  /// Zeroes what the run wrote and reuses the buffer
+  void releaseSamples(uint64_t *samples);
+  /// The memory returned is zeroed
+  void *acquireBuffer(size_t size);
+  void releaseBuffer(void *memory, size_t size, bool zeroed);
 };
 } // namespace mull
@@ -1,12 +1,49 @@
 #pragma once
 
 #include <cstdint>
-#include <stack>
 
 namespace mull {
+/// The inline instrumentation accesses the first nine fields directly from
+/// the generated code, they must keep their order and types
 struct InstrumentationInfo {
-  InstrumentationInfo() : callTreeMapping(nullptr), callstack() {}
+  InstrumentationInfo()
+      : callTreeMapping(nullptr), shadowStack(nullptr), shadowStackDepth(0),
+        coverage(nullptr), blockCoverage(nullptr), backEdges(nullptr),
+        testBody(0), maxDistance(0), testBodyDepth(OutsideTestBody), run(0),
+        consumed(false), samples(nullptr) {}
+  /// Laid out as described by CallTreeMapping
   uint32_t *callTreeMapping;
-  std::stack<uint32_t> callstack;
+  /// Call stack of the inline instrumentation, ShadowStackSize frames
+  uint32_t *shadowStack;
+  uint32_t shadowStackDepth;
+  /// A bit per function reached, used instead of the call tree mapping by the
+  /// coverage instrumentation
+  uint8_t *coverage;
+  /// A byte per basic block executed, with the block coverage
+  uint8_t *blockCoverage;
+  /// The back edges the loops of the test took, with the loop budget
+  uint64_t *backEdges;
+  /// With the bounded call tree, the function index of the test body: only
+  /// the test body and the functions at most maxDistance below it are
+  /// recorded in the mapping. Zero records every call.
+  uint32_t testBody;
+  uint32_t maxDistance;
+  /// The depth the test body runs at in the shadow stack
+  uint32_t testBodyDepth;
+  /// Identifies the run of the test, mull_enterFunction/mull_leaveFunction
+  /// keep a call stack per thread and start it over for every run
+  uint64_t run;
+  /// Reading the testees zeroes the mapping or the coverage as it goes,
+  /// so that their memory can be reused without clearing it again
+  bool consumed;
+  /// The addresses sampled from the run, see CallSampler: their count, then
+  /// SampleCapacity of them at most
+  uint64_t *samples;
+
+  /// Calls nested deeper share the last frame
+  static const uint32_t ShadowStackSize = 1 << 16;
+  /// The test body is not on the stack
+  static const uint32_t OutsideTestBody = UINT32_MAX;
+  static const uint64_t SampleCapacity = 1 << 16;
 };
 } // namespace mull
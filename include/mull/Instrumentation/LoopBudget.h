@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace llvm {
+class Function;
+class Instruction;
+} // namespace llvm
+
+namespace mull {
+
+/// The back edges the mutated functions may still take in the process,
+/// counted down by the code injectLoopBudget adds. Zero leaves them
+/// unlimited: the count wraps around instead of reaching zero.
+extern "C" uint64_t mull_loopBudget;
+/// Ends the process once the budget is spent, see
+/// ForkProcessSandbox::LoopBudgetExitCode
+extern "C" void mull_loopBudgetExceeded();
+
+/// The terminators of the blocks a loop of the function goes back from,
+/// collected before any code is added to them
+std::vector<llvm::Instruction *> backEdgeTerminators(llvm::Function *function);
+
+/// Counts down mull_loopBudget on every back edge of the mutated function,
+/// so that a mutant stuck in a loop ends in a fraction of the timeout
+void injectLoopBudget(llvm::Function *function);
+
+/// The budget of a mutant run of a test: `factor` times the back edges the
+/// original run of the test took, never less than MinimumLoopBudget, so that
+/// a test that hardly loops is not stopped by a mutant that loops a bit more.
+/// Saturates at the maximum, a budget the mutants never run out of.
+uint64_t loopBudgetOf(uint64_t originalBackEdges, uint64_t factor);
+
+static const uint64_t MinimumLoopBudget = 1 << 20;
+
+} // namespace mull
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "mull/Instrumentation/Instrumentation.h"
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace llvm {
+class Function;
+}
+
+namespace mull {
+
+class Program;
+class Test;
+
+/// The calls of the original test runs of the previous runs, one file per
+/// program under <cache>/reachability/, named after the MD5 of its modules
+/// and of the version of the instrumentation.
+/// The calls of a test are only reused while every function the test
+/// reached is unchanged, see hashOfFunctionBody: the test then calls the
+/// same functions again, so that it does not need to run at all.
+/// Only the tests that passed are stored.
+class ReachabilityCache {
+public:
+  /// An empty directory disables the cache
+  ReachabilityCache(const std::string &cacheDirectory,
+                    const std::string &version);
+
+  /// Reads the calls stored for the modules of the program. The functions
+  /// are hashed as they are now, so this must be called before any of them
+  /// is changed.
+  void load(Program &program);
+
+  /// Gives the test the result and the running times of its stored run.
+  /// Returns false if there is none, or if it reached a changed function.
+  bool restore(Test &test, Instrumentation::Calls &calls);
+
+  /// Thread safe, the functions are only hashed by save
+  void store(Test &test, const Instrumentation::Calls &calls);
+
+  /// Writes the file if any test was stored
+  void save();
+
+  uint64_t getHits() const;
+
+private:
+  struct Entry {
+    Entry() : runningTime(0), used(false) {}
+    int64_t runningTime;
+    std::vector<int64_t> runningTimes;
+    /// The keys of the functions the test reached, with their hashes
+    std::vector<std::pair<std::string, std::string>> functions;
+    /// Pairs of the positions of the caller and of the function called in
+    /// functions, plus one: zero stands for no caller
+    std::vector<std::pair<uint32_t, uint32_t>> calls;
+    /// Only the entries of the tests of this run are written back
+    bool used;
+  };
+
+  bool read();
+  void write();
+  static std::string keyOf(const llvm::Function *function);
+  const std::string &functionHash(const std::string &key);
+
+  std::string cacheDirectory;
+  std::string version;
+  std::string path;
+
+  std::mutex mutex;
+  bool changed;
+  std::map<std::string, Entry> entries;
+  std::unordered_map<std::string, llvm::Function *> functions;
+  std::unordered_map<std::string, std::string> hashes;
+
+  std::atomic<uint64_t> hits;
+};
+
+} // namespace mull
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace llvm {
+class Function;
+}
+
+namespace mull {
+
+class Test;
+class Testee;
+
+/// Where the JIT linked the functions of the program, to find the function
+/// an address sampled from a test run is in, see CallSampler
+class FunctionAddresses {
+public:
+  void add(llvm::Function *function, uint64_t address, uint64_t size);
+  /// Once every function is added
+  void sort();
+  /// nullptr for an address outside of the functions, e.g. in a library
+  llvm::Function *find(uint64_t address) const;
+  size_t size() const;
+
+private:
+  struct Range {
+    uint64_t begin;
+    uint64_t end;
+    llvm::Function *function;
+  };
+  std::vector<Range> ranges;
+};
+
+/// The functions the addresses sampled from the run of the test are in,
+/// each of them once, as testees at distance 1. The test body is left out.
+std::vector<std::unique_ptr<Testee>>
+sampledTestees(const FunctionAddresses &addresses,
+               const std::vector<uint64_t> &samples, Test &test);
+
+/// Narrows the testees of the static call graph with the samples of the
+/// runs: a function sampled in any run is only reached by the tests it was
+/// sampled in, the functions no run was sampled in are reached as the call
+/// graph has it. A sampled function the call graph misses for its test
+/// is reached at the distance of the sample.
+/// A test that seldom calls a hot function may miss it, the sampling
+/// trades this for runs at native speed.
+std::vector<std::unique_ptr<Testee>>
+narrowBySamples(std::vector<std::unique_ptr<Testee>> &staticTestees,
+                std::vector<std::unique_ptr<Testee>> &sampled);
+
+} // namespace mull
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace llvm {
+class Function;
+class Module;
+} // namespace llvm
+
+namespace mull {
+
+class Filter;
+class Test;
+class Testee;
+
+/// The calls the IR of the program can make, read from the bodies of its
+/// functions instead of being recorded while the tests run.
+/// A call to a declaration goes to the definition of the same name in any
+/// of the modules. An indirect call, virtual calls included, may reach any
+/// function whose address is taken: the graph has at least the calls a run
+/// makes, usually many more.
+class StaticCallGraph {
+public:
+  /// Materializes the bodies of the lazily loaded functions
+  explicit StaticCallGraph(const std::vector<llvm::Module *> &modules);
+
+  /// The functions at most maxDistance calls away from the test body, the
+  /// body first, ordered by distance as the recorded testees are. The
+  /// functions the filter skips are not testees and their calls are not
+  /// followed, as with the instrumentation.
+  std::vector<std::unique_ptr<Testee>>
+  getTestees(Test &test, Filter &filter, int maxDistance) const;
+
+  size_t getFunctionCount() const;
+  size_t getCallCount() const;
+
+private:
+  static const uint32_t None;
+
+  std::vector<llvm::Function *> functions;
+  std::unordered_map<const llvm::Function *, uint32_t> indices;
+  /// The callees of function N are in callees, from firstCallees[N] up to
+  /// firstCallees[N + 1]
+  std::vector<uint32_t> firstCallees;
+  std::vector<uint32_t> callees;
+  std::vector<bool> callsIndirectly;
+  std::vector<uint32_t> addressTaken;
+};
+
+} // namespace mull
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <string>
+
+namespace mull {
+
+/// The contents of a JSON string literal, without the quotes. The control
+/// characters are escaped too, the test names and the outputs have some.
+std::string escapeJSON(const std::string &input);
+
+} // namespace mull
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "mull/Mutators/Mutator.h"
+
+#include <clang/AST/ASTContext.h>
+#include <clang/Basic/SourceLocation.h>
+#include <clang/Basic/SourceManager.h>
+
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace mull {
+
+/// The source ranges of the AST nodes each mutator applies to, collected in
+/// a single traversal of the translation unit, so that checking a mutant is a
+/// lookup instead of another traversal.
+/// A mutant is not junk if one of the ranges of its mutator covers it, within
+/// the same file.
+///
+/// An index only covers one file: the top-level declarations of the other
+/// files, most of them coming from the headers, are not traversed, and the
+/// ranges that begin in another file, e.g. in a macro, are not kept.
+class ASTIndex {
+public:
+  ASTIndex(clang::ASTContext &astContext, clang::FileID file);
+
+  bool coversMutant(MutatorKind kind,
+                    const clang::SourceLocation &location) const;
+
+  void addRange(MutatorKind kind, const clang::SourceRange &range);
+
+  uint64_t nodesVisited;
+  uint64_t declarationsSkipped;
+
+private:
+  /// Ranges sorted by their beginning, with the furthest end of all the
+  /// ranges up to each one
+  struct Ranges {
+    std::vector<std::pair<unsigned, unsigned>> ranges;
+    std::vector<unsigned> furthestEnds;
+  };
+
+  const clang::SourceManager &sourceManager;
+  clang::FileID file;
+  std::map<MutatorKind, Ranges> ranges;
+};
+
+} // namespace mull
@@ -1,12 +1,18 @@
 #pragma once
 
+#include "ASTIndex.h"
 #include "CompilationDatabase.h"
+#include "mull/Metrics/Metrics.h"
 
 #include <clang/Frontend/ASTUnit.h>
+#include <llvm/ADT/StringMap.h>
 
+#include <atomic>
 #include <map>
 #include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
 namespace mull {
 
@@ -21,27 +27,130 @@ public:
 
   clang::SourceLocation getLocation(MutationPoint *point);
   bool isInSystemHeader(clang::SourceLocation &location);
+  /// One index per file of the translation unit, the main file or a header,
+  /// built the first time a mutant in that file needs it
+  const ASTIndex &getIndex(const clang::SourceLocation &location);
+  JunkDetectionMetrics getMetrics();
+  /// What the AST takes, measured once parsed
+  size_t getMemoryUsage();
+  /// The main file and every header it includes, the headers coming from a
+  /// precompiled header included
+  std::vector<std::string> getIncludedFiles();
+  void setPrecompiledFiles(const std::vector<std::string> &files);
 
 private:
   const clang::FileEntry *findFileEntry(const MutationPoint *point);
   const clang::FileEntry *findFileEntry(const std::string &filePath);
+  std::string normalizedPath(llvm::StringRef path) const;
+
+  struct IndexEntry {
+    std::once_flag indexed;
+    std::unique_ptr<ASTIndex> index;
+  };
 
   std::unique_ptr<clang::ASTUnit> ast;
   std::mutex mutex;
+  std::mutex indexMutex;
+  std::map<clang::FileID, std::unique_ptr<IndexEntry>> indices;
+  std::vector<std::string> precompiledFiles;
+
+  /// The files of the translation unit by their normalized path, filled the
+  /// first time a file is looked up
+  std::once_flag fileEntriesCollected;
+  llvm::StringMap<const clang::FileEntry *> fileEntries;
 };
 
+/// Every file is parsed once, the files are parsed concurrently: a thread
+/// asking for a file only waits for that file.
+///
+/// With shared precompiled headers, the system headers included at the top
+/// of several files compiled with the same flags are parsed once into a PCH
+/// that all these files are parsed with. Their own includes of the same
+/// headers are then skipped by the include guards, so the parsing time is
+/// spent on the main files rather than on the headers. A file that does not
+/// parse cleanly with the PCH is parsed again without it.
+///
+/// With a memory limit, the least recently used ASTs are evicted once the
+/// parsed ASTs take more than the limit. An AST still used by a detector is
+/// never evicted, so the limit can be exceeded by the ASTs in use, and an
+/// evicted file is parsed again if it is needed later.
 class ASTStorage {
 public:
+  /// A memory limit of 0 keeps every AST
   ASTStorage(const std::string &cxxCompilationDatabasePath,
-             const std::string &cxxCompilationFlags);
+             const std::string &cxxCompilationFlags,
+             bool sharedPrecompiledHeaders = false, uint64_t memoryLimit = 0);
+  ~ASTStorage();
+
+  std::shared_ptr<ThreadSafeASTUnit> findAST(const MutationPoint *point);
+  std::shared_ptr<ThreadSafeASTUnit> findAST(const std::string &sourceFile);
 
-  ThreadSafeASTUnit *findAST(const MutationPoint *point);
+  /// Starts parsing the files on that many threads, findAST picks up the
+  /// files already parsed and waits for the ones being parsed.
+  /// The background parsing stops once the memory limit is reached, the
+  /// files left are parsed when they are needed.
+  void parseInBackground(const std::vector<std::string> &sourceFiles,
+                         int workers);
+
+  /// Sums the traversals of the files parsed so far
+  JunkDetectionMetrics getMetrics();
+
+  const std::vector<std::string> &
+  compilationFlags(const std::string &sourceFile) const;
 
 private:
+  struct ASTEntry {
+    ASTEntry() : parses(0), memoryUsage(0), lastUsed(0) {}
+    /// Held while the file is being parsed, the rest is guarded by the mutex
+    /// of the storage
+    std::mutex parsing;
+    std::shared_ptr<ThreadSafeASTUnit> ast;
+    int parses;
+    size_t memoryUsage;
+    uint64_t lastUsed;
+  };
+
+  /// Built by the first file of the group that needs it
+  struct SharedHeader {
+    SharedHeader() : usable(false) {}
+    std::vector<std::string> includes;
+    std::string headerPath;
+    std::string pchPath;
+    std::once_flag built;
+    bool usable;
+    std::vector<std::string> dependencies;
+  };
+
+  ASTEntry &entry(const std::string &sourceFile);
+  std::vector<std::shared_ptr<ThreadSafeASTUnit>> evict(ASTEntry &parsed);
+  bool isOverMemoryLimit();
+  ThreadSafeASTUnit *parse(const std::string &sourceFile);
+  clang::ASTUnit *load(const std::string &sourceFile,
+                       const std::vector<std::string> &extraFlags);
+
+  void planSharedHeaders(const std::vector<std::string> &sourceFiles);
+  bool buildSharedHeader(SharedHeader &header, const std::string &sourceFile);
+
   std::mutex mutex;
 
   CompilationDatabase compilationDatabase;
-  std::map<std::string, std::unique_ptr<ThreadSafeASTUnit>> astUnits;
+  std::map<std::string, std::unique_ptr<ASTEntry>> astUnits;
+
+  uint64_t memoryLimit;
+  uint64_t memoryUsage;
+  uint64_t useClock;
+  /// What the evicted ASTs did, so that the metrics cover them as well
+  JunkDetectionMetrics evictedMetrics;
+
+  bool sharedPrecompiledHeaders;
+  std::string sharedHeadersDirectory;
+  std::vector<std::unique_ptr<SharedHeader>> sharedHeaders;
+  /// Only filled before the parsing starts
+  std::map<std::string, SharedHeader *> sharedHeaderOfFile;
+
+  std::vector<std::string> backgroundFiles;
+  std::atomic<size_t> nextBackgroundFile;
+  std::vector<std::thread> backgroundParsers;
 };
 
 } // namespace mull
\ No newline at end of file
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "ASTStorage.h"
+#include "mull/JunkDetection/JunkCache.h"
 #include "mull/JunkDetection/JunkDetector.h"
+#include "mull/Mutators/Mutator.h"
 
 namespace mull {
 
@@ -11,12 +13,22 @@ struct JunkDetectionConfig;
 class CXXJunkDetector : public JunkDetector {
 public:
   explicit CXXJunkDetector(JunkDetectionConfig &config);
-  ~CXXJunkDetector() override = default;
+  /// Saves the new verdicts into the cache
+  ~CXXJunkDetector() override;
 
   bool isJunk(MutationPoint *point) override;
+  void classify(const std::vector<MutationPoint *> &points,
+                std::vector<MutationPoint *> &nonJunk) override;
+  void prepare(const std::vector<std::string> &sourceFiles,
+               int workers) override;
+  JunkDetectionMetrics getMetrics() override;
+  void flush() override;
 
 private:
+  bool isJunk(ThreadSafeASTUnit &ast, MutationPoint *point, MutatorKind kind);
+
   ASTStorage astStorage;
+  JunkCache junkCache;
 };
 
 } // namespace mull
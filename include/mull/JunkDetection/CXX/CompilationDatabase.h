@@ -1,12 +1,22 @@
 #pragma once
 
+#include <llvm/ADT/StringMap.h>
+#include <llvm/ADT/StringRef.h>
+#include <llvm/Support/MemoryBuffer.h>
+
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
 
 namespace mull {
 
+/// The database file is mapped and only scanned for the boundaries of its
+/// entries and their file names. An entry is parsed the first time the flags
+/// of its file are asked for, so that a large database costs little when
+/// only a few of its files have mutants.
 class CompilationDatabase {
 public:
   class Path {
@@ -33,8 +43,17 @@ public:
   compilationFlagsForFile(const std::string &filepath) const;
 
 private:
+  void indexDatabase(const std::string &path);
+  const std::vector<std::string> &flagsForEntry(const std::string &file,
+                                                llvm::StringRef entry) const;
+
   const std::vector<std::string> extraFlags;
-  const std::map<std::string, std::vector<std::string>> database;
+  std::unique_ptr<llvm::MemoryBuffer> buffer;
+  /// The text of the last entry of each file
+  llvm::StringMap<llvm::StringRef> index;
+
+  mutable std::mutex flagsMutex;
+  mutable std::map<std::string, std::vector<std::string>> flags;
 };
 
 } // namespace mull
\ No newline at end of file
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <llvm/ADT/StringRef.h>
+
+#include <string>
+#include <vector>
+
+namespace mull {
+
+/// The angle-bracket includes at the top of a source file. The scan stops at
+/// the first declaration, conditional or macro definition, since moving the
+/// includes that follow them in front of the file could change their meaning.
+std::vector<std::string> leadingSystemIncludes(llvm::StringRef source);
+
+/// The headers that at least two of the files include at their top, in the
+/// order they first appear
+std::vector<std::string>
+sharedSystemIncludes(const std::vector<std::vector<std::string>> &includes);
+
+} // namespace mull
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "mull/JunkDetection/JunkDetector.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace mull {
+
+/// Tells the junk apart from the debug information of the IR alone, before
+/// the next detector parses any source: the points with no location or at
+/// column 0, the ones in the functions the compiler generated (implicit
+/// constructors and destructors, initializers of globals), and the ones in
+/// the headers of the system. The points it cannot tell about are left to
+/// the next detector, which only loads the ASTs for them.
+class DebugInfoJunkDetector : public JunkDetector {
+public:
+  explicit DebugInfoJunkDetector(std::unique_ptr<JunkDetector> next);
+
+  bool isJunk(MutationPoint *point) override;
+  void classify(const std::vector<MutationPoint *> &points,
+                std::vector<MutationPoint *> &nonJunk) override;
+  void prepare(const std::vector<std::string> &sourceFiles,
+               int workers) override;
+  JunkDetectionMetrics getMetrics() override;
+  void flush() override;
+
+  /// Junk for sure, whatever the next detector would say
+  static bool isObviousJunk(MutationPoint *point);
+
+private:
+  std::unique_ptr<JunkDetector> next;
+  std::atomic<uint64_t> verdicts;
+};
+
+} // namespace mull
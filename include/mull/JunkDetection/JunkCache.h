@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mull {
+
+/// Junk verdicts of the previous runs, one file per translation unit under
+/// <cache>/junk/, named after the MD5 of the source file, its compilation
+/// flags and the version of the detector.
+/// Each file lists the files the translation unit was made of with their
+/// MD5, the verdicts are only used while all of them are unchanged, so that
+/// an unchanged translation unit does not need to be parsed at all.
+class JunkCache {
+public:
+  /// An empty directory disables the cache
+  JunkCache(const std::string &cacheDirectory, const std::string &version);
+
+  /// Reads the verdicts of the file once, the later calls return the same
+  /// result. Returns true if the verdicts are still valid.
+  bool load(const std::string &sourceFile,
+            const std::vector<std::string> &flags);
+
+  /// Returns false if there is no verdict for the mutant
+  bool lookup(const std::string &sourceFile, const std::string &mutant,
+              bool &junk);
+
+  /// The dependencies are only asked for the first verdict of a file whose
+  /// verdicts were not valid, they must include the source file itself
+  void store(const std::string &sourceFile, const std::string &mutant,
+             bool junk,
+             const std::function<std::vector<std::string>()> &dependencies);
+
+  /// Writes the files that got new verdicts
+  void save();
+
+  uint64_t getHits() const;
+
+private:
+  struct Entry {
+    Entry() : valid(false), changed(false) {}
+    std::string path;
+    bool valid;
+    bool changed;
+    /// Pairs of the file path and the MD5 of its contents
+    std::vector<std::pair<std::string, std::string>> dependencies;
+    std::unordered_map<std::string, bool> verdicts;
+  };
+
+  bool read(Entry &entry);
+  void write(const Entry &entry);
+  std::string fileHash(const std::string &path);
+
+  std::string cacheDirectory;
+  std::string version;
+
+  std::mutex mutex;
+  std::map<std::string, Entry> entries;
+  std::map<std::string, std::string> fileHashes;
+
+  std::atomic<uint64_t> hits;
+};
+
+} // namespace mull
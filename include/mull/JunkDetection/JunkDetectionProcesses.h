@@ -0,0 +1,25 @@
+#pragma once
+
+#include "mull/Metrics/Metrics.h"
+
+#include <vector>
+
+namespace mull {
+
+class JunkDetector;
+class MutationPoint;
+
+/// Runs the junk detection in `processes` helper processes forked off this
+/// one, and returns the points that are not junk, in their order. The
+/// source files are sharded over the helpers, each parses the files of its
+/// shard, classifies their points a function at a time and sends back a
+/// bitmap of its verdicts. The ASTs never live in this process, and a file
+/// that crashes the parser only takes its helper down: the points of a
+/// helper that did not answer are kept. The metrics of the helpers are
+/// added up into `metrics`.
+std::vector<MutationPoint *>
+detectJunkInProcesses(JunkDetector &detector,
+                      const std::vector<MutationPoint *> &points,
+                      int processes, JunkDetectionMetrics &metrics);
+
+} // namespace mull
@@ -1,5 +1,10 @@
 #pragma once
 
+#include "mull/Metrics/Metrics.h"
+
+#include <string>
+#include <vector>
+
 namespace mull {
 
 class MutationPoint;
@@ -7,6 +12,25 @@ class MutationPoint;
 class JunkDetector {
 public:
   virtual bool isJunk(MutationPoint *point) = 0;
+  /// Keeps the points of the batch that are not junk. The points of a batch
+  /// come from one module, so that a detector sets up what it needs for
+  /// their source file once for all of them.
+  virtual void classify(const std::vector<MutationPoint *> &points,
+                        std::vector<MutationPoint *> &nonJunk) {
+    for (auto point : points) {
+      if (!isJunk(point)) {
+        nonJunk.push_back(point);
+      }
+    }
+  }
+  /// Called before the first isJunk with the source files the points may
+  /// come from, so that the detector can get them ready in the background
+  virtual void prepare(const std::vector<std::string> &sourceFiles,
+                       int workers) {}
+  virtual JunkDetectionMetrics getMetrics() { return JunkDetectionMetrics(); }
+  /// Writes out what the detector keeps of its verdicts, for a process that
+  /// exits without running the destructors
+  virtual void flush() {}
   virtual ~JunkDetector() = default;
 };
 
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "mull/ExecutionResult.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mull {
+
+class MutationPoint;
+class Test;
+
+/// The status of every test against every mutant, two bits per cell, kept
+/// in a file mapped into memory instead of a MutationResult per cell.
+/// There is a row per mutant and a column per test. Every row starts on a
+/// byte of its own, so that a row is exported as is, see getRow, and the
+/// workers writing the rows of their own mutants never share a byte.
+///
+/// The file is a Header followed by the rows, the cells of a byte are
+/// stored from the low bits up.
+class KillMatrix {
+public:
+  enum class Cell : uint8_t {
+    NotRun = 0,
+    Survived = 1,
+    Killed = 2,
+    /// Timed out, crashed or exited
+    Abnormal = 3
+  };
+
+  struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t rowSize;
+    uint64_t rows;
+    uint64_t columns;
+  };
+
+  static const uint32_t Version = 1;
+
+  /// Creates the file, or truncates it, with every cell NotRun. The rows
+  /// follow the order of the points, the columns the order of the tests.
+  KillMatrix(const std::string &path,
+             const std::vector<MutationPoint *> &mutationPoints,
+             const std::vector<Test> &tests);
+  ~KillMatrix();
+  KillMatrix(const KillMatrix &) = delete;
+  KillMatrix &operator=(const KillMatrix &) = delete;
+
+  /// False if the file cannot be created or mapped, nothing is kept then
+  bool isMapped() const { return cells != nullptr; }
+  const std::string &getPath() const { return path; }
+  size_t getRowCount() const { return mutationPoints.size(); }
+  size_t getColumnCount() const { return testIdentifiers.size(); }
+  /// In bytes
+  size_t getRowSize() const { return rowSize; }
+  /// In bytes, along with the header
+  size_t getFileSize() const;
+
+  const MutationPoint *getMutationPoint(size_t row) const {
+    return mutationPoints[row];
+  }
+  const std::string &getTestIdentifier(size_t column) const {
+    return testIdentifiers[column];
+  }
+  /// What the filter matches the test by, see Filter::includeTest
+  const std::string &getTestName(size_t column) const {
+    return testNames[column];
+  }
+
+  /// Does nothing for the points and the tests the matrix does not know
+  void set(const MutationPoint &point, const Test &test,
+           ExecutionStatus status);
+  /// Gives the mutant the cells of another one, see equivalent mutants
+  void copyRow(const MutationPoint &from, const MutationPoint &to);
+
+  Cell get(size_t row, size_t column) const;
+  const uint8_t *getRow(size_t row) const {
+    return cells + row * rowSize;
+  }
+
+  static Cell cellOf(ExecutionStatus status);
+
+private:
+  std::string path;
+  std::vector<MutationPoint *> mutationPoints;
+  std::vector<std::string> testIdentifiers;
+  std::vector<std::string> testNames;
+  std::unordered_map<const MutationPoint *, size_t> rows;
+  /// The column of every test, by the id of the test
+  std::vector<uint32_t> columns;
+  size_t rowSize;
+  uint8_t *mapping;
+  uint8_t *cells;
+
+  bool rowOf(const MutationPoint &point, size_t &row) const;
+};
+
+} // namespace mull
@@ -4,6 +4,11 @@
 
 namespace mull {
 
+/// By default the messages go straight to stdout. Once asynchronous, each
+/// thread collects its messages in a buffer of its own and hands whole
+/// lines to a background thread that writes them, so that the workers never
+/// wait on the terminal or a pipe and their lines do not interleave. The
+/// same line repeated over and over is only written a few times.
 class Logger {
 public:
   Logger() = delete;
@@ -11,6 +16,9 @@ public:
   enum class Level { error, warn, info, debug };
 
   static void setLevel(Logger::Level level);
+  static void setAsynchronous(bool asynchronous);
+  /// Waits until the lines handed over so far are written
+  static void flush();
 
   static llvm::raw_ostream &error();
   static llvm::raw_ostream &warn();
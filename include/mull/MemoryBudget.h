@@ -0,0 +1,71 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+namespace mull {
+
+/// Keeps mull and its sandboxed children within a memory budget, see
+/// ChildResourcesConfig::memoryBudget. What mull holds is measured, its
+/// resident set with the images of the workers in it, what a child will
+/// take on top of it is estimated from the peaks of the children reaped so
+/// far. A child is forked once it fits next to the children in flight, and
+/// a worker loads its own copy of the program once the image fits, so the
+/// number of processes follows what the tests of each phase take.
+///
+/// Whatever comes is admitted when nothing else is in flight: waiting would
+/// not free anything, the budget is a target rather than a limit.
+class MemoryBudget {
+public:
+  /// What a child holds of the budget from its fork until it is reaped,
+  /// or an image until it is loaded
+  struct Reservation {
+    uint64_t bytes;
+    /// The resident set of mull on admission: a child shares it, its own
+    /// memory is what it takes on top of it
+    uint64_t residentBefore;
+    Reservation() : bytes(0), residentBefore(0) {}
+  };
+
+  /// In bytes. `resident` measures mull, by default its resident set.
+  explicit MemoryBudget(uint64_t budget,
+                        std::function<uint64_t()> resident = nullptr);
+
+  /// Waits until the next child fits
+  Reservation admitChild();
+  /// Admits the next child only if it fits now, for the threads that have
+  /// children of their own to supervise meanwhile
+  bool tryAdmitChild(Reservation &reservation);
+  /// `peakResident` is the peak of the child in bytes, 0 if unknown
+  void releaseChild(const Reservation &reservation, uint64_t peakResident);
+
+  /// Waits until the image of a worker fits, before the worker loads it
+  Reservation admitImage();
+  /// The worker loaded its image, what mull took since is its size
+  void imageLoaded(const Reservation &reservation);
+
+  /// The children and the images that had to wait
+  uint64_t waits() const;
+
+private:
+  bool fits(uint64_t bytes);
+  bool idle() const;
+  Reservation reserve(uint64_t bytes);
+
+  uint64_t budget;
+  std::function<uint64_t()> resident;
+  mutable std::mutex mutex;
+  std::condition_variable released;
+  uint64_t reserved;
+  size_t childrenInFlight;
+  size_t imagesLoading;
+  /// The private memory of a child and the size of an image, as expected
+  uint64_t childEstimate;
+  uint64_t imageEstimate;
+  uint64_t waited;
+};
+
+} // namespace mull
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace mull {
+
+/// A histogram with HDR-style log-linear buckets: the values below 64 have
+/// a bucket each, above that every power of two is split into 32 buckets,
+/// so a percentile is off by less than 1/32 of the value. The buckets are
+/// atomic, the workers record into the same histogram without locking.
+class Histogram {
+public:
+  Histogram();
+  Histogram(const Histogram &) = delete;
+  Histogram &operator=(const Histogram &) = delete;
+
+  void record(uint64_t value);
+
+  uint64_t count() const;
+  uint64_t max() const;
+  /// The highest value of the bucket the percentile (0-100) falls into,
+  /// 0 when nothing was recorded
+  uint64_t percentile(double percentile) const;
+
+  static size_t bucketIndex(uint64_t value);
+  static uint64_t bucketUpperBound(size_t index);
+
+private:
+  static const unsigned SubBucketBits = 5;
+  static const size_t Buckets = (65 - SubBucketBits) << SubBucketBits;
+
+  std::atomic<uint64_t> counts[Buckets];
+  std::atomic<uint64_t> total;
+  std::atomic<uint64_t> maximum;
+};
+
+} // namespace mull
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace llvm {
+class raw_ostream;
+}
+
+namespace mull {
+
+/// What a run in progress looks like from the outside: the phase, the
+/// progress of the current step and the counters of the mutant runs and of
+/// the object cache. Everything is a relaxed atomic, the workers only ever
+/// add to their counters, see MetricsServer.
+class LiveMetrics {
+public:
+  static LiveMetrics &shared();
+
+  /// Only called on the main thread, the phases nest. The name must outlive
+  /// the metrics.
+  void beginPhase(const char *name);
+  void endPhase(const char *name);
+
+  /// Called by the progress reporter of the current step
+  void setProgress(uint64_t done, uint64_t total, uint64_t workers);
+
+  void addMutantRun(int64_t forkNanoseconds);
+  void addCacheLookup(bool hit);
+
+  /// The OpenMetrics text format, as understood by Prometheus
+  void write(llvm::raw_ostream &stream) const;
+
+private:
+  LiveMetrics();
+
+  std::vector<const char *> phases;
+  std::atomic<const char *> phase;
+  std::atomic<uint64_t> done;
+  std::atomic<uint64_t> total;
+  std::atomic<uint64_t> workers;
+  /// In seconds since the epoch, for the alerts on the runs that stall
+  std::atomic<int64_t> lastProgress;
+  std::atomic<uint64_t> mutantRuns;
+  std::atomic<uint64_t> forks;
+  std::atomic<uint64_t> forkNanoseconds;
+  std::atomic<uint64_t> cacheHits;
+  std::atomic<uint64_t> cacheMisses;
+  int64_t started;
+};
+
+/// Serves LiveMetrics over plain HTTP at GET /metrics, on a thread of its
+/// own that only reads the atomics, so that a scrape never holds up the
+/// workers. The endpoint is "host:port", or ":port" for every interface.
+class MetricsServer {
+public:
+  explicit MetricsServer(const std::string &endpoint);
+  ~MetricsServer();
+
+  bool start();
+
+private:
+  void serve();
+  void respond(int client);
+
+  std::string endpoint;
+  int server;
+  /// Wakes the thread up on destruction
+  int wakeUp[2];
+  std::thread thread;
+};
+
+} // namespace mull
@@ -1,16 +1,31 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "mull/Metrics/Histogram.h"
 
 namespace llvm {
 class Module;
-}
+class raw_ostream;
+} // namespace llvm
 
 namespace mull {
 
 class Test;
 class MutationPoint;
+struct SandboxTimings;
+struct ChildUsage;
+struct PerfCounts;
+struct Timing;
 
 struct MetricsMeasure {
   using Precision = std::chrono::milliseconds;
@@ -26,8 +41,189 @@ struct MetricsMeasure {
   static const char *precision();
 };
 
+/// Time a worker spent running its task versus waiting for the other
+/// workers to finish the same phase
+struct WorkerMetrics {
+  MetricsMeasure::Duration busyTime;
+  MetricsMeasure::Duration idleTime;
+
+  WorkerMetrics(MetricsMeasure::Duration busy, MetricsMeasure::Duration idle);
+};
+
+/// Lookups of the object cache and the bytes that went through it, bytes
+/// saved is the disk space compression saved on the objects written,
+/// remote hits are the hits served by the remote cache
+struct ObjectCacheMetrics {
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t remoteHits;
+  uint64_t bytesRead;
+  uint64_t bytesWritten;
+  uint64_t bytesSaved;
+  uint64_t bytesEvicted;
+  /// The objects read ahead, see ObjectCache::prefetchObjects
+  uint64_t prefetches;
+
+  ObjectCacheMetrics();
+};
+
+/// AST nodes the junk detection visited, and the declarations outside of
+/// the files with mutants it did not descend into. The debug info verdicts
+/// are the junk told apart without the AST, see DebugInfoJunkDetector.
+struct JunkDetectionMetrics {
+  uint64_t filesIndexed;
+  uint64_t nodesVisited;
+  uint64_t declarationsSkipped;
+  uint64_t cachedVerdicts;
+  uint64_t unitsEvicted;
+  uint64_t unitsReparsed;
+  uint64_t debugInfoVerdicts;
+
+  JunkDetectionMetrics();
+};
+
+/// The mutants the search left out as equivalent without compiling them:
+/// the ones of a value nothing observes, and of a store nothing reads
+struct DeadMutantMetrics {
+  uint64_t deadValues;
+  uint64_t deadStores;
+
+  DeadMutantMetrics();
+};
+
+/// Resident set size of the process and its peak so far, in bytes, and
+/// what malloc holds: the bytes in use and the free bytes it keeps in its
+/// arenas rather than giving them back to the system, see Heap.h
+struct MemoryUsage {
+  uint64_t resident;
+  uint64_t peakResident;
+  uint64_t heapLive;
+  uint64_t heapFree;
+
+  MemoryUsage();
+  static MemoryUsage current();
+  /// The resident set alone, cheaper than current()
+  static uint64_t currentResident();
+  /// The bytes malloc holds in use alone, see heapLive
+  static uint64_t currentHeapLive();
+  /// The share of the heap that is free, in percents
+  uint64_t heapFragmentation() const;
+};
+
+/// The runs killed by the timeout and the milliseconds they took
+struct TimeoutMetrics {
+  uint64_t runs;
+  uint64_t milliseconds;
+
+  TimeoutMetrics() : runs(0), milliseconds(0) {}
+};
+
+/// The mutant runs whose instructions were counted, along with the original
+/// run of their test, and the ones that took OutlierFactor times the
+/// instructions of the original run or more: a cheap sign of a mutant that
+/// loops.
+struct InstructionMetrics {
+  static const int64_t OutlierFactor = 10;
+
+  uint64_t countedRuns;
+  uint64_t outliers;
+
+  InstructionMetrics() : countedRuns(0), outliers(0) {}
+};
+
+/// What the children of the forked mutant runs used, summed up over the
+/// runs, see ChildUsage. The peak resident memory is the largest of them.
+struct UsageMetrics {
+  uint64_t runs;
+  uint64_t userTime;
+  uint64_t systemTime;
+  uint64_t maxResident;
+  uint64_t minorFaults;
+  uint64_t majorFaults;
+  uint64_t voluntarySwitches;
+  uint64_t involuntarySwitches;
+
+  UsageMetrics();
+};
+
+/// The memory of the process when a phase began and when it ended
+struct PhaseMemoryUsage {
+  std::string phase;
+  MemoryUsage begin;
+  MemoryUsage end;
+};
+
+/// Bytes held by the components that grow with the size of the program:
+/// the bitcode of the modules, the objects compiled from them, the sections
+/// the JIT allocated to load the objects, and the outputs of the runs kept
+/// for the reports
+struct MemoryMetrics {
+  uint64_t bitcodeBytes;
+  uint64_t objectFileBytes;
+  uint64_t jitSectionBytes;
+  uint64_t outputBytes;
+
+  MemoryMetrics();
+};
+
+/// Distributions of the stages of the mutant runs, in nanoseconds, see
+/// SandboxTimings. The trampoline swap is the lookup and the store that
+/// activate a mutant.
+struct LatencyHistograms {
+  Histogram fork;
+  Histogram forkToStart;
+  Histogram testRun;
+  Histogram reap;
+  Histogram outputRead;
+  Histogram trampolineSwap;
+
+  /// The stages by the names they are reported under
+  std::vector<std::pair<const char *, const Histogram *>> stages() const;
+};
+
+/// What a sample measures: a phase of the run, a span of the trace, or
+/// a step done for the module, the test or the mutant of the sample
+enum class MetricsStep : uint8_t {
+  Phase,
+  Span,
+  CompileOriginalModule,
+  CompileInstrumentedModule,
+  RunOriginalTest,
+  FindMutations,
+  CompileMutant,
+  LoadMutatedProgram,
+  RunMutant
+};
+
+/// A begin ('B') or an end ('E') of a step, or a step of a known duration
+/// ('X') added once it is over. Timestamps are in microseconds, durations
+/// in MetricsMeasure::Precision.
+struct MetricsSample {
+  const char *name;
+  const void *key;
+  const Test *test;
+  int64_t timestamp;
+  int64_t duration;
+  int32_t detail;
+  MetricsStep step;
+  char phase;
+};
+
+/// The hooks may be called from any thread. Every thread appends its samples
+/// to a buffer of its own, in chunks that never move, without locking: the
+/// samples are only merged into the measures when they are reported, once
+/// the workers are done. The phases of the run are measured on the main
+/// thread only.
+/// With tracing enabled the phases and the spans are recorded as well, so
+/// that a run can be opened in Perfetto or chrome://tracing with a track per
+/// thread: the gaps on the tracks of the workers are the time they were idle.
 class Metrics {
 public:
+  Metrics();
+  Metrics(const Metrics &) = delete;
+  Metrics &operator=(const Metrics &) = delete;
+
+  void enableTracing();
   void beginLoadModules();
   void endLoadModules();
 
@@ -72,6 +268,15 @@ public:
 
   void beginRunMutant(const MutationPoint *mutant, const Test *test);
   void endRunMutant(const MutationPoint *mutant, const Test *test);
+  /// The tests of a mutant run in a forked process, their run times come
+  /// back with the results
+  void addRunMutant(const MutationPoint *mutant, const Test *test,
+                    MetricsMeasure::Duration duration);
+
+  /// Spans of the trace that are not measured otherwise, e.g. waiting for
+  /// a lock. The name must outlive the metrics.
+  void beginSpan(const char *name, const std::string &detail = std::string());
+  void endSpan(const char *name);
 
   void beginRun();
   void endRun();
@@ -79,13 +284,96 @@ public:
   void beginReportResult();
   void endReportResult();
 
+  /// Called from the workers, the histograms are lock-free
+  void addSandboxTimings(const SandboxTimings &timings);
+  void addTrampolineSwap(int64_t nanoseconds);
+  const LatencyHistograms &latencies() const { return latencyHistograms; }
+
+  /// The runs of the mutants the sandbox killed for running out of time,
+  /// reported apart from the other kills as they cost a timeout each
+  void addTimedOutRun(long long milliseconds);
+  TimeoutMetrics timeouts() const;
+
+  /// Called from the workers, the runs that were not forked are skipped
+  void addChildUsage(const ChildUsage &usage);
+  UsageMetrics childUsage() const;
+
+  /// Compares the counts of a mutant run with the ones of the original run
+  /// of the test, the runs that were not counted are skipped
+  void addPerfCounts(const PerfCounts &mutant, const PerfCounts &original);
+  InstructionMetrics instructions() const;
+
+  void addWorkersMetrics(const std::string &phase,
+                         const std::vector<WorkerMetrics> &workers);
+
+  /// The phases of the Driver are sampled by their hooks, the executors
+  /// sample their own phases
+  void addMemoryUsage(const PhaseMemoryUsage &usage);
+  void setMemoryMetrics(const MemoryMetrics &metrics);
+
+  void setObjectCacheMetrics(const ObjectCacheMetrics &metrics);
+  void setJunkDetectionMetrics(const JunkDetectionMetrics &metrics);
+  void setDeadMutantMetrics(const DeadMutantMetrics &metrics);
+
   void dump() const;
 
+  /// The phases of the run and the compilation of every module, for the
+  /// timing history. The phases that did not run are left out.
+  std::vector<Timing> timings() const;
+
+  /// Writes the trace in the Trace Event Format. The modules, the tests and
+  /// the mutants the samples refer to must still be around.
+  void writeTrace(llvm::raw_ostream &stream) const;
+
   const MetricsMeasure &driverRunTime() const { return runTime; }
 
   void setDriverRunTime(MetricsMeasure measure) { runTime = measure; }
 
 private:
+  struct SampleChunk {
+    static const size_t Capacity = 1024;
+    MetricsSample samples[Capacity];
+    size_t size = 0;
+  };
+
+  struct ThreadSamples {
+    std::thread::id thread;
+    std::vector<std::unique_ptr<SampleChunk>> chunks;
+    std::vector<std::string> details;
+  };
+
+  /// The measures the samples are merged into
+  struct StepMeasures {
+    std::map<const llvm::Module *, MetricsMeasure> originalModuleCompilation;
+    std::map<const llvm::Module *, MetricsMeasure>
+        instrumentedModuleCompilation;
+    std::map<const Test *, MetricsMeasure> runOriginalTest;
+    std::map<const Test *, MetricsMeasure> findMutations;
+    std::map<const MutationPoint *, MetricsMeasure> compileMutant;
+    std::map<const MutationPoint *, MetricsMeasure> loadMutant;
+    std::map<const MutationPoint *, std::map<const Test *, MetricsMeasure>>
+        mutantRuns;
+  };
+
+  ThreadSamples &samplesOfThisThread();
+  void record(MetricsStep step, char phase, const char *name,
+              const void *key = nullptr, const Test *test = nullptr,
+              int64_t duration = 0, int32_t detail = -1);
+  /// Index of the detail in the samples of the thread
+  int32_t addDetail(const std::string &detail);
+  void recordPhase(char phase, const char *name);
+  void beginPhaseMemory(const char *name);
+  void endPhaseMemory(const char *name);
+  StepMeasures mergeSamples() const;
+
+  uint64_t id;
+  static std::atomic<uint64_t> nextId;
+  std::atomic<bool> tracing;
+
+  /// Taken by a thread to add its buffer, and to read the buffers
+  mutable std::mutex samplesMutex;
+  std::vector<std::unique_ptr<ThreadSamples>> samples;
+
   MetricsMeasure loadModules;
   MetricsMeasure loadPrecompiledObjectFiles;
   MetricsMeasure loadDynamicLibraries;
@@ -97,17 +385,22 @@ private:
   MetricsMeasure originalTestsExecution;
   MetricsMeasure mutantsExecution;
 
-  std::map<const llvm::Module *, MetricsMeasure> originalModuleCompilation;
-  std::map<const llvm::Module *, MetricsMeasure> instrumentedModuleCompilation;
-
-  std::map<const Test *, MetricsMeasure> runOriginalTest;
-  std::map<const Test *, MetricsMeasure> findMutations;
-
-  std::map<const MutationPoint *, MetricsMeasure> compileMutant;
-  std::map<const MutationPoint *, MetricsMeasure> loadMutant;
-
-  std::map<const MutationPoint *, std::map<const Test *, MetricsMeasure>>
-      mutantRuns;
+  std::vector<std::pair<std::string, std::vector<WorkerMetrics>>>
+      workersMetrics;
+
+  std::vector<PhaseMemoryUsage> memoryUsage;
+  MemoryMetrics memory;
+
+  ObjectCacheMetrics objectCache;
+  JunkDetectionMetrics junkDetection;
+  DeadMutantMetrics deadMutants;
+  LatencyHistograms latencyHistograms;
+  std::atomic<uint64_t> timedOutRuns;
+  std::atomic<uint64_t> timedOutMilliseconds;
+  std::atomic<uint64_t> countedRuns;
+  std::atomic<uint64_t> instructionOutliers;
+  mutable std::mutex usageMutex;
+  UsageMetrics usage;
 };
 
 } // namespace mull
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+struct sqlite3;
+
+namespace mull {
+
+/// A phase of a run, or the compilation of one of its modules, and the
+/// milliseconds it took, see Metrics::timings
+struct Timing {
+  std::string name;
+  double milliseconds;
+
+  Timing(std::string name, double milliseconds)
+      : name(std::move(name)), milliseconds(milliseconds) {}
+};
+
+/// The timings of the previous runs, in a SQLite database every run adds
+/// to. A run is compared with the last runs of the same workload, so that a
+/// phase that became slower shows up right away, e.g. the compilation after
+/// an update of the toolchain. The workload is the project of a run of
+/// mull, or the size of the synthetic program of the benchmark suite.
+class TimingHistory {
+public:
+  /// A timing and the median of the same timing over the previous runs
+  struct Regression {
+    std::string name;
+    double milliseconds;
+    double baseline;
+    unsigned runs;
+  };
+
+  explicit TimingHistory(const std::string &path);
+  ~TimingHistory();
+  TimingHistory(const TimingHistory &) = delete;
+  TimingHistory &operator=(const TimingHistory &) = delete;
+
+  /// Creates the database if needed. False, with the reason, when it
+  /// cannot be opened.
+  bool open(std::string &error);
+
+  /// The timings that took `factor` times their median over the last
+  /// `runs` runs of the workload or more, and `noise` milliseconds more at
+  /// least. The timings the previous runs do not have are skipped.
+  std::vector<Regression> compare(const std::string &workload,
+                                  const std::vector<Timing> &timings,
+                                  unsigned runs, double factor,
+                                  double noise) const;
+
+  /// Adds the timings as the latest run of the workload
+  bool record(const std::string &workload,
+              const std::vector<Timing> &timings);
+
+private:
+  std::string path;
+  sqlite3 *database;
+};
+
+} // namespace mull
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "MullModule.h"
+#include "mull/Config/ConfigurationOptions.h"
 
 #include <string>
 #include <vector>
@@ -15,8 +16,14 @@ namespace mull {
 
 struct Configuration;
 
+/// A lazy module refers to the buffer, only the static initializers are read
+/// up front for the test finders. A known hash of the buffer, e.g. a cached
+/// one, is used as is.
 std::pair<std::string, std::unique_ptr<llvm::Module>>
-loadModuleFromBuffer(llvm::LLVMContext &context, llvm::MemoryBuffer &buffer);
+loadModuleFromBuffer(llvm::LLVMContext &context, llvm::MemoryBuffer &buffer,
+                     bool lazy = false,
+                     HashAlgorithm hashAlgorithm = HashAlgorithm::MD5,
+                     const std::string &knownHash = std::string());
 
 class ModuleLoader {
   std::vector<std::unique_ptr<llvm::LLVMContext>> contexts;
@@ -26,7 +33,10 @@ public:
   ~ModuleLoader() = default;
 
   std::unique_ptr<MullModule> loadModuleAtPath(const std::string &path,
-                                               llvm::LLVMContext &context);
+                                               llvm::LLVMContext &context,
+                                               bool lazy = false,
+                                               HashAlgorithm hashAlgorithm =
+                                                   HashAlgorithm::MD5);
 
   std::vector<std::unique_ptr<MullModule>>
   loadModules(const Configuration &config);
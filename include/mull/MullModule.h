@@ -2,46 +2,132 @@
 
 #include <string>
 #include <thread>
+#include <unordered_map>
+
+#include "mull/Config/ConfigurationOptions.h"
+#include "mull/MutationPointArena.h"
 
 #include <llvm/IR/Module.h>
 #include <llvm/Support/MemoryBuffer.h>
 
 namespace llvm {
+class CallInst;
 class LLVMContext;
 }
 
 namespace mull {
 
-class MutationPoint;
 class JITEngine;
 
 class MullModule {
 public:
   MullModule(std::unique_ptr<llvm::Module> llvmModule,
              std::unique_ptr<llvm::MemoryBuffer> buffer,
-             const std::string &md5);
+             const std::string &hash,
+             HashAlgorithm hashAlgorithm = HashAlgorithm::MD5);
 
   std::unique_ptr<MullModule> clone(llvm::LLVMContext &context);
+  /// Size of the bitcode the module was read from, 0 for a clone
+  size_t getBitcodeSize() const;
 
   llvm::Module *getModule();
   llvm::Module *getModule() const;
+  /// Also known once the IR is released
+  const std::string &getModuleIdentifier() const;
   std::string getUniqueIdentifier();
   std::string getUniqueIdentifier() const;
 
   std::string getInstrumentedUniqueIdentifier() const;
   std::string getMutatedUniqueIdentifier() const;
 
-  std::vector<std::string> prepareMutations();
-  void addMutation(MutationPoint *point);
+  /// Clones the mutated functions, returns the names of the trampolines.
+  /// With schemata the original function becomes a switch over a global
+  /// mutant id instead, and needs no trampoline. With guarded schemata
+  /// the mutants of a function that only change their own instruction share
+  /// one clone: each of them runs a copy of the instruction instead of it
+  /// when the mutant id is its own. The shared clone cannot be told apart
+  /// per mutant, so hashMutations needs a clone per mutant.
+  std::vector<std::string> prepareMutations(bool schemata = false,
+                                            bool guardedSchemata = false);
+  /// The names returned by prepareMutations
+  const std::vector<std::string> &getTrampolineNames() const;
+  /// Hashes the mutated clones once canonicalized, see
+  /// MutationPoint::getMutantHash, and marks the ones that are canonicalized
+  /// the same as their original function as equivalent.
+  /// Must be called after the mutations are applied, before they are
+  /// inlined or split.
+  void hashMutations();
+  /// Merges the mutated clones into the bodies of their schemata,
+  /// must be called after the mutations are applied
+  void inlineSchemata();
+  /// Moves the original copy and the mutated clones of every mutated
+  /// function into a satellite module of its own, so that the rest of the
+  /// module does not depend on the mutation points and is compiled (or taken
+  /// from cache) once, and a change of the mutation points of one function
+  /// recompiles only its satellite.
+  /// Must be called after the mutations are applied, not with schemata.
+  void splitMutatedFunctions();
+  /// 0 unless the mutated functions were split
+  size_t getSatelliteCount() const;
+  llvm::Module *getSatelliteModule(size_t index);
+  /// Depends on the mutation points of the function only: the points are
+  /// identified by the module, their address and their mutator
+  std::string getSatelliteUniqueIdentifier(size_t index) const;
+  /// The point lives in the arena of the module and is destroyed with it
+  MutationPoint *createMutationPoint(Mutator *mutator,
+                                     const MutationPointAddress &address,
+                                     llvm::Value *value,
+                                     llvm::Function *function,
+                                     const std::string &diagnostics,
+                                     const SourceLocation &location);
+  /// The strings the mutation points of the module share
+  const std::string *internString(const std::string &string);
+  /// Registers the points found by a search, grouped by their functions,
+  /// in one go rather than point by point
+  void addMutations(
+      const std::map<llvm::Function *, std::vector<MutationPoint *>> &points);
+  /// Position of the function in the module as loaded, the functions cloned
+  /// later are appended and keep the positions of the others intact
+  int getFunctionIndex(llvm::Function *function) const;
+  /// Forgets the mutation points not in the list, so that prepareMutations
+  /// clones the functions only for the mutants that are going to run
+  void retainMutations(const std::vector<MutationPoint *> &points);
+  /// A lazily loaded module reads the body of a function on demand. Reading
+  /// a body changes the context of the module, so the calls are serialized
+  /// across all the modules. Both do nothing for a module loaded eagerly.
+  static bool materialize(const llvm::Function *function);
+  bool materializeAll();
+  /// Drops the debug info of the module, or all of it but the line tables,
+  /// before it is compiled. The mutation points keep the locations they
+  /// were found at. Must be called once the module is materialized.
+  void stripDebugInfo(bool keepLineTables);
+  /// Frees the module, its bitcode and the clones of its mutated functions,
+  /// and releases its mutation points, see MutationPoint::releaseIR. Only
+  /// the identifiers are left.
+  void releaseIR();
 
 private:
   std::unique_ptr<llvm::Module> module;
   std::unique_ptr<llvm::MemoryBuffer> buffer;
+  std::string moduleIdentifier;
   std::string uniqueIdentifier;
+  /// Also hashes the mutation points into the identifiers
+  HashAlgorithm hashAlgorithm;
 
+  /// Outlives the lists of the points below
+  MutationPointArena mutationPointArena;
   std::map<llvm::Function *, std::vector<MutationPoint *>> mutationPoints;
   std::mutex mutex;
+  bool schemataEnabled;
+  std::vector<std::string> trampolineNames;
+  std::vector<llvm::CallInst *> schemataCalls;
+  std::vector<std::unique_ptr<llvm::Module>> satellites;
+  std::vector<std::string> satelliteIdentifiers;
+  /// Identifies the rest of the module once the mutated functions are split
+  std::string splitIdentifier;
+  std::unordered_map<const llvm::Function *, int> functionIndices;
 
+  void indexFunctions();
   explicit MullModule(std::unique_ptr<llvm::Module> llvmModule);
 };
 
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "mull/Config/ConfigurationOptions.h"
+
+#include <vector>
+
+namespace mull {
+
+struct Configuration;
+class MutationPoint;
+
+/// The time the reachable tests of a mutant took during the original run,
+/// in milliseconds. Every test counts at least 1ms so that the number of
+/// tests matters when the tests are faster than the precision.
+long long estimatedMutantCost(const MutationPoint *point);
+
+/// Longest Processing Time first: the most expensive mutants are dispatched
+/// first, so the long tail lands at the beginning of the run instead of
+/// at the end. Mutants of the same cost keep their order.
+std::vector<MutationPoint *>
+longestFirst(const std::vector<MutationPoint *> &points);
+
+/// The mutants of one of `count` shards, see ShardConfig. The most
+/// expensive mutants go first, each to the shard with the smallest cost so
+/// far, so that the shards take about as long. Ties are broken by the
+/// identifiers of the mutants: the jobs that find the same mutants agree on
+/// the shards without talking to each other. The order is kept.
+std::vector<MutationPoint *>
+shardMutants(const std::vector<MutationPoint *> &points, int index,
+             int count);
+
+/// Picks the mutants that run when there are too many of them, see
+/// SamplingConfig. The same mutants and the same seed give the same sample.
+/// The sample keeps the order of the mutants.
+class MutantSampler {
+public:
+  /// The mutants of the time budget run on all the workers at once
+  MutantSampler(const SamplingConfig &config, int workers);
+  explicit MutantSampler(const Configuration &config);
+
+  std::vector<MutationPoint *>
+  sample(const std::vector<MutationPoint *> &points) const;
+
+private:
+  std::vector<size_t> uniform(const std::vector<MutationPoint *> &points,
+                              size_t size) const;
+  std::vector<size_t> stratified(const std::vector<MutationPoint *> &points,
+                                 size_t size) const;
+  std::vector<size_t> budgeted(const std::vector<MutationPoint *> &points,
+                               long long budget) const;
+
+  SamplingConfig config;
+  int workers;
+};
+
+} // namespace mull
@@ -5,6 +5,7 @@
 #include <string>
 #include <vector>
 
+#include "ReachableTests.h"
 #include "SourceLocation.h"
 
 namespace llvm {
@@ -27,12 +28,17 @@ class Test;
 /// MutationPoints. We need the indexes of function, basic block and instruction
 /// to find the mutation point in the clone of original module, when mutator is
 /// to apply mutation in that clone.
+/// The address also remembers the instruction itself within one function
+/// (the original one, then the clone the mutation is applied to), so that
+/// finding the instruction in that function does not walk the lists.
+/// The identifier is derived from the indexes when asked for.
 class MutationPointAddress {
   int FnIndex;
   int BBIndex;
   int IIndex;
 
-  std::string identifier;
+  llvm::Function *knownFunction;
+  llvm::Instruction *knownInstruction;
 
 public:
   MutationPointAddress(int FnIndex, int BBIndex, int IIndex);
@@ -45,6 +51,9 @@ public:
 
   std::string getIdentifier() const;
 
+  /// nullptr forgets the instruction, e.g. once a mutator replaced it
+  void setInstruction(llvm::Instruction *instruction);
+
   llvm::Instruction &findInstruction(llvm::Module *module);
   llvm::Instruction &findInstruction(llvm::Function *function);
   llvm::Function &findFunction(llvm::Module *module);
@@ -55,6 +64,10 @@ public:
       const std::function<void(llvm::Instruction &, int, int)> &block);
 };
 
+/// The points are usually allocated in the arena of their module, see
+/// MullModule::createMutationPoint. A point keeps pointers and indexes only:
+/// its strings are interned in the arena of the module, and its identifier
+/// is derived from the module, the address and the mutator when asked for.
 class MutationPoint {
   Mutator *mutator;
   MutationPointAddress Address;
@@ -62,10 +75,18 @@ class MutationPoint {
   MullModule *module;
   llvm::Function *originalFunction;
   llvm::Function *mutatedFunction;
-  std::string uniqueIdentifier;
-  std::string diagnostics;
+  const std::string *diagnostics;
+  /// Only set once the IR is released
+  const std::string *functionName;
+  const std::string *functionHash;
+  const std::string *mutantHash;
   const SourceLocation sourceLocation;
-  std::vector<std::pair<Test *, int>> reachableTests;
+  int schemaIndex;
+  bool equivalent;
+  /// The copies of a canonical point form a list, see setCanonical
+  MutationPoint *canonical;
+  MutationPoint *nextOdrCopy;
+  std::shared_ptr<const ReachableTests> reachableTests;
 
 public:
   MutationPoint(Mutator *mutator, MutationPointAddress Address,
@@ -81,7 +102,21 @@ public:
   MullModule *getOriginalModule();
 
   llvm::Function *getOriginalFunction();
-  void setMutatedFunction(llvm::Function *function);
+  /// The instruction of the mutation in the clone, when known, spares
+  /// the mutator the lookup of the instruction by its indices
+  void setMutatedFunction(llvm::Function *function,
+                          llvm::Instruction *mutatedInstruction = nullptr);
+  /// The function holds the other mutants of the original function as well,
+  /// each of them guarded by the mutant id, and keeps its own name
+  void shareMutatedFunction(llvm::Function *function,
+                            llvm::Instruction *mutatedInstruction);
+  /// nullptr until the mutations of the module are prepared
+  llvm::Function *getMutatedFunction();
+
+  /// Index of the mutant within the schema of its function,
+  /// 0 if the mutant is activated through a trampoline
+  int getSchemaIndex() const;
+  void setSchemaIndex(int index);
 
   Mutator *getMutator() const;
   MutationPointAddress getAddress() const;
@@ -89,10 +124,16 @@ public:
   MullModule *getOriginalModule() const;
   const SourceLocation &getSourceLocation() const;
 
+  /// Copies the list first if other points share it
   void addReachableTest(Test *test, int distance);
   void applyMutation();
 
-  const std::vector<std::pair<Test *, int>> &getReachableTests() const;
+  const ReachableTests &getReachableTests() const;
+  /// The list is shared with the testee of the function and its other
+  /// points, see MergedTestee::getSharedReachableTests
+  const std::shared_ptr<const ReachableTests> &getSharedReachableTests() const;
+  /// Also reorders the reachable tests, see prioritizeReachableTests
+  void setReachableTests(std::shared_ptr<const ReachableTests> tests);
 
   std::string getUniqueIdentifier();
   std::string getUniqueIdentifier() const;
@@ -100,9 +141,43 @@ public:
   const std::string &getDiagnostics();
   const std::string &getDiagnostics() const;
 
+  /// The hash of the body of the original function, see hashOfFunctionBody.
+  /// It tells whether the point is the same as in a previous run.
+  const std::string &getFunctionHash() const;
+  void setFunctionHash(const std::string &hash);
+
+  /// The hash of the mutated function once canonicalized, see
+  /// MullModule::hashMutations: the mutants of a function with the same hash
+  /// behave the same. Empty unless the mutations were hashed.
+  const std::string &getMutantHash() const;
+  void setMutantHash(const std::string &hash);
+  /// Whether the mutated function is canonicalized the same as the original
+  /// one, no test can tell the mutant apart
+  bool isEquivalent() const;
+  void setEquivalent(bool equivalent);
+
+  /// The point is the same mutant as the canonical one in another copy of
+  /// a linkonce_odr or weak_odr function. The copy is not cloned nor run,
+  /// its trampoline points to the mutated function of the canonical point
+  /// while the canonical one runs.
+  void setCanonical(MutationPoint *canonical);
+  /// nullptr unless the point is a copy of another one
+  MutationPoint *getCanonical() const;
+  /// The points whose canonical point this one is
+  std::vector<MutationPoint *> getOdrCopies() const;
+
+  /// The name of the original function, also known once the IR is released
+  std::string getFunctionName() const;
+  /// Forgets the functions and the value of the point, only what identifies
+  /// it and what the reports need is left, see Program::releaseIR
+  void releaseIR();
+
   std::string getTrampolineName();
   std::string getMutatedFunctionName();
   std::string getOriginalFunctionName();
+  std::string getMutantIdName();
+  /// The clone shared by the guarded mutants of the function
+  std::string getGuardedFunctionName();
 };
 
 } // namespace mull
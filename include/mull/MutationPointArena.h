@@ -0,0 +1,42 @@
+#pragma once
+
+#include "mull/MutationPoint.h"
+
+#include <llvm/Support/Allocator.h>
+
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+namespace mull {
+
+/// The mutation points of one module: they are allocated out of slabs
+/// rather than one by one, and are destroyed together with the module.
+/// The strings many points share, such as the diagnostics of a mutator or
+/// the hash of a function, are kept once.
+class MutationPointArena {
+public:
+  MutationPointArena();
+  ~MutationPointArena();
+
+  MutationPointArena(const MutationPointArena &) = delete;
+  MutationPointArena &operator=(const MutationPointArena &) = delete;
+
+  MutationPoint *create(Mutator *mutator, const MutationPointAddress &address,
+                        llvm::Value *value, llvm::Function *function,
+                        const std::string &diagnostics,
+                        const SourceLocation &location, MullModule *module);
+
+  /// The same string for the same contents, valid as long as the arena
+  const std::string *intern(const std::string &string);
+
+  size_t size() const;
+
+private:
+  std::mutex mutex;
+  llvm::SpecificBumpPtrAllocator<MutationPoint> allocator;
+  std::unordered_set<std::string> strings;
+  size_t count;
+};
+
+} // namespace mull
@@ -19,9 +19,10 @@ public:
       : Result(std::move(R)), MutPoint(MP), distance(distance), test(test) {}
 
   ExecutionResult &getExecutionResult() { return Result; }
-  MutationPoint *getMutationPoint() { return MutPoint; }
-  int getMutationDistance() { return distance; }
-  Test *getTest() { return test; }
+  const ExecutionResult &getExecutionResult() const { return Result; }
+  MutationPoint *getMutationPoint() const { return MutPoint; }
+  int getMutationDistance() const { return distance; }
+  Test *getTest() const { return test; }
 };
 
 } // namespace mull
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "mull/ExecutionResult.h"
+#include "mull/MutationResult.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace mull {
+
+class MutationPoint;
+class Test;
+
+/// The results of the mutants, one row per (mutant, test), as parallel
+/// columns. The rows refer to the points and the tests by index, and to the
+/// outputs only when they have some, so a row takes a few dozen bytes
+/// instead of a MutationResult allocated on its own.
+/// The sandbox timings are not kept: the metrics take them as the results
+/// come in.
+///
+/// Each worker appends to a table of its own, the tables are then appended
+/// to one another in bulk. The rows are read back as MutationResults.
+///
+/// Under a result memory budget, see setResultMemoryBudget, a table moves
+/// its rows to a segment file once the rows of all the tables take more
+/// than the budget. The segments are appended to, never changed, and are
+/// mapped back: the spilled rows come first, the rows in memory after them.
+class MutationResultTable {
+public:
+  using value_type = MutationResult;
+
+  class const_iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = MutationResult;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const MutationResult *;
+    using reference = MutationResult;
+
+    const_iterator(const MutationResultTable *table, size_t row)
+        : table(table), row(row) {}
+
+    MutationResult operator*() const { return (*table)[row]; }
+    const_iterator &operator++() {
+      row++;
+      return *this;
+    }
+    const_iterator operator++(int) {
+      const_iterator previous(*this);
+      row++;
+      return previous;
+    }
+    bool operator==(const const_iterator &other) const {
+      return row == other.row;
+    }
+    bool operator!=(const const_iterator &other) const {
+      return row != other.row;
+    }
+
+  private:
+    const MutationResultTable *table;
+    size_t row;
+  };
+
+  void add(const MutationResult &result);
+  /// Moves the rows of the other table after the rows of this one
+  void append(MutationResultTable &other);
+  void reserve(size_t rows);
+  /// Puts the rows in the given order: order[i] is the row that ends up at i
+  void reorder(const std::vector<size_t> &order);
+  /// Puts the rows back into the order of the points, the rows of the same
+  /// point keep their order
+  void restoreMutantsOrder(const std::vector<MutationPoint *> &points);
+
+  size_t size() const { return spilledRows + pointRows.size(); }
+  bool empty() const { return size() == 0; }
+  /// The rows in the segment files
+  size_t getSpilledRows() const { return spilledRows; }
+
+  MutationResult operator[](size_t row) const;
+  MutationPoint *getMutationPoint(size_t row) const;
+  Test *getTest(size_t row) const;
+  int getMutationDistance(size_t row) const;
+  ExecutionStatus getStatus(size_t row) const;
+  ExecutionResult getExecutionResult(size_t row) const;
+
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, size()); }
+
+private:
+  struct SpilledRow;
+  struct Segment;
+
+  /// The bytes of the rows a table holds in memory, counted towards the
+  /// budget of all the tables. Copies count again, moves do not.
+  class MemoryShare {
+  public:
+    MemoryShare() : bytes(0) {}
+    MemoryShare(const MemoryShare &other);
+    MemoryShare(MemoryShare &&other);
+    MemoryShare &operator=(const MemoryShare &other);
+    MemoryShare &operator=(MemoryShare &&other);
+    ~MemoryShare();
+
+    void add(size_t added);
+    void release();
+    size_t get() const { return bytes; }
+
+  private:
+    size_t bytes;
+  };
+
+  uint32_t indexOfPoint(MutationPoint *point);
+  uint32_t indexOfTest(Test *test);
+  /// Moves the rows in memory to a new segment, false if they stay
+  bool spill();
+  void spillIfOverBudget();
+  const SpilledRow &spilledRow(size_t row, const Segment *&segment) const;
+
+  /// The results of a point mostly come one after another, so a point is
+  /// only added again when it differs from the last one
+  std::vector<MutationPoint *> points;
+  std::vector<Test *> tests;
+  /// By the id of the test, see Test::getId: the index of the test plus
+  /// one, 0 for the tests not in the table
+  std::vector<uint32_t> testIndices;
+  /// stdout and stderr, shared with the ExecutionOutputStore
+  std::vector<std::pair<ExecutionOutput, ExecutionOutput>> outputs;
+
+  std::vector<uint32_t> pointRows;
+  std::vector<uint32_t> testRows;
+  std::vector<int32_t> distances;
+  std::vector<uint8_t> statuses;
+  std::vector<int32_t> exitStatuses;
+  std::vector<int64_t> runningTimes;
+  /// The index of the outputs of the row plus one, 0 if it has none
+  std::vector<uint32_t> outputRows;
+
+  /// Shared by the copies of the table, unmapped along with the last one
+  std::vector<std::shared_ptr<const Segment>> segments;
+  /// The index of the segments: the rows up to the end of each of them
+  std::vector<size_t> segmentEnds;
+  size_t spilledRows = 0;
+  MemoryShare memory;
+};
+
+/// Bytes the rows in memory of all the tables may take before the table
+/// that adds a row spills its rows, 0 keeps every row in memory. A table
+/// spills once it holds a megabyte or the whole budget, whichever is less,
+/// so a run may exceed the budget by up to a megabyte per worker.
+void setResultMemoryBudget(size_t bytes);
+
+/// The storages of the workers are appended table by table, see
+/// TaskExecutor
+void appendStorages(MutationResultTable &out,
+                    std::vector<MutationResultTable> &storages);
+
+} // namespace mull
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace mull {
+
+class MullModule;
+
+/// The mutation points the searches of the previous runs found, one file per
+/// module under <cache>/mutations/, named after the MD5 of the version of
+/// the search, the search key and the unique identifier of the module, i.e.
+/// the hash of its bitcode. The search key identifies the mutators, the
+/// filter and everything else that decides which points a function has, see
+/// MutationsFinder. A function of an unchanged module then gets its points
+/// back without the search walking its instructions.
+class MutationSearchCache {
+public:
+  /// A point of a function, the mutator is its position in the mutators of
+  /// the search
+  struct Point {
+    uint32_t mutator;
+    int basicBlock;
+    int instruction;
+  };
+
+  /// In the order the search reports them, with the points it left out as
+  /// equivalent
+  struct FunctionPoints {
+    FunctionPoints() : deadValues(0), deadStores(0) {}
+    std::vector<Point> points;
+    uint64_t deadValues;
+    uint64_t deadStores;
+  };
+
+  /// An empty directory disables the cache
+  MutationSearchCache(const std::string &cacheDirectory,
+                      const std::string &version);
+
+  /// The lookups from now on use the points stored under the key. The
+  /// points of another key are saved first.
+  void setSearchKey(const std::string &key);
+
+  /// Thread safe, the points of a module are read on its first lookup.
+  /// Returns false if none are stored for the function.
+  bool lookup(const MullModule &module, const std::string &function,
+              FunctionPoints &points);
+
+  /// Thread safe
+  void store(const MullModule &module, const std::string &function,
+             FunctionPoints points);
+
+  /// Writes the files of the modules that got new points
+  void save();
+
+  uint64_t getHits() const;
+
+private:
+  struct Entry {
+    Entry() : changed(false) {}
+    std::string path;
+    bool changed;
+    std::map<std::string, FunctionPoints> functions;
+  };
+
+  Entry &entryOf(const MullModule &module);
+  bool read(Entry &entry);
+  void write(const Entry &entry);
+  void saveEntries();
+
+  std::string cacheDirectory;
+  std::string version;
+  std::string searchKey;
+
+  std::mutex mutex;
+  std::map<std::string, Entry> entries;
+
+  std::atomic<uint64_t> hits;
+};
+
+} // namespace mull
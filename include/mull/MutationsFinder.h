@@ -5,7 +5,10 @@
 
 #include "MutationPoint.h"
 #include "Testee.h"
+#include "mull/Metrics/Metrics.h"
+#include "mull/MutationSearchCache.h"
 #include "mull/Mutators/Mutator.h"
+#include "mull/Parallelization/Tasks/SearchMutationPointsTask.h"
 
 namespace llvm {
 class Function;
@@ -13,6 +16,7 @@ class Function;
 
 namespace mull {
 struct Configuration;
+class BlockCoverage;
 class Program;
 class Filter;
 class Testee;
@@ -21,13 +25,33 @@ class MutationsFinder {
 public:
   explicit MutationsFinder(std::vector<std::unique_ptr<Mutator>> mutators,
                            const Configuration &config);
+  /// The points are also pushed into the stream as soon as the search of
+  /// their function is over, the stream is not closed here
   std::vector<MutationPoint *>
   getMutationPoints(const Program &program, std::vector<MergedTestee> &testees,
-                    Filter &filter);
+                    Filter &filter, MutationPointStream *stream = nullptr);
+  /// The points the searches so far left out as equivalent, with equivalent
+  /// mutant pruning enabled
+  const DeadMutantMetrics &getDeadMutants() const { return deadMutants; }
+  /// The searches from now on attach to a point only the tests that
+  /// executed its block, see SearchMutationPointsTask
+  void setBlockCoverage(const BlockCoverage *coverage) {
+    blockCoverage = coverage;
+  }
+  /// The functions whose points came from the mutation search cache
+  uint64_t getCachedFunctions() const;
 
 private:
   std::vector<std::unique_ptr<Mutator>> mutators;
-  std::vector<std::unique_ptr<MutationPoint>> ownedPoints;
+  /// Every point found so far, the modules own them
+  std::vector<MutationPoint *> foundPoints;
+  DeadMutantMetrics deadMutants;
+  const BlockCoverage *blockCoverage;
   const Configuration &config;
+  /// nullptr unless the configuration asks for it
+  std::unique_ptr<MutationSearchCache> cache;
+
+  /// Identifies what decides the points of a function besides its body
+  std::string searchKey(const Filter &filter) const;
 };
 } // namespace mull
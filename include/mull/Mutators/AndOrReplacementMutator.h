@@ -2,6 +2,9 @@
 
 #include "Mutator.h"
 
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/IR/ValueHandle.h>
+
 #include <vector>
 
 enum AND_OR_MutationType {
@@ -32,6 +35,23 @@ class MutationPointAddress;
 
 class AndOrReplacementMutator : public Mutator {
 
+  /// The conditional branches of a function in order, by their successors,
+  /// so that the branch completing a pattern with a given one is found
+  /// without walking the function again for every branch. The handle lets
+  /// go of a function once it is deleted.
+  struct BranchIndex {
+    llvm::WeakVH function;
+    std::vector<BranchInst *> branches;
+    llvm::DenseMap<const BranchInst *, size_t> positions;
+    llvm::DenseMap<llvm::Value *, std::vector<size_t>> byLeft;
+    llvm::DenseMap<llvm::Value *, std::vector<size_t>> byRight;
+
+    void build(llvm::Function *function);
+    /// The same as findPossibleMutationInBranch
+    AND_OR_MutationType find(BranchInst *branchInst,
+                             BranchInst **secondBranchInst);
+  };
+
   AND_OR_MutationType
   findPossibleMutationInBranch(BranchInst *branchInst,
                                BranchInst **secondBranchInst);
@@ -68,6 +88,7 @@ public:
     return MutatorKind::AndOrReplacementMutator;
   }
 
+  std::vector<unsigned> getOpcodes() const override;
   bool canBeApplied(llvm::Value &V) override;
   llvm::Value *applyMutation(Function *function,
                              MutationPointAddress &address) override;
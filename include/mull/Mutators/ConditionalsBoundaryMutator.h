@@ -36,6 +36,7 @@ public:
                                   SourceLocation &sourceLocation,
                                   MutationPointAddress &address) override;
 
+  std::vector<unsigned> getOpcodes() const override;
   bool canBeApplied(llvm::Value &V) override;
   llvm::Value *applyMutation(llvm::Function *function,
                              MutationPointAddress &address) override;
@@ -30,6 +30,7 @@ public:
   std::string getDescription() const override { return description; }
   MutatorKind mutatorKind() override { return MutatorKind::MathDivMutator; }
 
+  std::vector<unsigned> getOpcodes() const override;
   bool canBeApplied(llvm::Value &V) override;
   llvm::Value *applyMutation(llvm::Function *function,
                              MutationPointAddress &address) override;
@@ -45,6 +45,16 @@ public:
 
   virtual std::string getDescription() const = 0;
 
+  /// Opcodes of the instructions the mutator can be applied to. The search
+  /// hands only these instructions to getMutationPoint, an empty list means
+  /// any instruction.
+  virtual std::vector<unsigned> getOpcodes() const { return {}; }
+
+  /// Whether the mutants only replace operands of their instruction, so
+  /// that they are equivalent when the instruction cannot be observed, see
+  /// isObservable
+  virtual bool replacesOperandsOnly() const { return false; }
+
   virtual bool canBeApplied(llvm::Value &V) = 0;
   virtual llvm::Value *applyMutation(llvm::Function *function,
                                      MutationPointAddress &address) = 0;
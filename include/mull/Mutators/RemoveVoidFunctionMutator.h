@@ -35,6 +35,7 @@ public:
   std::string getUniqueIdentifier() const override { return ID; }
   std::string getDescription() const override { return description; }
 
+  std::vector<unsigned> getOpcodes() const override;
   bool canBeApplied(llvm::Value &V) override;
   llvm::Value *applyMutation(llvm::Function *function,
                              MutationPointAddress &address) override;
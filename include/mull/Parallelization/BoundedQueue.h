@@ -0,0 +1,85 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace mull {
+
+/// Hands items over from the producers of one phase to the consumers of the
+/// next one. The producers block while the queue is full, so a fast phase
+/// cannot run arbitrarily far ahead of a slow one. Once the producers are
+/// done the queue is closed, and the consumers drain what is left.
+template <typename T> class BoundedQueue {
+public:
+  explicit BoundedQueue(size_t capacity) : capacity(capacity), closed(false) {}
+
+  void push(T item) {
+    std::unique_lock<std::mutex> lock(mutex);
+    notFull.wait(lock, [this]() { return items.size() < capacity || closed; });
+    items.push_back(std::move(item));
+    notEmpty.notify_one();
+  }
+
+  /// Returns false when the queue is closed and empty
+  bool pop(T &item) {
+    std::unique_lock<std::mutex> lock(mutex);
+    notEmpty.wait(lock, [this]() { return !items.empty() || closed; });
+    if (items.empty()) {
+      return false;
+    }
+    item = std::move(items.front());
+    items.pop_front();
+    notFull.notify_one();
+    return true;
+  }
+
+  void close() {
+    std::lock_guard<std::mutex> lock(mutex);
+    closed = true;
+    notEmpty.notify_all();
+    notFull.notify_all();
+  }
+
+private:
+  size_t capacity;
+  bool closed;
+  std::deque<T> items;
+  std::mutex mutex;
+  std::condition_variable notEmpty;
+  std::condition_variable notFull;
+};
+
+/// A bounded queue per consumer: the items pushed with the same key always
+/// go to the same consumer, e.g. the mutation points of a source file to the
+/// worker that owns the file
+template <typename T> class PartitionedQueue {
+public:
+  PartitionedQueue(size_t partitions, size_t capacity) {
+    for (size_t index = 0; index < partitions; index++) {
+      queues.emplace_back(new BoundedQueue<T>(capacity));
+    }
+  }
+
+  void push(size_t key, T item) {
+    queues[key % queues.size()]->push(std::move(item));
+  }
+
+  BoundedQueue<T> &partition(size_t index) { return *queues[index]; }
+  size_t partitions() const { return queues.size(); }
+
+  void close() {
+    for (auto &queue : queues) {
+      queue->close();
+    }
+  }
+
+private:
+  std::vector<std::unique_ptr<BoundedQueue<T>>> queues;
+};
+
+} // namespace mull
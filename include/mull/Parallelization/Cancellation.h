@@ -0,0 +1,47 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace mull {
+
+/// Stops a run early. The executors check it before they hand out the next
+/// item, the items that already ran keep their results and are reported.
+/// A run is cancelled by SIGINT or SIGTERM, once its deadline has passed,
+/// or by the gate mode as soon as a mutant survives.
+class Cancellation {
+public:
+  enum class Reason { None, Interrupted, Deadline, Survivor };
+
+  static Cancellation &shared();
+
+  /// The first reason sticks. Only stores to atomics, safe in a signal
+  /// handler.
+  void cancel(Reason reason);
+  /// Also cancels the run once the deadline has passed
+  bool cancelled();
+  Reason reason() const;
+
+  /// The run is cancelled `seconds` from now, zero or less means never
+  void setDeadline(int seconds);
+  /// Forgets the cancellation and the deadline
+  void reset();
+
+  /// SIGINT and SIGTERM cancel the run of this process, a second one ends
+  /// it. The children it forks die of them as usual.
+  void installSignalHandlers();
+
+  static const char *reasonToString(Reason reason);
+
+private:
+  Cancellation();
+
+  using clock = std::chrono::steady_clock;
+
+  std::atomic<int> cancelReason;
+  /// Ticks of the steady clock, zero when there is no deadline
+  std::atomic<int64_t> deadline;
+};
+
+} // namespace mull
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "mull/ExecutionResult.h"
+
+#include <functional>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace mull {
+
+/// The result of a mutant as the nodes of a distributed run exchange it,
+/// the mutant and the test by their unique identifiers
+struct StoredMutationResult {
+  std::string mutant;
+  std::string test;
+  ExecutionResult result;
+};
+
+/// The queue of the mutants of a run shared by several machines, kept in a
+/// directory they all see (e.g. over NFS) instead of a server of its own:
+///
+///     <directory>/mutants        the mutants, published by the coordinator
+///     <directory>/claims/<n>     the node that runs the n-th chunk
+///     <directory>/results/<n>    the results of the n-th chunk
+///
+/// A node claims the next chunk nobody claimed by creating its claim, the
+/// file system settles the races, so the nodes that are done first take
+/// more of the work. The claim of a chunk is touched after every mutant:
+/// once a claim is older than the lease its node is considered gone, and
+/// the chunk is claimed again by the next node that is out of work. Files
+/// are written to a temporary name and renamed, so that a node never sees
+/// half of one. Every chunk may thus run more than once, the results of the
+/// last run are the ones kept.
+class DistributedQueue {
+public:
+  DistributedQueue(std::string directory, long long leaseSeconds);
+
+  /// The coordinator removes what a previous run left behind before any
+  /// worker subscribes
+  void clear();
+
+  bool publish(const std::vector<std::string> &mutants, size_t chunkSize);
+  /// Waits until the coordinator published the mutants, returns false if
+  /// it did not within the timeout
+  bool subscribe(long long timeoutSeconds);
+
+  const std::vector<std::vector<std::string>> &getChunks() const;
+  const std::string &getDirectory() const { return directory; }
+
+  /// Thread safe, returns false if every chunk the node can run is either
+  /// done or claimed by a node that is still alive
+  bool claim(size_t &chunk, const std::function<bool(size_t)> &runnable);
+  /// Extends the lease of a claimed chunk
+  void renew(size_t chunk);
+  bool complete(size_t chunk, const std::vector<StoredMutationResult> &results);
+  /// True once every chunk has results
+  bool finished();
+  /// Whether this node wrote the results of the chunk
+  bool completedHere(size_t chunk);
+
+  bool readResults(size_t chunk, std::vector<StoredMutationResult> &results);
+
+private:
+  std::string claimPath(size_t chunk) const;
+  std::string resultsPath(size_t chunk) const;
+  bool writeFile(const std::string &path, const std::string &content);
+  bool hasResults(size_t chunk);
+
+  std::string directory;
+  std::string node;
+  long long leaseSeconds;
+  std::vector<std::vector<std::string>> chunks;
+
+  std::mutex mutex;
+  /// The chunks the threads of this node run, never claimed twice here
+  std::set<size_t> running;
+  std::set<size_t> done;
+  std::set<size_t> doneHere;
+};
+
+} // namespace mull
@@ -1,7 +1,11 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstddef>
+#include <cstdint>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -10,28 +14,59 @@ class raw_ostream;
 }
 
 namespace mull {
+/// Every worker increments its own counter, the counters are padded to a
+/// cache line so that the workers do not slow each other down. The reporter
+/// only needs an approximate value, hence the relaxed ordering.
 class progress_counter {
 public:
   using CounterType = size_t;
+  static const size_t CacheLineSize = 64;
 
-  progress_counter() = default;
+  progress_counter();
   progress_counter(const progress_counter &v);
   void increment();
   CounterType get();
 
 private:
   std::atomic<CounterType> value;
+  char padding[CacheLineSize - sizeof(std::atomic<CounterType>)];
 };
 
+/// Tells the reporter that the workers are done, so that it does not need
+/// to poll the counters often to notice the end of the phase
+class progress_completion {
+public:
+  progress_completion();
+  void finish();
+  /// Returns true once finished, otherwise waits for the interval at most
+  bool waitFor(std::chrono::milliseconds interval);
+
+private:
+  std::mutex mutex;
+  std::condition_variable condition;
+  bool finished;
+};
+
+/// On a terminal the progress is redrawn on the same line. Otherwise, e.g.
+/// in CI logs, it is written at most once per second as lines of JSON:
+///
+///     mull-progress: {"phase": "...", "threads": 4, "done": 10, "total": 20}
+///
+/// followed by the human readable line once the phase is complete.
+/// Given an estimate of the phase, the time left is reported as well, see
+/// remainingTime, and the lines of JSON carry "eta_seconds".
 class progress_reporter {
 public:
   progress_reporter(std::string &name, std::vector<progress_counter> &counters,
                     progress_counter::CounterType total, size_t workers,
-                    llvm::raw_ostream &stream);
+                    llvm::raw_ostream &stream,
+                    progress_completion *completion = nullptr);
 
   void operator()();
   void printProgress(progress_counter::CounterType current,
                      progress_counter::CounterType total, bool force);
+  /// In nanoseconds, zero reports no time left
+  void setEstimate(int64_t nanoseconds);
 
 private:
   std::vector<progress_counter> &counters;
@@ -41,5 +76,8 @@ private:
   std::string name;
   size_t workers;
   bool hasTerminal;
+  progress_completion *completion;
+  int64_t estimate;
+  std::chrono::steady_clock::time_point start;
 };
 } // namespace mull
@@ -1,25 +1,65 @@
 #pragma once
 
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <iterator>
 #include <string>
-#include <thread>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+#include "BoundedQueue.h"
+#include "Cancellation.h"
 #include "Progress.h"
+#include "ThreadPool.h"
+#include "mull/Heap.h"
 #include "mull/Logger.h"
 #include "mull/Metrics/Metrics.h"
 
 namespace mull {
 
 std::vector<int> taskBatches(size_t itemsCount, size_t tasks);
+std::vector<int> taskChunks(size_t itemsCount, size_t workers);
+std::vector<size_t> largestFirst(const std::vector<uint64_t> &sizes);
+/// The numbers of workers auto-tuning tries, fewest first, and how many
+/// items each of them runs. Empty when there are too few items to spare.
+std::vector<std::pair<size_t, size_t>> calibrationSlices(size_t itemsCount,
+                                                         size_t workers);
 void printTimeSummary(MetricsMeasure measure);
 
+/// Moves the storages of the workers to the end of the output in their
+/// order, growing the output once rather than one item at a time
+template <typename Out>
+void appendStorages(Out &out, std::vector<Out> &storages) {
+  size_t total = out.size();
+  for (auto &storage : storages) {
+    total += storage.size();
+  }
+  out.reserve(total);
+  for (auto &storage : storages) {
+    out.insert(out.end(), std::make_move_iterator(storage.begin()),
+               std::make_move_iterator(storage.end()));
+    Out().swap(storage);
+  }
+}
+
+/// Guided: chunks of decreasing size, cheap to dispatch.
+/// OneByOne: each item is a chunk on its own, used when items are expensive
+/// and the order in which they are handed out matters (e.g. longest first).
+enum class TaskDispatch { Guided, OneByOne };
+
 template <typename Task> class TaskExecutor {
 public:
   using In = typename Task::In;
   using Out = typename Task::Out;
-  TaskExecutor(std::string name, In &in, Out &out, std::vector<Task> tasks)
-      : in(in), out(out), tasks(std::move(tasks)), name(std::move(name)) {}
+  TaskExecutor(std::string name, In &in, Out &out, std::vector<Task> tasks,
+               TaskDispatch dispatch = TaskDispatch::Guided)
+      : in(in), out(out), tasks(std::move(tasks)), name(std::move(name)),
+        dispatch(dispatch), estimate(0), autoTune(false), tunedWorkers(0) {
+    memoryUsage.phase = this->name;
+  }
 
   void execute() {
     if (tasks.empty() || in.empty()) {
@@ -27,54 +67,157 @@ public:
     }
 
     measure.start();
+    memoryUsage.begin = MemoryUsage::current();
     if (tasks.size() == 1 || in.size() == 1) {
       executeSequentially();
     } else {
       executeInParallel();
     }
+    trimHeap();
+    memoryUsage.end = MemoryUsage::current();
     measure.finish();
     printTimeSummary(measure);
   }
 
+  const std::string &getName() const { return name; }
+  /// How long the phase is expected to take in nanoseconds, see
+  /// progress_reporter
+  void setEstimate(int64_t nanoseconds) { estimate = nanoseconds; }
+  /// The first items run with fewer workers as well, the others with the
+  /// number of workers that got through the most items per second
+  void setAutoTune(bool enabled) { autoTune = enabled; }
+  /// The number of workers auto-tuning settled on, 0 if it did not run
+  size_t getTunedWorkers() const { return tunedWorkers; }
+
+  const std::vector<WorkerMetrics> &getWorkersMetrics() const {
+    return workersMetrics;
+  }
+
+  const PhaseMemoryUsage &getMemoryUsage() const { return memoryUsage; }
+
 private:
+  using clock = std::chrono::steady_clock;
+  using iterator = decltype(std::declval<In &>().begin());
+
+  /// Items are handed out in chunks of decreasing size from a shared cursor:
+  /// a worker that is done with its chunk grabs the next one, so a single
+  /// slow range cannot keep the whole phase busy while other workers idle.
+  /// Each chunk has its own storage, which keeps the output in the same
+  /// order as the input regardless of which worker processed the chunk.
   void executeInParallel() {
     assert(tasks.size() != 1);
     assert(in.size() != 1);
     auto workers = std::min(in.size(), tasks.size());
 
-    auto batches = taskBatches(in.size(), workers);
-    std::vector<std::thread> threads;
-    std::vector<Out> storages;
-
-    storages.reserve(workers);
+    std::vector<clock::duration> busyTimes(workers, clock::duration::zero());
     counters.reserve(workers);
-
-    auto end = in.begin();
     for (unsigned i = 0; i < workers; i++) {
-      int group = batches[i];
-      storages.push_back(Out());
       counters.push_back(progress_counter());
+    }
+
+    progress_completion completion;
+    progress_reporter reporter{name, counters, in.size(), workers,
+                               Logger::info(), &completion};
+    reporter.setEstimate(estimate);
+    WorkerGroup reporterGroup(ThreadPool::shared());
+    reporterGroup.run([&reporter]() { reporter(); });
+
+    auto phaseStart = clock::now();
+    size_t first = 0;
+    if (autoTune) {
+      first = calibrate(workers, busyTimes);
+    }
+    runSlice(first, in.size(), tunedWorkers ? tunedWorkers : workers,
+             busyTimes);
+    auto phaseDuration = clock::now() - phaseStart;
+    completion.finish();
+    reporterGroup.wait();
+
+    for (auto &busyTime : busyTimes) {
+      workersMetrics.emplace_back(toPrecision(busyTime),
+                                  toPrecision(phaseDuration - busyTime));
+    }
+  }
 
-      auto begin = end;
-      std::advance(end, group);
-      std::thread t(std::move(tasks[i]), begin, end, std::ref(storages.back()),
-                    std::ref(counters.back()));
-      threads.push_back(std::move(t));
+  /// Runs the items in [first, last) on the first `workers` tasks
+  void runSlice(size_t first, size_t last, size_t workers,
+                std::vector<clock::duration> &busyTimes) {
+    auto count = last - first;
+    if (count == 0) {
+      return;
+    }
+    workers = std::min(workers, count);
+    auto chunks = dispatch == TaskDispatch::OneByOne
+                      ? std::vector<int>(count, 1)
+                      : taskChunks(count, workers);
+    std::vector<iterator> chunkBegins;
+    chunkBegins.reserve(chunks.size() + 1);
+    auto end = std::next(in.begin(), first);
+    for (int chunk : chunks) {
+      chunkBegins.push_back(end);
+      std::advance(end, chunk);
     }
+    chunkBegins.push_back(end);
 
-    std::thread reporter(
-        progress_reporter{name, counters, in.size(), workers, Logger::info()});
-    threads.push_back(std::move(reporter));
+    std::vector<Out> storages(chunks.size());
+    std::atomic<size_t> nextChunk(0);
 
-    for (auto &t : threads) {
-      t.join();
+    WorkerGroup workerGroup(ThreadPool::shared());
+    for (unsigned i = 0; i < workers; i++) {
+      workerGroup.run([&, i]() {
+        Task &task = tasks[i];
+        for (size_t chunk = nextChunk++; chunk < chunks.size();
+             chunk = nextChunk++) {
+          /// The chunks that ran keep their storages
+          if (Cancellation::shared().cancelled()) {
+            break;
+          }
+          auto chunkStart = clock::now();
+          task(chunkBegins[chunk], chunkBegins[chunk + 1], storages[chunk],
+               counters[i]);
+          busyTimes[i] += clock::now() - chunkStart;
+        }
+      });
     }
+    workerGroup.wait();
+
+    appendStorages(out, storages);
+  }
+
+  /// Runs a slice of the first items per number of workers, fewest workers
+  /// first: when the items come longest first, the longer items go to the
+  /// fewer workers, and the tuning leans towards all of them. Returns the
+  /// items that ran.
+  size_t calibrate(size_t workers, std::vector<clock::duration> &busyTimes) {
+    auto slices = calibrationSlices(in.size(), workers);
+    if (slices.empty()) {
+      return 0;
+    }
+
+    size_t first = 0;
+    double best = 0;
+    std::string tried;
+    for (auto &slice : slices) {
+      if (Cancellation::shared().cancelled()) {
+        return first;
+      }
+      auto start = clock::now();
+      runSlice(first, first + slice.second, slice.first, busyTimes);
+      std::chrono::duration<double> elapsed = clock::now() - start;
+      first += slice.second;
 
-    for (auto &storage : storages) {
-      for (auto &m : storage) {
-        out.push_back(std::move(m));
+      double throughput = slice.second / std::max(elapsed.count(), 1e-9);
+      if (throughput >= best) {
+        best = throughput;
+        tunedWorkers = slice.first;
       }
+      tried += (tried.empty() ? "" : ", ") + std::to_string(slice.first) +
+               " workers: " + std::to_string(int64_t(throughput * 60)) +
+               "/min";
     }
+    Logger::info() << name << ": auto-tuned to " << tunedWorkers << " of "
+                   << workers << " workers (" << tried << ")\n";
+    return first;
   }
 
   void executeSequentially() {
@@ -82,19 +225,50 @@ private:
     auto &task = tasks.front();
 
     counters.push_back(progress_counter());
-    std::thread reporter(
-        progress_reporter{name, counters, in.size(), 1, Logger::info()});
+    progress_completion completion;
+    progress_reporter reporter{name, counters, in.size(), 1, Logger::info(),
+                               &completion};
+    reporter.setEstimate(estimate);
+    WorkerGroup reporterGroup(ThreadPool::shared());
+    reporterGroup.run([&reporter]() { reporter(); });
 
-    task(in.begin(), in.end(), out, std::ref(counters.back()));
-    reporter.join();
+    auto start = clock::now();
+    if (dispatch == TaskDispatch::OneByOne) {
+      /// One item at a time, so that a cancellation stops the phase between
+      /// two of them
+      for (auto item = in.begin(); item != in.end(); ++item) {
+        if (Cancellation::shared().cancelled()) {
+          break;
+        }
+        task(item, std::next(item), out, std::ref(counters.back()));
+      }
+    } else if (!Cancellation::shared().cancelled()) {
+      task(in.begin(), in.end(), out, std::ref(counters.back()));
+    }
+    completion.finish();
+    reporterGroup.wait();
+
+    auto zero = MetricsMeasure::Duration(0);
+    workersMetrics.emplace_back(toPrecision(clock::now() - start), zero);
+  }
+
+  static MetricsMeasure::Duration toPrecision(clock::duration duration) {
+    using namespace std::chrono;
+    return duration_cast<MetricsMeasure::Precision>(duration).count();
   }
 
   In &in;
   Out &out;
   std::vector<Task> tasks;
   std::vector<progress_counter> counters{};
+  std::vector<WorkerMetrics> workersMetrics{};
   MetricsMeasure measure;
+  PhaseMemoryUsage memoryUsage;
   std::string name;
+  TaskDispatch dispatch;
+  int64_t estimate;
+  bool autoTune;
+  size_t tunedWorkers;
 };
 
 class SingleTaskTag {};
@@ -102,11 +276,14 @@ class SingleTaskTag {};
 template <> class TaskExecutor<SingleTaskTag> {
 public:
   TaskExecutor(std::string name, std::function<void(void)> task)
-      : name(std::move(name)), task(std::move(task)) {}
+      : name(std::move(name)), task(std::move(task)) {
+    memoryUsage.phase = this->name;
+  }
 
   void execute() {
     MetricsMeasure measure;
     measure.start();
+    memoryUsage.begin = MemoryUsage::current();
     std::vector<progress_counter> unusedCounters{};
     progress_counter::CounterType total(1);
     size_t workers = 1;
@@ -115,15 +292,127 @@ public:
     task();
     bool forceReport(true);
     reporter.printProgress(total, total, forceReport);
+    trimHeap();
+    memoryUsage.end = MemoryUsage::current();
     measure.finish();
     printTimeSummary(measure);
   }
 
+  const PhaseMemoryUsage &getMemoryUsage() const { return memoryUsage; }
+
 private:
   std::string name;
   std::function<void(void)> task;
+  PhaseMemoryUsage memoryUsage;
 };
 
 typedef TaskExecutor<SingleTaskTag> SingleTaskExecutor;
 
+/// Runs the tasks on the items of a queue while the queue is still being
+/// filled by the previous phase: start() before producing, wait() after
+/// closing the queue. The items are consumed in no particular order. With a
+/// partitioned queue every task only consumes its own partition.
+template <typename Task> class StreamingTaskExecutor {
+public:
+  using In = typename std::remove_const<typename Task::In>::type;
+  using Out = typename Task::Out;
+  using Queue = BoundedQueue<typename In::value_type>;
+  StreamingTaskExecutor(std::string name, Queue &queue, Out &out,
+                        std::vector<Task> tasks)
+      : queues({&queue}), out(out), tasks(std::move(tasks)),
+        workerGroup(ThreadPool::shared()), name(std::move(name)) {
+    memoryUsage.phase = this->name;
+  }
+
+  StreamingTaskExecutor(std::string name,
+                        PartitionedQueue<typename In::value_type> &queue,
+                        Out &out, std::vector<Task> tasks)
+      : out(out), tasks(std::move(tasks)), workerGroup(ThreadPool::shared()),
+        name(std::move(name)) {
+    assert(queue.partitions() == this->tasks.size());
+    for (size_t index = 0; index < queue.partitions(); index++) {
+      queues.push_back(&queue.partition(index));
+    }
+    memoryUsage.phase = this->name;
+  }
+
+  void start() {
+    measure.start();
+    memoryUsage.begin = MemoryUsage::current();
+    phaseStart = clock::now();
+    storages.resize(tasks.size());
+    busyTimes.resize(tasks.size(), clock::duration::zero());
+    counters.resize(tasks.size());
+    for (size_t i = 0; i < tasks.size(); i++) {
+      workerGroup.run([this, i]() {
+        Queue &queue = *queues[queues.size() == 1 ? 0 : i];
+        /// The time spent waiting for the previous phase is idle time
+        In batch(1);
+        const In &items = batch;
+        while (queue.pop(batch.front())) {
+          /// Once cancelled the queue is drained anyway, the producer would
+          /// block on a full queue otherwise
+          if (Cancellation::shared().cancelled()) {
+            continue;
+          }
+          auto start = clock::now();
+          tasks[i](items.begin(), items.end(), storages[i], counters[i]);
+          busyTimes[i] += clock::now() - start;
+        }
+      });
+    }
+  }
+
+  void wait() {
+    workerGroup.wait();
+    auto phaseDuration = clock::now() - phaseStart;
+    trimHeap();
+    memoryUsage.end = MemoryUsage::current();
+    measure.finish();
+
+    progress_counter::CounterType total(0);
+    for (size_t i = 0; i < tasks.size(); i++) {
+      total += counters[i].get();
+      workersMetrics.emplace_back(toPrecision(busyTimes[i]),
+                                  toPrecision(phaseDuration - busyTimes[i]));
+    }
+    appendStorages(out, storages);
+
+    progress_reporter reporter{name, counters, total, tasks.size(),
+                               Logger::info()};
+    bool forceReport(true);
+    reporter.printProgress(total, total, forceReport);
+    printTimeSummary(measure);
+  }
+
+  const std::string &getName() const { return name; }
+
+  const std::vector<WorkerMetrics> &getWorkersMetrics() const {
+    return workersMetrics;
+  }
+
+  const PhaseMemoryUsage &getMemoryUsage() const { return memoryUsage; }
+
+private:
+  using clock = std::chrono::steady_clock;
+
+  static MetricsMeasure::Duration toPrecision(clock::duration duration) {
+    using namespace std::chrono;
+    return duration_cast<MetricsMeasure::Precision>(duration).count();
+  }
+
+  std::vector<Queue *> queues;
+  Out &out;
+  std::vector<Task> tasks;
+  std::vector<Out> storages{};
+  std::vector<clock::duration> busyTimes{};
+  std::vector<progress_counter> counters{};
+  WorkerGroup workerGroup;
+  std::vector<WorkerMetrics> workersMetrics{};
+  clock::time_point phaseStart{};
+  MetricsMeasure measure;
+  PhaseMemoryUsage memoryUsage;
+  std::string name;
+};
+
 } // namespace mull
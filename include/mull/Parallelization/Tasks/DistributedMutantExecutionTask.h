@@ -0,0 +1,41 @@
+#pragma once
+
+#include "mull/Parallelization/Tasks/MutantExecutionTask.h"
+
+#include <vector>
+
+namespace mull {
+
+class DistributedQueue;
+class MutationPoint;
+class progress_counter;
+
+/// Runs the chunks of mutants a node claims from the DistributedQueue until
+/// every chunk of the run has results. The input has one item per worker,
+/// each worker claims chunks on its own, and waits for the other nodes once
+/// there are none left: the chunks of a node that is gone are claimed again
+/// when their lease expires.
+class DistributedMutantExecutionTask {
+public:
+  using In = const std::vector<int>;
+  using Out = MutantExecutionTask::Out;
+  using iterator = In::const_iterator;
+
+  /// The chunks hold the mutants of the chunks of the queue, empty for the
+  /// ones with mutants this node does not know
+  DistributedMutantExecutionTask(
+      MutantExecutionTask task, DistributedQueue &queue,
+      const std::vector<std::vector<MutationPoint *>> &chunks);
+
+  void operator()(iterator begin, iterator end, Out &storage,
+                  progress_counter &counter);
+
+private:
+  void runChunk(size_t chunk, Out &storage);
+
+  MutantExecutionTask task;
+  DistributedQueue &queue;
+  const std::vector<std::vector<MutationPoint *>> &chunks;
+};
+
+} // namespace mull
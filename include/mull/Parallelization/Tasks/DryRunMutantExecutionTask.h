@@ -1,7 +1,7 @@
 #pragma once
 
 #include <mull/Filter.h>
-#include <mull/MutationResult.h>
+#include <mull/MutationResultTable.h>
 
 namespace mull {
 class progress_counter;
@@ -10,7 +10,7 @@ class MutationPoint;
 class DryRunMutantExecutionTask {
 public:
   using In = const std::vector<MutationPoint *>;
-  using Out = std::vector<std::unique_ptr<MutationResult>>;
+  using Out = MutationResultTable;
   using iterator = In::const_iterator;
 
   void operator()(iterator begin, iterator end, Out &storage,
@@ -9,8 +9,13 @@ namespace mull {
 
 class Toolchain;
 class Instrumentation;
+class JITEngine;
+class Metrics;
 class progress_counter;
 
+/// Every module is stored as Toolchain::codegenPartitions objects, following
+/// the order of the modules. Given an engine, each object is also added to
+/// it as soon as it is compiled, see JITEngine::beginObjectFiles.
 class InstrumentedCompilationTask {
 public:
   using In = std::vector<std::unique_ptr<MullModule>>;
@@ -18,13 +23,22 @@ public:
   using iterator = In::const_iterator;
 
   InstrumentedCompilationTask(Instrumentation &instrumentation,
-                              Toolchain &toolchain);
+                              Toolchain &toolchain, Metrics &metrics,
+                              JITEngine *jit = nullptr);
 
   void operator()(iterator begin, iterator end, Out &storage,
                   progress_counter &counter);
 
 private:
+  void compileInParts(MullModule &module, unsigned partitions, Out &storage);
+  std::string cacheSuffix() const;
+  void instrumentCallbacks(llvm::Module *module);
+  void store(llvm::object::OwningBinary<llvm::object::ObjectFile> object,
+             Out &storage);
+
   Instrumentation &instrumentation;
   Toolchain &toolchain;
+  Metrics &metrics;
+  JITEngine *jit;
 };
 } // namespace mull
@@ -9,7 +9,8 @@ class JunkDetector;
 
 class JunkDetectionTask {
 public:
-  using In = std::vector<MutationPoint *>;
+  /// The points of a function at a time, see JunkDetector::classify
+  using In = std::vector<std::vector<MutationPoint *>>;
   using Out = std::vector<MutationPoint *>;
   using iterator = In::const_iterator;
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "mull/Config/ConfigurationOptions.h"
 #include "mull/MullModule.h"
 
 namespace llvm {
@@ -17,13 +18,17 @@ public:
   using Out = std::vector<std::unique_ptr<MullModule>>;
   using iterator = In::const_iterator;
 
-  ModuleLoadingTask(llvm::LLVMContext &context, ModuleLoader &loader);
+  ModuleLoadingTask(llvm::LLVMContext &context, ModuleLoader &loader,
+                    bool lazy = false,
+                    HashAlgorithm hashAlgorithm = HashAlgorithm::MD5);
   void operator()(iterator begin, iterator end, Out &storage,
                   progress_counter &counter);
 
 private:
   llvm::LLVMContext &context;
   ModuleLoader &loader;
+  bool lazy;
+  HashAlgorithm hashAlgorithm;
 };
 
 } // namespace mull
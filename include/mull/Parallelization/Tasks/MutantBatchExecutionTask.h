@@ -0,0 +1,37 @@
+#pragma once
+
+#include "mull/Parallelization/Tasks/MutantExecutionTask.h"
+
+#include <vector>
+
+namespace mull {
+
+class MutationPoint;
+class progress_counter;
+
+/// Groups the mutants into batches of at most `size` mutants of different
+/// functions, so that the mutants of a batch can be active at once. The
+/// n-th mutant of every function goes to the n-th round of batches, the
+/// order of the mutants is kept otherwise.
+std::vector<std::vector<MutationPoint *>>
+batchMutants(const std::vector<MutationPoint *> &mutationPoints, size_t size);
+
+/// Runs a batch of mutants at a time, see MutantExecutionTask::runBatch.
+/// Most mutants of a well tested program are killed, but the ones that
+/// survive then take a single run of their tests for the whole batch.
+class MutantBatchExecutionTask {
+public:
+  using In = const std::vector<std::vector<MutationPoint *>>;
+  using Out = MutantExecutionTask::Out;
+  using iterator = In::const_iterator;
+
+  explicit MutantBatchExecutionTask(MutantExecutionTask task);
+
+  void operator()(iterator begin, iterator end, Out &storage,
+                  progress_counter &counter);
+
+private:
+  MutantExecutionTask task;
+};
+
+} // namespace mull
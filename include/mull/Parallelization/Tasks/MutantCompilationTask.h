@@ -0,0 +1,52 @@
+#pragma once
+
+#include "mull/MullModule.h"
+#include "mull/Parallelization/Tasks/OriginalCompilationTask.h"
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace llvm {
+class LLVMContext;
+}
+
+namespace mull {
+struct Configuration;
+class Metrics;
+class MutationPoint;
+class Toolchain;
+class progress_counter;
+
+/// Prepares, applies and compiles the mutations of one module at a time, so
+/// that a module is compiled as soon as its own mutations are in place
+/// rather than after the mutations of every module are applied.
+/// An LLVMContext is not thread-safe: mutators create constants, types and
+/// declarations in it, and so does the code generation. The modules of
+/// different contexts are processed in parallel, the modules sharing a
+/// context take turns on the lock of the context.
+class MutantCompilationTask {
+public:
+  using In = std::vector<MullModule *>;
+  using Out = OriginalCompilationTask::Out;
+  using iterator = In::const_iterator;
+  using MutationPoints =
+      std::unordered_map<const MullModule *, std::vector<MutationPoint *>>;
+  using ContextLocks = std::unordered_map<const llvm::LLVMContext *,
+                                          std::unique_ptr<std::mutex>>;
+
+  MutantCompilationTask(Toolchain &toolchain, const Configuration &config,
+                        const MutationPoints &mutationPoints,
+                        const ContextLocks &contextLocks, Metrics &metrics);
+
+  void operator()(iterator begin, iterator end, Out &storage,
+                  progress_counter &counter);
+
+private:
+  const Configuration &config;
+  const MutationPoints &mutationPoints;
+  const ContextLocks &contextLocks;
+  Metrics &metrics;
+  OriginalCompilationTask compilation;
+};
+} // namespace mull
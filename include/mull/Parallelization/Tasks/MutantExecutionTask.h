@@ -1,12 +1,21 @@
 #pragma once
 
-#include "mull/MutationResult.h"
+#include "mull/ForkProcessSandbox.h"
+#include "mull/MutationResultTable.h"
+#include "mull/TimeoutPolicy.h"
+#include "mull/Toolchain/CountingMemoryManager.h"
 #include "mull/Toolchain/JITEngine.h"
+#include "mull/Toolchain/Trampolines.h"
 
 #include <llvm/Object/ObjectFile.h>
 
+#include <unordered_set>
+
 namespace mull {
 
+class ExecutionOutputStore;
+class KillMatrix;
+class MemoryBudget;
 class MutationPoint;
 class Driver;
 class ProcessSandbox;
@@ -14,35 +23,122 @@ class TestRunner;
 class Toolchain;
 class Filter;
 class Mangler;
+class Metrics;
 class progress_counter;
 class Program;
+class Reporter;
+class SymbolIndex;
+class Test;
 
 struct Configuration;
 
 class MutantExecutionTask {
 public:
   using In = const std::vector<MutationPoint *>;
-  using Out = std::vector<std::unique_ptr<MutationResult>>;
+  using Out = MutationResultTable;
   using iterator = In::const_iterator;
 
-  MutantExecutionTask(ProcessSandbox &sandbox, Program &program,
+  /// When sharedJit and sharedTrampolines are given, the task runs mutants
+  /// against the program linked once for all the workers instead of linking
+  /// its own copy. Each mutant is then activated in the forked process that
+  /// runs its tests, so the workers never see each other's trampolines.
+  /// Every result is handed to the streaming reporters as soon as it is in.
+  /// With a kill matrix every test of a mutant runs, the cells go to the
+  /// matrix and a single result per mutant to the table, see collectResults.
+  /// Under a memory budget the task waits for its copy of the program to
+  /// fit before it loads it.
+  MutantExecutionTask(ProcessSandbox &sandbox,
+                      ExecutionOutputStore &outputStore, Program &program,
                       TestRunner &runner, const Configuration &config,
-                      Filter &filter, Mangler &mangler,
+                      Filter &filter, Metrics &metrics, Mangler &mangler,
                       std::vector<llvm::object::ObjectFile *> &objectFiles,
-                      std::vector<std::string> &mutatedFunctionNames);
+                      std::vector<std::string> &mutatedFunctionNames,
+                      std::shared_ptr<const SymbolIndex> symbolIndex = nullptr,
+                      JITEngine *sharedJit = nullptr,
+                      Trampolines *sharedTrampolines = nullptr,
+                      const std::vector<Reporter *> *reporters = nullptr,
+                      KillMatrix *killMatrix = nullptr,
+                      MemoryBudget *memoryBudget = nullptr);
 
   void operator()(iterator begin, iterator end, Out &storage,
                   progress_counter &counter);
 
+  /// Runs the mutants of a batch at once against the union of their
+  /// reachable tests, the mutants must belong to different functions.
+  /// If every test passes, every mutant of the batch survived. Otherwise
+  /// the batch is bisected until the mutants the tests kill run alone.
+  void runBatch(const std::vector<MutationPoint *> &batch, Out &storage);
+
 private:
-  JITEngine jit;
+  /// The store that activates a mutant, and what it overwrites
+  struct MutantActivation {
+    uint64_t *slot;
+    uint64_t value;
+    uint64_t originalValue;
+    /// The trampolines of the ODR copies of the mutant, which get the same
+    /// value, and what they held, see MutationPoint::getCanonical
+    std::vector<std::pair<uint64_t *, uint64_t>> copies;
+    /// With direct calls, the entry of the function, patched to jump to
+    /// the mutant in the child, see Trampolines::redirectEntries
+    const EntryPatch *entry;
+
+    void store() const;
+  };
+
+  void runBatch(const std::vector<MutationPoint *> &batch,
+                std::vector<MutantActivation> &activations, Out &storage);
+  void loadProgram(MutationPoint *firstMutationPoint);
+  /// The activations of the mutants, in the order of the points
+  std::vector<MutantActivation>
+  resolve(const std::vector<MutationPoint *> &points);
+  void activate(MutantActivation &activation);
+  void deactivate(const MutantActivation &activation);
+  std::vector<SandboxJob> jobsOf(MutationPoint *mutationPoint,
+                                 const MutantActivation &activation);
+  std::vector<SandboxJob>
+  jobsOf(const std::vector<Test *> &tests,
+         const std::vector<MutantActivation> &activations);
+  /// Whether the test opted out of the constructor template
+  bool needsFreshGlobals(const Test &test) const;
+  /// Restores the globals as loaded in the child of a test that opted out,
+  /// false if they cannot be restored
+  bool restoreLoadedGlobals();
+  void collectResults(MutationPoint *mutationPoint,
+                      std::vector<ExecutionResult> &results, Out &storage);
+
+  JITEngine ownJit;
+  std::unique_ptr<Trampolines> ownTrampolines;
+  JITEngine *jit;
+  Trampolines *trampolines;
+  bool sharedProgram;
+  /// Mutants whose tests run at once, each in a child of its own
+  size_t childrenInFlight;
+  /// Only in a forked child, which patches the code of its own copy
+  bool directCalls;
+  bool activateInChild;
+  /// The static constructors run once per mutant, see the prologue of
+  /// SandboxJob. Only ever set in the process the tests are forked from.
+  bool constructorTemplate;
+  bool constructorsDone;
+  /// The tests that run on the globals as loaded, and the globals taken
+  /// before any mutant is activated
+  std::unordered_set<std::string> freshGlobalsTests;
+  WritableSectionsSnapshot loadedGlobals;
   Program &program;
   ProcessSandbox &sandbox;
+  ExecutionOutputStore &outputStore;
   TestRunner &runner;
   const Configuration &config;
   Filter &filter;
+  Metrics &metrics;
+  TimeoutPolicy timeoutPolicy;
   Mangler &mangler;
   std::vector<llvm::object::ObjectFile *> &objectFiles;
   std::vector<std::string> &mutatedFunctionNames;
+  const std::vector<Reporter *> *reporters;
+  KillMatrix *killMatrix;
+  MemoryBudget *memoryBudget;
+  /// Off with the kill matrix
+  bool failFast;
 };
 } // namespace mull
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "mull/Config/ConfigurationOptions.h"
 #include "mull/MullModule.h"
 
 #include <llvm/Object/ObjectFile.h>
@@ -15,12 +16,23 @@ public:
   using Out = std::vector<llvm::object::OwningBinary<llvm::object::ObjectFile>>;
   using iterator = In::const_iterator;
 
-  explicit OriginalCompilationTask(Toolchain &toolchain);
+  /// The modules compiled keep `debugInfo` of their debug info, the ones
+  /// taken from the cache keep what they were compiled with
+  explicit OriginalCompilationTask(
+      Toolchain &toolchain, MutantDebugInfo debugInfo = MutantDebugInfo::Full);
 
   void operator()(iterator begin, iterator end, Out &storage,
                   progress_counter &counter);
 
+  /// Takes the objects of the module and of its satellites from the cache,
+  /// or compiles them
+  void compile(MullModule &module, Out &storage);
+
 private:
+  void compileInParts(MullModule &module, unsigned partitions, Out &storage);
+  void stripDebugInfo(MullModule &module);
+
   Toolchain &toolchain;
+  MutantDebugInfo debugInfo;
 };
 } // namespace mull
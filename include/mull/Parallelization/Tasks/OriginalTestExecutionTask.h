@@ -5,35 +5,69 @@
 
 namespace mull {
 
+class ExecutionOutputStore;
+class FunctionAddresses;
 class Instrumentation;
 class ProcessSandbox;
 class TestRunner;
 class Filter;
 class JITEngine;
+class Metrics;
 class progress_counter;
 class Program;
+class ReachabilityCache;
+class Reporter;
 
 struct Configuration;
 
 class OriginalTestExecutionTask {
 public:
-  using In = std::vector<Test>;
+  using In = std::vector<Test *>;
   using Out = std::vector<std::unique_ptr<Testee>>;
   using iterator = In::iterator;
 
   OriginalTestExecutionTask(Instrumentation &instrumentation, Program &program,
-                            ProcessSandbox &sandbox, TestRunner &runner,
-                            const Configuration &config, Filter &filter,
-                            JITEngine &jit);
+                            ProcessSandbox &sandbox,
+                            ExecutionOutputStore &outputStore,
+                            TestRunner &runner, const Configuration &config,
+                            Filter &filter, JITEngine &jit, Metrics &metrics,
+                            ReachabilityCache *reachabilityCache = nullptr,
+                            const std::vector<Reporter *> *reporters = nullptr,
+                            ProcessSandbox *batchSandbox = nullptr,
+                            const FunctionAddresses *sampledFunctions =
+                                nullptr);
 
   void operator()(iterator begin, iterator end, Out &storage,
                   progress_counter &counter);
   Instrumentation &instrumentation;
   Program &program;
   ProcessSandbox &sandbox;
+  ExecutionOutputStore &outputStore;
   TestRunner &runner;
   const Configuration &config;
   Filter &filter;
   JITEngine &jit;
+  Metrics &metrics;
+  /// Stores the calls of the tests, when there is one
+  ReachabilityCache *reachabilityCache;
+  /// Every test is handed to the streaming reporters once it ran
+  const std::vector<Reporter *> *reporters;
+  /// Runs the tests config.originalTestBatchSize at a time when there is one
+  ProcessSandbox *batchSandbox;
+  /// With the sampled reachability, the functions the samples of the runs
+  /// are looked up in, see CallSampler
+  const FunctionAddresses *sampledFunctions;
+
+private:
+  /// Samples the run when the reachability is sampled
+  ExecutionStatus runTest(Test &test);
+  void runBatches(iterator begin, iterator end, Out &storage,
+                  progress_counter &counter);
+  /// Takes what the run of the test left, cleans up its instrumentation
+  void finishTest(Test &test, ExecutionResult &result, Out &storage);
+  void measureRunningTimes(Test &test);
+  /// Runs the test again in several sandboxes at once, marks it flaky
+  /// unless all of the runs pass
+  void detectFlakiness(Test &test);
 };
 } // namespace mull
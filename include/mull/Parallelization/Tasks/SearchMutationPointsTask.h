@@ -1,23 +1,47 @@
 #pragma once
 
+#include "mull/Metrics/Metrics.h"
 #include "mull/MutationPoint.h"
+#include "mull/MutationSearchCache.h"
 #include "mull/Mutators/Mutator.h"
+#include "mull/Parallelization/BoundedQueue.h"
 #include "mull/Testee.h"
 
+#include <map>
+
 namespace mull {
 
+class BlockCoverage;
 class Filter;
+class MullModule;
 class Program;
 class progress_counter;
 
+/// The points of a function at a time, keyed by their source file
+using MutationPointStream = PartitionedQueue<std::vector<MutationPoint *>>;
+
 class SearchMutationPointsTask {
 public:
   using In = const std::vector<MergedTestee>;
-  using Out = std::vector<std::unique_ptr<MutationPoint>>;
+  /// The points live in the arenas of their modules
+  using Out = std::vector<MutationPoint *>;
   using iterator = In::const_iterator;
 
+  /// The points of every function are also pushed into the stream, when
+  /// there is one, so that the next phase can start before the search is
+  /// finished. They are pushed together, keyed by the source file. With
+  /// deadMutants the points of the mutators that only replace operands are
+  /// left out when their instruction cannot be observed, and counted there.
+  /// With blockCoverage a point is only reached by the tests that executed
+  /// its block, the points of the blocks no test executed reach no test.
+  /// With cache the points of a function found by a previous run are
+  /// created again without walking its instructions.
   SearchMutationPointsTask(Filter &filter, const Program &program,
-                           std::vector<std::unique_ptr<Mutator>> &mutators);
+                           std::vector<std::unique_ptr<Mutator>> &mutators,
+                           MutationPointStream *stream = nullptr,
+                           DeadMutantMetrics *deadMutants = nullptr,
+                           const BlockCoverage *blockCoverage = nullptr,
+                           MutationSearchCache *cache = nullptr);
   void operator()(iterator begin, iterator end, Out &storage,
                   progress_counter &counter);
 
@@ -25,6 +49,32 @@ private:
   Filter &filter;
   const Program &program;
   std::vector<std::unique_ptr<Mutator>> &mutators;
+  MutationPointStream *stream;
+  DeadMutantMetrics *deadMutants;
+  const BlockCoverage *blockCoverage;
+  MutationSearchCache *cache;
+  /// For every mutator, whether it accepts an opcode, empty if it accepts
+  /// every opcode
+  std::vector<std::vector<bool>> dispatchTable;
+
+  bool accepts(size_t mutatorIndex, const llvm::Instruction &instruction);
+  /// Walks the function once, the points found are kept per mutator to
+  /// report them in the same order as a walk per mutator would
+  void findPoints(MullModule *module, llvm::Function *function,
+                  int functionIndex,
+                  std::vector<std::vector<MutationPoint *>> &points,
+                  MutationSearchCache::FunctionPoints &found);
+  /// Returns false, without creating any point, if a stored point is not in
+  /// the function
+  bool restorePoints(MullModule *module, llvm::Function *function,
+                     int functionIndex,
+                     const MutationSearchCache::FunctionPoints &stored,
+                     std::vector<std::vector<MutationPoint *>> &points);
+  /// The tests of the testee that executed the block, shared by the points
+  /// of the block
+  std::shared_ptr<const ReachableTests>
+  testsOfBlock(const MergedTestee &testee, int basicBlockIndex,
+               std::map<int, std::shared_ptr<const ReachableTests>> &blocks);
 };
 
 } // namespace mull
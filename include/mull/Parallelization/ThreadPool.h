@@ -0,0 +1,89 @@
+#pragma once
+
+#include <llvm/ADT/StringRef.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace mull {
+
+struct ParallelizationConfig;
+
+/// Threads that outlive the phases: a phase hands its workers to the pool
+/// instead of starting and joining its own threads, so that the startup cost
+/// is paid once per process and thread-local state (e.g. a target machine)
+/// survives from one phase to the next.
+///
+/// A job never waits for a free thread: when all of them are busy the pool
+/// grows. The streaming phases rely on it, their workers block on a queue
+/// that is filled by the workers of another phase.
+class ThreadPool {
+public:
+  ThreadPool();
+  ~ThreadPool();
+
+  static ThreadPool &shared();
+
+  /// Starts the configured number of workers ahead of time and, if asked
+  /// for, pins every thread of the pool to a CPU. On a machine with several
+  /// NUMA nodes a pinned thread then prefers the memory of its node: the
+  /// JIT images a worker loads for itself are local to it, and so is the
+  /// memory of the children it forks, which inherit the preference along
+  /// with the affinity.
+  void configure(const ParallelizationConfig &config);
+  /// The thread counts as idle again by the time finished is called, so that
+  /// a phase that starts right after the previous one reuses its threads
+  void run(std::function<void()> job,
+           std::function<void()> finished = nullptr);
+  size_t size();
+  /// The threads of the pool do not exist in a child forked off the
+  /// process, the pool starts over without them. Only to be called in such
+  /// a child, while the pool was idle at the time of the fork.
+  void forgetThreads();
+
+private:
+  void startThread();
+  void pin(std::thread &thread, size_t index);
+  void work();
+
+  std::mutex mutex;
+  std::condition_variable condition;
+  std::deque<std::pair<std::function<void()>, std::function<void()>>> jobs;
+  std::vector<std::thread> threads;
+  std::vector<int> cpus;
+  size_t idle;
+  bool pinThreads;
+  bool localMemory;
+  bool stopping;
+};
+
+/// Jobs of a single phase, wait() returns once all of them are done
+class WorkerGroup {
+public:
+  explicit WorkerGroup(ThreadPool &pool);
+  ~WorkerGroup();
+
+  void run(std::function<void()> job);
+  void wait();
+
+private:
+  ThreadPool &pool;
+  std::mutex mutex;
+  std::condition_variable condition;
+  size_t pending;
+};
+
+/// Parses the CPU lists of sysfs, e.g. "0-3,8,10-11"
+std::vector<int> parseCPUList(llvm::StringRef list);
+
+/// Takes the CPUs of the NUMA nodes in turns, so that the first N threads
+/// are spread over all the nodes and their memory controllers
+std::vector<int> interleaveCPUs(const std::vector<std::vector<int>> &nodes);
+
+} // namespace mull
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "mull/ExecutionResult.h"
+
+namespace mull {
+
+/// Counts the hardware events of the calling process, and of the threads it
+/// starts from then on, see perf_event_open(2): the instructions, the cycles,
+/// the branch misses and the cache misses, in user space. The counters are
+/// one group, scheduled together, opened by the child of a run so that
+/// nothing but the child is counted. Only system calls are made: the child
+/// of a multi-threaded process may not allocate.
+/// The counts are all zero off Linux, or where perf_event_paranoid or the
+/// machine (e.g. a VM without a PMU) do not allow the counters.
+class PerfCounters {
+public:
+  /// Opens nothing unless enabled, e.g. when the sandbox does not count
+  explicit PerfCounters(bool enabled = true);
+  ~PerfCounters();
+  PerfCounters(const PerfCounters &) = delete;
+  PerfCounters &operator=(const PerfCounters &) = delete;
+
+  /// The counts since the counters were opened
+  PerfCounts read() const;
+
+  /// What was counted from `before` on
+  static PerfCounts since(const PerfCounts &after, const PerfCounts &before);
+
+private:
+  static const int Events = 4;
+  int descriptors[Events];
+};
+
+} // namespace mull
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "mull/ExecutionResult.h"
+
+#include <string>
+#include <unordered_map>
+
+namespace mull {
+
+class MutationPoint;
+
+/// The results of the mutants of a previous run, read back from the
+/// database the SQLite reporter wrote, so that a run only executes the
+/// mutants that changed since. The identifiers of the mutation points carry
+/// the hash of their module, any change to a module changes all of them, so
+/// a stored point is found by its mutator, module, function and the indices
+/// of its instruction in the function instead.
+class PreviousResults {
+public:
+  struct StoredMutant {
+    std::string mutator;
+    std::string functionHash;
+    /// The result of every test that reached the point, by test identifier
+    std::unordered_map<std::string, ExecutionResult> results;
+
+    /// Whether a test ran against the mutant and none of them killed it
+    bool survived() const;
+  };
+
+  /// False, with the reason, when the database cannot be read
+  bool load(const std::string &databasePath, std::string &error);
+
+  /// nullptr when the point is not in the database
+  const StoredMutant *find(MutationPoint &point) const;
+  size_t size() const;
+
+  /// The share of the mutants each test ran against that it killed, by test
+  /// identifier
+  const std::unordered_map<std::string, double> &getKillRates() const;
+  /// The share of the mutants of each mutator that were killed, by mutator
+  /// identifier
+  const std::unordered_map<std::string, double> &getMutatorKillRates() const;
+
+private:
+  std::unordered_map<std::string, StoredMutant> mutants;
+  std::unordered_map<std::string, double> killRates;
+  std::unordered_map<std::string, double> mutatorKillRates;
+};
+
+} // namespace mull
@@ -2,6 +2,7 @@
 
 #include "mull/MullModule.h"
 
+#include <llvm/ADT/StringMap.h>
 #include <llvm/IR/Function.h>
 #include <llvm/IR/Module.h>
 #include <llvm/Object/ObjectFile.h>
@@ -23,18 +24,42 @@ public:
   std::vector<std::unique_ptr<MullModule>> &modules();
   MullModule *moduleWithIdentifier(const std::string &identifier) const;
   llvm::Function *lookupDefinedFunction(llvm::StringRef FunctionName) const;
-  std::vector<llvm::Function *> getStaticConstructors() const;
+  /// Collected once, when the modules are added: a program may have
+  /// thousands of them and they are run before every test. Sorted by their
+  /// priority, the constructors of the same priority run in the order of
+  /// the modules.
+  const std::vector<llvm::Function *> &getStaticConstructors() const;
+  /// The names of the constructors above, also known once the IR is released
+  const std::vector<std::string> &getStaticConstructorNames() const;
+  /// The globals that point to the named struct, e.g. to the TestInfo of
+  /// every GoogleTest test, in the order of the modules. The suffix a
+  /// context adds to the names of the types it already has is ignored, e.g.
+  /// `class.testing::TestInfo.25`.
+  const std::vector<llvm::GlobalVariable *> &
+  globalsPointingTo(llvm::StringRef structName) const;
 
   const std::vector<std::string> &getDynamicLibraryPaths() const;
 
+  /// Frees the IR of every module once the mutants are compiled, only the
+  /// names and identifiers the runs and the reports need are left.
+  /// Nothing may look up a function or a global afterwards.
+  void releaseIR();
+
 private:
   void addModule(std::unique_ptr<MullModule> module);
+  void addStaticConstructors(llvm::Module &module);
+  void addGlobalPointers(llvm::Module &module);
 
   std::vector<std::string> _dynamicLibraries;
   ObjectFiles _precompiledObjectFiles;
   std::vector<std::unique_ptr<MullModule>> _modules;
-  std::map<std::string, llvm::Function *> functionsRegistry;
-  std::map<std::string, MullModule *> moduleRegistry;
+  llvm::StringMap<llvm::Function *> functionsRegistry;
+  llvm::StringMap<MullModule *> moduleRegistry;
+  std::vector<llvm::Function *> staticConstructors;
+  std::vector<std::string> staticConstructorNames;
+  /// The priorities of the constructors, until they are sorted
+  std::vector<std::pair<uint64_t, llvm::Function *>> prioritizedConstructors;
+  llvm::StringMap<std::vector<llvm::GlobalVariable *>> globalPointers;
 };
 
 } // namespace mull
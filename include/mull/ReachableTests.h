@@ -0,0 +1,87 @@
+#pragma once
+
+#include "mull/TestSet.h"
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace mull {
+
+class Test;
+
+/// The tests that reach a function along with their distances, as two
+/// parallel arrays. A list is built once per function while the testees are
+/// merged, then the testee and every mutation point of the function share
+/// it, so the memory scales with the functions rather than the mutants.
+/// The tests are also kept as a TestSet, for the questions about the set
+/// rather than the order of the tests.
+class ReachableTests {
+public:
+  using value_type = std::pair<Test *, int>;
+
+  class const_iterator {
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = ReachableTests::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type *;
+    using reference = value_type;
+
+    const_iterator(const ReachableTests *list, size_t index)
+        : list(list), index(index) {}
+
+    value_type operator*() const { return (*list)[index]; }
+    const_iterator &operator++() {
+      index++;
+      return *this;
+    }
+    bool operator==(const const_iterator &other) const {
+      return index == other.index;
+    }
+    bool operator!=(const const_iterator &other) const {
+      return index != other.index;
+    }
+
+  private:
+    const ReachableTests *list;
+    size_t index;
+  };
+
+  ReachableTests() = default;
+  explicit ReachableTests(const std::vector<value_type> &pairs);
+
+  void add(Test *test, int distance);
+  /// Adds the tests of the other list after the ones of this list
+  void append(const ReachableTests &other);
+  void reserve(size_t size);
+
+  size_t size() const { return tests.size(); }
+  bool empty() const { return tests.empty(); }
+  value_type operator[](size_t index) const {
+    return std::make_pair(tests[index], distances[index]);
+  }
+  value_type front() const { return (*this)[0]; }
+  Test *test(size_t index) const { return tests[index]; }
+  int distance(size_t index) const { return distances[index]; }
+  bool contains(const Test &test) const;
+  const TestSet &getTestSet() const { return testSet; }
+
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, size()); }
+
+  /// The list shared by nobody else, copied from the given one if needed
+  static ReachableTests &
+  modifiable(std::shared_ptr<const ReachableTests> &shared);
+  /// An empty list, for the points created without a testee
+  static const ReachableTests &none();
+
+private:
+  std::vector<Test *> tests;
+  std::vector<int> distances;
+  TestSet testSet;
+};
+
+} // namespace mull
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Reporter.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace llvm {
+class raw_fd_ostream;
+}
+
+namespace mull {
+
+class ArrowStreamWriter;
+
+/// Writes the results to <project>_<time>.arrows, in the Arrow IPC stream
+/// format, a row per result:
+///
+///   mutation_point, mutator, test, file, status: dictionary<int32, utf8>
+///   line, column, distance: int32
+///   killed: bool
+///   duration: int64
+///
+/// The index of a mutation point or of a test in its dictionary is its id
+/// within the file. While streaming, the results are written as a record
+/// batch every rowGroupSize results, so that the file is readable before
+/// the run ends and the reporter never holds more than a batch.
+class ArrowReporter : public Reporter {
+public:
+  static const size_t DefaultRowGroupSize = 64 * 1024;
+
+  explicit ArrowReporter(const std::string &projectName = std::string(""),
+                         size_t rowGroupSize = DefaultRowGroupSize);
+  ~ArrowReporter() override;
+
+  void beginStreaming() override;
+  void reportMutationResult(const MutationResult &result) override;
+  void reportResults(const Result &result, const RawConfig &config,
+                     const Metrics &metrics) override;
+
+  const std::string &getPath() const;
+
+private:
+  bool openFile();
+  void closeFile();
+  void addRow(const MutationResult &result);
+
+  std::string path;
+  size_t rowGroupSize;
+  std::unique_ptr<llvm::raw_fd_ostream> file;
+  std::unique_ptr<ArrowStreamWriter> writer;
+  std::mutex mutex;
+  bool streaming;
+};
+
+} // namespace mull
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace llvm {
+class raw_ostream;
+}
+
+namespace mull {
+
+/// Writes a table in the Arrow IPC stream format, record batch after record
+/// batch, for the tools that read columns rather than rows (pyarrow,
+/// DuckDB, Spark...). The columns have no nulls. The dictionary columns
+/// hold strings, each distinct string is stored once and the rows refer to
+/// it by an int32 index; the strings a batch adds to a dictionary are sent
+/// as a delta of the dictionary right before the batch.
+///
+/// The metadata is written as FlatBuffers by hand, only the few tables the
+/// format needs, so that mull does not depend on the Arrow libraries.
+class ArrowStreamWriter {
+public:
+  enum class ColumnType { Int32, Int64, Bool, Dictionary };
+
+  struct Column {
+    std::string name;
+    ColumnType type;
+  };
+
+  /// Writes the schema right away
+  ArrowStreamWriter(llvm::raw_ostream &stream, std::vector<Column> columns);
+
+  /// The values of a row, every column gets one before the next row
+  void appendInteger(size_t column, int64_t value);
+  void appendBool(size_t column, bool value);
+  void appendString(size_t column, const std::string &value);
+
+  size_t pendingRows() const;
+  /// Writes the pending rows as a record batch, if there are any
+  void writeBatch();
+  /// Writes the pending rows and the end of the stream
+  void finish();
+
+private:
+  struct ColumnData {
+    Column column;
+    std::vector<int64_t> values;
+    std::unordered_map<std::string, int32_t> indices;
+    std::vector<std::string> dictionary;
+    /// The entries of the dictionary sent so far
+    size_t sent;
+  };
+
+  void writeSchema();
+  void writeDictionary(size_t column);
+  void writeMessage(const std::string &metadata, const std::string &body);
+
+  llvm::raw_ostream &stream;
+  std::vector<ColumnData> columns;
+  bool finished;
+};
+
+} // namespace mull
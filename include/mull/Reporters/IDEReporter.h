@@ -2,12 +2,34 @@
 
 #include "Reporter.h"
 
+#include <mutex>
+#include <unordered_set>
+
 namespace mull {
 
+class MutationPoint;
+
+/// When streaming, the killed mutants are noted as their results come in,
+/// so that the report does not go over the results of the run again.
+/// The survivors are reported a file at a time, the files sorted by path and
+/// the mutants of a file by line. The files are formatted on all the workers.
 class IDEReporter : public Reporter {
 public:
+  /// Up to maxMutantsPerFile survivors are reported per file, the rest are
+  /// only counted. Zero reports them all.
+  explicit IDEReporter(size_t maxMutantsPerFile = 0)
+      : maxMutantsPerFile(maxMutantsPerFile) {}
+
   void reportResults(const Result &result, const RawConfig &config,
                      const Metrics &metrics) override;
+  void beginStreaming() override;
+  void reportMutationResult(const MutationResult &result) override;
+
+private:
+  size_t maxMutantsPerFile;
+  bool streaming = false;
+  std::mutex mutex;
+  std::unordered_set<const MutationPoint *> killedMutants;
 };
 
 } // namespace mull
\ No newline at end of file
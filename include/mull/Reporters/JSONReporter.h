@@ -0,0 +1,91 @@
+#pragma once
+
+#include "Reporter.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace llvm {
+class raw_fd_ostream;
+}
+
+namespace mull {
+
+class Result;
+class RawConfig;
+class Metrics;
+
+/// Writes the results as newline delimited JSON, one record per line:
+///
+///   {"version": 1, "type": "mutation_result", "mutation_point": "...",
+///    "mutator": "...", "test": "...", "status": "Failed", "killed": true,
+///    "duration": 12, "distance": 1, "file": "...", "line": 3, "column": 5}
+///
+/// and a last record once the run is reported:
+///
+///   {"version": 1, "type": "summary", "project": "...", "tests": 3,
+///    "mutation_points": 10, "mutation_results": 25, "killed": 7,
+///    "latencies": {"fork": {"count": 25, "p50": 1200, "p90": 1800,
+///    "p99": 4000, "max": 5100}, ...}}
+///
+/// The latencies are in nanoseconds, one entry per stage of the mutant runs
+/// that was measured, see LatencyHistograms.
+///
+/// New fields may be added, the existing ones keep their meaning until the
+/// version changes.
+///
+/// While streaming, each worker formats its records into a buffer of its
+/// own, and a thread of the reporter writes the buffers out every
+/// flushInterval milliseconds.
+class JSONReporter : public Reporter {
+public:
+  static const int DefaultFlushInterval = 1000;
+
+  explicit JSONReporter(const std::string &projectName = std::string(""),
+                        int flushInterval = DefaultFlushInterval);
+  ~JSONReporter() override;
+
+  void beginStreaming() override;
+  void reportMutationResult(const MutationResult &result) override;
+  void reportResults(const Result &result, const RawConfig &config,
+                     const Metrics &metrics) override;
+
+  const std::string &getPath() const;
+
+private:
+  struct Buffer {
+    std::mutex mutex;
+    std::string records;
+  };
+
+  bool openFile();
+  void closeFile();
+  Buffer &bufferOfThisThread();
+  void writeBuffers();
+  void flushBuffers();
+
+  std::string path;
+  int flushInterval;
+  std::unique_ptr<llvm::raw_fd_ostream> file;
+
+  /// Tells the buffers of this reporter from the ones a thread keeps for
+  /// another reporter
+  uint64_t id;
+  static std::atomic<uint64_t> nextId;
+
+  std::mutex buffersMutex;
+  std::vector<std::unique_ptr<Buffer>> buffers;
+
+  std::mutex writerMutex;
+  std::condition_variable writerWakeup;
+  bool finished;
+  std::thread writer;
+};
+
+} // namespace mull
@@ -5,11 +5,30 @@ namespace mull {
 class Result;
 class RawConfig;
 class Metrics;
+class MutationResult;
+class Test;
+
+/// The phases of a run whose end the streaming reporters are told about
+enum class RunPhase { OriginalTests, MutationSearch, MutantExecution };
 
 class Reporter {
 public:
   virtual void reportResults(const Result &result, const RawConfig &config,
                              const Metrics &metrics) = 0;
+
+  /// Called before the mutants run by a driver that streams their results:
+  /// reportMutationResult then receives every result of the run, from any
+  /// of the workers, and reportResults only adds what is left
+  virtual void beginStreaming() {}
+  /// The result only lives for the call, the reporter copies what it keeps
+  virtual void reportMutationResult(const MutationResult &result) {}
+  /// Called by the workers once an original test ran, with its result and
+  /// running time set. The tests whose calls are cached do not run.
+  virtual void reportTestResult(const Test &test) {}
+  /// Called on the thread of the driver, after everything the phase
+  /// produced has been reported
+  virtual void reportPhaseEnd(RunPhase phase) {}
+
   virtual ~Reporter() = default;
 };
 
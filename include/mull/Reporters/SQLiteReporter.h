@@ -1,27 +1,118 @@
 #include "Reporter.h"
 
+#include "mull/Parallelization/BoundedQueue.h"
+
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
+struct sqlite3;
+struct sqlite3_stmt;
+
 namespace mull {
 
 class Result;
 class RawConfig;
 class Metrics;
+class MutationPoint;
+class Test;
+struct ExecutionResult;
+
+/// How the results are laid out in the database
+enum class SQLiteSchema {
+  /// A table per kind of row, the rows refer to each other by the unique
+  /// identifiers of the tests and mutation points
+  Default,
+  /// Integer keys into tables of the tests, mutation points, files,
+  /// functions and distinct outputs, each stored once. The tables of the
+  /// default schema are views on top, so the existing queries keep working.
+  Normalized
+};
 
+/// While streaming, the results of the mutants are written as they come by
+/// a thread of the reporter, committed every so often, so that a run leaves
+/// its results behind even if it does not finish. The indexes are only
+/// created once all the rows are in.
+///
+/// With several writers and the default schema, each writer thread has a
+/// shard database of its own next to the report, the results go to the
+/// writers in turn, and the shards are merged into the report with bulk
+/// INSERT ... SELECT once the run is over. The normalized schema interns
+/// the rows into one set of ids, it always has a single writer.
 class SQLiteReporter : public Reporter {
 
 private:
   std::string databasePath;
+  SQLiteSchema schema;
+  sqlite3 *database;
+  sqlite3_stmt *insertExecutionResultStmt;
+  sqlite3_stmt *insertMutationResultStmt;
+  std::unique_ptr<BoundedQueue<MutationResult>> queue;
+  std::thread writer;
+  int writers;
+  std::vector<std::unique_ptr<SQLiteReporter>> shards;
+  std::atomic<size_t> nextShard;
+
+  /// The normalized schema only
+  sqlite3_stmt *insertTestIdStmt;
+  sqlite3_stmt *insertMutationPointIdStmt;
+  sqlite3_stmt *insertFileStmt;
+  sqlite3_stmt *insertFunctionStmt;
+  sqlite3_stmt *insertContentStmt;
+  std::unordered_map<std::string, int64_t> testIds;
+  std::unordered_map<std::string, int64_t> mutationPointIds;
+  std::unordered_map<std::string, int64_t> fileIds;
+  std::unordered_map<std::string, int64_t> functionIds;
+  std::unordered_map<std::string, int64_t> contentIds;
+
+  void openDatabase();
+  void closeDatabase();
+  void mergeShards();
+  void writeMutationResults();
+  void insertMutationResult(const MutationResult &mutationResult);
+  void insertExecutionResult(const std::string &testId,
+                             const std::string &mutationPointId,
+                             const ExecutionResult &executionResult);
+  void insertTest(sqlite3_stmt *stmt, const Test &test);
+  void insertMutationPoint(sqlite3_stmt *stmt, MutationPoint &mutationPoint);
+  void insertMutationPointDebug(sqlite3_stmt *stmt,
+                                MutationPoint &mutationPoint);
+
+  int64_t intern(std::unordered_map<std::string, int64_t> &ids,
+                 const std::string &key, sqlite3_stmt *stmt,
+                 const std::vector<std::string> &values);
+  int64_t internTest(const std::string &uniqueId);
+  int64_t internMutationPoint(const std::string &uniqueId);
+  int64_t internFile(const std::string &filePath,
+                     const std::string &directory);
+  int64_t internFunction(const std::string &moduleName,
+                         const std::string &name);
+  int64_t internContent(const std::string &content);
 
 public:
-  SQLiteReporter(const std::string &projectName = std::string(""));
+  SQLiteReporter(const std::string &projectName = std::string(""),
+                 SQLiteSchema schema = SQLiteSchema::Default,
+                 int writers = 1);
+  ~SQLiteReporter() override;
 
+  void beginStreaming() override;
+  void reportMutationResult(const MutationResult &result) override;
   void reportResults(const Result &result, const RawConfig &config,
                      const Metrics &metrics) override;
 
   std::string getDatabasePath();
 };
 
+/// Combines the databases of the shards of a run, see ShardConfig, into a
+/// new one with the default schema. The tests and their original runs are
+/// in every shard and taken once, the mutants are those of all the shards.
+/// Returns false with the reason if a database cannot be merged.
+bool mergeSQLiteDatabases(const std::string &outputPath,
+                          const std::vector<std::string> &partialPaths,
+                          std::string &error);
+
 } // namespace mull
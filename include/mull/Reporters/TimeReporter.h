@@ -1,11 +1,24 @@
 #include "Reporter.h"
 
+#include <string>
+
 namespace mull {
 
+/// Prints the metrics of the run. With a history, the timings of the run are
+/// compared with the previous runs of the project and added to them, see
+/// TimingHistory.
 class TimeReporter : public Reporter {
 public:
+  /// An empty history path disables the history
+  explicit TimeReporter(const std::string &historyPath = std::string(),
+                        const std::string &projectName = std::string());
+
   void reportResults(const Result &result, const RawConfig &config,
                      const Metrics &metrics) override;
+
+private:
+  std::string historyPath;
+  std::string projectName;
 };
 
 } // namespace mull
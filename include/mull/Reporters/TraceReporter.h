@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Reporter.h"
+
+#include <string>
+
+namespace mull {
+
+/// Writes the trace the metrics recorded to <project>_<time>.trace.json, in
+/// the Trace Event Format that Perfetto and chrome://tracing open.
+/// The metrics only record the trace once tracing is enabled on them.
+class TraceReporter : public Reporter {
+public:
+  explicit TraceReporter(const std::string &projectName = "");
+
+  void reportResults(const Result &result, const RawConfig &config,
+                     const Metrics &metrics) override;
+
+  const std::string &getPath() const;
+
+private:
+  std::string path;
+};
+
+} // namespace mull
@@ -1,7 +1,9 @@
 #pragma once
 
+#include "KillMatrix.h"
 #include "MutationPoint.h"
 #include "MutationResult.h"
+#include "MutationResultTable.h"
 #include "mull/TestFrameworks/Test.h"
 #include <vector>
 
@@ -9,25 +11,41 @@ namespace mull {
 
 class Result {
   std::vector<Test> tests;
-  std::vector<std::unique_ptr<MutationResult>> mutationResults;
+  MutationResultTable mutationResults;
   std::vector<MutationPoint *> mutationPoints;
+  std::unique_ptr<KillMatrix> killMatrix;
 
 public:
-  Result(std::vector<Test> tests,
-         std::vector<std::unique_ptr<MutationResult>> mutationResults,
+  Result(std::vector<Test> tests, MutationResultTable mutationResults,
          std::vector<MutationPoint *> mutationPoints)
       : tests(std::move(tests)), mutationResults(std::move(mutationResults)),
         mutationPoints(std::move(mutationPoints)) {}
 
+  /// For the results built one by one
+  Result(std::vector<Test> tests,
+         const std::vector<std::unique_ptr<MutationResult>> &results,
+         std::vector<MutationPoint *> mutationPoints)
+      : tests(std::move(tests)), mutationPoints(std::move(mutationPoints)) {
+    mutationResults.reserve(results.size());
+    for (auto &result : results) {
+      mutationResults.add(*result);
+    }
+  }
+
   std::vector<Test> const &getTests() const { return tests; }
 
-  std::vector<std::unique_ptr<MutationResult>> const &
-  getMutationResults() const {
+  MutationResultTable const &getMutationResults() const {
     return mutationResults;
   }
 
   std::vector<MutationPoint *> const &getMutationPoints() const {
     return mutationPoints;
   }
+
+  void setKillMatrix(std::unique_ptr<KillMatrix> matrix) {
+    killMatrix = std::move(matrix);
+  }
+  /// nullptr unless the configuration asks for the kill matrix
+  const KillMatrix *getKillMatrix() const { return killMatrix.get(); }
 };
 } // namespace mull
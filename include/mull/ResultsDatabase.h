@@ -0,0 +1,29 @@
+#pragma once
+
+#include "mull/ExecutionResult.h"
+
+#include <string>
+
+struct sqlite3;
+struct sqlite3_stmt;
+
+namespace mull {
+
+/// Reading back the databases of the SQLite reporter. The views of the
+/// normalized schema have the columns of the default one, so the same
+/// queries read both.
+
+/// nullptr, with the reason, when the database cannot be opened
+sqlite3 *openResultsDatabase(const std::string &path, std::string &error);
+
+/// Empty when the column is NULL
+std::string columnText(sqlite3_stmt *statement, int column);
+
+/// The results of the mutants, the rows of the original tests left out:
+/// test_id, mutation_point_id, status, duration, stdout, stderr
+extern const char *const SelectExecutionResults;
+
+/// The result of a row of SelectExecutionResults
+ExecutionResult executionResultOf(sqlite3_stmt *selectResults);
+
+} // namespace mull
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <functional>
+#include <string>
+
+namespace mull {
+
+/// A mutant as two runs both know it: by its mutator, its source location
+/// and the hash of the body of its function. The identifiers of the
+/// mutation points carry the hash of their module, any change to a module
+/// changes all of them.
+struct DiffedMutant {
+  std::string mutator;
+  std::string file;
+  int line;
+  int column;
+  std::string functionHash;
+};
+
+enum class MutantChange { Added, Removed, NewlySurvived, NewlyKilled };
+
+std::string mutantChangeToString(MutantChange change);
+
+/// Compares the databases the SQLite reporter wrote for two runs, the
+/// previous one first, and reports every mutant that changed as it is
+/// found. A mutant survived when one of its points had all of its tests
+/// pass, and was killed when its points were all killed; a mutant that no
+/// test ran is only ever added or removed. Each database is read once, the
+/// rows of the results are streamed and only their status is read, so
+/// only a few flags per mutant are kept in memory, never the outputs.
+/// False, with the reason, when a database cannot be read.
+bool diffResults(
+    const std::string &previousPath, const std::string &currentPath,
+    const std::function<void(MutantChange, const DiffedMutant &)> &report,
+    std::string &error);
+
+} // namespace mull
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <llvm/ADT/StringRef.h>
+
+#include <cstddef>
+
+namespace mull {
+
+/// Sends all the bytes, retrying the interrupted and partial sends. A peer
+/// that went away fails the send rather than raising SIGPIPE.
+bool sendAll(int socket, const void *data, size_t size);
+
+inline bool sendAll(int socket, llvm::StringRef data) {
+  return sendAll(socket, data.data(), data.size());
+}
+
+} // namespace mull
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "mull/SourceLocation.h"
+
+#include <llvm/ADT/StringRef.h>
+#include <llvm/Support/MemoryBuffer.h>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mull {
+
+/// Reads the lines of the source files the diagnostics point at.
+/// A file is mapped into memory the first time one of its lines is asked
+/// for, its descriptor is closed right away, and the starts of its lines are
+/// found with memchr. The lines point into the mapping, so they live as long
+/// as the cache does.
+class SourceCache {
+public:
+  /// The line the location is on, with the newline it ends with.
+  /// Empty when the file cannot be read or has no such line.
+  llvm::StringRef getLine(const SourceLocation &location);
+  llvm::StringRef getLine(const std::string &filePath, int line);
+
+  /// Marks the column of the line with a caret, keeping the tabs before it
+  /// so that the caret lines up. Empty when the line has no such column.
+  static std::string caret(llvm::StringRef line, int column);
+
+private:
+  struct File {
+    std::unique_ptr<llvm::MemoryBuffer> buffer;
+    std::vector<uint32_t> lineOffsets;
+  };
+
+  const File *getFile(const std::string &filePath);
+
+  std::mutex mutex;
+  std::unordered_map<std::string, std::unique_ptr<File>> files;
+};
+
+} // namespace mull
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 
 namespace llvm {
@@ -9,15 +10,20 @@ class Function;
 
 namespace mull {
 
+/// The directory and the path of the file live in a pool shared by all the
+/// locations, a location only keeps the id of its file
 struct SourceLocation {
-  std::string directory;
-  std::string filePath;
+  uint32_t file;
   int line;
   int column;
   SourceLocation(const std::string &directory, const std::string &filePath,
                  int line, int column);
+  SourceLocation(uint32_t file, int line, int column);
   bool isNull() const;
 
+  const std::string &directory() const;
+  const std::string &filePath() const;
+
   const static SourceLocation
   sourceLocationFromInstruction(const llvm::Instruction *instruction);
   const static SourceLocation
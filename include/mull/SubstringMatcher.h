@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <llvm/ADT/StringRef.h>
+
+namespace mull {
+
+/// Tells whether a text contains any of the patterns in a single pass over
+/// the text, however many patterns there are (Aho-Corasick)
+class SubstringMatcher {
+public:
+  SubstringMatcher();
+
+  void addPattern(const std::string &pattern);
+  bool empty() const;
+  bool matches(llvm::StringRef text);
+
+private:
+  struct State {
+    std::vector<std::pair<char, uint32_t>> transitions;
+    uint32_t failure;
+    /// Whether a pattern ends here, or in one of the states of the failure
+    /// chain
+    bool terminal;
+  };
+
+  std::vector<std::string> patterns;
+  std::vector<State> states;
+  bool compiled;
+
+  void compile();
+  uint32_t transition(uint32_t state, char character) const;
+};
+
+} // namespace mull
@@ -2,8 +2,14 @@
 
 #include "mull/TestFrameworks/TestFinder.h"
 
+#include <llvm/ADT/StringRef.h>
+
 #include <vector>
 
+namespace llvm {
+class Function;
+}
+
 namespace mull {
 
 class Program;
@@ -11,7 +17,28 @@ class Filter;
 
 class GoogleTestFinder : public TestFinder {
 public:
+  /// A test as --gtest_list_tests lists it, along with the type of a typed
+  /// test when GoogleTest knows it
+  struct ListedTest {
+    std::string name;
+    std::string typeParameter;
+  };
+
+  explicit GoogleTestFinder(int workers = 1);
   std::vector<Test> findTests(Program &program, Filter &filter) override;
+
+  /// The instances of the parametrized and the typed tests are known only
+  /// once GoogleTest registers them, each instance is a test of its own
+  bool hasRuntimeTests() const override;
+  void findRuntimeTests(const std::function<std::string(Test &)> &run,
+                        Filter &filter, std::vector<Test> &tests) override;
+
+  static std::vector<ListedTest> parseTestList(llvm::StringRef listing);
+
+private:
+  int workers;
+  /// The bodies of the tests that have no TestInfo of their own
+  std::vector<llvm::Function *> instanceBodies;
 };
 
 } // namespace mull
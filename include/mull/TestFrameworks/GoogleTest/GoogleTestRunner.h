@@ -0,0 +1,29 @@
+#pragma once
+
+#include "mull/TestFrameworks/NativeTestRunner.h"
+
+#include <string>
+
+namespace mull {
+
+/// Runs the tests of GoogleTest without going through main: GoogleTest is
+/// initialized along with the static constructors, so only once in the
+/// process the tests are forked from with the constructor template, and
+/// each test then only parses its filter before the UnitTest runs it.
+///
+/// Whatever the main of the program does besides RUN_ALL_TESTS, e.g. adding
+/// global environments, is skipped. The runner falls back to main when the
+/// program does not define the functions of GoogleTest it calls.
+class GoogleTestRunner : public NativeTestRunner {
+public:
+  explicit GoogleTestRunner(Mangler &mangler);
+
+  void runStaticConstructors(JITEngine &jit, Program &program) override;
+  ExecutionStatus runInitializedTest(JITEngine &jit, Test &test) override;
+
+private:
+  /// nullptr when the program does not define the function
+  void *findFunctionPointer(const std::string &functionName, JITEngine &jit);
+};
+
+} // namespace mull
@@ -17,20 +17,35 @@ public:
   void loadInstrumentedProgram(ObjectFiles &objectFiles,
                                Instrumentation &instrumentation,
                                JITEngine &jit) override;
+  void beginInstrumentedProgram(Instrumentation &instrumentation,
+                                JITEngine &jit) override;
+  void loadInstrumentedLibrary(ProgramLibrary &library,
+                               Instrumentation &instrumentation,
+                               JITEngine &jit) override;
   void loadMutatedProgram(ObjectFiles &objectFiles, Trampolines &trampolines,
                           JITEngine &jit) override;
   ExecutionStatus runTest(JITEngine &jit, Program &program,
                           Test &test) override;
+  void runStaticConstructors(JITEngine &jit, Program &program) override;
+  ExecutionStatus runInitializedTest(JITEngine &jit, Test &test) override;
+  void prepareTest(JITEngine &jit, Test &test) override;
 
-private:
+protected:
   Mangler &mangler;
   llvm_compat::CXXRuntimeOverrides overrides;
+  /// The trampoline of the instrumented program: the own one of the
+  /// runner, or the slot of a program library
   InstrumentationInfo **trampoline;
 
-  void *getConstructorPointer(const llvm::Function &function, JITEngine &jit);
   void *getFunctionPointer(const std::string &functionName, JITEngine &jit);
+  /// Looked up once per image and thread rather than before every run
+  void *getDriverPointer(Test &test, JITEngine &jit);
+
+private:
+  InstrumentationInfo **ownTrampoline;
 
-  void runStaticConstructor(llvm::Function *constructor, JITEngine &jit);
+  void *getConstructorPointer(const std::string &constructor, JITEngine &jit);
+  void runStaticConstructor(const std::string &constructor, JITEngine &jit);
 };
 
 } // namespace mull
\ No newline at end of file
@@ -1,10 +1,14 @@
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "mull/ExecutionResult.h"
 #include "mull/Instrumentation/InstrumentationInfo.h"
+#include "mull/SourceLocation.h"
+
+#include <llvm/ADT/SmallVector.h>
 
 namespace llvm {
 class Function;
@@ -12,31 +16,79 @@ class Function;
 
 namespace mull {
 
+/// The program name followed by the arguments, laid out in one block when
+/// the test is created instead of before every run
+class ArgumentVector {
+public:
+  ArgumentVector(const std::string &programName,
+                 const std::vector<std::string> &arguments);
+
+  int getArgc() const;
+  /// Points into the block, terminated by nullptr. The pointers are copied
+  /// for every run, a test may reorder them, e.g. InitGoogleTest removes
+  /// the flags it recognizes. The strings are shared.
+  void getArgv(llvm::SmallVectorImpl<char *> &argv);
+
+private:
+  std::vector<char> block;
+  std::vector<size_t> offsets;
+};
+
 class Test {
 public:
   Test(std::string test, std::string program, std::string driverFunctionName,
        std::vector<std::string> args, llvm::Function *testBody);
 
-  std::string getTestName() const;
-  std::string getProgramName() const;
-  std::string getDriverFunctionName() const;
-  std::string getTestDisplayName() const;
-  std::string getUniqueIdentifier() const;
+  /// Unique in the process and shared by the copies of the test. The tests
+  /// found by one search have ids next to each other, see TestSet.
+  uint32_t getId() const;
+  const std::string &getTestName() const;
+  const std::string &getProgramName() const;
+  const std::string &getDriverFunctionName() const;
+  const std::string &getTestDisplayName() const;
+  const std::string &getUniqueIdentifier() const;
   const std::vector<std::string> &getArguments() const;
+  ArgumentVector &getArgumentVector();
+  /// nullptr once the IR is released
   const llvm::Function *getTestBody() const;
+  /// Where the body is defined, also known once the IR is released
+  SourceLocation getSourceLocation() const;
+  /// Keeps the location of the body, for when its debug info is stripped
+  void keepSourceLocation();
+  /// Keeps the location of the body and forgets the body, see
+  /// Program::releaseIR
+  void releaseIR();
 
   void setExecutionResult(ExecutionResult result);
   const ExecutionResult &getExecutionResult() const;
+  /// Nanoseconds each of the measured runs of the test took
+  void addRunningTime(int64_t nanoseconds);
+  const std::vector<int64_t> &getRunningTimes() const;
+  /// The back edges the original run of the test took in the instrumented
+  /// code. The maximum unless they are counted, which leaves the mutant runs
+  /// of the test unlimited, see loopBudgetOf.
+  void setBackEdges(uint64_t count);
+  uint64_t getBackEdges() const;
+  /// The runs of the original test disagreed, see Configuration::flakyRuns
+  void setFlaky(bool flaky);
+  bool isFlaky() const;
   InstrumentationInfo &getInstrumentationInfo();
 
 private:
+  uint32_t id;
   std::string testName;
   std::string programName;
   std::string driverFunctionName;
   std::vector<std::string> arguments;
+  /// Shared by the copies of the test
+  std::shared_ptr<ArgumentVector> argumentVector;
   llvm::Function *testBody;
+  SourceLocation bodyLocation;
 
   ExecutionResult executionResult;
+  std::vector<int64_t> runningTimes;
+  uint64_t backEdges;
+  bool flaky;
   InstrumentationInfo instrumentationInfo;
 };
 
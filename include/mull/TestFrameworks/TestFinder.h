@@ -1,8 +1,11 @@
 #pragma once
 
 #include "Test.h"
+#include "mull/TestSearchCache.h"
 
+#include <functional>
 #include <memory>
+#include <string>
 
 namespace mull {
 
@@ -12,7 +15,25 @@ class Filter;
 class TestFinder {
 public:
   virtual std::vector<Test> findTests(Program &program, Filter &filter) = 0;
+  /// Whether findTests saw tests that the program registers only at run
+  /// time, e.g. the instances of a parametrized GoogleTest test
+  virtual bool hasRuntimeTests() const { return false; }
+  /// Adds a test per instance the program registers at run time. `run` runs
+  /// a test of the finder against the loaded program, in a child of its own,
+  /// and returns what the test printed.
+  virtual void findRuntimeTests(const std::function<std::string(Test &)> &run,
+                                Filter &filter, std::vector<Test> &tests) {}
+  /// The finder rebuilds the tests of the modules the cache knows rather
+  /// than searching them, the finders that do not walk the IR ignore it
+  void setCache(std::unique_ptr<TestSearchCache> testCache) {
+    cache = std::move(testCache);
+  }
+  /// The modules whose tests came from the cache
+  uint64_t getCachedModules() const { return cache ? cache->getHits() : 0; }
   virtual ~TestFinder() = default;
+
+protected:
+  std::unique_ptr<TestSearchCache> cache;
 };
 
 } // namespace mull
@@ -13,6 +13,7 @@ class Test;
 class Instrumentation;
 class Trampolines;
 class Program;
+class ProgramLibrary;
 
 class TestRunner {
 public:
@@ -25,10 +26,26 @@ public:
   virtual void loadInstrumentedProgram(ObjectFiles &objectFiles,
                                        Instrumentation &instrumentation,
                                        JITEngine &jit) = 0;
+  /// Same as loadInstrumentedProgram, but the objects are then added to the
+  /// engine one by one, see JITEngine::beginObjectFiles
+  virtual void beginInstrumentedProgram(Instrumentation &instrumentation,
+                                        JITEngine &jit) = 0;
+  /// Same as loadInstrumentedProgram, for the program linked into a loaded
+  /// program library
+  virtual void loadInstrumentedLibrary(ProgramLibrary &library,
+                                       Instrumentation &instrumentation,
+                                       JITEngine &jit) = 0;
   virtual void loadMutatedProgram(ObjectFiles &objectFiles,
                                   Trampolines &trampolines, JITEngine &jit) = 0;
+  /// Runs the static constructors of the program, then the test
   virtual ExecutionStatus runTest(JITEngine &jit, Program &program,
                                   Test &test) = 0;
+  virtual void runStaticConstructors(JITEngine &jit, Program &program) = 0;
+  /// Runs the test in a process where runStaticConstructors has run already
+  virtual ExecutionStatus runInitializedTest(JITEngine &jit, Test &test) = 0;
+  /// Looks up what the runs of the test need in the image ahead, in the
+  /// process the runs are forked from, so that every run does not do it
+  virtual void prepareTest(JITEngine &jit, Test &test) {}
 
   virtual ~TestRunner() = default;
 };
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "mull/Config/ConfigurationOptions.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mull {
+
+class ChangedLines;
+class MutationPoint;
+class PreviousResults;
+
+/// Sorts the reachable tests of every mutant in the order, see TestOrder.
+/// The ties keep the order they were discovered in, so that the same
+/// tests run in the same order from one run to the next. A mutant is
+/// killed or not whatever the order of its tests, only fail fast skips the
+/// tests after the one that killed it.
+/// The kill rates are by test identifier, see PreviousResults, the tests
+/// without one run last.
+void prioritizeReachableTests(
+    const std::vector<MutationPoint *> &points, TestOrder order,
+    const std::unordered_map<std::string, double> &killRates);
+
+/// The mutants in the order a developer acts upon their results, see
+/// MutantOrder::Feedback: the mutants on the changed lines first, then the
+/// mutants that survived the previous run, then the others by the kill rate
+/// of their mutator in the previous run, lowest first. The mutants of a
+/// tier keep their order, e.g. longest first. Either of the changes and the
+/// previous results may be missing.
+std::vector<MutationPoint *>
+feedbackFirst(const std::vector<MutationPoint *> &points,
+              const ChangedLines *changes, const PreviousResults *previous);
+
+} // namespace mull
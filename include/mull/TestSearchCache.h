@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mull {
+
+class MullModule;
+
+/// The tests the finders of the previous runs found, one file per module
+/// under <cache>/tests/, named after the MD5 of the finder and the unique
+/// identifier of the module, i.e. the hash of its bitcode. A finder then
+/// rebuilds the tests of an unchanged module from the names of their
+/// functions instead of walking its IR.
+class TestSearchCache {
+public:
+  /// A test as the finder found it, before the filter
+  struct CachedTest {
+    std::string name;
+    std::string driverFunction;
+    std::string body;
+  };
+
+  /// The tests of a module, with the bodies of the tests that are only
+  /// known at run time, see TestFinder::findRuntimeTests
+  struct ModuleTests {
+    std::vector<CachedTest> tests;
+    std::vector<std::string> runtimeBodies;
+  };
+
+  /// An empty directory disables the cache
+  TestSearchCache(const std::string &cacheDirectory,
+                  const std::string &finder);
+
+  /// Thread safe. Returns false if the tests of the module are not stored.
+  bool lookup(const MullModule &module, ModuleTests &tests);
+  /// Thread safe, the tests are written right away
+  void store(const MullModule &module, const ModuleTests &tests);
+
+  /// The modules whose tests were found in the cache
+  uint64_t getHits() const;
+
+private:
+  std::string pathOf(const MullModule &module) const;
+
+  std::string cacheDirectory;
+  std::string finder;
+  std::atomic<uint64_t> hits;
+};
+
+} // namespace mull
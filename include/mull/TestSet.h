@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mull {
+
+/// A set of tests as a compressed bitset over their ids, see Test::getId.
+/// Only the 64-bit words that hold a test are stored, along with their
+/// positions, both sorted by the position: the tests reaching a function are
+/// few compared to all the tests, and the tests of one suite have ids next
+/// to each other. The operations on two sets go over their words in step.
+class TestSet {
+public:
+  /// Returns false if the test is in the set already. Appending is cheap,
+  /// the ids mostly come in ascending order.
+  bool insert(uint32_t id);
+  bool contains(uint32_t id) const;
+
+  size_t size() const;
+  bool empty() const { return words.empty(); }
+
+  /// Adds the tests of the other set to this one
+  void unite(const TestSet &other);
+  bool intersects(const TestSet &other) const;
+  size_t intersectionSize(const TestSet &other) const;
+
+  /// The ids in ascending order
+  std::vector<uint32_t> ids() const;
+
+private:
+  /// The id of the first test of each word, divided by 64
+  std::vector<uint32_t> positions;
+  std::vector<uint64_t> words;
+};
+
+} // namespace mull
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace mull {
+
+class KillMatrix;
+
+/// The columns of a small set of tests that kills every mutant the tests of
+/// the matrix kill, in the order they are picked. The greedy set cover picks
+/// the test that kills the most mutants not killed yet, the lowest column
+/// on a tie, until no test kills any more of them. A test that timed out or
+/// crashed against a mutant killed it.
+/// The kills of every test are a bitset over the mutants. The columns are
+/// split between the workers, both to build the bitsets and to count what
+/// each test would add.
+std::vector<size_t> minimizeTestSuite(const KillMatrix &matrix,
+                                      size_t workers);
+
+/// Writes the names of the tests as the tests of a config, see
+/// RawConfig::getTests, returns false if the file cannot be written
+bool writeTestList(const std::string &path,
+                   const std::vector<std::string> &testNames);
+
+} // namespace mull
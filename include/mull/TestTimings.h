@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mull {
+
+class Program;
+class Test;
+
+/// The running times of the original tests in the previous runs, one file
+/// per program under <cache>/timings/, named after the MD5 of its modules.
+/// Unlike the calls of the reachability cache they stay good enough to
+/// schedule the tests when the code changes.
+class TestTimings {
+public:
+  /// An empty directory disables the timings
+  explicit TestTimings(const std::string &cacheDirectory);
+
+  void load(Program &program);
+
+  /// Orders the tests longest first, the tests with no timing go last in
+  /// their order. Returns false and leaves the tests as they are if none
+  /// has a timing.
+  bool sortLongestFirst(std::vector<Test *> &tests) const;
+
+  /// The tests with a result replace their timings, the others keep the
+  /// ones of the previous runs. The tests that are gone are dropped.
+  void save(const std::vector<Test> &tests);
+
+private:
+  bool read();
+  void write();
+
+  std::string cacheDirectory;
+  std::string path;
+  std::unordered_map<std::string, int64_t> timings;
+};
+
+} // namespace mull
@@ -1,7 +1,11 @@
 #pragma once
 
+#include "mull/ReachableTests.h"
+
 #include <llvm/IR/Function.h>
 
+#include <cstdint>
+
 namespace mull {
 class Test;
 
@@ -9,28 +13,46 @@ class MergedTestee {
 public:
   explicit MergedTestee(llvm::Function *function, Test *test, int distance);
   void addReachableTest(Test *test, int distance);
-  const std::vector<std::pair<Test *, int>> &getReachableTests() const;
+  /// Adds the tests of another testee of the same function after these ones
+  void addReachableTests(const MergedTestee &other);
+  const ReachableTests &getReachableTests() const;
+  /// The mutation points of the function share the list of the testee
+  const std::shared_ptr<const ReachableTests> &getSharedReachableTests() const;
   llvm::Function *getTesteeFunction() const;
 
 private:
-  std::vector<std::pair<Test *, int>> reachableTests;
+  std::shared_ptr<const ReachableTests> reachableTests;
   llvm::Function *function;
 };
 
 class Testee {
 public:
-  Testee(llvm::Function *testeeFunction, Test *test, int distance);
+  /// The index is the one of the function in the instrumentation, 0 if the
+  /// function is not known to the instrumentation
+  Testee(llvm::Function *testeeFunction, Test *test, int distance,
+         uint32_t functionIndex = 0);
   llvm::Function *getTesteeFunction() const;
   Test *getTest() const;
   int getDistance() const;
+  uint32_t getFunctionIndex() const;
 
 private:
   llvm::Function *testeeFunction;
   Test *test;
   int distance;
+  uint32_t functionIndex;
 };
 
+/// The merged testees come in the order their functions first appear in.
+/// The functions that have an index are found in a table indexed by it, the
+/// others through a hash map: a function is expected to either always have
+/// its index or never.
 std::vector<MergedTestee>
 mergeTestees(std::vector<std::unique_ptr<Testee>> &testees);
+/// The same merge, where each worker first merges a contiguous range of the
+/// testees on its own. Combining the ranges in their order then only goes
+/// over the functions of each range instead of every (test, function) pair.
+std::vector<MergedTestee>
+mergeTestees(std::vector<std::unique_ptr<Testee>> &testees, size_t workers);
 
 } // namespace mull
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "mull/Config/ConfigurationOptions.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace mull {
+
+struct Configuration;
+struct ExecutionResult;
+class Test;
+
+/// Derives the timeout of a test run against a mutant from the distribution
+/// of the runs of the original test, see TimeoutPolicyConfig. A single run
+/// has no deviation, so with the defaults the timeout is ten times the run,
+/// but never below 30 milliseconds.
+/// The measures are in nanoseconds, the sandbox takes milliseconds.
+class TimeoutPolicy {
+public:
+  TimeoutPolicy(const TimeoutPolicyConfig &config, int workers,
+                unsigned cores);
+  /// The machine is as loaded as there are mutant execution workers per core
+  explicit TimeoutPolicy(const Configuration &config);
+
+  long long timeout(const Test &test) const;
+  long long timeout(const std::vector<int64_t> &runningTimes) const;
+
+  /// How much slower the tests run because the workers share the cores
+  double getLoad() const { return load; }
+
+  /// The run time the child measured when the run was forked, otherwise
+  /// the run time the parent measured
+  static int64_t runningTime(const ExecutionResult &result);
+
+private:
+  TimeoutPolicyConfig config;
+  double load;
+};
+
+} // namespace mull
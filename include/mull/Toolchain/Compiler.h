@@ -3,6 +3,9 @@
 #include "llvm/Object/Binary.h"
 #include "llvm/Object/ObjectFile.h"
 
+#include <functional>
+#include <vector>
+
 namespace llvm {
 
 class Module;
@@ -20,5 +23,12 @@ public:
   compileModule(const MullModule &module, llvm::TargetMachine &machine);
   llvm::object::OwningBinary<llvm::object::ObjectFile>
   compileModule(llvm::Module *module, llvm::TargetMachine &machine);
+
+  /// Splits the module into the given number of parts and compiles them on
+  /// the shared pool, the calling thread included. Every part is read into
+  /// a context of its own and compiled with the machine of its thread.
+  std::vector<llvm::object::OwningBinary<llvm::object::ObjectFile>>
+  compileModuleInParts(const llvm::Module &module, unsigned parts,
+                       std::function<llvm::TargetMachine &()> machine);
 };
 } // namespace mull
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "mull/Toolchain/SlabMemoryManager.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <vector>
+
+namespace mull {
+
+/// Counts the bytes of the sections the JIT allocates to load the objects,
+/// over all the JIT engines of the process
+class CountingMemoryManager : public SlabMemoryManager {
+public:
+  CountingMemoryManager();
+  ~CountingMemoryManager() override;
+
+  uint8_t *allocateCodeSection(uintptr_t size, unsigned alignment,
+                               unsigned sectionID,
+                               llvm::StringRef sectionName) override;
+  uint8_t *allocateDataSection(uintptr_t size, unsigned alignment,
+                               unsigned sectionID, llvm::StringRef sectionName,
+                               bool isReadOnly) override;
+  bool finalizeMemory(std::string *errorMessage = nullptr) override;
+
+  static uint64_t allocatedBytes();
+
+  /// Calls back with the writable data sections of all the finalized
+  /// managers of the process, i.e. the globals of the programs once they
+  /// are relocated. The managers stay alive during the calls, and the
+  /// identifier of a manager is never reused.
+  static void forEachWritableSection(
+      const std::function<void(uint64_t manager, uint8_t *address,
+                               uintptr_t size)> &callback);
+  /// The same in a forked child, where the lock may have been held by a
+  /// thread that did not make it into the child: false, without calling
+  /// back, if so
+  static bool forEachWritableSectionInChild(
+      const std::function<void(uint64_t manager, uint8_t *address,
+                               uintptr_t size)> &callback);
+
+private:
+  static std::atomic<uint64_t> bytes;
+
+  const uint64_t identifier;
+  std::vector<std::pair<uint8_t *, uintptr_t>> writableSections;
+};
+
+/// A copy of the writable data sections of the process, see
+/// CountingMemoryManager::forEachWritableSection. On restore the sections
+/// of the managers destroyed meanwhile are gone, and the ones finalized
+/// meanwhile are left as they are.
+class WritableSectionsSnapshot {
+public:
+  void take();
+  void restore() const;
+  /// See CountingMemoryManager::forEachWritableSectionInChild
+  bool takeInChild();
+  bool restoreInChild() const;
+  /// Whether the sections hold what was copied, false if they cannot be
+  /// looked at
+  bool matchesInChild() const;
+  bool empty() const { return sections.empty(); }
+
+private:
+  void restoreSection(uint64_t manager, uint8_t *address,
+                      uintptr_t size) const;
+
+  std::map<std::pair<uint64_t, uint8_t *>, std::vector<uint8_t>> sections;
+};
+
+} // namespace mull
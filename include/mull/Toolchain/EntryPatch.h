@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mull {
+
+/// A direct jump written over the first instruction of a function in the
+/// JIT memory, so that its callers land in another function without the
+/// load and the indirect call of a trampoline. The jump is one instruction,
+/// `jmp rel32` on x86-64 and `b imm26` on AArch64: it fits in any function
+/// and reaches the functions linked near it, within 2GB and 128MB
+/// respectively. Elsewhere nothing is reachable.
+///
+/// The page of the entry is made writable for the time of the write, so
+/// the write must not race with the code running: it happens either before
+/// the program runs or in a forked child, where it lands in the private
+/// copy of the page.
+class EntryPatch {
+public:
+  /// Keeps the bytes the jumps overwrite
+  explicit EntryPatch(uint64_t entry);
+
+  static bool reaches(uint64_t entry, uint64_t target);
+
+  uint64_t getEntry() const { return entry; }
+
+  /// Jumps to the target if it is in reach, otherwise puts back the entry
+  /// as it was, for the callers to go through the trampoline again.
+  /// Returns false if the page cannot be written.
+  bool jumpTo(uint64_t target) const;
+  bool restore() const;
+
+private:
+  static const size_t MaxJumpSize = 8;
+  bool write(const uint8_t *bytes, size_t size) const;
+
+  uint64_t entry;
+  uint8_t original[MaxJumpSize];
+};
+
+} // namespace mull
@@ -2,21 +2,89 @@
 
 #include "LLVMCompatibility.h"
 
+#include <functional>
+#include <memory>
+#include <mutex>
+
 namespace mull {
 
+class ProgramLibrary;
+class SymbolIndex;
+
+/// Eager linking relocates all the objects up front with one loader.
+/// Lazy linking relocates an object on the first lookup of one of its
+/// symbols, either by the test runner or by another object being relocated,
+/// so only the code reachable from the executed tests is ever linked.
+/// Parallel linking splits the objects into shards with a loader each,
+/// loads the shards on several threads, then relocates them on several
+/// threads once the addresses of all the symbols are known.
+enum class JITLinking { Eager, Lazy, Parallel };
+
 class JITEngine {
+public:
+  using MemoryManagerFactory =
+      std::function<std::unique_ptr<llvm::RuntimeDyld::MemoryManager>()>;
+
+private:
+  class LazyLinker;
+  class ParallelLinker;
+
+  JITLinking linking;
   std::vector<llvm::object::ObjectFile *> objectFiles;
   llvm::StringMap<llvm_compat::JITSymbol> symbolTable;
   llvm_compat::JITSymbol symbolNotFound;
+  std::unique_ptr<llvm_compat::SymbolResolver> resolver;
   std::unique_ptr<llvm::RuntimeDyld::MemoryManager> memoryManager;
+  std::unique_ptr<llvm::RuntimeDyld> dynamicLoader;
+  std::unique_ptr<LazyLinker> lazyLinker;
+  std::unique_ptr<ParallelLinker> parallelLinker;
+  std::shared_ptr<const SymbolIndex> symbolIndex;
+  const ProgramLibrary *library;
+  std::unique_ptr<std::mutex> lookupMutex;
+  bool symbolTableComplete;
+  uint64_t image;
 
 public:
-  JITEngine();
-  void addObjectFiles(
-      std::vector<llvm::object::ObjectFile *> &files,
-      llvm_compat::SymbolResolver &resolver,
-      std::unique_ptr<llvm::RuntimeDyld::MemoryManager> memoryManager);
+  /// The symbol index is reused when it indexes the objects being linked
+  /// lazily or in parallel, otherwise the engine builds its own
+  explicit JITEngine(JITLinking linking = JITLinking::Eager,
+                     std::shared_ptr<const SymbolIndex> symbolIndex = nullptr);
+  JITEngine(JITEngine &&);
+  ~JITEngine();
+
+  void addObjectFiles(std::vector<llvm::object::ObjectFile *> &files,
+                      std::unique_ptr<llvm_compat::SymbolResolver> resolver,
+                      MemoryManagerFactory createMemoryManager);
+
+  /// Eager linking of objects handed over one at a time, e.g. as soon as
+  /// each of them is compiled: addObjectFile may be called from any thread
+  /// between beginObjectFiles and finishObjectFiles, which relocates them
+  /// once the last one is in. The objects must outlive the engine.
+  void beginObjectFiles(std::unique_ptr<llvm_compat::SymbolResolver> resolver,
+                        MemoryManagerFactory createMemoryManager);
+  void addObjectFile(llvm::object::ObjectFile &file);
+  void finishObjectFiles();
+
+  /// The symbols are looked up in a loaded program library rather than in
+  /// linked objects, the library must outlive the engine
+  void addLibrary(const ProgramLibrary &programLibrary);
+
+  /// The symbol table is filled on the first lookup of every symbol, which
+  /// takes a lock. Once all the symbols are resolved up front, the lookups
+  /// are read-only and safe in a process forked while another thread was
+  /// looking up. Not supported by lazy linking.
+  void resolveAllSymbols();
+
   llvm_compat::JITSymbol &getSymbol(llvm::StringRef name);
+
+  /// Identifies the objects added last, unique among all the engines of
+  /// the process, so that the addresses of an image can be kept around
+  uint64_t getImage() const;
+
+private:
+  /// Forgets the objects of the previous image
+  void startImage(std::unique_ptr<llvm_compat::SymbolResolver> resolver);
+  llvm_compat::JITSymbol &findSymbol(llvm::StringRef name);
 };
 
 } // namespace mull
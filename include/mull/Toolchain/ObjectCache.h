@@ -1,30 +1,130 @@
 #pragma once
 
+#include "mull/Metrics/Metrics.h"
+#include "mull/Toolchain/ObjectCacheBackend.h"
+
+#include <llvm/ADT/StringMap.h>
+#include <llvm/ADT/StringSet.h>
 #include <llvm/Object/ObjectFile.h>
+#include <llvm/Support/MemoryBuffer.h>
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 #include <string>
+#include <thread>
 
 namespace mull {
 class MullModule;
 class MutationPoint;
 
+/// Objects are stored under the MD5 of their identifiers, sharded by the
+/// first two hex digits: <cache>/ab/cdef....o, or .oz when compressed.
+/// Every object is written to a temporary file and renamed into place, so
+/// several mull processes can share one cache directory.
+/// Cached objects are memory-mapped read-only on the first lookup, and the
+/// mapping is shared by all the later lookups until the cache is destroyed,
+/// so the objects returned by the cache must not outlive it.
+/// A remote backend, when given, is asked for the objects missing locally
+/// and receives every new object, so that CI machines can share a cache.
+/// The mutated object of every module is recorded under
+/// <cache>/predictions/, so that the next run can read it ahead before its
+/// mutations are known.
+/// The files are written on a background thread, so that slow storage does
+/// not hold up the compile workers. A lookup of an object still being
+/// written waits for it, the pending writes are finished on destruction.
 class ObjectCache {
+  /// A file for the writer, with its share of the metrics
+  struct PendingWrite {
+    std::string identifier;
+    std::string path;
+    std::string contents;
+    uint64_t size;
+    uint64_t saved;
+  };
+
   bool useOnDiskCache;
   std::string cacheDirectory;
+  bool compression;
+  uint64_t sizeLimit;
+  bool populate;
+  std::unique_ptr<ObjectCacheBackend> remote;
+
+  std::mutex mappingsMutex;
+  llvm::StringMap<std::unique_ptr<llvm::MemoryBuffer>> mappings;
+
+  std::mutex writesMutex;
+  std::condition_variable writesCondition;
+  std::deque<PendingWrite> writes;
+  /// The objects queued or being written
+  llvm::StringSet<> writing;
+  size_t pendingFiles;
+  uint64_t pendingBytes;
+  bool stopping;
+  std::thread writer;
+
+  std::mutex prefetchMutex;
+  /// The mutated object of each module in the previous run
+  llvm::StringMap<std::string> predictions;
+  llvm::StringSet<> prefetched;
+
+  std::atomic<uint64_t> hits;
+  std::atomic<uint64_t> misses;
+  std::atomic<uint64_t> remoteHits;
+  std::atomic<uint64_t> bytesRead;
+  std::atomic<uint64_t> bytesWritten;
+  std::atomic<uint64_t> bytesSaved;
+  std::atomic<uint64_t> bytesEvicted;
+  std::atomic<uint64_t> prefetches;
 
 public:
-  ObjectCache(bool useCache, const std::string &cacheDir);
+  /// When the objects exceed sizeLimit bytes, the least recently used ones
+  /// are evicted on startup. Only the object shards count, the other caches
+  /// sharing the directory are left alone. 0 means no limit.
+  /// With populate the pages of a mapped object are read ahead right away
+  /// instead of faulting in while the object is being linked.
+  ObjectCache(bool useCache, const std::string &cacheDir,
+              bool compression = false, uint64_t sizeLimit = 0,
+              bool populate = false,
+              std::unique_ptr<ObjectCacheBackend> remote = nullptr);
+  ~ObjectCache();
 
+  /// The suffix tells apart the objects of different instrumentation modes
+  llvm::object::OwningBinary<llvm::object::ObjectFile>
+  getInstrumentedObject(const MullModule &module,
+                        const std::string &suffix = "");
+  /// The suffix tells apart the parts of a module compiled in parts
   llvm::object::OwningBinary<llvm::object::ObjectFile>
-  getInstrumentedObject(const MullModule &module);
+  getObject(const MullModule &module, const std::string &suffix = "");
   llvm::object::OwningBinary<llvm::object::ObjectFile>
-  getObject(const MullModule &module);
+  getSatelliteObject(const MullModule &module, size_t index);
 
   void putInstrumentedObject(
       llvm::object::OwningBinary<llvm::object::ObjectFile> &object,
-      const MullModule &module);
+      const MullModule &module, const std::string &suffix = "");
   void putObject(llvm::object::OwningBinary<llvm::object::ObjectFile> &object,
-                 const MullModule &module);
+                 const MullModule &module, const std::string &suffix = "");
+  void putSatelliteObject(
+      llvm::object::OwningBinary<llvm::object::ObjectFile> &object,
+      const MullModule &module, size_t index);
+
+  /// Asks the kernel to read the mutated objects of the module ahead, and
+  /// returns at once. With `predicted` the objects are those of the
+  /// previous run, otherwise those of the mutations found so far.
+  void prefetchObjects(const MullModule &module, unsigned partitions,
+                       bool predicted);
+  /// Records the mutated object of the module for the next run
+  void rememberObject(const MullModule &module);
+
+  /// Waits for the pending writes, before a fork: the children would have
+  /// the queue but not the writer
+  void flush();
+
+  ObjectCacheMetrics getMetrics() const;
+
+  /// Identifies a part of a module compiled in parts
+  static std::string partSuffix(size_t index, size_t parts);
 
 private:
   llvm::object::OwningBinary<llvm::object::ObjectFile>
@@ -32,5 +132,20 @@ private:
   void
   putObjectOnDisk(llvm::object::OwningBinary<llvm::object::ObjectFile> &object,
                   const std::string &identifier);
+
+  void writeObject(const std::string &identifier, llvm::StringRef contents);
+  void queueWrite(PendingWrite write);
+  void writeFiles();
+  bool writeFile(const PendingWrite &write);
+  void waitForWrite(const std::string &identifier);
+
+  const llvm::MemoryBuffer *mapObject(const std::string &identifier);
+  void prefetchObject(const std::string &identifier);
+  std::string predictionPath(const MullModule &module) const;
+  std::unique_ptr<llvm::MemoryBuffer>
+  fetchRemoteObject(const std::string &identifier);
+  std::string objectKey(const std::string &identifier) const;
+  std::string objectPath(const std::string &identifier, bool compressed) const;
+  void evict();
 };
 } // namespace mull
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <llvm/ADT/StringRef.h>
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace mull {
+
+/// Storage behind the local object cache: it is asked for the objects
+/// missing locally and is given every object stored locally.
+/// The keys are the content addresses of the local cache.
+class ObjectCacheBackend {
+public:
+  virtual ~ObjectCacheBackend() = default;
+
+  /// Returns false when the backend does not have the object
+  virtual bool fetch(const std::string &key, std::string &contents) = 0;
+  virtual bool store(const std::string &key, llvm::StringRef contents) = 0;
+};
+
+/// Objects are stored with plain HTTP/1.0 requests, GET and PUT of
+/// <url>/<key>, as understood by WebDAV servers and HTTP caches such as
+/// bazel-remote or nginx. Only http:// URLs are supported.
+class HTTPObjectCacheBackend : public ObjectCacheBackend {
+public:
+  explicit HTTPObjectCacheBackend(const std::string &url);
+
+  bool fetch(const std::string &key, std::string &contents) override;
+  bool store(const std::string &key, llvm::StringRef contents) override;
+
+private:
+  /// With requireLength a response without Content-Length is rejected, a
+  /// body cut short could not be told apart from a complete one
+  bool request(const std::string &method, const std::string &key,
+               llvm::StringRef body, bool requireLength, int &status,
+               std::string &response);
+
+  bool valid;
+  std::string host;
+  std::string port;
+  std::string path;
+};
+
+/// Stores the objects on a background thread, so that uploads never block
+/// compilation. The pending uploads are finished on destruction.
+/// Once the pending uploads hold maxPendingBytes, further objects are not
+/// uploaded rather than piling up in memory behind a slow server.
+class AsyncObjectCacheBackend : public ObjectCacheBackend {
+public:
+  static const size_t DefaultMaxPendingBytes = 64 * 1024 * 1024;
+
+  explicit AsyncObjectCacheBackend(
+      std::unique_ptr<ObjectCacheBackend> backend,
+      size_t maxPendingBytes = DefaultMaxPendingBytes);
+  ~AsyncObjectCacheBackend() override;
+
+  bool fetch(const std::string &key, std::string &contents) override;
+  bool store(const std::string &key, llvm::StringRef contents) override;
+
+private:
+  void upload();
+
+  std::unique_ptr<ObjectCacheBackend> backend;
+  std::mutex queueMutex;
+  std::condition_variable queueCondition;
+  std::deque<std::pair<std::string, std::string>> queue;
+  size_t maxPendingBytes;
+  size_t pendingBytes;
+  bool stopping;
+  std::thread uploader;
+};
+
+} // namespace mull
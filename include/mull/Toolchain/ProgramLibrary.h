@@ -0,0 +1,72 @@
+#pragma once
+
+#include "LLVMCompatibility.h"
+
+#include <llvm/ADT/StringMap.h>
+#include <llvm/Object/ObjectFile.h>
+
+#include <string>
+#include <vector>
+
+namespace llvm {
+class Module;
+class TargetMachine;
+} // namespace llvm
+
+namespace mull {
+
+class Instrumentation;
+struct InstrumentationInfo;
+
+/// The instrumented program linked by the system linker into a shared
+/// library kept in the cache, <cache>/programs/<hash>.so, where the hash
+/// combines the hashes of the objects. The first run links it, the later
+/// runs load it with dlopen instead of relocating every object with
+/// RuntimeDyld, and the processes running the tests share its pages.
+/// The objects must be position independent and leave the static
+/// constructors to the test runner, see Toolchain::isPositionIndependent.
+/// What the JIT resolves to the memory of mull, the instrumentation
+/// globals and __cxa_atexit, the library defines as slots that are filled
+/// once it is loaded. Only ELF is supported. A loaded library is never
+/// unloaded: the forked runs and the destructors registered by the tests
+/// may still refer to it.
+class ProgramLibrary {
+public:
+  explicit ProgramLibrary(const std::string &cacheDirectory);
+
+  static bool isSupported();
+
+  /// Removes the static constructors from the instrumented module: dlopen
+  /// would run them, the test runner runs them in every test run instead
+  static void dropStaticConstructors(llvm::Module &module);
+
+  /// Links the library unless the cache has it, then loads it. Returns
+  /// false, with a warning, when either fails, e.g. without a linker.
+  bool load(const std::vector<llvm::object::ObjectFile *> &objectFiles,
+            llvm::TargetMachine &machine);
+
+  /// Fills the slots of the loaded library, and returns the trampoline the
+  /// instrumented code reads, nullptr when the code is not instrumented
+  InstrumentationInfo **
+  bindSlots(Instrumentation &instrumentation,
+            llvm_compat::CXXRuntimeOverrides &overrides);
+
+  /// Every symbol the library defines, the local ones included, e.g. the
+  /// static constructors: 0 when it does not define the symbol
+  uint64_t getAddress(llvm::StringRef name) const;
+  const llvm::StringMap<uint64_t> &getSymbols() const;
+
+  const std::string &getPath() const;
+
+private:
+  bool link(const std::vector<llvm::object::ObjectFile *> &objectFiles,
+            llvm::TargetMachine &machine);
+  bool readSymbols();
+
+  std::string directory;
+  std::string path;
+  void *handle;
+  llvm::StringMap<uint64_t> symbols;
+};
+
+} // namespace mull
@@ -20,6 +20,7 @@ class InstrumentationResolver : public llvm_compat::SymbolResolver {
   Instrumentation &instrumentation;
   std::string instrumentationInfoName;
   std::string functionOffsetPrefix;
+  std::string blockOffsetPrefix;
   InstrumentationInfo **trampoline;
 
 public:
@@ -3,6 +3,8 @@
 #include "LLVMCompatibility.h"
 #include <llvm/ExecutionEngine/Orc/ExecutionUtils.h>
 
+#include <string>
+
 namespace mull {
 class Trampolines;
 class Mangler;
@@ -11,6 +13,9 @@ class MutationResolver : public llvm_compat::SymbolResolver {
   llvm_compat::CXXRuntimeOverrides &overrides;
   Trampolines &trampolines;
   Mangler &mangler;
+  std::string instrumentationInfoName;
+  std::string functionOffsetPrefix;
+  std::string blockOffsetPrefix;
 
 public:
   MutationResolver(llvm_compat::CXXRuntimeOverrides &overrides,
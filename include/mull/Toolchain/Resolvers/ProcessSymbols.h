@@ -0,0 +1,37 @@
+#pragma once
+
+#include <llvm/ADT/StringMap.h>
+#include <llvm/Object/ObjectFile.h>
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace mull {
+
+/// The addresses of the symbols defined by the process and the dynamic
+/// libraries it loaded, shared by the resolvers of every link. Searching
+/// the process walks all the loaded libraries with dlsym, for every symbol
+/// an object leaves undefined, and every worker links the same objects
+/// again, so each name is searched for only once, found or not.
+class ProcessSymbols {
+public:
+  static ProcessSymbols &shared();
+
+  /// 0 when the process does not define the symbol
+  uint64_t getAddress(const std::string &name);
+  /// Searches the process for the symbols the objects leave undefined ahead
+  /// of the links, spread over the workers
+  void prefetch(const std::vector<llvm::object::ObjectFile *> &objectFiles,
+                size_t workers);
+  /// A library loaded since may define the symbols that were missing
+  void forgetMissingSymbols();
+  size_t size();
+
+private:
+  std::mutex mutex;
+  llvm::StringMap<uint64_t> addresses;
+};
+
+} // namespace mull
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <llvm/ExecutionEngine/RTDyldMemoryManager.h>
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mull {
+
+/// Places the sections of an image next to each other instead of spreading
+/// them over many small mappings: the code, the read-only data and the
+/// writable data are each bump-allocated from large slabs, and every slab is
+/// protected once, when the image is finalized.
+/// The loader tells the sizes of an object ahead of loading it, see
+/// reserveAllocationSpace, so the sections of an object share one slab. The
+/// slabs of a manager grow geometrically, an image takes a few of them.
+class SlabMemoryManager : public llvm::RTDyldMemoryManager {
+public:
+  SlabMemoryManager();
+  ~SlabMemoryManager() override;
+
+  bool needsToReserveAllocationSpace() override { return true; }
+  void reserveAllocationSpace(uintptr_t codeSize, uint32_t codeAlign,
+                              uintptr_t roDataSize, uint32_t roDataAlign,
+                              uintptr_t rwDataSize,
+                              uint32_t rwDataAlign) override;
+  uint8_t *allocateCodeSection(uintptr_t size, unsigned alignment,
+                               unsigned sectionID,
+                               llvm::StringRef sectionName) override;
+  uint8_t *allocateDataSection(uintptr_t size, unsigned alignment,
+                               unsigned sectionID, llvm::StringRef sectionName,
+                               bool isReadOnly) override;
+  /// The sections loaded after go to new slabs, except the writable data
+  bool finalizeMemory(std::string *errorMessage = nullptr) override;
+
+  /// Aligns the slabs the managers map from now on to huge pages and asks
+  /// the kernel to back them with transparent huge pages, where supported
+  static void setHugePages(bool enabled);
+  /// The bytes of the slabs mapped over all the managers of the process
+  static uint64_t mappedBytes();
+
+private:
+  struct Slab {
+    uint8_t *base;
+    uintptr_t size;
+    /// The rest of the slab is never touched
+    uintptr_t used;
+  };
+
+  /// The slabs of one kind of sections, only the last one has room left
+  struct Arena {
+    std::vector<Slab> slabs;
+    uint8_t *next;
+    uint8_t *end;
+    /// The slabs from this one on are to be protected on finalize
+    size_t firstPending;
+  };
+
+  Arena code;
+  Arena readOnlyData;
+  Arena writableData;
+
+  uint8_t *allocate(Arena &arena, uintptr_t size, unsigned alignment);
+  /// Starts a new slab unless the last one has the room
+  bool reserve(Arena &arena, uintptr_t size, uint32_t alignment);
+  bool protect(Arena &arena, int protection, std::string *errorMessage);
+};
+
+} // namespace mull
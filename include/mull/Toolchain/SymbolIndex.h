@@ -0,0 +1,34 @@
+#pragma once
+
+#include <llvm/ADT/StringMap.h>
+#include <llvm/Object/ObjectFile.h>
+
+#include <vector>
+
+namespace mull {
+
+/// Maps the names of the symbols defined by a set of objects to the objects
+/// defining them. The index only depends on the objects, so it is built once
+/// and then shared read-only by all the engines linking the same objects.
+class SymbolIndex {
+public:
+  explicit SymbolIndex(std::vector<llvm::object::ObjectFile *> objectFiles);
+
+  bool indexes(const std::vector<llvm::object::ObjectFile *> &files) const;
+
+  /// Returns false when none of the objects defines the symbol
+  bool lookup(llvm::StringRef name, size_t &objectIndex) const;
+
+  const std::vector<llvm::object::ObjectFile *> &getObjectFiles() const;
+
+private:
+  struct Owner {
+    size_t objectIndex;
+    bool weak;
+  };
+
+  std::vector<llvm::object::ObjectFile *> objectFiles;
+  llvm::StringMap<Owner> owners;
+};
+
+} // namespace mull
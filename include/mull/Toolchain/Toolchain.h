@@ -4,6 +4,7 @@
 #include "Mangler.h"
 #include "ObjectCache.h"
 
+#include <llvm/Support/CodeGen.h>
 #include <llvm/Target/TargetMachine.h>
 
 namespace mull {
@@ -17,6 +18,10 @@ class Toolchain {
   };
 
   NativeTarget nativeTarget;
+  llvm::CodeGenOpt::Level optLevel;
+  uint64_t parallelCodegenThreshold;
+  unsigned codegenWorkers;
+  bool positionIndependent;
   std::unique_ptr<llvm::TargetMachine> machine;
   ObjectCache objectCache;
   Compiler simpleCompiler;
@@ -28,6 +33,16 @@ public:
   ObjectCache &cache();
   Compiler &compiler();
   llvm::TargetMachine &targetMachine();
+  /// A machine per thread, kept for the lifetime of the thread: the workers
+  /// of the pool reuse theirs from one compilation phase to the next
+  llvm::TargetMachine &workerTargetMachine();
+  std::unique_ptr<llvm::TargetMachine> createTargetMachine();
+  /// The number of parts to compile the module in: one per worker for the
+  /// modules above the parallel codegen threshold, 1 for the others
+  unsigned codegenPartitions(const MullModule &module) const;
   mull::Mangler &mangler();
+  /// The instrumented objects are linked into a program library, see
+  /// ProgramLibrary
+  bool isPositionIndependent() const;
 };
 } // namespace mull
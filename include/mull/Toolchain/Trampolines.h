@@ -1,13 +1,23 @@
 #pragma once
 
-#include <map>
+#include "mull/Toolchain/EntryPatch.h"
+
+#include <llvm/ADT/StringMap.h>
+
+#include <cstdint>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace mull {
 class JITEngine;
 class Mangler;
+class MutationPoint;
 
+/// The trampolines of the mutated functions, the mutant runs store the
+/// address of either the original or a mutated function in them. They are
+/// laid out side by side in one block of whole cache lines, so that the
+/// loads of the trampolines the tests go through share a few lines.
 class Trampolines {
 public:
   explicit Trampolines(const std::vector<std::string> &trampolineNames);
@@ -19,8 +29,28 @@ public:
 
   void fixupOriginalFunctions(JITEngine &jit);
 
+  /// With direct calls, the entries of the functions the points mutate
+  /// jump straight to the original copies rather than through the
+  /// trampolines, see EntryPatch. A mutant run then patches the entry of
+  /// its own function only, on top of storing the trampoline, which the
+  /// unlinked ODR copies still go through. Must be called before the
+  /// program runs, it skips the entries already patched.
+  void redirectEntries(JITEngine &jit, Mangler &mangler,
+                       const std::vector<MutationPoint *> &points);
+  /// The patched entry behind a trampoline, nullptr if there is none
+  const EntryPatch *findEntry(const std::string &name) const;
+
 private:
   const std::vector<std::string> &trampolineNames;
-  std::map<std::string, uint64_t *> _trampolines;
+  uint64_t *table;
+  /// The index of each trampoline in the table, by mangled name
+  llvm::StringMap<size_t> indices;
+  /// The mangled names of the original functions, in the order of the table
+  std::vector<std::string> originalNames;
+  std::vector<EntryPatch> entries;
+  /// The index of the patched entry of each trampoline in the table, the
+  /// ODR copies of a function share its linked entry
+  std::vector<int> entryIndices;
+  std::unordered_map<uint64_t, size_t> entryAddresses;
 };
 } // namespace mull
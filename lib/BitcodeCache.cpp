@@ -0,0 +1,199 @@
+#include "mull/BitcodeCache.h"
+
+#include "mull/CacheFile.h"
+#include "mull/Hash.h"
+#include "mull/Logger.h"
+
+#include <llvm/Support/MathExtras.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <cassert>
+#include <cstring>
+
+#include <sys/stat.h>
+
+using namespace mull;
+
+static const char Magic[8] = {'M', 'U', 'L', 'L', 'B', 'C', '1', '\0'};
+static const uint32_t Version = 1;
+static const size_t HashLength = 64;
+/// The files start at multiples of it, as they do in an object file
+static const size_t FileAlignment = 8;
+
+namespace {
+
+/// What tells a changed executable from the same one without reading it
+struct Stamp {
+  uint64_t size;
+  uint64_t device;
+  uint64_t inode;
+  int64_t modified;
+  int64_t modifiedNanoseconds;
+};
+
+/// Followed by a FileEntry per file, then by the files
+struct Header {
+  char magic[8];
+  uint32_t version;
+  uint32_t hashAlgorithm;
+  uint64_t files;
+  Stamp stamp;
+  char contentHash[HashLength];
+};
+
+struct FileEntry {
+  uint64_t offset;
+  uint64_t size;
+  char hash[HashLength];
+};
+
+} // namespace
+
+static bool stampOf(const std::string &path, Stamp &stamp) {
+  struct stat status;
+  if (stat(path.c_str(), &status) != 0) {
+    return false;
+  }
+  memset(&stamp, 0, sizeof(stamp));
+  stamp.size = status.st_size;
+  stamp.device = status.st_dev;
+  stamp.inode = status.st_ino;
+#ifdef __APPLE__
+  stamp.modified = status.st_mtimespec.tv_sec;
+  stamp.modifiedNanoseconds = status.st_mtimespec.tv_nsec;
+#else
+  stamp.modified = status.st_mtim.tv_sec;
+  stamp.modifiedNanoseconds = status.st_mtim.tv_nsec;
+#endif
+  return true;
+}
+
+static bool sameStamp(const Stamp &a, const Stamp &b) {
+  return a.size == b.size && a.device == b.device && a.inode == b.inode &&
+         a.modified == b.modified &&
+         a.modifiedNanoseconds == b.modifiedNanoseconds;
+}
+
+static std::string contentHashOf(llvm::StringRef executable) {
+  return hashOf(executable, HashAlgorithm::XXHash64);
+}
+
+static std::string cachePath(const std::string &cacheDirectory,
+                             const std::string &executablePath) {
+  return cacheDirectory + "/bitcode/" +
+         hashOf(executablePath, HashAlgorithm::XXHash64);
+}
+
+static std::string fixedString(const char *field) {
+  return std::string(field, strnlen(field, HashLength));
+}
+
+BitcodeCache::BitcodeCache(std::unique_ptr<llvm::MemoryBuffer> mapping)
+    : mapping(std::move(mapping)) {}
+
+std::unique_ptr<BitcodeCache>
+BitcodeCache::load(const std::string &cacheDirectory,
+                   const std::string &executablePath,
+                   llvm::StringRef executable, HashAlgorithm hashAlgorithm) {
+  if (cacheDirectory.empty()) {
+    return nullptr;
+  }
+  bool requiresNullTerminator = false;
+  auto buffer = llvm::MemoryBuffer::getFile(
+      cachePath(cacheDirectory, executablePath), -1, requiresNullTerminator);
+  if (!buffer) {
+    return nullptr;
+  }
+
+  auto data = buffer.get()->getBuffer();
+  Header header;
+  if (data.size() < sizeof(header)) {
+    return nullptr;
+  }
+  memcpy(&header, data.data(), sizeof(header));
+  if (memcmp(header.magic, Magic, sizeof(Magic)) != 0 ||
+      header.version != Version ||
+      header.hashAlgorithm != uint32_t(hashAlgorithm) ||
+      header.files > (data.size() - sizeof(header)) / sizeof(FileEntry)) {
+    return nullptr;
+  }
+
+  /// The content is only hashed when the executable looks changed, e.g.
+  /// when it was copied over by an identical build
+  Stamp stamp;
+  bool fresh = stampOf(executablePath, stamp) && sameStamp(stamp, header.stamp);
+  if (!fresh && fixedString(header.contentHash) != contentHashOf(executable)) {
+    return nullptr;
+  }
+
+  std::unique_ptr<BitcodeCache> cache(
+      new BitcodeCache(std::move(buffer.get())));
+  auto entries = data.data() + sizeof(header);
+  for (uint64_t index = 0; index < header.files; index++) {
+    FileEntry entry;
+    memcpy(&entry, entries + index * sizeof(entry), sizeof(entry));
+    if (entry.offset > data.size() || entry.size > data.size() - entry.offset) {
+      return nullptr;
+    }
+    cache->files.push_back(data.substr(entry.offset, entry.size));
+    cache->hashes.push_back(fixedString(entry.hash));
+  }
+
+  if (!fresh) {
+    store(cacheDirectory, executablePath, executable, hashAlgorithm,
+          cache->files, cache->hashes);
+  }
+  return cache;
+}
+
+bool BitcodeCache::store(const std::string &cacheDirectory,
+                         const std::string &executablePath,
+                         llvm::StringRef executable,
+                         HashAlgorithm hashAlgorithm,
+                         const std::vector<llvm::StringRef> &files,
+                         const std::vector<std::string> &hashes) {
+  assert(files.size() == hashes.size());
+  Header header;
+  memset(&header, 0, sizeof(header));
+  if (cacheDirectory.empty() || !stampOf(executablePath, header.stamp)) {
+    return false;
+  }
+  memcpy(header.magic, Magic, sizeof(Magic));
+  header.version = Version;
+  header.hashAlgorithm = uint32_t(hashAlgorithm);
+  header.files = files.size();
+  auto contentHash = contentHashOf(executable);
+  strncpy(header.contentHash, contentHash.c_str(), HashLength);
+
+  std::vector<FileEntry> entries(files.size());
+  uint64_t offset = sizeof(header) + files.size() * sizeof(FileEntry);
+  for (size_t index = 0; index < files.size(); index++) {
+    offset = llvm::alignTo(offset, FileAlignment);
+    auto &entry = entries[index];
+    memset(&entry, 0, sizeof(entry));
+    entry.offset = offset;
+    entry.size = files[index].size();
+    if (hashes[index].size() > HashLength) {
+      return false;
+    }
+    strncpy(entry.hash, hashes[index].c_str(), HashLength);
+    offset += entry.size;
+  }
+
+  auto path = cachePath(cacheDirectory, executablePath);
+  auto error = writeCacheFile(path, [&](llvm::raw_ostream &outfile) {
+    outfile.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    outfile.write(reinterpret_cast<const char *>(entries.data()),
+                  entries.size() * sizeof(FileEntry));
+    for (size_t index = 0; index < files.size(); index++) {
+      outfile.write_zeros(entries[index].offset - outfile.tell());
+      outfile << files[index];
+    }
+  });
+  if (error) {
+    Logger::warn() << "Cannot cache the bitcode in " << path << ": "
+                   << error.message() << "\n";
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,42 @@
+#include "mull/CacheFile.h"
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/raw_ostream.h>
+
+using namespace mull;
+
+std::error_code
+mull::writeCacheFile(const std::string &path,
+                     llvm::function_ref<void(llvm::raw_ostream &)> contents) {
+  auto error =
+      llvm::sys::fs::create_directories(llvm::sys::path::parent_path(path));
+  if (error) {
+    return error;
+  }
+
+  int descriptor = -1;
+  llvm::SmallString<128> temporaryName;
+  error = llvm::sys::fs::createUniqueFile(path + ".tmp-%%%%%%%%", descriptor,
+                                          temporaryName);
+  if (error) {
+    return error;
+  }
+
+  bool failed = false;
+  {
+    llvm::raw_fd_ostream outfile(descriptor, true);
+    contents(outfile);
+    outfile.close();
+    failed = outfile.has_error();
+    outfile.clear_error();
+  }
+
+  error = failed ? std::make_error_code(std::errc::io_error)
+                 : llvm::sys::fs::rename(temporaryName, path);
+  if (error) {
+    llvm::sys::fs::remove(temporaryName);
+  }
+  return error;
+}
@@ -0,0 +1,210 @@
+#include "mull/ChangedLines.h"
+
+#include "mull/SourceLocation.h"
+
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/Support/MemoryBuffer.h>
+
+using namespace mull;
+using namespace llvm;
+
+static const char DevNull[] = "/dev/null";
+
+bool ChangedLines::FileChanges::contains(int line) const {
+  return wholeFile || lines.count(line) != 0;
+}
+
+static bool isDiff(StringRef text) {
+  SmallVector<StringRef, 64> lines;
+  text.split(lines, '\n');
+  for (auto line : lines) {
+    if (line.startswith("@@ ") || line.startswith("+++ ") ||
+        line.startswith("diff --git ")) {
+      return true;
+    }
+  }
+  return false;
+}
+
+ChangedLines ChangedLines::parse(StringRef text) {
+  ChangedLines changes;
+  if (isDiff(text)) {
+    changes.parseDiff(text);
+  } else {
+    changes.parseList(text);
+  }
+  return changes;
+}
+
+bool ChangedLines::load(const std::string &path, ChangedLines &changes) {
+  auto buffer = MemoryBuffer::getFile(path);
+  if (!buffer) {
+    return false;
+  }
+  changes = parse(buffer.get()->getBuffer());
+  return true;
+}
+
+/// "-start,count" or "+start,count", the count is 1 when it is left out
+static bool parseRange(StringRef range, int &start, int &count) {
+  range = range.drop_front();
+  auto parts = range.split(',');
+  count = 1;
+  return !parts.first.getAsInteger(10, start) &&
+         (parts.second.empty() || !parts.second.getAsInteger(10, count));
+}
+
+/// Walks the hunks of every file, the lines are numbered as in the new
+/// version of the file. A removed line marks the lines around it, there is
+/// nothing left of it to mark in the new version.
+void ChangedLines::parseDiff(StringRef text) {
+  SmallVector<StringRef, 64> lines;
+  text.split(lines, '\n');
+
+  std::string file;
+  int line = 0;
+  int oldRemaining = 0;
+  int newRemaining = 0;
+  for (auto diffLine : lines) {
+    diffLine = diffLine.rtrim('\r');
+    if (oldRemaining > 0 || newRemaining > 0) {
+      char kind = diffLine.empty() ? ' ' : diffLine.front();
+      if (kind == '\\') {
+        continue;
+      }
+      if (kind == '+') {
+        if (!file.empty()) {
+          addLine(file, line);
+        }
+        line++;
+        newRemaining--;
+      } else if (kind == '-') {
+        if (!file.empty()) {
+          addLine(file, line - 1);
+          addLine(file, line);
+        }
+        oldRemaining--;
+      } else {
+        line++;
+        oldRemaining--;
+        newRemaining--;
+      }
+      continue;
+    }
+
+    if (diffLine.startswith("+++ ")) {
+      StringRef path = diffLine.drop_front(4).split('\t').first.rtrim();
+      if (path == DevNull) {
+        file.clear();
+      } else {
+        file = (path.startswith("b/") ? path.drop_front(2) : path).str();
+      }
+      continue;
+    }
+
+    if (diffLine.startswith("@@ ")) {
+      SmallVector<StringRef, 4> fields;
+      diffLine.split(fields, ' ');
+      int oldStart = 0;
+      int newStart = 0;
+      if (fields.size() < 3 ||
+          !parseRange(fields[1], oldStart, oldRemaining) ||
+          !parseRange(fields[2], newStart, newRemaining)) {
+        oldRemaining = 0;
+        newRemaining = 0;
+        continue;
+      }
+      /// An empty range starts after the line it names
+      line = newRemaining == 0 ? newStart + 1 : newStart;
+    }
+  }
+}
+
+void ChangedLines::parseList(StringRef text) {
+  SmallVector<StringRef, 64> lines;
+  text.split(lines, '\n');
+
+  for (auto entry : lines) {
+    entry = entry.trim();
+    if (entry.empty() || entry.startswith("#")) {
+      continue;
+    }
+
+    auto parts = entry.rsplit(':');
+    auto range = parts.second.split('-');
+    int first = 0;
+    int last = 0;
+    if (parts.second.empty() || range.first.getAsInteger(10, first)) {
+      addFile(entry.str());
+      continue;
+    }
+    if (range.second.empty()) {
+      last = first;
+    } else if (range.second.getAsInteger(10, last)) {
+      addFile(entry.str());
+      continue;
+    }
+    for (int line = first; line <= last; line++) {
+      addLine(parts.first.str(), line);
+    }
+  }
+}
+
+static std::string normalizedPath(const std::string &file) {
+  StringRef path(file);
+  while (path.startswith("./")) {
+    path = path.drop_front(2);
+  }
+  return path.str();
+}
+
+void ChangedLines::addLine(const std::string &file, int line) {
+  if (line > 0) {
+    files[normalizedPath(file)].lines.insert(line);
+  }
+}
+
+void ChangedLines::addFile(const std::string &file) {
+  files[normalizedPath(file)].wholeFile = true;
+}
+
+bool ChangedLines::empty() const { return files.empty(); }
+
+std::string ChangedLines::toString() const {
+  std::string list;
+  for (auto &file : files) {
+    if (file.second.wholeFile) {
+      list += file.first + "\n";
+      continue;
+    }
+    for (int line : file.second.lines) {
+      list += file.first + ":" + std::to_string(line) + "\n";
+    }
+  }
+  return list;
+}
+
+const ChangedLines::FileChanges *
+ChangedLines::changesOf(StringRef path) const {
+  for (auto &file : files) {
+    StringRef changed(file.first);
+    if (path == changed ||
+        (path.endswith(changed) &&
+         path[path.size() - changed.size() - 1] == '/')) {
+      return &file.second;
+    }
+  }
+  return nullptr;
+}
+
+bool ChangedLines::touches(const SourceLocation &location) const {
+  return !location.isNull() && changesOf(location.filePath()) != nullptr;
+}
+
+bool ChangedLines::contains(const SourceLocation &location) const {
+  if (location.isNull()) {
+    return false;
+  }
+  auto changes = changesOf(location.filePath());
+  return changes != nullptr && changes->contains(location.line);
+}
@@ -0,0 +1,40 @@
+#include "mull/Checkpoint.h"
+
+#include "mull/MutationPoint.h"
+#include "mull/ResultsDatabase.h"
+
+#include <sqlite3.h>
+
+using namespace mull;
+
+bool Checkpoint::load(const std::string &databasePath, std::string &error) {
+  auto database = openResultsDatabase(databasePath, error);
+  if (!database) {
+    return false;
+  }
+
+  sqlite3_stmt *selectResults = nullptr;
+  if (sqlite3_prepare_v2(database, SelectExecutionResults, -1, &selectResults,
+                         nullptr) != SQLITE_OK) {
+    error = sqlite3_errmsg(database);
+    sqlite3_close(database);
+    return false;
+  }
+
+  while (sqlite3_step(selectResults) == SQLITE_ROW) {
+    mutants[columnText(selectResults, 1)][columnText(selectResults, 0)] =
+        executionResultOf(selectResults);
+  }
+
+  sqlite3_finalize(selectResults);
+  sqlite3_close(database);
+  return true;
+}
+
+const Checkpoint::StoredResults *
+Checkpoint::find(MutationPoint &point) const {
+  auto mutant = mutants.find(point.getUniqueIdentifier());
+  return mutant == mutants.end() ? nullptr : &mutant->second;
+}
+
+size_t Checkpoint::size() const { return mutants.size(); }
@@ -0,0 +1,155 @@
+#include "mull/ChildResources.h"
+
+#include "mull/Logger.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace mull;
+
+static const rlim_t Megabyte = 1024 * 1024;
+
+ChildResources::Limits::Limits()
+    : addressSpace(RLIM_INFINITY), cpuTime(RLIM_INFINITY),
+      openFiles(RLIM_INFINITY), cgroupProcs(nullptr) {}
+
+ChildResources::ChildResources(const ChildResourcesConfig &config)
+    : config(config), cgroupsWorking(!config.cgroupRoot.empty()) {
+  if (config.memoryBudget > 0) {
+    budget = std::unique_ptr<MemoryBudget>(
+        new MemoryBudget(uint64_t(config.memoryBudget) * Megabyte));
+  }
+}
+
+ChildResources::~ChildResources() {
+  for (auto &cgroup : cgroups) {
+    rmdir(cgroup.c_str());
+  }
+}
+
+/// The virtual size of mull, a child starts with all of it mapped
+static rlim_t inheritedAddressSpace() {
+  std::ifstream statm("/proc/self/statm");
+  unsigned long long pages = 0;
+  if (!(statm >> pages)) {
+    return 0;
+  }
+  return rlim_t(pages) * rlim_t(sysconf(_SC_PAGESIZE));
+}
+
+ChildResources::Limits ChildResources::prepare() {
+  Limits limits;
+  if (config.addressSpace > 0) {
+    limits.addressSpace =
+        inheritedAddressSpace() + rlim_t(config.addressSpace) * Megabyte;
+  }
+  if (config.cpuTime > 0) {
+    limits.cpuTime = rlim_t(config.cpuTime);
+  }
+  if (config.openFiles > 0) {
+    limits.openFiles = rlim_t(config.openFiles);
+  }
+  limits.cgroupProcs = cgroupOfThisWorker();
+  return limits;
+}
+
+static void setLimit(int resource, rlim_t value) {
+  if (value == RLIM_INFINITY) {
+    return;
+  }
+  struct rlimit limit {};
+  if (getrlimit(resource, &limit) == 0 && limit.rlim_max != RLIM_INFINITY &&
+      limit.rlim_max < value) {
+    value = limit.rlim_max;
+  }
+  limit.rlim_cur = value;
+  limit.rlim_max = value;
+  setrlimit(resource, &limit);
+}
+
+void ChildResources::apply(const Limits &limits) {
+  setLimit(RLIMIT_AS, limits.addressSpace);
+  setLimit(RLIMIT_CPU, limits.cpuTime);
+  setLimit(RLIMIT_NOFILE, limits.openFiles);
+  if (limits.cgroupProcs) {
+    /// "0" moves the process that writes it
+    int fd = open(limits.cgroupProcs, O_WRONLY);
+    if (fd != -1) {
+      ssize_t written = write(fd, "0", 1);
+      (void)written;
+      close(fd);
+    }
+  }
+}
+
+static bool writeFile(const std::string &path, const std::string &contents) {
+  std::ofstream file(path);
+  file << contents;
+  file.flush();
+  return bool(file);
+}
+
+bool ChildResources::createCgroup(const std::string &path) {
+  if (mkdir(path.c_str(), 0755) == -1 && errno != EEXIST) {
+    return false;
+  }
+  cgroups.push_back(path);
+  if (config.cgroupMemory > 0 &&
+      !writeFile(path + "/memory.max",
+                 std::to_string(rlim_t(config.cgroupMemory) * Megabyte))) {
+    return false;
+  }
+  /// The quota is per period of 100ms
+  if (config.cgroupCPU > 0 &&
+      !writeFile(path + "/cpu.max",
+                 std::to_string(config.cgroupCPU * 1000) + " 100000")) {
+    return false;
+  }
+  return true;
+}
+
+const char *ChildResources::cgroupOfThisWorker() {
+  if (config.cgroupRoot.empty()) {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> lock(mutex);
+  if (!cgroupsWorking) {
+    return nullptr;
+  }
+  auto worker = workers.find(std::this_thread::get_id());
+  if (worker != workers.end()) {
+    return cgroupProcs[worker->second].c_str();
+  }
+
+  if (workers.empty()) {
+    std::string controllers;
+    if (config.cgroupMemory > 0) {
+      controllers += "+memory ";
+    }
+    if (config.cgroupCPU > 0) {
+      controllers += "+cpu";
+    }
+    if (!controllers.empty()) {
+      writeFile(config.cgroupRoot + "/cgroup.subtree_control", controllers);
+    }
+  }
+
+  const size_t index = cgroupProcs.size();
+  const std::string path = config.cgroupRoot + "/mull-" +
+                           std::to_string(getpid()) + "-worker-" +
+                           std::to_string(index);
+  if (!createCgroup(path)) {
+    Logger::warn() << "Cannot set up the cgroup " << path << ": "
+                   << strerror(errno)
+                   << ", the children run without cgroup limits\n";
+    cgroupsWorking = false;
+    return nullptr;
+  }
+  cgroupProcs.push_back(path + "/cgroup.procs");
+  workers[std::this_thread::get_id()] = index;
+  return cgroupProcs.back().c_str();
+}
@@ -15,24 +15,114 @@ ParallelizationConfig singleThreadParallelization() {
 }
 
 Configuration::Configuration()
-    : forkEnabled(true), junkDetectionEnabled(false), dryRunEnabled(false),
-      failFastEnabled(false), cacheEnabled(false),
-      timeout(MullDefaultTimeoutMilliseconds), maxDistance(128),
-      diagnostics(Diagnostics::None),
+    : forkEnabled(true), forkServerEnabled(false), forkBatchEnabled(false),
+      forkSnapshotEnabled(false),
+      junkDetectionEnabled(false),
+      dryRunEnabled(false), failFastEnabled(false), cacheEnabled(false),
+      mutantSchemataEnabled(false), splitMutatedFunctionsEnabled(false),
+      equivalentMutantPruningEnabled(false),
+      sharedProgramEnabled(false), lazyJITEnabled(false),
+      parallelJITEnabled(false),
+      deferMutantCloningEnabled(false), lazyBitcodeLoadingEnabled(false),
+      inlineInstrumentationEnabled(false),
+      coverageInstrumentationEnabled(false),
+      guardedInstrumentationEnabled(false), constructorTemplateEnabled(false),
+      directTestRunEnabled(false), releaseIREnabled(false),
+      jitHugePagesEnabled(false), blockCoverageEnabled(false),
+      boundedCallTreeEnabled(false), perfCountersEnabled(false),
+      directCallsEnabled(false), stopOnSurvivorEnabled(false),
+      staticReachabilityEnabled(false),
+      timeout(MullDefaultTimeoutMilliseconds), deadline(0),
+      reachabilitySamplePeriod(0), timeoutPolicy(),
+      sampling(),
+      shard(), testOrder(TestOrder::Discovery),
+      mutantOrder(MutantOrder::LongestFirst), batchKillSize(0),
+      originalTestBatchSize(0), loopBudget(0), stallTimeout(0), flakyRuns(0),
+      distributed(),
+      childResources(), heap(), resultMemoryBudget(0),
+      maxDistance(128),
+      outputLimit(MullDefaultOutputLimitBytes), dropPassedOutput(false),
+      outputRetention(OutputRetention::Full),
+      outputTailBytes(MullDefaultOutputTailBytes),
+      diagnostics(Diagnostics::None), cacheCompressionEnabled(false),
+      cacheSizeLimit(0), cachePopulateEnabled(false),
+      reachabilityCacheEnabled(false), programLibraryEnabled(false),
+      mutationSearchCacheEnabled(false), testSearchCacheEnabled(false),
+      hashAlgorithm(HashAlgorithm::MD5),
+      codegenOptLevel(2), mutantDebugInfo(MutantDebugInfo::Full),
+      parallelCodegenThreshold(0),
       parallelization(singleThreadParallelization()) {}
 
 Configuration::Configuration(RawConfig &raw)
     : forkEnabled(raw.forkEnabled()),
+      forkServerEnabled(raw.forkServerEnabled()),
+      forkBatchEnabled(raw.forkBatchEnabled()),
+      forkSnapshotEnabled(raw.forkSnapshotEnabled()),
       junkDetectionEnabled(raw.junkDetectionEnabled()),
       dryRunEnabled(raw.dryRunModeEnabled()),
       failFastEnabled(raw.failFastModeEnabled()),
-      cacheEnabled(raw.cachingEnabled()), timeout(raw.getTimeout()),
-      maxDistance(raw.getMaxDistance()), diagnostics(raw.getDiagnostics()),
+      cacheEnabled(raw.cachingEnabled()),
+      mutantSchemataEnabled(raw.mutantSchemataEnabled()),
+      splitMutatedFunctionsEnabled(raw.splitMutatedFunctionsEnabled()),
+      equivalentMutantPruningEnabled(raw.equivalentMutantPruningEnabled()),
+      sharedProgramEnabled(raw.sharedProgramEnabled()),
+      lazyJITEnabled(raw.lazyJITEnabled()),
+      parallelJITEnabled(raw.parallelJITEnabled()),
+      deferMutantCloningEnabled(raw.deferMutantCloningEnabled()),
+      lazyBitcodeLoadingEnabled(raw.lazyBitcodeLoadingEnabled()),
+      inlineInstrumentationEnabled(raw.inlineInstrumentationEnabled()),
+      coverageInstrumentationEnabled(raw.coverageInstrumentationEnabled()),
+      guardedInstrumentationEnabled(raw.guardedInstrumentationEnabled()),
+      constructorTemplateEnabled(raw.constructorTemplateEnabled()),
+      freshGlobalsTests(raw.getFreshGlobalsTests()),
+      directTestRunEnabled(raw.directTestRunEnabled()),
+      releaseIREnabled(raw.releaseIREnabled()),
+      jitHugePagesEnabled(raw.jitHugePagesEnabled()),
+      blockCoverageEnabled(raw.blockCoverageEnabled()),
+      boundedCallTreeEnabled(raw.boundedCallTreeEnabled()),
+      perfCountersEnabled(raw.perfCountersEnabled()),
+      directCallsEnabled(raw.directCallsEnabled()),
+      stopOnSurvivorEnabled(raw.stopOnSurvivorEnabled()),
+      staticReachabilityEnabled(raw.staticReachabilityEnabled()),
+      timeout(raw.getTimeout()), deadline(raw.getDeadline()),
+      reachabilitySamplePeriod(raw.getReachabilitySamplePeriod()),
+      timeoutPolicy(raw.getTimeoutPolicy()),
+      sampling(raw.getSampling()), shard(raw.getShard()),
+      testOrder(raw.getTestOrder()), mutantOrder(raw.getMutantOrder()),
+      batchKillSize(raw.getBatchKillSize()),
+      originalTestBatchSize(raw.getOriginalTestBatchSize()),
+      loopBudget(raw.getLoopBudget()), stallTimeout(raw.getStallTimeout()),
+      flakyRuns(raw.getFlakyRuns()),
+      distributed(raw.getDistributed()),
+      childResources(raw.getChildResources()), heap(raw.getHeap()),
+      resultMemoryBudget(raw.getResultMemoryBudget()),
+      maxDistance(raw.getMaxDistance()), outputLimit(raw.getOutputLimit()),
+      dropPassedOutput(raw.shouldDropPassedOutput()),
+      outputRetention(raw.getOutputRetention()),
+      outputTailBytes(raw.getOutputTail()),
+      diagnostics(raw.getDiagnostics()),
       bitcodePaths(raw.getBitcodePaths()),
       parallelization(raw.parallelization()),
       objectFilePaths(raw.getObjectFilesPaths()),
       dynamicLibraryPaths(raw.getDynamicLibrariesPaths()),
       cacheDirectory(raw.getCacheDirectory()),
+      cacheCompressionEnabled(raw.cacheCompressionEnabled()),
+      cacheSizeLimit(raw.getCacheSizeLimit()),
+      cachePopulateEnabled(raw.cachePopulateEnabled()),
+      reachabilityCacheEnabled(raw.reachabilityCacheEnabled()),
+      programLibraryEnabled(raw.programLibraryEnabled()),
+      mutationSearchCacheEnabled(raw.mutationSearchCacheEnabled()),
+      testSearchCacheEnabled(raw.testSearchCacheEnabled()),
+      cacheRemoteURL(raw.getCacheRemoteURL()),
+      changedLinesPath(raw.getChangedLines()),
+      previousResultsPath(raw.getPreviousResults()),
+      resumePath(raw.getResume()), killMatrixPath(raw.getKillMatrix()),
+      minimizedTestsPath(raw.getMinimizedTests()),
+      metricsEndpoint(raw.getMetricsEndpoint()),
+      hashAlgorithm(raw.getHashAlgorithm()),
+      codegenOptLevel(raw.getCodegenOptLevel()),
+      mutantDebugInfo(raw.getMutantDebugInfo()),
+      parallelCodegenThreshold(raw.getParallelCodegenThreshold()),
       customTests(raw.getCustomTests()) {}
 
 } // namespace mull
@@ -28,8 +28,55 @@ std::string diagnosticsToString(Diagnostics diagnostics) {
   }
 }
 
+std::string outputRetentionToString(OutputRetention retention) {
+  switch (retention) {
+  case OutputRetention::Full: {
+    return "full";
+  }
+  case OutputRetention::None: {
+    return "none";
+  }
+  case OutputRetention::Tail: {
+    return "tail";
+  }
+  case OutputRetention::Killed: {
+    return "killed";
+  }
+  case OutputRetention::Compressed: {
+    return "compressed";
+  }
+  }
+}
+
+std::string hashAlgorithmToString(HashAlgorithm algorithm) {
+  switch (algorithm) {
+  case HashAlgorithm::MD5: {
+    return "md5";
+  }
+  case HashAlgorithm::XXHash64: {
+    return "xxhash64";
+  }
+  }
+}
+
+std::string mutantDebugInfoToString(MutantDebugInfo debugInfo) {
+  switch (debugInfo) {
+  case MutantDebugInfo::Full: {
+    return "full";
+  }
+  case MutantDebugInfo::LineTables: {
+    return "line_tables";
+  }
+  case MutantDebugInfo::None: {
+    return "none";
+  }
+  }
+}
+
 ParallelizationConfig::ParallelizationConfig()
-    : workers(0), testExecutionWorkers(0), mutantExecutionWorkers(0) {}
+    : workers(0), testExecutionWorkers(0), mutantExecutionWorkers(0),
+      childrenPerWorker(1), pinWorkers(false), autoTune(false),
+      workerProcesses(1), junkDetectionProcesses(0) {}
 
 void ParallelizationConfig::normalize() {
   int defaultWorkers = std::max(std::thread::hardware_concurrency(), uint(1));
@@ -43,6 +90,10 @@ void ParallelizationConfig::normalize() {
   if (mutantExecutionWorkers == 0) {
     mutantExecutionWorkers = workers;
   }
+
+  childrenPerWorker = std::max(childrenPerWorker, 1);
+  workerProcesses = std::max(workerProcesses, 1);
+  junkDetectionProcesses = std::max(junkDetectionProcesses, 0);
 }
 
 ParallelizationConfig ParallelizationConfig::defaultConfig() {
@@ -51,6 +102,128 @@ ParallelizationConfig ParallelizationConfig::defaultConfig() {
   return config;
 }
 
+TimeoutPolicyConfig::TimeoutPolicyConfig()
+    : runs(1), deviations(3), multiplier(10), floor(30), ceiling(0) {}
+
+static const std::pair<SamplingStrategy, const char *> SamplingStrategies[] = {
+    {SamplingStrategy::None, "none"},
+    {SamplingStrategy::Uniform, "uniform"},
+    {SamplingStrategy::PerMutator, "per_mutator"},
+    {SamplingStrategy::PerFile, "per_file"},
+    {SamplingStrategy::PerFunction, "per_function"},
+    {SamplingStrategy::TimeBudget, "time_budget"},
+};
+
+std::string samplingStrategyToString(SamplingStrategy strategy) {
+  for (auto &pair : SamplingStrategies) {
+    if (pair.first == strategy) {
+      return pair.second;
+    }
+  }
+  return "none";
+}
+
+bool samplingStrategyFromString(const std::string &name,
+                                SamplingStrategy &strategy) {
+  for (auto &pair : SamplingStrategies) {
+    if (name == pair.second) {
+      strategy = pair.first;
+      return true;
+    }
+  }
+  return false;
+}
+
+SamplingConfig::SamplingConfig()
+    : strategy(SamplingStrategy::None), size(0), seed(0), budget(0) {}
+
+ShardConfig::ShardConfig() : index(0), count(1) {}
+
+ChildResourcesConfig::ChildResourcesConfig()
+    : addressSpace(0), cpuTime(0), openFiles(0), cgroupRoot(),
+      cgroupMemory(0), cgroupCPU(0), memoryBudget(0) {}
+
+HeapConfig::HeapConfig() : arenas(0), trim(false) {}
+
+static const std::pair<DistributedRole, const char *> DistributedRoles[] = {
+    {DistributedRole::None, "none"},
+    {DistributedRole::Coordinator, "coordinator"},
+    {DistributedRole::Worker, "worker"},
+};
+
+std::string distributedRoleToString(DistributedRole role) {
+  for (auto &pair : DistributedRoles) {
+    if (pair.first == role) {
+      return pair.second;
+    }
+  }
+  return "none";
+}
+
+bool distributedRoleFromString(const std::string &name,
+                               DistributedRole &role) {
+  for (auto &pair : DistributedRoles) {
+    if (name == pair.second) {
+      role = pair.first;
+      return true;
+    }
+  }
+  return false;
+}
+
+DistributedConfig::DistributedConfig()
+    : role(DistributedRole::None), directory(), chunk(16), lease(300) {}
+
+static const std::pair<TestOrder, const char *> TestOrders[] = {
+    {TestOrder::Discovery, "discovery"},
+    {TestOrder::Distance, "distance"},
+    {TestOrder::Runtime, "runtime"},
+    {TestOrder::KillRate, "kill_rate"},
+};
+
+std::string testOrderToString(TestOrder order) {
+  for (auto &pair : TestOrders) {
+    if (pair.first == order) {
+      return pair.second;
+    }
+  }
+  return "discovery";
+}
+
+bool testOrderFromString(const std::string &name, TestOrder &order) {
+  for (auto &pair : TestOrders) {
+    if (name == pair.second) {
+      order = pair.first;
+      return true;
+    }
+  }
+  return false;
+}
+
+static const std::pair<MutantOrder, const char *> MutantOrders[] = {
+    {MutantOrder::LongestFirst, "longest_first"},
+    {MutantOrder::Feedback, "feedback"},
+};
+
+std::string mutantOrderToString(MutantOrder order) {
+  for (auto &pair : MutantOrders) {
+    if (pair.first == order) {
+      return pair.second;
+    }
+  }
+  return "longest_first";
+}
+
+bool mutantOrderFromString(const std::string &name, MutantOrder &order) {
+  for (auto &pair : MutantOrders) {
+    if (name == pair.second) {
+      order = pair.first;
+      return true;
+    }
+  }
+  return false;
+}
+
 CustomTestDefinition::CustomTestDefinition() = default;
 
 CustomTestDefinition::CustomTestDefinition(std::string name, std::string method,
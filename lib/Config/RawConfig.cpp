@@ -1,5 +1,6 @@
 #include "mull/Config/RawConfig.h"
 #include "mull/Config/Configuration.h"
+#include "mull/Filter.h"
 #include "mull/Logger.h"
 
 #include <fstream>
@@ -11,12 +12,16 @@
 #include <vector>
 
 int MullDefaultTimeoutMilliseconds = 3000;
+int MullDefaultOutputLimitBytes = 1024 * 1024;
+int MullDefaultOutputTailBytes = 4096;
 
 using namespace mull;
 
 JunkDetectionConfig::JunkDetectionConfig()
     : toggle(JunkDetectionToggle::Disabled), detectorName(""),
-      cxxCompilationDatabasePath(""), cxxCompilationFlags("") {}
+      cxxCompilationDatabasePath(""), cxxCompilationFlags(""),
+      cxxSharedPrecompiledHeaders(false), cxxMemoryLimit(0),
+      cacheDirectory("") {}
 
 JunkDetectionConfig JunkDetectionConfig::enabled() {
   JunkDetectionConfig config;
@@ -43,6 +48,18 @@ std::string RawConfig::forkToString(Fork fork) {
   case Fork::Disabled:
     return "disabled";
     break;
+
+  case Fork::Server:
+    return "server";
+    break;
+
+  case Fork::Batch:
+    return "batch";
+    break;
+
+  case Fork::Snapshot:
+    return "snapshot";
+    break;
   }
 }
 
@@ -93,6 +110,356 @@ std::string RawConfig::emitDebugInfoToString(EmitDebugInfo emitDebugInfo) {
   }
 }
 
+std::string RawConfig::mutantSchemataToString(MutantSchemata schemata) {
+  switch (schemata) {
+  case MutantSchemata::Enabled:
+    return "enabled";
+    break;
+
+  case MutantSchemata::Disabled:
+    return "disabled";
+    break;
+  }
+}
+
+std::string RawConfig::splitMutatedFunctionsToString(
+    SplitMutatedFunctions splitFunctions) {
+  switch (splitFunctions) {
+  case SplitMutatedFunctions::Enabled:
+    return "enabled";
+    break;
+
+  case SplitMutatedFunctions::Disabled:
+    return "disabled";
+    break;
+  }
+}
+
+std::string RawConfig::equivalentMutantPruningToString(
+    EquivalentMutantPruning equivalentMutantPruning) {
+  switch (equivalentMutantPruning) {
+  case EquivalentMutantPruning::Enabled:
+    return "enabled";
+    break;
+
+  case EquivalentMutantPruning::Disabled:
+    return "disabled";
+    break;
+  }
+}
+
+std::string RawConfig::sharedProgramToString(SharedProgram sharedProgram) {
+  switch (sharedProgram) {
+  case SharedProgram::Enabled:
+    return "enabled";
+    break;
+
+  case SharedProgram::Disabled:
+    return "disabled";
+    break;
+  }
+}
+
+std::string RawConfig::lazyJITToString(LazyJIT lazyJIT) {
+  switch (lazyJIT) {
+  case LazyJIT::Enabled:
+    return "enabled";
+    break;
+
+  case LazyJIT::Disabled:
+    return "disabled";
+    break;
+  }
+}
+
+std::string RawConfig::parallelJITToString(ParallelJIT parallelJIT) {
+  switch (parallelJIT) {
+  case ParallelJIT::Enabled:
+    return "enabled";
+    break;
+
+  case ParallelJIT::Disabled:
+    return "disabled";
+    break;
+  }
+}
+
+std::string
+RawConfig::deferMutantCloningToString(DeferMutantCloning deferMutantCloning) {
+  switch (deferMutantCloning) {
+  case DeferMutantCloning::Enabled:
+    return "enabled";
+    break;
+
+  case DeferMutantCloning::Disabled:
+    return "disabled";
+    break;
+  }
+}
+
+std::string
+RawConfig::lazyBitcodeLoadingToString(LazyBitcodeLoading lazyBitcodeLoading) {
+  switch (lazyBitcodeLoading) {
+  case LazyBitcodeLoading::Enabled:
+    return "enabled";
+    break;
+
+  case LazyBitcodeLoading::Disabled:
+    return "disabled";
+    break;
+  }
+}
+
+std::string RawConfig::inlineInstrumentationToString(
+    InlineInstrumentation inlineInstrumentation) {
+  switch (inlineInstrumentation) {
+  case InlineInstrumentation::Enabled:
+    return "enabled";
+    break;
+
+  case InlineInstrumentation::Disabled:
+    return "disabled";
+    break;
+  }
+}
+
+std::string RawConfig::coverageInstrumentationToString(
+    CoverageInstrumentation coverageInstrumentation) {
+  switch (coverageInstrumentation) {
+  case CoverageInstrumentation::Enabled:
+    return "enabled";
+    break;
+
+  case CoverageInstrumentation::Disabled:
+    return "disabled";
+    break;
+  }
+}
+
+std::string RawConfig::guardedInstrumentationToString(
+    GuardedInstrumentation guardedInstrumentation) {
+  switch (guardedInstrumentation) {
+  case GuardedInstrumentation::Enabled:
+    return "enabled";
+    break;
+
+  case GuardedInstrumentation::Disabled:
+    return "disabled";
+    break;
+  }
+}
+
+std::string RawConfig::constructorTemplateToString(
+    ConstructorTemplate constructorTemplate) {
+  switch (constructorTemplate) {
+  case ConstructorTemplate::Enabled:
+    return "enabled";
+    break;
+
+  case ConstructorTemplate::Disabled:
+    return "disabled";
+    break;
+  }
+}
+
+std::string RawConfig::directTestRunToString(DirectTestRun directTestRun) {
+  switch (directTestRun) {
+  case DirectTestRun::Enabled:
+    return "enabled";
+    break;
+
+  case DirectTestRun::Disabled:
+    return "disabled";
+    break;
+  }
+}
+
+std::string RawConfig::releaseIRToString(ReleaseIR releaseIR) {
+  switch (releaseIR) {
+  case ReleaseIR::Enabled:
+    return "enabled";
+    break;
+
+  case ReleaseIR::Disabled:
+    return "disabled";
+    break;
+  }
+}
+
+std::string RawConfig::jitHugePagesToString(JITHugePages jitHugePages) {
+  switch (jitHugePages) {
+  case JITHugePages::Enabled:
+    return "enabled";
+    break;
+
+  case JITHugePages::Disabled:
+    return "disabled";
+    break;
+  }
+}
+
+std::string RawConfig::blockCoverageToString(BlockCoverage blockCoverage) {
+  switch (blockCoverage) {
+  case BlockCoverage::Enabled:
+    return "enabled";
+    break;
+
+  case BlockCoverage::Disabled:
+    return "disabled";
+    break;
+  }
+}
+
+std::string
+RawConfig::boundedCallTreeToString(BoundedCallTree boundedCallTree) {
+  switch (boundedCallTree) {
+  case BoundedCallTree::Enabled:
+    return "enabled";
+    break;
+
+  case BoundedCallTree::Disabled:
+    return "disabled";
+    break;
+  }
+}
+
+std::string RawConfig::perfCountersToString(PerfCounters perfCounters) {
+  switch (perfCounters) {
+  case PerfCounters::Enabled:
+    return "enabled";
+    break;
+
+  case PerfCounters::Disabled:
+    return "disabled";
+    break;
+  }
+}
+
+std::string RawConfig::directCallsToString(DirectCalls directCalls) {
+  switch (directCalls) {
+  case DirectCalls::Enabled:
+    return "enabled";
+    break;
+
+  case DirectCalls::Disabled:
+    return "disabled";
+    break;
+  }
+}
+
+std::string RawConfig::stopOnSurvivorToString(StopOnSurvivor stopOnSurvivor) {
+  switch (stopOnSurvivor) {
+  case StopOnSurvivor::Enabled:
+    return "enabled";
+    break;
+
+  case StopOnSurvivor::Disabled:
+    return "disabled";
+    break;
+  }
+}
+
+std::string RawConfig::staticReachabilityToString(
+    StaticReachability staticReachability) {
+  switch (staticReachability) {
+  case StaticReachability::Enabled:
+    return "enabled";
+    break;
+
+  case StaticReachability::Disabled:
+    return "disabled";
+    break;
+  }
+}
+
+std::string
+RawConfig::cacheCompressionToString(CacheCompression cacheCompression) {
+  switch (cacheCompression) {
+  case CacheCompression::Enabled:
+    return "enabled";
+    break;
+
+  case CacheCompression::Disabled:
+    return "disabled";
+    break;
+  }
+}
+
+std::string RawConfig::cachePopulateToString(CachePopulate cachePopulate) {
+  switch (cachePopulate) {
+  case CachePopulate::Enabled:
+    return "enabled";
+    break;
+
+  case CachePopulate::Disabled:
+    return "disabled";
+    break;
+  }
+}
+
+std::string RawConfig::mutationSearchCacheToString(
+    MutationSearchCache mutationSearchCache) {
+  switch (mutationSearchCache) {
+  case MutationSearchCache::Enabled:
+    return "enabled";
+    break;
+
+  case MutationSearchCache::Disabled:
+    return "disabled";
+    break;
+  }
+}
+
+std::string
+RawConfig::testSearchCacheToString(TestSearchCache testSearchCache) {
+  switch (testSearchCache) {
+  case TestSearchCache::Enabled:
+    return "enabled";
+    break;
+
+  case TestSearchCache::Disabled:
+    return "disabled";
+    break;
+  }
+}
+
+std::string
+RawConfig::reachabilityCacheToString(ReachabilityCache reachabilityCache) {
+  switch (reachabilityCache) {
+  case ReachabilityCache::Enabled:
+    return "enabled";
+    break;
+
+  case ReachabilityCache::Disabled:
+    return "disabled";
+    break;
+  }
+}
+
+std::string RawConfig::programLibraryToString(ProgramLibrary programLibrary) {
+  switch (programLibrary) {
+  case ProgramLibrary::Enabled:
+    return "enabled";
+    break;
+
+  case ProgramLibrary::Disabled:
+    return "disabled";
+    break;
+  }
+}
+
+std::string RawConfig::dropPassedOutputToString(DropPassedOutput dropOutput) {
+  switch (dropOutput) {
+  case DropPassedOutput::Yes:
+    return "yes";
+    break;
+
+  case DropPassedOutput::No:
+    return "no";
+    break;
+  }
+}
+
 // Constructor initializes defaults.
 // TODO: Refactoring into constants.
 RawConfig::RawConfig()
@@ -108,11 +475,54 @@ RawConfig::RawConfig()
           // }
           ),
       reporters(), dynamicLibraryFileList(), objectFileList(), tests(),
-      excludeLocations(), customTests(), fork(Fork::Enabled),
+      excludeLocations(), freshGlobalsTests(), customTests(),
+      fork(Fork::Enabled),
       dryRun(DryRunMode::Disabled), failFast(FailFastMode::Disabled),
       caching(UseCache::No), emitDebugInfo(EmitDebugInfo::No),
       diagnostics(Diagnostics::None), timeout(MullDefaultTimeoutMilliseconds),
-      maxDistance(128), cacheDirectory("/tmp/mull_cache"), junkDetection(),
+      timeoutPolicy(), sampling(), shard(),
+      testOrder(TestOrder::Discovery),
+      mutantOrder(MutantOrder::LongestFirst),
+      batchKillSize(0), originalTestBatchSize(0), loopBudget(0),
+      stallTimeout(0), flakyRuns(0), distributed(),
+      childResources(), heap(), resultMemoryBudget(0), maxDistance(128),
+      cacheDirectory("/tmp/mull_cache"),
+      cacheCompression(CacheCompression::Disabled), cacheSizeLimit(0),
+      cachePopulate(CachePopulate::Disabled),
+      reachabilityCache(ReachabilityCache::Disabled),
+      programLibrary(ProgramLibrary::Disabled),
+      mutationSearchCache(MutationSearchCache::Disabled),
+      testSearchCache(TestSearchCache::Disabled), cacheRemoteURL(),
+      changedLines(), previousResults(), resume(), killMatrix(),
+      minimizedTests(), metricsEndpoint(), hashAlgorithm(HashAlgorithm::MD5),
+      codegenOptLevel(2),
+      mutantDebugInfo(MutantDebugInfo::Full), parallelCodegenThreshold(0),
+      jsonFlushInterval(1000), sqliteWriters(1), deadline(0),
+      reachabilitySamplePeriod(0),
+      outputLimit(MullDefaultOutputLimitBytes),
+      dropPassedOutput(DropPassedOutput::No),
+      outputRetention(OutputRetention::Full),
+      outputTail(MullDefaultOutputTailBytes),
+      mutantSchemata(MutantSchemata::Disabled),
+      splitMutatedFunctions(SplitMutatedFunctions::Disabled),
+      equivalentMutantPruning(EquivalentMutantPruning::Disabled),
+      sharedProgram(SharedProgram::Disabled), lazyJIT(LazyJIT::Disabled),
+      parallelJIT(ParallelJIT::Disabled),
+      deferMutantCloning(DeferMutantCloning::Disabled),
+      lazyBitcodeLoading(LazyBitcodeLoading::Disabled),
+      inlineInstrumentation(InlineInstrumentation::Disabled),
+      coverageInstrumentation(CoverageInstrumentation::Disabled),
+      guardedInstrumentation(GuardedInstrumentation::Disabled),
+      constructorTemplate(ConstructorTemplate::Disabled),
+      directTestRun(DirectTestRun::Disabled), releaseIR(ReleaseIR::Disabled),
+      jitHugePages(JITHugePages::Disabled),
+      blockCoverage(BlockCoverage::Disabled),
+      boundedCallTree(BoundedCallTree::Disabled),
+      perfCounters(PerfCounters::Disabled),
+      directCalls(DirectCalls::Disabled),
+      stopOnSurvivor(StopOnSurvivor::Disabled),
+      staticReachability(StaticReachability::Disabled),
+      junkDetection(),
       parallelizationConfig() {}
 
 RawConfig::RawConfig(
@@ -131,10 +541,52 @@ RawConfig::RawConfig(
       testFramework(testFramework), mutators(mutators), reporters(reporters),
       dynamicLibraryFileList(dynamicLibraryFileList),
       objectFileList(objectFileList), tests(tests),
-      excludeLocations(excludeLocations), customTests(definitions), fork(fork),
+      excludeLocations(excludeLocations), freshGlobalsTests(),
+      customTests(definitions), fork(fork),
       dryRun(dryRun), failFast(failFast), caching(cache),
       emitDebugInfo(debugInfo), diagnostics(diagnostics), timeout(timeout),
-      maxDistance(distance), cacheDirectory(cacheDir),
+      timeoutPolicy(), sampling(), shard(),
+      testOrder(TestOrder::Discovery),
+      mutantOrder(MutantOrder::LongestFirst),
+      batchKillSize(0), originalTestBatchSize(0), loopBudget(0),
+      stallTimeout(0), flakyRuns(0), distributed(),
+      childResources(), heap(), resultMemoryBudget(0), maxDistance(distance),
+      cacheDirectory(cacheDir),
+      cacheCompression(CacheCompression::Disabled), cacheSizeLimit(0),
+      cachePopulate(CachePopulate::Disabled),
+      reachabilityCache(ReachabilityCache::Disabled),
+      programLibrary(ProgramLibrary::Disabled),
+      mutationSearchCache(MutationSearchCache::Disabled),
+      testSearchCache(TestSearchCache::Disabled), cacheRemoteURL(),
+      changedLines(), previousResults(), resume(), killMatrix(),
+      minimizedTests(), metricsEndpoint(), hashAlgorithm(HashAlgorithm::MD5),
+      codegenOptLevel(2),
+      mutantDebugInfo(MutantDebugInfo::Full), parallelCodegenThreshold(0),
+      jsonFlushInterval(1000), sqliteWriters(1), deadline(0),
+      reachabilitySamplePeriod(0),
+      outputLimit(MullDefaultOutputLimitBytes),
+      dropPassedOutput(DropPassedOutput::No),
+      outputRetention(OutputRetention::Full),
+      outputTail(MullDefaultOutputTailBytes),
+      mutantSchemata(MutantSchemata::Disabled),
+      splitMutatedFunctions(SplitMutatedFunctions::Disabled),
+      equivalentMutantPruning(EquivalentMutantPruning::Disabled),
+      sharedProgram(SharedProgram::Disabled), lazyJIT(LazyJIT::Disabled),
+      parallelJIT(ParallelJIT::Disabled),
+      deferMutantCloning(DeferMutantCloning::Disabled),
+      lazyBitcodeLoading(LazyBitcodeLoading::Disabled),
+      inlineInstrumentation(InlineInstrumentation::Disabled),
+      coverageInstrumentation(CoverageInstrumentation::Disabled),
+      guardedInstrumentation(GuardedInstrumentation::Disabled),
+      constructorTemplate(ConstructorTemplate::Disabled),
+      directTestRun(DirectTestRun::Disabled), releaseIR(ReleaseIR::Disabled),
+      jitHugePages(JITHugePages::Disabled),
+      blockCoverage(BlockCoverage::Disabled),
+      boundedCallTree(BoundedCallTree::Disabled),
+      perfCounters(PerfCounters::Disabled),
+      directCalls(DirectCalls::Disabled),
+      stopOnSurvivor(StopOnSurvivor::Disabled),
+      staticReachability(StaticReachability::Disabled),
       junkDetection(std::move(junkDetection)),
       parallelizationConfig(parallelizationConfig) {}
 
@@ -216,6 +668,10 @@ const std::vector<std::string> &RawConfig::getExcludeLocations() const {
   return excludeLocations;
 }
 
+const std::vector<std::string> &RawConfig::getFreshGlobalsTests() const {
+  return freshGlobalsTests;
+}
+
 const std::vector<CustomTestDefinition> &RawConfig::getCustomTests() const {
   return customTests;
 }
@@ -224,38 +680,246 @@ void RawConfig::addCustomTest(CustomTestDefinition customTest) {
   customTests.push_back(customTest);
 }
 
-bool RawConfig::forkEnabled() const { return fork == Fork::Enabled; }
+bool RawConfig::forkEnabled() const { return fork != Fork::Disabled; }
 
-int RawConfig::getTimeout() const { return timeout; }
+bool RawConfig::forkServerEnabled() const { return fork == Fork::Server; }
 
-bool RawConfig::cachingEnabled() const { return caching == UseCache::Yes; }
+bool RawConfig::forkBatchEnabled() const { return fork == Fork::Batch; }
 
-bool RawConfig::dryRunModeEnabled() const {
-  return dryRun == DryRunMode::Enabled;
+bool RawConfig::forkSnapshotEnabled() const {
+  return fork == Fork::Snapshot;
 }
 
-bool RawConfig::failFastModeEnabled() const {
-  return failFast == FailFastMode::Enabled;
-}
+int RawConfig::getTimeout() const { return timeout; }
 
-bool RawConfig::shouldEmitDebugInfo() const {
-  return emitDebugInfo == EmitDebugInfo::Yes;
+const TimeoutPolicyConfig &RawConfig::getTimeoutPolicy() const {
+  return timeoutPolicy;
 }
 
-bool RawConfig::junkDetectionEnabled() const {
-  return junkDetection.isEnabled();
+const SamplingConfig &RawConfig::getSampling() const { return sampling; }
+
+const ShardConfig &RawConfig::getShard() const { return shard; }
+
+TestOrder RawConfig::getTestOrder() const { return testOrder; }
+
+MutantOrder RawConfig::getMutantOrder() const { return mutantOrder; }
+
+int RawConfig::getBatchKillSize() const { return batchKillSize; }
+
+int RawConfig::getOriginalTestBatchSize() const {
+  return originalTestBatchSize;
 }
 
-JunkDetectionConfig &RawConfig::junkDetectionConfig() { return junkDetection; }
+int RawConfig::getLoopBudget() const { return loopBudget; }
 
-Diagnostics RawConfig::getDiagnostics() const { return diagnostics; }
+int RawConfig::getStallTimeout() const { return stallTimeout; }
 
-int RawConfig::getMaxDistance() const { return maxDistance; }
+int RawConfig::getFlakyRuns() const { return flakyRuns; }
 
-std::string RawConfig::getCacheDirectory() const { return cacheDirectory; }
+const DistributedConfig &RawConfig::getDistributed() const {
+  return distributed;
+}
 
-void RawConfig::dump() const {
-  Logger::debug() << "RawConfig>\n"
+const ChildResourcesConfig &RawConfig::getChildResources() const {
+  return childResources;
+}
+
+const HeapConfig &RawConfig::getHeap() const { return heap; }
+
+int RawConfig::getResultMemoryBudget() const { return resultMemoryBudget; }
+
+int RawConfig::getOutputLimit() const { return outputLimit; }
+
+OutputRetention RawConfig::getOutputRetention() const {
+  return outputRetention;
+}
+
+HashAlgorithm RawConfig::getHashAlgorithm() const { return hashAlgorithm; }
+
+int RawConfig::getCodegenOptLevel() const { return codegenOptLevel; }
+
+MutantDebugInfo RawConfig::getMutantDebugInfo() const {
+  return mutantDebugInfo;
+}
+
+int RawConfig::getParallelCodegenThreshold() const {
+  return parallelCodegenThreshold;
+}
+
+int RawConfig::getJSONFlushInterval() const { return jsonFlushInterval; }
+
+int RawConfig::getSQLiteWriters() const { return sqliteWriters; }
+
+int RawConfig::getDeadline() const { return deadline; }
+
+int RawConfig::getReachabilitySamplePeriod() const {
+  return reachabilitySamplePeriod;
+}
+
+int RawConfig::getOutputTail() const { return outputTail; }
+
+bool RawConfig::mutantSchemataEnabled() const {
+  return mutantSchemata == MutantSchemata::Enabled;
+}
+
+bool RawConfig::splitMutatedFunctionsEnabled() const {
+  return splitMutatedFunctions == SplitMutatedFunctions::Enabled;
+}
+
+bool RawConfig::equivalentMutantPruningEnabled() const {
+  return equivalentMutantPruning == EquivalentMutantPruning::Enabled;
+}
+
+bool RawConfig::sharedProgramEnabled() const {
+  return sharedProgram == SharedProgram::Enabled;
+}
+
+bool RawConfig::lazyJITEnabled() const { return lazyJIT == LazyJIT::Enabled; }
+
+bool RawConfig::parallelJITEnabled() const {
+  return parallelJIT == ParallelJIT::Enabled;
+}
+
+bool RawConfig::deferMutantCloningEnabled() const {
+  return deferMutantCloning == DeferMutantCloning::Enabled;
+}
+
+bool RawConfig::lazyBitcodeLoadingEnabled() const {
+  return lazyBitcodeLoading == LazyBitcodeLoading::Enabled;
+}
+
+bool RawConfig::inlineInstrumentationEnabled() const {
+  return inlineInstrumentation == InlineInstrumentation::Enabled;
+}
+
+bool RawConfig::coverageInstrumentationEnabled() const {
+  return coverageInstrumentation == CoverageInstrumentation::Enabled;
+}
+
+bool RawConfig::guardedInstrumentationEnabled() const {
+  return guardedInstrumentation == GuardedInstrumentation::Enabled;
+}
+
+bool RawConfig::constructorTemplateEnabled() const {
+  return constructorTemplate == ConstructorTemplate::Enabled;
+}
+
+bool RawConfig::directTestRunEnabled() const {
+  return directTestRun == DirectTestRun::Enabled;
+}
+
+bool RawConfig::releaseIREnabled() const {
+  return releaseIR == ReleaseIR::Enabled;
+}
+
+bool RawConfig::jitHugePagesEnabled() const {
+  return jitHugePages == JITHugePages::Enabled;
+}
+
+bool RawConfig::blockCoverageEnabled() const {
+  return blockCoverage == BlockCoverage::Enabled;
+}
+
+bool RawConfig::boundedCallTreeEnabled() const {
+  return boundedCallTree == BoundedCallTree::Enabled;
+}
+
+bool RawConfig::perfCountersEnabled() const {
+  return perfCounters == PerfCounters::Enabled;
+}
+
+bool RawConfig::directCallsEnabled() const {
+  return directCalls == DirectCalls::Enabled;
+}
+
+bool RawConfig::stopOnSurvivorEnabled() const {
+  return stopOnSurvivor == StopOnSurvivor::Enabled;
+}
+
+bool RawConfig::staticReachabilityEnabled() const {
+  return staticReachability == StaticReachability::Enabled;
+}
+
+bool RawConfig::cacheCompressionEnabled() const {
+  return cacheCompression == CacheCompression::Enabled;
+}
+
+int RawConfig::getCacheSizeLimit() const { return cacheSizeLimit; }
+
+bool RawConfig::cachePopulateEnabled() const {
+  return cachePopulate == CachePopulate::Enabled;
+}
+
+bool RawConfig::reachabilityCacheEnabled() const {
+  return reachabilityCache == ReachabilityCache::Enabled;
+}
+
+bool RawConfig::programLibraryEnabled() const {
+  return programLibrary == ProgramLibrary::Enabled;
+}
+
+bool RawConfig::mutationSearchCacheEnabled() const {
+  return mutationSearchCache == MutationSearchCache::Enabled;
+}
+
+bool RawConfig::testSearchCacheEnabled() const {
+  return testSearchCache == TestSearchCache::Enabled;
+}
+
+const std::string &RawConfig::getCacheRemoteURL() const {
+  return cacheRemoteURL;
+}
+
+const std::string &RawConfig::getChangedLines() const { return changedLines; }
+
+const std::string &RawConfig::getPreviousResults() const {
+  return previousResults;
+}
+
+const std::string &RawConfig::getResume() const { return resume; }
+
+const std::string &RawConfig::getKillMatrix() const { return killMatrix; }
+
+const std::string &RawConfig::getMinimizedTests() const {
+  return minimizedTests;
+}
+
+const std::string &RawConfig::getMetricsEndpoint() const {
+  return metricsEndpoint;
+}
+
+bool RawConfig::shouldDropPassedOutput() const {
+  return dropPassedOutput == DropPassedOutput::Yes;
+}
+
+bool RawConfig::cachingEnabled() const { return caching == UseCache::Yes; }
+
+bool RawConfig::dryRunModeEnabled() const {
+  return dryRun == DryRunMode::Enabled;
+}
+
+bool RawConfig::failFastModeEnabled() const {
+  return failFast == FailFastMode::Enabled;
+}
+
+bool RawConfig::shouldEmitDebugInfo() const {
+  return emitDebugInfo == EmitDebugInfo::Yes;
+}
+
+bool RawConfig::junkDetectionEnabled() const {
+  return junkDetection.isEnabled();
+}
+
+JunkDetectionConfig &RawConfig::junkDetectionConfig() { return junkDetection; }
+
+Diagnostics RawConfig::getDiagnostics() const { return diagnostics; }
+
+int RawConfig::getMaxDistance() const { return maxDistance; }
+
+std::string RawConfig::getCacheDirectory() const { return cacheDirectory; }
+
+void RawConfig::dump() const {
+  Logger::debug() << "RawConfig>\n"
                   << "\t"
                   << "bitcode_file_list: " << bitcodeFileList << '\n'
                   << "\t"
@@ -270,6 +934,54 @@ void RawConfig::dump() const {
                   << "\t"
                   << "distance: " << getMaxDistance() << '\n'
                   << "\t"
+                  << "timeout_policy: runs " << timeoutPolicy.runs
+                  << ", deviations " << timeoutPolicy.deviations
+                  << ", multiplier " << timeoutPolicy.multiplier
+                  << ", floor " << timeoutPolicy.floor << ", ceiling "
+                  << timeoutPolicy.ceiling << '\n'
+                  << "\t"
+                  << "sampling: " << samplingStrategyToString(sampling.strategy)
+                  << ", size " << sampling.size << ", seed " << sampling.seed
+                  << ", budget " << sampling.budget << '\n'
+                  << "\t"
+                  << "shard: " << shard.index << " of " << shard.count << '\n'
+                  << "\t"
+                  << "test_order: " << testOrderToString(testOrder) << '\n'
+                  << "\t"
+                  << "mutant_order: " << mutantOrderToString(mutantOrder)
+                  << '\n'
+                  << "\t"
+                  << "batch_kill_size: " << batchKillSize << '\n'
+                  << "\t"
+                  << "original_test_batch_size: " << originalTestBatchSize
+                  << '\n'
+                  << "\t"
+                  << "loop_budget: " << loopBudget << '\n'
+                  << "\t"
+                  << "stall_timeout: " << stallTimeout << '\n'
+                  << "\t"
+                  << "flaky_runs: " << flakyRuns << '\n'
+                  << "\t"
+                  << "distributed: "
+                  << distributedRoleToString(distributed.role)
+                  << ", directory " << distributed.directory << ", chunk "
+                  << distributed.chunk << ", lease " << distributed.lease
+                  << '\n'
+                  << "\t"
+                  << "child_resources: address_space "
+                  << childResources.addressSpace << ", cpu_time "
+                  << childResources.cpuTime << ", open_files "
+                  << childResources.openFiles << ", cgroup_root "
+                  << childResources.cgroupRoot << ", cgroup_memory "
+                  << childResources.cgroupMemory << ", cgroup_cpu "
+                  << childResources.cgroupCPU << ", memory_budget "
+                  << childResources.memoryBudget << '\n'
+                  << "\t"
+                  << "heap: arenas " << heap.arenas << ", trim "
+                  << (heap.trim ? "true" : "false") << '\n'
+                  << "\t"
+                  << "result_memory_budget: " << resultMemoryBudget << '\n'
+                  << "\t"
                   << "dry_run: " << dryRunToString(dryRun) << '\n'
                   << "\t"
                   << "fail_fast: " << failFastToString(failFast) << '\n'
@@ -278,13 +990,144 @@ void RawConfig::dump() const {
                   << "\t"
                   << "use_cache: " << cachingToString(caching) << '\n'
                   << "\t"
+                  << "cache_compression: "
+                  << cacheCompressionToString(cacheCompression) << '\n'
+                  << "\t"
+                  << "cache_size_limit: " << cacheSizeLimit << '\n'
+                  << "\t"
+                  << "cache_populate: " << cachePopulateToString(cachePopulate)
+                  << '\n'
+                  << "\t"
+                  << "reachability_cache: "
+                  << reachabilityCacheToString(reachabilityCache) << '\n'
+                  << "\t"
+                  << "program_library: "
+                  << programLibraryToString(programLibrary) << '\n'
+                  << "\t"
+                  << "mutation_search_cache: "
+                  << mutationSearchCacheToString(mutationSearchCache) << '\n'
+                  << "\t"
+                  << "test_search_cache: "
+                  << testSearchCacheToString(testSearchCache) << '\n'
+                  << "\t"
+                  << "hash_algorithm: " << hashAlgorithmToString(hashAlgorithm)
+                  << '\n'
+                  << "\t"
+                  << "codegen_opt_level: " << codegenOptLevel << '\n'
+                  << "\t"
+                  << "mutant_debug_info: "
+                  << mutantDebugInfoToString(mutantDebugInfo) << '\n'
+                  << "\t"
+                  << "parallel_codegen_threshold: " << parallelCodegenThreshold
+                  << '\n'
+                  << "\t"
+                  << "json_flush_interval: " << jsonFlushInterval << '\n'
+                  << "\t"
+                  << "sqlite_writers: " << sqliteWriters << '\n'
+                  << "\t"
+                  << "deadline: " << deadline << '\n'
+                  << "\t"
+                  << "reachability_sample_period: "
+                  << reachabilitySamplePeriod << '\n'
+                  << "\t"
+                  << "cache_remote_url: " << cacheRemoteURL << '\n'
+                  << "\t"
+                  << "changed_lines: " << changedLines << '\n'
+                  << "\t"
+                  << "previous_results: " << previousResults << '\n'
+                  << "\t"
+                  << "resume: " << resume << '\n'
+                  << "\t"
+                  << "kill_matrix: " << killMatrix << '\n'
+                  << "\t"
+                  << "minimized_tests: " << minimizedTests << '\n'
+                  << "\t"
+                  << "metrics_endpoint: " << metricsEndpoint << '\n'
+                  << "\t"
                   << "junk_detection: "
                   << (junkDetectionEnabled() ? "enabled" : "disabled") << '\n'
                   << "\t"
                   << "diagnostics: " << diagnosticsToString(diagnostics) << '\n'
                   << "\t"
                   << "emit_debug_info: " << emitDebugInfoToString(emitDebugInfo)
-                  << '\n';
+                  << '\n'
+                  << "\t"
+                  << "output_limit: " << outputLimit << '\n'
+                  << "\t"
+                  << "drop_passed_output: "
+                  << dropPassedOutputToString(dropPassedOutput) << '\n'
+                  << "\t"
+                  << "output_retention: "
+                  << outputRetentionToString(outputRetention) << '\n'
+                  << "\t"
+                  << "output_tail: " << outputTail << '\n'
+                  << "\t"
+                  << "mutant_schemata: "
+                  << mutantSchemataToString(mutantSchemata) << '\n'
+                  << "\t"
+                  << "split_mutated_functions: "
+                  << splitMutatedFunctionsToString(splitMutatedFunctions)
+                  << '\n'
+                  << "\t"
+                  << "equivalent_mutant_pruning: "
+                  << equivalentMutantPruningToString(equivalentMutantPruning)
+                  << '\n'
+                  << "\t"
+                  << "shared_program: " << sharedProgramToString(sharedProgram)
+                  << '\n'
+                  << "\t"
+                  << "lazy_jit: " << lazyJITToString(lazyJIT) << '\n'
+                  << "\t"
+                  << "parallel_jit: " << parallelJITToString(parallelJIT)
+                  << '\n'
+                  << "\t"
+                  << "defer_mutant_cloning: "
+                  << deferMutantCloningToString(deferMutantCloning)
+                  << '\n'
+                  << "\t"
+                  << "lazy_bitcode_loading: "
+                  << lazyBitcodeLoadingToString(lazyBitcodeLoading) << '\n'
+                  << "\t"
+                  << "inline_instrumentation: "
+                  << inlineInstrumentationToString(inlineInstrumentation)
+                  << '\n'
+                  << "\t"
+                  << "coverage_instrumentation: "
+                  << coverageInstrumentationToString(coverageInstrumentation)
+                  << '\n'
+                  << "\t"
+                  << "guarded_instrumentation: "
+                  << guardedInstrumentationToString(guardedInstrumentation)
+                  << '\n'
+                  << "\t"
+                  << "constructor_template: "
+                  << constructorTemplateToString(constructorTemplate) << '\n'
+                  << "\t"
+                  << "direct_test_run: "
+                  << directTestRunToString(directTestRun) << '\n'
+                  << "\t"
+                  << "release_ir: " << releaseIRToString(releaseIR) << '\n'
+                  << "\t"
+                  << "jit_huge_pages: " << jitHugePagesToString(jitHugePages)
+                  << '\n'
+                  << "\t"
+                  << "block_coverage: " << blockCoverageToString(blockCoverage)
+                  << '\n'
+                  << "\t"
+                  << "bounded_call_tree: "
+                  << boundedCallTreeToString(boundedCallTree) << '\n'
+                  << "\t"
+                  << "perf_counters: " << perfCountersToString(perfCounters)
+                  << '\n'
+                  << "\t"
+                  << "direct_calls: " << directCallsToString(directCalls)
+                  << '\n'
+                  << "\t"
+                  << "stop_on_survivor: "
+                  << stopOnSurvivorToString(stopOnSurvivor) << '\n'
+                  << "\t"
+                  << "static_reachability: "
+                  << staticReachabilityToString(staticReachability) << '\n';
 
   if (!mutators.empty()) {
     Logger::debug() << "\t"
@@ -312,6 +1155,15 @@ void RawConfig::dump() const {
       Logger::debug() << "\t- " << excludeLocation << '\n';
     }
   }
+
+  if (!getFreshGlobalsTests().empty()) {
+    Logger::debug() << "\t"
+                    << "fresh_globals_tests: " << '\n';
+
+    for (const auto &test : getFreshGlobalsTests()) {
+      Logger::debug() << "\t- " << test << '\n';
+    }
+  }
 }
 
 std::vector<std::string> RawConfig::validate() {
@@ -355,6 +1207,193 @@ std::vector<std::string> RawConfig::validate() {
     }
   }
 
+  if (timeoutPolicy.runs < 1 || timeoutPolicy.deviations < 0 ||
+      timeoutPolicy.multiplier < 1 || timeoutPolicy.floor < 0 ||
+      timeoutPolicy.ceiling < 0) {
+    std::stringstream error;
+
+    error << "timeout_policy: runs and multiplier must be positive, "
+             "deviations, floor and ceiling must not be negative";
+
+    errors.push_back(error.str());
+  } else if (timeoutPolicy.ceiling != 0 &&
+             timeoutPolicy.ceiling < timeoutPolicy.floor) {
+    std::stringstream error;
+
+    error << "timeout_policy: ceiling must not be below floor: "
+          << timeoutPolicy.ceiling << " < " << timeoutPolicy.floor;
+
+    errors.push_back(error.str());
+  }
+
+  if (sampling.size < 0 || sampling.budget < 0) {
+    std::stringstream error;
+
+    error << "sampling: size and budget must not be negative";
+
+    errors.push_back(error.str());
+  } else if (sampling.strategy == SamplingStrategy::TimeBudget &&
+             sampling.budget == 0) {
+    std::stringstream error;
+
+    error << "sampling: time_budget requires a budget in seconds";
+
+    errors.push_back(error.str());
+  } else if (sampling.strategy != SamplingStrategy::None &&
+             sampling.strategy != SamplingStrategy::TimeBudget &&
+             sampling.size == 0) {
+    std::stringstream error;
+
+    error << "sampling: " << samplingStrategyToString(sampling.strategy)
+          << " requires a sample size";
+
+    errors.push_back(error.str());
+  }
+
+  if (shard.count < 1 || shard.index < 0 || shard.index >= shard.count) {
+    std::stringstream error;
+
+    error << "shard: index must be below count: " << shard.index << " of "
+          << shard.count;
+
+    errors.push_back(error.str());
+  }
+
+  if (batchKillSize < 0) {
+    std::stringstream error;
+
+    error << "batch_kill_size must not be negative: " << batchKillSize;
+
+    errors.push_back(error.str());
+  }
+
+  if (originalTestBatchSize < 0) {
+    std::stringstream error;
+
+    error << "original_test_batch_size must not be negative: "
+          << originalTestBatchSize;
+
+    errors.push_back(error.str());
+  }
+
+  if (loopBudget < 0) {
+    std::stringstream error;
+
+    error << "loop_budget must not be negative: " << loopBudget;
+
+    errors.push_back(error.str());
+  }
+
+  if (stallTimeout < 0) {
+    std::stringstream error;
+
+    error << "stall_timeout must not be negative: " << stallTimeout;
+
+    errors.push_back(error.str());
+  }
+
+  if (flakyRuns < 0) {
+    std::stringstream error;
+
+    error << "flaky_runs must not be negative: " << flakyRuns;
+
+    errors.push_back(error.str());
+  }
+
+  if (distributed.role != DistributedRole::None &&
+      distributed.directory.empty()) {
+    std::stringstream error;
+
+    error << "distributed: " << distributedRoleToString(distributed.role)
+          << " requires a directory";
+
+    errors.push_back(error.str());
+  } else if (distributed.chunk <= 0 || distributed.lease <= 0) {
+    std::stringstream error;
+
+    error << "distributed: chunk and lease must be positive";
+
+    errors.push_back(error.str());
+  }
+
+  if (childResources.addressSpace < 0 || childResources.cpuTime < 0 ||
+      childResources.openFiles < 0 || childResources.cgroupMemory < 0 ||
+      childResources.cgroupCPU < 0 || childResources.memoryBudget < 0) {
+    std::stringstream error;
+
+    error << "child_resources: the limits must not be negative";
+
+    errors.push_back(error.str());
+  } else if (childResources.cgroupRoot.empty() &&
+             (childResources.cgroupMemory != 0 ||
+              childResources.cgroupCPU != 0)) {
+    std::stringstream error;
+
+    error << "child_resources: cgroup_memory and cgroup_cpu require "
+             "a cgroup_root";
+
+    errors.push_back(error.str());
+  }
+
+  if (heap.arenas < 0) {
+    std::stringstream error;
+
+    error << "heap: arenas must not be negative";
+
+    errors.push_back(error.str());
+  }
+
+  if (resultMemoryBudget < 0) {
+    std::stringstream error;
+
+    error << "result_memory_budget must not be negative: "
+          << resultMemoryBudget;
+
+    errors.push_back(error.str());
+  }
+
+  if (!changedLines.empty() && !llvm::sys::fs::exists(changedLines)) {
+    std::stringstream error;
+
+    error << "changed_lines parameter points to a non-existing file: "
+          << changedLines;
+
+    errors.push_back(error.str());
+  }
+
+  if (!previousResults.empty() && !llvm::sys::fs::exists(previousResults)) {
+    std::stringstream error;
+
+    error << "previous_results parameter points to a non-existing file: "
+          << previousResults;
+
+    errors.push_back(error.str());
+  }
+
+  if (!resume.empty() && !llvm::sys::fs::exists(resume)) {
+    std::stringstream error;
+
+    error << "resume parameter points to a non-existing file: " << resume;
+
+    errors.push_back(error.str());
+  }
+
+  if (codegenOptLevel < 0 || codegenOptLevel > 3) {
+    std::stringstream error;
+
+    error << "codegen_opt_level parameter must be between 0 and 3: "
+          << codegenOptLevel;
+
+    errors.push_back(error.str());
+  }
+
+  for (auto &location : excludeLocations) {
+    std::string error = Filter::validateLocationPattern(location);
+    if (!error.empty()) {
+      errors.push_back("exclude_locations: " + error);
+    }
+  }
+
   return errors;
 }
 
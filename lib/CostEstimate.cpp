@@ -0,0 +1,157 @@
+#include "mull/CostEstimate.h"
+
+#include "mull/Config/Configuration.h"
+#include "mull/MutationPoint.h"
+#include "mull/Mutators/Mutator.h"
+#include "mull/TestFrameworks/Test.h"
+#include "mull/TimeoutPolicy.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <unordered_map>
+
+using namespace mull;
+
+static const int64_t Millisecond = 1000000;
+static const int64_t Second = 1000 * Millisecond;
+
+RunCost &RunCost::operator+=(const RunCost &other) {
+  least += other.least;
+  most += other.most;
+  return *this;
+}
+
+CostModel::CostModel(int64_t sandboxOverhead, double load, bool failFast)
+    : sandboxOverhead(sandboxOverhead), load(load), failFast(failFast) {}
+
+/// The runs of the tests of a batch past the first one have no overhead of
+/// their own, they are left out
+static int64_t meanOverhead(const std::vector<Test> &tests) {
+  int64_t overhead = 0;
+  int64_t runs = 0;
+  for (auto &test : tests) {
+    auto &timings = test.getExecutionResult().timings;
+    if (timings.fork == 0) {
+      continue;
+    }
+    overhead +=
+        timings.fork + timings.forkToStart + timings.reap + timings.outputRead;
+    runs++;
+  }
+  return runs ? overhead / runs : 0;
+}
+
+CostModel::CostModel(const Configuration &config,
+                     const std::vector<Test> &tests)
+    : CostModel(meanOverhead(tests), TimeoutPolicy(config).getLoad(),
+                config.failFastEnabled && config.killMatrixPath.empty()) {}
+
+int64_t CostModel::testCost(const Test &test) const {
+  auto &runningTimes = test.getRunningTimes();
+  int64_t mean = 0;
+  if (runningTimes.empty()) {
+    mean = TimeoutPolicy::runningTime(test.getExecutionResult());
+  } else {
+    for (auto time : runningTimes) {
+      mean += time;
+    }
+    mean /= int64_t(runningTimes.size());
+  }
+  return int64_t(mean * load) + sandboxOverhead;
+}
+
+RunCost CostModel::mutantCost(const MutationPoint &point) const {
+  RunCost cost;
+  bool first = true;
+  for (auto reachableTest : point.getReachableTests()) {
+    auto test = testCost(*reachableTest.first);
+    cost.most += test;
+    if (first || !failFast) {
+      cost.least += test;
+    }
+    first = false;
+  }
+  return cost;
+}
+
+RunCost CostEstimate::wallTime(const Entry &entry) const {
+  auto shares = int64_t(std::max<size_t>(workers, 1));
+  return RunCost(entry.cost.least / shares, entry.cost.most / shares);
+}
+
+static std::vector<CostEstimate::Entry>
+sortedEntries(std::unordered_map<std::string, CostEstimate::Entry> &entries) {
+  std::vector<CostEstimate::Entry> sorted;
+  sorted.reserve(entries.size());
+  for (auto &entry : entries) {
+    sorted.push_back(std::move(entry.second));
+  }
+  std::sort(sorted.begin(), sorted.end(),
+            [](const CostEstimate::Entry &a, const CostEstimate::Entry &b) {
+              if (a.cost.most != b.cost.most) {
+                return a.cost.most > b.cost.most;
+              }
+              return a.name < b.name;
+            });
+  return sorted;
+}
+
+CostEstimate mull::estimateCost(const CostModel &model,
+                                const std::vector<MutationPoint *> &points,
+                                size_t workers) {
+  std::unordered_map<std::string, CostEstimate::Entry> files;
+  std::unordered_map<std::string, CostEstimate::Entry> mutators;
+  CostEstimate estimate;
+  estimate.workers = workers;
+  estimate.overall.name = "overall";
+
+  for (auto point : points) {
+    auto cost = model.mutantCost(*point);
+    auto &file = point->getSourceLocation().filePath();
+    auto &byFile = files[file];
+    byFile.name = file;
+    auto mutator = point->getMutator()->getUniqueIdentifier();
+    auto &byMutator = mutators[mutator];
+    byMutator.name = mutator;
+    for (auto entry : {&byFile, &byMutator, &estimate.overall}) {
+      entry->mutants++;
+      entry->cost += cost;
+    }
+  }
+
+  estimate.files = sortedEntries(files);
+  estimate.mutators = sortedEntries(mutators);
+  return estimate;
+}
+
+int64_t mull::remainingTime(int64_t estimate, int64_t elapsed, size_t done,
+                            size_t total) {
+  if (total == 0 || done >= total) {
+    return 0;
+  }
+  double progress = double(done) / double(total);
+  double predicted = double(estimate) * (1 - progress);
+  double observed =
+      done ? double(elapsed) * double(total - done) / double(done) : predicted;
+  return int64_t((1 - progress) * predicted + progress * observed);
+}
+
+std::string mull::formatDuration(int64_t nanoseconds) {
+  char buffer[32];
+  if (nanoseconds < Second) {
+    snprintf(buffer, sizeof(buffer), "%lldms",
+             static_cast<long long>(nanoseconds / Millisecond));
+    return buffer;
+  }
+  auto seconds = static_cast<long long>(nanoseconds / Second);
+  if (seconds < 60) {
+    snprintf(buffer, sizeof(buffer), "%llds", seconds);
+  } else if (seconds < 60 * 60) {
+    snprintf(buffer, sizeof(buffer), "%lldm%02llds", seconds / 60,
+             seconds % 60);
+  } else {
+    snprintf(buffer, sizeof(buffer), "%lldh%02lldm", seconds / 3600,
+             seconds / 60 % 60);
+  }
+  return buffer;
+}
@@ -0,0 +1,195 @@
+#include "mull/Daemon.h"
+
+#include "mull/Filter.h"
+#include "mull/Logger.h"
+#include "mull/Parallelization/ThreadPool.h"
+
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace mull;
+
+bool DaemonRequest::parse(llvm::StringRef text, DaemonRequest &request,
+                          std::string &error) {
+  llvm::SmallVector<llvm::StringRef, 16> lines;
+  text.split(lines, '\n', -1, false);
+  for (auto line : lines) {
+    line = line.trim();
+    if (line.empty()) {
+      continue;
+    }
+    auto keyAndValue = line.split(' ');
+    auto key = keyAndValue.first;
+    auto value = keyAndValue.second.trim();
+
+    if (key == "stop" && value.empty()) {
+      request.stop = true;
+      continue;
+    }
+    if (value.empty()) {
+      error = "no value in '" + line.str() + "'";
+      return false;
+    }
+    if (key == "test") {
+      request.tests.push_back(value.str());
+    } else if (key == "file") {
+      request.files.addFile(value.str());
+    } else if (key == "exclude") {
+      error = Filter::validateLocationPattern(value.str());
+      if (!error.empty()) {
+        return false;
+      }
+      request.excludedLocations.push_back(value.str());
+    } else {
+      error = "unknown request '" + line.str() + "'";
+      return false;
+    }
+  }
+  return true;
+}
+
+Daemon::Daemon(std::string socketPath)
+    : socketPath(std::move(socketPath)), server(-1) {}
+
+Daemon::~Daemon() {
+  if (server != -1) {
+    close(server);
+    unlink(socketPath.c_str());
+  }
+}
+
+bool Daemon::listen() {
+  sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  if (socketPath.size() >= sizeof(address.sun_path)) {
+    Logger::error() << "The path of the socket is too long: " << socketPath
+                    << "\n";
+    return false;
+  }
+  address.sun_family = AF_UNIX;
+  strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+  server = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (server == -1) {
+    Logger::error() << "Cannot create a socket: " << strerror(errno) << "\n";
+    return false;
+  }
+  unlink(socketPath.c_str());
+  if (bind(server, reinterpret_cast<sockaddr *>(&address), sizeof(address)) ==
+          -1 ||
+      ::listen(server, 16) == -1) {
+    Logger::error() << "Cannot listen on " << socketPath << ": "
+                    << strerror(errno) << "\n";
+    close(server);
+    server = -1;
+    return false;
+  }
+  return true;
+}
+
+/// The request ends with an empty line, or once the client stops writing
+static std::string readRequest(int client) {
+  std::string text;
+  char buffer[4096];
+  while (text.find("\n\n") == std::string::npos) {
+    auto count = read(client, buffer, sizeof(buffer));
+    if (count == -1 && errno == EINTR) {
+      continue;
+    }
+    if (count <= 0) {
+      break;
+    }
+    text.append(buffer, size_t(count));
+  }
+  return text.substr(0, text.find("\n\n"));
+}
+
+static void writeAll(int client, const std::string &text) {
+  size_t written = 0;
+  while (written < text.size()) {
+    auto count = write(client, text.data() + written, text.size() - written);
+    if (count == -1 && errno == EINTR) {
+      continue;
+    }
+    if (count <= 0) {
+      return;
+    }
+    written += size_t(count);
+  }
+}
+
+static std::string exitLine(int status) {
+  return "mull-daemon: exit " + std::to_string(status) + "\n";
+}
+
+void Daemon::serve(const Handler &handler) {
+  /// A client that goes away must not take the daemon with it
+  signal(SIGPIPE, SIG_IGN);
+  bool stop = false;
+  while (!stop) {
+    int client = accept(server, nullptr, nullptr);
+    if (client == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      Logger::error() << "Cannot accept a client: " << strerror(errno) << "\n";
+      return;
+    }
+    serveClient(client, handler, stop);
+    close(client);
+  }
+}
+
+void Daemon::serveClient(int client, const Handler &handler, bool &stop) {
+  DaemonRequest request;
+  std::string error;
+  if (!DaemonRequest::parse(readRequest(client), request, error)) {
+    writeAll(client, "mull-daemon: " + error + "\n" + exitLine(1));
+    return;
+  }
+  if (request.stop) {
+    stop = true;
+    writeAll(client, exitLine(0));
+    return;
+  }
+
+  /// The child would write what is buffered once more otherwise
+  Logger::flush();
+  llvm::outs().flush();
+  llvm::errs().flush();
+  const pid_t pid = fork();
+  if (pid == -1) {
+    writeAll(client, "mull-daemon: cannot fork: " +
+                         std::string(strerror(errno)) + "\n" + exitLine(1));
+    return;
+  }
+
+  if (pid == 0) {
+    signal(SIGPIPE, SIG_DFL);
+    close(server);
+    dup2(client, STDOUT_FILENO);
+    dup2(client, STDERR_FILENO);
+    close(client);
+    ThreadPool::shared().forgetThreads();
+    int status = handler(request);
+    llvm::outs().flush();
+    llvm::errs().flush();
+    _exit(status);
+  }
+
+  int status = 0;
+  while (waitpid(pid, &status, 0) == -1 && errno == EINTR) {
+  }
+  int exitStatus =
+      WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+  writeAll(client, exitLine(exitStatus));
+}
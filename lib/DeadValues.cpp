@@ -0,0 +1,77 @@
+#include "mull/DeadValues.h"
+
+#include <llvm/ADT/SmallPtrSet.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/Analysis/ValueTracking.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/IntrinsicInst.h>
+
+using namespace llvm;
+
+bool mull::isDeadStore(const StoreInst &store) {
+  if (store.isVolatile() || store.isAtomic()) {
+    return false;
+  }
+  auto variable = dyn_cast<AllocaInst>(store.getPointerOperand());
+  if (!variable) {
+    return false;
+  }
+  for (auto user : variable->users()) {
+    auto otherStore = dyn_cast<StoreInst>(user);
+    if (!otherStore || otherStore->getPointerOperand() != variable ||
+        otherStore->getValueOperand() == variable) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool mull::isObservable(const Instruction &instruction) {
+  if (auto store = dyn_cast<StoreInst>(&instruction)) {
+    return !isDeadStore(*store);
+  }
+  /// A division that did not trap may once its divisor is mutated
+  switch (instruction.getOpcode()) {
+  case Instruction::SDiv:
+  case Instruction::UDiv:
+  case Instruction::SRem:
+  case Instruction::URem:
+    return true;
+  default:
+    break;
+  }
+  if (!isSafeToSpeculativelyExecute(&instruction)) {
+    return true;
+  }
+
+  SmallPtrSet<const Instruction *, 16> visited;
+  SmallVector<const Instruction *, 16> worklist;
+  worklist.push_back(&instruction);
+  while (!worklist.empty()) {
+    auto value = worklist.pop_back_val();
+    for (auto user : value->users()) {
+      auto userInstruction = dyn_cast<Instruction>(user);
+      if (!userInstruction) {
+        return true;
+      }
+      if (isa<DbgInfoIntrinsic>(userInstruction)) {
+        continue;
+      }
+      if (auto store = dyn_cast<StoreInst>(userInstruction)) {
+        if (store->getValueOperand() == value && isDeadStore(*store)) {
+          continue;
+        }
+        return true;
+      }
+      if (userInstruction->isTerminator() ||
+          userInstruction->mayHaveSideEffects() ||
+          !isSafeToSpeculativelyExecute(userInstruction)) {
+        return true;
+      }
+      if (visited.insert(userInstruction).second) {
+        worklist.push_back(userInstruction);
+      }
+    }
+  }
+  return false;
+}
@@ -1,28 +1,63 @@
 #include "mull/Driver.h"
 
+#include "mull/ChangedLines.h"
+#include "mull/Checkpoint.h"
 #include "mull/Config/Configuration.h"
+#include "mull/CostEstimate.h"
+#include "mull/Heap.h"
+#include "mull/Instrumentation/ReachabilityCache.h"
+#include "mull/Instrumentation/SampledReachability.h"
+#include "mull/Instrumentation/StaticCallGraph.h"
+#include "mull/JunkDetection/JunkDetectionProcesses.h"
 #include "mull/JunkDetection/JunkDetector.h"
+#include "mull/KillMatrix.h"
 #include "mull/Logger.h"
+#include "mull/Metrics/LiveMetrics.h"
 #include "mull/Metrics/Metrics.h"
 #include "mull/ModuleLoader.h"
+#include "mull/MutantSampler.h"
 #include "mull/MutationResult.h"
 #include "mull/MutationsFinder.h"
+#include "mull/Parallelization/DistributedQueue.h"
 #include "mull/Parallelization/Parallelization.h"
+#include "mull/PreviousResults.h"
 #include "mull/Program/Program.h"
+#include "mull/Reporters/Reporter.h"
 #include "mull/Result.h"
 #include "mull/TestFrameworks/TestFramework.h"
+#include "mull/TestPrioritization.h"
+#include "mull/TestSet.h"
+#include "mull/TestSuiteMinimization.h"
+#include "mull/TestTimings.h"
 #include "mull/Testee.h"
+#include "mull/Toolchain/CountingMemoryManager.h"
 #include "mull/Toolchain/JITEngine.h"
+#include "mull/Toolchain/ProgramLibrary.h"
+#include "mull/Toolchain/Resolvers/ProcessSymbols.h"
+#include "mull/Toolchain/SymbolIndex.h"
+#include "mull/Toolchain/Trampolines.h"
 
+#include <llvm/Object/ELFObjectFile.h>
 #include <llvm/Support/DynamicLibrary.h>
+#include <llvm/Support/FileSystem.h>
 #include <llvm/Support/Path.h>
 #include <llvm/Transforms/Utils/Cloning.h>
 
 #include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
 #include <fstream>
+#include <iterator>
+#include <limits>
 #include <map>
+#include <set>
 #include <sys/mman.h>
 #include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 using namespace llvm;
@@ -53,42 +88,252 @@ Driver::~Driver() {
 /// Each result contains result of execution of an original test and
 /// all the results of each mutant within corresponding MutationPoint
 
+static void removeEquivalentMutants(std::vector<MutationPoint *> &points);
+
+/// The points of a cancelled run that have results, the others did not run
+static std::vector<MutationPoint *>
+ranMutationPoints(const std::vector<MutationPoint *> &mutationPoints,
+                  const MutationResultTable &results) {
+  std::unordered_set<const MutationPoint *> ran;
+  for (size_t row = 0; row < results.size(); row++) {
+    ran.insert(results.getMutationPoint(row));
+  }
+  std::vector<MutationPoint *> points;
+  for (auto point : mutationPoints) {
+    if (ran.count(point)) {
+      points.push_back(point);
+    }
+  }
+  Logger::warn() << "The run was cancelled ("
+                 << Cancellation::reasonToString(
+                        Cancellation::shared().reason())
+                 << "), " << points.size() << " of " << mutationPoints.size()
+                 << " mutants ran, the others are left out of the results\n";
+  return points;
+}
+
 std::unique_ptr<Result> Driver::Run() {
-  compileInstrumentedBitcodeFiles();
-  loadDynamicLibraries();
+  if (config.deadline > 0) {
+    Cancellation::shared().setDeadline(config.deadline);
+  }
+  /// Before the workers subscribe, they would see the previous run otherwise
+  if (config.distributed.role == DistributedRole::Coordinator) {
+    distributedQueue->clear();
+  }
+  prepareIncrementalRun();
+  if (!warm) {
+    for (auto &module : program.modules()) {
+      instrumentation.recordFunctions(module->getModule());
+    }
+  }
 
+  /// Neither the libraries nor the search for the tests need the
+  /// instrumented code, it is compiled meanwhile on the workers of the pool
+  WorkerGroup compilation(ThreadPool::shared());
+  if (!compiled && needsInstrumentedCode()) {
+    /// The original tests link every object, they are linked as they come
+    if (!config.lazyJITEnabled && !config.parallelJITEnabled &&
+        !reachabilityCache && !toolchain.isPositionIndependent()) {
+      linkingProgram = make_unique<JITEngine>(JITLinking::Eager);
+      testFramework.runner().beginInstrumentedProgram(instrumentation,
+                                                      *linkingProgram);
+    }
+    compilation.run([this]() {
+      compileInstrumentedBitcodeFiles(linkingProgram.get());
+    });
+  }
+  if (!warm) {
+    loadDynamicLibraries();
+  }
   auto tests = findTests();
-  auto mutationPoints = findMutationPoints(tests);
-  auto nonJunkMutationPoints =
-      filterOutJunkMutations(std::move(mutationPoints));
-  auto mutationResults = runMutations(nonJunkMutationPoints);
+  compilation.wait();
+
+  auto nonJunkMutationPoints = findMutationPoints(tests);
+  if (config.sampling.strategy != SamplingStrategy::None) {
+    nonJunkMutationPoints = sampleMutationPoints(nonJunkMutationPoints);
+  }
+  if (config.shard.count > 1) {
+    nonJunkMutationPoints = shardMutationPoints(nonJunkMutationPoints);
+  }
+  endPhase(RunPhase::MutationSearch);
+  if (!config.killMatrixPath.empty() && !config.dryRunEnabled) {
+    createKillMatrix(nonJunkMutationPoints, tests);
+  }
+  if (!config.minimizedTestsPath.empty() && !killMatrix) {
+    Logger::warn() << "Minimizing the tests requires the kill matrix, "
+                      "the tests will not be minimized\n";
+  }
+  auto mutationResults = runMutations(nonJunkMutationPoints, tests);
+  if (Cancellation::shared().reason() != Cancellation::Reason::None) {
+    nonJunkMutationPoints =
+        ranMutationPoints(nonJunkMutationPoints, mutationResults);
+  }
+  if (config.equivalentMutantPruningEnabled) {
+    removeEquivalentMutants(nonJunkMutationPoints);
+  }
+  endPhase(RunPhase::MutantExecution);
+  if (killMatrix && !config.minimizedTestsPath.empty()) {
+    writeMinimizedTests();
+  }
+  metrics.setObjectCacheMetrics(toolchain.cache().getMetrics());
+  metrics.setMemoryMetrics(memoryMetrics());
 
-  return make_unique<Result>(std::move(tests), std::move(mutationResults),
-                             std::move(nonJunkMutationPoints));
+  auto result =
+      make_unique<Result>(std::move(tests), std::move(mutationResults),
+                          std::move(nonJunkMutationPoints));
+  result->setKillMatrix(std::move(killMatrix));
+  return result;
 }
 
-void Driver::compileInstrumentedBitcodeFiles() {
-  metrics.beginInstrumentedCompilation();
+void Driver::createKillMatrix(const std::vector<MutationPoint *> &points,
+                              const std::vector<Test> &tests) {
+  killMatrix = make_unique<KillMatrix>(config.killMatrixPath, points, tests);
+  if (!killMatrix->isMapped()) {
+    Logger::warn() << "Running without the kill matrix\n";
+    killMatrix.reset();
+    return;
+  }
+  Logger::info() << "Keeping the kill matrix of " << points.size()
+                 << " mutants by " << tests.size() << " tests in "
+                 << config.killMatrixPath << " ("
+                 << killMatrix->getFileSize() << " bytes)\n";
+}
+
+void Driver::writeMinimizedTests() {
+  metrics.beginSpan("Minimize tests");
+  auto columns =
+      minimizeTestSuite(*killMatrix, config.parallelization.workers);
+  metrics.endSpan("Minimize tests");
+
+  std::vector<std::string> testNames;
+  for (auto column : columns) {
+    testNames.push_back(killMatrix->getTestName(column));
+  }
+  if (!writeTestList(config.minimizedTestsPath, testNames)) {
+    Logger::error() << "Cannot write the minimized tests to "
+                    << config.minimizedTestsPath << "\n";
+    return;
+  }
+  Logger::info() << testNames.size() << " of "
+                 << killMatrix->getColumnCount()
+                 << " tests kill the same mutants, written to "
+                 << config.minimizedTestsPath << "\n";
+}
+
+void Driver::warmUp() {
+  for (auto &module : program.modules()) {
+    instrumentation.recordFunctions(module->getModule());
+  }
+  loadDynamicLibraries();
+  compileInstrumentedBitcodeFiles();
+  ProcessSymbols::shared().prefetch(AllInstrumentedObjectFiles(),
+                                    config.parallelization.workers);
+  warm = true;
+}
+
+static uint64_t objectFilesBytes(
+    const std::vector<object::OwningBinary<object::ObjectFile>> &objects) {
+  uint64_t bytes = 0;
+  for (auto &object : objects) {
+    bytes += object.getBinary()->getData().size();
+  }
+  return bytes;
+}
+
+/// The bitcode size stands for the size of the IR, which LLVM cannot measure
+MemoryMetrics Driver::memoryMetrics() {
+  MemoryMetrics memory;
+  for (auto &module : program.modules()) {
+    memory.bitcodeBytes += module->getBitcodeSize();
+  }
+  memory.objectFileBytes = objectFilesBytes(instrumentedObjectFiles) +
+                           objectFilesBytes(ownedObjectFiles);
+  memory.jitSectionBytes = CountingMemoryManager::allocatedBytes();
+  memory.outputBytes = outputStore.storedBytes();
+  return memory;
+}
+
+void Driver::prepareIncrementalRun() {
+  if (!config.changedLinesPath.empty()) {
+    auto changes = make_unique<ChangedLines>();
+    if (ChangedLines::load(config.changedLinesPath, *changes)) {
+      changedLines = std::move(changes);
+    } else {
+      Logger::warn() << "Cannot read the changed lines from "
+                     << config.changedLinesPath
+                     << ", every line is considered changed\n";
+    }
+  }
 
-  for (auto &ownedModule : program.modules()) {
-    MullModule &module = *ownedModule;
-    instrumentation.recordFunctions(module.getModule());
+  if (!config.previousResultsPath.empty()) {
+    auto results = make_unique<PreviousResults>();
+    std::string error;
+    if (results->load(config.previousResultsPath, error)) {
+      previousResults = std::move(results);
+    } else {
+      Logger::warn() << "Cannot reuse the results of "
+                     << config.previousResultsPath << ": " << error << "\n";
+    }
   }
 
+  if (!config.resumePath.empty()) {
+    auto resumed = make_unique<Checkpoint>();
+    std::string error;
+    if (resumed->load(config.resumePath, error)) {
+      checkpoint = std::move(resumed);
+    } else {
+      Logger::warn() << "Cannot resume the run of " << config.resumePath
+                     << ": " << error << "\n";
+    }
+  }
+
+  /// Without previous results the mutants off the changed lines would have
+  /// no results at all, so they are not even searched for
+  if (changedLines && !previousResults) {
+    filter.includeChangedLines(*changedLines);
+  }
+}
+
+void Driver::streamResultsTo(Reporter &reporter) {
+  reporter.beginStreaming();
+  streamingReporters.push_back(&reporter);
+}
+
+void Driver::endPhase(RunPhase phase) {
+  for (auto reporter : streamingReporters) {
+    reporter->reportPhaseEnd(phase);
+  }
+}
+
+void Driver::compileInstrumentedBitcodeFiles(JITEngine *jit) {
+  metrics.beginInstrumentedCompilation();
+
   std::vector<InstrumentedCompilationTask> tasks;
   for (int i = 0; i < config.parallelization.workers; i++) {
-    tasks.emplace_back(instrumentation, toolchain);
+    tasks.emplace_back(instrumentation, toolchain, metrics, jit);
   }
 
   TaskExecutor<InstrumentedCompilationTask> compiler(
       "Compiling instrumented code", program.modules(), instrumentedObjectFiles,
-      tasks);
+      std::move(tasks));
+  compiler.setAutoTune(config.parallelization.autoTune);
   compiler.execute();
+  metrics.addWorkersMetrics(compiler.getName(), compiler.getWorkersMetrics());
+  metrics.addMemoryUsage(compiler.getMemoryUsage());
 
   metrics.endInstrumentedCompilation();
+  compiled = true;
+}
+
+/// The tests whose calls are cached may not run at all, their instrumented
+/// code is compiled only once it turns out they do
+bool Driver::needsInstrumentedCode() {
+  return !reachabilityCache || instrumentation.isGuarded() ||
+         testFramework.finder().hasRuntimeTests();
 }
 
 void Driver::loadDynamicLibraries() {
+  metrics.beginLoadDynamicLibraries();
   SingleTaskExecutor task("Loading dynamic libraries", [&]() {
     for (const std::string &dylibPath : program.getDynamicLibraryPaths()) {
       std::string msg;
@@ -99,51 +344,244 @@ void Driver::loadDynamicLibraries() {
                         << "': " << msg << "\n";
       }
     }
+    ProcessSymbols::shared().forgetMissingSymbols();
   });
   task.execute();
+  metrics.endLoadDynamicLibraries();
 }
 
 std::vector<Test> Driver::findTests() {
   std::vector<Test> tests;
-  SingleTaskExecutor task("Searching tests", [&]() {
-    tests = testFramework.finder().findTests(program, filter);
-  });
-  task.execute();
+  metrics.beginFindTests();
+  /// The finders report the search themselves, some of them search on all
+  /// the workers
+  tests = testFramework.finder().findTests(program, filter);
+  metrics.endFindTests();
+  if (auto cached = testFramework.finder().getCachedModules()) {
+    Logger::info() << "Reused the tests of " << cached
+                   << " modules from the cache\n";
+  }
   return tests;
 }
 
-std::vector<MutationPoint *> Driver::findMutationPoints(vector<Test> &tests) {
-  if (tests.empty()) {
-    return std::vector<MutationPoint *>();
+std::unique_ptr<JITEngine> Driver::loadOriginalProgram() {
+  if (!compiled) {
+    compileInstrumentedBitcodeFiles();
   }
 
   auto objectFiles = AllInstrumentedObjectFiles();
-  JITEngine jit;
+  /// The objects are loaded already when they were linked as they came,
+  /// only the relocations are left
+  const bool linked = linkingProgram != nullptr;
+  auto linking = config.lazyJITEnabled       ? JITLinking::Lazy
+                 : config.parallelJITEnabled ? JITLinking::Parallel
+                                             : JITLinking::Eager;
+  auto jit = linked ? std::move(linkingProgram)
+                    : make_unique<JITEngine>(linking);
 
+  metrics.beginLoadOriginalProgram();
+  if (!linked && toolchain.isPositionIndependent()) {
+    if (auto loaded = loadProgramLibrary(objectFiles)) {
+      metrics.endLoadOriginalProgram();
+      return loaded;
+    }
+  }
+  ProcessSymbols::shared().prefetch(objectFiles,
+                                    config.parallelization.workers);
   SingleTaskExecutor prepareOriginalTestRunTask(
       "Preparing original test run", [&]() {
+        if (linked) {
+          jit->finishObjectFiles();
+          return;
+        }
         testFramework.runner().loadInstrumentedProgram(objectFiles,
-                                                       instrumentation, jit);
+                                                       instrumentation, *jit);
       });
   prepareOriginalTestRunTask.execute();
+  metrics.endLoadOriginalProgram();
+  return jit;
+}
 
-  std::vector<OriginalTestExecutionTask> tasks;
-  tasks.reserve(config.parallelization.testExecutionWorkers);
-  for (int i = 0; i < config.parallelization.testExecutionWorkers; i++) {
-    tasks.emplace_back(instrumentation, program, *sandbox,
-                       testFramework.runner(), config, filter, jit);
+/// The program library supersedes the lazy linking: it is loaded whole, and
+/// its pages are shared by all the processes running the tests
+std::unique_ptr<JITEngine>
+Driver::loadProgramLibrary(std::vector<object::ObjectFile *> &objectFiles) {
+  std::unique_ptr<JITEngine> jit;
+  SingleTaskExecutor task("Loading program library", [&]() {
+    auto library = make_unique<ProgramLibrary>(config.cacheDirectory);
+    auto machine = toolchain.createTargetMachine();
+    if (!library->load(objectFiles, *machine)) {
+      Logger::warn() << "Linking the program in memory\n";
+      return;
+    }
+    jit = make_unique<JITEngine>();
+    testFramework.runner().loadInstrumentedLibrary(*library, instrumentation,
+                                                   *jit);
+    programLibrary = std::move(library);
+  });
+  task.execute();
+  return jit;
+}
+
+/// The listing is captured whatever the sandbox of the tests, and whatever
+/// the limit of their output
+void Driver::findRuntimeTests(std::vector<Test> &tests, JITEngine &jit) {
+  ForkProcessSandbox listingSandbox(std::numeric_limits<size_t>::max());
+  SingleTaskExecutor task("Listing test instances", [&]() {
+    auto run = [&](Test &test) {
+      instrumentation.setupInstrumentationInfo(test);
+      ExecutionResult result = listingSandbox.run(
+          [&]() { return testFramework.runner().runTest(jit, program, test); },
+          config.timeout);
+      instrumentation.cleanupInstrumentationInfo(test);
+      if (result.status != Passed) {
+        Logger::warn() << "Cannot list the tests: "
+                       << result.getStatusAsString() << "\n";
+        return std::string();
+      }
+      return result.stdoutOutput.str();
+    };
+    testFramework.finder().findRuntimeTests(run, filter, tests);
+  });
+  task.execute();
+}
+
+/// The original tests do not record their calls, see StaticCallGraph
+static bool staticReachability(const Configuration &config) {
+  return config.staticReachabilityEnabled ||
+         config.reachabilitySamplePeriod > 0;
+}
+
+std::vector<MutationPoint *> Driver::findMutationPoints(vector<Test> &tests) {
+  const bool runtimeTests = testFramework.finder().hasRuntimeTests();
+  if (tests.empty() && !runtimeTests) {
+    return std::vector<MutationPoint *>();
+  }
+
+  /// The instances are known only to the program, the tests are not cached
+  /// before the program lists them
+  std::unique_ptr<JITEngine> jit;
+  if (runtimeTests) {
+    jit = loadOriginalProgram();
+    findRuntimeTests(tests, *jit);
   }
 
   std::vector<std::unique_ptr<Testee>> testees;
-  TaskExecutor<OriginalTestExecutionTask> testRunner("Running original tests",
-                                                     tests, testees, tasks);
-  testRunner.execute();
+  auto uncachedTests = restoreCachedTestees(tests, testees);
+
+  /// The mutant run links the guarded objects of the unmutated modules
+  if (!compiled && !jit && uncachedTests.empty() &&
+      instrumentation.isGuarded()) {
+    compileInstrumentedBitcodeFiles();
+  }
+
+  if (!uncachedTests.empty()) {
+    if (!jit) {
+      jit = loadOriginalProgram();
+    }
+    if (config.reachabilitySamplePeriod > 0 && !config.lazyJITEnabled) {
+      sampledFunctions = mapFunctionAddresses(*jit);
+    }
+
+    /// Whatever runs the mutants, the original tests are batched on request
+    std::unique_ptr<ProcessSandbox> batchSandbox;
+    if (config.forkEnabled && config.originalTestBatchSize > 1) {
+      batchSandbox = make_unique<BatchProcessSandbox>(
+          size_t(std::max(config.outputLimit, 0)), !config.dropPassedOutput,
+          childResources.get(), config.perfCountersEnabled);
+    }
+
+    std::vector<OriginalTestExecutionTask> tasks;
+    tasks.reserve(config.parallelization.testExecutionWorkers);
+    for (int i = 0; i < config.parallelization.testExecutionWorkers; i++) {
+      tasks.emplace_back(instrumentation, program, *sandbox, outputStore,
+                         testFramework.runner(), config, filter, *jit, metrics,
+                         reachabilityCache.get(), &streamingReporters,
+                         batchSandbox.get(), sampledFunctions.get());
+    }
+
+    /// The slowest tests of the previous run go first, one at a time, so
+    /// that none of them is left running alone at the end of the phase.
+    /// The batches need more than one test at a time.
+    auto dispatch = TaskDispatch::Guided;
+    bool sorted = false;
+    if (testTimings) {
+      testTimings->load(program);
+      sorted = testTimings->sortLongestFirst(uncachedTests);
+    }
+    if (sorted && !batchSandbox) {
+      dispatch = TaskDispatch::OneByOne;
+    }
+    auto firstTestee = testees.size();
+
+    metrics.beginOriginalTestExecution();
+    TaskExecutor<OriginalTestExecutionTask> testRunner(
+        "Running original tests", uncachedTests, testees, tasks, dispatch);
+    testRunner.setAutoTune(config.parallelization.autoTune);
+    testRunner.execute();
+    metrics.endOriginalTestExecution();
+    metrics.addWorkersMetrics(testRunner.getName(),
+                              testRunner.getWorkersMetrics());
+    metrics.addMemoryUsage(testRunner.getMemoryUsage());
+
+    /// The testees go back to the order of the tests, which are in a vector
+    if (sorted) {
+      std::stable_sort(std::next(testees.begin(), firstTestee), testees.end(),
+                       [](const std::unique_ptr<Testee> &lhs,
+                          const std::unique_ptr<Testee> &rhs) {
+                         return lhs->getTest() < rhs->getTest();
+                       });
+    }
+    if (testTimings) {
+      testTimings->save(tests);
+    }
+  }
+
+  /// The functions are hashed before the search changes them
+  if (reachabilityCache) {
+    reachabilityCache->save();
+  }
+  instrumentation.forgetKnownTestees();
+  endPhase(RunPhase::OriginalTests);
+
+  /// The mutated objects of the previous run are read from the cache while
+  /// the search runs, before the mutations are known
+  WorkerGroup prefetch(ThreadPool::shared());
+  prefetch.run([this]() {
+    for (auto &module : program.modules()) {
+      toolchain.cache().prefetchObjects(
+          *module, toolchain.codegenPartitions(*module), true);
+    }
+  });
 
-  auto mergedTestees = mergeTestees(testees);
-  std::vector<MutationPoint *> mutationPoints =
-      mutationsFinder.getMutationPoints(program, mergedTestees, filter);
+  if (staticReachability(config)) {
+    auto sampled = std::move(testees);
+    testees = findStaticTestees(tests);
+    if (sampledFunctions) {
+      testees = narrowBySamples(testees, sampled);
+    }
+  }
+  auto mergedTestees =
+      mergeTestees(testees, config.parallelization.workers);
+  metrics.beginSpan("Search mutation points");
+  auto mutationPoints = searchMutationPoints(mergedTestees);
+  metrics.endSpan("Search mutation points");
+  metrics.setDeadMutantMetrics(mutationsFinder.getDeadMutants());
+  if (auto cached = mutationsFinder.getCachedFunctions()) {
+    Logger::info() << "Reused the mutation points of " << cached
+                   << " functions from the cache\n";
+  }
+  if (config.blockCoverageEnabled) {
+    /// They do not run, and are reported as surviving
+    auto uncovered = std::count_if(
+        mutationPoints.begin(), mutationPoints.end(),
+        [](MutationPoint *point) { return point->getReachableTests().empty(); });
+    Logger::info() << uncovered << " of " << mutationPoints.size()
+                   << " mutants are in blocks no test executed\n";
+  }
 
-  {
+  /// The guarded objects are reused by the mutant run
+  if (!instrumentation.isGuarded()) {
     /// Cleans up the memory allocated for the vector itself as well
     std::vector<OwningBinary<ObjectFile>>().swap(instrumentedObjectFiles);
   }
@@ -151,44 +589,591 @@ std::vector<MutationPoint *> Driver::findMutationPoints(vector<Test> &tests) {
   return mutationPoints;
 }
 
+/// Only the ELF objects have the sizes of their functions. The functions
+/// the JIT keeps no address of, e.g. the local ones, are never sampled.
+std::unique_ptr<FunctionAddresses>
+Driver::mapFunctionAddresses(JITEngine &jit) {
+  std::unordered_map<std::string, uint64_t> sizes;
+  for (auto objectFile : AllInstrumentedObjectFiles()) {
+    auto elf = dyn_cast<object::ELFObjectFileBase>(objectFile);
+    if (!elf) {
+      continue;
+    }
+    for (auto symbol : elf->symbols()) {
+      if (symbol.getELFType() != ELF::STT_FUNC || symbol.getSize() == 0) {
+        continue;
+      }
+      Expected<StringRef> name = symbol.getName();
+      if (!name) {
+        consumeError(name.takeError());
+        continue;
+      }
+      sizes[name.get().str()] = symbol.getSize();
+    }
+  }
+
+  auto addresses = make_unique<FunctionAddresses>();
+  for (auto &module : program.modules()) {
+    for (auto &function : module->getModule()->getFunctionList()) {
+      if (function.isDeclaration()) {
+        continue;
+      }
+      auto name =
+          toolchain.mangler().getNameWithPrefix(function.getName().str());
+      auto size = sizes.find(name);
+      if (size == sizes.end()) {
+        continue;
+      }
+      auto address = llvm_compat::JITSymbolAddress(jit.getSymbol(name));
+      if (address != 0) {
+        addresses->add(&function, address, size->second);
+      }
+    }
+  }
+  addresses->sort();
+  Logger::info() << "The samples of the original tests are mapped to "
+                 << addresses->size() << " functions\n";
+  return addresses;
+}
+
+/// The tests that did not pass reach nothing, as with the recorded calls
+std::vector<std::unique_ptr<Testee>>
+Driver::findStaticTestees(std::vector<Test> &tests) {
+  metrics.beginSpan("Build static call graph");
+  std::vector<llvm::Module *> modules;
+  for (auto &module : program.modules()) {
+    modules.push_back(module->getModule());
+  }
+  StaticCallGraph callGraph(modules);
+  metrics.endSpan("Build static call graph");
+  Logger::info() << "The static call graph has "
+                 << callGraph.getFunctionCount() << " functions and "
+                 << callGraph.getCallCount() << " direct calls\n";
+
+  std::vector<std::unique_ptr<Testee>> testees;
+  for (auto &test : tests) {
+    if (test.getExecutionResult().status != Passed || test.isFlaky()) {
+      continue;
+    }
+    auto reached = callGraph.getTestees(test, filter, config.maxDistance);
+    /// The test body is left out, as it is for the recorded calls
+    for (size_t index = 1; index < reached.size(); index++) {
+      testees.push_back(std::move(reached[index]));
+    }
+  }
+  return testees;
+}
+
+std::vector<Test *>
+Driver::restoreCachedTestees(std::vector<Test> &tests,
+                             std::vector<std::unique_ptr<Testee>> &testees) {
+  std::vector<Test *> uncachedTests;
+  if (!reachabilityCache) {
+    for (auto &test : tests) {
+      uncachedTests.push_back(&test);
+    }
+    return uncachedTests;
+  }
+
+  reachabilityCache->load(program);
+  for (auto &test : tests) {
+    Instrumentation::Calls calls;
+    if (!reachabilityCache->restore(test, calls)) {
+      uncachedTests.push_back(&test);
+      continue;
+    }
+    auto cachedTestees =
+        instrumentation.getTestees(calls, test, filter, config.maxDistance);
+    /// The test body is left out, as it is for the tests that run
+    for (size_t index = 1; index < cachedTestees.size(); index++) {
+      testees.push_back(std::move(cachedTestees[index]));
+    }
+  }
+
+  Logger::info() << "Reused the calls of "
+                 << tests.size() - uncachedTests.size() << " of "
+                 << tests.size() << " tests\n";
+  return uncachedTests;
+}
+
+/// How many functions the search may be ahead of a worker of the junk
+/// detection
+static const size_t JunkDetectionQueueCapacity = 256;
+
+/// The junk detection does not wait for the search to finish: the points
+/// are streamed to the detectors as they are found, so that the detection
+/// of the points of one function overlaps with the search in the others.
+/// The testees are searched grouped by source file, so that the points of
+/// a file reach the detectors together and its AST is only needed for a
+/// while, then the points are put back in the order of the testees.
+/// With helper processes, the detection waits for the search instead: the
+/// helpers are forked with every point there is.
 std::vector<MutationPoint *>
-Driver::filterOutJunkMutations(std::vector<MutationPoint *> mutationPoints) {
+Driver::searchMutationPoints(std::vector<MergedTestee> &testees) {
+  if (!config.junkDetectionEnabled) {
+    return mutationsFinder.getMutationPoints(program, testees, filter);
+  }
+  if (config.parallelization.junkDetectionProcesses > 0) {
+    return detectJunkInProcesses(testees);
+  }
+
+  std::unordered_map<const llvm::Function *, size_t> testeeIndices;
+  testeeIndices.reserve(testees.size());
+  for (size_t index = 0; index < testees.size(); index++) {
+    testeeIndices[testees[index].getTesteeFunction()] = index;
+  }
+  std::stable_sort(testees.begin(), testees.end(),
+                   [](const MergedTestee &lhs, const MergedTestee &rhs) {
+                     return lhs.getTesteeFunction()
+                                ->getParent()
+                                ->getSourceFileName() <
+                            rhs.getTesteeFunction()
+                                ->getParent()
+                                ->getSourceFileName();
+                   });
+
+  /// The points come from the modules of the testees
+  std::set<std::string> sourceFiles;
+  for (auto &testee : testees) {
+    sourceFiles.insert(
+        testee.getTesteeFunction()->getParent()->getSourceFileName());
+  }
+  junkDetector.prepare(
+      std::vector<std::string>(sourceFiles.begin(), sourceFiles.end()),
+      config.parallelization.workers);
+
+  /// A worker owns the files whose points it gets, it is the only one to
+  /// use their ASTs and their cached verdicts
+  MutationPointStream queue(config.parallelization.workers,
+                            JunkDetectionQueueCapacity);
+  std::vector<JunkDetectionTask> tasks;
+  tasks.reserve(config.parallelization.workers);
+  for (int i = 0; i < config.parallelization.workers; i++) {
+    tasks.emplace_back(junkDetector);
+  }
+
   std::vector<MutationPoint *> nonJunkMutationPoints;
-  if (config.junkDetectionEnabled) {
-    std::vector<JunkDetectionTask> tasks;
-    tasks.reserve(config.parallelization.workers);
-    for (int i = 0; i < config.parallelization.workers; i++) {
-      tasks.emplace_back(junkDetector);
-    }
-    TaskExecutor<JunkDetectionTask> mutantRunner(
-        "Filtering out junk mutations", mutationPoints, nonJunkMutationPoints,
-        std::move(tasks));
-    mutantRunner.execute();
-  } else {
-    mutationPoints.swap(nonJunkMutationPoints);
+  StreamingTaskExecutor<JunkDetectionTask> junkFilter(
+      "Filtering out junk mutations", queue, nonJunkMutationPoints,
+      std::move(tasks));
+  junkFilter.start();
+  auto mutationPoints =
+      mutationsFinder.getMutationPoints(program, testees, filter, &queue);
+  queue.close();
+
+  /// The detection only drops points: the modules it leaves as they are
+  /// get the objects of the points found
+  std::set<MullModule *> mutatedModules;
+  for (auto point : mutationPoints) {
+    mutatedModules.insert(point->getOriginalModule());
+  }
+  for (auto module : mutatedModules) {
+    toolchain.cache().prefetchObjects(
+        *module, toolchain.codegenPartitions(*module), false);
   }
 
+  junkFilter.wait();
+  metrics.addWorkersMetrics(junkFilter.getName(),
+                            junkFilter.getWorkersMetrics());
+  metrics.addMemoryUsage(junkFilter.getMemoryUsage());
+  metrics.setJunkDetectionMetrics(junkDetector.getMetrics());
+
+  /// The detectors finish in any order, the points of a testee keep the
+  /// search order
+  std::unordered_map<const MutationPoint *, std::pair<size_t, size_t>> indices;
+  indices.reserve(mutationPoints.size());
+  for (size_t index = 0; index < mutationPoints.size(); index++) {
+    auto point = mutationPoints[index];
+    indices[point] =
+        std::make_pair(testeeIndices[point->getOriginalFunction()], index);
+  }
+  std::sort(nonJunkMutationPoints.begin(), nonJunkMutationPoints.end(),
+            [&](const MutationPoint *lhs, const MutationPoint *rhs) {
+              return indices[lhs] < indices[rhs];
+            });
+
   return nonJunkMutationPoints;
 }
 
-std::vector<std::unique_ptr<MutationResult>>
-Driver::runMutations(std::vector<MutationPoint *> &mutationPoints) {
+std::vector<MutationPoint *>
+Driver::detectJunkInProcesses(std::vector<MergedTestee> &testees) {
+  auto mutationPoints =
+      mutationsFinder.getMutationPoints(program, testees, filter);
+  const int processes = config.parallelization.junkDetectionProcesses;
+  Logger::info() << "Filtering out junk mutations in " << processes
+                 << " processes\n";
+
+  /// The helpers would write the entries once more otherwise
+  toolchain.cache().flush();
+  JunkDetectionMetrics junkDetectionMetrics;
+  auto nonJunkMutationPoints = mull::detectJunkInProcesses(
+      junkDetector, mutationPoints, processes, junkDetectionMetrics);
+  metrics.setJunkDetectionMetrics(junkDetectionMetrics);
+
+  std::set<MullModule *> mutatedModules;
+  for (auto point : nonJunkMutationPoints) {
+    mutatedModules.insert(point->getOriginalModule());
+  }
+  for (auto module : mutatedModules) {
+    toolchain.cache().prefetchObjects(
+        *module, toolchain.codegenPartitions(*module), false);
+  }
+  return nonJunkMutationPoints;
+}
+
+MutationResultTable
+Driver::runMutations(std::vector<MutationPoint *> &mutationPoints,
+                     std::vector<Test> &tests) {
   if (mutationPoints.empty()) {
-    return std::vector<std::unique_ptr<MutationResult>>();
+    return MutationResultTable();
   }
 
   if (config.dryRunEnabled) {
-    return dryRunMutations(mutationPoints);
+    auto mutationResults = dryRunMutations(mutationPoints, tests);
+    for (auto reporter : streamingReporters) {
+      for (auto mutationResult : mutationResults) {
+        reporter->reportMutationResult(mutationResult);
+      }
+    }
+    return mutationResults;
+  }
+
+  if (!checkpoint && !previousResults) {
+    return normalRunMutations(mutationPoints, tests);
+  }
+
+  MutationResultTable mutationResults;
+  auto pendingPoints = mutationPoints;
+  if (checkpoint) {
+    pendingPoints = resumeCompletedMutants(pendingPoints, mutationResults);
+  }
+  if (previousResults) {
+    pendingPoints = reusePreviousResults(pendingPoints, mutationResults);
+  }
+  if (!pendingPoints.empty()) {
+    auto pendingResults = normalRunMutations(pendingPoints, tests);
+    mutationResults.append(pendingResults);
+  }
+  mutationResults.restoreMutantsOrder(mutationPoints);
+  return mutationResults;
+}
+
+/// The modules forget the mutants left out, so that they are neither cloned
+/// nor compiled
+void Driver::retainMutationPoints(const std::vector<MutationPoint *> &points) {
+  std::unordered_map<const MullModule *, std::vector<MutationPoint *>>
+      modulePoints;
+  for (auto point : points) {
+    modulePoints[point->getOriginalModule()].push_back(point);
+  }
+  for (auto &module : program.modules()) {
+    module->retainMutations(modulePoints[module.get()]);
+  }
+}
+
+std::vector<MutationPoint *>
+Driver::sampleMutationPoints(const std::vector<MutationPoint *> &points) {
+  MutantSampler sampler(config);
+  auto sampled = sampler.sample(points);
+  retainMutationPoints(sampled);
+
+  Logger::info() << "Sampled " << sampled.size() << " of " << points.size()
+                 << " mutants ("
+                 << samplingStrategyToString(config.sampling.strategy)
+                 << ")\n";
+  return sampled;
+}
+
+std::vector<MutationPoint *>
+Driver::shardMutationPoints(const std::vector<MutationPoint *> &points) {
+  auto shard = shardMutants(points, config.shard.index, config.shard.count);
+  retainMutationPoints(shard);
+
+  Logger::info() << "Shard " << config.shard.index << " of "
+                 << config.shard.count << " runs " << shard.size() << " of "
+                 << points.size() << " mutants\n";
+  return shard;
+}
+
+/// Only the results of the mutants that actually ran are worth reusing
+static bool isReusable(const ExecutionResult &result) {
+  return result.status != ExecutionStatus::Invalid &&
+         result.status != ExecutionStatus::DryRun;
+}
+
+/// A mutant changed if its line did, if its function did, or if the tests
+/// that reach it did: some other tests reach it now, or one of them is
+/// defined in a changed file
+std::vector<MutationPoint *> Driver::reusePreviousResults(
+    const std::vector<MutationPoint *> &mutationPoints,
+    MutationResultTable &results) {
+  /// The location of a test is only looked at once
+  TestSet checkedTests;
+  TestSet changedTests;
+  auto testChanged = [&](const Test *test) {
+    if (!changedLines) {
+      return false;
+    }
+    if (checkedTests.insert(test->getId()) &&
+        changedLines->touches(test->getSourceLocation())) {
+      changedTests.insert(test->getId());
+    }
+    return changedTests.contains(test->getId());
+  };
+
+  std::vector<MutationPoint *> changedPoints;
+  for (auto point : mutationPoints) {
+    auto &reachableTests = point->getReachableTests();
+    auto stored = previousResults->find(*point);
+    bool reusable = stored && !stored->functionHash.empty() &&
+                    stored->functionHash == point->getFunctionHash() &&
+                    stored->results.size() == reachableTests.size() &&
+                    !(changedLines &&
+                      changedLines->contains(point->getSourceLocation()));
+    for (size_t index = 0; reusable && index < reachableTests.size();
+         index++) {
+      auto test = reachableTests[index].first;
+      auto result = stored->results.find(test->getUniqueIdentifier());
+      reusable = result != stored->results.end() &&
+                 isReusable(result->second) && !testChanged(test);
+    }
+    if (!reusable) {
+      changedPoints.push_back(point);
+      continue;
+    }
+
+    for (auto reachableTest : reachableTests) {
+      auto test = reachableTest.first;
+      auto result = stored->results.at(test->getUniqueIdentifier());
+      outputStore.retain(result);
+      if (killMatrix) {
+        killMatrix->set(*point, *test, result.status);
+      }
+      MutationResult mutationResult(result, point, reachableTest.second, test);
+      results.add(mutationResult);
+      for (auto reporter : streamingReporters) {
+        reporter->reportMutationResult(mutationResult);
+      }
+    }
+  }
+
+  Logger::info() << "Reused the results of "
+                 << mutationPoints.size() - changedPoints.size()
+                 << " mutants from the previous run, " << changedPoints.size()
+                 << " mutants changed\n";
+  return changedPoints;
+}
+
+/// A mutant is complete once every test that reaches it has a result: the
+/// interrupted run may have died in the middle of one. The modules keep the
+/// mutants that completed, the cached objects are found by the mutants of
+/// their module, so the modules the interrupted run compiled are not
+/// compiled again.
+std::vector<MutationPoint *> Driver::resumeCompletedMutants(
+    const std::vector<MutationPoint *> &mutationPoints,
+    MutationResultTable &results) {
+  std::vector<MutationPoint *> pendingPoints;
+  for (auto point : mutationPoints) {
+    auto &reachableTests = point->getReachableTests();
+    auto stored = checkpoint->find(*point);
+    bool completed = stored && stored->size() == reachableTests.size();
+    for (size_t index = 0; completed && index < reachableTests.size();
+         index++) {
+      auto result =
+          stored->find(reachableTests[index].first->getUniqueIdentifier());
+      completed = result != stored->end() && isReusable(result->second);
+    }
+    if (!completed) {
+      pendingPoints.push_back(point);
+      continue;
+    }
+
+    for (auto reachableTest : reachableTests) {
+      auto test = reachableTest.first;
+      auto result = stored->at(test->getUniqueIdentifier());
+      outputStore.retain(result);
+      if (killMatrix) {
+        killMatrix->set(*point, *test, result.status);
+      }
+      MutationResult mutationResult(result, point, reachableTest.second, test);
+      results.add(mutationResult);
+      for (auto reporter : streamingReporters) {
+        reporter->reportMutationResult(mutationResult);
+      }
+    }
+  }
+
+  Logger::info() << "Resumed " << mutationPoints.size() - pendingPoints.size()
+                 << " completed mutants from " << config.resumePath << ", "
+                 << pendingPoints.size() << " mutants left to run\n";
+  return pendingPoints;
+}
+
+void Driver::copyDuplicateResults(
+    const std::unordered_map<MutationPoint *, MutationPoint *> &duplicates,
+    MutationResultTable &results) {
+  std::unordered_map<const MutationPoint *, std::vector<size_t>>
+      representativeRows;
+  for (size_t row = 0; row < results.size(); row++) {
+    representativeRows[results.getMutationPoint(row)].push_back(row);
   }
 
-  return normalRunMutations(mutationPoints);
+  for (auto &pair : duplicates) {
+    if (killMatrix) {
+      killMatrix->copyRow(*pair.second, *pair.first);
+    }
+    /// The outputs are shared with the results of the representative
+    for (auto row : representativeRows[pair.second]) {
+      MutationResult mutationResult(results.getExecutionResult(row),
+                                    pair.first,
+                                    results.getMutationDistance(row),
+                                    results.getTest(row));
+      results.add(mutationResult);
+      for (auto reporter : streamingReporters) {
+        reporter->reportMutationResult(mutationResult);
+      }
+    }
+  }
 }
 
 #pragma mark -
 
-std::vector<std::unique_ptr<MutationResult>>
-Driver::dryRunMutations(const std::vector<MutationPoint *> &mutationPoints) {
-  std::vector<std::unique_ptr<MutationResult>> mutationResults;
+/// Template instantiations and inline functions are defined in every
+/// module that uses them. The mutants of the copies of such a function are
+/// the same when the bodies are: the first one is canonical and runs every
+/// test any of them reaches, the others take its results.
+static std::vector<MutationPoint *> dedupeOdrMutants(
+    const std::vector<MutationPoint *> &mutationPoints,
+    std::unordered_map<MutationPoint *, MutationPoint *> &duplicates) {
+  std::unordered_map<std::string, MutationPoint *> canonicals;
+  std::vector<MutationPoint *> dedupedPoints;
+  for (auto point : mutationPoints) {
+    auto function = point->getOriginalFunction();
+    if (!function ||
+        !(function->hasLinkOnceODRLinkage() || function->hasWeakODRLinkage())) {
+      dedupedPoints.push_back(point);
+      continue;
+    }
+    auto address = point->getAddress();
+    auto &location = point->getSourceLocation();
+    auto key = function->getName().str() + " " + point->getFunctionHash() +
+               " " + std::to_string(address.getBBIndex()) + " " +
+               std::to_string(address.getIIndex()) + " " +
+               point->getMutator()->getUniqueIdentifier() + " " +
+               std::to_string(location.file) + ":" +
+               std::to_string(location.line) + ":" +
+               std::to_string(location.column);
+    auto inserted = canonicals.insert(std::make_pair(key, point));
+    if (inserted.second) {
+      dedupedPoints.push_back(point);
+      continue;
+    }
+    auto canonical = inserted.first->second;
+    point->setCanonical(canonical);
+    duplicates[point] = canonical;
+    for (auto reachableTest : point->getReachableTests()) {
+      if (!canonical->getReachableTests().contains(*reachableTest.first)) {
+        canonical->addReachableTest(reachableTest.first, reachableTest.second);
+      }
+    }
+  }
+
+  if (!duplicates.empty()) {
+    Logger::info() << "Deduplicated " << duplicates.size()
+                   << " mutants of the copies of ODR functions\n";
+  }
+  return dedupedPoints;
+}
+
+/// The mutants of a function that are canonicalized the same are
+/// duplicates: only the first one runs, the others take its results.
+/// The equivalent mutants do not run at all.
+static std::vector<MutationPoint *> pruneEquivalentMutants(
+    const std::vector<MutationPoint *> &mutationPoints,
+    std::unordered_map<MutationPoint *, MutationPoint *> &duplicates) {
+  std::map<std::pair<const Function *, std::string>, MutationPoint *>
+      representatives;
+  std::vector<MutationPoint *> prunedPoints;
+  size_t equivalent = 0;
+  const size_t previousDuplicates = duplicates.size();
+  for (auto point : mutationPoints) {
+    if (point->isEquivalent()) {
+      equivalent++;
+      continue;
+    }
+    if (point->getMutantHash().empty()) {
+      prunedPoints.push_back(point);
+      continue;
+    }
+    auto key = std::make_pair(point->getOriginalFunction(),
+                              point->getMutantHash());
+    auto inserted = representatives.insert(std::make_pair(key, point));
+    if (inserted.second) {
+      prunedPoints.push_back(point);
+    } else {
+      duplicates[point] = inserted.first->second;
+    }
+  }
+
+  Logger::info() << "Pruned " << equivalent << " equivalent and "
+                 << duplicates.size() - previousDuplicates
+                 << " duplicate mutants\n";
+  return prunedPoints;
+}
+
+static void removeEquivalentMutants(std::vector<MutationPoint *> &points) {
+  points.erase(std::remove_if(points.begin(), points.end(),
+                              [](MutationPoint *point) {
+                                return point->isEquivalent();
+                              }),
+               points.end());
+}
+
+/// The entries of the files and the mutators past the limit are left out
+static const size_t ReportedCostEntries = 5;
+
+static std::string wallTimeRange(const RunCost &wallTime) {
+  auto range = formatDuration(wallTime.most);
+  if (wallTime.least != wallTime.most) {
+    range = formatDuration(wallTime.least) + " to " + range;
+  }
+  return range;
+}
+
+static void reportCostEstimate(const CostEstimate &estimate, size_t limit) {
+  auto overall = wallTimeRange(estimate.wallTime(estimate.overall));
+  Logger::info() << "Estimated mutant execution on " << estimate.workers
+                 << " workers: " << overall << " for "
+                 << estimate.overall.mutants << " mutants\n";
+  auto reportEntries = [&](const char *title,
+                           const std::vector<CostEstimate::Entry> &entries) {
+    Logger::info() << "  by " << title << ":\n";
+    for (size_t i = 0; i < entries.size() && i < limit; i++) {
+      auto &entry = entries[i];
+      Logger::info() << "    " << wallTimeRange(estimate.wallTime(entry))
+                     << ", " << entry.mutants << " mutants: " << entry.name
+                     << "\n";
+    }
+    if (entries.size() > limit) {
+      Logger::info() << "    and " << entries.size() - limit << " more\n";
+    }
+  };
+  reportEntries("file", estimate.files);
+  reportEntries("mutator", estimate.mutators);
+}
+
+/// The estimate of every file and mutator is reported, the dry run is there
+/// to see where the time would go
+MutationResultTable
+Driver::dryRunMutations(const std::vector<MutationPoint *> &mutationPoints,
+                        const std::vector<Test> &tests) {
+  MutationResultTable mutationResults;
+
+  CostModel model(config, tests);
+  reportCostEstimate(
+      estimateCost(model, mutationPoints,
+                   config.parallelization.mutantExecutionWorkers),
+      std::numeric_limits<size_t>::max());
 
   std::vector<DryRunMutantExecutionTask> tasks;
   tasks.reserve(config.parallelization.workers);
@@ -201,65 +1186,509 @@ Driver::dryRunMutations(const std::vector<MutationPoint *> &mutationPoints) {
       std::move(tasks));
   mutantRunner.execute();
   metrics.endMutantsExecution();
+  metrics.addWorkersMetrics(mutantRunner.getName(),
+                            mutantRunner.getWorkersMetrics());
+  metrics.addMemoryUsage(mutantRunner.getMemoryUsage());
 
   return mutationResults;
 }
 
-std::vector<std::unique_ptr<MutationResult>>
-Driver::normalRunMutations(const std::vector<MutationPoint *> &mutationPoints) {
-  std::vector<std::string> mutatedFunctions;
+MutationResultTable
+Driver::normalRunMutations(const std::vector<MutationPoint *> &mutationPoints,
+                           std::vector<Test> &tests) {
+  /// The schemata activate a mutant by the id of its own module
+  std::unordered_map<MutationPoint *, MutationPoint *> duplicates;
+  auto runnablePoints = config.mutantSchemataEnabled
+                            ? mutationPoints
+                            : dedupeOdrMutants(mutationPoints, duplicates);
 
-  SingleTaskExecutor prepareMutationsTask("Preparing mutations", [&]() {
-    for (auto &module : program.modules()) {
-      auto functions = module->prepareMutations();
-      for (auto &name : functions) {
-        mutatedFunctions.push_back(name);
+  if (config.testOrder == TestOrder::KillRate && !previousResults) {
+    Logger::warn() << "Ordering the tests by kill rate requires the previous "
+                      "results, the tests run by distance\n";
+    prioritizeReachableTests(mutationPoints, TestOrder::Distance, {});
+  } else if (config.testOrder == TestOrder::KillRate) {
+    prioritizeReachableTests(mutationPoints, config.testOrder,
+                             previousResults->getKillRates());
+  } else {
+    prioritizeReachableTests(mutationPoints, config.testOrder, {});
+  }
+
+  MutantCompilationTask::MutationPoints modulePoints;
+  for (auto point : mutationPoints) {
+    modulePoints[point->getOriginalModule()].push_back(point);
+  }
+
+  /// With the guarded instrumentation the modules without mutations are
+  /// not compiled again, their instrumented objects are linked instead
+  std::vector<object::ObjectFile *> reusedObjectFiles;
+  if (instrumentation.isGuarded()) {
+    reusedObjectFiles = unmutatedInstrumentedObjectFiles(modulePoints);
+  }
+
+  /// Every module goes through preparation, mutation and compilation on its
+  /// own, there is no barrier between the modules at each of the steps.
+  /// The modules are handed out one by one, interleaved by their contexts,
+  /// so that the workers pick modules they can process at the same time.
+  MutantCompilationTask::ContextLocks contextLocks;
+  std::vector<std::vector<MullModule *>> contextModules;
+  std::unordered_map<const LLVMContext *, size_t> contextIndices;
+  size_t compiledModules = 0;
+  for (auto &module : program.modules()) {
+    if (instrumentation.isGuarded() && modulePoints.count(module.get()) == 0) {
+      continue;
+    }
+    auto context = &module->getModule()->getContext();
+    if (contextIndices.count(context) == 0) {
+      contextIndices[context] = contextModules.size();
+      contextModules.emplace_back();
+      contextLocks[context] = make_unique<std::mutex>();
+    }
+    contextModules[contextIndices[context]].push_back(module.get());
+    compiledModules++;
+  }
+  std::vector<MullModule *> modules;
+  for (size_t index = 0; modules.size() != compiledModules; index++) {
+    for (auto &sameContext : contextModules) {
+      if (index < sameContext.size()) {
+        modules.push_back(sameContext[index]);
       }
     }
-  });
-  prepareMutationsTask.execute();
+  }
 
-  std::vector<int> empty;
-  TaskExecutor<ApplyMutationTask> applyMutations(
-      "Applying mutations", mutationPoints, empty, {ApplyMutationTask()});
-  applyMutations.execute();
+  /// The bodies of the tests lose their debug info along with the mutants
+  if (config.mutantDebugInfo != MutantDebugInfo::Full) {
+    for (auto &test : tests) {
+      test.keepSourceLocation();
+    }
+  }
 
-  std::vector<OriginalCompilationTask> compilationTasks;
+  std::vector<MutantCompilationTask> compilationTasks;
   compilationTasks.reserve(config.parallelization.workers);
   for (int i = 0; i < config.parallelization.workers; i++) {
-    compilationTasks.emplace_back(toolchain);
+    compilationTasks.emplace_back(toolchain, config, modulePoints,
+                                  contextLocks, metrics);
   }
-  TaskExecutor<OriginalCompilationTask> mutantCompiler(
-      "Compiling original code", program.modules(), ownedObjectFiles,
-      std::move(compilationTasks));
+  metrics.beginSpan("Compile mutants");
+  TaskExecutor<MutantCompilationTask> mutantCompiler(
+      "Compiling mutants", modules, ownedObjectFiles,
+      std::move(compilationTasks), TaskDispatch::OneByOne);
+  mutantCompiler.setAutoTune(config.parallelization.autoTune);
   mutantCompiler.execute();
+  metrics.endSpan("Compile mutants");
+  metrics.addWorkersMetrics(mutantCompiler.getName(),
+                            mutantCompiler.getWorkersMetrics());
+  metrics.addMemoryUsage(mutantCompiler.getMemoryUsage());
+
+  std::vector<std::string> mutatedFunctions;
+  for (auto &module : program.modules()) {
+    auto &names = module->getTrampolineNames();
+    mutatedFunctions.insert(mutatedFunctions.end(), names.begin(),
+                            names.end());
+  }
 
   std::vector<object::ObjectFile *> objectFiles;
   for (auto &object : ownedObjectFiles) {
     objectFiles.push_back(object.getBinary());
   }
+  objectFiles.insert(objectFiles.end(), reusedObjectFiles.begin(),
+                     reusedObjectFiles.end());
   for (auto &object : program.precompiledObjectFiles()) {
     objectFiles.push_back(object.getBinary());
   }
 
-  std::vector<std::unique_ptr<MutationResult>> mutationResults;
+  MutationResultTable mutationResults;
+
+  /// Without fork every mutant is activated in the worker's own process,
+  /// so the workers cannot share one copy of the program
+  const bool shareProgram = config.sharedProgramEnabled &&
+                           config.forkEnabled && !config.forkSnapshotEnabled;
+  if (config.sharedProgramEnabled &&
+      (!config.forkEnabled || config.forkSnapshotEnabled)) {
+    Logger::warn() << "Shared program requires fork, "
+                      "each worker will load its own copy\n";
+  }
+  if (config.parallelization.childrenPerWorker > 1 &&
+      (!config.forkEnabled || config.forkServerEnabled ||
+       config.forkBatchEnabled || config.forkSnapshotEnabled)) {
+    Logger::warn() << "Several children per worker require fork without "
+                      "the fork server or batches, each worker will run one "
+                      "at a time\n";
+  }
+  if (config.directCallsEnabled &&
+      (!config.forkEnabled || config.forkSnapshotEnabled)) {
+    Logger::warn() << "Direct calls require fork without snapshots, "
+                      "the mutants will run through their trampolines\n";
+  }
+  if (config.forkSnapshotEnabled && config.lazyJITEnabled) {
+    Logger::warn() << "Snapshots require eager linking, "
+                      "every test will run in a forked child\n";
+  }
+  if (config.constructorTemplateEnabled &&
+      (!config.forkEnabled ||
+       !(config.forkServerEnabled || config.forkBatchEnabled))) {
+    Logger::warn() << "Constructor template requires the fork server or "
+                      "batches, the static constructors will run before "
+                      "every test\n";
+  }
+
+  /// A worker may fork while another one holds the lookup lock, so the
+  /// shared program is linked and resolved up front
+  JITEngine sharedJit(config.parallelJITEnabled ? JITLinking::Parallel
+                                                : JITLinking::Eager);
+  std::unique_ptr<Trampolines> sharedTrampolines;
+  if (shareProgram) {
+    metrics.beginLoadMutatedProgram(nullptr);
+    SingleTaskExecutor loadProgramTask("Loading mutated program", [&]() {
+      sharedTrampolines = make_unique<Trampolines>(mutatedFunctions);
+      testFramework.runner().loadMutatedProgram(objectFiles,
+                                                *sharedTrampolines, sharedJit);
+      sharedTrampolines->fixupOriginalFunctions(sharedJit);
+      sharedJit.resolveAllSymbols();
+    });
+    loadProgramTask.execute();
+    metrics.addMemoryUsage(loadProgramTask.getMemoryUsage());
+    metrics.endLoadMutatedProgram(nullptr);
+  }
+
+  /// The workers link the same objects, so they share one lazy index
+  std::shared_ptr<const SymbolIndex> symbolIndex;
+  if (config.lazyJITEnabled && !shareProgram) {
+    symbolIndex = std::make_shared<const SymbolIndex>(objectFiles);
+  }
+
+  std::vector<MutationPoint *> scheduledMutationPoints;
+  if (config.equivalentMutantPruningEnabled) {
+    /// The copies are not hashed, they are what their canonical points are
+    for (auto &pair : duplicates) {
+      pair.first->setEquivalent(pair.second->isEquivalent());
+    }
+    scheduledMutationPoints =
+        longestFirst(pruneEquivalentMutants(runnablePoints, duplicates));
+    /// A canonical point may be a duplicate in its own function
+    for (auto &pair : duplicates) {
+      auto representative = duplicates.find(pair.second);
+      if (representative != duplicates.end()) {
+        pair.second = representative->second;
+      }
+    }
+  } else {
+    scheduledMutationPoints = longestFirst(runnablePoints);
+  }
+  /// The results a developer acts upon stream out first, the long tail is
+  /// left to the end
+  if (config.mutantOrder == MutantOrder::Feedback) {
+    scheduledMutationPoints =
+        feedbackFirst(scheduledMutationPoints, changedLines.get(),
+                      previousResults.get());
+  }
+
+  CostModel model(config, tests);
+  auto estimate =
+      estimateCost(model, scheduledMutationPoints,
+                   size_t(config.parallelization.mutantExecutionWorkers));
+  reportCostEstimate(estimate, ReportedCostEntries);
+  auto wallTime = estimate.wallTime(estimate.overall);
+  const int64_t expectedWallTime = (wallTime.least + wallTime.most) / 2;
+
+  /// Nothing reads the IR once the mutants are compiled and the mutants to
+  /// run are known
+  if (config.releaseIREnabled) {
+    program.releaseIR();
+    for (auto &test : tests) {
+      test.releaseIR();
+    }
+    trimHeap();
+    auto heap = MemoryUsage::current();
+    const uint64_t megabyte = 1024 * 1024;
+    Logger::info() << "Released the IR of " << program.modules().size()
+                   << " modules, the heap holds "
+                   << heap.heapLive / megabyte << "MB, "
+                   << heap.heapFree / megabyte << "MB free\n";
+  }
+
+  /// The workers fork the children of the shared program from now on, a
+  /// shared program implies fork without snapshots
+  if (shareProgram && config.directCallsEnabled) {
+    sharedTrampolines->redirectEntries(sharedJit, toolchain.mangler(),
+                                       scheduledMutationPoints);
+  }
 
+  auto role = config.distributed.role;
+  int workers = config.parallelization.mutantExecutionWorkers;
+  if (config.parallelization.workerProcesses > 1 && !distributedQueue) {
+    workers = startWorkerProcesses(role);
+  }
+  /// The coordinator reports the results of the worker processes
+  const bool workerProcess =
+      !workerProcessesQueue.empty() && role == DistributedRole::Worker;
   std::vector<MutantExecutionTask> tasks;
-  tasks.reserve(config.parallelization.mutantExecutionWorkers);
-  for (int i = 0; i < config.parallelization.mutantExecutionWorkers; i++) {
-    tasks.emplace_back(*sandbox, program, testFramework.runner(), config,
-                       filter, toolchain.mangler(), objectFiles,
-                       mutatedFunctions);
+  tasks.reserve(workers);
+  for (int i = 0; i < workers; i++) {
+    tasks.emplace_back(*sandbox, outputStore, program, testFramework.runner(),
+                       config, filter, metrics, toolchain.mangler(),
+                       objectFiles, mutatedFunctions, symbolIndex,
+                       shareProgram ? &sharedJit : nullptr,
+                       sharedTrampolines.get(),
+                       workerProcess ? nullptr : &streamingReporters,
+                       killMatrix.get(),
+                       childResources ? childResources->memoryBudget()
+                                      : nullptr);
   }
+
   metrics.beginMutantsExecution();
-  TaskExecutor<MutantExecutionTask> mutantRunner(
-      "Running mutants", mutationPoints, mutationResults, std::move(tasks));
-  mutantRunner.execute();
+  bool distributed = distributedQueue &&
+                     distributedRunMutations(tasks, scheduledMutationPoints,
+                                             mutationResults, role);
+  if (workerProcess) {
+    Logger::flush();
+    llvm::outs().flush();
+    llvm::errs().flush();
+    _exit(0);
+  }
+  if (!workerProcessesQueue.empty()) {
+    stopWorkerProcesses(distributed);
+  }
+  if (!distributed && config.batchKillSize > 1) {
+    auto batches =
+        batchMutants(scheduledMutationPoints, config.batchKillSize);
+    Logger::info() << "Running " << scheduledMutationPoints.size()
+                   << " mutants in " << batches.size() << " batches\n";
+    std::vector<MutantBatchExecutionTask> batchTasks;
+    batchTasks.reserve(tasks.size());
+    for (auto &task : tasks) {
+      batchTasks.emplace_back(std::move(task));
+    }
+    TaskExecutor<MutantBatchExecutionTask> mutantRunner(
+        "Running mutant batches", batches, mutationResults,
+        std::move(batchTasks), TaskDispatch::OneByOne);
+    mutantRunner.setEstimate(expectedWallTime);
+    mutantRunner.setAutoTune(config.parallelization.autoTune);
+    mutantRunner.execute();
+    metrics.addWorkersMetrics(mutantRunner.getName(),
+                              mutantRunner.getWorkersMetrics());
+    metrics.addMemoryUsage(mutantRunner.getMemoryUsage());
+  } else if (!distributed) {
+    TaskExecutor<MutantExecutionTask> mutantRunner(
+        "Running mutants", scheduledMutationPoints, mutationResults,
+        std::move(tasks), TaskDispatch::OneByOne);
+    mutantRunner.setEstimate(expectedWallTime);
+    mutantRunner.setAutoTune(config.parallelization.autoTune);
+    mutantRunner.execute();
+    metrics.addWorkersMetrics(mutantRunner.getName(),
+                              mutantRunner.getWorkersMetrics());
+    metrics.addMemoryUsage(mutantRunner.getMemoryUsage());
+  }
   metrics.endMutantsExecution();
+  auto budget = childResources ? childResources->memoryBudget() : nullptr;
+  if (budget && budget->waits() != 0) {
+    Logger::info() << "The memory budget held back " << budget->waits()
+                   << " children and copies of the program\n";
+  }
+
+  if (!duplicates.empty()) {
+    copyDuplicateResults(duplicates, mutationResults);
+  }
+  mutationResults.restoreMutantsOrder(mutationPoints);
 
   return mutationResults;
 }
 
+/// How long a worker waits for the coordinator to publish the mutants
+static const long long SubscribeTimeoutSeconds = 24 * 60 * 60;
+
+bool Driver::distributedRunMutations(
+    std::vector<MutantExecutionTask> &tasks,
+    const std::vector<MutationPoint *> &mutationPoints,
+    MutationResultTable &results, DistributedRole role) {
+  auto &queue = *distributedQueue;
+  const bool coordinator = role == DistributedRole::Coordinator;
+  if (coordinator) {
+    std::vector<std::string> mutants;
+    for (auto point : mutationPoints) {
+      mutants.push_back(point->getUniqueIdentifier());
+    }
+    if (!queue.publish(mutants, config.distributed.chunk)) {
+      Logger::error() << "Cannot publish the mutants, running them here\n";
+      return false;
+    }
+  } else {
+    Logger::info() << "Waiting for the coordinator to publish the mutants to "
+                   << queue.getDirectory() << "\n";
+    if (!queue.subscribe(SubscribeTimeoutSeconds)) {
+      Logger::error() << "The coordinator did not publish any mutants\n";
+      return true;
+    }
+  }
+
+  /// Every node finds the mutants on its own, a node that found different
+  /// ones (e.g. with another configuration) leaves theirs to the others
+  std::unordered_map<std::string, MutationPoint *> points;
+  for (auto point : mutationPoints) {
+    points[point->getUniqueIdentifier()] = point;
+  }
+  std::vector<std::vector<MutationPoint *>> chunks;
+  size_t foreignChunks = 0;
+  for (auto &chunk : queue.getChunks()) {
+    chunks.emplace_back();
+    for (auto &mutant : chunk) {
+      auto found = points.find(mutant);
+      if (found == points.end()) {
+        chunks.back().clear();
+        foreignChunks++;
+        break;
+      }
+      chunks.back().push_back(found->second);
+    }
+  }
+  if (foreignChunks != 0) {
+    Logger::warn() << foreignChunks << " of " << chunks.size()
+                   << " chunks have mutants this node did not find, "
+                      "they are left to the others\n";
+  }
+
+  std::vector<int> workers(tasks.size(), 0);
+  std::vector<DistributedMutantExecutionTask> distributedTasks;
+  distributedTasks.reserve(tasks.size());
+  for (auto &task : tasks) {
+    distributedTasks.emplace_back(std::move(task), queue, chunks);
+  }
+  TaskExecutor<DistributedMutantExecutionTask> mutantRunner(
+      "Running distributed mutants", workers, results,
+      std::move(distributedTasks), TaskDispatch::OneByOne);
+  mutantRunner.execute();
+  metrics.addWorkersMetrics(mutantRunner.getName(),
+                            mutantRunner.getWorkersMetrics());
+  metrics.addMemoryUsage(mutantRunner.getMemoryUsage());
+
+  if (!coordinator) {
+    return true;
+  }
+
+  size_t remoteResults = 0;
+  for (size_t chunk = 0; chunk < chunks.size(); chunk++) {
+    if (queue.completedHere(chunk)) {
+      continue;
+    }
+    std::vector<StoredMutationResult> stored;
+    if (!queue.readResults(chunk, stored)) {
+      Logger::error() << "Cannot read the results of chunk " << chunk
+                      << "\n";
+      continue;
+    }
+    for (auto &storedResult : stored) {
+      auto point = points.find(storedResult.mutant);
+      if (point == points.end()) {
+        continue;
+      }
+      for (auto reachableTest : point->second->getReachableTests()) {
+        if (reachableTest.first->getUniqueIdentifier() != storedResult.test) {
+          continue;
+        }
+        if (killMatrix) {
+          killMatrix->set(*point->second, *reachableTest.first,
+                          storedResult.result.status);
+        }
+        MutationResult mutationResult(storedResult.result, point->second,
+                                      reachableTest.second,
+                                      reachableTest.first);
+        results.add(mutationResult);
+        for (auto reporter : streamingReporters) {
+          reporter->reportMutationResult(mutationResult);
+        }
+        remoteResults++;
+        break;
+      }
+    }
+  }
+  Logger::info() << "Collected " << remoteResults
+                 << " results of the other nodes\n";
+  return true;
+}
+
+/// The queue is a directory of its own, in shared memory when there is
+/// some: the processes exchange their chunks through the page cache. This
+/// process forks the others once everything is loaded, so that they share
+/// its memory, coordinates them and runs its share of the workers as well.
+int Driver::startWorkerProcesses(DistributedRole &role) {
+  const int processes = config.parallelization.workerProcesses;
+  const int workers = config.parallelization.mutantExecutionWorkers;
+  const int workersPerProcess = std::max(workers / processes, 1);
+
+  SmallString<128> directory;
+  if (sys::fs::is_directory("/dev/shm")) {
+    directory = "/dev/shm";
+  } else {
+    sys::path::system_temp_directory(true, directory);
+  }
+  sys::path::append(directory, "mull-workers-" + std::to_string(getpid()));
+  if (auto error = sys::fs::create_directories(directory)) {
+    Logger::warn() << "Cannot create the queue of the worker processes in "
+                   << directory << ", the mutants run in this process: "
+                   << error.message() << "\n";
+    return workers;
+  }
+  workerProcessesQueue = directory.str().str();
+  distributedQueue = make_unique<DistributedQueue>(workerProcessesQueue,
+                                                   config.distributed.lease);
+  /// A queue left behind by a process with the same pid
+  distributedQueue->clear();
+
+  /// The children would write what is buffered once more otherwise
+  toolchain.cache().flush();
+  Logger::flush();
+  llvm::outs().flush();
+  llvm::errs().flush();
+  for (int index = 1; index < processes; index++) {
+    const pid_t pid = fork();
+    if (pid == -1) {
+      Logger::warn() << "Cannot fork a worker process: " << strerror(errno)
+                     << "\n";
+      break;
+    }
+    if (pid == 0) {
+      ThreadPool::shared().forgetThreads();
+      workerProcesses.clear();
+      /// The queue names the node after its process
+      distributedQueue = make_unique<DistributedQueue>(
+          workerProcessesQueue, config.distributed.lease);
+      role = DistributedRole::Worker;
+      return workersPerProcess;
+    }
+    workerProcesses.push_back(pid);
+  }
+
+  role = DistributedRole::Coordinator;
+  const int workersHere = std::max(
+      workers - workersPerProcess * int(workerProcesses.size()), 1);
+  Logger::info() << "Running the mutants in " << workerProcesses.size() + 1
+                 << " processes, " << workersHere << " workers in this one and "
+                 << workersPerProcess << " in each of the others\n";
+  return workersHere;
+}
+
+void Driver::stopWorkerProcesses(bool finished) {
+  size_t failed = 0;
+  for (auto pid : workerProcesses) {
+    if (!finished) {
+      kill(pid, SIGKILL);
+    }
+    int status = 0;
+    while (waitpid(pid, &status, 0) == -1 && errno == EINTR) {
+    }
+    if (finished && !(WIFEXITED(status) && WEXITSTATUS(status) == 0)) {
+      failed++;
+    }
+  }
+  if (failed != 0) {
+    Logger::warn() << failed << " worker processes did not exit normally, "
+                      "their chunks ran again in the others\n";
+  }
+  workerProcesses.clear();
+  distributedQueue.reset();
+  sys::fs::remove_directories(workerProcessesQueue);
+  workerProcessesQueue.clear();
+}
+
 std::vector<llvm::object::ObjectFile *> Driver::AllInstrumentedObjectFiles() {
   std::vector<llvm::object::ObjectFile *> objects;
 
@@ -274,23 +1703,144 @@ std::vector<llvm::object::ObjectFile *> Driver::AllInstrumentedObjectFiles() {
   return objects;
 }
 
+std::vector<llvm::object::ObjectFile *>
+Driver::unmutatedInstrumentedObjectFiles(
+    const MutantCompilationTask::MutationPoints &modulePoints) {
+  std::vector<llvm::object::ObjectFile *> objects;
+
+  size_t offset = 0;
+  for (auto &module : program.modules()) {
+    size_t count = toolchain.codegenPartitions(*module);
+    if (modulePoints.count(module.get()) == 0) {
+      for (size_t index = offset; index < offset + count; index++) {
+        objects.push_back(instrumentedObjectFiles[index].getBinary());
+      }
+    }
+    offset += count;
+  }
+
+  return objects;
+}
+
+/// Bumped whenever the calls recorded for the same functions change
+static const char *const ReachabilityCacheVersion = "calls-1";
+
+static InstrumentationMode instrumentationMode(const Configuration &config) {
+  if (staticReachability(config)) {
+    return InstrumentationMode::Static;
+  }
+  if (config.coverageInstrumentationEnabled) {
+    return InstrumentationMode::Coverage;
+  }
+  if (config.inlineInstrumentationEnabled) {
+    return InstrumentationMode::InlineCallbacks;
+  }
+  return InstrumentationMode::Callbacks;
+}
+
 Driver::Driver(const Configuration &config, Program &program,
                TestFramework &testFramework, Toolchain &t, Filter &f,
                MutationsFinder &mutationsFinder, Metrics &metrics,
                JunkDetector &junkDetector)
     : config(config), program(program), testFramework(testFramework),
       toolchain(t), filter(f), mutationsFinder(mutationsFinder),
-      instrumentation(), metrics(metrics), junkDetector(junkDetector) {
+      instrumentation(instrumentationMode(config),
+                      config.guardedInstrumentationEnabled,
+                      config.blockCoverageEnabled,
+                      config.loopBudget > 0 && config.forkEnabled),
+      metrics(metrics),
+      junkDetector(junkDetector),
+      outputStore(config.outputRetention,
+                  size_t(std::max(config.outputTailBytes, 0))),
+      warm(false), compiled(false) {
+  SlabMemoryManager::setHugePages(config.jitHugePagesEnabled);
+  mutationsFinder.setBlockCoverage(instrumentation.getBlockCoverage());
+  instrumentation.setFilter(&filter);
+  if (config.boundedCallTreeEnabled) {
+    instrumentation.setMaxDistance(config.maxDistance);
+  }
 
-  if (config.forkEnabled) {
-    this->sandbox = new ForkProcessSandbox();
+  const auto outputLimit = size_t(std::max(config.outputLimit, 0));
+  const auto keepPassedOutput = !config.dropPassedOutput;
+  auto &limits = config.childResources;
+  if (limits.addressSpace > 0 || limits.cpuTime > 0 || limits.openFiles > 0 ||
+      !limits.cgroupRoot.empty() || limits.memoryBudget > 0) {
+    childResources = make_unique<ChildResources>(limits);
+  }
+  const long long stallTimeout = config.stallTimeout;
+  if (config.forkEnabled && config.forkServerEnabled) {
+    this->sandbox = new ForkServerProcessSandbox(
+        outputLimit, keepPassedOutput, childResources.get(),
+        config.perfCountersEnabled, stallTimeout);
+  } else if (config.forkEnabled && config.forkBatchEnabled) {
+    this->sandbox = new BatchProcessSandbox(
+        outputLimit, keepPassedOutput, childResources.get(),
+        config.perfCountersEnabled, stallTimeout);
+  } else if (config.forkEnabled && config.forkSnapshotEnabled &&
+             !config.lazyJITEnabled) {
+    this->sandbox = new SnapshotProcessSandbox(
+        outputLimit, keepPassedOutput, childResources.get(),
+        config.perfCountersEnabled, stallTimeout);
+  } else if (config.forkEnabled) {
+    this->sandbox = new ForkProcessSandbox(
+        outputLimit, keepPassedOutput, childResources.get(),
+        config.perfCountersEnabled, stallTimeout);
   } else {
     this->sandbox = new NullProcessSandbox();
   }
+  if (config.loopBudget > 0 && !config.forkEnabled) {
+    Logger::warn() << "Loop budget requires fork, the mutants that loop "
+                      "will run until the timeout\n";
+  }
 
   if (config.diagnostics != Diagnostics::None) {
     this->diagnostics = new NormalIDEDiagnostics(config.diagnostics);
   } else {
     this->diagnostics = new NullIDEDiagnostics();
   }
+
+  if (config.distributed.role != DistributedRole::None) {
+    distributedQueue = make_unique<DistributedQueue>(
+        config.distributed.directory, config.distributed.lease);
+  }
+
+  if (config.cacheEnabled) {
+    testTimings = make_unique<TestTimings>(config.cacheDirectory);
+  }
+  if (config.programLibraryEnabled && !config.cacheEnabled) {
+    Logger::warn() << "Program library requires the cache, the program is "
+                      "linked in memory\n";
+  }
+  if (config.mutationSearchCacheEnabled && !config.cacheEnabled) {
+    Logger::warn() << "Mutation search cache requires the cache, every "
+                      "function will be searched\n";
+  }
+  if (config.testSearchCacheEnabled && !config.cacheEnabled) {
+    Logger::warn() << "Test search cache requires the cache, every module "
+                      "will be searched for tests\n";
+  }
+  if (config.reachabilitySamplePeriod > 0 && config.lazyJITEnabled) {
+    Logger::warn() << "The calls cannot be sampled with the lazy JIT, the "
+                      "reachability is static\n";
+  } else if (config.reachabilitySamplePeriod > 0) {
+    instrumentation.enableSamples();
+  }
+  if (config.reachabilityCacheEnabled && staticReachability(config)) {
+    Logger::warn() << "Reachability cache has no calls to reuse with the "
+                      "static reachability, every test will run\n";
+  } else if (config.reachabilityCacheEnabled && config.cacheEnabled) {
+    reachabilityCache = make_unique<ReachabilityCache>(
+        config.cacheDirectory,
+        std::string(ReachabilityCacheVersion) + instrumentation.cacheSuffix());
+  } else if (config.reachabilityCacheEnabled) {
+    Logger::warn() << "Reachability cache requires the cache, every test "
+                      "will run\n";
+  }
+
+  if (!config.metricsEndpoint.empty()) {
+    metricsServer = make_unique<MetricsServer>(config.metricsEndpoint);
+    if (!metricsServer->start()) {
+      metricsServer.reset();
+    }
+  }
 }
@@ -0,0 +1,156 @@
+#include "mull/EmbeddedBitcode.h"
+
+#include <llvm/Object/Binary.h>
+#include <llvm/Object/ObjectFile.h>
+
+#include <algorithm>
+#include <cstdint>
+
+using namespace llvm;
+using namespace mull;
+
+static const StringRef BitcodeMagic("BC\xC0\xDE", 4);
+static const StringRef WrapperMagic("\xDE\xC0\x17\x0B", 4);
+
+/// ENTER_SUBBLOCK, the only abbreviation the top level of a file consists of
+static const uint64_t EnterSubblock = 1;
+
+namespace {
+
+/// Reads the bitstream least significant bit first, as LLVM writes it
+class BitReader {
+public:
+  BitReader(StringRef data, size_t byteOffset)
+      : data(data), bit(byteOffset * 8), overflow(false) {}
+
+  uint64_t read(unsigned width) {
+    uint64_t value = 0;
+    for (unsigned i = 0; i < width; i++, bit++) {
+      if (bit / 8 >= data.size()) {
+        overflow = true;
+        return 0;
+      }
+      uint64_t byte = static_cast<unsigned char>(data[bit / 8]);
+      value |= ((byte >> (bit % 8)) & 1) << i;
+    }
+    return value;
+  }
+
+  uint64_t readVBR(unsigned width) {
+    uint64_t continuation = uint64_t(1) << (width - 1);
+    uint64_t value = 0;
+    for (unsigned shift = 0; shift < 64; shift += width - 1) {
+      uint64_t chunk = read(width);
+      value |= (chunk & (continuation - 1)) << shift;
+      if ((chunk & continuation) == 0 || overflow) {
+        break;
+      }
+    }
+    return value;
+  }
+
+  void alignTo32() { bit = (bit + 31) / 32 * 32; }
+
+  size_t byteOffset() const { return bit / 8; }
+  bool failed() const { return overflow; }
+
+private:
+  StringRef data;
+  uint64_t bit;
+  bool overflow;
+};
+
+} // namespace
+
+static uint32_t read32(StringRef data, size_t offset) {
+  uint32_t value = 0;
+  for (int i = 3; i >= 0; i--) {
+    value = (value << 8) | static_cast<unsigned char>(data[offset + i]);
+  }
+  return value;
+}
+
+/// What may follow a bitcode file in a section: padding, then the next file
+static bool isFileBoundary(StringRef data, size_t offset) {
+  StringRef rest = data.substr(offset).ltrim(StringRef("\0", 1));
+  return rest.empty() || rest.startswith(BitcodeMagic) ||
+         rest.startswith(WrapperMagic);
+}
+
+/// The size of the bitcode file the data starts with, 0 if it is malformed.
+/// Every top level block starts on a 32 bit boundary, the file ends where
+/// something else than a block starts, which must be a file boundary.
+static size_t bitcodeFileSize(StringRef data) {
+  if (data.startswith(WrapperMagic)) {
+    if (data.size() < 16) {
+      return 0;
+    }
+    uint64_t size = uint64_t(read32(data, 8)) + read32(data, 12);
+    return size <= data.size() ? size : 0;
+  }
+
+  size_t offset = BitcodeMagic.size();
+  while (offset + 4 <= data.size() &&
+         !data.substr(offset).startswith(BitcodeMagic)) {
+    BitReader reader(data, offset);
+    if (reader.read(2) != EnterSubblock) {
+      break;
+    }
+    reader.readVBR(8);
+    reader.readVBR(4);
+    reader.alignTo32();
+    uint64_t words = reader.read(32);
+    uint64_t end = reader.byteOffset() + words * 4;
+    if (reader.failed() || end > data.size()) {
+      return 0;
+    }
+    offset = end;
+  }
+  return isFileBoundary(data, offset) ? offset : 0;
+}
+
+static size_t findBitcodeFile(StringRef section, size_t from) {
+  return std::min(section.find(BitcodeMagic, from),
+                  section.find(WrapperMagic, from));
+}
+
+std::vector<StringRef> mull::splitBitcodeSection(StringRef section) {
+  std::vector<StringRef> files;
+  size_t offset = findBitcodeFile(section, 0);
+  while (offset != StringRef::npos) {
+    size_t size = bitcodeFileSize(section.substr(offset));
+    if (size == 0) {
+      offset = findBitcodeFile(section, offset + 1);
+      continue;
+    }
+    files.push_back(section.substr(offset, size));
+    offset = findBitcodeFile(section, offset + size);
+  }
+  return files;
+}
+
+bool mull::findBitcodeSections(MemoryBufferRef object,
+                               std::vector<StringRef> &sections) {
+  auto binary = object::createBinary(object);
+  if (!binary) {
+    consumeError(binary.takeError());
+    return false;
+  }
+
+  auto objectFile = dyn_cast<object::ObjectFile>(binary.get().get());
+  if (!objectFile) {
+    return false;
+  }
+
+  for (auto &section : objectFile->sections()) {
+    StringRef name;
+    if (section.getName(name) || (name != ".llvmbc" && name != "__bitcode")) {
+      continue;
+    }
+    StringRef contents;
+    if (!section.getContents(contents)) {
+      sections.push_back(contents);
+    }
+  }
+  return true;
+}
@@ -0,0 +1,147 @@
+#include "mull/ExecutionOutput.h"
+
+#include "mull/ExecutionResult.h"
+
+#include "LLVMCompatibility.h"
+
+#include <llvm/ADT/SmallVector.h>
+
+#include <functional>
+
+using namespace mull;
+
+ExecutionOutput::ExecutionOutput(std::string text) {
+  if (!text.empty()) {
+    auto size = text.size();
+    storage = std::make_shared<const Storage>(
+        Storage{std::move(text), size, false});
+  }
+}
+
+ExecutionOutput::ExecutionOutput(const char *text)
+    : ExecutionOutput(std::string(text)) {}
+
+ExecutionOutput::ExecutionOutput(std::shared_ptr<const Storage> storage)
+    : storage(std::move(storage)) {}
+
+std::string ExecutionOutput::str() const {
+  if (!storage) {
+    return std::string();
+  }
+  if (!storage->compressed) {
+    return storage->bytes;
+  }
+
+  llvm::SmallVector<char, 0> text;
+  if (!llvm_compat::uncompress(storage->bytes, text, storage->size)) {
+    return std::string("Mull error: could not decompress output");
+  }
+  return std::string(text.begin(), text.end());
+}
+
+size_t ExecutionOutput::size() const { return storage ? storage->size : 0; }
+
+bool ExecutionOutput::empty() const { return size() == 0; }
+
+bool ExecutionOutput::isCompressed() const {
+  return storage && storage->compressed;
+}
+
+bool ExecutionOutput::sharesStorageWith(const ExecutionOutput &other) const {
+  return storage == other.storage;
+}
+
+bool mull::operator==(const ExecutionOutput &output, const std::string &text) {
+  return output.str() == text;
+}
+
+bool mull::operator==(const ExecutionOutput &output, const char *text) {
+  return output.str() == text;
+}
+
+std::ostream &mull::operator<<(std::ostream &stream,
+                               const ExecutionOutput &output) {
+  return stream << output.str();
+}
+
+ExecutionOutputStore::ExecutionOutputStore(OutputRetention retention,
+                                           size_t tailBytes)
+    : retention(retention), tailBytes(tailBytes), count(0), bytes(0) {}
+
+void ExecutionOutputStore::retain(ExecutionResult &result) {
+  switch (retention) {
+  case OutputRetention::None:
+    result.stdoutOutput = ExecutionOutput();
+    result.stderrOutput = ExecutionOutput();
+    return;
+
+  case OutputRetention::Killed:
+    if (result.status == ExecutionStatus::Passed) {
+      result.stdoutOutput = ExecutionOutput();
+      result.stderrOutput = ExecutionOutput();
+      return;
+    }
+    break;
+
+  case OutputRetention::Tail:
+  case OutputRetention::Full:
+  case OutputRetention::Compressed:
+    break;
+  }
+
+  result.stdoutOutput = intern(result.stdoutOutput.str());
+  result.stderrOutput = intern(result.stderrOutput.str());
+}
+
+size_t ExecutionOutputStore::uniqueOutputs() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return count;
+}
+
+size_t ExecutionOutputStore::storedBytes() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return bytes;
+}
+
+ExecutionOutput ExecutionOutputStore::intern(const std::string &text) {
+  if (text.empty()) {
+    return ExecutionOutput();
+  }
+
+  ExecutionOutput::Storage candidate{std::string(), text.size(), false};
+  if (retention == OutputRetention::Tail && text.size() > tailBytes) {
+    candidate.bytes = text.substr(text.size() - tailBytes);
+    candidate.size = candidate.bytes.size();
+  } else {
+    candidate.bytes = text;
+  }
+
+  if (retention == OutputRetention::Compressed) {
+    /// If zlib is not available the output is stored as is
+    llvm::SmallVector<char, 0> compressed;
+    if (llvm_compat::compress(candidate.bytes, compressed)) {
+      candidate.bytes.assign(compressed.begin(), compressed.end());
+      candidate.compressed = true;
+    }
+  }
+
+  /// Compression is deterministic, so the identical outputs have
+  /// the identical compressed bytes as well
+  const size_t hash = std::hash<std::string>()(candidate.bytes);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto &bucket = storages[hash];
+  for (auto &storage : bucket) {
+    if (storage->compressed == candidate.compressed &&
+        storage->bytes == candidate.bytes) {
+      return ExecutionOutput(storage);
+    }
+  }
+
+  auto storage = std::make_shared<const ExecutionOutput::Storage>(
+      std::move(candidate));
+  bucket.push_back(storage);
+  count++;
+  bytes += storage->bytes.size();
+  return ExecutionOutput(storage);
+}
@@ -1,51 +1,194 @@
 #include "mull/Filter.h"
 
-#include "mull/SourceLocation.h"
+#include "mull/MullModule.h"
 #include "mull/TestFrameworks/Test.h"
 
 #include <llvm/IR/DebugInfoMetadata.h>
 #include <llvm/IR/Function.h>
 #include <llvm/IR/Instructions.h>
+#include <llvm/Support/Path.h>
 
 using namespace llvm;
 using namespace mull;
 
+static const char GlobPrefix[] = "glob:";
+static const char RegexPrefix[] = "regex:";
+
+/// "*" and "?" stay within a directory, "**/" matches any number of
+/// directories, the glob matches the end of the path
+static std::string globToRegex(StringRef glob) {
+  std::string regex = "(^|/)";
+  for (size_t i = 0; i < glob.size(); i++) {
+    char character = glob[i];
+    if (glob.substr(i).startswith("**/")) {
+      regex += "(.*/)?";
+      i += 2;
+    } else if (glob.substr(i).startswith("**")) {
+      regex += ".*";
+      i += 1;
+    } else if (character == '*') {
+      regex += "[^/]*";
+    } else if (character == '?') {
+      regex += "[^/]";
+    } else if (character == '[') {
+      size_t end = glob.find(']', i + 1);
+      if (end == StringRef::npos) {
+        regex += "\\[";
+      } else {
+        std::string set = glob.substr(i, end - i + 1).str();
+        if (set.size() > 2 && set[1] == '!') {
+          set[1] = '^';
+        }
+        regex += set;
+        i = end;
+      }
+    } else if (StringRef("\\^$.|+(){}").find(character) != StringRef::npos) {
+      regex += '\\';
+      regex += character;
+    } else {
+      regex += character;
+    }
+  }
+  return regex + "$";
+}
+
+/// The regular expression of a glob or regex pattern, false for a substring
+static bool locationRegex(StringRef pattern, std::string &regex) {
+  if (pattern.startswith(GlobPrefix)) {
+    regex = globToRegex(pattern.substr(strlen(GlobPrefix)));
+    return true;
+  }
+  if (pattern.startswith(RegexPrefix)) {
+    regex = pattern.substr(strlen(RegexPrefix)).str();
+    return true;
+  }
+  return false;
+}
+
+/// Mirrors SourceLocation::isNull, without building the location
+static bool isNullLocation(unsigned line, unsigned column) {
+  return line == 0 && column == 0;
+}
+
 bool Filter::shouldSkipInstruction(llvm::Instruction *instruction) {
-  SourceLocation location =
-      SourceLocation::sourceLocationFromInstruction(instruction);
-  if (location.isNull()) {
+  const bool filtersFiles = !locations.empty() || !locationRegexes.empty();
+  if (!filtersFiles && !changedLinesOnly) {
     return false;
   }
+  if (instruction->getMetadata(0) == nullptr) {
+    return changedLinesOnly;
+  }
 
-  for (auto &fileLocation : locations) {
-    if (location.filePath.find(fileLocation) != std::string::npos) {
-      return true;
-    }
+  const DILocation *location = instruction->getDebugLoc().get();
+  if (isNullLocation(location->getLine(), location->getColumn())) {
+    return changedLinesOnly;
   }
 
+  std::lock_guard<std::mutex> lock(verdictsMutex);
+  auto file = location->getScope()->getFile();
+  if (filtersFiles && shouldSkipFile(file)) {
+    return true;
+  }
+  if (changedLinesOnly) {
+    auto changes = changesOf(file);
+    return changes == nullptr || !changes->contains(location->getLine());
+  }
   return false;
 }
 
 bool Filter::shouldSkipFunction(llvm::Function *function) {
-  for (std::string &name : names) {
-    if (function->getName().find(StringRef(name)) != StringRef::npos) {
-      return true;
+  if (names.empty() && locations.empty() && locationRegexes.empty()) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(verdictsMutex);
+  auto cached = functionVerdicts.find(function);
+  if (cached != functionVerdicts.end()) {
+    return cached->second;
+  }
+
+  bool skip = names.matches(function->getName());
+  if (!skip && (!locations.empty() || !locationRegexes.empty())) {
+    /// The debug info of a function is read along with its body
+    MullModule::materialize(function);
+    auto subprogram = dyn_cast_or_null<DISubprogram>(function->getMetadata(0));
+    if (subprogram && !isNullLocation(subprogram->getLine(), 0)) {
+      skip = shouldSkipFile(subprogram->getFile());
     }
   }
 
-  SourceLocation location =
-      SourceLocation::sourceLocationFromFunction(function);
-  if (location.isNull()) {
+  functionVerdicts[function] = skip;
+  return skip;
+}
+
+static std::string filePathOf(const llvm::DIFile *file) {
+  StringRef directory = file->getDirectory();
+  StringRef fileName = file->getFilename();
+  if (directory.empty() && fileName.empty()) {
+    return std::string();
+  }
+  std::string filePath = fileName.str();
+  if (!sys::path::is_absolute(fileName)) {
+    filePath = directory.str() + sys::path::get_separator().str() + filePath;
+  }
+  return filePath;
+}
+
+bool Filter::shouldSkipFile(const llvm::DIFile *file) {
+  if (file == nullptr) {
     return false;
   }
 
-  for (auto &fileLocation : locations) {
-    if (location.filePath.find(fileLocation) != std::string::npos) {
-      return true;
+  auto cached = fileVerdicts.find(file);
+  if (cached != fileVerdicts.end()) {
+    return cached->second;
+  }
+
+  std::string filePath = filePathOf(file);
+  bool skip = false;
+  if (!filePath.empty()) {
+    skip = locations.matches(filePath);
+    for (auto &regex : locationRegexes) {
+      if (skip) {
+        break;
+      }
+      skip = regex.match(filePath);
     }
   }
 
-  return false;
+  fileVerdicts[file] = skip;
+  return skip;
+}
+
+const ChangedLines::FileChanges *
+Filter::changesOf(const llvm::DIFile *file) {
+  if (file == nullptr) {
+    return nullptr;
+  }
+
+  auto cached = fileChanges.find(file);
+  if (cached != fileChanges.end()) {
+    return cached->second;
+  }
+
+  std::string filePath = filePathOf(file);
+  auto changes = filePath.empty() ? nullptr : changedLines.changesOf(filePath);
+  fileChanges[file] = changes;
+  return changes;
+}
+
+void Filter::clearVerdicts() {
+  std::lock_guard<std::mutex> lock(verdictsMutex);
+  functionVerdicts.clear();
+  fileVerdicts.clear();
+  fileChanges.clear();
+}
+
+void Filter::includeChangedLines(ChangedLines changes) {
+  clearVerdicts();
+  instructionPatterns += "changed:\n" + changes.toString();
+  changedLines = std::move(changes);
+  changedLinesOnly = true;
 }
 
 bool Filter::shouldSkipTest(const std::string &testName) {
@@ -62,19 +205,59 @@ bool Filter::shouldSkipTest(const std::string &testName) {
 }
 
 void Filter::skipByName(const std::string &nameSubstring) {
-  names.push_back(nameSubstring);
+  clearVerdicts();
+  names.addPattern(nameSubstring);
+  functionPatterns += "name:" + nameSubstring + "\n";
 }
 
 void Filter::skipByName(const char *nameSubstring) {
-  names.push_back(std::string(nameSubstring));
+  skipByName(std::string(nameSubstring));
 }
 
 void Filter::skipByLocation(const std::string &locationSubstring) {
-  locations.push_back(locationSubstring);
+  clearVerdicts();
+  locations.addPattern(locationSubstring);
+  functionPatterns += "location:" + locationSubstring + "\n";
+  instructionPatterns += "location:" + locationSubstring + "\n";
 }
 
 void Filter::skipByLocation(const char *locationSubstring) {
-  locations.push_back(std::string(locationSubstring));
+  skipByLocation(std::string(locationSubstring));
+}
+
+void Filter::skipByLocationPattern(const std::string &pattern) {
+  std::string regex;
+  if (!locationRegex(pattern, regex)) {
+    skipByLocation(pattern);
+    return;
+  }
+
+  assert(validateLocationPattern(pattern).empty());
+  clearVerdicts();
+  locationRegexes.emplace_back(regex, Regex::NoFlags);
+  functionPatterns += "regex:" + regex + "\n";
+  instructionPatterns += "regex:" + regex + "\n";
+}
+
+const std::string &Filter::getFunctionPatterns() const {
+  return functionPatterns;
+}
+
+const std::string &Filter::getInstructionPatterns() const {
+  return instructionPatterns;
+}
+
+std::string Filter::validateLocationPattern(const std::string &pattern) {
+  std::string regex;
+  if (!locationRegex(pattern, regex)) {
+    return std::string();
+  }
+
+  std::string error;
+  if (!Regex(regex).isValid(error)) {
+    return "invalid location pattern '" + pattern + "': " + error;
+  }
+  return std::string();
 }
 
 void Filter::includeTest(const std::string &testName) {
@@ -2,19 +2,33 @@
 
 #include "mull/ExecutionResult.h"
 #include "mull/Logger.h"
+#include "mull/PerfCounters.h"
+#include "mull/Socket.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cerrno>
 #include <chrono>
 #include <csignal>
+#include <cstdio>
 #include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <memory>
+#include <new>
+#include <poll.h>
 #include <sys/mman.h>
-#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <thread>
 #include <unistd.h>
 
-#include <llvm/Support/FileSystem.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
 
 using namespace std::chrono;
 
@@ -36,126 +50,1090 @@ static pid_t mullFork(const char *processName) {
   return pid;
 }
 
-static std::string readFileAndUnlink(const char *filename) {
-  FILE *file = fopen(filename, "r");
-  if (!file) {
-    perror("fopen");
-    printf("fopen: %s\n", filename);
-    return std::string("Mull error: could not read output");
+static void createPipe(int fds[2], const char *pipeName) {
+  if (pipe(fds) == -1) {
+    mull::Logger::error() << "Failed to create " << pipeName << "\n";
+    mull::Logger::error() << strerror(errno) << "\n";
+    mull::Logger::error() << "Shutting down\n";
+    exit(1);
   }
-  if (unlink(filename) == -1) {
-    perror("unlink");
-    printf("unlink: %s\n", filename);
+}
+
+/// Reads whatever is available without blocking, the bytes beyond the limit
+/// are read and thrown away so that the child never blocks on a full pipe.
+/// Returns false once the pipe is closed.
+static bool drainPipe(int fd, std::string &output, size_t limit) {
+  char buffer[4096];
+  while (true) {
+    ssize_t bytes = read(fd, buffer, sizeof(buffer));
+    if (bytes > 0) {
+      if (output.size() < limit) {
+        output.append(buffer,
+                      std::min(size_t(bytes), limit - output.size()));
+      }
+      continue;
+    }
+    if (bytes == -1 && errno == EINTR) {
+      continue;
+    }
+    return bytes == -1 && (errno == EAGAIN || errno == EWOULDBLOCK);
   }
+}
 
-  fseek(file, 0, SEEK_END);
-  int size = ftell(file);
-  rewind(file);
+static int64_t nanosecondsSince(steady_clock::time_point start) {
+  return duration_cast<nanoseconds>(steady_clock::now() - start).count();
+}
 
-  char *buffer = (char *)malloc(sizeof(char) * (size + 1));
-  fread(buffer, sizeof(char), size, file);
-  buffer[size] = '\0';
-  std::string output(buffer);
-  free(buffer);
-  fclose(file);
+static int64_t microsecondsOf(const struct timeval &time) {
+  return int64_t(time.tv_sec) * 1000000 + time.tv_usec;
+}
 
-  return output;
+static mull::ChildUsage usageOf(const struct rusage &usage) {
+  mull::ChildUsage childUsage;
+  childUsage.userTime = microsecondsOf(usage.ru_utime);
+  childUsage.systemTime = microsecondsOf(usage.ru_stime);
+#ifdef __APPLE__
+  /// In bytes rather than kilobytes
+  childUsage.maxResident = usage.ru_maxrss / 1024;
+#else
+  childUsage.maxResident = usage.ru_maxrss;
+#endif
+  childUsage.minorFaults = usage.ru_minflt;
+  childUsage.majorFaults = usage.ru_majflt;
+  childUsage.voluntarySwitches = usage.ru_nvcsw;
+  childUsage.involuntarySwitches = usage.ru_nivcsw;
+  return childUsage;
+}
+
+/// What was used from `before` on, the peak is the one of `after`
+static mull::ChildUsage usageSince(const mull::ChildUsage &after,
+                                   const mull::ChildUsage &before) {
+  mull::ChildUsage usage;
+  usage.userTime = after.userTime - before.userTime;
+  usage.systemTime = after.systemTime - before.systemTime;
+  usage.maxResident = after.maxResident;
+  usage.minorFaults = after.minorFaults - before.minorFaults;
+  usage.majorFaults = after.majorFaults - before.majorFaults;
+  usage.voluntarySwitches = after.voluntarySwitches - before.voluntarySwitches;
+  usage.involuntarySwitches =
+      after.involuntarySwitches - before.involuntarySwitches;
+  return usage;
+}
+
+static mull::ChildUsage currentUsage() {
+  struct rusage usage {};
+  getrusage(RUSAGE_SELF, &usage);
+  return usageOf(usage);
+}
+
+/// A descriptor that becomes readable when the child exits, so that the
+/// parent sleeps in poll until there is output, an exit or the deadline.
+/// -1 where pidfd_open is not available, the child is then polled instead.
+static int openProcessDescriptor(pid_t pid) {
+#ifdef SYS_pidfd_open
+  return int(syscall(SYS_pidfd_open, pid, 0));
+#else
+  return -1;
+#endif
 }
 
-void handle_alarm_signal(int signal, siginfo_t *info, void *context) {
-  _exit(mull::ForkProcessSandbox::MullTimeoutCode);
+/// Without a process descriptor the child is polled this often
+static const int ExitPollMilliseconds = 10;
+
+static int pollTimeout(steady_clock::time_point deadline, bool watchesExit) {
+  auto remaining = duration_cast<milliseconds>(deadline - steady_clock::now());
+  /// Rounded up, a poll that returns early only to find nothing to do would
+  /// spin until the deadline
+  int timeout = int(std::max<long long>(remaining.count() + 1, 0));
+  return watchesExit ? timeout : std::min(timeout, ExitPollMilliseconds);
 }
 
-void handle_timeout(long long timeoutMilliseconds) {
-  struct sigaction action{};
-  memset(&action, 0, sizeof(action));
-  action.sa_sigaction = &handle_alarm_signal;
-  if (sigaction(SIGALRM, &action, nullptr) != 0) {
-    perror("sigaction");
-    abort();
+namespace {
+
+/// Memory shared between a child and the parent. The child notes when the
+/// test starts and ends, the steady clock is the same in both processes,
+/// and what the test counted. Only the child itself writes the results:
+/// a process the test forked runs the same code after the test.
+struct SharedState {
+  SharedState()
+      : status(mull::Invalid), testStart(), testEnd(), counts(), child(0) {}
+  mull::ExecutionStatus status;
+  steady_clock::time_point testStart;
+  steady_clock::time_point testEnd;
+  mull::PerfCounts counts;
+  pid_t child;
+};
+
+/// The shared states are mapped a batch at a time and reused by the later
+/// children, a run then costs neither an mmap nor a munmap. A process
+/// forked from mull, e.g. a fork server, maps a state per child instead:
+/// the states it inherited are mull's, and so may be the lock.
+class SharedStates {
+public:
+  SharedStates() : owner(getpid()) {}
+
+  SharedState *acquire() {
+    if (getpid() != owner) {
+      return new (map(1)) SharedState();
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    if (available.empty()) {
+      auto states = map(StatesPerMapping);
+      for (size_t index = 0; index < StatesPerMapping; index++) {
+        available.push_back(&states[index]);
+      }
+    }
+    auto state = available.back();
+    available.pop_back();
+    return new (state) SharedState();
   }
 
-  struct itimerval timer{};
-  timer.it_value.tv_sec = timeoutMilliseconds / 1000;
-  /// Cut off seconds, and convert what's left into microseconds
-  timer.it_value.tv_usec = (timeoutMilliseconds % 1000) * 1000;
+  void release(SharedState *state) {
+    state->~SharedState();
+    if (getpid() != owner) {
+      munmap(state, sizeof(SharedState));
+      return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    available.push_back(state);
+  }
 
-  /// Do not repeat
-  timer.it_interval.tv_sec = 0;
-  timer.it_interval.tv_usec = 0;
+  static SharedStates &shared() {
+    static SharedStates states;
+    return states;
+  }
+
+private:
+  static const size_t StatesPerMapping = 64;
 
-  if (setitimer(ITIMER_REAL, &timer, nullptr) != 0) {
-    perror("setitimer");
-    abort();
+  static SharedState *map(size_t count) {
+    void *memory = mmap(nullptr, sizeof(SharedState) * count,
+                        PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS,
+                        -1, 0);
+    if (memory == MAP_FAILED) {
+      mull::Logger::error() << "Cannot map the state of a child: "
+                            << strerror(errno) << "\n";
+      exit(1);
+    }
+    return static_cast<SharedState *>(memory);
   }
-}
 
-mull::ExecutionResult
-mull::ForkProcessSandbox::run(std::function<ExecutionStatus(void)> function,
-                              long long timeoutMilliseconds) {
-  llvm::SmallString<32> stderrFilename;
-  llvm::sys::fs::createUniqueFile("/tmp/mull.stderr.%%%%%%", stderrFilename);
+  const pid_t owner;
+  std::mutex mutex;
+  std::vector<SharedState *> available;
+};
+
+/// A forked child the parent collects the output of. The pipes and
+/// the process descriptor are -1 once closed, or when there is none.
+struct Child {
+  pid_t pid;
+  int pipes[2];
+  int processDescriptor;
+  SharedState *sharedState;
+  high_resolution_clock::time_point start;
+  steady_clock::time_point forkStart;
+  steady_clock::time_point forked;
+  steady_clock::time_point deadline;
+  /// The progress as last seen and when it changed, see stalled
+  bool watchesProgress;
+  clockid_t cpuClock;
+  uint64_t progress;
+  steady_clock::time_point lastProgress;
+  milliseconds stallTimeout;
+  std::string outputs[2];
+  int64_t outputRead;
+  int status;
+  struct rusage usage;
+  bool exited;
+  bool killed;
+};
+
+} // namespace
+
+static std::unique_ptr<Child>
+spawnChild(const std::function<mull::ExecutionStatus()> &function,
+           long long timeoutMilliseconds,
+           const mull::ChildResources::Limits &limits, bool countEvents,
+           long long stallMilliseconds) {
+  int stdoutPipe[2];
+  int stderrPipe[2];
+  createPipe(stdoutPipe, "stdout pipe");
+  createPipe(stderrPipe, "stderr pipe");
 
-  llvm::SmallString<32> stdoutFilename;
-  llvm::sys::fs::createUniqueFile("/tmp/mull.stdout.%%%%%%", stdoutFilename);
+  SharedState *sharedState = SharedStates::shared().acquire();
 
-  /// Creating a memory to be shared between child and parent.
-  ExecutionStatus *sharedStatus = (ExecutionStatus *)mmap(
-      nullptr, sizeof(ExecutionStatus), PROT_READ | PROT_WRITE,
-      MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  /// Otherwise whatever is buffered now ends up in the child's output
+  fflush(stdout);
+  fflush(stderr);
 
   auto start = high_resolution_clock::now();
+  auto forkStart = steady_clock::now();
   const pid_t workerPID = mullFork("worker");
   if (workerPID == 0) {
-    freopen(stderrFilename.c_str(), "w", stderr);
-    freopen(stdoutFilename.c_str(), "w", stdout);
+    close(stdoutPipe[0]);
+    close(stderrPipe[0]);
+    dup2(stdoutPipe[1], STDOUT_FILENO);
+    dup2(stderrPipe[1], STDERR_FILENO);
+    close(stdoutPipe[1]);
+    close(stderrPipe[1]);
+    mull::ChildResources::apply(limits);
 
-    handle_timeout(timeoutMilliseconds);
+    sharedState->child = getpid();
 
-    *sharedStatus = function();
+    mull::PerfCounters counters(countEvents);
+    sharedState->testStart = steady_clock::now();
+    auto status = function();
+    if (getpid() == sharedState->child) {
+      sharedState->testEnd = steady_clock::now();
+      sharedState->counts = counters.read();
+      sharedState->status = status;
+    }
 
     fflush(stderr);
     fflush(stdout);
-    _exit(MullExitCode);
-  } else {
-    int status = 0;
-    pid_t pid = 0;
-    while ((pid = waitpid(workerPID, &status, 0)) == -1) {
+    _exit(mull::ForkProcessSandbox::MullExitCode);
+  }
+
+  auto child = std::unique_ptr<Child>(new Child());
+  child->forked = steady_clock::now();
+  close(stdoutPipe[1]);
+  close(stderrPipe[1]);
+  fcntl(stdoutPipe[0], F_SETFL, O_NONBLOCK);
+  fcntl(stderrPipe[0], F_SETFL, O_NONBLOCK);
+
+  child->pid = workerPID;
+  child->pipes[0] = stdoutPipe[0];
+  child->pipes[1] = stderrPipe[0];
+  child->processDescriptor = openProcessDescriptor(workerPID);
+  child->sharedState = sharedState;
+  child->start = start;
+  child->forkStart = forkStart;
+  /// The deadline is enforced by the parent: a timer in the child would
+  /// not fire if the test blocked the signal or used the timer itself
+  child->deadline = forkStart + milliseconds(timeoutMilliseconds);
+  child->watchesProgress =
+      stallMilliseconds > 0 &&
+      clock_getcpuclockid(workerPID, &child->cpuClock) == 0;
+  child->progress = 0;
+  child->lastProgress = child->forked;
+  child->stallTimeout = milliseconds(stallMilliseconds);
+  child->outputRead = 0;
+  child->status = 0;
+  child->exited = false;
+  child->killed = false;
+  return child;
+}
+
+/// What the child did so far, wherever the test is: the CPU time it took
+/// and, on Linux, the bytes it read and wrote. The parent reads both, the
+/// child has nothing to report.
+static bool progressOf(const Child &child, uint64_t &progress) {
+  struct timespec cpuTime;
+  if (clock_gettime(child.cpuClock, &cpuTime) != 0) {
+    return false;
+  }
+  progress = uint64_t(cpuTime.tv_sec) * 1000000000 + cpuTime.tv_nsec;
+#ifdef __linux__
+  char path[64];
+  snprintf(path, sizeof(path), "/proc/%d/io", int(child.pid));
+  if (FILE *io = fopen(path, "r")) {
+    unsigned long long read = 0;
+    unsigned long long written = 0;
+    if (fscanf(io, "rchar: %llu wchar: %llu", &read, &written) == 2) {
+      progress += read + written;
+    }
+    fclose(io);
+  }
+#endif
+  return true;
+}
+
+/// Whether the child neither ran nor did I/O for its stall timeout, it
+/// waits on something that does not come, e.g. a lock a mutant never
+/// releases. A child that cannot be watched is left to its deadline.
+static bool stalled(Child &child, steady_clock::time_point now) {
+  uint64_t progress = 0;
+  if (!child.watchesProgress || !progressOf(child, progress)) {
+    return false;
+  }
+  if (progress != child.progress) {
+    child.progress = progress;
+    child.lastProgress = now;
+    return false;
+  }
+  return now - child.lastProgress >= child.stallTimeout;
+}
+
+/// Waits until there is output, an exit or a deadline for any of
+/// the children, collects the output, reaps the children that exited and
+/// kills the ones that ran past their deadline or stalled. The pipes are not
+/// enough to detect the exits: a child forked concurrently by another worker
+/// may have inherited the write ends, so the exits are watched as well.
+/// A positive maxTimeout bounds the wait, for deadlines that move.
+static void superviseChildren(const std::vector<Child *> &children,
+                              size_t limit, int maxTimeout = -1) {
+  std::vector<struct pollfd> fds;
+  int timeout = maxTimeout;
+  for (auto child : children) {
+    int descriptors[] = {child->pipes[0], child->pipes[1],
+                         child->processDescriptor};
+    for (int fd : descriptors) {
+      struct pollfd entry {};
+      entry.fd = fd;
+      entry.events = POLLIN;
+      fds.push_back(entry);
+    }
+    int childTimeout =
+        child->killed
+            ? ExitPollMilliseconds
+            : pollTimeout(child->deadline, child->processDescriptor != -1);
+    if (!child->killed && child->watchesProgress) {
+      childTimeout = std::min(
+          childTimeout, pollTimeout(child->lastProgress + child->stallTimeout,
+                                    child->processDescriptor != -1));
+    }
+    timeout = timeout == -1 ? childTimeout : std::min(timeout, childTimeout);
+  }
+
+  /// poll skips the negative descriptors
+  poll(fds.data(), fds.size(), timeout);
+
+  for (size_t index = 0; index < children.size(); index++) {
+    auto child = children[index];
+    for (int i = 0; i < 2; i++) {
+      if (child->pipes[i] == -1 || fds[index * 3 + i].revents == 0) {
+        continue;
+      }
+      auto readStart = steady_clock::now();
+      bool open = drainPipe(child->pipes[i], child->outputs[i], limit);
+      child->outputRead += nanosecondsSince(readStart);
+      if (!open) {
+        close(child->pipes[i]);
+        child->pipes[i] = -1;
+      }
+    }
+
+    pid_t reaped = wait4(child->pid, &child->status, WNOHANG, &child->usage);
+    child->exited = reaped == child->pid || (reaped == -1 && errno != EINTR);
+    auto now = steady_clock::now();
+    if (!child->exited && !child->killed &&
+        (now >= child->deadline || stalled(*child, now))) {
+      kill(child->pid, SIGKILL);
+      child->killed = true;
+    }
+  }
+}
+
+static mull::ExecutionResult finishChild(Child &child, size_t limit,
+                                         bool keepPassedOutput) {
+  using namespace mull;
+
+  for (int i = 0; i < 2; i++) {
+    if (child.pipes[i] != -1) {
+      auto readStart = steady_clock::now();
+      drainPipe(child.pipes[i], child.outputs[i], limit);
+      child.outputRead += nanosecondsSince(readStart);
+      close(child.pipes[i]);
     }
+  }
+  if (child.processDescriptor != -1) {
+    close(child.processDescriptor);
+  }
+  auto reaped = steady_clock::now();
+
+  ExecutionResult result;
+  result.stdoutOutput = std::move(child.outputs[0]);
+  result.stderrOutput = std::move(child.outputs[1]);
+
+  auto elapsed = high_resolution_clock::now() - child.start;
+  result.runningTime =
+      duration_cast<std::chrono::milliseconds>(elapsed).count();
+  result.exitStatus = WEXITSTATUS(child.status);
+  result.usage = usageOf(child.usage);
+  auto sharedState = child.sharedState;
+  result.status = sharedState->status;
+  result.counts = sharedState->counts;
+
+  /// A child that crashed or timed out did not note the end of its test
+  auto &timings = result.timings;
+  timings.outputRead = child.outputRead;
+  timings.fork =
+      duration_cast<nanoseconds>(child.forked - child.forkStart).count();
+  if (sharedState->testStart != steady_clock::time_point()) {
+    auto testEnd = sharedState->testEnd != steady_clock::time_point()
+                       ? sharedState->testEnd
+                       : reaped;
+    timings.forkToStart =
+        duration_cast<nanoseconds>(sharedState->testStart - child.forkStart)
+            .count();
+    timings.test =
+        duration_cast<nanoseconds>(testEnd - sharedState->testStart).count();
+    timings.reap = duration_cast<nanoseconds>(reaped - testEnd).count();
+  }
+
+  SharedStates::shared().release(sharedState);
+
+  int status = child.status;
+  if (child.killed) {
+    result.status = Timedout;
+  }
+
+  else if (WIFSIGNALED(status)) {
+    result.status = Crashed;
+  }
+
+  else if (WIFEXITED(status) &&
+           WEXITSTATUS(status) == ForkProcessSandbox::LoopBudgetExitCode) {
+    result.status = LoopBudgetExceeded;
+  }
+
+  else if (WIFEXITED(status) &&
+           WEXITSTATUS(status) != ForkProcessSandbox::MullExitCode) {
+    result.status = AbnormalExit;
+  }
+
+  if (!keepPassedOutput && result.status == Passed) {
+    result.stdoutOutput = ExecutionOutput();
+    result.stderrOutput = ExecutionOutput();
+  }
+
+  return result;
+}
+
+mull::ChildResources::Limits mull::ForkProcessSandbox::prepareLimits() {
+  return resources ? resources->prepare() : ChildResources::Limits();
+}
+
+bool mull::ForkProcessSandbox::admitChild(
+    MemoryBudget::Reservation &reservation, bool wait) {
+  auto budget = resources ? resources->memoryBudget() : nullptr;
+  if (!budget) {
+    return true;
+  }
+  if (wait) {
+    reservation = budget->admitChild();
+    return true;
+  }
+  return budget->tryAdmitChild(reservation);
+}
+
+void mull::ForkProcessSandbox::releaseChild(
+    const MemoryBudget::Reservation &reservation, const ChildUsage &usage) {
+  if (auto budget = resources ? resources->memoryBudget() : nullptr) {
+    budget->releaseChild(reservation, uint64_t(usage.maxResident) * 1024);
+  }
+}
+
+mull::ExecutionResult
+mull::ForkProcessSandbox::run(std::function<ExecutionStatus(void)> function,
+                              long long timeoutMilliseconds) {
+  MemoryBudget::Reservation reservation;
+  admitChild(reservation, true);
+  auto result = runLimited(function, timeoutMilliseconds, prepareLimits());
+  releaseChild(reservation, result.usage);
+  return result;
+}
+
+mull::ExecutionResult mull::ForkProcessSandbox::runLimited(
+    const std::function<ExecutionStatus()> &function,
+    long long timeoutMilliseconds, const ChildResources::Limits &limits) {
+  auto child = spawnChild(function, timeoutMilliseconds, limits, perfCounters,
+                          stallMilliseconds);
+  std::vector<Child *> children({child.get()});
+  while (!child->exited) {
+    superviseChildren(children, outputLimit);
+  }
+  return finishChild(*child, outputLimit, keepPassedOutput);
+}
+
+std::vector<mull::ExecutionResult> mull::ProcessSandbox::runSeries(
+    const std::vector<SandboxJob> &jobs,
+    const std::function<bool(const ExecutionResult &)> &proceed) {
+  std::vector<ExecutionResult> results;
+  for (auto &job : jobs) {
+    results.push_back(run(job.function, job.timeoutMilliseconds));
+    if (!proceed(results.back())) {
+      break;
+    }
+  }
+  return results;
+}
+
+std::vector<std::vector<mull::ExecutionResult>>
+mull::ProcessSandbox::runConcurrentSeries(
+    const std::vector<std::vector<SandboxJob>> &series, size_t concurrency,
+    const std::function<bool(const ExecutionResult &)> &proceed) {
+  std::vector<std::vector<ExecutionResult>> results;
+  for (auto &jobs : series) {
+    results.push_back(runSeries(jobs, proceed));
+  }
+  return results;
+}
 
-    auto elapsed = high_resolution_clock::now() - start;
+std::vector<std::vector<mull::ExecutionResult>>
+mull::ForkProcessSandbox::runConcurrentSeries(
+    const std::vector<std::vector<SandboxJob>> &series, size_t concurrency,
+    const std::function<bool(const ExecutionResult &)> &proceed) {
+  std::vector<std::vector<ExecutionResult>> results(series.size());
+
+  struct Running {
+    size_t series;
+    std::unique_ptr<Child> child;
+    MemoryBudget::Reservation reservation;
+  };
+  std::vector<Running> running;
+  /// Only the first child waits for the memory budget, the others would
+  /// keep the running ones from being supervised
+  auto startNextJob = [&](size_t index) {
+    MemoryBudget::Reservation reservation;
+    if (!admitChild(reservation, running.empty())) {
+      return false;
+    }
+    auto &job = series[index][results[index].size()];
+    running.push_back(Running{
+        index,
+        spawnChild(job.function, job.timeoutMilliseconds, prepareLimits(),
+                   perfCounters, stallMilliseconds),
+        reservation});
+    return true;
+  };
+
+  size_t nextSeries = 0;
+  std::vector<size_t> proceeding;
+  while (true) {
+    /// The series already in flight go on first, so that the results of
+    /// a series come in as soon as possible
+    std::vector<size_t> deferred;
+    for (auto index : proceeding) {
+      if (!startNextJob(index)) {
+        deferred.push_back(index);
+      }
+    }
+    proceeding.swap(deferred);
+    for (; running.size() < concurrency && nextSeries < series.size() &&
+           proceeding.empty();
+         nextSeries++) {
+      if (!series[nextSeries].empty() && !startNextJob(nextSeries)) {
+        break;
+      }
+    }
+    if (running.empty()) {
+      break;
+    }
+
+    std::vector<Child *> children;
+    for (auto &entry : running) {
+      children.push_back(entry.child.get());
+    }
+    superviseChildren(children, outputLimit);
+
+    for (auto it = running.begin(); it != running.end();) {
+      if (!it->child->exited) {
+        ++it;
+        continue;
+      }
+      auto index = it->series;
+      results[index].push_back(
+          finishChild(*it->child, outputLimit, keepPassedOutput));
+      releaseChild(it->reservation, results[index].back().usage);
+      it = running.erase(it);
+      if (proceed(results[index].back()) &&
+          results[index].size() < series[index].size()) {
+        proceeding.push_back(index);
+      }
+    }
+  }
+
+  return results;
+}
+
+#pragma mark - Fork server
+
+using mull::sendAll;
+
+/// The server's end may be gone, the failure is reported instead of SIGPIPE
+static void disableSigPipe(int socket) {
+#ifdef SO_NOSIGPIPE
+  int enabled = 1;
+  setsockopt(socket, SOL_SOCKET, SO_NOSIGPIPE, &enabled, sizeof(enabled));
+#endif
+}
+
+static bool receiveAll(int socket, void *data, size_t size) {
+  auto bytes = static_cast<char *>(data);
+  while (size > 0) {
+    ssize_t received = recv(socket, bytes, size, 0);
+    if (received == -1 && errno == EINTR) {
+      continue;
+    }
+    if (received <= 0) {
+      return false;
+    }
+    bytes += received;
+    size -= received;
+  }
+  return true;
+}
+
+static bool sendString(int socket, const std::string &string) {
+  uint64_t size = string.size();
+  return sendAll(socket, &size, sizeof(size)) &&
+         sendAll(socket, string.data(), string.size());
+}
+
+static bool receiveString(int socket, std::string &string) {
+  uint64_t size = 0;
+  if (!receiveAll(socket, &size, sizeof(size))) {
+    return false;
+  }
+  string.resize(size);
+  return size == 0 || receiveAll(socket, &string[0], size);
+}
+
+static bool sendResult(int socket, const mull::ExecutionResult &result) {
+  int32_t status = result.status;
+  int32_t exitStatus = result.exitStatus;
+  int64_t runningTime = result.runningTime;
+  return sendAll(socket, &status, sizeof(status)) &&
+         sendAll(socket, &exitStatus, sizeof(exitStatus)) &&
+         sendAll(socket, &runningTime, sizeof(runningTime)) &&
+         sendAll(socket, &result.timings, sizeof(result.timings)) &&
+         sendAll(socket, &result.usage, sizeof(result.usage)) &&
+         sendAll(socket, &result.counts, sizeof(result.counts)) &&
+         sendString(socket, result.stdoutOutput.str()) &&
+         sendString(socket, result.stderrOutput.str());
+}
+
+static bool receiveResult(int socket, mull::ExecutionResult &result) {
+  int32_t status = 0;
+  int32_t exitStatus = 0;
+  int64_t runningTime = 0;
+  mull::SandboxTimings timings;
+  mull::ChildUsage usage;
+  mull::PerfCounts counts;
+  std::string stdoutOutput;
+  std::string stderrOutput;
+  if (!receiveAll(socket, &status, sizeof(status)) ||
+      !receiveAll(socket, &exitStatus, sizeof(exitStatus)) ||
+      !receiveAll(socket, &runningTime, sizeof(runningTime)) ||
+      !receiveAll(socket, &timings, sizeof(timings)) ||
+      !receiveAll(socket, &usage, sizeof(usage)) ||
+      !receiveAll(socket, &counts, sizeof(counts)) ||
+      !receiveString(socket, stdoutOutput) ||
+      !receiveString(socket, stderrOutput)) {
+    return false;
+  }
+  result.stdoutOutput = std::move(stdoutOutput);
+  result.stderrOutput = std::move(stderrOutput);
+  result.status = static_cast<mull::ExecutionStatus>(status);
+  result.exitStatus = exitStatus;
+  result.runningTime = runningTime;
+  result.timings = timings;
+  result.usage = usage;
+  result.counts = counts;
+  return true;
+}
+
+/// Waits until the socket has something to read, false on a timeout
+static bool waitReadable(int socket, long long timeoutMilliseconds) {
+  auto deadline = steady_clock::now() + milliseconds(timeoutMilliseconds);
+  while (true) {
+    struct pollfd descriptor {};
+    descriptor.fd = socket;
+    descriptor.events = POLLIN;
+    /// The socket is closed, so readable, once the server dies
+    int ready = poll(&descriptor, 1, pollTimeout(deadline, true));
+    if (ready > 0) {
+      return true;
+    }
+    if ((ready == -1 && errno != EINTR) || steady_clock::now() >= deadline) {
+      return false;
+    }
+  }
+}
+
+/// Runs the prologue of a series with the output thrown away: it belongs to
+/// no test, and the server shares mull's stdout and stderr
+static void runPrologue(const std::function<void()> &prologue) {
+  fflush(stdout);
+  fflush(stderr);
+  int null = open("/dev/null", O_WRONLY);
+  int saved[2] = {dup(STDOUT_FILENO), dup(STDERR_FILENO)};
+  dup2(null, STDOUT_FILENO);
+  dup2(null, STDERR_FILENO);
+  prologue();
+  fflush(stdout);
+  fflush(stderr);
+  dup2(saved[0], STDOUT_FILENO);
+  dup2(saved[1], STDERR_FILENO);
+  close(saved[0]);
+  close(saved[1]);
+  close(null);
+}
+
+/// Sent by the server once the prologue has run
+static const uint8_t ReadyCommand = 1;
+
+/// Sent instead of a job index when the series is over. The server does not
+/// rely on EOF: other servers may have inherited the parent's end of
+/// the socket, so EOF may never come.
+static const uint64_t QuitCommand = UINT64_MAX;
+
+std::vector<mull::ExecutionResult> mull::ForkServerProcessSandbox::runSeries(
+    const std::vector<SandboxJob> &jobs,
+    const std::function<bool(const ExecutionResult &)> &proceed) {
+  if (jobs.empty()) {
+    return std::vector<ExecutionResult>();
+  }
+
+  /// The server holds the budget of its children, one at a time
+  MemoryBudget::Reservation reservation;
+  admitChild(reservation, true);
+  const auto limits = prepareLimits();
+  int sockets[2];
+  pid_t serverPID = 0;
+  {
+    std::lock_guard<std::mutex> lock(forkMutex);
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) == -1) {
+      Logger::error() << "Cannot create fork server sockets: "
+                      << strerror(errno) << "\n";
+      releaseChild(reservation, ChildUsage());
+      return ProcessSandbox::runSeries(jobs, proceed);
+    }
+
+    serverPID = mullFork("fork server");
+    if (serverPID == 0) {
+      close(sockets[0]);
+      disableSigPipe(sockets[1]);
+
+      if (jobs.front().prologue) {
+        runPrologue(jobs.front().prologue);
+        if (!sendAll(sockets[1], &ReadyCommand, sizeof(ReadyCommand))) {
+          _exit(MullExitCode);
+        }
+      }
+
+      uint64_t index = 0;
+      while (receiveAll(sockets[1], &index, sizeof(index)) &&
+             index < jobs.size()) {
+        auto &job = jobs[index];
+        auto result = runLimited(job.function, job.timeoutMilliseconds,
+                                 limits);
+        if (!sendResult(sockets[1], result)) {
+          break;
+        }
+      }
+      _exit(MullExitCode);
+    }
+
+    close(sockets[1]);
+  }
+
+  const int server = sockets[0];
+  disableSigPipe(server);
+
+  std::vector<ExecutionResult> results;
+  bool serverAlive = true;
+  if (jobs.front().prologue) {
+    /// A prologue that hangs or crashes leaves the jobs to set themselves up
+    uint8_t ready = 0;
+    serverAlive =
+        waitReadable(server, jobs.front().timeoutMilliseconds) &&
+        receiveAll(server, &ready, sizeof(ready)) && ready == ReadyCommand;
+  }
+  for (uint64_t index = 0; index < jobs.size(); index++) {
     ExecutionResult result;
-    result.runningTime =
-        duration_cast<std::chrono::milliseconds>(elapsed).count();
-    result.exitStatus = WEXITSTATUS(status);
-    result.stderrOutput = readFileAndUnlink(stderrFilename.c_str());
-    result.stdoutOutput = readFileAndUnlink(stdoutFilename.c_str());
-    result.status = *sharedStatus;
+    serverAlive = serverAlive && sendAll(server, &index, sizeof(index)) &&
+                  receiveResult(server, result);
+    if (!serverAlive) {
+      /// The server itself should never crash, but if it did the rest of
+      /// the series is still run the old way, under its reservation
+      auto &job = jobs[index];
+      result = runLimited(job.function, job.timeoutMilliseconds, limits);
+    }
 
-    int munmapResult = munmap(sharedStatus, sizeof(ExecutionStatus));
+    results.push_back(result);
+    if (!proceed(result)) {
+      break;
+    }
+  }
+
+  if (serverAlive) {
+    sendAll(server, &QuitCommand, sizeof(QuitCommand));
+  } else {
+    kill(serverPID, SIGKILL);
+  }
+  close(server);
+
+  int status = 0;
+  struct rusage serverUsage {};
+  while (wait4(serverPID, &status, 0, &serverUsage) == -1 && errno == EINTR) {
+  }
+
+  auto peak = usageOf(serverUsage);
+  for (auto &result : results) {
+    peak.maxResident = std::max(peak.maxResident, result.usage.maxResident);
+  }
+  releaseChild(reservation, peak);
+  return results;
+}
+
+/// The server forks the children of one series at a time
+std::vector<std::vector<mull::ExecutionResult>>
+mull::ForkServerProcessSandbox::runConcurrentSeries(
+    const std::vector<std::vector<SandboxJob>> &series, size_t concurrency,
+    const std::function<bool(const ExecutionResult &)> &proceed) {
+  return ProcessSandbox::runConcurrentSeries(series, concurrency, proceed);
+}
+
+#pragma mark - Batches
+
+namespace {
 
-    /// Check that mummap succeeds:
-    /// "On success, munmap() returns 0, on failure -1, and errno is set
-    /// (probably to EINVAL)." http://linux.die.net/man/2/munmap
-    assert(munmapResult == 0);
-    (void)munmapResult;
+/// What the child of a batch notes for every test, the ends are the
+/// offsets of the output files once the test is done. The usages are the
+/// ones of the child so far.
+struct BatchSlot {
+  mull::ExecutionStatus status;
+  steady_clock::time_point testStart;
+  steady_clock::time_point testEnd;
+  int64_t outputEnds[2];
+  mull::ChildUsage usageAtStart;
+  mull::ChildUsage usageAtEnd;
+  mull::PerfCounts counts;
+};
 
-    if (WIFSIGNALED(status)) {
-      result.status = Crashed;
+/// The tests started and finished so far, then a slot per test
+struct BatchState {
+  std::atomic<uint64_t> started;
+  std::atomic<uint64_t> finished;
+  BatchSlot slots[1];
+};
+
+} // namespace
+
+/// Reads [begin, end) of a file, at most limit bytes of it
+static std::string readRange(int fd, int64_t begin, int64_t end,
+                             size_t limit) {
+  std::string output;
+  if (end <= begin) {
+    return output;
+  }
+  output.resize(std::min(size_t(end - begin), limit));
+  size_t read = 0;
+  while (read < output.size()) {
+    ssize_t bytes =
+        pread(fd, &output[read], output.size() - read, begin + read);
+    if (bytes == -1 && errno == EINTR) {
+      continue;
+    }
+    if (bytes <= 0) {
+      break;
     }
+    read += bytes;
+  }
+  output.resize(read);
+  return output;
+}
 
-    else if (WIFEXITED(status) && WEXITSTATUS(status) == MullTimeoutCode) {
-      result.status = Timedout;
+static int64_t fileEnd(int fd) {
+  struct stat status {};
+  return fstat(fd, &status) == 0 ? int64_t(status.st_size) : 0;
+}
+
+bool mull::BatchProcessSandbox::runBatch(
+    const std::vector<SandboxJob> &jobs, size_t first,
+    const std::function<bool(const ExecutionResult &)> &proceed,
+    std::vector<ExecutionResult> &results) {
+  const size_t count = jobs.size() - first;
+  const size_t stateSize = sizeof(BatchState) + sizeof(BatchSlot) * count;
+  void *memory = mmap(nullptr, stateSize, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  /// Files rather than pipes: the child notes their offsets after every test
+  FILE *files[2] = {tmpfile(), tmpfile()};
+  if (memory == MAP_FAILED || !files[0] || !files[1]) {
+    Logger::error() << "Cannot set up a batch: " << strerror(errno) << "\n";
+    exit(1);
+  }
+  auto state = new (memory) BatchState();
+  MemoryBudget::Reservation reservation;
+  admitChild(reservation, true);
+  const auto limits = prepareLimits();
+
+  fflush(stdout);
+  fflush(stderr);
+
+  Child child{};
+  child.start = high_resolution_clock::now();
+  child.forkStart = steady_clock::now();
+  child.pid = mullFork("batch worker");
+  if (child.pid == 0) {
+    ChildResources::apply(limits);
+    if (jobs[first].prologue) {
+      runPrologue(jobs[first].prologue);
     }
+    prepareBatch();
+    dup2(fileno(files[0]), STDOUT_FILENO);
+    dup2(fileno(files[1]), STDERR_FILENO);
+    PerfCounters counters(perfCounters);
+    for (size_t index = 0; index < count; index++) {
+      auto &slot = state->slots[index];
+      startBatchTest();
+      slot.usageAtStart = currentUsage();
+      auto countsAtStart = counters.read();
+      slot.testStart = steady_clock::now();
+      state->started = index + 1;
+      slot.status = jobs[first + index].function();
+      slot.testEnd = steady_clock::now();
+      const bool reusable = finishBatchTest();
+      slot.counts = PerfCounters::since(counters.read(), countsAtStart);
+      slot.usageAtEnd = currentUsage();
+      fflush(stdout);
+      fflush(stderr);
+      slot.outputEnds[0] = lseek(STDOUT_FILENO, 0, SEEK_CUR);
+      slot.outputEnds[1] = lseek(STDERR_FILENO, 0, SEEK_CUR);
+      state->finished = index + 1;
 
-    else if (WIFEXITED(status) && WEXITSTATUS(status) != MullExitCode) {
-      result.status = AbnormalExit;
+      ExecutionResult result;
+      result.status = slot.status;
+      if (!proceed(result) || !reusable) {
+        break;
+      }
     }
+    _exit(MullExitCode);
+  }
+
+  child.forked = steady_clock::now();
+  child.pipes[0] = -1;
+  child.pipes[1] = -1;
+  child.processDescriptor = openProcessDescriptor(child.pid);
+
+  /// The deadline is the one of the test that is running, or the one of
+  /// the next test between the tests. It moves with every test, so the
+  /// child is looked at often.
+  std::vector<Child *> children({&child});
+  while (!child.exited) {
+    uint64_t started = state->started;
+    uint64_t finished = state->finished;
+    if (started > finished) {
+      child.deadline =
+          state->slots[started - 1].testStart +
+          milliseconds(jobs[first + started - 1].timeoutMilliseconds);
+    } else if (finished < count) {
+      auto since = finished ? state->slots[finished - 1].testEnd
+                            : child.forkStart;
+      child.deadline =
+          since + milliseconds(jobs[first + finished].timeoutMilliseconds);
+    }
+    superviseChildren(children, outputLimit, ExitPollMilliseconds);
+  }
+  if (child.processDescriptor != -1) {
+    close(child.processDescriptor);
+  }
+  auto reaped = steady_clock::now();
+  releaseChild(reservation, usageOf(child.usage));
 
-    return result;
+  const uint64_t finished = state->finished;
+  int64_t outputBegins[2] = {0, 0};
+  bool proceeding = true;
+  for (uint64_t index = 0; index < finished && proceeding; index++) {
+    auto &slot = state->slots[index];
+    ExecutionResult result;
+    result.status = slot.status;
+    result.exitStatus = MullExitCode;
+    auto testTime = slot.testEnd - slot.testStart;
+    result.runningTime = duration_cast<milliseconds>(testTime).count();
+    result.timings.test = duration_cast<nanoseconds>(testTime).count();
+    result.usage = usageSince(slot.usageAtEnd, slot.usageAtStart);
+    result.counts = slot.counts;
+    if (index == 0) {
+      result.timings.fork =
+          duration_cast<nanoseconds>(child.forked - child.forkStart).count();
+      result.timings.forkToStart =
+          duration_cast<nanoseconds>(slot.testStart - child.forkStart).count();
+    }
+    if (index + 1 == finished && child.exited &&
+        state->started == finished) {
+      result.timings.reap =
+          duration_cast<nanoseconds>(reaped - slot.testEnd).count();
+    }
+    if (keepPassedOutput || result.status != Passed) {
+      result.stdoutOutput = readRange(fileno(files[0]), outputBegins[0],
+                                      slot.outputEnds[0], outputLimit);
+      result.stderrOutput = readRange(fileno(files[1]), outputBegins[1],
+                                      slot.outputEnds[1], outputLimit);
+    }
+    outputBegins[0] = slot.outputEnds[0];
+    outputBegins[1] = slot.outputEnds[1];
+    results.push_back(std::move(result));
+    proceeding = proceed(results.back());
   }
+
+  const bool interrupted = proceeding && first + finished < jobs.size() &&
+                           state->started > finished;
+  if (interrupted) {
+    auto &job = jobs[first + finished];
+    ExecutionResult result;
+    if (child.killed) {
+      auto &slot = state->slots[finished];
+      result.status = Timedout;
+      result.runningTime =
+          duration_cast<milliseconds>(reaped - slot.testStart).count();
+      result.timings.test =
+          duration_cast<nanoseconds>(reaped - slot.testStart).count();
+      result.usage = usageSince(usageOf(child.usage), slot.usageAtStart);
+      result.stdoutOutput = readRange(fileno(files[0]), outputBegins[0],
+                                      fileEnd(fileno(files[0])), outputLimit);
+      result.stderrOutput = readRange(fileno(files[1]), outputBegins[1],
+                                      fileEnd(fileno(files[1])), outputLimit);
+    } else {
+      /// The crash may come from what the tests before left behind
+      result = ForkProcessSandbox::run(job.function, job.timeoutMilliseconds);
+    }
+    results.push_back(std::move(result));
+    proceeding = proceed(results.back());
+  }
+
+  fclose(files[0]);
+  fclose(files[1]);
+  state->~BatchState();
+  munmap(memory, stateSize);
+
+  /// A child that died between the tests leaves the rest to the next batch
+  return proceeding;
 }
 
+std::vector<mull::ExecutionResult> mull::BatchProcessSandbox::runSeries(
+    const std::vector<SandboxJob> &jobs,
+    const std::function<bool(const ExecutionResult &)> &proceed) {
+  std::vector<ExecutionResult> results;
+  while (results.size() < jobs.size()) {
+    const size_t before = results.size();
+    if (!runBatch(jobs, before, proceed, results)) {
+      break;
+    }
+    if (results.size() == before) {
+      /// The child died before its first test, the test runs on its own
+      auto &job = jobs[before];
+      results.push_back(
+          ForkProcessSandbox::run(job.function, job.timeoutMilliseconds));
+      if (!proceed(results.back())) {
+        break;
+      }
+    }
+  }
+  return results;
+}
+
+std::vector<std::vector<mull::ExecutionResult>>
+mull::BatchProcessSandbox::runConcurrentSeries(
+    const std::vector<std::vector<SandboxJob>> &series, size_t concurrency,
+    const std::function<bool(const ExecutionResult &)> &proceed) {
+  return ProcessSandbox::runConcurrentSeries(series, concurrency, proceed);
+}
+
+#pragma mark - Null sandbox
+
 mull::ExecutionResult
 mull::NullProcessSandbox::run(std::function<ExecutionStatus(void)> function,
                               long long timeoutMilliseconds) {
@@ -0,0 +1,208 @@
+#include "mull/Hash.h"
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/IR/Function.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+
+using namespace mull;
+
+static const uint64_t Prime1 = 11400714785074694791ULL;
+static const uint64_t Prime2 = 14029467366897019727ULL;
+static const uint64_t Prime3 = 1609587929392839161ULL;
+static const uint64_t Prime4 = 9650029242287828579ULL;
+static const uint64_t Prime5 = 2870177450012600261ULL;
+
+static uint64_t rotateLeft(uint64_t value, int bits) {
+  return (value << bits) | (value >> (64 - bits));
+}
+
+/// XXH64 reads the input as little endian words
+static uint64_t read64(const char *data) {
+  const unsigned char *bytes = reinterpret_cast<const unsigned char *>(data);
+  uint64_t value = 0;
+  for (int i = 7; i >= 0; i--) {
+    value = (value << 8) | bytes[i];
+  }
+  return value;
+}
+
+static uint32_t read32(const char *data) {
+  const unsigned char *bytes = reinterpret_cast<const unsigned char *>(data);
+  uint32_t value = 0;
+  for (int i = 3; i >= 0; i--) {
+    value = (value << 8) | bytes[i];
+  }
+  return value;
+}
+
+static uint64_t xxhRound(uint64_t accumulator, uint64_t input) {
+  accumulator += input * Prime2;
+  accumulator = rotateLeft(accumulator, 31);
+  return accumulator * Prime1;
+}
+
+static uint64_t xxhMergeRound(uint64_t hash, uint64_t accumulator) {
+  hash ^= xxhRound(0, accumulator);
+  return hash * Prime1 + Prime4;
+}
+
+Hasher::Hasher(HashAlgorithm algorithm)
+    : algorithm(algorithm), totalLength(0), stripeLength(0) {
+  accumulators[0] = Prime1 + Prime2;
+  accumulators[1] = Prime2;
+  accumulators[2] = 0;
+  accumulators[3] = -Prime1;
+}
+
+void Hasher::consumeStripe(const char *data) {
+  for (int lane = 0; lane < 4; lane++) {
+    auto &accumulator = accumulators[lane];
+    accumulator = xxhRound(accumulator, read64(data + lane * 8));
+  }
+}
+
+void Hasher::update(llvm::StringRef data) {
+  if (algorithm == HashAlgorithm::MD5) {
+    md5.update(data);
+    return;
+  }
+
+  totalLength += data.size();
+  const char *input = data.data();
+  size_t length = data.size();
+
+  if (stripeLength != 0) {
+    size_t missing = std::min(StripeSize - stripeLength, length);
+    memcpy(stripe + stripeLength, input, missing);
+    stripeLength += missing;
+    input += missing;
+    length -= missing;
+    if (stripeLength < StripeSize) {
+      return;
+    }
+    consumeStripe(stripe);
+    stripeLength = 0;
+  }
+
+  for (; length >= StripeSize; input += StripeSize, length -= StripeSize) {
+    consumeStripe(input);
+  }
+
+  memcpy(stripe, input, length);
+  stripeLength = length;
+}
+
+std::string Hasher::final() {
+  if (algorithm == HashAlgorithm::MD5) {
+    llvm::MD5::MD5Result hash;
+    md5.final(hash);
+    llvm::SmallString<32> result;
+    llvm::MD5::stringifyResult(hash, result);
+    return std::string(result.str());
+  }
+
+  uint64_t hash = Prime5;
+  if (totalLength >= StripeSize) {
+    hash = rotateLeft(accumulators[0], 1) + rotateLeft(accumulators[1], 7) +
+           rotateLeft(accumulators[2], 12) + rotateLeft(accumulators[3], 18);
+    for (auto accumulator : accumulators) {
+      hash = xxhMergeRound(hash, accumulator);
+    }
+  }
+  hash += totalLength;
+
+  const char *tail = stripe;
+  size_t length = stripeLength;
+  for (; length >= 8; tail += 8, length -= 8) {
+    hash ^= xxhRound(0, read64(tail));
+    hash = rotateLeft(hash, 27) * Prime1 + Prime4;
+  }
+  if (length >= 4) {
+    hash ^= uint64_t(read32(tail)) * Prime1;
+    hash = rotateLeft(hash, 23) * Prime2 + Prime3;
+    tail += 4;
+    length -= 4;
+  }
+  for (; length > 0; tail++, length--) {
+    hash ^= uint64_t(static_cast<unsigned char>(*tail)) * Prime5;
+    hash = rotateLeft(hash, 11) * Prime1;
+  }
+
+  hash ^= hash >> 33;
+  hash *= Prime2;
+  hash ^= hash >> 29;
+  hash *= Prime3;
+  hash ^= hash >> 32;
+
+  char digest[sizeof("xxh64-") + 16];
+  snprintf(digest, sizeof(digest), "xxh64-%016llx",
+           static_cast<unsigned long long>(hash));
+  return digest;
+}
+
+std::string mull::hashOf(llvm::StringRef data, HashAlgorithm algorithm) {
+  Hasher hasher(algorithm);
+  hasher.update(data);
+  return hasher.final();
+}
+
+/// "!dbg !42" and "#3" lose their numbers
+static std::string normalizedIR(const std::string &text, size_t begin,
+                                size_t end) {
+  std::string normalized;
+  normalized.reserve(end - begin);
+  for (size_t i = begin; i < end; i++) {
+    normalized += text[i];
+    if (text[i] == '!' || text[i] == '#') {
+      while (i + 1 < end && isdigit(static_cast<unsigned char>(text[i + 1]))) {
+        i++;
+      }
+    }
+  }
+  return normalized;
+}
+
+std::string mull::hashOfFunctionBody(const llvm::Function &function) {
+  std::string body;
+  llvm::raw_string_ostream stream(body);
+  function.print(stream);
+  stream.flush();
+
+  return hashOf(normalizedIR(body, 0, body.size()), HashAlgorithm::XXHash64);
+}
+
+/// The name is the first global of the definition, quoted if needed
+std::string mull::hashOfFunctionCode(const llvm::Function &function) {
+  std::string body;
+  llvm::raw_string_ostream stream(body);
+  function.print(stream);
+  stream.flush();
+
+  size_t definition =
+      body.compare(0, 7, "define ") == 0 ? 0 : body.find("\ndefine ");
+  size_t name = definition == std::string::npos
+                    ? std::string::npos
+                    : body.find('@', definition);
+  if (name == std::string::npos) {
+    return hashOf(normalizedIR(body, 0, body.size()),
+                  HashAlgorithm::XXHash64);
+  }
+  size_t nameEnd = name + 1;
+  if (nameEnd < body.size() && body[nameEnd] == '"') {
+    nameEnd = body.find('"', nameEnd + 1);
+    nameEnd = nameEnd == std::string::npos ? body.size() : nameEnd + 1;
+  } else {
+    while (nameEnd < body.size() && body[nameEnd] != '(') {
+      nameEnd++;
+    }
+  }
+
+  return hashOf(normalizedIR(body, 0, name) +
+                    normalizedIR(body, nameEnd, body.size()),
+                HashAlgorithm::XXHash64);
+}
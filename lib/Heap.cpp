@@ -0,0 +1,38 @@
+#include "mull/Heap.h"
+
+#include "mull/Config/ConfigurationOptions.h"
+#include "mull/Logger.h"
+
+#include <atomic>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+using namespace mull;
+
+static std::atomic<bool> trimEnabled(false);
+
+void mull::configureHeap(const HeapConfig &config) {
+  trimEnabled = config.trim;
+  if (config.arenas == 0 && !config.trim) {
+    return;
+  }
+#ifdef __GLIBC__
+  if (config.arenas != 0 && mallopt(M_ARENA_MAX, config.arenas) == 0) {
+    Logger::warn() << "Cannot limit malloc to " << config.arenas
+                   << " arenas\n";
+  }
+#else
+  Logger::warn() << "The heap options need glibc, ignoring them\n";
+  trimEnabled = false;
+#endif
+}
+
+void mull::trimHeap() {
+#ifdef __GLIBC__
+  if (trimEnabled) {
+    malloc_trim(0);
+  }
+#endif
+}
@@ -28,19 +28,36 @@ void NormalIDEDiagnostics::report(mull::MutationPoint *mutationPoint,
     return;
   }
 
+  auto &location = mutationPoint->getSourceLocation();
+  std::string fileNameOrNil = location.filePath();
+  std::string lineOrNil = std::to_string(location.line);
+  std::string columnOrNil = std::to_string(location.column);
+
+  /// The instruction is gone once the IR is released, its debug info once
+  /// it is stripped, see MutantDebugInfo
   Instruction *instruction =
-      dyn_cast<Instruction>(mutationPoint->getOriginalValue());
-  if (instruction->getMetadata(0) == nullptr) {
+      dyn_cast_or_null<Instruction>(mutationPoint->getOriginalValue());
+  if (instruction && instruction->getMetadata(0) != nullptr) {
+    const DebugLoc &debugLoc = instruction->getDebugLoc();
+    fileNameOrNil = debugLoc->getFilename().str();
+    lineOrNil = std::to_string(debugLoc->getLine());
+    columnOrNil = std::to_string(debugLoc->getColumn());
+  } else if (location.isNull()) {
     return;
   }
 
-  const DebugLoc &debugLoc = instruction->getDebugLoc();
-
-  std::string fileNameOrNil = debugLoc->getFilename().str();
-  std::string lineOrNil = std::to_string(debugLoc->getLine());
-  std::string columnOrNil = std::to_string(debugLoc->getColumn());
-
   errs() << "\n";
   errs() << fileNameOrNil << ":" << lineOrNil << ":" << columnOrNil << ": "
          << "warning: " << diagnostics << "\n";
+
+  auto line = sourceCache.getLine(location);
+  auto caret = SourceCache::caret(line, location.column);
+  if (caret.empty()) {
+    return;
+  }
+  errs() << line;
+  if (!line.endswith("\n")) {
+    errs() << "\n";
+  }
+  errs() << caret << "\n";
 }
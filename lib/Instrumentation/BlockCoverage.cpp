@@ -0,0 +1,27 @@
+#include "mull/Instrumentation/BlockCoverage.h"
+
+#include <algorithm>
+
+using namespace mull;
+
+void BlockCoverage::setFirstBlock(const llvm::Function *function,
+                                  uint32_t block) {
+  firstBlocks[function] = block;
+}
+
+void BlockCoverage::setCoveredBlocks(const Test *test,
+                                     std::vector<uint32_t> blocks) {
+  std::lock_guard<std::mutex> lock(mutex);
+  coveredBlocks[test] = std::move(blocks);
+}
+
+bool BlockCoverage::executed(const Test *test, const llvm::Function *function,
+                             int basicBlockIndex) const {
+  auto firstBlock = firstBlocks.find(function);
+  auto blocks = coveredBlocks.find(test);
+  if (firstBlock == firstBlocks.end() || blocks == coveredBlocks.end()) {
+    return true;
+  }
+  return std::binary_search(blocks->second.begin(), blocks->second.end(),
+                            firstBlock->second + uint32_t(basicBlockIndex));
+}
@@ -0,0 +1,159 @@
+#include "mull/Instrumentation/CallSampler.h"
+
+#include <cstring>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+using namespace mull;
+
+#ifdef __linux__
+
+static int openSampler(uint32_t type, uint64_t config, uint64_t period,
+                       bool branchRecords) {
+  struct perf_event_attr attributes;
+  memset(&attributes, 0, sizeof(attributes));
+  attributes.type = type;
+  attributes.size = sizeof(attributes);
+  attributes.config = config;
+  attributes.sample_period = period;
+  attributes.sample_type = PERF_SAMPLE_IP;
+  if (branchRecords) {
+    attributes.sample_type |= PERF_SAMPLE_BRANCH_STACK;
+    attributes.branch_sample_type =
+        PERF_SAMPLE_BRANCH_USER | PERF_SAMPLE_BRANCH_ANY_CALL;
+  }
+  attributes.disabled = 1;
+  /// What a process may sample with the default perf_event_paranoid
+  attributes.exclude_kernel = 1;
+  attributes.exclude_hv = 1;
+  return int(syscall(SYS_perf_event_open, &attributes, 0, -1, -1,
+                     PERF_FLAG_FD_CLOEXEC));
+}
+
+/// The records may wrap around the end of the ring
+static void readRing(const char *data, size_t size, uint64_t offset,
+                     void *bytes, size_t count) {
+  auto out = static_cast<char *>(bytes);
+  for (size_t index = 0; index < count; index++) {
+    out[index] = data[(offset + index) & (size - 1)];
+  }
+}
+
+#endif
+
+CallSampler::CallSampler(uint64_t period)
+    : descriptor(-1), branchRecords(false), ring(nullptr), ringSize(0) {
+#ifdef __linux__
+  if (period == 0) {
+    return;
+  }
+  /// The branch records first, then the instruction pointers alone, then a
+  /// software clock for the machines without hardware counters
+  descriptor = openSampler(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES,
+                           period, true);
+  branchRecords = descriptor != -1;
+  if (descriptor == -1) {
+    descriptor = openSampler(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES,
+                             period, false);
+  }
+  if (descriptor == -1) {
+    descriptor = openSampler(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_CLOCK,
+                             period, false);
+  }
+  if (descriptor == -1) {
+    return;
+  }
+
+  /// A header page followed by the ring
+  ringSize = (RingPages + 1) * size_t(sysconf(_SC_PAGESIZE));
+  ring = mmap(nullptr, ringSize, PROT_READ | PROT_WRITE, MAP_SHARED,
+              descriptor, 0);
+  if (ring == MAP_FAILED) {
+    ring = nullptr;
+    close(descriptor);
+    descriptor = -1;
+    branchRecords = false;
+    return;
+  }
+  ioctl(descriptor, PERF_EVENT_IOC_ENABLE, 0);
+#else
+  (void)period;
+#endif
+}
+
+CallSampler::~CallSampler() {
+#ifdef __linux__
+  if (ring) {
+    munmap(ring, ringSize);
+  }
+#endif
+  if (descriptor != -1) {
+    close(descriptor);
+  }
+}
+
+bool CallSampler::isSampling() const { return descriptor != -1; }
+
+bool CallSampler::hasBranchRecords() const { return branchRecords; }
+
+void CallSampler::drain(uint64_t *samples, uint64_t capacity) {
+  samples[0] = 0;
+#ifdef __linux__
+  if (descriptor == -1) {
+    return;
+  }
+  ioctl(descriptor, PERF_EVENT_IOC_DISABLE, 0);
+
+  auto header = static_cast<perf_event_mmap_page *>(ring);
+  const size_t pageSize = size_t(sysconf(_SC_PAGESIZE));
+  const char *data = static_cast<const char *>(ring) + pageSize;
+  const size_t dataSize = RingPages * pageSize;
+  uint64_t head = header->data_head;
+  __sync_synchronize();
+  uint64_t tail = header->data_tail;
+
+  uint64_t count = 0;
+  auto add = [&](uint64_t address) {
+    if (address != 0 && count < capacity) {
+      samples[++count] = address;
+    }
+  };
+  while (tail < head && count < capacity) {
+    struct perf_event_header record;
+    readRing(data, dataSize, tail, &record, sizeof(record));
+    if (record.size == 0) {
+      break;
+    }
+    if (record.type == PERF_RECORD_SAMPLE) {
+      uint64_t offset = tail + sizeof(record);
+      uint64_t ip = 0;
+      readRing(data, dataSize, offset, &ip, sizeof(ip));
+      add(ip);
+      offset += sizeof(ip);
+      if (branchRecords) {
+        uint64_t branches = 0;
+        readRing(data, dataSize, offset, &branches, sizeof(branches));
+        offset += sizeof(branches);
+        for (uint64_t branch = 0; branch < branches; branch++) {
+          struct perf_branch_entry entry;
+          readRing(data, dataSize, offset, &entry, sizeof(entry));
+          offset += sizeof(entry);
+          add(entry.from);
+          add(entry.to);
+        }
+      }
+    }
+    tail += record.size;
+  }
+  header->data_tail = tail;
+  samples[0] = count;
+#else
+  (void)capacity;
+#endif
+}
@@ -0,0 +1,128 @@
+#include "mull/Instrumentation/CallTreeMapping.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace mull;
+
+static size_t directorySize(size_t functions) {
+  return (functions + CallTreeMapping::PageSize - 1) /
+         CallTreeMapping::PageSize;
+}
+
+/// The pages are aligned to PageSize words within the block
+static size_t firstPage(size_t functions) {
+  size_t header = CallTreeMapping::DirectoryOffset + directorySize(functions);
+  return (header + CallTreeMapping::PageSize - 1) / CallTreeMapping::PageSize *
+         CallTreeMapping::PageSize;
+}
+
+size_t CallTreeMapping::size(size_t functions) {
+  size_t words = firstPage(functions) + directorySize(functions) * PageSize;
+  return sizeof(uint32_t) * words;
+}
+
+void CallTreeMapping::initialize(uint32_t *mapping, size_t functions) {
+  mapping[0] = 0;
+  mapping[1] = firstPage(functions);
+}
+
+uint32_t *CallTreeMapping::slot(uint32_t *mapping, uint32_t functionIndex) {
+  uint32_t *entry = &mapping[DirectoryOffset + functionIndex / PageSize];
+  uint32_t page = __atomic_load_n(entry, __ATOMIC_ACQUIRE);
+  if (page == 0 || page == Allocating) {
+    page = allocatePage(mapping, functionIndex);
+  }
+  return &mapping[page + functionIndex % PageSize];
+}
+
+uint32_t CallTreeMapping::allocatePage(uint32_t *mapping,
+                                       uint32_t functionIndex) {
+  uint32_t *entry = &mapping[DirectoryOffset + functionIndex / PageSize];
+  uint32_t page = 0;
+  if (__atomic_compare_exchange_n(entry, &page, Allocating, false,
+                                  __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) {
+    uint32_t used = __atomic_fetch_add(&mapping[0], 1, __ATOMIC_RELAXED);
+    page = mapping[1] + used * PageSize;
+    __atomic_store_n(entry, page, __ATOMIC_RELEASE);
+    return page;
+  }
+
+  /// Another thread won, the page is ready once it publishes the offset
+  while (page == Allocating) {
+    page = __atomic_load_n(entry, __ATOMIC_ACQUIRE);
+  }
+  return page;
+}
+
+uint32_t CallTreeMapping::get(const uint32_t *mapping,
+                              uint32_t functionIndex) {
+  uint32_t page = mapping[DirectoryOffset + functionIndex / PageSize];
+  if (page == 0) {
+    return 0;
+  }
+  return mapping[page + functionIndex % PageSize];
+}
+
+void CallTreeMapping::extractCalls(
+    uint32_t *mapping, size_t functions,
+    std::vector<std::pair<uint32_t, uint32_t>> &calls) {
+  for (size_t directory = 0; directory < directorySize(functions);
+       directory++) {
+    uint32_t page = mapping[DirectoryOffset + directory];
+    mapping[DirectoryOffset + directory] = 0;
+    /// A page being handed out when the run ended was never written to
+    if (page == 0 || page == Allocating) {
+      continue;
+    }
+
+    uint32_t *entries = &mapping[page];
+    for (size_t offset = nextNonZero(entries, 0, PageSize); offset < PageSize;
+         offset = nextNonZero(entries, offset + 1, PageSize)) {
+      uint32_t caller = entries[offset];
+      entries[offset] = 0;
+      uint32_t function = directory * PageSize + offset;
+      calls.emplace_back(caller == function ? 0 : caller, function);
+    }
+  }
+  mapping[0] = 0;
+}
+
+void CallTreeMapping::clear(uint32_t *mapping, size_t functions) {
+  for (size_t directory = 0; directory < directorySize(functions);
+       directory++) {
+    uint32_t page = mapping[DirectoryOffset + directory];
+    if (page == 0) {
+      continue;
+    }
+    if (page != Allocating) {
+      memset(&mapping[page], 0, sizeof(uint32_t) * PageSize);
+    }
+    mapping[DirectoryOffset + directory] = 0;
+  }
+  mapping[0] = 0;
+}
+
+size_t CallTreeMapping::nextNonZero(const uint32_t *words, size_t begin,
+                                    size_t end) {
+  /// Eight words, the width of an AVX2 register: the compiler turns the
+  /// test of a whole chunk into a few vector instructions
+  const size_t chunkSize = 8;
+  while (begin < end) {
+    size_t chunkEnd = std::min(begin + chunkSize, end);
+    if (chunkEnd - begin == chunkSize) {
+      uint64_t chunk[chunkSize / 2];
+      memcpy(chunk, words + begin, sizeof(chunk));
+      if ((chunk[0] | chunk[1] | chunk[2] | chunk[3]) == 0) {
+        begin = chunkEnd;
+        continue;
+      }
+    }
+    for (; begin < chunkEnd; begin++) {
+      if (words[begin] != 0) {
+        return begin;
+      }
+    }
+  }
+  return end;
+}
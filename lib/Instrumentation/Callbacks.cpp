@@ -1,38 +1,125 @@
 #include "mull/Instrumentation/Callbacks.h"
 
 #include "mull/Driver.h"
+#include "mull/Instrumentation/CallTreeMapping.h"
 #include "mull/Instrumentation/DynamicCallTree.h"
 #include "mull/Instrumentation/Instrumentation.h"
+#include "mull/Instrumentation/InstrumentationInfo.h"
+#include "mull/Instrumentation/LoopBudget.h"
 #include "mull/MullModule.h"
 
 #include <llvm/IR/Constants.h>
 #include <llvm/IR/GlobalVariable.h>
 #include <llvm/IR/Instructions.h>
 #include <llvm/IR/Module.h>
+#include <llvm/Support/MathExtras.h>
+#include <llvm/Transforms/Utils/BasicBlockUtils.h>
+
+#include <stack>
+#include <vector>
 
 using namespace mull;
 using namespace llvm;
 
+namespace {
+struct ThreadCallStack {
+  const InstrumentationInfo *info;
+  uint64_t run;
+  std::stack<uint32_t> stack;
+  uint32_t testBodyDepth;
+};
+} // namespace
+
+/// The call stack of the calling thread within the current run of the test,
+/// so that the threads spawned by a test do not share one stack
+static ThreadCallStack &threadCallStack(const InstrumentationInfo *info) {
+  static thread_local ThreadCallStack callStack = {
+      nullptr, 0, {}, InstrumentationInfo::OutsideTestBody};
+  if (callStack.info != info || callStack.run != info->run) {
+    std::stack<uint32_t>().swap(callStack.stack);
+    callStack.info = info;
+    callStack.run = info->run;
+    callStack.testBodyDepth = InstrumentationInfo::OutsideTestBody;
+  }
+  return callStack;
+}
+
 namespace mull {
 
 extern "C" void mull_enterFunction(void **trampoline, uint32_t functionIndex) {
   InstrumentationInfo *info = (InstrumentationInfo *)*trampoline;
   assert(info);
   assert(info->callTreeMapping);
-  DynamicCallTree::enterFunction(functionIndex, info->callTreeMapping,
-                                 info->callstack);
+  auto &callStack = threadCallStack(info);
+  auto &stack = callStack.stack;
+  if (DynamicCallTree::enterBounded(functionIndex, stack.size(),
+                                    info->testBody, info->maxDistance,
+                                    callStack.testBodyDepth)) {
+    DynamicCallTree::recordCaller(
+        functionIndex,
+        CallTreeMapping::slot(info->callTreeMapping, functionIndex), stack);
+  }
+  stack.push(functionIndex);
+}
+
+/// Called by the inline callbacks the first time a page of the mapping is
+/// reached
+extern "C" uint32_t mull_allocateCallTreePage(uint32_t *mapping,
+                                              uint32_t functionIndex) {
+  return CallTreeMapping::allocatePage(mapping, functionIndex);
 }
 
 extern "C" void mull_leaveFunction(void **trampoline, uint32_t functionIndex) {
   InstrumentationInfo *info = (InstrumentationInfo *)*trampoline;
   assert(info);
   assert(info->callTreeMapping);
+  auto &callStack = threadCallStack(info);
   DynamicCallTree::leaveFunction(functionIndex, info->callTreeMapping,
-                                 info->callstack);
+                                 callStack.stack);
+  DynamicCallTree::leaveBounded(callStack.stack.size(),
+                                callStack.testBodyDepth);
 }
 
 } // namespace mull
 
+Callbacks::Callbacks(bool guarded) : guarded(guarded) {}
+
+Instruction *Callbacks::guard(Value *infoPointer, Instruction *insertBefore) {
+  if (!guarded) {
+    return insertBefore;
+  }
+
+  /// if (mull_instrumentation_info != nullptr) { callback }
+  Value *info = new LoadInst(infoPointer, "guardInfo", insertBefore);
+  Value *isEnabled = new ICmpInst(
+      insertBefore, ICmpInst::ICMP_NE, info,
+      ConstantPointerNull::get(cast<PointerType>(info->getType())),
+      "isInstrumented");
+  return SplitBlockAndInsertIfThen(isEnabled, insertBefore, false);
+}
+
+/// Whatever is split off the entry block, the allocas stay in front of it so
+/// that they are still static
+static Instruction *firstNonAlloca(Function *function) {
+  auto &entryBlock = *function->getBasicBlockList().begin();
+  auto instruction = &*entryBlock.getInstList().begin();
+  while (isa<AllocaInst>(instruction)) {
+    instruction = instruction->getNextNode();
+  }
+  return instruction;
+}
+
+/// Collected up front, the guards split the blocks they are found in
+static std::vector<ReturnInst *> returnInstructions(Function *function) {
+  std::vector<ReturnInst *> returns;
+  for (auto &block : function->getBasicBlockList()) {
+    if (auto returnStatement = dyn_cast<ReturnInst>(block.getTerminator())) {
+      returns.push_back(returnStatement);
+    }
+  }
+  return returns;
+}
+
 Value *Callbacks::injectInstrumentationInfoPointer(Module *module,
                                                    const char *variableName) {
   auto &context = module->getContext();
@@ -85,7 +172,9 @@ void Callbacks::injectCallbacks(llvm::Function *function, uint32_t index,
   Value *functionIndex = ConstantInt::get(intType, index);
 
   auto &entryBlock = *function->getBasicBlockList().begin();
-  auto firstInstruction = &*entryBlock.getInstList().begin();
+  auto firstInstruction = guarded ? firstNonAlloca(function)
+                                  : &*entryBlock.getInstList().begin();
+  firstInstruction = guard(infoPointer, firstInstruction);
 
   Value *offsetValue = new LoadInst(offset, "offset", firstInstruction);
   Value *indexAndOffset =
@@ -97,11 +186,8 @@ void Callbacks::injectCallbacks(llvm::Function *function, uint32_t index,
       CallInst::Create(enterFunction, enterParameters);
   enterFunctionCall->insertBefore(firstInstruction);
 
-  for (auto &block : function->getBasicBlockList()) {
-    ReturnInst *returnStatement = nullptr;
-    if (!(returnStatement = dyn_cast<ReturnInst>(block.getTerminator()))) {
-      continue;
-    }
+  for (auto returnInstruction : returnInstructions(function)) {
+    auto returnStatement = guard(infoPointer, returnInstruction);
 
     Value *offsetValue = new LoadInst(offset, "offset", returnStatement);
     Value *indexAndOffset =
@@ -114,3 +200,320 @@ void Callbacks::injectCallbacks(llvm::Function *function, uint32_t index,
     leaveFunctionCall->insertBefore(returnStatement);
   }
 }
+
+/// Mirrors the fields of InstrumentationInfo read by the inline callbacks
+static StructType *inlineInfoType(LLVMContext &context) {
+  auto intType = Type::getInt32Ty(context);
+  std::vector<Type *> fields({intType->getPointerTo(), intType->getPointerTo(),
+                              intType, Type::getInt8PtrTy(context),
+                              Type::getInt8PtrTy(context),
+                              Type::getInt64PtrTy(context), intType, intType,
+                              intType});
+  return StructType::get(context, fields);
+}
+
+static Value *infoField(Value *info, StructType *infoType, unsigned field,
+                        const Twine &name, Instruction *insertBefore) {
+  auto intType = Type::getInt32Ty(info->getContext());
+  std::vector<Value *> indices(
+      {ConstantInt::get(intType, 0), ConstantInt::get(intType, field)});
+  return GetElementPtrInst::CreateInBounds(infoType, info, indices, name,
+                                           insertBefore);
+}
+
+static Value *loadInfo(Value *infoPointer, StructType *infoType,
+                       Instruction *insertBefore) {
+  Value *rawInfo = new LoadInst(infoPointer, "info", insertBefore);
+  return new BitCastInst(rawInfo, infoType->getPointerTo(), "info",
+                         insertBefore);
+}
+
+void Callbacks::injectInlineCallbacks(llvm::Function *function, uint32_t index,
+                                      Value *infoPointer, Value *offset,
+                                      bool bounded) {
+  auto &context = function->getParent()->getContext();
+  auto intType = Type::getInt32Ty(context);
+  auto infoType = inlineInfoType(context);
+
+  Value *functionIndex = ConstantInt::get(intType, index);
+  Value *zero = ConstantInt::get(intType, 0);
+  Value *one = ConstantInt::get(intType, 1);
+  Value *stackSize =
+      ConstantInt::get(intType, InstrumentationInfo::ShadowStackSize);
+  Value *lastFrame =
+      ConstantInt::get(intType, InstrumentationInfo::ShadowStackSize - 1);
+
+  std::vector<Type *> allocateParameterTypes(
+      {intType->getPointerTo(), intType});
+  FunctionType *allocateType =
+      FunctionType::get(intType, allocateParameterTypes, false);
+  Function *allocatePage =
+      function->getParent()->getFunction("mull_allocateCallTreePage");
+  if (allocatePage == nullptr) {
+    allocatePage =
+        Function::Create(allocateType, Function::ExternalLinkage,
+                         "mull_allocateCallTreePage", function->getParent());
+  }
+
+  /// The entry block is split below
+  auto entry = guard(infoPointer, firstNonAlloca(function));
+
+  /// The same as DynamicCallTree::enterFunction:
+  ///   *slot = depth == 0 ? index
+  ///         : *slot == 0 ? stack[depth - 1]
+  ///         : *slot;
+  ///   stack[depth++] = index;
+  /// with the frames past the end of the stack folded into the last one
+  Value *info = loadInfo(infoPointer, infoType, entry);
+  Value *mapping = new LoadInst(infoField(info, infoType, 0, "", entry),
+                                "mapping", entry);
+  Value *stack =
+      new LoadInst(infoField(info, infoType, 1, "", entry), "stack", entry);
+  Value *depthAddress = infoField(info, infoType, 2, "depthAddress", entry);
+  Value *depth = new LoadInst(depthAddress, "depth", entry);
+
+  Value *offsetValue = new LoadInst(offset, "offset", entry);
+  Value *indexAndOffset = BinaryOperator::Create(
+      Instruction::Add, functionIndex, offsetValue, "functionIndex", entry);
+
+  /// The mapping is only updated behind the check of enterBounded:
+  ///   if (index == testBody && testBodyDepth == OutsideTestBody)
+  ///     testBodyDepth = depth;
+  ///   if (testBody == 0 || (testBodyDepth != OutsideTestBody &&
+  ///                         depth - testBodyDepth <= maxDistance))
+  auto record = entry;
+  if (bounded) {
+    Value *outside =
+        ConstantInt::get(intType, InstrumentationInfo::OutsideTestBody);
+    Value *testBody = new LoadInst(infoField(info, infoType, 6, "", entry),
+                                   "testBody", entry);
+    Value *maxDistance = new LoadInst(infoField(info, infoType, 7, "", entry),
+                                      "maxDistance", entry);
+    Value *testBodyDepthAddress =
+        infoField(info, infoType, 8, "testBodyDepthAddress", entry);
+    Value *knownDepth =
+        new LoadInst(testBodyDepthAddress, "knownTestBodyDepth", entry);
+    Value *entersTestBody = BinaryOperator::Create(
+        Instruction::And,
+        new ICmpInst(entry, ICmpInst::ICMP_EQ, indexAndOffset, testBody),
+        new ICmpInst(entry, ICmpInst::ICMP_EQ, knownDepth, outside), "",
+        entry);
+    Value *testBodyDepth = SelectInst::Create(entersTestBody, depth,
+                                              knownDepth, "testBodyDepth",
+                                              entry);
+    new StoreInst(testBodyDepth, testBodyDepthAddress, entry);
+
+    Value *withinDistance = BinaryOperator::Create(
+        Instruction::And,
+        new ICmpInst(entry, ICmpInst::ICMP_NE, testBodyDepth, outside),
+        new ICmpInst(entry, ICmpInst::ICMP_ULE,
+                     BinaryOperator::Create(Instruction::Sub, depth,
+                                            testBodyDepth, "", entry),
+                     maxDistance),
+        "", entry);
+    Value *isRecorded = BinaryOperator::Create(
+        Instruction::Or,
+        new ICmpInst(entry, ICmpInst::ICMP_EQ, testBody, zero),
+        withinDistance, "isRecorded", entry);
+    record = SplitBlockAndInsertIfThen(isRecorded, entry, false);
+  }
+
+  /// The entry lives in a page of the CallTreeMapping:
+  ///   page = mapping[DirectoryOffset + index / PageSize];
+  ///   if (page == 0 || page == Allocating)
+  ///     page = mull_allocateCallTreePage(mapping, index);
+  ///   slot = &mapping[page + index % PageSize];
+  Value *directory = BinaryOperator::Create(
+      Instruction::Add,
+      BinaryOperator::Create(
+          Instruction::LShr, indexAndOffset,
+          ConstantInt::get(intType, Log2_32(CallTreeMapping::PageSize)), "",
+          record),
+      ConstantInt::get(intType, CallTreeMapping::DirectoryOffset), "", record);
+  Value *knownPage =
+      new LoadInst(GetElementPtrInst::CreateInBounds(intType, mapping,
+                                                     directory, "", record),
+                   "knownPage", record);
+  Value *isMissing = BinaryOperator::Create(
+      Instruction::Or, new ICmpInst(record, ICmpInst::ICMP_EQ, knownPage, zero),
+      new ICmpInst(record, ICmpInst::ICMP_EQ, knownPage,
+                   ConstantInt::get(intType, CallTreeMapping::Allocating)),
+      "isMissing", record);
+
+  BasicBlock *knownBlock = record->getParent();
+  auto allocateTerminator = SplitBlockAndInsertIfThen(isMissing, record, false);
+  std::vector<Value *> allocateParameters({mapping, indexAndOffset});
+  Value *allocatedPage = CallInst::Create(allocatePage, allocateParameters,
+                                          "allocatedPage", allocateTerminator);
+  PHINode *page = PHINode::Create(intType, 2, "page", record);
+  page->addIncoming(knownPage, knownBlock);
+  page->addIncoming(allocatedPage, allocateTerminator->getParent());
+
+  Value *pageOffset = BinaryOperator::Create(
+      Instruction::And, indexAndOffset,
+      ConstantInt::get(intType, CallTreeMapping::PageSize - 1), "", record);
+  Value *slot = GetElementPtrInst::CreateInBounds(
+      intType, mapping,
+      BinaryOperator::Create(Instruction::Add, page, pageOffset, "", record),
+      "", record);
+  Value *knownParent = new LoadInst(slot, "knownParent", record);
+
+  Value *previousDepth =
+      BinaryOperator::Create(Instruction::Sub, depth, one, "", record);
+  Value *previousFits = new ICmpInst(record, ICmpInst::ICMP_ULT,
+                                     previousDepth, stackSize);
+  Value *parentFrame =
+      SelectInst::Create(previousFits, previousDepth, lastFrame, "", record);
+  Value *parent =
+      new LoadInst(GetElementPtrInst::CreateInBounds(intType, stack,
+                                                     parentFrame, "", record),
+                   "parent", record);
+
+  Value *isRoot = new ICmpInst(record, ICmpInst::ICMP_EQ, depth, zero);
+  Value *isUnknown = new ICmpInst(record, ICmpInst::ICMP_EQ, knownParent, zero);
+  Value *callerParent =
+      SelectInst::Create(isUnknown, parent, knownParent, "", record);
+  Value *newParent =
+      SelectInst::Create(isRoot, indexAndOffset, callerParent, "", record);
+  new StoreInst(newParent, slot, record);
+
+  Value *depthFits = new ICmpInst(entry, ICmpInst::ICMP_ULT, depth, stackSize);
+  Value *frame = SelectInst::Create(depthFits, depth, lastFrame, "", entry);
+  new StoreInst(indexAndOffset,
+                GetElementPtrInst::CreateInBounds(intType, stack, frame, "",
+                                                  entry),
+                entry);
+  new StoreInst(BinaryOperator::Create(Instruction::Add, depth, one, "", entry),
+                depthAddress, entry);
+
+  for (auto returnInstruction : returnInstructions(function)) {
+    auto returnStatement = guard(infoPointer, returnInstruction);
+
+    Value *info = loadInfo(infoPointer, infoType, returnStatement);
+    Value *depthAddress =
+        infoField(info, infoType, 2, "depthAddress", returnStatement);
+    Value *depth = new LoadInst(depthAddress, "depth", returnStatement);
+    Value *newDepth = BinaryOperator::Create(Instruction::Sub, depth, one, "",
+                                             returnStatement);
+    new StoreInst(newDepth, depthAddress, returnStatement);
+
+    if (bounded) {
+      /// The same as DynamicCallTree::leaveBounded
+      Value *testBodyDepthAddress = infoField(
+          info, infoType, 8, "testBodyDepthAddress", returnStatement);
+      Value *testBodyDepth = new LoadInst(testBodyDepthAddress,
+                                          "testBodyDepth", returnStatement);
+      Value *leavesTestBody =
+          new ICmpInst(returnStatement, ICmpInst::ICMP_EQ, newDepth,
+                       testBodyDepth, "leavesTestBody");
+      new StoreInst(
+          SelectInst::Create(
+              leavesTestBody,
+              ConstantInt::get(intType, InstrumentationInfo::OutsideTestBody),
+              testBodyDepth, "", returnStatement),
+          testBodyDepthAddress, returnStatement);
+    }
+  }
+}
+
+void Callbacks::injectCoverageCallback(llvm::Function *function, uint32_t index,
+                                       Value *infoPointer, Value *offset) {
+  auto &context = function->getParent()->getContext();
+  auto intType = Type::getInt32Ty(context);
+  auto byteType = Type::getInt8Ty(context);
+  auto infoType = inlineInfoType(context);
+
+  Value *functionIndex = ConstantInt::get(intType, index);
+
+  auto &entryBlock = *function->getBasicBlockList().begin();
+  auto entry = guarded ? firstNonAlloca(function)
+                       : &*entryBlock.getInstList().begin();
+  entry = guard(infoPointer, entry);
+
+  /// coverage[index / 8] |= 1 << (index % 8);
+  Value *info = loadInfo(infoPointer, infoType, entry);
+  Value *coverage = new LoadInst(infoField(info, infoType, 3, "", entry),
+                                 "coverage", entry);
+
+  Value *offsetValue = new LoadInst(offset, "offset", entry);
+  Value *indexAndOffset = BinaryOperator::Create(
+      Instruction::Add, functionIndex, offsetValue, "functionIndex", entry);
+
+  Value *byteIndex = BinaryOperator::Create(
+      Instruction::LShr, indexAndOffset, ConstantInt::get(intType, 3), "",
+      entry);
+  Value *bitIndex = BinaryOperator::Create(
+      Instruction::And, indexAndOffset, ConstantInt::get(intType, 7), "",
+      entry);
+  Value *bit = BinaryOperator::Create(
+      Instruction::Shl, ConstantInt::get(byteType, 1),
+      new TruncInst(bitIndex, byteType, "", entry), "bit", entry);
+
+  Value *byteAddress = GetElementPtrInst::CreateInBounds(byteType, coverage,
+                                                         byteIndex, "", entry);
+  Value *byte = new LoadInst(byteAddress, "byte", entry);
+  new StoreInst(BinaryOperator::Create(Instruction::Or, byte, bit, "", entry),
+                byteAddress, entry);
+}
+
+void Callbacks::injectBlockCoverage(llvm::Function *function,
+                                    uint32_t firstBlock, Value *infoPointer,
+                                    Value *offset) {
+  auto &context = function->getParent()->getContext();
+  auto intType = Type::getInt32Ty(context);
+  auto byteType = Type::getInt8Ty(context);
+  auto infoType = inlineInfoType(context);
+
+  /// Collected up front, the guards split the blocks they are found in
+  std::vector<Instruction *> entries;
+  for (auto &block : function->getBasicBlockList()) {
+    auto entry = block.getFirstInsertionPt();
+    entries.push_back(entry == block.end() ? nullptr : &*entry);
+  }
+  /// The allocas stay in front of the mark, see firstNonAlloca
+  entries.front() = firstNonAlloca(function);
+
+  for (uint32_t index = 0; index < entries.size(); index++) {
+    /// A block that cannot hold the mark, e.g. a catchswitch, is never
+    /// known to be executed
+    if (entries[index] == nullptr) {
+      continue;
+    }
+    auto entry = guard(infoPointer, entries[index]);
+
+    /// blockCoverage[firstBlock + index + offset] = 1;
+    Value *info = loadInfo(infoPointer, infoType, entry);
+    Value *blockCoverage = new LoadInst(infoField(info, infoType, 4, "", entry),
+                                        "blockCoverage", entry);
+    Value *offsetValue = new LoadInst(offset, "blockOffset", entry);
+    Value *blockIndex = BinaryOperator::Create(
+        Instruction::Add, ConstantInt::get(intType, firstBlock + index),
+        offsetValue, "blockIndex", entry);
+    new StoreInst(ConstantInt::get(byteType, 1),
+                  GetElementPtrInst::CreateInBounds(byteType, blockCoverage,
+                                                    blockIndex, "", entry),
+                  entry);
+  }
+}
+
+void Callbacks::injectBackEdgeCounter(llvm::Function *function,
+                                      Value *infoPointer) {
+  auto &context = function->getParent()->getContext();
+  auto longType = Type::getInt64Ty(context);
+  auto infoType = inlineInfoType(context);
+
+  for (auto latch : backEdgeTerminators(function)) {
+    auto insertBefore = guard(infoPointer, latch);
+
+    /// *backEdges += 1;
+    Value *info = loadInfo(infoPointer, infoType, insertBefore);
+    Value *backEdges =
+        new LoadInst(infoField(info, infoType, 5, "", insertBefore),
+                     "backEdges", insertBefore);
+    Value *count = new LoadInst(backEdges, "backEdgeCount", insertBefore);
+    new StoreInst(BinaryOperator::Create(Instruction::Add, count,
+                                         ConstantInt::get(longType, 1), "",
+                                         insertBefore),
+                  backEdges, insertBefore);
+  }
+}
@@ -1,8 +1,11 @@
 #include "mull/Instrumentation/DynamicCallTree.h"
 
+#include "mull/Instrumentation/CallTreeMapping.h"
+#include "mull/Instrumentation/InstrumentationInfo.h"
 #include "mull/TestFrameworks/Test.h"
 #include "mull/Testee.h"
 
+#include <algorithm>
 #include <queue>
 #include <stack>
 
@@ -13,17 +16,27 @@ void DynamicCallTree::enterFunction(const uint32_t functionIndex,
                                     uint32_t *mapping,
                                     std::stack<uint32_t> &stack) {
   assert(functionIndex != 0);
+  recordCaller(functionIndex, &mapping[functionIndex], stack);
+  stack.push(functionIndex);
+}
+
+void DynamicCallTree::recordCaller(const uint32_t functionIndex,
+                                   uint32_t *slot,
+                                   const std::stack<uint32_t> &stack) {
+  /// The stack belongs to the calling thread, the mapping is shared by all
+  /// the threads of the test and is updated atomically
   if (stack.empty()) {
     /// This is the first function in a chain
     /// The root of a tree
-    mapping[functionIndex] = functionIndex;
-  } else if (mapping[functionIndex] == 0) {
-    /// This function has never been called
+    __atomic_store_n(slot, functionIndex, __ATOMIC_RELAXED);
+  } else if (__atomic_load_n(slot, __ATOMIC_RELAXED) == 0) {
+    /// This function has never been called, the first thread to record
+    /// a parent wins
     uint32_t parent = stack.top();
-    mapping[functionIndex] = parent;
+    uint32_t unknown = 0;
+    __atomic_compare_exchange_n(slot, &unknown, parent, false,
+                                __ATOMIC_RELAXED, __ATOMIC_RELAXED);
   }
-
-  stack.push(functionIndex);
 }
 
 void DynamicCallTree::leaveFunction(const uint32_t functionIndex,
@@ -33,41 +46,35 @@ void DynamicCallTree::leaveFunction(const uint32_t functionIndex,
   stack.pop();
 }
 
-void fillInCallTree(std::vector<CallTreeFunction> &functions,
-                    uint32_t *callTreeMapping, uint32_t functionIndex) {
-  assert(functionIndex < functions.size());
-
-  uint32_t parent = callTreeMapping[functionIndex];
-  if (parent == 0) {
-    return;
+bool DynamicCallTree::enterBounded(uint32_t functionIndex, uint32_t depth,
+                                   uint32_t testBody, uint32_t maxDistance,
+                                   uint32_t &testBodyDepth) {
+  if (testBody == 0) {
+    return true;
   }
-
-  if (parent == functionIndex) {
-    parent = 0;
+  if (functionIndex == testBody &&
+      testBodyDepth == InstrumentationInfo::OutsideTestBody) {
+    testBodyDepth = depth;
   }
+  return testBodyDepth != InstrumentationInfo::OutsideTestBody &&
+         depth - testBodyDepth <= maxDistance;
+}
 
-  CallTreeFunction &function = functions[functionIndex];
-  std::unique_ptr<CallTree> node = make_unique<CallTree>(function.function);
-  function.treeRoot = node.get();
-
-  fillInCallTree(functions, callTreeMapping, parent);
-
-  CallTreeFunction root = functions[parent];
-  assert(root.treeRoot);
-  node->level = root.treeRoot->level + 1;
-  node->functionsIndex = functionIndex;
-  root.treeRoot->children.push_back(std::move(node));
-  callTreeMapping[functionIndex] = 0;
+void DynamicCallTree::leaveBounded(uint32_t depth, uint32_t &testBodyDepth) {
+  if (depth == testBodyDepth) {
+    testBodyDepth = InstrumentationInfo::OutsideTestBody;
+  }
 }
 
-std::unique_ptr<CallTree>
-DynamicCallTree::createCallTree(uint32_t *mapping,
-                                std::vector<CallTreeFunction> functions) {
+const uint32_t CallTree::None = UINT32_MAX;
+
+void DynamicCallTree::createCallTree(
+    uint32_t *mapping, const std::vector<CallTreeFunction> &functions,
+    CallTree &callTree) {
   assert(mapping != nullptr);
   assert(mapping[0] == 0);
   assert(!functions.empty());
   assert(functions.begin()->function == nullptr);
-  assert(functions.begin()->treeRoot == nullptr);
 
   ///
   /// Building the Call Tree
@@ -90,67 +97,106 @@ DynamicCallTree::createCallTree(uint32_t *mapping,
   /// When the execution is done we can construct a tree of a  more classic
   /// form.
   ///
+  /// A function is attached to its parent once the parent is attached, so
+  /// for every function the chain of its ancestors that are not in the tree
+  /// yet is collected first, and then attached from the top down.
+  ///
 
-  std::unique_ptr<CallTree> phonyRoot = make_unique<CallTree>(nullptr);
-  CallTreeFunction &rootFunction = functions[0];
-  rootFunction.treeRoot = phonyRoot.get();
+  const size_t size = functions.size();
+  callTree.parents.assign(size, CallTree::None);
+  callTree.firstChildren.assign(size, CallTree::None);
+  callTree.lastChildren.assign(size, CallTree::None);
+  callTree.nextSiblings.assign(size, CallTree::None);
+  callTree.levels.assign(size, -1);
+  callTree.levels[0] = 0;
 
-  for (uint32_t index = 1; index < functions.size(); index++) {
-    fillInCallTree(functions, mapping, index);
-  }
+  auto &chain = callTree.chain;
+  for (size_t index = CallTreeMapping::nextNonZero(mapping, 1, size);
+       index < size;
+       index = CallTreeMapping::nextNonZero(mapping, index + 1, size)) {
+    chain.clear();
+    uint32_t node = index;
+    while (node != 0 && mapping[node] != 0) {
+      uint32_t parent = mapping[node];
+      mapping[node] = 0;
+      chain.push_back(node);
+      node = parent == node ? 0 : parent;
+      callTree.parents[chain.back()] = node;
+    }
 
-  return phonyRoot;
+    for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+      uint32_t child = *it;
+      uint32_t parent = callTree.parents[child];
+      if (!callTree.contains(parent)) {
+        /// The parent was never recorded, e.g. the mapping is inconsistent
+        parent = 0;
+        callTree.parents[child] = parent;
+      }
+
+      callTree.levels[child] = callTree.levels[parent] + 1;
+      if (callTree.firstChildren[parent] == CallTree::None) {
+        callTree.firstChildren[parent] = child;
+      } else {
+        callTree.nextSiblings[callTree.lastChildren[parent]] = child;
+      }
+      callTree.lastChildren[parent] = child;
+    }
+  }
 }
 
-std::vector<CallTree *> DynamicCallTree::extractTestSubtrees(CallTree *root,
-                                                             Test &test) {
-  std::vector<CallTree *> subtrees;
-  std::vector<const Function *> entryPoints = {test.getTestBody()};
+std::vector<uint32_t> DynamicCallTree::extractTestSubtrees(
+    const CallTree &callTree, const std::vector<CallTreeFunction> &functions,
+    Test &test) {
+  std::vector<uint32_t> subtrees;
+  const Function *entryPoint = test.getTestBody();
 
-  std::queue<CallTree *> nodes;
-  nodes.push(root);
+  std::queue<uint32_t> nodes;
+  nodes.push(0);
   while (!nodes.empty()) {
-    CallTree *node = nodes.front();
+    uint32_t node = nodes.front();
     nodes.pop();
 
-    if (std::find(entryPoints.begin(), entryPoints.end(), node->function) !=
-        entryPoints.end()) {
+    if (functions[node].function == entryPoint) {
       subtrees.push_back(node);
     }
 
-    for (auto &child : node->children) {
-      nodes.push(child.get());
+    for (uint32_t child = callTree.firstChild(node); child != CallTree::None;
+         child = callTree.nextSibling(child)) {
+      nodes.push(child);
     }
   }
   return subtrees;
 }
 
-std::vector<std::unique_ptr<Testee>>
-DynamicCallTree::createTestees(std::vector<CallTree *> subtrees, Test &test,
-                               int maxDistance, Filter &filter) {
+std::vector<std::unique_ptr<Testee>> DynamicCallTree::createTestees(
+    const CallTree &callTree, const std::vector<CallTreeFunction> &functions,
+    const std::vector<uint32_t> &subtrees, Test &test, int maxDistance,
+    Filter &filter) {
   std::vector<std::unique_ptr<Testee>> testees;
 
-  for (CallTree *root : subtrees) {
-    const int offset = root->level;
+  for (uint32_t root : subtrees) {
+    const int offset = callTree.level(root);
 
-    std::queue<CallTree *> nodes;
+    std::queue<uint32_t> nodes;
     nodes.push(root);
 
     while (!nodes.empty()) {
-      CallTree *node = nodes.front();
+      uint32_t node = nodes.front();
       nodes.pop();
 
-      if (filter.shouldSkipFunction(node->function)) {
+      Function *function = functions[node].function;
+      if (filter.shouldSkipFunction(function)) {
         continue;
       }
 
-      int distance = node->level - offset;
+      int distance = callTree.level(node) - offset;
       std::unique_ptr<Testee> testee(
-          make_unique<Testee>(node->function, &test, distance));
+          make_unique<Testee>(function, &test, distance, node));
       testees.push_back(std::move(testee));
       if (distance < maxDistance) {
-        for (std::unique_ptr<CallTree> &child : node->children) {
-          nodes.push(child.get());
+        for (uint32_t child = callTree.firstChild(node);
+             child != CallTree::None; child = callTree.nextSibling(child)) {
+          nodes.push(child);
         }
       }
     }
@@ -158,3 +204,62 @@ DynamicCallTree::createTestees(std::vector<CallTree *> subtrees, Test &test,
 
   return testees;
 }
+
+std::vector<std::unique_ptr<Testee>> DynamicCallTree::extractTestees(
+    uint32_t *mapping, const std::vector<CallTreeFunction> &functions,
+    uint32_t testBody, Test &test, int maxDistance, Filter &filter) {
+  std::vector<std::pair<uint32_t, uint32_t>> calls;
+  const size_t size = functions.size();
+  for (size_t index = CallTreeMapping::nextNonZero(mapping, 1, size);
+       index < size;
+       index = CallTreeMapping::nextNonZero(mapping, index + 1, size)) {
+    uint32_t parent = mapping[index];
+    mapping[index] = 0;
+    calls.emplace_back(parent == index ? 0 : parent, index);
+  }
+
+  return extractTestees(calls, functions, testBody, test, maxDistance,
+                        filter);
+}
+
+std::vector<std::unique_ptr<Testee>> DynamicCallTree::extractTestees(
+    std::vector<std::pair<uint32_t, uint32_t>> &calls,
+    const std::vector<CallTreeFunction> &functions, uint32_t testBody,
+    Test &test, int maxDistance, Filter &filter) {
+  std::vector<std::unique_ptr<Testee>> testees;
+
+  auto testBodyCalled =
+      std::find_if(calls.begin(), calls.end(),
+                   [testBody](const std::pair<uint32_t, uint32_t> &call) {
+                     return call.second == testBody;
+                   });
+  if (testBodyCalled == calls.end()) {
+    return testees;
+  }
+
+  /// The callees of every function end up next to each other
+  std::sort(calls.begin(), calls.end());
+
+  std::vector<std::pair<uint32_t, int>> nodes;
+  nodes.emplace_back(testBody, 0);
+  for (size_t head = 0; head < nodes.size(); head++) {
+    const uint32_t node = nodes[head].first;
+    const int distance = nodes[head].second;
+
+    Function *function = functions[node].function;
+    if (filter.shouldSkipFunction(function)) {
+      continue;
+    }
+
+    testees.push_back(make_unique<Testee>(function, &test, distance, node));
+    if (distance < maxDistance) {
+      auto callee = std::lower_bound(calls.begin(), calls.end(),
+                                     std::make_pair(node, uint32_t(0)));
+      for (; callee != calls.end() && callee->first == node; ++callee) {
+        nodes.emplace_back(callee->second, distance + 1);
+      }
+    }
+  }
+
+  return testees;
+}
@@ -1,26 +1,58 @@
 #include "mull/Instrumentation/Instrumentation.h"
 
+#include "mull/Instrumentation/CallTreeMapping.h"
 #include "mull/Instrumentation/DynamicCallTree.h"
+#include "mull/Filter.h"
+#include "mull/Hash.h"
+#include "mull/MullModule.h"
 #include "mull/TestFrameworks/Test.h"
 
+#include <llvm/ADT/Hashing.h>
 #include <llvm/IR/Function.h>
 #include <llvm/IR/Module.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
 #include <sys/mman.h>
 #include <sys/types.h>
 
 using namespace mull;
 using namespace llvm;
 
-Instrumentation::Instrumentation() : callbacks(), functions() {
+/// A test that made calls no other test made keeps its testees in memory
+/// twice, up to this many of them
+static const size_t MaxKnownTestees = 1 << 22;
+
+Instrumentation::Instrumentation(InstrumentationMode mode, bool guarded,
+                                 bool blockCoverage, bool backEdges)
+    : callbacks(guarded), mode(mode), guarded(guarded), functions(),
+      blockCoverageEnabled(blockCoverage), blockCount(0),
+      backEdgesEnabled(backEdges), samplesEnabled(false), filter(nullptr),
+      maxDistance(-1),
+      knownTesteesSize(0) {
   CallTreeFunction phonyRoot(nullptr);
   functions.push_back(phonyRoot);
 }
 
+Instrumentation::~Instrumentation() {
+  for (auto &buffer : freeBuffers) {
+    munmap(buffer.memory, buffer.size);
+  }
+  for (auto shadowStack : freeShadowStacks) {
+    delete[] shadowStack;
+  }
+}
+
 std::map<std::string, uint32_t> &Instrumentation::getFunctionOffsetMapping() {
   return functionOffsetMapping;
 }
 
+std::map<std::string, uint32_t> &Instrumentation::getBlockOffsetMapping() {
+  return blockOffsetMapping;
+}
+
 const char *Instrumentation::instrumentationInfoVariableName() {
   return "mull_instrumentation_info";
 }
@@ -29,16 +61,74 @@ const char *Instrumentation::functionIndexOffsetPrefix() {
   return "mull_function_index_offset_";
 }
 
+const char *Instrumentation::blockIndexOffsetPrefix() {
+  return "mull_block_index_offset_";
+}
+
+static const char *modeSuffix(InstrumentationMode mode) {
+  switch (mode) {
+  case InstrumentationMode::Callbacks:
+    return "";
+  case InstrumentationMode::InlineCallbacks:
+    return "_inline";
+  case InstrumentationMode::Coverage:
+    return "_coverage";
+  case InstrumentationMode::Static:
+    return "_static";
+  }
+}
+
+std::string Instrumentation::cacheSuffix() const {
+  std::string filtered;
+  if (filter && !filter->getFunctionPatterns().empty()) {
+    filtered = "_filtered_" + hashOf(filter->getFunctionPatterns(),
+                                     HashAlgorithm::XXHash64);
+  }
+  /// The calls recorded depend on the distance, not only the code
+  std::string bounded;
+  if (isBounded()) {
+    bounded = "_bounded" + std::to_string(maxDistance);
+  }
+  return std::string(modeSuffix(mode)) + (guarded ? "_guarded" : "") +
+         (blockCoverageEnabled ? "_blocks" : "") +
+         (backEdgesEnabled ? "_loops" : "") + filtered + bounded;
+}
+
+void Instrumentation::setFilter(Filter *filter) { this->filter = filter; }
+
+void Instrumentation::setMaxDistance(int distance) { maxDistance = distance; }
+
+void Instrumentation::enableSamples() { samplesEnabled = true; }
+
+bool Instrumentation::isBounded() const {
+  return maxDistance >= 0 && mode != InstrumentationMode::Coverage &&
+         mode != InstrumentationMode::Static;
+}
+
+bool Instrumentation::isGuarded() const { return guarded; }
+
 void Instrumentation::recordFunctions(llvm::Module *originalModule) {
   uint32_t offset = functions.size();
   functionOffsetMapping[originalModule->getModuleIdentifier()] = offset;
+  if (blockCoverageEnabled) {
+    blockOffsetMapping[originalModule->getModuleIdentifier()] = blockCount;
+  }
 
   for (auto &function : originalModule->getFunctionList()) {
     if (function.isDeclaration()) {
       continue;
     }
     CallTreeFunction callTreeFunction(&function);
+    callTreeFunction.instrumented =
+        !filter || !filter->shouldSkipFunction(&function);
+    functionIndices[&function] = functions.size();
     functions.push_back(callTreeFunction);
+
+    if (blockCoverageEnabled) {
+      MullModule::materialize(&function);
+      blockCoverage.setFirstBlock(&function, blockCount);
+      blockCount += function.size();
+    }
   }
 }
 
@@ -48,44 +138,423 @@ void Instrumentation::insertCallbacks(llvm::Module *instrumentedModule) {
   auto offset = callbacks.injectFunctionIndexOffset(
       instrumentedModule, functionIndexOffsetPrefix());
 
+  Value *blockOffset = nullptr;
+  if (blockCoverageEnabled) {
+    blockOffset = callbacks.injectFunctionIndexOffset(
+        instrumentedModule, blockIndexOffsetPrefix());
+  }
+
+  /// The module is a clone of the recorded one, its functions are in the
+  /// same order
+  auto recorded =
+      functionOffsetMapping.find(instrumentedModule->getModuleIdentifier());
+  const CallTreeFunction *recordedFunctions =
+      recorded != functionOffsetMapping.end() ? &functions[recorded->second]
+                                              : nullptr;
+
   uint32_t index = 0;
+  /// The same numbering as recordFunctions, relative to the module
+  uint32_t firstBlock = 0;
   for (auto &function : instrumentedModule->getFunctionList()) {
     if (function.isDeclaration()) {
       continue;
     }
-    callbacks.injectCallbacks(&function, index, info, offset);
+    /// A filtered function has no mutants, nothing it does is of interest
+    if (recordedFunctions && !recordedFunctions[index].instrumented) {
+      firstBlock += function.size();
+      index++;
+      continue;
+    }
+    if (blockCoverageEnabled) {
+      uint32_t blocks = function.size();
+      callbacks.injectBlockCoverage(&function, firstBlock, info, blockOffset);
+      firstBlock += blocks;
+    }
+    if (backEdgesEnabled) {
+      callbacks.injectBackEdgeCounter(&function, info);
+    }
+    switch (mode) {
+    case InstrumentationMode::Callbacks:
+      callbacks.injectCallbacks(&function, index, info, offset);
+      break;
+    case InstrumentationMode::InlineCallbacks:
+      callbacks.injectInlineCallbacks(&function, index, info, offset,
+                                      isBounded());
+      break;
+    case InstrumentationMode::Coverage:
+      callbacks.injectCoverageCallback(&function, index, info, offset);
+      break;
+    case InstrumentationMode::Static:
+      break;
+    }
     index++;
   }
 }
 
+Instrumentation::Calls Instrumentation::takeCalls(Test &test) {
+  auto &info = test.getInstrumentationInfo();
+  std::vector<std::pair<uint32_t, uint32_t>> indices;
+
+  if (mode == InstrumentationMode::Coverage) {
+    auto coverage = info.coverage;
+    for (uint32_t byte = 0; byte < coverageSize(); byte++) {
+      uint8_t bits = coverage[byte];
+      if (bits == 0) {
+        continue;
+      }
+      coverage[byte] = 0;
+      for (uint32_t bit = 0; bit < 8; bit++) {
+        uint32_t index = byte * 8 + bit;
+        if ((bits & (1 << bit)) == 0 || index == 0 ||
+            index >= functions.size()) {
+          continue;
+        }
+        indices.emplace_back(0, index);
+      }
+    }
+  } else if (mode != InstrumentationMode::Static) {
+    CallTreeMapping::extractCalls(info.callTreeMapping, functions.size(),
+                                  indices);
+  }
+  info.consumed = true;
+
+  Calls calls;
+  calls.reserve(indices.size());
+  for (auto &call : indices) {
+    calls.emplace_back(functions[call.first].function,
+                       functions[call.second].function);
+  }
+  return calls;
+}
+
+std::vector<std::unique_ptr<Testee>>
+Instrumentation::getTestees(const Calls &calls, Test &test, Filter &filter,
+                            int distance) {
+  const llvm::Function *testBody = test.getTestBody();
+  size_t hash =
+      hash_combine(testBody, &filter, distance,
+                   hash_combine_range(calls.begin(), calls.end()));
+  /// A second, independent hash stands for the calls themselves
+  auto callsDigest = hashOf(
+      StringRef(reinterpret_cast<const char *>(calls.data()),
+                calls.size() * sizeof(Calls::value_type)),
+      HashAlgorithm::XXHash64);
+  auto findKnown = [&]() -> const KnownTestees * {
+    auto candidates = knownTestees.equal_range(hash);
+    for (auto it = candidates.first; it != candidates.second; ++it) {
+      auto &known = it->second;
+      if (known.testBody == testBody && known.filter == &filter &&
+          known.distance == distance && known.calls == calls.size() &&
+          known.callsDigest == callsDigest) {
+        return &known;
+      }
+    }
+    return nullptr;
+  };
+
+  {
+    std::lock_guard<std::mutex> lock(knownTesteesMutex);
+    if (auto known = findKnown()) {
+      std::vector<std::unique_ptr<Testee>> testees;
+      for (auto &testee : known->testees) {
+        testees.push_back(make_unique<Testee>(testee.getTesteeFunction(),
+                                              &test, testee.getDistance(),
+                                              testee.getFunctionIndex()));
+      }
+      return testees;
+    }
+  }
+
+  auto testees = findTestees(calls, test, filter, distance);
+
+  std::lock_guard<std::mutex> lock(knownTesteesMutex);
+  /// Another test with the same calls may have been first
+  if (knownTesteesSize + testees.size() > MaxKnownTestees || findKnown()) {
+    return testees;
+  }
+  KnownTestees known = {testBody, &filter, distance, calls.size(),
+                        callsDigest, {}};
+  for (auto &testee : testees) {
+    known.testees.emplace_back(testee->getTesteeFunction(), nullptr,
+                               testee->getDistance(),
+                               testee->getFunctionIndex());
+  }
+  knownTesteesSize += testees.size();
+  knownTestees.emplace(hash, std::move(known));
+  return testees;
+}
+
+void Instrumentation::forgetKnownTestees() {
+  std::lock_guard<std::mutex> lock(knownTesteesMutex);
+  std::unordered_multimap<size_t, KnownTestees>().swap(knownTestees);
+  knownTesteesSize = 0;
+}
+
+std::vector<std::unique_ptr<Testee>>
+Instrumentation::findTestees(const Calls &calls, Test &test, Filter &filter,
+                             int distance) {
+  if (mode == InstrumentationMode::Coverage) {
+    return getCoveredTestees(calls, test, filter, distance);
+  }
+  if (mode == InstrumentationMode::Static) {
+    return std::vector<std::unique_ptr<Testee>>();
+  }
+
+  auto testBody = functionIndices.find(test.getTestBody());
+  if (testBody == functionIndices.end()) {
+    return std::vector<std::unique_ptr<Testee>>();
+  }
+
+  std::vector<std::pair<uint32_t, uint32_t>> indices;
+  indices.reserve(calls.size());
+  for (auto &call : calls) {
+    auto callee = functionIndices.find(call.second);
+    if (callee == functionIndices.end()) {
+      continue;
+    }
+    auto caller = functionIndices.find(call.first);
+    indices.emplace_back(
+        caller == functionIndices.end() ? 0 : caller->second, callee->second);
+  }
+
+  return DynamicCallTree::extractTestees(indices, functions, testBody->second,
+                                         test, distance, filter);
+}
+
+void Instrumentation::takeCoveredBlocks(Test &test) {
+  auto &info = test.getInstrumentationInfo();
+  if (info.blockCoverage == nullptr) {
+    return;
+  }
+
+  /// Most of the blocks are not executed, they are skipped a word at a time
+  std::vector<uint32_t> blocks;
+  auto bytes = info.blockCoverage;
+  for (uint32_t word = 0; word < blockCoverageSize(); word += 8) {
+    uint64_t marks;
+    memcpy(&marks, bytes + word, sizeof(marks));
+    if (marks == 0) {
+      continue;
+    }
+    for (uint32_t block = word; block < word + 8; block++) {
+      if (bytes[block] != 0) {
+        bytes[block] = 0;
+        blocks.push_back(block);
+      }
+    }
+  }
+  blockCoverage.setCoveredBlocks(&test, std::move(blocks));
+
+  releaseBuffer(info.blockCoverage, blockCoverageSize(), true);
+  info.blockCoverage = nullptr;
+}
+
+void Instrumentation::takeBackEdges(Test &test) {
+  auto &info = test.getInstrumentationInfo();
+  if (info.backEdges == nullptr) {
+    return;
+  }
+  test.setBackEdges(*info.backEdges);
+  releaseBuffer(info.backEdges, sizeof(uint64_t), false);
+  info.backEdges = nullptr;
+}
+
+static uint64_t sampleCount(const uint64_t *samples) {
+  const uint64_t capacity = InstrumentationInfo::SampleCapacity;
+  return samples[0] < capacity ? samples[0] : capacity;
+}
+
+std::vector<uint64_t> Instrumentation::takeSamples(Test &test) {
+  auto &info = test.getInstrumentationInfo();
+  if (info.samples == nullptr) {
+    return std::vector<uint64_t>();
+  }
+  auto count = sampleCount(info.samples);
+  std::vector<uint64_t> samples(info.samples + 1, info.samples + 1 + count);
+  releaseSamples(info.samples);
+  info.samples = nullptr;
+  return samples;
+}
+
+/// Only the pages the run wrote to are touched
+void Instrumentation::releaseSamples(uint64_t *samples) {
+  memset(samples, 0, (sampleCount(samples) + 1) * sizeof(uint64_t));
+  releaseBuffer(samples, samplesSize(), true);
+}
+
+const BlockCoverage *Instrumentation::getBlockCoverage() const {
+  return blockCoverageEnabled ? &blockCoverage : nullptr;
+}
+
+/// The test body goes first, as the root of its call tree would
 std::vector<std::unique_ptr<Testee>>
-Instrumentation::getTestees(Test &test, Filter &filter, int distance) {
-  auto &mapping = test.getInstrumentationInfo().callTreeMapping;
+Instrumentation::getCoveredTestees(const Calls &calls, Test &test,
+                                   Filter &filter, int distance) {
+  std::vector<std::unique_ptr<Testee>> testees;
 
-  auto callTree = DynamicCallTree::createCallTree(mapping, functions);
-  auto subtrees = DynamicCallTree::extractTestSubtrees(callTree.get(), test);
-  auto testees =
-      DynamicCallTree::createTestees(subtrees, test, distance, filter);
+  auto testBody = std::find_if(calls.begin(), calls.end(),
+                               [&](const Calls::value_type &call) {
+                                 return call.second == test.getTestBody();
+                               });
+  if (testBody == calls.end() ||
+      filter.shouldSkipFunction(testBody->second)) {
+    return testees;
+  }
+  auto indexOf = [this](llvm::Function *function) {
+    auto index = functionIndices.find(function);
+    return index == functionIndices.end() ? 0 : index->second;
+  };
+  testees.push_back(make_unique<Testee>(testBody->second, &test, 0,
+                                        indexOf(testBody->second)));
+
+  if (distance < 1) {
+    return testees;
+  }
+
+  for (auto &call : calls) {
+    if (call.second == testBody->second ||
+        filter.shouldSkipFunction(call.second)) {
+      continue;
+    }
+    testees.push_back(
+        make_unique<Testee>(call.second, &test, 1, indexOf(call.second)));
+  }
 
   return testees;
 }
 
+size_t Instrumentation::coverageSize() const {
+  return (functions.size() + 7) / 8;
+}
+
+/// A byte rather than a bit per block: the blocks are marked with a plain
+/// store, without reading the byte first. Rounded up to whole words.
+size_t Instrumentation::blockCoverageSize() const {
+  return (blockCount + 8) / 8 * 8;
+}
+
+size_t Instrumentation::samplesSize() const {
+  return (InstrumentationInfo::SampleCapacity + 1) * sizeof(uint64_t);
+}
+
+size_t Instrumentation::mappingSize() const {
+  return CallTreeMapping::size(functions.size());
+}
+
+void *Instrumentation::acquireBuffer(size_t size) {
+  {
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    for (auto it = freeBuffers.begin(); it != freeBuffers.end(); ++it) {
+      if (it->size == size) {
+        void *memory = it->memory;
+        freeBuffers.erase(it);
+        return memory;
+      }
+    }
+  }
+
+  /// Creating a memory to be shared between child and parent.
+  /// Anonymous mappings start zeroed, and only the pages written to are
+  /// backed by memory.
+  return mmap(nullptr, size, PROT_READ | PROT_WRITE,
+              MAP_SHARED | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+}
+
+void Instrumentation::releaseBuffer(void *memory, size_t size, bool zeroed) {
+  if (!zeroed) {
+    memset(memory, 0, size);
+  }
+  std::lock_guard<std::mutex> lock(buffersMutex);
+  freeBuffers.push_back({memory, size});
+}
+
 void Instrumentation::setupInstrumentationInfo(Test &test) {
-  auto &mapping = test.getInstrumentationInfo().callTreeMapping;
+  static std::atomic<uint64_t> runs(0);
 
-  assert(mapping == nullptr && "Called twice?");
+  auto &info = test.getInstrumentationInfo();
+  auto &mapping = info.callTreeMapping;
+  info.run = ++runs;
+  info.consumed = false;
+
+  assert(mapping == nullptr && info.coverage == nullptr && "Called twice?");
   assert(functions.size() > 1 &&
          "Functions must be filled in before this call");
 
-  auto mappingSize = sizeof(mapping[0]) * functions.size();
-  /// Creating a memory to be shared between child and parent.
-  auto rawMemory = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE,
-                        MAP_SHARED | MAP_ANONYMOUS, -1, 0);
-  mapping = static_cast<uint32_t *>(rawMemory);
-  memset(mapping, 0, mappingSize);
+  if (blockCoverageEnabled) {
+    info.blockCoverage =
+        static_cast<uint8_t *>(acquireBuffer(blockCoverageSize()));
+  }
+  if (backEdgesEnabled) {
+    info.backEdges = static_cast<uint64_t *>(acquireBuffer(sizeof(uint64_t)));
+  }
+  if (samplesEnabled) {
+    info.samples = static_cast<uint64_t *>(acquireBuffer(samplesSize()));
+  }
+
+  if (mode == InstrumentationMode::Coverage) {
+    info.coverage = static_cast<uint8_t *>(acquireBuffer(coverageSize()));
+    return;
+  }
+  if (mode == InstrumentationMode::Static) {
+    return;
+  }
+
+  mapping = static_cast<uint32_t *>(acquireBuffer(mappingSize()));
+  CallTreeMapping::initialize(mapping, functions.size());
+
+  /// An uninstrumented test body is never entered, every call is recorded
+  info.testBody = 0;
+  info.testBodyDepth = InstrumentationInfo::OutsideTestBody;
+  if (isBounded()) {
+    auto testBody = functionIndices.find(test.getTestBody());
+    if (testBody != functionIndices.end() &&
+        functions[testBody->second].instrumented) {
+      info.testBody = testBody->second;
+      info.maxDistance = maxDistance;
+    }
+  }
+
+  if (mode == InstrumentationMode::InlineCallbacks) {
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    if (freeShadowStacks.empty()) {
+      info.shadowStack = new uint32_t[InstrumentationInfo::ShadowStackSize];
+    } else {
+      info.shadowStack = freeShadowStacks.back();
+      freeShadowStacks.pop_back();
+    }
+    info.shadowStackDepth = 0;
+  }
 }
 
 void Instrumentation::cleanupInstrumentationInfo(Test &test) {
-  std::stack<uint32_t>().swap(test.getInstrumentationInfo().callstack);
-  munmap(test.getInstrumentationInfo().callTreeMapping, functions.size());
+  auto &info = test.getInstrumentationInfo();
+  if (info.blockCoverage) {
+    releaseBuffer(info.blockCoverage, blockCoverageSize(), false);
+    info.blockCoverage = nullptr;
+  }
+  if (info.backEdges) {
+    releaseBuffer(info.backEdges, sizeof(uint64_t), false);
+    info.backEdges = nullptr;
+  }
+  if (info.samples) {
+    releaseSamples(info.samples);
+    info.samples = nullptr;
+  }
+  if (info.coverage) {
+    releaseBuffer(info.coverage, coverageSize(), info.consumed);
+    info.coverage = nullptr;
+  }
+  if (info.callTreeMapping) {
+    if (!info.consumed) {
+      CallTreeMapping::clear(info.callTreeMapping, functions.size());
+    }
+    releaseBuffer(info.callTreeMapping, mappingSize(), true);
+    info.callTreeMapping = nullptr;
+  }
+  if (info.shadowStack) {
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    freeShadowStacks.push_back(info.shadowStack);
+    info.shadowStack = nullptr;
+    info.shadowStackDepth = 0;
+  }
 }
@@ -0,0 +1,87 @@
+#include "mull/Instrumentation/LoopBudget.h"
+
+#include "mull/ForkProcessSandbox.h"
+
+#include <llvm/Analysis/CFG.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Transforms/Utils/BasicBlockUtils.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+
+#include <unistd.h>
+
+using namespace mull;
+using namespace llvm;
+
+namespace mull {
+
+extern "C" {
+uint64_t mull_loopBudget = 0;
+}
+
+extern "C" void mull_loopBudgetExceeded() {
+  fflush(stdout);
+  fflush(stderr);
+  _exit(ForkProcessSandbox::LoopBudgetExitCode);
+}
+
+} // namespace mull
+
+std::vector<Instruction *> mull::backEdgeTerminators(Function *function) {
+  SmallVector<std::pair<const BasicBlock *, const BasicBlock *>, 8> backEdges;
+  FindFunctionBackedges(*function, backEdges);
+
+  std::vector<Instruction *> terminators;
+  for (auto &edge : backEdges) {
+    auto terminator = const_cast<BasicBlock *>(edge.first)->getTerminator();
+    /// Nothing goes in front of a catchswitch
+    if (terminator->isEHPad() ||
+        std::find(terminators.begin(), terminators.end(), terminator) !=
+            terminators.end()) {
+      continue;
+    }
+    terminators.push_back(terminator);
+  }
+  return terminators;
+}
+
+void mull::injectLoopBudget(Function *function) {
+  auto module = function->getParent();
+  auto &context = module->getContext();
+  auto longType = Type::getInt64Ty(context);
+
+  Value *budget = module->getOrInsertGlobal("mull_loopBudget", longType);
+  Function *exceeded = module->getFunction("mull_loopBudgetExceeded");
+  if (exceeded == nullptr) {
+    exceeded = Function::Create(
+        FunctionType::get(Type::getVoidTy(context), false),
+        Function::ExternalLinkage, "mull_loopBudgetExceeded", module);
+  }
+
+  for (auto latch : backEdgeTerminators(function)) {
+    /// if (--mull_loopBudget == 0) mull_loopBudgetExceeded();
+    Value *left = new LoadInst(budget, "loopBudget", latch);
+    Value *next = BinaryOperator::Create(
+        Instruction::Sub, left, ConstantInt::get(longType, 1), "", latch);
+    new StoreInst(next, budget, latch);
+    Value *spent = new ICmpInst(latch, ICmpInst::ICMP_EQ, next,
+                                ConstantInt::get(longType, 0), "budgetSpent");
+    auto unreachable = SplitBlockAndInsertIfThen(spent, latch, true);
+    CallInst::Create(exceeded, {}, "", unreachable);
+  }
+}
+
+uint64_t mull::loopBudgetOf(uint64_t originalBackEdges, uint64_t factor) {
+  if (factor == 0) {
+    return 0;
+  }
+  auto max = std::numeric_limits<uint64_t>::max();
+  auto budget =
+      originalBackEdges > max / factor ? max : originalBackEdges * factor;
+  return std::max(budget, MinimumLoopBudget);
+}
@@ -0,0 +1,254 @@
+#include "mull/Instrumentation/ReachabilityCache.h"
+
+#include "mull/CacheFile.h"
+#include "mull/Hash.h"
+#include "mull/Logger.h"
+#include "mull/MullModule.h"
+#include "mull/Program/Program.h"
+#include "mull/TestFrameworks/Test.h"
+
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/StringRef.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <algorithm>
+
+using namespace mull;
+
+static const char *const Header = "mull-reachability 1";
+
+ReachabilityCache::ReachabilityCache(const std::string &cacheDirectory,
+                                     const std::string &version)
+    : cacheDirectory(cacheDirectory), version(version), changed(false),
+      hits(0) {}
+
+/// The name comes first, it has no spaces, the module identifier may
+std::string ReachabilityCache::keyOf(const llvm::Function *function) {
+  return function->getName().str() + " " +
+         function->getParent()->getModuleIdentifier();
+}
+
+void ReachabilityCache::load(Program &program) {
+  if (cacheDirectory.empty()) {
+    return;
+  }
+
+  std::vector<std::string> modules;
+  for (auto &module : program.modules()) {
+    modules.push_back(module->getModule()->getModuleIdentifier());
+    for (auto &function : module->getModule()->getFunctionList()) {
+      if (!function.isDeclaration()) {
+        functions[keyOf(&function)] = &function;
+      }
+    }
+  }
+  std::sort(modules.begin(), modules.end());
+
+  std::string identifier = version;
+  for (auto &module : modules) {
+    identifier += '\0' + module;
+  }
+  path = cacheDirectory + "/reachability/" +
+         mull::hashOf(identifier, HashAlgorithm::MD5);
+
+  if (!read()) {
+    entries.clear();
+  }
+}
+
+/// The format is line based, the lines following a test belong to it:
+///
+///     mull-reachability 1
+///     test <running time> <test identifier>
+///     time <nanoseconds>
+///     function <hash> <key>
+///     call <caller> <function>
+bool ReachabilityCache::read() {
+  auto buffer = llvm::MemoryBuffer::getFile(path);
+  if (!buffer) {
+    return false;
+  }
+
+  llvm::SmallVector<llvm::StringRef, 64> lines;
+  buffer.get()->getBuffer().split(lines, '\n', -1, false);
+  if (lines.empty() || lines.front() != Header) {
+    return false;
+  }
+
+  Entry *entry = nullptr;
+  for (auto &line : llvm::makeArrayRef(lines).drop_front()) {
+    auto kindAndRest = line.split(' ');
+    auto firstAndRest = kindAndRest.second.split(' ');
+    if (kindAndRest.first == "test") {
+      entry = &entries[firstAndRest.second.str()];
+      if (firstAndRest.first.getAsInteger(10, entry->runningTime)) {
+        return false;
+      }
+      continue;
+    }
+    if (entry == nullptr) {
+      return false;
+    }
+
+    if (kindAndRest.first == "time") {
+      int64_t time = 0;
+      if (kindAndRest.second.getAsInteger(10, time)) {
+        return false;
+      }
+      entry->runningTimes.push_back(time);
+    } else if (kindAndRest.first == "function") {
+      entry->functions.emplace_back(firstAndRest.second.str(),
+                                    firstAndRest.first.str());
+    } else if (kindAndRest.first == "call") {
+      uint32_t caller = 0;
+      uint32_t function = 0;
+      if (firstAndRest.first.getAsInteger(10, caller) ||
+          firstAndRest.second.getAsInteger(10, function) || function == 0 ||
+          caller > entry->functions.size() ||
+          function > entry->functions.size()) {
+        return false;
+      }
+      entry->calls.emplace_back(caller, function);
+    } else {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/// Functions are reached by many tests, each is only hashed once
+const std::string &ReachabilityCache::functionHash(const std::string &key) {
+  static const std::string none;
+  auto found = hashes.find(key);
+  if (found != hashes.end()) {
+    return found->second;
+  }
+  auto function = functions.find(key);
+  if (function == functions.end()) {
+    return none;
+  }
+  return hashes[key] = hashOfFunctionBody(*function->second);
+}
+
+bool ReachabilityCache::restore(Test &test, Instrumentation::Calls &calls) {
+  std::lock_guard<std::mutex> guard(mutex);
+  auto found = entries.find(test.getUniqueIdentifier());
+  if (found == entries.end()) {
+    return false;
+  }
+
+  Entry &entry = found->second;
+  for (auto &function : entry.functions) {
+    auto &hash = functionHash(function.first);
+    if (hash.empty() || hash != function.second) {
+      return false;
+    }
+  }
+
+  calls.clear();
+  calls.reserve(entry.calls.size());
+  for (auto &call : entry.calls) {
+    llvm::Function *caller = nullptr;
+    if (call.first != 0) {
+      caller = functions[entry.functions[call.first - 1].first];
+    }
+    calls.emplace_back(caller,
+                       functions[entry.functions[call.second - 1].first]);
+  }
+
+  ExecutionResult result;
+  result.status = ExecutionStatus::Passed;
+  result.runningTime = entry.runningTime;
+  test.setExecutionResult(result);
+  for (auto time : entry.runningTimes) {
+    test.addRunningTime(time);
+  }
+
+  entry.used = true;
+  hits++;
+  return true;
+}
+
+void ReachabilityCache::store(Test &test,
+                              const Instrumentation::Calls &calls) {
+  if (cacheDirectory.empty() ||
+      test.getExecutionResult().status != ExecutionStatus::Passed) {
+    return;
+  }
+
+  Entry entry;
+  entry.used = true;
+  entry.runningTime = test.getExecutionResult().runningTime;
+  entry.runningTimes = test.getRunningTimes();
+
+  /// The test body is a dependency even if it was not recorded
+  std::unordered_map<const llvm::Function *, uint32_t> positions;
+  auto positionOf = [&](const llvm::Function *function) {
+    auto inserted = positions.insert(
+        std::make_pair(function, uint32_t(entry.functions.size() + 1)));
+    if (inserted.second) {
+      entry.functions.emplace_back(keyOf(function), std::string());
+    }
+    return inserted.first->second;
+  };
+  if (test.getTestBody()) {
+    positionOf(test.getTestBody());
+  }
+  for (auto &call : calls) {
+    uint32_t caller = call.first ? positionOf(call.first) : 0;
+    entry.calls.emplace_back(caller, positionOf(call.second));
+  }
+
+  std::lock_guard<std::mutex> guard(mutex);
+  entries[test.getUniqueIdentifier()] = std::move(entry);
+  changed = true;
+}
+
+void ReachabilityCache::save() {
+  std::lock_guard<std::mutex> guard(mutex);
+  if (!changed) {
+    return;
+  }
+  for (auto &pair : entries) {
+    for (auto &function : pair.second.functions) {
+      if (function.second.empty()) {
+        function.second = functionHash(function.first);
+      }
+    }
+  }
+  write();
+  changed = false;
+}
+
+void ReachabilityCache::write() {
+  auto error = writeCacheFile(path, [&](llvm::raw_ostream &outfile) {
+    outfile << Header << "\n";
+    for (auto &pair : entries) {
+      auto &entry = pair.second;
+      if (!entry.used) {
+        continue;
+      }
+      outfile << "test " << entry.runningTime << " " << pair.first << "\n";
+      for (auto time : entry.runningTimes) {
+        outfile << "time " << time << "\n";
+      }
+      for (auto &function : entry.functions) {
+        outfile << "function " << function.second << " " << function.first
+                << "\n";
+      }
+      for (auto &call : entry.calls) {
+        outfile << "call " << call.first << " " << call.second << "\n";
+      }
+    }
+  });
+  if (error) {
+    Logger::error() << "Cannot write reachability cache file '" << path
+                    << "': " << error.message() << "\n";
+  }
+}
+
+uint64_t ReachabilityCache::getHits() const { return hits; }
@@ -0,0 +1,91 @@
+#include "mull/Instrumentation/SampledReachability.h"
+
+#include "mull/TestFrameworks/Test.h"
+#include "mull/Testee.h"
+
+#include <llvm/IR/Function.h>
+
+#include <algorithm>
+#include <set>
+#include <unordered_set>
+#include <utility>
+
+using namespace mull;
+using namespace llvm;
+
+void FunctionAddresses::add(llvm::Function *function, uint64_t address,
+                            uint64_t size) {
+  ranges.push_back({address, address + size, function});
+}
+
+void FunctionAddresses::sort() {
+  std::sort(ranges.begin(), ranges.end(),
+            [](const Range &lhs, const Range &rhs) {
+              return lhs.begin < rhs.begin;
+            });
+}
+
+llvm::Function *FunctionAddresses::find(uint64_t address) const {
+  auto after = std::upper_bound(
+      ranges.begin(), ranges.end(), address,
+      [](uint64_t address, const Range &range) {
+        return address < range.begin;
+      });
+  if (after == ranges.begin()) {
+    return nullptr;
+  }
+  auto range = std::prev(after);
+  return address < range->end ? range->function : nullptr;
+}
+
+size_t FunctionAddresses::size() const { return ranges.size(); }
+
+std::vector<std::unique_ptr<Testee>>
+mull::sampledTestees(const FunctionAddresses &addresses,
+                     const std::vector<uint64_t> &samples, Test &test) {
+  std::vector<std::unique_ptr<Testee>> testees;
+  /// The test body is left out, as it is for the recorded calls
+  std::unordered_set<const llvm::Function *> reached = {test.getTestBody()};
+  for (auto address : samples) {
+    auto function = addresses.find(address);
+    if (function && reached.insert(function).second) {
+      testees.push_back(make_unique<Testee>(function, &test, 1));
+    }
+  }
+  return testees;
+}
+
+std::vector<std::unique_ptr<Testee>>
+mull::narrowBySamples(std::vector<std::unique_ptr<Testee>> &staticTestees,
+                      std::vector<std::unique_ptr<Testee>> &sampled) {
+  std::unordered_set<llvm::Function *> hot;
+  std::set<std::pair<Test *, llvm::Function *>> unmatched;
+  for (auto &testee : sampled) {
+    hot.insert(testee->getTesteeFunction());
+    unmatched.emplace(testee->getTest(), testee->getTesteeFunction());
+  }
+
+  std::vector<std::unique_ptr<Testee>> testees;
+  for (auto &testee : staticTestees) {
+    auto function = testee->getTesteeFunction();
+    if (hot.count(function) == 0 ||
+        unmatched.erase(std::make_pair(testee->getTest(), function)) != 0) {
+      testees.push_back(std::move(testee));
+    }
+  }
+  for (auto &testee : sampled) {
+    if (unmatched.erase(std::make_pair(testee->getTest(),
+                                       testee->getTesteeFunction())) != 0) {
+      testees.push_back(std::move(testee));
+    }
+  }
+
+  /// The testees of a test stay next to each other, the tests are in a
+  /// vector
+  std::stable_sort(testees.begin(), testees.end(),
+                   [](const std::unique_ptr<Testee> &lhs,
+                      const std::unique_ptr<Testee> &rhs) {
+                     return lhs->getTest() < rhs->getTest();
+                   });
+  return testees;
+}
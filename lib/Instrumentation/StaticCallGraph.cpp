@@ -0,0 +1,150 @@
+#include "mull/Instrumentation/StaticCallGraph.h"
+
+#include "mull/Filter.h"
+#include "mull/MullModule.h"
+#include "mull/TestFrameworks/Test.h"
+#include "mull/Testee.h"
+
+#include <llvm/IR/CallSite.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/InlineAsm.h>
+#include <llvm/IR/Module.h>
+
+#include <algorithm>
+#include <limits>
+#include <string>
+
+using namespace mull;
+using namespace llvm;
+
+const uint32_t StaticCallGraph::None = std::numeric_limits<uint32_t>::max();
+
+StaticCallGraph::StaticCallGraph(const std::vector<llvm::Module *> &modules) {
+  /// The definitions the other modules can call, by name
+  std::unordered_map<std::string, uint32_t> definitions;
+  for (auto module : modules) {
+    for (auto &function : module->getFunctionList()) {
+      if (function.isDeclaration()) {
+        continue;
+      }
+      uint32_t index = functions.size();
+      indices[&function] = index;
+      functions.push_back(&function);
+      if (!function.hasLocalLinkage()) {
+        definitions.emplace(function.getName().str(), index);
+      }
+    }
+  }
+
+  auto resolve = [&](const Function *function) {
+    auto known = indices.find(function);
+    if (known != indices.end()) {
+      return known->second;
+    }
+    auto defined = definitions.find(function->getName().str());
+    return defined == definitions.end() ? None : defined->second;
+  };
+
+  std::vector<bool> taken(functions.size(), false);
+  for (auto module : modules) {
+    for (auto &function : module->getFunctionList()) {
+      if (!function.hasAddressTaken()) {
+        continue;
+      }
+      auto index = resolve(&function);
+      if (index != None && !taken[index]) {
+        taken[index] = true;
+        addressTaken.push_back(index);
+      }
+    }
+  }
+
+  callsIndirectly.resize(functions.size(), false);
+  firstCallees.reserve(functions.size() + 1);
+  for (uint32_t caller = 0; caller < functions.size(); caller++) {
+    firstCallees.push_back(callees.size());
+    auto function = functions[caller];
+    if (!MullModule::materialize(function)) {
+      continue;
+    }
+    for (auto &block : *function) {
+      for (auto &instruction : block) {
+        CallSite callSite(&instruction);
+        if (!callSite) {
+          continue;
+        }
+        auto called = callSite.getCalledValue()->stripPointerCasts();
+        if (isa<InlineAsm>(called)) {
+          continue;
+        }
+        auto callee = dyn_cast<Function>(called);
+        if (!callee) {
+          callsIndirectly[caller] = true;
+          continue;
+        }
+        auto index = resolve(callee);
+        if (index != None) {
+          callees.push_back(index);
+        }
+      }
+    }
+    /// A function calling another one several times has one edge to it
+    auto first = std::next(callees.begin(), firstCallees.back());
+    std::sort(first, callees.end());
+    callees.erase(std::unique(first, callees.end()), callees.end());
+  }
+  firstCallees.push_back(callees.size());
+}
+
+std::vector<std::unique_ptr<Testee>>
+StaticCallGraph::getTestees(Test &test, Filter &filter,
+                            int maxDistance) const {
+  std::vector<std::unique_ptr<Testee>> testees;
+  auto testBody = indices.find(test.getTestBody());
+  if (testBody == indices.end()) {
+    return testees;
+  }
+
+  std::vector<bool> reached(functions.size(), false);
+  bool indirectCallsFollowed = false;
+  std::vector<std::pair<uint32_t, int>> nodes;
+  nodes.emplace_back(testBody->second, 0);
+  reached[testBody->second] = true;
+  auto reach = [&](uint32_t node, int distance) {
+    if (!reached[node]) {
+      reached[node] = true;
+      nodes.emplace_back(node, distance);
+    }
+  };
+
+  for (size_t head = 0; head < nodes.size(); head++) {
+    const uint32_t node = nodes[head].first;
+    const int distance = nodes[head].second;
+
+    Function *function = functions[node];
+    if (filter.shouldSkipFunction(function)) {
+      continue;
+    }
+    testees.push_back(make_unique<Testee>(function, &test, distance));
+    if (distance >= maxDistance) {
+      continue;
+    }
+    for (auto callee = firstCallees[node]; callee < firstCallees[node + 1];
+         callee++) {
+      reach(callees[callee], distance + 1);
+    }
+    /// The first indirect call met is the closest one
+    if (callsIndirectly[node] && !indirectCallsFollowed) {
+      indirectCallsFollowed = true;
+      for (auto callee : addressTaken) {
+        reach(callee, distance + 1);
+      }
+    }
+  }
+
+  return testees;
+}
+
+size_t StaticCallGraph::getFunctionCount() const { return functions.size(); }
+
+size_t StaticCallGraph::getCallCount() const { return callees.size(); }
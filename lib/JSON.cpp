@@ -0,0 +1,36 @@
+#include "mull/JSON.h"
+
+#include <cstdio>
+
+std::string mull::escapeJSON(const std::string &input) {
+  std::string escaped;
+  escaped.reserve(input.size());
+  for (char c : input) {
+    switch (c) {
+    case '"':
+      escaped += "\\\"";
+      break;
+    case '\\':
+      escaped += "\\\\";
+      break;
+    case '\n':
+      escaped += "\\n";
+      break;
+    case '\r':
+      escaped += "\\r";
+      break;
+    case '\t':
+      escaped += "\\t";
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20) {
+        char code[sizeof("\\u0000")];
+        snprintf(code, sizeof(code), "\\u%04x", c);
+        escaped += code;
+      } else {
+        escaped.push_back(c);
+      }
+    }
+  }
+  return escaped;
+}
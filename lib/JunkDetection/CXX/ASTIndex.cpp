@@ -0,0 +1,177 @@
+#include "mull/JunkDetection/CXX/ASTIndex.h"
+
+#include <clang/AST/RecursiveASTVisitor.h>
+
+#include <algorithm>
+#include <limits>
+
+using namespace mull;
+
+namespace {
+/// The nodes each mutator can come from
+class ASTIndexBuilder : public clang::RecursiveASTVisitor<ASTIndexBuilder> {
+public:
+  ASTIndexBuilder(ASTIndex &index, const clang::SourceManager &sourceManager,
+                  clang::FileID file)
+      : index(index), sourceManager(sourceManager), file(file) {}
+
+  bool TraverseDecl(clang::Decl *declaration) {
+    if (declaration != nullptr && isTopLevel(declaration) &&
+        !clang::isa<clang::NamespaceDecl>(declaration) &&
+        !clang::isa<clang::LinkageSpecDecl>(declaration)) {
+      auto location = sourceManager.getExpansionLoc(declaration->getLocation());
+      if (sourceManager.getFileID(location) != file) {
+        index.declarationsSkipped++;
+        return true;
+      }
+    }
+    return RecursiveASTVisitor::TraverseDecl(declaration);
+  }
+
+  bool VisitDecl(clang::Decl *declaration) {
+    index.nodesVisited++;
+    return true;
+  }
+
+  bool VisitStmt(clang::Stmt *statement) {
+    index.nodesVisited++;
+    return true;
+  }
+
+  bool VisitBinaryOperator(clang::BinaryOperator *binaryOperator) {
+    auto range = binaryOperator->getSourceRange();
+    if (binaryOperator->isLogicalOp()) {
+      index.addRange(MutatorKind::AndOrReplacementMutator, range);
+    }
+    if (binaryOperator->isRelationalOp()) {
+      index.addRange(MutatorKind::ConditionalsBoundaryMutator, range);
+    }
+    if (binaryOperator->isRelationalOp() || binaryOperator->isEqualityOp()) {
+      index.addRange(MutatorKind::NegateMutator, range);
+    }
+
+    switch (binaryOperator->getOpcode()) {
+    case clang::BinaryOperatorKind::BO_Add:
+    case clang::BinaryOperatorKind::BO_AddAssign:
+      index.addRange(MutatorKind::MathAddMutator, range);
+      break;
+    case clang::BinaryOperatorKind::BO_Sub:
+    case clang::BinaryOperatorKind::BO_SubAssign:
+      index.addRange(MutatorKind::MathSubMutator, range);
+      break;
+    case clang::BinaryOperatorKind::BO_Mul:
+    case clang::BinaryOperatorKind::BO_MulAssign:
+      index.addRange(MutatorKind::MathMulMutator, range);
+      break;
+    case clang::BinaryOperatorKind::BO_Div:
+    case clang::BinaryOperatorKind::BO_DivAssign:
+      index.addRange(MutatorKind::MathDivMutator, range);
+      break;
+    default:
+      break;
+    }
+
+    return true;
+  }
+
+  bool VisitUnaryOperator(clang::UnaryOperator *unaryOperator) {
+    auto range = unaryOperator->getSourceRange();
+    if (unaryOperator->isIncrementOp()) {
+      index.addRange(MutatorKind::MathAddMutator, range);
+    }
+    if (unaryOperator->isDecrementOp()) {
+      index.addRange(MutatorKind::MathSubMutator, range);
+    }
+    if (unaryOperator->getOpcode() == clang::UnaryOperatorKind::UO_LNot) {
+      index.addRange(MutatorKind::NegateMutator, range);
+    }
+
+    return true;
+  }
+
+  /// Also visits the member and the operator calls
+  bool VisitCallExpr(clang::CallExpr *callExpression) {
+    auto *type = callExpression->getType().getTypePtrOrNull();
+    if (type == nullptr) {
+      return true;
+    }
+
+    auto range = callExpression->getSourceRange();
+    if (type->isVoidType()) {
+      index.addRange(MutatorKind::RemoveVoidFunctionMutator, range);
+    }
+    /// Real Type = float, double, long double, integer
+    if (type->isRealType()) {
+      index.addRange(MutatorKind::ReplaceCallMutator, range);
+    }
+
+    return true;
+  }
+
+private:
+  ASTIndex &index;
+  const clang::SourceManager &sourceManager;
+  clang::FileID file;
+
+  /// Declared in the translation unit or in a namespace, possibly nested
+  /// in extern "C" blocks
+  static bool isTopLevel(clang::Decl *declaration) {
+    auto context = declaration->getDeclContext();
+    return context != nullptr && context->getRedeclContext()->isFileContext();
+  }
+};
+} // namespace
+
+ASTIndex::ASTIndex(clang::ASTContext &astContext, clang::FileID file)
+    : nodesVisited(0), declarationsSkipped(0),
+      sourceManager(astContext.getSourceManager()), file(file) {
+  ASTIndexBuilder builder(*this, sourceManager, file);
+  builder.TraverseDecl(astContext.getTranslationUnitDecl());
+
+  for (auto &entry : ranges) {
+    auto &kindRanges = entry.second;
+    std::sort(kindRanges.ranges.begin(), kindRanges.ranges.end());
+    unsigned furthestEnd = 0;
+    for (auto &range : kindRanges.ranges) {
+      furthestEnd = std::max(furthestEnd, range.second);
+      kindRanges.furthestEnds.push_back(furthestEnd);
+    }
+  }
+}
+
+void ASTIndex::addRange(MutatorKind kind, const clang::SourceRange &range) {
+  if (range.isInvalid()) {
+    return;
+  }
+
+  if (sourceManager.getFileID(range.getBegin()) != file) {
+    return;
+  }
+  auto begin = sourceManager.getFileOffset(range.getBegin());
+  auto end = sourceManager.getFileOffset(range.getEnd());
+  ranges[kind].ranges.emplace_back(begin, end);
+}
+
+bool ASTIndex::coversMutant(MutatorKind kind,
+                            const clang::SourceLocation &location) const {
+  if (!location.isFileID() || sourceManager.getFileID(location) != file) {
+    return false;
+  }
+
+  auto entry = ranges.find(kind);
+  if (entry == ranges.end()) {
+    return false;
+  }
+
+  /// Some range starting at or before the mutant has to end after it
+  auto offset = sourceManager.getFileOffset(location);
+  auto &kindRanges = entry->second;
+  auto after = std::upper_bound(
+      kindRanges.ranges.begin(), kindRanges.ranges.end(),
+      std::make_pair(offset, std::numeric_limits<unsigned>::max()));
+  if (after == kindRanges.ranges.begin()) {
+    return false;
+  }
+  return kindRanges.furthestEnds[after - kindRanges.ranges.begin() - 1] >=
+         offset;
+}
@@ -1,5 +1,6 @@
 #include "mull/JunkDetection/CXX/ASTStorage.h"
 
+#include "mull/JunkDetection/CXX/SharedIncludes.h"
 #include "mull/Logger.h"
 #include "mull/MutationPoint.h"
 
@@ -11,8 +12,10 @@
 #include <llvm/IR/Instruction.h>
 #include <llvm/IR/Module.h>
 #include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
 #include <llvm/Support/Path.h>
 
+#include <fstream>
 #include <sstream>
 
 using namespace mull;
@@ -29,6 +32,75 @@ clang::ASTContext &ThreadSafeASTUnit::getASTContext() {
   return ast->getASTContext();
 }
 
+const ASTIndex &
+ThreadSafeASTUnit::getIndex(const clang::SourceLocation &location) {
+  auto file = ast->getSourceManager().getFileID(location);
+
+  IndexEntry *entry = nullptr;
+  {
+    std::lock_guard<std::mutex> guard(indexMutex);
+    auto &slot = indices[file];
+    if (!slot) {
+      slot = make_unique<IndexEntry>();
+    }
+    entry = slot.get();
+  }
+
+  std::call_once(entry->indexed, [this, entry, file]() {
+    entry->index = make_unique<ASTIndex>(ast->getASTContext(), file);
+  });
+  return *entry->index;
+}
+
+JunkDetectionMetrics ThreadSafeASTUnit::getMetrics() {
+  JunkDetectionMetrics metrics;
+  std::lock_guard<std::mutex> guard(indexMutex);
+  for (auto &pair : indices) {
+    auto &index = pair.second->index;
+    if (!index) {
+      continue;
+    }
+    metrics.filesIndexed++;
+    metrics.nodesVisited += index->nodesVisited;
+    metrics.declarationsSkipped += index->declarationsSkipped;
+  }
+  return metrics;
+}
+
+static std::vector<std::string>
+includedFiles(const clang::SourceManager &sourceManager) {
+  std::vector<std::string> files;
+  for (auto it = sourceManager.fileinfo_begin();
+       it != sourceManager.fileinfo_end(); ++it) {
+    files.push_back(llvm::StringRef(it->first->getName()).str());
+  }
+  return files;
+}
+
+std::vector<std::string> ThreadSafeASTUnit::getIncludedFiles() {
+  std::lock_guard<std::mutex> guard(mutex);
+  auto files = includedFiles(ast->getSourceManager());
+  files.insert(files.end(), precompiledFiles.begin(), precompiledFiles.end());
+  return files;
+}
+
+size_t ThreadSafeASTUnit::getMemoryUsage() {
+  if (ast == nullptr) {
+    return 0;
+  }
+  auto &context = ast->getASTContext();
+  auto &sourceManager = ast->getSourceManager();
+  return context.getASTAllocatedMemory() +
+         context.getSideTableAllocatedMemory() +
+         sourceManager.getContentCacheSize() +
+         sourceManager.getDataStructureSizes();
+}
+
+void ThreadSafeASTUnit::setPrecompiledFiles(
+    const std::vector<std::string> &files) {
+  precompiledFiles = files;
+}
+
 bool ThreadSafeASTUnit::isInSystemHeader(clang::SourceLocation &location) {
   return ast->getSourceManager().isInSystemHeader(location);
 }
@@ -38,7 +110,7 @@ ThreadSafeASTUnit::findFileEntry(const MutationPoint *point) {
   assert(point);
   assert(!point->getSourceLocation().isNull() && "Missing debug information?");
 
-  auto filePath = point->getSourceLocation().filePath;
+  auto filePath = point->getSourceLocation().filePath();
   const clang::FileEntry *file = findFileEntry(filePath);
   if (file != nullptr) {
     return file;
@@ -54,21 +126,45 @@ ThreadSafeASTUnit::findFileEntry(const MutationPoint *point) {
   return findFileEntry(sourceFile);
 }
 
+/// The debug information has absolute paths, while the headers are named the
+/// way the compiler found them, relative to its working directory
+std::string ThreadSafeASTUnit::normalizedPath(llvm::StringRef path) const {
+  llvm::SmallString<256> normalized(path);
+  if (!llvm::sys::path::is_absolute(normalized)) {
+    auto &workingDirectory =
+        ast->getFileManager().getFileSystemOpts().WorkingDir;
+    if (workingDirectory.empty()) {
+      llvm::sys::fs::make_absolute(normalized);
+    } else {
+      llvm::SmallString<256> absolute(workingDirectory);
+      llvm::sys::path::append(absolute, normalized);
+      normalized = absolute;
+    }
+  }
+  llvm::sys::path::remove_dots(normalized, true);
+  return std::string(normalized.str());
+}
+
 const clang::FileEntry *
 ThreadSafeASTUnit::findFileEntry(const std::string &filePath) {
-  auto &sourceManager = ast->getSourceManager();
-  auto begin = sourceManager.fileinfo_begin();
-  auto end = sourceManager.fileinfo_end();
-  const clang::FileEntry *file = nullptr;
-  for (auto it = begin; it != end; it++) {
-    StringRef name(it->first->getName());
-    if (name.equals(filePath)) {
-      file = it->first;
-      break;
+  std::call_once(fileEntriesCollected, [this]() {
+    auto &sourceManager = ast->getSourceManager();
+    for (auto it = sourceManager.fileinfo_begin();
+         it != sourceManager.fileinfo_end(); it++) {
+      StringRef name(it->first->getName());
+      fileEntries[name] = it->first;
+      fileEntries[normalizedPath(name)] = it->first;
     }
-  }
+  });
 
-  return file;
+  auto file = fileEntries.find(filePath);
+  if (file == fileEntries.end()) {
+    file = fileEntries.find(normalizedPath(filePath));
+  }
+  if (file == fileEntries.end()) {
+    return nullptr;
+  }
+  return file->second;
 }
 
 clang::SourceLocation ThreadSafeASTUnit::getLocation(MutationPoint *point) {
@@ -88,11 +184,27 @@ clang::SourceLocation ThreadSafeASTUnit::getLocation(MutationPoint *point) {
 }
 
 ASTStorage::ASTStorage(const std::string &cxxCompilationDatabasePath,
-                       const std::string &cxxCompilationFlags)
+                       const std::string &cxxCompilationFlags,
+                       bool sharedPrecompiledHeaders, uint64_t memoryLimit)
     : compilationDatabase(CompilationDatabase::Path(cxxCompilationDatabasePath),
-                          CompilationDatabase::Flags(cxxCompilationFlags)) {}
+                          CompilationDatabase::Flags(cxxCompilationFlags)),
+      memoryLimit(memoryLimit), memoryUsage(0), useClock(0),
+      sharedPrecompiledHeaders(sharedPrecompiledHeaders),
+      nextBackgroundFile(0) {}
+
+ASTStorage::~ASTStorage() {
+  /// Nobody waits for the files left
+  nextBackgroundFile = backgroundFiles.size();
+  for (auto &parser : backgroundParsers) {
+    parser.join();
+  }
+  if (!sharedHeadersDirectory.empty()) {
+    llvm::sys::fs::remove_directories(sharedHeadersDirectory);
+  }
+}
 
-ThreadSafeASTUnit *ASTStorage::findAST(const MutationPoint *point) {
+std::shared_ptr<ThreadSafeASTUnit>
+ASTStorage::findAST(const MutationPoint *point) {
   assert(point);
   assert(!point->getSourceLocation().isNull() && "Missing debug information?");
 
@@ -101,18 +213,248 @@ ThreadSafeASTUnit *ASTStorage::findAST(const MutationPoint *point) {
     return nullptr;
   }
 
-  const std::string &sourceFile = instruction->getModule()->getSourceFileName();
+  return findAST(instruction->getModule()->getSourceFileName());
+}
+
+std::shared_ptr<ThreadSafeASTUnit>
+ASTStorage::findAST(const std::string &sourceFile) {
+  ASTEntry &ast = entry(sourceFile);
+  std::lock_guard<std::mutex> parsing(ast.parsing);
+  {
+    std::lock_guard<std::mutex> guard(mutex);
+    ast.lastUsed = ++useClock;
+    if (ast.ast) {
+      return ast.ast;
+    }
+  }
+
+  std::shared_ptr<ThreadSafeASTUnit> unit(parse(sourceFile));
+  auto unitMemoryUsage = unit->getMemoryUsage();
+
+  /// The evicted ASTs are destroyed once the lock is released
+  std::vector<std::shared_ptr<ThreadSafeASTUnit>> evicted;
+  {
+    std::lock_guard<std::mutex> guard(mutex);
+    if (ast.parses++ != 0) {
+      evictedMetrics.unitsReparsed++;
+    }
+    ast.ast = unit;
+    ast.memoryUsage = unitMemoryUsage;
+    memoryUsage += unitMemoryUsage;
+    evicted = evict(ast);
+  }
+  return unit;
+}
+
+/// The ASTs in use elsewhere would not be freed by the eviction anyway
+std::vector<std::shared_ptr<ThreadSafeASTUnit>>
+ASTStorage::evict(ASTEntry &parsed) {
+  std::vector<std::shared_ptr<ThreadSafeASTUnit>> evicted;
+  if (memoryLimit == 0) {
+    return evicted;
+  }
+
+  while (memoryUsage > memoryLimit) {
+    ASTEntry *leastRecentlyUsed = nullptr;
+    for (auto &pair : astUnits) {
+      auto &candidate = *pair.second;
+      if (&candidate == &parsed || !candidate.ast ||
+          candidate.ast.use_count() != 1) {
+        continue;
+      }
+      if (leastRecentlyUsed == nullptr ||
+          candidate.lastUsed < leastRecentlyUsed->lastUsed) {
+        leastRecentlyUsed = &candidate;
+      }
+    }
+    if (leastRecentlyUsed == nullptr) {
+      break;
+    }
+
+    auto unitMetrics = leastRecentlyUsed->ast->getMetrics();
+    evictedMetrics.filesIndexed += unitMetrics.filesIndexed;
+    evictedMetrics.nodesVisited += unitMetrics.nodesVisited;
+    evictedMetrics.declarationsSkipped += unitMetrics.declarationsSkipped;
+    evictedMetrics.unitsEvicted++;
+
+    memoryUsage -= leastRecentlyUsed->memoryUsage;
+    leastRecentlyUsed->memoryUsage = 0;
+    evicted.push_back(std::move(leastRecentlyUsed->ast));
+    leastRecentlyUsed->ast.reset();
+  }
+  return evicted;
+}
+
+bool ASTStorage::isOverMemoryLimit() {
+  std::lock_guard<std::mutex> guard(mutex);
+  return memoryLimit != 0 && memoryUsage >= memoryLimit;
+}
+
+ASTStorage::ASTEntry &ASTStorage::entry(const std::string &sourceFile) {
+  std::lock_guard<std::mutex> guard(mutex);
+  auto &ast = astUnits[sourceFile];
+  if (!ast) {
+    ast = make_unique<ASTEntry>();
+  }
+  return *ast;
+}
+
+void ASTStorage::parseInBackground(const std::vector<std::string> &sourceFiles,
+                                   int workers) {
+  assert(backgroundParsers.empty() && "Called twice?");
+  if (sharedPrecompiledHeaders) {
+    planSharedHeaders(sourceFiles);
+  }
+  backgroundFiles = sourceFiles;
+  for (int i = 0; i < workers; i++) {
+    backgroundParsers.emplace_back([this]() {
+      for (size_t index = nextBackgroundFile++; index < backgroundFiles.size();
+           index = nextBackgroundFile++) {
+        if (isOverMemoryLimit()) {
+          break;
+        }
+        findAST(backgroundFiles[index]);
+      }
+    });
+  }
+}
+
+JunkDetectionMetrics ASTStorage::getMetrics() {
   std::lock_guard<std::mutex> guard(mutex);
-  if (astUnits.count(sourceFile)) {
-    return astUnits.at(sourceFile).get();
+  JunkDetectionMetrics metrics = evictedMetrics;
+  for (auto &pair : astUnits) {
+    auto &entry = *pair.second;
+    if (!entry.ast) {
+      continue;
+    }
+    auto unitMetrics = entry.ast->getMetrics();
+    metrics.filesIndexed += unitMetrics.filesIndexed;
+    metrics.nodesVisited += unitMetrics.nodesVisited;
+    metrics.declarationsSkipped += unitMetrics.declarationsSkipped;
+  }
+  return metrics;
+}
+
+const std::vector<std::string> &
+ASTStorage::compilationFlags(const std::string &sourceFile) const {
+  return compilationDatabase.compilationFlagsForFile(sourceFile);
+}
+
+static bool isCFile(const std::string &sourceFile) {
+  return llvm::sys::path::extension(sourceFile) == ".c";
+}
+
+/// Groups the files by their compilation flags, each group with headers in
+/// common gets a PCH of them
+void ASTStorage::planSharedHeaders(
+    const std::vector<std::string> &sourceFiles) {
+  std::map<std::vector<std::string>, std::vector<std::string>> groups;
+  for (auto &sourceFile : sourceFiles) {
+    auto flags = compilationDatabase.compilationFlagsForFile(sourceFile);
+    flags.push_back(isCFile(sourceFile) ? "c" : "c++");
+    groups[flags].push_back(sourceFile);
   }
 
+  for (auto &group : groups) {
+    if (group.second.size() < 2) {
+      continue;
+    }
+
+    std::vector<std::vector<std::string>> includes;
+    for (auto &sourceFile : group.second) {
+      auto buffer = llvm::MemoryBuffer::getFile(sourceFile);
+      if (buffer) {
+        includes.push_back(leadingSystemIncludes(buffer.get()->getBuffer()));
+      }
+    }
+    auto shared = sharedSystemIncludes(includes);
+    if (shared.empty()) {
+      continue;
+    }
+
+    if (sharedHeadersDirectory.empty()) {
+      llvm::SmallString<128> directory;
+      if (llvm::sys::fs::createUniqueDirectory("mull-pch", directory)) {
+        Logger::warn() << "Cannot create a directory for the shared "
+                          "precompiled headers\n";
+        return;
+      }
+      sharedHeadersDirectory = std::string(directory.str());
+    }
+
+    auto header = make_unique<SharedHeader>();
+    auto name = sharedHeadersDirectory + "/shared-" +
+                std::to_string(sharedHeaders.size());
+    header->includes = shared;
+    header->headerPath = name + ".h";
+    header->pchPath = name + ".pch";
+    for (auto &sourceFile : group.second) {
+      sharedHeaderOfFile[sourceFile] = header.get();
+    }
+    sharedHeaders.push_back(std::move(header));
+  }
+}
+
+bool ASTStorage::buildSharedHeader(SharedHeader &header,
+                                   const std::string &sourceFile) {
+  std::call_once(header.built, [&]() {
+    {
+      std::ofstream stream(header.headerPath);
+      for (auto &include : header.includes) {
+        stream << "#include <" << include << ">\n";
+      }
+    }
+
+    auto compilationFlags =
+        compilationDatabase.compilationFlagsForFile(sourceFile);
+    std::vector<const char *> args({"mull-cxx"});
+    for (auto &flag : compilationFlags) {
+      args.push_back(flag.c_str());
+    }
+    args.push_back("-x");
+    args.push_back(isCFile(sourceFile) ? "c-header" : "c++-header");
+    args.push_back(header.headerPath.c_str());
+
+    clang::IntrusiveRefCntPtr<clang::DiagnosticsEngine> diagnosticsEngine(
+        clang::CompilerInstance::createDiagnostics(
+            new clang::DiagnosticOptions));
+
+    /// A prefix translation unit keeps the tentative definitions and the
+    /// pending instantiations for the files including it
+    std::unique_ptr<clang::ASTUnit> ast(clang::ASTUnit::LoadFromCommandLine(
+        args.data(), args.data() + args.size(),
+        std::make_shared<clang::PCHContainerOperations>(), diagnosticsEngine,
+        "", false, false, llvm::None, true, 0, clang::TU_Prefix));
+
+    if (ast == nullptr || diagnosticsEngine->hasErrorOccurred() ||
+        ast->Save(header.pchPath)) {
+      Logger::debug() << "Cannot precompile the headers shared with '"
+                      << sourceFile << "', parsing without them\n";
+      return;
+    }
+
+    /// The header itself is gone after the run
+    for (auto &file : includedFiles(ast->getSourceManager())) {
+      if (file != header.headerPath) {
+        header.dependencies.push_back(file);
+      }
+    }
+    header.usable = true;
+  });
+  return header.usable;
+}
+
+clang::ASTUnit *ASTStorage::load(const std::string &sourceFile,
+                                 const std::vector<std::string> &extraFlags) {
   auto compilationFlags =
       compilationDatabase.compilationFlagsForFile(sourceFile);
   std::vector<const char *> args({"mull-cxx"});
   for (auto &flag : compilationFlags) {
     args.push_back(flag.c_str());
   }
+  for (auto &flag : extraFlags) {
+    args.push_back(flag.c_str());
+  }
   args.push_back(sourceFile.c_str());
 
   clang::IntrusiveRefCntPtr<clang::DiagnosticsEngine> diagnosticsEngine(
@@ -130,9 +472,32 @@ ThreadSafeASTUnit *ASTStorage::findAST(const MutationPoint *point) {
     }
     message << "\n";
     Logger::error() << message.str();
+    return nullptr;
+  }
+
+  if (!extraFlags.empty() && diagnosticsEngine->hasErrorOccurred()) {
+    delete ast;
+    return nullptr;
+  }
+
+  return ast;
+}
+
+ThreadSafeASTUnit *ASTStorage::parse(const std::string &sourceFile) {
+  auto sharedHeader = sharedHeaderOfFile.find(sourceFile);
+  if (sharedHeader != sharedHeaderOfFile.end() &&
+      buildSharedHeader(*sharedHeader->second, sourceFile)) {
+    auto &header = *sharedHeader->second;
+    auto ast = load(sourceFile, {"-include-pch", header.pchPath});
+    if (ast != nullptr) {
+      auto unit = new ThreadSafeASTUnit(ast);
+      unit->setPrecompiledFiles(header.dependencies);
+      return unit;
+    }
+    Logger::debug() << "Cannot parse '" << sourceFile
+                    << "' with the shared precompiled headers, parsing "
+                       "without them\n";
   }
 
-  auto threadSafeAST = new ThreadSafeASTUnit(ast);
-  astUnits[sourceFile] = std::unique_ptr<ThreadSafeASTUnit>(threadSafeAST);
-  return threadSafeAST;
+  return new ThreadSafeASTUnit(load(sourceFile, {}));
 }
@@ -4,67 +4,154 @@
 #include "mull/MutationPoint.h"
 #include "mull/Mutators/Mutator.h"
 
-#include "mull/JunkDetection/CXX/Visitors/AndOrReplacementVisitor.h"
-#include "mull/JunkDetection/CXX/Visitors/ConditionalsBoundaryVisitor.h"
-#include "mull/JunkDetection/CXX/Visitors/MathAddVisitor.h"
-#include "mull/JunkDetection/CXX/Visitors/MathDivVisitor.h"
-#include "mull/JunkDetection/CXX/Visitors/MathMulVisitor.h"
-#include "mull/JunkDetection/CXX/Visitors/MathSubVisitor.h"
-#include "mull/JunkDetection/CXX/Visitors/NegateConditionVisitor.h"
-#include "mull/JunkDetection/CXX/Visitors/RemoveVoidFunctionVisitor.h"
-#include "mull/JunkDetection/CXX/Visitors/ReplaceCallVisitor.h"
+#include <clang/Basic/Version.h>
+#include <llvm/IR/Instruction.h>
+#include <llvm/IR/Module.h>
+
+#include <algorithm>
 
 using namespace mull;
 
-template <typename Visitor>
-static bool isJunkMutation(ASTStorage &storage, MutationPoint *point) {
-  auto ast = storage.findAST(point);
-  auto location = ast->getLocation(point);
+/// Bumped whenever the verdicts for the same source change
+static const char *const JunkCacheVersion =
+    "ast-index-1 " CLANG_VERSION_STRING;
 
-  if (ast->isInSystemHeader(location)) {
-    return true;
-  }
+CXXJunkDetector::CXXJunkDetector(JunkDetectionConfig &config)
+    : astStorage(config.cxxCompilationDatabasePath, config.cxxCompilationFlags,
+                 config.cxxSharedPrecompiledHeaders,
+                 uint64_t(std::max(config.cxxMemoryLimit, 0)) * 1024 * 1024),
+      junkCache(config.cacheDirectory, JunkCacheVersion) {}
 
-  VisitorParameters parameters = {.sourceManager = ast->getSourceManager(),
-                                  .sourceLocation = location,
-                                  .astContext = ast->getASTContext()};
-  Visitor visitor(parameters);
-  visitor.TraverseDecl(ast->getASTContext().getTranslationUnitDecl());
+CXXJunkDetector::~CXXJunkDetector() { junkCache.save(); }
 
-  return !visitor.foundMutant();
+/// The files whose verdicts are all cached are not parsed
+void CXXJunkDetector::prepare(const std::vector<std::string> &sourceFiles,
+                              int workers) {
+  std::vector<std::string> uncachedFiles;
+  for (auto &sourceFile : sourceFiles) {
+    if (!junkCache.load(sourceFile, astStorage.compilationFlags(sourceFile))) {
+      uncachedFiles.push_back(sourceFile);
+    }
+  }
+  astStorage.parseInBackground(uncachedFiles, workers);
 }
 
-CXXJunkDetector::CXXJunkDetector(JunkDetectionConfig &config)
-    : astStorage(config.cxxCompilationDatabasePath,
-                 config.cxxCompilationFlags) {}
+JunkDetectionMetrics CXXJunkDetector::getMetrics() {
+  auto metrics = astStorage.getMetrics();
+  metrics.cachedVerdicts = junkCache.getHits();
+  return metrics;
+}
 
-bool CXXJunkDetector::isJunk(MutationPoint *point) {
-  if (point->getSourceLocation().isNull()) {
-    return true;
+void CXXJunkDetector::flush() { junkCache.save(); }
+
+static std::string sourceFileName(MutationPoint *point) {
+  auto instruction =
+      llvm::dyn_cast<llvm::Instruction>(point->getOriginalValue());
+  if (instruction == nullptr) {
+    return std::string();
   }
+  return instruction->getModule()->getSourceFileName();
+}
 
-  switch (point->getMutator()->mutatorKind()) {
+static std::string mutantKey(MutationPoint *point) {
+  auto &location = point->getSourceLocation();
+  return point->getMutator()->getUniqueIdentifier() + ":" +
+         std::to_string(location.line) + ":" +
+         std::to_string(location.column) + ":" + location.filePath();
+}
+
+/// The mutators whose mutants may come from no node of the AST
+static bool detectsJunkOf(MutatorKind kind) {
+  switch (kind) {
   case MutatorKind::ConditionalsBoundaryMutator:
-    return isJunkMutation<ConditionalsBoundaryVisitor>(astStorage, point);
   case MutatorKind::MathAddMutator:
-    return isJunkMutation<MathAddVisitor>(astStorage, point);
   case MutatorKind::MathSubMutator:
-    return isJunkMutation<MathSubVisitor>(astStorage, point);
   case MutatorKind::MathMulMutator:
-    return isJunkMutation<MathMulVisitor>(astStorage, point);
   case MutatorKind::MathDivMutator:
-    return isJunkMutation<MathDivVisitor>(astStorage, point);
   case MutatorKind::RemoveVoidFunctionMutator:
-    return isJunkMutation<RemoveVoidFunctionVisitor>(astStorage, point);
   case MutatorKind::ReplaceCallMutator:
-    return isJunkMutation<ReplaceCallVisitor>(astStorage, point);
   case MutatorKind::NegateMutator:
-    return isJunkMutation<NegateConditionVisitor>(astStorage, point);
   case MutatorKind::AndOrReplacementMutator:
-    return isJunkMutation<AndOrReplacementVisitor>(astStorage, point);
+    return true;
   default:
     return false;
   }
+}
+
+bool CXXJunkDetector::isJunk(MutationPoint *point) {
+  if (point->getSourceLocation().isNull()) {
+    return true;
+  }
+
+  auto kind = point->getMutator()->mutatorKind();
+  if (!detectsJunkOf(kind)) {
+    return false;
+  }
+
+  auto sourceFile = sourceFileName(point);
+  if (sourceFile.empty()) {
+    return isJunk(*astStorage.findAST(point), point, kind);
+  }
+
+  auto mutant = mutantKey(point);
+  bool junk = false;
+  junkCache.load(sourceFile, astStorage.compilationFlags(sourceFile));
+  if (junkCache.lookup(sourceFile, mutant, junk)) {
+    return junk;
+  }
+
+  auto ast = astStorage.findAST(sourceFile);
+  junk = isJunk(*ast, point, kind);
+  junkCache.store(sourceFile, mutant, junk,
+                  [ast]() { return ast->getIncludedFiles(); });
+  return junk;
+}
+
+/// The points of a batch share their source file: its verdicts are loaded
+/// and its AST is found once, and only if a verdict is not cached
+void CXXJunkDetector::classify(const std::vector<MutationPoint *> &points,
+                               std::vector<MutationPoint *> &nonJunk) {
+  auto sourceFile = points.empty() ? std::string()
+                                   : sourceFileName(points.front());
+  if (sourceFile.empty()) {
+    JunkDetector::classify(points, nonJunk);
+    return;
+  }
+
+  junkCache.load(sourceFile, astStorage.compilationFlags(sourceFile));
+  std::shared_ptr<ThreadSafeASTUnit> ast;
+  for (auto point : points) {
+    if (point->getSourceLocation().isNull()) {
+      continue;
+    }
+    auto kind = point->getMutator()->mutatorKind();
+    if (!detectsJunkOf(kind)) {
+      nonJunk.push_back(point);
+      continue;
+    }
+
+    auto mutant = mutantKey(point);
+    bool junk = false;
+    if (!junkCache.lookup(sourceFile, mutant, junk)) {
+      if (!ast) {
+        ast = astStorage.findAST(sourceFile);
+      }
+      junk = isJunk(*ast, point, kind);
+      junkCache.store(sourceFile, mutant, junk,
+                      [ast]() { return ast->getIncludedFiles(); });
+    }
+    if (!junk) {
+      nonJunk.push_back(point);
+    }
+  }
+}
+
+bool CXXJunkDetector::isJunk(ThreadSafeASTUnit &ast, MutationPoint *point,
+                             MutatorKind kind) {
+  auto location = ast.getLocation(point);
+  if (ast.isInSystemHeader(location)) {
+    return true;
+  }
 
-  return false;
+  return !ast.getIndex(location).coversMutant(kind, location);
 }
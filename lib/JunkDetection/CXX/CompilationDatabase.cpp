@@ -77,56 +77,147 @@ flagsFromCommand(const CompileCommand &command,
   return flags;
 }
 
-static std::map<std::string, std::vector<std::string>>
-loadDatabaseFromFile(const std::string &path,
-                     const std::vector<std::string> &extraFlags) {
-  std::map<std::string, std::vector<std::string>> database;
-  if (path.empty()) {
-    return database;
+/// Skips a JSON string, position is at the opening quote. Returns the
+/// position after the closing quote, or npos when the string is not closed.
+static size_t skipString(llvm::StringRef json, size_t position,
+                         std::string *value = nullptr) {
+  for (size_t i = position + 1; i < json.size(); i++) {
+    char c = json[i];
+    if (c == '"') {
+      return i + 1;
+    }
+    if (c == '\\' && i + 1 < json.size()) {
+      c = json[++i];
+      switch (c) {
+      case 'n':
+        c = '\n';
+        break;
+      case 't':
+        c = '\t';
+        break;
+      default:
+        break;
+      }
+    }
+    if (value) {
+      value->push_back(c);
+    }
   }
+  return llvm::StringRef::npos;
+}
 
-  std::vector<CompileCommand> commands;
-
-  auto bufferOrError = llvm::MemoryBuffer::getFile(path);
+/// Finds the entries of the top-level array and the value of their "file"
+/// keys without parsing anything else
+void CompilationDatabase::indexDatabase(const std::string &path) {
+  auto bufferOrError = llvm::MemoryBuffer::getFile(path, -1, false);
   if (!bufferOrError) {
     Logger::error() << "Can not read compilation database: " << path << '\n';
-  } else {
-    auto buffer = bufferOrError->get();
-    llvm::yaml::Input json(buffer->getBuffer());
-
-    json >> commands;
+    return;
+  }
+  buffer = std::move(bufferOrError.get());
 
-    if (json.error()) {
-      Logger::error() << "Can not read compilation database: " << path << '\n';
-    }
+  llvm::StringRef json = buffer->getBuffer();
+  size_t position = json.find_first_not_of(" \t\r\n");
+  if (position == llvm::StringRef::npos || json[position] != '[') {
+    Logger::error() << "Can not read compilation database: " << path << '\n';
+    return;
   }
 
-  for (auto &command : commands) {
-    database[command.file] = flagsFromCommand(command, extraFlags);
+  int depth = 0;
+  size_t entryBegin = 0;
+  bool keyExpected = false;
+  std::string file;
+  for (position++; position < json.size(); position++) {
+    char c = json[position];
+    if (c == '"') {
+      std::string key;
+      bool isKey = depth == 1 && keyExpected;
+      auto end = skipString(json, position, isKey ? &key : nullptr);
+      if (end == llvm::StringRef::npos) {
+        break;
+      }
+      position = end - 1;
+
+      /// The value of the file key is the next string
+      if (key == "file") {
+        auto colon = json.find_first_not_of(" \t\r\n", end);
+        if (colon != llvm::StringRef::npos && json[colon] == ':') {
+          auto value = json.find_first_not_of(" \t\r\n", colon + 1);
+          if (value != llvm::StringRef::npos && json[value] == '"') {
+            file.clear();
+            end = skipString(json, value, &file);
+            if (end == llvm::StringRef::npos) {
+              break;
+            }
+            position = end - 1;
+          }
+        }
+      }
+      keyExpected = false;
+    } else if (c == '{' || c == '[') {
+      if (depth++ == 0) {
+        entryBegin = position;
+        file.clear();
+      }
+      keyExpected = c == '{' && depth == 1;
+    } else if (c == ',') {
+      keyExpected = depth == 1;
+    } else if (c == '}' || c == ']') {
+      if (depth == 0) {
+        return;
+      }
+      if (--depth == 0 && !file.empty()) {
+        index[file] = json.slice(entryBegin, position + 1);
+      }
+    }
   }
 
-  return database;
+  Logger::error() << "Can not read compilation database: " << path << '\n';
 }
 
 CompilationDatabase::CompilationDatabase(CompilationDatabase::Path path,
                                          CompilationDatabase::Flags flags)
-    : extraFlags(flagsFromString(flags.getFlags())),
-      database(loadDatabaseFromFile(path.getPath(), extraFlags)) {}
+    : extraFlags(flagsFromString(flags.getFlags())) {
+  if (!path.getPath().empty()) {
+    indexDatabase(path.getPath());
+  }
+}
+
+const std::vector<std::string> &
+CompilationDatabase::flagsForEntry(const std::string &file,
+                                   llvm::StringRef entry) const {
+  std::lock_guard<std::mutex> guard(flagsMutex);
+  auto cached = flags.find(file);
+  if (cached != flags.end()) {
+    return cached->second;
+  }
+
+  CompileCommand command;
+  llvm::yaml::Input json(entry);
+  json >> command;
+  if (json.error()) {
+    Logger::error() << "Can not read compilation database entry of: " << file
+                    << '\n';
+    return flags[file] = extraFlags;
+  }
+
+  return flags[file] = flagsFromCommand(command, extraFlags);
+}
 
 const std::vector<std::string> &CompilationDatabase::compilationFlagsForFile(
     const std::string &filepath) const {
-  if (database.empty()) {
+  if (index.empty()) {
     return extraFlags;
   }
 
-  auto it = database.find(filepath);
-  if (it != database.end()) {
-    return it->second;
+  auto it = index.find(filepath);
+  if (it != index.end()) {
+    return flagsForEntry(filepath, it->second);
   }
   auto filename = llvm::sys::path::filename(filepath);
-  it = database.find(filename);
-  if (it != database.end()) {
-    return it->second;
+  it = index.find(filename);
+  if (it != index.end()) {
+    return flagsForEntry(filename.str(), it->second);
   }
 
   return extraFlags;
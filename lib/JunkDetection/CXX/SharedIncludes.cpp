@@ -0,0 +1,87 @@
+#include "mull/JunkDetection/CXX/SharedIncludes.h"
+
+#include <llvm/ADT/SmallVector.h>
+
+#include <cstring>
+#include <set>
+#include <unordered_map>
+
+using namespace mull;
+
+std::vector<std::string> mull::leadingSystemIncludes(llvm::StringRef source) {
+  std::vector<std::string> includes;
+
+  llvm::SmallVector<llvm::StringRef, 64> lines;
+  source.split(lines, '\n');
+
+  bool inComment = false;
+  for (auto &rawLine : lines) {
+    auto line = rawLine.trim();
+    if (inComment) {
+      auto end = line.find("*/");
+      if (end == llvm::StringRef::npos) {
+        continue;
+      }
+      inComment = false;
+      line = line.drop_front(end + 2).trim();
+    }
+    if (line.startswith("/*")) {
+      auto end = line.find("*/", 2);
+      if (end == llvm::StringRef::npos) {
+        inComment = true;
+        continue;
+      }
+      line = line.drop_front(end + 2).trim();
+    }
+    if (line.empty() || line.startswith("//")) {
+      continue;
+    }
+    if (!line.startswith("#")) {
+      break;
+    }
+
+    auto directive = line.drop_front(1).ltrim();
+    if (directive.startswith("pragma")) {
+      continue;
+    }
+    if (!directive.startswith("include")) {
+      break;
+    }
+
+    auto header = directive.drop_front(strlen("include")).ltrim();
+    if (header.startswith("<")) {
+      auto end = header.find('>');
+      if (end == llvm::StringRef::npos) {
+        break;
+      }
+      includes.push_back(header.slice(1, end).str());
+    } else if (!header.startswith("\"")) {
+      /// Computed includes
+      break;
+    }
+  }
+
+  return includes;
+}
+
+std::vector<std::string> mull::sharedSystemIncludes(
+    const std::vector<std::vector<std::string>> &includes) {
+  std::unordered_map<std::string, int> counts;
+  for (auto &fileIncludes : includes) {
+    std::set<std::string> unique(fileIncludes.begin(), fileIncludes.end());
+    for (auto &header : unique) {
+      counts[header]++;
+    }
+  }
+
+  std::vector<std::string> shared;
+  std::set<std::string> added;
+  for (auto &fileIncludes : includes) {
+    for (auto &header : fileIncludes) {
+      if (counts[header] >= 2 && added.insert(header).second) {
+        shared.push_back(header);
+      }
+    }
+  }
+  return shared;
+}
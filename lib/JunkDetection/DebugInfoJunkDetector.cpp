@@ -0,0 +1,97 @@
+#include "mull/JunkDetection/DebugInfoJunkDetector.h"
+
+#include "mull/MutationPoint.h"
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/IR/DebugInfoMetadata.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Instruction.h>
+#include <llvm/Support/Path.h>
+
+using namespace mull;
+
+/// Where the headers of the system and of the toolchains are installed
+static const char *const SystemDirectories[] = {
+    "/usr/include/", "/usr/lib/", "/Library/Developer/",
+    "/Applications/Xcode"};
+
+static bool isInSystemDirectory(const llvm::DILocation &location) {
+  llvm::SmallString<256> path(location.getFilename());
+  if (!llvm::sys::path::is_absolute(path)) {
+    path = location.getDirectory();
+    llvm::sys::path::append(path, location.getFilename());
+  }
+  llvm::StringRef file(path);
+  for (auto directory : SystemDirectories) {
+    if (file.startswith(directory)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+DebugInfoJunkDetector::DebugInfoJunkDetector(
+    std::unique_ptr<JunkDetector> next)
+    : next(std::move(next)), verdicts(0) {}
+
+bool DebugInfoJunkDetector::isObviousJunk(MutationPoint *point) {
+  if (point->getSourceLocation().isNull()) {
+    return true;
+  }
+  auto instruction =
+      llvm::dyn_cast<llvm::Instruction>(point->getOriginalValue());
+  if (instruction == nullptr) {
+    return false;
+  }
+  auto location = instruction->getDebugLoc().get();
+  if (location == nullptr || location->getColumn() == 0) {
+    return true;
+  }
+
+  /// Marked artificial by the compiler, it has no source of its own
+  auto subprogram = instruction->getFunction()->getSubprogram();
+  if (subprogram != nullptr && subprogram->isArtificial()) {
+    return true;
+  }
+
+  /// Where the instruction was written, not where it was inlined
+  return isInSystemDirectory(*location);
+}
+
+bool DebugInfoJunkDetector::isJunk(MutationPoint *point) {
+  if (isObviousJunk(point)) {
+    verdicts.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+  return next->isJunk(point);
+}
+
+void DebugInfoJunkDetector::classify(
+    const std::vector<MutationPoint *> &points,
+    std::vector<MutationPoint *> &nonJunk) {
+  std::vector<MutationPoint *> ambiguous;
+  ambiguous.reserve(points.size());
+  for (auto point : points) {
+    if (!isObviousJunk(point)) {
+      ambiguous.push_back(point);
+    }
+  }
+  verdicts.fetch_add(points.size() - ambiguous.size(),
+                     std::memory_order_relaxed);
+  if (!ambiguous.empty()) {
+    next->classify(ambiguous, nonJunk);
+  }
+}
+
+void DebugInfoJunkDetector::prepare(const std::vector<std::string> &sourceFiles,
+                                    int workers) {
+  next->prepare(sourceFiles, workers);
+}
+
+JunkDetectionMetrics DebugInfoJunkDetector::getMetrics() {
+  auto metrics = next->getMetrics();
+  metrics.debugInfoVerdicts = verdicts.load(std::memory_order_relaxed);
+  return metrics;
+}
+
+void DebugInfoJunkDetector::flush() { next->flush(); }
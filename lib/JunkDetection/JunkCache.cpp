@@ -0,0 +1,176 @@
+#include "mull/JunkDetection/JunkCache.h"
+
+#include "mull/CacheFile.h"
+#include "mull/Logger.h"
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/StringRef.h>
+#include <llvm/Support/MD5.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/raw_ostream.h>
+
+using namespace mull;
+
+static const char *const Header = "mull-junk-cache 1";
+
+static std::string MD5HashFromBuffer(llvm::StringRef buffer) {
+  llvm::MD5 hasher;
+  hasher.update(buffer);
+  llvm::MD5::MD5Result hash;
+  hasher.final(hash);
+  llvm::SmallString<32> result;
+  llvm::MD5::stringifyResult(hash, result);
+  return std::string(result.str());
+}
+
+JunkCache::JunkCache(const std::string &cacheDirectory,
+                     const std::string &version)
+    : cacheDirectory(cacheDirectory), version(version), hits(0) {}
+
+bool JunkCache::load(const std::string &sourceFile,
+                     const std::vector<std::string> &flags) {
+  if (cacheDirectory.empty()) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> guard(mutex);
+  auto inserted = entries.insert(std::make_pair(sourceFile, Entry()));
+  Entry &entry = inserted.first->second;
+  if (!inserted.second) {
+    return entry.valid;
+  }
+
+  std::string identifier = version + '\0' + sourceFile;
+  for (auto &flag : flags) {
+    identifier += '\0' + flag;
+  }
+  entry.path = cacheDirectory + "/junk/" + MD5HashFromBuffer(identifier);
+
+  entry.valid = read(entry);
+  if (!entry.valid) {
+    entry.dependencies.clear();
+    entry.verdicts.clear();
+  }
+  return entry.valid;
+}
+
+/// The format is line based:
+///
+///     mull-junk-cache 1
+///     depends <md5> <path>
+///     junk <mutant>
+///     clean <mutant>
+bool JunkCache::read(Entry &entry) {
+  auto buffer = llvm::MemoryBuffer::getFile(entry.path);
+  if (!buffer) {
+    return false;
+  }
+
+  llvm::SmallVector<llvm::StringRef, 64> lines;
+  buffer.get()->getBuffer().split(lines, '\n', -1, false);
+  if (lines.empty() || lines.front() != Header) {
+    return false;
+  }
+
+  for (auto &line : llvm::makeArrayRef(lines).drop_front()) {
+    auto kindAndRest = line.split(' ');
+    if (kindAndRest.first == "depends") {
+      auto hashAndPath = kindAndRest.second.split(' ');
+      if (fileHash(hashAndPath.second.str()) != hashAndPath.first) {
+        return false;
+      }
+      entry.dependencies.emplace_back(hashAndPath.second.str(),
+                                      hashAndPath.first.str());
+    } else if (kindAndRest.first == "junk") {
+      entry.verdicts[kindAndRest.second.str()] = true;
+    } else if (kindAndRest.first == "clean") {
+      entry.verdicts[kindAndRest.second.str()] = false;
+    } else {
+      return false;
+    }
+  }
+
+  return !entry.dependencies.empty();
+}
+
+bool JunkCache::lookup(const std::string &sourceFile,
+                       const std::string &mutant, bool &junk) {
+  std::lock_guard<std::mutex> guard(mutex);
+  auto entry = entries.find(sourceFile);
+  if (entry == entries.end()) {
+    return false;
+  }
+  auto verdict = entry->second.verdicts.find(mutant);
+  if (verdict == entry->second.verdicts.end()) {
+    return false;
+  }
+  junk = verdict->second;
+  hits++;
+  return true;
+}
+
+void JunkCache::store(
+    const std::string &sourceFile, const std::string &mutant, bool junk,
+    const std::function<std::vector<std::string>()> &dependencies) {
+  std::lock_guard<std::mutex> guard(mutex);
+  auto found = entries.find(sourceFile);
+  if (found == entries.end()) {
+    return;
+  }
+
+  Entry &entry = found->second;
+  if (entry.dependencies.empty()) {
+    for (auto &dependency : dependencies()) {
+      entry.dependencies.emplace_back(dependency, fileHash(dependency));
+    }
+  }
+  entry.verdicts[mutant] = junk;
+  entry.changed = true;
+}
+
+void JunkCache::save() {
+  std::lock_guard<std::mutex> guard(mutex);
+  for (auto &pair : entries) {
+    if (pair.second.changed) {
+      write(pair.second);
+      pair.second.changed = false;
+    }
+  }
+}
+
+void JunkCache::write(const Entry &entry) {
+  auto error = writeCacheFile(entry.path, [&](llvm::raw_ostream &outfile) {
+    outfile << Header << "\n";
+    for (auto &dependency : entry.dependencies) {
+      outfile << "depends " << dependency.second << " " << dependency.first
+              << "\n";
+    }
+    for (auto &verdict : entry.verdicts) {
+      outfile << (verdict.second ? "junk " : "clean ") << verdict.first
+              << "\n";
+    }
+  });
+  if (error) {
+    Logger::error() << "Cannot write junk cache file '" << entry.path
+                    << "': " << error.message() << "\n";
+  }
+}
+
+/// Headers are shared by many translation units, each is only read once
+std::string JunkCache::fileHash(const std::string &path) {
+  auto found = fileHashes.find(path);
+  if (found != fileHashes.end()) {
+    return found->second;
+  }
+
+  std::string hash;
+  auto buffer = llvm::MemoryBuffer::getFile(path);
+  if (buffer) {
+    hash = MD5HashFromBuffer(buffer.get()->getBuffer());
+  }
+  fileHashes[path] = hash;
+  return hash;
+}
+
+uint64_t JunkCache::getHits() const { return hits; }
@@ -0,0 +1,234 @@
+#include "mull/JunkDetection/JunkDetectionProcesses.h"
+
+#include "mull/JunkDetection/JunkDetector.h"
+#include "mull/Logger.h"
+#include "mull/MutationPoint.h"
+#include "mull/Parallelization/ThreadPool.h"
+
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <functional>
+#include <set>
+#include <string>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <unordered_set>
+
+using namespace mull;
+
+namespace {
+
+/// The points of the source files of a helper, as indices into all of them
+struct Shard {
+  std::vector<size_t> indices;
+  pid_t pid;
+  int output;
+
+  Shard() : pid(-1), output(-1) {}
+};
+
+} // namespace
+
+static const std::string &sourceFileName(MutationPoint *point) {
+  return point->getOriginalFunction()->getParent()->getSourceFileName();
+}
+
+static bool writeAll(int descriptor, const void *data, size_t size) {
+  auto bytes = static_cast<const char *>(data);
+  while (size != 0) {
+    ssize_t written = write(descriptor, bytes, size);
+    if (written == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    bytes += written;
+    size -= size_t(written);
+  }
+  return true;
+}
+
+static bool readAll(int descriptor, void *data, size_t size) {
+  auto bytes = static_cast<char *>(data);
+  while (size != 0) {
+    ssize_t read = ::read(descriptor, bytes, size);
+    if (read == -1 && errno == EINTR) {
+      continue;
+    }
+    if (read <= 0) {
+      return false;
+    }
+    bytes += read;
+    size -= size_t(read);
+  }
+  return true;
+}
+
+static void addMetrics(JunkDetectionMetrics &total,
+                       const JunkDetectionMetrics &metrics) {
+  total.filesIndexed += metrics.filesIndexed;
+  total.nodesVisited += metrics.nodesVisited;
+  total.declarationsSkipped += metrics.declarationsSkipped;
+  total.cachedVerdicts += metrics.cachedVerdicts;
+  total.unitsEvicted += metrics.unitsEvicted;
+  total.unitsReparsed += metrics.unitsReparsed;
+  total.debugInfoVerdicts += metrics.debugInfoVerdicts;
+}
+
+/// A bit per point of the shard, set for the junk. The points of a
+/// function are next to each other, they are classified together.
+static std::vector<uint8_t>
+classifyShard(JunkDetector &detector,
+              const std::vector<MutationPoint *> &points,
+              const Shard &shard) {
+  std::set<std::string> sourceFiles;
+  for (auto index : shard.indices) {
+    sourceFiles.insert(sourceFileName(points[index]));
+  }
+  detector.prepare(
+      std::vector<std::string>(sourceFiles.begin(), sourceFiles.end()), 1);
+
+  std::vector<uint8_t> verdicts((shard.indices.size() + 7) / 8, 0);
+  size_t begin = 0;
+  while (begin < shard.indices.size()) {
+    auto function = points[shard.indices[begin]]->getOriginalFunction();
+    std::vector<MutationPoint *> batch;
+    size_t end = begin;
+    while (end < shard.indices.size() &&
+           points[shard.indices[end]]->getOriginalFunction() == function) {
+      batch.push_back(points[shard.indices[end]]);
+      end++;
+    }
+
+    std::vector<MutationPoint *> nonJunk;
+    detector.classify(batch, nonJunk);
+    std::unordered_set<MutationPoint *> kept(nonJunk.begin(), nonJunk.end());
+    for (size_t bit = begin; bit < end; bit++) {
+      if (kept.count(points[shard.indices[bit]]) == 0) {
+        verdicts[bit / 8] |= uint8_t(1 << (bit % 8));
+      }
+    }
+    begin = end;
+  }
+  return verdicts;
+}
+
+static void applyVerdicts(const std::vector<uint8_t> &verdicts,
+                          const Shard &shard, std::vector<bool> &junk) {
+  for (size_t bit = 0; bit < shard.indices.size(); bit++) {
+    junk[shard.indices[bit]] = (verdicts[bit / 8] >> (bit % 8)) & 1;
+  }
+}
+
+std::vector<MutationPoint *>
+mull::detectJunkInProcesses(JunkDetector &detector,
+                            const std::vector<MutationPoint *> &points,
+                            int processes, JunkDetectionMetrics &metrics) {
+  /// A file always goes to the same helper, as in the in-process detection
+  std::vector<Shard> shards(std::max(processes, 1));
+  for (size_t index = 0; index < points.size(); index++) {
+    auto hash = std::hash<std::string>()(sourceFileName(points[index]));
+    shards[hash % shards.size()].indices.push_back(index);
+  }
+
+  std::vector<bool> junk(points.size(), false);
+  bool classifiedHere = false;
+
+  /// The helpers would write what is buffered once more otherwise
+  Logger::flush();
+  llvm::outs().flush();
+  llvm::errs().flush();
+  for (auto &shard : shards) {
+    if (shard.indices.empty()) {
+      continue;
+    }
+    int descriptors[2] = {-1, -1};
+    if (pipe(descriptors) == -1 || (shard.pid = fork()) == -1) {
+      Logger::warn() << "Cannot fork a junk detection process, its files are "
+                        "classified in this one: "
+                     << strerror(errno) << "\n";
+      for (int descriptor : descriptors) {
+        if (descriptor != -1) {
+          close(descriptor);
+        }
+      }
+      applyVerdicts(classifyShard(detector, points, shard), shard, junk);
+      classifiedHere = true;
+      continue;
+    }
+
+    if (shard.pid == 0) {
+      ThreadPool::shared().forgetThreads();
+      for (auto &other : shards) {
+        if (other.output != -1) {
+          close(other.output);
+        }
+      }
+      close(descriptors[0]);
+      auto verdicts = classifyShard(detector, points, shard);
+      auto shardMetrics = detector.getMetrics();
+      const bool sent =
+          writeAll(descriptors[1], verdicts.data(), verdicts.size()) &&
+          writeAll(descriptors[1], &shardMetrics, sizeof(shardMetrics));
+      close(descriptors[1]);
+      detector.flush();
+      Logger::flush();
+      llvm::outs().flush();
+      llvm::errs().flush();
+      _exit(sent ? 0 : 1);
+    }
+
+    close(descriptors[1]);
+    shard.output = descriptors[0];
+  }
+
+  size_t failedProcesses = 0;
+  size_t keptPoints = 0;
+  for (auto &shard : shards) {
+    if (shard.output == -1) {
+      continue;
+    }
+    std::vector<uint8_t> verdicts((shard.indices.size() + 7) / 8, 0);
+    JunkDetectionMetrics shardMetrics;
+    const bool received =
+        readAll(shard.output, verdicts.data(), verdicts.size()) &&
+        readAll(shard.output, &shardMetrics, sizeof(shardMetrics));
+    close(shard.output);
+    int status = 0;
+    while (waitpid(shard.pid, &status, 0) == -1 && errno == EINTR) {
+    }
+
+    if (!received) {
+      failedProcesses++;
+      keptPoints += shard.indices.size();
+      continue;
+    }
+    applyVerdicts(verdicts, shard, junk);
+    addMetrics(metrics, shardMetrics);
+  }
+
+  if (classifiedHere) {
+    addMetrics(metrics, detector.getMetrics());
+  }
+  if (failedProcesses != 0) {
+    Logger::warn() << failedProcesses
+                   << " junk detection processes did not answer, the "
+                   << keptPoints << " mutants of their files are kept\n";
+  }
+
+  std::vector<MutationPoint *> nonJunk;
+  nonJunk.reserve(points.size());
+  for (size_t index = 0; index < points.size(); index++) {
+    if (!junk[index]) {
+      nonJunk.push_back(points[index]);
+    }
+  }
+  return nonJunk;
+}
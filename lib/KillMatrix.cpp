@@ -0,0 +1,136 @@
+#include "mull/KillMatrix.h"
+
+#include "mull/Logger.h"
+#include "mull/MutationPoint.h"
+#include "mull/TestFrameworks/Test.h"
+
+#include <cerrno>
+#include <cstring>
+#include <limits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace mull;
+
+static const char Magic[8] = {'M', 'U', 'L', 'L', 'K', 'M', 'X', '\0'};
+static const uint32_t NoColumn = std::numeric_limits<uint32_t>::max();
+static const size_t CellsPerByte = 4;
+
+KillMatrix::KillMatrix(const std::string &path,
+                       const std::vector<MutationPoint *> &mutationPoints,
+                       const std::vector<Test> &tests)
+    : path(path), mutationPoints(mutationPoints),
+      rowSize((tests.size() + CellsPerByte - 1) / CellsPerByte),
+      mapping(nullptr), cells(nullptr) {
+  rows.reserve(mutationPoints.size());
+  for (size_t row = 0; row < mutationPoints.size(); row++) {
+    rows[mutationPoints[row]] = row;
+  }
+  testIdentifiers.reserve(tests.size());
+  testNames.reserve(tests.size());
+  for (size_t column = 0; column < tests.size(); column++) {
+    auto id = tests[column].getId();
+    if (columns.size() <= id) {
+      columns.resize(id + 1, NoColumn);
+    }
+    columns[id] = column;
+    testIdentifiers.push_back(tests[column].getUniqueIdentifier());
+    testNames.push_back(tests[column].getTestName());
+  }
+
+  int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd == -1) {
+    Logger::error() << "Cannot create the kill matrix " << path << ": "
+                    << strerror(errno) << "\n";
+    return;
+  }
+  /// The file is sparse, the cells not run are never written
+  if (ftruncate(fd, getFileSize()) != 0) {
+    Logger::error() << "Cannot allocate the kill matrix " << path << ": "
+                    << strerror(errno) << "\n";
+    close(fd);
+    return;
+  }
+  void *memory = mmap(nullptr, getFileSize(), PROT_READ | PROT_WRITE,
+                      MAP_SHARED, fd, 0);
+  close(fd);
+  if (memory == MAP_FAILED) {
+    Logger::error() << "Cannot map the kill matrix " << path << ": "
+                    << strerror(errno) << "\n";
+    return;
+  }
+
+  mapping = static_cast<uint8_t *>(memory);
+  auto header = reinterpret_cast<Header *>(mapping);
+  memcpy(header->magic, Magic, sizeof(Magic));
+  header->version = Version;
+  header->rowSize = rowSize;
+  header->rows = mutationPoints.size();
+  header->columns = tests.size();
+  cells = mapping + sizeof(Header);
+}
+
+KillMatrix::~KillMatrix() {
+  if (mapping) {
+    munmap(mapping, getFileSize());
+  }
+}
+
+size_t KillMatrix::getFileSize() const {
+  return sizeof(Header) + mutationPoints.size() * rowSize;
+}
+
+bool KillMatrix::rowOf(const MutationPoint &point, size_t &row) const {
+  auto found = rows.find(&point);
+  if (found == rows.end()) {
+    return false;
+  }
+  row = found->second;
+  return true;
+}
+
+void KillMatrix::set(const MutationPoint &point, const Test &test,
+                     ExecutionStatus status) {
+  size_t row;
+  auto id = test.getId();
+  if (!cells || !rowOf(point, row) || columns.size() <= id ||
+      columns[id] == NoColumn) {
+    return;
+  }
+  auto column = columns[id];
+  auto &byte = cells[row * rowSize + column / CellsPerByte];
+  auto shift = column % CellsPerByte * 2;
+  byte = (byte & ~(3 << shift)) |
+         (static_cast<uint8_t>(cellOf(status)) << shift);
+}
+
+void KillMatrix::copyRow(const MutationPoint &from, const MutationPoint &to) {
+  size_t fromRow, toRow;
+  if (!cells || !rowOf(from, fromRow) || !rowOf(to, toRow)) {
+    return;
+  }
+  memcpy(cells + toRow * rowSize, cells + fromRow * rowSize, rowSize);
+}
+
+KillMatrix::Cell KillMatrix::get(size_t row, size_t column) const {
+  auto byte = cells[row * rowSize + column / CellsPerByte];
+  return static_cast<Cell>((byte >> (column % CellsPerByte * 2)) & 3);
+}
+
+KillMatrix::Cell KillMatrix::cellOf(ExecutionStatus status) {
+  switch (status) {
+  case Passed:
+    return Cell::Survived;
+  case Failed:
+    return Cell::Killed;
+  case Timedout:
+  case Crashed:
+  case AbnormalExit:
+  case LoopBudgetExceeded:
+    return Cell::Abnormal;
+  default:
+    return Cell::NotRun;
+  }
+}
@@ -1,17 +1,247 @@
 #include "mull/Logger.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
 namespace mull {
 
+/// How many times in a row the same line is written, the further
+/// repetitions are only counted
+static const int RepeatedLinesLimit = 3;
+
+static void writeToStdout(const std::string &text) {
+  size_t done = 0;
+  while (done < text.size()) {
+    ssize_t result = ::write(STDOUT_FILENO, text.data() + done,
+                             text.size() - done);
+    if (result <= 0) {
+      return;
+    }
+    done += result;
+  }
+}
+
+namespace {
+/// Writes the lines of every thread on a thread of its own
+class LogSink {
+public:
+  LogSink()
+      : owner(getpid()), stopping(false), queued(0), written(0),
+        repetitions(0), suppressed(0) {
+    /// Constructed first, outs() is destroyed after the sink
+    llvm::outs();
+    writer = std::thread(&LogSink::writeLines, this);
+  }
+
+  ~LogSink() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    wakeup.notify_one();
+    writer.join();
+  }
+
+  void push(std::string text) {
+    /// A forked child has no writer, and the lock may be held by a thread
+    /// that does not exist in it
+    if (getpid() != owner) {
+      writeToStdout(text);
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      lines.push_back(std::move(text));
+      queued++;
+    }
+    wakeup.notify_one();
+  }
+
+  void flush() {
+    if (getpid() != owner) {
+      return;
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    uint64_t target = queued;
+    flushed.wait(lock, [&]() { return written >= target; });
+  }
+
+private:
+  void writeLines() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+      wakeup.wait(lock, [this]() { return stopping || !lines.empty(); });
+      std::vector<std::string> batch;
+      batch.swap(lines);
+      uint64_t batchEnd = queued;
+      bool stop = stopping;
+      lock.unlock();
+
+      for (auto &line : batch) {
+        write(line);
+      }
+      if (stop) {
+        writeSuppressed();
+      }
+      llvm::outs().flush();
+
+      lock.lock();
+      written = batchEnd;
+      flushed.notify_all();
+      if (stop && lines.empty()) {
+        return;
+      }
+    }
+  }
+
+  /// A progress line is rewritten in place and never counts as a repetition
+  void write(const std::string &line) {
+    bool wholeLine = line.back() == '\n' && line.find('\r') == line.npos;
+    if (wholeLine && line == lastLine) {
+      if (++repetitions > RepeatedLinesLimit) {
+        suppressed++;
+        return;
+      }
+    } else {
+      writeSuppressed();
+      lastLine = wholeLine ? line : std::string();
+      repetitions = 1;
+    }
+    llvm::outs() << line;
+  }
+
+  void writeSuppressed() {
+    if (suppressed != 0) {
+      llvm::outs() << "(the line above repeated " << suppressed
+                   << " more times)\n";
+      suppressed = 0;
+    }
+  }
+
+  const pid_t owner;
+  std::thread writer;
+  std::mutex mutex;
+  std::condition_variable wakeup;
+  std::condition_variable flushed;
+  std::vector<std::string> lines;
+  bool stopping;
+  uint64_t queued;
+  uint64_t written;
+
+  /// Only touched by the writer
+  std::string lastLine;
+  int repetitions;
+  uint64_t suppressed;
+};
+
+std::atomic<bool> asynchronousLogging(false);
+std::atomic<bool> sinkAlive(false);
+
+LogSink &sink() {
+  static LogSink sink;
+  return sink;
+}
+
+/// Collects the messages of a thread until they make up whole lines, so the
+/// lines of the workers are neither interleaved nor written by the workers
+class ThreadStream : public llvm::raw_ostream {
+public:
+  ThreadStream() : llvm::raw_ostream(true), position(0) {}
+
+  ~ThreadStream() override { handOverPending(); }
+
+  /// Hands over what is not a whole line yet
+  void handOverPending() {
+    std::lock_guard<std::mutex> lock(mutex);
+    handOver();
+  }
+
+private:
+  void handOver() {
+    if (text.empty()) {
+      return;
+    }
+    if (sinkAlive) {
+      sink().push(std::move(text));
+    } else {
+      writeToStdout(text);
+    }
+    text.clear();
+  }
+
+  void write_impl(const char *ptr, size_t size) override {
+    std::lock_guard<std::mutex> lock(mutex);
+    text.append(ptr, size);
+    position += size;
+    if (text.back() == '\n' || text.find('\r') != text.npos) {
+      handOver();
+    }
+  }
+
+  uint64_t current_pos() const override { return position; }
+
+  /// The stream of a thread may be written by another one, e.g. the progress
+  /// of a phase is reported on a thread of the pool
+  std::mutex mutex;
+  std::string text;
+  uint64_t position;
+};
+
+ThreadStream &threadStream() {
+  thread_local ThreadStream stream;
+  return stream;
+}
+
+/// Marks the end of the sink, which is destroyed right before it
+struct SinkLifetime {
+  SinkLifetime() {
+    sink();
+    sinkAlive = true;
+  }
+  ~SinkLifetime() { sinkAlive = false; }
+};
+} // namespace
+
 void Logger::setLevel(Logger::Level level) { logLevel = level; }
 
+void Logger::setAsynchronous(bool asynchronous) {
+  if (asynchronous) {
+    static SinkLifetime lifetime;
+  } else {
+    flush();
+  }
+  asynchronousLogging = asynchronous;
+}
+
+void Logger::flush() {
+  if (!sinkAlive) {
+    llvm::outs().flush();
+    return;
+  }
+  threadStream().handOverPending();
+  sink().flush();
+}
+
 llvm::raw_ostream &Logger::error() { return getStream(Logger::Level::error); }
 llvm::raw_ostream &Logger::warn() { return getStream(Logger::Level::warn); }
 llvm::raw_ostream &Logger::info() { return getStream(Logger::Level::info); }
 llvm::raw_ostream &Logger::debug() { return getStream(Logger::Level::debug); }
 
 llvm::raw_ostream &Logger::getStream(Logger::Level level) {
-  if (Logger::logLevel <= level)
+  if (Logger::logLevel <= level) {
+    if (asynchronousLogging) {
+      return threadStream();
+    }
     return llvm::outs();
+  }
   return llvm::nulls();
 }
 
@@ -0,0 +1,100 @@
+#include "mull/MemoryBudget.h"
+
+#include "mull/Metrics/Metrics.h"
+
+#include <algorithm>
+
+using namespace mull;
+
+MemoryBudget::MemoryBudget(uint64_t budget,
+                           std::function<uint64_t()> resident)
+    : budget(budget), resident(std::move(resident)), reserved(0),
+      childrenInFlight(0), imagesLoading(0), childEstimate(0),
+      imageEstimate(0), waited(0) {
+  if (!this->resident) {
+    this->resident = []() { return MemoryUsage::currentResident(); };
+  }
+}
+
+bool MemoryBudget::fits(uint64_t bytes) {
+  return resident() + reserved + bytes <= budget;
+}
+
+bool MemoryBudget::idle() const {
+  return childrenInFlight == 0 && imagesLoading == 0;
+}
+
+MemoryBudget::Reservation MemoryBudget::reserve(uint64_t bytes) {
+  Reservation reservation;
+  reservation.bytes = bytes;
+  reservation.residentBefore = resident();
+  reserved += bytes;
+  return reservation;
+}
+
+MemoryBudget::Reservation MemoryBudget::admitChild() {
+  std::unique_lock<std::mutex> lock(mutex);
+  if (!idle() && !fits(childEstimate)) {
+    waited++;
+    released.wait(lock, [&]() { return idle() || fits(childEstimate); });
+  }
+  childrenInFlight++;
+  return reserve(childEstimate);
+}
+
+bool MemoryBudget::tryAdmitChild(Reservation &reservation) {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (!idle() && !fits(childEstimate)) {
+    return false;
+  }
+  childrenInFlight++;
+  reservation = reserve(childEstimate);
+  return true;
+}
+
+void MemoryBudget::releaseChild(const Reservation &reservation,
+                                uint64_t peakResident) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    reserved -= reservation.bytes;
+    childrenInFlight--;
+    /// The estimate follows the largest children, and lets go of an
+    /// outlier over the next few dozen children
+    if (peakResident != 0) {
+      auto taken = peakResident > reservation.residentBefore
+                       ? peakResident - reservation.residentBefore
+                       : 0;
+      childEstimate = std::max(taken, childEstimate - childEstimate / 8);
+    }
+  }
+  released.notify_all();
+}
+
+MemoryBudget::Reservation MemoryBudget::admitImage() {
+  std::unique_lock<std::mutex> lock(mutex);
+  if (!idle() && !fits(imageEstimate)) {
+    waited++;
+    released.wait(lock, [&]() { return idle() || fits(imageEstimate); });
+  }
+  imagesLoading++;
+  return reserve(imageEstimate);
+}
+
+void MemoryBudget::imageLoaded(const Reservation &reservation) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    reserved -= reservation.bytes;
+    imagesLoading--;
+    auto now = resident();
+    if (now > reservation.residentBefore) {
+      imageEstimate =
+          std::max(imageEstimate, now - reservation.residentBefore);
+    }
+  }
+  released.notify_all();
+}
+
+uint64_t MemoryBudget::waits() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return waited;
+}
@@ -0,0 +1,77 @@
+#include "mull/Metrics/Histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace mull;
+
+Histogram::Histogram() : total(0), maximum(0) {
+  for (auto &count : counts) {
+    count.store(0, std::memory_order_relaxed);
+  }
+}
+
+static unsigned mostSignificantBit(uint64_t value) {
+  unsigned bit = 0;
+  while (value >>= 1) {
+    bit++;
+  }
+  return bit;
+}
+
+size_t Histogram::bucketIndex(uint64_t value) {
+  const uint64_t linear = uint64_t(2) << SubBucketBits;
+  if (value < linear) {
+    return size_t(value);
+  }
+  unsigned shift = mostSignificantBit(value) - SubBucketBits;
+  uint64_t subBucket = (value >> shift) - (uint64_t(1) << SubBucketBits);
+  return size_t(linear + ((shift - 1) << SubBucketBits) + subBucket);
+}
+
+uint64_t Histogram::bucketUpperBound(size_t index) {
+  const uint64_t linear = uint64_t(2) << SubBucketBits;
+  if (index < linear) {
+    return index;
+  }
+  unsigned shift = unsigned((index - linear) >> SubBucketBits) + 1;
+  uint64_t subBucket = (index - linear) & ((uint64_t(1) << SubBucketBits) - 1);
+  uint64_t lowerBound = ((uint64_t(1) << SubBucketBits) + subBucket) << shift;
+  return lowerBound + ((uint64_t(1) << shift) - 1);
+}
+
+void Histogram::record(uint64_t value) {
+  counts[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+  total.fetch_add(1, std::memory_order_relaxed);
+  uint64_t current = maximum.load(std::memory_order_relaxed);
+  while (value > current &&
+         !maximum.compare_exchange_weak(current, value,
+                                        std::memory_order_relaxed)) {
+  }
+}
+
+uint64_t Histogram::count() const {
+  return total.load(std::memory_order_relaxed);
+}
+
+uint64_t Histogram::max() const {
+  return maximum.load(std::memory_order_relaxed);
+}
+
+uint64_t Histogram::percentile(double percentile) const {
+  uint64_t recorded = count();
+  if (recorded == 0) {
+    return 0;
+  }
+  auto rank = uint64_t(std::ceil(percentile / 100.0 * recorded));
+  rank = std::min(std::max(rank, uint64_t(1)), recorded);
+
+  uint64_t seen = 0;
+  for (size_t index = 0; index < Buckets; index++) {
+    seen += counts[index].load(std::memory_order_relaxed);
+    if (seen >= rank) {
+      return std::min(bucketUpperBound(index), max());
+    }
+  }
+  return max();
+}
@@ -0,0 +1,282 @@
+#include "mull/Metrics/LiveMetrics.h"
+
+#include "mull/Logger.h"
+#include "mull/Metrics/Metrics.h"
+#include "mull/Socket.h"
+
+#include <llvm/Support/Format.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <netdb.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+using namespace mull;
+
+static int64_t secondsSinceEpoch() {
+  return std::chrono::duration_cast<std::chrono::seconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+LiveMetrics::LiveMetrics()
+    : phase(nullptr), done(0), total(0), workers(0), lastProgress(0),
+      mutantRuns(0), forks(0), forkNanoseconds(0), cacheHits(0),
+      cacheMisses(0), started(secondsSinceEpoch()) {}
+
+LiveMetrics &LiveMetrics::shared() {
+  static LiveMetrics metrics;
+  return metrics;
+}
+
+void LiveMetrics::beginPhase(const char *name) {
+  phases.push_back(name);
+  phase.store(name, std::memory_order_relaxed);
+}
+
+void LiveMetrics::endPhase(const char *name) {
+  for (auto it = phases.rbegin(); it != phases.rend(); ++it) {
+    if (strcmp(*it, name) == 0) {
+      phases.erase(std::next(it).base());
+      break;
+    }
+  }
+  phase.store(phases.empty() ? nullptr : phases.back(),
+              std::memory_order_relaxed);
+}
+
+void LiveMetrics::setProgress(uint64_t done, uint64_t total,
+                              uint64_t workers) {
+  if (this->done.exchange(done, std::memory_order_relaxed) != done) {
+    lastProgress.store(secondsSinceEpoch(), std::memory_order_relaxed);
+  }
+  this->total.store(total, std::memory_order_relaxed);
+  this->workers.store(workers, std::memory_order_relaxed);
+}
+
+void LiveMetrics::addMutantRun(int64_t forkNanoseconds) {
+  mutantRuns.fetch_add(1, std::memory_order_relaxed);
+  if (forkNanoseconds > 0) {
+    forks.fetch_add(1, std::memory_order_relaxed);
+    this->forkNanoseconds.fetch_add(uint64_t(forkNanoseconds),
+                                    std::memory_order_relaxed);
+  }
+}
+
+void LiveMetrics::addCacheLookup(bool hit) {
+  (hit ? cacheHits : cacheMisses).fetch_add(1, std::memory_order_relaxed);
+}
+
+static void writeMetric(llvm::raw_ostream &stream, const char *name,
+                        const char *type, const char *help) {
+  stream << "# TYPE " << name << " " << type << "\n"
+         << "# HELP " << name << " " << help << "\n";
+}
+
+void LiveMetrics::write(llvm::raw_ostream &stream) const {
+  auto load = [](const std::atomic<uint64_t> &value) {
+    return value.load(std::memory_order_relaxed);
+  };
+
+  writeMetric(stream, "mull_phase", "stateset", "The phase of the run");
+  auto current = phase.load(std::memory_order_relaxed);
+  stream << "mull_phase{mull_phase=\"" << (current ? current : "None")
+         << "\"} 1\n";
+
+  writeMetric(stream, "mull_start_time_seconds", "gauge",
+              "When the run started");
+  stream << "mull_start_time_seconds " << started << "\n";
+
+  writeMetric(stream, "mull_progress_done", "gauge",
+              "What the current step has done");
+  stream << "mull_progress_done " << load(done) << "\n";
+  writeMetric(stream, "mull_progress_total", "gauge",
+              "What the current step has to do");
+  stream << "mull_progress_total " << load(total) << "\n";
+  writeMetric(stream, "mull_progress_workers", "gauge",
+              "The workers of the current step");
+  stream << "mull_progress_workers " << load(workers) << "\n";
+  writeMetric(stream, "mull_last_progress_time_seconds", "gauge",
+              "When the current step last made progress");
+  stream << "mull_last_progress_time_seconds "
+         << lastProgress.load(std::memory_order_relaxed) << "\n";
+
+  writeMetric(stream, "mull_mutant_runs", "counter",
+              "The runs of the tests against the mutants");
+  stream << "mull_mutant_runs_total " << load(mutantRuns) << "\n";
+  writeMetric(stream, "mull_fork_seconds", "summary",
+              "The time the forks of the mutant runs took");
+  const double forkSeconds = double(load(forkNanoseconds)) / 1e9;
+  stream << "mull_fork_seconds_count " << load(forks) << "\n"
+         << "mull_fork_seconds_sum " << llvm::format("%.6f", forkSeconds)
+         << "\n";
+
+  writeMetric(stream, "mull_object_cache_hits", "counter",
+              "The objects found in the cache");
+  stream << "mull_object_cache_hits_total " << load(cacheHits) << "\n";
+  writeMetric(stream, "mull_object_cache_misses", "counter",
+              "The objects compiled as they were not in the cache");
+  stream << "mull_object_cache_misses_total " << load(cacheMisses) << "\n";
+
+  writeMetric(stream, "mull_resident_memory_bytes", "gauge",
+              "The resident set of the process");
+  stream << "mull_resident_memory_bytes " << MemoryUsage::currentResident()
+         << "\n";
+  stream << "# EOF\n";
+}
+
+#pragma mark - Server
+
+/// A scraper that does not send its request does not hold up the others
+static const int RequestTimeoutSeconds = 1;
+
+MetricsServer::MetricsServer(const std::string &endpoint)
+    : endpoint(endpoint), server(-1), wakeUp{-1, -1} {}
+
+MetricsServer::~MetricsServer() {
+  if (thread.joinable()) {
+    char byte = 0;
+    while (::write(wakeUp[1], &byte, 1) == -1 && errno == EINTR) {
+    }
+    thread.join();
+  }
+  for (int descriptor : {server, wakeUp[0], wakeUp[1]}) {
+    if (descriptor != -1) {
+      close(descriptor);
+    }
+  }
+}
+
+bool MetricsServer::start() {
+  auto colon = endpoint.rfind(':');
+  if (colon == std::string::npos) {
+    Logger::error() << "The metrics endpoint '" << endpoint
+                    << "' is not host:port\n";
+    return false;
+  }
+  auto host = endpoint.substr(0, colon);
+  auto port = endpoint.substr(colon + 1);
+
+  struct addrinfo hints = {};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  hints.ai_flags = AI_PASSIVE;
+  struct addrinfo *addresses = nullptr;
+  int error = getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(),
+                          &hints, &addresses);
+  if (error != 0) {
+    Logger::error() << "Cannot resolve the metrics endpoint '" << endpoint
+                    << "': " << gai_strerror(error) << "\n";
+    return false;
+  }
+
+  for (auto address = addresses; address; address = address->ai_next) {
+    server =
+        socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+    if (server == -1) {
+      continue;
+    }
+    int enabled = 1;
+    setsockopt(server, SOL_SOCKET, SO_REUSEADDR, &enabled, sizeof(enabled));
+    if (bind(server, address->ai_addr, address->ai_addrlen) == 0 &&
+        listen(server, 16) == 0) {
+      break;
+    }
+    close(server);
+    server = -1;
+  }
+  freeaddrinfo(addresses);
+
+  if (server == -1 || pipe(wakeUp) == -1) {
+    Logger::error() << "Cannot serve the metrics at '" << endpoint
+                    << "': " << strerror(errno) << "\n";
+    return false;
+  }
+
+  thread = std::thread(&MetricsServer::serve, this);
+  Logger::info() << "Serving the metrics at http://" << endpoint
+                 << "/metrics\n";
+  return true;
+}
+
+/// One scrape at a time: a scraper waits for the previous one, never a
+/// worker
+void MetricsServer::serve() {
+  while (true) {
+    struct pollfd descriptors[2] = {{server, POLLIN, 0},
+                                    {wakeUp[0], POLLIN, 0}};
+    if (poll(descriptors, 2, -1) == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return;
+    }
+    if (descriptors[1].revents != 0) {
+      return;
+    }
+
+    int client = accept(server, nullptr, nullptr);
+    if (client == -1) {
+      continue;
+    }
+    respond(client);
+    close(client);
+  }
+}
+
+void MetricsServer::respond(int client) {
+  struct timeval timeout = {RequestTimeoutSeconds, 0};
+  setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+#ifdef SO_NOSIGPIPE
+  int enabled = 1;
+  setsockopt(client, SOL_SOCKET, SO_NOSIGPIPE, &enabled, sizeof(enabled));
+#endif
+
+  /// Only the request line matters, the headers are read and ignored
+  std::string request;
+  while (request.find("\r\n\r\n") == std::string::npos &&
+         request.size() < 8 * 1024) {
+    char buffer[1024];
+    ssize_t bytes = recv(client, buffer, sizeof(buffer), 0);
+    if (bytes == -1 && errno == EINTR) {
+      continue;
+    }
+    if (bytes <= 0) {
+      break;
+    }
+    request.append(buffer, bytes);
+  }
+
+  llvm::StringRef line(request);
+  line = line.substr(0, line.find("\r\n"));
+  auto target = line.split(' ').second.split(' ').first;
+  const bool found = line.startswith("GET ") &&
+                     (target == "/metrics" || target.startswith("/metrics?"));
+
+  std::string body;
+  if (found) {
+    llvm::raw_string_ostream stream(body);
+    LiveMetrics::shared().write(stream);
+    stream.flush();
+  } else {
+    body = "Not found, the metrics are at /metrics\n";
+  }
+
+  std::string header;
+  header += found ? "HTTP/1.1 200 OK\r\n" : "HTTP/1.1 404 Not Found\r\n";
+  header += found ? "Content-Type: application/openmetrics-text; "
+                    "version=1.0.0; charset=utf-8\r\n"
+                  : "Content-Type: text/plain\r\n";
+  header += "Content-Length: " + std::to_string(body.size()) + "\r\n";
+  header += "Connection: close\r\n\r\n";
+  if (sendAll(client, header)) {
+    sendAll(client, body);
+  }
+}
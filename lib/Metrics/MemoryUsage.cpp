@@ -0,0 +1,105 @@
+#include "mull/Metrics/Metrics.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#ifdef __APPLE__
+#include <mach/mach.h>
+#include <malloc/malloc.h>
+#endif
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+using namespace mull;
+
+MemoryUsage::MemoryUsage()
+    : resident(0), peakResident(0), heapLive(0), heapFree(0) {}
+
+static uint64_t residentBytes() {
+#ifdef __APPLE__
+  mach_task_basic_info_data_t info;
+  mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+  if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO,
+                reinterpret_cast<task_info_t>(&info), &count) != KERN_SUCCESS) {
+    return 0;
+  }
+  return info.resident_size;
+#else
+  /// The second field is the resident set in pages
+  FILE *statm = fopen("/proc/self/statm", "r");
+  if (!statm) {
+    return 0;
+  }
+  unsigned long long size = 0;
+  unsigned long long resident = 0;
+  int fields = fscanf(statm, "%llu %llu", &size, &resident);
+  fclose(statm);
+  if (fields != 2) {
+    return 0;
+  }
+  return resident * uint64_t(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+/// ru_maxrss is in bytes on macOS, in kilobytes elsewhere
+static uint64_t peakResidentBytes() {
+  struct rusage usage {};
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+#ifdef __APPLE__
+  return uint64_t(usage.ru_maxrss);
+#else
+  return uint64_t(usage.ru_maxrss) * 1024;
+#endif
+}
+
+/// mallinfo sums up all the arenas under their locks, which is fine once
+/// per phase. Its fields are ints before glibc 2.33 and wrap past 4GB.
+static void heapBytes(uint64_t &live, uint64_t &free) {
+#if defined(__APPLE__)
+  malloc_statistics_t statistics;
+  malloc_zone_statistics(nullptr, &statistics);
+  live = statistics.size_in_use;
+  free = statistics.size_allocated - statistics.size_in_use;
+#elif defined(__GLIBC__) && __GLIBC_PREREQ(2, 33)
+  struct mallinfo2 info = mallinfo2();
+  live = info.uordblks + info.hblkhd;
+  free = info.fordblks;
+#elif defined(__GLIBC__)
+  struct mallinfo info = mallinfo();
+  live = uint64_t(unsigned(info.uordblks)) + unsigned(info.hblkhd);
+  free = unsigned(info.fordblks);
+#else
+  live = 0;
+  free = 0;
+#endif
+}
+
+uint64_t MemoryUsage::currentResident() { return residentBytes(); }
+
+uint64_t MemoryUsage::currentHeapLive() {
+  uint64_t live = 0;
+  uint64_t free = 0;
+  heapBytes(live, free);
+  return live;
+}
+
+uint64_t MemoryUsage::heapFragmentation() const {
+  if (heapLive + heapFree == 0) {
+    return 0;
+  }
+  return heapFree * 100 / (heapLive + heapFree);
+}
+
+MemoryUsage MemoryUsage::current() {
+  MemoryUsage usage;
+  usage.resident = residentBytes();
+  heapBytes(usage.heapLive, usage.heapFree);
+  /// The kernel updates the peak lazily, it may lag behind the resident set
+  usage.peakResident = std::max(peakResidentBytes(), usage.resident);
+  return usage;
+}
@@ -1,5 +1,17 @@
 #include "mull/Metrics/Metrics.h"
 
+#include "mull/ExecutionResult.h"
+#include "mull/JSON.h"
+#include "mull/Metrics/LiveMetrics.h"
+#include "mull/Metrics/TimingHistory.h"
+#include "mull/MutationPoint.h"
+#include "mull/TestFrameworks/Test.h"
+
+#include <llvm/ADT/STLExtras.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <algorithm>
 #include <iostream>
 #include <numeric>
 
@@ -45,131 +57,392 @@ MetricsMeasure::Duration MetricsMeasure::duration() const {
 
 const char *MetricsMeasure::precision() { return "ms"; }
 
-void Metrics::beginLoadModules() { loadModules.begin = currentTimestamp(); }
-void Metrics::endLoadModules() { loadModules.end = currentTimestamp(); }
+WorkerMetrics::WorkerMetrics(MetricsMeasure::Duration busy,
+                             MetricsMeasure::Duration idle)
+    : busyTime(busy), idleTime(idle) {}
 
-void Metrics::beginCompileOriginalModule(const llvm::Module *module) {
-  MetricsMeasure &measure = originalModuleCompilation[module];
-  measure.begin = currentTimestamp();
+ObjectCacheMetrics::ObjectCacheMetrics()
+    : hits(0), misses(0), remoteHits(0), bytesRead(0), bytesWritten(0),
+      bytesSaved(0), bytesEvicted(0), prefetches(0) {}
+
+MemoryMetrics::MemoryMetrics()
+    : bitcodeBytes(0), objectFileBytes(0), jitSectionBytes(0),
+      outputBytes(0) {}
+
+JunkDetectionMetrics::JunkDetectionMetrics()
+    : filesIndexed(0), nodesVisited(0), declarationsSkipped(0),
+      cachedVerdicts(0), unitsEvicted(0), unitsReparsed(0),
+      debugInfoVerdicts(0) {}
+
+DeadMutantMetrics::DeadMutantMetrics() : deadValues(0), deadStores(0) {}
+
+static int64_t currentMicroseconds() {
+  using namespace std::chrono;
+  return duration_cast<microseconds>(system_clock::now().time_since_epoch())
+      .count();
 }
-void Metrics::endCompileOriginalModule(const llvm::Module *module) {
-  MetricsMeasure &measure = originalModuleCompilation[module];
-  measure.end = currentTimestamp();
+
+static std::string testName(const Test *test) {
+  return test ? test->getUniqueIdentifier() : std::string();
 }
 
-void Metrics::beginInstrumentedCompilation() {
-  instrumentedCompilation.begin = currentTimestamp();
+static std::string mutantName(const MutationPoint *mutant) {
+  return mutant ? mutant->getUniqueIdentifier() : std::string();
 }
 
-void Metrics::endInstrumentedCompilation() {
-  instrumentedCompilation.end = currentTimestamp();
+std::atomic<uint64_t> Metrics::nextId(1);
+
+Metrics::Metrics()
+    : id(nextId++), tracing(false), timedOutRuns(0), timedOutMilliseconds(0),
+      countedRuns(0), instructionOutliers(0) {}
+
+void Metrics::enableTracing() { tracing = true; }
+
+/// The lock is only taken the first time a thread records a sample,
+/// afterwards the thread finds its buffer on its own
+Metrics::ThreadSamples &Metrics::samplesOfThisThread() {
+  thread_local uint64_t metricsId = 0;
+  thread_local ThreadSamples *buffer = nullptr;
+  if (metricsId != id) {
+    std::lock_guard<std::mutex> lock(samplesMutex);
+    samples.push_back(llvm::make_unique<ThreadSamples>());
+    buffer = samples.back().get();
+    buffer->thread = std::this_thread::get_id();
+    metricsId = id;
+  }
+  return *buffer;
 }
 
-void Metrics::beginCompileInstrumentedModule(const llvm::Module *module) {
-  MetricsMeasure &measure = instrumentedModuleCompilation[module];
-  measure.begin = currentTimestamp();
+void Metrics::record(MetricsStep step, char phase, const char *name,
+                     const void *key, const Test *test, int64_t duration,
+                     int32_t detail) {
+  ThreadSamples &buffer = samplesOfThisThread();
+  if (buffer.chunks.empty() ||
+      buffer.chunks.back()->size == SampleChunk::Capacity) {
+    buffer.chunks.push_back(llvm::make_unique<SampleChunk>());
+  }
+  SampleChunk &chunk = *buffer.chunks.back();
+  chunk.samples[chunk.size++] = MetricsSample{
+      name, key, test, currentMicroseconds(), duration, detail, step, phase};
 }
-void Metrics::endCompileInstrumentedModule(const llvm::Module *module) {
-  MetricsMeasure &measure = instrumentedModuleCompilation[module];
-  measure.end = currentTimestamp();
+
+int32_t Metrics::addDetail(const std::string &detail) {
+  auto &details = samplesOfThisThread().details;
+  details.push_back(detail);
+  return int32_t(details.size() - 1);
 }
 
-void Metrics::beginLoadPrecompiledObjectFiles() {
-  loadPrecompiledObjectFiles.begin = currentTimestamp();
+void Metrics::recordPhase(char phase, const char *name) {
+  if (tracing.load(std::memory_order_relaxed)) {
+    record(MetricsStep::Phase, phase, name);
+  }
 }
-void Metrics::endLoadPrecompiledObjectFiles() {
-  loadPrecompiledObjectFiles.end = currentTimestamp();
+
+void Metrics::beginPhaseMemory(const char *name) {
+  PhaseMemoryUsage usage;
+  usage.phase = name;
+  usage.begin = MemoryUsage::current();
+  memoryUsage.push_back(usage);
 }
 
-void Metrics::beginFindTests() { findTests.begin = currentTimestamp(); }
-void Metrics::endFindTests() { findTests.end = currentTimestamp(); }
+/// The phases nest, e.g. the run holds all the others
+void Metrics::endPhaseMemory(const char *name) {
+  for (auto it = memoryUsage.rbegin(); it != memoryUsage.rend(); ++it) {
+    if (it->phase == name) {
+      it->end = MemoryUsage::current();
+      return;
+    }
+  }
+}
+
+/// Marks the beginning or the end of a phase of the run
+#define MULL_PHASE_HOOKS(hook, measure, name)                                  \
+  void Metrics::begin##hook() {                                                \
+    measure.start();                                                           \
+    beginPhaseMemory(name);                                                    \
+    LiveMetrics::shared().beginPhase(name);                                    \
+    recordPhase('B', name);                                                    \
+  }                                                                            \
+  void Metrics::end##hook() {                                                  \
+    measure.finish();                                                          \
+    endPhaseMemory(name);                                                      \
+    LiveMetrics::shared().endPhase(name);                                      \
+    recordPhase('E', name);                                                    \
+  }
 
-void Metrics::beginLoadDynamicLibraries() {
-  loadDynamicLibraries.begin = currentTimestamp();
+MULL_PHASE_HOOKS(LoadModules, loadModules, "Load modules")
+MULL_PHASE_HOOKS(InstrumentedCompilation, instrumentedCompilation,
+                 "Instrumented compilation")
+MULL_PHASE_HOOKS(LoadPrecompiledObjectFiles, loadPrecompiledObjectFiles,
+                 "Load object files")
+MULL_PHASE_HOOKS(FindTests, findTests, "Find tests")
+MULL_PHASE_HOOKS(LoadDynamicLibraries, loadDynamicLibraries,
+                 "Load dynamic libraries")
+MULL_PHASE_HOOKS(LoadOriginalProgram, loadOriginalProgram,
+                 "Load original program")
+MULL_PHASE_HOOKS(OriginalTestExecution, originalTestsExecution,
+                 "Run original tests")
+MULL_PHASE_HOOKS(MutantsExecution, mutantsExecution, "Run mutants")
+MULL_PHASE_HOOKS(Run, runTime, "Run")
+MULL_PHASE_HOOKS(ReportResult, reportResult, "Report results")
+
+#undef MULL_PHASE_HOOKS
+
+/// Marks the beginning or the end of a step done for a module, a test or
+/// a mutant
+#define MULL_STEP_HOOKS(hook, Key, step, name)                                 \
+  void Metrics::begin##hook(const Key *key) {                                  \
+    record(MetricsStep::step, 'B', name, key);                                 \
+  }                                                                            \
+  void Metrics::end##hook(const Key *key) {                                    \
+    record(MetricsStep::step, 'E', name, key);                                 \
+  }
+
+MULL_STEP_HOOKS(RunOriginalTest, Test, RunOriginalTest, "Run original test")
+MULL_STEP_HOOKS(FindMutationsForTest, Test, FindMutations, "Find mutations")
+MULL_STEP_HOOKS(CompileMutant, MutationPoint, CompileMutant, "Compile mutant")
+MULL_STEP_HOOKS(LoadMutatedProgram, MutationPoint, LoadMutatedProgram,
+                "Load mutated program")
+
+#undef MULL_STEP_HOOKS
+
+/// The name of the module is kept right away for the trace and the timings,
+/// the IR may be freed by the time they are written, see Program::releaseIR
+#define MULL_MODULE_HOOKS(hook, step, name)                                    \
+  void Metrics::begin##hook(const llvm::Module *module) {                      \
+    int32_t detail = -1;                                                       \
+    if (module) {                                                              \
+      detail = addDetail(module->getModuleIdentifier());                       \
+    }                                                                          \
+    record(MetricsStep::step, 'B', name, module, nullptr, 0, detail);          \
+  }                                                                            \
+  void Metrics::end##hook(const llvm::Module *module) {                        \
+    record(MetricsStep::step, 'E', name, module);                              \
+  }
+
+MULL_MODULE_HOOKS(CompileOriginalModule, CompileOriginalModule,
+                  "Compile module")
+MULL_MODULE_HOOKS(CompileInstrumentedModule, CompileInstrumentedModule,
+                  "Compile instrumented module")
+
+#undef MULL_MODULE_HOOKS
+
+void Metrics::beginRunMutant(const MutationPoint *mutant, const Test *test) {
+  record(MetricsStep::RunMutant, 'B', "Run mutant", mutant, test);
 }
-void Metrics::endLoadDynamicLibraries() {
-  loadDynamicLibraries.end = currentTimestamp();
+void Metrics::endRunMutant(const MutationPoint *mutant, const Test *test) {
+  record(MetricsStep::RunMutant, 'E', "Run mutant", mutant, test);
 }
 
-void Metrics::beginLoadOriginalProgram() {
-  loadOriginalProgram.begin = currentTimestamp();
+void Metrics::addRunMutant(const MutationPoint *mutant, const Test *test,
+                           MetricsMeasure::Duration duration) {
+  record(MetricsStep::RunMutant, 'X', "Run mutant", mutant, test, duration);
 }
-void Metrics::endLoadOriginalProgram() {
-  loadOriginalProgram.end = currentTimestamp();
+
+void Metrics::beginSpan(const char *name, const std::string &detail) {
+  if (!tracing.load(std::memory_order_relaxed)) {
+    return;
+  }
+  int32_t index = detail.empty() ? -1 : addDetail(detail);
+  record(MetricsStep::Span, 'B', name, nullptr, nullptr, 0, index);
+}
+void Metrics::endSpan(const char *name) {
+  if (tracing.load(std::memory_order_relaxed)) {
+    record(MetricsStep::Span, 'E', name);
+  }
 }
 
-void Metrics::beginOriginalTestExecution() {
-  originalTestsExecution.begin = currentTimestamp();
+std::vector<std::pair<const char *, const Histogram *>>
+LatencyHistograms::stages() const {
+  return {{"fork", &fork},
+          {"fork_to_start", &forkToStart},
+          {"test_run", &testRun},
+          {"reap", &reap},
+          {"output_read", &outputRead},
+          {"trampoline_swap", &trampolineSwap}};
 }
 
-void Metrics::endOriginalTestExecution() {
-  originalTestsExecution.end = currentTimestamp();
+void Metrics::addSandboxTimings(const SandboxTimings &timings) {
+  LiveMetrics::shared().addMutantRun(timings.fork);
+  if (timings.fork == 0 && timings.test == 0) {
+    return;
+  }
+  latencyHistograms.testRun.record(uint64_t(timings.test));
+  /// The tests of a batch after the first one were not forked for
+  if (timings.fork == 0) {
+    return;
+  }
+  latencyHistograms.fork.record(uint64_t(timings.fork));
+  latencyHistograms.forkToStart.record(uint64_t(timings.forkToStart));
+  latencyHistograms.reap.record(uint64_t(timings.reap));
+  latencyHistograms.outputRead.record(uint64_t(timings.outputRead));
 }
 
-void Metrics::beginMutantsExecution() {
-  mutantsExecution.begin = currentTimestamp();
+void Metrics::addTrampolineSwap(int64_t nanoseconds) {
+  latencyHistograms.trampolineSwap.record(uint64_t(nanoseconds));
 }
 
-void Metrics::endMutantsExecution() {
-  mutantsExecution.end = currentTimestamp();
+void Metrics::addTimedOutRun(long long milliseconds) {
+  timedOutRuns.fetch_add(1, std::memory_order_relaxed);
+  timedOutMilliseconds.fetch_add(uint64_t(milliseconds),
+                                 std::memory_order_relaxed);
 }
 
-void Metrics::beginRunOriginalTest(const Test *test) {
-  MetricsMeasure &measure = runOriginalTest[test];
-  measure.begin = currentTimestamp();
+UsageMetrics::UsageMetrics()
+    : runs(0), userTime(0), systemTime(0), maxResident(0), minorFaults(0),
+      majorFaults(0), voluntarySwitches(0), involuntarySwitches(0) {}
+
+void Metrics::addChildUsage(const ChildUsage &childUsage) {
+  if (childUsage.userTime == 0 && childUsage.systemTime == 0 &&
+      childUsage.maxResident == 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(usageMutex);
+  usage.runs++;
+  usage.userTime += childUsage.userTime;
+  usage.systemTime += childUsage.systemTime;
+  usage.maxResident =
+      std::max(usage.maxResident, uint64_t(childUsage.maxResident));
+  usage.minorFaults += childUsage.minorFaults;
+  usage.majorFaults += childUsage.majorFaults;
+  usage.voluntarySwitches += childUsage.voluntarySwitches;
+  usage.involuntarySwitches += childUsage.involuntarySwitches;
 }
-void Metrics::endRunOriginalTest(const Test *test) {
-  MetricsMeasure &measure = runOriginalTest[test];
-  measure.end = currentTimestamp();
+
+UsageMetrics Metrics::childUsage() const {
+  std::lock_guard<std::mutex> lock(usageMutex);
+  return usage;
 }
 
-void Metrics::beginFindMutationsForTest(const Test *test) {
-  MetricsMeasure &measure = findMutations[test];
-  measure.begin = currentTimestamp();
+void Metrics::addPerfCounts(const PerfCounts &mutant,
+                            const PerfCounts &original) {
+  if (mutant.instructions == 0 || original.instructions == 0) {
+    return;
+  }
+  countedRuns.fetch_add(1, std::memory_order_relaxed);
+  if (mutant.instructions / InstructionMetrics::OutlierFactor >=
+      original.instructions) {
+    instructionOutliers.fetch_add(1, std::memory_order_relaxed);
+  }
 }
-void Metrics::endFindMutationsForTest(const Test *test) {
-  MetricsMeasure &measure = findMutations[test];
-  measure.end = currentTimestamp();
+
+InstructionMetrics Metrics::instructions() const {
+  InstructionMetrics metrics;
+  metrics.countedRuns = countedRuns.load(std::memory_order_relaxed);
+  metrics.outliers = instructionOutliers.load(std::memory_order_relaxed);
+  return metrics;
 }
 
-void Metrics::beginCompileMutant(const MutationPoint *mutant) {
-  MetricsMeasure &measure = compileMutant[mutant];
-  measure.begin = currentTimestamp();
+TimeoutMetrics Metrics::timeouts() const {
+  TimeoutMetrics metrics;
+  metrics.runs = timedOutRuns.load(std::memory_order_relaxed);
+  metrics.milliseconds = timedOutMilliseconds.load(std::memory_order_relaxed);
+  return metrics;
 }
-void Metrics::endCompileMutant(const MutationPoint *mutant) {
-  MetricsMeasure &measure = compileMutant[mutant];
-  measure.end = currentTimestamp();
+
+static MetricsMeasure::Precision fromMicroseconds(int64_t timestamp) {
+  using namespace std::chrono;
+  return duration_cast<MetricsMeasure::Precision>(microseconds(timestamp));
 }
 
-void Metrics::beginLoadMutatedProgram(const MutationPoint *mutant) {
-  MetricsMeasure &measure = loadMutant[mutant];
-  measure.begin = currentTimestamp();
+static void mergeSample(MetricsMeasure &measure, const MetricsSample &sample) {
+  auto timestamp = fromMicroseconds(sample.timestamp);
+  if (sample.phase == 'B') {
+    measure.begin = timestamp;
+  } else {
+    measure.end = timestamp;
+  }
+  if (sample.phase == 'X') {
+    measure.begin = timestamp - MetricsMeasure::Precision(sample.duration);
+  }
 }
-void Metrics::endLoadMutatedProgram(const MutationPoint *mutant) {
-  MetricsMeasure &measure = loadMutant[mutant];
-  measure.end = currentTimestamp();
+
+Metrics::StepMeasures Metrics::mergeSamples() const {
+  StepMeasures measures;
+  std::lock_guard<std::mutex> lock(samplesMutex);
+  for (auto &buffer : samples) {
+    for (auto &chunk : buffer->chunks) {
+      for (size_t index = 0; index < chunk->size; index++) {
+        auto &sample = chunk->samples[index];
+        auto mutant = static_cast<const MutationPoint *>(sample.key);
+        auto module = static_cast<const llvm::Module *>(sample.key);
+        auto test = static_cast<const Test *>(sample.key);
+        switch (sample.step) {
+        case MetricsStep::CompileOriginalModule:
+          mergeSample(measures.originalModuleCompilation[module], sample);
+          break;
+        case MetricsStep::CompileInstrumentedModule:
+          mergeSample(measures.instrumentedModuleCompilation[module], sample);
+          break;
+        case MetricsStep::RunOriginalTest:
+          mergeSample(measures.runOriginalTest[test], sample);
+          break;
+        case MetricsStep::FindMutations:
+          mergeSample(measures.findMutations[test], sample);
+          break;
+        case MetricsStep::CompileMutant:
+          mergeSample(measures.compileMutant[mutant], sample);
+          break;
+        case MetricsStep::LoadMutatedProgram:
+          mergeSample(measures.loadMutant[mutant], sample);
+          break;
+        case MetricsStep::RunMutant:
+          mergeSample(measures.mutantRuns[mutant][sample.test], sample);
+          break;
+        case MetricsStep::Phase:
+        case MetricsStep::Span:
+          break;
+        }
+      }
+    }
+  }
+  return measures;
 }
 
-void Metrics::beginRunMutant(const MutationPoint *mutant, const Test *test) {
-  std::map<const Test *, MetricsMeasure> &testRun = mutantRuns[mutant];
-  MetricsMeasure &measure = testRun[test];
-  measure.begin = currentTimestamp();
+void Metrics::addWorkersMetrics(const std::string &phase,
+                                const std::vector<WorkerMetrics> &workers) {
+  if (workers.empty()) {
+    return;
+  }
+  workersMetrics.emplace_back(phase, workers);
 }
-void Metrics::endRunMutant(const MutationPoint *mutant, const Test *test) {
-  std::map<const Test *, MetricsMeasure> &testRun = mutantRuns[mutant];
-  MetricsMeasure &measure = testRun[test];
-  measure.end = currentTimestamp();
+
+void Metrics::addMemoryUsage(const PhaseMemoryUsage &usage) {
+  /// The executors that did not run have nothing to report
+  if (usage.end.peakResident == 0) {
+    return;
+  }
+  memoryUsage.push_back(usage);
+}
+
+void Metrics::setMemoryMetrics(const MemoryMetrics &metrics) {
+  memory = metrics;
 }
 
-void Metrics::beginRun() { runTime.begin = currentTimestamp(); }
-void Metrics::endRun() { runTime.end = currentTimestamp(); }
+void Metrics::setObjectCacheMetrics(const ObjectCacheMetrics &metrics) {
+  objectCache = metrics;
+}
 
-void Metrics::beginReportResult() { reportResult.begin = currentTimestamp(); }
-void Metrics::endReportResult() { reportResult.end = currentTimestamp(); }
+void Metrics::setJunkDetectionMetrics(const JunkDetectionMetrics &metrics) {
+  junkDetection = metrics;
+}
+
+void Metrics::setDeadMutantMetrics(const DeadMutantMetrics &metrics) {
+  deadMutants = metrics;
+}
 
 void Metrics::dump() const {
   using namespace std;
 
+  auto measures = mergeSamples();
+  auto &originalModuleCompilation = measures.originalModuleCompilation;
+  auto &instrumentedModuleCompilation = measures.instrumentedModuleCompilation;
+  auto &runOriginalTest = measures.runOriginalTest;
+  auto &findMutations = measures.findMutations;
+  auto &compileMutant = measures.compileMutant;
+  auto &loadMutant = measures.loadMutant;
+  auto &mutantRuns = measures.mutantRuns;
+
   MetricsMeasure::Duration totalMutantRunTime(0);
   for (auto &pair : mutantRuns) {
     totalMutantRunTime += accumulate_duration(pair.second);
@@ -243,5 +516,296 @@ void Metrics::dump() const {
   cout << "Mutants run time (avg): ........... "
        << totalMutantRunTime / (mutantRuns.size() ? mutantRuns.size() : 1)
        << MetricsMeasure::precision() << endl;
+  if (timedOutRuns != 0) {
+    cout << "Mutant runs timed out: ............ " << timedOutRuns << " ("
+         << timedOutMilliseconds << "ms in total)" << endl;
+  }
+  if (usage.runs != 0) {
+    cout << "Mutant runs CPU time: ............. " << usage.userTime / 1000
+         << "ms user, " << usage.systemTime / 1000 << "ms system" << endl;
+    cout << "Mutant runs peak RSS: ............. " << usage.maxResident / 1024
+         << "MB" << endl;
+    cout << "Mutant runs page faults: .......... " << usage.minorFaults
+         << " minor, " << usage.majorFaults << " major" << endl;
+    cout << "Mutant runs context switches: ..... " << usage.voluntarySwitches
+         << " voluntary, " << usage.involuntarySwitches << " involuntary"
+         << endl;
+  }
+  if (countedRuns != 0) {
+    cout << "Mutant runs with " << InstructionMetrics::OutlierFactor
+         << "x the instructions: " << instructionOutliers << " of "
+         << countedRuns << " counted" << endl;
+  }
+  cout << endl;
+
+  if (objectCache.hits + objectCache.misses != 0) {
+    auto lookups = objectCache.hits + objectCache.misses;
+    cout << "Object cache: ..................... " << objectCache.hits
+         << " hits (" << objectCache.remoteHits << " remote), "
+         << objectCache.misses << " misses, "
+         << objectCache.hits * 100 / lookups << "% hit rate, "
+         << objectCache.prefetches << " read ahead" << endl;
+    cout << "Object cache (bytes): ............. read "
+         << objectCache.bytesRead << ", written " << objectCache.bytesWritten
+         << ", saved by compression " << objectCache.bytesSaved
+         << ", evicted " << objectCache.bytesEvicted << endl;
+    cout << endl;
+  }
+
+  if (junkDetection.filesIndexed != 0 || junkDetection.cachedVerdicts != 0 ||
+      junkDetection.debugInfoVerdicts != 0) {
+    cout << "Junk detection (AST): ............. "
+         << junkDetection.filesIndexed << " files indexed, "
+         << junkDetection.nodesVisited << " nodes visited, "
+         << junkDetection.declarationsSkipped
+         << " declarations skipped in other files" << endl;
+    cout << "Junk detection (cache): ........... "
+         << junkDetection.cachedVerdicts << " verdicts reused, "
+         << junkDetection.debugInfoVerdicts << " told by the debug info"
+         << endl;
+    if (junkDetection.unitsEvicted != 0) {
+      cout << "Junk detection (memory): .......... "
+           << junkDetection.unitsEvicted << " ASTs evicted, "
+           << junkDetection.unitsReparsed << " parsed again" << endl;
+    }
+    cout << endl;
+  }
+
+  if (deadMutants.deadValues + deadMutants.deadStores != 0) {
+    cout << "Dead mutants (skipped): ........... "
+         << deadMutants.deadValues << " of unused values, "
+         << deadMutants.deadStores << " of dead stores" << endl;
+    cout << endl;
+  }
+
+  if (!memoryUsage.empty()) {
+    const uint64_t megabyte = 1024 * 1024;
+    uint64_t peak = 0;
+    cout << "Memory (RSS at the beginning -> end, peak so far; heap in use "
+            "and free at the end):"
+         << endl;
+    cout << endl;
+    for (auto &usage : memoryUsage) {
+      peak = std::max(peak, usage.end.peakResident);
+      cout << usage.phase << ": " << usage.begin.resident / megabyte
+           << "MB -> " << usage.end.resident / megabyte << "MB, peak "
+           << usage.end.peakResident / megabyte << "MB";
+      if (usage.end.heapLive != 0) {
+        cout << "; heap " << usage.end.heapLive / megabyte << "MB, free "
+             << usage.end.heapFree / megabyte << "MB ("
+             << usage.end.heapFragmentation() << "%)";
+      }
+      cout << endl;
+    }
+    cout << endl;
+    cout << "Peak RSS: ......................... " << peak / megabyte << "MB"
+         << endl;
+    cout << "Bitcode: .......................... "
+         << memory.bitcodeBytes / megabyte << "MB" << endl;
+    cout << "Object files: ..................... "
+         << memory.objectFileBytes / megabyte << "MB" << endl;
+    cout << "JIT sections: ..................... "
+         << memory.jitSectionBytes / megabyte << "MB" << endl;
+    cout << "Outputs of the runs: .............. "
+         << memory.outputBytes / megabyte << "MB" << endl;
+    cout << endl;
+  }
+
+  if (latencyHistograms.trampolineSwap.count() != 0) {
+    cout << "Latencies (p50 / p90 / p99 / max):" << endl;
+    cout << endl;
+    for (auto &stage : latencyHistograms.stages()) {
+      auto &histogram = *stage.second;
+      if (histogram.count() == 0) {
+        continue;
+      }
+      cout << stage.first << ": " << histogram.percentile(50) / 1000 << "us / "
+           << histogram.percentile(90) / 1000 << "us / "
+           << histogram.percentile(99) / 1000 << "us / "
+           << histogram.max() / 1000 << "us (" << histogram.count()
+           << " samples)" << endl;
+    }
+    cout << endl;
+  }
+
+  if (workersMetrics.empty()) {
+    return;
+  }
+
+  cout << "Workers utilization:" << endl;
   cout << endl;
+  for (auto &phase : workersMetrics) {
+    MetricsMeasure::Duration busy(0);
+    MetricsMeasure::Duration idle(0);
+    MetricsMeasure::Duration maxIdle(0);
+    for (auto &worker : phase.second) {
+      busy += worker.busyTime;
+      idle += worker.idleTime;
+      maxIdle = std::max(maxIdle, worker.idleTime);
+    }
+    cout << phase.first << " (" << phase.second.size() << " workers): "
+         << "busy " << busy << MetricsMeasure::precision() << ", idle "
+         << idle << MetricsMeasure::precision() << " (max idle " << maxIdle
+         << MetricsMeasure::precision() << ")" << endl;
+  }
+  cout << endl;
+}
+
+std::vector<Timing> Metrics::timings() const {
+  auto measures = mergeSamples();
+
+  std::map<const void *, std::string> moduleNames;
+  {
+    std::lock_guard<std::mutex> lock(samplesMutex);
+    for (auto &buffer : samples) {
+      for (auto &chunk : buffer->chunks) {
+        for (size_t index = 0; index < chunk->size; index++) {
+          auto &sample = chunk->samples[index];
+          if (sample.phase == 'B' && sample.detail >= 0 &&
+              (sample.step == MetricsStep::CompileOriginalModule ||
+               sample.step == MetricsStep::CompileInstrumentedModule)) {
+            moduleNames[sample.key] = buffer->details[sample.detail];
+          }
+        }
+      }
+    }
+  }
+
+  std::vector<Timing> timings;
+  auto addPhase = [&](const char *name, const MetricsMeasure &measure) {
+    if (measure.end.count() != 0) {
+      timings.emplace_back(name, double(measure.duration()));
+    }
+  };
+  addPhase("run", runTime);
+  addPhase("load_modules", loadModules);
+  addPhase("load_object_files", loadPrecompiledObjectFiles);
+  addPhase("load_dylibs", loadDynamicLibraries);
+  addPhase("load_original_program", loadOriginalProgram);
+  addPhase("find_tests", findTests);
+  addPhase("instrumented_compilation", instrumentedCompilation);
+  addPhase("original_tests", originalTestsExecution);
+  addPhase("mutants", mutantsExecution);
+
+  auto addTotal = [&](const char *name, MetricsMeasure::Duration total,
+                      bool measured) {
+    if (measured) {
+      timings.emplace_back(name, double(total));
+    }
+  };
+  addTotal("find_mutations", accumulate_duration(measures.findMutations),
+           !measures.findMutations.empty());
+  addTotal("original_compilation",
+           accumulate_duration(measures.originalModuleCompilation),
+           !measures.originalModuleCompilation.empty());
+  addTotal("mutant_compilation", accumulate_duration(measures.compileMutant),
+           !measures.compileMutant.empty());
+  addTotal("load_mutants", accumulate_duration(measures.loadMutant),
+           !measures.loadMutant.empty());
+
+  auto addModules = [&](const char *prefix,
+                        const std::map<const llvm::Module *, MetricsMeasure>
+                            &modules) {
+    for (auto &pair : modules) {
+      auto name = moduleNames.find(pair.first);
+      if (name != moduleNames.end()) {
+        timings.emplace_back(std::string(prefix) + "/" + name->second,
+                             double(pair.second.duration()));
+      }
+    }
+  };
+  addModules("original_compilation", measures.originalModuleCompilation);
+  addModules("instrumented_compilation",
+             measures.instrumentedModuleCompilation);
+  return timings;
+}
+
+static std::string sampleDetail(const MetricsSample &sample) {
+  switch (sample.step) {
+  case MetricsStep::RunOriginalTest:
+  case MetricsStep::FindMutations:
+    return testName(static_cast<const Test *>(sample.key));
+  case MetricsStep::CompileMutant:
+  case MetricsStep::LoadMutatedProgram:
+    return mutantName(static_cast<const MutationPoint *>(sample.key));
+  case MetricsStep::RunMutant:
+    return mutantName(static_cast<const MutationPoint *>(sample.key)) + " " +
+           testName(sample.test);
+  case MetricsStep::CompileOriginalModule:
+  case MetricsStep::CompileInstrumentedModule:
+  case MetricsStep::Phase:
+  case MetricsStep::Span:
+    break;
+  }
+  return std::string();
+}
+
+void Metrics::writeTrace(llvm::raw_ostream &stream) const {
+  std::lock_guard<std::mutex> lock(samplesMutex);
+
+  stream << "{\"traceEvents\":[\n";
+  if (!tracing) {
+    stream << "\n]}\n";
+    return;
+  }
+
+  bool first = true;
+  auto separate = [&]() {
+    stream << (first ? "" : ",\n");
+    first = false;
+  };
+
+  /// The main thread is the first one to record a sample
+  std::map<std::thread::id, size_t> threads;
+  for (auto &buffer : samples) {
+    if (threads.count(buffer->thread)) {
+      continue;
+    }
+    size_t thread = threads.size();
+    threads[buffer->thread] = thread;
+    separate();
+    std::string name =
+        thread == 0 ? std::string("main") : "thread " + std::to_string(thread);
+    stream << "{\"ph\":\"M\",\"pid\":1,\"tid\":" << thread
+           << ",\"name\":\"thread_name\",\"args\":{\"name\":\"" << name
+           << "\"}}";
+  }
+
+  std::map<size_t, int> openSpans;
+  for (auto &buffer : samples) {
+    size_t thread = threads[buffer->thread];
+    for (auto &chunk : buffer->chunks) {
+      for (size_t index = 0; index < chunk->size; index++) {
+        auto &sample = chunk->samples[index];
+        if (sample.phase == 'X') {
+          continue;
+        }
+        separate();
+        stream << "{\"ph\":\"" << sample.phase << "\",\"pid\":1,\"tid\":"
+               << thread << ",\"ts\":" << sample.timestamp
+               << ",\"cat\":\"mull\",\"name\":\"" << sample.name << "\"";
+        if (sample.phase == 'B') {
+          auto detail = sample.detail >= 0 ? buffer->details[sample.detail]
+                                           : sampleDetail(sample);
+          if (!detail.empty()) {
+            stream << ",\"args\":{\"detail\":\"" << escapeJSON(detail)
+                   << "\"}";
+          }
+        }
+        stream << "}";
+        openSpans[thread] += sample.phase == 'B' ? 1 : -1;
+      }
+    }
+  }
+
+  /// The trace may be written by a reporter, from within a span
+  auto now = currentMicroseconds();
+  for (auto &thread : openSpans) {
+    for (int span = 0; span < thread.second; span++) {
+      separate();
+      stream << "{\"ph\":\"E\",\"pid\":1,\"tid\":" << thread.first
+             << ",\"ts\":" << now << "}";
+    }
+  }
+  stream << "\n]}\n";
 }
@@ -0,0 +1,171 @@
+#include "mull/Metrics/TimingHistory.h"
+
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Path.h>
+
+#include <algorithm>
+#include <ctime>
+#include <map>
+#include <sqlite3.h>
+
+using namespace mull;
+
+/// The runs of a workload beyond these are dropped as the new ones come
+static const int KeptRuns = 100;
+/// Several mull processes may share the history
+static const int BusyTimeoutMilliseconds = 5000;
+
+static const char *CreateTables =
+    "CREATE TABLE IF NOT EXISTS run ("
+    "id INTEGER PRIMARY KEY AUTOINCREMENT, workload TEXT, time INTEGER);"
+    "CREATE TABLE IF NOT EXISTS timing ("
+    "run_id INTEGER, name TEXT, milliseconds REAL);"
+    "CREATE INDEX IF NOT EXISTS timing_run_id ON timing(run_id);";
+
+static const char *SelectTimings =
+    "SELECT name, milliseconds FROM timing WHERE run_id IN "
+    "(SELECT id FROM run WHERE workload = ?1 ORDER BY id DESC LIMIT ?2)";
+
+static const char *DeleteOldTimings =
+    "DELETE FROM timing WHERE run_id IN "
+    "(SELECT id FROM run WHERE workload = ?1 ORDER BY id DESC "
+    "LIMIT -1 OFFSET ?2)";
+static const char *DeleteOldRuns =
+    "DELETE FROM run WHERE id IN "
+    "(SELECT id FROM run WHERE workload = ?1 ORDER BY id DESC "
+    "LIMIT -1 OFFSET ?2)";
+
+static double median(std::vector<double> &values) {
+  auto middle = values.begin() + values.size() / 2;
+  std::nth_element(values.begin(), middle, values.end());
+  if (values.size() % 2 != 0) {
+    return *middle;
+  }
+  auto below = std::max_element(values.begin(), middle);
+  return (*below + *middle) / 2;
+}
+
+TimingHistory::TimingHistory(const std::string &path)
+    : path(path), database(nullptr) {}
+
+TimingHistory::~TimingHistory() { sqlite3_close(database); }
+
+bool TimingHistory::open(std::string &error) {
+  auto directory = llvm::sys::path::parent_path(path);
+  if (!directory.empty()) {
+    llvm::sys::fs::create_directories(directory);
+  }
+  char *message = nullptr;
+  if (sqlite3_open(path.c_str(), &database) != SQLITE_OK ||
+      sqlite3_busy_timeout(database, BusyTimeoutMilliseconds) != SQLITE_OK ||
+      sqlite3_exec(database, CreateTables, nullptr, nullptr, &message) !=
+          SQLITE_OK) {
+    error = message ? message : sqlite3_errmsg(database);
+    sqlite3_free(message);
+    sqlite3_close(database);
+    database = nullptr;
+    return false;
+  }
+  return true;
+}
+
+std::vector<TimingHistory::Regression>
+TimingHistory::compare(const std::string &workload,
+                       const std::vector<Timing> &timings, unsigned runs,
+                       double factor, double noise) const {
+  std::vector<Regression> regressions;
+  sqlite3_stmt *select = nullptr;
+  if (!database || sqlite3_prepare_v2(database, SelectTimings, -1, &select,
+                                      nullptr) != SQLITE_OK) {
+    return regressions;
+  }
+  sqlite3_bind_text(select, 1, workload.c_str(), -1, SQLITE_TRANSIENT);
+  sqlite3_bind_int(select, 2, int(runs));
+
+  std::map<std::string, std::vector<double>> previous;
+  while (sqlite3_step(select) == SQLITE_ROW) {
+    auto name = sqlite3_column_text(select, 0);
+    if (name) {
+      previous[reinterpret_cast<const char *>(name)].push_back(
+          sqlite3_column_double(select, 1));
+    }
+  }
+  sqlite3_finalize(select);
+
+  for (auto &timing : timings) {
+    auto values = previous.find(timing.name);
+    if (values == previous.end()) {
+      continue;
+    }
+    Regression regression;
+    regression.name = timing.name;
+    regression.milliseconds = timing.milliseconds;
+    regression.runs = unsigned(values->second.size());
+    regression.baseline = median(values->second);
+    if (timing.milliseconds >= regression.baseline * factor &&
+        timing.milliseconds - regression.baseline >= noise) {
+      regressions.push_back(regression);
+    }
+  }
+  return regressions;
+}
+
+bool TimingHistory::record(const std::string &workload,
+                           const std::vector<Timing> &timings) {
+  if (!database) {
+    return false;
+  }
+
+  sqlite3_stmt *insertRun = nullptr;
+  sqlite3_stmt *insertTiming = nullptr;
+  sqlite3_stmt *deleteTimings = nullptr;
+  sqlite3_stmt *deleteRuns = nullptr;
+  bool recorded =
+      sqlite3_exec(database, "BEGIN IMMEDIATE TRANSACTION", nullptr, nullptr,
+                   nullptr) == SQLITE_OK;
+  if (!recorded) {
+    return false;
+  }
+
+  recorded =
+      sqlite3_prepare_v2(database, "INSERT INTO run VALUES (NULL, ?1, ?2)",
+                         -1, &insertRun, nullptr) == SQLITE_OK &&
+      sqlite3_prepare_v2(database, "INSERT INTO timing VALUES (?1, ?2, ?3)",
+                         -1, &insertTiming, nullptr) == SQLITE_OK &&
+      sqlite3_prepare_v2(database, DeleteOldTimings, -1, &deleteTimings,
+                         nullptr) == SQLITE_OK &&
+      sqlite3_prepare_v2(database, DeleteOldRuns, -1, &deleteRuns,
+                         nullptr) == SQLITE_OK;
+
+  if (recorded) {
+    sqlite3_bind_text(insertRun, 1, workload.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int64(insertRun, 2, int64_t(time(nullptr)));
+    recorded = sqlite3_step(insertRun) == SQLITE_DONE;
+  }
+  auto run = sqlite3_last_insert_rowid(database);
+  for (auto &timing : timings) {
+    if (!recorded) {
+      break;
+    }
+    sqlite3_bind_int64(insertTiming, 1, run);
+    sqlite3_bind_text(insertTiming, 2, timing.name.c_str(), -1,
+                      SQLITE_TRANSIENT);
+    sqlite3_bind_double(insertTiming, 3, timing.milliseconds);
+    recorded = sqlite3_step(insertTiming) == SQLITE_DONE;
+    sqlite3_reset(insertTiming);
+  }
+  for (auto stmt : {deleteTimings, deleteRuns}) {
+    if (recorded) {
+      sqlite3_bind_text(stmt, 1, workload.c_str(), -1, SQLITE_TRANSIENT);
+      sqlite3_bind_int(stmt, 2, KeptRuns);
+      recorded = sqlite3_step(stmt) == SQLITE_DONE;
+    }
+  }
+
+  for (auto stmt : {insertRun, insertTiming, deleteTimings, deleteRuns}) {
+    sqlite3_finalize(stmt);
+  }
+  sqlite3_exec(database, recorded ? "COMMIT" : "ROLLBACK", nullptr, nullptr,
+               nullptr);
+  return recorded;
+}
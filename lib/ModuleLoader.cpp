@@ -2,42 +2,108 @@
 
 #include "LLVMCompatibility.h"
 #include "mull/Config/Configuration.h"
+#include "mull/Hash.h"
 #include "mull/Logger.h"
 #include "mull/Parallelization/Parallelization.h"
 
 #include <llvm/AsmParser/Parser.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Instructions.h>
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Module.h>
-#include <llvm/Support/MD5.h>
+#include <llvm/Support/FileSystem.h>
 #include <llvm/Support/MemoryBuffer.h>
 #include <llvm/Support/SourceMgr.h>
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <set>
+#include <unordered_map>
 
 using namespace llvm;
 using namespace mull;
 
-static std::string MD5HashFromBuffer(StringRef buffer) {
-  MD5 hasher;
-  hasher.update(buffer);
-  MD5::MD5Result hash;
-  hasher.final(hash);
-  SmallString<32> result;
-  MD5::stringifyResult(hash, result);
-  return result.str();
+/// Below this size handing the hashing to another thread costs more than
+/// the hashing itself
+static const size_t OverlappedHashingThreshold = 1 << 20;
+
+/// The finders look for the registration of the tests in the bodies of the
+/// global constructors and the local functions they call
+static void materializeInitializers(Module &module) {
+  auto constructors = module.getNamedGlobal("llvm.global_ctors");
+  if (!constructors || !constructors->hasInitializer()) {
+    return;
+  }
+
+  std::vector<Function *> worklist;
+  std::set<Function *> visited;
+  auto entries = dyn_cast<ConstantArray>(constructors->getInitializer());
+  for (unsigned i = 0; entries && i < entries->getNumOperands(); i++) {
+    auto entry = dyn_cast<ConstantStruct>(entries->getOperand(i));
+    if (!entry || entry->getNumOperands() < 2) {
+      continue;
+    }
+    auto constructor =
+        dyn_cast<Function>(entry->getOperand(1)->stripPointerCasts());
+    if (constructor && visited.insert(constructor).second) {
+      worklist.push_back(constructor);
+    }
+  }
+
+  while (!worklist.empty()) {
+    auto function = worklist.back();
+    worklist.pop_back();
+    if (!function->isMaterializable() ||
+        !llvm_compat::materialize(*function)) {
+      continue;
+    }
+    for (auto &block : *function) {
+      for (auto &instruction : block) {
+        auto call = dyn_cast<CallInst>(&instruction);
+        auto callee = call ? call->getCalledFunction() : nullptr;
+        if (callee && callee->hasLocalLinkage() &&
+            visited.insert(callee).second) {
+          worklist.push_back(callee);
+        }
+      }
+    }
+  }
 }
 
 std::pair<std::string, std::unique_ptr<Module>>
-mull::loadModuleFromBuffer(LLVMContext &context, MemoryBuffer &buffer) {
-  auto module = llvm_compat::parseBitcode(buffer.getMemBufferRef(), context);
-  std::string md5 = MD5HashFromBuffer(buffer.getBuffer());
-  return std::make_pair(md5, std::move(module));
+mull::loadModuleFromBuffer(LLVMContext &context, MemoryBuffer &buffer,
+                           bool lazy, HashAlgorithm hashAlgorithm,
+                           const std::string &knownHash) {
+  /// The buffer is hashed while it is being parsed
+  std::string hash = knownHash;
+  WorkerGroup hashing(ThreadPool::shared());
+  auto hashBuffer = [&]() { hash = hashOf(buffer.getBuffer(), hashAlgorithm); };
+  if (knownHash.empty()) {
+    if (buffer.getBufferSize() >= OverlappedHashingThreshold) {
+      hashing.run(hashBuffer);
+    } else {
+      hashBuffer();
+    }
+  }
+
+  std::unique_ptr<Module> module;
+  if (lazy) {
+    module = llvm_compat::parseLazyBitcode(buffer.getMemBufferRef(), context);
+    if (module) {
+      materializeInitializers(*module);
+    }
+  } else {
+    module = llvm_compat::parseBitcode(buffer.getMemBufferRef(), context);
+  }
+  hashing.wait();
+  return std::make_pair(hash, std::move(module));
 }
 
 std::unique_ptr<MullModule>
 ModuleLoader::loadModuleAtPath(const std::string &path,
-                               llvm::LLVMContext &context) {
+                               llvm::LLVMContext &context, bool lazy,
+                               HashAlgorithm hashAlgorithm) {
   auto buffer = MemoryBuffer::getFile(path);
   if (!buffer) {
     Logger::error() << "Cannot load module " << path << '\n';
@@ -45,7 +111,7 @@ ModuleLoader::loadModuleAtPath(const std::string &path,
   }
 
   MemoryBuffer *b = buffer.get().get();
-  auto modulePair = loadModuleFromBuffer(context, *b);
+  auto modulePair = loadModuleFromBuffer(context, *b, lazy, hashAlgorithm);
 
   std::string hash = modulePair.first;
   std::unique_ptr<llvm::Module> module(std::move(modulePair.second));
@@ -56,7 +122,7 @@ ModuleLoader::loadModuleAtPath(const std::string &path,
   }
 
   return make_unique<MullModule>(std::move(module), std::move(buffer.get()),
-                                 hash);
+                                 hash, hashAlgorithm);
 }
 
 std::vector<std::unique_ptr<MullModule>>
@@ -66,13 +132,40 @@ ModuleLoader::loadModules(const Configuration &config) {
   std::vector<ModuleLoadingTask> tasks;
   for (int i = 0; i < config.parallelization.workers; i++) {
     auto context = llvm::make_unique<LLVMContext>();
-    tasks.emplace_back(*context, *this);
+    tasks.emplace_back(*context, *this, config.lazyBitcodeLoadingEnabled,
+                       config.hashAlgorithm);
     contexts.push_back(std::move(context));
   }
 
-  TaskExecutor<ModuleLoadingTask> loader("Loading bitcode", config.bitcodePaths,
-                                         modules, tasks);
+  /// Each worker loads into its own context, handing the largest files out
+  /// first keeps a worker that got a few huge modules from finishing last
+  std::vector<uint64_t> sizes;
+  for (auto &path : config.bitcodePaths) {
+    uint64_t size = 0;
+    llvm::sys::fs::file_size(path, size);
+    sizes.push_back(size);
+  }
+  std::vector<std::string> paths;
+  for (auto index : largestFirst(sizes)) {
+    paths.push_back(config.bitcodePaths[index]);
+  }
+
+  TaskExecutor<ModuleLoadingTask> loader("Loading bitcode", paths, modules,
+                                         tasks, TaskDispatch::OneByOne);
   loader.execute();
 
+  /// The modules that failed to load are skipped, so the order of the
+  /// configuration is restored by the paths the modules were loaded from
+  std::unordered_map<std::string, size_t> positions;
+  for (size_t i = 0; i < config.bitcodePaths.size(); i++) {
+    positions.emplace(config.bitcodePaths[i], i);
+  }
+  std::stable_sort(modules.begin(), modules.end(),
+                   [&](const std::unique_ptr<MullModule> &lhs,
+                       const std::unique_ptr<MullModule> &rhs) {
+                     return positions[lhs->getModule()->getModuleIdentifier()] <
+                            positions[rhs->getModule()->getModuleIdentifier()];
+                   });
+
   return modules;
 }
@@ -1,30 +1,73 @@
 #include "mull/MullModule.h"
 
 #include "LLVMCompatibility.h"
+#include "mull/Hash.h"
 #include "mull/Logger.h"
 #include "mull/MutationPoint.h"
 
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/DebugInfo.h>
+#include <llvm/IR/Instructions.h>
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Module.h>
-#include <llvm/Support/MD5.h>
 #include <llvm/Support/MemoryBuffer.h>
 #include <llvm/Support/Path.h>
 #include <llvm/Support/SourceMgr.h>
 #include <llvm/Transforms/Utils/Cloning.h>
+#include <llvm/Transforms/Utils/ValueMapper.h>
+
+#include <set>
 
 using namespace mull;
 using namespace llvm;
 using namespace std;
 
 MullModule::MullModule(std::unique_ptr<llvm::Module> llvmModule)
-    : module(std::move(llvmModule)), uniqueIdentifier("") {}
+    : module(std::move(llvmModule)),
+      moduleIdentifier(module->getModuleIdentifier()), uniqueIdentifier(""),
+      hashAlgorithm(HashAlgorithm::MD5), schemataEnabled(false) {
+  indexFunctions();
+}
 
 MullModule::MullModule(std::unique_ptr<llvm::Module> llvmModule,
                        std::unique_ptr<llvm::MemoryBuffer> buffer,
-                       const std::string &md5)
-    : module(std::move(llvmModule)), buffer(std::move(buffer)) {
+                       const std::string &hash, HashAlgorithm hashAlgorithm)
+    : module(std::move(llvmModule)), buffer(std::move(buffer)),
+      moduleIdentifier(module->getModuleIdentifier()),
+      hashAlgorithm(hashAlgorithm), schemataEnabled(false) {
   uniqueIdentifier =
-      llvm::sys::path::stem(module->getModuleIdentifier()).str() + "_" + md5;
+      llvm::sys::path::stem(module->getModuleIdentifier()).str() + "_" + hash;
+  indexFunctions();
+}
+
+void MullModule::indexFunctions() {
+  int index = 0;
+  for (auto &function : module->functions()) {
+    functionIndices[&function] = index++;
+  }
+}
+
+int MullModule::getFunctionIndex(llvm::Function *function) const {
+  auto it = functionIndices.find(function);
+  assert(it != functionIndices.end() &&
+         "Expected function to be found in module");
+  return it->second;
+}
+
+static std::mutex materializationMutex;
+
+/// Reading the body does not change the function as seen from outside
+bool MullModule::materialize(const llvm::Function *function) {
+  std::lock_guard<std::mutex> guard(materializationMutex);
+  if (!function->isMaterializable()) {
+    return true;
+  }
+  return llvm_compat::materialize(*const_cast<llvm::Function *>(function));
+}
+
+bool MullModule::materializeAll() {
+  std::lock_guard<std::mutex> guard(materializationMutex);
+  return llvm_compat::materializeAll(*module);
 }
 
 std::unique_ptr<MullModule> MullModule::clone(LLVMContext &context) {
@@ -38,7 +81,8 @@ std::unique_ptr<MullModule> MullModule::clone(LLVMContext &context) {
   clone->setModuleIdentifier(module->getModuleIdentifier());
 
   return make_unique<MullModule>(std::move(clone),
-                                 std::unique_ptr<MemoryBuffer>(), "");
+                                 std::unique_ptr<MemoryBuffer>(), "",
+                                 hashAlgorithm);
 }
 
 llvm::Module *MullModule::getModule() {
@@ -51,33 +95,194 @@ llvm::Module *MullModule::getModule() const {
   return module.get();
 }
 
+const std::string &MullModule::getModuleIdentifier() const {
+  return moduleIdentifier;
+}
+
+void MullModule::stripDebugInfo(bool keepLineTables) {
+  if (keepLineTables) {
+    stripNonLineTableDebugInfo(*module);
+  } else {
+    StripDebugInfo(*module);
+  }
+}
+
+void MullModule::releaseIR() {
+  std::lock_guard<std::mutex> guard(mutex);
+  for (auto &function : mutationPoints) {
+    for (auto point : function.second) {
+      point->releaseIR();
+    }
+  }
+  schemataCalls.clear();
+  functionIndices.clear();
+  satellites.clear();
+  module.reset();
+  buffer.reset();
+}
+
 std::string MullModule::getUniqueIdentifier() { return uniqueIdentifier; }
 
 std::string MullModule::getUniqueIdentifier() const { return uniqueIdentifier; }
 
-std::vector<std::string> MullModule::prepareMutations() {
-  std::vector<std::string> mutatedFunctionNames;
+size_t MullModule::getBitcodeSize() const {
+  return buffer ? buffer->getBufferSize() : 0;
+}
+
+static CallInst *callAndReturn(Function *callee, std::vector<Value *> &args,
+                               BasicBlock *block) {
+  // name has to be empty for void functions:
+  // http://lists.llvm.org/pipermail/llvm-dev/2016-March/096242.html
+  auto callInst = CallInst::Create(callee, args, "", block);
+  callInst->setCallingConv(callee->getCallingConv());
+  if (callee->getReturnType()->isVoidTy()) {
+    ReturnInst::Create(block->getContext(), block);
+  } else {
+    ReturnInst::Create(block->getContext(), callInst, block);
+  }
+  return callInst;
+}
+
+/// A mutant can share the clone with the others when its mutator only
+/// changes the instruction itself, which then can be copied into a block
+/// of its own
+static bool canBeGuarded(MutationPoint *point) {
+  auto instruction = dyn_cast_or_null<Instruction>(point->getOriginalValue());
+  return instruction && !instruction->isTerminator() &&
+         !isa<PHINode>(instruction) && !instruction->isEHPad() &&
+         !isa<AllocaInst>(instruction) && !instruction->getType()->isTokenTy();
+}
+
+/// Splits the block around the instruction so that a copy of it, the one
+/// to mutate, runs instead when the mutant id is `index`:
+///   head:     ...; br (mutant_id == index), mutant, original
+///   original: instruction; br tail
+///   mutant:   copy; br tail
+///   tail:     phi [instruction, original], [copy, mutant]; ...
+static Instruction *guardMutant(Instruction *instruction,
+                                GlobalVariable *mutantId, uint64_t index) {
+  auto &context = instruction->getContext();
+  auto head = instruction->getParent();
+  auto tail = head->splitBasicBlock(instruction->getNextNode(), "tail");
+  auto originalBlock = head->splitBasicBlock(instruction, "original");
+  auto mutantBlock =
+      BasicBlock::Create(context, "mutant", head->getParent(), tail);
+  auto copy = instruction->clone();
+  mutantBlock->getInstList().push_back(copy);
+  BranchInst::Create(tail, mutantBlock);
+
+  head->getTerminator()->eraseFromParent();
+  auto idType = Type::getInt64Ty(context);
+  auto loadId = new LoadInst(mutantId, "mutant_id", head);
+  auto isMutant = new ICmpInst(*head, ICmpInst::ICMP_EQ, loadId,
+                               ConstantInt::get(idType, index));
+  BranchInst::Create(mutantBlock, originalBlock, isMutant, head);
+
+  if (!instruction->getType()->isVoidTy()) {
+    auto phi = PHINode::Create(instruction->getType(), 2, "", &tail->front());
+    instruction->replaceAllUsesWith(phi);
+    phi->addIncoming(instruction, originalBlock);
+    phi->addIncoming(copy, mutantBlock);
+  }
+  return copy;
+}
+
+std::vector<std::string> MullModule::prepareMutations(bool schemata,
+                                                      bool guardedSchemata) {
+  schemataEnabled = schemata;
 
   for (auto pair : mutationPoints) {
     auto original = pair.first;
     auto anyPoint = pair.second.front();
-    mutatedFunctionNames.push_back(anyPoint->getTrampolineName());
-    for (auto point : pair.second) {
+
+    GlobalVariable *mutantId = nullptr;
+    auto idType = Type::getInt64Ty(module->getContext());
+    if (schemata) {
+      mutantId = new GlobalVariable(
+          *module, idType, false, GlobalValue::ExternalLinkage,
+          ConstantInt::get(idType, 0), anyPoint->getMutantIdName());
+    }
+
+    /// The guarded mutants share one clone and one map of it
+    Function *guarded = nullptr;
+    ValueToValueMapTy guardedMap;
+    std::vector<Function *> mutatedFunctions;
+    for (size_t index = 0; index < pair.second.size(); index++) {
+      auto point = pair.second[index];
+      /// The function is still called through its trampoline
+      if (point->getCanonical()) {
+        assert(!schemata && "The copies are activated through trampolines");
+        continue;
+      }
+      if (schemata && guardedSchemata && canBeGuarded(point)) {
+        if (!guarded) {
+          guarded = CloneFunction(original, guardedMap);
+          guarded->setName(anyPoint->getGuardedFunctionName());
+        }
+        auto instruction =
+            cast<Instruction>(guardedMap[point->getOriginalValue()]);
+        point->shareMutatedFunction(
+            guarded, guardMutant(instruction, mutantId, index + 1));
+        mutatedFunctions.push_back(guarded);
+        continue;
+      }
+
       ValueToValueMapTy map;
       auto mutatedFunction = CloneFunction(original, map);
-      point->setMutatedFunction(mutatedFunction);
+      Value *mutatedValue = map[point->getOriginalValue()];
+      point->setMutatedFunction(mutatedFunction,
+                                dyn_cast_or_null<Instruction>(mutatedValue));
+      mutatedFunctions.push_back(mutatedFunction);
     }
+
     ValueToValueMapTy map;
     auto originalCopy = CloneFunction(original, map);
     originalCopy->setName(anyPoint->getOriginalFunctionName());
     original->deleteBody();
 
     std::vector<Value *> args;
-
     for (auto &arg : original->args()) {
       args.push_back(&arg);
     }
 
+    if (schemata) {
+      /// switch (mutant_id) {
+      ///   case 1: return mutant_1(args...);
+      ///   ...
+      ///   default: return original(args...);
+      /// }
+      /// The cases of the guarded mutants all call the shared clone.
+      BasicBlock *entry =
+          BasicBlock::Create(module->getContext(), "schema", original);
+      BasicBlock *originalBlock =
+          BasicBlock::Create(module->getContext(), "original", original);
+      auto loadId = new LoadInst(mutantId, "mutant_id", entry);
+      auto switchInst = SwitchInst::Create(loadId, originalBlock,
+                                           mutatedFunctions.size(), entry);
+      schemataCalls.push_back(callAndReturn(originalCopy, args, originalBlock));
+
+      BasicBlock *guardedBlock = nullptr;
+      for (size_t index = 0; index < mutatedFunctions.size(); index++) {
+        BasicBlock *mutantBlock = nullptr;
+        if (mutatedFunctions[index] == guarded && guardedBlock) {
+          mutantBlock = guardedBlock;
+        } else {
+          mutantBlock =
+              BasicBlock::Create(module->getContext(), "mutant", original);
+          schemataCalls.push_back(
+              callAndReturn(mutatedFunctions[index], args, mutantBlock));
+          if (mutatedFunctions[index] == guarded) {
+            guardedBlock = mutantBlock;
+          }
+        }
+        switchInst->addCase(ConstantInt::get(idType, index + 1), mutantBlock);
+        pair.second[index]->setSchemaIndex(index + 1);
+      }
+      continue;
+    }
+
+    trampolineNames.push_back(anyPoint->getTrampolineName());
+
     auto trampoline =
         module->getOrInsertGlobal(anyPoint->getTrampolineName(),
                                   original->getFunctionType()->getPointerTo());
@@ -91,24 +296,110 @@ std::vector<std::string> MullModule::prepareMutations() {
     ReturnInst::Create(module->getContext(), callInst, block);
   }
 
-  return mutatedFunctionNames;
+  return trampolineNames;
+}
+
+const std::vector<std::string> &MullModule::getTrampolineNames() const {
+  return trampolineNames;
+}
+
+/// Canonicalizes a throwaway clone, the function itself is left as it is
+static std::string canonicalHash(Function *function) {
+  ValueToValueMapTy map;
+  auto clone = CloneFunction(function, map);
+  llvm_compat::canonicalizeFunction(*clone);
+  auto hash = hashOfFunctionCode(*clone);
+  clone->eraseFromParent();
+  return hash;
+}
+
+void MullModule::hashMutations() {
+  for (auto &pair : mutationPoints) {
+    auto anyPoint = pair.second.front();
+    auto originalCopy =
+        module->getFunction(anyPoint->getOriginalFunctionName());
+    assert(originalCopy && "Expected mutations to be prepared");
+    auto originalHash = canonicalHash(originalCopy);
+
+    for (auto point : pair.second) {
+      if (point->getCanonical()) {
+        continue;
+      }
+      auto hash = canonicalHash(point->getMutatedFunction());
+      point->setMutantHash(hash);
+      point->setEquivalent(hash == originalHash);
+    }
+  }
+}
+
+void MullModule::inlineSchemata() {
+  for (auto callInst : schemataCalls) {
+    auto callee = callInst->getCalledFunction();
+    InlineFunctionInfo info;
+    /// If a function cannot be inlined (e.g. varargs) it is still called
+    /// from the schema, which is correct, just not merged
+    if (InlineFunction(callInst, info) && callee->use_empty()) {
+      callee->eraseFromParent();
+    }
+  }
+  std::vector<CallInst *>().swap(schemataCalls);
 }
 
-void MullModule::addMutation(MutationPoint *point) {
+MutationPoint *MullModule::createMutationPoint(
+    Mutator *mutator, const MutationPointAddress &address, llvm::Value *value,
+    llvm::Function *function, const std::string &diagnostics,
+    const SourceLocation &location) {
+  return mutationPointArena.create(mutator, address, value, function,
+                                   diagnostics, location, this);
+}
+
+const std::string *MullModule::internString(const std::string &string) {
+  return mutationPointArena.intern(string);
+}
+
+void MullModule::addMutations(
+    const std::map<llvm::Function *, std::vector<MutationPoint *>> &points) {
+  std::lock_guard<std::mutex> guard(mutex);
+  for (auto &pair : points) {
+    auto &functionPoints = mutationPoints[pair.first];
+    functionPoints.insert(functionPoints.end(), pair.second.begin(),
+                          pair.second.end());
+  }
+}
+
+void MullModule::retainMutations(const std::vector<MutationPoint *> &points) {
   std::lock_guard<std::mutex> guard(mutex);
-  auto function = point->getOriginalFunction();
-  mutationPoints[function].push_back(point);
+  mutationPoints.clear();
+  for (auto point : points) {
+    assert(point->getOriginalModule() == this);
+    mutationPoints[point->getOriginalFunction()].push_back(point);
+  }
 }
 
 std::string MullModule::getInstrumentedUniqueIdentifier() const {
   return getUniqueIdentifier() + "_instrumented";
 }
 
+static std::string combinedHash(std::vector<std::string> strings,
+                                HashAlgorithm algorithm) {
+  std::sort(strings.begin(), strings.end());
+
+  Hasher hasher(algorithm);
+  for (auto &string : strings) {
+    hasher.update(string);
+  }
+  return hasher.final();
+}
+
 std::string MullModule::getMutatedUniqueIdentifier() const {
   if (mutationPoints.empty()) {
     return getUniqueIdentifier();
   }
 
+  if (!satellites.empty()) {
+    return splitIdentifier;
+  }
+
   std::vector<std::string> mutationPointsIds;
   for (auto mutationPair : mutationPoints) {
     for (auto point : mutationPair.second) {
@@ -116,17 +407,177 @@ std::string MullModule::getMutatedUniqueIdentifier() const {
     }
   }
 
-  std::sort(mutationPointsIds.begin(), mutationPointsIds.end());
+  auto suffix = schemataEnabled ? "_mutated_schemata" : "_mutated";
+  return getUniqueIdentifier() + "_" +
+         combinedHash(mutationPointsIds, hashAlgorithm) + suffix;
+}
 
-  MD5 hasher;
-  for (auto &id : mutationPointsIds) {
-    hasher.update(id);
+size_t MullModule::getSatelliteCount() const { return satellites.size(); }
+
+llvm::Module *MullModule::getSatelliteModule(size_t index) {
+  return satellites[index].get();
+}
+
+std::string MullModule::getSatelliteUniqueIdentifier(size_t index) const {
+  return satelliteIdentifiers[index];
+}
+
+/// Collects the global values of the module a moved function refers to,
+/// including the ones hidden in constant expressions and initializers
+static void collectGlobals(Value *value, Module *module,
+                           std::set<GlobalValue *> &globals,
+                           std::set<Value *> &visited) {
+  if (!visited.insert(value).second) {
+    return;
+  }
+
+  if (auto global = dyn_cast<GlobalValue>(value)) {
+    if (global->getParent() == module) {
+      globals.insert(global);
+    }
+    return;
   }
 
-  MD5::MD5Result hash;
-  hasher.final(hash);
-  SmallString<32> result;
-  MD5::stringifyResult(hash, result);
+  if (auto constant = dyn_cast<Constant>(value)) {
+    for (auto &operand : constant->operands()) {
+      collectGlobals(operand.get(), module, globals, visited);
+    }
+  }
+}
+
+/// The satellite refers to the rest of the module through declarations.
+/// Local symbols are not visible from another object file, they are
+/// exported through aliases named after the module to avoid clashes.
+static std::unique_ptr<Module>
+createSatellite(Module *module, const std::string &moduleIdentifier,
+                const std::vector<Function *> &movedFunctions,
+                const std::set<Value *> &allMovedFunctions,
+                std::map<GlobalValue *, std::string> &exportedNames) {
+  std::set<GlobalValue *> globals;
+  std::set<Value *> visited(allMovedFunctions);
+  for (auto function : movedFunctions) {
+    if (function->hasPersonalityFn()) {
+      collectGlobals(function->getPersonalityFn(), module, globals, visited);
+    }
+    for (auto &block : *function) {
+      for (auto &instruction : block) {
+        for (auto &operand : instruction.operands()) {
+          collectGlobals(operand.get(), module, globals, visited);
+        }
+      }
+    }
+  }
 
-  return (getUniqueIdentifier() + "_" + result + "_mutated").str();
+  auto satellite = make_unique<Module>(
+      module->getModuleIdentifier() + ".mutants", module->getContext());
+  satellite->setDataLayout(module->getDataLayout());
+  satellite->setTargetTriple(module->getTargetTriple());
+
+  ValueToValueMapTy map;
+  for (auto global : globals) {
+    std::string name = global->getName().str();
+    if (global->hasLocalLinkage()) {
+      auto exported = exportedNames.find(global);
+      if (exported == exportedNames.end()) {
+        auto alias = GlobalAlias::create(
+            GlobalValue::ExternalLinkage,
+            global->getName() + "_" + moduleIdentifier + "_shared", global);
+        exported =
+            exportedNames.insert(std::make_pair(global, alias->getName().str()))
+                .first;
+      }
+      name = exported->second;
+    }
+
+    GlobalValue *declaration = nullptr;
+    if (auto type = dyn_cast<FunctionType>(global->getValueType())) {
+      auto function = Function::Create(type, GlobalValue::ExternalLinkage,
+                                       name, satellite.get());
+      if (auto original = dyn_cast<Function>(global)) {
+        function->setCallingConv(original->getCallingConv());
+        function->setAttributes(original->getAttributes());
+      }
+      declaration = function;
+    } else {
+      auto variable = dyn_cast<GlobalVariable>(global);
+      declaration = new GlobalVariable(
+          *satellite, global->getValueType(),
+          variable ? variable->isConstant() : false,
+          GlobalValue::ExternalLinkage, nullptr, name, nullptr,
+          global->getThreadLocalMode(), global->getType()->getAddressSpace());
+    }
+    map[global] = declaration;
+  }
+
+  for (auto function : movedFunctions) {
+    function->removeFromParent();
+    satellite->getFunctionList().push_back(function);
+    function->setLinkage(GlobalValue::ExternalLinkage);
+    function->setComdat(nullptr);
+  }
+
+  /// Debug info refers to the compile unit of the original module
+  StripDebugInfo(*satellite);
+
+  const auto flags = RF_IgnoreMissingLocals | RF_NoModuleLevelChanges;
+  for (auto function : movedFunctions) {
+    if (function->hasPersonalityFn()) {
+      function->setPersonalityFn(
+          MapValue(function->getPersonalityFn(), map, flags));
+    }
+    for (auto &block : *function) {
+      for (auto &instruction : block) {
+        RemapInstruction(&instruction, map, flags);
+      }
+    }
+  }
+
+  return satellite;
+}
+
+void MullModule::splitMutatedFunctions() {
+  assert(!schemataEnabled && "Schemata keep the mutants in the function");
+  if (mutationPoints.empty()) {
+    return;
+  }
+
+  std::vector<std::vector<Function *>> movedFunctions;
+  std::set<Value *> allMovedFunctions;
+  std::vector<std::string> mutatedFunctionNames;
+  for (auto &pair : mutationPoints) {
+    auto anyPoint = pair.second.front();
+    mutatedFunctionNames.push_back(pair.first->getName().str());
+
+    std::vector<Function *> functions;
+    functions.push_back(
+        module->getFunction(anyPoint->getOriginalFunctionName()));
+    std::vector<std::string> mutationPointsIds;
+    for (auto point : pair.second) {
+      if (!point->getCanonical()) {
+        functions.push_back(
+            module->getFunction(point->getMutatedFunctionName()));
+      }
+      mutationPointsIds.push_back(point->getUniqueIdentifier());
+    }
+
+    allMovedFunctions.insert(functions.begin(), functions.end());
+    movedFunctions.push_back(std::move(functions));
+    satelliteIdentifiers.push_back(
+        getUniqueIdentifier() + "_" +
+        combinedHash(mutationPointsIds, hashAlgorithm) + "_satellite");
+  }
+
+  std::map<GlobalValue *, std::string> exportedNames;
+  for (auto &functions : movedFunctions) {
+    satellites.push_back(createSatellite(module.get(), getUniqueIdentifier(),
+                                         functions, allMovedFunctions,
+                                         exportedNames));
+  }
+
+  for (auto &exported : exportedNames) {
+    mutatedFunctionNames.push_back(exported.second);
+  }
+  splitIdentifier = getUniqueIdentifier() + "_" +
+                    combinedHash(mutatedFunctionNames, hashAlgorithm) +
+                    "_split";
 }
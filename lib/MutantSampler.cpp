@@ -0,0 +1,248 @@
+#include "mull/MutantSampler.h"
+
+#include "mull/Config/Configuration.h"
+#include "mull/MullModule.h"
+#include "mull/MutationPoint.h"
+#include "mull/Mutators/Mutator.h"
+#include "mull/SourceLocation.h"
+#include "mull/TestFrameworks/Test.h"
+
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Module.h>
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <string>
+#include <utility>
+
+using namespace mull;
+
+long long mull::estimatedMutantCost(const MutationPoint *point) {
+  long long cost = 0;
+  for (auto reachableTest : point->getReachableTests()) {
+    auto test = reachableTest.first;
+    cost += std::max(test->getExecutionResult().runningTime, 1LL);
+  }
+  return cost;
+}
+
+std::vector<MutationPoint *>
+mull::longestFirst(const std::vector<MutationPoint *> &points) {
+  std::vector<std::pair<long long, MutationPoint *>> costs;
+  costs.reserve(points.size());
+  for (auto point : points) {
+    costs.emplace_back(estimatedMutantCost(point), point);
+  }
+
+  std::stable_sort(costs.begin(), costs.end(),
+                   [](const std::pair<long long, MutationPoint *> &lhs,
+                      const std::pair<long long, MutationPoint *> &rhs) {
+                     return lhs.first > rhs.first;
+                   });
+
+  std::vector<MutationPoint *> scheduled;
+  scheduled.reserve(costs.size());
+  for (auto &pair : costs) {
+    scheduled.push_back(pair.second);
+  }
+  return scheduled;
+}
+
+MutantSampler::MutantSampler(const SamplingConfig &config, int workers)
+    : config(config), workers(std::max(workers, 1)) {}
+
+MutantSampler::MutantSampler(const Configuration &config)
+    : MutantSampler(config.sampling,
+                    config.parallelization.mutantExecutionWorkers) {}
+
+std::vector<MutationPoint *>
+MutantSampler::sample(const std::vector<MutationPoint *> &points) const {
+  std::vector<size_t> indices;
+  switch (config.strategy) {
+  case SamplingStrategy::None:
+    return points;
+  case SamplingStrategy::Uniform:
+    indices = uniform(points, config.size);
+    break;
+  case SamplingStrategy::PerMutator:
+  case SamplingStrategy::PerFile:
+  case SamplingStrategy::PerFunction:
+    indices = stratified(points, config.size);
+    break;
+  case SamplingStrategy::TimeBudget:
+    indices = budgeted(points, config.budget * 1000LL * workers);
+    break;
+  }
+
+  std::sort(indices.begin(), indices.end());
+  std::vector<MutationPoint *> sampled;
+  sampled.reserve(indices.size());
+  for (auto index : indices) {
+    sampled.push_back(points[index]);
+  }
+  return sampled;
+}
+
+/// std::shuffle is not the same across the standard libraries, the
+/// Fisher-Yates shuffle keeps the samples of a seed the same everywhere
+static std::vector<size_t> shuffled(size_t count, std::mt19937 &random) {
+  std::vector<size_t> indices(count);
+  std::iota(indices.begin(), indices.end(), 0);
+  for (size_t index = count; index > 1; index--) {
+    size_t other = random() % index;
+    std::swap(indices[index - 1], indices[other]);
+  }
+  return indices;
+}
+
+std::vector<size_t>
+MutantSampler::uniform(const std::vector<MutationPoint *> &points,
+                       size_t size) const {
+  std::mt19937 random(config.seed);
+  auto indices = shuffled(points.size(), random);
+  indices.resize(std::min(size, indices.size()));
+  return indices;
+}
+
+/// The strata are named rather than identified by pointers, so that they
+/// are in the same order from one run to the next
+static std::string stratumOf(SamplingStrategy strategy, MutationPoint *point) {
+  switch (strategy) {
+  case SamplingStrategy::PerMutator:
+    return point->getMutator()->getUniqueIdentifier();
+  case SamplingStrategy::PerFile:
+    return point->getSourceLocation().filePath();
+  default:
+    return point->getOriginalModule()->getModuleIdentifier() + "\n" +
+           point->getFunctionName();
+  }
+}
+
+/// Every stratum gets its share of the sample rounded down, the mutants
+/// left go to the strata with the largest remainders
+std::vector<size_t>
+MutantSampler::stratified(const std::vector<MutationPoint *> &points,
+                          size_t size) const {
+  if (size >= points.size()) {
+    return uniform(points, size);
+  }
+
+  std::map<std::string, std::vector<size_t>> strata;
+  for (size_t index = 0; index < points.size(); index++) {
+    strata[stratumOf(config.strategy, points[index])].push_back(index);
+  }
+
+  std::vector<size_t> shares;
+  std::vector<std::pair<size_t, size_t>> remainders;
+  size_t assigned = 0;
+  for (auto &stratum : strata) {
+    size_t share = stratum.second.size() * size / points.size();
+    size_t remainder = stratum.second.size() * size % points.size();
+    remainders.emplace_back(remainder, shares.size());
+    shares.push_back(share);
+    assigned += share;
+  }
+  std::stable_sort(remainders.begin(), remainders.end(),
+                   [](const std::pair<size_t, size_t> &lhs,
+                      const std::pair<size_t, size_t> &rhs) {
+                     return lhs.first > rhs.first;
+                   });
+  for (size_t index = 0; assigned < size; index++, assigned++) {
+    shares[remainders[index].second]++;
+  }
+
+  std::mt19937 random(config.seed);
+  std::vector<size_t> indices;
+  size_t stratumIndex = 0;
+  for (auto &stratum : strata) {
+    auto order = shuffled(stratum.second.size(), random);
+    for (size_t index = 0; index < shares[stratumIndex]; index++) {
+      indices.push_back(stratum.second[order[index]]);
+    }
+    stratumIndex++;
+  }
+  return indices;
+}
+
+/// The cheapest mutants first make the largest sample that fits, the
+/// mutants that cost the same are taken at random
+std::vector<size_t>
+MutantSampler::budgeted(const std::vector<MutationPoint *> &points,
+                        long long budget) const {
+  std::mt19937 random(config.seed);
+  auto indices = shuffled(points.size(), random);
+  std::vector<long long> costs;
+  costs.reserve(points.size());
+  for (auto point : points) {
+    costs.push_back(estimatedMutantCost(point));
+  }
+  std::stable_sort(indices.begin(), indices.end(),
+                   [&](size_t lhs, size_t rhs) {
+                     return costs[lhs] < costs[rhs];
+                   });
+
+  long long total = 0;
+  size_t count = 0;
+  while (count < indices.size() && total + costs[indices[count]] <= budget) {
+    total += costs[indices[count]];
+    count++;
+  }
+  indices.resize(count);
+  return indices;
+}
+
+std::vector<MutationPoint *>
+mull::shardMutants(const std::vector<MutationPoint *> &points, int index,
+                   int count) {
+  if (count <= 1) {
+    return points;
+  }
+
+  struct Mutant {
+    long long cost;
+    std::string identifier;
+    size_t position;
+  };
+  std::vector<Mutant> mutants;
+  mutants.reserve(points.size());
+  for (size_t position = 0; position < points.size(); position++) {
+    mutants.push_back({estimatedMutantCost(points[position]),
+                       points[position]->getUniqueIdentifier(), position});
+  }
+  std::sort(mutants.begin(), mutants.end(),
+            [](const Mutant &lhs, const Mutant &rhs) {
+              if (lhs.cost != rhs.cost) {
+                return lhs.cost > rhs.cost;
+              }
+              return lhs.identifier < rhs.identifier;
+            });
+
+  /// The cost of every shard so far, the cheapest on top
+  using Shard = std::pair<long long, int>;
+  std::priority_queue<Shard, std::vector<Shard>, std::greater<Shard>> shards;
+  for (int shard = 0; shard < count; shard++) {
+    shards.push(Shard(0, shard));
+  }
+
+  std::vector<size_t> positions;
+  for (auto &mutant : mutants) {
+    auto shard = shards.top();
+    shards.pop();
+    if (shard.second == index) {
+      positions.push_back(mutant.position);
+    }
+    shards.push(Shard(shard.first + mutant.cost, shard.second));
+  }
+
+  std::sort(positions.begin(), positions.end());
+  std::vector<MutationPoint *> shard;
+  shard.reserve(positions.size());
+  for (auto position : positions) {
+    shard.push_back(points[position]);
+  }
+  return shard;
+}
@@ -57,6 +57,10 @@ void MutationPointAddress::enumerateInstructions(
 
 llvm::Instruction &
 MutationPointAddress::findInstruction(llvm::Function *function) {
+  if (knownInstruction && function == knownFunction) {
+    return *knownInstruction;
+  }
+
   llvm::BasicBlock &bb = *(std::next(function->begin(), getBBIndex()));
   llvm::Instruction &instruction = *(std::next(bb.begin(), getIIndex()));
 
@@ -64,11 +68,8 @@ MutationPointAddress::findInstruction(llvm::Function *function) {
 }
 
 MutationPointAddress::MutationPointAddress(int FnIndex, int BBIndex, int IIndex)
-    : FnIndex(FnIndex), BBIndex(BBIndex), IIndex(IIndex) {
-
-  identifier = std::to_string(FnIndex) + "_" + std::to_string(BBIndex) + "_" +
-               std::to_string(IIndex);
-}
+    : FnIndex(FnIndex), BBIndex(BBIndex), IIndex(IIndex),
+      knownFunction(nullptr), knownInstruction(nullptr) {}
 
 int MutationPointAddress::getFnIndex() { return FnIndex; }
 
@@ -76,24 +77,41 @@ int MutationPointAddress::getBBIndex() { return BBIndex; }
 
 int MutationPointAddress::getIIndex() { return IIndex; }
 
-std::string MutationPointAddress::getIdentifier() { return identifier; }
+std::string MutationPointAddress::getIdentifier() {
+  return static_cast<const MutationPointAddress *>(this)->getIdentifier();
+}
 
-std::string MutationPointAddress::getIdentifier() const { return identifier; }
+std::string MutationPointAddress::getIdentifier() const {
+  return std::to_string(FnIndex) + "_" + std::to_string(BBIndex) + "_" +
+         std::to_string(IIndex);
+}
+
+void MutationPointAddress::setInstruction(llvm::Instruction *instruction) {
+  knownInstruction = instruction;
+  knownFunction = instruction ? instruction->getParent()->getParent() : nullptr;
+}
 
 #pragma mark - MutationPoint
 
+static const std::string &emptyString() {
+  static const std::string empty;
+  return empty;
+}
+
 MutationPoint::MutationPoint(Mutator *mutator, MutationPointAddress Address,
                              llvm::Value *Val, llvm::Function *function,
                              std::string diagnostics,
                              const SourceLocation &location, MullModule *m)
     : mutator(mutator), Address(Address), OriginalValue(Val), module(m),
       originalFunction(function), mutatedFunction(nullptr),
-      diagnostics(diagnostics), sourceLocation(location), reachableTests() {
-  string moduleID = module->getUniqueIdentifier();
-  string addressID = Address.getIdentifier();
-  string mutatorID = mutator->getUniqueIdentifier();
-
-  uniqueIdentifier = moduleID + "_" + addressID + "_" + mutatorID;
+      diagnostics(m->internString(diagnostics)), functionName(nullptr),
+      functionHash(&emptyString()),
+      mutantHash(&emptyString()), sourceLocation(location), schemaIndex(0),
+      equivalent(false), canonical(nullptr), nextOdrCopy(nullptr) {
+  auto instruction = dyn_cast_or_null<Instruction>(Val);
+  if (instruction && instruction->getParent()->getParent() == function) {
+    this->Address.setInstruction(instruction);
+  }
 }
 
 MutationPoint::~MutationPoint() {}
@@ -115,28 +133,86 @@ Value *MutationPoint::getOriginalValue() const { return OriginalValue; }
 MullModule *MutationPoint::getOriginalModule() const { return module; }
 
 void MutationPoint::addReachableTest(Test *test, int distance) {
-  reachableTests.emplace_back(test, distance);
+  ReachableTests::modifiable(reachableTests).add(test, distance);
 }
 
 void MutationPoint::applyMutation() {
   assert(mutatedFunction != nullptr);
   mutator->applyMutation(mutatedFunction, Address);
+  /// The mutator may have replaced the instruction
+  Address.setInstruction(nullptr);
 }
 
-const std::vector<std::pair<Test *, int>> &
-MutationPoint::getReachableTests() const {
+const ReachableTests &MutationPoint::getReachableTests() const {
+  return reachableTests ? *reachableTests : ReachableTests::none();
+}
+
+const std::shared_ptr<const ReachableTests> &
+MutationPoint::getSharedReachableTests() const {
   return reachableTests;
 }
 
-std::string MutationPoint::getUniqueIdentifier() { return uniqueIdentifier; }
+void MutationPoint::setReachableTests(
+    std::shared_ptr<const ReachableTests> tests) {
+  reachableTests = std::move(tests);
+}
+
+std::string MutationPoint::getUniqueIdentifier() {
+  return static_cast<const MutationPoint *>(this)->getUniqueIdentifier();
+}
 
 std::string MutationPoint::getUniqueIdentifier() const {
-  return uniqueIdentifier;
+  return module->getUniqueIdentifier() + "_" + Address.getIdentifier() + "_" +
+         mutator->getUniqueIdentifier();
+}
+
+const std::string &MutationPoint::getDiagnostics() { return *diagnostics; }
+
+const std::string &MutationPoint::getDiagnostics() const {
+  return *diagnostics;
+}
+
+const std::string &MutationPoint::getFunctionHash() const {
+  return *functionHash;
+}
+
+void MutationPoint::setFunctionHash(const std::string &hash) {
+  functionHash = module->internString(hash);
+}
+
+const std::string &MutationPoint::getMutantHash() const {
+  return *mutantHash;
+}
+
+void MutationPoint::setMutantHash(const std::string &hash) {
+  mutantHash = module->internString(hash);
 }
 
-const std::string &MutationPoint::getDiagnostics() { return diagnostics; }
+bool MutationPoint::isEquivalent() const { return equivalent; }
+
+void MutationPoint::setEquivalent(bool equivalent) {
+  this->equivalent = equivalent;
+}
+
+void MutationPoint::setCanonical(MutationPoint *canonical) {
+  assert(canonical && !canonical->canonical && !this->canonical);
+  this->canonical = canonical;
+  nextOdrCopy = canonical->nextOdrCopy;
+  canonical->nextOdrCopy = this;
+}
 
-const std::string &MutationPoint::getDiagnostics() const { return diagnostics; }
+MutationPoint *MutationPoint::getCanonical() const { return canonical; }
+
+std::vector<MutationPoint *> MutationPoint::getOdrCopies() const {
+  std::vector<MutationPoint *> copies;
+  if (canonical) {
+    return copies;
+  }
+  for (auto copy = nextOdrCopy; copy; copy = copy->nextOdrCopy) {
+    copies.push_back(copy);
+  }
+  return copies;
+}
 
 const SourceLocation &MutationPoint::getSourceLocation() const {
   return sourceLocation;
@@ -144,14 +220,40 @@ const SourceLocation &MutationPoint::getSourceLocation() const {
 
 Function *MutationPoint::getOriginalFunction() { return originalFunction; }
 
-void MutationPoint::setMutatedFunction(llvm::Function *function) {
+void MutationPoint::setMutatedFunction(llvm::Function *function,
+                                       llvm::Instruction *mutatedInstruction) {
   function->setName(getMutatedFunctionName());
   this->mutatedFunction = function;
+  Address.setInstruction(mutatedInstruction);
+}
+
+void MutationPoint::shareMutatedFunction(llvm::Function *function,
+                                         llvm::Instruction *mutatedInstruction) {
+  this->mutatedFunction = function;
+  Address.setInstruction(mutatedInstruction);
+}
+
+Function *MutationPoint::getMutatedFunction() { return mutatedFunction; }
+
+int MutationPoint::getSchemaIndex() const { return schemaIndex; }
+
+void MutationPoint::setSchemaIndex(int index) { schemaIndex = index; }
+
+std::string MutationPoint::getFunctionName() const {
+  return originalFunction ? originalFunction->getName().str() : *functionName;
+}
+
+void MutationPoint::releaseIR() {
+  functionName = module->internString(getFunctionName());
+  Address.setInstruction(nullptr);
+  OriginalValue = nullptr;
+  originalFunction = nullptr;
+  mutatedFunction = nullptr;
 }
 
 std::string MutationPoint::getTrampolineName() {
-  return originalFunction->getName().str() + "_" +
-         module->getUniqueIdentifier() + "_trampoline";
+  return getFunctionName() + "_" + module->getUniqueIdentifier() +
+         "_trampoline";
 }
 
 std::string MutationPoint::getMutatedFunctionName() {
@@ -159,6 +261,13 @@ std::string MutationPoint::getMutatedFunctionName() {
 }
 
 std::string MutationPoint::getOriginalFunctionName() {
-  return originalFunction->getName().str() + "_" +
-         module->getUniqueIdentifier() + "_original";
+  return getFunctionName() + "_" + module->getUniqueIdentifier() + "_original";
+}
+
+std::string MutationPoint::getMutantIdName() {
+  return getFunctionName() + "_" + module->getUniqueIdentifier() + "_mutant_id";
+}
+
+std::string MutationPoint::getGuardedFunctionName() {
+  return getFunctionName() + "_" + module->getUniqueIdentifier() + "_guarded";
 }
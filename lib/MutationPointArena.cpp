@@ -0,0 +1,32 @@
+#include "mull/MutationPointArena.h"
+
+#include <new>
+
+using namespace mull;
+
+MutationPointArena::MutationPointArena() : count(0) {}
+
+/// The allocator runs the destructors of the points
+MutationPointArena::~MutationPointArena() {}
+
+MutationPoint *MutationPointArena::create(
+    Mutator *mutator, const MutationPointAddress &address, llvm::Value *value,
+    llvm::Function *function, const std::string &diagnostics,
+    const SourceLocation &location, MullModule *module) {
+  void *memory;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    memory = allocator.Allocate();
+    count++;
+  }
+  /// The constructor interns its strings, so it runs without the lock
+  return new (memory) MutationPoint(mutator, address, value, function,
+                                    diagnostics, location, module);
+}
+
+const std::string *MutationPointArena::intern(const std::string &string) {
+  std::lock_guard<std::mutex> lock(mutex);
+  return &*strings.insert(string).first;
+}
+
+size_t MutationPointArena::size() const { return count; }
@@ -0,0 +1,471 @@
+#include "mull/MutationResultTable.h"
+
+#include "mull/Logger.h"
+#include "mull/TestFrameworks/Test.h"
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <unordered_map>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace mull;
+
+static std::atomic<size_t> resultMemoryBudget(0);
+static std::atomic<size_t> resultBytesInMemory(0);
+/// Set once a segment could not be written, the rows then stay in memory
+static std::atomic<bool> spillFailed(false);
+static const size_t MinimumSegmentBytes = 1 << 20;
+/// The columns of a row, the outputs are counted on their own
+static const size_t RowBytes = 3 * sizeof(uint32_t) + 2 * sizeof(int32_t) +
+                               sizeof(uint8_t) + sizeof(int64_t);
+
+void mull::setResultMemoryBudget(size_t bytes) { resultMemoryBudget = bytes; }
+
+/// A row as written to a segment. The segments only live as long as the
+/// process, so the points and the tests are kept as pointers. The outputs
+/// follow the rows, stdout then stderr, at the given offset.
+struct MutationResultTable::SpilledRow {
+  MutationPoint *point;
+  Test *test;
+  int64_t runningTime;
+  uint64_t output;
+  int32_t distance;
+  int32_t exitStatus;
+  uint32_t stdoutSize;
+  uint32_t stderrSize;
+  uint8_t status;
+};
+
+struct MutationResultTable::Segment {
+  Segment(const uint8_t *mapping, size_t length)
+      : mapping(mapping), length(length) {}
+  ~Segment() { munmap(const_cast<uint8_t *>(mapping), length); }
+
+  const SpilledRow &row(size_t index) const {
+    return reinterpret_cast<const SpilledRow *>(mapping)[index];
+  }
+  ExecutionOutput text(uint64_t offset, uint32_t size) const {
+    return std::string(reinterpret_cast<const char *>(mapping) + offset, size);
+  }
+
+  const uint8_t *mapping;
+  size_t length;
+};
+
+MutationResultTable::MemoryShare::MemoryShare(const MemoryShare &other)
+    : bytes(0) {
+  add(other.bytes);
+}
+
+MutationResultTable::MemoryShare::MemoryShare(MemoryShare &&other)
+    : bytes(other.bytes) {
+  other.bytes = 0;
+}
+
+MutationResultTable::MemoryShare &
+MutationResultTable::MemoryShare::operator=(const MemoryShare &other) {
+  if (this != &other) {
+    release();
+    add(other.bytes);
+  }
+  return *this;
+}
+
+MutationResultTable::MemoryShare &
+MutationResultTable::MemoryShare::operator=(MemoryShare &&other) {
+  if (this != &other) {
+    release();
+    bytes = other.bytes;
+    other.bytes = 0;
+  }
+  return *this;
+}
+
+MutationResultTable::MemoryShare::~MemoryShare() { release(); }
+
+void MutationResultTable::MemoryShare::add(size_t added) {
+  bytes += added;
+  resultBytesInMemory += added;
+}
+
+void MutationResultTable::MemoryShare::release() {
+  resultBytesInMemory -= bytes;
+  bytes = 0;
+}
+
+uint32_t MutationResultTable::indexOfPoint(MutationPoint *point) {
+  if (points.empty() || points.back() != point) {
+    points.push_back(point);
+  }
+  return points.size() - 1;
+}
+
+uint32_t MutationResultTable::indexOfTest(Test *test) {
+  auto id = test->getId();
+  if (testIndices.size() <= id) {
+    testIndices.resize(id + 1, 0);
+  }
+  auto &index = testIndices[id];
+  if (index == 0) {
+    tests.push_back(test);
+    index = tests.size();
+  }
+  return index - 1;
+}
+
+void MutationResultTable::add(const MutationResult &result) {
+  auto &executionResult = result.getExecutionResult();
+  pointRows.push_back(indexOfPoint(result.getMutationPoint()));
+  testRows.push_back(indexOfTest(result.getTest()));
+  distances.push_back(result.getMutationDistance());
+  statuses.push_back(uint8_t(executionResult.status));
+  exitStatuses.push_back(executionResult.exitStatus);
+  runningTimes.push_back(executionResult.runningTime);
+  if (executionResult.stdoutOutput.empty() &&
+      executionResult.stderrOutput.empty()) {
+    outputRows.push_back(0);
+  } else {
+    outputs.emplace_back(executionResult.stdoutOutput,
+                         executionResult.stderrOutput);
+    outputRows.push_back(outputs.size());
+  }
+  /// The outputs are counted as if they were not shared
+  memory.add(RowBytes + executionResult.stdoutOutput.size() +
+             executionResult.stderrOutput.size());
+  spillIfOverBudget();
+}
+
+void MutationResultTable::spillIfOverBudget() {
+  size_t budget = resultMemoryBudget;
+  if (budget != 0 && !spillFailed &&
+      memory.get() >= std::min(budget, MinimumSegmentBytes) &&
+      resultBytesInMemory > budget) {
+    spill();
+  }
+}
+
+static bool writeAt(int descriptor, const void *data, size_t size,
+                    off_t offset) {
+  auto bytes = static_cast<const char *>(data);
+  while (size != 0) {
+    auto written = pwrite(descriptor, bytes, size, offset);
+    if (written == -1 && errno == EINTR) {
+      continue;
+    }
+    if (written <= 0) {
+      return false;
+    }
+    bytes += written;
+    size -= written;
+    offset += written;
+  }
+  return true;
+}
+
+/// The rows take the beginning of the segment, so that each output can be
+/// written right after the ones of the previous rows as the rows go
+bool MutationResultTable::spill() {
+  size_t rows = pointRows.size();
+  if (rows == 0) {
+    return true;
+  }
+  if (spillFailed) {
+    return false;
+  }
+
+  int descriptor = -1;
+  llvm::SmallString<128> path;
+  auto error = llvm::sys::fs::createTemporaryFile("mull-results", "segment",
+                                                  descriptor, path);
+  if (error) {
+    if (!spillFailed.exchange(true)) {
+      Logger::error() << "Cannot create a result segment, the results stay "
+                         "in memory: "
+                      << error.message() << "\n";
+    }
+    return false;
+  }
+  /// The segment goes away with the mapping, however the run ends
+  llvm::sys::fs::remove(path);
+
+  const size_t chunkRows = 4096;
+  std::vector<SpilledRow> chunk;
+  chunk.reserve(std::min(rows, chunkRows));
+  off_t rowsOffset = 0;
+  uint64_t textOffset = rows * sizeof(SpilledRow);
+  bool written = true;
+  for (size_t row = 0; row < rows && written; row++) {
+    SpilledRow spilled;
+    memset(&spilled, 0, sizeof(spilled));
+    spilled.point = points[pointRows[row]];
+    spilled.test = tests[testRows[row]];
+    spilled.runningTime = runningTimes[row];
+    spilled.output = textOffset;
+    spilled.distance = distances[row];
+    spilled.exitStatus = exitStatuses[row];
+    spilled.status = statuses[row];
+    if (outputRows[row] != 0) {
+      auto &output = outputs[outputRows[row] - 1];
+      auto stdoutText = output.first.str();
+      auto text = stdoutText + output.second.str();
+      spilled.stdoutSize = stdoutText.size();
+      spilled.stderrSize = text.size() - stdoutText.size();
+      written = writeAt(descriptor, text.data(), text.size(), textOffset);
+      textOffset += text.size();
+    }
+    chunk.push_back(spilled);
+    if (chunk.size() == chunkRows || row + 1 == rows) {
+      size_t bytes = chunk.size() * sizeof(SpilledRow);
+      written = written && writeAt(descriptor, chunk.data(), bytes, rowsOffset);
+      rowsOffset += bytes;
+      chunk.clear();
+    }
+  }
+
+  void *mapping = MAP_FAILED;
+  if (written) {
+    mapping = mmap(nullptr, textOffset, PROT_READ, MAP_SHARED, descriptor, 0);
+  }
+  int writeError = errno;
+  close(descriptor);
+  if (mapping == MAP_FAILED) {
+    if (!spillFailed.exchange(true)) {
+      Logger::error() << "Cannot write a result segment, the results stay in "
+                         "memory: "
+                      << strerror(writeError) << "\n";
+    }
+    return false;
+  }
+
+  segments.push_back(std::make_shared<const Segment>(
+      static_cast<const uint8_t *>(mapping), textOffset));
+  spilledRows += rows;
+  segmentEnds.push_back(spilledRows);
+  Logger::debug() << "Spilled " << rows << " result rows, "
+                  << spilledRows << " in total\n";
+
+  /// The tests stay, there are only so many of them
+  std::vector<MutationPoint *>().swap(points);
+  std::vector<std::pair<ExecutionOutput, ExecutionOutput>>().swap(outputs);
+  std::vector<uint32_t>().swap(pointRows);
+  std::vector<uint32_t>().swap(testRows);
+  std::vector<int32_t>().swap(distances);
+  std::vector<uint8_t>().swap(statuses);
+  std::vector<int32_t>().swap(exitStatuses);
+  std::vector<int64_t>().swap(runningTimes);
+  std::vector<uint32_t>().swap(outputRows);
+  memory.release();
+  return true;
+}
+
+const MutationResultTable::SpilledRow &
+MutationResultTable::spilledRow(size_t row, const Segment *&segment) const {
+  assert(row < spilledRows);
+  auto end = std::upper_bound(segmentEnds.begin(), segmentEnds.end(), row);
+  size_t index = end - segmentEnds.begin();
+  size_t first = index == 0 ? 0 : segmentEnds[index - 1];
+  segment = segments[index].get();
+  return segment->row(row - first);
+}
+
+void MutationResultTable::append(MutationResultTable &other) {
+  if (other.empty()) {
+    return;
+  }
+
+  /// The spilled rows come first, so the rows in memory go to a segment of
+  /// their own before the segments of the other table
+  if (other.spilledRows != 0 && spill()) {
+    for (size_t index = 0; index < other.segments.size(); index++) {
+      segments.push_back(other.segments[index]);
+      segmentEnds.push_back(spilledRows + other.segmentEnds[index]);
+    }
+    spilledRows += other.spilledRows;
+  } else {
+    for (size_t row = 0; row < other.spilledRows; row++) {
+      add(other[row]);
+    }
+  }
+
+  uint32_t pointOffset = points.size();
+  points.insert(points.end(), other.points.begin(), other.points.end());
+  for (auto pointRow : other.pointRows) {
+    pointRows.push_back(pointOffset + pointRow);
+  }
+
+  std::vector<uint32_t> testIndexOf;
+  testIndexOf.reserve(other.tests.size());
+  for (auto test : other.tests) {
+    testIndexOf.push_back(indexOfTest(test));
+  }
+  for (auto testRow : other.testRows) {
+    testRows.push_back(testIndexOf[testRow]);
+  }
+
+  uint32_t outputOffset = outputs.size();
+  outputs.insert(outputs.end(), std::make_move_iterator(other.outputs.begin()),
+                 std::make_move_iterator(other.outputs.end()));
+  for (auto outputRow : other.outputRows) {
+    outputRows.push_back(outputRow == 0 ? 0 : outputOffset + outputRow);
+  }
+
+  distances.insert(distances.end(), other.distances.begin(),
+                   other.distances.end());
+  statuses.insert(statuses.end(), other.statuses.begin(),
+                  other.statuses.end());
+  exitStatuses.insert(exitStatuses.end(), other.exitStatuses.begin(),
+                      other.exitStatuses.end());
+  runningTimes.insert(runningTimes.end(), other.runningTimes.begin(),
+                      other.runningTimes.end());
+
+  memory.add(other.memory.get());
+  other = MutationResultTable();
+  spillIfOverBudget();
+}
+
+void MutationResultTable::reserve(size_t rows) {
+  pointRows.reserve(rows);
+  testRows.reserve(rows);
+  distances.reserve(rows);
+  statuses.reserve(rows);
+  exitStatuses.reserve(rows);
+  runningTimes.reserve(rows);
+  outputRows.reserve(rows);
+}
+
+template <typename T>
+static void reorderColumn(std::vector<T> &column,
+                          const std::vector<size_t> &order) {
+  std::vector<T> reordered;
+  reordered.reserve(column.size());
+  for (auto row : order) {
+    reordered.push_back(column[row]);
+  }
+  column.swap(reordered);
+}
+
+void MutationResultTable::reorder(const std::vector<size_t> &order) {
+  assert(order.size() == size());
+  if (spilledRows != 0) {
+    /// The rows are read back in the new order and spill again as they go
+    MutationResultTable reordered;
+    for (auto row : order) {
+      reordered.add((*this)[row]);
+    }
+    *this = std::move(reordered);
+    return;
+  }
+  reorderColumn(pointRows, order);
+  reorderColumn(testRows, order);
+  reorderColumn(distances, order);
+  reorderColumn(statuses, order);
+  reorderColumn(exitStatuses, order);
+  reorderColumn(runningTimes, order);
+  reorderColumn(outputRows, order);
+}
+
+void MutationResultTable::restoreMutantsOrder(
+    const std::vector<MutationPoint *> &points) {
+  std::unordered_map<const MutationPoint *, size_t> indices;
+  indices.reserve(points.size());
+  for (size_t index = 0; index < points.size(); index++) {
+    indices[points[index]] = index;
+  }
+
+  std::vector<size_t> order(size());
+  for (size_t row = 0; row < order.size(); row++) {
+    order[row] = row;
+  }
+  std::stable_sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+    return indices[getMutationPoint(lhs)] < indices[getMutationPoint(rhs)];
+  });
+  reorder(order);
+}
+
+MutationPoint *MutationResultTable::getMutationPoint(size_t row) const {
+  if (row < spilledRows) {
+    const Segment *segment = nullptr;
+    return spilledRow(row, segment).point;
+  }
+  return points[pointRows[row - spilledRows]];
+}
+
+Test *MutationResultTable::getTest(size_t row) const {
+  if (row < spilledRows) {
+    const Segment *segment = nullptr;
+    return spilledRow(row, segment).test;
+  }
+  return tests[testRows[row - spilledRows]];
+}
+
+int MutationResultTable::getMutationDistance(size_t row) const {
+  if (row < spilledRows) {
+    const Segment *segment = nullptr;
+    return spilledRow(row, segment).distance;
+  }
+  return distances[row - spilledRows];
+}
+
+ExecutionStatus MutationResultTable::getStatus(size_t row) const {
+  if (row < spilledRows) {
+    const Segment *segment = nullptr;
+    return ExecutionStatus(spilledRow(row, segment).status);
+  }
+  return ExecutionStatus(statuses[row - spilledRows]);
+}
+
+ExecutionResult MutationResultTable::getExecutionResult(size_t row) const {
+  ExecutionResult result;
+  if (row < spilledRows) {
+    const Segment *segment = nullptr;
+    auto &spilled = spilledRow(row, segment);
+    result.status = ExecutionStatus(spilled.status);
+    result.exitStatus = spilled.exitStatus;
+    result.runningTime = spilled.runningTime;
+    if (spilled.stdoutSize != 0) {
+      result.stdoutOutput = segment->text(spilled.output, spilled.stdoutSize);
+    }
+    if (spilled.stderrSize != 0) {
+      result.stderrOutput = segment->text(
+          spilled.output + spilled.stdoutSize, spilled.stderrSize);
+    }
+    return result;
+  }
+
+  row -= spilledRows;
+  result.status = ExecutionStatus(statuses[row]);
+  result.exitStatus = exitStatuses[row];
+  result.runningTime = runningTimes[row];
+  if (outputRows[row] != 0) {
+    auto &output = outputs[outputRows[row] - 1];
+    result.stdoutOutput = output.first;
+    result.stderrOutput = output.second;
+  }
+  return result;
+}
+
+MutationResult MutationResultTable::operator[](size_t row) const {
+  return MutationResult(getExecutionResult(row), getMutationPoint(row),
+                        getMutationDistance(row), getTest(row));
+}
+
+void mull::appendStorages(MutationResultTable &out,
+                          std::vector<MutationResultTable> &storages) {
+  /// Only the rows in memory are copied, the segments are shared
+  size_t total = out.size() - out.getSpilledRows();
+  for (auto &storage : storages) {
+    total += storage.size() - storage.getSpilledRows();
+  }
+  out.reserve(total);
+  for (auto &storage : storages) {
+    out.append(storage);
+  }
+}
@@ -0,0 +1,160 @@
+#include "mull/MutationSearchCache.h"
+
+#include "mull/CacheFile.h"
+#include "mull/Hash.h"
+#include "mull/Logger.h"
+#include "mull/MullModule.h"
+
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/StringRef.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/raw_ostream.h>
+
+using namespace mull;
+
+static const char *const Header = "mull-mutations 1";
+
+MutationSearchCache::MutationSearchCache(const std::string &cacheDirectory,
+                                         const std::string &version)
+    : cacheDirectory(cacheDirectory), version(version), hits(0) {}
+
+void MutationSearchCache::setSearchKey(const std::string &key) {
+  std::lock_guard<std::mutex> guard(mutex);
+  if (key == searchKey) {
+    return;
+  }
+  saveEntries();
+  entries.clear();
+  searchKey = key;
+}
+
+MutationSearchCache::Entry &
+MutationSearchCache::entryOf(const MullModule &module) {
+  auto identifier = module.getUniqueIdentifier();
+  auto inserted = entries.insert(std::make_pair(identifier, Entry()));
+  Entry &entry = inserted.first->second;
+  if (!inserted.second) {
+    return entry;
+  }
+
+  entry.path = cacheDirectory + "/mutations/" +
+               hashOf(version + '\0' + searchKey + '\0' + identifier,
+                      HashAlgorithm::MD5);
+  if (!read(entry)) {
+    entry.functions.clear();
+  }
+  return entry;
+}
+
+bool MutationSearchCache::lookup(const MullModule &module,
+                                 const std::string &function,
+                                 FunctionPoints &points) {
+  if (cacheDirectory.empty()) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> guard(mutex);
+  auto &functions = entryOf(module).functions;
+  auto found = functions.find(function);
+  if (found == functions.end()) {
+    return false;
+  }
+  points = found->second;
+  hits++;
+  return true;
+}
+
+void MutationSearchCache::store(const MullModule &module,
+                                const std::string &function,
+                                FunctionPoints points) {
+  if (cacheDirectory.empty()) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> guard(mutex);
+  auto &entry = entryOf(module);
+  entry.functions[function] = std::move(points);
+  entry.changed = true;
+}
+
+/// The format is line based, the points following a function belong to it:
+///
+///     mull-mutations 1
+///     function <dead values> <dead stores> <function name>
+///     point <mutator> <basic block> <instruction>
+bool MutationSearchCache::read(Entry &entry) {
+  auto buffer = llvm::MemoryBuffer::getFile(entry.path);
+  if (!buffer) {
+    return false;
+  }
+
+  llvm::SmallVector<llvm::StringRef, 64> lines;
+  buffer.get()->getBuffer().split(lines, '\n', -1, false);
+  if (lines.empty() || lines.front() != Header) {
+    return false;
+  }
+
+  FunctionPoints *function = nullptr;
+  for (auto &line : llvm::makeArrayRef(lines).drop_front()) {
+    auto kindAndRest = line.split(' ');
+    auto first = kindAndRest.second.split(' ');
+    auto second = first.second.split(' ');
+    if (kindAndRest.first == "function") {
+      FunctionPoints points;
+      if (first.first.getAsInteger(10, points.deadValues) ||
+          second.first.getAsInteger(10, points.deadStores) ||
+          second.second.empty()) {
+        return false;
+      }
+      function = &entry.functions[second.second.str()];
+      *function = std::move(points);
+    } else if (kindAndRest.first == "point" && function != nullptr) {
+      Point point;
+      if (first.first.getAsInteger(10, point.mutator) ||
+          second.first.getAsInteger(10, point.basicBlock) ||
+          second.second.getAsInteger(10, point.instruction)) {
+        return false;
+      }
+      function->points.push_back(point);
+    } else {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void MutationSearchCache::save() {
+  std::lock_guard<std::mutex> guard(mutex);
+  saveEntries();
+}
+
+void MutationSearchCache::saveEntries() {
+  for (auto &pair : entries) {
+    if (pair.second.changed) {
+      write(pair.second);
+      pair.second.changed = false;
+    }
+  }
+}
+
+void MutationSearchCache::write(const Entry &entry) {
+  auto error = writeCacheFile(entry.path, [&](llvm::raw_ostream &outfile) {
+    outfile << Header << "\n";
+    for (auto &function : entry.functions) {
+      auto &points = function.second;
+      outfile << "function " << points.deadValues << " " << points.deadStores
+              << " " << function.first << "\n";
+      for (auto &point : points.points) {
+        outfile << "point " << point.mutator << " " << point.basicBlock << " "
+                << point.instruction << "\n";
+      }
+    }
+  });
+  if (error) {
+    Logger::error() << "Cannot write mutation search cache file '"
+                    << entry.path << "': " << error.message() << "\n";
+  }
+}
+
+uint64_t MutationSearchCache::getHits() const { return hits; }
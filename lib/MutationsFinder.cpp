@@ -1,35 +1,91 @@
 #include "mull/MutationsFinder.h"
 
 #include "mull/Config/Configuration.h"
+#include "mull/Filter.h"
+#include "mull/MullModule.h"
 #include "mull/Parallelization/Parallelization.h"
 #include "mull/Program/Program.h"
 #include "mull/Testee.h"
 
+#include <unordered_map>
+
 using namespace mull;
 using namespace llvm;
 
+/// Bumped whenever the search finds other points in the same functions
+static const char *const MutationSearchCacheVersion = "search-1";
+
 MutationsFinder::MutationsFinder(std::vector<std::unique_ptr<Mutator>> mutators,
                                  const Configuration &config)
-    : mutators(std::move(mutators)), config(config) {}
+    : mutators(std::move(mutators)), blockCoverage(nullptr), config(config) {
+  if (config.mutationSearchCacheEnabled && config.cacheEnabled) {
+    cache = make_unique<MutationSearchCache>(config.cacheDirectory,
+                                             MutationSearchCacheVersion);
+  }
+}
+
+/// The mutators are identified by their positions in the stored points
+std::string MutationsFinder::searchKey(const Filter &filter) const {
+  std::string key = filter.getInstructionPatterns();
+  key += config.equivalentMutantPruningEnabled ? "\0pruned" : "\0all";
+  for (auto &mutator : mutators) {
+    key += '\0' + mutator->getUniqueIdentifier();
+  }
+  return key;
+}
+
+uint64_t MutationsFinder::getCachedFunctions() const {
+  return cache ? cache->getHits() : 0;
+}
 
 std::vector<MutationPoint *>
 MutationsFinder::getMutationPoints(const Program &program,
                                    std::vector<MergedTestee> &testees,
-                                   Filter &filter) {
+                                   Filter &filter,
+                                   MutationPointStream *stream) {
+  /// A count per task, the tasks run concurrently
+  std::vector<DeadMutantMetrics> taskDeadMutants(
+      config.parallelization.workers);
+  if (cache) {
+    cache->setSearchKey(searchKey(filter));
+  }
   std::vector<SearchMutationPointsTask> tasks;
   tasks.reserve(config.parallelization.workers);
   for (int i = 0; i < config.parallelization.workers; i++) {
-    tasks.emplace_back(filter, program, mutators);
+    tasks.emplace_back(filter, program, mutators, stream,
+                       config.equivalentMutantPruningEnabled
+                           ? &taskDeadMutants[i]
+                           : nullptr,
+                       blockCoverage, cache.get());
   }
 
+  const size_t firstFound = foundPoints.size();
   TaskExecutor<SearchMutationPointsTask> finder(
-      "Searching mutants across functions", testees, ownedPoints, tasks);
+      "Searching mutants across functions", testees, foundPoints, tasks);
   finder.execute();
+  if (cache) {
+    cache->save();
+  }
+
+  /// The workers do not take the lock of a module for every point they
+  /// find, the modules get their points once the search is over. The points
+  /// of a function all come from one worker and keep their order.
+  std::unordered_map<MullModule *,
+                     std::map<Function *, std::vector<MutationPoint *>>>
+      modulePoints;
+  for (size_t index = firstFound; index < foundPoints.size(); index++) {
+    auto point = foundPoints[index];
+    modulePoints[point->getOriginalModule()][point->getOriginalFunction()]
+        .push_back(point);
+  }
+  for (auto &pair : modulePoints) {
+    pair.first->addMutations(pair.second);
+  }
 
-  std::vector<MutationPoint *> mutationPoints;
-  for (auto &point : ownedPoints) {
-    mutationPoints.push_back(point.get());
+  for (auto &taskMetrics : taskDeadMutants) {
+    deadMutants.deadValues += taskMetrics.deadValues;
+    deadMutants.deadStores += taskMetrics.deadStores;
   }
 
-  return mutationPoints;
+  return foundPoints;
 }
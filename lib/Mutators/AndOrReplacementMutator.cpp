@@ -1,6 +1,7 @@
 #include "mull/Mutators/AndOrReplacementMutator.h"
 
 #include "mull/Logger.h"
+#include "mull/MullModule.h"
 #include "mull/MutationPoint.h"
 #include "mull/SourceLocation.h"
 
@@ -11,8 +12,10 @@
 #include <llvm/IR/Instructions.h>
 #include <llvm/IR/Module.h>
 
+#include <algorithm>
 #include <fstream>
 #include <iterator>
+#include <limits>
 
 using namespace llvm;
 using namespace mull;
@@ -21,16 +24,40 @@ const std::string AndOrReplacementMutator::ID = "and_or_replacement_mutator";
 const std::string AndOrReplacementMutator::description =
     "Replaces && with ||, || with &&";
 
+/// TODO: Discuss how to filter out irrelevant branch instructions.
+static bool isInLibCxx(const SourceLocation &location) {
+  return !location.isNull() &&
+         location.filePath().find("include/c++/v1") != std::string::npos;
+}
+
 MutationPoint *AndOrReplacementMutator::getMutationPoint(
     MullModule *module, llvm::Function *function,
     llvm::Instruction *instruction, SourceLocation &sourceLocation,
     MutationPointAddress &address) {
-  if (canBeApplied(*instruction)) {
-    std::string diagnostics = "AND-OR Replacement";
-    return new MutationPoint(this, address, instruction, function, diagnostics,
-                             sourceLocation, module);
+  BranchInst *branchInst = dyn_cast<BranchInst>(instruction);
+  if (branchInst == nullptr || branchInst->isConditional() == false ||
+      isInLibCxx(sourceLocation)) {
+    return nullptr;
   }
-  return nullptr;
+
+  /// The search hands over the instructions of a function in a row, and a
+  /// mutator is shared by the threads of the search
+  static thread_local BranchIndex index;
+  if (index.function != static_cast<Value *>(function) ||
+      index.positions.find(branchInst) == index.positions.end()) {
+    index.build(function);
+  }
+  if (index.find(branchInst, nullptr) == AND_OR_MutationType_None) {
+    return nullptr;
+  }
+
+  std::string diagnostics = "AND-OR Replacement";
+  return module->createMutationPoint(this, address, instruction, function,
+                                     diagnostics, sourceLocation);
+}
+
+std::vector<unsigned> AndOrReplacementMutator::getOpcodes() const {
+  return {Instruction::Br};
 }
 
 bool AndOrReplacementMutator::canBeApplied(Value &V) {
@@ -44,13 +71,10 @@ bool AndOrReplacementMutator::canBeApplied(Value &V) {
     return false;
   }
 
-  /// TODO: Discuss how to filter out irrelevant branch instructions.
   SourceLocation location =
       SourceLocation::sourceLocationFromInstruction(branchInst);
-  if (!location.isNull()) {
-    if (location.filePath.find("include/c++/v1") != std::string::npos) {
-      return false;
-    }
+  if (isInLibCxx(location)) {
+    return false;
   }
 
   BranchInst *secondBranch = nullptr;
@@ -503,6 +527,57 @@ llvm::Value *AndOrReplacementMutator::applyMutationORToAND_Pattern3(
 
 #pragma mark - Private: Finding possible mutations
 
+/// How the candidate, a conditional branch that comes after the branch,
+/// completes a pattern of && or || with it
+static AND_OR_MutationType matchPattern(BranchInst *branchInst,
+                                        BranchInst *candidateBranchInst) {
+  BasicBlock *leftBB = dyn_cast<BasicBlock>(branchInst->getOperand(2));
+  BasicBlock *rightBB = dyn_cast<BasicBlock>(branchInst->getOperand(1));
+
+  auto candidateBranchInst_leftBB = candidateBranchInst->getOperand(2);
+  auto candidateBranchInst_rightBB = candidateBranchInst->getOperand(1);
+
+  if (candidateBranchInst_rightBB == rightBB) {
+    return AND_OR_MutationType_AND_to_OR_Pattern1;
+  }
+
+  else if (candidateBranchInst_leftBB == leftBB) {
+    return AND_OR_MutationType_OR_to_AND_Pattern1;
+  }
+
+  else if (candidateBranchInst_leftBB == rightBB) {
+    return AND_OR_MutationType_OR_to_AND_Pattern2;
+  }
+
+  else if (candidateBranchInst_rightBB == leftBB) {
+    return AND_OR_MutationType_AND_to_OR_Pattern2;
+  }
+
+  for (auto &instruction : *candidateBranchInst->getParent()) {
+    PHINode *phiNode = dyn_cast<PHINode>(&instruction);
+
+    if (phiNode == nullptr) {
+      continue;
+    }
+
+    for (BasicBlock *phiNodeIncomingBB : phiNode->blocks()) {
+      if (phiNodeIncomingBB == branchInst->getParent()) {
+        continue;
+      }
+
+      if (candidateBranchInst->getParent() == leftBB) {
+        return AND_OR_MutationType_OR_to_AND_Pattern3;
+      }
+
+      if (candidateBranchInst->getParent() == rightBB) {
+        return AND_OR_MutationType_AND_to_OR_Pattern3;
+      }
+    }
+  }
+
+  return AND_OR_MutationType_None;
+}
+
 AND_OR_MutationType AndOrReplacementMutator::findPossibleMutationInBranch(
     BranchInst *branchInst, BranchInst **secondBranchInst) {
 
@@ -510,9 +585,6 @@ AND_OR_MutationType AndOrReplacementMutator::findPossibleMutationInBranch(
     return AND_OR_MutationType_None;
   }
 
-  BasicBlock *leftBB = dyn_cast<BasicBlock>(branchInst->getOperand(2));
-  BasicBlock *rightBB = dyn_cast<BasicBlock>(branchInst->getOperand(1));
-
   bool passedBranchInst = false;
   for (BasicBlock &bb : *branchInst->getFunction()) {
     for (Instruction &instruction : bb) {
@@ -532,72 +604,97 @@ AND_OR_MutationType AndOrReplacementMutator::findPossibleMutationInBranch(
         continue;
       }
 
-      auto candidateBranchInst_leftBB = candidateBranchInst->getOperand(2);
-      auto candidateBranchInst_rightBB = candidateBranchInst->getOperand(1);
-
-      if (candidateBranchInst_rightBB == rightBB) {
+      AND_OR_MutationType mutationType =
+          matchPattern(branchInst, candidateBranchInst);
+      if (mutationType != AND_OR_MutationType_None) {
         if (secondBranchInst) {
           *secondBranchInst = candidateBranchInst;
         }
-
-        return AND_OR_MutationType_AND_to_OR_Pattern1;
+        return mutationType;
       }
+    }
+  }
 
-      else if (candidateBranchInst_leftBB == leftBB) {
-        if (secondBranchInst) {
-          *secondBranchInst = candidateBranchInst;
-        }
-
-        return AND_OR_MutationType_OR_to_AND_Pattern1;
-      }
-
-      else if (candidateBranchInst_leftBB == rightBB) {
-        if (secondBranchInst) {
-          *secondBranchInst = candidateBranchInst;
-        }
-
-        return AND_OR_MutationType_OR_to_AND_Pattern2;
-      }
-
-      else if (candidateBranchInst_rightBB == leftBB) {
-        if (secondBranchInst) {
-          *secondBranchInst = candidateBranchInst;
-        }
-
-        return AND_OR_MutationType_AND_to_OR_Pattern2;
-      }
-
-      for (auto &instruction : *candidateBranchInst->getParent()) {
-        PHINode *phiNode = dyn_cast<PHINode>(&instruction);
-
-        if (phiNode == nullptr) {
-          continue;
-        }
+  return AND_OR_MutationType_None;
+}
 
-        for (BasicBlock *phiNodeIncomingBB : phiNode->blocks()) {
-          if (phiNodeIncomingBB == branchInst->getParent()) {
-            continue;
-          }
+void AndOrReplacementMutator::BranchIndex::build(Function *function) {
+  this->function = function;
+  branches.clear();
+  positions.clear();
+  byLeft.clear();
+  byRight.clear();
 
-          if (candidateBranchInst->getParent() == leftBB) {
-            if (secondBranchInst) {
-              *secondBranchInst = candidateBranchInst;
-            }
+  for (BasicBlock &bb : *function) {
+    BranchInst *branchInst = dyn_cast_or_null<BranchInst>(bb.getTerminator());
+    if (branchInst == nullptr || branchInst->isConditional() == false) {
+      continue;
+    }
+    size_t position = branches.size();
+    branches.push_back(branchInst);
+    positions[branchInst] = position;
+    byLeft[branchInst->getOperand(2)].push_back(position);
+    byRight[branchInst->getOperand(1)].push_back(position);
+  }
+}
 
-            return AND_OR_MutationType_OR_to_AND_Pattern3;
-          }
+/// The first of the positions, which are sorted, that comes after the given
+/// one, or `after` when there is none
+static size_t firstAfter(const std::vector<size_t> *positions, size_t after) {
+  if (positions == nullptr) {
+    return after;
+  }
+  auto next = std::upper_bound(positions->begin(), positions->end(), after);
+  return next == positions->end() ? after : *next;
+}
 
-          if (candidateBranchInst->getParent() == rightBB) {
-            if (secondBranchInst) {
-              *secondBranchInst = candidateBranchInst;
-            }
+AND_OR_MutationType
+AndOrReplacementMutator::BranchIndex::find(BranchInst *branchInst,
+                                           BranchInst **secondBranchInst) {
+  auto position = positions.find(branchInst);
+  if (position == positions.end()) {
+    return AND_OR_MutationType_None;
+  }
+  const size_t after = position->second;
+  Value *leftBB = branchInst->getOperand(2);
+  Value *rightBB = branchInst->getOperand(1);
+
+  auto lookup = [](DenseMap<Value *, std::vector<size_t>> &index,
+                   Value *block) -> const std::vector<size_t> * {
+    auto positions = index.find(block);
+    return positions == index.end() ? nullptr : &positions->second;
+  };
+
+  /// The candidates that share a successor with the branch
+  size_t first = std::numeric_limits<size_t>::max();
+  for (size_t next : {firstAfter(lookup(byRight, rightBB), after),
+                      firstAfter(lookup(byLeft, leftBB), after),
+                      firstAfter(lookup(byLeft, rightBB), after),
+                      firstAfter(lookup(byRight, leftBB), after)}) {
+    if (next != after) {
+      first = std::min(first, next);
+    }
+  }
 
-            return AND_OR_MutationType_AND_to_OR_Pattern3;
-          }
-        }
-      }
+  /// The candidates that end a successor of the branch and join other
+  /// blocks in a PHI
+  for (Value *successor : {leftBB, rightBB}) {
+    auto block = cast<BasicBlock>(successor);
+    auto terminator = positions.find(
+        dyn_cast_or_null<BranchInst>(block->getTerminator()));
+    if (terminator != positions.end() && terminator->second > after &&
+        terminator->second < first &&
+        matchPattern(branchInst, branches[terminator->second]) !=
+            AND_OR_MutationType_None) {
+      first = terminator->second;
     }
   }
 
-  return AND_OR_MutationType_None;
+  if (first == std::numeric_limits<size_t>::max()) {
+    return AND_OR_MutationType_None;
+  }
+  if (secondBranchInst) {
+    *secondBranchInst = branches[first];
+  }
+  return matchPattern(branchInst, branches[first]);
 }
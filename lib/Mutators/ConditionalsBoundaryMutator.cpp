@@ -1,11 +1,13 @@
 #include "mull/Mutators/ConditionalsBoundaryMutator.h"
 
 #include "mull/Logger.h"
+#include "mull/MullModule.h"
 #include "mull/MutationPoint.h"
 
 #include <llvm/IR/DebugInfoMetadata.h>
 #include <llvm/IR/DebugLoc.h>
 #include <llvm/IR/InstIterator.h>
+#include <llvm/IR/Instruction.h>
 #include <llvm/IR/Module.h>
 
 #include <fstream>
@@ -251,8 +253,12 @@ MutationPoint *ConditionalsBoundaryMutator::getMutationPoint(
   std::string diagnostics =
       getDiagnostics(originalPredicate, mutatedPredicate.getValue());
 
-  return new MutationPoint(this, address, instruction, function, diagnostics,
-                           sourceLocation, module);
+  return module->createMutationPoint(this, address, instruction, function,
+                                     diagnostics, sourceLocation);
+}
+
+std::vector<unsigned> ConditionalsBoundaryMutator::getOpcodes() const {
+  return {Instruction::ICmp, Instruction::FCmp};
 }
 
 bool ConditionalsBoundaryMutator::canBeApplied(Value &V) {
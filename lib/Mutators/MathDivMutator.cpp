@@ -1,6 +1,7 @@
 #include "mull/Mutators/MathDivMutator.h"
 
 #include "mull/Logger.h"
+#include "mull/MullModule.h"
 #include "mull/MutationPoint.h"
 
 #include <llvm/IR/DebugInfoMetadata.h>
@@ -25,13 +26,17 @@ MutationPoint *MathDivMutator::getMutationPoint(MullModule *module,
                                                 MutationPointAddress &address) {
   if (canBeApplied(*instruction)) {
     std::string diagnostics = "Math Div: replaced / with *";
-    return new MutationPoint(this, address, instruction, function, diagnostics,
-                             sourceLocation, module);
+    return module->createMutationPoint(this, address, instruction, function,
+                                       diagnostics, sourceLocation);
   }
 
   return nullptr;
 }
 
+std::vector<unsigned> MathDivMutator::getOpcodes() const {
+  return {Instruction::UDiv, Instruction::SDiv, Instruction::FDiv};
+}
+
 bool MathDivMutator::canBeApplied(Value &V) {
   if (BinaryOperator *BinOp = dyn_cast<BinaryOperator>(&V)) {
     BinaryOperator::BinaryOps Opcode = BinOp->getOpcode();
@@ -1,6 +1,7 @@
 #include "mull/Mutators/MathMulMutator.h"
 
 #include "mull/Logger.h"
+#include "mull/MullModule.h"
 #include "mull/MutationPoint.h"
 
 #include <llvm/IR/DebugInfoMetadata.h>
@@ -26,12 +27,16 @@ MutationPoint *MathMulMutator::getMutationPoint(MullModule *module,
                                                 MutationPointAddress &address) {
   if (canBeApplied(*instruction)) {
     std::string diagnostics = "Math Mul: replaced * with /";
-    return new MutationPoint(this, address, instruction, function, diagnostics,
-                             sourceLocation, module);
+    return module->createMutationPoint(this, address, instruction, function,
+                                       diagnostics, sourceLocation);
   }
   return nullptr;
 }
 
+std::vector<unsigned> MathMulMutator::getOpcodes() const {
+  return {Instruction::Mul, Instruction::FMul};
+}
+
 bool MathMulMutator::canBeApplied(Value &V) {
   if (BinaryOperator *BinOp = dyn_cast<BinaryOperator>(&V)) {
     BinaryOperator::BinaryOps Opcode = BinOp->getOpcode();
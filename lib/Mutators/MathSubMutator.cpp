@@ -1,12 +1,14 @@
 #include "mull/Mutators/MathSubMutator.h"
 
 #include "mull/Logger.h"
+#include "mull/MullModule.h"
 #include "mull/MutationPoint.h"
 
 #include <llvm/IR/DebugInfoMetadata.h>
 #include <llvm/IR/DebugLoc.h>
 #include <llvm/IR/InstIterator.h>
 #include <llvm/IR/Instructions.h>
+#include <llvm/IR/Intrinsics.h>
 #include <llvm/IR/Module.h>
 
 #include <fstream>
@@ -18,6 +20,22 @@ using namespace mull;
 const std::string MathSubMutator::ID = "math_sub_mutator";
 const std::string MathSubMutator::description = "Replaces - with +";
 
+/// The intrinsics with overflow and what replaces them, the type of
+/// the operands stays the same
+static const std::pair<Intrinsic::ID, Intrinsic::ID> subWithOverflow[] = {
+    {Intrinsic::ssub_with_overflow, Intrinsic::sadd_with_overflow},
+    {Intrinsic::usub_with_overflow, Intrinsic::uadd_with_overflow},
+};
+
+static Intrinsic::ID replacementIntrinsic(Intrinsic::ID original) {
+  for (auto &replacement : subWithOverflow) {
+    if (replacement.first == original) {
+      return replacement.second;
+    }
+  }
+  return Intrinsic::not_intrinsic;
+}
+
 bool MathSubMutator::isSubWithOverflow(llvm::Value &V) {
   if (CallInst *callInst = dyn_cast<CallInst>(&V)) {
     Function *calledFunction = callInst->getCalledFunction();
@@ -26,79 +44,21 @@ bool MathSubMutator::isSubWithOverflow(llvm::Value &V) {
       return false;
     }
 
-    if (calledFunction->getName().startswith("llvm.ssub") ||
-        calledFunction->getName().startswith("llvm.usub")) {
-      return true;
-    }
+    return replacementIntrinsic(calledFunction->getIntrinsicID()) !=
+           Intrinsic::not_intrinsic;
   }
 
   return false;
 }
 
+/// The module declares an intrinsic once, getDeclaration reuses it
 llvm::Function *
 MathSubMutator::replacementForSubWithOverflow(llvm::Function *testeeFunction,
                                               llvm::Module &module) {
-
-  std::string name = testeeFunction->getName().str();
-
-  std::string replacementName = "";
-  Type *replacementType = nullptr;
-
-  if (name == "llvm.ssub.with.overflow.i8") {
-    replacementName = "llvm.sadd.with.overflow.i8";
-    replacementType = Type::getInt8Ty(module.getContext());
-  }
-
-  else if (name == "llvm.ssub.with.overflow.i16") {
-    replacementName = "llvm.sadd.with.overflow.i16";
-    replacementType = Type::getInt16Ty(module.getContext());
-  }
-
-  else if (name == "llvm.ssub.with.overflow.i32") {
-    replacementName = "llvm.sadd.with.overflow.i32";
-    replacementType = Type::getInt32Ty(module.getContext());
-  }
-
-  else if (name == "llvm.ssub.with.overflow.i64") {
-    replacementName = "llvm.sadd.with.overflow.i64";
-    replacementType = Type::getInt64Ty(module.getContext());
-  }
-
-  else if (name == "llvm.usub.with.overflow.i8") {
-    replacementName = "llvm.uadd.with.overflow.i8";
-    replacementType = Type::getInt8Ty(module.getContext());
-  }
-
-  else if (name == "llvm.usub.with.overflow.i16") {
-    replacementName = "llvm.uadd.with.overflow.i16";
-    replacementType = Type::getInt16Ty(module.getContext());
-  }
-
-  else if (name == "llvm.usub.with.overflow.i32") {
-    replacementName = "llvm.uadd.with.overflow.i32";
-    replacementType = Type::getInt32Ty(module.getContext());
-  }
-
-  else if (name == "llvm.usub.with.overflow.i64") {
-    replacementName = "llvm.uadd.with.overflow.i64";
-    replacementType = Type::getInt64Ty(module.getContext());
-  }
-
-  else {
-    Logger::debug() << "MathSubMutator> unknown add function: " << name
-                    << ".\n";
-  }
-
-  std::vector<Type *> twoParameters(2, replacementType);
-
-  FunctionType *replacementFunctionType =
-      FunctionType::get(replacementType, twoParameters, false);
-
-  Function *replacementFunction =
-      Function::Create(replacementFunctionType, Function::ExternalLinkage,
-                       replacementName, &module);
-
-  return replacementFunction;
+  auto replacement = replacementIntrinsic(testeeFunction->getIntrinsicID());
+  assert(replacement != Intrinsic::not_intrinsic);
+  Type *operandType = testeeFunction->getFunctionType()->getParamType(0);
+  return Intrinsic::getDeclaration(&module, replacement, {operandType});
 }
 
 MutationPoint *MathSubMutator::getMutationPoint(MullModule *module,
@@ -108,12 +68,16 @@ MutationPoint *MathSubMutator::getMutationPoint(MullModule *module,
                                                 MutationPointAddress &address) {
   if (canBeApplied(*instruction)) {
     std::string diagnostics = "Math Sub: replaced - with +";
-    return new MutationPoint(this, address, instruction, function, diagnostics,
-                             sourceLocation, module);
+    return module->createMutationPoint(this, address, instruction, function,
+                                       diagnostics, sourceLocation);
   }
   return nullptr;
 }
 
+std::vector<unsigned> MathSubMutator::getOpcodes() const {
+  return {Instruction::Sub, Instruction::FSub, Instruction::Call};
+}
+
 bool MathSubMutator::canBeApplied(Value &V) {
   if (BinaryOperator *BinOp = dyn_cast<BinaryOperator>(&V)) {
     BinaryOperator::BinaryOps Opcode = BinOp->getOpcode();
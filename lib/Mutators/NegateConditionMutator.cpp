@@ -1,11 +1,13 @@
 #include "mull/Mutators/NegateConditionMutator.h"
 
 #include "mull/Logger.h"
+#include "mull/MullModule.h"
 #include "mull/MutationPoint.h"
 
 #include <llvm/IR/DebugInfoMetadata.h>
 #include <llvm/IR/DebugLoc.h>
 #include <llvm/IR/InstIterator.h>
+#include <llvm/IR/Instruction.h>
 #include <llvm/IR/Module.h>
 
 #include <fstream>
@@ -289,12 +291,16 @@ MutationPoint *NegateConditionMutator::getMutationPoint(
     std::string diagnostics = getDiagnostics(
         cmpOp->getPredicate(), negatedCmpInstPredicate(cmpOp->getPredicate()));
 
-    return new MutationPoint(this, address, instruction, function, diagnostics,
-                             sourceLocation, module);
+    return module->createMutationPoint(this, address, instruction, function,
+                                       diagnostics, sourceLocation);
   }
   return nullptr;
 }
 
+std::vector<unsigned> NegateConditionMutator::getOpcodes() const {
+  return {Instruction::ICmp, Instruction::FCmp};
+}
+
 bool NegateConditionMutator::canBeApplied(Value &V) {
 
   if (CmpInst *cmpOp = dyn_cast<CmpInst>(&V)) {
@@ -1,11 +1,13 @@
 #include "mull/Mutators/RemoveVoidFunctionMutator.h"
 
+#include "mull/MullModule.h"
 #include "mull/MutationPoint.h"
 
 #include <llvm/IR/CallSite.h>
 #include <llvm/IR/DebugInfoMetadata.h>
 #include <llvm/IR/DebugLoc.h>
 #include <llvm/IR/InstIterator.h>
+#include <llvm/IR/Instruction.h>
 #include <llvm/IR/Module.h>
 
 #include <fstream>
@@ -41,13 +43,17 @@ MutationPoint *RemoveVoidFunctionMutator::getMutationPoint(
     MutationPointAddress &address) {
   if (canBeApplied(*instruction)) {
     std::string diagnostics = getDiagnostics(*instruction);
-    return new MutationPoint(this, address, instruction, function, diagnostics,
-                             sourceLocation, module);
+    return module->createMutationPoint(this, address, instruction, function,
+                                       diagnostics, sourceLocation);
   }
 
   return nullptr;
 }
 
+std::vector<unsigned> RemoveVoidFunctionMutator::getOpcodes() const {
+  return {Instruction::Call};
+}
+
 bool RemoveVoidFunctionMutator::canBeApplied(Value &V) {
   if (CallInst *callInst = dyn_cast<CallInst>(&V)) {
 
@@ -1,6 +1,7 @@
 #include "mull/Mutators/ReplaceAssignmentMutator.h"
 
 #include "mull/Logger.h"
+#include "mull/MullModule.h"
 #include "mull/MutationPoint.h"
 
 #include <llvm/IR/CallSite.h>
@@ -24,6 +25,10 @@ static bool findPossibleApplication(Value &V, std::string &outDiagnostics);
 static llvm::Value *getReplacement(Type *returnType,
                                    llvm::LLVMContext &context);
 
+std::vector<unsigned> ReplaceAssignmentMutator::getOpcodes() const {
+  return {Instruction::Store};
+}
+
 bool ReplaceAssignmentMutator::canBeApplied(Value &V) {
   std::string diagnostics;
 
@@ -69,8 +74,8 @@ MutationPoint *ReplaceAssignmentMutator::getMutationPoint(
     return nullptr;
   }
 
-  auto mutationPoint = new MutationPoint(this, address, instruction, function,
-                                         diagnostics, sourceLocation, module);
+  auto mutationPoint = module->createMutationPoint(
+      this, address, instruction, function, diagnostics, sourceLocation);
 
   return mutationPoint;
 }
@@ -1,6 +1,7 @@
 #include "mull/Mutators/ReplaceCallMutator.h"
 
 #include "mull/Logger.h"
+#include "mull/MullModule.h"
 #include "mull/MutationPoint.h"
 
 #include <llvm/IR/CallSite.h>
@@ -22,6 +23,10 @@ const std::string ReplaceCallMutator::description =
 
 static bool findPossibleApplication(Value &V, std::string &outDiagnostics);
 
+std::vector<unsigned> ReplaceCallMutator::getOpcodes() const {
+  return {Instruction::Call, Instruction::Invoke};
+}
+
 bool ReplaceCallMutator::canBeApplied(Value &V) {
   std::string diagnostics;
 
@@ -80,8 +85,8 @@ MutationPoint *ReplaceCallMutator::getMutationPoint(
     return nullptr;
   }
 
-  auto mutationPoint = new MutationPoint(this, address, instruction, function,
-                                         diagnostics, sourceLocation, module);
+  auto mutationPoint = module->createMutationPoint(
+      this, address, instruction, function, diagnostics, sourceLocation);
 
   return mutationPoint;
 }
@@ -1,6 +1,7 @@
 #include "mull/Mutators/ScalarValueMutator.h"
 
 #include "mull/Logger.h"
+#include "mull/MullModule.h"
 #include "mull/MutationPoint.h"
 
 #include <llvm/IR/Constants.h>
@@ -43,8 +44,20 @@ MutationPoint *ScalarValueMutator::getMutationPoint(
     return nullptr;
   }
 
-  return new MutationPoint(this, address, instruction, function, diagnostics,
-                           sourceLocation, module);
+  return module->createMutationPoint(this, address, instruction, function,
+                                     diagnostics, sourceLocation);
+}
+
+std::vector<unsigned> ScalarValueMutator::getOpcodes() const {
+  std::vector<unsigned> opcodes;
+  for (unsigned opcode = Instruction::BinaryOpsBegin;
+       opcode < Instruction::BinaryOpsEnd; opcode++) {
+    opcodes.push_back(opcode);
+  }
+  opcodes.insert(opcodes.end(),
+                 {Instruction::Store, Instruction::FCmp, Instruction::ICmp,
+                  Instruction::Ret, Instruction::Call, Instruction::Invoke});
+  return opcodes;
 }
 
 /// Currently only used by SimpleTestFinder.
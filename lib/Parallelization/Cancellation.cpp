@@ -0,0 +1,87 @@
+#include "mull/Parallelization/Cancellation.h"
+
+#include <csignal>
+#include <unistd.h>
+
+using namespace mull;
+
+static pid_t signalsOwner = 0;
+static std::atomic<bool> signalled(false);
+
+static void cancelOnSignal(int signalNumber) {
+  /// A child forked off mull dies of the signal, as it would without mull
+  if (getpid() != signalsOwner || signalled.exchange(true)) {
+    signal(signalNumber, SIG_DFL);
+    raise(signalNumber);
+    return;
+  }
+  Cancellation::shared().cancel(Cancellation::Reason::Interrupted);
+}
+
+Cancellation::Cancellation()
+    : cancelReason(int(Reason::None)), deadline(0) {}
+
+Cancellation &Cancellation::shared() {
+  static Cancellation cancellation;
+  return cancellation;
+}
+
+void Cancellation::cancel(Reason reason) {
+  int none = int(Reason::None);
+  cancelReason.compare_exchange_strong(none, int(reason));
+}
+
+bool Cancellation::cancelled() {
+  if (cancelReason.load(std::memory_order_relaxed) != int(Reason::None)) {
+    return true;
+  }
+  auto until = deadline.load(std::memory_order_relaxed);
+  if (until != 0 && clock::now().time_since_epoch().count() >= until) {
+    cancel(Reason::Deadline);
+    return true;
+  }
+  return false;
+}
+
+Cancellation::Reason Cancellation::reason() const {
+  return Reason(cancelReason.load());
+}
+
+void Cancellation::setDeadline(int seconds) {
+  if (seconds <= 0) {
+    deadline = 0;
+    return;
+  }
+  auto until = clock::now() + std::chrono::seconds(seconds);
+  deadline = std::chrono::duration_cast<clock::duration>(
+                 until.time_since_epoch())
+                 .count();
+}
+
+void Cancellation::reset() {
+  cancelReason = int(Reason::None);
+  deadline = 0;
+}
+
+void Cancellation::installSignalHandlers() {
+  signalsOwner = getpid();
+  struct sigaction action {};
+  action.sa_handler = cancelOnSignal;
+  sigemptyset(&action.sa_mask);
+  sigaction(SIGINT, &action, nullptr);
+  sigaction(SIGTERM, &action, nullptr);
+}
+
+const char *Cancellation::reasonToString(Reason reason) {
+  switch (reason) {
+  case Reason::None:
+    return "not cancelled";
+  case Reason::Interrupted:
+    return "interrupted";
+  case Reason::Deadline:
+    return "the deadline has passed";
+  case Reason::Survivor:
+    return "a mutant survived";
+  }
+  return "cancelled";
+}
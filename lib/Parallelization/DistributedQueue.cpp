@@ -0,0 +1,308 @@
+#include "mull/Parallelization/DistributedQueue.h"
+
+#include "mull/Logger.h"
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/StringRef.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <chrono>
+#include <ctime>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+using namespace mull;
+
+static const char *const MutantsHeader = "mull-mutants 1";
+static const char *const ResultsHeader = "mull-results 1";
+
+static std::string nodeName() {
+  char hostname[256] = {0};
+  gethostname(hostname, sizeof(hostname) - 1);
+  return std::string(hostname) + ":" + std::to_string(getpid());
+}
+
+DistributedQueue::DistributedQueue(std::string directory,
+                                   long long leaseSeconds)
+    : directory(std::move(directory)), node(nodeName()),
+      leaseSeconds(leaseSeconds) {}
+
+std::string DistributedQueue::claimPath(size_t chunk) const {
+  return directory + "/claims/" + std::to_string(chunk);
+}
+
+std::string DistributedQueue::resultsPath(size_t chunk) const {
+  return directory + "/results/" + std::to_string(chunk);
+}
+
+void DistributedQueue::clear() {
+  llvm::sys::fs::remove(directory + "/mutants");
+  for (auto subdirectory : {"/claims", "/results"}) {
+    std::error_code error;
+    std::vector<std::string> files;
+    for (llvm::sys::fs::directory_iterator it(directory + subdirectory, error),
+         end;
+         it != end && !error; it.increment(error)) {
+      files.push_back(it->path());
+    }
+    for (auto &file : files) {
+      llvm::sys::fs::remove(file);
+    }
+  }
+}
+
+bool DistributedQueue::writeFile(const std::string &path,
+                                 const std::string &content) {
+  int descriptor = -1;
+  llvm::SmallString<128> temporaryName;
+  auto error = llvm::sys::fs::createUniqueFile(path + ".tmp-%%%%%%%%",
+                                               descriptor, temporaryName);
+  if (error) {
+    Logger::error() << "Cannot write '" << path << "': " << error.message()
+                    << "\n";
+    return false;
+  }
+
+  bool failed = false;
+  {
+    llvm::raw_fd_ostream outfile(descriptor, true);
+    outfile << content;
+    outfile.close();
+    failed = outfile.has_error();
+    outfile.clear_error();
+  }
+
+  if (failed || llvm::sys::fs::rename(temporaryName, path)) {
+    llvm::sys::fs::remove(temporaryName);
+    Logger::error() << "Cannot write '" << path << "'\n";
+    return false;
+  }
+  return true;
+}
+
+/// The mutants follow the size of the chunks, one per line:
+///
+///     mull-mutants 1
+///     chunk <size>
+///     <mutant identifier>
+bool DistributedQueue::publish(const std::vector<std::string> &mutants,
+                               size_t chunkSize) {
+  for (auto subdirectory : {"/claims", "/results"}) {
+    auto error = llvm::sys::fs::create_directories(directory + subdirectory);
+    if (error) {
+      Logger::error() << "Cannot create '" << directory << subdirectory
+                      << "': " << error.message() << "\n";
+      return false;
+    }
+  }
+
+  chunks.clear();
+  std::string content = std::string(MutantsHeader) + "\n";
+  content += "chunk " + std::to_string(chunkSize) + "\n";
+  for (size_t index = 0; index < mutants.size(); index++) {
+    if (index % chunkSize == 0) {
+      chunks.emplace_back();
+    }
+    chunks.back().push_back(mutants[index]);
+    content += mutants[index] + "\n";
+  }
+  return writeFile(directory + "/mutants", content);
+}
+
+bool DistributedQueue::subscribe(long long timeoutSeconds) {
+  auto deadline = std::time(nullptr) + timeoutSeconds;
+  while (true) {
+    auto buffer = llvm::MemoryBuffer::getFile(directory + "/mutants");
+    if (buffer) {
+      llvm::SmallVector<llvm::StringRef, 64> lines;
+      buffer.get()->getBuffer().split(lines, '\n', -1, false);
+      size_t chunkSize = 0;
+      if (lines.size() < 2 || lines[0] != MutantsHeader ||
+          !lines[1].startswith("chunk ") ||
+          lines[1].drop_front(6).getAsInteger(10, chunkSize) ||
+          chunkSize == 0) {
+        Logger::error() << "Cannot read the mutants of '" << directory
+                        << "'\n";
+        return false;
+      }
+      chunks.clear();
+      for (size_t index = 2; index < lines.size(); index++) {
+        if ((index - 2) % chunkSize == 0) {
+          chunks.emplace_back();
+        }
+        chunks.back().push_back(lines[index].str());
+      }
+      return true;
+    }
+    if (std::time(nullptr) >= deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+  }
+}
+
+const std::vector<std::vector<std::string>> &
+DistributedQueue::getChunks() const {
+  return chunks;
+}
+
+bool DistributedQueue::hasResults(size_t chunk) {
+  if (done.count(chunk)) {
+    return true;
+  }
+  if (llvm::sys::fs::exists(resultsPath(chunk))) {
+    done.insert(chunk);
+    return true;
+  }
+  return false;
+}
+
+bool DistributedQueue::claim(size_t &chunk,
+                             const std::function<bool(size_t)> &runnable) {
+  std::lock_guard<std::mutex> guard(mutex);
+  std::vector<size_t> expired;
+  for (size_t index = 0; index < chunks.size(); index++) {
+    if (running.count(index) || hasResults(index) || !runnable(index)) {
+      continue;
+    }
+
+    auto path = claimPath(index);
+    int descriptor = open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0644);
+    if (descriptor != -1) {
+      auto written = write(descriptor, node.data(), node.size());
+      (void)written;
+      close(descriptor);
+      running.insert(index);
+      chunk = index;
+      return true;
+    }
+
+    struct stat status;
+    if (stat(path.c_str(), &status) == 0 &&
+        std::time(nullptr) - status.st_mtime > leaseSeconds) {
+      expired.push_back(index);
+    }
+  }
+
+  /// The chunks nobody claimed go first, those of the nodes that are gone
+  /// or too slow are taken over only once there are none left
+  for (auto index : expired) {
+    if (!writeFile(claimPath(index), node)) {
+      continue;
+    }
+    Logger::info() << "Claimed chunk " << index << " again, its lease of "
+                   << leaseSeconds << " seconds expired\n";
+    running.insert(index);
+    chunk = index;
+    return true;
+  }
+  return false;
+}
+
+void DistributedQueue::renew(size_t chunk) {
+  utimes(claimPath(chunk).c_str(), nullptr);
+}
+
+/// Each result is a line of sizes followed by the data:
+///
+///     mull-results 1
+///     <status> <running time> <mutant> <test> <stdout> <stderr>
+///     <mutant identifier><test identifier><stdout><stderr>
+bool DistributedQueue::complete(
+    size_t chunk, const std::vector<StoredMutationResult> &results) {
+  std::string content = std::string(ResultsHeader) + "\n";
+  for (auto &stored : results) {
+    auto stdoutText = stored.result.stdoutOutput.str();
+    auto stderrText = stored.result.stderrOutput.str();
+    content += std::to_string(int(stored.result.status)) + " " +
+               std::to_string(stored.result.runningTime) + " " +
+               std::to_string(stored.mutant.size()) + " " +
+               std::to_string(stored.test.size()) + " " +
+               std::to_string(stdoutText.size()) + " " +
+               std::to_string(stderrText.size()) + "\n";
+    content += stored.mutant + stored.test + stdoutText + stderrText + "\n";
+  }
+
+  bool written = writeFile(resultsPath(chunk), content);
+  std::lock_guard<std::mutex> guard(mutex);
+  running.erase(chunk);
+  if (written) {
+    done.insert(chunk);
+    doneHere.insert(chunk);
+  }
+  return written;
+}
+
+bool DistributedQueue::finished() {
+  std::lock_guard<std::mutex> guard(mutex);
+  for (size_t index = 0; index < chunks.size(); index++) {
+    if (!hasResults(index)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool DistributedQueue::completedHere(size_t chunk) {
+  std::lock_guard<std::mutex> guard(mutex);
+  return doneHere.count(chunk) != 0;
+}
+
+bool DistributedQueue::readResults(size_t chunk,
+                                   std::vector<StoredMutationResult> &results) {
+  auto buffer = llvm::MemoryBuffer::getFile(resultsPath(chunk));
+  if (!buffer) {
+    return false;
+  }
+
+  llvm::StringRef rest = buffer.get()->getBuffer();
+  auto headerAndRest = rest.split('\n');
+  if (headerAndRest.first != ResultsHeader) {
+    return false;
+  }
+  rest = headerAndRest.second;
+
+  while (!rest.empty()) {
+    auto lineAndRest = rest.split('\n');
+    llvm::SmallVector<llvm::StringRef, 6> fields;
+    lineAndRest.first.split(fields, ' ');
+    int status = 0;
+    long long runningTime = 0;
+    size_t sizes[4] = {0, 0, 0, 0};
+    if (fields.size() != 6 || fields[0].getAsInteger(10, status) ||
+        fields[1].getAsInteger(10, runningTime)) {
+      return false;
+    }
+    size_t total = 0;
+    for (size_t index = 0; index < 4; index++) {
+      if (fields[index + 2].getAsInteger(10, sizes[index])) {
+        return false;
+      }
+      total += sizes[index];
+    }
+    rest = lineAndRest.second;
+    if (rest.size() < total + 1 || rest[total] != '\n') {
+      return false;
+    }
+
+    StoredMutationResult stored;
+    stored.mutant = rest.substr(0, sizes[0]).str();
+    stored.test = rest.substr(sizes[0], sizes[1]).str();
+    stored.result.status = static_cast<ExecutionStatus>(status);
+    stored.result.runningTime = runningTime;
+    stored.result.stdoutOutput =
+        rest.substr(sizes[0] + sizes[1], sizes[2]).str();
+    stored.result.stderrOutput =
+        rest.substr(sizes[0] + sizes[1] + sizes[2], sizes[3]).str();
+    results.push_back(std::move(stored));
+    rest = rest.drop_front(total + 1);
+  }
+  return true;
+}
@@ -1,45 +1,86 @@
 #include "mull/Parallelization/Progress.h"
 
+#include "mull/CostEstimate.h"
+#include "mull/JSON.h"
+#include "mull/Metrics/LiveMetrics.h"
+
 #include <llvm/Support/raw_ostream.h>
-#include <unistd.h>
+
+#include <cstdlib>
+#include <thread>
 #include <vector>
 
 using namespace mull;
 
+const size_t progress_counter::CacheLineSize;
+
+progress_counter::progress_counter() : value(0) {}
+
 progress_counter::progress_counter(const progress_counter &v)
     : value(v.value.load()) {}
 
-void progress_counter::increment() { value++; }
+void progress_counter::increment() {
+  value.fetch_add(1, std::memory_order_relaxed);
+}
+
+progress_counter::CounterType progress_counter::get() {
+  return value.load(std::memory_order_relaxed);
+}
 
-progress_counter::CounterType progress_counter::get() { return value.load(); }
+progress_completion::progress_completion() : finished(false) {}
+
+void progress_completion::finish() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    finished = true;
+  }
+  condition.notify_all();
+}
+
+bool progress_completion::waitFor(std::chrono::milliseconds interval) {
+  std::unique_lock<std::mutex> lock(mutex);
+  return condition.wait_for(lock, interval, [this]() { return finished; });
+}
 
 progress_reporter::progress_reporter(std::string &name,
                                      std::vector<progress_counter> &counters,
                                      progress_counter::CounterType total,
-                                     size_t workers, llvm::raw_ostream &stream)
+                                     size_t workers, llvm::raw_ostream &stream,
+                                     progress_completion *completion)
     : counters(counters), stream(stream), total(total), previousValue(0),
-      name(name), workers(workers) {
-  hasTerminal = getenv("TERM") != nullptr;
+      name(name), workers(workers), completion(completion), estimate(0),
+      start(std::chrono::steady_clock::now()) {
+  hasTerminal = getenv("TERM") != nullptr && stream.is_displayed();
   bool forceReport = true;
   printProgress(0, total, forceReport);
 }
 
+void progress_reporter::setEstimate(int64_t nanoseconds) {
+  estimate = nanoseconds;
+}
+
 void progress_reporter::operator()() {
-  useconds_t microseconds(10000);
-  for (;; usleep(microseconds)) {
+  std::chrono::milliseconds interval(hasTerminal ? 100 : 1000);
+  for (;;) {
+    bool finished = false;
+    if (completion) {
+      finished = completion->waitFor(interval);
+    } else {
+      std::this_thread::sleep_for(interval);
+    }
+
     progress_counter::CounterType current(0);
     for (auto &counter : counters) {
       current += counter.get();
     }
 
-    if (current == 0) {
+    if (current == 0 && !finished) {
       continue;
     }
 
-    bool forceReport = false;
-    printProgress(current, total, forceReport);
+    printProgress(current, total, finished);
 
-    if (current == total) {
+    if (current == total || finished) {
       break;
     }
   }
@@ -48,21 +89,53 @@ void progress_reporter::operator()() {
 void progress_reporter::printProgress(progress_counter::CounterType current,
                                       progress_counter::CounterType total,
                                       bool force) {
+  LiveMetrics::shared().setProgress(current, total, workers);
   if (current == previousValue && !force) {
     return;
   }
 
-  char terminator = '\n';
-  if (hasTerminal) {
-    terminator = '\r';
+  const size_t bufferSize(256);
+  char message[bufferSize];
+
+  const bool withEstimate = estimate > 0 && current < total;
+  int64_t remaining = 0;
+  if (withEstimate) {
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start);
+    remaining = remainingTime(estimate, elapsed.count(), current, total);
+  }
+
+  if (!hasTerminal) {
+    const char *format = "\nmull-progress: {\"phase\": \"%s\", \"threads\": "
+                         "%zu, \"done\": %zu, \"total\": %zu";
+    snprintf(message, bufferSize, format, escapeJSON(name).c_str(), workers,
+             current, total);
+    stream << message;
+    if (withEstimate) {
+      stream << ", \"eta_seconds\": " << remaining / 1000000000;
+    }
+    stream << "}";
+  }
+
+  if (hasTerminal || current == total) {
+    char terminator = hasTerminal ? '\r' : '\n';
+    const char *format = "%c%s (threads: %zu): %zu/%zu";
+    snprintf(message, bufferSize, format, terminator, name.c_str(), workers,
+             current, total);
+    stream << message;
+    /// Padded so that a shorter time does not leave the end of a longer one
+    /// on the line, blanked once the phase is complete
+    if (hasTerminal && estimate > 0) {
+      if (withEstimate) {
+        snprintf(message, bufferSize, ", about %-8s left",
+                 formatDuration(remaining).c_str());
+      } else {
+        snprintf(message, bufferSize, "%20s", "");
+      }
+      stream << message;
+    }
   }
 
-  const char *format = "%c%s (threads: %d): %zu/%zu";
-  const size_t bufferSize(128);
-  char message[bufferSize];
-  snprintf(message, bufferSize, format, terminator, name.c_str(), workers,
-           current, total);
-  stream << message;
   stream.flush();
   previousValue = current;
 }
@@ -1,5 +1,7 @@
 #include "mull/Parallelization/TaskExecutor.h"
 
+#include <algorithm>
+
 namespace mull {
 std::vector<int> taskBatches(size_t itemsCount, size_t tasks) {
   assert(itemsCount >= tasks);
@@ -31,6 +33,68 @@ std::vector<int> taskBatches(size_t itemsCount, size_t tasks) {
   return result;
 }
 
+/// Guided partitioning: every chunk takes a share of the items that are left,
+/// so the chunks are large at the beginning (cheap to dispatch) and shrink
+/// down to a single item towards the end (cheap to balance).
+std::vector<int> taskChunks(size_t itemsCount, size_t workers) {
+  assert(workers != 0);
+
+  std::vector<int> result;
+
+  size_t remaining = itemsCount;
+  while (remaining != 0) {
+    size_t chunk = std::max(remaining / (workers * 2), size_t(1));
+    result.push_back(chunk);
+    remaining -= chunk;
+  }
+
+  return result;
+}
+
+/// Indexes of the items ordered by size, largest first; items of the same
+/// size keep their order. Handed out one by one, the workers pick the largest
+/// item left whenever they are done, which is the greedy (LPT) packing of the
+/// items into the workers.
+std::vector<size_t> largestFirst(const std::vector<uint64_t> &sizes) {
+  std::vector<size_t> order(sizes.size());
+  for (size_t i = 0; i < order.size(); i++) {
+    order[i] = i;
+  }
+  std::stable_sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+    return sizes[lhs] > sizes[rhs];
+  });
+  return order;
+}
+
+/// A quarter, a half and all of the workers. Together the slices take about
+/// a hundredth of the items, and each of them has at least two items per
+/// worker so that every worker is measured. Calibrating is not worth it when
+/// that takes more than a quarter of the items.
+std::vector<std::pair<size_t, size_t>> calibrationSlices(size_t itemsCount,
+                                                         size_t workers) {
+  std::vector<size_t> levels;
+  for (auto level : {workers / 4, workers / 2, workers}) {
+    if (level != 0 && (levels.empty() || levels.back() != level)) {
+      levels.push_back(level);
+    }
+  }
+  if (levels.size() < 2) {
+    return {};
+  }
+
+  std::vector<std::pair<size_t, size_t>> slices;
+  size_t total = 0;
+  for (auto level : levels) {
+    auto items = std::max(itemsCount / 100 / levels.size(), level * 2);
+    slices.emplace_back(level, items);
+    total += items;
+  }
+  if (total > itemsCount / 4) {
+    return {};
+  }
+  return slices;
+}
+
 void printTimeSummary(MetricsMeasure measure) {
   Logger::info() << ". Finished in " << measure.duration()
                  << MetricsMeasure::precision() << ".\n";
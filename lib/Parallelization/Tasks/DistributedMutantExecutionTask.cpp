@@ -0,0 +1,60 @@
+#include "mull/Parallelization/Tasks/DistributedMutantExecutionTask.h"
+
+#include "mull/MutationPoint.h"
+#include "mull/Parallelization/DistributedQueue.h"
+#include "mull/Parallelization/Progress.h"
+
+#include <chrono>
+#include <iterator>
+#include <thread>
+
+using namespace mull;
+
+/// How often an idle worker looks for the chunks of the nodes that are gone
+static const std::chrono::seconds PollInterval(1);
+
+DistributedMutantExecutionTask::DistributedMutantExecutionTask(
+    MutantExecutionTask task, DistributedQueue &queue,
+    const std::vector<std::vector<MutationPoint *>> &chunks)
+    : task(std::move(task)), queue(queue), chunks(chunks) {}
+
+void DistributedMutantExecutionTask::operator()(iterator begin, iterator end,
+                                                Out &storage,
+                                                progress_counter &counter) {
+  auto runnable = [this](size_t chunk) { return !chunks[chunk].empty(); };
+  for (auto it = begin; it != end; it++, counter.increment()) {
+    size_t chunk = 0;
+    while (true) {
+      if (queue.claim(chunk, runnable)) {
+        runChunk(chunk, storage);
+      } else if (queue.finished()) {
+        break;
+      } else {
+        std::this_thread::sleep_for(PollInterval);
+      }
+    }
+  }
+}
+
+void DistributedMutantExecutionTask::runChunk(size_t chunk, Out &storage) {
+  auto &points = chunks[chunk];
+  Out results;
+  progress_counter progress;
+  for (auto point = points.cbegin(); point != points.cend(); ++point) {
+    task(point, std::next(point), results, progress);
+    queue.renew(chunk);
+  }
+
+  std::vector<StoredMutationResult> stored;
+  stored.reserve(results.size());
+  for (size_t row = 0; row < results.size(); row++) {
+    StoredMutationResult storedResult;
+    storedResult.mutant = results.getMutationPoint(row)->getUniqueIdentifier();
+    storedResult.test = results.getTest(row)->getUniqueIdentifier();
+    storedResult.result = results.getExecutionResult(row);
+    stored.push_back(std::move(storedResult));
+  }
+  queue.complete(chunk, stored);
+
+  storage.append(results);
+}
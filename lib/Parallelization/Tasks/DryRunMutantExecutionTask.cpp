@@ -10,15 +10,14 @@ void DryRunMutantExecutionTask::operator()(iterator begin, iterator end,
                                            progress_counter &counter) {
   for (auto it = begin; it != end; it++, counter.increment()) {
     auto mutationPoint = *it;
-    for (auto &reachableTest : mutationPoint->getReachableTests()) {
+    for (auto reachableTest : mutationPoint->getReachableTests()) {
       auto test = reachableTest.first;
       auto distance = reachableTest.second;
       auto timeout = test->getExecutionResult().runningTime * 10;
       ExecutionResult result;
       result.status = DryRun;
       result.runningTime = timeout;
-      storage.push_back(
-          make_unique<MutationResult>(result, mutationPoint, distance, test));
+      storage.add(MutationResult(result, mutationPoint, distance, test));
     }
   }
 }
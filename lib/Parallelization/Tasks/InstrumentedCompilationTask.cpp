@@ -1,39 +1,108 @@
 #include "mull/Parallelization/Tasks/InstrumentedCompilationTask.h"
 
 #include "mull/Instrumentation/Instrumentation.h"
+#include "mull/Metrics/Metrics.h"
 #include "mull/Parallelization/Progress.h"
+#include "mull/Toolchain/JITEngine.h"
+#include "mull/Toolchain/ProgramLibrary.h"
 #include "mull/Toolchain/Toolchain.h"
 
-#include <llvm/ExecutionEngine/ExecutionEngine.h>
-#include <llvm/Support/TargetSelect.h>
-
 using namespace mull;
 using namespace llvm;
 
 InstrumentedCompilationTask::InstrumentedCompilationTask(
-    Instrumentation &instrumentation, Toolchain &toolchain)
-    : instrumentation(instrumentation), toolchain(toolchain) {}
+    Instrumentation &instrumentation, Toolchain &toolchain, Metrics &metrics,
+    JITEngine *jit)
+    : instrumentation(instrumentation), toolchain(toolchain), metrics(metrics),
+      jit(jit) {}
 
 void InstrumentedCompilationTask::operator()(iterator begin, iterator end,
                                              Out &storage,
                                              progress_counter &counter) {
-  EngineBuilder builder;
-  auto target = builder.selectTarget(llvm::Triple(), "", "",
-                                     llvm::SmallVector<std::string, 1>());
-  std::unique_ptr<TargetMachine> localMachine(target);
+  auto &machine = toolchain.workerTargetMachine();
 
   for (auto it = begin; it != end; it++, counter.increment()) {
     auto &module = *it->get();
-    auto objectFile = toolchain.cache().getInstrumentedObject(module);
+    metrics.beginCompileInstrumentedModule(module.getModule());
+    auto partitions = toolchain.codegenPartitions(module);
+    if (partitions > 1) {
+      compileInParts(module, partitions, storage);
+      metrics.endCompileInstrumentedModule(module.getModule());
+      continue;
+    }
+
+    auto objectFile =
+        toolchain.cache().getInstrumentedObject(module, cacheSuffix());
     if (objectFile.getBinary() == nullptr) {
       LLVMContext instrumentationContext;
       auto clonedModule = module.clone(instrumentationContext);
 
-      instrumentation.insertCallbacks(clonedModule->getModule());
+      instrumentCallbacks(clonedModule->getModule());
       objectFile =
-          toolchain.compiler().compileModule(*clonedModule, *localMachine);
-      toolchain.cache().putInstrumentedObject(objectFile, module);
+          toolchain.compiler().compileModule(*clonedModule, machine);
+      toolchain.cache().putInstrumentedObject(objectFile, module,
+                                              cacheSuffix());
+    }
+    store(std::move(objectFile), storage);
+    metrics.endCompileInstrumentedModule(module.getModule());
+  }
+}
+
+/// The module is compiled again unless all of its parts are in the cache
+void InstrumentedCompilationTask::compileInParts(MullModule &module,
+                                                 unsigned partitions,
+                                                 Out &storage) {
+  Out parts;
+  for (unsigned index = 0; index < partitions; index++) {
+    auto part = toolchain.cache().getInstrumentedObject(
+        module, cacheSuffix() + ObjectCache::partSuffix(index, partitions));
+    if (part.getBinary() == nullptr) {
+      break;
+    }
+    parts.push_back(std::move(part));
+  }
+
+  if (parts.size() != partitions) {
+    LLVMContext instrumentationContext;
+    auto clonedModule = module.clone(instrumentationContext);
+
+    instrumentCallbacks(clonedModule->getModule());
+    auto machine = [this]() -> TargetMachine & {
+      return toolchain.workerTargetMachine();
+    };
+    parts = toolchain.compiler().compileModuleInParts(
+        *clonedModule->getModule(), partitions, machine);
+    for (size_t index = 0; index < parts.size(); index++) {
+      if (parts[index].getBinary()) {
+        toolchain.cache().putInstrumentedObject(
+            parts[index], module,
+            cacheSuffix() + ObjectCache::partSuffix(index, partitions));
+      }
     }
-    storage.push_back(std::move(objectFile));
   }
+
+  for (auto &part : parts) {
+    store(std::move(part), storage);
+  }
+}
+
+/// The objects of a program library are compiled apart from the others
+std::string InstrumentedCompilationTask::cacheSuffix() const {
+  return instrumentation.cacheSuffix() +
+         (toolchain.isPositionIndependent() ? "_library" : "");
+}
+
+void InstrumentedCompilationTask::instrumentCallbacks(llvm::Module *module) {
+  instrumentation.insertCallbacks(module);
+  if (toolchain.isPositionIndependent()) {
+    ProgramLibrary::dropStaticConstructors(*module);
+  }
+}
+
+void InstrumentedCompilationTask::store(
+    object::OwningBinary<object::ObjectFile> object, Out &storage) {
+  if (jit && object.getBinary()) {
+    jit->addObjectFile(*object.getBinary());
+  }
+  storage.push_back(std::move(object));
 }
@@ -10,11 +10,10 @@ JunkDetectionTask::JunkDetectionTask(JunkDetector &detector)
 
 void JunkDetectionTask::operator()(iterator begin, iterator end, Out &storage,
                                    progress_counter &counter) {
-  for (auto it = begin; it != end; ++it, counter.increment()) {
-    auto point = *it;
-    if (detector.isJunk(point)) {
-      continue;
+  for (auto it = begin; it != end; ++it) {
+    detector.classify(*it, storage);
+    for (size_t index = 0; index < it->size(); index++) {
+      counter.increment();
     }
-    storage.push_back(point);
   }
 }
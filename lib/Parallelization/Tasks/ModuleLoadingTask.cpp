@@ -6,13 +6,15 @@
 using namespace mull;
 using namespace llvm;
 
-ModuleLoadingTask::ModuleLoadingTask(LLVMContext &context, ModuleLoader &loader)
-    : context(context), loader(loader) {}
+ModuleLoadingTask::ModuleLoadingTask(LLVMContext &context, ModuleLoader &loader,
+                                     bool lazy, HashAlgorithm hashAlgorithm)
+    : context(context), loader(loader), lazy(lazy),
+      hashAlgorithm(hashAlgorithm) {}
 
 void ModuleLoadingTask::operator()(iterator begin, iterator end, Out &storage,
                                    progress_counter &counter) {
   for (auto it = begin; it != end; ++it, counter.increment()) {
-    auto module = loader.loadModuleAtPath(*it, context);
+    auto module = loader.loadModuleAtPath(*it, context, lazy, hashAlgorithm);
     if (module != nullptr) {
       storage.push_back(std::move(module));
     }
@@ -0,0 +1,49 @@
+#include "mull/Parallelization/Tasks/MutantBatchExecutionTask.h"
+
+#include "mull/MutationPoint.h"
+#include "mull/Parallelization/Progress.h"
+
+#include <algorithm>
+#include <map>
+
+using namespace mull;
+
+std::vector<std::vector<MutationPoint *>>
+mull::batchMutants(const std::vector<MutationPoint *> &mutationPoints,
+                   size_t size) {
+  size = std::max<size_t>(size, 1);
+
+  std::vector<std::vector<MutationPoint *>> rounds;
+  /// The functions are told apart by their positions, the IR may be
+  /// released already
+  std::map<std::pair<const MullModule *, int>, size_t> mutantsPerFunction;
+  for (auto point : mutationPoints) {
+    auto function = std::make_pair(point->getOriginalModule(),
+                                   point->getAddress().getFnIndex());
+    auto round = mutantsPerFunction[function]++;
+    if (round == rounds.size()) {
+      rounds.emplace_back();
+    }
+    rounds[round].push_back(point);
+  }
+
+  std::vector<std::vector<MutationPoint *>> batches;
+  for (auto &round : rounds) {
+    for (size_t begin = 0; begin < round.size(); begin += size) {
+      auto end = std::min(begin + size, round.size());
+      batches.emplace_back(round.begin() + begin, round.begin() + end);
+    }
+  }
+  return batches;
+}
+
+MutantBatchExecutionTask::MutantBatchExecutionTask(MutantExecutionTask task)
+    : task(std::move(task)) {}
+
+void MutantBatchExecutionTask::operator()(iterator begin, iterator end,
+                                          Out &storage,
+                                          progress_counter &counter) {
+  for (auto it = begin; it != end; it++, counter.increment()) {
+    task.runBatch(*it, storage);
+  }
+}
@@ -0,0 +1,83 @@
+#include "mull/Parallelization/Tasks/MutantCompilationTask.h"
+
+#include "mull/Config/Configuration.h"
+#include "mull/Instrumentation/LoopBudget.h"
+#include "mull/Metrics/Metrics.h"
+#include "mull/MutationPoint.h"
+#include "mull/Parallelization/Progress.h"
+
+#include <llvm/IR/LLVMContext.h>
+
+#include <unordered_set>
+
+using namespace mull;
+
+MutantCompilationTask::MutantCompilationTask(
+    Toolchain &toolchain, const Configuration &config,
+    const MutationPoints &mutationPoints, const ContextLocks &contextLocks,
+    Metrics &metrics)
+    : config(config), mutationPoints(mutationPoints),
+      contextLocks(contextLocks), metrics(metrics),
+      compilation(toolchain, config.mutantDebugInfo) {}
+
+void MutantCompilationTask::operator()(iterator begin, iterator end,
+                                       Out &storage,
+                                       progress_counter &counter) {
+  for (auto it = begin; it != end; it++, counter.increment()) {
+    auto &module = **it;
+    auto &context = module.getModule()->getContext();
+    auto &contextLock = *contextLocks.at(&context);
+    metrics.beginSpan("Wait for context lock");
+    std::lock_guard<std::mutex> guard(contextLock);
+    metrics.endSpan("Wait for context lock");
+
+    auto points = mutationPoints.find(&module);
+    if (config.deferMutantCloningEnabled) {
+      module.retainMutations(points != mutationPoints.end()
+                                 ? points->second
+                                 : std::vector<MutationPoint *>());
+    }
+
+    module.prepareMutations(config.mutantSchemataEnabled,
+                            !config.equivalentMutantPruningEnabled);
+
+    if (points != mutationPoints.end()) {
+      for (auto point : points->second) {
+        if (!point->getCanonical()) {
+          point->applyMutation();
+        }
+      }
+    }
+
+    if (config.equivalentMutantPruningEnabled) {
+      metrics.beginSpan("Hash mutants",
+                        module.getModule()->getModuleIdentifier());
+      module.hashMutations();
+      metrics.endSpan("Hash mutants");
+    }
+
+    /// After the hashes, the budget is no part of what a mutant changes. The
+    /// budget ends the process it runs in, which has to be a forked one.
+    if (config.loopBudget > 0 && config.forkEnabled &&
+        points != mutationPoints.end()) {
+      std::unordered_set<llvm::Function *> budgeted;
+      for (auto point : points->second) {
+        auto function = point->getMutatedFunction();
+        if (function && budgeted.insert(function).second) {
+          injectLoopBudget(function);
+        }
+      }
+    }
+
+    if (config.mutantSchemataEnabled) {
+      module.inlineSchemata();
+    } else if (config.splitMutatedFunctionsEnabled) {
+      module.splitMutatedFunctions();
+    }
+
+    metrics.beginSpan("Compile mutated module",
+                      module.getModule()->getModuleIdentifier());
+    compilation.compile(module, storage);
+    metrics.endSpan("Compile mutated module");
+  }
+}
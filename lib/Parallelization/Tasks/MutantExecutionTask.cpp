@@ -1,8 +1,16 @@
 #include "mull/Parallelization/Tasks/MutantExecutionTask.h"
 
 #include "mull/Config/Configuration.h"
+#include "mull/ExecutionOutput.h"
 #include "mull/ForkProcessSandbox.h"
+#include "mull/Instrumentation/LoopBudget.h"
+#include "mull/KillMatrix.h"
+#include "mull/MemoryBudget.h"
+#include "mull/Metrics/Metrics.h"
+#include "mull/Parallelization/Cancellation.h"
 #include "mull/Parallelization/Progress.h"
+#include "mull/Reporters/Reporter.h"
+#include "mull/TestFrameworks/Test.h"
 #include "mull/TestFrameworks/TestRunner.h"
 #include "mull/Toolchain/Mangler.h"
 #include "mull/Toolchain/Trampolines.h"
@@ -10,70 +18,455 @@
 #include <llvm/ExecutionEngine/ExecutionEngine.h>
 #include <llvm/Support/TargetSelect.h>
 
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <limits>
+
 using namespace mull;
 using namespace llvm;
 
 MutantExecutionTask::MutantExecutionTask(
-    ProcessSandbox &sandbox, Program &program, TestRunner &runner,
-    const Configuration &config, Filter &filter, Mangler &mangler,
+    ProcessSandbox &sandbox, ExecutionOutputStore &outputStore,
+    Program &program, TestRunner &runner, const Configuration &config,
+    Filter &filter, Metrics &metrics, Mangler &mangler,
     std::vector<llvm::object::ObjectFile *> &objectFiles,
-    std::vector<std::string> &mutatedFunctionNames)
-    : sandbox(sandbox), program(program), runner(runner), config(config),
-      filter(filter), mangler(mangler), objectFiles(objectFiles),
-      mutatedFunctionNames(mutatedFunctionNames) {}
+    std::vector<std::string> &mutatedFunctionNames,
+    std::shared_ptr<const SymbolIndex> symbolIndex, JITEngine *sharedJit,
+    Trampolines *sharedTrampolines, const std::vector<Reporter *> *reporters,
+    KillMatrix *killMatrix, MemoryBudget *memoryBudget)
+    : ownJit(config.lazyJITEnabled ? JITLinking::Lazy : JITLinking::Eager,
+             std::move(symbolIndex)),
+      jit(sharedJit), trampolines(sharedTrampolines),
+      sharedProgram(sharedJit != nullptr && sharedTrampolines != nullptr),
+      childrenInFlight(
+          config.forkEnabled && !config.forkSnapshotEnabled
+              ? std::max(config.parallelization.childrenPerWorker, 1)
+              : 1),
+      directCalls(config.directCallsEnabled && config.forkEnabled &&
+                  !config.forkSnapshotEnabled),
+      activateInChild(sharedProgram || childrenInFlight > 1 || directCalls),
+      constructorTemplate(config.constructorTemplateEnabled),
+      constructorsDone(false),
+      freshGlobalsTests(config.freshGlobalsTests.begin(),
+                        config.freshGlobalsTests.end()),
+      program(program), sandbox(sandbox), outputStore(outputStore),
+      runner(runner), config(config), filter(filter), metrics(metrics),
+      timeoutPolicy(config), mangler(mangler),
+      objectFiles(objectFiles), mutatedFunctionNames(mutatedFunctionNames),
+      reporters(reporters), killMatrix(killMatrix), memoryBudget(memoryBudget),
+      failFast(config.failFastEnabled && !killMatrix) {}
 
 void MutantExecutionTask::operator()(iterator begin, iterator end, Out &storage,
                                      progress_counter &counter) {
-  Trampolines trampolines(mutatedFunctionNames);
-  runner.loadMutatedProgram(objectFiles, trampolines, jit);
-  trampolines.fixupOriginalFunctions(jit);
-
-  for (auto it = begin; it != end; ++it, counter.increment()) {
-    auto mutationPoint = *it;
-
-    auto trampolineName =
-        mangler.getNameWithPrefix(mutationPoint->getTrampolineName());
-    auto mutatedFunctionName =
-        mangler.getNameWithPrefix(mutationPoint->getMutatedFunctionName());
-    uint64_t *trampoline = trampolines.findTrampoline(trampolineName);
-    uint64_t address =
-        llvm_compat::JITSymbolAddress(jit.getSymbol(mutatedFunctionName));
-    uint64_t originalAddress = *trampoline;
-    *trampoline = address;
-
-    auto atLeastOneTestFailed = false;
-    for (auto &reachableTest : mutationPoint->getReachableTests()) {
-      auto test = reachableTest.first;
-      auto distance = reachableTest.second;
-
-      ExecutionResult result;
-      if (config.failFastEnabled && atLeastOneTestFailed) {
-        result.status = ExecutionStatus::FailFast;
-      } else {
-        const auto timeout = test->getExecutionResult().runningTime * 10;
-        const auto sandboxTimeout = std::max(30LL, timeout);
-
-        result = sandbox.run(
-            [&]() {
-              ExecutionStatus status = runner.runTest(jit, program, *test);
-              assert(status != ExecutionStatus::Invalid &&
-                     "Expect to see valid TestResult");
-              return status;
-            },
-            sandboxTimeout);
-
-        assert(result.status != ExecutionStatus::Invalid &&
-               "Expect to see valid TestResult");
-
-        if (result.status != ExecutionStatus::Passed) {
-          atLeastOneTestFailed = true;
-        }
+  loadProgram(*begin);
+  auto activations = resolve(std::vector<MutationPoint *>(begin, end));
+
+  /// One chunk of mutants at a time, each of them a series of tests in its
+  /// own child. Several of them in flight need the mutant to be activated
+  /// in the children, the parent sees every mutant at once.
+  for (auto it = begin; it != end;) {
+    if (Cancellation::shared().cancelled()) {
+      break;
+    }
+    auto groupEnd =
+        it + std::min<size_t>(childrenInFlight, std::distance(it, end));
+
+    std::vector<std::vector<SandboxJob>> series;
+    for (auto point = it; point != groupEnd; ++point) {
+      auto &activation = activations[std::distance(begin, point)];
+      activate(activation);
+      series.push_back(jobsOf(*point, activation));
+    }
+
+    /// All the tests of a mutant run against the same trampoline, so
+    /// the sandbox is free to fork the process once for the whole series
+    auto proceed = [this](const ExecutionResult &result) {
+      assert(result.status != ExecutionStatus::Invalid &&
+             "Expect to see valid TestResult");
+      return !failFast || result.status == ExecutionStatus::Passed;
+    };
+    std::vector<std::vector<ExecutionResult>> results;
+    if (series.size() == 1) {
+      metrics.beginSpan("Run mutant", (*it)->getUniqueIdentifier());
+      results.push_back(sandbox.runSeries(series.front(), proceed));
+      metrics.endSpan("Run mutant");
+    } else {
+      metrics.beginSpan("Run mutants", (*it)->getUniqueIdentifier());
+      results = sandbox.runConcurrentSeries(series, childrenInFlight, proceed);
+      metrics.endSpan("Run mutants");
+    }
+
+    for (size_t index = 0; index < series.size(); index++) {
+      collectResults(it[index], results[index], storage);
+      deactivate(activations[std::distance(begin, it) + index]);
+      counter.increment();
+    }
+    it = groupEnd;
+  }
+}
+
+void MutantExecutionTask::runBatch(const std::vector<MutationPoint *> &batch,
+                                   Out &storage) {
+  loadProgram(batch.front());
+  auto activations = resolve(batch);
+  runBatch(batch, activations, storage);
+}
+
+void MutantExecutionTask::runBatch(const std::vector<MutationPoint *> &batch,
+                                   std::vector<MutantActivation> &activations,
+                                   Out &storage) {
+  auto proceed = [this](const ExecutionResult &result) {
+    return !failFast || result.status == ExecutionStatus::Passed;
+  };
+  if (batch.size() == 1) {
+    auto &activation = activations.front();
+    activate(activation);
+    metrics.beginSpan("Run mutant", batch.front()->getUniqueIdentifier());
+    auto results = sandbox.runSeries(jobsOf(batch.front(), activation),
+                                     proceed);
+    metrics.endSpan("Run mutant");
+    collectResults(batch.front(), results, storage);
+    deactivate(activation);
+    return;
+  }
+
+  /// The position of every test of the batch, by the id of the test
+  static const size_t Absent = std::numeric_limits<size_t>::max();
+  std::vector<Test *> tests;
+  std::vector<size_t> positions;
+  for (size_t index = 0; index < batch.size(); index++) {
+    auto point = batch[index];
+    activate(activations[index]);
+    for (auto reachableTest : point->getReachableTests()) {
+      auto id = reachableTest.first->getId();
+      if (positions.size() <= id) {
+        positions.resize(id + 1, Absent);
+      }
+      if (positions[id] == Absent) {
+        positions[id] = tests.size();
+        tests.push_back(reachableTest.first);
       }
+    }
+  }
+
+  /// The first test that fails is enough to bisect the batch
+  metrics.beginSpan("Run batch", batch.front()->getUniqueIdentifier());
+  auto results =
+      sandbox.runSeries(jobsOf(tests, activations),
+                        [](const ExecutionResult &result) {
+                          return result.status == ExecutionStatus::Passed;
+                        });
+  metrics.endSpan("Run batch");
+  for (auto &activation : activations) {
+    deactivate(activation);
+  }
+
+  bool survived = results.size() == tests.size() &&
+                  std::all_of(results.begin(), results.end(),
+                              [](const ExecutionResult &result) {
+                                return result.status ==
+                                       ExecutionStatus::Passed;
+                              });
+  if (!survived) {
+    auto middle = batch.size() / 2;
+    std::vector<MutationPoint *> first(batch.begin(), batch.begin() + middle);
+    std::vector<MutationPoint *> second(batch.begin() + middle, batch.end());
+    std::vector<MutantActivation> firstActivations(
+        activations.begin(), activations.begin() + middle);
+    std::vector<MutantActivation> secondActivations(
+        activations.begin() + middle, activations.end());
+    runBatch(first, firstActivations, storage);
+    runBatch(second, secondActivations, storage);
+    return;
+  }
+
+  for (auto point : batch) {
+    std::vector<ExecutionResult> pointResults;
+    for (auto reachableTest : point->getReachableTests()) {
+      auto position = positions[reachableTest.first->getId()];
+      pointResults.push_back(results[position]);
+    }
+    collectResults(point, pointResults, storage);
+  }
+}
+
+void MutantExecutionTask::loadProgram(MutationPoint *firstMutationPoint) {
+  /// The task is called once per chunk of mutants,
+  /// the mutated program is loaded only on the first call
+  if (!sharedProgram && !ownTrampolines) {
+    MemoryBudget::Reservation image;
+    if (memoryBudget) {
+      image = memoryBudget->admitImage();
+    }
+    metrics.beginLoadMutatedProgram(firstMutationPoint);
+    ownTrampolines = make_unique<Trampolines>(mutatedFunctionNames);
+    runner.loadMutatedProgram(objectFiles, *ownTrampolines, ownJit);
+    ownTrampolines->fixupOriginalFunctions(ownJit);
+    metrics.endLoadMutatedProgram(firstMutationPoint);
+    if (memoryBudget) {
+      memoryBudget->imageLoaded(image);
+    }
+    jit = &ownJit;
+    trampolines = ownTrampolines.get();
+  }
+  if (constructorTemplate && !freshGlobalsTests.empty() &&
+      loadedGlobals.empty()) {
+    loadedGlobals.take();
+  }
+}
 
-      storage.push_back(
-          make_unique<MutationResult>(result, mutationPoint, distance, test));
+bool MutantExecutionTask::needsFreshGlobals(const Test &test) const {
+  return constructorTemplate &&
+         freshGlobalsTests.count(test.getTestName()) != 0;
+}
+
+bool MutantExecutionTask::restoreLoadedGlobals() {
+  if (!constructorsDone || loadedGlobals.empty()) {
+    return false;
+  }
+  return loadedGlobals.restoreInChild();
+}
+
+/// The names are mangled and looked up once the program is linked, for all
+/// the mutants of the chunk at once, rather than every time a mutant runs
+std::vector<MutantExecutionTask::MutantActivation>
+MutantExecutionTask::resolve(const std::vector<MutationPoint *> &points) {
+  /// Nothing runs the program of the task but the children of the task
+  if (directCalls && !sharedProgram) {
+    trampolines->redirectEntries(*jit, mangler, points);
+  }
+  std::vector<MutantActivation> activations;
+  activations.reserve(points.size());
+  for (auto mutationPoint : points) {
+    MutantActivation activation;
+    activation.entry = nullptr;
+    if (mutationPoint->getSchemaIndex() != 0) {
+      auto mutantIdName =
+          mangler.getNameWithPrefix(mutationPoint->getMutantIdName());
+      activation.slot = reinterpret_cast<uint64_t *>(
+          llvm_compat::JITSymbolAddress(jit->getSymbol(mutantIdName)));
+      activation.value = mutationPoint->getSchemaIndex();
+    } else {
+      auto trampolineName =
+          mangler.getNameWithPrefix(mutationPoint->getTrampolineName());
+      auto mutatedFunctionName =
+          mangler.getNameWithPrefix(mutationPoint->getMutatedFunctionName());
+      activation.slot = trampolines->findTrampoline(trampolineName);
+      activation.value =
+          llvm_compat::JITSymbolAddress(jit->getSymbol(mutatedFunctionName));
+      if (directCalls) {
+        activation.entry = trampolines->findEntry(trampolineName);
+      }
+      /// The linker keeps one of the copies, whichever it is runs the mutant
+      for (auto copy : mutationPoint->getOdrCopies()) {
+        auto copySlot = trampolines->findTrampoline(
+            mangler.getNameWithPrefix(copy->getTrampolineName()));
+        assert(copySlot && "Expect to find the trampoline of the copy");
+        activation.copies.emplace_back(copySlot, 0);
+      }
     }
+    assert(activation.slot && "Expect to find the mutant's trampoline or id");
+    activation.originalValue = 0;
+    activations.push_back(activation);
+  }
+  return activations;
+}
 
-    *trampoline = originalAddress;
+void MutantExecutionTask::MutantActivation::store() const {
+  *slot = value;
+  for (auto &copy : copies) {
+    *copy.first = value;
+  }
+  /// The trampoline is still there if the entry cannot jump to the mutant
+  if (entry) {
+    entry->jumpTo(value);
+  }
+}
+
+void MutantExecutionTask::activate(MutantActivation &activation) {
+  /// Activating a mutant is a single store: either the mutant's index into
+  /// the schema of its function, or the mutated function into trampoline
+  auto swapStart = std::chrono::steady_clock::now();
+  activation.originalValue = *activation.slot;
+  for (auto &copy : activation.copies) {
+    copy.second = *copy.first;
+  }
+  if (!activateInChild) {
+    activation.store();
+  }
+  metrics.addTrampolineSwap(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - swapStart)
+          .count());
+}
+
+void MutantExecutionTask::deactivate(const MutantActivation &activation) {
+  if (!activateInChild) {
+    *activation.slot = activation.originalValue;
+    for (auto &copy : activation.copies) {
+      *copy.first = copy.second;
+    }
+  }
+}
+
+std::vector<SandboxJob>
+MutantExecutionTask::jobsOf(MutationPoint *mutationPoint,
+                            const MutantActivation &activation) {
+  auto &reachableTests = mutationPoint->getReachableTests();
+
+  /// The constructors run against the mutant, it may well be in one of them
+  std::function<void()> prologue;
+  if (constructorTemplate) {
+    prologue = [this, activation]() {
+      if (activateInChild) {
+        activation.store();
+      }
+      runner.runStaticConstructors(*jit, program);
+      constructorsDone = true;
+    };
+  }
+
+  std::vector<SandboxJob> jobs;
+  jobs.reserve(reachableTests.size());
+  for (auto reachableTest : reachableTests) {
+    auto test = reachableTest.first;
+    const auto sandboxTimeout = timeoutPolicy.timeout(*test);
+    runner.prepareTest(*jit, *test);
+
+    const bool freshGlobals = needsFreshGlobals(*test);
+    const auto loopBudget =
+        loopBudgetOf(test->getBackEdges(), config.loopBudget);
+    jobs.emplace_back(
+        [this, test, activation, freshGlobals, loopBudget]() {
+          /// The globals as loaded predate the activation of the mutant
+          const bool restored = freshGlobals && restoreLoadedGlobals();
+          mull_loopBudget = loopBudget;
+          /// The store lands in the private copy of the memory of the forked
+          /// process, the parent and the other children never see it
+          if (activateInChild || restored) {
+            activation.store();
+          }
+          ExecutionStatus status =
+              constructorsDone && !restored
+                  ? runner.runInitializedTest(*jit, *test)
+                  : runner.runTest(*jit, program, *test);
+          assert(status != ExecutionStatus::Invalid &&
+                 "Expect to see valid TestResult");
+          return status;
+        },
+        sandboxTimeout, prologue);
+  }
+  return jobs;
+}
+
+std::vector<SandboxJob>
+MutantExecutionTask::jobsOf(const std::vector<Test *> &tests,
+                            const std::vector<MutantActivation> &activations) {
+  auto activateAll = [this, activations](bool restored) {
+    if (activateInChild || restored) {
+      for (auto &activation : activations) {
+        activation.store();
+      }
+    }
+  };
+
+  std::function<void()> prologue;
+  if (constructorTemplate) {
+    prologue = [this, activateAll]() {
+      activateAll(false);
+      runner.runStaticConstructors(*jit, program);
+      constructorsDone = true;
+    };
+  }
+
+  std::vector<SandboxJob> jobs;
+  jobs.reserve(tests.size());
+  for (auto test : tests) {
+    runner.prepareTest(*jit, *test);
+    const bool freshGlobals = needsFreshGlobals(*test);
+    const auto loopBudget =
+        loopBudgetOf(test->getBackEdges(), config.loopBudget);
+    jobs.emplace_back(
+        [this, test, activateAll, freshGlobals, loopBudget]() {
+          const bool restored = freshGlobals && restoreLoadedGlobals();
+          activateAll(restored);
+          mull_loopBudget = loopBudget;
+          ExecutionStatus status =
+              constructorsDone && !restored
+                  ? runner.runInitializedTest(*jit, *test)
+                  : runner.runTest(*jit, program, *test);
+          assert(status != ExecutionStatus::Invalid &&
+                 "Expect to see valid TestResult");
+          return status;
+        },
+        timeoutPolicy.timeout(*test), prologue);
+  }
+  return jobs;
+}
+
+void MutantExecutionTask::collectResults(MutationPoint *mutationPoint,
+                                         std::vector<ExecutionResult> &results,
+                                         Out &storage) {
+  auto &reachableTests = mutationPoint->getReachableTests();
+
+  /// Gate mode: a mutant that every test it reaches let through is enough
+  if (config.stopOnSurvivorEnabled && !reachableTests.empty() &&
+      results.size() == reachableTests.size() &&
+      std::all_of(results.begin(), results.end(),
+                  [](const ExecutionResult &result) {
+                    return result.status == ExecutionStatus::Passed;
+                  })) {
+    Cancellation::shared().cancel(Cancellation::Reason::Survivor);
+  }
+
+  /// With the kill matrix every cell goes to the matrix, the table keeps
+  /// one result per mutant: the first test that killed it, or the last
+  /// test that ran
+  size_t kept = std::numeric_limits<size_t>::max();
+  if (killMatrix) {
+    kept = results.empty() ? 0 : results.size() - 1;
+    for (size_t index = 0; index < results.size(); index++) {
+      if (results[index].status != ExecutionStatus::Passed) {
+        kept = index;
+        break;
+      }
+    }
+  }
+
+  for (size_t index = 0; index < reachableTests.size(); index++) {
+    auto test = reachableTests[index].first;
+    auto distance = reachableTests[index].second;
+
+    ExecutionResult result;
+    if (index < results.size()) {
+      result = std::move(results[index]);
+      metrics.addRunMutant(mutationPoint, test, result.runningTime);
+      metrics.addSandboxTimings(result.timings);
+      metrics.addChildUsage(result.usage);
+      metrics.addPerfCounts(result.counts, test->getExecutionResult().counts);
+      if (result.status == ExecutionStatus::Timedout) {
+        metrics.addTimedOutRun(result.runningTime);
+      }
+    } else {
+      result.status = ExecutionStatus::FailFast;
+    }
+
+    if (killMatrix) {
+      killMatrix->set(*mutationPoint, *test, result.status);
+      if (index != kept) {
+        continue;
+      }
+    }
+    outputStore.retain(result);
+
+    MutationResult mutationResult(std::move(result), mutationPoint, distance,
+                                  test);
+    storage.add(mutationResult);
+    if (reporters) {
+      for (auto reporter : *reporters) {
+        reporter->reportMutationResult(mutationResult);
+      }
+    }
   }
 }
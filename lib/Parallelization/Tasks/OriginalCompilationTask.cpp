@@ -3,32 +3,90 @@
 #include "mull/Parallelization/Progress.h"
 #include "mull/Toolchain/Toolchain.h"
 
-#include <llvm/ExecutionEngine/ExecutionEngine.h>
-#include <llvm/Support/TargetSelect.h>
-
 using namespace mull;
 using namespace llvm;
 
-OriginalCompilationTask::OriginalCompilationTask(Toolchain &toolchain)
-    : toolchain(toolchain) {}
+OriginalCompilationTask::OriginalCompilationTask(Toolchain &toolchain,
+                                                 MutantDebugInfo debugInfo)
+    : toolchain(toolchain), debugInfo(debugInfo) {}
 
 void OriginalCompilationTask::operator()(iterator begin, iterator end,
                                          Out &storage,
                                          progress_counter &counter) {
-  EngineBuilder builder;
-  auto target = builder.selectTarget(llvm::Triple(), "", "",
-                                     llvm::SmallVector<std::string, 1>());
-  std::unique_ptr<TargetMachine> localMachine(target);
-
   for (auto it = begin; it != end; it++, counter.increment()) {
-    auto &module = *it->get();
+    compile(*it->get(), storage);
+  }
+}
+
+void OriginalCompilationTask::compile(MullModule &module, Out &storage) {
+  auto &machine = toolchain.workerTargetMachine();
 
+  auto partitions = toolchain.codegenPartitions(module);
+  if (partitions > 1) {
+    compileInParts(module, partitions, storage);
+  } else {
     auto objectFile = toolchain.cache().getObject(module);
     if (objectFile.getBinary() == nullptr) {
-      objectFile = toolchain.compiler().compileModule(module, *localMachine);
+      /// A lazily loaded module is read in full only when it is not cached
+      module.materializeAll();
+      stripDebugInfo(module);
+      objectFile = toolchain.compiler().compileModule(module, machine);
       toolchain.cache().putObject(objectFile, module);
     }
 
     storage.push_back(std::move(objectFile));
   }
+  toolchain.cache().rememberObject(module);
+
+  for (size_t index = 0; index < module.getSatelliteCount(); index++) {
+    auto satelliteObject = toolchain.cache().getSatelliteObject(module, index);
+    if (satelliteObject.getBinary() == nullptr) {
+      satelliteObject = toolchain.compiler().compileModule(
+          module.getSatelliteModule(index), machine);
+      toolchain.cache().putSatelliteObject(satelliteObject, module, index);
+    }
+
+    storage.push_back(std::move(satelliteObject));
+  }
+}
+
+/// The module is compiled again unless all of its parts are in the cache
+void OriginalCompilationTask::compileInParts(MullModule &module,
+                                             unsigned partitions,
+                                             Out &storage) {
+  Out parts;
+  for (unsigned index = 0; index < partitions; index++) {
+    auto part = toolchain.cache().getObject(
+        module, ObjectCache::partSuffix(index, partitions));
+    if (part.getBinary() == nullptr) {
+      break;
+    }
+    parts.push_back(std::move(part));
+  }
+
+  if (parts.size() != partitions) {
+    module.materializeAll();
+    stripDebugInfo(module);
+    auto machine = [this]() -> TargetMachine & {
+      return toolchain.workerTargetMachine();
+    };
+    parts = toolchain.compiler().compileModuleInParts(
+        *module.getModule(), partitions, machine);
+    for (size_t index = 0; index < parts.size(); index++) {
+      if (parts[index].getBinary()) {
+        toolchain.cache().putObject(parts[index], module,
+                                    ObjectCache::partSuffix(index, partitions));
+      }
+    }
+  }
+
+  for (auto &part : parts) {
+    storage.push_back(std::move(part));
+  }
+}
+
+void OriginalCompilationTask::stripDebugInfo(MullModule &module) {
+  if (debugInfo != MutantDebugInfo::Full) {
+    module.stripDebugInfo(debugInfo == MutantDebugInfo::LineTables);
+  }
 }
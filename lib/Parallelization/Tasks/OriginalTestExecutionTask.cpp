@@ -1,52 +1,219 @@
 #include "mull/Parallelization/Tasks/OriginalTestExecutionTask.h"
 
 #include "mull/Config/Configuration.h"
+#include "mull/ExecutionOutput.h"
 #include "mull/ForkProcessSandbox.h"
+#include "mull/Instrumentation/CallSampler.h"
 #include "mull/Instrumentation/Instrumentation.h"
+#include "mull/Instrumentation/ReachabilityCache.h"
+#include "mull/Instrumentation/SampledReachability.h"
+#include "mull/Logger.h"
+#include "mull/Metrics/Metrics.h"
 #include "mull/Parallelization/Progress.h"
+#include "mull/Reporters/Reporter.h"
 #include "mull/TestFrameworks/TestRunner.h"
+#include "mull/TimeoutPolicy.h"
 #include "mull/Toolchain/Toolchain.h"
 
+#include <algorithm>
+#include <cassert>
+
 using namespace mull;
 using namespace llvm;
 
 OriginalTestExecutionTask::OriginalTestExecutionTask(
     Instrumentation &instrumentation, Program &program, ProcessSandbox &sandbox,
-    TestRunner &runner, const Configuration &config, Filter &filter,
-    JITEngine &jit)
+    ExecutionOutputStore &outputStore, TestRunner &runner,
+    const Configuration &config, Filter &filter, JITEngine &jit,
+    Metrics &metrics, ReachabilityCache *reachabilityCache,
+    const std::vector<Reporter *> *reporters, ProcessSandbox *batchSandbox,
+    const FunctionAddresses *sampledFunctions)
     : instrumentation(instrumentation), program(program), sandbox(sandbox),
-      runner(runner), config(config), filter(filter), jit(jit) {}
+      outputStore(outputStore), runner(runner), config(config), filter(filter),
+      jit(jit), metrics(metrics), reachabilityCache(reachabilityCache),
+      reporters(reporters), batchSandbox(batchSandbox),
+      sampledFunctions(sampledFunctions) {}
+
+/// Runs in the child, the samples are left in the buffer of the test
+ExecutionStatus OriginalTestExecutionTask::runTest(Test &test) {
+  auto samples = test.getInstrumentationInfo().samples;
+  if (!sampledFunctions || samples == nullptr) {
+    return runner.runTest(jit, program, test);
+  }
+  CallSampler sampler(uint64_t(config.reachabilitySamplePeriod));
+  auto status = runner.runTest(jit, program, test);
+  sampler.drain(samples, InstrumentationInfo::SampleCapacity);
+  return status;
+}
+
+/// The first run is measured along with the call tree, the others only
+/// feed the timeout policy. Each of them records a call tree of its own,
+/// which is thrown away.
+void OriginalTestExecutionTask::measureRunningTimes(Test &test) {
+  for (int run = 1; run < config.timeoutPolicy.runs; run++) {
+    instrumentation.setupInstrumentationInfo(test);
+    ExecutionResult result = sandbox.run(
+        [&]() { return runner.runTest(jit, program, test); }, config.timeout);
+    instrumentation.cleanupInstrumentationInfo(test);
+    if (result.status != Passed) {
+      break;
+    }
+    test.addRunningTime(TimeoutPolicy::runningTime(result));
+  }
+}
+
+/// The runs compete for the machine the way the mutant runs of the workers
+/// will, which is what brings out a test that depends on the timing. Their
+/// call trees are thrown away.
+void OriginalTestExecutionTask::detectFlakiness(Test &test) {
+  std::vector<std::vector<SandboxJob>> series;
+  for (int run = 0; run < config.flakyRuns; run++) {
+    series.push_back({SandboxJob(
+        [this, &test]() { return runner.runTest(jit, program, test); },
+        config.timeout)});
+  }
+
+  instrumentation.setupInstrumentationInfo(test);
+  auto results = sandbox.runConcurrentSeries(
+      series, series.size(), [](const ExecutionResult &) { return true; });
+  instrumentation.cleanupInstrumentationInfo(test);
+
+  int failed = 0;
+  for (auto &runs : results) {
+    for (auto &result : runs) {
+      if (result.status == Passed) {
+        test.addRunningTime(TimeoutPolicy::runningTime(result));
+      } else {
+        failed++;
+      }
+    }
+  }
+  if (failed > 0) {
+    test.setFlaky(true);
+    Logger::warn() << test.getTestName() << " is flaky, " << failed << " of "
+                   << config.flakyRuns
+                   << " runs did not pass. It reaches no mutant.\n";
+  }
+}
 
 void OriginalTestExecutionTask::operator()(iterator begin, iterator end,
                                            Out &storage,
                                            progress_counter &counter) {
+  if (batchSandbox) {
+    runBatches(begin, end, storage, counter);
+    return;
+  }
+
   for (auto it = begin; it != end; ++it, counter.increment()) {
-    auto &test = *it;
+    auto &test = **it;
 
     instrumentation.setupInstrumentationInfo(test);
 
-    ExecutionResult testExecutionResult = sandbox.run(
-        [&]() { return runner.runTest(jit, program, test); }, config.timeout);
+    metrics.beginRunOriginalTest(&test);
+    ExecutionResult testExecutionResult =
+        sandbox.run([&]() { return runTest(test); }, config.timeout);
+    metrics.endRunOriginalTest(&test);
 
-    test.setExecutionResult(testExecutionResult);
+    finishTest(test, testExecutionResult, storage);
+  }
+}
 
-    std::vector<std::unique_ptr<Testee>> testees;
+/// Every test of a batch records its calls in buffers of its own, the runs
+/// of the tests tell the program which ones. A test that did not pass in
+/// the batch may have failed because of the tests before it, it runs again
+/// in a child of its own, and that run is the one that counts.
+void OriginalTestExecutionTask::runBatches(iterator begin, iterator end,
+                                           Out &storage,
+                                           progress_counter &counter) {
+  const auto batchSize = size_t(config.originalTestBatchSize);
+  while (begin != end) {
+    auto batchEnd = std::next(
+        begin, std::min<ptrdiff_t>(batchSize, std::distance(begin, end)));
 
-    if (testExecutionResult.status == Passed) {
-      testees = instrumentation.getTestees(test, filter, config.maxDistance);
-    } else {
-      auto ssss = test.getTestName() +
-                  " failed: " + testExecutionResult.getStatusAsString() + "\n";
-      errs() << ssss;
+    std::vector<SandboxJob> jobs;
+    for (auto it = begin; it != batchEnd; ++it) {
+      auto test = *it;
+      instrumentation.setupInstrumentationInfo(*test);
+      jobs.emplace_back([this, test]() { return runTest(*test); },
+                        config.timeout);
     }
-    instrumentation.cleanupInstrumentationInfo(test);
+    auto results = batchSandbox->runSeries(
+        jobs, [](const ExecutionResult &) { return true; });
+    assert(results.size() == jobs.size());
+
+    for (auto &result : results) {
+      auto &test = **begin;
+      if (result.status != Passed) {
+        instrumentation.cleanupInstrumentationInfo(test);
+        instrumentation.setupInstrumentationInfo(test);
+        metrics.beginRunOriginalTest(&test);
+        result = sandbox.run([&]() { return runTest(test); }, config.timeout);
+        metrics.endRunOriginalTest(&test);
+      }
+      finishTest(test, result, storage);
+      ++begin;
+      counter.increment();
+    }
+  }
+}
+
+void OriginalTestExecutionTask::finishTest(Test &test,
+                                           ExecutionResult &testExecutionResult,
+                                           Out &storage) {
+  outputStore.retain(testExecutionResult);
+
+  test.setExecutionResult(testExecutionResult);
+  test.addRunningTime(TimeoutPolicy::runningTime(testExecutionResult));
 
-    if (testees.empty()) {
-      continue;
+  std::vector<std::unique_ptr<Testee>> testees;
+  std::vector<std::unique_ptr<Testee>> sampled;
+  Instrumentation::Calls calls;
+
+  if (testExecutionResult.status == Passed) {
+    calls = instrumentation.takeCalls(test);
+    instrumentation.takeCoveredBlocks(test);
+    instrumentation.takeBackEdges(test);
+    testees =
+        instrumentation.getTestees(calls, test, filter, config.maxDistance);
+    if (sampledFunctions) {
+      sampled = sampledTestees(*sampledFunctions,
+                               instrumentation.takeSamples(test), test);
+    }
+  } else {
+    Logger::warn() << test.getTestName() << " failed: "
+                   << testExecutionResult.getStatusAsString() << "\n";
+  }
+  instrumentation.cleanupInstrumentationInfo(test);
+
+  if (testExecutionResult.status == Passed) {
+    measureRunningTimes(test);
+    if (config.flakyRuns > 0) {
+      detectFlakiness(test);
+    }
+    /// The flaky test runs again next time instead of being cached
+    if (test.isFlaky()) {
+      testees.clear();
+      sampled.clear();
+    } else if (reachabilityCache) {
+      reachabilityCache->store(test, calls);
     }
+  }
 
-    for (auto it = std::next(testees.begin()); it != testees.end(); ++it) {
-      storage.push_back(std::move(*it));
+  if (reporters) {
+    for (auto reporter : *reporters) {
+      reporter->reportTestResult(test);
     }
   }
+
+  /// The sampled testees have no test body in front of them
+  for (auto &testee : sampled) {
+    storage.push_back(std::move(testee));
+  }
+  if (testees.empty()) {
+    return;
+  }
+
+  for (auto it = std::next(testees.begin()); it != testees.end(); ++it) {
+    storage.push_back(std::move(*it));
+  }
 }
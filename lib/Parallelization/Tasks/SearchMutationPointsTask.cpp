@@ -1,41 +1,182 @@
 #include "mull/Parallelization/Tasks/SearchMutationPointsTask.h"
 
+#include "mull/DeadValues.h"
 #include "mull/Filter.h"
+#include "mull/Hash.h"
+#include "mull/Instrumentation/BlockCoverage.h"
 #include "mull/Parallelization/Progress.h"
 #include "mull/Program/Program.h"
 
 #include <llvm/IR/Function.h>
+#include <llvm/IR/Instructions.h>
 #include <llvm/IR/Module.h>
 
+#include <functional>
 #include <vector>
 
 using namespace mull;
 using namespace llvm;
 
-static int GetFunctionIndex(llvm::Function *function) {
-  Module *parent = function->getParent();
+SearchMutationPointsTask::SearchMutationPointsTask(
+    Filter &filter, const Program &program,
+    std::vector<std::unique_ptr<Mutator>> &mutators,
+    MutationPointStream *stream, DeadMutantMetrics *deadMutants,
+    const BlockCoverage *blockCoverage, MutationSearchCache *cache)
+    : filter(filter), program(program), mutators(mutators), stream(stream),
+      deadMutants(deadMutants), blockCoverage(blockCoverage), cache(cache) {
+  for (auto &mutator : mutators) {
+    std::vector<bool> accepted;
+    for (unsigned opcode : mutator->getOpcodes()) {
+      if (accepted.size() <= opcode) {
+        accepted.resize(opcode + 1, false);
+      }
+      accepted[opcode] = true;
+    }
+    dispatchTable.push_back(std::move(accepted));
+  }
+}
+
+bool SearchMutationPointsTask::accepts(size_t mutatorIndex,
+                                       const Instruction &instruction) {
+  auto &accepted = dispatchTable[mutatorIndex];
+  if (accepted.empty()) {
+    return true;
+  }
+  unsigned opcode = instruction.getOpcode();
+  return opcode < accepted.size() && accepted[opcode];
+}
 
-  auto functionIterator =
-      std::find_if(parent->begin(), parent->end(),
-                   [function](llvm::Function &f) { return &f == function; });
+std::shared_ptr<const ReachableTests> SearchMutationPointsTask::testsOfBlock(
+    const MergedTestee &testee, int basicBlockIndex,
+    std::map<int, std::shared_ptr<const ReachableTests>> &blocks) {
+  auto known = blocks.find(basicBlockIndex);
+  if (known != blocks.end()) {
+    return known->second;
+  }
 
-  assert(functionIterator != parent->end() &&
-         "Expected function to be found in module");
-  int index =
-      static_cast<int>(std::distance(parent->begin(), functionIterator));
+  auto &tests = testee.getReachableTests();
+  auto function = testee.getTesteeFunction();
+  auto executed = std::make_shared<ReachableTests>();
+  for (size_t index = 0; index < tests.size(); index++) {
+    if (blockCoverage->executed(tests.test(index), function,
+                                basicBlockIndex)) {
+      executed->add(tests.test(index), tests.distance(index));
+    }
+  }
 
-  return index;
+  auto shared = testee.getSharedReachableTests();
+  if (executed->size() != tests.size()) {
+    shared = std::move(executed);
+  }
+  blocks[basicBlockIndex] = shared;
+  return shared;
 }
 
-SearchMutationPointsTask::SearchMutationPointsTask(
-    Filter &filter, const Program &program,
-    std::vector<std::unique_ptr<Mutator>> &mutators)
-    : filter(filter), program(program), mutators(mutators) {}
+void SearchMutationPointsTask::findPoints(
+    MullModule *module, Function *function, int functionIndex,
+    std::vector<std::vector<MutationPoint *>> &points,
+    MutationSearchCache::FunctionPoints &found) {
+  std::vector<size_t> candidates;
+
+  int basicBlockIndex = 0;
+  for (auto &basicBlock : function->getBasicBlockList()) {
+
+    int instructionIndex = 0;
+    for (auto &instruction : basicBlock.getInstList()) {
+      candidates.clear();
+      for (size_t index = 0; index < mutators.size(); index++) {
+        if (accepts(index, instruction)) {
+          candidates.push_back(index);
+        }
+      }
+
+      if (candidates.empty() || filter.shouldSkipInstruction(&instruction)) {
+        instructionIndex++;
+        continue;
+      }
+
+      auto location =
+          SourceLocation::sourceLocationFromInstruction(&instruction);
+
+      MutationPointAddress address(functionIndex, basicBlockIndex,
+                                   instructionIndex);
+      /// Only looked at once a mutator that replaces operands applies
+      int observable = -1;
+      for (size_t index : candidates) {
+        MutationPoint *point = mutators[index]->getMutationPoint(
+            module, function, &instruction, location, address);
+        if (!point) {
+          continue;
+        }
+        if (deadMutants && mutators[index]->replacesOperandsOnly()) {
+          if (observable == -1) {
+            observable = isObservable(instruction);
+          }
+          if (!observable) {
+            if (isa<StoreInst>(instruction)) {
+              found.deadStores++;
+            } else {
+              found.deadValues++;
+            }
+            continue;
+          }
+        }
+        points[index].push_back(point);
+      }
+      instructionIndex++;
+    }
+    basicBlockIndex++;
+  }
+
+  for (size_t index = 0; index < points.size(); index++) {
+    for (auto point : points[index]) {
+      auto address = point->getAddress();
+      found.points.push_back({uint32_t(index), address.getBBIndex(),
+                              address.getIIndex()});
+    }
+  }
+}
+
+bool SearchMutationPointsTask::restorePoints(
+    MullModule *module, Function *function, int functionIndex,
+    const MutationSearchCache::FunctionPoints &stored,
+    std::vector<std::vector<MutationPoint *>> &points) {
+  std::vector<BasicBlock *> blocks;
+  for (auto &basicBlock : function->getBasicBlockList()) {
+    blocks.push_back(&basicBlock);
+  }
+
+  std::vector<Instruction *> instructions;
+  instructions.reserve(stored.points.size());
+  for (auto &point : stored.points) {
+    if (point.mutator >= mutators.size() || point.basicBlock < 0 ||
+        size_t(point.basicBlock) >= blocks.size() || point.instruction < 0 ||
+        size_t(point.instruction) >= blocks[point.basicBlock]->size()) {
+      return false;
+    }
+    auto &instructionList = blocks[point.basicBlock]->getInstList();
+    instructions.push_back(
+        &*std::next(instructionList.begin(), point.instruction));
+  }
 
-void SearchMutationPointsTask::
-operator()(iterator begin, iterator end,
-           std::vector<std::unique_ptr<MutationPoint>> &storage,
-           progress_counter &counter) {
+  for (size_t index = 0; index < stored.points.size(); index++) {
+    auto &point = stored.points[index];
+    auto location =
+        SourceLocation::sourceLocationFromInstruction(instructions[index]);
+    MutationPointAddress address(functionIndex, point.basicBlock,
+                                 point.instruction);
+    auto &mutator = mutators[point.mutator];
+    if (auto restored = mutator->getMutationPoint(
+            module, function, instructions[index], location, address)) {
+      points[point.mutator].push_back(restored);
+    }
+  }
+  return true;
+}
+
+void SearchMutationPointsTask::operator()(iterator begin, iterator end,
+                                          Out &storage,
+                                          progress_counter &counter) {
   for (auto it = begin; it != end; it++, counter.increment()) {
     auto &testee = *it;
     Function *function = testee.getTesteeFunction();
@@ -43,38 +184,50 @@ operator()(iterator begin, iterator end,
     auto moduleID = function->getParent()->getModuleIdentifier();
     MullModule *module = program.moduleWithIdentifier(moduleID);
 
-    int functionIndex = GetFunctionIndex(function);
-    for (auto &mutator : mutators) {
-
-      int basicBlockIndex = 0;
-      for (auto &basicBlock : function->getBasicBlockList()) {
-
-        int instructionIndex = 0;
-        for (auto &instruction : basicBlock.getInstList()) {
-          if (filter.shouldSkipInstruction(&instruction)) {
-            instructionIndex++;
-            continue;
-          }
+    int functionIndex = module->getFunctionIndex(function);
+    MullModule::materialize(function);
+
+    std::vector<std::vector<MutationPoint *>> points(mutators.size());
+    MutationSearchCache::FunctionPoints found;
+    auto name = function->getName().str();
+    if (!cache || !cache->lookup(*module, name, found) ||
+        !restorePoints(module, function, functionIndex, found, points)) {
+      found = MutationSearchCache::FunctionPoints();
+      findPoints(module, function, functionIndex, points, found);
+      if (cache) {
+        cache->store(*module, name, found);
+      }
+    }
+    if (deadMutants) {
+      deadMutants->deadValues += found.deadValues;
+      deadMutants->deadStores += found.deadStores;
+    }
 
-          auto location =
-              SourceLocation::sourceLocationFromInstruction(&instruction);
-
-          MutationPointAddress address(functionIndex, basicBlockIndex,
-                                       instructionIndex);
-          MutationPoint *point = mutator->getMutationPoint(
-              module, function, &instruction, location, address);
-          if (point) {
-            module->addMutation(point);
-            for (auto &reachableTest : testee.getReachableTests()) {
-              point->addReachableTest(reachableTest.first,
-                                      reachableTest.second);
-            }
-            storage.emplace_back(std::unique_ptr<MutationPoint>(point));
-          }
-          instructionIndex++;
+    /// The body is gone once the function is prepared for the mutations
+    std::string functionHash;
+    std::map<int, std::shared_ptr<const ReachableTests>> blocks;
+    std::vector<MutationPoint *> batch;
+    for (auto &mutatorPoints : points) {
+      if (!mutatorPoints.empty() && functionHash.empty()) {
+        functionHash = hashOfFunctionBody(*function);
+      }
+      for (auto point : mutatorPoints) {
+        point->setFunctionHash(functionHash);
+        if (blockCoverage) {
+          point->setReachableTests(testsOfBlock(
+              testee, point->getAddress().getBBIndex(), blocks));
+        } else {
+          point->setReachableTests(testee.getSharedReachableTests());
+        }
+        storage.push_back(point);
+        if (stream) {
+          batch.push_back(point);
         }
-        basicBlockIndex++;
       }
     }
+    if (!batch.empty()) {
+      auto &sourceFile = function->getParent()->getSourceFileName();
+      stream->push(std::hash<std::string>()(sourceFile), std::move(batch));
+    }
   }
 }
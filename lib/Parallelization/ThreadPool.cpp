@@ -0,0 +1,242 @@
+#include "mull/Parallelization/ThreadPool.h"
+
+#include "mull/Config/ConfigurationOptions.h"
+
+#include <llvm/ADT/SmallVector.h>
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace mull;
+
+std::vector<int> mull::parseCPUList(llvm::StringRef list) {
+  std::vector<int> cpus;
+  llvm::SmallVector<llvm::StringRef, 8> ranges;
+  list.trim().split(ranges, ',', -1, false);
+  for (auto &range : ranges) {
+    auto bounds = range.trim().split('-');
+    int first = 0;
+    if (bounds.first.getAsInteger(10, first)) {
+      continue;
+    }
+    int last = first;
+    if (!bounds.second.empty() && bounds.second.getAsInteger(10, last)) {
+      continue;
+    }
+    for (int cpu = first; cpu <= last; cpu++) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+std::vector<int>
+mull::interleaveCPUs(const std::vector<std::vector<int>> &nodes) {
+  std::vector<int> cpus;
+  for (size_t i = 0;; i++) {
+    bool added = false;
+    for (auto &node : nodes) {
+      if (i < node.size()) {
+        cpus.push_back(node[i]);
+        added = true;
+      }
+    }
+    if (!added) {
+      return cpus;
+    }
+  }
+}
+
+static std::vector<std::vector<int>> numaNodes() {
+  std::vector<std::vector<int>> nodes;
+  for (int node = 0;; node++) {
+    std::ifstream file("/sys/devices/system/node/node" +
+                       std::to_string(node) + "/cpulist");
+    std::string list;
+    if (!file || !std::getline(file, list)) {
+      break;
+    }
+    nodes.push_back(parseCPUList(list));
+  }
+  return nodes;
+}
+
+static std::vector<int>
+availableCPUs(const std::vector<std::vector<int>> &nodes) {
+  auto cpus = interleaveCPUs(nodes);
+  if (cpus.empty()) {
+    auto count = std::max(std::thread::hardware_concurrency(), 1u);
+    for (unsigned cpu = 0; cpu < count; cpu++) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+/// The pages the thread touches from now on come from the memory of the
+/// node it runs on. The policy of a thread is inherited by the children it
+/// forks.
+static void preferLocalMemory() {
+#ifdef __linux__
+  static thread_local bool preferred = false;
+  if (preferred) {
+    return;
+  }
+  preferred = true;
+
+  unsigned cpu = 0;
+  unsigned node = 0;
+  if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) {
+    return;
+  }
+  const size_t maxNodes = 1024;
+  const size_t bitsPerWord = 8 * sizeof(unsigned long);
+  unsigned long mask[maxNodes / bitsPerWord] = {0};
+  if (node >= maxNodes) {
+    return;
+  }
+  mask[node / bitsPerWord] |= 1UL << (node % bitsPerWord);
+  syscall(SYS_set_mempolicy, MPOL_PREFERRED, mask, maxNodes);
+#endif
+}
+
+ThreadPool::ThreadPool()
+    : idle(0), pinThreads(false), localMemory(false), stopping(false) {}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  condition.notify_all();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
+ThreadPool &ThreadPool::shared() {
+  static ThreadPool pool;
+  return pool;
+}
+
+void ThreadPool::configure(const ParallelizationConfig &config) {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (config.pinWorkers && !pinThreads) {
+    pinThreads = true;
+    auto nodes = numaNodes();
+    cpus = availableCPUs(nodes);
+    localMemory = nodes.size() > 1;
+    for (size_t i = 0; i < threads.size(); i++) {
+      pin(threads[i], i);
+    }
+  }
+  while (threads.size() < size_t(std::max(config.workers, 0))) {
+    startThread();
+  }
+}
+
+void ThreadPool::run(std::function<void()> job,
+                     std::function<void()> finished) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    jobs.push_back(std::make_pair(std::move(job), std::move(finished)));
+    if (idle < jobs.size()) {
+      startThread();
+    }
+  }
+  condition.notify_one();
+}
+
+size_t ThreadPool::size() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return threads.size();
+}
+
+/// The handles can neither be joined nor detached in the child, they are
+/// leaked instead
+void ThreadPool::forgetThreads() {
+  std::lock_guard<std::mutex> lock(mutex);
+  new std::vector<std::thread>(std::move(threads));
+  threads.clear();
+  idle = 0;
+}
+
+/// A new thread counts as idle right away, otherwise the jobs submitted
+/// before it gets to wait would start even more threads
+void ThreadPool::startThread() {
+  idle++;
+  threads.emplace_back([this]() { work(); });
+  if (pinThreads) {
+    pin(threads.back(), threads.size() - 1);
+  }
+}
+
+void ThreadPool::pin(std::thread &thread, size_t index) {
+#ifdef __linux__
+  if (cpus.empty()) {
+    return;
+  }
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpus[index % cpus.size()], &set);
+  pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+#endif
+}
+
+void ThreadPool::work() {
+  std::unique_lock<std::mutex> lock(mutex);
+  for (;;) {
+    condition.wait(lock, [this]() { return stopping || !jobs.empty(); });
+    if (jobs.empty()) {
+      return;
+    }
+    idle--;
+    auto job = std::move(jobs.front());
+    jobs.pop_front();
+    /// The thread is pinned by now, by whoever started it under the lock
+    bool local = localMemory;
+    lock.unlock();
+    if (local) {
+      preferLocalMemory();
+    }
+    job.first();
+    lock.lock();
+    idle++;
+    if (job.second) {
+      lock.unlock();
+      job.second();
+      lock.lock();
+    }
+  }
+}
+
+WorkerGroup::WorkerGroup(ThreadPool &pool) : pool(pool), pending(0) {}
+
+WorkerGroup::~WorkerGroup() { wait(); }
+
+void WorkerGroup::run(std::function<void()> job) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    pending++;
+  }
+  pool.run(std::move(job), [this]() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (--pending == 0) {
+      condition.notify_all();
+    }
+  });
+}
+
+void WorkerGroup::wait() {
+  std::unique_lock<std::mutex> lock(mutex);
+  condition.wait(lock, [this]() { return pending == 0; });
+}
@@ -0,0 +1,94 @@
+#include "mull/PerfCounters.h"
+
+#include <cstring>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+using namespace mull;
+
+#ifdef __linux__
+
+/// In the order of the fields of PerfCounts, the first one leads the group
+static const uint64_t EventConfigs[] = {
+    PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_BRANCH_MISSES, PERF_COUNT_HW_CACHE_MISSES};
+
+static int openCounter(uint64_t config, int leader) {
+  struct perf_event_attr attributes;
+  memset(&attributes, 0, sizeof(attributes));
+  attributes.type = PERF_TYPE_HARDWARE;
+  attributes.size = sizeof(attributes);
+  attributes.config = config;
+  /// The whole group starts once the leader is enabled
+  attributes.disabled = leader == -1;
+  attributes.inherit = 1;
+  /// What a process may count with the default perf_event_paranoid
+  attributes.exclude_kernel = 1;
+  attributes.exclude_hv = 1;
+  return int(syscall(SYS_perf_event_open, &attributes, 0, -1, leader,
+                     PERF_FLAG_FD_CLOEXEC));
+}
+
+#endif
+
+PerfCounters::PerfCounters(bool enabled) {
+  for (int &descriptor : descriptors) {
+    descriptor = -1;
+  }
+#ifdef __linux__
+  if (!enabled) {
+    return;
+  }
+  descriptors[0] = openCounter(EventConfigs[0], -1);
+  if (descriptors[0] == -1) {
+    return;
+  }
+  for (int index = 1; index < Events; index++) {
+    descriptors[index] = openCounter(EventConfigs[index], descriptors[0]);
+  }
+  ioctl(descriptors[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#else
+  (void)enabled;
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+  for (int descriptor : descriptors) {
+    if (descriptor != -1) {
+      close(descriptor);
+    }
+  }
+}
+
+PerfCounts PerfCounters::read() const {
+  int64_t values[Events] = {0, 0, 0, 0};
+  for (int index = 0; index < Events; index++) {
+    uint64_t value = 0;
+    if (descriptors[index] != -1 &&
+        ::read(descriptors[index], &value, sizeof(value)) == sizeof(value)) {
+      values[index] = int64_t(value);
+    }
+  }
+
+  PerfCounts counts;
+  counts.instructions = values[0];
+  counts.cycles = values[1];
+  counts.branchMisses = values[2];
+  counts.cacheMisses = values[3];
+  return counts;
+}
+
+PerfCounts PerfCounters::since(const PerfCounts &after,
+                               const PerfCounts &before) {
+  PerfCounts counts;
+  counts.instructions = after.instructions - before.instructions;
+  counts.cycles = after.cycles - before.cycles;
+  counts.branchMisses = after.branchMisses - before.branchMisses;
+  counts.cacheMisses = after.cacheMisses - before.cacheMisses;
+  return counts;
+}
@@ -0,0 +1,150 @@
+#include "mull/PreviousResults.h"
+
+#include "mull/MullModule.h"
+#include "mull/MutationPoint.h"
+#include "mull/Mutators/Mutator.h"
+#include "mull/ResultsDatabase.h"
+
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Module.h>
+
+#include <sqlite3.h>
+
+using namespace mull;
+
+static std::string mutantKey(const std::string &mutator,
+                             const std::string &moduleName,
+                             const std::string &functionName,
+                             int basicBlockIndex, int instructionIndex) {
+  return mutator + "\n" + moduleName + "\n" + functionName + "\n" +
+         std::to_string(basicBlockIndex) + "\n" +
+         std::to_string(instructionIndex);
+}
+
+/// The statuses that tell nothing: the tests fail fast skipped, or that did
+/// not run
+static bool isMeaningful(ExecutionStatus status) {
+  return status != ExecutionStatus::Invalid &&
+         status != ExecutionStatus::DryRun &&
+         status != ExecutionStatus::FailFast;
+}
+
+static const char *SelectMutationPoints =
+    "SELECT unique_id, mutator, module_name, function_name, "
+    "basic_block_index, instruction_index, function_hash "
+    "FROM mutation_point";
+
+bool PreviousResults::load(const std::string &databasePath,
+                           std::string &error) {
+  auto database = openResultsDatabase(databasePath, error);
+  if (!database) {
+    return false;
+  }
+
+  sqlite3_stmt *selectPoints = nullptr;
+  sqlite3_stmt *selectResults = nullptr;
+  if (sqlite3_prepare_v2(database, SelectMutationPoints, -1, &selectPoints,
+                         nullptr) != SQLITE_OK ||
+      sqlite3_prepare_v2(database, SelectExecutionResults, -1, &selectResults,
+                         nullptr) != SQLITE_OK) {
+    /// e.g. a database without the hashes of the functions
+    error = sqlite3_errmsg(database);
+    sqlite3_finalize(selectPoints);
+    sqlite3_close(database);
+    return false;
+  }
+
+  std::unordered_map<std::string, std::string> keys;
+  while (sqlite3_step(selectPoints) == SQLITE_ROW) {
+    auto key = mutantKey(columnText(selectPoints, 1),
+                         columnText(selectPoints, 2),
+                         columnText(selectPoints, 3),
+                         sqlite3_column_int(selectPoints, 4),
+                         sqlite3_column_int(selectPoints, 5));
+    keys[columnText(selectPoints, 0)] = key;
+    mutants[key].mutator = columnText(selectPoints, 1);
+    mutants[key].functionHash = columnText(selectPoints, 6);
+  }
+
+  while (sqlite3_step(selectResults) == SQLITE_ROW) {
+    auto key = keys.find(columnText(selectResults, 1));
+    if (key == keys.end()) {
+      continue;
+    }
+    mutants[key->second].results[columnText(selectResults, 0)] =
+        executionResultOf(selectResults);
+  }
+
+  std::unordered_map<std::string, std::pair<size_t, size_t>> killsAndRuns;
+  std::unordered_map<std::string, std::pair<size_t, size_t>> mutatorKills;
+  for (auto &mutant : mutants) {
+    bool ran = false;
+    bool killed = false;
+    for (auto &pair : mutant.second.results) {
+      auto status = pair.second.status;
+      if (!isMeaningful(status)) {
+        continue;
+      }
+      auto &counts = killsAndRuns[pair.first];
+      counts.first += status != ExecutionStatus::Passed;
+      counts.second++;
+      ran = true;
+      killed = killed || status != ExecutionStatus::Passed;
+    }
+    if (ran) {
+      auto &counts = mutatorKills[mutant.second.mutator];
+      counts.first += killed;
+      counts.second++;
+    }
+  }
+  for (auto &pair : killsAndRuns) {
+    killRates[pair.first] = double(pair.second.first) / pair.second.second;
+  }
+  for (auto &pair : mutatorKills) {
+    mutatorKillRates[pair.first] =
+        double(pair.second.first) / pair.second.second;
+  }
+
+  sqlite3_finalize(selectPoints);
+  sqlite3_finalize(selectResults);
+  sqlite3_close(database);
+  return true;
+}
+
+const PreviousResults::StoredMutant *
+PreviousResults::find(MutationPoint &point) const {
+  auto address = point.getAddress();
+  auto key = mutantKey(
+      point.getMutator()->getUniqueIdentifier(),
+      point.getOriginalModule()->getModuleIdentifier(),
+      point.getFunctionName(), address.getBBIndex(),
+      address.getIIndex());
+  auto mutant = mutants.find(key);
+  return mutant == mutants.end() ? nullptr : &mutant->second;
+}
+
+size_t PreviousResults::size() const { return mutants.size(); }
+
+const std::unordered_map<std::string, double> &
+PreviousResults::getKillRates() const {
+  return killRates;
+}
+
+const std::unordered_map<std::string, double> &
+PreviousResults::getMutatorKillRates() const {
+  return mutatorKillRates;
+}
+
+bool PreviousResults::StoredMutant::survived() const {
+  bool ran = false;
+  for (auto &pair : results) {
+    if (!isMeaningful(pair.second.status)) {
+      continue;
+    }
+    if (pair.second.status != ExecutionStatus::Passed) {
+      return false;
+    }
+    ran = true;
+  }
+  return ran;
+}
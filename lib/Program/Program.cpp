@@ -4,6 +4,9 @@
 
 #include <llvm/IR/Constants.h>
 
+#include <algorithm>
+#include <cstdint>
+
 using namespace mull;
 
 Program::Program(std::vector<std::string> dynamicLibraryPaths,
@@ -14,6 +17,21 @@ Program::Program(std::vector<std::string> dynamicLibraryPaths,
   for (auto &module : modules) {
     addModule(std::move(module));
   }
+
+  std::stable_sort(prioritizedConstructors.begin(),
+                   prioritizedConstructors.end(),
+                   [](const std::pair<uint64_t, llvm::Function *> &lhs,
+                      const std::pair<uint64_t, llvm::Function *> &rhs) {
+                     return lhs.first < rhs.first;
+                   });
+  staticConstructors.reserve(prioritizedConstructors.size());
+  staticConstructorNames.reserve(prioritizedConstructors.size());
+  for (auto &constructor : prioritizedConstructors) {
+    staticConstructors.push_back(constructor.second);
+    staticConstructorNames.push_back(constructor.second->getName().str());
+  }
+  std::vector<std::pair<uint64_t, llvm::Function *>>().swap(
+      prioritizedConstructors);
 }
 
 ObjectFiles &Program::precompiledObjectFiles() {
@@ -48,6 +66,8 @@ void Program::addModule(std::unique_ptr<MullModule> module) {
          "Attempt to add a module which has been added already!");
 
   moduleRegistry.insert(std::make_pair(identifier, module.get()));
+  addStaticConstructors(*module->getModule());
+  addGlobalPointers(*module->getModule());
   _modules.emplace_back(std::move(module));
 }
 
@@ -61,60 +81,113 @@ MullModule *Program::moduleWithIdentifier(const std::string &identifier) const {
 
 llvm::Function *
 Program::lookupDefinedFunction(llvm::StringRef FunctionName) const {
-  auto it = functionsRegistry.find(FunctionName.str());
+  auto it = functionsRegistry.find(FunctionName);
   if (it == functionsRegistry.end()) {
     return nullptr;
   }
   return it->second;
 }
 
-std::vector<llvm::Function *> Program::getStaticConstructors() const {
+const std::vector<llvm::Function *> &Program::getStaticConstructors() const {
+  return staticConstructors;
+}
+
+const std::vector<std::string> &Program::getStaticConstructorNames() const {
+  return staticConstructorNames;
+}
+
+void Program::releaseIR() {
+  for (auto &module : _modules) {
+    module->releaseIR();
+  }
+  functionsRegistry.clear();
+  std::vector<llvm::Function *>().swap(staticConstructors);
+  globalPointers.clear();
+}
+
+void Program::addStaticConstructors(llvm::Module &module) {
   using namespace llvm;
   /// NOTE: Just Copied the whole logic from ExecutionEngine
-  std::vector<Function *> Ctors;
+  auto &Ctors = prioritizedConstructors;
+
+  GlobalVariable *GV = module.getNamedGlobal("llvm.global_ctors");
+
+  // If this global has internal linkage, or if it has a use, then it must be
+  // an old-style (llvmgcc3) static ctor with __main linked in and in use.  If
+  // this is the case, don't execute any of the global ctors, __main will do
+  // it.
+  if (!GV || GV->isDeclaration() || GV->hasLocalLinkage())
+    return;
+
+  // Should be an array of '{ i32, void ()* }' structs.  The first value is
+  // the init priority, the constructors are sorted by it once all the
+  // modules are added.
+  ConstantArray *InitList = dyn_cast<ConstantArray>(GV->getInitializer());
+  if (!InitList)
+    return;
+  for (unsigned i = 0, e = InitList->getNumOperands(); i != e; ++i) {
+    ConstantStruct *CS = dyn_cast<ConstantStruct>(InitList->getOperand(i));
+    if (!CS)
+      continue;
 
-  for (auto &module : _modules) {
+    Constant *FP = CS->getOperand(1);
+    if (FP->isNullValue())
+      continue; // Found a sentinal value, ignore.
 
-    GlobalVariable *GV =
-        module->getModule()->getNamedGlobal("llvm.global_ctors");
+    // Strip off constant expression casts.
+    if (ConstantExpr *CE = dyn_cast<ConstantExpr>(FP))
+      if (CE->isCast())
+        FP = CE->getOperand(0);
 
-    // If this global has internal linkage, or if it has a use, then it must be
-    // an old-style (llvmgcc3) static ctor with __main linked in and in use.  If
-    // this is the case, don't execute any of the global ctors, __main will do
-    // it.
-    if (!GV || GV->isDeclaration() || GV->hasLocalLinkage())
-      continue;
+    uint64_t Priority = UINT64_MAX;
+    if (auto PriorityValue = dyn_cast<ConstantInt>(CS->getOperand(0)))
+      Priority = PriorityValue->getZExtValue();
+
+    // Execute the ctor/dtor function!
+    if (Function *F = dyn_cast<Function>(FP))
+      Ctors.push_back(std::make_pair(Priority, F));
 
-    // Should be an array of '{ i32, void ()* }' structs.  The first value is
-    // the init priority, which we ignore.
-    ConstantArray *InitList = dyn_cast<ConstantArray>(GV->getInitializer());
-    if (!InitList)
+    // FIXME: It is marginally lame that we just do nothing here if we see an
+    // entry we don't recognize. It might not be unreasonable for the verifier
+    // to not even allow this and just assert here.
+  }
+}
+
+/// Drops the `.<number>` a context appends to the name of a type it has
+static llvm::StringRef withoutUniqueSuffix(llvm::StringRef typeName) {
+  auto nameAndSuffix = typeName.rsplit('.');
+  unsigned number = 0;
+  if (nameAndSuffix.second.empty() ||
+      nameAndSuffix.second.getAsInteger(10, number)) {
+    return typeName;
+  }
+  return nameAndSuffix.first;
+}
+
+void Program::addGlobalPointers(llvm::Module &module) {
+  for (auto &global : module.getGlobalList()) {
+    auto pointerType = llvm::dyn_cast<llvm::PointerType>(global.getValueType());
+    if (!pointerType) {
+      continue;
+    }
+    auto structType =
+        llvm::dyn_cast<llvm::StructType>(pointerType->getElementType());
+    if (!structType || !structType->hasName()) {
       continue;
-    for (unsigned i = 0, e = InitList->getNumOperands(); i != e; ++i) {
-      ConstantStruct *CS = dyn_cast<ConstantStruct>(InitList->getOperand(i));
-      if (!CS)
-        continue;
-
-      Constant *FP = CS->getOperand(1);
-      if (FP->isNullValue())
-        continue; // Found a sentinal value, ignore.
-
-      // Strip off constant expression casts.
-      if (ConstantExpr *CE = dyn_cast<ConstantExpr>(FP))
-        if (CE->isCast())
-          FP = CE->getOperand(0);
-
-      // Execute the ctor/dtor function!
-      if (Function *F = dyn_cast<Function>(FP))
-        Ctors.push_back(F);
-
-      // FIXME: It is marginally lame that we just do nothing here if we see an
-      // entry we don't recognize. It might not be unreasonable for the verifier
-      // to not even allow this and just assert here.
     }
+    globalPointers[withoutUniqueSuffix(structType->getName())].push_back(
+        &global);
   }
+}
 
-  return Ctors;
+const std::vector<llvm::GlobalVariable *> &
+Program::globalsPointingTo(llvm::StringRef structName) const {
+  static const std::vector<llvm::GlobalVariable *> none;
+  auto it = globalPointers.find(structName);
+  if (it == globalPointers.end()) {
+    return none;
+  }
+  return it->second;
 }
 
 const std::vector<std::string> &Program::getDynamicLibraryPaths() const {
@@ -0,0 +1,49 @@
+#include "mull/ReachableTests.h"
+
+#include "mull/TestFrameworks/Test.h"
+
+using namespace mull;
+
+ReachableTests::ReachableTests(const std::vector<value_type> &pairs) {
+  reserve(pairs.size());
+  for (auto &pair : pairs) {
+    add(pair.first, pair.second);
+  }
+}
+
+void ReachableTests::add(Test *test, int distance) {
+  tests.push_back(test);
+  distances.push_back(distance);
+  testSet.insert(test->getId());
+}
+
+void ReachableTests::append(const ReachableTests &other) {
+  tests.insert(tests.end(), other.tests.begin(), other.tests.end());
+  distances.insert(distances.end(), other.distances.begin(),
+                   other.distances.end());
+  testSet.unite(other.testSet);
+}
+
+bool ReachableTests::contains(const Test &test) const {
+  return testSet.contains(test.getId());
+}
+
+void ReachableTests::reserve(size_t size) {
+  tests.reserve(size);
+  distances.reserve(size);
+}
+
+ReachableTests &
+ReachableTests::modifiable(std::shared_ptr<const ReachableTests> &shared) {
+  if (!shared || shared.use_count() > 1) {
+    shared = shared ? std::make_shared<ReachableTests>(*shared)
+                    : std::make_shared<ReachableTests>();
+  }
+  /// Every list is created modifiable, it is only handed out as const
+  return const_cast<ReachableTests &>(*shared);
+}
+
+const ReachableTests &ReachableTests::none() {
+  static const ReachableTests empty;
+  return empty;
+}
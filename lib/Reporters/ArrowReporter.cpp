@@ -0,0 +1,142 @@
+#include "mull/Reporters/ArrowReporter.h"
+
+#include "mull/ExecutionResult.h"
+#include "mull/Logger.h"
+#include "mull/MutationResult.h"
+#include "mull/Mutators/Mutator.h"
+#include "mull/Reporters/ArrowStream.h"
+#include "mull/Result.h"
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <algorithm>
+#include <ctime>
+#include <sys/param.h>
+
+using namespace mull;
+using namespace llvm;
+
+namespace {
+enum Columns {
+  MutationPointColumn,
+  MutatorColumn,
+  TestColumn,
+  FileColumn,
+  LineColumn,
+  ColumnColumn,
+  StatusColumn,
+  KilledColumn,
+  DurationColumn,
+  DistanceColumn
+};
+} // namespace
+
+static std::vector<ArrowStreamWriter::Column> columns() {
+  using Type = ArrowStreamWriter::ColumnType;
+  return {{"mutation_point", Type::Dictionary}, {"mutator", Type::Dictionary},
+          {"test", Type::Dictionary},           {"file", Type::Dictionary},
+          {"line", Type::Int32},                {"column", Type::Int32},
+          {"status", Type::Dictionary},         {"killed", Type::Bool},
+          {"duration", Type::Int64},            {"distance", Type::Int32}};
+}
+
+ArrowReporter::ArrowReporter(const std::string &projectName,
+                             size_t rowGroupSize)
+    : rowGroupSize(std::max(rowGroupSize, size_t(1))), streaming(false) {
+  SmallString<MAXPATHLEN> filePath;
+  auto error = sys::fs::current_path(filePath);
+  if (error) {
+    Logger::error() << error.message() << "\n";
+  }
+
+  std::string projectNameComponent = projectName;
+  if (!projectNameComponent.empty()) {
+    projectNameComponent += "_";
+  }
+  sys::path::append(filePath, projectNameComponent +
+                                  std::to_string(time(nullptr)) + ".arrows");
+  path = filePath.str();
+}
+
+/// The batches streamed by a run that was never reported are kept
+ArrowReporter::~ArrowReporter() { closeFile(); }
+
+const std::string &ArrowReporter::getPath() const { return path; }
+
+bool ArrowReporter::openFile() {
+  std::error_code error;
+  file = make_unique<raw_fd_ostream>(path, error, sys::fs::F_None);
+  if (error) {
+    Logger::error() << "Cannot write " << path << ": " << error.message()
+                    << "\n";
+    file.reset();
+    return false;
+  }
+  writer = make_unique<ArrowStreamWriter>(*file, columns());
+  return true;
+}
+
+void ArrowReporter::closeFile() {
+  if (writer) {
+    writer->finish();
+    writer.reset();
+  }
+  if (file) {
+    file->close();
+    file.reset();
+  }
+}
+
+void ArrowReporter::addRow(const MutationResult &result) {
+  auto mutationPoint = result.getMutationPoint();
+  auto &executionResult = result.getExecutionResult();
+  auto &location = mutationPoint->getSourceLocation();
+
+  writer->appendString(MutationPointColumn,
+                       mutationPoint->getUniqueIdentifier());
+  writer->appendString(MutatorColumn,
+                       mutationPoint->getMutator()->getUniqueIdentifier());
+  writer->appendString(TestColumn, result.getTest()->getUniqueIdentifier());
+  writer->appendString(FileColumn, location.filePath());
+  writer->appendInteger(LineColumn, location.line);
+  writer->appendInteger(ColumnColumn, location.column);
+  writer->appendString(StatusColumn,
+                       executionStatusAsString(executionResult.status));
+  writer->appendBool(KilledColumn,
+                     executionResult.status != ExecutionStatus::Passed);
+  writer->appendInteger(DurationColumn, executionResult.runningTime);
+  writer->appendInteger(DistanceColumn, result.getMutationDistance());
+  if (writer->pendingRows() >= rowGroupSize) {
+    writer->writeBatch();
+  }
+}
+
+void ArrowReporter::beginStreaming() { streaming = openFile(); }
+
+/// A worker only holds the lock to add its row, and to write a batch every
+/// rowGroupSize rows
+void ArrowReporter::reportMutationResult(const MutationResult &result) {
+  if (!streaming) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex);
+  addRow(result);
+}
+
+void ArrowReporter::reportResults(const Result &result, const RawConfig &config,
+                                  const Metrics &metrics) {
+  if (!streaming) {
+    if (!openFile()) {
+      return;
+    }
+    for (auto mutationResult : result.getMutationResults()) {
+      addRow(mutationResult);
+    }
+  }
+  streaming = false;
+  closeFile();
+  Logger::info() << "Results can be found at '" << path << "'\n";
+}
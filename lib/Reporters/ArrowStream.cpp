@@ -0,0 +1,399 @@
+#include "mull/Reporters/ArrowStream.h"
+
+#include <llvm/Support/raw_ostream.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <functional>
+
+using namespace mull;
+
+/// The values of the unions and enums of Schema.fbs and Message.fbs
+enum : uint8_t { TypeInt = 2, TypeUtf8 = 5, TypeBool = 6 };
+enum : uint8_t {
+  HeaderSchema = 1,
+  HeaderDictionaryBatch = 2,
+  HeaderRecordBatch = 3
+};
+static const int16_t MetadataVersionV5 = 4;
+
+static const uint32_t Continuation = 0xFFFFFFFF;
+
+#pragma mark - FlatBuffers
+
+namespace {
+
+/// Writes an object at the end of the buffer and returns where it starts
+using ObjectWriter = std::function<size_t(std::string &)>;
+
+void align(std::string &buffer, size_t alignment) {
+  buffer.resize((buffer.size() + alignment - 1) / alignment * alignment,
+                '\0');
+}
+
+template <typename T> void put(std::string &buffer, size_t at, T value) {
+  memcpy(&buffer[at], &value, sizeof(T));
+}
+
+template <typename T> size_t append(std::string &buffer, T value) {
+  size_t at = buffer.size();
+  buffer.append(sizeof(T), '\0');
+  put(buffer, at, value);
+  return at;
+}
+
+/// A table is written front to back: its vtable, its fields, then the
+/// objects they refer to, so that every offset points forward as
+/// FlatBuffers wants. The scalars are little-endian, as the host.
+class Table {
+public:
+  template <typename T> Table &scalar(uint16_t slot, T value) {
+    Field field;
+    field.slot = slot;
+    field.size = sizeof(T);
+    field.bits = 0;
+    memcpy(&field.bits, &value, sizeof(T));
+    fields.push_back(std::move(field));
+    return *this;
+  }
+
+  Table &object(uint16_t slot, ObjectWriter writer) {
+    Field field;
+    field.slot = slot;
+    field.size = sizeof(uint32_t);
+    field.bits = 0;
+    field.writer = std::move(writer);
+    fields.push_back(std::move(field));
+    return *this;
+  }
+
+  size_t write(std::string &buffer) const {
+    /// The largest fields first, none of them needs padding then
+    std::vector<const Field *> layout;
+    for (auto &field : fields) {
+      layout.push_back(&field);
+    }
+    std::stable_sort(layout.begin(), layout.end(),
+                     [](const Field *lhs, const Field *rhs) {
+                       return lhs->size > rhs->size;
+                     });
+    uint16_t slots = 0;
+    for (auto &field : fields) {
+      slots = std::max(slots, uint16_t(field.slot + 1));
+    }
+    std::vector<uint16_t> slotOffsets(slots, 0);
+    std::vector<size_t> offsets;
+    size_t size = sizeof(int32_t);
+    size_t alignment = sizeof(int32_t);
+    for (auto field : layout) {
+      size = (size + field->size - 1) / field->size * field->size;
+      slotOffsets[field->slot] = uint16_t(size);
+      offsets.push_back(size);
+      size += field->size;
+      alignment = std::max(alignment, field->size);
+    }
+
+    align(buffer, sizeof(uint16_t));
+    const size_t vtable = buffer.size();
+    append<uint16_t>(buffer, uint16_t(sizeof(uint16_t) * (2 + slots)));
+    append<uint16_t>(buffer, uint16_t(size));
+    for (auto offset : slotOffsets) {
+      append<uint16_t>(buffer, offset);
+    }
+
+    align(buffer, alignment);
+    const size_t table = buffer.size();
+    buffer.append(size, '\0');
+    put<int32_t>(buffer, table, int32_t(table - vtable));
+    for (size_t index = 0; index < layout.size(); index++) {
+      if (!layout[index]->writer) {
+        memcpy(&buffer[table + offsets[index]], &layout[index]->bits,
+               layout[index]->size);
+      }
+    }
+    for (size_t index = 0; index < layout.size(); index++) {
+      if (layout[index]->writer) {
+        const size_t at = table + offsets[index];
+        const size_t object = layout[index]->writer(buffer);
+        put<uint32_t>(buffer, at, uint32_t(object - at));
+      }
+    }
+    return table;
+  }
+
+  operator ObjectWriter() const {
+    Table table = *this;
+    return [table](std::string &buffer) { return table.write(buffer); };
+  }
+
+private:
+  struct Field {
+    uint16_t slot;
+    size_t size;
+    uint64_t bits;
+    ObjectWriter writer;
+  };
+  std::vector<Field> fields;
+};
+
+ObjectWriter string(const std::string &value) {
+  return [value](std::string &buffer) {
+    align(buffer, sizeof(uint32_t));
+    size_t at = append<uint32_t>(buffer, uint32_t(value.size()));
+    buffer += value;
+    buffer.push_back('\0');
+    return at;
+  };
+}
+
+/// The structs of Arrow are all made of int64 fields, they start on 8 bytes
+ObjectWriter structs(const std::vector<int64_t> &values,
+                     size_t fieldsPerStruct) {
+  return [values, fieldsPerStruct](std::string &buffer) {
+    align(buffer, sizeof(uint32_t));
+    if (buffer.size() % sizeof(int64_t) == 0) {
+      buffer.append(sizeof(uint32_t), '\0');
+    }
+    size_t at =
+        append<uint32_t>(buffer, uint32_t(values.size() / fieldsPerStruct));
+    for (auto value : values) {
+      append<int64_t>(buffer, value);
+    }
+    return at;
+  };
+}
+
+ObjectWriter objects(const std::vector<ObjectWriter> &writers) {
+  return [writers](std::string &buffer) {
+    align(buffer, sizeof(uint32_t));
+    size_t at = append<uint32_t>(buffer, uint32_t(writers.size()));
+    const size_t first = buffer.size();
+    buffer.append(sizeof(uint32_t) * writers.size(), '\0');
+    for (size_t index = 0; index < writers.size(); index++) {
+      const size_t slot = first + sizeof(uint32_t) * index;
+      const size_t object = writers[index](buffer);
+      put<uint32_t>(buffer, slot, uint32_t(object - slot));
+    }
+    return at;
+  };
+}
+
+std::string rootTable(const Table &root) {
+  std::string buffer(sizeof(uint32_t), '\0');
+  put<uint32_t>(buffer, 0, uint32_t(root.write(buffer)));
+  return buffer;
+}
+
+/// The buffers of a record batch, each starting on 8 bytes
+struct Body {
+  std::string bytes;
+  /// The offset and the length of every buffer
+  std::vector<int64_t> buffers;
+
+  void add(const void *data, size_t size) {
+    buffers.push_back(int64_t(bytes.size()));
+    buffers.push_back(int64_t(size));
+    if (size != 0) {
+      bytes.append(static_cast<const char *>(data), size);
+    }
+    align(bytes, sizeof(int64_t));
+  }
+};
+
+} // namespace
+
+#pragma mark - Arrow
+
+static Table intType(int32_t bitWidth) {
+  return Table().scalar<int32_t>(0, bitWidth).scalar<uint8_t>(1, 1);
+}
+
+static ObjectWriter field(const ArrowStreamWriter::Column &column,
+                          int64_t dictionaryId) {
+  Table field;
+  field.object(0, string(column.name)).scalar<uint8_t>(1, 0);
+  switch (column.type) {
+  case ArrowStreamWriter::ColumnType::Int32:
+    field.scalar<uint8_t>(2, TypeInt).object(3, intType(32));
+    break;
+  case ArrowStreamWriter::ColumnType::Int64:
+    field.scalar<uint8_t>(2, TypeInt).object(3, intType(64));
+    break;
+  case ArrowStreamWriter::ColumnType::Bool:
+    field.scalar<uint8_t>(2, TypeBool).object(3, Table());
+    break;
+  case ArrowStreamWriter::ColumnType::Dictionary:
+    field.scalar<uint8_t>(2, TypeUtf8).object(3, Table());
+    field.object(4, Table()
+                        .scalar<int64_t>(0, dictionaryId)
+                        .object(1, intType(32))
+                        .scalar<uint8_t>(2, 0));
+    break;
+  }
+  /// The readers want the children even when there are none
+  return field.object(5, objects({}));
+}
+
+static Table recordBatch(int64_t length, const std::vector<int64_t> &nodes,
+                         const Body &body) {
+  return Table()
+      .scalar<int64_t>(0, length)
+      .object(1, structs(nodes, 2))
+      .object(2, structs(body.buffers, 2));
+}
+
+static std::string message(uint8_t headerType, const Table &header,
+                           int64_t bodyLength) {
+  return rootTable(Table()
+                       .scalar<int16_t>(0, MetadataVersionV5)
+                       .scalar<uint8_t>(1, headerType)
+                       .object(2, header)
+                       .scalar<int64_t>(3, bodyLength));
+}
+
+ArrowStreamWriter::ArrowStreamWriter(llvm::raw_ostream &stream,
+                                     std::vector<Column> columns)
+    : stream(stream), finished(false) {
+  for (auto &column : columns) {
+    ColumnData data;
+    data.column = column;
+    data.sent = 0;
+    this->columns.push_back(std::move(data));
+  }
+  writeSchema();
+}
+
+void ArrowStreamWriter::appendInteger(size_t column, int64_t value) {
+  assert(columns[column].column.type == ColumnType::Int32 ||
+         columns[column].column.type == ColumnType::Int64);
+  columns[column].values.push_back(value);
+}
+
+void ArrowStreamWriter::appendBool(size_t column, bool value) {
+  assert(columns[column].column.type == ColumnType::Bool);
+  columns[column].values.push_back(value ? 1 : 0);
+}
+
+void ArrowStreamWriter::appendString(size_t column, const std::string &value) {
+  auto &data = columns[column];
+  assert(data.column.type == ColumnType::Dictionary);
+  auto inserted =
+      data.indices.emplace(value, int32_t(data.dictionary.size()));
+  if (inserted.second) {
+    data.dictionary.push_back(value);
+  }
+  data.values.push_back(inserted.first->second);
+}
+
+size_t ArrowStreamWriter::pendingRows() const {
+  return columns.empty() ? 0 : columns.front().values.size();
+}
+
+void ArrowStreamWriter::writeMessage(const std::string &metadata,
+                                     const std::string &body) {
+  std::string padded = metadata;
+  align(padded, sizeof(int64_t));
+  const int32_t size = int32_t(padded.size());
+  stream.write(reinterpret_cast<const char *>(&Continuation),
+               sizeof(Continuation));
+  stream.write(reinterpret_cast<const char *>(&size), sizeof(size));
+  stream << padded << body;
+}
+
+void ArrowStreamWriter::writeSchema() {
+  std::vector<ObjectWriter> fields;
+  for (size_t index = 0; index < columns.size(); index++) {
+    fields.push_back(field(columns[index].column, int64_t(index)));
+  }
+  auto schema = Table().scalar<int16_t>(0, 0).object(1, objects(fields));
+  writeMessage(message(HeaderSchema, schema, 0), std::string());
+}
+
+/// The dictionary of a column is its index in the schema
+void ArrowStreamWriter::writeDictionary(size_t column) {
+  auto &data = columns[column];
+  std::vector<int32_t> offsets(1, 0);
+  std::string characters;
+  for (size_t index = data.sent; index < data.dictionary.size(); index++) {
+    characters += data.dictionary[index];
+    offsets.push_back(int32_t(characters.size()));
+  }
+  const int64_t length = int64_t(data.dictionary.size() - data.sent);
+
+  Body body;
+  body.add(nullptr, 0);
+  body.add(offsets.data(), offsets.size() * sizeof(int32_t));
+  body.add(characters.data(), characters.size());
+
+  auto batch = Table()
+                   .scalar<int64_t>(0, int64_t(column))
+                   .object(1, recordBatch(length, {length, 0}, body))
+                   .scalar<uint8_t>(2, data.sent != 0);
+  writeMessage(
+      message(HeaderDictionaryBatch, batch, int64_t(body.bytes.size())),
+      body.bytes);
+  data.sent = data.dictionary.size();
+}
+
+void ArrowStreamWriter::writeBatch() {
+  const size_t rows = pendingRows();
+  if (rows == 0 || finished) {
+    return;
+  }
+
+  std::vector<int64_t> nodes;
+  Body body;
+  for (size_t index = 0; index < columns.size(); index++) {
+    auto &data = columns[index];
+    assert(data.values.size() == rows);
+    nodes.push_back(int64_t(rows));
+    nodes.push_back(0);
+    body.add(nullptr, 0);
+    switch (data.column.type) {
+    case ColumnType::Int64:
+      body.add(data.values.data(), rows * sizeof(int64_t));
+      break;
+    case ColumnType::Int32:
+    case ColumnType::Dictionary: {
+      std::vector<int32_t> values(data.values.begin(), data.values.end());
+      body.add(values.data(), rows * sizeof(int32_t));
+      break;
+    }
+    case ColumnType::Bool: {
+      std::vector<uint8_t> bits((rows + 7) / 8, 0);
+      for (size_t row = 0; row < rows; row++) {
+        if (data.values[row]) {
+          bits[row / 8] |= uint8_t(1 << (row % 8));
+        }
+      }
+      body.add(bits.data(), bits.size());
+      break;
+    }
+    }
+    if (data.column.type == ColumnType::Dictionary &&
+        data.dictionary.size() > data.sent) {
+      writeDictionary(index);
+    }
+    data.values.clear();
+  }
+
+  writeMessage(message(HeaderRecordBatch,
+                       recordBatch(int64_t(rows), nodes, body),
+                       int64_t(body.bytes.size())),
+               body.bytes);
+}
+
+void ArrowStreamWriter::finish() {
+  if (finished) {
+    return;
+  }
+  writeBatch();
+  const int32_t endOfStream = 0;
+  stream.write(reinterpret_cast<const char *>(&Continuation),
+               sizeof(Continuation));
+  stream.write(reinterpret_cast<const char *>(&endOfStream),
+               sizeof(endOfStream));
+  stream.flush();
+  finished = true;
+}
@@ -2,97 +2,104 @@
 
 #include "mull/Logger.h"
 #include "mull/MutationResult.h"
+#include "mull/Parallelization/ThreadPool.h"
 #include "mull/Result.h"
+#include "mull/SourceCache.h"
 
+#include <llvm/Support/raw_ostream.h>
+
+#include <algorithm>
+#include <atomic>
 #include <map>
-#include <set>
 #include <string>
-#include <utility>
-#include <vector>
+#include <thread>
 
 using namespace mull;
 
-struct LineOffset {
-  FILE *file;
-  std::vector<uint> offsets;
-  LineOffset(FILE *file, std::vector<uint> offsets)
-      : file(file), offsets(std::move(offsets)) {}
-};
+static bool mutantSurvived(const ExecutionStatus &status) {
+  return status == ExecutionStatus::Passed;
+}
 
-class SourceManager {
-public:
-  std::string getLine(const SourceLocation &location) {
-    LineOffset &lineOffset = getLineOffset(location);
-    assert(location.line < lineOffset.offsets.size());
-
-    uint lineBegin = lineOffset.offsets[location.line - 1];
-    uint lineEnd = lineOffset.offsets[location.line];
-    uint lineLength = lineEnd - lineBegin;
-    fseek(lineOffset.file, lineBegin, SEEK_SET);
-    char *buffer = new char[lineLength + 1];
-    fread(buffer, sizeof(char), lineLength, lineOffset.file);
-    buffer[lineLength] = '\0';
-    auto line = std::string(buffer);
-    free(buffer);
-    return line;
+static void printSurvivedMutant(llvm::raw_ostream &out,
+                                SourceCache &sourceCache,
+                                const MutationPoint &mutant) {
+  auto &sourceLocation = mutant.getSourceLocation();
+  assert(!sourceLocation.isNull() && "Debug information is missing?");
+  out << sourceLocation.filePath() << ":" << sourceLocation.line << ":"
+      << sourceLocation.column << ": warning: " << mutant.getDiagnostics()
+      << "\n";
+  auto line = sourceCache.getLine(sourceLocation);
+  auto caret = SourceCache::caret(line, sourceLocation.column);
+  if (caret.empty()) {
+    return;
   }
-  ~SourceManager() {
-    for (auto &pair : lineOffsets) {
-      fclose(pair.second.file);
-    }
+
+  out << line;
+  if (!line.endswith("\n")) {
+    out << "\n";
   }
+  out << caret << "\n";
+}
 
-private:
-  std::map<std::string, LineOffset> lineOffsets;
+namespace {
 
-  LineOffset &getLineOffset(const SourceLocation &location) {
-    if (lineOffsets.count(location.filePath)) {
-      return lineOffsets.at(location.filePath);
-    }
+/// The survivors of one file and what is reported of them
+struct FileReport {
+  std::vector<const MutationPoint *> mutants;
+  std::string text;
+};
 
-    FILE *file = fopen(location.filePath.c_str(), "rb");
-    if (!file) {
-      perror("IDEReporter");
-    }
-    std::vector<uint> offsets;
-    uint offset = 0;
-    char c = '\n';
-    for (; c != EOF; c = fgetc(file), offset++) {
-      if (c == '\n') {
-        offsets.push_back(offset);
-      }
-    }
+} // namespace
 
-    LineOffset lineOffset(file, offsets);
-    auto inserted =
-        lineOffsets.insert(std::make_pair(location.filePath, lineOffset));
-    return inserted.first->second;
+static bool locatedBefore(const MutationPoint *left,
+                          const MutationPoint *right) {
+  auto &leftLocation = left->getSourceLocation();
+  auto &rightLocation = right->getSourceLocation();
+  if (leftLocation.line != rightLocation.line) {
+    return leftLocation.line < rightLocation.line;
   }
-};
+  return leftLocation.column < rightLocation.column;
+}
 
-static bool mutantSurvived(const ExecutionStatus &status) {
-  return status == ExecutionStatus::Passed;
+static void formatFile(SourceCache &sourceCache, FileReport &report,
+                       size_t maxMutants) {
+  std::stable_sort(report.mutants.begin(), report.mutants.end(),
+                   locatedBefore);
+  llvm::raw_string_ostream out(report.text);
+  size_t reported = report.mutants.size();
+  if (maxMutants > 0) {
+    reported = std::min(reported, maxMutants);
+  }
+  for (size_t index = 0; index < reported; index++) {
+    printSurvivedMutant(out, sourceCache, *report.mutants[index]);
+  }
+  if (reported < report.mutants.size()) {
+    out << report.mutants.front()->getSourceLocation().filePath()
+        << ": note: " << report.mutants.size() - reported
+        << " more survived mutants in this file\n";
+  }
+  out.flush();
 }
 
-static void printSurvivedMutant(SourceManager &sourceManager,
-                                const MutationPoint &mutant) {
-  auto &sourceLocation = mutant.getSourceLocation();
-  assert(!sourceLocation.isNull() && "Debug information is missing?");
-  Logger::info() << sourceLocation.filePath << ":" << sourceLocation.line << ":"
-                 << sourceLocation.column
-                 << ": warning: " << mutant.getDiagnostics() << "\n";
-  auto line = sourceManager.getLine(sourceLocation);
-  assert(sourceLocation.column < line.size());
-  std::string caret(sourceLocation.column, ' ');
-  for (size_t index = 0; index < sourceLocation.column; index++) {
-    if (line[index] == '\t') {
-      caret[index] = '\t';
+/// The files are taken in turns by as many workers as there are cores, the
+/// lines of a file come from the source cache all the workers share
+static void formatFiles(std::vector<FileReport> &reports, size_t maxMutants) {
+  SourceCache sourceCache;
+  std::atomic<size_t> next(0);
+  auto formatNext = [&]() {
+    for (size_t index = next++; index < reports.size(); index = next++) {
+      formatFile(sourceCache, reports[index], maxMutants);
     }
-  }
-  caret[sourceLocation.column - 1] = '^';
+  };
 
-  Logger::info() << line;
-  Logger::info() << caret << "\n";
+  const size_t workerCount = std::min<size_t>(
+      reports.size(), std::max(std::thread::hardware_concurrency(), 1u));
+  WorkerGroup workers(ThreadPool::shared());
+  for (size_t worker = 1; worker < workerCount; worker++) {
+    workers.run(formatNext);
+  }
+  formatNext();
+  workers.wait();
 }
 
 void IDEReporter::reportResults(const Result &result, const RawConfig &config,
@@ -102,31 +109,57 @@ void IDEReporter::reportResults(const Result &result, const RawConfig &config,
     return;
   }
 
-  std::set<MutationPoint *> killedMutants;
-  for (auto &mutationResult : result.getMutationResults()) {
-    auto mutant = mutationResult->getMutationPoint();
-    auto &executionResult = mutationResult->getExecutionResult();
-
-    if (!mutantSurvived(executionResult.status)) {
-      killedMutants.insert(mutant);
+  if (!streaming) {
+    auto &mutationResults = result.getMutationResults();
+    for (size_t row = 0; row < mutationResults.size(); row++) {
+      if (!mutantSurvived(mutationResults.getStatus(row))) {
+        killedMutants.insert(mutationResults.getMutationPoint(row));
+      }
     }
   }
 
+  /// The equivalent mutants may be gone from the points since they ran
+  size_t killedMutantsCount = 0;
+  for (auto mutant : result.getMutationPoints()) {
+    killedMutantsCount += killedMutants.count(mutant);
+  }
   auto survivedMutantsCount =
-      result.getMutationPoints().size() - killedMutants.size();
+      result.getMutationPoints().size() - killedMutantsCount;
 
   Logger::info() << "\nSurvived mutants (" << survivedMutantsCount << "/"
                  << result.getMutationPoints().size() << "):\n\n";
 
-  SourceManager sourceManager;
+  std::map<std::string, FileReport> files;
   for (auto mutant : result.getMutationPoints()) {
     if (killedMutants.find(mutant) == killedMutants.end()) {
-      printSurvivedMutant(sourceManager, *mutant);
+      auto &filePath = mutant->getSourceLocation().filePath();
+      files[filePath].mutants.push_back(mutant);
     }
   }
+  std::vector<FileReport> reports;
+  reports.reserve(files.size());
+  for (auto &file : files) {
+    reports.push_back(std::move(file.second));
+  }
+  formatFiles(reports, maxMutantsPerFile);
+
+  auto &out = Logger::info();
+  for (auto &report : reports) {
+    out << report.text;
+  }
 
   auto rawScore =
-      double(killedMutants.size()) / double(result.getMutationPoints().size());
+      double(killedMutantsCount) / double(result.getMutationPoints().size());
   auto score = uint(rawScore * 100);
   Logger::info() << "Mutation score: " << score << "%\n";
 }
+
+void IDEReporter::beginStreaming() { streaming = true; }
+
+void IDEReporter::reportMutationResult(const MutationResult &result) {
+  if (mutantSurvived(result.getExecutionResult().status)) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex);
+  killedMutants.insert(result.getMutationPoint());
+}
@@ -0,0 +1,243 @@
+#include "mull/Reporters/JSONReporter.h"
+
+#include "mull/Config/RawConfig.h"
+#include "mull/ExecutionResult.h"
+#include "mull/JSON.h"
+#include "mull/Logger.h"
+#include "mull/Metrics/Metrics.h"
+#include "mull/MutationResult.h"
+#include "mull/Mutators/Mutator.h"
+#include "mull/Result.h"
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <set>
+#include <sys/param.h>
+
+using namespace mull;
+using namespace llvm;
+
+static const int RecordVersion = 1;
+
+std::atomic<uint64_t> JSONReporter::nextId(1);
+
+static bool mutantSurvived(ExecutionStatus status) {
+  return status == ExecutionStatus::Passed;
+}
+
+static void appendRecord(std::string &records,
+                         const MutationResult &mutationResult) {
+  auto mutationPoint = mutationResult.getMutationPoint();
+  auto &executionResult = mutationResult.getExecutionResult();
+  auto &location = mutationPoint->getSourceLocation();
+
+  raw_string_ostream record(records);
+  record << "{\"version\": " << RecordVersion
+         << ", \"type\": \"mutation_result\", \"mutation_point\": \""
+         << escapeJSON(mutationPoint->getUniqueIdentifier())
+         << "\", \"mutator\": \""
+         << escapeJSON(mutationPoint->getMutator()->getUniqueIdentifier())
+         << "\", \"test\": \""
+         << escapeJSON(mutationResult.getTest()->getUniqueIdentifier())
+         << "\", \"status\": \""
+         << executionStatusAsString(executionResult.status)
+         << "\", \"killed\": "
+         << (mutantSurvived(executionResult.status) ? "false" : "true")
+         << ", \"duration\": " << executionResult.runningTime
+         << ", \"distance\": " << mutationResult.getMutationDistance()
+         << ", \"file\": \"" << escapeJSON(location.filePath())
+         << "\", \"line\": " << location.line
+         << ", \"column\": " << location.column << "}\n";
+  record.flush();
+}
+
+JSONReporter::JSONReporter(const std::string &projectName, int flushInterval)
+    : flushInterval(std::max(flushInterval, 1)), id(nextId++),
+      finished(false) {
+  SmallString<MAXPATHLEN> filePath;
+  auto error = sys::fs::current_path(filePath);
+  if (error) {
+    Logger::error() << error.message() << "\n";
+  }
+
+  std::string projectNameComponent = projectName;
+  if (!projectNameComponent.empty()) {
+    projectNameComponent += "_";
+  }
+  sys::path::append(filePath, projectNameComponent +
+                                  std::to_string(time(nullptr)) + ".ndjson");
+  path = filePath.str();
+}
+
+JSONReporter::~JSONReporter() {
+  /// The records streamed by a run that was never reported are kept
+  if (writer.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(writerMutex);
+      finished = true;
+    }
+    writerWakeup.notify_one();
+    writer.join();
+  }
+  closeFile();
+}
+
+const std::string &JSONReporter::getPath() const { return path; }
+
+bool JSONReporter::openFile() {
+  std::error_code error;
+  file = make_unique<raw_fd_ostream>(path, error, sys::fs::F_None);
+  if (error) {
+    Logger::error() << "Cannot write " << path << ": " << error.message()
+                    << "\n";
+    file.reset();
+    return false;
+  }
+  return true;
+}
+
+void JSONReporter::closeFile() {
+  if (file) {
+    file->close();
+    file.reset();
+  }
+}
+
+void JSONReporter::beginStreaming() {
+  if (!openFile()) {
+    return;
+  }
+  writer = std::thread(&JSONReporter::writeBuffers, this);
+}
+
+/// Only the first record of a thread takes the lock of the whole reporter,
+/// afterwards the thread finds its buffer on its own, and shares it with the
+/// writer only
+JSONReporter::Buffer &JSONReporter::bufferOfThisThread() {
+  thread_local uint64_t reporterId = 0;
+  thread_local Buffer *buffer = nullptr;
+  if (reporterId != id) {
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    buffers.push_back(make_unique<Buffer>());
+    buffer = buffers.back().get();
+    reporterId = id;
+  }
+  return *buffer;
+}
+
+void JSONReporter::reportMutationResult(const MutationResult &result) {
+  if (!writer.joinable()) {
+    return;
+  }
+
+  std::string record;
+  appendRecord(record, result);
+
+  Buffer &buffer = bufferOfThisThread();
+  std::lock_guard<std::mutex> lock(buffer.mutex);
+  buffer.records += record;
+}
+
+void JSONReporter::writeBuffers() {
+  std::unique_lock<std::mutex> lock(writerMutex);
+  while (!finished) {
+    writerWakeup.wait_for(lock, std::chrono::milliseconds(flushInterval),
+                          [this]() { return finished; });
+    flushBuffers();
+  }
+}
+
+void JSONReporter::flushBuffers() {
+  std::vector<Buffer *> snapshot;
+  {
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    for (auto &buffer : buffers) {
+      snapshot.push_back(buffer.get());
+    }
+  }
+
+  std::string records;
+  for (auto buffer : snapshot) {
+    {
+      std::lock_guard<std::mutex> lock(buffer->mutex);
+      records.swap(buffer->records);
+    }
+    *file << records;
+    records.clear();
+  }
+  file->flush();
+}
+
+void JSONReporter::reportResults(const Result &result, const RawConfig &config,
+                                 const Metrics &metrics) {
+  if (writer.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(writerMutex);
+      finished = true;
+    }
+    writerWakeup.notify_one();
+    writer.join();
+  } else {
+    if (!openFile()) {
+      return;
+    }
+    std::string records;
+    for (auto mutationResult : result.getMutationResults()) {
+      appendRecord(records, mutationResult);
+    }
+    *file << records;
+  }
+
+  std::set<MutationPoint *> killedMutants;
+  auto &mutationResults = result.getMutationResults();
+  for (size_t row = 0; row < mutationResults.size(); row++) {
+    if (!mutantSurvived(mutationResults.getStatus(row))) {
+      killedMutants.insert(mutationResults.getMutationPoint(row));
+    }
+  }
+
+  *file << "{\"version\": " << RecordVersion
+        << ", \"type\": \"summary\", \"project\": \""
+        << escapeJSON(config.getProjectName())
+        << "\", \"tests\": " << result.getTests().size()
+        << ", \"mutation_points\": " << result.getMutationPoints().size()
+        << ", \"mutation_results\": " << result.getMutationResults().size()
+        << ", \"killed\": " << killedMutants.size() << ", \"latencies\": {";
+  bool firstStage = true;
+  for (auto &stage : metrics.latencies().stages()) {
+    auto &histogram = *stage.second;
+    if (histogram.count() == 0) {
+      continue;
+    }
+    *file << (firstStage ? "" : ", ") << "\"" << stage.first
+          << "\": {\"count\": " << histogram.count()
+          << ", \"p50\": " << histogram.percentile(50)
+          << ", \"p90\": " << histogram.percentile(90)
+          << ", \"p99\": " << histogram.percentile(99)
+          << ", \"max\": " << histogram.max() << "}";
+    firstStage = false;
+  }
+  *file << "}";
+  auto usage = metrics.childUsage();
+  if (usage.runs != 0) {
+    *file << ", \"usage\": {\"runs\": " << usage.runs
+          << ", \"user_time\": " << usage.userTime
+          << ", \"system_time\": " << usage.systemTime
+          << ", \"max_resident\": " << usage.maxResident
+          << ", \"minor_faults\": " << usage.minorFaults
+          << ", \"major_faults\": " << usage.majorFaults
+          << ", \"voluntary_switches\": " << usage.voluntarySwitches
+          << ", \"involuntary_switches\": " << usage.involuntarySwitches
+          << "}";
+  }
+  *file << "}\n";
+  closeFile();
+
+  Logger::info() << "Results can be found at '" << path << "'\n";
+}
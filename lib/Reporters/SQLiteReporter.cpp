@@ -2,12 +2,14 @@
 
 #include "mull/Config/RawConfig.h"
 #include "mull/ExecutionResult.h"
+#include "mull/Hash.h"
 #include "mull/Logger.h"
 #include "mull/MullModule.h"
 #include "mull/MutationResult.h"
 #include "mull/Result.h"
 
 #include "mull/Metrics/Metrics.h"
+#include "mull/Metrics/TimingHistory.h"
 #include "mull/Mutators/Mutator.h"
 
 #include <llvm/IR/DebugInfoMetadata.h>
@@ -18,6 +20,8 @@
 #include <llvm/Support/Path.h>
 #include <llvm/Support/raw_ostream.h>
 
+#include <algorithm>
+#include <cassert>
 #include <sqlite3.h>
 #include <sstream>
 #include <string>
@@ -27,7 +31,15 @@
 using namespace mull;
 using namespace llvm;
 
-static void createTables(sqlite3 *database);
+static void createTables(sqlite3 *database, SQLiteSchema schema);
+static void createIndexes(sqlite3 *database, SQLiteSchema schema);
+static bool mergePartial(sqlite3 *database, const std::string &partialPath,
+                         bool first, std::string &error);
+
+/// How many mutation results the workers may be ahead of the writer
+static const size_t StreamingQueueCapacity = 4096;
+/// The streamed results are committed every so many rows
+static const size_t StreamingCommitInterval = 10000;
 
 static std::string vectorToCsv(const std::vector<std::string> &v) {
   if (v.empty()) {
@@ -63,7 +75,32 @@ void sqlite_step(sqlite3 *database, sqlite3_stmt *stmt) {
   }
 }
 
-SQLiteReporter::SQLiteReporter(const std::string &projectName) {
+/// The statements are reused for every row, SQLite is told so when it
+/// supports it
+static sqlite3_stmt *sqlite_prepare(sqlite3 *database, const char *sql) {
+  sqlite3_stmt *stmt = nullptr;
+#if SQLITE_VERSION_NUMBER >= 3020000
+  int result = sqlite3_prepare_v3(database, sql, -1, SQLITE_PREPARE_PERSISTENT,
+                                  &stmt, nullptr);
+#else
+  int result = sqlite3_prepare_v2(database, sql, -1, &stmt, nullptr);
+#endif
+  if (result != SQLITE_OK) {
+    Logger::error() << "Cannot prepare " << sql << '\n';
+    Logger::error() << "Reason: '" << sqlite3_errmsg(database) << "'\n";
+    Logger::error() << "Shutting down\n";
+    exit(18);
+  }
+  return stmt;
+}
+
+SQLiteReporter::SQLiteReporter(const std::string &projectName,
+                               SQLiteSchema schema, int writers)
+    : schema(schema), database(nullptr), insertExecutionResultStmt(nullptr),
+      insertMutationResultStmt(nullptr), writers(std::max(writers, 1)),
+      nextShard(0), insertTestIdStmt(nullptr),
+      insertMutationPointIdStmt(nullptr), insertFileStmt(nullptr),
+      insertFunctionStmt(nullptr), insertContentStmt(nullptr) {
   SmallString<MAXPATHLEN> databasePath;
   auto error = llvm::sys::fs::current_path(databasePath);
   if (error) {
@@ -86,230 +123,436 @@ SQLiteReporter::SQLiteReporter(const std::string &projectName) {
 
 std::string mull::SQLiteReporter::getDatabasePath() { return databasePath; }
 
-void mull::SQLiteReporter::reportResults(const Result &result,
-                                         const RawConfig &config,
-                                         const Metrics &metrics) {
-
-  std::string databasePath = getDatabasePath();
+SQLiteReporter::~SQLiteReporter() {
+  /// The results streamed by a run that was never reported are kept, in
+  /// the shards when there are some
+  shards.clear();
+  if (writer.joinable()) {
+    queue->close();
+    writer.join();
+  }
+  if (database) {
+    sqlite_exec(database, "END TRANSACTION");
+    closeDatabase();
+  }
+}
 
-  sqlite3 *database;
+/// Nothing needs to survive a crash of the machine, a run can be repeated,
+/// so the writes skip the syncs and the per-transaction journal copies
+void SQLiteReporter::openDatabase() {
   sqlite3_open(databasePath.c_str(), &database);
-
-  createTables(database);
+  sqlite_exec(database, "PRAGMA journal_mode = WAL");
+  sqlite_exec(database, "PRAGMA synchronous = OFF");
+
+  createTables(database, schema);
+
+  if (schema == SQLiteSchema::Normalized) {
+    /// A test may run a mutant only once
+    insertExecutionResultStmt = sqlite_prepare(
+        database, "INSERT OR IGNORE INTO execution_result_entry VALUES (?1, "
+                  "?2, ?3, ?4, ?5, ?6)");
+    insertMutationResultStmt = sqlite_prepare(
+        database,
+        "INSERT OR IGNORE INTO mutation_result_entry VALUES (?1, ?2, ?3)");
+    insertTestIdStmt = sqlite_prepare(
+        database, "INSERT INTO test_entry (id, unique_id) VALUES (?1, ?2)");
+    insertMutationPointIdStmt = sqlite_prepare(
+        database,
+        "INSERT INTO mutation_point_entry (id, unique_id) VALUES (?1, ?2)");
+    insertFileStmt =
+        sqlite_prepare(database, "INSERT INTO file VALUES (?1, ?2, ?3)");
+    insertFunctionStmt =
+        sqlite_prepare(database, "INSERT INTO function VALUES (?1, ?2, ?3)");
+    insertContentStmt =
+        sqlite_prepare(database, "INSERT INTO content VALUES (?1, ?2)");
+  } else {
+    insertExecutionResultStmt = sqlite_prepare(
+        database,
+        "INSERT INTO execution_result VALUES (?1, ?2, ?3, ?4, ?5, ?6)");
+    insertMutationResultStmt = sqlite_prepare(
+        database, "INSERT INTO mutation_result VALUES (?1, ?2, ?3)");
+  }
 
   sqlite_exec(database, "BEGIN TRANSACTION");
+}
 
-  const char *insertExecutionResultQuery =
-      "INSERT INTO execution_result VALUES (?1, ?2, ?3, ?4, ?5, ?6)";
-  sqlite3_stmt *insertExecutionResultStmt;
-  sqlite3_prepare(database, insertExecutionResultQuery, -1,
-                  &insertExecutionResultStmt, NULL);
+void SQLiteReporter::closeDatabase() {
+  for (sqlite3_stmt **stmt :
+       {&insertExecutionResultStmt, &insertMutationResultStmt,
+        &insertTestIdStmt, &insertMutationPointIdStmt, &insertFileStmt,
+        &insertFunctionStmt, &insertContentStmt}) {
+    sqlite3_finalize(*stmt);
+    *stmt = nullptr;
+  }
 
-  const char *insertTestQuery = "INSERT INTO test VALUES (?1, ?2, ?3, ?4)";
-  sqlite3_stmt *insertTestStmt;
-  sqlite3_prepare(database, insertTestQuery, -1, &insertTestStmt, NULL);
+  sqlite3_close(database);
+  database = nullptr;
+}
 
-  for (auto &test : result.getTests()) {
-    std::string testName = test.getTestDisplayName();
-    std::string testUniqueId = test.getUniqueIdentifier();
-    ExecutionResult testExecutionResult = test.getExecutionResult();
+void SQLiteReporter::beginStreaming() {
+  assert(!database && shards.empty() && "Streaming started twice?");
+  if (writers > 1 && schema == SQLiteSchema::Default) {
+    for (int index = 0; index < writers; index++) {
+      auto shard = make_unique<SQLiteReporter>("", schema);
+      shard->databasePath = databasePath + ".shard-" + std::to_string(index);
+      shard->beginStreaming();
+      shards.push_back(std::move(shard));
+    }
+    return;
+  }
 
-    auto testLocation =
-        SourceLocation::sourceLocationFromFunction(test.getTestBody());
+  openDatabase();
+  queue = make_unique<BoundedQueue<MutationResult>>(
+      StreamingQueueCapacity);
+  writer = std::thread(&SQLiteReporter::writeMutationResults, this);
+}
+
+void SQLiteReporter::reportMutationResult(const MutationResult &result) {
+  if (!shards.empty()) {
+    auto index = nextShard.fetch_add(1, std::memory_order_relaxed);
+    shards[index % shards.size()]->reportMutationResult(result);
+    return;
+  }
+  assert(queue && "Expect beginStreaming to be called first");
+  queue->push(result);
+}
+
+void SQLiteReporter::writeMutationResults() {
+  MutationResult mutationResult(ExecutionResult(), nullptr, 0, nullptr);
+  size_t rows = 0;
+  while (queue->pop(mutationResult)) {
+    insertMutationResult(mutationResult);
+    if (++rows % StreamingCommitInterval == 0) {
+      sqlite_exec(database, "COMMIT TRANSACTION");
+      sqlite_exec(database, "BEGIN TRANSACTION");
+    }
+  }
+}
+
+#pragma mark - Interning
+
+/// Gives the key the id of the row inserted the first time the key is seen.
+/// The statement takes the id, then the values.
+int64_t SQLiteReporter::intern(std::unordered_map<std::string, int64_t> &ids,
+                               const std::string &key, sqlite3_stmt *stmt,
+                               const std::vector<std::string> &values) {
+  auto existing = ids.find(key);
+  if (existing != ids.end()) {
+    return existing->second;
+  }
+
+  int64_t id = ids.size() + 1;
+  int index = 1;
+  sqlite3_bind_int64(stmt, index++, id);
+  for (auto &value : values) {
+    sqlite3_bind_text(stmt, index++, value.c_str(), -1, SQLITE_TRANSIENT);
+  }
+  sqlite_step(database, stmt);
+  sqlite3_clear_bindings(stmt);
+  sqlite3_reset(stmt);
+
+  ids[key] = id;
+  return id;
+}
+
+/// The row holds the identifier only until the test is reported, so that
+/// the streamed results refer to something if the run does not finish
+int64_t SQLiteReporter::internTest(const std::string &uniqueId) {
+  return intern(testIds, uniqueId, insertTestIdStmt, {uniqueId});
+}
+
+int64_t SQLiteReporter::internMutationPoint(const std::string &uniqueId) {
+  return intern(mutationPointIds, uniqueId, insertMutationPointIdStmt,
+                {uniqueId});
+}
+
+int64_t SQLiteReporter::internFile(const std::string &filePath,
+                                   const std::string &directory) {
+  return intern(fileIds, filePath + '\0' + directory, insertFileStmt,
+                {filePath, directory});
+}
+
+int64_t SQLiteReporter::internFunction(const std::string &moduleName,
+                                       const std::string &name) {
+  return intern(functionIds, moduleName + '\0' + name, insertFunctionStmt,
+                {moduleName, name});
+}
+
+/// The outputs are told apart by their hashes rather than kept in memory
+int64_t SQLiteReporter::internContent(const std::string &content) {
+  return intern(contentIds, hashOf(content, HashAlgorithm::XXHash64),
+                insertContentStmt, {content});
+}
 
-    int executionResultIndex = 1;
-    sqlite3_bind_text(insertExecutionResultStmt, executionResultIndex++,
-                      testUniqueId.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(insertExecutionResultStmt, executionResultIndex++, "", -1,
+#pragma mark - Rows
+
+void SQLiteReporter::insertExecutionResult(
+    const std::string &testId, const std::string &mutationPointId,
+    const ExecutionResult &executionResult) {
+  sqlite3_stmt *stmt = insertExecutionResultStmt;
+  int index = 1;
+  if (schema == SQLiteSchema::Normalized) {
+    /// The runs of the tests themselves have no mutation point, 0
+    sqlite3_bind_int64(stmt, index++, internTest(testId));
+    sqlite3_bind_int64(stmt, index++,
+                       mutationPointId.empty()
+                           ? 0
+                           : internMutationPoint(mutationPointId));
+    sqlite3_bind_int(stmt, index++, executionResult.status);
+    sqlite3_bind_int64(stmt, index++, executionResult.runningTime);
+    sqlite3_bind_int64(stmt, index++,
+                       internContent(executionResult.stdoutOutput.str()));
+    sqlite3_bind_int64(stmt, index++,
+                       internContent(executionResult.stderrOutput.str()));
+  } else {
+    sqlite3_bind_text(stmt, index++, testId.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, index++, mutationPointId.c_str(), -1,
                       SQLITE_TRANSIENT);
-    sqlite3_bind_int(insertExecutionResultStmt, executionResultIndex++,
-                     testExecutionResult.status);
-    sqlite3_bind_int64(insertExecutionResultStmt, executionResultIndex++,
-                       testExecutionResult.runningTime);
-    sqlite3_bind_text(insertExecutionResultStmt, executionResultIndex++,
-                      testExecutionResult.stdoutOutput.c_str(), -1,
+    sqlite3_bind_int(stmt, index++, executionResult.status);
+    sqlite3_bind_int64(stmt, index++, executionResult.runningTime);
+    sqlite3_bind_text(stmt, index++,
+                      executionResult.stdoutOutput.str().c_str(), -1,
                       SQLITE_TRANSIENT);
-    sqlite3_bind_text(insertExecutionResultStmt, executionResultIndex++,
-                      testExecutionResult.stderrOutput.c_str(), -1,
+    sqlite3_bind_text(stmt, index++,
+                      executionResult.stderrOutput.str().c_str(), -1,
                       SQLITE_TRANSIENT);
+  }
+
+  sqlite_step(database, stmt);
+  sqlite3_clear_bindings(stmt);
+  sqlite3_reset(stmt);
+}
+
+void SQLiteReporter::insertMutationResult(
+    const MutationResult &mutationResult) {
+  std::string testId = mutationResult.getTest()->getUniqueIdentifier();
+  std::string pointId =
+      mutationResult.getMutationPoint()->getUniqueIdentifier();
+
+  insertExecutionResult(testId, pointId, mutationResult.getExecutionResult());
+
+  sqlite3_stmt *stmt = insertMutationResultStmt;
+  int index = 1;
+  if (schema == SQLiteSchema::Normalized) {
+    sqlite3_bind_int64(stmt, index++, internTest(testId));
+    sqlite3_bind_int64(stmt, index++, internMutationPoint(pointId));
+  } else {
+    sqlite3_bind_text(stmt, index++, testId.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, index++, pointId.c_str(), -1, SQLITE_TRANSIENT);
+  }
+  sqlite3_bind_int(stmt, index++, mutationResult.getMutationDistance());
+
+  sqlite_step(database, stmt);
+  sqlite3_clear_bindings(stmt);
+  sqlite3_reset(stmt);
+}
+
+void SQLiteReporter::insertTest(sqlite3_stmt *stmt, const Test &test) {
+  std::string testName = test.getTestDisplayName();
+  std::string testUniqueId = test.getUniqueIdentifier();
+
+  auto testLocation = test.getSourceLocation();
+
+  int index = 1;
+  if (schema == SQLiteSchema::Normalized) {
+    sqlite3_bind_int64(stmt, index++, internTest(testUniqueId));
+  }
+  sqlite3_bind_text(stmt, index++, testName.c_str(), -1, SQLITE_TRANSIENT);
+  sqlite3_bind_text(stmt, index++, testUniqueId.c_str(), -1,
+                    SQLITE_TRANSIENT);
+  if (schema == SQLiteSchema::Normalized) {
+    sqlite3_bind_int64(
+        stmt, index++,
+        internFile(testLocation.filePath(), testLocation.directory()));
+  } else {
+    sqlite3_bind_text(stmt, index++, testLocation.filePath().c_str(), -1,
+                      SQLITE_TRANSIENT);
+  }
+  sqlite3_bind_int(stmt, index++, testLocation.line);
+
+  sqlite_step(database, stmt);
+  sqlite3_clear_bindings(stmt);
+  sqlite3_reset(stmt);
+}
 
-    int testIndex = 1;
-    sqlite3_bind_text(insertTestStmt, testIndex++, testName.c_str(), -1,
+void SQLiteReporter::insertMutationPoint(sqlite3_stmt *stmt,
+                                         MutationPoint &mutationPoint) {
+  SourceLocation location = mutationPoint.getSourceLocation();
+  std::string mutator = mutationPoint.getMutator()->getUniqueIdentifier();
+  std::string moduleName =
+      mutationPoint.getOriginalModule()->getModuleIdentifier();
+  std::string functionName = mutationPoint.getFunctionName();
+  std::string uniqueId = mutationPoint.getUniqueIdentifier();
+
+  int index = 1;
+  if (schema == SQLiteSchema::Normalized) {
+    sqlite3_bind_int64(stmt, index++, internMutationPoint(uniqueId));
+    sqlite3_bind_text(stmt, index++, mutator.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int64(stmt, index++,
+                       internFunction(moduleName, functionName));
+  } else {
+    sqlite3_bind_text(stmt, index++, mutator.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, index++, moduleName.c_str(), -1,
                       SQLITE_TRANSIENT);
-    sqlite3_bind_text(insertTestStmt, testIndex++, testUniqueId.c_str(), -1,
+    sqlite3_bind_text(stmt, index++, functionName.c_str(), -1,
                       SQLITE_TRANSIENT);
-    sqlite3_bind_text(insertTestStmt, testIndex++,
-                      testLocation.filePath.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_int(insertTestStmt, testIndex++, testLocation.line);
-
-    sqlite_step(database, insertExecutionResultStmt);
-    sqlite3_clear_bindings(insertExecutionResultStmt);
-    sqlite3_reset(insertExecutionResultStmt);
-
-    sqlite_step(database, insertTestStmt);
-    sqlite3_clear_bindings(insertTestStmt);
-    sqlite3_reset(insertTestStmt);
-  }
-
-  const char *insertMutationResultQuery =
-      "INSERT INTO mutation_result VALUES (?1, ?2, ?3)";
-  sqlite3_stmt *insertMutationResultStmt;
-  sqlite3_prepare(database, insertMutationResultQuery, -1,
-                  &insertMutationResultStmt, nullptr);
-
-  for (auto &mutationResult : result.getMutationResults()) {
-    MutationPoint *mutationPoint = mutationResult->getMutationPoint();
-    std::string testId = mutationResult->getTest()->getUniqueIdentifier();
-    std::string pointId = mutationPoint->getUniqueIdentifier();
-
-    ExecutionResult mutationExecutionResult =
-        mutationResult->getExecutionResult();
-
-    int executionResultIndex = 1;
-    sqlite3_bind_text(insertExecutionResultStmt, executionResultIndex++,
-                      testId.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(insertExecutionResultStmt, executionResultIndex++,
-                      pointId.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_int(insertExecutionResultStmt, executionResultIndex++,
-                     mutationExecutionResult.status);
-    sqlite3_bind_int64(insertExecutionResultStmt, executionResultIndex++,
-                       mutationExecutionResult.runningTime);
-    sqlite3_bind_text(insertExecutionResultStmt, executionResultIndex++,
-                      mutationExecutionResult.stdoutOutput.c_str(), -1,
+  }
+
+  sqlite3_bind_int(stmt, index++, mutationPoint.getAddress().getFnIndex());
+  sqlite3_bind_int(stmt, index++, mutationPoint.getAddress().getBBIndex());
+  sqlite3_bind_int(stmt, index++, mutationPoint.getAddress().getIIndex());
+
+  if (schema == SQLiteSchema::Normalized) {
+    sqlite3_bind_int64(stmt, index++,
+                       internFile(location.filePath(), location.directory()));
+  } else {
+    sqlite3_bind_text(stmt, index++, location.filePath().c_str(), -1,
                       SQLITE_TRANSIENT);
-    sqlite3_bind_text(insertExecutionResultStmt, executionResultIndex++,
-                      mutationExecutionResult.stderrOutput.c_str(), -1,
+    sqlite3_bind_text(stmt, index++, location.directory().c_str(), -1,
                       SQLITE_TRANSIENT);
+  }
+  sqlite3_bind_text(stmt, index++, mutationPoint.getDiagnostics().c_str(), -1,
+                    SQLITE_TRANSIENT);
 
-    sqlite3_step(insertExecutionResultStmt);
-    sqlite3_clear_bindings(insertExecutionResultStmt);
-    sqlite3_reset(insertExecutionResultStmt);
-
-    int mutationResultIndex = 1;
-    sqlite3_bind_text(insertMutationResultStmt, mutationResultIndex++,
-                      testId.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(insertMutationResultStmt, mutationResultIndex++,
-                      pointId.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_int(insertMutationResultStmt, mutationResultIndex++,
-                     mutationResult->getMutationDistance());
-
-    sqlite3_step(insertMutationResultStmt);
-    sqlite3_clear_bindings(insertMutationResultStmt);
-    sqlite3_reset(insertMutationResultStmt);
-  }
-
-  const char *insertMutationPointQuery =
-      "INSERT OR IGNORE INTO mutation_point VALUES (?1, ?2, ?3, ?4, ?5, ?6, "
-      "?7, ?8, ?9, ?10, ?11, ?12)";
-  sqlite3_stmt *insertMutationPointStmt;
-  sqlite3_prepare(database, insertMutationPointQuery, -1,
-                  &insertMutationPointStmt, NULL);
-
-  const char *insertMutationPointDebugQuery =
-      "INSERT OR IGNORE INTO mutation_point_debug VALUES (?1, ?2, ?3, ?4, ?5, "
-      "?6, ?7, ?8)";
-  sqlite3_stmt *insertMutationPointDebugStmt;
-  sqlite3_prepare(database, insertMutationPointDebugQuery, -1,
-                  &insertMutationPointDebugStmt, NULL);
+  sqlite3_bind_int(stmt, index++, location.line);
+  sqlite3_bind_int(stmt, index++, location.column);
 
-  for (auto mutationPoint : result.getMutationPoints()) {
-    Instruction *instruction =
-        dyn_cast<Instruction>(mutationPoint->getOriginalValue());
+  sqlite3_bind_text(stmt, index++, uniqueId.c_str(), -1, SQLITE_TRANSIENT);
+  sqlite3_bind_text(stmt, index++, mutationPoint.getFunctionHash().c_str(), -1,
+                    SQLITE_TRANSIENT);
 
-    SourceLocation location =
-        mutationPoint
-            ->getSourceLocation(); // SourceLocation::sourceLocationFromInstruction(instruction);
+  sqlite3_step(stmt);
+  sqlite3_clear_bindings(stmt);
+  sqlite3_reset(stmt);
+}
 
-    int index = 1;
-    sqlite3_bind_text(
-        insertMutationPointStmt, index++,
-        mutationPoint->getMutator()->getUniqueIdentifier().c_str(), -1,
-        SQLITE_TRANSIENT);
-    sqlite3_bind_text(insertMutationPointStmt, index++,
-                      mutationPoint->getOriginalModule()
-                          ->getModule()
-                          ->getModuleIdentifier()
-                          .c_str(),
-                      -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(
-        insertMutationPointStmt, index++,
-        mutationPoint->getOriginalFunction()->getName().str().c_str(), -1,
-        SQLITE_TRANSIENT);
-
-    sqlite3_bind_int(insertMutationPointStmt, index++,
-                     mutationPoint->getAddress().getFnIndex());
-    sqlite3_bind_int(insertMutationPointStmt, index++,
-                     mutationPoint->getAddress().getBBIndex());
-    sqlite3_bind_int(insertMutationPointStmt, index++,
-                     mutationPoint->getAddress().getIIndex());
-
-    sqlite3_bind_text(insertMutationPointStmt, index++,
-                      location.filePath.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(insertMutationPointStmt, index++,
-                      location.directory.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(insertMutationPointStmt, index++,
-                      mutationPoint->getDiagnostics().c_str(), -1,
+/// The normalized schema keeps the text of a function or a basic block once
+/// for all the mutation points in it, and takes the location from the point
+void SQLiteReporter::insertMutationPointDebug(sqlite3_stmt *stmt,
+                                              MutationPoint &mutationPoint) {
+  /// Nothing to show once the IR is released
+  Instruction *instruction =
+      dyn_cast_or_null<Instruction>(mutationPoint.getOriginalValue());
+  if (!instruction) {
+    return;
+  }
+  SourceLocation location = mutationPoint.getSourceLocation();
+
+  std::string function;
+  llvm::raw_string_ostream f_ostream(function);
+  instruction->getFunction()->print(f_ostream);
+
+  std::string basicBlock;
+  llvm::raw_string_ostream bb_ostream(basicBlock);
+  instruction->getParent()->print(bb_ostream);
+
+  std::string instr;
+  llvm::raw_string_ostream i_ostream(instr);
+  instruction->print(i_ostream);
+
+  std::string uniqueId = mutationPoint.getUniqueIdentifier();
+
+  int index = 1;
+  if (schema == SQLiteSchema::Normalized) {
+    sqlite3_bind_int64(stmt, index++, internMutationPoint(uniqueId));
+    sqlite3_bind_int64(stmt, index++, internContent(f_ostream.str()));
+    sqlite3_bind_int64(stmt, index++, internContent(bb_ostream.str()));
+    sqlite3_bind_text(stmt, index++, i_ostream.str().c_str(), -1,
+                      SQLITE_TRANSIENT);
+  } else {
+    sqlite3_bind_text(stmt, index++, location.filePath().c_str(), -1,
+                      SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, index++, location.directory().c_str(), -1,
                       SQLITE_TRANSIENT);
 
-    sqlite3_bind_int(insertMutationPointStmt, index++, location.line);
-    sqlite3_bind_int(insertMutationPointStmt, index++, location.column);
+    sqlite3_bind_int(stmt, index++, location.line);
+    sqlite3_bind_int(stmt, index++, location.column);
 
-    sqlite3_bind_text(insertMutationPointStmt, index++,
-                      mutationPoint->getUniqueIdentifier().c_str(), -1,
+    sqlite3_bind_text(stmt, index++, f_ostream.str().c_str(), -1,
+                      SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, index++, bb_ostream.str().c_str(), -1,
+                      SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, index++, i_ostream.str().c_str(), -1,
                       SQLITE_TRANSIENT);
 
-    sqlite3_step(insertMutationPointStmt);
-    sqlite3_clear_bindings(insertMutationPointStmt);
-    sqlite3_reset(insertMutationPointStmt);
+    sqlite3_bind_text(stmt, index++, uniqueId.c_str(), -1, SQLITE_TRANSIENT);
+  }
 
-    std::string mutationPointID = mutationPoint->getUniqueIdentifier();
+  sqlite3_step(stmt);
+  sqlite3_clear_bindings(stmt);
+  sqlite3_reset(stmt);
+}
 
-    if (config.shouldEmitDebugInfo()) {
-      std::string function;
-      llvm::raw_string_ostream f_ostream(function);
-      instruction->getFunction()->print(f_ostream);
+#pragma mark - Report
 
-      std::string basicBlock;
-      llvm::raw_string_ostream bb_ostream(basicBlock);
-      instruction->getParent()->print(bb_ostream);
+void mull::SQLiteReporter::reportResults(const Result &result,
+                                         const RawConfig &config,
+                                         const Metrics &metrics) {
+  const bool streamed = writer.joinable() || !shards.empty();
+  if (writer.joinable()) {
+    queue->close();
+    writer.join();
+  } else {
+    openDatabase();
+  }
+  if (!shards.empty()) {
+    mergeShards();
+  }
 
-      std::string instr;
-      llvm::raw_string_ostream i_ostream(instr);
-      instruction->print(i_ostream);
+  const bool normalized = schema == SQLiteSchema::Normalized;
 
-      int index = 1;
-      sqlite3_bind_text(insertMutationPointDebugStmt, index++,
-                        location.filePath.c_str(), -1, SQLITE_TRANSIENT);
-      sqlite3_bind_text(insertMutationPointDebugStmt, index++,
-                        location.directory.c_str(), -1, SQLITE_TRANSIENT);
-
-      sqlite3_bind_int(insertMutationPointDebugStmt, index++, location.line);
-      sqlite3_bind_int(insertMutationPointDebugStmt, index++, location.column);
-
-      sqlite3_bind_text(insertMutationPointDebugStmt, index++,
-                        f_ostream.str().c_str(), -1, SQLITE_TRANSIENT);
-      sqlite3_bind_text(insertMutationPointDebugStmt, index++,
-                        bb_ostream.str().c_str(), -1, SQLITE_TRANSIENT);
-      sqlite3_bind_text(insertMutationPointDebugStmt, index++,
-                        i_ostream.str().c_str(), -1, SQLITE_TRANSIENT);
-
-      sqlite3_bind_text(insertMutationPointDebugStmt, index++,
-                        mutationPoint->getUniqueIdentifier().c_str(), -1,
-                        SQLITE_TRANSIENT);
+  /// The normalized rows replace the ones holding only the identifier
+  sqlite3_stmt *insertTestStmt = sqlite_prepare(
+      database, normalized
+                    ? "INSERT OR REPLACE INTO test_entry VALUES (?1, ?2, ?3, "
+                      "?4, ?5)"
+                    : "INSERT INTO test VALUES (?1, ?2, ?3, ?4)");
+
+  for (auto &test : result.getTests()) {
+    insertExecutionResult(test.getUniqueIdentifier(), "",
+                          test.getExecutionResult());
+    insertTest(insertTestStmt, test);
+  }
+
+  sqlite3_finalize(insertTestStmt);
 
-      sqlite3_step(insertMutationPointDebugStmt);
-      sqlite3_clear_bindings(insertMutationPointDebugStmt);
-      sqlite3_reset(insertMutationPointDebugStmt);
+  if (!streamed) {
+    for (auto mutationResult : result.getMutationResults()) {
+      insertMutationResult(mutationResult);
     }
   }
 
+  sqlite3_stmt *insertMutationPointStmt = sqlite_prepare(
+      database, normalized
+                    ? "INSERT OR REPLACE INTO mutation_point_entry VALUES "
+                      "(?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8, ?9, ?10, ?11, ?12)"
+                    : "INSERT OR IGNORE INTO mutation_point VALUES (?1, ?2, "
+                      "?3, ?4, ?5, ?6, ?7, ?8, ?9, ?10, ?11, ?12, ?13)");
+
+  sqlite3_stmt *insertMutationPointDebugStmt = sqlite_prepare(
+      database, normalized
+                    ? "INSERT OR IGNORE INTO mutation_point_debug_entry "
+                      "VALUES (?1, ?2, ?3, ?4)"
+                    : "INSERT OR IGNORE INTO mutation_point_debug VALUES "
+                      "(?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8)");
+
+  for (auto mutationPoint : result.getMutationPoints()) {
+    insertMutationPoint(insertMutationPointStmt, *mutationPoint);
+    if (config.shouldEmitDebugInfo()) {
+      insertMutationPointDebug(insertMutationPointDebugStmt, *mutationPoint);
+    }
+  }
+
+  sqlite3_finalize(insertMutationPointStmt);
+  sqlite3_finalize(insertMutationPointDebugStmt);
+
   /// Config
   {
     const char *insertConfigQuery =
         "INSERT INTO config VALUES(?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8, ?9, ?10, "
         "?11, ?12, ?13, ?14, ?15)";
-    sqlite3_stmt *insertConfigStmt;
-    sqlite3_prepare(database, insertConfigQuery, -1, &insertConfigStmt, NULL);
+    sqlite3_stmt *insertConfigStmt =
+        sqlite_prepare(database, insertConfigQuery);
 
     // Start and end times are not part of a config however we are
     // mixing them in to make them into a final report.
@@ -351,13 +594,242 @@ void mull::SQLiteReporter::reportResults(const Result &result,
     sqlite3_bind_int64(insertConfigStmt, index++, endTime);
 
     sqlite3_step(insertConfigStmt);
+    sqlite3_finalize(insertConfigStmt);
+  }
+
+  /// The kill matrix, a blob of packed cells per mutant, see KillMatrix
+  if (auto killMatrix = result.getKillMatrix()) {
+    sqlite3_stmt *insertTestStmt = sqlite_prepare(
+        database, "INSERT INTO kill_matrix_test VALUES (?1, ?2)");
+    for (size_t column = 0; column < killMatrix->getColumnCount(); column++) {
+      sqlite3_bind_int64(insertTestStmt, 1, column);
+      sqlite3_bind_text(insertTestStmt, 2,
+                        killMatrix->getTestIdentifier(column).c_str(), -1,
+                        SQLITE_TRANSIENT);
+      sqlite3_step(insertTestStmt);
+      sqlite3_reset(insertTestStmt);
+    }
+    sqlite3_finalize(insertTestStmt);
+
+    sqlite3_stmt *insertRowStmt = sqlite_prepare(
+        database, "INSERT OR REPLACE INTO kill_matrix VALUES (?1, ?2)");
+    for (size_t row = 0; row < killMatrix->getRowCount(); row++) {
+      auto point = killMatrix->getMutationPoint(row);
+      sqlite3_bind_text(insertRowStmt, 1,
+                        point->getUniqueIdentifier().c_str(), -1,
+                        SQLITE_TRANSIENT);
+      /// The cells are mapped until the result is destroyed
+      sqlite3_bind_blob(insertRowStmt, 2, killMatrix->getRow(row),
+                        killMatrix->getRowSize(), SQLITE_STATIC);
+      sqlite3_step(insertRowStmt);
+      sqlite3_reset(insertRowStmt);
+    }
+    sqlite3_finalize(insertRowStmt);
+  }
+
+  /// Latencies
+  {
+    sqlite3_stmt *insertLatencyStmt = sqlite_prepare(
+        database, "INSERT INTO latency VALUES (?1, ?2, ?3, ?4, ?5, ?6)");
+    for (auto &stage : metrics.latencies().stages()) {
+      auto &histogram = *stage.second;
+      if (histogram.count() == 0) {
+        continue;
+      }
+      int index = 1;
+      sqlite3_bind_text(insertLatencyStmt, index++, stage.first, -1,
+                        SQLITE_STATIC);
+      sqlite3_bind_int64(insertLatencyStmt, index++, histogram.count());
+      sqlite3_bind_int64(insertLatencyStmt, index++, histogram.percentile(50));
+      sqlite3_bind_int64(insertLatencyStmt, index++, histogram.percentile(90));
+      sqlite3_bind_int64(insertLatencyStmt, index++, histogram.percentile(99));
+      sqlite3_bind_int64(insertLatencyStmt, index++, histogram.max());
+      sqlite3_step(insertLatencyStmt);
+      sqlite3_reset(insertLatencyStmt);
+    }
+    sqlite3_finalize(insertLatencyStmt);
+  }
+
+  /// Timings
+  {
+    sqlite3_stmt *insertTimingStmt =
+        sqlite_prepare(database, "INSERT INTO timing VALUES (?1, ?2)");
+    for (auto &timing : metrics.timings()) {
+      sqlite3_bind_text(insertTimingStmt, 1, timing.name.c_str(), -1,
+                        SQLITE_TRANSIENT);
+      sqlite3_bind_double(insertTimingStmt, 2, timing.milliseconds);
+      sqlite3_step(insertTimingStmt);
+      sqlite3_reset(insertTimingStmt);
+    }
+    sqlite3_finalize(insertTimingStmt);
+  }
+
+  /// Resource usage
+  auto usage = metrics.childUsage();
+  if (usage.runs != 0) {
+    sqlite3_stmt *insertUsageStmt = sqlite_prepare(
+        database, "INSERT INTO resource_usage VALUES "
+                  "(?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8)");
+    int64_t values[] = {int64_t(usage.runs),
+                        int64_t(usage.userTime),
+                        int64_t(usage.systemTime),
+                        int64_t(usage.maxResident),
+                        int64_t(usage.minorFaults),
+                        int64_t(usage.majorFaults),
+                        int64_t(usage.voluntarySwitches),
+                        int64_t(usage.involuntarySwitches)};
+    for (int index = 0; index < 8; index++) {
+      sqlite3_bind_int64(insertUsageStmt, index + 1, values[index]);
+    }
+    sqlite3_step(insertUsageStmt);
+    sqlite3_finalize(insertUsageStmt);
   }
 
+  createIndexes(database, schema);
+
   sqlite_exec(database, "END TRANSACTION");
 
-  sqlite3_close(database);
+  closeDatabase();
+
+  Logger::info() << "Results can be found at '" << databasePath << "'\n";
+}
+
+#pragma mark - Merging
+
+/// ATTACH is not allowed within a transaction: the one of openDatabase
+/// ends, and each shard is merged in a transaction of its own. A shard that
+/// cannot be merged is left next to the report.
+void SQLiteReporter::mergeShards() {
+  std::vector<std::string> paths;
+  for (auto &shard : shards) {
+    paths.push_back(shard->databasePath);
+  }
+  /// Waits for the writers to drain their queues and closes the shards
+  shards.clear();
+
+  sqlite_exec(database, "END TRANSACTION");
+  for (auto &path : paths) {
+    std::string error;
+    if (!mergePartial(database, path, false, error)) {
+      Logger::error() << "Cannot merge the results of a writer: " << error
+                      << "\n";
+      continue;
+    }
+    llvm::sys::fs::remove(path);
+  }
+  sqlite_exec(database, "BEGIN TRANSACTION");
+}
+
+/// The views of the normalized schema have the columns of the default one,
+/// so the partials of either schema merge the same way
+static const char *MergeMutants = R"MergeMutants(
+INSERT OR IGNORE INTO test
+  SELECT test_name, unique_id, location_file, location_line
+  FROM partial.test;
+INSERT OR IGNORE INTO mutation_point
+  SELECT mutator, module_name, function_name, function_index,
+         basic_block_index, instruction_index, filename, directory,
+         diagnostics, line_number, column_number, unique_id, function_hash
+  FROM partial.mutation_point;
+INSERT OR IGNORE INTO mutation_point_debug
+  SELECT filename, directory, line_number, column_number, function,
+         basic_block, instruction, unique_id
+  FROM partial.mutation_point_debug;
+INSERT INTO mutation_result
+  SELECT test_id, mutation_point_id, mutation_distance
+  FROM partial.mutation_result;
+INSERT INTO execution_result
+  SELECT test_id, mutation_point_id, status, duration, stdout, stderr
+  FROM partial.execution_result WHERE mutation_point_id != '';
+)MergeMutants";
+
+/// Taken from the first partial only
+static const char *MergeRun = R"MergeRun(
+INSERT INTO execution_result
+  SELECT test_id, mutation_point_id, status, duration, stdout, stderr
+  FROM partial.execution_result WHERE mutation_point_id = '';
+INSERT INTO config SELECT * FROM partial.config;
+INSERT INTO latency SELECT * FROM partial.latency;
+INSERT INTO timing SELECT * FROM partial.timing;
+INSERT INTO resource_usage SELECT * FROM partial.resource_usage;
+)MergeRun";
+
+static bool mergeStatements(sqlite3 *database, const char *sql,
+                            std::string &error) {
+  char *errorMessage = nullptr;
+  if (sqlite3_exec(database, sql, nullptr, nullptr, &errorMessage) !=
+      SQLITE_OK) {
+    error = errorMessage ? errorMessage : "unknown error";
+    sqlite3_free(errorMessage);
+    return false;
+  }
+  return true;
+}
+
+static bool mergePartial(sqlite3 *database, const std::string &partialPath,
+                         bool first, std::string &error) {
+  /// ATTACH would create an empty database instead
+  if (!llvm::sys::fs::exists(partialPath)) {
+    error = partialPath + " does not exist";
+    return false;
+  }
+
+  sqlite3_stmt *attach = nullptr;
+  if (sqlite3_prepare_v2(database, "ATTACH DATABASE ?1 AS partial", -1,
+                         &attach, nullptr) != SQLITE_OK) {
+    error = sqlite3_errmsg(database);
+    return false;
+  }
+  sqlite3_bind_text(attach, 1, partialPath.c_str(), -1, SQLITE_TRANSIENT);
+  int attached = sqlite3_step(attach);
+  sqlite3_finalize(attach);
+  if (attached != SQLITE_DONE) {
+    error = sqlite3_errmsg(database);
+    return false;
+  }
+
+  /// ATTACH is not allowed within a transaction, so there is one per partial
+  bool merged = mergeStatements(database, "BEGIN TRANSACTION", error) &&
+                mergeStatements(database, MergeMutants, error) &&
+                (!first || mergeStatements(database, MergeRun, error)) &&
+                mergeStatements(database, "END TRANSACTION", error);
+  if (!merged) {
+    error = partialPath + ": " + error;
+    std::string ignored;
+    mergeStatements(database, "ROLLBACK", ignored);
+  }
+  std::string ignored;
+  mergeStatements(database, "DETACH DATABASE partial", ignored);
+  return merged;
+}
+
+bool mull::mergeSQLiteDatabases(const std::string &outputPath,
+                                const std::vector<std::string> &partialPaths,
+                                std::string &error) {
+  if (llvm::sys::fs::exists(outputPath)) {
+    error = outputPath + " already exists";
+    return false;
+  }
+
+  sqlite3 *database = nullptr;
+  if (sqlite3_open(outputPath.c_str(), &database) != SQLITE_OK) {
+    error = sqlite3_errmsg(database);
+    sqlite3_close(database);
+    return false;
+  }
+  sqlite_exec(database, "PRAGMA synchronous = OFF");
+  createTables(database, SQLiteSchema::Default);
 
-  outs() << "Results can be found at '" << databasePath << "'\n";
+  bool merged = true;
+  for (size_t index = 0; index < partialPaths.size() && merged; index++) {
+    merged = mergePartial(database, partialPaths[index], index == 0, error);
+  }
+  if (merged) {
+    createIndexes(database, SQLiteSchema::Default);
+  }
+
+  sqlite3_close(database);
+  return merged;
 }
 
 #pragma mark - Database Schema
@@ -391,7 +863,8 @@ CREATE TABLE mutation_point (
   diagnostics TEXT,
   line_number INT,
   column_number INT,
-  unique_id TEXT UNIQUE
+  unique_id TEXT UNIQUE,
+  function_hash TEXT
 );
 
 CREATE TABLE mutation_result (
@@ -410,7 +883,9 @@ CREATE TABLE mutation_point_debug (
   instruction TEXT,
   unique_id TEXT UNIQUE
 );
+)CreateTables";
 
+static const char *CreateConfigTable = R"ConfigTable(
 CREATE TABLE config (
   project_name TEXT,
   bitcode_paths TEXT,
@@ -428,8 +903,219 @@ CREATE TABLE config (
   time_start INT,
   time_end INT
 );
-)CreateTables";
+)ConfigTable";
+
+/// The distributions of the stages of the mutant runs, in nanoseconds
+static const char *CreateLatencyTable = R"LatencyTable(
+CREATE TABLE latency (
+  stage TEXT,
+  count INT,
+  p50 INT,
+  p90 INT,
+  p99 INT,
+  max INT
+);
+)LatencyTable";
+
+/// The phases of the run and the compilation of the modules, see
+/// Metrics::timings
+static const char *CreateTimingTable = R"TimingTable(
+CREATE TABLE timing (
+  name TEXT,
+  milliseconds REAL
+);
+)TimingTable";
+
+/// What the children of the mutant runs used in total, see UsageMetrics.
+/// The times are in microseconds, the peak resident memory in kilobytes.
+static const char *CreateResourceUsageTable = R"UsageTable(
+CREATE TABLE resource_usage (
+  runs INT,
+  user_time INT,
+  system_time INT,
+  max_resident INT,
+  minor_faults INT,
+  major_faults INT,
+  voluntary_switches INT,
+  involuntary_switches INT
+);
+)UsageTable";
+
+/// The cells of a mutant are packed two bits per test, in the order of the
+/// columns: 0 not run, 1 survived, 2 killed, 3 timed out or crashed
+static const char *CreateKillMatrixTables = R"KillMatrixTables(
+CREATE TABLE kill_matrix_test (
+  column_index INT PRIMARY KEY,
+  test_id TEXT
+);
+
+CREATE TABLE kill_matrix (
+  mutation_point_id TEXT PRIMARY KEY,
+  cells BLOB
+);
+)KillMatrixTables";
+
+/// The rows refer to each other by integer keys. The results are keyed on
+/// the mutation point first, which is how they are looked up, so they are
+/// stored in that order instead of next to a rowid and a separate index.
+/// A mutation point id of 0 is the run of the test itself.
+static const char *CreateNormalizedTables = R"NormalizedTables(
+CREATE TABLE file (
+  id INTEGER PRIMARY KEY,
+  path TEXT,
+  directory TEXT
+);
+
+CREATE TABLE function (
+  id INTEGER PRIMARY KEY,
+  module_name TEXT,
+  name TEXT
+);
 
-static void createTables(sqlite3 *database) {
-  sqlite_exec(database, CreateTables);
+CREATE TABLE content (
+  id INTEGER PRIMARY KEY,
+  text TEXT
+);
+
+CREATE TABLE test_entry (
+  id INTEGER PRIMARY KEY,
+  test_name TEXT,
+  unique_id TEXT UNIQUE,
+  file_id INT,
+  location_line INT
+);
+
+CREATE TABLE mutation_point_entry (
+  id INTEGER PRIMARY KEY,
+  mutator TEXT,
+  function_id INT,
+  function_index INT,
+  basic_block_index INT,
+  instruction_index INT,
+  file_id INT,
+  diagnostics TEXT,
+  line_number INT,
+  column_number INT,
+  unique_id TEXT UNIQUE,
+  function_hash TEXT
+);
+
+CREATE TABLE execution_result_entry (
+  test_id INT NOT NULL,
+  mutation_point_id INT NOT NULL,
+  status INT,
+  duration INT,
+  stdout_id INT,
+  stderr_id INT,
+  PRIMARY KEY (mutation_point_id, test_id)
+) WITHOUT ROWID;
+
+CREATE TABLE mutation_result_entry (
+  test_id INT NOT NULL,
+  mutation_point_id INT NOT NULL,
+  mutation_distance INT,
+  PRIMARY KEY (mutation_point_id, test_id)
+) WITHOUT ROWID;
+
+CREATE TABLE mutation_point_debug_entry (
+  mutation_point_id INTEGER PRIMARY KEY,
+  function_id INT,
+  basic_block_id INT,
+  instruction TEXT
+);
+
+CREATE VIEW execution_result AS
+SELECT test.unique_id AS test_id,
+       COALESCE(point.unique_id, '') AS mutation_point_id,
+       result.status AS status,
+       result.duration AS duration,
+       stdout.text AS stdout,
+       stderr.text AS stderr
+FROM execution_result_entry AS result
+JOIN test_entry AS test ON test.id = result.test_id
+LEFT JOIN mutation_point_entry AS point
+  ON point.id = result.mutation_point_id
+LEFT JOIN content AS stdout ON stdout.id = result.stdout_id
+LEFT JOIN content AS stderr ON stderr.id = result.stderr_id;
+
+CREATE VIEW test AS
+SELECT test.test_name AS test_name,
+       test.unique_id AS unique_id,
+       file.path AS location_file,
+       test.location_line AS location_line
+FROM test_entry AS test
+LEFT JOIN file ON file.id = test.file_id;
+
+CREATE VIEW mutation_point AS
+SELECT point.mutator AS mutator,
+       function.module_name AS module_name,
+       function.name AS function_name,
+       point.function_index AS function_index,
+       point.basic_block_index AS basic_block_index,
+       point.instruction_index AS instruction_index,
+       file.path AS filename,
+       file.directory AS directory,
+       point.diagnostics AS diagnostics,
+       point.line_number AS line_number,
+       point.column_number AS column_number,
+       point.unique_id AS unique_id,
+       point.function_hash AS function_hash
+FROM mutation_point_entry AS point
+LEFT JOIN function ON function.id = point.function_id
+LEFT JOIN file ON file.id = point.file_id;
+
+CREATE VIEW mutation_result AS
+SELECT test.unique_id AS test_id,
+       point.unique_id AS mutation_point_id,
+       result.mutation_distance AS mutation_distance
+FROM mutation_result_entry AS result
+JOIN test_entry AS test ON test.id = result.test_id
+JOIN mutation_point_entry AS point ON point.id = result.mutation_point_id;
+
+CREATE VIEW mutation_point_debug AS
+SELECT file.path AS filename,
+       file.directory AS directory,
+       point.line_number AS line_number,
+       point.column_number AS column_number,
+       function.text AS function,
+       basic_block.text AS basic_block,
+       debug.instruction AS instruction,
+       point.unique_id AS unique_id
+FROM mutation_point_debug_entry AS debug
+JOIN mutation_point_entry AS point ON point.id = debug.mutation_point_id
+LEFT JOIN file ON file.id = point.file_id
+LEFT JOIN content AS function ON function.id = debug.function_id
+LEFT JOIN content AS basic_block ON basic_block.id = debug.basic_block_id;
+)NormalizedTables";
+
+/// Built once all the rows are in, rather than updated on every insert
+static const char *CreateIndexes = R"CreateIndexes(
+CREATE INDEX execution_result_mutation_point_id
+  ON execution_result (mutation_point_id);
+CREATE INDEX mutation_result_mutation_point_id
+  ON mutation_result (mutation_point_id);
+CREATE INDEX mutation_result_test_id ON mutation_result (test_id);
+)CreateIndexes";
+
+static const char *CreateNormalizedIndexes = R"NormalizedIndex(
+CREATE INDEX mutation_result_entry_test_id
+  ON mutation_result_entry (test_id);
+)NormalizedIndex";
+
+static void createTables(sqlite3 *database, SQLiteSchema schema) {
+  sqlite_exec(database, schema == SQLiteSchema::Normalized
+                            ? CreateNormalizedTables
+                            : CreateTables);
+  sqlite_exec(database, CreateConfigTable);
+  sqlite_exec(database, CreateLatencyTable);
+  sqlite_exec(database, CreateTimingTable);
+  sqlite_exec(database, CreateResourceUsageTable);
+  sqlite_exec(database, CreateKillMatrixTables);
 }
+
+static void createIndexes(sqlite3 *database, SQLiteSchema schema) {
+  sqlite_exec(database, schema == SQLiteSchema::Normalized
+                            ? CreateNormalizedIndexes
+                            : CreateIndexes);
+}
+
@@ -1,9 +1,49 @@
 #include "mull/Reporters/TimeReporter.h"
+#include "mull/Logger.h"
 #include "mull/Metrics/Metrics.h"
+#include "mull/Metrics/TimingHistory.h"
+
+#include <llvm/Support/Format.h>
 
 using namespace mull;
 
+/// A run is compared with the median of the last runs of the project
+static const unsigned ComparedRuns = 10;
+static const double RegressionFactor = 1.5;
+/// The timings are in milliseconds, the short ones jitter too much
+static const double NoiseMilliseconds = 100;
+
+TimeReporter::TimeReporter(const std::string &historyPath,
+                           const std::string &projectName)
+    : historyPath(historyPath), projectName(projectName) {}
+
 void TimeReporter::reportResults(const Result &result, const RawConfig &config,
                                  const Metrics &metrics) {
   metrics.dump();
+
+  if (historyPath.empty()) {
+    return;
+  }
+  TimingHistory history(historyPath);
+  std::string error;
+  if (!history.open(error)) {
+    Logger::warn() << "Cannot open the timing history " << historyPath << ": "
+                   << error << "\n";
+    return;
+  }
+
+  auto timings = metrics.timings();
+  auto workload = projectName.empty() ? std::string("mull") : projectName;
+  for (auto &regression :
+       history.compare(workload, timings, ComparedRuns, RegressionFactor,
+                       NoiseMilliseconds)) {
+    Logger::warn() << "Timing regression: " << regression.name << " took "
+                   << llvm::format("%.0f", regression.milliseconds)
+                   << "ms, the median of the last " << regression.runs
+                   << " runs is "
+                   << llvm::format("%.0f", regression.baseline) << "ms\n";
+  }
+  if (!history.record(workload, timings)) {
+    Logger::warn() << "Cannot add the timings to " << historyPath << "\n";
+  }
 }
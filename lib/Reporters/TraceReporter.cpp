@@ -0,0 +1,47 @@
+#include "mull/Reporters/TraceReporter.h"
+
+#include "mull/Logger.h"
+#include "mull/Metrics/Metrics.h"
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <ctime>
+#include <sys/param.h>
+
+using namespace mull;
+using namespace llvm;
+
+TraceReporter::TraceReporter(const std::string &projectName) {
+  SmallString<MAXPATHLEN> filePath;
+  auto error = sys::fs::current_path(filePath);
+  if (error) {
+    Logger::error() << error.message() << "\n";
+  }
+
+  std::string projectNameComponent = projectName;
+  if (!projectNameComponent.empty()) {
+    projectNameComponent += "_";
+  }
+  sys::path::append(filePath, projectNameComponent +
+                                  std::to_string(time(nullptr)) +
+                                  ".trace.json");
+  path = filePath.str();
+}
+
+const std::string &TraceReporter::getPath() const { return path; }
+
+void TraceReporter::reportResults(const Result &result, const RawConfig &config,
+                                  const Metrics &metrics) {
+  std::error_code error;
+  raw_fd_ostream file(path, error, sys::fs::F_None);
+  if (error) {
+    Logger::error() << "Cannot write " << path << ": " << error.message()
+                    << "\n";
+    return;
+  }
+  metrics.writeTrace(file);
+  Logger::info() << "Trace can be found at '" << path << "'\n";
+}
@@ -0,0 +1,36 @@
+#include "mull/ResultsDatabase.h"
+
+#include <sqlite3.h>
+
+using namespace mull;
+
+const char *const mull::SelectExecutionResults =
+    "SELECT test_id, mutation_point_id, status, duration, stdout, stderr "
+    "FROM execution_result WHERE mutation_point_id != ''";
+
+sqlite3 *mull::openResultsDatabase(const std::string &path,
+                                   std::string &error) {
+  sqlite3 *database = nullptr;
+  if (sqlite3_open_v2(path.c_str(), &database, SQLITE_OPEN_READONLY,
+                      nullptr) != SQLITE_OK) {
+    error = sqlite3_errmsg(database);
+    sqlite3_close(database);
+    return nullptr;
+  }
+  return database;
+}
+
+std::string mull::columnText(sqlite3_stmt *statement, int column) {
+  auto text = sqlite3_column_text(statement, column);
+  return text ? reinterpret_cast<const char *>(text) : std::string();
+}
+
+ExecutionResult mull::executionResultOf(sqlite3_stmt *selectResults) {
+  ExecutionResult result;
+  result.status =
+      static_cast<ExecutionStatus>(sqlite3_column_int(selectResults, 2));
+  result.runningTime = sqlite3_column_int64(selectResults, 3);
+  result.stdoutOutput = columnText(selectResults, 4);
+  result.stderrOutput = columnText(selectResults, 5);
+  return result;
+}
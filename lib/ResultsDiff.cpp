@@ -0,0 +1,167 @@
+#include "mull/ResultsDiff.h"
+
+#include "mull/ExecutionResult.h"
+#include "mull/ResultsDatabase.h"
+
+#include <sqlite3.h>
+#include <unordered_map>
+#include <vector>
+
+using namespace mull;
+
+namespace {
+
+enum class MutantState { NotRun, Survived, Killed };
+
+struct Mutant {
+  DiffedMutant mutant;
+  /// One of its points at least ran, one survived
+  bool ran;
+  bool survived;
+  /// Set once the other run has the mutant as well
+  bool matched;
+};
+
+/// A mutation point and what its results told so far
+struct Point {
+  Mutant *mutant;
+  bool ran;
+  bool killed;
+};
+
+using Mutants = std::unordered_map<std::string, Mutant>;
+
+} // namespace
+
+static MutantState stateOf(const Mutant &mutant) {
+  if (mutant.survived) {
+    return MutantState::Survived;
+  }
+  return mutant.ran ? MutantState::Killed : MutantState::NotRun;
+}
+
+static const char *SelectMutationPoints =
+    "SELECT unique_id, mutator, filename, line_number, column_number, "
+    "function_hash FROM mutation_point";
+static const char *SelectStatuses =
+    "SELECT mutation_point_id, status FROM execution_result "
+    "WHERE mutation_point_id != ''";
+
+static bool loadMutants(const std::string &path, Mutants &mutants,
+                        std::string &error) {
+  auto database = openResultsDatabase(path, error);
+  if (!database) {
+    error = path + ": " + error;
+    return false;
+  }
+
+  sqlite3_stmt *selectPoints = nullptr;
+  sqlite3_stmt *selectStatuses = nullptr;
+  if (sqlite3_prepare_v2(database, SelectMutationPoints, -1, &selectPoints,
+                         nullptr) != SQLITE_OK ||
+      sqlite3_prepare_v2(database, SelectStatuses, -1, &selectStatuses,
+                         nullptr) != SQLITE_OK) {
+    /// e.g. a database without the hashes of the functions
+    error = path + ": " + sqlite3_errmsg(database);
+    sqlite3_finalize(selectPoints);
+    sqlite3_close(database);
+    return false;
+  }
+
+  std::vector<Point> points;
+  std::unordered_map<std::string, size_t> pointIndices;
+  while (sqlite3_step(selectPoints) == SQLITE_ROW) {
+    DiffedMutant diffed;
+    diffed.mutator = columnText(selectPoints, 1);
+    diffed.file = columnText(selectPoints, 2);
+    diffed.line = sqlite3_column_int(selectPoints, 3);
+    diffed.column = sqlite3_column_int(selectPoints, 4);
+    diffed.functionHash = columnText(selectPoints, 5);
+    auto key = diffed.mutator + "\n" + diffed.file + "\n" +
+               std::to_string(diffed.line) + "\n" +
+               std::to_string(diffed.column) + "\n" + diffed.functionHash;
+
+    auto inserted = mutants.emplace(
+        std::move(key), Mutant{std::move(diffed), false, false, false});
+    pointIndices.emplace(columnText(selectPoints, 0), points.size());
+    points.push_back(Point{&inserted.first->second, false, false});
+  }
+
+  while (sqlite3_step(selectStatuses) == SQLITE_ROW) {
+    auto index = pointIndices.find(columnText(selectStatuses, 0));
+    if (index == pointIndices.end()) {
+      continue;
+    }
+    auto status =
+        static_cast<ExecutionStatus>(sqlite3_column_int(selectStatuses, 1));
+    /// The tests fail fast skipped, or that did not run, tell nothing
+    if (status == ExecutionStatus::Invalid ||
+        status == ExecutionStatus::DryRun ||
+        status == ExecutionStatus::FailFast) {
+      continue;
+    }
+    auto &point = points[index->second];
+    point.ran = true;
+    point.killed = point.killed || status != ExecutionStatus::Passed;
+  }
+
+  for (auto &point : points) {
+    if (point.ran) {
+      point.mutant->ran = true;
+      point.mutant->survived = point.mutant->survived || !point.killed;
+    }
+  }
+
+  sqlite3_finalize(selectPoints);
+  sqlite3_finalize(selectStatuses);
+  sqlite3_close(database);
+  return true;
+}
+
+std::string mull::mutantChangeToString(MutantChange change) {
+  switch (change) {
+  case MutantChange::Added:
+    return "added";
+  case MutantChange::Removed:
+    return "removed";
+  case MutantChange::NewlySurvived:
+    return "newly_survived";
+  case MutantChange::NewlyKilled:
+    return "newly_killed";
+  }
+}
+
+bool mull::diffResults(
+    const std::string &previousPath, const std::string &currentPath,
+    const std::function<void(MutantChange, const DiffedMutant &)> &report,
+    std::string &error) {
+  Mutants previous;
+  Mutants current;
+  if (!loadMutants(previousPath, previous, error) ||
+      !loadMutants(currentPath, current, error)) {
+    return false;
+  }
+
+  for (auto &pair : current) {
+    auto &mutant = pair.second;
+    auto before = previous.find(pair.first);
+    if (before == previous.end()) {
+      report(MutantChange::Added, mutant.mutant);
+      continue;
+    }
+    before->second.matched = true;
+    auto was = stateOf(before->second);
+    auto is = stateOf(mutant);
+    if (was == MutantState::Killed && is == MutantState::Survived) {
+      report(MutantChange::NewlySurvived, mutant.mutant);
+    } else if (was == MutantState::Survived && is == MutantState::Killed) {
+      report(MutantChange::NewlyKilled, mutant.mutant);
+    }
+  }
+  for (auto &pair : previous) {
+    if (!pair.second.matched) {
+      report(MutantChange::Removed, pair.second.mutant);
+    }
+  }
+  return true;
+}
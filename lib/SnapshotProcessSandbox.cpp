@@ -0,0 +1,30 @@
+#include "mull/ForkProcessSandbox.h"
+
+#include "mull/Metrics/Metrics.h"
+#include "mull/Toolchain/CountingMemoryManager.h"
+
+#include <cstdint>
+
+using namespace mull;
+
+/// Only ever used in the child of a batch, which has one thread
+static WritableSectionsSnapshot childSnapshot;
+static bool childSnapshotTaken = false;
+static uint64_t heapAtTestStart = 0;
+
+void SnapshotProcessSandbox::prepareBatch() {
+  childSnapshotTaken = childSnapshot.takeInChild();
+}
+
+void SnapshotProcessSandbox::startBatchTest() {
+  /// mallinfo walks the free lists, still cheaper than a fork of mull
+  heapAtTestStart = MemoryUsage::currentHeapLive();
+}
+
+bool SnapshotProcessSandbox::finishBatchTest() {
+  if (!childSnapshotTaken ||
+      MemoryUsage::currentHeapLive() != heapAtTestStart) {
+    return false;
+  }
+  return childSnapshot.matchesInChild() || childSnapshot.restoreInChild();
+}
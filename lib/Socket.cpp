@@ -0,0 +1,27 @@
+#include "mull/Socket.h"
+
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/types.h>
+
+#ifdef MSG_NOSIGNAL
+static const int SendFlags = MSG_NOSIGNAL;
+#else
+static const int SendFlags = 0;
+#endif
+
+bool mull::sendAll(int socket, const void *data, size_t size) {
+  auto bytes = static_cast<const char *>(data);
+  while (size > 0) {
+    ssize_t sent = send(socket, bytes, size, SendFlags);
+    if (sent == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    bytes += sent;
+    size -= sent;
+  }
+  return true;
+}
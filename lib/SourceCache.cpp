@@ -0,0 +1,77 @@
+#include "mull/SourceCache.h"
+
+#include "mull/Logger.h"
+
+#include <cstring>
+
+using namespace mull;
+using namespace llvm;
+
+StringRef SourceCache::getLine(const SourceLocation &location) {
+  return getLine(location.filePath(), location.line);
+}
+
+StringRef SourceCache::getLine(const std::string &filePath, int line) {
+  const File *file = getFile(filePath);
+  if (!file || line < 1 || size_t(line) > file->lineOffsets.size()) {
+    return StringRef();
+  }
+
+  StringRef contents = file->buffer->getBuffer();
+  size_t begin = file->lineOffsets[line - 1];
+  size_t end = size_t(line) < file->lineOffsets.size()
+                   ? file->lineOffsets[line]
+                   : contents.size();
+  return contents.slice(begin, end);
+}
+
+std::string SourceCache::caret(StringRef line, int column) {
+  if (column < 1 || size_t(column) > line.size()) {
+    return std::string();
+  }
+
+  std::string caret(column, ' ');
+  for (int index = 0; index < column; index++) {
+    if (line[index] == '\t') {
+      caret[index] = '\t';
+    }
+  }
+  caret[column - 1] = '^';
+  return caret;
+}
+
+/// A file that cannot be read is remembered as such and reported once
+const SourceCache::File *SourceCache::getFile(const std::string &filePath) {
+  std::lock_guard<std::mutex> lock(mutex);
+
+  auto existing = files.find(filePath);
+  if (existing != files.end()) {
+    return existing->second.get();
+  }
+
+  std::unique_ptr<File> file;
+  auto buffer = MemoryBuffer::getFile(filePath, -1, false);
+  if (!buffer) {
+    Logger::warn() << "Cannot read " << filePath << ": "
+                   << buffer.getError().message() << "\n";
+  } else {
+    file = make_unique<File>();
+    file->buffer = std::move(buffer.get());
+
+    const char *start = file->buffer->getBufferStart();
+    const char *end = file->buffer->getBufferEnd();
+    file->lineOffsets.push_back(0);
+    for (const char *newline = start;
+         (newline = static_cast<const char *>(
+              memchr(newline, '\n', end - newline)));) {
+      newline++;
+      if (newline != end) {
+        file->lineOffsets.push_back(newline - start);
+      }
+    }
+  }
+
+  const File *result = file.get();
+  files[filePath] = std::move(file);
+  return result;
+}
@@ -1,6 +1,11 @@
 #include "mull/SourceLocation.h"
 
+#include <deque>
+#include <map>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <utility>
 
 #include <llvm/IR/DebugInfoMetadata.h>
 #include <llvm/IR/DebugLoc.h>
@@ -10,13 +15,108 @@
 
 namespace mull {
 
+namespace {
+struct SourceFile {
+  std::string directory;
+  std::string filePath;
+};
+
+/// The files of all the locations, file 0 has neither directory nor path.
+/// The files are only ever added, so the strings handed out stay valid.
+class SourceFiles {
+public:
+  SourceFiles() { files.push_back(SourceFile()); }
+
+  uint32_t intern(const std::string &directory, const std::string &filePath) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return internLocked(directory, filePath);
+  }
+
+  uint32_t intern(const llvm::DIFile *file) {
+    if (file == nullptr) {
+      return 0;
+    }
+
+    llvm::StringRef directory = file->getDirectory();
+    llvm::StringRef fileName = file->getFilename();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    /// The metadata of a released context may be reused for another file,
+    /// so the cached file is checked against the metadata
+    auto cached = debugFiles.find(file);
+    if (cached != debugFiles.end() && cached->second.fileName == fileName &&
+        files[cached->second.id].directory == directory) {
+      return cached->second.id;
+    }
+
+    std::string filePath = fileName.str();
+    if (!llvm::sys::path::is_absolute(filePath)) {
+      filePath = directory.str() + llvm::sys::path::get_separator().str() +
+                 filePath;
+    }
+    uint32_t id = internLocked(directory.str(), filePath);
+    debugFiles[file] = {id, fileName.str()};
+    return id;
+  }
+
+  const SourceFile &get(uint32_t id) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return files[id];
+  }
+
+private:
+  struct DebugFile {
+    uint32_t id;
+    std::string fileName;
+  };
+
+  std::mutex mutex;
+  std::deque<SourceFile> files;
+  std::map<std::pair<std::string, std::string>, uint32_t> ids;
+  std::unordered_map<const llvm::DIFile *, DebugFile> debugFiles;
+
+  uint32_t internLocked(const std::string &directory,
+                        const std::string &filePath) {
+    if (directory.empty() && filePath.empty()) {
+      return 0;
+    }
+    auto key = std::make_pair(directory, filePath);
+    auto existing = ids.find(key);
+    if (existing != ids.end()) {
+      return existing->second;
+    }
+    uint32_t id = files.size();
+    files.push_back({directory, filePath});
+    ids[key] = id;
+    return id;
+  }
+};
+} // namespace
+
+static SourceFiles &sourceFiles() {
+  static SourceFiles files;
+  return files;
+}
+
 SourceLocation::SourceLocation(const std::string &directory,
                                const std::string &filePath, int line,
                                int column)
-    : directory(directory), filePath(filePath), line(line), column(column) {}
+    : file(sourceFiles().intern(directory, filePath)), line(line),
+      column(column) {}
+
+SourceLocation::SourceLocation(uint32_t file, int line, int column)
+    : file(file), line(line), column(column) {}
+
+const std::string &SourceLocation::directory() const {
+  return sourceFiles().get(file).directory;
+}
+
+const std::string &SourceLocation::filePath() const {
+  return sourceFiles().get(file).filePath;
+}
 
 const SourceLocation SourceLocation::nullSourceLocation() {
-  return SourceLocation(std::string(), std::string(), 0, 0);
+  return SourceLocation(0, 0, 0);
 }
 
 const SourceLocation SourceLocation::sourceLocationFromInstruction(
@@ -25,18 +125,13 @@ const SourceLocation SourceLocation::sourceLocationFromInstruction(
     return nullSourceLocation();
   }
 
-  const llvm::DebugLoc &debugInfo = instruction->getDebugLoc();
+  const llvm::DILocation *debugInfo = instruction->getDebugLoc().get();
 
-  std::string directory = debugInfo->getDirectory();
-  std::string filePath = debugInfo->getFilename();
+  uint32_t file = sourceFiles().intern(debugInfo->getScope()->getFile());
   int line = debugInfo->getLine();
   int column = debugInfo->getColumn();
 
-  if (!llvm::sys::path::is_absolute(filePath)) {
-    filePath = directory + llvm::sys::path::get_separator().str() + filePath;
-  }
-
-  return SourceLocation(directory, filePath, line, column);
+  return SourceLocation(file, line, column);
 }
 
 const SourceLocation
@@ -47,20 +142,15 @@ SourceLocation::sourceLocationFromFunction(const llvm::Function *function) {
 
   auto debugInfo = llvm::dyn_cast<llvm::DISubprogram>(function->getMetadata(0));
 
-  std::string directory = debugInfo->getDirectory();
-  std::string filePath = debugInfo->getFilename();
+  uint32_t file = sourceFiles().intern(debugInfo->getFile());
   int line = debugInfo->getLine();
   int column = 0;
 
-  if (!llvm::sys::path::is_absolute(filePath)) {
-    filePath = directory + llvm::sys::path::get_separator().str() + filePath;
-  }
-
-  return SourceLocation(directory, filePath, line, column);
+  return SourceLocation(file, line, column);
 }
 
 bool SourceLocation::isNull() const {
-  return (directory == "" && filePath == "" && line == 0 && column == 0) ||
+  return (file == 0 && line == 0 && column == 0) ||
          // this case happened when compiled with '-Og', please look at:
          // https://github.com/mull-project/mull/issues/519
          // https://github.com/mull-project/mull/issues/520
@@ -0,0 +1,95 @@
+#include "mull/SubstringMatcher.h"
+
+#include <queue>
+
+using namespace mull;
+
+static const uint32_t NoTransition = UINT32_MAX;
+
+SubstringMatcher::SubstringMatcher() : compiled(false) {}
+
+void SubstringMatcher::addPattern(const std::string &pattern) {
+  patterns.push_back(pattern);
+  compiled = false;
+}
+
+bool SubstringMatcher::empty() const { return patterns.empty(); }
+
+bool SubstringMatcher::matches(llvm::StringRef text) {
+  if (!compiled) {
+    compile();
+  }
+
+  uint32_t state = 0;
+  if (states[state].terminal) {
+    return true;
+  }
+  for (char character : text) {
+    uint32_t next = transition(state, character);
+    while (next == NoTransition && state != 0) {
+      state = states[state].failure;
+      next = transition(state, character);
+    }
+    state = next == NoTransition ? 0 : next;
+    if (states[state].terminal) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+uint32_t SubstringMatcher::transition(uint32_t state, char character) const {
+  for (auto &transition : states[state].transitions) {
+    if (transition.first == character) {
+      return transition.second;
+    }
+  }
+  return NoTransition;
+}
+
+void SubstringMatcher::compile() {
+  states.clear();
+  states.push_back({{}, 0, false});
+
+  for (auto &pattern : patterns) {
+    uint32_t state = 0;
+    for (char character : pattern) {
+      uint32_t next = transition(state, character);
+      if (next == NoTransition) {
+        next = states.size();
+        states[state].transitions.emplace_back(character, next);
+        states.push_back({{}, 0, false});
+      }
+      state = next;
+    }
+    states[state].terminal = true;
+  }
+
+  /// The failure of a state is the longest proper suffix of its prefix that
+  /// is also a prefix of a pattern, the states are visited by depth so that
+  /// the failures of the shorter prefixes are known
+  std::queue<uint32_t> queue;
+  for (auto &transition : states[0].transitions) {
+    states[transition.second].failure = 0;
+    queue.push(transition.second);
+  }
+  while (!queue.empty()) {
+    uint32_t state = queue.front();
+    queue.pop();
+    for (auto &transition : states[state].transitions) {
+      uint32_t failure = states[state].failure;
+      uint32_t next = this->transition(failure, transition.first);
+      while (next == NoTransition && failure != 0) {
+        failure = states[failure].failure;
+        next = this->transition(failure, transition.first);
+      }
+      State &child = states[transition.second];
+      child.failure = next == NoTransition ? 0 : next;
+      child.terminal |= states[child.failure].terminal;
+      queue.push(transition.second);
+    }
+  }
+
+  compiled = true;
+}
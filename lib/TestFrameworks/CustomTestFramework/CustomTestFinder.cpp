@@ -3,12 +3,12 @@
 #include "mull/Config/Configuration.h"
 #include "mull/Filter.h"
 #include "mull/Logger.h"
+#include "mull/Parallelization/Parallelization.h"
 #include "mull/Program/Program.h"
 #include "mull/TestFrameworks/Test.h"
 
 #include <llvm/IR/Module.h>
 
-#include <map>
 #include <string>
 #include <vector>
 
@@ -19,41 +19,33 @@ CustomTestFinder::CustomTestFinder(
     const std::vector<CustomTestDefinition> &definitions)
     : testDefinitions(definitions) {}
 
+/// The test functions are looked up in the functions the program indexes
+/// by name, rather than by walking the functions of every module
 std::vector<Test> CustomTestFinder::findTests(Program &program,
                                               Filter &filter) {
-  std::map<std::string, std::vector<CustomTestDefinition>> testMapping;
-  for (const auto &definition : testDefinitions) {
-    testMapping[definition.methodName].push_back(definition);
-  }
-
   std::vector<Test> tests;
 
-  for (auto &currentModule : program.modules()) {
-    for (auto &function : currentModule->getModule()->getFunctionList()) {
-      if (function.isDeclaration()) {
+  SingleTaskExecutor task("Searching tests", [&]() {
+    for (auto &definition : testDefinitions) {
+      if (filter.shouldSkipTest(definition.testName)) {
         continue;
       }
 
-      const std::string &functionName = function.getName().str();
-      if (testMapping.count(functionName) == 0) {
+      auto function = program.lookupDefinedFunction(definition.methodName);
+      if (function == nullptr) {
         continue;
       }
 
-      for (auto &definition : testMapping.at(functionName)) {
-        if (filter.shouldSkipTest(definition.testName)) {
-          continue;
-        }
-
-        std::string programName = definition.programName;
-        if (programName.empty()) {
-          programName = "mull";
-        }
-
-        tests.push_back(Test(definition.testName, programName, "main",
-                             definition.callArguments, &function));
+      std::string programName = definition.programName;
+      if (programName.empty()) {
+        programName = "mull";
       }
+
+      tests.push_back(Test(definition.testName, programName, "main",
+                           definition.callArguments, function));
     }
-  }
+  });
+  task.execute();
 
   return tests;
 }
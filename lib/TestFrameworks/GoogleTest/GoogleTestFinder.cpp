@@ -2,8 +2,10 @@
 
 #include "mull/Filter.h"
 #include "mull/Logger.h"
+#include "mull/Parallelization/Parallelization.h"
 #include "mull/Program/Program.h"
 
+#include <llvm/ADT/SmallVector.h>
 #include <llvm/IR/CallSite.h>
 #include <llvm/IR/Constants.h>
 #include <llvm/IR/DebugInfoMetadata.h>
@@ -14,8 +16,15 @@
 #include <llvm/Support/Debug.h>
 #include <llvm/Support/raw_ostream.h>
 
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <map>
+#include <set>
 #include <vector>
 
+#include <cxxabi.h>
+
 using namespace mull;
 using namespace llvm;
 
@@ -38,10 +47,6 @@ using namespace llvm;
 ///              internal::TestFactoryBase* factory);
 ///
 /// Here we particularly interested in the values of `test_case_name` and `name`
-/// Note:
-///   Values `type_param` and `value_param` are also important,
-///   but ignored for the moment because we do not support Typed and
-///   Value Parametrized tests yet.
 ///
 /// To extract this information we need to find a global
 /// variable of type `class.testing::TestInfo`, then find its usage (it used
@@ -49,185 +54,519 @@ using namespace llvm;
 /// function `MakeAndRegisterTestInfo`, from the call extract values of
 /// first and second parameters.
 /// Concatenation of thsi parameters is exactly the test name.
-/// Note: except of Typed and Value Prametrized Tests
+///
+/// Typed and Value Parametrized Tests have no such variable: GoogleTest
+/// registers their instances at run time, their names depend on the types
+/// and the parameters. Their test bodies are collected along with the other
+/// tests, and the instances are found once the program is loaded, by
+/// listing the tests:
+///
+///    Prefix/Suite.        <- INSTANTIATE_TEST_CASE_P(Prefix, Suite, ...)
+///      Name/0  # GetParam() = 42
+///    Suite/0.  # TypeParam = int
+///      Name
+///
+/// Every instance is a test of its own, with the body of its class, e.g.
+/// `Suite_Name_Test::TestBody()` or `Suite_Name_Test<int>::TestBody()`.
 ///
 
-std::vector<Test> GoogleTestFinder::findTests(Program &program,
-                                              Filter &filter) {
+static void testNames(GlobalVariable &globalValue, std::string &testSuiteName,
+                      std::string &testCaseName) {
+  /// Normally the globalValue has only one usage, ut LLVM could add
+  /// intrinsics such as @llvm.invariant.start
+  /// We need to find a user that is a store instruction, which is
+  /// a part of initialization function
+  /// It looks like this:
+  ///
+  ///   store %"class.testing::TestInfo"* %call2,
+  ///   %"class.testing::TestInfo"** @_ZN16Hello_world_Test10test_info_E
+  ///
+  /// From here we need to extract actual user, which is a `store`
+  /// instruction The `store` instruction uses variable `%call2`, which is
+  /// created from the following code:
+  ///
+  ///   %call2 = call %"class.testing::TestInfo"*
+  ///   @_ZN7testing8internal23MakeAndRegisterTestInfoEPKcS2_S2_S2_PKvPFvvES6_PNS0_15TestFactoryBaseE(i8*
+  ///   getelementptr inbounds ([6 x i8], [6 x i8]* @.str, i32 0, i32 0),
+  ///   i8* getelementptr inbounds ([4 x i8], [4 x i8]* @.str.1, i32 0, i32
+  ///   0), i8* null, i8* null, i8* %call, void ()*
+  ///   @_ZN7testing4Test13SetUpTestCaseEv, void ()*
+  ///   @_ZN7testing4Test16TearDownTestCaseEv,
+  ///   %"class.testing::internal::TestFactoryBase"* %1)
+  ///
+  /// Which can be roughly simplified to the following pseudo-code:
+  ///
+  ///   testInfo = MakeAndRegisterTestInfo("Test Suite Name",
+  ///                                      "Test Case Name",
+  ///                                      setUpFunctionPtr,
+  ///                                      tearDownFunctionPtr,
+  ///                                      some_other_ignored_parameters)
+  ///
+  /// Where `testInfo` is exactly the `%call2` from above.
+  /// From the `MakeAndRegisterTestInfo` we need to extract test suite
+  /// and test case names. Having those in place it's possible to provide
+  /// correct filter for GoogleTest framework
+  ///
+  /// Putting lots of assertions to check the hardway whether
+  /// my assumptions are correct or not
+
+  StoreInst *storeInstruction = nullptr;
+  for (auto userIterator = globalValue.user_begin();
+       userIterator != globalValue.user_end(); userIterator++) {
+    auto user = *userIterator;
+    if (isa<StoreInst>(user)) {
+      storeInstruction = dyn_cast<StoreInst>(user);
+      break;
+    }
+  }
+
+  assert(storeInstruction &&
+         "The Global should be used within a store instruction");
+  auto valueOperand = storeInstruction->getValueOperand();
+
+  auto callSite = CallSite(valueOperand);
+  assert((callSite.isCall() || callSite.isInvoke()) &&
+         "Store should be using call to MakeAndRegisterTestInfo");
+
+  /// Once we have the CallInstruction we can extract Test Suite Name
+  /// and Test Case Name
+  /// To extract them we need climb to the top, i.e.:
+  ///
+  ///   i8* getelementptr inbounds ([6 x i8], [6 x i8]* @.str, i32 0, i32 0)
+  ///   i8* getelementptr inbounds ([6 x i8], [6 x i8]* @.str1, i32 0, i32
+  ///   0)
+
+  auto testSuiteNameConstRef =
+      dyn_cast<ConstantExpr>(callSite->getOperand(0));
+  assert(testSuiteNameConstRef);
+
+  auto testCaseNameConstRef =
+      dyn_cast<ConstantExpr>(callSite->getOperand(1));
+  assert(testCaseNameConstRef);
+
+  ///   @.str = private unnamed_addr constant [6 x i8] c"Hello\00", align 1
+  ///   @.str = private unnamed_addr constant [6 x i8] c"world\00", align 1
+
+  auto testSuiteNameConst =
+      dyn_cast<GlobalValue>(testSuiteNameConstRef->getOperand(0));
+  assert(testSuiteNameConst);
+
+  auto testCaseNameConst =
+      dyn_cast<GlobalValue>(testCaseNameConstRef->getOperand(0));
+  assert(testCaseNameConst);
+
+  ///   [6 x i8] c"Hello\00"
+  ///   [6 x i8] c"world\00"
+
+  auto testSuiteNameConstArray =
+      dyn_cast<ConstantDataArray>(testSuiteNameConst->getOperand(0));
+  assert(testSuiteNameConstArray);
+
+  auto testCaseNameConstArray =
+      dyn_cast<ConstantDataArray>(testCaseNameConst->getOperand(0));
+  assert(testCaseNameConstArray);
+
+  ///   "Hello"
+  ///   "world"
+
+  testSuiteName =
+      testSuiteNameConstArray->getRawDataValues().rtrim('\0').str();
+  testCaseName = testCaseNameConstArray->getRawDataValues().rtrim('\0').str();
+}
+
+namespace {
+
+/// A module that defines tests, with the TestInfo globals of its tests
+struct TestModule {
+  MullModule *mullModule;
+  Module *module;
+  std::vector<GlobalVariable *> testInfos;
+};
+
+/// The tests of a module, and the bodies of its tests without a TestInfo
+struct TestModuleSearch {
   std::vector<Test> tests;
+  std::vector<Function *> instanceBodies;
+};
+
+/// Finds the tests of one module per item
+class GoogleTestSearchTask {
+public:
+  using In = const std::vector<TestModule>;
+  using Out = std::vector<TestModuleSearch>;
+  using iterator = In::const_iterator;
+
+  GoogleTestSearchTask(Program &program, Filter &filter,
+                       TestSearchCache *cache)
+      : program(program), filter(filter), cache(cache) {}
+
+  void operator()(iterator begin, iterator end, Out &storage,
+                  progress_counter &counter) {
+    for (auto it = begin; it != end; it++, counter.increment()) {
+      storage.emplace_back();
+      findTests(*it, storage.back());
+    }
+  }
 
-  auto testInfoTypeName = StringRef("class.testing::TestInfo");
+private:
+  Program &program;
+  Filter &filter;
+  TestSearchCache *cache;
 
-  for (auto &currentModule : program.modules()) {
-    for (auto &globalValue : currentModule->getModule()->getGlobalList()) {
-      Type *globalValueType = globalValue.getValueType();
-      if (globalValueType->getTypeID() != Type::PointerTyID) {
-        continue;
-      }
+  void findTests(const TestModule &testModule, TestModuleSearch &search);
+  void searchModule(const TestModule &testModule,
+                    TestSearchCache::ModuleTests &found,
+                    std::vector<Function *> &bodies);
+  bool lookupBodies(const TestSearchCache::ModuleTests &found,
+                    std::vector<Function *> &bodies);
+};
 
-      Type *globalType = nullptr;
-      if (globalValueType->getTypeID() == Type::PointerTyID) {
-        globalType = globalValueType->getPointerElementType();
-      } else {
-        globalType = globalValueType->getSequentialElementType();
-      }
+} // namespace
 
-      if (!globalType) {
-        continue;
-      }
+static bool isTestBody(const Function &function) {
+  return !function.isDeclaration() && function.getName().startswith("_ZN") &&
+         function.getName().endswith("8TestBodyEv");
+}
 
-      auto *structType = dyn_cast<StructType>(globalType);
-      if (!structType) {
-        continue;
-      }
+/// The bodies of the tests come first in `bodies`, then the bodies of the
+/// tests without a TestInfo
+void GoogleTestSearchTask::searchModule(const TestModule &testModule,
+                                        TestSearchCache::ModuleTests &found,
+                                        std::vector<Function *> &bodies) {
+  /// The module is walked once for the test bodies of all its tests
+  std::vector<Function *> testBodies;
+  for (auto &func : testModule.module->getFunctionList()) {
+    if (isTestBody(func)) {
+      testBodies.push_back(&func);
+    }
+  }
 
-      /// If two modules contain the same type, then when second modules is
-      /// loaded the typename is changed a bit, e.g.:
-      ///
-      ///   class.testing::TestInfo     // type from first module
-      ///   class.testing::TestInfo.25  // type from second module
-      ///
-      /// Hence we cannot just compare string, and rather should
-      /// compare the beginning of the typename
-
-      if (!structType->getName().startswith(testInfoTypeName)) {
-        continue;
+  std::set<Function *> registeredBodies;
+  for (auto testInfo : testModule.testInfos) {
+    std::string testSuiteName;
+    std::string testCaseName;
+    testNames(*testInfo, testSuiteName, testCaseName);
+
+    /// The part of Test Body function name
+    std::string testBodyFunctionName =
+        testSuiteName + "_" + testCaseName + "_Test8TestBodyEv";
+    StringRef testBodyFunctionNameRef(testBodyFunctionName);
+
+    /// Using the TestBodyFunctionName we could find the function
+    /// and finish creating the GoogleTest_Test object
+
+    Function *testBodyFunction = nullptr;
+    for (auto func : testBodies) {
+      auto foundPosition = func->getName().rfind(testBodyFunctionNameRef);
+      if (foundPosition != StringRef::npos) {
+        testBodyFunction = func;
+        break;
       }
+    }
 
-      /// Normally the globalValue has only one usage, ut LLVM could add
-      /// intrinsics such as @llvm.invariant.start
-      /// We need to find a user that is a store instruction, which is
-      /// a part of initialization function
-      /// It looks like this:
-      ///
-      ///   store %"class.testing::TestInfo"* %call2,
-      ///   %"class.testing::TestInfo"** @_ZN16Hello_world_Test10test_info_E
-      ///
-      /// From here we need to extract actual user, which is a `store`
-      /// instruction The `store` instruction uses variable `%call2`, which is
-      /// created from the following code:
-      ///
-      ///   %call2 = call %"class.testing::TestInfo"*
-      ///   @_ZN7testing8internal23MakeAndRegisterTestInfoEPKcS2_S2_S2_PKvPFvvES6_PNS0_15TestFactoryBaseE(i8*
-      ///   getelementptr inbounds ([6 x i8], [6 x i8]* @.str, i32 0, i32 0),
-      ///   i8* getelementptr inbounds ([4 x i8], [4 x i8]* @.str.1, i32 0, i32
-      ///   0), i8* null, i8* null, i8* %call, void ()*
-      ///   @_ZN7testing4Test13SetUpTestCaseEv, void ()*
-      ///   @_ZN7testing4Test16TearDownTestCaseEv,
-      ///   %"class.testing::internal::TestFactoryBase"* %1)
-      ///
-      /// Which can be roughly simplified to the following pseudo-code:
-      ///
-      ///   testInfo = MakeAndRegisterTestInfo("Test Suite Name",
-      ///                                      "Test Case Name",
-      ///                                      setUpFunctionPtr,
-      ///                                      tearDownFunctionPtr,
-      ///                                      some_other_ignored_parameters)
-      ///
-      /// Where `testInfo` is exactly the `%call2` from above.
-      /// From the `MakeAndRegisterTestInfo` we need to extract test suite
-      /// and test case names. Having those in place it's possible to provide
-      /// correct filter for GoogleTest framework
-      ///
-      /// Putting lots of assertions to check the hardway whether
-      /// my assumptions are correct or not
-
-      StoreInst *storeInstruction = nullptr;
-      for (auto userIterator = globalValue.user_begin();
-           userIterator != globalValue.user_end(); userIterator++) {
-        auto user = *userIterator;
-        if (isa<StoreInst>(user)) {
-          storeInstruction = dyn_cast<StoreInst>(user);
-          break;
-        }
-      }
+    assert(testBodyFunction &&
+           "Cannot find the TestBody function for the Test");
+    /// Even the body of a test the filter skips is not one of an instance
+    registeredBodies.insert(testBodyFunction);
+
+    /// Once we've got the Name of a Test Suite and the name of a Test Case
+    /// We can construct the name of a Test
+    const std::string testName = testSuiteName + "." + testCaseName;
+    found.tests.push_back(TestSearchCache::CachedTest{
+        testName, "main", testBodyFunction->getName().str()});
+    bodies.push_back(testBodyFunction);
+  }
 
-      assert(storeInstruction &&
-             "The Global should be used within a store instruction");
-      auto valueOperand = storeInstruction->getValueOperand();
-
-      auto callSite = CallSite(valueOperand);
-      assert((callSite.isCall() || callSite.isInvoke()) &&
-             "Store should be using call to MakeAndRegisterTestInfo");
-
-      /// Once we have the CallInstruction we can extract Test Suite Name
-      /// and Test Case Name
-      /// To extract them we need climb to the top, i.e.:
-      ///
-      ///   i8* getelementptr inbounds ([6 x i8], [6 x i8]* @.str, i32 0, i32 0)
-      ///   i8* getelementptr inbounds ([6 x i8], [6 x i8]* @.str1, i32 0, i32
-      ///   0)
-
-      auto testSuiteNameConstRef =
-          dyn_cast<ConstantExpr>(callSite->getOperand(0));
-      assert(testSuiteNameConstRef);
-
-      auto testCaseNameConstRef =
-          dyn_cast<ConstantExpr>(callSite->getOperand(1));
-      assert(testCaseNameConstRef);
-
-      ///   @.str = private unnamed_addr constant [6 x i8] c"Hello\00", align 1
-      ///   @.str = private unnamed_addr constant [6 x i8] c"world\00", align 1
-
-      auto testSuiteNameConst =
-          dyn_cast<GlobalValue>(testSuiteNameConstRef->getOperand(0));
-      assert(testSuiteNameConst);
-
-      auto testCaseNameConst =
-          dyn_cast<GlobalValue>(testCaseNameConstRef->getOperand(0));
-      assert(testCaseNameConst);
-
-      ///   [6 x i8] c"Hello\00"
-      ///   [6 x i8] c"world\00"
-
-      auto testSuiteNameConstArray =
-          dyn_cast<ConstantDataArray>(testSuiteNameConst->getOperand(0));
-      assert(testSuiteNameConstArray);
-
-      auto testCaseNameConstArray =
-          dyn_cast<ConstantDataArray>(testCaseNameConst->getOperand(0));
-      assert(testCaseNameConstArray);
-
-      ///   "Hello"
-      ///   "world"
-
-      std::string testSuiteName =
-          testSuiteNameConstArray->getRawDataValues().rtrim('\0').str();
-      std::string testCaseName =
-          testCaseNameConstArray->getRawDataValues().rtrim('\0').str();
-
-      /// Once we've got the Name of a Test Suite and the name of a Test Case
-      /// We can construct the name of a Test
-      const std::string testName = testSuiteName + "." + testCaseName;
-      if (filter.shouldSkipTest(testName)) {
-        continue;
-      }
+  for (auto func : testBodies) {
+    if (registeredBodies.count(func) == 0) {
+      found.runtimeBodies.push_back(func->getName().str());
+      bodies.push_back(func);
+    }
+  }
+}
+
+bool GoogleTestSearchTask::lookupBodies(
+    const TestSearchCache::ModuleTests &found,
+    std::vector<Function *> &bodies) {
+  for (auto &test : found.tests) {
+    bodies.push_back(program.lookupDefinedFunction(test.body));
+  }
+  for (auto &body : found.runtimeBodies) {
+    bodies.push_back(program.lookupDefinedFunction(body));
+  }
+  return std::find(bodies.begin(), bodies.end(), nullptr) == bodies.end();
+}
+
+/// The tests of a module the cache knows are rebuilt from the names of
+/// their bodies, the filter applies to them all the same
+void GoogleTestSearchTask::findTests(const TestModule &testModule,
+                                     TestModuleSearch &search) {
+  TestSearchCache::ModuleTests found;
+  std::vector<Function *> bodies;
+  if (!cache || !cache->lookup(*testModule.mullModule, found) ||
+      !lookupBodies(found, bodies)) {
+    found = TestSearchCache::ModuleTests();
+    bodies.clear();
+    searchModule(testModule, found, bodies);
+    if (cache) {
+      cache->store(*testModule.mullModule, found);
+    }
+  }
+
+  for (size_t index = 0; index < found.tests.size(); index++) {
+    auto &test = found.tests[index];
+    if (filter.shouldSkipTest(test.name)) {
+      continue;
+    }
+    auto arguments = {std::string("--gtest_filter=") + test.name};
+    search.tests.push_back(Test(test.name, "mull", test.driverFunction,
+                                arguments, bodies[index]));
+  }
+  search.instanceBodies.assign(bodies.begin() + found.tests.size(),
+                               bodies.end());
+}
+
+GoogleTestFinder::GoogleTestFinder(int workers) : workers(workers) {}
+
+/// Every test class derives from testing::Test, the modules that do not
+/// declare its constructor have no tests
+static bool definesTests(Module &module) {
+  return module.getFunction("_ZN7testing4TestC2Ev") ||
+         module.getFunction("_ZN7testing4TestC1Ev");
+}
+
+/// The program indexes its globals by type, so that only the modules with
+/// tests are looked at. They are searched on all the workers.
+std::vector<Test> GoogleTestFinder::findTests(Program &program,
+                                              Filter &filter) {
+  std::map<Module *, std::vector<GlobalVariable *>> testInfosByModule;
+  for (auto global : program.globalsPointingTo("class.testing::TestInfo")) {
+    testInfosByModule[global->getParent()].push_back(global);
+  }
+
+  std::vector<TestModule> testModules;
+  for (auto &mullModule : program.modules()) {
+    auto module = mullModule->getModule();
+    auto testInfos = testInfosByModule.find(module);
+    if (testInfos != testInfosByModule.end()) {
+      testModules.push_back(TestModule{mullModule.get(), module,
+                                       std::move(testInfos->second)});
+    } else if (definesTests(*module)) {
+      testModules.push_back(TestModule{mullModule.get(), module, {}});
+    }
+  }
+
+  std::vector<GoogleTestSearchTask> tasks;
+  for (int i = 0; i < std::max(workers, 1); i++) {
+    tasks.emplace_back(program, filter, cache.get());
+  }
+
+  std::vector<TestModuleSearch> searches;
+  TaskExecutor<GoogleTestSearchTask> finder(
+      "Searching tests", testModules, searches, std::move(tasks));
+  finder.execute();
+
+  std::vector<Test> tests;
+  instanceBodies.clear();
+  for (auto &search : searches) {
+    std::move(search.tests.begin(), search.tests.end(),
+              std::back_inserter(tests));
+    instanceBodies.insert(instanceBodies.end(), search.instanceBodies.begin(),
+                          search.instanceBodies.end());
+  }
+  return tests;
+}
 
-      /// And the part of Test Body function name
-      std::string testBodyFunctionName =
-          testSuiteName + "_" + testCaseName + "_Test8TestBodyEv";
-      StringRef testBodyFunctionNameRef(testBodyFunctionName);
+bool GoogleTestFinder::hasRuntimeTests() const {
+  return !instanceBodies.empty();
+}
 
-      /// Using the TestBodyFunctionName we could find the function
-      /// and finish creating the GoogleTest_Test object
+/// A suite line ends with a dot, the tests of the suite follow it indented
+/// by two spaces. Either may end with a comment.
+std::vector<GoogleTestFinder::ListedTest>
+GoogleTestFinder::parseTestList(StringRef listing) {
+  static const StringRef TypeParamComment("# TypeParam = ");
+
+  std::vector<ListedTest> tests;
+  SmallVector<StringRef, 64> lines;
+  listing.split(lines, '\n', -1, false);
+  std::string suite;
+  std::string typeParameter;
+  for (auto line : lines) {
+    auto nameAndComment = line.trim().split("  #");
+    auto name = nameAndComment.first.rtrim();
+    if (name.empty()) {
+      continue;
+    }
 
-      Function *testBodyFunction = nullptr;
-      for (auto &func : currentModule->getModule()->getFunctionList()) {
-        auto foundPosition = func.getName().rfind(testBodyFunctionNameRef);
-        if (foundPosition != StringRef::npos) {
-          testBodyFunction = &func;
-          break;
+    if (!line.startswith("  ")) {
+      suite.clear();
+      typeParameter.clear();
+      if (name.endswith(".")) {
+        suite = name.str();
+        auto comment = line.find(TypeParamComment);
+        if (comment != StringRef::npos) {
+          typeParameter =
+              line.substr(comment + TypeParamComment.size()).rtrim().str();
         }
       }
+      continue;
+    }
 
-      assert(testBodyFunction &&
-             "Cannot find the TestBody function for the Test");
+    if (!suite.empty()) {
+      tests.push_back(ListedTest{suite + name.str(), typeParameter});
+    }
+  }
+  return tests;
+}
 
-      auto arguments = {std::string("--gtest_filter=") + testName};
-      tests.push_back(
-          Test(testName, "mull", "main", arguments, testBodyFunction));
+/// `Prefix::Outer<int>` is `Prefix::Outer` and `int`
+static void splitTemplateArguments(StringRef qualifiedName,
+                                   StringRef &templateName,
+                                   StringRef &arguments) {
+  templateName = qualifiedName;
+  arguments = StringRef();
+  if (!qualifiedName.endswith(">")) {
+    return;
+  }
+  int depth = 0;
+  for (size_t index = qualifiedName.size(); index > 0; index--) {
+    char c = qualifiedName[index - 1];
+    if (c == '>') {
+      depth++;
+    } else if (c == '<' && --depth == 0) {
+      templateName = qualifiedName.substr(0, index - 1);
+      arguments = qualifiedName.substr(index).drop_back().rtrim();
+      return;
     }
   }
+}
 
-  return tests;
+static bool isNamed(StringRef qualifiedName, StringRef name) {
+  return qualifiedName == name ||
+         (qualifiedName.endswith(name) &&
+          qualifiedName.drop_back(name.size()).endswith("::"));
+}
+
+namespace {
+
+/// A test body with the class it belongs to, e.g. `Suite_Name_Test<int>`
+struct InstanceBody {
+  Function *function;
+  std::string templateName;
+  std::string arguments;
+};
+
+} // namespace
+
+static std::vector<InstanceBody>
+demangleInstanceBodies(const std::vector<Function *> &functions) {
+  static const StringRef TestBody("::TestBody()");
+
+  std::vector<InstanceBody> bodies;
+  for (auto function : functions) {
+    int status = 0;
+    char *demangled = abi::__cxa_demangle(function->getName().str().c_str(),
+                                          nullptr, nullptr, &status);
+    if (!demangled) {
+      continue;
+    }
+    StringRef name(demangled);
+    if (name.endswith(TestBody)) {
+      StringRef templateName;
+      StringRef arguments;
+      splitTemplateArguments(name.drop_back(TestBody.size()), templateName,
+                             arguments);
+      bodies.push_back(
+          InstanceBody{function, templateName.str(), arguments.str()});
+    }
+    free(demangled);
+  }
+  return bodies;
+}
+
+/// The classes GoogleTest defines for the instances, a value parametrized
+/// test has the index (or the name) of the instance after the name of the
+/// test, a typed one after the name of the suite:
+///
+///    Prefix/Suite.Name/0        Suite_Name_Test
+///    Suite/0.Name               Suite_Name_Test<TypeParam>
+///    Prefix/Suite/0.Name        gtest_case_Suite_::Name<TypeParam>
+///
+/// The type parametrized tests live in `gtest_suite_Suite_` since 1.10.
+static std::vector<std::string> instanceClassNames(StringRef testName,
+                                                   bool &typed) {
+  auto suiteAndTest = testName.split('.');
+  SmallVector<StringRef, 3> suite;
+  SmallVector<StringRef, 2> test;
+  suiteAndTest.first.split(suite, '/');
+  suiteAndTest.second.split(test, '/');
+
+  if (test.size() == 2 && suite.size() <= 2) {
+    typed = false;
+    return {(suite.back() + "_" + test[0] + "_Test").str()};
+  }
+  if (test.size() == 1 && suite.size() >= 2) {
+    typed = true;
+    auto caseName = suite[suite.size() - 2];
+    return {(caseName + "_" + test[0] + "_Test").str(),
+            ("gtest_case_" + caseName + "_::" + test[0]).str(),
+            ("gtest_suite_" + caseName + "_::" + test[0]).str()};
+  }
+  return {};
+}
+
+/// A typed test is matched by its type, or by its class alone when the
+/// class has only one instance, e.g. when GoogleTest does not know the type
+/// without RTTI
+static Function *findInstanceBody(const GoogleTestFinder::ListedTest &test,
+                                  const std::vector<InstanceBody> &bodies) {
+  bool typed = false;
+  auto classNames = instanceClassNames(test.name, typed);
+  std::vector<Function *> candidates;
+  for (auto &body : bodies) {
+    bool named = false;
+    for (auto &className : classNames) {
+      named = named || isNamed(body.templateName, className);
+    }
+    if (!named || typed == body.arguments.empty()) {
+      continue;
+    }
+    if (!typed || body.arguments == test.typeParameter) {
+      return body.function;
+    }
+    candidates.push_back(body.function);
+  }
+  if (candidates.size() == 1) {
+    return candidates.front();
+  }
+  return nullptr;
+}
+
+void GoogleTestFinder::findRuntimeTests(
+    const std::function<std::string(Test &)> &run, Filter &filter,
+    std::vector<Test> &tests) {
+  Test listing("--gtest_list_tests", "mull", "main", {"--gtest_list_tests"},
+               nullptr);
+  auto bodies = demangleInstanceBodies(instanceBodies);
+
+  int unknown = 0;
+  for (auto &listed : parseTestList(run(listing))) {
+    if (listed.name.find('/') == std::string::npos ||
+        filter.shouldSkipTest(listed.name)) {
+      continue;
+    }
+    auto body = findInstanceBody(listed, bodies);
+    if (!body) {
+      unknown++;
+      continue;
+    }
+    auto arguments = {std::string("--gtest_filter=") + listed.name};
+    tests.push_back(Test(listed.name, "mull", "main", arguments, body));
+  }
+
+  if (unknown) {
+    Logger::warn() << "Cannot find the test bodies of " << unknown
+                   << " parametrized or typed tests, they are skipped\n";
+  }
 }
@@ -0,0 +1,84 @@
+#include "mull/TestFrameworks/GoogleTest/GoogleTestRunner.h"
+
+#include "LLVMCompatibility.h"
+#include "mull/TestFrameworks/Test.h"
+#include "mull/Toolchain/JITEngine.h"
+#include "mull/Toolchain/Mangler.h"
+
+#include <llvm/ADT/SmallVector.h>
+
+#include <string>
+
+using namespace mull;
+
+/// testing::InitGoogleTest(int *, char **)
+static const char *const InitGoogleTestName =
+    "_ZN7testing14InitGoogleTestEPiPPc";
+/// testing::internal::ParseGoogleTestFlagsOnly(int *, char **), the flags
+/// are parsed again for every test, InitGoogleTest does nothing the second
+/// time
+static const char *const ParseFlagsName =
+    "_ZN7testing8internal24ParseGoogleTestFlagsOnlyEPiPPc";
+/// testing::UnitTest::GetInstance()
+static const char *const GetInstanceName =
+    "_ZN7testing8UnitTest11GetInstanceEv";
+/// testing::UnitTest::Run(), what RUN_ALL_TESTS calls
+static const char *const RunName = "_ZN7testing8UnitTest3RunEv";
+
+typedef void (*InitFunction)(int *, char **);
+typedef void *(*GetInstanceFunction)();
+typedef int (*RunFunction)(void *);
+
+GoogleTestRunner::GoogleTestRunner(Mangler &mangler)
+    : NativeTestRunner(mangler) {}
+
+void *GoogleTestRunner::findFunctionPointer(const std::string &functionName,
+                                            JITEngine &jit) {
+  llvm_compat::JITSymbol &symbol =
+      jit.getSymbol(mangler.getNameWithPrefix(functionName));
+  auto address = llvm_compat::JITSymbolAddress(symbol);
+  return reinterpret_cast<void *>(static_cast<uintptr_t>(address));
+}
+
+void GoogleTestRunner::runStaticConstructors(JITEngine &jit,
+                                             Program &program) {
+  NativeTestRunner::runStaticConstructors(jit, program);
+
+  auto init = reinterpret_cast<InitFunction>(
+      findFunctionPointer(InitGoogleTestName, jit));
+  if (init) {
+    ArgumentVector arguments("mull", {});
+    llvm::SmallVector<char *, 2> argv;
+    arguments.getArgv(argv);
+    int argc = arguments.getArgc();
+    init(&argc, argv.data());
+  }
+}
+
+ExecutionStatus GoogleTestRunner::runInitializedTest(JITEngine &jit,
+                                                     Test &test) {
+  auto parseFlags =
+      reinterpret_cast<InitFunction>(findFunctionPointer(ParseFlagsName, jit));
+  auto getInstance = reinterpret_cast<GetInstanceFunction>(
+      findFunctionPointer(GetInstanceName, jit));
+  auto run = reinterpret_cast<RunFunction>(findFunctionPointer(RunName, jit));
+  if (!parseFlags || !getInstance || !run) {
+    return NativeTestRunner::runInitializedTest(jit, test);
+  }
+
+  *trampoline = &test.getInstrumentationInfo();
+
+  auto &arguments = test.getArgumentVector();
+  llvm::SmallVector<char *, 8> argv;
+  arguments.getArgv(argv);
+  int argc = arguments.getArgc();
+  parseFlags(&argc, argv.data());
+  int exitStatus = run(getInstance());
+
+  overrides.runDestructors();
+
+  if (exitStatus == 0) {
+    return ExecutionStatus::Passed;
+  }
+  return ExecutionStatus::Failed;
+}
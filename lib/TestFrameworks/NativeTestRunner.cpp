@@ -4,13 +4,15 @@
 #include "mull/Logger.h"
 #include "mull/Program/Program.h"
 #include "mull/TestFrameworks/Test.h"
+#include "mull/Toolchain/CountingMemoryManager.h"
 #include "mull/Toolchain/JITEngine.h"
 #include "mull/Toolchain/Mangler.h"
+#include "mull/Toolchain/ProgramLibrary.h"
 #include "mull/Toolchain/Resolvers/InstrumentationResolver.h"
 #include "mull/Toolchain/Resolvers/MutationResolver.h"
 #include "mull/Toolchain/Trampolines.h"
 
-#include <llvm/ExecutionEngine/SectionMemoryManager.h>
+#include <llvm/ADT/SmallVector.h>
 
 using namespace mull;
 
@@ -18,13 +20,13 @@ NativeTestRunner::NativeTestRunner(Mangler &mangler)
     : mangler(mangler), overrides([this](const char *name) {
         return this->mangler.getNameWithPrefix(name);
       }),
-      trampoline(new InstrumentationInfo *) {}
+      trampoline(new InstrumentationInfo *), ownTrampoline(trampoline) {}
 
-NativeTestRunner::~NativeTestRunner() { delete trampoline; }
+NativeTestRunner::~NativeTestRunner() { delete ownTrampoline; }
 
-void *NativeTestRunner::getConstructorPointer(const llvm::Function &function,
+void *NativeTestRunner::getConstructorPointer(const std::string &constructor,
                                               JITEngine &jit) {
-  auto name = mangler.getNameWithPrefix(function.getName().str());
+  auto name = mangler.getNameWithPrefix(constructor);
   return getFunctionPointer(name, jit);
 }
 
@@ -44,9 +46,30 @@ void *NativeTestRunner::getFunctionPointer(const std::string &functionName,
   return pointer;
 }
 
-void NativeTestRunner::runStaticConstructor(llvm::Function *constructor,
+namespace {
+struct DriverPointer {
+  uint64_t image;
+  std::string name;
+  void *pointer;
+};
+} // namespace
+
+/// The tests of a batch mostly share their driver, e.g. main, and run one
+/// after another on a thread
+void *NativeTestRunner::getDriverPointer(Test &test, JITEngine &jit) {
+  static thread_local DriverPointer cached = {0, std::string(), nullptr};
+  auto &name = test.getDriverFunctionName();
+  if (cached.image != jit.getImage() || cached.name != name) {
+    cached.pointer = getFunctionPointer(mangler.getNameWithPrefix(name), jit);
+    cached.image = jit.getImage();
+    cached.name = name;
+  }
+  return cached.pointer;
+}
+
+void NativeTestRunner::runStaticConstructor(const std::string &constructor,
                                             JITEngine &jit) {
-  void *CtorPointer = getConstructorPointer(*constructor, jit);
+  void *CtorPointer = getConstructorPointer(constructor, jit);
 
   auto ctor = ((int (*)())(intptr_t)CtorPointer);
   ctor();
@@ -55,41 +78,58 @@ void NativeTestRunner::runStaticConstructor(llvm::Function *constructor,
 void NativeTestRunner::loadInstrumentedProgram(ObjectFiles &objectFiles,
                                                Instrumentation &instrumentation,
                                                JITEngine &jit) {
-  InstrumentationResolver resolver(overrides, instrumentation, mangler,
-                                   trampoline);
-  jit.addObjectFiles(objectFiles, resolver,
-                     llvm::make_unique<llvm::SectionMemoryManager>());
+  trampoline = ownTrampoline;
+  auto resolver = llvm::make_unique<InstrumentationResolver>(
+      overrides, instrumentation, mangler, trampoline);
+  jit.addObjectFiles(objectFiles, std::move(resolver), []() {
+    return llvm::make_unique<CountingMemoryManager>();
+  });
+}
+
+void NativeTestRunner::beginInstrumentedProgram(
+    Instrumentation &instrumentation, JITEngine &jit) {
+  trampoline = ownTrampoline;
+  auto resolver = llvm::make_unique<InstrumentationResolver>(
+      overrides, instrumentation, mangler, trampoline);
+  jit.beginObjectFiles(std::move(resolver), []() {
+    return llvm::make_unique<CountingMemoryManager>();
+  });
+}
+
+void NativeTestRunner::loadInstrumentedLibrary(
+    ProgramLibrary &library, Instrumentation &instrumentation,
+    JITEngine &jit) {
+  auto slot = library.bindSlots(instrumentation, overrides);
+  trampoline = slot ? slot : ownTrampoline;
+  jit.addLibrary(library);
 }
 
 ExecutionStatus NativeTestRunner::runTest(JITEngine &jit, Program &program,
                                           Test &test) {
+  /// The constructors are part of the call tree of the test
   *trampoline = &test.getInstrumentationInfo();
+  runStaticConstructors(jit, program);
+  return runInitializedTest(jit, test);
+}
 
-  for (auto &constructor : program.getStaticConstructors()) {
+void NativeTestRunner::runStaticConstructors(JITEngine &jit,
+                                             Program &program) {
+  for (auto &constructor : program.getStaticConstructorNames()) {
     runStaticConstructor(constructor, jit);
   }
+}
 
-  std::vector<std::string> arguments = test.getArguments();
-  arguments.insert(arguments.begin(), test.getProgramName());
-  size_t argc = arguments.size();
-  char **argv = new char *[argc + 1];
+ExecutionStatus NativeTestRunner::runInitializedTest(JITEngine &jit,
+                                                     Test &test) {
+  *trampoline = &test.getInstrumentationInfo();
 
-  for (int i = 0; i < argc; i++) {
-    std::string &argument = arguments[i];
-    argv[i] = new char[argument.length() + 1];
-    strcpy(argv[i], argument.c_str());
-  }
-  argv[argc] = nullptr;
+  auto &arguments = test.getArgumentVector();
+  llvm::SmallVector<char *, 8> argv;
+  arguments.getArgv(argv);
 
-  void *mainPointer = getFunctionPointer(
-      mangler.getNameWithPrefix(test.getDriverFunctionName()), jit);
+  void *mainPointer = getDriverPointer(test, jit);
   auto main = ((int (*)(int, char **))(intptr_t)mainPointer);
-  int exitStatus = main(static_cast<int>(argc), argv);
-
-  for (int i = 0; i < argc; i++) {
-    delete[] argv[i];
-  }
-  delete[] argv;
+  int exitStatus = main(arguments.getArgc(), argv.data());
 
   overrides.runDestructors();
 
@@ -99,11 +139,17 @@ ExecutionStatus NativeTestRunner::runTest(JITEngine &jit, Program &program,
   return ExecutionStatus::Failed;
 }
 
+void NativeTestRunner::prepareTest(JITEngine &jit, Test &test) {
+  getDriverPointer(test, jit);
+}
+
 void NativeTestRunner::loadMutatedProgram(TestRunner::ObjectFiles &objectFiles,
                                           Trampolines &trampolines,
                                           JITEngine &jit) {
   trampolines.allocateTrampolines(mangler);
-  MutationResolver resolver(overrides, trampolines, mangler);
-  jit.addObjectFiles(objectFiles, resolver,
-                     llvm::make_unique<llvm::SectionMemoryManager>());
+  auto resolver =
+      llvm::make_unique<MutationResolver>(overrides, trampolines, mangler);
+  jit.addObjectFiles(objectFiles, std::move(resolver), []() {
+    return llvm::make_unique<CountingMemoryManager>();
+  });
 }
@@ -2,34 +2,67 @@
 
 #include "mull/Filter.h"
 #include "mull/Logger.h"
+#include "mull/Parallelization/Parallelization.h"
 #include "mull/Program/Program.h"
 
 #include <llvm/IR/Module.h>
 
+#include <iterator>
 #include <vector>
 
 using namespace mull;
 using namespace llvm;
 
+/// The tests of a module the cache knows, false if a body is gone
+static bool restoreTests(Program &program,
+                         const TestSearchCache::ModuleTests &found,
+                         std::vector<Test> &tests) {
+  std::vector<Test> restored;
+  for (auto &test : found.tests) {
+    auto body = program.lookupDefinedFunction(test.body);
+    if (body == nullptr) {
+      return false;
+    }
+    restored.push_back(Test(test.name, "mull", test.driverFunction, {}, body));
+  }
+  std::move(restored.begin(), restored.end(), std::back_inserter(tests));
+  return true;
+}
+
 std::vector<Test> SimpleTestFinder::findTests(Program &program,
                                               Filter &filter) {
   std::vector<Test> tests;
 
-  for (auto &module : program.modules()) {
-    auto &x = module->getModule()->getFunctionList();
-    for (auto &Fn : x) {
+  SingleTaskExecutor task("Searching tests", [&]() {
+    for (auto &module : program.modules()) {
+      TestSearchCache::ModuleTests found;
+      if (cache && cache->lookup(*module, found) &&
+          restoreTests(program, found, tests)) {
+        continue;
+      }
+
+      found = TestSearchCache::ModuleTests();
+      auto &x = module->getModule()->getFunctionList();
+      for (auto &Fn : x) {
 
-      /// We find C functions having test_ and the same functions if they are
-      /// compiled with C++ (mangled as "_Z25test_").
-      if (Fn.getName().find("test_") != std::string::npos) {
+        /// We find C functions having test_ and the same functions if they
+        /// are compiled with C++ (mangled as "_Z25test_").
+        if (Fn.getName().find("test_") != std::string::npos) {
 
-        Logger::info() << "SimpleTestFinder::findTests - found function "
-                       << Fn.getName() << '\n';
+          Logger::info() << "SimpleTestFinder::findTests - found function "
+                         << Fn.getName() << '\n';
 
-        tests.push_back(Test(Fn.getName(), "mull", Fn.getName(), {}, &Fn));
+          tests.push_back(Test(Fn.getName(), "mull", Fn.getName(), {}, &Fn));
+          auto name = Fn.getName().str();
+          found.tests.push_back(TestSearchCache::CachedTest{name, name, name});
+        }
+      }
+      if (cache) {
+        cache->store(*module, found);
       }
     }
-  }
+  });
+  task.execute();
 
   return tests;
 }
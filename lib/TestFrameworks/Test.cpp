@@ -1,25 +1,77 @@
 #include "mull/TestFrameworks/Test.h"
 
-#include <mull/TestFrameworks/Test.h>
+#include "mull/MullModule.h"
+
+#include <atomic>
+#include <limits>
 #include <utility>
 
 using namespace mull;
 
+ArgumentVector::ArgumentVector(const std::string &programName,
+                               const std::vector<std::string> &arguments) {
+  offsets.push_back(0);
+  block.insert(block.end(), programName.begin(), programName.end());
+  block.push_back('\0');
+  for (auto &argument : arguments) {
+    offsets.push_back(block.size());
+    block.insert(block.end(), argument.begin(), argument.end());
+    block.push_back('\0');
+  }
+}
+
+int ArgumentVector::getArgc() const { return static_cast<int>(offsets.size()); }
+
+void ArgumentVector::getArgv(llvm::SmallVectorImpl<char *> &argv) {
+  argv.clear();
+  for (auto offset : offsets) {
+    argv.push_back(block.data() + offset);
+  }
+  argv.push_back(nullptr);
+}
+
+static std::atomic<uint32_t> nextId(0);
+
 Test::Test(std::string test, std::string program,
            std::string driverFunctionName, std::vector<std::string> args,
            llvm::Function *testBody)
-    : testName(std::move(test)), programName(std::move(program)),
-      driverFunctionName(std::move(driverFunctionName)),
-      arguments(std::move(args)), testBody(testBody) {}
+    : id(nextId++), testName(std::move(test)),
+      programName(std::move(program)), driverFunctionName(std::move(driverFunctionName)),
+      arguments(std::move(args)),
+      argumentVector(std::make_shared<ArgumentVector>(programName, arguments)),
+      testBody(testBody),
+      bodyLocation(SourceLocation::nullSourceLocation()),
+      backEdges(std::numeric_limits<uint64_t>::max()), flaky(false) {}
 
-std::string Test::getTestName() const { return testName; }
-std::string Test::getProgramName() const { return programName; }
-std::string Test::getDriverFunctionName() const { return driverFunctionName; }
-std::string Test::getTestDisplayName() const { return getTestName(); }
-std::string Test::getUniqueIdentifier() const { return getTestName(); }
+uint32_t Test::getId() const { return id; }
+const std::string &Test::getTestName() const { return testName; }
+const std::string &Test::getProgramName() const { return programName; }
+const std::string &Test::getDriverFunctionName() const {
+  return driverFunctionName;
+}
+const std::string &Test::getTestDisplayName() const { return testName; }
+const std::string &Test::getUniqueIdentifier() const { return testName; }
 
 const std::vector<std::string> &Test::getArguments() const { return arguments; }
+ArgumentVector &Test::getArgumentVector() { return *argumentVector; }
 const llvm::Function *Test::getTestBody() const { return testBody; }
+
+SourceLocation Test::getSourceLocation() const {
+  if (!testBody || !bodyLocation.isNull()) {
+    return bodyLocation;
+  }
+  /// The body of a test that reached nothing may not be read yet
+  MullModule::materialize(testBody);
+  return SourceLocation::sourceLocationFromFunction(testBody);
+}
+
+void Test::keepSourceLocation() { bodyLocation = getSourceLocation(); }
+
+void Test::releaseIR() {
+  keepSourceLocation();
+  testBody = nullptr;
+}
+
 void Test::setExecutionResult(ExecutionResult result) {
   executionResult = std::move(result);
 }
@@ -27,6 +79,20 @@ const ExecutionResult &Test::getExecutionResult() const {
   return executionResult;
 }
 
+void Test::addRunningTime(int64_t nanoseconds) {
+  runningTimes.push_back(nanoseconds);
+}
+
+const std::vector<int64_t> &Test::getRunningTimes() const {
+  return runningTimes;
+}
+
+void Test::setBackEdges(uint64_t count) { backEdges = count; }
+uint64_t Test::getBackEdges() const { return backEdges; }
+
+void Test::setFlaky(bool flaky) { this->flaky = flaky; }
+bool Test::isFlaky() const { return flaky; }
+
 InstrumentationInfo &Test::getInstrumentationInfo() {
   return instrumentationInfo;
 }
@@ -3,6 +3,7 @@
 #include "mull/Config/Configuration.h"
 #include "mull/TestFrameworks/CustomTestFramework/CustomTestFinder.h"
 #include "mull/TestFrameworks/GoogleTest/GoogleTestFinder.h"
+#include "mull/TestFrameworks/GoogleTest/GoogleTestRunner.h"
 #include "mull/TestFrameworks/NativeTestRunner.h"
 #include "mull/TestFrameworks/SimpleTest/SimpleTestFinder.h"
 #include "mull/Toolchain/Toolchain.h"
@@ -10,6 +11,16 @@
 using namespace mull;
 using namespace llvm;
 
+/// The tests of the modules are kept apart for each finder
+static std::unique_ptr<TestSearchCache>
+testSearchCache(Configuration &configuration, const std::string &finder) {
+  if (!configuration.testSearchCacheEnabled || !configuration.cacheEnabled) {
+    return nullptr;
+  }
+  return make_unique<TestSearchCache>(configuration.cacheDirectory,
+                                      finder + "-1");
+}
+
 TestFramework
 TestFrameworkFactory::createTestFramework(const std::string &name,
                                           Toolchain &toolchain,
@@ -35,6 +46,7 @@ TestFramework
 TestFrameworkFactory::simpleTestFramework(Toolchain &toolchain,
                                           Configuration &configuration) {
   auto finder = make_unique<SimpleTestFinder>();
+  finder->setCache(testSearchCache(configuration, "SimpleTest"));
   auto runner = make_unique<NativeTestRunner>(toolchain.mangler());
   return TestFramework(std::move(finder), std::move(runner));
 }
@@ -42,7 +54,13 @@ TestFrameworkFactory::simpleTestFramework(Toolchain &toolchain,
 TestFramework
 TestFrameworkFactory::googleTestFramework(Toolchain &toolchain,
                                           Configuration &configuration) {
-  auto finder = make_unique<GoogleTestFinder>();
+  auto finder =
+      make_unique<GoogleTestFinder>(configuration.parallelization.workers);
+  finder->setCache(testSearchCache(configuration, "GoogleTest"));
+  if (configuration.directTestRunEnabled) {
+    auto runner = make_unique<GoogleTestRunner>(toolchain.mangler());
+    return TestFramework(std::move(finder), std::move(runner));
+  }
   auto runner = make_unique<NativeTestRunner>(toolchain.mangler());
   return TestFramework(std::move(finder), std::move(runner));
 }
@@ -0,0 +1,136 @@
+#include "mull/TestPrioritization.h"
+
+#include "mull/ChangedLines.h"
+#include "mull/MutationPoint.h"
+#include "mull/Mutators/Mutator.h"
+#include "mull/PreviousResults.h"
+#include "mull/TestFrameworks/Test.h"
+
+#include <algorithm>
+#include <memory>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+using namespace mull;
+
+namespace {
+
+/// Smaller runs first
+struct TestScore {
+  double primary;
+  double secondary;
+
+  bool operator<(const TestScore &other) const {
+    return std::tie(primary, secondary) <
+           std::tie(other.primary, other.secondary);
+  }
+};
+
+} // namespace
+
+static TestScore
+scoreOf(const std::pair<Test *, int> &reachableTest, TestOrder order,
+        const std::unordered_map<std::string, double> &killRates) {
+  auto test = reachableTest.first;
+  double distance = reachableTest.second;
+  double runtime = test->getExecutionResult().runningTime;
+  switch (order) {
+  case TestOrder::Discovery:
+    return {0, 0};
+  case TestOrder::Distance:
+    return {distance, runtime};
+  case TestOrder::Runtime:
+    return {runtime, distance};
+  case TestOrder::KillRate: {
+    auto rate = killRates.find(test->getUniqueIdentifier());
+    return {rate == killRates.end() ? 1.0 : -rate->second, runtime};
+  }
+  }
+  return {0, 0};
+}
+
+void mull::prioritizeReachableTests(
+    const std::vector<MutationPoint *> &points, TestOrder order,
+    const std::unordered_map<std::string, double> &killRates) {
+  if (order == TestOrder::Discovery) {
+    return;
+  }
+
+  /// The points of a function share their list, it is sorted once. The
+  /// lists are kept alive so that their addresses are not reused.
+  std::unordered_map<const ReachableTests *,
+                     std::shared_ptr<const ReachableTests>>
+      sortedLists;
+  std::vector<std::shared_ptr<const ReachableTests>> originalLists;
+  for (auto point : points) {
+    auto &reachableTests = point->getReachableTests();
+    if (reachableTests.size() < 2) {
+      continue;
+    }
+    auto shared = point->getSharedReachableTests();
+    auto sortedList = sortedLists.find(shared.get());
+    if (sortedList != sortedLists.end()) {
+      point->setReachableTests(sortedList->second);
+      continue;
+    }
+
+    std::vector<std::pair<TestScore, size_t>> scored;
+    scored.reserve(reachableTests.size());
+    for (size_t index = 0; index < reachableTests.size(); index++) {
+      scored.emplace_back(scoreOf(reachableTests[index], order, killRates),
+                          index);
+    }
+    std::stable_sort(scored.begin(), scored.end(),
+                     [](const std::pair<TestScore, size_t> &lhs,
+                        const std::pair<TestScore, size_t> &rhs) {
+                       return lhs.first < rhs.first;
+                     });
+
+    auto sorted = std::make_shared<ReachableTests>();
+    sorted->reserve(reachableTests.size());
+    for (auto &pair : scored) {
+      sorted->add(reachableTests.test(pair.second),
+                  reachableTests.distance(pair.second));
+    }
+    sortedLists[shared.get()] = sorted;
+    originalLists.push_back(std::move(shared));
+    point->setReachableTests(std::move(sorted));
+  }
+}
+
+std::vector<MutationPoint *>
+mull::feedbackFirst(const std::vector<MutationPoint *> &points,
+                    const ChangedLines *changes,
+                    const PreviousResults *previous) {
+  std::vector<std::pair<TestScore, MutationPoint *>> scored;
+  scored.reserve(points.size());
+  for (auto point : points) {
+    TestScore score{3, 0};
+    if (changes && changes->contains(point->getSourceLocation())) {
+      score = {0, 0};
+    } else if (previous) {
+      auto stored = previous->find(*point);
+      auto &rates = previous->getMutatorKillRates();
+      auto rate = rates.find(point->getMutator()->getUniqueIdentifier());
+      if (stored && stored->survived()) {
+        score = {1, 0};
+      } else if (rate != rates.end()) {
+        score = {2, rate->second};
+      }
+    }
+    scored.emplace_back(score, point);
+  }
+  std::stable_sort(scored.begin(), scored.end(),
+                   [](const std::pair<TestScore, MutationPoint *> &lhs,
+                      const std::pair<TestScore, MutationPoint *> &rhs) {
+                     return lhs.first < rhs.first;
+                   });
+
+  std::vector<MutationPoint *> ordered;
+  ordered.reserve(scored.size());
+  for (auto &pair : scored) {
+    ordered.push_back(pair.second);
+  }
+  return ordered;
+}
@@ -0,0 +1,97 @@
+#include "mull/TestSearchCache.h"
+
+#include "mull/CacheFile.h"
+#include "mull/Hash.h"
+#include "mull/Logger.h"
+#include "mull/MullModule.h"
+
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/StringRef.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/raw_ostream.h>
+
+using namespace mull;
+
+static const char *const Header = "mull-tests 1";
+
+TestSearchCache::TestSearchCache(const std::string &cacheDirectory,
+                                 const std::string &finder)
+    : cacheDirectory(cacheDirectory), finder(finder), hits(0) {}
+
+std::string TestSearchCache::pathOf(const MullModule &module) const {
+  return cacheDirectory + "/tests/" +
+         hashOf(finder + '\0' + module.getUniqueIdentifier(),
+                HashAlgorithm::MD5);
+}
+
+/// The format is line based, the names of the tests come last as they are
+/// the only part that is not a symbol:
+///
+///     mull-tests 1
+///     test <driver function> <body> <test name>
+///     runtime <body>
+bool TestSearchCache::lookup(const MullModule &module, ModuleTests &tests) {
+  if (cacheDirectory.empty()) {
+    return false;
+  }
+
+  auto path = pathOf(module);
+  auto buffer = llvm::MemoryBuffer::getFile(path);
+  if (!buffer) {
+    return false;
+  }
+
+  llvm::SmallVector<llvm::StringRef, 64> lines;
+  buffer.get()->getBuffer().split(lines, '\n', -1, false);
+  if (lines.empty() || lines.front() != Header) {
+    return false;
+  }
+
+  ModuleTests stored;
+  for (auto &line : llvm::makeArrayRef(lines).drop_front()) {
+    auto kindAndRest = line.split(' ');
+    if (kindAndRest.first == "test") {
+      auto driver = kindAndRest.second.split(' ');
+      auto body = driver.second.split(' ');
+      if (driver.first.empty() || body.first.empty() || body.second.empty()) {
+        return false;
+      }
+      stored.tests.push_back(CachedTest{body.second.str(), driver.first.str(),
+                                        body.first.str()});
+    } else if (kindAndRest.first == "runtime" &&
+               !kindAndRest.second.empty()) {
+      stored.runtimeBodies.push_back(kindAndRest.second.str());
+    } else {
+      return false;
+    }
+  }
+
+  tests = std::move(stored);
+  hits++;
+  return true;
+}
+
+void TestSearchCache::store(const MullModule &module,
+                            const ModuleTests &tests) {
+  if (cacheDirectory.empty()) {
+    return;
+  }
+
+  auto path = pathOf(module);
+  auto error = writeCacheFile(path, [&](llvm::raw_ostream &outfile) {
+    outfile << Header << "\n";
+    for (auto &test : tests.tests) {
+      outfile << "test " << test.driverFunction << " " << test.body << " "
+              << test.name << "\n";
+    }
+    for (auto &body : tests.runtimeBodies) {
+      outfile << "runtime " << body << "\n";
+    }
+  });
+  if (error) {
+    Logger::error() << "Cannot write test search cache file '" << path
+                    << "': " << error.message() << "\n";
+  }
+}
+
+uint64_t TestSearchCache::getHits() const { return hits; }
@@ -0,0 +1,123 @@
+#include "mull/TestSet.h"
+
+#include <llvm/Support/MathExtras.h>
+
+#include <algorithm>
+
+using namespace mull;
+
+static const uint32_t WordBits = 64;
+
+bool TestSet::insert(uint32_t id) {
+  uint32_t position = id / WordBits;
+  uint64_t bit = uint64_t(1) << (id % WordBits);
+
+  auto found = positions.end();
+  if (!positions.empty() && positions.back() >= position) {
+    found = positions.back() == position
+                ? positions.end() - 1
+                : std::lower_bound(positions.begin(), positions.end(),
+                                   position);
+  }
+
+  auto index = found - positions.begin();
+  if (found == positions.end() || *found != position) {
+    positions.insert(found, position);
+    words.insert(words.begin() + index, bit);
+    return true;
+  }
+  if (words[index] & bit) {
+    return false;
+  }
+  words[index] |= bit;
+  return true;
+}
+
+bool TestSet::contains(uint32_t id) const {
+  uint32_t position = id / WordBits;
+  auto found = std::lower_bound(positions.begin(), positions.end(), position);
+  if (found == positions.end() || *found != position) {
+    return false;
+  }
+  return words[found - positions.begin()] & (uint64_t(1) << (id % WordBits));
+}
+
+size_t TestSet::size() const {
+  size_t count = 0;
+  for (auto word : words) {
+    count += llvm::countPopulation(word);
+  }
+  return count;
+}
+
+void TestSet::unite(const TestSet &other) {
+  std::vector<uint32_t> unitedPositions;
+  std::vector<uint64_t> unitedWords;
+  unitedPositions.reserve(positions.size() + other.positions.size());
+  unitedWords.reserve(words.size() + other.words.size());
+
+  size_t left = 0;
+  size_t right = 0;
+  while (left < positions.size() || right < other.positions.size()) {
+    if (right == other.positions.size() ||
+        (left < positions.size() && positions[left] < other.positions[right])) {
+      unitedPositions.push_back(positions[left]);
+      unitedWords.push_back(words[left++]);
+    } else if (left == positions.size() ||
+               other.positions[right] < positions[left]) {
+      unitedPositions.push_back(other.positions[right]);
+      unitedWords.push_back(other.words[right++]);
+    } else {
+      unitedPositions.push_back(positions[left]);
+      unitedWords.push_back(words[left++] | other.words[right++]);
+    }
+  }
+
+  positions = std::move(unitedPositions);
+  words = std::move(unitedWords);
+}
+
+bool TestSet::intersects(const TestSet &other) const {
+  size_t left = 0;
+  size_t right = 0;
+  while (left < positions.size() && right < other.positions.size()) {
+    if (positions[left] < other.positions[right]) {
+      left++;
+    } else if (other.positions[right] < positions[left]) {
+      right++;
+    } else if (words[left++] & other.words[right++]) {
+      return true;
+    }
+  }
+  return false;
+}
+
+size_t TestSet::intersectionSize(const TestSet &other) const {
+  size_t count = 0;
+  size_t left = 0;
+  size_t right = 0;
+  while (left < positions.size() && right < other.positions.size()) {
+    if (positions[left] < other.positions[right]) {
+      left++;
+    } else if (other.positions[right] < positions[left]) {
+      right++;
+    } else {
+      count += llvm::countPopulation(words[left++] & other.words[right++]);
+    }
+  }
+  return count;
+}
+
+std::vector<uint32_t> TestSet::ids() const {
+  std::vector<uint32_t> ids;
+  ids.reserve(size());
+  for (size_t index = 0; index < words.size(); index++) {
+    uint64_t word = words[index];
+    while (word != 0) {
+      ids.push_back(positions[index] * WordBits +
+                    llvm::countTrailingZeros(word));
+      word &= word - 1;
+    }
+  }
+  return ids;
+}
@@ -0,0 +1,111 @@
+#include "mull/TestSuiteMinimization.h"
+
+#include "mull/KillMatrix.h"
+#include "mull/Parallelization/ThreadPool.h"
+
+#include <llvm/Support/MathExtras.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+
+using namespace mull;
+
+static const size_t WordBits = 64;
+
+static bool killed(KillMatrix::Cell cell) {
+  return cell == KillMatrix::Cell::Killed ||
+         cell == KillMatrix::Cell::Abnormal;
+}
+
+std::vector<size_t> mull::minimizeTestSuite(const KillMatrix &matrix,
+                                            size_t workers) {
+  const size_t rowCount = matrix.getRowCount();
+  const size_t columnCount = matrix.getColumnCount();
+  const size_t wordCount = (rowCount + WordBits - 1) / WordBits;
+  if (columnCount == 0) {
+    return {};
+  }
+  workers = std::max<size_t>(workers, 1);
+  const size_t step = (columnCount + workers - 1) / workers;
+
+  auto inParallel = [&](const std::function<void(size_t, size_t)> &job) {
+    WorkerGroup group(ThreadPool::shared());
+    for (size_t begin = 0; begin < columnCount; begin += step) {
+      auto end = std::min(begin + step, columnCount);
+      group.run([&job, begin, end]() { job(begin, end); });
+    }
+    group.wait();
+  };
+
+  /// The rows are read once per worker, each of them sets the bits of its
+  /// own columns
+  std::vector<std::vector<uint64_t>> kills(columnCount);
+  inParallel([&](size_t begin, size_t end) {
+    for (size_t column = begin; column < end; column++) {
+      kills[column].assign(wordCount, 0);
+    }
+    for (size_t row = 0; row < rowCount; row++) {
+      uint64_t bit = uint64_t(1) << (row % WordBits);
+      for (size_t column = begin; column < end; column++) {
+        if (killed(matrix.get(row, column))) {
+          kills[column][row / WordBits] |= bit;
+        }
+      }
+    }
+  });
+
+  std::vector<uint64_t> uncovered(wordCount, 0);
+  for (auto &column : kills) {
+    for (size_t word = 0; word < wordCount; word++) {
+      uncovered[word] |= column[word];
+    }
+  }
+
+  std::vector<size_t> picked;
+  std::vector<size_t> gains(columnCount);
+  while (true) {
+    inParallel([&](size_t begin, size_t end) {
+      for (size_t column = begin; column < end; column++) {
+        size_t gain = 0;
+        for (size_t word = 0; word < wordCount; word++) {
+          gain += llvm::countPopulation(kills[column][word] & uncovered[word]);
+        }
+        gains[column] = gain;
+      }
+    });
+
+    auto best = std::max_element(gains.begin(), gains.end());
+    if (*best == 0) {
+      break;
+    }
+    auto column = std::distance(gains.begin(), best);
+    picked.push_back(column);
+    for (size_t word = 0; word < wordCount; word++) {
+      uncovered[word] &= ~kills[column][word];
+    }
+  }
+  return picked;
+}
+
+/// The names are quoted, they may well contain a colon
+bool mull::writeTestList(const std::string &path,
+                         const std::vector<std::string> &testNames) {
+  std::ofstream file(path);
+  if (!file) {
+    return false;
+  }
+  file << "tests:\n";
+  for (auto &name : testNames) {
+    file << "  - '";
+    for (auto character : name) {
+      file << character;
+      if (character == '\'') {
+        file << '\'';
+      }
+    }
+    file << "'\n";
+  }
+  return bool(file);
+}
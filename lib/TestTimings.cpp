@@ -0,0 +1,140 @@
+#include "mull/TestTimings.h"
+
+#include "mull/CacheFile.h"
+#include "mull/Hash.h"
+#include "mull/Logger.h"
+#include "mull/MullModule.h"
+#include "mull/Program/Program.h"
+#include "mull/TestFrameworks/Test.h"
+#include "mull/TimeoutPolicy.h"
+
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/StringRef.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <algorithm>
+
+using namespace mull;
+
+static const char *const Header = "mull-timings 1";
+
+TestTimings::TestTimings(const std::string &cacheDirectory)
+    : cacheDirectory(cacheDirectory) {}
+
+void TestTimings::load(Program &program) {
+  if (cacheDirectory.empty()) {
+    return;
+  }
+
+  std::vector<std::string> modules;
+  for (auto &module : program.modules()) {
+    modules.push_back(module->getModule()->getModuleIdentifier());
+  }
+  std::sort(modules.begin(), modules.end());
+
+  std::string identifier;
+  for (auto &module : modules) {
+    identifier += '\0' + module;
+  }
+  path = cacheDirectory + "/timings/" +
+         mull::hashOf(identifier, HashAlgorithm::MD5);
+
+  if (!read()) {
+    timings.clear();
+  }
+}
+
+/// The format is line based:
+///
+///     mull-timings 1
+///     <nanoseconds> <test identifier>
+bool TestTimings::read() {
+  auto buffer = llvm::MemoryBuffer::getFile(path);
+  if (!buffer) {
+    return false;
+  }
+
+  llvm::SmallVector<llvm::StringRef, 64> lines;
+  buffer.get()->getBuffer().split(lines, '\n', -1, false);
+  if (lines.empty() || lines.front() != Header) {
+    return false;
+  }
+
+  for (auto &line : llvm::makeArrayRef(lines).drop_front()) {
+    auto timeAndTest = line.split(' ');
+    int64_t time = 0;
+    if (timeAndTest.first.getAsInteger(10, time) ||
+        timeAndTest.second.empty()) {
+      return false;
+    }
+    timings[timeAndTest.second.str()] = time;
+  }
+  return true;
+}
+
+bool TestTimings::sortLongestFirst(std::vector<Test *> &tests) const {
+  std::vector<int64_t> times;
+  times.reserve(tests.size());
+  bool known = false;
+  for (auto test : tests) {
+    auto timing = timings.find(test->getUniqueIdentifier());
+    times.push_back(timing == timings.end() ? -1 : timing->second);
+    known = known || timing != timings.end();
+  }
+  if (!known) {
+    return false;
+  }
+
+  std::vector<size_t> order(tests.size());
+  for (size_t index = 0; index < order.size(); index++) {
+    order[index] = index;
+  }
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return times[a] > times[b];
+  });
+
+  std::vector<Test *> sorted;
+  sorted.reserve(tests.size());
+  for (auto index : order) {
+    sorted.push_back(tests[index]);
+  }
+  tests.swap(sorted);
+  return true;
+}
+
+void TestTimings::save(const std::vector<Test> &tests) {
+  if (path.empty()) {
+    return;
+  }
+
+  std::unordered_map<std::string, int64_t> current;
+  for (auto &test : tests) {
+    auto &result = test.getExecutionResult();
+    auto &identifier = test.getUniqueIdentifier();
+    if (result.status != ExecutionStatus::Invalid) {
+      current[identifier] = TimeoutPolicy::runningTime(result);
+      continue;
+    }
+    auto timing = timings.find(identifier);
+    if (timing != timings.end()) {
+      current[identifier] = timing->second;
+    }
+  }
+  timings.swap(current);
+  write();
+}
+
+void TestTimings::write() {
+  auto error = writeCacheFile(path, [&](llvm::raw_ostream &outfile) {
+    outfile << Header << "\n";
+    for (auto &timing : timings) {
+      outfile << timing.second << " " << timing.first << "\n";
+    }
+  });
+  if (error) {
+    Logger::warn() << "Cannot write the test timings to " << path << ": "
+                   << error.message() << "\n";
+  }
+}
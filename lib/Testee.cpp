@@ -1,35 +1,124 @@
 #include "mull/Testee.h"
 
+#include "mull/Parallelization/TaskExecutor.h"
+#include "mull/Parallelization/ThreadPool.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
 namespace mull {
-std::vector<MergedTestee>
-mergeTestees(std::vector<std::unique_ptr<Testee>> &testees) {
-  std::map<llvm::Function *, MergedTestee> testeesMap;
+namespace {
+/// Finds the merged testee of a function
+class TesteePositions {
+public:
+  /// The position of the merged testee of the function, or the given new
+  /// position if the function has none yet
+  size_t find(llvm::Function *function, uint32_t index, size_t position,
+              bool &merged) {
+    if (index != 0) {
+      if (index >= indexedPositions.size()) {
+        indexedPositions.resize(index + 1, 0);
+      }
+      merged = indexedPositions[index] != 0;
+      if (merged) {
+        return indexedPositions[index] - 1;
+      }
+      indexedPositions[index] = position + 1;
+      return position;
+    }
+    auto inserted = positions.emplace(function, position);
+    merged = !inserted.second;
+    return inserted.first->second;
+  }
+
+private:
+  /// The position of the merged testee of a function plus one, 0 if the
+  /// function has none yet
+  std::vector<size_t> indexedPositions;
+  std::unordered_map<llvm::Function *, size_t> positions;
+};
 
-  for (auto &testee : testees) {
+/// The testees of a range merged on their own, along with the index of the
+/// function of each of them
+struct PartialMerge {
+  std::vector<MergedTestee> testees;
+  std::vector<uint32_t> functionIndices;
+};
+
+PartialMerge
+mergeRange(std::vector<std::unique_ptr<Testee>>::const_iterator begin,
+           std::vector<std::unique_ptr<Testee>>::const_iterator end) {
+  PartialMerge partial;
+  TesteePositions positions;
+  for (auto it = begin; it != end; ++it) {
+    auto &testee = *it;
     auto function = testee->getTesteeFunction();
-    auto test = testee->getTest();
-    auto distance = testee->getDistance();
-    auto merged = testeesMap.find(function);
-    if (merged != testeesMap.end()) {
-      merged->second.addReachableTest(test, distance);
+    auto index = testee->getFunctionIndex();
+    bool merged;
+    auto position =
+        positions.find(function, index, partial.testees.size(), merged);
+    if (merged) {
+      partial.testees[position].addReachableTest(testee->getTest(),
+                                                 testee->getDistance());
     } else {
-      testeesMap.insert(
-          std::make_pair(function, MergedTestee(function, test, distance)));
+      partial.testees.emplace_back(function, testee->getTest(),
+                                   testee->getDistance());
+      partial.functionIndices.push_back(index);
     }
   }
+  return partial;
+}
+} // namespace
 
-  std::vector<MergedTestee> mergedTestees;
-  for (auto &testee : testees) {
-    /// TODO: We could have just accumulated contents from the map,
-    /// But it would break the order of mutants: some of our tests depend on it
-    if (testeesMap.empty()) {
-      break;
-    }
-    auto function = testee->getTesteeFunction();
-    auto mergedTestee = testeesMap.find(function);
-    if (mergedTestee != testeesMap.end()) {
-      mergedTestees.push_back((*mergedTestee).second);
-      testeesMap.erase(mergedTestee);
+std::vector<MergedTestee>
+mergeTestees(std::vector<std::unique_ptr<Testee>> &testees) {
+  return std::move(mergeRange(testees.begin(), testees.end()).testees);
+}
+
+std::vector<MergedTestee>
+mergeTestees(std::vector<std::unique_ptr<Testee>> &testees, size_t workers) {
+  workers = std::min(workers, testees.size());
+  if (workers <= 1) {
+    return mergeTestees(testees);
+  }
+
+  auto batches = taskBatches(testees.size(), workers);
+  std::vector<PartialMerge> partials(workers);
+  WorkerGroup workerGroup(ThreadPool::shared());
+  auto begin = testees.cbegin();
+  for (size_t i = 0; i < workers; i++) {
+    auto end = begin + batches[i];
+    workerGroup.run([&partials, i, begin, end]() {
+      partials[i] = mergeRange(begin, end);
+    });
+    begin = end;
+  }
+  workerGroup.wait();
+
+  /// The ranges are combined in their order, so a function comes where it
+  /// first appears and its tests keep the order of the testees
+  std::vector<MergedTestee> mergedTestees(std::move(partials.front().testees));
+  TesteePositions positions;
+  for (size_t i = 0; i < mergedTestees.size(); i++) {
+    bool merged;
+    positions.find(mergedTestees[i].getTesteeFunction(),
+                   partials.front().functionIndices[i], i, merged);
+  }
+  for (size_t p = 1; p < partials.size(); p++) {
+    auto &partial = partials[p];
+    for (size_t i = 0; i < partial.testees.size(); i++) {
+      auto &testee = partial.testees[i];
+      bool merged;
+      auto position =
+          positions.find(testee.getTesteeFunction(),
+                         partial.functionIndices[i], mergedTestees.size(),
+                         merged);
+      if (merged) {
+        mergedTestees[position].addReachableTests(testee);
+      } else {
+        mergedTestees.push_back(std::move(testee));
+      }
     }
   }
 
@@ -44,11 +133,19 @@ mull::MergedTestee::MergedTestee(llvm::Function *function, mull::Test *test,
 }
 
 void mull::MergedTestee::addReachableTest(mull::Test *test, int distance) {
-  reachableTests.emplace_back(test, distance);
+  ReachableTests::modifiable(reachableTests).add(test, distance);
+}
+
+void mull::MergedTestee::addReachableTests(const MergedTestee &other) {
+  ReachableTests::modifiable(reachableTests).append(*other.reachableTests);
 }
 
-const std::vector<std::pair<mull::Test *, int>> &
-mull::MergedTestee::getReachableTests() const {
+const mull::ReachableTests &mull::MergedTestee::getReachableTests() const {
+  return *reachableTests;
+}
+
+const std::shared_ptr<const mull::ReachableTests> &
+mull::MergedTestee::getSharedReachableTests() const {
   return reachableTests;
 }
 
@@ -57,8 +154,9 @@ llvm::Function *mull::MergedTestee::getTesteeFunction() const {
 }
 
 mull::Testee::Testee(llvm::Function *testeeFunction, mull::Test *test,
-                     int distance)
-    : testeeFunction(testeeFunction), test(test), distance(distance) {}
+                     int distance, uint32_t functionIndex)
+    : testeeFunction(testeeFunction), test(test), distance(distance),
+      functionIndex(functionIndex) {}
 
 llvm::Function *mull::Testee::getTesteeFunction() const {
   return testeeFunction;
@@ -67,3 +165,5 @@ llvm::Function *mull::Testee::getTesteeFunction() const {
 mull::Test *mull::Testee::getTest() const { return test; }
 
 int mull::Testee::getDistance() const { return distance; }
+
+uint32_t mull::Testee::getFunctionIndex() const { return functionIndex; }
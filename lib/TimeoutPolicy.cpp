@@ -0,0 +1,67 @@
+#include "mull/TimeoutPolicy.h"
+
+#include "mull/Config/Configuration.h"
+#include "mull/ExecutionResult.h"
+#include "mull/TestFrameworks/Test.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+using namespace mull;
+
+static const double NanosecondsPerMillisecond = 1000000.0;
+
+TimeoutPolicy::TimeoutPolicy(const TimeoutPolicyConfig &config, int workers,
+                             unsigned cores)
+    : config(config),
+      load(std::max(1.0, double(workers) / double(std::max(cores, 1u)))) {}
+
+TimeoutPolicy::TimeoutPolicy(const Configuration &config)
+    : TimeoutPolicy(config.timeoutPolicy,
+                    config.parallelization.mutantExecutionWorkers,
+                    std::thread::hardware_concurrency()) {}
+
+long long TimeoutPolicy::timeout(const Test &test) const {
+  auto &runningTimes = test.getRunningTimes();
+  if (!runningTimes.empty()) {
+    return timeout(runningTimes);
+  }
+  return timeout({runningTime(test.getExecutionResult())});
+}
+
+long long
+TimeoutPolicy::timeout(const std::vector<int64_t> &runningTimes) const {
+  double mean = 0;
+  for (auto time : runningTimes) {
+    mean += time;
+  }
+  mean /= std::max(runningTimes.size(), size_t(1));
+
+  double variance = 0;
+  if (runningTimes.size() > 1) {
+    for (auto time : runningTimes) {
+      variance += (time - mean) * (time - mean);
+    }
+    variance /= runningTimes.size() - 1;
+  }
+
+  double expected = (mean + config.deviations * std::sqrt(variance)) *
+                    config.multiplier * load;
+  auto milliseconds =
+      static_cast<long long>(std::ceil(expected / NanosecondsPerMillisecond));
+
+  milliseconds = std::max(milliseconds, static_cast<long long>(config.floor));
+  if (config.ceiling != 0) {
+    milliseconds =
+        std::min(milliseconds, static_cast<long long>(config.ceiling));
+  }
+  return milliseconds;
+}
+
+int64_t TimeoutPolicy::runningTime(const ExecutionResult &result) {
+  if (result.timings.test != 0) {
+    return result.timings.test;
+  }
+  return int64_t(result.runningTime) * int64_t(NanosecondsPerMillisecond);
+}
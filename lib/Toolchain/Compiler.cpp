@@ -2,9 +2,13 @@
 
 #include "LLVMCompatibility.h"
 #include "mull/MullModule.h"
+#include "mull/Parallelization/ThreadPool.h"
 
 #include <llvm/ExecutionEngine/Orc/CompileUtils.h>
+#include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Module.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/raw_ostream.h>
 
 using namespace llvm;
 using namespace llvm::object;
@@ -30,3 +34,39 @@ OwningBinary<ObjectFile> Compiler::compileModule(Module *module,
 
   return objectFile;
 }
+
+/// The parts are passed to the other threads as bitcode: a module cannot
+/// leave its context, and the context cannot be used by several threads
+std::vector<OwningBinary<ObjectFile>>
+Compiler::compileModuleInParts(const Module &module, unsigned parts,
+                               std::function<TargetMachine &()> machine) {
+  std::vector<std::string> bitcodes;
+  llvm_compat::splitModule(module, parts, [&](std::unique_ptr<Module> part) {
+    std::string bitcode;
+    raw_string_ostream stream(bitcode);
+    llvm_compat::writeBitcode(*part, stream);
+    stream.flush();
+    bitcodes.push_back(std::move(bitcode));
+  });
+
+  std::vector<OwningBinary<ObjectFile>> objects(bitcodes.size());
+  auto compilePart = [&](size_t index) {
+    LLVMContext context;
+    MemoryBufferRef buffer(bitcodes[index], module.getModuleIdentifier());
+    auto part = llvm_compat::parseBitcode(buffer, context);
+    if (part) {
+      objects[index] = compileModule(part.get(), machine());
+    }
+  };
+
+  WorkerGroup workers(ThreadPool::shared());
+  for (size_t index = 1; index < bitcodes.size(); index++) {
+    workers.run([&compilePart, index]() { compilePart(index); });
+  }
+  if (!bitcodes.empty()) {
+    compilePart(0);
+  }
+  workers.wait();
+
+  return objects;
+}
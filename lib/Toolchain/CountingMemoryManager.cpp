@@ -0,0 +1,142 @@
+#include "mull/Toolchain/CountingMemoryManager.h"
+
+#include <cstring>
+#include <mutex>
+#include <set>
+
+using namespace mull;
+using namespace llvm;
+
+std::atomic<uint64_t> CountingMemoryManager::bytes(0);
+
+static std::atomic<uint64_t> nextIdentifier(1);
+
+/// The finalized managers, the ones still being loaded may be relocated
+static std::mutex &finalizedMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+static std::set<CountingMemoryManager *> &finalizedManagers() {
+  static std::set<CountingMemoryManager *> managers;
+  return managers;
+}
+
+CountingMemoryManager::CountingMemoryManager()
+    : identifier(nextIdentifier.fetch_add(1, std::memory_order_relaxed)) {}
+
+CountingMemoryManager::~CountingMemoryManager() {
+  std::lock_guard<std::mutex> lock(finalizedMutex());
+  finalizedManagers().erase(this);
+}
+
+uint8_t *CountingMemoryManager::allocateCodeSection(uintptr_t size,
+                                                    unsigned alignment,
+                                                    unsigned sectionID,
+                                                    StringRef sectionName) {
+  bytes.fetch_add(size, std::memory_order_relaxed);
+  return SlabMemoryManager::allocateCodeSection(size, alignment, sectionID,
+                                                sectionName);
+}
+
+uint8_t *CountingMemoryManager::allocateDataSection(uintptr_t size,
+                                                    unsigned alignment,
+                                                    unsigned sectionID,
+                                                    StringRef sectionName,
+                                                    bool isReadOnly) {
+  bytes.fetch_add(size, std::memory_order_relaxed);
+  auto section = SlabMemoryManager::allocateDataSection(
+      size, alignment, sectionID, sectionName, isReadOnly);
+  if (!isReadOnly && section && size != 0) {
+    writableSections.emplace_back(section, size);
+  }
+  return section;
+}
+
+bool CountingMemoryManager::finalizeMemory(std::string *errorMessage) {
+  bool failed = SlabMemoryManager::finalizeMemory(errorMessage);
+  std::lock_guard<std::mutex> lock(finalizedMutex());
+  finalizedManagers().insert(this);
+  return failed;
+}
+
+uint64_t CountingMemoryManager::allocatedBytes() {
+  return bytes.load(std::memory_order_relaxed);
+}
+
+void CountingMemoryManager::forEachWritableSection(
+    const std::function<void(uint64_t, uint8_t *, uintptr_t)> &callback) {
+  std::lock_guard<std::mutex> lock(finalizedMutex());
+  for (auto manager : finalizedManagers()) {
+    for (auto &section : manager->writableSections) {
+      callback(manager->identifier, section.first, section.second);
+    }
+  }
+}
+
+bool CountingMemoryManager::forEachWritableSectionInChild(
+    const std::function<void(uint64_t, uint8_t *, uintptr_t)> &callback) {
+  std::unique_lock<std::mutex> lock(finalizedMutex(), std::try_to_lock);
+  if (!lock.owns_lock()) {
+    return false;
+  }
+  for (auto manager : finalizedManagers()) {
+    for (auto &section : manager->writableSections) {
+      callback(manager->identifier, section.first, section.second);
+    }
+  }
+  return true;
+}
+
+void WritableSectionsSnapshot::take() {
+  sections.clear();
+  CountingMemoryManager::forEachWritableSection(
+      [&](uint64_t manager, uint8_t *address, uintptr_t size) {
+        sections[std::make_pair(manager, address)].assign(address,
+                                                          address + size);
+      });
+}
+
+void WritableSectionsSnapshot::restoreSection(uint64_t manager,
+                                              uint8_t *address,
+                                              uintptr_t size) const {
+  auto copy = sections.find(std::make_pair(manager, address));
+  if (copy != sections.end() && copy->second.size() == size) {
+    memcpy(address, copy->second.data(), size);
+  }
+}
+
+void WritableSectionsSnapshot::restore() const {
+  CountingMemoryManager::forEachWritableSection(
+      [this](uint64_t manager, uint8_t *address, uintptr_t size) {
+        restoreSection(manager, address, size);
+      });
+}
+
+bool WritableSectionsSnapshot::takeInChild() {
+  sections.clear();
+  return CountingMemoryManager::forEachWritableSectionInChild(
+      [&](uint64_t manager, uint8_t *address, uintptr_t size) {
+        sections[std::make_pair(manager, address)].assign(address,
+                                                          address + size);
+      });
+}
+
+bool WritableSectionsSnapshot::matchesInChild() const {
+  bool matches = true;
+  bool looked = CountingMemoryManager::forEachWritableSectionInChild(
+      [&](uint64_t manager, uint8_t *address, uintptr_t size) {
+        auto copy = sections.find(std::make_pair(manager, address));
+        matches = matches && copy != sections.end() &&
+                  copy->second.size() == size &&
+                  memcmp(address, copy->second.data(), size) == 0;
+      });
+  return looked && matches;
+}
+
+bool WritableSectionsSnapshot::restoreInChild() const {
+  return CountingMemoryManager::forEachWritableSectionInChild(
+      [this](uint64_t manager, uint8_t *address, uintptr_t size) {
+        restoreSection(manager, address, size);
+      });
+}
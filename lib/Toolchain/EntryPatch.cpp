@@ -0,0 +1,80 @@
+#include "mull/Toolchain/EntryPatch.h"
+
+#include <cstring>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace mull;
+
+#if defined(__x86_64__)
+static const size_t JumpSize = 5;
+#elif defined(__aarch64__)
+static const size_t JumpSize = 4;
+#else
+static const size_t JumpSize = 0;
+#endif
+
+EntryPatch::EntryPatch(uint64_t entry) : entry(entry) {
+  static_assert(JumpSize <= MaxJumpSize, "The jump must fit the patch");
+  memcpy(original, reinterpret_cast<const void *>(entry), JumpSize);
+}
+
+bool EntryPatch::reaches(uint64_t entry, uint64_t target) {
+  auto offset = int64_t(target) - int64_t(entry);
+#if defined(__x86_64__)
+  offset -= int64_t(JumpSize);
+  return offset >= INT32_MIN && offset <= INT32_MAX;
+#elif defined(__aarch64__)
+  const int64_t range = int64_t(1) << 27;
+  return offset % 4 == 0 && offset >= -range && offset < range;
+#else
+  (void)offset;
+  return false;
+#endif
+}
+
+bool EntryPatch::jumpTo(uint64_t target) const {
+  if (!reaches(entry, target)) {
+    return restore();
+  }
+  uint8_t jump[MaxJumpSize];
+  auto offset = int64_t(target) - int64_t(entry);
+#if defined(__x86_64__)
+  auto displacement = int32_t(offset - int64_t(JumpSize));
+  jump[0] = 0xE9;
+  memcpy(jump + 1, &displacement, sizeof(displacement));
+#elif defined(__aarch64__)
+  uint32_t branch = 0x14000000u | (uint32_t(offset >> 2) & 0x03FFFFFFu);
+  memcpy(jump, &branch, sizeof(branch));
+#else
+  (void)offset;
+#endif
+  return write(jump, JumpSize);
+}
+
+bool EntryPatch::restore() const { return write(original, JumpSize); }
+
+bool EntryPatch::write(const uint8_t *bytes, size_t size) const {
+  if (size == 0) {
+    return false;
+  }
+  auto target = reinterpret_cast<uint8_t *>(entry);
+  if (memcmp(target, bytes, size) == 0) {
+    return true;
+  }
+
+  /// The entry may straddle two pages
+  const uint64_t pageSize = uint64_t(sysconf(_SC_PAGESIZE));
+  uint64_t first = entry & ~(pageSize - 1);
+  uint64_t last = (entry + size - 1) & ~(pageSize - 1);
+  auto pages = reinterpret_cast<void *>(first);
+  size_t length = size_t(last - first + pageSize);
+  if (mprotect(pages, length, PROT_READ | PROT_WRITE) != 0) {
+    return false;
+  }
+  memcpy(target, bytes, size);
+  mprotect(pages, length, PROT_READ | PROT_EXEC);
+  __builtin___clear_cache(reinterpret_cast<char *>(target),
+                          reinterpret_cast<char *>(target + size));
+  return true;
+}
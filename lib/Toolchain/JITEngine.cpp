@@ -1,21 +1,329 @@
 #include "mull/Toolchain/JITEngine.h"
 
+#include "mull/Parallelization/ThreadPool.h"
+#include "mull/Toolchain/ProgramLibrary.h"
+#include "mull/Toolchain/SymbolIndex.h"
+
+#include <llvm/ExecutionEngine/RuntimeDyld.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <thread>
+
 using namespace mull;
 using namespace llvm;
 
-JITEngine::JITEngine() : symbolNotFound(nullptr) {}
+/// Every object gets its own loader and memory: relocating an object may
+/// trigger relocation of the objects it references, which then must not
+/// finalize the memory of the object still being relocated.
+/// Weak definitions are not shared between the objects, each object keeps
+/// using its own copy of a weak symbol it defines.
+class JITEngine::LazyLinker : public llvm_compat::SymbolResolver {
+public:
+  LazyLinker(const SymbolIndex &symbolIndex,
+             llvm_compat::SymbolResolver &externalResolver,
+             MemoryManagerFactory createMemoryManager)
+      : symbolIndex(symbolIndex), externalResolver(externalResolver),
+        createMemoryManager(std::move(createMemoryManager)),
+        objects(symbolIndex.getObjectFiles().size()) {}
 
-void JITEngine::addObjectFiles(
-    std::vector<object::ObjectFile *> &files,
-    llvm_compat::SymbolResolver &resolver,
-    std::unique_ptr<llvm::RuntimeDyld::MemoryManager> memManager) {
+  /// Returns 0 when none of the objects defines the symbol
+  uint64_t materialize(StringRef name) {
+    size_t objectIndex = 0;
+    if (!symbolIndex.lookup(name, objectIndex)) {
+      return 0;
+    }
+
+    auto &object = objects[objectIndex];
+    if (!object.loader) {
+      load(object, *symbolIndex.getObjectFiles()[objectIndex]);
+    }
+    return object.loader->getSymbol(name).getAddress();
+  }
+
+  llvm_compat::JITSymbolInfo findSymbol(const std::string &name) override {
+    if (auto address = materialize(name)) {
+      return llvm_compat::JITSymbolInfo(address, JITSymbolFlags::Exported);
+    }
+    return externalResolver.findSymbol(name);
+  }
+
+  llvm_compat::JITSymbolInfo
+  findSymbolInLogicalDylib(const std::string &name) override {
+    return externalResolver.findSymbolInLogicalDylib(name);
+  }
+
+private:
+  struct Object {
+    std::unique_ptr<RuntimeDyld::MemoryManager> memoryManager;
+    std::unique_ptr<RuntimeDyld> loader;
+  };
+
+  /// The addresses are known as soon as the sections are allocated, so the
+  /// objects referencing this one back find them during finalization
+  void load(Object &object, object::ObjectFile &file) {
+    object.memoryManager = createMemoryManager();
+    object.loader = make_unique<RuntimeDyld>(*object.memoryManager, *this);
+    object.loader->setProcessAllSections(false);
+    object.loader->loadObject(file);
+    object.loader->finalizeWithMemoryManagerLocking();
+  }
+
+  const SymbolIndex &symbolIndex;
+  llvm_compat::SymbolResolver &externalResolver;
+  MemoryManagerFactory createMemoryManager;
+  std::vector<Object> objects;
+};
+
+/// A shard is a contiguous range of the objects with its own loader and
+/// memory. Loading allocates the sections and fills the symbol table of every
+/// shard, the relocations wait until all the shards are loaded: by then the
+/// tables are only read, so a shard looks up the symbols of the others
+/// through the symbol index without a lock. The lookups of the symbols none
+/// of the objects define are serialized, the external resolvers are not
+/// thread-safe.
+/// A weak definition is only kept by the object the index assigns it to, as
+/// if all the objects shared a loader: the other copies are left out and
+/// their references are bound to that one.
+class JITEngine::ParallelLinker {
+public:
+  ParallelLinker(const SymbolIndex &symbolIndex,
+                 llvm_compat::SymbolResolver &externalResolver,
+                 MemoryManagerFactory createMemoryManager)
+      : symbolIndex(symbolIndex), externalResolver(externalResolver),
+        createMemoryManager(std::move(createMemoryManager)),
+        objectsPerShard(1), relocating(false) {}
+
+  void link() {
+    auto &objectFiles = symbolIndex.getObjectFiles();
+    const size_t threads = std::max(std::thread::hardware_concurrency(), 1u);
+    const size_t shardCount = std::max<size_t>(
+        std::min(threads, objectFiles.size() / MinimumObjectsPerShard), 1);
+    objectsPerShard =
+        std::max<size_t>((objectFiles.size() + shardCount - 1) / shardCount, 1);
+    shards.resize((objectFiles.size() + objectsPerShard - 1) / objectsPerShard);
+
+    inParallel([this, &objectFiles](size_t index) {
+      auto &shard = shards[index];
+      shard.resolver = make_unique<ShardResolver>(*this, shard);
+      shard.memoryManager = createMemoryManager();
+      shard.loader =
+          make_unique<RuntimeDyld>(*shard.memoryManager, *shard.resolver);
+      shard.loader->setProcessAllSections(false);
+      const size_t end =
+          std::min((index + 1) * objectsPerShard, objectFiles.size());
+      for (size_t object = index * objectsPerShard; object < end; object++) {
+        shard.loadingObject = object;
+        shard.loader->loadObject(*objectFiles[object]);
+      }
+    });
+    relocating = true;
+    inParallel([this](size_t index) {
+      shards[index].loader->finalizeWithMemoryManagerLocking();
+    });
+  }
+
+  /// The loader of the shard defining the symbol, nullptr when none does.
+  /// The symbols the index leaves out, e.g. the local ones, are looked up
+  /// in every shard.
+  RuntimeDyld *findLoader(StringRef name) {
+    size_t objectIndex = 0;
+    if (symbolIndex.lookup(name, objectIndex)) {
+      return shards[objectIndex / objectsPerShard].loader.get();
+    }
+    for (auto &shard : shards) {
+      if (shard.loader->getSymbol(name).getAddress() != 0) {
+        return shard.loader.get();
+      }
+    }
+    return nullptr;
+  }
+
+private:
+  /// Below that, a thread costs more than relocating the objects
+  static const size_t MinimumObjectsPerShard = 16;
+  /// Stands for a definition of another object while the shards are loaded:
+  /// the loaders only read the flags then, the address comes with the
+  /// relocations
+  static const uint64_t NotYetLoaded = ~uint64_t(0);
+
+  class ShardResolver;
+
+  struct Shard {
+    std::unique_ptr<ShardResolver> resolver;
+    std::unique_ptr<RuntimeDyld::MemoryManager> memoryManager;
+    std::unique_ptr<RuntimeDyld> loader;
+    size_t loadingObject = 0;
+  };
+
+  class ShardResolver : public llvm_compat::SymbolResolver {
+  public:
+    ShardResolver(ParallelLinker &linker, Shard &shard)
+        : linker(linker), shard(shard) {}
+
+    llvm_compat::JITSymbolInfo findSymbol(const std::string &name) override {
+      return linker.findSymbol(name);
+    }
+
+    /// A weak definition is left out when the symbol is reported here as
+    /// defined, by an object other than the one being loaded
+    llvm_compat::JITSymbolInfo
+    findSymbolInLogicalDylib(const std::string &name) override {
+      size_t objectIndex = 0;
+      if (linker.symbolIndex.lookup(name, objectIndex) &&
+          (linker.relocating || objectIndex != shard.loadingObject)) {
+        if (!linker.relocating) {
+          return llvm_compat::JITSymbolInfo(NotYetLoaded,
+                                            JITSymbolFlags::Exported);
+        }
+        return linker.findSymbol(name);
+      }
+      std::lock_guard<std::mutex> lock(linker.externalMutex);
+      return linker.externalResolver.findSymbolInLogicalDylib(name);
+    }
+
+  private:
+    ParallelLinker &linker;
+    Shard &shard;
+  };
+
+  llvm_compat::JITSymbolInfo findSymbol(const std::string &name) {
+    size_t objectIndex = 0;
+    if (symbolIndex.lookup(name, objectIndex)) {
+      auto &shard = shards[objectIndex / objectsPerShard];
+      if (auto address = shard.loader->getSymbol(name).getAddress()) {
+        return llvm_compat::JITSymbolInfo(address, JITSymbolFlags::Exported);
+      }
+    }
+    std::lock_guard<std::mutex> lock(externalMutex);
+    return externalResolver.findSymbol(name);
+  }
+
+  void inParallel(const std::function<void(size_t)> &job) {
+    WorkerGroup workers(ThreadPool::shared());
+    for (size_t index = 1; index < shards.size(); index++) {
+      workers.run([&job, index]() { job(index); });
+    }
+    if (!shards.empty()) {
+      job(0);
+    }
+    workers.wait();
+  }
+
+  const SymbolIndex &symbolIndex;
+  llvm_compat::SymbolResolver &externalResolver;
+  MemoryManagerFactory createMemoryManager;
+  std::mutex externalMutex;
+  std::vector<Shard> shards;
+  size_t objectsPerShard;
+  /// Set once all the shards are loaded
+  bool relocating;
+};
+
+/// Zero stands for an engine without objects
+static std::atomic<uint64_t> nextImage(1);
+
+JITEngine::JITEngine(JITLinking linking,
+                     std::shared_ptr<const SymbolIndex> symbolIndex)
+    : linking(linking), symbolNotFound(nullptr),
+      symbolIndex(std::move(symbolIndex)), library(nullptr),
+      lookupMutex(make_unique<std::mutex>()), symbolTableComplete(false),
+      image(0) {}
+
+JITEngine::JITEngine(JITEngine &&) = default;
+
+JITEngine::~JITEngine() = default;
+
+void JITEngine::startImage(
+    std::unique_ptr<llvm_compat::SymbolResolver> symbolResolver) {
   std::vector<object::ObjectFile *>().swap(objectFiles);
   llvm::StringMap<llvm_compat::JITSymbolInfo>().swap(symbolTable);
-  memoryManager = std::move(memManager);
+  symbolTableComplete = false;
+  image = nextImage++;
+  library = nullptr;
+  lazyLinker.reset();
+  parallelLinker.reset();
+  dynamicLoader.reset();
+  memoryManager.reset();
+  resolver = std::move(symbolResolver);
+}
+
+void JITEngine::addObjectFiles(
+    std::vector<object::ObjectFile *> &files,
+    std::unique_ptr<llvm_compat::SymbolResolver> symbolResolver,
+    MemoryManagerFactory createMemoryManager) {
+  if (linking != JITLinking::Eager) {
+    startImage(std::move(symbolResolver));
+    objectFiles = files;
+    if (!symbolIndex || !symbolIndex->indexes(objectFiles)) {
+      symbolIndex = std::make_shared<const SymbolIndex>(objectFiles);
+    }
+  }
 
-  for (auto object : files) {
-    objectFiles.push_back(object);
+  if (linking == JITLinking::Lazy) {
+    lazyLinker =
+        make_unique<LazyLinker>(*symbolIndex, *resolver, createMemoryManager);
+    return;
+  }
+
+  if (linking == JITLinking::Parallel) {
+    parallelLinker = make_unique<ParallelLinker>(*symbolIndex, *resolver,
+                                                 createMemoryManager);
+    parallelLinker->link();
+    return;
+  }
 
+  beginObjectFiles(std::move(symbolResolver), std::move(createMemoryManager));
+  objectFiles.reserve(files.size());
+  for (auto &object : files) {
+    addObjectFile(*object);
+  }
+  finishObjectFiles();
+}
+
+void JITEngine::beginObjectFiles(
+    std::unique_ptr<llvm_compat::SymbolResolver> symbolResolver,
+    MemoryManagerFactory createMemoryManager) {
+  assert(linking == JITLinking::Eager &&
+         "Lazy and parallel linking need all the objects up front");
+
+  startImage(std::move(symbolResolver));
+  memoryManager = createMemoryManager();
+  dynamicLoader = make_unique<RuntimeDyld>(*memoryManager, *resolver);
+  dynamicLoader->setProcessAllSections(false);
+}
+
+/// Loading only copies the sections, the relocations and the lookups of the
+/// external symbols wait for finishObjectFiles
+void JITEngine::addObjectFile(object::ObjectFile &file) {
+  std::lock_guard<std::mutex> lock(*lookupMutex);
+  objectFiles.push_back(&file);
+  dynamicLoader->loadObject(file);
+}
+
+void JITEngine::finishObjectFiles() {
+  dynamicLoader->finalizeWithMemoryManagerLocking();
+}
+
+void JITEngine::addLibrary(const ProgramLibrary &programLibrary) {
+  startImage(nullptr);
+  library = &programLibrary;
+}
+
+void JITEngine::resolveAllSymbols() {
+  assert(linking != JITLinking::Lazy &&
+         "Lazy linking cannot resolve all the symbols up front");
+
+  if (library) {
+    for (auto &symbol : library->getSymbols()) {
+      findSymbol(symbol.getKey());
+    }
+    symbolTableComplete = true;
+    return;
+  }
+
+  for (auto object : objectFiles) {
     for (auto symbol : object->symbols()) {
       if (symbol.getFlags() & object::SymbolRef::SF_Undefined) {
         continue;
@@ -27,31 +335,53 @@ void JITEngine::addObjectFiles(
         continue;
       }
 
-      auto flags = llvm_compat::JITSymbolFlagsFromObjectSymbol(symbol);
-      symbolTable.insert(
-          std::make_pair(name.get(), llvm_compat::JITSymbol(0, flags)));
+      findSymbol(name.get());
     }
   }
 
-  RuntimeDyld dynamicLoader(*memoryManager, resolver);
-  dynamicLoader.setProcessAllSections(false);
+  symbolTableComplete = true;
+}
 
-  for (auto &object : objectFiles) {
-    dynamicLoader.loadObject(*object);
-  }
+llvm_compat::JITSymbol &JITEngine::getSymbol(llvm::StringRef name) {
+  if (symbolTableComplete) {
+    auto symbolIterator = symbolTable.find(name);
+    if (symbolIterator == symbolTable.end()) {
+      return symbolNotFound;
+    }
 
-  for (auto &entry : symbolTable) {
-    entry.second = dynamicLoader.getSymbol(entry.first());
+    return symbolIterator->second;
   }
 
-  dynamicLoader.finalizeWithMemoryManagerLocking();
+  std::lock_guard<std::mutex> lock(*lookupMutex);
+  return findSymbol(name);
 }
 
-llvm_compat::JITSymbol &JITEngine::getSymbol(llvm::StringRef name) {
+llvm_compat::JITSymbol &JITEngine::findSymbol(llvm::StringRef name) {
   auto symbolIterator = symbolTable.find(name);
-  if (symbolIterator == symbolTable.end()) {
+  if (symbolIterator != symbolTable.end()) {
+    return symbolIterator->second;
+  }
+
+  uint64_t address = 0;
+  JITSymbolFlags flags = JITSymbolFlags::Exported;
+  if (library) {
+    address = library->getAddress(name);
+  } else if (lazyLinker) {
+    address = lazyLinker->materialize(name);
+  } else if (auto loader = parallelLinker ? parallelLinker->findLoader(name)
+                                           : dynamicLoader.get()) {
+    auto symbol = loader->getSymbol(name);
+    address = symbol.getAddress();
+    flags = symbol.getFlags();
+  }
+
+  if (address == 0) {
     return symbolNotFound;
   }
 
-  return symbolIterator->second;
+  auto inserted = symbolTable.insert(
+      std::make_pair(name, llvm_compat::JITSymbol(address, flags)));
+  return inserted.first->second;
 }
+
+uint64_t JITEngine::getImage() const { return image; }
@@ -1,15 +1,37 @@
 #include "mull/Toolchain/ObjectCache.h"
 
+#include "mull/CacheFile.h"
 #include "LLVMCompatibility.h"
 #include "mull/Logger.h"
+#include "mull/Metrics/LiveMetrics.h"
 #include "mull/MullModule.h"
 #include "mull/MutationPoint.h"
 
+#include <llvm/ADT/SmallString.h>
+#include <llvm/ADT/StringExtras.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MD5.h>
+#include <llvm/Support/Path.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+#include <unistd.h>
+
 using namespace mull;
 using namespace llvm::object;
 
-ObjectCache::ObjectCache(bool useCache, const std::string &cacheDir)
-    : useOnDiskCache(useCache), cacheDirectory(cacheDir) {
+ObjectCache::ObjectCache(bool useCache, const std::string &cacheDir,
+                         bool compression, uint64_t sizeLimit, bool populate,
+                         std::unique_ptr<ObjectCacheBackend> remote)
+    : useOnDiskCache(useCache), cacheDirectory(cacheDir),
+      compression(compression), sizeLimit(sizeLimit), populate(populate),
+      remote(std::move(remote)), pendingFiles(0), pendingBytes(0),
+      stopping(false), hits(0), misses(0), remoteHits(0), bytesRead(0),
+      bytesWritten(0), bytesSaved(0), bytesEvicted(0), prefetches(0) {
   if (useOnDiskCache) {
     auto error = llvm::sys::fs::create_directories(cacheDir);
     if (error) {
@@ -21,65 +43,508 @@ ObjectCache::ObjectCache(bool useCache, const std::string &cacheDir)
       useOnDiskCache = false;
     }
   }
+
+  evict();
+  if (useOnDiskCache) {
+    writer = std::thread(&ObjectCache::writeFiles, this);
+  }
 }
 
-OwningBinary<ObjectFile>
-ObjectCache::getObjectFromDisk(const std::string &identifier) {
-  if (!useOnDiskCache) {
-    return OwningBinary<ObjectFile>();
+ObjectCache::~ObjectCache() {
+  {
+    std::lock_guard<std::mutex> lock(writesMutex);
+    stopping = true;
+  }
+  writesCondition.notify_all();
+  if (writer.joinable()) {
+    writer.join();
+  }
+}
+
+std::string ObjectCache::objectKey(const std::string &identifier) const {
+  llvm::MD5 hasher;
+  hasher.update(identifier);
+  llvm::MD5::MD5Result hash;
+  hasher.final(hash);
+  llvm::SmallString<32> digest;
+  llvm::MD5::stringifyResult(hash, digest);
+  return std::string(digest.str());
+}
+
+std::string ObjectCache::objectPath(const std::string &identifier,
+                                    bool compressed) const {
+  std::string name = objectKey(identifier);
+  return cacheDirectory + "/" + name.substr(0, 2) + "/" + name.substr(2) +
+         (compressed ? ".oz" : ".o");
+}
+
+/// Compressed objects start with the size of the uncompressed object
+static std::unique_ptr<llvm::MemoryBuffer>
+uncompressObject(std::unique_ptr<llvm::MemoryBuffer> buffer) {
+  uint64_t size = 0;
+  if (buffer->getBufferSize() < sizeof(size)) {
+    return nullptr;
+  }
+  memcpy(&size, buffer->getBufferStart(), sizeof(size));
+
+  llvm::SmallVector<char, 0> object;
+  if (!llvm_compat::uncompress(buffer->getBuffer().drop_front(sizeof(size)),
+                               object, size_t(size))) {
+    return nullptr;
   }
 
-  std::string cacheName(cacheDirectory + "/" + identifier + ".o");
+  return llvm::MemoryBuffer::getMemBufferCopy(
+      llvm::StringRef(object.data(), object.size()),
+      buffer->getBufferIdentifier());
+}
 
-  auto buffer = llvm::MemoryBuffer::getFile(cacheName.c_str());
+/// Reads the pages of a mapped object ahead, like MAP_POPULATE would
+static void populatePages(const llvm::MemoryBuffer &buffer) {
+  const uintptr_t pageSize = sysconf(_SC_PAGESIZE);
+  auto start = reinterpret_cast<uintptr_t>(buffer.getBufferStart());
+  auto end = reinterpret_cast<uintptr_t>(buffer.getBufferEnd());
+  auto alignedStart = start & ~(pageSize - 1);
+  posix_madvise(reinterpret_cast<void *>(alignedStart), end - alignedStart,
+                POSIX_MADV_WILLNEED);
+}
 
+const llvm::MemoryBuffer *
+ObjectCache::mapObject(const std::string &identifier) {
+  {
+    std::lock_guard<std::mutex> lock(mappingsMutex);
+    auto mapping = mappings.find(identifier);
+    if (mapping != mappings.end()) {
+      return mapping->second.get();
+    }
+  }
+
+  waitForWrite(identifier);
+
+  /// Without the null terminator the file is mapped rather than copied
+  /// into the heap, unless it is too small to be worth a mapping
+  std::string cacheName = objectPath(identifier, false);
+  auto buffer = llvm::MemoryBuffer::getFile(cacheName, -1, false);
   if (!buffer) {
+    cacheName = objectPath(identifier, true);
+    buffer = llvm::MemoryBuffer::getFile(cacheName, -1, false);
+    if (buffer) {
+      buffer = uncompressObject(std::move(buffer.get()));
+    }
+  }
+
+  std::unique_ptr<llvm::MemoryBuffer> object;
+  if (buffer && buffer.get()) {
+    object = std::move(buffer.get());
+    if (populate) {
+      populatePages(*object);
+    }
+
+    /// The modification time tells the eviction which objects are still used
+    utimes(cacheName.c_str(), nullptr);
+  } else {
+    object = fetchRemoteObject(identifier);
+  }
+
+  if (!object) {
+    return nullptr;
+  }
+
+  /// Another worker may have mapped the same object meanwhile
+  std::lock_guard<std::mutex> lock(mappingsMutex);
+  auto inserted =
+      mappings.insert(std::make_pair(identifier, std::move(object)));
+  return inserted.first->second.get();
+}
+
+std::string ObjectCache::predictionPath(const MullModule &module) const {
+  return cacheDirectory + "/predictions/" +
+         objectKey(module.getUniqueIdentifier());
+}
+
+void ObjectCache::prefetchObjects(const MullModule &module,
+                                  unsigned partitions, bool predicted) {
+  if (!useOnDiskCache) {
+    return;
+  }
+
+  std::string identifier;
+  if (predicted) {
+    auto buffer = llvm::MemoryBuffer::getFile(predictionPath(module));
+    if (!buffer) {
+      return;
+    }
+    identifier = buffer.get()->getBuffer().str();
+    std::lock_guard<std::mutex> lock(prefetchMutex);
+    predictions[module.getUniqueIdentifier()] = identifier;
+  } else {
+    identifier = module.getMutatedUniqueIdentifier();
+  }
+
+  if (partitions <= 1) {
+    prefetchObject(identifier);
+    return;
+  }
+  for (unsigned index = 0; index < partitions; index++) {
+    prefetchObject(identifier + partSuffix(index, partitions));
+  }
+}
+
+/// The object is not mapped yet, only its pages get into the page cache
+void ObjectCache::prefetchObject(const std::string &identifier) {
+  {
+    std::lock_guard<std::mutex> lock(prefetchMutex);
+    if (!prefetched.insert(identifier).second) {
+      return;
+    }
+  }
+
+  for (bool compressed : {false, true}) {
+    auto path = objectPath(identifier, compressed);
+    int descriptor = open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+      continue;
+    }
+#if defined(__APPLE__)
+    struct stat status;
+    if (fstat(descriptor, &status) == 0) {
+      struct radvisory advice;
+      advice.ra_offset = 0;
+      advice.ra_count = int(std::min<off_t>(status.st_size, INT32_MAX));
+      fcntl(descriptor, F_RDADVISE, &advice);
+    }
+#else
+    posix_fadvise(descriptor, 0, 0, POSIX_FADV_WILLNEED);
+#endif
+    close(descriptor);
+    prefetches++;
+    return;
+  }
+}
+
+/// Written only when it changes, which is when the mutations do
+void ObjectCache::rememberObject(const MullModule &module) {
+  if (!useOnDiskCache) {
+    return;
+  }
+
+  auto identifier = module.getMutatedUniqueIdentifier();
+  {
+    std::lock_guard<std::mutex> lock(prefetchMutex);
+    auto prediction = predictions.find(module.getUniqueIdentifier());
+    if (prediction != predictions.end() && prediction->second == identifier) {
+      return;
+    }
+  }
+
+  PendingWrite write;
+  write.path = predictionPath(module);
+  write.contents = identifier;
+  write.size = 0;
+  write.saved = 0;
+  queueWrite(std::move(write));
+}
+
+/// Objects fetched from the remote cache are kept in memory and also stored
+/// locally, so that the next run does not need to fetch them again.
+/// Only valid objects are kept, a broken one would stay in the local cache.
+std::unique_ptr<llvm::MemoryBuffer>
+ObjectCache::fetchRemoteObject(const std::string &identifier) {
+  if (!remote) {
+    return nullptr;
+  }
+
+  std::string contents;
+  if (!remote->fetch(objectKey(identifier), contents)) {
+    return nullptr;
+  }
+
+  auto object = ObjectFile::createObjectFile(
+      llvm::MemoryBufferRef(contents, identifier));
+  if (!object) {
+    llvm::consumeError(object.takeError());
+    Logger::warn() << "Remote cache sent an invalid object for '"
+                   << identifier << "'\n";
+    return nullptr;
+  }
+
+  remoteHits++;
+  if (useOnDiskCache) {
+    writeObject(identifier, contents);
+  }
+  return llvm::MemoryBuffer::getMemBufferCopy(contents, identifier);
+}
+
+OwningBinary<ObjectFile>
+ObjectCache::getObjectFromDisk(const std::string &identifier) {
+  if (!useOnDiskCache && !remote) {
+    return OwningBinary<ObjectFile>();
+  }
+
+  auto mapping = mapObject(identifier);
+  if (!mapping) {
+    misses++;
+    LiveMetrics::shared().addCacheLookup(false);
     return OwningBinary<ObjectFile>();
   }
 
+  auto buffer =
+      llvm::MemoryBuffer::getMemBuffer(mapping->getMemBufferRef(), false);
+
   llvm_compat::Expected<std::unique_ptr<ObjectFile>> objectOrError =
-      ObjectFile::createObjectFile(buffer.get()->getMemBufferRef());
+      ObjectFile::createObjectFile(buffer->getMemBufferRef());
 
   if (!objectOrError) {
+    misses++;
+    LiveMetrics::shared().addCacheLookup(false);
     return OwningBinary<ObjectFile>();
   }
 
+  hits++;
+  LiveMetrics::shared().addCacheLookup(true);
+  bytesRead += buffer->getBufferSize();
+
   std::unique_ptr<ObjectFile> objectFile(std::move(objectOrError.get()));
 
   auto owningObject =
-      OwningBinary<ObjectFile>(std::move(objectFile), std::move(buffer.get()));
+      OwningBinary<ObjectFile>(std::move(objectFile), std::move(buffer));
   return owningObject;
 }
 
 OwningBinary<ObjectFile>
-ObjectCache::getInstrumentedObject(const MullModule &module) {
-  return getObjectFromDisk(module.getInstrumentedUniqueIdentifier());
+ObjectCache::getInstrumentedObject(const MullModule &module,
+                                   const std::string &suffix) {
+  return getObjectFromDisk(module.getInstrumentedUniqueIdentifier() + suffix);
 }
 
-OwningBinary<ObjectFile> ObjectCache::getObject(const MullModule &module) {
-  return getObjectFromDisk(module.getMutatedUniqueIdentifier());
+OwningBinary<ObjectFile> ObjectCache::getObject(const MullModule &module,
+                                                const std::string &suffix) {
+  return getObjectFromDisk(module.getMutatedUniqueIdentifier() + suffix);
+}
+
+OwningBinary<ObjectFile>
+ObjectCache::getSatelliteObject(const MullModule &module, size_t index) {
+  return getObjectFromDisk(module.getSatelliteUniqueIdentifier(index));
 }
 
 void ObjectCache::putObjectOnDisk(OwningBinary<ObjectFile> &object,
                                   const std::string &identifier) {
-  if (!useOnDiskCache) {
-    return;
+  llvm::StringRef contents =
+      object.getBinary()->getMemoryBufferRef().getBuffer();
+
+  if (useOnDiskCache) {
+    writeObject(identifier, contents);
+  }
+
+  /// The remote cache always gets uncompressed objects, so that runs with
+  /// and without compression share them
+  if (remote) {
+    remote->store(objectKey(identifier), contents);
+  }
+}
+
+void ObjectCache::writeObject(const std::string &identifier,
+                              llvm::StringRef contents) {
+  uint64_t size = contents.size();
+
+  /// Objects that do not get smaller are stored as they are. They are
+  /// compressed here, on the worker, the writer only does the I/O.
+  llvm::SmallVector<char, 0> compressed;
+  const bool isCompressed =
+      compression && llvm_compat::compress(contents, compressed) &&
+      sizeof(size) + compressed.size() < size;
+
+  PendingWrite write;
+  write.identifier = identifier;
+  write.path = objectPath(identifier, isCompressed);
+  write.size = size;
+  write.saved = 0;
+  if (isCompressed) {
+    write.contents.reserve(sizeof(size) + compressed.size());
+    write.contents.append(reinterpret_cast<const char *>(&size), sizeof(size));
+    write.contents.append(compressed.data(), compressed.size());
+    write.saved = size - sizeof(size) - compressed.size();
+  } else {
+    write.contents = contents.str();
   }
+  queueWrite(std::move(write));
+}
+
+/// How much the workers may get ahead of the storage
+static const uint64_t MaxPendingBytes = 64 * 1024 * 1024;
 
-  std::string cacheName(cacheDirectory + "/" + identifier + ".o");
-  std::error_code EC;
-  llvm::raw_fd_ostream outfile(cacheName, EC, llvm::sys::fs::F_None);
-  outfile.write(object.getBinary()->getMemoryBufferRef().getBufferStart(),
-                object.getBinary()->getMemoryBufferRef().getBufferSize());
-  outfile.close();
+void ObjectCache::queueWrite(PendingWrite write) {
+  {
+    std::unique_lock<std::mutex> lock(writesMutex);
+    writesCondition.wait(lock, [&]() {
+      return pendingBytes == 0 ||
+             pendingBytes + write.contents.size() <= MaxPendingBytes;
+    });
+    pendingFiles++;
+    pendingBytes += write.contents.size();
+    if (!write.identifier.empty()) {
+      writing.insert(write.identifier);
+    }
+    writes.push_back(std::move(write));
+  }
+  writesCondition.notify_all();
+}
+
+/// Takes whatever is queued at once, so that the lock is not taken for
+/// every file while the storage is slow
+void ObjectCache::writeFiles() {
+  std::unique_lock<std::mutex> lock(writesMutex);
+  while (true) {
+    writesCondition.wait(lock,
+                         [this]() { return stopping || !writes.empty(); });
+    if (writes.empty()) {
+      return;
+    }
+
+    std::deque<PendingWrite> batch;
+    batch.swap(writes);
+    lock.unlock();
+    for (auto &write : batch) {
+      if (writeFile(write) && !write.identifier.empty()) {
+        bytesWritten += write.size;
+        bytesSaved += write.saved;
+      }
+      lock.lock();
+      pendingFiles--;
+      pendingBytes -= write.contents.size();
+      if (!write.identifier.empty()) {
+        writing.erase(write.identifier);
+      }
+      lock.unlock();
+      writesCondition.notify_all();
+    }
+    lock.lock();
+  }
+}
+
+/// Readers see either no object or the complete one
+bool ObjectCache::writeFile(const PendingWrite &write) {
+  auto error = writeCacheFile(write.path, [&](llvm::raw_ostream &outfile) {
+    outfile.write(write.contents.data(), write.contents.size());
+  });
+  if (error) {
+    Logger::error() << "Cannot write cache file '" << write.path
+                    << "': " << error.message() << "\n";
+    return false;
+  }
+  return true;
+}
+
+void ObjectCache::flush() {
+  std::unique_lock<std::mutex> lock(writesMutex);
+  writesCondition.wait(lock, [this]() { return pendingFiles == 0; });
+}
+
+void ObjectCache::waitForWrite(const std::string &identifier) {
+  std::unique_lock<std::mutex> lock(writesMutex);
+  writesCondition.wait(lock,
+                       [&]() { return writing.count(identifier) == 0; });
 }
 
 void ObjectCache::putInstrumentedObject(OwningBinary<ObjectFile> &object,
-                                        const MullModule &module) {
-  putObjectOnDisk(object, module.getInstrumentedUniqueIdentifier());
+                                        const MullModule &module,
+                                        const std::string &suffix) {
+  putObjectOnDisk(object, module.getInstrumentedUniqueIdentifier() + suffix);
 }
 
 void ObjectCache::putObject(OwningBinary<ObjectFile> &object,
-                            const MullModule &module) {
-  putObjectOnDisk(object, module.getMutatedUniqueIdentifier());
+                            const MullModule &module,
+                            const std::string &suffix) {
+  putObjectOnDisk(object, module.getMutatedUniqueIdentifier() + suffix);
+}
+
+void ObjectCache::putSatelliteObject(OwningBinary<ObjectFile> &object,
+                                     const MullModule &module, size_t index) {
+  putObjectOnDisk(object, module.getSatelliteUniqueIdentifier(index));
+}
+
+/// The objects live in the shards named after the first two hex digits of
+/// their key, see objectPath. The rest of the cache directory belongs to the
+/// other caches, which keep to their own sizes.
+static bool isObjectShard(llvm::StringRef name) {
+  return name.size() == 2 && llvm::isHexDigit(name[0]) &&
+         llvm::isHexDigit(name[1]);
+}
+
+/// The temporary files of the objects being written, by this or a concurrent
+/// mull, end in ".tmp-%%%%%%%%" and are never evicted
+static bool isCachedObject(llvm::StringRef name) {
+  return name.endswith(".o") || name.endswith(".oz");
+}
+
+void ObjectCache::evict() {
+  if (!useOnDiskCache || sizeLimit == 0) {
+    return;
+  }
+
+  struct Entry {
+    std::string path;
+    time_t lastUsed;
+    uint64_t size;
+  };
+
+  std::vector<Entry> entries;
+  uint64_t totalSize = 0;
+  std::error_code error;
+  llvm::sys::fs::directory_iterator shard(cacheDirectory, error), end;
+  for (; shard != end && !error; shard.increment(error)) {
+    if (!isObjectShard(llvm::sys::path::filename(shard->path()))) {
+      continue;
+    }
+    std::error_code shardError;
+    llvm::sys::fs::directory_iterator it(shard->path(), shardError);
+    for (; it != end && !shardError; it.increment(shardError)) {
+      if (!isCachedObject(llvm::sys::path::filename(it->path()))) {
+        continue;
+      }
+      struct stat status;
+      if (stat(it->path().c_str(), &status) != 0 ||
+          !S_ISREG(status.st_mode)) {
+        continue;
+      }
+      entries.push_back(
+          {it->path(), status.st_mtime, uint64_t(status.st_size)});
+      totalSize += status.st_size;
+    }
+  }
+
+  if (totalSize <= sizeLimit) {
+    return;
+  }
+
+  std::sort(entries.begin(), entries.end(),
+            [](const Entry &lhs, const Entry &rhs) {
+              return lhs.lastUsed < rhs.lastUsed;
+            });
+
+  for (auto &entry : entries) {
+    if (totalSize <= sizeLimit) {
+      break;
+    }
+    if (!llvm::sys::fs::remove(entry.path)) {
+      totalSize -= entry.size;
+      bytesEvicted += entry.size;
+    }
+  }
+}
+
+std::string ObjectCache::partSuffix(size_t index, size_t parts) {
+  return "_part" + std::to_string(index) + "of" + std::to_string(parts);
+}
+
+ObjectCacheMetrics ObjectCache::getMetrics() const {
+  ObjectCacheMetrics metrics;
+  metrics.hits = hits;
+  metrics.misses = misses;
+  metrics.remoteHits = remoteHits;
+  metrics.bytesRead = bytesRead;
+  metrics.bytesWritten = bytesWritten;
+  metrics.bytesSaved = bytesSaved;
+  metrics.bytesEvicted = bytesEvicted;
+  metrics.prefetches = prefetches;
+  return metrics;
 }
@@ -0,0 +1,232 @@
+#include "mull/Toolchain/ObjectCacheBackend.h"
+
+#include "mull/Logger.h"
+#include "mull/Socket.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+using namespace mull;
+
+#pragma mark - HTTP
+
+/// A stalled server should not stall mull
+static const int SocketTimeoutSeconds = 10;
+
+static int connectTo(const std::string &host, const std::string &port) {
+  struct addrinfo hints = {};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+
+  struct addrinfo *addresses = nullptr;
+  if (getaddrinfo(host.c_str(), port.c_str(), &hints, &addresses) != 0) {
+    return -1;
+  }
+
+  int connection = -1;
+  for (auto address = addresses; address; address = address->ai_next) {
+    connection =
+        socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+    if (connection == -1) {
+      continue;
+    }
+
+    struct timeval timeout = {SocketTimeoutSeconds, 0};
+    setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(connection, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+#ifdef SO_NOSIGPIPE
+    int enabled = 1;
+    setsockopt(connection, SOL_SOCKET, SO_NOSIGPIPE, &enabled,
+               sizeof(enabled));
+#endif
+
+    if (connect(connection, address->ai_addr, address->ai_addrlen) == 0) {
+      break;
+    }
+    close(connection);
+    connection = -1;
+  }
+
+  freeaddrinfo(addresses);
+  return connection;
+}
+
+HTTPObjectCacheBackend::HTTPObjectCacheBackend(const std::string &url)
+    : valid(false), port("80") {
+  const std::string scheme("http://");
+  if (url.compare(0, scheme.size(), scheme) != 0) {
+    Logger::error() << "Remote cache '" << url
+                    << "' is not supported, expected an http:// URL\n";
+    return;
+  }
+
+  auto location = url.substr(scheme.size());
+  auto slash = location.find('/');
+  host = location.substr(0, slash);
+  if (slash != std::string::npos) {
+    path = location.substr(slash);
+  }
+  while (!path.empty() && path.back() == '/') {
+    path.pop_back();
+  }
+
+  auto colon = host.rfind(':');
+  if (colon != std::string::npos) {
+    port = host.substr(colon + 1);
+    host = host.substr(0, colon);
+  }
+
+  valid = !host.empty();
+}
+
+bool HTTPObjectCacheBackend::request(const std::string &method,
+                                     const std::string &key,
+                                     llvm::StringRef body,
+                                     bool requireLength, int &status,
+                                     std::string &response) {
+  if (!valid) {
+    return false;
+  }
+
+  int connection = connectTo(host, port);
+  if (connection == -1) {
+    return false;
+  }
+
+  std::string header = method + " " + path + "/" + key + " HTTP/1.0\r\n" +
+                       "Host: " + host + "\r\n" +
+                       "Content-Length: " + std::to_string(body.size()) +
+                       "\r\n\r\n";
+
+  /// HTTP/1.0 servers close the connection after the response,
+  /// so the response is everything read until the end of the stream
+  std::string received;
+  bool succeeded = sendAll(connection, header) && sendAll(connection, body);
+  while (succeeded) {
+    char buffer[64 * 1024];
+    ssize_t bytes = recv(connection, buffer, sizeof(buffer), 0);
+    if (bytes == -1 && errno == EINTR) {
+      continue;
+    }
+    if (bytes <= 0) {
+      succeeded = bytes == 0;
+      break;
+    }
+    received.append(buffer, bytes);
+  }
+  close(connection);
+
+  auto headerEnd = received.find("\r\n\r\n");
+  auto statusStart = received.find(' ');
+  if (!succeeded || headerEnd == std::string::npos ||
+      statusStart == std::string::npos || statusStart > headerEnd) {
+    return false;
+  }
+
+  status = atoi(received.c_str() + statusStart + 1);
+  response = received.substr(headerEnd + 4);
+
+  /// The server closing the connection early looks like the end of the
+  /// response, only the announced length tells the two apart
+  auto headers = llvm::StringRef(received).take_front(headerEnd).lower();
+  auto lengthStart = headers.find("\r\ncontent-length:");
+  if (lengthStart == std::string::npos) {
+    return !requireLength;
+  }
+  auto length = strtoull(headers.c_str() + lengthStart + 17, nullptr, 10);
+  if (length != response.size()) {
+    Logger::warn() << "Remote cache sent " << response.size() << " of "
+                   << length << " bytes of '" << key << "'\n";
+    return false;
+  }
+  return true;
+}
+
+bool HTTPObjectCacheBackend::fetch(const std::string &key,
+                                   std::string &contents) {
+  int status = 0;
+  std::string response;
+  if (!request("GET", key, llvm::StringRef(), true, status, response) ||
+      status != 200) {
+    return false;
+  }
+  contents = std::move(response);
+  return true;
+}
+
+bool HTTPObjectCacheBackend::store(const std::string &key,
+                                   llvm::StringRef contents) {
+  int status = 0;
+  std::string response;
+  if (!request("PUT", key, contents, false, status, response)) {
+    return false;
+  }
+  return status >= 200 && status < 300;
+}
+
+#pragma mark - Async
+
+AsyncObjectCacheBackend::AsyncObjectCacheBackend(
+    std::unique_ptr<ObjectCacheBackend> backend, size_t maxPendingBytes)
+    : backend(std::move(backend)), maxPendingBytes(maxPendingBytes),
+      pendingBytes(0), stopping(false),
+      uploader(&AsyncObjectCacheBackend::upload, this) {}
+
+AsyncObjectCacheBackend::~AsyncObjectCacheBackend() {
+  {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    stopping = true;
+  }
+  queueCondition.notify_one();
+  uploader.join();
+}
+
+bool AsyncObjectCacheBackend::fetch(const std::string &key,
+                                    std::string &contents) {
+  return backend->fetch(key, contents);
+}
+
+bool AsyncObjectCacheBackend::store(const std::string &key,
+                                    llvm::StringRef contents) {
+  {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    /// An object larger than the limit still goes when nothing is pending
+    if (pendingBytes != 0 &&
+        pendingBytes + contents.size() > maxPendingBytes) {
+      Logger::debug() << "Too many pending uploads, object '" << key
+                      << "' is not uploaded to the remote cache\n";
+      return false;
+    }
+    pendingBytes += contents.size();
+    queue.emplace_back(key, contents.str());
+  }
+  queueCondition.notify_one();
+  return true;
+}
+
+void AsyncObjectCacheBackend::upload() {
+  std::unique_lock<std::mutex> lock(queueMutex);
+  while (true) {
+    queueCondition.wait(lock, [this]() { return stopping || !queue.empty(); });
+    if (queue.empty()) {
+      return;
+    }
+
+    auto object = std::move(queue.front());
+    queue.pop_front();
+
+    lock.unlock();
+    if (!backend->store(object.first, object.second)) {
+      Logger::warn() << "Cannot upload object '" << object.first
+                     << "' to the remote cache\n";
+    }
+    lock.lock();
+    /// Only counted once uploaded, the object is in memory until then
+    pendingBytes -= object.second.size();
+  }
+}
@@ -0,0 +1,387 @@
+#include "mull/Toolchain/ProgramLibrary.h"
+
+#include "mull/Hash.h"
+#include "mull/Instrumentation/Instrumentation.h"
+#include "mull/Logger.h"
+#include "mull/Toolchain/Compiler.h"
+
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/DerivedTypes.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/GlobalVariable.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Object/ELFObjectFile.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Target/TargetMachine.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <set>
+#include <unistd.h>
+#include <utility>
+
+#ifdef __linux__
+#include <dlfcn.h>
+#include <spawn.h>
+#include <sys/wait.h>
+
+extern char **environ;
+#endif
+
+using namespace mull;
+using namespace llvm;
+
+/// The slot the __cxa_atexit of the library calls through, see bindSlots
+static const char *const AtExitSlot = "mull_cxa_atexit";
+
+ProgramLibrary::ProgramLibrary(const std::string &cacheDirectory)
+    : directory(cacheDirectory + "/programs"), handle(nullptr) {}
+
+bool ProgramLibrary::isSupported() {
+#ifdef __linux__
+  return true;
+#else
+  return false;
+#endif
+}
+
+/// RuntimeDyld does not process .init_array either, the objects linked by
+/// the JIT are the same without the constructors
+void ProgramLibrary::dropStaticConstructors(Module &module) {
+  for (auto name : {"llvm.global_ctors", "llvm.global_dtors"}) {
+    if (auto variable = module.getNamedGlobal(name)) {
+      variable->eraseFromParent();
+    }
+  }
+}
+
+/// The names the objects leave undefined, each of them once
+static std::set<std::string>
+undefinedSymbols(const std::vector<object::ObjectFile *> &objectFiles) {
+  std::set<std::string> names;
+  for (auto objectFile : objectFiles) {
+    for (auto symbol : objectFile->symbols()) {
+      if (!(symbol.getFlags() & object::SymbolRef::SF_Undefined)) {
+        continue;
+      }
+      Expected<StringRef> name = symbol.getName();
+      if (!name) {
+        consumeError(name.takeError());
+        continue;
+      }
+      names.insert(name.get().str());
+    }
+  }
+  return names;
+}
+
+/// A hidden __cxa_atexit, which the objects bind to instead of the one of
+/// libc, calls the override of the test runner through the slot
+static void defineAtExit(Module &module) {
+  auto &context = module.getContext();
+  auto pointerType = Type::getInt8Ty(context)->getPointerTo();
+  auto destructorType =
+      FunctionType::get(Type::getVoidTy(context), {pointerType}, false);
+  auto atExitType = FunctionType::get(
+      Type::getInt32Ty(context),
+      {destructorType->getPointerTo(), pointerType, pointerType}, false);
+  auto slotType = atExitType->getPointerTo();
+  auto slot = new GlobalVariable(module, slotType, false,
+                                 GlobalValue::ExternalLinkage,
+                                 ConstantPointerNull::get(slotType),
+                                 AtExitSlot);
+
+  auto atExit = Function::Create(atExitType, GlobalValue::ExternalLinkage,
+                                 "__cxa_atexit", &module);
+  atExit->setVisibility(GlobalValue::HiddenVisibility);
+  IRBuilder<> builder(BasicBlock::Create(context, "entry", atExit));
+  std::vector<Value *> arguments;
+  for (auto &argument : atExit->args()) {
+    arguments.push_back(&argument);
+  }
+  auto target = builder.CreateLoad(slot);
+  builder.CreateRet(builder.CreateCall(target, arguments));
+}
+
+/// Defines what the JIT would resolve to the memory of mull
+static std::unique_ptr<Module> slotsModule(LLVMContext &context,
+                                           const std::set<std::string> &names) {
+  auto module = make_unique<Module>("mull_program_library_slots", context);
+  auto pointerType = Type::getInt8Ty(context)->getPointerTo();
+  auto offsetType = Type::getInt32Ty(context);
+  StringRef functionPrefix = Instrumentation::functionIndexOffsetPrefix();
+  StringRef blockPrefix = Instrumentation::blockIndexOffsetPrefix();
+
+  for (auto &name : names) {
+    StringRef symbol(name);
+    if (symbol == Instrumentation::instrumentationInfoVariableName()) {
+      new GlobalVariable(*module, pointerType, false,
+                         GlobalValue::ExternalLinkage,
+                         ConstantPointerNull::get(pointerType), name);
+    } else if (symbol.startswith(functionPrefix) ||
+               symbol.startswith(blockPrefix)) {
+      new GlobalVariable(*module, offsetType, false,
+                         GlobalValue::ExternalLinkage,
+                         ConstantInt::get(offsetType, 0), name);
+    } else if (symbol == "__cxa_atexit") {
+      defineAtExit(*module);
+    }
+  }
+  return module;
+}
+
+/// The compiler driver of the system links, run without a shell
+static bool runLinker(const std::vector<std::string> &inputs,
+                      const std::string &output) {
+#ifdef __linux__
+  std::vector<std::string> arguments = {"cc", "-shared", "-o", output};
+  arguments.insert(arguments.end(), inputs.begin(), inputs.end());
+  std::vector<char *> argv;
+  for (auto &argument : arguments) {
+    argv.push_back(const_cast<char *>(argument.c_str()));
+  }
+  argv.push_back(nullptr);
+
+  pid_t pid = 0;
+  int error = posix_spawnp(&pid, argv[0], nullptr, nullptr, argv.data(),
+                           environ);
+  if (error) {
+    Logger::warn() << "Cannot run the linker 'cc': " << strerror(error)
+                   << "\n";
+    return false;
+  }
+  int status = 0;
+  while (waitpid(pid, &status, 0) == -1 && errno == EINTR) {
+  }
+  if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+    Logger::warn() << "The linker failed to link '" << output << "'\n";
+    return false;
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+/// Writes the contents to a new file of the directory, the path is added
+/// to the inputs of the linker
+static bool writeInput(const std::string &directory, StringRef contents,
+                       std::vector<std::string> &inputs) {
+  int descriptor = -1;
+  SmallString<128> name;
+  auto error =
+      sys::fs::createUniqueFile(directory + "/input-%%%%%%%%.o", descriptor,
+                                name);
+  if (error) {
+    Logger::warn() << "Cannot write the objects of the program library: "
+                   << error.message() << "\n";
+    return false;
+  }
+  inputs.push_back(std::string(name.str()));
+
+  raw_fd_ostream stream(descriptor, true);
+  stream.write(contents.data(), contents.size());
+  stream.close();
+  const bool failed = stream.has_error();
+  stream.clear_error();
+  return !failed;
+}
+
+bool ProgramLibrary::load(
+    const std::vector<object::ObjectFile *> &objectFiles,
+    TargetMachine &machine) {
+  if (!isSupported()) {
+    Logger::warn() << "The program library is only supported on Linux\n";
+    return false;
+  }
+
+  /// The objects come in the order they were compiled in, which changes
+  /// from one run to the next
+  std::vector<std::pair<std::string, object::ObjectFile *>> hashed;
+  for (auto objectFile : objectFiles) {
+    hashed.emplace_back(
+        hashOf(objectFile->getData(), HashAlgorithm::XXHash64), objectFile);
+  }
+  std::sort(hashed.begin(), hashed.end());
+  Hasher hasher(HashAlgorithm::MD5);
+  std::vector<object::ObjectFile *> ordered;
+  for (auto &object : hashed) {
+    hasher.update(object.first);
+    ordered.push_back(object.second);
+  }
+  path = directory + "/" + hasher.final() + ".so";
+
+  if (!sys::fs::exists(path) && !link(ordered, machine)) {
+    return false;
+  }
+
+#ifdef __linux__
+  handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+  if (!handle) {
+    Logger::warn() << "Cannot load the program library: " << dlerror()
+                   << "\n";
+    return false;
+  }
+#endif
+  return readSymbols();
+}
+
+/// The objects and the slots are written next to the library, the linker
+/// writes a temporary library that is renamed into place once complete,
+/// so several mull processes can share the cache
+bool ProgramLibrary::link(
+    const std::vector<object::ObjectFile *> &objectFiles,
+    TargetMachine &machine) {
+  auto error = sys::fs::create_directories(directory);
+  if (error) {
+    Logger::warn() << "Cannot create the directory of the program library '"
+                   << directory << "': " << error.message() << "\n";
+    return false;
+  }
+
+  LLVMContext context;
+  auto slots = slotsModule(context, undefinedSymbols(objectFiles));
+  auto slotsObject = Compiler().compileModule(slots.get(), machine);
+  if (!slotsObject.getBinary()) {
+    Logger::warn() << "Cannot compile the slots of the program library\n";
+    return false;
+  }
+
+  std::vector<std::string> inputs;
+  bool written = true;
+  for (auto objectFile : objectFiles) {
+    written = written && writeInput(directory, objectFile->getData(), inputs);
+  }
+  written = written &&
+            writeInput(directory, slotsObject.getBinary()->getData(), inputs);
+
+  int descriptor = -1;
+  SmallString<128> temporaryName;
+  error = sys::fs::createUniqueFile(path + ".tmp-%%%%%%%%", descriptor,
+                                    temporaryName);
+  bool linked = false;
+  if (!error) {
+    close(descriptor);
+    linked = written && runLinker(inputs, std::string(temporaryName.str()));
+  }
+  for (auto &input : inputs) {
+    sys::fs::remove(input);
+  }
+
+  /// Readers see either no library or the complete one
+  if (!linked || sys::fs::rename(temporaryName, path)) {
+    if (!error) {
+      sys::fs::remove(temporaryName);
+    }
+    return false;
+  }
+  Logger::info() << "Linked the program library '" << path << "'\n";
+  return true;
+}
+
+/// The symbol table of the file rather than dlsym: the test runner looks up
+/// local symbols, and the library exports none of them. Where the library
+/// is loaded comes from an exported symbol.
+bool ProgramLibrary::readSymbols() {
+#ifdef __linux__
+  auto binary = object::ObjectFile::createObjectFile(path);
+  if (!binary) {
+    consumeError(binary.takeError());
+    Logger::warn() << "Cannot read the symbols of the program library\n";
+    return false;
+  }
+  auto elf = dyn_cast<object::ELFObjectFileBase>(binary->getBinary());
+  if (!elf) {
+    return false;
+  }
+
+  std::string exported;
+  for (auto symbol : elf->symbols()) {
+    auto type = symbol.getELFType();
+    if ((symbol.getFlags() & object::SymbolRef::SF_Undefined) ||
+        type == ELF::STT_SECTION || type == ELF::STT_FILE) {
+      continue;
+    }
+    Expected<StringRef> name = symbol.getName();
+    Expected<uint64_t> address = symbol.getAddress();
+    if (!name || !address) {
+      if (!name) {
+        consumeError(name.takeError());
+      }
+      if (!address) {
+        consumeError(address.takeError());
+      }
+      continue;
+    }
+    if (name.get().empty() || address.get() == 0) {
+      continue;
+    }
+    /// A global symbol takes over the local ones of the same name
+    if (symbol.getFlags() & object::SymbolRef::SF_Global) {
+      symbols[name.get()] = address.get();
+      if (type == ELF::STT_FUNC || type == ELF::STT_OBJECT) {
+        exported = name.get().str();
+      }
+    } else {
+      symbols.insert(std::make_pair(name.get(), address.get()));
+    }
+  }
+
+  auto loaded = exported.empty() ? nullptr : dlsym(handle, exported.c_str());
+  if (!loaded) {
+    Logger::warn() << "Cannot find where the program library is loaded\n";
+    return false;
+  }
+  const uint64_t base = uint64_t(loaded) - symbols[exported];
+  for (auto &symbol : symbols) {
+    symbol.second += base;
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+InstrumentationInfo **
+ProgramLibrary::bindSlots(Instrumentation &instrumentation,
+                          llvm_compat::CXXRuntimeOverrides &overrides) {
+  auto fill = [this](const std::map<std::string, uint32_t> &mapping,
+                     const std::string &prefix) {
+    for (auto &offset : mapping) {
+      if (auto slot = getAddress(prefix + offset.first)) {
+        *reinterpret_cast<uint32_t *>(slot) = offset.second;
+      }
+    }
+  };
+  fill(instrumentation.getFunctionOffsetMapping(),
+       Instrumentation::functionIndexOffsetPrefix());
+  fill(instrumentation.getBlockOffsetMapping(),
+       Instrumentation::blockIndexOffsetPrefix());
+
+  if (auto slot = getAddress(AtExitSlot)) {
+    llvm_compat::JITSymbol atExit = overrides.searchOverrides("__cxa_atexit");
+    *reinterpret_cast<uint64_t *>(slot) =
+        llvm_compat::JITSymbolAddress(atExit);
+  }
+
+  auto trampoline =
+      getAddress(Instrumentation::instrumentationInfoVariableName());
+  return reinterpret_cast<InstrumentationInfo **>(trampoline);
+}
+
+uint64_t ProgramLibrary::getAddress(StringRef name) const {
+  auto symbol = symbols.find(name);
+  return symbol == symbols.end() ? 0 : symbol->second;
+}
+
+const StringMap<uint64_t> &ProgramLibrary::getSymbols() const {
+  return symbols;
+}
+
+const std::string &ProgramLibrary::getPath() const { return path; }
@@ -2,9 +2,9 @@
 
 #include "mull/Instrumentation/Instrumentation.h"
 #include "mull/Toolchain/Mangler.h"
+#include "mull/Toolchain/Resolvers/ProcessSymbols.h"
 
 #include <llvm/ExecutionEngine/Orc/ExecutionUtils.h>
-#include <llvm/ExecutionEngine/RTDyldMemoryManager.h>
 
 using namespace mull;
 using namespace llvm;
@@ -18,6 +18,8 @@ InstrumentationResolver::InstrumentationResolver(
           instrumentation.instrumentationInfoVariableName())),
       functionOffsetPrefix(mangler.getNameWithPrefix(
           instrumentation.functionIndexOffsetPrefix())),
+      blockOffsetPrefix(mangler.getNameWithPrefix(
+          instrumentation.blockIndexOffsetPrefix())),
       trampoline(trampoline) {}
 
 llvm_compat::JITSymbolInfo
@@ -28,7 +30,7 @@ InstrumentationResolver::findSymbol(const std::string &name) {
     return symbol;
   }
 
-  if (auto address = RTDyldMemoryManager::getSymbolAddressInProcess(name)) {
+  if (auto address = ProcessSymbols::shared().getAddress(name)) {
     return llvm_compat::JITSymbolInfo(address, JITSymbolFlags::Exported);
   }
 
@@ -44,6 +46,13 @@ InstrumentationResolver::findSymbol(const std::string &name) {
                                       JITSymbolFlags::Exported);
   }
 
+  if (name.find(blockOffsetPrefix) != std::string::npos) {
+    auto moduleName = name.substr(blockOffsetPrefix.length());
+    auto &mapping = instrumentation.getBlockOffsetMapping();
+    return llvm_compat::JITSymbolInfo((uint64_t)&mapping[moduleName],
+                                      JITSymbolFlags::Exported);
+  }
+
   return llvm_compat::JITSymbolInfo(nullptr);
 }
 
@@ -1,15 +1,28 @@
 #include "mull/Toolchain/Resolvers/MutationResolver.h"
 
+#include "mull/Instrumentation/Instrumentation.h"
+#include "mull/Instrumentation/InstrumentationInfo.h"
+#include "mull/Toolchain/Mangler.h"
+#include "mull/Toolchain/Resolvers/ProcessSymbols.h"
 #include "mull/Toolchain/Trampolines.h"
 
-#include <llvm/ExecutionEngine/RTDyldMemoryManager.h>
-
 using namespace mull;
 using namespace llvm;
 
 MutationResolver::MutationResolver(llvm_compat::CXXRuntimeOverrides &overrides,
                                    Trampolines &trampolines, Mangler &mangler)
-    : overrides(overrides), trampolines(trampolines), mangler(mangler) {}
+    : overrides(overrides), trampolines(trampolines), mangler(mangler),
+      instrumentationInfoName(mangler.getNameWithPrefix(
+          Instrumentation::instrumentationInfoVariableName())),
+      functionOffsetPrefix(mangler.getNameWithPrefix(
+          Instrumentation::functionIndexOffsetPrefix())),
+      blockOffsetPrefix(mangler.getNameWithPrefix(
+          Instrumentation::blockIndexOffsetPrefix())) {}
+
+/// The guarded instrumentation of the objects reused from the original run
+/// sees no InstrumentationInfo and stays off
+static InstrumentationInfo *const disabledInstrumentation = nullptr;
+static const uint32_t noFunctionOffset = 0;
 
 llvm_compat::JITSymbolInfo
 MutationResolver::findSymbol(const std::string &name) {
@@ -19,7 +32,7 @@ MutationResolver::findSymbol(const std::string &name) {
     return symbol;
   }
 
-  if (auto address = RTDyldMemoryManager::getSymbolAddressInProcess(name)) {
+  if (auto address = ProcessSymbols::shared().getAddress(name)) {
     return llvm_compat::JITSymbolInfo(address, JITSymbolFlags::Exported);
   }
 
@@ -29,6 +42,17 @@ MutationResolver::findSymbol(const std::string &name) {
                                       JITSymbolFlags::Exported);
   }
 
+  if (name == instrumentationInfoName) {
+    return llvm_compat::JITSymbolInfo((uint64_t)&disabledInstrumentation,
+                                      JITSymbolFlags::Exported);
+  }
+
+  if (name.find(functionOffsetPrefix) == 0 ||
+      name.find(blockOffsetPrefix) == 0) {
+    return llvm_compat::JITSymbolInfo((uint64_t)&noFunctionOffset,
+                                      JITSymbolFlags::Exported);
+  }
+
   return llvm_compat::JITSymbolInfo(nullptr);
 }
 
@@ -0,0 +1,89 @@
+#include "mull/Toolchain/Resolvers/ProcessSymbols.h"
+
+#include "mull/Parallelization/ThreadPool.h"
+
+#include <llvm/ADT/StringSet.h>
+#include <llvm/ExecutionEngine/RTDyldMemoryManager.h>
+
+#include <algorithm>
+
+using namespace mull;
+using namespace llvm;
+
+ProcessSymbols &ProcessSymbols::shared() {
+  static ProcessSymbols symbols;
+  return symbols;
+}
+
+/// dlsym is thread safe, the lock is not held while searching, so that the
+/// links of the workers do not wait for each other. Two of them may search
+/// for the same name at the same time, the first to finish stores it.
+uint64_t ProcessSymbols::getAddress(const std::string &name) {
+  {
+    std::lock_guard<std::mutex> guard(mutex);
+    auto it = addresses.find(name);
+    if (it != addresses.end()) {
+      return it->second;
+    }
+  }
+
+  uint64_t address = RTDyldMemoryManager::getSymbolAddressInProcess(name);
+  std::lock_guard<std::mutex> guard(mutex);
+  return addresses.insert(std::make_pair(name, address)).first->second;
+}
+
+void ProcessSymbols::prefetch(
+    const std::vector<object::ObjectFile *> &objectFiles, size_t workers) {
+  std::vector<std::string> names;
+  {
+    StringSet<> seen;
+    std::lock_guard<std::mutex> guard(mutex);
+    for (auto object : objectFiles) {
+      for (auto symbol : object->symbols()) {
+        if (!(symbol.getFlags() & object::SymbolRef::SF_Undefined)) {
+          continue;
+        }
+
+        Expected<StringRef> name = symbol.getName();
+        if (!name) {
+          consumeError(name.takeError());
+          continue;
+        }
+
+        if (addresses.count(name.get()) == 0 &&
+            seen.insert(name.get()).second) {
+          names.push_back(name.get().str());
+        }
+      }
+    }
+  }
+
+  workers = std::max<size_t>(1, std::min(workers, names.size()));
+  WorkerGroup group(ThreadPool::shared());
+  for (size_t worker = 0; worker < workers; worker++) {
+    group.run([this, &names, worker, workers]() {
+      for (size_t index = worker; index < names.size(); index += workers) {
+        getAddress(names[index]);
+      }
+    });
+  }
+  group.wait();
+}
+
+void ProcessSymbols::forgetMissingSymbols() {
+  std::lock_guard<std::mutex> guard(mutex);
+  std::vector<std::string> missing;
+  for (auto &entry : addresses) {
+    if (entry.getValue() == 0) {
+      missing.push_back(entry.getKey().str());
+    }
+  }
+  for (auto &name : missing) {
+    addresses.erase(name);
+  }
+}
+
+size_t ProcessSymbols::size() {
+  std::lock_guard<std::mutex> guard(mutex);
+  return addresses.size();
+}
@@ -0,0 +1,181 @@
+#include "mull/Toolchain/SlabMemoryManager.h"
+
+#include <llvm/Support/Memory.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace mull;
+using namespace llvm;
+
+static const uintptr_t DefaultAlignment = 16;
+static const uintptr_t MinimumSlabSize = 256 * 1024;
+static const uintptr_t HugePageSize = 2 * 1024 * 1024;
+
+static std::atomic<bool> hugePages(false);
+static std::atomic<uint64_t> mapped(0);
+
+static uintptr_t roundUp(uintptr_t value, uintptr_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+/// Only the pages touched are backed, the slabs are reserved generously
+static uint8_t *mapSlab(uintptr_t size, bool huge) {
+  int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_NORESERVE
+  flags |= MAP_NORESERVE;
+#endif
+  uintptr_t length = huge ? size + HugePageSize : size;
+  void *memory = mmap(nullptr, length, PROT_READ | PROT_WRITE, flags, -1, 0);
+  if (memory == MAP_FAILED) {
+    return nullptr;
+  }
+  auto base = static_cast<uint8_t *>(memory);
+  if (!huge) {
+    return base;
+  }
+
+  auto aligned = reinterpret_cast<uint8_t *>(
+      roundUp(reinterpret_cast<uintptr_t>(base), HugePageSize));
+  if (aligned != base) {
+    munmap(base, aligned - base);
+  }
+  auto tail = (base + length) - (aligned + size);
+  if (tail != 0) {
+    munmap(aligned + size, tail);
+  }
+#ifdef MADV_HUGEPAGE
+  madvise(aligned, size, MADV_HUGEPAGE);
+#endif
+  return aligned;
+}
+
+SlabMemoryManager::SlabMemoryManager()
+    : code({{}, nullptr, nullptr, 0}), readOnlyData({{}, nullptr, nullptr, 0}),
+      writableData({{}, nullptr, nullptr, 0}) {}
+
+SlabMemoryManager::~SlabMemoryManager() {
+  for (auto arena : {&code, &readOnlyData, &writableData}) {
+    for (auto &slab : arena->slabs) {
+      munmap(slab.base, slab.size);
+      mapped.fetch_sub(slab.size, std::memory_order_relaxed);
+    }
+  }
+}
+
+void SlabMemoryManager::setHugePages(bool enabled) {
+  hugePages.store(enabled, std::memory_order_relaxed);
+}
+
+uint64_t SlabMemoryManager::mappedBytes() {
+  return mapped.load(std::memory_order_relaxed);
+}
+
+bool SlabMemoryManager::reserve(Arena &arena, uintptr_t size,
+                                uint32_t alignment) {
+  uintptr_t needed = size + std::max<uintptr_t>(alignment, DefaultAlignment);
+  if (arena.next && uintptr_t(arena.end - arena.next) >= needed) {
+    return true;
+  }
+
+  bool huge = hugePages.load(std::memory_order_relaxed);
+  uintptr_t slabSize = std::max(needed, MinimumSlabSize);
+  if (!arena.slabs.empty()) {
+    slabSize = std::max(slabSize, arena.slabs.back().size * 2);
+  }
+  slabSize = roundUp(slabSize, huge ? HugePageSize : sysconf(_SC_PAGESIZE));
+
+  auto base = mapSlab(slabSize, huge);
+  if (!base) {
+    return false;
+  }
+  mapped.fetch_add(slabSize, std::memory_order_relaxed);
+  arena.slabs.push_back({base, slabSize, 0});
+  arena.next = base;
+  arena.end = base + slabSize;
+  return true;
+}
+
+void SlabMemoryManager::reserveAllocationSpace(
+    uintptr_t codeSize, uint32_t codeAlign, uintptr_t roDataSize,
+    uint32_t roDataAlign, uintptr_t rwDataSize, uint32_t rwDataAlign) {
+  /// A failure shows up when the section is allocated
+  if (codeSize != 0) {
+    reserve(code, codeSize, codeAlign);
+  }
+  if (roDataSize != 0) {
+    reserve(readOnlyData, roDataSize, roDataAlign);
+  }
+  if (rwDataSize != 0) {
+    reserve(writableData, rwDataSize, rwDataAlign);
+  }
+}
+
+uint8_t *SlabMemoryManager::allocate(Arena &arena, uintptr_t size,
+                                     unsigned alignment) {
+  if (alignment == 0) {
+    alignment = DefaultAlignment;
+  }
+  /// Even an empty section gets an address of its own
+  size = std::max<uintptr_t>(size, 1);
+  if (!reserve(arena, size, alignment)) {
+    return nullptr;
+  }
+
+  auto &slab = arena.slabs.back();
+  auto address = roundUp(reinterpret_cast<uintptr_t>(arena.next), alignment);
+  arena.next = reinterpret_cast<uint8_t *>(address + size);
+  slab.used = arena.next - slab.base;
+  return reinterpret_cast<uint8_t *>(address);
+}
+
+uint8_t *SlabMemoryManager::allocateCodeSection(uintptr_t size,
+                                                unsigned alignment,
+                                                unsigned sectionID,
+                                                StringRef sectionName) {
+  return allocate(code, size, alignment);
+}
+
+uint8_t *SlabMemoryManager::allocateDataSection(uintptr_t size,
+                                                unsigned alignment,
+                                                unsigned sectionID,
+                                                StringRef sectionName,
+                                                bool isReadOnly) {
+  return allocate(isReadOnly ? readOnlyData : writableData, size, alignment);
+}
+
+/// The whole slab changes its protection at once: protecting a part of a
+/// huge page would split it
+bool SlabMemoryManager::protect(Arena &arena, int protection,
+                                std::string *errorMessage) {
+  for (size_t index = arena.firstPending; index < arena.slabs.size();
+       index++) {
+    auto &slab = arena.slabs[index];
+    if (mprotect(slab.base, slab.size, protection) != 0) {
+      if (errorMessage) {
+        *errorMessage =
+            std::string("Cannot protect the JIT memory: ") + strerror(errno);
+      }
+      return false;
+    }
+    if (protection & PROT_EXEC) {
+      sys::Memory::InvalidateInstructionCache(slab.base, slab.used);
+    }
+  }
+  arena.firstPending = arena.slabs.size();
+  arena.next = nullptr;
+  arena.end = nullptr;
+  return true;
+}
+
+bool SlabMemoryManager::finalizeMemory(std::string *errorMessage) {
+  bool protectedAll =
+      protect(code, PROT_READ | PROT_EXEC, errorMessage) &&
+      protect(readOnlyData, PROT_READ, errorMessage);
+  return !protectedAll;
+}
@@ -0,0 +1,68 @@
+#include "mull/Toolchain/SymbolIndex.h"
+
+using namespace mull;
+using namespace llvm;
+
+static bool isIndexed(const object::BasicSymbolRef &symbol) {
+  auto flags = symbol.getFlags();
+  return !(flags & object::SymbolRef::SF_Undefined) &&
+         (flags & object::SymbolRef::SF_Global);
+}
+
+static unsigned countIndexedSymbols(
+    const std::vector<object::ObjectFile *> &objectFiles) {
+  unsigned count = 0;
+  for (auto object : objectFiles) {
+    for (auto symbol : object->symbols()) {
+      if (isIndexed(symbol)) {
+        count++;
+      }
+    }
+  }
+  return count;
+}
+
+SymbolIndex::SymbolIndex(std::vector<object::ObjectFile *> files)
+    : objectFiles(std::move(files)), owners(countIndexedSymbols(objectFiles)) {
+  for (size_t index = 0; index < objectFiles.size(); index++) {
+    for (auto symbol : objectFiles[index]->symbols()) {
+      if (!isIndexed(symbol)) {
+        continue;
+      }
+
+      Expected<StringRef> name = symbol.getName();
+      if (!name) {
+        consumeError(name.takeError());
+        continue;
+      }
+
+      /// The first strong definition wins, a weak one is used only
+      /// when there is no strong definition at all
+      const bool weak = symbol.getFlags() & object::SymbolRef::SF_Weak;
+      auto inserted =
+          owners.insert(std::make_pair(name.get(), Owner{index, weak}));
+      auto &owner = inserted.first->second;
+      if (!inserted.second && owner.weak && !weak) {
+        owner = Owner{index, weak};
+      }
+    }
+  }
+}
+
+bool SymbolIndex::indexes(
+    const std::vector<object::ObjectFile *> &files) const {
+  return objectFiles == files;
+}
+
+bool SymbolIndex::lookup(StringRef name, size_t &objectIndex) const {
+  auto it = owners.find(name);
+  if (it == owners.end()) {
+    return false;
+  }
+  objectIndex = it->second.objectIndex;
+  return true;
+}
+
+const std::vector<object::ObjectFile *> &SymbolIndex::getObjectFiles() const {
+  return objectFiles;
+}
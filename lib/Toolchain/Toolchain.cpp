@@ -1,13 +1,26 @@
 #include "mull/Toolchain/Toolchain.h"
 
 #include "mull/Config/Configuration.h"
+#include "mull/MullModule.h"
+#include "mull/Toolchain/ObjectCacheBackend.h"
 
 #include <llvm/ADT/Triple.h>
 #include <llvm/ExecutionEngine/ExecutionEngine.h>
 #include <llvm/Support/TargetSelect.h>
 
+#include <algorithm>
+
 using namespace mull;
 
+static std::unique_ptr<ObjectCacheBackend>
+remoteCache(const Configuration &config) {
+  if (!config.cacheEnabled || config.cacheRemoteURL.empty()) {
+    return nullptr;
+  }
+  return llvm::make_unique<AsyncObjectCacheBackend>(
+      llvm::make_unique<HTTPObjectCacheBackend>(config.cacheRemoteURL));
+}
+
 /// To make sure that initialization is getting called
 /// before we create TargetMachine
 /// Otherwise we cannot selectTarget, which lead us to invalid TargetMachine
@@ -17,11 +30,33 @@ Toolchain::NativeTarget::NativeTarget() {
   llvm::InitializeNativeTargetAsmParser();
 }
 
+static llvm::CodeGenOpt::Level codegenOptLevel(int level) {
+  switch (level) {
+  case 0:
+    return llvm::CodeGenOpt::None;
+  case 1:
+    return llvm::CodeGenOpt::Less;
+  case 3:
+    return llvm::CodeGenOpt::Aggressive;
+  default:
+    return llvm::CodeGenOpt::Default;
+  }
+}
+
 Toolchain::Toolchain(const Configuration &config)
-    : nativeTarget(),
-      machine(llvm::EngineBuilder().selectTarget(
-          llvm::Triple(), "", "", llvm::SmallVector<std::string, 1>())),
-      objectCache(config.cacheEnabled, config.cacheDirectory), simpleCompiler(),
+    : nativeTarget(), optLevel(codegenOptLevel(config.codegenOptLevel)),
+      parallelCodegenThreshold(
+          uint64_t(std::max(config.parallelCodegenThreshold, 0)) * 1024 *
+          1024),
+      codegenWorkers(unsigned(std::max(config.parallelization.workers, 1))),
+      positionIndependent(config.programLibraryEnabled &&
+                          config.cacheEnabled),
+      machine(createTargetMachine()),
+      objectCache(config.cacheEnabled, config.cacheDirectory,
+                  config.cacheCompressionEnabled,
+                  uint64_t(std::max(config.cacheSizeLimit, 0)) * 1024 * 1024,
+                  config.cachePopulateEnabled, remoteCache(config)),
+      simpleCompiler(),
       nameMangler(machine->createDataLayout()) {}
 
 ObjectCache &Toolchain::cache() { return objectCache; }
@@ -30,4 +65,38 @@ Compiler &Toolchain::compiler() { return simpleCompiler; }
 
 llvm::TargetMachine &Toolchain::targetMachine() { return *machine; }
 
+llvm::TargetMachine &Toolchain::workerTargetMachine() {
+  static thread_local std::unique_ptr<llvm::TargetMachine>
+      machines[llvm::CodeGenOpt::Aggressive + 1];
+  auto &workerMachine = machines[optLevel];
+  if (!workerMachine) {
+    workerMachine = createTargetMachine();
+  }
+  return *workerMachine;
+}
+
+unsigned Toolchain::codegenPartitions(const MullModule &module) const {
+  if (parallelCodegenThreshold == 0 ||
+      module.getBitcodeSize() <= parallelCodegenThreshold) {
+    return 1;
+  }
+  return codegenWorkers;
+}
+
+std::unique_ptr<llvm::TargetMachine> Toolchain::createTargetMachine() {
+  llvm::EngineBuilder builder;
+  builder.setOptLevel(optLevel);
+  if (positionIndependent) {
+    builder.setRelocationModel(llvm::Reloc::PIC_);
+  }
+  std::unique_ptr<llvm::TargetMachine> targetMachine(builder.selectTarget(
+      llvm::Triple(), "", "", llvm::SmallVector<std::string, 1>()));
+  if (optLevel == llvm::CodeGenOpt::None) {
+    targetMachine->setFastISel(true);
+  }
+  return targetMachine;
+}
+
 mull::Mangler &Toolchain::mangler() { return nameMangler; }
+
+bool Toolchain::isPositionIndependent() const { return positionIndependent; }
@@ -1,45 +1,113 @@
 #include "mull/Toolchain/Trampolines.h"
 
+#include "mull/MutationPoint.h"
 #include "mull/Toolchain/JITEngine.h"
 #include "mull/Toolchain/Mangler.h"
 
+#include <llvm/Support/ErrorHandling.h>
+
+#include <cstdlib>
+#include <cstring>
+
 using namespace mull;
 
+static const size_t CacheLineSize = 64;
+static const char *const TrampolineSuffix = "_trampoline";
+static const char *const OriginalSuffix = "_original";
+
 Trampolines::Trampolines(const std::vector<std::string> &trampolineNames)
-    : trampolineNames(trampolineNames) {}
+    : trampolineNames(trampolineNames), table(nullptr) {}
 
-Trampolines::~Trampolines() {
-  for (auto &pair : _trampolines) {
-    delete pair.second;
-  }
-}
+Trampolines::~Trampolines() { free(table); }
 
 void Trampolines::fixupOriginalFunctions(JITEngine &jit) {
-  for (auto &pair : _trampolines) {
-    auto &name = pair.first;
-    auto originalName =
-        name.substr(0, name.length() - std::string("_trampoline").length()) +
-        "_original";
-    auto it = _trampolines.find(name);
-    assert(it != _trampolines.end());
-    uint64_t *trampoline = it->second;
-    auto address = llvm_compat::JITSymbolAddress(jit.getSymbol(originalName));
+  for (size_t index = 0; index < originalNames.size(); index++) {
+    auto address =
+        llvm_compat::JITSymbolAddress(jit.getSymbol(originalNames[index]));
     assert(address);
-    *trampoline = address;
+    table[index] = address;
   }
 }
 
 uint64_t *Trampolines::findTrampoline(const std::string &name) {
-  auto it = _trampolines.find(name);
-  if (it == _trampolines.end()) {
+  auto it = indices.find(name);
+  if (it == indices.end()) {
     return nullptr;
   }
-  return it->second;
+  return &table[it->second];
 }
 
 void Trampolines::allocateTrampolines(Mangler &mangler) {
+  free(table);
+  table = nullptr;
+  indices.clear();
+  originalNames.clear();
+  entries.clear();
+  entryIndices.clear();
+  entryAddresses.clear();
+
+  size_t bytes = trampolineNames.size() * sizeof(uint64_t);
+  bytes = (bytes / CacheLineSize + 1) * CacheLineSize;
+  void *memory = nullptr;
+  if (posix_memalign(&memory, CacheLineSize, bytes) != 0) {
+    llvm::report_fatal_error("Cannot allocate the trampolines");
+  }
+  memset(memory, 0, bytes);
+  table = static_cast<uint64_t *>(memory);
+
+  const size_t suffixLength = strlen(TrampolineSuffix);
   for (auto &name : trampolineNames) {
-    _trampolines.insert(
-        std::make_pair(mangler.getNameWithPrefix(name), new uint64_t));
+    auto inserted =
+        indices.insert(std::make_pair(mangler.getNameWithPrefix(name),
+                                      originalNames.size()));
+    if (!inserted.second) {
+      continue;
+    }
+    originalNames.push_back(mangler.getNameWithPrefix(
+        name.substr(0, name.length() - suffixLength) + OriginalSuffix));
+  }
+}
+
+void Trampolines::redirectEntries(JITEngine &jit, Mangler &mangler,
+                                  const std::vector<MutationPoint *> &points) {
+  entryIndices.resize(originalNames.size(), -1);
+  for (auto point : points) {
+    if (point->getSchemaIndex() != 0) {
+      continue;
+    }
+    auto trampoline = indices.find(
+        mangler.getNameWithPrefix(point->getTrampolineName()));
+    if (trampoline == indices.end() ||
+        entryIndices[trampoline->second] != -1) {
+      continue;
+    }
+    /// The functions of internal linkage have no symbol to find their entry
+    auto entry = llvm_compat::JITSymbolAddress(
+        jit.getSymbol(mangler.getNameWithPrefix(point->getFunctionName())));
+    auto original = table[trampoline->second];
+    if (entry == 0 || !EntryPatch::reaches(entry, original)) {
+      continue;
+    }
+
+    auto patched = entryAddresses.find(entry);
+    if (patched == entryAddresses.end()) {
+      EntryPatch patch(entry);
+      if (!patch.jumpTo(original)) {
+        continue;
+      }
+      patched = entryAddresses.insert(std::make_pair(entry, entries.size()))
+                    .first;
+      entries.push_back(patch);
+    }
+    entryIndices[trampoline->second] = int(patched->second);
+  }
+}
+
+const EntryPatch *Trampolines::findEntry(const std::string &name) const {
+  auto it = indices.find(name);
+  if (it == indices.end() || it->second >= entryIndices.size() ||
+      entryIndices[it->second] == -1) {
+    return nullptr;
   }
+  return &entries[entryIndices[it->second]];
 }
@@ -0,0 +1,93 @@
+#include "mull/Reporters/ArrowStream.h"
+
+#include <llvm/Support/raw_ostream.h>
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+using namespace mull;
+
+namespace {
+
+struct Message {
+  std::string metadata;
+  std::string body;
+};
+
+/// The messages of the stream, whose bodies are as long as expected
+std::vector<Message> readMessages(const std::string &stream,
+                                  const std::vector<size_t> &bodyLengths) {
+  std::vector<Message> messages;
+  size_t position = 0;
+  for (size_t index = 0;; index++) {
+    uint32_t continuation = 0;
+    int32_t size = 0;
+    memcpy(&continuation, stream.data() + position, sizeof(continuation));
+    memcpy(&size, stream.data() + position + 4, sizeof(size));
+    EXPECT_EQ(0xFFFFFFFF, continuation);
+    position += 8;
+    if (size == 0) {
+      break;
+    }
+    EXPECT_EQ(0, size % 8);
+    Message message;
+    message.metadata = stream.substr(position, size);
+    position += size;
+    message.body = stream.substr(position, bodyLengths.at(index));
+    position += bodyLengths.at(index);
+    messages.push_back(message);
+  }
+  EXPECT_EQ(stream.size(), position);
+  return messages;
+}
+
+} // namespace
+
+TEST(ArrowStreamWriter, SendsTheNewStringsOfTheDictionariesBeforeEachBatch) {
+  std::string stream;
+  llvm::raw_string_ostream output(stream);
+  ArrowStreamWriter writer(
+      output, {{"test", ArrowStreamWriter::ColumnType::Dictionary},
+               {"line", ArrowStreamWriter::ColumnType::Int32},
+               {"killed", ArrowStreamWriter::ColumnType::Bool}});
+
+  const char *tests[] = {"first", "second", "first"};
+  for (int row = 0; row < 3; row++) {
+    writer.appendString(0, tests[row]);
+    writer.appendInteger(1, row);
+    writer.appendBool(2, row == 1);
+  }
+  ASSERT_EQ(3U, writer.pendingRows());
+  writer.writeBatch();
+  ASSERT_EQ(0U, writer.pendingRows());
+
+  writer.appendString(0, "second");
+  writer.appendInteger(1, 3);
+  writer.appendBool(2, false);
+  writer.finish();
+  output.flush();
+
+  /// The schema, the dictionary, the first batch, the second batch: the
+  /// second one adds no string
+  auto messages = readMessages(stream, {0, 32, 40, 24});
+  ASSERT_EQ(4U, messages.size());
+  ASSERT_NE(std::string::npos, messages[0].metadata.find("killed"));
+
+  /// The offsets of the strings, then the strings
+  const int32_t offsets[] = {0, 5, 11};
+  ASSERT_EQ(0, memcmp(offsets, messages[1].body.data(), sizeof(offsets)));
+  ASSERT_EQ("firstsecond", messages[1].body.substr(16, 11));
+
+  /// The indices into the dictionary, the lines, then the killed bits, each
+  /// on 8 bytes
+  const int32_t indices[] = {0, 1, 0};
+  const int32_t lines[] = {0, 1, 2};
+  ASSERT_EQ(0, memcmp(indices, messages[2].body.data(), sizeof(indices)));
+  ASSERT_EQ(0, memcmp(lines, messages[2].body.data() + 16, sizeof(lines)));
+  ASSERT_EQ(0x2, messages[2].body[32]);
+
+  const int32_t secondIndices[] = {1};
+  ASSERT_EQ(0, memcmp(secondIndices, messages[3].body.data(),
+                      sizeof(secondIndices)));
+}
@@ -0,0 +1,74 @@
+#include "mull/BitcodeCache.h"
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+
+#include "gtest/gtest.h"
+
+#include <fstream>
+
+using namespace mull;
+using namespace llvm;
+
+class BitcodeCacheTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    SmallString<128> directory;
+    ASSERT_FALSE(sys::fs::createUniqueDirectory("mull-bitcode", directory));
+    cacheDirectory = directory.str().str();
+    executablePath = cacheDirectory + "/executable";
+    writeExecutable("first build");
+  }
+
+  void writeExecutable(StringRef content) {
+    std::ofstream stream(executablePath);
+    stream << content.str();
+    executable = content.str();
+  }
+
+  bool store(HashAlgorithm hashAlgorithm = HashAlgorithm::MD5) {
+    return BitcodeCache::store(cacheDirectory, executablePath, executable,
+                               hashAlgorithm, {"first", "second file"},
+                               {"hash1", "hash2"});
+  }
+
+  std::unique_ptr<BitcodeCache>
+  load(HashAlgorithm hashAlgorithm = HashAlgorithm::MD5) {
+    return BitcodeCache::load(cacheDirectory, executablePath, executable,
+                              hashAlgorithm);
+  }
+
+  std::string cacheDirectory;
+  std::string executablePath;
+  std::string executable;
+};
+
+TEST_F(BitcodeCacheTest, loadsTheStoredFiles) {
+  ASSERT_EQ(nullptr, load());
+  ASSERT_TRUE(store());
+
+  auto cache = load();
+  ASSERT_NE(nullptr, cache);
+  ASSERT_EQ(std::vector<StringRef>({"first", "second file"}),
+            cache->getFiles());
+  ASSERT_EQ(std::vector<std::string>({"hash1", "hash2"}), cache->getHashes());
+}
+
+TEST_F(BitcodeCacheTest, missesOnceTheExecutableChanges) {
+  ASSERT_TRUE(store());
+  writeExecutable("second build");
+  ASSERT_EQ(nullptr, load());
+}
+
+TEST_F(BitcodeCacheTest, hitsWhenOnlyTheModificationTimeChanges) {
+  ASSERT_TRUE(store());
+  sys::fs::remove(executablePath);
+  writeExecutable(executable);
+  ASSERT_NE(nullptr, load());
+  ASSERT_NE(nullptr, load());
+}
+
+TEST_F(BitcodeCacheTest, missesForAnotherHashAlgorithm) {
+  ASSERT_TRUE(store(HashAlgorithm::MD5));
+  ASSERT_EQ(nullptr, load(HashAlgorithm::XXHash64));
+}
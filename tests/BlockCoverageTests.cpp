@@ -0,0 +1,169 @@
+#include "mull/Instrumentation/BlockCoverage.h"
+
+#include "mull/Filter.h"
+#include "mull/Instrumentation/Instrumentation.h"
+#include "mull/TestFrameworks/Test.h"
+
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Verifier.h>
+
+#include "gtest/gtest.h"
+
+using namespace mull;
+using namespace llvm;
+
+/// A function with the given number of blocks, each branching to the next
+static Function *createFunction(Module &module, const std::string &name,
+                                int blocks) {
+  auto &context = module.getContext();
+  auto type = FunctionType::get(Type::getVoidTy(context), false);
+  auto function =
+      Function::Create(type, Function::ExternalLinkage, name, &module);
+  std::vector<BasicBlock *> basicBlocks;
+  for (int index = 0; index < blocks; index++) {
+    basicBlocks.push_back(BasicBlock::Create(context, "", function));
+  }
+  for (int index = 0; index < blocks; index++) {
+    IRBuilder<> builder(basicBlocks[index]);
+    if (index + 1 < blocks) {
+      builder.CreateBr(basicBlocks[index + 1]);
+    } else {
+      builder.CreateRetVoid();
+    }
+  }
+  return function;
+}
+
+TEST(BlockCoverage, executedBlocksOnly) {
+  LLVMContext context;
+  Module module("module", context);
+  auto first = createFunction(module, "first", 3);
+  auto second = createFunction(module, "second", 2);
+  mull::Test covered("covered", "", "", {}, nullptr);
+  mull::Test unknown("unknown", "", "", {}, nullptr);
+
+  BlockCoverage coverage;
+  coverage.setFirstBlock(first, 0);
+  coverage.setFirstBlock(second, 3);
+  coverage.setCoveredBlocks(&covered, {0, 2, 4});
+
+  ASSERT_TRUE(coverage.executed(&covered, first, 0));
+  ASSERT_FALSE(coverage.executed(&covered, first, 1));
+  ASSERT_TRUE(coverage.executed(&covered, first, 2));
+  ASSERT_FALSE(coverage.executed(&covered, second, 0));
+  ASSERT_TRUE(coverage.executed(&covered, second, 1));
+
+  ASSERT_TRUE(coverage.executed(&unknown, first, 1));
+}
+
+TEST(BlockCoverage, blocksAreNumberedAcrossModules) {
+  LLVMContext context;
+  Module firstModule("first", context);
+  Module secondModule("second", context);
+  createFunction(firstModule, "first", 3);
+  createFunction(firstModule, "second", 2);
+  createFunction(secondModule, "third", 4);
+
+  Instrumentation instrumentation(InstrumentationMode::Callbacks, false,
+                                  true);
+  instrumentation.recordFunctions(&firstModule);
+  instrumentation.recordFunctions(&secondModule);
+  ASSERT_NE(nullptr, instrumentation.getBlockCoverage());
+  ASSERT_EQ(0U, instrumentation.getBlockOffsetMapping()["first"]);
+  ASSERT_EQ(5U, instrumentation.getBlockOffsetMapping()["second"]);
+
+  instrumentation.insertCallbacks(&secondModule);
+  ASSERT_FALSE(verifyModule(secondModule, &errs()));
+  auto offset = secondModule.getNamedGlobal(
+      std::string(Instrumentation::blockIndexOffsetPrefix()) + "second");
+  ASSERT_NE(nullptr, offset);
+}
+
+TEST(BlockCoverage, disabledByDefault) {
+  Instrumentation instrumentation;
+  ASSERT_EQ(nullptr, instrumentation.getBlockCoverage());
+}
+
+static bool callsFunction(Function *caller, StringRef callee) {
+  for (auto &block : *caller) {
+    for (auto &instruction : block) {
+      auto call = dyn_cast<CallInst>(&instruction);
+      if (call && call->getCalledFunction() &&
+          call->getCalledFunction()->getName() == callee) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+TEST(BlockCoverage, filteredFunctionsAreNotInstrumented) {
+  LLVMContext context;
+  Module module("module", context);
+  auto kept = createFunction(module, "kept", 2);
+  auto filtered = createFunction(module, "std_filtered", 2);
+
+  Filter filter;
+  filter.skipByName("std_");
+  Instrumentation instrumentation(InstrumentationMode::Callbacks, false,
+                                  true);
+  auto unfilteredSuffix = instrumentation.cacheSuffix();
+  instrumentation.setFilter(&filter);
+  ASSERT_NE(unfilteredSuffix, instrumentation.cacheSuffix());
+
+  instrumentation.recordFunctions(&module);
+  instrumentation.insertCallbacks(&module);
+  ASSERT_FALSE(verifyModule(module, &errs()));
+  ASSERT_TRUE(callsFunction(kept, "mull_enterFunction"));
+  ASSERT_FALSE(callsFunction(filtered, "mull_enterFunction"));
+}
+
+TEST(Instrumentation, boundedInlineCallbacks) {
+  LLVMContext context;
+  Module module("module", context);
+  createFunction(module, "body", 3);
+
+  Instrumentation instrumentation(InstrumentationMode::InlineCallbacks);
+  auto unboundedSuffix = instrumentation.cacheSuffix();
+  instrumentation.setMaxDistance(2);
+  ASSERT_NE(unboundedSuffix, instrumentation.cacheSuffix());
+
+  instrumentation.recordFunctions(&module);
+  instrumentation.insertCallbacks(&module);
+  ASSERT_FALSE(verifyModule(module, &errs()));
+}
+
+TEST(Instrumentation, testsWithTheSameCallsShareTheirTestees) {
+  LLVMContext context;
+  Module module("module", context);
+  auto body = createFunction(module, "body", 1);
+  auto callee = createFunction(module, "callee", 1);
+  auto other = createFunction(module, "other", 1);
+
+  Filter filter;
+  Instrumentation instrumentation;
+  instrumentation.recordFunctions(&module);
+  mull::Test first("first", "", "", {}, body);
+  mull::Test second("second", "", "", {}, body);
+
+  Instrumentation::Calls calls({{nullptr, body}, {body, callee}});
+  auto firstTestees = instrumentation.getTestees(calls, first, filter, 2);
+  auto secondTestees = instrumentation.getTestees(calls, second, filter, 2);
+  ASSERT_EQ(2U, firstTestees.size());
+  ASSERT_EQ(firstTestees.size(), secondTestees.size());
+  for (size_t index = 0; index < firstTestees.size(); index++) {
+    ASSERT_EQ(firstTestees[index]->getTesteeFunction(),
+              secondTestees[index]->getTesteeFunction());
+    ASSERT_EQ(firstTestees[index]->getDistance(),
+              secondTestees[index]->getDistance());
+    ASSERT_EQ(&second, secondTestees[index]->getTest());
+  }
+
+  Instrumentation::Calls otherCalls({{nullptr, body}, {body, other}});
+  auto otherTestees = instrumentation.getTestees(otherCalls, second, filter, 2);
+  ASSERT_EQ(2U, otherTestees.size());
+  ASSERT_EQ(other, otherTestees[1]->getTesteeFunction());
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+
+#include "gtest/gtest.h"
+
+#include <string>
+#include <vector>
+
+/// Cache directories of their own for the tests of the caches, removed once
+/// the test finishes
+class CacheDirectoryFixture : public ::testing::Test {
+protected:
+  void TearDown() override {
+    for (auto &directory : directories) {
+      llvm::sys::fs::remove_directories(directory);
+    }
+  }
+
+  std::string createCacheDirectory() {
+    llvm::SmallString<128> directory;
+    auto error =
+        llvm::sys::fs::createUniqueDirectory("mull-cache", directory);
+    EXPECT_FALSE(error);
+    directories.push_back(directory.str().str());
+    return directories.back();
+  }
+
+private:
+  std::vector<std::string> directories;
+};
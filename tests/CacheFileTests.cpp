@@ -0,0 +1,45 @@
+#include "mull/CacheFile.h"
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include "gtest/gtest.h"
+
+using namespace mull;
+using namespace llvm;
+
+static std::string contentsOf(const std::string &path) {
+  auto buffer = MemoryBuffer::getFile(path);
+  return buffer ? buffer.get()->getBuffer().str() : std::string();
+}
+
+static size_t filesIn(const std::string &directory) {
+  size_t files = 0;
+  std::error_code error;
+  sys::fs::directory_iterator it(directory, error), end;
+  for (; it != end && !error; it.increment(error)) {
+    files++;
+  }
+  return files;
+}
+
+TEST(CacheFile, replacesTheFileWhole) {
+  SmallString<128> directory;
+  ASSERT_FALSE(sys::fs::createUniqueDirectory("mull-cache-file", directory));
+  std::string path = directory.str().str() + "/entries/file";
+
+  auto error = writeCacheFile(
+      path, [](raw_ostream &outfile) { outfile << "first\n"; });
+  ASSERT_FALSE(error);
+  ASSERT_EQ("first\n", contentsOf(path));
+
+  error = writeCacheFile(path,
+                         [](raw_ostream &outfile) { outfile << "second\n"; });
+  ASSERT_FALSE(error);
+  ASSERT_EQ("second\n", contentsOf(path));
+
+  /// No temporary file is left behind
+  ASSERT_EQ(1u, filesIn(directory.str().str() + "/entries"));
+}
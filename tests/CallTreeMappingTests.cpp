@@ -0,0 +1,91 @@
+#include "mull/Instrumentation/CallTreeMapping.h"
+#include "mull/Instrumentation/DynamicCallTree.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <stack>
+#include <thread>
+
+using namespace mull;
+
+TEST(CallTreeMapping, only_pages_reached_are_used) {
+  const size_t functions = 2000000;
+  std::vector<uint32_t> mapping(CallTreeMapping::size(functions) /
+                                sizeof(uint32_t));
+  CallTreeMapping::initialize(mapping.data(), functions);
+
+  *CallTreeMapping::slot(mapping.data(), 5) = 5;
+  *CallTreeMapping::slot(mapping.data(), 7) = 5;
+  *CallTreeMapping::slot(mapping.data(), 1999999) = 7;
+
+  ASSERT_EQ(2U, mapping[0]);
+  ASSERT_EQ(5U, CallTreeMapping::get(mapping.data(), 5));
+  ASSERT_EQ(5U, CallTreeMapping::get(mapping.data(), 7));
+  ASSERT_EQ(7U, CallTreeMapping::get(mapping.data(), 1999999));
+  ASSERT_EQ(0U, CallTreeMapping::get(mapping.data(), 6));
+  ASSERT_EQ(0U, CallTreeMapping::get(mapping.data(), 1000000));
+
+  std::vector<std::pair<uint32_t, uint32_t>> calls;
+  CallTreeMapping::extractCalls(mapping.data(), functions, calls);
+  std::vector<std::pair<uint32_t, uint32_t>> expected(
+      {{0, 5}, {5, 7}, {7, 1999999}});
+  ASSERT_EQ(expected, calls);
+
+  /// Everything but the offset of the first page is cleared
+  ASSERT_EQ(mapping.size() - 1,
+            size_t(std::count(mapping.begin(), mapping.end(), 0)));
+
+  *CallTreeMapping::slot(mapping.data(), 1000000) = 1000000;
+  ASSERT_EQ(1U, mapping[0]);
+  CallTreeMapping::clear(mapping.data(), functions);
+  ASSERT_EQ(mapping.size() - 1,
+            size_t(std::count(mapping.begin(), mapping.end(), 0)));
+}
+
+TEST(CallTreeMapping, pages_handed_out_once_across_threads) {
+  const size_t functions = 64 * CallTreeMapping::PageSize;
+  std::vector<uint32_t> mapping(CallTreeMapping::size(functions) /
+                                sizeof(uint32_t));
+  CallTreeMapping::initialize(mapping.data(), functions);
+
+  std::vector<std::thread> threads;
+  for (uint32_t thread = 0; thread < 4; thread++) {
+    threads.emplace_back([&mapping, functions]() {
+      std::stack<uint32_t> stack;
+      for (uint32_t index = 1; index < functions; index += 3) {
+        DynamicCallTree::recordCaller(
+            index, CallTreeMapping::slot(mapping.data(), index), stack);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_EQ(64U, mapping[0]);
+  for (uint32_t index = 1; index < functions; index++) {
+    ASSERT_EQ(index % 3 == 1 ? index : 0,
+              CallTreeMapping::get(mapping.data(), index));
+  }
+}
+
+TEST(CallTreeMapping, next_non_zero_skips_zero_words) {
+  std::vector<uint32_t> words(37, 0);
+  words[3] = 1;
+  words[4] = 2;
+  words[20] = 3;
+  words[36] = 4;
+
+  std::vector<size_t> found;
+  for (size_t index = CallTreeMapping::nextNonZero(words.data(), 0, 37);
+       index < 37;
+       index = CallTreeMapping::nextNonZero(words.data(), index + 1, 37)) {
+    found.push_back(index);
+  }
+  ASSERT_EQ(std::vector<size_t>({3, 4, 20, 36}), found);
+
+  ASSERT_EQ(20U, CallTreeMapping::nextNonZero(words.data(), 5, 37));
+  ASSERT_EQ(20U, CallTreeMapping::nextNonZero(words.data(), 5, 20));
+  ASSERT_EQ(35U, CallTreeMapping::nextNonZero(words.data(), 21, 35));
+}
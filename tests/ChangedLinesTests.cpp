@@ -0,0 +1,75 @@
+#include "mull/ChangedLines.h"
+#include "mull/SourceLocation.h"
+
+#include "gtest/gtest.h"
+
+using namespace mull;
+
+static bool changed(const ChangedLines &changes, const std::string &path,
+                    int line) {
+  return changes.contains(SourceLocation("/repo", path, line, 1));
+}
+
+TEST(ChangedLines, parsesUnifiedDiff) {
+  auto changes = ChangedLines::parse("diff --git a/lib/a.cpp b/lib/a.cpp\n"
+                                     "index 1111111..2222222 100644\n"
+                                     "--- a/lib/a.cpp\n"
+                                     "+++ b/lib/a.cpp\n"
+                                     "@@ -10,4 +10,5 @@ int f() {\n"
+                                     " context\n"
+                                     "-old\n"
+                                     "+new\n"
+                                     "+added\n"
+                                     " context\n"
+                                     " context\n"
+                                     "@@ -30 +31,0 @@\n"
+                                     "-removed\n"
+                                     "diff --git a/gone.cpp b/gone.cpp\n"
+                                     "--- a/gone.cpp\n"
+                                     "+++ /dev/null\n"
+                                     "@@ -1 +0,0 @@\n"
+                                     "-gone\n");
+
+  ASSERT_FALSE(changes.empty());
+  ASSERT_FALSE(changed(changes, "/repo/lib/a.cpp", 9));
+  ASSERT_TRUE(changed(changes, "/repo/lib/a.cpp", 10));
+  ASSERT_TRUE(changed(changes, "/repo/lib/a.cpp", 11));
+  ASSERT_TRUE(changed(changes, "/repo/lib/a.cpp", 12));
+  ASSERT_FALSE(changed(changes, "/repo/lib/a.cpp", 13));
+  ASSERT_FALSE(changed(changes, "/repo/lib/a.cpp", 14));
+
+  ASSERT_TRUE(changed(changes, "/repo/lib/a.cpp", 31));
+  ASSERT_TRUE(changed(changes, "/repo/lib/a.cpp", 32));
+  ASSERT_FALSE(changed(changes, "/repo/lib/a.cpp", 33));
+
+  ASSERT_EQ(nullptr, changes.changesOf("/repo/gone.cpp"));
+}
+
+TEST(ChangedLines, parsesListOfLines) {
+  auto changes = ChangedLines::parse("# changed by hand\n"
+                                     "./src/b.cpp:7\n"
+                                     "src/c.cpp:3-5\n"
+                                     "src/d.cpp\n");
+
+  ASSERT_TRUE(changed(changes, "/repo/src/b.cpp", 7));
+  ASSERT_FALSE(changed(changes, "/repo/src/b.cpp", 8));
+  ASSERT_FALSE(changed(changes, "/repo/src/c.cpp", 2));
+  ASSERT_TRUE(changed(changes, "/repo/src/c.cpp", 3));
+  ASSERT_TRUE(changed(changes, "/repo/src/c.cpp", 5));
+  ASSERT_FALSE(changed(changes, "/repo/src/c.cpp", 6));
+  ASSERT_TRUE(changed(changes, "/repo/src/d.cpp", 1000));
+}
+
+TEST(ChangedLines, matchesTheEndOfFullPaths) {
+  ChangedLines changes;
+  changes.addLine("lib/a.cpp", 1);
+
+  ASSERT_NE(nullptr, changes.changesOf("lib/a.cpp"));
+  ASSERT_NE(nullptr, changes.changesOf("/home/user/repo/lib/a.cpp"));
+  ASSERT_EQ(nullptr, changes.changesOf("/home/user/repo/otherlib/a.cpp"));
+  ASSERT_EQ(nullptr, changes.changesOf("/home/user/repo/lib/b.cpp"));
+
+  ASSERT_TRUE(changes.touches(SourceLocation("/", "/x/lib/a.cpp", 20, 1)));
+  ASSERT_FALSE(changes.contains(SourceLocation("/", "/x/lib/a.cpp", 20, 1)));
+  ASSERT_FALSE(changes.touches(SourceLocation::nullSourceLocation()));
+}
@@ -32,3 +32,29 @@ TEST(Compiler, CompileModule) {
 
   ASSERT_NE(nullptr, binary.getBinary());
 }
+
+TEST(Compiler, CompileModuleInParts) {
+  InitializeNativeTarget();
+  InitializeNativeTargetAsmPrinter();
+  InitializeNativeTargetAsmParser();
+
+  Compiler compiler;
+
+  LLVMContext llvmContext;
+  ModuleLoader loader;
+  auto module = loader.loadModuleAtPath(
+      fixtures::simple_test_count_letters_test_count_letters_bc_path(),
+      llvmContext);
+  auto parts = compiler.compileModuleInParts(
+      *module->getModule(), 2, []() -> TargetMachine & {
+        static thread_local std::unique_ptr<TargetMachine> machine(
+            EngineBuilder().selectTarget(Triple(), "", "",
+                                         SmallVector<std::string, 1>()));
+        return *machine;
+      });
+
+  ASSERT_EQ(2u, parts.size());
+  for (auto &part : parts) {
+    ASSERT_NE(nullptr, part.getBinary());
+  }
+}
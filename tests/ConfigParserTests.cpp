@@ -211,6 +211,19 @@ TEST_F(ConfigParserTestFixture, loadConfig_Timeout_SpecificValue) {
   ASSERT_EQ(15, config.getTimeout());
 }
 
+TEST_F(ConfigParserTestFixture, loadConfig_OutputLimit_Unspecified) {
+  configWithYamlContent("");
+  ASSERT_EQ(MullDefaultOutputLimitBytes, config.getOutputLimit());
+  ASSERT_FALSE(config.shouldDropPassedOutput());
+}
+
+TEST_F(ConfigParserTestFixture, loadConfig_OutputLimit_SpecificValue) {
+  configWithYamlContent("output_limit: 4096\n"
+                        "drop_passed_output: yes\n");
+  ASSERT_EQ(4096, config.getOutputLimit());
+  ASSERT_TRUE(config.shouldDropPassedOutput());
+}
+
 TEST_F(ConfigParserTestFixture, loadConfig_DryRun_Unspecified) {
   configWithYamlContent("");
   ASSERT_FALSE(config.dryRunModeEnabled());
@@ -528,4 +541,503 @@ parallelization:
 
   ASSERT_EQ(12, parallelization.mutantExecutionWorkers);
   ASSERT_EQ(14, parallelization.testExecutionWorkers);
+  ASSERT_EQ(1, parallelization.childrenPerWorker);
+}
+
+TEST_F(ConfigParserTestFixture, loadConfig_parallelization_childrenPerWorker) {
+  const char *configYAML = R"YAML(
+parallelization:
+  mutant_execution_workers: 2
+  children_per_worker: 8
+  )YAML";
+  configWithYamlContent(configYAML);
+
+  ASSERT_EQ(8, config.parallelization().childrenPerWorker);
+}
+
+TEST_F(ConfigParserTestFixture, loadConfig_parallelization_autoTune) {
+  configWithYamlContent("parallelization:\n"
+                        "  workers: 8\n");
+  ASSERT_FALSE(config.parallelization().autoTune);
+
+  configWithYamlContent("parallelization:\n"
+                        "  workers: 8\n"
+                        "  auto_tune: true\n");
+  ASSERT_TRUE(config.parallelization().autoTune);
+}
+
+TEST_F(ConfigParserTestFixture, loadConfig_parallelization_workerProcesses) {
+  configWithYamlContent("parallelization:\n"
+                        "  workers: 8\n");
+  ASSERT_EQ(1, config.parallelization().workerProcesses);
+
+  configWithYamlContent("parallelization:\n"
+                        "  workers: 8\n"
+                        "  worker_processes: 4\n");
+  ASSERT_EQ(4, config.parallelization().workerProcesses);
+}
+
+TEST_F(ConfigParserTestFixture,
+       loadConfig_parallelization_junkDetectionProcesses) {
+  configWithYamlContent("parallelization:\n"
+                        "  workers: 8\n");
+  ASSERT_EQ(0, config.parallelization().junkDetectionProcesses);
+
+  configWithYamlContent("parallelization:\n"
+                        "  workers: 8\n"
+                        "  junk_detection_processes: 6\n");
+  ASSERT_EQ(6, config.parallelization().junkDetectionProcesses);
+}
+
+TEST_F(ConfigParserTestFixture, loadConfig_hashAlgorithm) {
+  configWithYamlContent("cache_size_limit: 1");
+  ASSERT_EQ(HashAlgorithm::MD5, config.getHashAlgorithm());
+
+  configWithYamlContent("hash_algorithm: xxhash64");
+  ASSERT_EQ(HashAlgorithm::XXHash64, config.getHashAlgorithm());
+}
+
+TEST_F(ConfigParserTestFixture, loadConfig_codegenOptLevel) {
+  configWithYamlContent("cache_size_limit: 1");
+  ASSERT_EQ(2, config.getCodegenOptLevel());
+
+  configWithYamlContent("codegen_opt_level: 0");
+  ASSERT_EQ(0, config.getCodegenOptLevel());
+}
+
+TEST_F(ConfigParserTestFixture, loadConfig_sqliteWriters) {
+  configWithYamlContent("cache_size_limit: 1");
+  ASSERT_EQ(1, config.getSQLiteWriters());
+
+  configWithYamlContent("sqlite_writers: 4");
+  ASSERT_EQ(4, config.getSQLiteWriters());
+}
+
+TEST_F(ConfigParserTestFixture, loadConfig_mutantDebugInfo) {
+  configWithYamlContent("cache_size_limit: 1");
+  ASSERT_EQ(MutantDebugInfo::Full, config.getMutantDebugInfo());
+
+  configWithYamlContent("mutant_debug_info: line_tables");
+  ASSERT_EQ(MutantDebugInfo::LineTables, config.getMutantDebugInfo());
+
+  configWithYamlContent("mutant_debug_info: none");
+  ASSERT_EQ(MutantDebugInfo::None, config.getMutantDebugInfo());
+}
+
+TEST_F(ConfigParserTestFixture, loadConfig_timeoutPolicy) {
+  configWithYamlContent("cache_size_limit: 1");
+  ASSERT_EQ(1, config.getTimeoutPolicy().runs);
+  ASSERT_EQ(10, config.getTimeoutPolicy().multiplier);
+  ASSERT_EQ(0, config.getTimeoutPolicy().ceiling);
+
+  const char *configYAML = "timeout_policy:\n"
+                           "  runs: 5\n"
+                           "  deviations: 4\n"
+                           "  multiplier: 2\n"
+                           "  floor: 100\n"
+                           "  ceiling: 20000\n";
+  configWithYamlContent(configYAML);
+  auto &policy = config.getTimeoutPolicy();
+  ASSERT_EQ(5, policy.runs);
+  ASSERT_EQ(4, policy.deviations);
+  ASSERT_EQ(2, policy.multiplier);
+  ASSERT_EQ(100, policy.floor);
+  ASSERT_EQ(20000, policy.ceiling);
+
+  configWithYamlContent("bitcode_file_list: /tmp/non-existing-file-12345.txt\n"
+                        "timeout_policy:\n"
+                        "  floor: 100\n"
+                        "  ceiling: 50\n");
+  ASSERT_EQ(2U, config.validate().size());
+}
+
+TEST_F(ConfigParserTestFixture, loadConfig_constructorTemplate) {
+  configWithYamlContent("fork: batch\n");
+  ASSERT_FALSE(config.constructorTemplateEnabled());
+
+  configWithYamlContent("fork: batch\n"
+                        "constructor_template: enabled\n");
+  ASSERT_TRUE(config.constructorTemplateEnabled());
+}
+
+TEST_F(ConfigParserTestFixture, loadConfig_freshGlobalsTests) {
+  configWithYamlContent("fork: batch\n");
+  ASSERT_TRUE(config.getFreshGlobalsTests().empty());
+
+  configWithYamlContent("fork: batch\n"
+                        "constructor_template: enabled\n"
+                        "fresh_globals_tests:\n"
+                        "  - Registry.StartsEmpty\n"
+                        "  - Singleton.IsCreatedOnce\n");
+  ASSERT_EQ(std::vector<std::string>(
+                {"Registry.StartsEmpty", "Singleton.IsCreatedOnce"}),
+            config.getFreshGlobalsTests());
+}
+
+TEST_F(ConfigParserTestFixture, loadConfig_directTestRun) {
+  configWithYamlContent("fork: true\n");
+  ASSERT_FALSE(config.directTestRunEnabled());
+
+  configWithYamlContent("direct_test_run: enabled\n");
+  ASSERT_TRUE(config.directTestRunEnabled());
+}
+
+TEST_F(ConfigParserTestFixture, loadConfig_releaseIR) {
+  configWithYamlContent("fork: true\n");
+  ASSERT_FALSE(config.releaseIREnabled());
+
+  configWithYamlContent("release_ir: true\n");
+  ASSERT_TRUE(config.releaseIREnabled());
+}
+
+TEST_F(ConfigParserTestFixture, loadConfig_jitHugePages) {
+  configWithYamlContent("fork: true\n");
+  ASSERT_FALSE(config.jitHugePagesEnabled());
+
+  configWithYamlContent("jit_huge_pages: true\n");
+  ASSERT_TRUE(config.jitHugePagesEnabled());
+}
+
+TEST_F(ConfigParserTestFixture, loadConfig_blockCoverage) {
+  configWithYamlContent("fork: true\n");
+  ASSERT_FALSE(config.blockCoverageEnabled());
+
+  configWithYamlContent("block_coverage: true\n");
+  ASSERT_TRUE(config.blockCoverageEnabled());
+}
+
+TEST_F(ConfigParserTestFixture, loadConfig_boundedCallTree) {
+  configWithYamlContent("fork: true\n");
+  ASSERT_FALSE(config.boundedCallTreeEnabled());
+
+  configWithYamlContent("bounded_call_tree: true\n");
+  ASSERT_TRUE(config.boundedCallTreeEnabled());
+}
+
+TEST_F(ConfigParserTestFixture, loadConfig_perfCounters) {
+  configWithYamlContent("fork: true\n");
+  ASSERT_FALSE(config.perfCountersEnabled());
+
+  configWithYamlContent("perf_counters: true\n");
+  ASSERT_TRUE(config.perfCountersEnabled());
+}
+
+TEST_F(ConfigParserTestFixture, loadConfig_directCalls) {
+  configWithYamlContent("fork: true\n");
+  ASSERT_FALSE(config.directCallsEnabled());
+
+  configWithYamlContent("direct_calls: true\n");
+  ASSERT_TRUE(config.directCallsEnabled());
+}
+
+TEST_F(ConfigParserTestFixture, loadConfig_stopOnSurvivor) {
+  configWithYamlContent("fork: true\n");
+  ASSERT_FALSE(config.stopOnSurvivorEnabled());
+  ASSERT_EQ(0, config.getDeadline());
+
+  configWithYamlContent("stop_on_survivor: true\n"
+                        "deadline: 600\n");
+  ASSERT_TRUE(config.stopOnSurvivorEnabled());
+  ASSERT_EQ(600, config.getDeadline());
+}
+
+TEST_F(ConfigParserTestFixture, loadConfig_staticReachability) {
+  configWithYamlContent("fork: true\n");
+  ASSERT_FALSE(config.staticReachabilityEnabled());
+
+  configWithYamlContent("static_reachability: true\n"
+                        "max_distance: 3\n");
+  ASSERT_TRUE(config.staticReachabilityEnabled());
+  ASSERT_EQ(3, config.getMaxDistance());
+  ASSERT_EQ(0, config.getReachabilitySamplePeriod());
+
+  configWithYamlContent("reachability_sample_period: 20000\n");
+  ASSERT_EQ(20000, config.getReachabilitySamplePeriod());
+}
+
+TEST_F(ConfigParserTestFixture, loadConfig_incrementalRun) {
+  configWithYamlContent("fork: true\n");
+  ASSERT_EQ("", config.getChangedLines());
+  ASSERT_EQ("", config.getPreviousResults());
+
+  configWithYamlContent("changed_lines: /tmp/changes.diff\n"
+                        "previous_results: /tmp/previous.sqlite\n");
+  ASSERT_EQ("/tmp/changes.diff", config.getChangedLines());
+  ASSERT_EQ("/tmp/previous.sqlite", config.getPreviousResults());
+}
+
+TEST_F(ConfigParserTestFixture, loadConfig_resume) {
+  configWithYamlContent("fork: true\n");
+  ASSERT_EQ("", config.getResume());
+
+  configWithYamlContent("resume: /tmp/interrupted.sqlite\n");
+  ASSERT_EQ("/tmp/interrupted.sqlite", config.getResume());
+}
+
+TEST_F(ConfigParserTestFixture, loadConfig_killMatrix) {
+  configWithYamlContent("fork: true\n");
+  ASSERT_EQ("", config.getKillMatrix());
+
+  configWithYamlContent("kill_matrix: /tmp/kill.matrix\n");
+  ASSERT_EQ("/tmp/kill.matrix", config.getKillMatrix());
+}
+
+TEST_F(ConfigParserTestFixture, loadConfig_minimizedTests) {
+  configWithYamlContent("fork: true\n");
+  ASSERT_EQ("", config.getMinimizedTests());
+
+  configWithYamlContent("minimized_tests: /tmp/minimized.yaml\n");
+  ASSERT_EQ("/tmp/minimized.yaml", config.getMinimizedTests());
+}
+
+TEST_F(ConfigParserTestFixture, loadConfig_metricsEndpoint) {
+  configWithYamlContent("fork: true\n");
+  ASSERT_EQ("", config.getMetricsEndpoint());
+
+  configWithYamlContent("metrics_endpoint: \":9464\"\n");
+  ASSERT_EQ(":9464", config.getMetricsEndpoint());
+}
+
+TEST_F(ConfigParserTestFixture, loadConfig_reachabilityCache) {
+  configWithYamlContent("fork: true\n");
+  ASSERT_FALSE(config.reachabilityCacheEnabled());
+
+  configWithYamlContent("reachability_cache: enabled\n");
+  ASSERT_TRUE(config.reachabilityCacheEnabled());
+}
+
+TEST_F(ConfigParserTestFixture, loadConfig_programLibrary) {
+  configWithYamlContent("fork: true\n");
+  ASSERT_FALSE(config.programLibraryEnabled());
+
+  configWithYamlContent("program_library: true\n");
+  ASSERT_TRUE(config.programLibraryEnabled());
+}
+
+TEST_F(ConfigParserTestFixture, loadConfig_parallelJIT) {
+  configWithYamlContent("fork: true\n");
+  ASSERT_FALSE(config.parallelJITEnabled());
+
+  configWithYamlContent("parallel_jit: true\n");
+  ASSERT_TRUE(config.parallelJITEnabled());
+}
+
+TEST_F(ConfigParserTestFixture, loadConfig_mutationSearchCache) {
+  configWithYamlContent("fork: true\n");
+  ASSERT_FALSE(config.mutationSearchCacheEnabled());
+
+  configWithYamlContent("mutation_search_cache: true\n");
+  ASSERT_TRUE(config.mutationSearchCacheEnabled());
+}
+
+TEST_F(ConfigParserTestFixture, loadConfig_testSearchCache) {
+  configWithYamlContent("fork: true\n");
+  ASSERT_FALSE(config.testSearchCacheEnabled());
+
+  configWithYamlContent("test_search_cache: true\n");
+  ASSERT_TRUE(config.testSearchCacheEnabled());
+}
+
+TEST_F(ConfigParserTestFixture, loadConfig_equivalentMutantPruning) {
+  configWithYamlContent("fork: true\n");
+  ASSERT_FALSE(config.equivalentMutantPruningEnabled());
+
+  configWithYamlContent("equivalent_mutant_pruning: true\n");
+  ASSERT_TRUE(config.equivalentMutantPruningEnabled());
+}
+
+TEST_F(ConfigParserTestFixture, loadConfig_sampling) {
+  configWithYamlContent("fork: true\n");
+  ASSERT_EQ(SamplingStrategy::None, config.getSampling().strategy);
+
+  configWithYamlContent("sampling:\n"
+                        "  strategy: per_file\n"
+                        "  size: 200\n"
+                        "  seed: 7\n");
+  auto &sampling = config.getSampling();
+  ASSERT_EQ(SamplingStrategy::PerFile, sampling.strategy);
+  ASSERT_EQ(200, sampling.size);
+  ASSERT_EQ(7, sampling.seed);
+  ASSERT_EQ(0, sampling.budget);
+
+  configWithYamlContent("bitcode_file_list: /tmp/non-existing-file-12345.txt\n"
+                        "sampling:\n"
+                        "  strategy: time_budget\n");
+  ASSERT_EQ(2U, config.validate().size());
+}
+
+TEST_F(ConfigParserTestFixture, loadConfig_testOrder) {
+  configWithYamlContent("fork: true\n");
+  ASSERT_EQ(TestOrder::Discovery, config.getTestOrder());
+
+  configWithYamlContent("test_order: kill_rate\n");
+  ASSERT_EQ(TestOrder::KillRate, config.getTestOrder());
+}
+
+TEST_F(ConfigParserTestFixture, loadConfig_mutantOrder) {
+  configWithYamlContent("fork: true\n");
+  ASSERT_EQ(MutantOrder::LongestFirst, config.getMutantOrder());
+
+  configWithYamlContent("mutant_order: feedback\n");
+  ASSERT_EQ(MutantOrder::Feedback, config.getMutantOrder());
+}
+
+TEST_F(ConfigParserTestFixture, loadConfig_batchKillSize) {
+  configWithYamlContent("fork: true\n");
+  ASSERT_EQ(0, config.getBatchKillSize());
+
+  configWithYamlContent("batch_kill_size: 8\n");
+  ASSERT_EQ(8, config.getBatchKillSize());
+
+  configWithYamlContent("bitcode_file_list: /tmp/non-existing-file-12345.txt\n"
+                        "batch_kill_size: -1\n");
+  ASSERT_EQ(2U, config.validate().size());
+}
+
+TEST_F(ConfigParserTestFixture, loadConfig_originalTestBatchSize) {
+  configWithYamlContent("fork: true\n");
+  ASSERT_EQ(0, config.getOriginalTestBatchSize());
+
+  configWithYamlContent("original_test_batch_size: 64\n");
+  ASSERT_EQ(64, config.getOriginalTestBatchSize());
+
+  configWithYamlContent("bitcode_file_list: /tmp/non-existing-file-12345.txt\n"
+                        "original_test_batch_size: -1\n");
+  ASSERT_EQ(2U, config.validate().size());
+}
+
+TEST_F(ConfigParserTestFixture, loadConfig_loopBudget) {
+  configWithYamlContent("fork: true\n");
+  ASSERT_EQ(0, config.getLoopBudget());
+
+  configWithYamlContent("loop_budget: 100\n");
+  ASSERT_EQ(100, config.getLoopBudget());
+
+  configWithYamlContent("bitcode_file_list: /tmp/non-existing-file-12345.txt\n"
+                        "loop_budget: -1\n");
+  ASSERT_EQ(2U, config.validate().size());
+}
+
+TEST_F(ConfigParserTestFixture, loadConfig_stallTimeout) {
+  configWithYamlContent("fork: true\n");
+  ASSERT_EQ(0, config.getStallTimeout());
+
+  configWithYamlContent("stall_timeout: 500\n");
+  ASSERT_EQ(500, config.getStallTimeout());
+
+  configWithYamlContent("bitcode_file_list: /tmp/non-existing-file-12345.txt\n"
+                        "stall_timeout: -1\n");
+  ASSERT_EQ(2U, config.validate().size());
+}
+
+TEST_F(ConfigParserTestFixture, loadConfig_flakyRuns) {
+  configWithYamlContent("fork: true\n");
+  ASSERT_EQ(0, config.getFlakyRuns());
+
+  configWithYamlContent("flaky_runs: 4\n");
+  ASSERT_EQ(4, config.getFlakyRuns());
+
+  configWithYamlContent("bitcode_file_list: /tmp/non-existing-file-12345.txt\n"
+                        "flaky_runs: -1\n");
+  ASSERT_EQ(2U, config.validate().size());
+}
+
+TEST_F(ConfigParserTestFixture, loadConfig_distributed) {
+  configWithYamlContent("fork: true\n");
+  ASSERT_EQ(DistributedRole::None, config.getDistributed().role);
+
+  configWithYamlContent("distributed:\n"
+                        "  role: worker\n"
+                        "  directory: /shared/mull\n"
+                        "  chunk: 4\n");
+  auto &distributed = config.getDistributed();
+  ASSERT_EQ(DistributedRole::Worker, distributed.role);
+  ASSERT_EQ("/shared/mull", distributed.directory);
+  ASSERT_EQ(4, distributed.chunk);
+  ASSERT_EQ(300, distributed.lease);
+
+  configWithYamlContent("bitcode_file_list: /tmp/non-existing-file-12345.txt\n"
+                        "distributed:\n"
+                        "  role: coordinator\n");
+  ASSERT_EQ(2U, config.validate().size());
+}
+
+TEST_F(ConfigParserTestFixture, loadConfig_childResources) {
+  configWithYamlContent("fork: true\n");
+  ASSERT_EQ(0, config.getChildResources().addressSpace);
+  ASSERT_TRUE(config.getChildResources().cgroupRoot.empty());
+
+  configWithYamlContent("child_resources:\n"
+                        "  address_space: 2048\n"
+                        "  cpu_time: 60\n"
+                        "  open_files: 256\n"
+                        "  cgroup_root: /sys/fs/cgroup/mull\n"
+                        "  cgroup_memory: 4096\n"
+                        "  cgroup_cpu: 100\n"
+                        "  memory_budget: 16384\n");
+  auto &resources = config.getChildResources();
+  ASSERT_EQ(2048, resources.addressSpace);
+  ASSERT_EQ(60, resources.cpuTime);
+  ASSERT_EQ(256, resources.openFiles);
+  ASSERT_EQ("/sys/fs/cgroup/mull", resources.cgroupRoot);
+  ASSERT_EQ(4096, resources.cgroupMemory);
+  ASSERT_EQ(100, resources.cgroupCPU);
+  ASSERT_EQ(16384, resources.memoryBudget);
+
+  configWithYamlContent("bitcode_file_list: /tmp/non-existing-file-12345.txt\n"
+                        "child_resources:\n"
+                        "  cgroup_memory: 4096\n");
+  ASSERT_EQ(2U, config.validate().size());
+
+  configWithYamlContent("bitcode_file_list: /tmp/non-existing-file-12345.txt\n"
+                        "child_resources:\n"
+                        "  cpu_time: -1\n");
+  ASSERT_EQ(2U, config.validate().size());
+}
+
+TEST_F(ConfigParserTestFixture, loadConfig_heap) {
+  configWithYamlContent("fork: true\n");
+  ASSERT_EQ(0, config.getHeap().arenas);
+  ASSERT_FALSE(config.getHeap().trim);
+
+  configWithYamlContent("heap:\n"
+                        "  arenas: 4\n"
+                        "  trim: true\n");
+  ASSERT_EQ(4, config.getHeap().arenas);
+  ASSERT_TRUE(config.getHeap().trim);
+
+  configWithYamlContent("bitcode_file_list: /tmp/non-existing-file-12345.txt\n"
+                        "heap:\n"
+                        "  arenas: -1\n");
+  ASSERT_EQ(2U, config.validate().size());
+}
+
+TEST_F(ConfigParserTestFixture, loadConfig_resultMemoryBudget) {
+  configWithYamlContent("fork: true\n");
+  ASSERT_EQ(0, config.getResultMemoryBudget());
+
+  configWithYamlContent("result_memory_budget: 512\n");
+  ASSERT_EQ(512, config.getResultMemoryBudget());
+
+  configWithYamlContent("bitcode_file_list: /tmp/non-existing-file-12345.txt\n"
+                        "result_memory_budget: -1\n");
+  ASSERT_EQ(2U, config.validate().size());
+}
+
+TEST_F(ConfigParserTestFixture, loadConfig_shard) {
+  configWithYamlContent("fork: true\n");
+  ASSERT_EQ(0, config.getShard().index);
+  ASSERT_EQ(1, config.getShard().count);
+
+  configWithYamlContent("shard:\n"
+                        "  index: 2\n"
+                        "  count: 4\n");
+  ASSERT_EQ(2, config.getShard().index);
+  ASSERT_EQ(4, config.getShard().count);
+
+  configWithYamlContent("bitcode_file_list: /tmp/non-existing-file-12345.txt\n"
+                        "shard:\n"
+                        "  index: 4\n"
+                        "  count: 4\n");
+  ASSERT_EQ(2U, config.validate().size());
 }
@@ -0,0 +1,100 @@
+#include "mull/CostEstimate.h"
+
+#include "mull/Mutators/MathSubMutator.h"
+#include "mull/TestFrameworks/Test.h"
+
+#include "MutationPointsFixture.h"
+
+#include "gtest/gtest.h"
+
+using namespace mull;
+using namespace llvm;
+
+static const int64_t Millisecond = 1000000;
+
+class CostEstimateTest : public MutationPointsFixture {
+protected:
+  MutationPoint *addPoint(Mutator &pointMutator, const char *file) {
+    return MutationPointsFixture::addPoint(pointMutator, "mutated",
+                                           SourceLocation("/", file, 1, 1));
+  }
+
+  /// A test whose original runs took the given milliseconds
+  mull::Test *addTest(std::vector<int64_t> runningTimes) {
+    tests.push_back(
+        make_unique<mull::Test>("test", "mull", "mull",
+                                std::vector<std::string>(), nullptr));
+    for (auto time : runningTimes) {
+      tests.back()->addRunningTime(time * Millisecond);
+    }
+    return tests.back().get();
+  }
+
+  MathAddMutator addMutator;
+  MathSubMutator subMutator;
+  std::vector<std::unique_ptr<mull::Test>> tests;
+};
+
+TEST_F(CostEstimateTest, addsTheSandboxToTheMeanOfTheRuns) {
+  CostModel model(2 * Millisecond, 1.5, false);
+  ASSERT_EQ(17 * Millisecond, model.testCost(*addTest({8, 12})));
+
+  ExecutionResult result;
+  result.runningTime = 4;
+  auto unmeasured = addTest({});
+  unmeasured->setExecutionResult(result);
+  ASSERT_EQ(8 * Millisecond, model.testCost(*unmeasured));
+}
+
+TEST_F(CostEstimateTest, failFastStopsAtTheFirstTest) {
+  auto point = addPoint(addMutator, "a.cpp");
+  point->addReachableTest(addTest({10}), 1);
+  point->addReachableTest(addTest({30}), 1);
+
+  auto all = CostModel(0, 1, false).mutantCost(*point);
+  ASSERT_EQ(40 * Millisecond, all.least);
+  ASSERT_EQ(40 * Millisecond, all.most);
+
+  auto failFast = CostModel(0, 1, true).mutantCost(*point);
+  ASSERT_EQ(10 * Millisecond, failFast.least);
+  ASSERT_EQ(40 * Millisecond, failFast.most);
+}
+
+TEST_F(CostEstimateTest, splitsTheCostByFileAndMutator) {
+  auto cheap = addTest({10});
+  auto expensive = addTest({100});
+  addPoint(addMutator, "a.cpp")->addReachableTest(cheap, 1);
+  addPoint(subMutator, "a.cpp")->addReachableTest(cheap, 1);
+  addPoint(addMutator, "b.cpp")->addReachableTest(expensive, 1);
+  addPoint(subMutator, "b.cpp");
+
+  auto estimate = estimateCost(CostModel(0, 1, false), allPoints(), 2);
+  ASSERT_EQ(4U, estimate.overall.mutants);
+  ASSERT_EQ(120 * Millisecond, estimate.overall.cost.most);
+  ASSERT_EQ(60 * Millisecond, estimate.wallTime(estimate.overall).most);
+
+  ASSERT_EQ(2U, estimate.files.size());
+  ASSERT_EQ("b.cpp", estimate.files[0].name);
+  ASSERT_EQ(100 * Millisecond, estimate.files[0].cost.most);
+  ASSERT_EQ("a.cpp", estimate.files[1].name);
+  ASSERT_EQ(2U, estimate.files[1].mutants);
+
+  ASSERT_EQ(2U, estimate.mutators.size());
+  ASSERT_EQ(addMutator.getUniqueIdentifier(), estimate.mutators[0].name);
+  ASSERT_EQ(110 * Millisecond, estimate.mutators[0].cost.most);
+}
+
+TEST_F(CostEstimateTest, movesFromTheEstimateToTheObservedRate) {
+  const int64_t second = 1000 * Millisecond;
+  ASSERT_EQ(100 * second, remainingTime(100 * second, 0, 0, 10));
+  ASSERT_EQ(0, remainingTime(100 * second, 50 * second, 10, 10));
+  /// Halfway through at half the estimated pace: 50s predicted, 100s seen
+  ASSERT_EQ(75 * second, remainingTime(100 * second, 100 * second, 5, 10));
+}
+
+TEST(CostEstimate, formatsDurations) {
+  ASSERT_EQ("250ms", formatDuration(250 * Millisecond));
+  ASSERT_EQ("12s", formatDuration(12500 * Millisecond));
+  ASSERT_EQ("3m05s", formatDuration(185000 * Millisecond));
+  ASSERT_EQ("1h02m", formatDuration(3720000 * Millisecond));
+}
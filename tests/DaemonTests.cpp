@@ -0,0 +1,95 @@
+#include "mull/Daemon.h"
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <thread>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace mull;
+using namespace llvm;
+
+TEST(DaemonRequest, readsTheTestsAndTheFiles) {
+  DaemonRequest request;
+  std::string error;
+  ASSERT_TRUE(DaemonRequest::parse("test first test\n"
+                                   "test second\n"
+                                   "\n"
+                                   "file src/parser.cpp\n"
+                                   "exclude glob:third_party/**\n",
+                                   request, error));
+  ASSERT_EQ(std::vector<std::string>({"first test", "second"}),
+            request.tests);
+  ASSERT_NE(nullptr, request.files.changesOf("/home/project/src/parser.cpp"));
+  ASSERT_EQ(nullptr, request.files.changesOf("/home/project/src/lexer.cpp"));
+  ASSERT_EQ(std::vector<std::string>({"glob:third_party/**"}),
+            request.excludedLocations);
+  ASSERT_FALSE(request.stop);
+}
+
+TEST(DaemonRequest, rejectsWhatItDoesNotKnow) {
+  DaemonRequest request;
+  std::string error;
+  ASSERT_FALSE(DaemonRequest::parse("mutant 42\n", request, error));
+  ASSERT_FALSE(error.empty());
+  ASSERT_FALSE(DaemonRequest::parse("test\n", request, error));
+  ASSERT_FALSE(DaemonRequest::parse("exclude regex:([\n", request, error));
+}
+
+static std::string request(const std::string &socketPath,
+                           const std::string &text) {
+  sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+  int client = socket(AF_UNIX, SOCK_STREAM, 0);
+  EXPECT_EQ(0, connect(client, reinterpret_cast<sockaddr *>(&address),
+                       sizeof(address)));
+  EXPECT_EQ(ssize_t(text.size()), write(client, text.data(), text.size()));
+  shutdown(client, SHUT_WR);
+
+  std::string response;
+  char buffer[256];
+  ssize_t count = 0;
+  while ((count = read(client, buffer, sizeof(buffer))) > 0) {
+    response.append(buffer, size_t(count));
+  }
+  close(client);
+  return response;
+}
+
+TEST(Daemon, runsEveryRequestInAChild) {
+  SmallString<128> directory;
+  ASSERT_FALSE(sys::fs::createUniqueDirectory("mull-daemon", directory));
+  std::string socketPath = std::string(directory.str()) + "/socket";
+  Daemon daemon(socketPath);
+  ASSERT_TRUE(daemon.listen());
+
+  int runs = 0;
+  std::thread server([&]() {
+    daemon.serve([&](const DaemonRequest &request) {
+      runs++;
+      llvm::outs() << "runs " << runs << ", tests " << request.tests.size()
+                   << "\n";
+      return 3;
+    });
+  });
+
+  ASSERT_EQ("runs 1, tests 2\nmull-daemon: exit 3\n",
+            request(socketPath, "test a\ntest b\n"));
+  /// The second run does not see what the first one changed
+  ASSERT_EQ("runs 1, tests 0\nmull-daemon: exit 3\n",
+            request(socketPath, "\n"));
+  ASSERT_EQ("mull-daemon: unknown request 'mutant 1'\nmull-daemon: exit 1\n",
+            request(socketPath, "mutant 1\n"));
+  ASSERT_EQ("mull-daemon: exit 0\n", request(socketPath, "stop\n"));
+  server.join();
+  ASSERT_EQ(0, runs);
+}
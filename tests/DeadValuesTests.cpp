@@ -0,0 +1,97 @@
+#include "mull/DeadValues.h"
+
+#include <llvm/AsmParser/Parser.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/SourceMgr.h>
+
+#include "gtest/gtest.h"
+
+using namespace mull;
+using namespace llvm;
+
+static const char *const Functions =
+    "declare void @use(i32)\n"
+    "define i32 @returned(i32 %a) {\n"
+    "  %value = add i32 %a, 1\n"
+    "  ret i32 %value\n"
+    "}\n"
+    "define void @unused(i32 %a) {\n"
+    "  %value = add i32 %a, 1\n"
+    "  %twice = mul i32 %value, 2\n"
+    "  ret void\n"
+    "}\n"
+    "define void @passed(i32 %a) {\n"
+    "  %value = add i32 %a, 1\n"
+    "  call void @use(i32 %value)\n"
+    "  ret void\n"
+    "}\n"
+    "define void @divided(i32 %a) {\n"
+    "  %value = sdiv i32 %a, 3\n"
+    "  ret void\n"
+    "}\n"
+    "define i32 @stored(i32 %a) {\n"
+    "  %read = alloca i32\n"
+    "  %unread = alloca i32\n"
+    "  %value = add i32 %a, 1\n"
+    "  store i32 %value, i32* %unread\n"
+    "  store i32 %a, i32* %read\n"
+    "  %loaded = load i32, i32* %read\n"
+    "  ret i32 %loaded\n"
+    "}\n";
+
+static Instruction &named(Module &module, StringRef function, StringRef name) {
+  for (auto &instruction : instructions(module.getFunction(function))) {
+    if (instruction.getName() == name) {
+      return instruction;
+    }
+  }
+  llvm_unreachable("No such instruction");
+}
+
+static StoreInst &storeInto(Module &module, StringRef function,
+                            StringRef variable) {
+  for (auto &instruction : instructions(module.getFunction(function))) {
+    auto store = dyn_cast<StoreInst>(&instruction);
+    if (store && store->getPointerOperand()->getName() == variable) {
+      return *store;
+    }
+  }
+  llvm_unreachable("No such store");
+}
+
+TEST(DeadValues, ValuesAreObservedThroughSideEffectsAndReturns) {
+  LLVMContext context;
+  SMDiagnostic error;
+  auto module = parseAssemblyString(Functions, error, context);
+  ASSERT_NE(nullptr, module);
+
+  ASSERT_TRUE(isObservable(named(*module, "returned", "value")));
+  ASSERT_TRUE(isObservable(named(*module, "passed", "value")));
+  ASSERT_FALSE(isObservable(named(*module, "unused", "value")));
+  ASSERT_FALSE(isObservable(named(*module, "unused", "twice")));
+}
+
+TEST(DeadValues, InstructionsThatMayTrapAreObserved) {
+  LLVMContext context;
+  SMDiagnostic error;
+  auto module = parseAssemblyString(Functions, error, context);
+  ASSERT_NE(nullptr, module);
+
+  ASSERT_TRUE(isObservable(named(*module, "divided", "value")));
+}
+
+TEST(DeadValues, StoresIntoVariablesNeverReadAreDead) {
+  LLVMContext context;
+  SMDiagnostic error;
+  auto module = parseAssemblyString(Functions, error, context);
+  ASSERT_NE(nullptr, module);
+
+  ASSERT_TRUE(isDeadStore(storeInto(*module, "stored", "unread")));
+  ASSERT_FALSE(isDeadStore(storeInto(*module, "stored", "read")));
+  ASSERT_FALSE(isObservable(storeInto(*module, "stored", "unread")));
+  ASSERT_FALSE(isObservable(named(*module, "stored", "value")));
+  ASSERT_TRUE(isObservable(storeInto(*module, "stored", "read")));
+}
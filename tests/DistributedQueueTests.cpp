@@ -0,0 +1,137 @@
+#include "mull/Parallelization/DistributedQueue.h"
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+
+#include "gtest/gtest.h"
+
+#include <sys/time.h>
+
+using namespace mull;
+using namespace llvm;
+
+static std::string createQueueDirectory() {
+  SmallString<128> directory;
+  auto error = sys::fs::createUniqueDirectory("mull-distributed", directory);
+  EXPECT_FALSE(error);
+  return std::string(directory.str());
+}
+
+static bool anyChunk(size_t) { return true; }
+
+TEST(DistributedQueue, workersSeeTheChunksOfTheCoordinator) {
+  auto directory = createQueueDirectory();
+  DistributedQueue coordinator(directory, 60);
+  coordinator.clear();
+  ASSERT_TRUE(coordinator.publish({"a", "b", "c", "d", "e"}, 2));
+
+  DistributedQueue worker(directory, 60);
+  ASSERT_TRUE(worker.subscribe(0));
+  std::vector<std::vector<std::string>> expected(
+      {{"a", "b"}, {"c", "d"}, {"e"}});
+  ASSERT_EQ(expected, coordinator.getChunks());
+  ASSERT_EQ(expected, worker.getChunks());
+}
+
+TEST(DistributedQueue, doesNotWaitForever) {
+  auto directory = createQueueDirectory();
+  DistributedQueue worker(directory, 60);
+  ASSERT_FALSE(worker.subscribe(0));
+}
+
+TEST(DistributedQueue, everyChunkIsClaimedOnce) {
+  auto directory = createQueueDirectory();
+  DistributedQueue coordinator(directory, 60);
+  ASSERT_TRUE(coordinator.publish({"a", "b", "c"}, 2));
+  DistributedQueue worker(directory, 60);
+  ASSERT_TRUE(worker.subscribe(0));
+
+  size_t first = 0;
+  size_t second = 0;
+  size_t third = 0;
+  ASSERT_TRUE(coordinator.claim(first, anyChunk));
+  ASSERT_TRUE(worker.claim(second, anyChunk));
+  ASSERT_FALSE(worker.claim(third, anyChunk));
+  ASSERT_EQ(0U, first);
+  ASSERT_EQ(1U, second);
+
+  ASSERT_FALSE(coordinator.finished());
+  ASSERT_TRUE(coordinator.complete(first, {}));
+  ASSERT_TRUE(worker.complete(second, {}));
+  ASSERT_TRUE(coordinator.finished());
+  ASSERT_TRUE(coordinator.completedHere(0));
+  ASSERT_FALSE(coordinator.completedHere(1));
+}
+
+TEST(DistributedQueue, skipsTheChunksTheNodeCannotRun) {
+  auto directory = createQueueDirectory();
+  DistributedQueue queue(directory, 60);
+  ASSERT_TRUE(queue.publish({"a", "b"}, 1));
+
+  auto runnable = [](size_t index) { return index == 1; };
+  size_t chunk = 0;
+  ASSERT_TRUE(queue.claim(chunk, runnable));
+  ASSERT_EQ(1U, chunk);
+  ASSERT_FALSE(queue.claim(chunk, runnable));
+}
+
+TEST(DistributedQueue, claimsTheChunksOfGoneNodesAgain) {
+  auto directory = createQueueDirectory();
+  DistributedQueue coordinator(directory, 60);
+  ASSERT_TRUE(coordinator.publish({"a"}, 1));
+  DistributedQueue worker(directory, 60);
+  ASSERT_TRUE(worker.subscribe(0));
+
+  size_t chunk = 0;
+  ASSERT_TRUE(worker.claim(chunk, anyChunk));
+  ASSERT_FALSE(coordinator.claim(chunk, anyChunk));
+
+  /// The worker last reported progress two minutes ago
+  struct timeval times[2];
+  gettimeofday(&times[0], nullptr);
+  times[0].tv_sec -= 120;
+  times[1] = times[0];
+  ASSERT_EQ(0, utimes((directory + "/claims/0").c_str(), times));
+
+  ASSERT_TRUE(coordinator.claim(chunk, anyChunk));
+  ASSERT_EQ(0U, chunk);
+}
+
+TEST(DistributedQueue, readsTheResultsBack) {
+  auto directory = createQueueDirectory();
+  DistributedQueue coordinator(directory, 60);
+  ASSERT_TRUE(coordinator.publish({"a", "b"}, 2));
+  DistributedQueue worker(directory, 60);
+  ASSERT_TRUE(worker.subscribe(0));
+
+  size_t chunk = 0;
+  ASSERT_TRUE(worker.claim(chunk, anyChunk));
+  StoredMutationResult passed;
+  passed.mutant = "a";
+  passed.test = "test one";
+  passed.result.status = Passed;
+  passed.result.runningTime = 12;
+  passed.result.stdoutOutput = "line\nanother line\n";
+  StoredMutationResult failed;
+  failed.mutant = "b";
+  failed.test = "test two";
+  failed.result.status = Failed;
+  failed.result.runningTime = 34;
+  failed.result.stderrOutput = "1 2 3";
+  ASSERT_TRUE(worker.complete(chunk, {passed, failed}));
+
+  std::vector<StoredMutationResult> results;
+  ASSERT_TRUE(coordinator.readResults(chunk, results));
+  ASSERT_EQ(2U, results.size());
+  ASSERT_EQ("a", results[0].mutant);
+  ASSERT_EQ("test one", results[0].test);
+  ASSERT_EQ(Passed, results[0].result.status);
+  ASSERT_EQ(12, results[0].result.runningTime);
+  ASSERT_TRUE(results[0].result.stdoutOutput == "line\nanother line\n");
+  ASSERT_TRUE(results[0].result.stderrOutput.empty());
+  ASSERT_EQ("b", results[1].mutant);
+  ASSERT_EQ("test two", results[1].test);
+  ASSERT_EQ(Failed, results[1].result.status);
+  ASSERT_EQ(34, results[1].result.runningTime);
+  ASSERT_TRUE(results[1].result.stderrOutput == "1 2 3");
+}
@@ -9,6 +9,7 @@
 #include "mull/ModuleLoader.h"
 #include "mull/MutationsFinder.h"
 #include "mull/Mutators/AndOrReplacementMutator.h"
+#include "mull/Mutators/ConditionalsBoundaryMutator.h"
 #include "mull/Mutators/MathAddMutator.h"
 #include "mull/Mutators/MathDivMutator.h"
 #include "mull/Mutators/MathMulMutator.h"
@@ -19,12 +20,14 @@
 #include "mull/Mutators/ReplaceAssignmentMutator.h"
 #include "mull/ObjectLoader.h"
 #include "mull/Program/Program.h"
+#include "mull/Reporters/Reporter.h"
 #include "mull/Result.h"
 #include "mull/TestFrameworks/TestFrameworkFactory.h"
 #include "mull/Toolchain/Mangler.h"
 #include "mull/Toolchain/Toolchain.h"
 
 #include <functional>
+#include <mutex>
 
 #include <llvm/ADT/SmallString.h>
 #include <llvm/ADT/Twine.h>
@@ -32,6 +35,7 @@
 #include <llvm/IR/Module.h>
 #include <llvm/Support/Casting.h>
 #include <llvm/Support/Debug.h>
+#include <llvm/Support/FileSystem.h>
 #include <llvm/Support/MemoryBuffer.h>
 #include <llvm/Support/SourceMgr.h>
 #include <llvm/Support/YAMLParser.h>
@@ -106,19 +110,275 @@ TEST(Driver, SimpleTest_MathAddMutator) {
   auto result = Driver.Run();
   ASSERT_EQ(1u, result->getTests().size());
 
-  auto firstResult = result->getMutationResults().begin()->get();
+  auto firstResult = result->getMutationResults()[0];
 
   ASSERT_EQ(ExecutionStatus::Passed,
-            firstResult->getTest()->getExecutionResult().status);
-  ASSERT_EQ("test_count_letters", firstResult->getTest()->getTestName());
+            firstResult.getTest()->getExecutionResult().status);
+  ASSERT_EQ("test_count_letters", firstResult.getTest()->getTestName());
 
   auto &mutants = result->getMutationResults();
   ASSERT_EQ(1u, mutants.size());
 
-  auto firstMutant = mutants.begin()->get();
-  ASSERT_EQ(ExecutionStatus::Failed, firstMutant->getExecutionResult().status);
+  auto firstMutant = mutants[0];
+  ASSERT_EQ(ExecutionStatus::Failed, firstMutant.getExecutionResult().status);
 
-  ASSERT_NE(nullptr, firstMutant->getMutationPoint());
+  ASSERT_NE(nullptr, firstMutant.getMutationPoint());
+}
+
+/// Records the events of the run in the order they come in
+class RecordingReporter : public Reporter {
+public:
+  void reportResults(const Result &result, const RawConfig &config,
+                     const Metrics &metrics) override {}
+  void reportMutationResult(const MutationResult &result) override {
+    std::lock_guard<std::mutex> lock(mutex);
+    events.push_back("mutant");
+  }
+  void reportTestResult(const mull::Test &test) override {
+    std::lock_guard<std::mutex> lock(mutex);
+    events.push_back("test " + test.getTestName());
+  }
+  void reportPhaseEnd(RunPhase phase) override {
+    std::lock_guard<std::mutex> lock(mutex);
+    events.push_back("end " + std::to_string(int(phase)));
+  }
+
+  std::mutex mutex;
+  std::vector<std::string> events;
+};
+
+TEST(Driver, SimpleTest_MathAddMutator_Streaming) {
+  Configuration configuration;
+  configuration.bitcodePaths = {
+      fixtures::simple_test_count_letters_test_count_letters_bc_path(),
+      fixtures::simple_test_count_letters_count_letters_bc_path()};
+  configuration.forkEnabled = false;
+
+  ModuleLoader loader;
+  Program program({}, {}, loader.loadModules(configuration));
+
+  std::vector<std::unique_ptr<Mutator>> mutators;
+  mutators.emplace_back(make_unique<MathAddMutator>());
+  MutationsFinder finder(std::move(mutators), configuration);
+
+  Toolchain toolchain(configuration);
+  Filter filter;
+  Metrics metrics;
+  NullJunkDetector junkDetector;
+
+  TestFrameworkFactory testFrameworkFactory;
+  TestFramework testFramework(
+      testFrameworkFactory.simpleTestFramework(toolchain, configuration));
+
+  Driver Driver(configuration, program, testFramework, toolchain, filter,
+                finder, metrics, junkDetector);
+  RecordingReporter reporter;
+  Driver.streamResultsTo(reporter);
+
+  auto result = Driver.Run();
+  ASSERT_EQ(1u, result->getMutationResults().size());
+
+  std::vector<std::string> expected(
+      {"test test_count_letters",
+       "end " + std::to_string(int(RunPhase::OriginalTests)),
+       "end " + std::to_string(int(RunPhase::MutationSearch)), "mutant",
+       "end " + std::to_string(int(RunPhase::MutantExecution))});
+  ASSERT_EQ(expected, reporter.events);
+}
+
+TEST(Driver, SimpleTest_MathAddMutator_Schemata) {
+  Configuration configuration;
+  configuration.bitcodePaths = {
+      fixtures::simple_test_count_letters_test_count_letters_bc_path(),
+      fixtures::simple_test_count_letters_count_letters_bc_path()};
+  configuration.forkEnabled = false;
+  configuration.mutantSchemataEnabled = true;
+
+  ModuleLoader loader;
+  Program program({}, {}, loader.loadModules(configuration));
+
+  std::vector<std::unique_ptr<Mutator>> mutators;
+  mutators.emplace_back(make_unique<MathAddMutator>());
+  MutationsFinder finder(std::move(mutators), configuration);
+
+  Toolchain toolchain(configuration);
+  Filter filter;
+  Metrics metrics;
+  NullJunkDetector junkDetector;
+
+  TestFrameworkFactory testFrameworkFactory;
+  TestFramework testFramework(
+      testFrameworkFactory.simpleTestFramework(toolchain, configuration));
+
+  Driver Driver(configuration, program, testFramework, toolchain, filter,
+                finder, metrics, junkDetector);
+
+  /// The same outcome as with trampolines: the mutant is activated through
+  /// the schema of its function
+  auto result = Driver.Run();
+  ASSERT_EQ(1u, result->getTests().size());
+
+  auto &mutants = result->getMutationResults();
+  ASSERT_EQ(1u, mutants.size());
+
+  auto firstMutant = mutants[0];
+  ASSERT_EQ(ExecutionStatus::Failed, firstMutant.getExecutionResult().status);
+  ASSERT_EQ(1, firstMutant.getMutationPoint()->getSchemaIndex());
+}
+
+TEST(Driver, SimpleTest_MathAddMutator_SharedProgram) {
+  Configuration configuration;
+  configuration.bitcodePaths = {
+      fixtures::simple_test_count_letters_test_count_letters_bc_path(),
+      fixtures::simple_test_count_letters_count_letters_bc_path()};
+  configuration.forkEnabled = true;
+  configuration.sharedProgramEnabled = true;
+  configuration.parallelization.mutantExecutionWorkers = 2;
+
+  ModuleLoader loader;
+  Program program({}, {}, loader.loadModules(configuration));
+
+  std::vector<std::unique_ptr<Mutator>> mutators;
+  mutators.emplace_back(make_unique<MathAddMutator>());
+  MutationsFinder finder(std::move(mutators), configuration);
+
+  Toolchain toolchain(configuration);
+  Filter filter;
+  Metrics metrics;
+  NullJunkDetector junkDetector;
+
+  TestFrameworkFactory testFrameworkFactory;
+  TestFramework testFramework(
+      testFrameworkFactory.simpleTestFramework(toolchain, configuration));
+
+  Driver Driver(configuration, program, testFramework, toolchain, filter,
+                finder, metrics, junkDetector);
+
+  /// The mutant is activated in the forked process only, the program loaded
+  /// once for all the workers keeps running the original code
+  auto result = Driver.Run();
+  ASSERT_EQ(1u, result->getTests().size());
+
+  auto &mutants = result->getMutationResults();
+  ASSERT_EQ(1u, mutants.size());
+
+  auto firstMutant = mutants[0];
+  ASSERT_EQ(ExecutionStatus::Failed, firstMutant.getExecutionResult().status);
+}
+
+TEST(Driver, SimpleTest_MathAddMutator_InlineInstrumentation) {
+  Configuration configuration;
+  configuration.bitcodePaths = {
+      fixtures::simple_test_count_letters_test_count_letters_bc_path(),
+      fixtures::simple_test_count_letters_count_letters_bc_path()};
+  configuration.forkEnabled = false;
+  configuration.inlineInstrumentationEnabled = true;
+
+  ModuleLoader loader;
+  Program program({}, {}, loader.loadModules(configuration));
+
+  std::vector<std::unique_ptr<Mutator>> mutators;
+  mutators.emplace_back(make_unique<MathAddMutator>());
+  MutationsFinder finder(std::move(mutators), configuration);
+
+  Toolchain toolchain(configuration);
+  Filter filter;
+  Metrics metrics;
+  NullJunkDetector junkDetector;
+
+  TestFrameworkFactory testFrameworkFactory;
+  TestFramework testFramework(
+      testFrameworkFactory.simpleTestFramework(toolchain, configuration));
+
+  Driver Driver(configuration, program, testFramework, toolchain, filter,
+                finder, metrics, junkDetector);
+
+  /// The call tree recorded by the inline code reaches the same testee
+  auto result = Driver.Run();
+  ASSERT_EQ(1u, result->getTests().size());
+
+  auto &mutants = result->getMutationResults();
+  ASSERT_EQ(1u, mutants.size());
+
+  auto firstMutant = mutants[0];
+  ASSERT_EQ(ExecutionStatus::Failed, firstMutant.getExecutionResult().status);
+}
+
+TEST(Driver, SimpleTest_MathAddMutator_CoverageInstrumentation) {
+  Configuration configuration;
+  configuration.bitcodePaths = {
+      fixtures::simple_test_count_letters_test_count_letters_bc_path(),
+      fixtures::simple_test_count_letters_count_letters_bc_path()};
+  configuration.forkEnabled = false;
+  configuration.coverageInstrumentationEnabled = true;
+
+  ModuleLoader loader;
+  Program program({}, {}, loader.loadModules(configuration));
+
+  std::vector<std::unique_ptr<Mutator>> mutators;
+  mutators.emplace_back(make_unique<MathAddMutator>());
+  MutationsFinder finder(std::move(mutators), configuration);
+
+  Toolchain toolchain(configuration);
+  Filter filter;
+  Metrics metrics;
+  NullJunkDetector junkDetector;
+
+  TestFrameworkFactory testFrameworkFactory;
+  TestFramework testFramework(
+      testFrameworkFactory.simpleTestFramework(toolchain, configuration));
+
+  Driver Driver(configuration, program, testFramework, toolchain, filter,
+                finder, metrics, junkDetector);
+
+  /// Without the call tree the testee is found through the coverage bitmap
+  auto result = Driver.Run();
+  ASSERT_EQ(1u, result->getTests().size());
+
+  auto &mutants = result->getMutationResults();
+  ASSERT_EQ(1u, mutants.size());
+
+  auto firstMutant = mutants[0];
+  ASSERT_EQ(ExecutionStatus::Failed, firstMutant.getExecutionResult().status);
+}
+
+TEST(Driver, SimpleTest_MathAddMutator_GuardedInstrumentation) {
+  Configuration configuration;
+  configuration.bitcodePaths = {
+      fixtures::simple_test_count_letters_test_count_letters_bc_path(),
+      fixtures::simple_test_count_letters_count_letters_bc_path()};
+  configuration.forkEnabled = false;
+  configuration.guardedInstrumentationEnabled = true;
+
+  ModuleLoader loader;
+  Program program({}, {}, loader.loadModules(configuration));
+
+  std::vector<std::unique_ptr<Mutator>> mutators;
+  mutators.emplace_back(make_unique<MathAddMutator>());
+  MutationsFinder finder(std::move(mutators), configuration);
+
+  Toolchain toolchain(configuration);
+  Filter filter;
+  Metrics metrics;
+  NullJunkDetector junkDetector;
+
+  TestFrameworkFactory testFrameworkFactory;
+  TestFramework testFramework(
+      testFrameworkFactory.simpleTestFramework(toolchain, configuration));
+
+  Driver Driver(configuration, program, testFramework, toolchain, filter,
+                finder, metrics, junkDetector);
+
+  /// The mutant runs the instrumented test module with the instrumentation
+  /// off, only the mutated module is compiled again
+  auto result = Driver.Run();
+  ASSERT_EQ(1u, result->getTests().size());
+
+  auto &mutants = result->getMutationResults();
+  ASSERT_EQ(1u, mutants.size());
+
+  auto firstMutant = mutants[0];
+  ASSERT_EQ(ExecutionStatus::Failed, firstMutant.getExecutionResult().status);
 }
 
 TEST(Driver, SimpleTest_MathSubMutator) {
@@ -158,19 +418,19 @@ TEST(Driver, SimpleTest_MathSubMutator) {
   auto result = Driver.Run();
   ASSERT_EQ(1u, result->getTests().size());
 
-  auto firstResult = result->getMutationResults().begin()->get();
+  auto firstResult = result->getMutationResults()[0];
 
   ASSERT_EQ(ExecutionStatus::Passed,
-            firstResult->getTest()->getExecutionResult().status);
-  ASSERT_EQ("test_math_sub", firstResult->getTest()->getTestName());
+            firstResult.getTest()->getExecutionResult().status);
+  ASSERT_EQ("test_math_sub", firstResult.getTest()->getTestName());
 
   auto &mutants = result->getMutationResults();
   ASSERT_EQ(1u, mutants.size());
 
-  auto firstMutant = mutants.begin()->get();
-  ASSERT_EQ(ExecutionStatus::Failed, firstMutant->getExecutionResult().status);
+  auto firstMutant = mutants[0];
+  ASSERT_EQ(ExecutionStatus::Failed, firstMutant.getExecutionResult().status);
 
-  ASSERT_NE(nullptr, firstMutant->getMutationPoint());
+  ASSERT_NE(nullptr, firstMutant.getMutationPoint());
 }
 
 TEST(Driver, SimpleTest_MathMulMutator) {
@@ -210,18 +470,18 @@ TEST(Driver, SimpleTest_MathMulMutator) {
   auto result = Driver.Run();
   ASSERT_EQ(1u, result->getTests().size());
 
-  auto firstResult = result->getMutationResults().begin()->get();
+  auto firstResult = result->getMutationResults()[0];
   ASSERT_EQ(ExecutionStatus::Passed,
-            firstResult->getTest()->getExecutionResult().status);
-  ASSERT_EQ("test_math_mul", firstResult->getTest()->getTestName());
+            firstResult.getTest()->getExecutionResult().status);
+  ASSERT_EQ("test_math_mul", firstResult.getTest()->getTestName());
 
   auto &mutants = result->getMutationResults();
   ASSERT_EQ(1u, mutants.size());
 
-  auto firstMutant = mutants.begin()->get();
-  ASSERT_EQ(ExecutionStatus::Failed, firstMutant->getExecutionResult().status);
+  auto firstMutant = mutants[0];
+  ASSERT_EQ(ExecutionStatus::Failed, firstMutant.getExecutionResult().status);
 
-  ASSERT_NE(nullptr, firstMutant->getMutationPoint());
+  ASSERT_NE(nullptr, firstMutant.getMutationPoint());
 }
 
 TEST(Driver, SimpleTest_MathDivMutator) {
@@ -261,18 +521,18 @@ TEST(Driver, SimpleTest_MathDivMutator) {
   auto result = Driver.Run();
   ASSERT_EQ(1u, result->getTests().size());
 
-  auto firstResult = result->getMutationResults().begin()->get();
+  auto firstResult = result->getMutationResults()[0];
   ASSERT_EQ(ExecutionStatus::Passed,
-            firstResult->getTest()->getExecutionResult().status);
-  ASSERT_EQ("test_math_div", firstResult->getTest()->getTestName());
+            firstResult.getTest()->getExecutionResult().status);
+  ASSERT_EQ("test_math_div", firstResult.getTest()->getTestName());
 
   auto &mutants = result->getMutationResults();
   ASSERT_EQ(1u, mutants.size());
 
-  auto firstMutant = mutants.begin()->get();
-  ASSERT_EQ(ExecutionStatus::Failed, firstMutant->getExecutionResult().status);
+  auto firstMutant = mutants[0];
+  ASSERT_EQ(ExecutionStatus::Failed, firstMutant.getExecutionResult().status);
 
-  ASSERT_NE(nullptr, firstMutant->getMutationPoint());
+  ASSERT_NE(nullptr, firstMutant.getMutationPoint());
 }
 
 TEST(Driver, SimpleTest_NegateConditionMutator) {
@@ -314,18 +574,18 @@ TEST(Driver, SimpleTest_NegateConditionMutator) {
   auto result = Driver.Run();
   ASSERT_EQ(1u, result->getTests().size());
 
-  auto firstResult = result->getMutationResults().begin()->get();
+  auto firstResult = result->getMutationResults()[0];
   ASSERT_EQ(ExecutionStatus::Passed,
-            firstResult->getTest()->getExecutionResult().status);
-  ASSERT_EQ("test_max", firstResult->getTest()->getTestName());
+            firstResult.getTest()->getExecutionResult().status);
+  ASSERT_EQ("test_max", firstResult.getTest()->getTestName());
 
   auto &mutants = result->getMutationResults();
   ASSERT_EQ(1u, mutants.size());
 
-  auto firstMutant = mutants.begin()->get();
-  ASSERT_EQ(ExecutionStatus::Failed, firstMutant->getExecutionResult().status);
+  auto firstMutant = mutants[0];
+  ASSERT_EQ(ExecutionStatus::Failed, firstMutant.getExecutionResult().status);
 
-  ASSERT_NE(nullptr, firstMutant->getMutationPoint());
+  ASSERT_NE(nullptr, firstMutant.getMutationPoint());
 }
 
 TEST(Driver, SimpleTest_RemoveVoidFunctionMutator) {
@@ -360,19 +620,19 @@ TEST(Driver, SimpleTest_RemoveVoidFunctionMutator) {
   auto result = Driver.Run();
   ASSERT_EQ(1u, result->getTests().size());
 
-  auto firstResult = result->getMutationResults().begin()->get();
+  auto firstResult = result->getMutationResults()[0];
   ASSERT_EQ(ExecutionStatus::Passed,
-            firstResult->getTest()->getExecutionResult().status);
+            firstResult.getTest()->getExecutionResult().status);
   ASSERT_EQ("test_func_with_a_void_function_inside",
-            firstResult->getTest()->getTestName());
+            firstResult.getTest()->getTestName());
 
   auto &mutants = result->getMutationResults();
   ASSERT_EQ(1u, mutants.size());
 
-  auto firstMutant = mutants.begin()->get();
-  ASSERT_EQ(ExecutionStatus::Failed, firstMutant->getExecutionResult().status);
+  auto firstMutant = mutants[0];
+  ASSERT_EQ(ExecutionStatus::Failed, firstMutant.getExecutionResult().status);
 
-  ASSERT_NE(nullptr, firstMutant->getMutationPoint());
+  ASSERT_NE(nullptr, firstMutant.getMutationPoint());
 }
 
 TEST(Driver, SimpleTest_ANDORReplacementMutator) {
@@ -406,170 +666,170 @@ TEST(Driver, SimpleTest_ANDORReplacementMutator) {
 
   /// Mutation #1: AND operator with 2 branches.
   {
-    auto mutant = (mutants++)->get();
+    auto mutant = *mutants++;
     ASSERT_EQ(ExecutionStatus::Passed,
-              mutant->getTest()->getExecutionResult().status);
-    ASSERT_EQ("test_AND_operator_2branches", mutant->getTest()->getTestName());
-    ASSERT_EQ(ExecutionStatus::Failed, mutant->getExecutionResult().status);
+              mutant.getTest()->getExecutionResult().status);
+    ASSERT_EQ("test_AND_operator_2branches", mutant.getTest()->getTestName());
+    ASSERT_EQ(ExecutionStatus::Failed, mutant.getExecutionResult().status);
   }
 
   /// Mutation #2: AND operator with 1 branch.
   {
-    auto mutant = (mutants++)->get();
+    auto mutant = *mutants++;
     ASSERT_EQ(ExecutionStatus::Passed,
-              mutant->getTest()->getExecutionResult().status);
-    ASSERT_EQ("test_AND_operator_1branch", mutant->getTest()->getTestName());
-    ASSERT_EQ(ExecutionStatus::Failed, mutant->getExecutionResult().status);
+              mutant.getTest()->getExecutionResult().status);
+    ASSERT_EQ("test_AND_operator_1branch", mutant.getTest()->getTestName());
+    ASSERT_EQ(ExecutionStatus::Failed, mutant.getExecutionResult().status);
   }
 
   /// Mutation #3: OR operator with 2 branches.
   {
-    auto mutant = (mutants++)->get();
+    auto mutant = *mutants++;
     ASSERT_EQ(ExecutionStatus::Passed,
-              mutant->getTest()->getExecutionResult().status);
-    ASSERT_EQ("test_OR_operator_2branches", mutant->getTest()->getTestName());
-    ASSERT_EQ(ExecutionStatus::Failed, mutant->getExecutionResult().status);
+              mutant.getTest()->getExecutionResult().status);
+    ASSERT_EQ("test_OR_operator_2branches", mutant.getTest()->getTestName());
+    ASSERT_EQ(ExecutionStatus::Failed, mutant.getExecutionResult().status);
   }
 
   /// Mutation #4: OR operator with 1 branch.
   {
-    auto mutant4 = (mutants++)->get();
+    auto mutant4 = *mutants++;
     ASSERT_EQ(ExecutionStatus::Passed,
-              mutant4->getTest()->getExecutionResult().status);
-    ASSERT_EQ("test_OR_operator_1branch", mutant4->getTest()->getTestName());
-    ASSERT_EQ(ExecutionStatus::Failed, mutant4->getExecutionResult().status);
+              mutant4.getTest()->getExecutionResult().status);
+    ASSERT_EQ("test_OR_operator_1branch", mutant4.getTest()->getTestName());
+    ASSERT_EQ(ExecutionStatus::Failed, mutant4.getExecutionResult().status);
   }
 
   /// Mutation #5: Compound AND then OR expression.
   {
     // Mutant 5.1 should pass because it is a relaxing AND -> OR replacement.
-    auto mutant5_1 = (mutants++)->get();
+    auto mutant5_1 = *mutants++;
     ASSERT_EQ(ExecutionStatus::Passed,
-              mutant5_1->getTest()->getExecutionResult().status);
+              mutant5_1.getTest()->getExecutionResult().status);
     ASSERT_EQ("test_compound_AND_then_OR_operator",
-              mutant5_1->getTest()->getTestName());
-    ASSERT_EQ(ExecutionStatus::Passed, mutant5_1->getExecutionResult().status);
+              mutant5_1.getTest()->getTestName());
+    ASSERT_EQ(ExecutionStatus::Passed, mutant5_1.getExecutionResult().status);
 
     // Mutant 5.2 should pass because it is a stressing OR -> AND replacement.
-    auto mutant5_2 = (mutants++)->get();
+    auto mutant5_2 = *mutants++;
     ASSERT_EQ(ExecutionStatus::Passed,
-              mutant5_2->getTest()->getExecutionResult().status);
+              mutant5_2.getTest()->getExecutionResult().status);
     ASSERT_EQ("test_compound_AND_then_OR_operator",
-              mutant5_2->getTest()->getTestName());
-    ASSERT_EQ(ExecutionStatus::Failed, mutant5_2->getExecutionResult().status);
+              mutant5_2.getTest()->getTestName());
+    ASSERT_EQ(ExecutionStatus::Failed, mutant5_2.getExecutionResult().status);
   }
 
   /// Mutation #6: Compound AND then AND expression.
   {
-    auto mutant6_1 = (mutants++)->get();
+    auto mutant6_1 = *mutants++;
     ASSERT_EQ(ExecutionStatus::Passed,
-              mutant6_1->getTest()->getExecutionResult().status);
+              mutant6_1.getTest()->getExecutionResult().status);
     ASSERT_EQ("test_compound_AND_then_AND_operator",
-              mutant6_1->getTest()->getTestName());
-    ASSERT_EQ(ExecutionStatus::Failed, mutant6_1->getExecutionResult().status);
+              mutant6_1.getTest()->getTestName());
+    ASSERT_EQ(ExecutionStatus::Failed, mutant6_1.getExecutionResult().status);
 
-    auto mutant6_2 = (mutants++)->get();
+    auto mutant6_2 = *mutants++;
     ASSERT_EQ(ExecutionStatus::Passed,
-              mutant6_2->getTest()->getExecutionResult().status);
+              mutant6_2.getTest()->getExecutionResult().status);
     ASSERT_EQ("test_compound_AND_then_AND_operator",
-              mutant6_2->getTest()->getTestName());
-    ASSERT_EQ(ExecutionStatus::Passed, mutant6_2->getExecutionResult().status);
+              mutant6_2.getTest()->getTestName());
+    ASSERT_EQ(ExecutionStatus::Passed, mutant6_2.getExecutionResult().status);
   }
 
   /// Mutation #7: Compound OR then AND expression.
   {
-    auto mutant7_1 = (mutants++)->get();
+    auto mutant7_1 = *mutants++;
     ASSERT_EQ(ExecutionStatus::Passed,
-              mutant7_1->getTest()->getExecutionResult().status);
+              mutant7_1.getTest()->getExecutionResult().status);
     ASSERT_EQ("test_compound_OR_then_AND_operator",
-              mutant7_1->getTest()->getTestName());
-    ASSERT_EQ(ExecutionStatus::Failed, mutant7_1->getExecutionResult().status);
+              mutant7_1.getTest()->getTestName());
+    ASSERT_EQ(ExecutionStatus::Failed, mutant7_1.getExecutionResult().status);
 
-    auto mutant7_2 = (mutants++)->get();
+    auto mutant7_2 = *mutants++;
     ASSERT_EQ(ExecutionStatus::Passed,
-              mutant7_2->getTest()->getExecutionResult().status);
+              mutant7_2.getTest()->getExecutionResult().status);
     ASSERT_EQ("test_compound_OR_then_AND_operator",
-              mutant7_2->getTest()->getTestName());
-    ASSERT_EQ(ExecutionStatus::Passed, mutant7_2->getExecutionResult().status);
+              mutant7_2.getTest()->getTestName());
+    ASSERT_EQ(ExecutionStatus::Passed, mutant7_2.getExecutionResult().status);
   }
 
   /// Mutation #8: Compound OR then OR expression.
   {
-    auto mutant8_1 = (mutants++)->get();
+    auto mutant8_1 = *mutants++;
     ASSERT_EQ(ExecutionStatus::Passed,
-              mutant8_1->getTest()->getExecutionResult().status);
+              mutant8_1.getTest()->getExecutionResult().status);
     ASSERT_EQ("test_compound_OR_then_OR_operator",
-              mutant8_1->getTest()->getTestName());
-    ASSERT_EQ(ExecutionStatus::Failed, mutant8_1->getExecutionResult().status);
+              mutant8_1.getTest()->getTestName());
+    ASSERT_EQ(ExecutionStatus::Failed, mutant8_1.getExecutionResult().status);
 
-    auto mutant8_2 = (mutants++)->get();
+    auto mutant8_2 = *mutants++;
     ASSERT_EQ(ExecutionStatus::Passed,
-              mutant8_2->getTest()->getExecutionResult().status);
+              mutant8_2.getTest()->getExecutionResult().status);
     ASSERT_EQ("test_compound_OR_then_OR_operator",
-              mutant8_2->getTest()->getTestName());
-    ASSERT_EQ(ExecutionStatus::Passed, mutant8_2->getExecutionResult().status);
+              mutant8_2.getTest()->getTestName());
+    ASSERT_EQ(ExecutionStatus::Passed, mutant8_2.getExecutionResult().status);
   }
 
   /// Edge case for Pattern #1: OR expression that always evaluates to a scalar
   /// value but also contains a dummy function call (presence of a dummy
   /// function makes the Branch instruction to be generated).
   {
-    auto mutant1 = (mutants++)->get();
+    auto mutant1 = *mutants++;
     ASSERT_EQ(ExecutionStatus::Passed,
-              mutant1->getTest()->getExecutionResult().status);
+              mutant1.getTest()->getExecutionResult().status);
     ASSERT_EQ("test_OR_operator_always_scalars_case_with_function_call_pattern1",
-              mutant1->getTest()->getTestName());
-    ASSERT_EQ(ExecutionStatus::Passed, mutant1->getExecutionResult().status);
+              mutant1.getTest()->getTestName());
+    ASSERT_EQ(ExecutionStatus::Passed, mutant1.getExecutionResult().status);
 
-    auto mutant2 = (mutants++)->get();
+    auto mutant2 = *mutants++;
     ASSERT_EQ(ExecutionStatus::Passed,
-              mutant2->getTest()->getExecutionResult().status);
+              mutant2.getTest()->getExecutionResult().status);
     ASSERT_EQ("test_OR_operator_always_scalars_case_with_function_call_pattern1",
-              mutant2->getTest()->getTestName());
-    ASSERT_EQ(ExecutionStatus::Passed, mutant2->getExecutionResult().status);
+              mutant2.getTest()->getTestName());
+    ASSERT_EQ(ExecutionStatus::Passed, mutant2.getExecutionResult().status);
   }
 
   /// Edge case for Pattern #3: OR expression that always evaluates to a scalar
   /// value but also contains a dummy function call (presence of a dummy
   /// function makes the Branch instruction to be generated).
   {
-    auto mutant = (mutants++)->get();
+    auto mutant = *mutants++;
     ASSERT_EQ(ExecutionStatus::Passed,
-              mutant->getTest()->getExecutionResult().status);
+              mutant.getTest()->getExecutionResult().status);
     ASSERT_EQ("test_OR_operator_always_scalars_case_with_function_call_pattern3",
-              mutant->getTest()->getTestName());
-    ASSERT_EQ(ExecutionStatus::Passed, mutant->getExecutionResult().status);
+              mutant.getTest()->getTestName());
+    ASSERT_EQ(ExecutionStatus::Passed, mutant.getExecutionResult().status);
   }
 
   /// Edge case for Pattern #1: AND expression that always evaluates to a scalar
   /// value but also contains a dummy function call (presence of a dummy
   /// function makes the Branch instruction to be generated).
   {
-    auto mutant1 = (mutants++)->get();
+    auto mutant1 = *mutants++;
     ASSERT_EQ(ExecutionStatus::Passed,
-              mutant1->getTest()->getExecutionResult().status);
+              mutant1.getTest()->getExecutionResult().status);
     ASSERT_EQ("test_AND_operator_always_scalars_case_with_function_call_pattern1",
-              mutant1->getTest()->getTestName());
-    ASSERT_EQ(ExecutionStatus::Passed, mutant1->getExecutionResult().status);
+              mutant1.getTest()->getTestName());
+    ASSERT_EQ(ExecutionStatus::Passed, mutant1.getExecutionResult().status);
 
-    auto mutant2 = (mutants++)->get();
+    auto mutant2 = *mutants++;
     ASSERT_EQ(ExecutionStatus::Passed,
-              mutant2->getTest()->getExecutionResult().status);
+              mutant2.getTest()->getExecutionResult().status);
     ASSERT_EQ("test_AND_operator_always_scalars_case_with_function_call_pattern1",
-              mutant2->getTest()->getTestName());
-    ASSERT_EQ(ExecutionStatus::Passed, mutant2->getExecutionResult().status);
+              mutant2.getTest()->getTestName());
+    ASSERT_EQ(ExecutionStatus::Passed, mutant2.getExecutionResult().status);
   }
 
   /// Edge case for Pattern #3: AND expression that always evaluates to a scalar
   /// value but also contains a dummy function call (presence of a dummy
   /// function makes the Branch instruction to be generated).
   {
-    auto mutant = (mutants++)->get();
+    auto mutant = *mutants++;
     ASSERT_EQ(ExecutionStatus::Passed,
-              mutant->getTest()->getExecutionResult().status);
+              mutant.getTest()->getExecutionResult().status);
     ASSERT_EQ("test_AND_operator_always_scalars_case_with_function_call_pattern3",
-              mutant->getTest()->getTestName());
-    ASSERT_EQ(ExecutionStatus::Passed, mutant->getExecutionResult().status);
+              mutant.getTest()->getTestName());
+    ASSERT_EQ(ExecutionStatus::Passed, mutant.getExecutionResult().status);
   }
 
   ASSERT_EQ(mutants, result->getMutationResults().end());
@@ -606,62 +866,62 @@ TEST(Driver, SimpleTest_ANDORReplacementMutator_CPP) {
 
   /// Mutation #1: OR operator
   {
-    auto mutant1 = (mutants++)->get();
+    auto mutant1 = *mutants++;
     ASSERT_EQ(ExecutionStatus::Passed,
-              mutant1->getTest()->getExecutionResult().status);
+              mutant1.getTest()->getExecutionResult().status);
     ASSERT_EQ("_Z25test_OR_operator_with_CPPv",
-              mutant1->getTest()->getTestName());
-    ASSERT_EQ(ExecutionStatus::Failed, mutant1->getExecutionResult().status);
+              mutant1.getTest()->getTestName());
+    ASSERT_EQ(ExecutionStatus::Failed, mutant1.getExecutionResult().status);
   }
 
   /// Mutation #2: OR operator (PHI case)
   {
-    auto mutant2 = (mutants++)->get();
+    auto mutant2 = *mutants++;
     ASSERT_EQ(ExecutionStatus::Passed,
-              mutant2->getTest()->getExecutionResult().status);
+              mutant2.getTest()->getExecutionResult().status);
     ASSERT_EQ("_Z34test_OR_operator_with_CPP_PHI_casev",
-              mutant2->getTest()->getTestName());
-    ASSERT_EQ(ExecutionStatus::Failed, mutant2->getExecutionResult().status);
+              mutant2.getTest()->getTestName());
+    ASSERT_EQ(ExecutionStatus::Failed, mutant2.getExecutionResult().status);
   }
 
   /// Mutation #3: OR operator (Assert)
   {
-    auto mutant3 = (mutants++)->get();
+    auto mutant3 = *mutants++;
     ASSERT_EQ(ExecutionStatus::Passed,
-              mutant3->getTest()->getExecutionResult().status);
+              mutant3.getTest()->getExecutionResult().status);
     ASSERT_EQ("_Z36test_OR_operator_with_CPP_and_assertv",
-              mutant3->getTest()->getTestName());
-    ASSERT_EQ(ExecutionStatus::Crashed, mutant3->getExecutionResult().status);
+              mutant3.getTest()->getTestName());
+    ASSERT_EQ(ExecutionStatus::Crashed, mutant3.getExecutionResult().status);
   }
 
   /// Mutation #4: AND operator
   {
-    auto mutant4 = (mutants++)->get();
+    auto mutant4 = *mutants++;
     ASSERT_EQ(ExecutionStatus::Passed,
-              mutant4->getTest()->getExecutionResult().status);
+              mutant4.getTest()->getExecutionResult().status);
     ASSERT_EQ("_Z26test_AND_operator_with_CPPv",
-              mutant4->getTest()->getTestName());
-    ASSERT_EQ(ExecutionStatus::Failed, mutant4->getExecutionResult().status);
+              mutant4.getTest()->getTestName());
+    ASSERT_EQ(ExecutionStatus::Failed, mutant4.getExecutionResult().status);
   }
 
   /// Mutation #5: AND operator (PHI case)
   {
-    auto mutant5 = (mutants++)->get();
+    auto mutant5 = *mutants++;
     ASSERT_EQ(ExecutionStatus::Passed,
-              mutant5->getTest()->getExecutionResult().status);
+              mutant5.getTest()->getExecutionResult().status);
     ASSERT_EQ("_Z35test_AND_operator_with_CPP_PHI_casev",
-              mutant5->getTest()->getTestName());
-    ASSERT_EQ(ExecutionStatus::Failed, mutant5->getExecutionResult().status);
+              mutant5.getTest()->getTestName());
+    ASSERT_EQ(ExecutionStatus::Failed, mutant5.getExecutionResult().status);
   }
 
   /// Mutation #6: AND operator (Assert)
   {
-    auto mutant6 = (mutants++)->get();
+    auto mutant6 = *mutants++;
     ASSERT_EQ(ExecutionStatus::Passed,
-              mutant6->getTest()->getExecutionResult().status);
+              mutant6.getTest()->getExecutionResult().status);
     ASSERT_EQ("_Z37test_AND_operator_with_CPP_and_assertv",
-              mutant6->getTest()->getTestName());
-    ASSERT_EQ(ExecutionStatus::Crashed, mutant6->getExecutionResult().status);
+              mutant6.getTest()->getTestName());
+    ASSERT_EQ(ExecutionStatus::Crashed, mutant6.getExecutionResult().status);
   }
 
   ASSERT_EQ(mutants, result->getMutationResults().end());
@@ -696,17 +956,17 @@ TEST(Driver, SimpleTest_ReplaceAssignmentMutator_CPP) {
 
   auto mutants = result->getMutationResults().begin();
 
-  auto mutant1 = (mutants++)->get();
+  auto mutant1 = *mutants++;
   ASSERT_EQ(ExecutionStatus::Passed,
-            mutant1->getTest()->getExecutionResult().status);
-  ASSERT_EQ("test_replace_assignment", mutant1->getTest()->getTestName());
-  ASSERT_EQ(ExecutionStatus::Failed, mutant1->getExecutionResult().status);
+            mutant1.getTest()->getExecutionResult().status);
+  ASSERT_EQ("test_replace_assignment", mutant1.getTest()->getTestName());
+  ASSERT_EQ(ExecutionStatus::Failed, mutant1.getExecutionResult().status);
 
-  auto mutant2 = (mutants++)->get();
+  auto mutant2 = *mutants++;
   ASSERT_EQ(ExecutionStatus::Passed,
-            mutant2->getTest()->getExecutionResult().status);
-  ASSERT_EQ("test_replace_assignment", mutant2->getTest()->getTestName());
-  ASSERT_EQ(ExecutionStatus::Failed, mutant2->getExecutionResult().status);
+            mutant2.getTest()->getExecutionResult().status);
+  ASSERT_EQ("test_replace_assignment", mutant2.getTest()->getTestName());
+  ASSERT_EQ(ExecutionStatus::Failed, mutant2.getExecutionResult().status);
 
   ASSERT_EQ(mutants, result->getMutationResults().end());
 }
@@ -747,11 +1007,65 @@ TEST(Driver, customTest) {
 
   auto mutants = result->getMutationResults().begin();
 
-  auto mutant = (mutants++)->get();
+  auto mutant = *mutants++;
   ASSERT_EQ(ExecutionStatus::Passed,
-            mutant->getTest()->getExecutionResult().status);
-  ASSERT_EQ("passing", mutant->getTest()->getTestName());
-  ASSERT_EQ(ExecutionStatus::Failed, mutant->getExecutionResult().status);
+            mutant.getTest()->getExecutionResult().status);
+  ASSERT_EQ("passing", mutant.getTest()->getTestName());
+  ASSERT_EQ(ExecutionStatus::Failed, mutant.getExecutionResult().status);
+}
+
+TEST(Driver, customTest_splitMutatedFunctions_cachedPerFunction) {
+  SmallString<128> cacheDirectory;
+  ASSERT_FALSE(
+      sys::fs::createUniqueDirectory("mull-split-cache", cacheDirectory));
+
+  Configuration configuration;
+  configuration.customTests = {CustomTestDefinition("passing", "passing_test",
+                                                    "mull", {"passing_test"})};
+  configuration.bitcodePaths = {mull::fixtures::custom_test_distance_bc_path(),
+                                mull::fixtures::custom_test_main_bc_path(),
+                                mull::fixtures::custom_test_test_bc_path()};
+  configuration.cacheEnabled = true;
+  configuration.cacheDirectory = cacheDirectory.str().str();
+  configuration.splitMutatedFunctionsEnabled = true;
+
+  auto run = [&](bool boundaryMutator) {
+    std::vector<std::unique_ptr<Mutator>> mutators;
+    mutators.emplace_back(make_unique<MathAddMutator>());
+    if (boundaryMutator) {
+      mutators.emplace_back(make_unique<ConditionalsBoundaryMutator>());
+    }
+    MutationsFinder finder(std::move(mutators), configuration);
+
+    ModuleLoader loader;
+    Program program({}, {}, loader.loadModules(configuration));
+
+    Toolchain toolchain(configuration);
+    Filter filter;
+    filter.includeTest("passing");
+    Metrics metrics;
+    NullJunkDetector junkDetector;
+
+    TestFrameworkFactory testFrameworkFactory;
+    TestFramework testFramework(
+        testFrameworkFactory.customTestFramework(toolchain, configuration));
+
+    Driver driver(configuration, program, testFramework, toolchain, filter,
+                  finder, metrics, junkDetector);
+    auto result = driver.Run();
+    EXPECT_LE(3UL, result->getMutationResults().size());
+    return toolchain.cache().getMetrics();
+  };
+
+  auto firstRun = run(false);
+  ASSERT_EQ(0U, firstRun.hits);
+
+  /// The new mutator touches min() only: the satellite of
+  /// LevenshteinDistance and the modules without mutants come from the
+  /// cache, only the rest of distance.c and the satellite of min() miss
+  auto secondRun = run(true);
+  ASSERT_EQ(2U, secondRun.misses);
+  ASSERT_EQ(firstRun.hits + firstRun.misses - 1, secondRun.hits);
 }
 
 TEST(Driver, customTest_withDynamicLibraries) {
@@ -865,6 +1179,71 @@ TEST(Driver, junkDetector_disabled) {
   ASSERT_EQ(3UL, result->getMutationResults().size());
 }
 
+namespace {
+/// Marks every other mutation point as junk
+class EveryOtherJunkDetector : public JunkDetector {
+public:
+  bool isJunk(MutationPoint *point) override {
+    std::lock_guard<std::mutex> guard(mutex);
+    junk = !junk;
+    if (junk) {
+      junkPoints.push_back(point);
+    }
+    return junk;
+  }
+
+  std::vector<MutationPoint *> junkPoints;
+
+private:
+  std::mutex mutex;
+  bool junk = false;
+};
+} // namespace
+
+TEST(Driver, junkDetector_deferMutantCloning) {
+  Configuration configuration;
+  configuration.junkDetectionEnabled = true;
+  configuration.deferMutantCloningEnabled = true;
+  configuration.customTests = {CustomTestDefinition("passing", "passing_test",
+                                                    "mull", {"passing_test"})};
+  configuration.bitcodePaths = {fixtures::custom_test_distance_bc_path(),
+                                fixtures::custom_test_main_bc_path(),
+                                fixtures::custom_test_test_bc_path()};
+
+  std::vector<std::unique_ptr<Mutator>> mutators;
+  mutators.emplace_back(make_unique<MathAddMutator>());
+  MutationsFinder finder(std::move(mutators), configuration);
+
+  ModuleLoader loader;
+  Program program({}, {}, loader.loadModules(configuration));
+
+  Toolchain toolchain(configuration);
+  Filter filter;
+  filter.includeTest("passing");
+  Metrics metrics;
+  EveryOtherJunkDetector junkDetector;
+
+  TestFrameworkFactory testFrameworkFactory;
+  TestFramework testFramework(
+      testFrameworkFactory.customTestFramework(toolchain, configuration));
+
+  Driver driver(configuration, program, testFramework, toolchain, filter,
+                finder, metrics, junkDetector);
+
+  auto result = driver.Run();
+  ASSERT_EQ(2U, junkDetector.junkPoints.size());
+  ASSERT_EQ(1UL, result->getMutationResults().size());
+
+  /// Only the mutant that runs has a clone of its function
+  for (auto point : junkDetector.junkPoints) {
+    auto module = point->getOriginalModule()->getModule();
+    ASSERT_EQ(nullptr, module->getFunction(point->getMutatedFunctionName()));
+  }
+  auto mutant = result->getMutationResults().getMutationPoint(0);
+  auto module = mutant->getOriginalModule()->getModule();
+  ASSERT_NE(nullptr, module->getFunction(mutant->getMutatedFunctionName()));
+}
+
 TEST(Driver, customTest_withDynamicLibraries_and_ObjectFiles) {
   Configuration configuration;
   configuration.customTests = {CustomTestDefinition("passing", "passing_test",
@@ -1,10 +1,13 @@
 #include "mull/Instrumentation/DynamicCallTree.h"
+#include "mull/Instrumentation/InstrumentationInfo.h"
 #include "mull/TestFrameworks/Test.h"
 #include "mull/Testee.h"
 
 #include "gtest/gtest.h"
 #include <llvm/IR/Function.h>
+#include <set>
 #include <stack>
+#include <thread>
 
 using namespace mull;
 using namespace llvm;
@@ -37,10 +40,12 @@ TEST(DynamicCallTree, empty_tree) {
 
   uint32_t mapping[6] = {0};
 
-  std::unique_ptr<CallTree> callTree =
-      DynamicCallTree::createCallTree(mapping, functions);
-  ASSERT_EQ(callTree->function, nullptr);
-  ASSERT_TRUE(callTree->children.empty());
+  CallTree callTree;
+  DynamicCallTree::createCallTree(mapping, functions, callTree);
+  ASSERT_EQ(CallTree::None, callTree.firstChild(0));
+  for (uint32_t index = 1; index < functions.size(); index++) {
+    ASSERT_FALSE(callTree.contains(index));
+  }
 }
 
 TEST(DynamicCallTree, non_empty_tree) {
@@ -92,8 +97,8 @@ TEST(DynamicCallTree, non_empty_tree) {
   mapping[4] = 2;
   mapping[5] = 4;
 
-  std::unique_ptr<CallTree> root =
-      DynamicCallTree::createCallTree(mapping, functions);
+  CallTree callTree;
+  DynamicCallTree::createCallTree(mapping, functions, callTree);
 
   /// The tree:
   ///
@@ -103,50 +108,63 @@ TEST(DynamicCallTree, non_empty_tree) {
   ///              F2 -> F4
   ///                    F4 -> F5
 
-  ASSERT_EQ(root->function, nullptr);
-  ASSERT_EQ(root->children.size(), 1UL);
-
-  CallTree *f1Node = root->children.front().get();
-  ASSERT_EQ(f1Node->function, F1);
-  ASSERT_EQ(f1Node->level, 1);
-  ASSERT_EQ(f1Node->functionsIndex, 1UL);
-  ASSERT_EQ(f1Node->children.size(), 1UL);
-
-  CallTree *f2Node = f1Node->children.front().get();
-  ASSERT_EQ(f2Node->function, F2);
-  ASSERT_EQ(f2Node->level, 2);
-  ASSERT_EQ(f2Node->functionsIndex, 2UL);
-  ASSERT_EQ(f2Node->children.size(), 2UL);
-
-  CallTree *f3Node = f2Node->children.front().get();
-  ASSERT_EQ(f3Node->function, F3);
-  ASSERT_EQ(f3Node->level, 3);
-  ASSERT_EQ(f3Node->functionsIndex, 3UL);
-  ASSERT_EQ(f3Node->children.size(), 0UL);
-
-  CallTree *f4Node = f2Node->children.back().get();
-  ASSERT_EQ(f4Node->function, F4);
-  ASSERT_EQ(f4Node->level, 3);
-  ASSERT_EQ(f4Node->functionsIndex, 4UL);
-  ASSERT_EQ(f4Node->children.size(), 1UL);
-
-  CallTree *f5Node = f4Node->children.front().get();
-  ASSERT_EQ(f5Node->function, F5);
-  ASSERT_EQ(f5Node->level, 4);
-  ASSERT_EQ(f5Node->functionsIndex, 5UL);
-  ASSERT_EQ(f5Node->children.size(), 0UL);
+  ASSERT_EQ(1U, callTree.firstChild(0));
+  ASSERT_EQ(CallTree::None, callTree.nextSibling(1));
+
+  ASSERT_EQ(1, callTree.level(1));
+  ASSERT_EQ(0U, callTree.parent(1));
+  ASSERT_EQ(2U, callTree.firstChild(1));
+
+  ASSERT_EQ(2, callTree.level(2));
+  ASSERT_EQ(1U, callTree.parent(2));
+  ASSERT_EQ(CallTree::None, callTree.nextSibling(2));
+  ASSERT_EQ(3U, callTree.firstChild(2));
+
+  ASSERT_EQ(3, callTree.level(3));
+  ASSERT_EQ(2U, callTree.parent(3));
+  ASSERT_EQ(CallTree::None, callTree.firstChild(3));
+  ASSERT_EQ(4U, callTree.nextSibling(3));
+
+  ASSERT_EQ(3, callTree.level(4));
+  ASSERT_EQ(2U, callTree.parent(4));
+  ASSERT_EQ(CallTree::None, callTree.nextSibling(4));
+  ASSERT_EQ(5U, callTree.firstChild(4));
+
+  ASSERT_EQ(4, callTree.level(5));
+  ASSERT_EQ(4U, callTree.parent(5));
+  ASSERT_EQ(CallTree::None, callTree.firstChild(5));
+  ASSERT_EQ(CallTree::None, callTree.nextSibling(5));
 
   /// mapping is being cleaned up while tree is created
   for (uint32_t index = 0; index < functions.size(); index++) {
-    ASSERT_EQ(mapping[0], 0UL);
+    ASSERT_EQ(mapping[index], 0UL);
+  }
+
+}
+
+TEST(DynamicCallTree, deep_chain_reused_tree) {
+  /// F1 -> F2 -> ... -> FN, deeper than a recursive builder could go
+  const uint32_t size = 1000000;
+  std::vector<CallTreeFunction> functions(size, nullptr);
+  std::vector<uint32_t> mapping(size, 0);
+
+  CallTree callTree;
+  for (int run = 0; run < 2; run++) {
+    for (uint32_t index = 1; index < size; index++) {
+      mapping[index] = index == 1 ? 1 : index - 1;
+    }
+
+    DynamicCallTree::createCallTree(mapping.data(), functions, callTree);
+
+    ASSERT_EQ(1U, callTree.firstChild(0));
+    ASSERT_EQ(int(size - 1), callTree.level(size - 1));
+    ASSERT_EQ(size - 2, callTree.parent(size - 1));
+    ASSERT_EQ(CallTree::None, callTree.firstChild(size - 1));
   }
 
-  ASSERT_EQ(functions[0].treeRoot, nullptr);
-  ASSERT_EQ(functions[1].treeRoot, nullptr);
-  ASSERT_EQ(functions[2].treeRoot, nullptr);
-  ASSERT_EQ(functions[3].treeRoot, nullptr);
-  ASSERT_EQ(functions[4].treeRoot, nullptr);
-  ASSERT_EQ(functions[5].treeRoot, nullptr);
+  for (uint32_t index = 0; index < size; index++) {
+    ASSERT_EQ(mapping[index], 0UL);
+  }
 }
 
 TEST(DynamicCallTree, enter_leave_function) {
@@ -253,6 +271,102 @@ TEST(DynamicCallTree, enter_leave_function_recursion) {
   ASSERT_TRUE(stack.empty());
 }
 
+TEST(DynamicCallTree, enter_leave_function_bounded) {
+  ///
+  /// Call trace, F2 is the test body and the max distance is 1
+  ///
+  ///   F1 -> F2 -> F3 -> F4 -> F5
+  ///   F1 -> F6
+  ///   F1 -> F2 -> F4
+
+  const uint32_t testBody = 2;
+  const uint32_t maxDistance = 1;
+  uint32_t mapping[7] = {0};
+  std::stack<uint32_t> stack;
+  uint32_t testBodyDepth = InstrumentationInfo::OutsideTestBody;
+
+  auto enter = [&](uint32_t index) {
+    if (DynamicCallTree::enterBounded(index, stack.size(), testBody,
+                                      maxDistance, testBodyDepth)) {
+      DynamicCallTree::recordCaller(index, &mapping[index], stack);
+    }
+    stack.push(index);
+  };
+  auto leave = [&](uint32_t index) {
+    DynamicCallTree::leaveFunction(index, mapping, stack);
+    DynamicCallTree::leaveBounded(stack.size(), testBodyDepth);
+  };
+
+  // clang-format off
+  enter(1);
+    enter(2);
+      enter(3);
+        enter(4);
+          enter(5);
+          leave(5);
+        leave(4);
+      leave(3);
+    leave(2);
+    enter(6);
+    leave(6);
+    enter(2);
+      enter(4);
+      leave(4);
+    leave(2);
+  leave(1);
+  // clang-format on
+
+  ASSERT_EQ(mapping[1], 0UL);
+  ASSERT_EQ(mapping[2], 1UL);
+  ASSERT_EQ(mapping[3], 2UL);
+  ASSERT_EQ(mapping[4], 2UL);
+  ASSERT_EQ(mapping[5], 0UL);
+  ASSERT_EQ(mapping[6], 0UL);
+
+  ASSERT_TRUE(stack.empty());
+  ASSERT_TRUE(testBodyDepth == InstrumentationInfo::OutsideTestBody);
+}
+
+TEST(DynamicCallTree, enter_leave_function_threads) {
+  ///
+  /// Call trace of every thread T, each with its own stack
+  ///
+  ///   F1 -> F(2 + T) -> F6
+
+  const int threadCount = 4;
+  const int iterations = 1000;
+  uint32_t mapping[7] = {0};
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < threadCount; t++) {
+    threads.emplace_back([t, &mapping]() {
+      std::stack<uint32_t> stack;
+      for (int i = 0; i < iterations; i++) {
+        // clang-format off
+        DynamicCallTree::enterFunction(1, mapping, stack);
+          DynamicCallTree::enterFunction(2 + t, mapping, stack);
+            DynamicCallTree::enterFunction(6, mapping, stack);
+            DynamicCallTree::leaveFunction(6, mapping, stack);
+          DynamicCallTree::leaveFunction(2 + t, mapping, stack);
+        DynamicCallTree::leaveFunction(1, mapping, stack);
+        // clang-format on
+      }
+      ASSERT_TRUE(stack.empty());
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_EQ(mapping[0], 0UL);
+  ASSERT_EQ(mapping[1], 1UL);
+  for (int t = 0; t < threadCount; t++) {
+    ASSERT_EQ(mapping[2 + t], 1UL);
+  }
+  ASSERT_GE(mapping[6], 2UL);
+  ASSERT_LE(mapping[6], 5UL);
+}
+
 TEST(DynamicCallTree, test_subtrees) {
   Function *phonyFunction = nullptr;
   Function *F1 = fakeFunction("F1");
@@ -286,15 +400,15 @@ TEST(DynamicCallTree, test_subtrees) {
 
   mull::Test test("", "", "", {}, F2);
 
-  std::unique_ptr<CallTree> callTree =
-      DynamicCallTree::createCallTree(mapping, functions);
-  std::vector<CallTree *> subtrees =
-      DynamicCallTree::extractTestSubtrees(callTree.get(), test);
+  CallTree callTree;
+  DynamicCallTree::createCallTree(mapping, functions, callTree);
+  std::vector<uint32_t> subtrees =
+      DynamicCallTree::extractTestSubtrees(callTree, functions, test);
 
   EXPECT_EQ(1UL, subtrees.size());
 
-  CallTree *root = *subtrees.begin();
-  EXPECT_EQ(root->function, F2);
+  uint32_t root = *subtrees.begin();
+  EXPECT_EQ(functions[root].function, F2);
 }
 
 TEST(DynamicCallTree, testees) {
@@ -330,16 +444,17 @@ TEST(DynamicCallTree, testees) {
 
   mull::Test test("", "", "", {}, F2);
 
-  std::unique_ptr<CallTree> callTree =
-      DynamicCallTree::createCallTree(mapping, functions);
-  std::vector<CallTree *> subtrees =
-      DynamicCallTree::extractTestSubtrees(callTree.get(), test);
+  CallTree callTree;
+  DynamicCallTree::createCallTree(mapping, functions, callTree);
+  std::vector<uint32_t> subtrees =
+      DynamicCallTree::extractTestSubtrees(callTree, functions, test);
 
   Filter nullFilter;
 
   {
     std::vector<std::unique_ptr<Testee>> testees =
-        DynamicCallTree::createTestees(subtrees, test, 5, nullFilter);
+        DynamicCallTree::createTestees(callTree, functions, subtrees, test,
+                                       5, nullFilter);
 
     EXPECT_EQ(4U, testees.size());
 
@@ -362,7 +477,8 @@ TEST(DynamicCallTree, testees) {
 
   {
     std::vector<std::unique_ptr<Testee>> testees =
-        DynamicCallTree::createTestees(subtrees, test, 1, nullFilter);
+        DynamicCallTree::createTestees(callTree, functions, subtrees, test,
+                                       1, nullFilter);
     EXPECT_EQ(3U, testees.size());
 
     Testee *testeeF2 = testees.begin()->get();
@@ -382,7 +498,8 @@ TEST(DynamicCallTree, testees) {
     Filter filter;
     filter.skipByName("F5");
     std::vector<std::unique_ptr<Testee>> testees =
-        DynamicCallTree::createTestees(subtrees, test, 5, filter);
+        DynamicCallTree::createTestees(callTree, functions, subtrees, test,
+                                       5, filter);
     EXPECT_EQ(3U, testees.size());
 
     Testee *testeeF2 = testees.begin()->get();
@@ -398,3 +515,116 @@ TEST(DynamicCallTree, testees) {
     EXPECT_EQ(testeeF4->getDistance(), 1);
   }
 }
+
+TEST(DynamicCallTree, testees_from_mapping) {
+  Function *phonyFunction = nullptr;
+  Function *F1 = fakeFunction("F1");
+  Function *F2 = fakeFunction("F2");
+  Function *F3 = fakeFunction("F3");
+  Function *F4 = fakeFunction("F4");
+  Function *F5 = fakeFunction("F5");
+
+  std::vector<CallTreeFunction> functions;
+  functions.push_back(phonyFunction);
+  functions.push_back(F1);
+  functions.push_back(F2);
+  functions.push_back(F3);
+  functions.push_back(F4);
+  functions.push_back(F5);
+
+  ///
+  /// Call trace
+  ///
+  ///   F1 -> F2 -> F3
+  ///         F2 -> F4
+  ///   F1 -> F4 -> F5
+  ///
+
+  uint32_t mapping[6] = {0, 1, 1, 2, 2, 4};
+
+  mull::Test test("", "", "", {}, F2);
+  Filter nullFilter;
+
+  std::vector<std::unique_ptr<Testee>> testees =
+      DynamicCallTree::extractTestees(mapping, functions, 2, test, 5,
+                                      nullFilter);
+
+  ASSERT_EQ(4U, testees.size());
+  EXPECT_EQ(testees[0]->getTesteeFunction(), F2);
+  EXPECT_EQ(testees[0]->getDistance(), 0);
+  EXPECT_EQ(testees[1]->getTesteeFunction(), F3);
+  EXPECT_EQ(testees[1]->getDistance(), 1);
+  EXPECT_EQ(testees[2]->getTesteeFunction(), F4);
+  EXPECT_EQ(testees[2]->getDistance(), 1);
+  EXPECT_EQ(testees[3]->getTesteeFunction(), F5);
+  EXPECT_EQ(testees[3]->getDistance(), 2);
+
+  for (uint32_t index = 0; index < functions.size(); index++) {
+    ASSERT_EQ(0U, mapping[index]);
+  }
+
+  mapping[1] = 1;
+  mapping[2] = 1;
+  mapping[3] = 2;
+  mapping[4] = 2;
+  mapping[5] = 4;
+  Filter filter;
+  filter.skipByName("F4");
+  testees = DynamicCallTree::extractTestees(mapping, functions, 2, test, 5,
+                                            filter);
+  ASSERT_EQ(2U, testees.size());
+  EXPECT_EQ(testees[0]->getTesteeFunction(), F2);
+  EXPECT_EQ(testees[1]->getTesteeFunction(), F3);
+
+  mapping[1] = 1;
+  mapping[3] = 1;
+  testees = DynamicCallTree::extractTestees(mapping, functions, 2, test, 5,
+                                            nullFilter);
+  ASSERT_TRUE(testees.empty());
+}
+
+TEST(DynamicCallTree, testees_from_mapping_match_call_tree) {
+  const uint32_t size = 2000;
+  std::vector<CallTreeFunction> functions;
+  functions.push_back(nullptr);
+  for (uint32_t index = 1; index < size; index++) {
+    functions.push_back(fakeFunction("F"));
+  }
+
+  /// Every other function ran, each one called by a function that ran before
+  std::vector<uint32_t> original(size, 0);
+  original[1] = 1;
+  for (uint32_t index = 3; index < size; index += 2) {
+    original[index] = 1 + 2 * ((index * 7919) % (index / 2));
+  }
+
+  mull::Test test("", "", "", {}, functions[3].function);
+  Filter nullFilter;
+
+  for (int distance = 0; distance < 6; distance++) {
+    std::vector<uint32_t> mapping(original);
+    CallTree callTree;
+    DynamicCallTree::createCallTree(mapping.data(), functions, callTree);
+    auto subtrees =
+        DynamicCallTree::extractTestSubtrees(callTree, functions, test);
+    auto expected = DynamicCallTree::createTestees(
+        callTree, functions, subtrees, test, distance, nullFilter);
+
+    mapping = original;
+    auto testees = DynamicCallTree::extractTestees(
+        mapping.data(), functions, 3, test, distance, nullFilter);
+
+    std::multiset<std::pair<Function *, int>> expectedTestees;
+    for (auto &testee : expected) {
+      expectedTestees.emplace(testee->getTesteeFunction(),
+                              testee->getDistance());
+    }
+    std::multiset<std::pair<Function *, int>> actualTestees;
+    for (auto &testee : testees) {
+      actualTestees.emplace(testee->getTesteeFunction(),
+                            testee->getDistance());
+    }
+    ASSERT_FALSE(testees.empty());
+    ASSERT_EQ(expectedTestees, actualTestees);
+  }
+}
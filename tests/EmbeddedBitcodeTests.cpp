@@ -0,0 +1,53 @@
+#include "gtest/gtest.h"
+
+#include "FixturePaths.h"
+#include "mull/EmbeddedBitcode.h"
+
+#include <llvm/Support/MemoryBuffer.h>
+
+#include <string>
+
+using namespace mull;
+using namespace llvm;
+
+static std::string readFile(const std::string &path) {
+  auto buffer = MemoryBuffer::getFile(path);
+  EXPECT_TRUE(bool(buffer));
+  return buffer.get()->getBuffer().str();
+}
+
+TEST(EmbeddedBitcode, SplitsConcatenatedBitcodeFiles) {
+  std::string main = readFile(fixtures::custom_test_main_bc_path());
+  std::string test = readFile(fixtures::custom_test_test_bc_path());
+  std::string distance = readFile(fixtures::custom_test_distance_bc_path());
+
+  /// The linker may pad the sections of the objects
+  std::string section = main + test + std::string(3, '\0') + distance;
+
+  auto files = splitBitcodeSection(section);
+  ASSERT_EQ(size_t(3), files.size());
+  ASSERT_EQ(main, files[0].str());
+  ASSERT_EQ(test, files[1].str());
+  ASSERT_EQ(distance, files[2].str());
+
+  /// The files point into the section
+  ASSERT_EQ(section.data(), files[0].data());
+}
+
+TEST(EmbeddedBitcode, SkipsMalformedBitcode) {
+  std::string main = readFile(fixtures::custom_test_main_bc_path());
+  std::string section = main.substr(0, main.size() / 2) + main;
+
+  auto files = splitBitcodeSection(section);
+  ASSERT_EQ(size_t(1), files.size());
+  ASSERT_EQ(main, files[0].str());
+
+  ASSERT_TRUE(splitBitcodeSection("no bitcode here").empty());
+}
+
+TEST(EmbeddedBitcode, BitcodeIsNotAnObjectFile) {
+  std::string main = readFile(fixtures::custom_test_main_bc_path());
+  std::vector<StringRef> sections;
+  ASSERT_FALSE(findBitcodeSections(MemoryBufferRef(main, "main.bc"), sections));
+  ASSERT_TRUE(sections.empty());
+}
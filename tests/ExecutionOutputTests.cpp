@@ -0,0 +1,85 @@
+#include "mull/ExecutionOutput.h"
+#include "mull/ExecutionResult.h"
+
+#include "gtest/gtest.h"
+
+using namespace mull;
+
+static ExecutionResult resultWithOutput(ExecutionStatus status,
+                                        const std::string &output) {
+  ExecutionResult result;
+  result.status = status;
+  result.stdoutOutput = output;
+  result.stderrOutput = output;
+  return result;
+}
+
+TEST(ExecutionOutputStore, Full_DeduplicatesIdenticalOutputs) {
+  ExecutionOutputStore store(OutputRetention::Full, 0);
+
+  auto first = resultWithOutput(Passed, "[ PASSED ] 1 test");
+  auto second = resultWithOutput(Passed, "[ PASSED ] 1 test");
+  auto third = resultWithOutput(Failed, "[ FAILED ] 1 test");
+  store.retain(first);
+  store.retain(second);
+  store.retain(third);
+
+  ASSERT_EQ(first.stdoutOutput, "[ PASSED ] 1 test");
+  ASSERT_TRUE(first.stdoutOutput.sharesStorageWith(second.stdoutOutput));
+  ASSERT_TRUE(first.stdoutOutput.sharesStorageWith(first.stderrOutput));
+  ASSERT_FALSE(first.stdoutOutput.sharesStorageWith(third.stdoutOutput));
+  ASSERT_EQ(store.uniqueOutputs(), 2U);
+  ASSERT_EQ(store.storedBytes(), 34U);
+}
+
+TEST(ExecutionOutputStore, None_DropsEverything) {
+  ExecutionOutputStore store(OutputRetention::None, 0);
+
+  auto result = resultWithOutput(Failed, "output");
+  store.retain(result);
+
+  ASSERT_TRUE(result.stdoutOutput.empty());
+  ASSERT_TRUE(result.stderrOutput.empty());
+}
+
+TEST(ExecutionOutputStore, Tail_KeepsLastBytes) {
+  ExecutionOutputStore store(OutputRetention::Tail, 4);
+
+  auto longOutput = resultWithOutput(Passed, "0123456789");
+  auto shortOutput = resultWithOutput(Passed, "01");
+  store.retain(longOutput);
+  store.retain(shortOutput);
+
+  ASSERT_EQ(longOutput.stdoutOutput, "6789");
+  ASSERT_EQ(shortOutput.stdoutOutput, "01");
+}
+
+TEST(ExecutionOutputStore, Killed_KeepsOnlyNotPassed) {
+  ExecutionOutputStore store(OutputRetention::Killed, 0);
+
+  auto passed = resultWithOutput(Passed, "passed");
+  auto crashed = resultWithOutput(Crashed, "crashed");
+  store.retain(passed);
+  store.retain(crashed);
+
+  ASSERT_TRUE(passed.stdoutOutput.empty());
+  ASSERT_EQ(crashed.stdoutOutput, "crashed");
+}
+
+TEST(ExecutionOutputStore, Compressed_RoundTrips) {
+  ExecutionOutputStore store(OutputRetention::Compressed, 0);
+
+  std::string output;
+  for (int i = 0; i < 1000; i++) {
+    output += "[ RUN      ] Test.Case\n";
+  }
+
+  auto first = resultWithOutput(Passed, output);
+  auto second = resultWithOutput(Passed, output);
+  store.retain(first);
+  store.retain(second);
+
+  ASSERT_EQ(first.stdoutOutput.size(), output.size());
+  ASSERT_EQ(first.stdoutOutput, output);
+  ASSERT_TRUE(first.stdoutOutput.sharesStorageWith(second.stdoutOutput));
+}
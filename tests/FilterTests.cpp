@@ -0,0 +1,111 @@
+#include "mull/Filter.h"
+
+#include "gtest/gtest.h"
+
+#include <llvm/AsmParser/Parser.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/SourceMgr.h>
+
+using namespace mull;
+using namespace llvm;
+
+static const char *const ModuleWithDebugInfo = R"(
+define void @inflate() !dbg !4 {
+  ret void, !dbg !7
+}
+
+define void @deflate() !dbg !8 {
+  ret void, !dbg !9
+}
+
+!llvm.dbg.cu = !{!0}
+!llvm.module.flags = !{!3}
+
+!0 = distinct !DICompileUnit(language: DW_LANG_C99, file: !1, emissionKind: FullDebug)
+!1 = !DIFile(filename: "third_party/zlib/src/inflate.cc", directory: "/home/project")
+!2 = !DIFile(filename: "/home/project/src/deflate.c", directory: "/home/project")
+!3 = !{i32 2, !"Debug Info Version", i32 3}
+!4 = distinct !DISubprogram(name: "inflate", scope: !1, file: !1, line: 3, type: !5, isDefinition: true, unit: !0)
+!5 = !DISubroutineType(types: !6)
+!6 = !{null}
+!7 = !DILocation(line: 4, column: 1, scope: !4)
+!8 = distinct !DISubprogram(name: "deflate", scope: !2, file: !2, line: 3, type: !5, isDefinition: true, unit: !0)
+!9 = !DILocation(line: 4, column: 1, scope: !8)
+)";
+
+class FilterTest : public ::testing::Test {
+protected:
+  LLVMContext context;
+  std::unique_ptr<Module> module;
+  Function *inflate;
+  Function *deflate;
+
+  void SetUp() override {
+    SMDiagnostic error;
+    module = parseAssemblyString(ModuleWithDebugInfo, error, context);
+    ASSERT_TRUE(module != nullptr);
+    inflate = module->getFunction("inflate");
+    deflate = module->getFunction("deflate");
+  }
+
+  bool skipsInflate(const std::string &pattern) {
+    Filter filter;
+    filter.skipByLocationPattern(pattern);
+    return filter.shouldSkipFunction(inflate) &&
+           filter.shouldSkipInstruction(&inflate->front().front()) &&
+           !filter.shouldSkipFunction(deflate);
+  }
+};
+
+TEST(Filter, skipsFunctionsByName) {
+  LLVMContext context;
+  Module module("filter", context);
+  auto type = FunctionType::get(Type::getVoidTy(context), false);
+  Function *kept = Function::Create(type, Function::ExternalLinkage,
+                                    "_ZN7mull4sum", &module);
+  Function *skipped = Function::Create(type, Function::ExternalLinkage,
+                                       "_ZN7testing8internal4Test", &module);
+
+  Filter filter;
+  ASSERT_FALSE(filter.shouldSkipFunction(skipped));
+
+  filter.skipByName("testing8internal");
+  filter.skipByName("clang_call_terminate");
+  ASSERT_FALSE(filter.shouldSkipFunction(kept));
+  ASSERT_TRUE(filter.shouldSkipFunction(skipped));
+  ASSERT_TRUE(filter.shouldSkipFunction(skipped));
+
+  /// A pattern added later is taken into account by the cached verdicts
+  filter.skipByName("4sum");
+  ASSERT_TRUE(filter.shouldSkipFunction(kept));
+}
+
+TEST_F(FilterTest, skipsLocationsBySubstring) {
+  ASSERT_TRUE(skipsInflate("third_party"));
+  ASSERT_TRUE(skipsInflate("/home/project/third_party/zlib"));
+  ASSERT_FALSE(skipsInflate("zlib/inflate"));
+}
+
+TEST_F(FilterTest, skipsLocationsByGlob) {
+  ASSERT_TRUE(skipsInflate("glob:third_party/**/*.cc"));
+  ASSERT_TRUE(skipsInflate("glob:**/zlib/*/inflate.c?"));
+  ASSERT_TRUE(skipsInflate("glob:*.[ch]c"));
+  ASSERT_TRUE(skipsInflate("glob:inflate.[!h]c"));
+  ASSERT_FALSE(skipsInflate("glob:third_party/*.cc"));
+  ASSERT_FALSE(skipsInflate("glob:party/**/*.cc"));
+  ASSERT_FALSE(skipsInflate("glob:*.c"));
+}
+
+TEST_F(FilterTest, skipsLocationsByRegex) {
+  ASSERT_TRUE(skipsInflate("regex:third_party/.*\\.cc$"));
+  ASSERT_TRUE(skipsInflate("regex:^/home/project/third"));
+  ASSERT_FALSE(skipsInflate("regex:^third_party"));
+}
+
+TEST_F(FilterTest, validatesLocationPatterns) {
+  ASSERT_EQ("", Filter::validateLocationPattern("third_party(["));
+  ASSERT_EQ("", Filter::validateLocationPattern("glob:third_party/**"));
+  ASSERT_EQ("", Filter::validateLocationPattern("regex:^std::.*"));
+  ASSERT_NE("", Filter::validateLocationPattern("regex:third_party(["));
+}
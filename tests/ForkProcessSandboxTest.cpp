@@ -1,8 +1,16 @@
 #include "mull/ForkProcessSandbox.h"
 #include "mull/ExecutionResult.h"
+#include "mull/PerfCounters.h"
 
 #include "gtest/gtest.h"
 
+#include <chrono>
+#include <csignal>
+#include <string>
+#include <sys/resource.h>
+#include <vector>
+#include <unistd.h>
+
 using namespace mull;
 
 /// The timeout should be long enough to overlive the unit test suite running
@@ -29,8 +37,8 @@ TEST(ForkProcessSandbox, captureOutputFromChildProcess) {
 
   ASSERT_EQ(result.status, Passed);
 
-  ASSERT_EQ(strcmp(result.stdoutOutput.c_str(), stdoutMessage), 0);
-  ASSERT_EQ(strcmp(result.stderrOutput.c_str(), stderrMessage), 0);
+  ASSERT_EQ(strcmp(result.stdoutOutput.str().c_str(), stdoutMessage), 0);
+  ASSERT_EQ(strcmp(result.stderrOutput.str().c_str(), stderrMessage), 0);
 }
 
 #pragma mark - Possible execution scenarios
@@ -84,6 +92,81 @@ TEST(ForkProcessSandbox, statusTimeout) {
   ASSERT_EQ(result.status, Timedout);
 }
 
+TEST(ForkProcessSandbox, statusTimeout_OnceTheTestStalls) {
+  ForkProcessSandbox sandbox(ForkProcessSandbox::DefaultOutputLimit, true,
+                             nullptr, false, 100);
+
+  auto start = std::chrono::steady_clock::now();
+  ExecutionResult result = sandbox.run(
+      [&]() {
+        /// Waits on a lock nobody releases
+        int pipes[2];
+        char byte;
+        if (pipe(pipes) != 0 || read(pipes[0], &byte, 1) != 0) {
+          return ExecutionStatus::Failed;
+        }
+        return ExecutionStatus::Passed;
+      },
+      Timeout * 10);
+
+  ASSERT_EQ(result.status, Timedout);
+  ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(2));
+}
+
+TEST(ForkProcessSandbox, statusPassed_IfTheTestKeepsRunning) {
+  ForkProcessSandbox sandbox(ForkProcessSandbox::DefaultOutputLimit, true,
+                             nullptr, false, 100);
+
+  ExecutionResult result = sandbox.run(
+      [&]() {
+        /// Busy outside of any mutated function, for longer than the stall
+        /// timeout
+        auto end = std::chrono::steady_clock::now() +
+                   std::chrono::milliseconds(300);
+        volatile uint64_t spins = 0;
+        while (std::chrono::steady_clock::now() < end) {
+          spins = spins + 1;
+        }
+        return ExecutionStatus::Passed;
+      },
+      Timeout);
+
+  ASSERT_EQ(result.status, Passed);
+}
+
+TEST(ForkProcessSandbox, statusTimeout_IfTheTestBlocksTheAlarm) {
+  ForkProcessSandbox sandbox;
+
+  ExecutionResult result = sandbox.run(
+      [&]() {
+        sigset_t signals;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGALRM);
+        sigprocmask(SIG_BLOCK, &signals, nullptr);
+        sleep(3);
+        return ExecutionStatus::Passed;
+      },
+      100);
+
+  ASSERT_EQ(result.status, Timedout);
+  /// The child is killed at the deadline, not when it is done sleeping
+  ASSERT_LT(result.runningTime, 2000);
+}
+
+TEST(ForkProcessSandbox, statusPassed_IfTheTestUsesTheAlarm) {
+  ForkProcessSandbox sandbox;
+
+  ExecutionResult result = sandbox.run(
+      [&]() {
+        signal(SIGALRM, SIG_IGN);
+        alarm(1);
+        return ExecutionStatus::Passed;
+      },
+      Timeout);
+
+  ASSERT_EQ(result.status, Passed);
+}
+
 TEST(ForkProcessSandbox, statusCrashed) {
   ForkProcessSandbox sandbox;
 
@@ -96,3 +179,657 @@ TEST(ForkProcessSandbox, statusCrashed) {
 
   ASSERT_EQ(result.status, Crashed);
 }
+
+/// Keeps the CPU busy for about that long
+static ExecutionStatus spin(int milliseconds) {
+  auto end = std::chrono::steady_clock::now() +
+             std::chrono::milliseconds(milliseconds);
+  volatile uint64_t iterations = 0;
+  while (std::chrono::steady_clock::now() < end) {
+    iterations = iterations + 1;
+  }
+  return ExecutionStatus::Passed;
+}
+
+TEST(ForkProcessSandbox, usageOfTheChild) {
+  ForkProcessSandbox sandbox;
+
+  ExecutionResult result = sandbox.run(
+      [&]() {
+        std::vector<char> memory(32 * 1024 * 1024, 1);
+        return memory.back() == 1 ? spin(100) : ExecutionStatus::Failed;
+      },
+      Timeout);
+
+  ASSERT_EQ(result.status, Passed);
+  ASSERT_GT(result.usage.userTime + result.usage.systemTime, 20000);
+  ASSERT_GE(result.usage.maxResident, 32 * 1024);
+  ASSERT_GT(result.usage.minorFaults, 0);
+}
+
+TEST(ForkProcessSandbox, countsTheEventsOfTheTest) {
+  ForkProcessSandbox sandbox(ForkProcessSandbox::DefaultOutputLimit, true,
+                             nullptr, true);
+
+  ExecutionResult result = sandbox.run([&]() { return spin(50); }, Timeout);
+
+  ASSERT_EQ(result.status, Passed);
+  /// Not every machine lets a process count, e.g. a VM without a PMU
+  PerfCounters probe;
+  if (probe.read().instructions == 0) {
+    ASSERT_EQ(result.counts.instructions, 0);
+    return;
+  }
+  ASSERT_GT(result.counts.instructions, 1000000);
+  ASSERT_GT(result.counts.cycles, 0);
+
+  ForkProcessSandbox uncounted;
+  result = uncounted.run([&]() { return spin(1); }, Timeout);
+  ASSERT_EQ(result.counts.instructions, 0);
+}
+
+#pragma mark - Fork server
+
+TEST(ForkServerProcessSandbox, runSeries_ReturnsResultsInOrder) {
+  ForkServerProcessSandbox sandbox;
+
+  std::vector<SandboxJob> jobs;
+  jobs.emplace_back(
+      [&]() {
+        printf("first");
+        return ExecutionStatus::Passed;
+      },
+      Timeout);
+  jobs.emplace_back(
+      [&]() {
+        abort();
+        return ExecutionStatus::Passed;
+      },
+      Timeout);
+  jobs.emplace_back(
+      [&]() {
+        fprintf(stderr, "third");
+        return ExecutionStatus::Failed;
+      },
+      Timeout);
+
+  auto results =
+      sandbox.runSeries(jobs, [](const ExecutionResult &) { return true; });
+
+  ASSERT_EQ(results.size(), 3U);
+  ASSERT_EQ(results[0].status, Passed);
+  ASSERT_EQ(results[0].stdoutOutput, "first");
+  ASSERT_EQ(results[1].status, Crashed);
+  ASSERT_EQ(results[2].status, Failed);
+  ASSERT_EQ(results[2].stderrOutput, "third");
+}
+
+TEST(ForkServerProcessSandbox, runSeries_StopsWhenAskedTo) {
+  ForkServerProcessSandbox sandbox;
+
+  std::vector<SandboxJob> jobs;
+  jobs.emplace_back([&]() { return ExecutionStatus::Failed; }, Timeout);
+  jobs.emplace_back([&]() { return ExecutionStatus::Passed; }, Timeout);
+
+  auto results = sandbox.runSeries(jobs, [](const ExecutionResult &result) {
+    return result.status == Passed;
+  });
+
+  ASSERT_EQ(results.size(), 1U);
+  ASSERT_EQ(results[0].status, Failed);
+}
+
+TEST(ForkServerProcessSandbox, runSeries_Timeout) {
+  ForkServerProcessSandbox sandbox;
+
+  std::vector<SandboxJob> jobs;
+  jobs.emplace_back(
+      [&]() {
+        sleep(3);
+        return ExecutionStatus::Passed;
+      },
+      Timeout);
+  jobs.emplace_back([&]() { return ExecutionStatus::Passed; }, Timeout);
+
+  auto results =
+      sandbox.runSeries(jobs, [](const ExecutionResult &) { return true; });
+
+  ASSERT_EQ(results.size(), 2U);
+  ASSERT_EQ(results[0].status, Timedout);
+  ASSERT_EQ(results[1].status, Passed);
+}
+
+#pragma mark - Concurrent series
+
+static SandboxJob printingJob(const char *output, ExecutionStatus status,
+                              unsigned sleepMilliseconds = 0) {
+  return SandboxJob(
+      [=]() {
+        usleep(sleepMilliseconds * 1000);
+        printf("%s", output);
+        return status;
+      },
+      Timeout);
+}
+
+/// Counts the runs of the prologue in the process it runs in, the jobs pass
+/// if it ran exactly once before them
+static std::vector<SandboxJob> prologueCountingJobs(size_t count,
+                                                    unsigned prologueSleep) {
+  static int prologueRuns = 0;
+  auto prologue = [prologueSleep]() {
+    printf("prologue");
+    sleep(prologueSleep);
+    prologueRuns++;
+  };
+  std::vector<SandboxJob> jobs;
+  for (size_t index = 0; index < count; index++) {
+    jobs.emplace_back(
+        [&]() {
+          printf("%s", prologueRuns ? "job" : "set up");
+          return prologueRuns == 1 ? ExecutionStatus::Passed
+                                   : ExecutionStatus::Failed;
+        },
+        Timeout, prologue);
+  }
+  return jobs;
+}
+
+TEST(ForkServerProcessSandbox, runSeries_RunsThePrologueOnceInTheServer) {
+  ForkServerProcessSandbox sandbox;
+
+  auto jobs = prologueCountingJobs(3, 0);
+  auto results =
+      sandbox.runSeries(jobs, [](const ExecutionResult &) { return true; });
+
+  ASSERT_EQ(results.size(), 3U);
+  for (auto &result : results) {
+    ASSERT_EQ(result.status, Passed);
+    ASSERT_EQ(result.stdoutOutput, "job");
+  }
+}
+
+TEST(ForkServerProcessSandbox, runSeries_JobsSetThemselvesUpIfPrologueHangs) {
+  ForkServerProcessSandbox sandbox;
+
+  auto jobs = prologueCountingJobs(2, 3);
+  auto start = std::chrono::steady_clock::now();
+  auto results =
+      sandbox.runSeries(jobs, [](const ExecutionResult &) { return true; });
+  auto elapsed = std::chrono::steady_clock::now() - start;
+
+  ASSERT_EQ(results.size(), 2U);
+  ASSERT_EQ(results[0].status, Failed);
+  ASSERT_EQ(results[0].stdoutOutput, "set up");
+  ASSERT_EQ(results[1].stdoutOutput, "set up");
+  ASSERT_LT(std::chrono::duration_cast<std::chrono::seconds>(elapsed).count(),
+            3);
+}
+
+TEST(ForkProcessSandbox, runConcurrentSeries_ReturnsResultsInOrder) {
+  ForkProcessSandbox sandbox;
+
+  std::vector<std::vector<SandboxJob>> series(3);
+  series[0].push_back(printingJob("a1", Passed, 50));
+  series[0].push_back(printingJob("a2", Failed));
+  series[1].push_back(printingJob("b1", Passed));
+  series[2].push_back(printingJob("c1", Failed, 20));
+  series[2].push_back(printingJob("c2", Passed));
+
+  auto results = sandbox.runConcurrentSeries(
+      series, 2, [](const ExecutionResult &) { return true; });
+
+  ASSERT_EQ(results.size(), 3U);
+  ASSERT_EQ(results[0].size(), 2U);
+  ASSERT_EQ(results[0][0].stdoutOutput, "a1");
+  ASSERT_EQ(results[0][1].stdoutOutput, "a2");
+  ASSERT_EQ(results[0][1].status, Failed);
+  ASSERT_EQ(results[1].size(), 1U);
+  ASSERT_EQ(results[1][0].stdoutOutput, "b1");
+  ASSERT_EQ(results[2].size(), 2U);
+  ASSERT_EQ(results[2][0].status, Failed);
+  ASSERT_EQ(results[2][1].stdoutOutput, "c2");
+}
+
+TEST(ForkProcessSandbox, runConcurrentSeries_RunsTheSeriesAtOnce) {
+  ForkProcessSandbox sandbox;
+
+  std::vector<std::vector<SandboxJob>> series(4);
+  for (auto &jobs : series) {
+    jobs.push_back(printingJob("", Passed, 300));
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  auto results = sandbox.runConcurrentSeries(
+      series, 4, [](const ExecutionResult &) { return true; });
+  auto elapsed = std::chrono::steady_clock::now() - start;
+
+  ASSERT_EQ(results.size(), 4U);
+  for (auto &result : results) {
+    ASSERT_EQ(result.size(), 1U);
+    ASSERT_EQ(result[0].status, Passed);
+  }
+  ASSERT_LT(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed)
+                .count(),
+            1000);
+}
+
+TEST(ForkProcessSandbox, runConcurrentSeries_StopsEachSeriesOnItsOwn) {
+  ForkProcessSandbox sandbox;
+
+  std::vector<std::vector<SandboxJob>> series(2);
+  series[0].emplace_back(
+      [&]() {
+        sleep(3);
+        return ExecutionStatus::Passed;
+      },
+      100);
+  series[0].push_back(printingJob("skipped", Passed));
+  series[1].push_back(printingJob("b1", Passed));
+  series[1].push_back(printingJob("b2", Passed));
+
+  auto results =
+      sandbox.runConcurrentSeries(series, 2, [](const ExecutionResult &result) {
+        return result.status == Passed;
+      });
+
+  ASSERT_EQ(results[0].size(), 1U);
+  ASSERT_EQ(results[0][0].status, Timedout);
+  ASSERT_EQ(results[1].size(), 2U);
+  ASSERT_EQ(results[1][1].stdoutOutput, "b2");
+}
+
+/// A budget smaller than mull itself lets one child through at a time
+TEST(ForkProcessSandbox, runConcurrentSeries_OneChildOverTheMemoryBudget) {
+  ChildResourcesConfig config;
+  config.memoryBudget = 1;
+  ChildResources resources(config);
+  ForkProcessSandbox sandbox(ForkProcessSandbox::DefaultOutputLimit, true,
+                             &resources);
+
+  std::vector<std::vector<SandboxJob>> series(3);
+  for (auto &jobs : series) {
+    jobs.push_back(printingJob("", Passed, 100));
+    jobs.push_back(printingJob("", Passed));
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  auto results = sandbox.runConcurrentSeries(
+      series, 3, [](const ExecutionResult &) { return true; });
+  auto elapsed = std::chrono::steady_clock::now() - start;
+
+  ASSERT_EQ(results.size(), 3U);
+  for (auto &result : results) {
+    ASSERT_EQ(result.size(), 2U);
+    ASSERT_EQ(result[1].status, Passed);
+  }
+  ASSERT_GE(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed)
+                .count(),
+            300);
+  ASSERT_EQ(resources.memoryBudget()->waits(), 0U);
+}
+
+#pragma mark - Batches
+
+static SandboxJob pidPrintingJob(ExecutionStatus status) {
+  return SandboxJob(
+      [=]() {
+        printf("%d", int(getpid()));
+        return status;
+      },
+      Timeout);
+}
+
+static auto proceedAlways = [](const ExecutionResult &) { return true; };
+
+TEST(BatchProcessSandbox, runSeries_RunsTheTestsInOneChild) {
+  BatchProcessSandbox sandbox;
+
+  std::vector<SandboxJob> jobs;
+  jobs.push_back(pidPrintingJob(Passed));
+  jobs.push_back(pidPrintingJob(Failed));
+  jobs.emplace_back(
+      [&]() {
+        fprintf(stderr, "third");
+        return ExecutionStatus::Passed;
+      },
+      Timeout);
+
+  auto results = sandbox.runSeries(jobs, proceedAlways);
+
+  ASSERT_EQ(results.size(), 3U);
+  ASSERT_EQ(results[0].status, Passed);
+  ASSERT_EQ(results[1].status, Failed);
+  ASSERT_EQ(results[2].status, Passed);
+  ASSERT_FALSE(results[0].stdoutOutput.empty());
+  ASSERT_EQ(results[0].stdoutOutput.str(), results[1].stdoutOutput.str());
+  ASSERT_NE(results[0].stdoutOutput.str(), std::to_string(getpid()));
+  ASSERT_TRUE(results[2].stdoutOutput.empty());
+  ASSERT_EQ(results[2].stderrOutput, "third");
+
+  /// Only the first test paid for the fork
+  ASSERT_GT(results[0].timings.fork, 0);
+  ASSERT_EQ(results[1].timings.fork, 0);
+}
+
+TEST(BatchProcessSandbox, runSeries_UsageOfEveryTest) {
+  BatchProcessSandbox sandbox;
+
+  std::vector<SandboxJob> jobs;
+  jobs.emplace_back([&]() { return spin(100); }, Timeout);
+  jobs.push_back(pidPrintingJob(Passed));
+
+  auto results = sandbox.runSeries(jobs, proceedAlways);
+
+  ASSERT_EQ(results.size(), 2U);
+  auto busy = results[0].usage.userTime + results[0].usage.systemTime;
+  auto idle = results[1].usage.userTime + results[1].usage.systemTime;
+  ASSERT_GT(busy, 20000);
+  ASSERT_LT(idle, busy);
+  ASSERT_GT(results[1].usage.maxResident, 0);
+}
+
+TEST(BatchProcessSandbox, runSeries_RunsACrashedTestAgainOnItsOwn) {
+  BatchProcessSandbox sandbox;
+
+  /// The second test only crashes after the first one ran in the process
+  static bool dirty = false;
+  std::vector<SandboxJob> jobs;
+  jobs.emplace_back(
+      [&]() {
+        dirty = true;
+        return ExecutionStatus::Passed;
+      },
+      Timeout);
+  jobs.emplace_back(
+      [&]() {
+        if (dirty) {
+          abort();
+        }
+        return ExecutionStatus::Passed;
+      },
+      Timeout);
+  jobs.emplace_back(
+      [&]() {
+        abort();
+        return ExecutionStatus::Passed;
+      },
+      Timeout);
+  jobs.push_back(pidPrintingJob(Passed));
+
+  auto results = sandbox.runSeries(jobs, proceedAlways);
+
+  ASSERT_EQ(results.size(), 4U);
+  ASSERT_EQ(results[0].status, Passed);
+  ASSERT_EQ(results[1].status, Passed);
+  ASSERT_EQ(results[2].status, Crashed);
+  ASSERT_EQ(results[3].status, Passed);
+  ASSERT_FALSE(dirty);
+}
+
+TEST(BatchProcessSandbox, runSeries_Timeout) {
+  BatchProcessSandbox sandbox;
+
+  std::vector<SandboxJob> jobs;
+  jobs.push_back(pidPrintingJob(Passed));
+  jobs.emplace_back(
+      [&]() {
+        printf("sleeping");
+        fflush(stdout);
+        sleep(3);
+        return ExecutionStatus::Passed;
+      },
+      100);
+  jobs.push_back(pidPrintingJob(Passed));
+
+  auto results = sandbox.runSeries(jobs, proceedAlways);
+
+  ASSERT_EQ(results.size(), 3U);
+  ASSERT_EQ(results[0].status, Passed);
+  ASSERT_EQ(results[1].status, Timedout);
+  ASSERT_EQ(results[1].stdoutOutput, "sleeping");
+  ASSERT_LT(results[1].runningTime, 2000);
+  ASSERT_EQ(results[2].status, Passed);
+  ASSERT_NE(results[0].stdoutOutput.str(), results[2].stdoutOutput.str());
+}
+
+TEST(BatchProcessSandbox, runSeries_StopsWhenAskedTo) {
+  BatchProcessSandbox sandbox;
+
+  std::vector<SandboxJob> jobs;
+  jobs.push_back(pidPrintingJob(Passed));
+  jobs.push_back(pidPrintingJob(Failed));
+  jobs.push_back(pidPrintingJob(Passed));
+
+  auto results = sandbox.runSeries(jobs, [](const ExecutionResult &result) {
+    return result.status == Passed;
+  });
+
+  ASSERT_EQ(results.size(), 2U);
+  ASSERT_EQ(results[1].status, Failed);
+}
+
+TEST(BatchProcessSandbox, runSeries_RunsThePrologueOnceBeforeTheTests) {
+  BatchProcessSandbox sandbox;
+
+  auto jobs = prologueCountingJobs(3, 0);
+  auto results = sandbox.runSeries(jobs, proceedAlways);
+
+  ASSERT_EQ(results.size(), 3U);
+  for (auto &result : results) {
+    ASSERT_EQ(result.status, Passed);
+    ASSERT_EQ(result.stdoutOutput, "job");
+  }
+}
+
+#pragma mark - Output capture
+
+TEST(ForkProcessSandbox, captureOutput_IsCappedByLimit) {
+  ForkProcessSandbox sandbox(16);
+
+  ExecutionResult result = sandbox.run(
+      [&]() {
+        /// Way more than the pipe buffer, the child must not block on it
+        for (int i = 0; i < 100000; i++) {
+          printf("0123456789");
+        }
+        return ExecutionStatus::Passed;
+      },
+      Timeout);
+
+  ASSERT_EQ(result.status, Passed);
+  ASSERT_EQ(result.stdoutOutput, "0123456789012345");
+}
+
+TEST(ForkProcessSandbox, captureOutput_DropsOutputOfPassedRuns) {
+  ForkProcessSandbox sandbox(ForkProcessSandbox::DefaultOutputLimit, false);
+
+  ExecutionResult passed = sandbox.run(
+      [&]() {
+        printf("passed");
+        return ExecutionStatus::Passed;
+      },
+      Timeout);
+  ExecutionResult failed = sandbox.run(
+      [&]() {
+        printf("failed");
+        return ExecutionStatus::Failed;
+      },
+      Timeout);
+
+  ASSERT_EQ(passed.status, Passed);
+  ASSERT_TRUE(passed.stdoutOutput.empty());
+  ASSERT_EQ(failed.status, Failed);
+  ASSERT_EQ(failed.stdoutOutput, "failed");
+}
+
+#pragma mark - Snapshots
+
+TEST(SnapshotProcessSandbox, runSeries_ReusesTheChildOfWellBehavedTests) {
+  SnapshotProcessSandbox sandbox;
+
+  std::vector<SandboxJob> jobs;
+  jobs.push_back(pidPrintingJob(Passed));
+  jobs.push_back(pidPrintingJob(Failed));
+
+  auto results = sandbox.runSeries(jobs, proceedAlways);
+
+  ASSERT_EQ(results.size(), 2U);
+  ASSERT_EQ(results[0].status, Passed);
+  ASSERT_EQ(results[1].status, Failed);
+  ASSERT_NE(results[0].stdoutOutput.str(), std::to_string(getpid()));
+  ASSERT_EQ(results[0].stdoutOutput.str(), results[1].stdoutOutput.str());
+}
+
+TEST(SnapshotProcessSandbox, runSeries_NewChildOnceATestChangedTheHeap) {
+  SnapshotProcessSandbox sandbox;
+
+  /// A global that owns heap memory, as a global vector the test grew
+  static std::vector<char> *grown = new std::vector<char>();
+  std::vector<SandboxJob> jobs;
+  jobs.push_back(pidPrintingJob(Passed));
+  jobs.emplace_back(
+      [&]() {
+        grown->resize(1 << 20);
+        printf("%d", int(getpid()));
+        return ExecutionStatus::Passed;
+      },
+      Timeout);
+  jobs.emplace_back(
+      [&]() {
+        printf("%d", int(getpid()));
+        return grown->empty() ? ExecutionStatus::Passed
+                              : ExecutionStatus::Failed;
+      },
+      Timeout);
+
+  auto results = sandbox.runSeries(jobs, proceedAlways);
+
+  ASSERT_EQ(results.size(), 3U);
+  ASSERT_EQ(results[0].stdoutOutput.str(), results[1].stdoutOutput.str());
+  ASSERT_NE(results[1].stdoutOutput.str(), results[2].stdoutOutput.str());
+  ASSERT_EQ(results[2].status, Passed);
+  ASSERT_TRUE(grown->empty());
+}
+
+TEST(SnapshotProcessSandbox, runSeries_ThrowsTheChildAwayOnTimeout) {
+  SnapshotProcessSandbox sandbox;
+
+  std::vector<SandboxJob> jobs;
+  jobs.push_back(pidPrintingJob(Passed));
+  jobs.emplace_back(
+      [&]() {
+        volatile bool running = true;
+        while (running) {
+        }
+        return ExecutionStatus::Passed;
+      },
+      100);
+  jobs.push_back(pidPrintingJob(Passed));
+
+  auto results = sandbox.runSeries(jobs, proceedAlways);
+
+  ASSERT_EQ(results.size(), 3U);
+  ASSERT_EQ(results[1].status, Timedout);
+  ASSERT_EQ(results[2].status, Passed);
+  ASSERT_NE(results[0].stdoutOutput.str(), results[2].stdoutOutput.str());
+}
+
+TEST(SnapshotProcessSandbox, run_ForksForATestOnItsOwn) {
+  SnapshotProcessSandbox sandbox;
+  const pid_t mull = getpid();
+
+  ExecutionResult crashed = sandbox.run(
+      [&]() {
+        raise(SIGSEGV);
+        return ExecutionStatus::Passed;
+      },
+      Timeout);
+  ExecutionResult passed = sandbox.run(
+      [&]() {
+        return getpid() != mull ? ExecutionStatus::Passed
+                                : ExecutionStatus::Failed;
+      },
+      Timeout);
+
+  ASSERT_EQ(crashed.status, Crashed);
+  ASSERT_EQ(passed.status, Passed);
+}
+
+#pragma mark - Child resources
+
+TEST(ForkProcessSandbox, childResources_LimitTheChildren) {
+  ChildResourcesConfig config;
+  config.openFiles = 16;
+  ChildResources resources(config);
+
+  auto openFilesLimit = []() {
+    struct rlimit limit {};
+    getrlimit(RLIMIT_NOFILE, &limit);
+    return limit.rlim_cur == 16 ? ExecutionStatus::Passed
+                                : ExecutionStatus::Failed;
+  };
+
+  ForkProcessSandbox sandbox(ForkProcessSandbox::DefaultOutputLimit, true,
+                             &resources);
+  ASSERT_EQ(sandbox.run(openFilesLimit, Timeout).status, Passed);
+
+  BatchProcessSandbox batchSandbox(ForkProcessSandbox::DefaultOutputLimit,
+                                   true, &resources);
+  std::vector<SandboxJob> jobs({SandboxJob(openFilesLimit, Timeout)});
+  auto results = batchSandbox.runSeries(
+      jobs, [](const ExecutionResult &) { return true; });
+  ASSERT_EQ(results.size(), 1U);
+  ASSERT_EQ(results.front().status, Passed);
+
+  ForkProcessSandbox unlimited;
+  ASSERT_EQ(unlimited.run(openFilesLimit, Timeout).status, Failed);
+}
+
+#pragma mark - Timings
+
+TEST(ForkProcessSandbox, timings_CoverTheStagesOfTheRun) {
+  ForkProcessSandbox sandbox;
+
+  ExecutionResult result = sandbox.run(
+      [&]() {
+        usleep(20 * 1000);
+        return ExecutionStatus::Passed;
+      },
+      Timeout);
+
+  ASSERT_EQ(result.status, Passed);
+  ASSERT_GT(result.timings.fork, 0);
+  ASSERT_GT(result.timings.forkToStart, 0);
+  ASSERT_GE(result.timings.test, 20 * 1000 * 1000);
+  ASSERT_GE(result.timings.reap, 0);
+}
+
+TEST(ForkServerProcessSandbox, timings_AreSentBackByTheServer) {
+  ForkServerProcessSandbox sandbox;
+
+  std::vector<SandboxJob> jobs;
+  jobs.emplace_back(
+      [&]() {
+        usleep(20 * 1000);
+        return ExecutionStatus::Passed;
+      },
+      Timeout);
+
+  auto results =
+      sandbox.runSeries(jobs, [](const ExecutionResult &) { return true; });
+
+  ASSERT_EQ(results.size(), 1U);
+  ASSERT_GT(results[0].timings.fork, 0);
+  ASSERT_GE(results[0].timings.test, 20 * 1000 * 1000);
+}
+
+TEST(NullProcessSandbox, timings_AreNotMeasured) {
+  NullProcessSandbox sandbox;
+
+  ExecutionResult result =
+      sandbox.run([&]() { return ExecutionStatus::Passed; }, Timeout);
+
+  ASSERT_EQ(result.timings.fork, 0);
+  ASSERT_EQ(result.timings.test, 0);
+}
@@ -18,6 +18,7 @@
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Module.h>
 #include <llvm/Support/DynamicLibrary.h>
+#include <llvm/Support/FileSystem.h>
 #include <llvm/Support/SourceMgr.h>
 #include <llvm/Support/YAMLTraits.h>
 
@@ -61,6 +62,28 @@ mutators:
   ASSERT_EQ("HelloTest.testSumOfTestee2", tests[1].getTestName());
 }
 
+TEST(GoogleTestFinder, FindTest_LazyLoading) {
+  LLVMContext llvmContext;
+  ModuleLoader loader;
+  bool lazy = true;
+  auto ModuleWithTests = loader.loadModuleAtPath(
+      fixtures::google_test_google_test_Test_bc_path(), llvmContext, lazy);
+
+  std::vector<std::unique_ptr<MullModule>> modules;
+  modules.push_back(std::move(ModuleWithTests));
+  Program program({}, {}, std::move(modules));
+
+  Filter filter;
+  GoogleTestFinder Finder;
+
+  auto tests = Finder.findTests(program, filter);
+
+  ASSERT_EQ(2U, tests.size());
+
+  ASSERT_EQ("HelloTest.testSumOfTestee", tests[0].getTestName());
+  ASSERT_EQ("HelloTest.testSumOfTestee2", tests[1].getTestName());
+}
+
 TEST(GoogleTestFinder, findTests_filter) {
   LLVMContext llvmContext;
   ModuleLoader loader;
@@ -93,6 +116,223 @@ mutators:
   ASSERT_EQ("HelloTest.testSumOfTestee", tests[0].getTestName());
 }
 
+static std::vector<Test> findTestsWithCache(const std::string &directory,
+                                            Filter &filter,
+                                            uint64_t &cachedModules) {
+  LLVMContext llvmContext;
+  ModuleLoader loader;
+  std::vector<std::unique_ptr<MullModule>> modules;
+  modules.push_back(loader.loadModuleAtPath(
+      fixtures::google_test_google_test_Test_bc_path(), llvmContext));
+  Program program({}, {}, std::move(modules));
+
+  GoogleTestFinder finder;
+  finder.setCache(make_unique<TestSearchCache>(directory, "GoogleTest"));
+  auto tests = finder.findTests(program, filter);
+  for (auto &test : tests) {
+    EXPECT_NE(nullptr, test.getTestBody());
+  }
+  cachedModules = finder.getCachedModules();
+  return tests;
+}
+
+TEST(GoogleTestFinder, findTests_fromTheCache) {
+  SmallString<128> directory;
+  ASSERT_FALSE(sys::fs::createUniqueDirectory("mull-tests", directory));
+
+  Filter filter;
+  uint64_t cachedModules = 0;
+  auto searched = findTestsWithCache(directory.c_str(), filter, cachedModules);
+  ASSERT_EQ(2U, searched.size());
+  ASSERT_EQ(0U, cachedModules);
+
+  /// The filter applies to the tests of the cache as well
+  filter.includeTest("HelloTest.testSumOfTestee2");
+  auto restored = findTestsWithCache(directory.c_str(), filter, cachedModules);
+  ASSERT_EQ(1U, cachedModules);
+  ASSERT_EQ(1U, restored.size());
+  ASSERT_EQ("HelloTest.testSumOfTestee2", restored[0].getTestName());
+  ASSERT_EQ("main", restored[0].getDriverFunctionName());
+  ASSERT_EQ(std::vector<std::string>(
+                {"--gtest_filter=HelloTest.testSumOfTestee2"}),
+            restored[0].getArguments());
+}
+
+/// A module with one test, registered the way the GoogleTest macros do
+static const char *const RegisteredTest = R"(
+%"class.testing::TestInfo" = type { i8 }
+@.str = private unnamed_addr constant [SUITE_SIZE x i8] c"SUITE\00"
+@.str.1 = private unnamed_addr constant [TEST_SIZE x i8] c"TEST\00"
+@_ZNBODY_SIZEBODY10test_info_E = global %"class.testing::TestInfo"* null
+
+declare %"class.testing::TestInfo"* @_ZN7testing8internal23MakeAndRegisterTestInfoEPKcS2_(i8*, i8*)
+
+define void @__cxx_global_var_init() {
+  %call = call %"class.testing::TestInfo"* @_ZN7testing8internal23MakeAndRegisterTestInfoEPKcS2_(i8* getelementptr inbounds ([SUITE_SIZE x i8], [SUITE_SIZE x i8]* @.str, i32 0, i32 0), i8* getelementptr inbounds ([TEST_SIZE x i8], [TEST_SIZE x i8]* @.str.1, i32 0, i32 0))
+  store %"class.testing::TestInfo"* %call, %"class.testing::TestInfo"** @_ZNBODY_SIZEBODY10test_info_E
+  ret void
+}
+
+define void @_ZNBODY_SIZEBODY8TestBodyEv() {
+  ret void
+}
+)";
+
+static std::string registeredTest(const std::string &suite,
+                                  const std::string &test) {
+  auto body = suite + "_" + test + "_Test";
+  std::vector<std::pair<std::string, std::string>> replacements(
+      {{"SUITE_SIZE", std::to_string(suite.size() + 1)},
+       {"TEST_SIZE", std::to_string(test.size() + 1)},
+       {"BODY_SIZE", std::to_string(body.size())},
+       {"SUITE", suite},
+       {"TEST", test},
+       {"BODY", body}});
+  std::string text = RegisteredTest;
+  for (auto &replacement : replacements) {
+    size_t position = 0;
+    while ((position = text.find(replacement.first, position)) !=
+           std::string::npos) {
+      text.replace(position, replacement.first.size(), replacement.second);
+      position += replacement.second.size();
+    }
+  }
+  return text;
+}
+
+TEST(GoogleTestFinder, findTests_onAllTheWorkers) {
+  LLVMContext llvmContext;
+  std::vector<std::unique_ptr<MullModule>> modules;
+  std::vector<std::pair<std::string, std::string>> registered(
+      {{"Parser", "parsesNumbers"},
+       {"Lexer", "skipsComments"},
+       {"Parser", "parsesStrings"}});
+  for (auto &suiteAndTest : registered) {
+    SMDiagnostic error;
+    auto module = parseAssemblyString(
+        registeredTest(suiteAndTest.first, suiteAndTest.second), error,
+        llvmContext);
+    ASSERT_NE(nullptr, module);
+    module->setModuleIdentifier(suiteAndTest.second);
+    modules.push_back(make_unique<MullModule>(
+        std::move(module), std::unique_ptr<MemoryBuffer>(), "hash"));
+  }
+  SMDiagnostic error;
+  auto withoutTests =
+      parseAssemblyString("define void @helper() {\n"
+                          "  ret void\n"
+                          "}\n",
+                          error, llvmContext);
+  ASSERT_NE(nullptr, withoutTests);
+  modules.push_back(make_unique<MullModule>(
+      std::move(withoutTests), std::unique_ptr<MemoryBuffer>(), "hash"));
+  Program program({}, {}, std::move(modules));
+
+  /// The later modules have their own copy of the type, with a suffix
+  ASSERT_EQ(3U, program.globalsPointingTo("class.testing::TestInfo").size());
+
+  Filter filter;
+  GoogleTestFinder finder(2);
+  auto tests = finder.findTests(program, filter);
+
+  ASSERT_EQ(3U, tests.size());
+  ASSERT_EQ("Parser.parsesNumbers", tests[0].getTestName());
+  ASSERT_EQ("Lexer.skipsComments", tests[1].getTestName());
+  ASSERT_EQ("Parser.parsesStrings", tests[2].getTestName());
+  ASSERT_EQ("_ZN24Lexer_skipsComments_Test8TestBodyEv",
+            tests[1].getTestBody()->getName());
+}
+
+static const char *const TestList = R"(Running main() from gtest_main.cc
+Parser.
+  parsesNumbers
+Numbers/Parser.
+  parsesAll/0  # GetParam() = 1
+  parsesAll/1  # GetParam() = 2
+Stack/0.  # TypeParam = int
+  pushPops
+Stack/1.  # TypeParam = char
+  pushPops
+Stack/2.  # TypeParam = long
+  pushPops
+)";
+
+TEST(GoogleTestFinder, parseTestList) {
+  auto tests = GoogleTestFinder::parseTestList(TestList);
+
+  ASSERT_EQ(6U, tests.size());
+  ASSERT_EQ("Parser.parsesNumbers", tests[0].name);
+  ASSERT_EQ("", tests[0].typeParameter);
+  ASSERT_EQ("Numbers/Parser.parsesAll/1", tests[2].name);
+  ASSERT_EQ("", tests[2].typeParameter);
+  ASSERT_EQ("Stack/1.pushPops", tests[4].name);
+  ASSERT_EQ("char", tests[4].typeParameter);
+}
+
+/// The bodies of a parametrized test and of a typed test with two types
+static const char *const InstanceBodies = R"(
+declare void @_ZN7testing4TestC2Ev(i8*)
+
+define void @_ZN21Parser_parsesAll_Test8TestBodyEv() {
+  ret void
+}
+
+define void @_ZN19Stack_pushPops_TestIiE8TestBodyEv() {
+  ret void
+}
+
+define void @_ZN19Stack_pushPops_TestIcE8TestBodyEv() {
+  ret void
+}
+)";
+
+TEST(GoogleTestFinder, findRuntimeTests_perInstance) {
+  LLVMContext llvmContext;
+  std::vector<std::unique_ptr<MullModule>> modules;
+  SMDiagnostic error;
+  auto plain = parseAssemblyString(registeredTest("Parser", "parsesNumbers"),
+                                   error, llvmContext);
+  ASSERT_NE(nullptr, plain);
+  modules.push_back(make_unique<MullModule>(
+      std::move(plain), std::unique_ptr<MemoryBuffer>(), "hash"));
+  auto instances = parseAssemblyString(InstanceBodies, error, llvmContext);
+  ASSERT_NE(nullptr, instances);
+  instances->setModuleIdentifier("instances");
+  modules.push_back(make_unique<MullModule>(
+      std::move(instances), std::unique_ptr<MemoryBuffer>(), "hash"));
+  Program program({}, {}, std::move(modules));
+
+  Filter filter;
+  GoogleTestFinder finder;
+  auto tests = finder.findTests(program, filter);
+  ASSERT_EQ(1U, tests.size());
+  ASSERT_TRUE(finder.hasRuntimeTests());
+
+  std::vector<std::string> listingArguments;
+  finder.findRuntimeTests(
+      [&](mull::Test &test) {
+        listingArguments = test.getArguments();
+        return std::string(TestList);
+      },
+      filter, tests);
+
+  ASSERT_EQ(std::vector<std::string>({"--gtest_list_tests"}),
+            listingArguments);
+  /// The instance of a type without a body of its own is skipped
+  ASSERT_EQ(5U, tests.size());
+  ASSERT_EQ("Numbers/Parser.parsesAll/0", tests[1].getTestName());
+  ASSERT_EQ(std::vector<std::string>(
+                {"--gtest_filter=Numbers/Parser.parsesAll/0"}),
+            tests[1].getArguments());
+  ASSERT_EQ("_ZN21Parser_parsesAll_Test8TestBodyEv",
+            tests[2].getTestBody()->getName());
+  ASSERT_EQ("Stack/0.pushPops", tests[3].getTestName());
+  ASSERT_EQ("_ZN19Stack_pushPops_TestIiE8TestBodyEv",
+            tests[3].getTestBody()->getName());
+  ASSERT_EQ("_ZN19Stack_pushPops_TestIcE8TestBodyEv",
+            tests[4].getTestBody()->getName());
+}
+
 TEST(DISABLED_GoogleTestRunner, runTest) {
   const char *configYAML = R"YAML(
 mutators:
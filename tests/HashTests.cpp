@@ -0,0 +1,61 @@
+#include "mull/Hash.h"
+
+#include <llvm/AsmParser/Parser.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/SourceMgr.h>
+
+#include "gtest/gtest.h"
+
+using namespace mull;
+
+TEST(Hash, MD5KeepsTheExistingDigests) {
+  ASSERT_EQ("900150983cd24fb0d6963f7d28e17f72",
+            hashOf("abc", HashAlgorithm::MD5));
+}
+
+TEST(Hash, XXHash64MatchesTheReferenceDigests) {
+  ASSERT_EQ("xxh64-ef46db3751d8e999", hashOf("", HashAlgorithm::XXHash64));
+  ASSERT_EQ("xxh64-44bc2cf5ad770999", hashOf("abc", HashAlgorithm::XXHash64));
+}
+
+TEST(Hash, XXHash64DoesNotDependOnHowTheInputIsSplit) {
+  std::string input;
+  for (int i = 0; i < 1000; i++) {
+    input.push_back(char(i * 7));
+  }
+  auto expected = hashOf(input, HashAlgorithm::XXHash64);
+
+  for (size_t piece : {1, 3, 31, 32, 33, 100}) {
+    Hasher hasher(HashAlgorithm::XXHash64);
+    for (size_t offset = 0; offset < input.size(); offset += piece) {
+      hasher.update(llvm::StringRef(input).substr(offset, piece));
+    }
+    ASSERT_EQ(expected, hasher.final());
+  }
+}
+
+TEST(Hash, FunctionCodeDoesNotDependOnTheName) {
+  llvm::LLVMContext context;
+  llvm::SMDiagnostic error;
+  auto module = llvm::parseAssemblyString("define i32 @first(i32 %a) {\n"
+                                          "  %b = add i32 %a, 1\n"
+                                          "  ret i32 %b\n"
+                                          "}\n"
+                                          "define i32 @second(i32 %a) {\n"
+                                          "  %b = add i32 %a, 1\n"
+                                          "  ret i32 %b\n"
+                                          "}\n"
+                                          "define i32 @third(i32 %a) {\n"
+                                          "  %b = sub i32 %a, 1\n"
+                                          "  ret i32 %b\n"
+                                          "}\n",
+                                          error, context);
+  ASSERT_NE(nullptr, module);
+
+  auto first = hashOfFunctionCode(*module->getFunction("first"));
+  ASSERT_EQ(first, hashOfFunctionCode(*module->getFunction("second")));
+  ASSERT_NE(first, hashOfFunctionCode(*module->getFunction("third")));
+  ASSERT_NE(hashOfFunctionBody(*module->getFunction("first")),
+            hashOfFunctionBody(*module->getFunction("second")));
+}
@@ -0,0 +1,56 @@
+#include "gtest/gtest.h"
+
+#include "mull/Metrics/Histogram.h"
+
+#include <thread>
+#include <vector>
+
+using namespace mull;
+
+TEST(Histogram, BucketsBoundTheirValues) {
+  ASSERT_EQ(0U, Histogram::bucketIndex(0));
+  ASSERT_EQ(63U, Histogram::bucketIndex(63));
+  ASSERT_EQ(63U, Histogram::bucketUpperBound(63));
+
+  for (uint64_t value : {64ULL, 65ULL, 1000ULL, 123456789ULL, ~0ULL}) {
+    auto index = Histogram::bucketIndex(value);
+    ASSERT_GE(Histogram::bucketUpperBound(index), value);
+    ASSERT_LT(Histogram::bucketUpperBound(index - 1), value);
+    /// Within 1/32 of the value
+    ASSERT_LE(Histogram::bucketUpperBound(index) - value, value / 32);
+  }
+}
+
+TEST(Histogram, ReportsPercentiles) {
+  Histogram histogram;
+  ASSERT_EQ(0U, histogram.percentile(50));
+
+  for (uint64_t value = 1; value <= 100; value++) {
+    histogram.record(value * 1000);
+  }
+
+  ASSERT_EQ(100U, histogram.count());
+  ASSERT_EQ(100000U, histogram.max());
+  ASSERT_NEAR(50000.0, double(histogram.percentile(50)), 50000.0 / 32);
+  ASSERT_NEAR(90000.0, double(histogram.percentile(90)), 90000.0 / 32);
+  ASSERT_NEAR(99000.0, double(histogram.percentile(99)), 99000.0 / 32);
+  ASSERT_EQ(100000U, histogram.percentile(100));
+}
+
+TEST(Histogram, RecordsFromManyThreads) {
+  Histogram histogram;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([&histogram, i]() {
+      for (uint64_t value = 0; value < 10000; value++) {
+        histogram.record(value + i);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_EQ(40000U, histogram.count());
+  ASSERT_EQ(10002U, histogram.max());
+}
@@ -0,0 +1,92 @@
+#include "mull/Reporters/IDEReporter.h"
+
+#include "mull/Config/RawConfig.h"
+#include "mull/Logger.h"
+#include "mull/Metrics/Metrics.h"
+#include "mull/Result.h"
+
+#include "MutationPointsFixture.h"
+#include "StdoutCapture.h"
+
+#include "gtest/gtest.h"
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/raw_ostream.h>
+
+using namespace mull;
+using namespace llvm;
+
+class IDEReporterTest : public MutationPointsFixture {
+protected:
+  void SetUp() override {
+    MutationPointsFixture::SetUp();
+    SmallString<128> path;
+    ASSERT_FALSE(sys::fs::createUniqueDirectory("mull-ide-reporter", path));
+    directory = path.str().str();
+    writeSource("a.cpp");
+    writeSource("b.cpp");
+
+    /// Neither the files nor the mutants come in order
+    addPoint("b.cpp", 3);
+    addPoint("a.cpp", 9);
+    addPoint("a.cpp", 2);
+    addPoint("b.cpp", 1);
+    addPoint("a.cpp", 5);
+  }
+
+  void TearDown() override { sys::fs::remove_directories(directory); }
+
+  void writeSource(const std::string &file) {
+    std::error_code error;
+    raw_fd_ostream source(directory + "/" + file, error, sys::fs::F_None);
+    ASSERT_FALSE(error);
+    for (int line = 1; line <= 10; line++) {
+      source << file << " line " << line << "\n";
+    }
+  }
+
+  void addPoint(const std::string &file, int line) {
+    MutationPointsFixture::addPoint(
+        mutator, "mutated",
+        SourceLocation(directory, directory + "/" + file, line, 3));
+  }
+
+  /// The warning of a mutant, its line and the caret under its column
+  std::string warning(const std::string &file, int line) {
+    return directory + "/" + file + ":" + std::to_string(line) +
+           ":3: warning: \n" + file + " line " + std::to_string(line) +
+           "\n  ^\n";
+  }
+
+  std::string report(size_t maxMutantsPerFile) {
+    Result result(std::vector<mull::Test>(), MutationResultTable(),
+                  allPoints());
+    Metrics metrics;
+    IDEReporter reporter(maxMutantsPerFile);
+
+    Logger::setLevel(Logger::Level::info);
+    StdoutCapture capture;
+    reporter.reportResults(result, RawConfig(), metrics);
+    return capture.finish();
+  }
+
+  std::string directory;
+};
+
+TEST_F(IDEReporterTest, reportsTheFilesByPathAndTheMutantsByLine) {
+  ASSERT_EQ("\nSurvived mutants (5/5):\n\n" + warning("a.cpp", 2) +
+                warning("a.cpp", 5) + warning("a.cpp", 9) +
+                warning("b.cpp", 1) + warning("b.cpp", 3) +
+                "Mutation score: 0%\n",
+            report(0));
+}
+
+TEST_F(IDEReporterTest, countsTheMutantsPastTheLimitOfAFile) {
+  ASSERT_EQ("\nSurvived mutants (5/5):\n\n" + warning("a.cpp", 2) +
+                warning("a.cpp", 5) + directory +
+                "/a.cpp: note: 1 more survived mutants in this file\n" +
+                warning("b.cpp", 1) + warning("b.cpp", 3) +
+                "Mutation score: 0%\n",
+            report(2));
+}
@@ -0,0 +1,171 @@
+#include "mull/Config/Configuration.h"
+#include "mull/Toolchain/CountingMemoryManager.h"
+#include "mull/Toolchain/JITEngine.h"
+#include "mull/Toolchain/Toolchain.h"
+
+#include <llvm/AsmParser/Parser.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/SourceMgr.h>
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+using namespace mull;
+using namespace llvm;
+
+static int32_t externalValue = 1000;
+
+/// Only knows the one symbol none of the objects define
+class ExternalValueResolver : public llvm_compat::SymbolResolver {
+public:
+  explicit ExternalValueResolver(std::string name) : name(std::move(name)) {}
+
+  llvm_compat::JITSymbolInfo findSymbol(const std::string &symbol) override {
+    if (symbol == name) {
+      return llvm_compat::JITSymbolInfo((uint64_t)&externalValue,
+                                        JITSymbolFlags::Exported);
+    }
+    return llvm_compat::JITSymbolInfo(nullptr);
+  }
+
+  llvm_compat::JITSymbolInfo
+  findSymbolInLogicalDylib(const std::string &symbol) override {
+    return llvm_compat::JITSymbolInfo(nullptr);
+  }
+
+private:
+  std::string name;
+};
+
+/// Every function of the chain calls the one of the next module, the last
+/// one reads the external value
+static std::string chainModule(int index, int count) {
+  auto name = std::to_string(index);
+  auto next = std::to_string(index + 1);
+  if (index + 1 == count) {
+    return "@external_value = external global i32\n"
+           "define i32 @chain_" +
+           name +
+           "() {\n"
+           "  %value = load i32, i32* @external_value\n"
+           "  ret i32 %value\n"
+           "}\n";
+  }
+  return "declare i32 @chain_" + next +
+         "()\n"
+         "define i32 @chain_" +
+         name +
+         "() {\n"
+         "  %next = call i32 @chain_" +
+         next +
+         "()\n"
+         "  %value = add i32 %next, 1\n"
+         "  ret i32 %value\n"
+         "}\n";
+}
+
+TEST(JITEngine, parallelLinkingRelocatesAcrossTheShards) {
+  Configuration configuration;
+  Toolchain toolchain(configuration);
+  auto &mangler = toolchain.mangler();
+
+  /// Enough objects for several shards on a machine with several cores
+  const int count = 64;
+  LLVMContext context;
+  std::vector<object::OwningBinary<object::ObjectFile>> ownedObjectFiles;
+  std::vector<object::ObjectFile *> objectFiles;
+  for (int index = 0; index < count; index++) {
+    SMDiagnostic error;
+    auto source = chainModule(index, count);
+    auto module = parseAssemblyString(source, error, context);
+    ASSERT_NE(nullptr, module);
+    ownedObjectFiles.push_back(toolchain.compiler().compileModule(
+        module.get(), toolchain.targetMachine()));
+    objectFiles.push_back(ownedObjectFiles.back().getBinary());
+  }
+
+  JITEngine jit(JITLinking::Parallel);
+  jit.addObjectFiles(
+      objectFiles,
+      make_unique<ExternalValueResolver>(
+          mangler.getNameWithPrefix("external_value")),
+      []() { return make_unique<CountingMemoryManager>(); });
+
+  auto &symbol = jit.getSymbol(mangler.getNameWithPrefix("chain_0"));
+  auto chain = (int32_t(*)())llvm_compat::JITSymbolAddress(symbol);
+  ASSERT_NE(nullptr, chain);
+  ASSERT_EQ(externalValue + count - 1, chain());
+
+  /// Once resolved up front, the lookups only read the symbol table
+  jit.resolveAllSymbols();
+  auto lastName =
+      mangler.getNameWithPrefix("chain_" + std::to_string(count - 1));
+  ASSERT_NE(0U, llvm_compat::JITSymbolAddress(jit.getSymbol(lastName)));
+  auto missingName = mangler.getNameWithPrefix("no_such_symbol");
+  ASSERT_EQ(0U, llvm_compat::JITSymbolAddress(jit.getSymbol(missingName)));
+}
+
+/// A function inlined in several modules, with the static local it counts
+/// its calls with
+static std::string counterModule(const std::string &caller) {
+  return "@counter_calls = linkonce_odr global i32 0\n"
+         "define linkonce_odr i32 @counter() {\n"
+         "  %calls = load i32, i32* @counter_calls\n"
+         "  %next = add i32 %calls, 1\n"
+         "  store i32 %next, i32* @counter_calls\n"
+         "  ret i32 %next\n"
+         "}\n"
+         "define i32 @" +
+         caller +
+         "() {\n"
+         "  %calls = call i32 @counter()\n"
+         "  ret i32 %calls\n"
+         "}\n";
+}
+
+TEST(JITEngine, parallelLinkingKeepsOneCopyOfTheWeakDefinitions) {
+  Configuration configuration;
+  Toolchain toolchain(configuration);
+  auto &mangler = toolchain.mangler();
+
+  /// The first and the last objects are in different shards on a machine
+  /// with several cores
+  const int count = 64;
+  LLVMContext context;
+  std::vector<object::OwningBinary<object::ObjectFile>> ownedObjectFiles;
+  std::vector<object::ObjectFile *> objectFiles;
+  for (int index = 0; index < count; index++) {
+    SMDiagnostic error;
+    auto source = index == 0 ? counterModule("first")
+                  : index == count - 1
+                      ? counterModule("last")
+                      : "define i32 @filler_" + std::to_string(index) +
+                            "() {\n"
+                            "  ret i32 0\n"
+                            "}\n";
+    auto module = parseAssemblyString(source, error, context);
+    ASSERT_NE(nullptr, module);
+    ownedObjectFiles.push_back(toolchain.compiler().compileModule(
+        module.get(), toolchain.targetMachine()));
+    objectFiles.push_back(ownedObjectFiles.back().getBinary());
+  }
+
+  JITEngine jit(JITLinking::Parallel);
+  jit.addObjectFiles(
+      objectFiles, make_unique<ExternalValueResolver>("no_external_value"),
+      []() { return make_unique<CountingMemoryManager>(); });
+
+  auto first = (int32_t(*)())llvm_compat::JITSymbolAddress(
+      jit.getSymbol(mangler.getNameWithPrefix("first")));
+  auto last = (int32_t(*)())llvm_compat::JITSymbolAddress(
+      jit.getSymbol(mangler.getNameWithPrefix("last")));
+  ASSERT_NE(nullptr, first);
+  ASSERT_NE(nullptr, last);
+
+  /// Both objects count their calls with the same static local
+  ASSERT_EQ(1, first());
+  ASSERT_EQ(2, last());
+  ASSERT_EQ(3, first());
+}
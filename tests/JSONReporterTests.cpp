@@ -0,0 +1,162 @@
+#include "mull/Reporters/JSONReporter.h"
+
+#include "FixturePaths.h"
+#include "mull/Config/Configuration.h"
+#include "mull/Config/RawConfig.h"
+#include "mull/Filter.h"
+#include "mull/Metrics/Metrics.h"
+#include "mull/ModuleLoader.h"
+#include "mull/MutationsFinder.h"
+#include "mull/Mutators/MathAddMutator.h"
+#include "mull/Program/Program.h"
+#include "mull/Result.h"
+#include "mull/TestFrameworks/SimpleTest/SimpleTestFinder.h"
+#include "mull/Testee.h"
+
+#include "gtest/gtest.h"
+
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
+
+#include <chrono>
+#include <thread>
+
+using namespace mull;
+using namespace llvm;
+
+static std::vector<std::string> readLines(const std::string &path) {
+  std::vector<std::string> lines;
+  auto buffer = MemoryBuffer::getFile(path);
+  if (!buffer) {
+    return lines;
+  }
+  SmallVector<StringRef, 8> parts;
+  buffer.get()->getBuffer().split(parts, '\n', -1, false);
+  for (auto &part : parts) {
+    lines.push_back(part.str());
+  }
+  return lines;
+}
+
+class JSONReporterTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    std::vector<std::unique_ptr<MullModule>> modules;
+    modules.push_back(loader.loadModuleAtPath(
+        fixtures::simple_test_count_letters_test_count_letters_bc_path(),
+        context));
+    modules.push_back(loader.loadModuleAtPath(
+        fixtures::simple_test_count_letters_count_letters_bc_path(),
+        context));
+    program = make_unique<Program>(std::vector<std::string>(), ObjectFiles(),
+                                   std::move(modules));
+
+    std::vector<std::unique_ptr<Mutator>> mutators;
+    mutators.emplace_back(make_unique<MathAddMutator>());
+    mutationsFinder =
+        make_unique<MutationsFinder>(std::move(mutators), configuration);
+
+    SimpleTestFinder testFinder;
+    tests = testFinder.findTests(*program, filter);
+
+    Function *testee = program->lookupDefinedFunction("count_letters");
+    std::vector<std::unique_ptr<Testee>> testees;
+    testees.emplace_back(make_unique<Testee>(testee, nullptr, 1));
+    auto mergedTestees = mergeTestees(testees);
+    mutationPoints =
+        mutationsFinder->getMutationPoints(*program, mergedTestees, filter);
+  }
+
+  std::unique_ptr<MutationResult> mutationResult(ExecutionStatus status) {
+    ExecutionResult executionResult;
+    executionResult.status = status;
+    executionResult.runningTime = 7;
+    return make_unique<MutationResult>(executionResult, mutationPoints.front(),
+                                       1, &tests.front());
+  }
+
+  LLVMContext context;
+  ModuleLoader loader;
+  std::unique_ptr<Program> program;
+  Configuration configuration;
+  Filter filter;
+  std::unique_ptr<MutationsFinder> mutationsFinder;
+  std::vector<mull::Test> tests;
+  std::vector<MutationPoint *> mutationPoints;
+};
+
+TEST_F(JSONReporterTest, WritesARecordPerMutationResult) {
+  ASSERT_EQ(1U, mutationPoints.size());
+
+  std::vector<std::unique_ptr<MutationResult>> mutationResults;
+  mutationResults.push_back(mutationResult(ExecutionStatus::Failed));
+  mutationResults.push_back(mutationResult(ExecutionStatus::Passed));
+
+  Result result(std::move(tests), std::move(mutationResults), mutationPoints);
+  Metrics metrics;
+  metrics.setDriverRunTime(MetricsMeasure());
+
+  JSONReporter reporter("json test");
+  reporter.reportResults(result, RawConfig(), metrics);
+
+  auto lines = readLines(reporter.getPath());
+  sys::fs::remove(reporter.getPath());
+  ASSERT_EQ(3U, lines.size());
+
+  std::string pointId = mutationPoints.front()->getUniqueIdentifier();
+  ASSERT_EQ(0U, lines[0].find("{\"version\": 1, \"type\": "
+                              "\"mutation_result\", \"mutation_point\": \"" +
+                              pointId + "\""));
+  ASSERT_NE(std::string::npos, lines[0].find("\"status\": \"Failed\", "
+                                             "\"killed\": true, "
+                                             "\"duration\": 7, "
+                                             "\"distance\": 1"));
+  ASSERT_NE(std::string::npos, lines[1].find("\"killed\": false"));
+  ASSERT_NE(std::string::npos,
+            lines[2].find("\"type\": \"summary\", \"project\": \"\", "
+                          "\"tests\": 1, \"mutation_points\": 1, "
+                          "\"mutation_results\": 2, \"killed\": 1, "
+                          "\"latencies\": {}}"));
+}
+
+TEST_F(JSONReporterTest, StreamsTheRecordsFromTheWorkers) {
+  ASSERT_EQ(1U, mutationPoints.size());
+
+  JSONReporter reporter("json streaming test", 1);
+  reporter.beginStreaming();
+
+  std::vector<std::unique_ptr<MutationResult>> mutationResults;
+  for (int i = 0; i < 8; i++) {
+    mutationResults.push_back(mutationResult(ExecutionStatus::Failed));
+  }
+
+  std::vector<std::thread> workers;
+  for (int worker = 0; worker < 4; worker++) {
+    workers.emplace_back([&reporter, &mutationResults, worker]() {
+      reporter.reportMutationResult(*mutationResults[worker * 2]);
+      reporter.reportMutationResult(*mutationResults[worker * 2 + 1]);
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  /// The records are on disk before the run is reported
+  std::vector<std::string> lines;
+  for (int attempt = 0; attempt < 1000 && lines.size() < 8; attempt++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    lines = readLines(reporter.getPath());
+  }
+  ASSERT_EQ(8U, lines.size());
+
+  Result result(std::move(tests), std::move(mutationResults), mutationPoints);
+  Metrics metrics;
+  metrics.setDriverRunTime(MetricsMeasure());
+  reporter.reportResults(result, RawConfig(), metrics);
+
+  lines = readLines(reporter.getPath());
+  sys::fs::remove(reporter.getPath());
+  ASSERT_EQ(9U, lines.size());
+  ASSERT_NE(std::string::npos, lines[8].find("\"type\": \"summary\""));
+}
@@ -0,0 +1,12 @@
+#include "mull/JSON.h"
+
+#include "gtest/gtest.h"
+
+using namespace mull;
+
+TEST(JSON, escapesTheQuotesAndTheControlCharacters) {
+  ASSERT_EQ("plain", escapeJSON("plain"));
+  ASSERT_EQ("say \\\"hi\\\" C:\\\\", escapeJSON("say \"hi\" C:\\"));
+  ASSERT_EQ("a\\nb\\r\\tc", escapeJSON("a\nb\r\tc"));
+  ASSERT_EQ("bell\\u0007", escapeJSON("bell\a"));
+}
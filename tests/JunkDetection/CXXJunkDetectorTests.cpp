@@ -24,6 +24,8 @@
 #include <llvm/IR/Module.h>
 #include <mull/Mutators/AndOrReplacementMutator.h>
 
+#include <map>
+
 #include "gtest/gtest.h"
 
 using namespace mull;
@@ -94,6 +96,18 @@ TEST_P(CXXJunkDetectorTest, detectJunk) {
   }
 
   ASSERT_EQ(nonJunkMutationPoints.size(), parameter.nonJunkMutants);
+
+  /// The batches of the search get the same verdicts
+  CXXJunkDetector batchDetector(junkConfig);
+  std::map<llvm::Function *, std::vector<MutationPoint *>> batches;
+  for (auto point : points) {
+    batches[point->getOriginalFunction()].push_back(point);
+  }
+  std::vector<MutationPoint *> classified;
+  for (auto &batch : batches) {
+    batchDetector.classify(batch.second, classified);
+  }
+  ASSERT_EQ(size_t(parameter.nonJunkMutants), classified.size());
 }
 
 static const CXXJunkDetectorTestParameter parameters[] = {
@@ -2,6 +2,9 @@
 #include "mull/JunkDetection/CXX/CompilationDatabase.h"
 
 #include <clang/Basic/Version.h>
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/raw_ostream.h>
 
 #include <gtest/gtest.h>
 
@@ -114,3 +117,39 @@ TEST(CompilationDatabaseFromFile, includesCompilationFlagsPassedSeparately) {
   ASSERT_EQ(compilationFlags.at(6), std::string("-isystem"));
   ASSERT_EQ(compilationFlags.at(7), std::string("/usr/include"));
 }
+
+TEST(CompilationDatabaseFromFile, findsEntriesAmongOthers) {
+  llvm::SmallString<128> path;
+  int descriptor = -1;
+  ASSERT_FALSE(llvm::sys::fs::createTemporaryFile("compile_commands", "json",
+                                                  descriptor, path));
+  {
+    llvm::raw_fd_ostream stream(descriptor, true);
+    stream << "[\n"
+              "{ \"directory\": \"/foo\", \"file\": \"/foo/first.cpp\",\n"
+              "  \"command\": \"clang++ -DBRACES=\\\"{[\\\" -c first.cpp\" },\n"
+              "{ \"directory\": \"/foo\",\n"
+              "  \"command\": \"clang++ -I foo -c second.cpp\",\n"
+              "  \"file\": \"\\/foo\\/second.cpp\" },\n"
+              "{ \"file\": \"third.cpp\", \"directory\": \"/foo\",\n"
+              "  \"command\": \"clang++ -I third -c third.cpp\" }\n"
+              "]\n";
+  }
+
+  const CompilationDatabase database(
+      CompilationDatabase::Path(std::string(path.str())),
+      CompilationDatabase::Flags("-DEXTRA"));
+  llvm::sys::fs::remove(path);
+
+  auto first = database.compilationFlagsForFile("/foo/first.cpp");
+  ASSERT_EQ(std::vector<std::string>({"-DBRACES=\"{[\"", "-DEXTRA"}), first);
+
+  auto second = database.compilationFlagsForFile("/foo/second.cpp");
+  ASSERT_EQ(std::vector<std::string>({"-I", "foo", "-DEXTRA"}), second);
+
+  auto third = database.compilationFlagsForFile("/bar/third.cpp");
+  ASSERT_EQ(std::vector<std::string>({"-I", "third", "-DEXTRA"}), third);
+
+  auto unknown = database.compilationFlagsForFile("/foo/unknown.cpp");
+  ASSERT_EQ(std::vector<std::string>({"-DEXTRA"}), unknown);
+}
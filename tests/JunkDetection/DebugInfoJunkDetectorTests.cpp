@@ -0,0 +1,63 @@
+#include "FixturePaths.h"
+#include "mull/Config/Configuration.h"
+#include "mull/Filter.h"
+#include "mull/JunkDetection/DebugInfoJunkDetector.h"
+#include "mull/ModuleLoader.h"
+#include "mull/MutationPoint.h"
+#include "mull/MutationsFinder.h"
+#include "mull/Mutators/MathAddMutator.h"
+#include "mull/Program/Program.h"
+#include "mull/Testee.h"
+
+#include <llvm/IR/DebugInfoMetadata.h>
+#include <llvm/IR/Instruction.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+
+#include "gtest/gtest.h"
+
+using namespace mull;
+using namespace llvm;
+
+TEST(DebugInfoJunkDetector, leavesTheAmbiguousPointsToTheNextDetector) {
+  LLVMContext llvmContext;
+  ModuleLoader loader;
+  auto mullModule = loader.loadModuleAtPath(
+      fixtures::mutators_math_add_module_bc_path(), llvmContext);
+  auto module = mullModule->getModule();
+
+  std::vector<std::unique_ptr<MullModule>> modules;
+  modules.push_back(std::move(mullModule));
+  Program program({}, {}, std::move(modules));
+  Configuration configuration;
+
+  std::vector<std::unique_ptr<Mutator>> mutators;
+  mutators.emplace_back(make_unique<MathAddMutator>());
+  MutationsFinder finder(std::move(mutators), configuration);
+  Filter filter;
+
+  std::vector<std::unique_ptr<Testee>> testees;
+  for (auto &function : *module) {
+    testees.emplace_back(make_unique<Testee>(&function, nullptr, 1));
+  }
+  auto mergedTestees = mergeTestees(testees);
+  std::vector<MutationPoint *> points =
+      finder.getMutationPoints(program, mergedTestees, filter);
+  ASSERT_LT(1U, points.size());
+
+  /// A location at column 0 is junk without looking at the source
+  auto instruction = cast<Instruction>(points.front()->getOriginalValue());
+  auto location = instruction->getDebugLoc().get();
+  ASSERT_NE(nullptr, location);
+  instruction->setDebugLoc(DILocation::get(
+      llvmContext, location->getLine(), 0, location->getScope()));
+
+  DebugInfoJunkDetector detector(make_unique<NullJunkDetector>());
+  std::vector<MutationPoint *> nonJunk;
+  detector.classify(points, nonJunk);
+
+  ASSERT_EQ(points.size() - 1, nonJunk.size());
+  ASSERT_EQ(1U, detector.getMetrics().debugInfoVerdicts);
+  ASSERT_TRUE(detector.isJunk(points.front()));
+  ASSERT_FALSE(detector.isJunk(points.back()));
+}
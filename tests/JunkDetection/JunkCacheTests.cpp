@@ -0,0 +1,110 @@
+#include "mull/JunkDetection/JunkCache.h"
+
+#include "CacheDirectoryFixture.h"
+
+#include "gtest/gtest.h"
+
+#include <fstream>
+
+using namespace mull;
+using namespace llvm;
+
+static void writeFile(const std::string &path, const std::string &contents) {
+  std::ofstream stream(path);
+  stream << contents;
+}
+
+namespace {
+class JunkCacheTest : public CacheDirectoryFixture {
+protected:
+  void SetUp() override {
+    directory = createCacheDirectory();
+    source = directory + "/source.cpp";
+    header = directory + "/header.h";
+    writeFile(source, "#include \"header.h\"\nint sum(int a, int b);\n");
+    writeFile(header, "#define SUM(a, b) a + b\n");
+    flags = {"-I", directory};
+  }
+
+  void storeVerdicts() {
+    JunkCache cache(directory, "1");
+    ASSERT_FALSE(cache.load(source, flags));
+
+    auto dependencies = [this]() {
+      return std::vector<std::string>({source, header});
+    };
+    cache.store(source, "add:2:10:source.cpp", false, dependencies);
+    cache.store(source, "add:1:20:header.h", true, dependencies);
+    cache.save();
+  }
+
+  std::string directory;
+  std::string source;
+  std::string header;
+  std::vector<std::string> flags;
+};
+} // namespace
+
+TEST_F(JunkCacheTest, reusesVerdictsOfUnchangedFiles) {
+  storeVerdicts();
+
+  JunkCache cache(directory, "1");
+  ASSERT_TRUE(cache.load(source, flags));
+
+  bool junk = true;
+  ASSERT_TRUE(cache.lookup(source, "add:2:10:source.cpp", junk));
+  ASSERT_FALSE(junk);
+  ASSERT_TRUE(cache.lookup(source, "add:1:20:header.h", junk));
+  ASSERT_TRUE(junk);
+  ASSERT_FALSE(cache.lookup(source, "sub:2:10:source.cpp", junk));
+  ASSERT_EQ(2u, cache.getHits());
+}
+
+TEST_F(JunkCacheTest, dropsVerdictsWhenHeaderChanges) {
+  storeVerdicts();
+  writeFile(header, "#define SUM(a, b) (a + b)\n");
+
+  JunkCache cache(directory, "1");
+  ASSERT_FALSE(cache.load(source, flags));
+  bool junk = false;
+  ASSERT_FALSE(cache.lookup(source, "add:1:20:header.h", junk));
+}
+
+TEST_F(JunkCacheTest, dropsVerdictsWhenFlagsOrVersionChange) {
+  storeVerdicts();
+
+  JunkCache otherFlags(directory, "1");
+  ASSERT_FALSE(otherFlags.load(source, {"-DNDEBUG"}));
+
+  JunkCache otherVersion(directory, "2");
+  ASSERT_FALSE(otherVersion.load(source, flags));
+}
+
+TEST_F(JunkCacheTest, keepsNewVerdictsOfValidFiles) {
+  storeVerdicts();
+
+  {
+    JunkCache cache(directory, "1");
+    ASSERT_TRUE(cache.load(source, flags));
+    cache.store(source, "sub:2:10:source.cpp", true,
+                []() { return std::vector<std::string>(); });
+    cache.save();
+  }
+
+  JunkCache cache(directory, "1");
+  ASSERT_TRUE(cache.load(source, flags));
+  bool junk = false;
+  ASSERT_TRUE(cache.lookup(source, "sub:2:10:source.cpp", junk));
+  ASSERT_TRUE(junk);
+  ASSERT_TRUE(cache.lookup(source, "add:2:10:source.cpp", junk));
+  ASSERT_FALSE(junk);
+}
+
+TEST(JunkCache, isDisabledWithoutDirectory) {
+  JunkCache cache("", "1");
+  ASSERT_FALSE(cache.load("source.cpp", {}));
+  cache.store("source.cpp", "add:1:1:source.cpp", true,
+              []() { return std::vector<std::string>({"source.cpp"}); });
+  bool junk = false;
+  ASSERT_FALSE(cache.lookup("source.cpp", "add:1:1:source.cpp", junk));
+}
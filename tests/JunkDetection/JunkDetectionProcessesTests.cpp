@@ -0,0 +1,69 @@
+#include "FixturePaths.h"
+#include "mull/Config/Configuration.h"
+#include "mull/Filter.h"
+#include "mull/JunkDetection/JunkDetectionProcesses.h"
+#include "mull/JunkDetection/JunkDetector.h"
+#include "mull/ModuleLoader.h"
+#include "mull/MutationPoint.h"
+#include "mull/MutationsFinder.h"
+#include "mull/Mutators/MathAddMutator.h"
+#include "mull/Program/Program.h"
+#include "mull/Testee.h"
+
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+
+#include <cstdlib>
+
+#include "gtest/gtest.h"
+
+using namespace mull;
+using namespace llvm;
+
+namespace {
+
+/// Takes its helper down, as a file the parser crashes on would
+class CrashingJunkDetector : public JunkDetector {
+public:
+  bool isJunk(MutationPoint *point) override { abort(); }
+};
+
+} // namespace
+
+TEST(JunkDetectionProcesses, keepsTheVerdictsOfTheHelpers) {
+  LLVMContext llvmContext;
+  ModuleLoader loader;
+  auto mullModule = loader.loadModuleAtPath(
+      fixtures::mutators_math_add_module_bc_path(), llvmContext);
+  auto module = mullModule->getModule();
+
+  std::vector<std::unique_ptr<MullModule>> modules;
+  modules.push_back(std::move(mullModule));
+  Program program({}, {}, std::move(modules));
+  Configuration configuration;
+
+  std::vector<std::unique_ptr<Mutator>> mutators;
+  mutators.emplace_back(make_unique<MathAddMutator>());
+  MutationsFinder finder(std::move(mutators), configuration);
+  Filter filter;
+
+  std::vector<std::unique_ptr<Testee>> testees;
+  for (auto &function : *module) {
+    testees.emplace_back(make_unique<Testee>(&function, nullptr, 1));
+  }
+  auto mergedTestees = mergeTestees(testees);
+  std::vector<MutationPoint *> points =
+      finder.getMutationPoints(program, mergedTestees, filter);
+  ASSERT_LT(1U, points.size());
+
+  JunkDetectionMetrics metrics;
+  AllJunkDetector allJunk;
+  ASSERT_TRUE(detectJunkInProcesses(allJunk, points, 3, metrics).empty());
+
+  NullJunkDetector noJunk;
+  ASSERT_EQ(points, detectJunkInProcesses(noJunk, points, 3, metrics));
+
+  /// The points of a helper that did not answer are kept
+  CrashingJunkDetector crashing;
+  ASSERT_EQ(points, detectJunkInProcesses(crashing, points, 3, metrics));
+}
@@ -0,0 +1,43 @@
+#include "mull/JunkDetection/CXX/SharedIncludes.h"
+
+#include "gtest/gtest.h"
+
+using namespace mull;
+
+TEST(SharedIncludes, findsLeadingSystemIncludes) {
+  const char *source = "// Copyright\n"
+                       "/* A comment\n"
+                       "   over two lines */\n"
+                       "#include \"own.h\"\n"
+                       "#pragma once\n"
+                       "#include <vector>\n"
+                       "#  include   <llvm/ADT/StringRef.h>\n"
+                       "\n"
+                       "int answer();\n"
+                       "#include <map>\n";
+
+  std::vector<std::string> expected({"vector", "llvm/ADT/StringRef.h"});
+  ASSERT_EQ(expected, leadingSystemIncludes(source));
+}
+
+TEST(SharedIncludes, stopsAtConditionalsAndDefinitions) {
+  std::vector<std::string> expected({"vector"});
+  ASSERT_EQ(expected, leadingSystemIncludes("#include <vector>\n"
+                                            "#define _GNU_SOURCE\n"
+                                            "#include <string.h>\n"));
+  ASSERT_EQ(expected, leadingSystemIncludes("#include <vector>\n"
+                                            "#ifdef __APPLE__\n"
+                                            "#include <mach/mach.h>\n"
+                                            "#endif\n"));
+  ASSERT_EQ(expected, leadingSystemIncludes("#include <vector>\n"
+                                            "#include HEADER\n"
+                                            "#include <map>\n"));
+}
+
+TEST(SharedIncludes, keepsHeadersIncludedTwiceInOrder) {
+  std::vector<std::vector<std::string>> includes(
+      {{"vector", "map", "unistd.h"}, {"string", "map"}, {"map", "string"}});
+
+  std::vector<std::string> expected({"map", "string"});
+  ASSERT_EQ(expected, sharedSystemIncludes(includes));
+}
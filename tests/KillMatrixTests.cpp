@@ -0,0 +1,103 @@
+#include "mull/KillMatrix.h"
+
+#include "mull/TestFrameworks/Test.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include <unistd.h>
+
+#include "MutationPointsFixture.h"
+
+#include "gtest/gtest.h"
+
+using namespace mull;
+using namespace llvm;
+
+class KillMatrixTest : public MutationPointsFixture {
+protected:
+  void SetUp() override {
+    MutationPointsFixture::SetUp();
+    for (int index = 0; index < 3; index++) {
+      rows.push_back(addPoint());
+    }
+    for (int index = 0; index < 6; index++) {
+      tests.emplace_back("test" + std::to_string(index), "mull", "mull",
+                         std::vector<std::string>(), nullptr);
+    }
+
+    path = "/tmp/mull-kill-matrix-test.XXXXXX";
+    close(mkstemp(&path[0]));
+  }
+
+  void TearDown() override { std::remove(path.c_str()); }
+
+  std::vector<MutationPoint *> rows;
+  std::vector<mull::Test> tests;
+  std::string path;
+};
+
+TEST_F(KillMatrixTest, packsTwoBitsPerCell) {
+  KillMatrix matrix(path, rows, tests);
+  ASSERT_TRUE(matrix.isMapped());
+  ASSERT_EQ(3U, matrix.getRowCount());
+  ASSERT_EQ(6U, matrix.getColumnCount());
+  ASSERT_EQ(2U, matrix.getRowSize());
+
+  matrix.set(*rows[1], tests[0], ExecutionStatus::Failed);
+  matrix.set(*rows[1], tests[3], ExecutionStatus::Passed);
+  matrix.set(*rows[1], tests[4], ExecutionStatus::Timedout);
+  matrix.set(*rows[1], tests[5], ExecutionStatus::FailFast);
+  matrix.set(*rows[2], tests[1], ExecutionStatus::Crashed);
+
+  ASSERT_EQ(KillMatrix::Cell::Killed, matrix.get(1, 0));
+  ASSERT_EQ(KillMatrix::Cell::NotRun, matrix.get(1, 1));
+  ASSERT_EQ(KillMatrix::Cell::Survived, matrix.get(1, 3));
+  ASSERT_EQ(KillMatrix::Cell::Abnormal, matrix.get(1, 4));
+  ASSERT_EQ(KillMatrix::Cell::NotRun, matrix.get(1, 5));
+  ASSERT_EQ(KillMatrix::Cell::Abnormal, matrix.get(2, 1));
+  ASSERT_EQ(0x42, matrix.getRow(1)[0]);
+  ASSERT_EQ(0x03, matrix.getRow(1)[1]);
+  ASSERT_EQ(0, matrix.getRow(0)[0]);
+
+  /// A cell is overwritten as a whole
+  matrix.set(*rows[1], tests[4], ExecutionStatus::Passed);
+  ASSERT_EQ(KillMatrix::Cell::Survived, matrix.get(1, 4));
+}
+
+TEST_F(KillMatrixTest, ignoresUnknownTests) {
+  std::vector<mull::Test> someTests(tests.begin(), tests.begin() + 2);
+  KillMatrix matrix(path, rows, someTests);
+  matrix.set(*rows[0], tests[5], ExecutionStatus::Failed);
+  ASSERT_EQ(0, matrix.getRow(0)[0]);
+}
+
+TEST_F(KillMatrixTest, copiesRows) {
+  KillMatrix matrix(path, rows, tests);
+  matrix.set(*rows[0], tests[2], ExecutionStatus::Failed);
+  matrix.copyRow(*rows[0], *rows[2]);
+  ASSERT_EQ(KillMatrix::Cell::Killed, matrix.get(2, 2));
+}
+
+TEST_F(KillMatrixTest, writesTheFile) {
+  {
+    KillMatrix matrix(path, rows, tests);
+    matrix.set(*rows[2], tests[5], ExecutionStatus::Failed);
+  }
+
+  std::ifstream file(path, std::ios::binary);
+  std::vector<char> content((std::istreambuf_iterator<char>(file)),
+                            std::istreambuf_iterator<char>());
+  ASSERT_EQ(sizeof(KillMatrix::Header) + 3 * 2, content.size());
+
+  KillMatrix::Header header;
+  memcpy(&header, content.data(), sizeof(header));
+  ASSERT_EQ(std::string("MULLKMX"), std::string(header.magic));
+  ASSERT_EQ(KillMatrix::Version, header.version);
+  ASSERT_EQ(2U, header.rowSize);
+  ASSERT_EQ(3U, header.rows);
+  ASSERT_EQ(6U, header.columns);
+  ASSERT_EQ(0x08, content[sizeof(header) + 2 * 2 + 1]);
+}
@@ -0,0 +1,77 @@
+#include "mull/Logger.h"
+
+#include <llvm/Support/raw_ostream.h>
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "StdoutCapture.h"
+
+#include "gtest/gtest.h"
+
+using namespace mull;
+
+TEST(Logger, asynchronous_keepsTheLinesOfTheThreadsWhole) {
+  Logger::setLevel(Logger::Level::info);
+  Logger::setAsynchronous(true);
+  StdoutCapture capture;
+
+  const int threadCount = 4;
+  const int linesPerThread = 50;
+  std::vector<std::thread> threads;
+  for (int thread = 0; thread < threadCount; thread++) {
+    threads.emplace_back([thread]() {
+      for (int line = 0; line < linesPerThread; line++) {
+        Logger::info() << "thread " << thread << " line " << line << "\n";
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  Logger::flush();
+
+  std::string output = capture.finish();
+  Logger::setAsynchronous(false);
+  Logger::setLevel(Logger::Level::error);
+
+  std::vector<int> nextLine(threadCount, 0);
+  std::istringstream lines(output);
+  std::string line;
+  int count = 0;
+  while (std::getline(lines, line)) {
+    int thread = -1;
+    int index = -1;
+    ASSERT_EQ(2, sscanf(line.c_str(), "thread %d line %d", &thread, &index))
+        << line;
+    ASSERT_EQ(nextLine[thread], index);
+    nextLine[thread]++;
+    count++;
+  }
+  ASSERT_EQ(threadCount * linesPerThread, count);
+}
+
+TEST(Logger, asynchronous_countsTheRepeatedLines) {
+  Logger::setLevel(Logger::Level::info);
+  Logger::setAsynchronous(true);
+  StdoutCapture capture;
+
+  for (int i = 0; i < 10; i++) {
+    Logger::info() << "the same line\n";
+  }
+  Logger::info() << "another line\n";
+  Logger::flush();
+
+  std::string output = capture.finish();
+  Logger::setAsynchronous(false);
+  Logger::setLevel(Logger::Level::error);
+
+  ASSERT_EQ("the same line\n"
+            "the same line\n"
+            "the same line\n"
+            "(the line above repeated 7 more times)\n"
+            "another line\n",
+            output);
+}
@@ -0,0 +1,86 @@
+#include "mull/Instrumentation/LoopBudget.h"
+
+#include <llvm/AsmParser/Parser.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Verifier.h>
+#include <llvm/Support/SourceMgr.h>
+
+#include <limits>
+
+#include "gtest/gtest.h"
+
+using namespace mull;
+using namespace llvm;
+
+static const char *NestedLoops =
+    "define void @loops(i32 %n) {\n"
+    "entry:\n"
+    "  br label %outer\n"
+    "outer:\n"
+    "  %i = phi i32 [ 0, %entry ], [ %i1, %latch ]\n"
+    "  br label %inner\n"
+    "inner:\n"
+    "  %j = phi i32 [ 0, %outer ], [ %j1, %inner ]\n"
+    "  %j1 = add i32 %j, 1\n"
+    "  %more = icmp slt i32 %j1, %n\n"
+    "  br i1 %more, label %inner, label %latch\n"
+    "latch:\n"
+    "  %i1 = add i32 %i, 1\n"
+    "  %again = icmp slt i32 %i1, %n\n"
+    "  br i1 %again, label %outer, label %exit\n"
+    "exit:\n"
+    "  ret void\n"
+    "}\n";
+
+static size_t callsTo(Function *function, StringRef name) {
+  size_t calls = 0;
+  for (auto &block : *function) {
+    for (auto &instruction : block) {
+      auto call = dyn_cast<CallInst>(&instruction);
+      if (call && call->getCalledFunction() &&
+          call->getCalledFunction()->getName() == name) {
+        calls++;
+      }
+    }
+  }
+  return calls;
+}
+
+TEST(LoopBudget, findsTheBackEdges) {
+  LLVMContext context;
+  SMDiagnostic error;
+  auto module = parseAssemblyString(NestedLoops, error, context);
+  ASSERT_NE(nullptr, module);
+
+  auto terminators = backEdgeTerminators(module->getFunction("loops"));
+  ASSERT_EQ(2U, terminators.size());
+}
+
+TEST(LoopBudget, countsDownOnEveryBackEdge) {
+  LLVMContext context;
+  SMDiagnostic error;
+  auto module = parseAssemblyString(NestedLoops, error, context);
+  ASSERT_NE(nullptr, module);
+  auto function = module->getFunction("loops");
+
+  injectLoopBudget(function);
+
+  ASSERT_FALSE(verifyModule(*module, &errs()));
+  ASSERT_NE(nullptr, module->getGlobalVariable("mull_loopBudget"));
+  ASSERT_EQ(2U, callsTo(function, "mull_loopBudgetExceeded"));
+  /// The loops still go back to where they did
+  ASSERT_EQ(2U, backEdgeTerminators(function).size());
+}
+
+TEST(LoopBudget, isAFactorOfTheOriginalRun) {
+  ASSERT_EQ(0U, loopBudgetOf(1000, 0));
+  ASSERT_EQ(MinimumLoopBudget, loopBudgetOf(0, 10));
+  ASSERT_EQ(MinimumLoopBudget, loopBudgetOf(1000, 10));
+  ASSERT_EQ(MinimumLoopBudget * 20, loopBudgetOf(MinimumLoopBudget * 2, 10));
+
+  auto max = std::numeric_limits<uint64_t>::max();
+  ASSERT_EQ(max, loopBudgetOf(max / 2, 10));
+  ASSERT_EQ(max, loopBudgetOf(max, 1));
+}
@@ -0,0 +1,73 @@
+#include "mull/MemoryBudget.h"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace mull;
+
+static const uint64_t Megabyte = 1024 * 1024;
+
+TEST(MemoryBudget, admitsAChildWhenNothingIsInFlight) {
+  MemoryBudget budget(100 * Megabyte, []() { return 200 * Megabyte; });
+  auto reservation = budget.admitChild();
+  budget.releaseChild(reservation, 0);
+  ASSERT_EQ(0U, budget.waits());
+}
+
+TEST(MemoryBudget, holdsBackTheChildrenThatDoNotFit) {
+  uint64_t resident = 40 * Megabyte;
+  MemoryBudget budget(90 * Megabyte, [&]() { return resident; });
+
+  /// The first child teaches the budget that a child takes 30 megabytes
+  auto first = budget.admitChild();
+  ASSERT_EQ(40 * Megabyte, first.residentBefore);
+  budget.releaseChild(first, 70 * Megabyte);
+
+  MemoryBudget::Reservation second;
+  MemoryBudget::Reservation third;
+  ASSERT_TRUE(budget.tryAdmitChild(second));
+  ASSERT_EQ(30 * Megabyte, second.bytes);
+  ASSERT_FALSE(budget.tryAdmitChild(third));
+
+  budget.releaseChild(second, 70 * Megabyte);
+  ASSERT_TRUE(budget.tryAdmitChild(third));
+  budget.releaseChild(third, 70 * Megabyte);
+}
+
+TEST(MemoryBudget, aWaitingChildIsAdmittedOnRelease) {
+  MemoryBudget budget(100 * Megabyte, []() { return 90 * Megabyte; });
+  auto first = budget.admitChild();
+  budget.releaseChild(first, 120 * Megabyte);
+
+  auto running = budget.admitChild();
+  std::atomic<bool> admitted(false);
+  std::thread waiting([&]() {
+    auto reservation = budget.admitChild();
+    admitted = true;
+    budget.releaseChild(reservation, 0);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  ASSERT_FALSE(admitted);
+
+  budget.releaseChild(running, 0);
+  waiting.join();
+  ASSERT_TRUE(admitted);
+  ASSERT_EQ(1U, budget.waits());
+}
+
+TEST(MemoryBudget, measuresTheImages) {
+  uint64_t resident = 10 * Megabyte;
+  MemoryBudget budget(100 * Megabyte, [&]() { return resident; });
+
+  auto image = budget.admitImage();
+  ASSERT_EQ(0U, image.bytes);
+  resident += 50 * Megabyte;
+  budget.imageLoaded(image);
+
+  auto second = budget.admitImage();
+  ASSERT_EQ(50 * Megabyte, second.bytes);
+  budget.imageLoaded(second);
+}
@@ -0,0 +1,162 @@
+#include "gtest/gtest.h"
+
+#include "mull/Metrics/LiveMetrics.h"
+#include "mull/Metrics/Metrics.h"
+
+#include <llvm/Support/raw_ostream.h>
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mull;
+
+static size_t occurrences(const std::string &string,
+                          const std::string &substring) {
+  size_t count = 0;
+  for (auto position = string.find(substring); position != std::string::npos;
+       position = string.find(substring, position + 1)) {
+    count++;
+  }
+  return count;
+}
+
+TEST(Metrics, RecordsNoTraceUnlessEnabled) {
+  Metrics metrics;
+  metrics.beginRun();
+  metrics.endRun();
+
+  std::string trace;
+  llvm::raw_string_ostream stream(trace);
+  metrics.writeTrace(stream);
+  stream.flush();
+
+  ASSERT_EQ(std::string("{\"traceEvents\":[\n\n]}\n"), trace);
+}
+
+TEST(Metrics, WritesATrackPerThread) {
+  Metrics metrics;
+  metrics.enableTracing();
+  metrics.beginRun();
+  std::thread worker([&]() {
+    metrics.beginSpan("Wait for context lock", "module \"a\"");
+    metrics.endSpan("Wait for context lock");
+  });
+  worker.join();
+  metrics.endRun();
+
+  std::string trace;
+  llvm::raw_string_ostream stream(trace);
+  metrics.writeTrace(stream);
+  stream.flush();
+
+  ASSERT_EQ(size_t(2), occurrences(trace, "\"name\":\"thread_name\""));
+  ASSERT_EQ(size_t(2), occurrences(trace, "\"ph\":\"B\""));
+  ASSERT_EQ(size_t(2), occurrences(trace, "\"ph\":\"E\""));
+  ASSERT_EQ(size_t(2), occurrences(trace, "\"name\":\"Run\""));
+  ASSERT_EQ(size_t(1),
+            occurrences(trace, "\"ph\":\"B\",\"pid\":1,\"tid\":1,"));
+  ASSERT_EQ(size_t(1),
+            occurrences(trace, "\"args\":{\"detail\":\"module \\\"a\\\"\"}"));
+}
+
+TEST(Metrics, ClosesTheSpansLeftOpen) {
+  Metrics metrics;
+  metrics.enableTracing();
+  metrics.beginReportResult();
+
+  std::string trace;
+  llvm::raw_string_ostream stream(trace);
+  metrics.writeTrace(stream);
+  stream.flush();
+
+  ASSERT_EQ(size_t(1), occurrences(trace, "\"ph\":\"B\""));
+  ASSERT_EQ(size_t(1), occurrences(trace, "\"ph\":\"E\""));
+}
+
+TEST(Metrics, KeepsTheSamplesOfEveryThread) {
+  Metrics metrics;
+  metrics.enableTracing();
+
+  const int samplesPerThread = 3000;
+  std::vector<std::thread> workers;
+  for (int i = 0; i < 4; i++) {
+    workers.emplace_back([&]() {
+      for (int sample = 0; sample < samplesPerThread; sample++) {
+        metrics.beginSpan("Run mutant");
+        metrics.endSpan("Run mutant");
+      }
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  std::string trace;
+  llvm::raw_string_ostream stream(trace);
+  metrics.writeTrace(stream);
+  stream.flush();
+
+  ASSERT_EQ(size_t(4), occurrences(trace, "\"name\":\"thread_name\""));
+  ASSERT_EQ(size_t(4 * samplesPerThread), occurrences(trace, "\"ph\":\"B\""));
+  ASSERT_EQ(size_t(4 * samplesPerThread), occurrences(trace, "\"ph\":\"E\""));
+}
+
+TEST(Metrics, MeasuresTheResidentMemory) {
+  MemoryUsage before = MemoryUsage::current();
+  ASSERT_NE(before.resident, 0U);
+  ASSERT_NE(before.peakResident, 0U);
+
+  std::vector<char> block(64 << 20, 1);
+  MemoryUsage after = MemoryUsage::current();
+  ASSERT_GT(after.resident, before.resident + (32 << 20));
+  ASSERT_GE(after.peakResident, after.resident);
+  ASSERT_EQ(block[block.size() - 1], 1);
+}
+
+TEST(Metrics, MeasuresTheHeap) {
+  MemoryUsage before = MemoryUsage::current();
+
+  std::vector<std::unique_ptr<char[]>> blocks(1 << 20);
+  for (auto &block : blocks) {
+    block.reset(new char[64]);
+  }
+  MemoryUsage allocated = MemoryUsage::current();
+  ASSERT_GT(allocated.heapLive, before.heapLive + (48 << 20));
+
+  /// Every other block is freed, malloc keeps the holes between the others
+  for (size_t index = 0; index < blocks.size(); index += 2) {
+    blocks[index].reset();
+  }
+  MemoryUsage freed = MemoryUsage::current();
+  ASSERT_LT(freed.heapLive, allocated.heapLive);
+#ifdef __GLIBC__
+  ASSERT_GT(freed.heapFree, allocated.heapFree + (24 << 20));
+  ASSERT_GT(freed.heapFragmentation(), 0U);
+#endif
+}
+
+TEST(Metrics, ServesThePhaseInProgress) {
+  Metrics metrics;
+  metrics.beginRun();
+  metrics.beginMutantsExecution();
+  LiveMetrics::shared().setProgress(3, 10, 4);
+
+  std::string live;
+  llvm::raw_string_ostream stream(live);
+  LiveMetrics::shared().write(stream);
+  stream.flush();
+  ASSERT_EQ(1U, occurrences(live, "mull_phase{mull_phase=\"Run mutants\"} 1"));
+  ASSERT_EQ(1U, occurrences(live, "mull_progress_done 3\n"));
+  ASSERT_EQ(1U, occurrences(live, "mull_progress_total 10\n"));
+  ASSERT_EQ(1U, occurrences(live, "# EOF\n"));
+
+  /// The run holds the other phases
+  metrics.endMutantsExecution();
+  live.clear();
+  LiveMetrics::shared().write(stream);
+  stream.flush();
+  ASSERT_EQ(1U, occurrences(live, "mull_phase{mull_phase=\"Run\"} 1"));
+  metrics.endRun();
+}
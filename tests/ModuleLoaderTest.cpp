@@ -18,3 +18,28 @@ TEST(ModuleLoaderTest, loadModuleFromBitcodeListFile) {
 
   ASSERT_EQ(modules.size(), 1U);
 }
+
+TEST(ModuleLoaderTest, loadsFunctionBodiesOnDemand) {
+  LLVMContext context;
+  ModuleLoader loader;
+  bool lazy = true;
+  auto module = loader.loadModuleAtPath(
+      fixtures::hardcode_fixture_simple_test_tester_module_bc_path(), context,
+      lazy);
+  ASSERT_NE(nullptr, module);
+
+  Function *function = nullptr;
+  for (auto &candidate : module->getModule()->functions()) {
+    if (candidate.isMaterializable()) {
+      function = &candidate;
+      break;
+    }
+  }
+  ASSERT_NE(nullptr, function);
+  ASSERT_TRUE(function->empty());
+  ASSERT_FALSE(function->isDeclaration());
+
+  ASSERT_TRUE(MullModule::materialize(function));
+  ASSERT_FALSE(function->isMaterializable());
+  ASSERT_FALSE(function->empty());
+}
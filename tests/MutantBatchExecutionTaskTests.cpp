@@ -0,0 +1,37 @@
+#include "mull/Parallelization/Tasks/MutantBatchExecutionTask.h"
+
+#include "MutationPointsFixture.h"
+
+#include "gtest/gtest.h"
+
+using namespace mull;
+using namespace llvm;
+
+class MutantBatchesTest : public MutationPointsFixture {
+protected:
+  void SetUp() override { parseModule({"first", "second", "third"}); }
+};
+
+TEST_F(MutantBatchesTest, batchesMutantsOfDifferentFunctions) {
+  auto first1 = addPoint("first");
+  auto first2 = addPoint("first");
+  auto second1 = addPoint("second");
+  auto third1 = addPoint("third");
+  auto first3 = addPoint("first");
+
+  auto batches = batchMutants(allPoints(), 2);
+
+  std::vector<std::vector<MutationPoint *>> expected(
+      {{first1, second1}, {third1}, {first2}, {first3}});
+  ASSERT_EQ(expected, batches);
+}
+
+TEST_F(MutantBatchesTest, runsEveryMutantOnItsOwnWithBatchesOfOne) {
+  auto first = addPoint("first");
+  auto second = addPoint("second");
+
+  auto batches = batchMutants(allPoints(), 0);
+
+  std::vector<std::vector<MutationPoint *>> expected({{first}, {second}});
+  ASSERT_EQ(expected, batches);
+}
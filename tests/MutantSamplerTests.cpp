@@ -0,0 +1,163 @@
+#include "mull/MutantSampler.h"
+
+#include "mull/Mutators/MathSubMutator.h"
+#include "mull/TestFrameworks/Test.h"
+
+#include "MutationPointsFixture.h"
+
+#include "gtest/gtest.h"
+
+using namespace mull;
+using namespace llvm;
+
+class MutantSamplerTest : public MutationPointsFixture {
+protected:
+  void SetUp() override { parseModule({"first", "second"}); }
+
+  MutationPoint *addPoint(Mutator &pointMutator, const char *function,
+                          const char *file) {
+    return MutationPointsFixture::addPoint(pointMutator, function,
+                                           SourceLocation("/", file, 1, 1));
+  }
+
+  /// A test that took the given milliseconds in the original run
+  mull::Test *addTest(long long runningTime) {
+    tests.push_back(
+        make_unique<mull::Test>("test", "mull", "mull",
+                                std::vector<std::string>(), nullptr));
+    ExecutionResult result;
+    result.status = Passed;
+    result.runningTime = runningTime;
+    tests.back()->setExecutionResult(result);
+    return tests.back().get();
+  }
+
+  MathAddMutator addMutator;
+  MathSubMutator subMutator;
+  std::vector<std::unique_ptr<mull::Test>> tests;
+};
+
+TEST_F(MutantSamplerTest, runsEveryMutantWithoutSampling) {
+  for (int i = 0; i < 5; i++) {
+    addPoint(addMutator, "first", "a.cpp");
+  }
+  MutantSampler sampler(SamplingConfig(), 1);
+  ASSERT_EQ(allPoints(), sampler.sample(allPoints()));
+}
+
+TEST_F(MutantSamplerTest, uniformSampleDependsOnTheSeedOnly) {
+  for (int i = 0; i < 20; i++) {
+    addPoint(addMutator, "first", "a.cpp");
+  }
+  SamplingConfig config;
+  config.strategy = SamplingStrategy::Uniform;
+  config.size = 5;
+  config.seed = 42;
+
+  auto sample = MutantSampler(config, 1).sample(allPoints());
+  ASSERT_EQ(5U, sample.size());
+  ASSERT_EQ(sample, MutantSampler(config, 4).sample(allPoints()));
+
+  /// The sample keeps the order of the mutants
+  auto all = allPoints();
+  auto position = all.begin();
+  for (auto point : sample) {
+    position = std::find(position, all.end(), point);
+    ASSERT_NE(all.end(), position);
+  }
+
+  config.size = 100;
+  ASSERT_EQ(all, MutantSampler(config, 1).sample(all));
+}
+
+TEST_F(MutantSamplerTest, stratifiedSampleKeepsTheShareOfEveryStratum) {
+  for (int i = 0; i < 8; i++) {
+    addPoint(addMutator, "first", "a.cpp");
+  }
+  for (int i = 0; i < 2; i++) {
+    addPoint(subMutator, "second", "b.cpp");
+  }
+
+  for (auto strategy : {SamplingStrategy::PerMutator, SamplingStrategy::PerFile,
+                        SamplingStrategy::PerFunction}) {
+    SamplingConfig config;
+    config.strategy = strategy;
+    config.size = 5;
+    auto sample = MutantSampler(config, 1).sample(allPoints());
+
+    ASSERT_EQ(5U, sample.size());
+    auto subtractions =
+        std::count_if(sample.begin(), sample.end(), [&](MutationPoint *point) {
+          return point->getMutator() == &subMutator;
+        });
+    ASSERT_EQ(1, subtractions);
+  }
+}
+
+TEST_F(MutantSamplerTest, timeBudgetTakesTheLargestSampleThatFits) {
+  auto cheap = addPoint(addMutator, "first", "a.cpp");
+  cheap->addReachableTest(addTest(300), 1);
+  auto alsoCheap = addPoint(addMutator, "first", "a.cpp");
+  alsoCheap->addReachableTest(addTest(100), 1);
+  alsoCheap->addReachableTest(addTest(200), 1);
+  auto expensive = addPoint(addMutator, "first", "a.cpp");
+  expensive->addReachableTest(addTest(900), 1);
+  auto average = addPoint(addMutator, "first", "a.cpp");
+  average->addReachableTest(addTest(500), 1);
+  ASSERT_EQ(300, estimatedMutantCost(alsoCheap));
+
+  SamplingConfig config;
+  config.strategy = SamplingStrategy::TimeBudget;
+  config.budget = 1;
+  ASSERT_EQ(std::vector<MutationPoint *>({cheap, alsoCheap}),
+            MutantSampler(config, 1).sample(allPoints()));
+
+  /// Two workers run the mutants twice as fast
+  ASSERT_EQ(std::vector<MutationPoint *>({cheap, alsoCheap, expensive,
+                                          average}),
+            MutantSampler(config, 2).sample(allPoints()));
+}
+
+TEST_F(MutantSamplerTest, shardsTakeAboutAsLong) {
+  auto quick = addPoint(addMutator, "first", "a.cpp");
+  quick->addReachableTest(addTest(100), 1);
+  auto slowest = addPoint(addMutator, "first", "a.cpp");
+  slowest->addReachableTest(addTest(900), 1);
+  auto average = addPoint(addMutator, "first", "a.cpp");
+  average->addReachableTest(addTest(400), 1);
+  auto slow = addPoint(addMutator, "second", "b.cpp");
+  slow->addReachableTest(addTest(500), 1);
+
+  ASSERT_EQ(allPoints(), shardMutants(allPoints(), 0, 1));
+  ASSERT_EQ(std::vector<MutationPoint *>({quick, slowest}),
+            shardMutants(allPoints(), 0, 2));
+  ASSERT_EQ(std::vector<MutationPoint *>({average, slow}),
+            shardMutants(allPoints(), 1, 2));
+
+  /// Every mutant is in exactly one shard
+  std::vector<MutationPoint *> all;
+  for (int index = 0; index < 3; index++) {
+    auto shard = shardMutants(allPoints(), index, 3);
+    all.insert(all.end(), shard.begin(), shard.end());
+  }
+  std::sort(all.begin(), all.end());
+  auto expected = allPoints();
+  std::sort(expected.begin(), expected.end());
+  ASSERT_EQ(expected, all);
+}
+
+TEST_F(MutantSamplerTest, longestMutantsRunFirst) {
+  auto quick = addPoint(addMutator, "first", "a.cpp");
+  quick->addReachableTest(addTest(100), 1);
+  auto slowest = addPoint(addMutator, "first", "a.cpp");
+  slowest->addReachableTest(addTest(900), 1);
+  auto alsoQuick = addPoint(addMutator, "first", "a.cpp");
+  alsoQuick->addReachableTest(addTest(100), 1);
+  auto slow = addPoint(addMutator, "second", "b.cpp");
+  slow->addReachableTest(addTest(300), 1);
+  slow->addReachableTest(addTest(200), 1);
+
+  /// The mutants of the same cost keep their order
+  ASSERT_EQ(std::vector<MutationPoint *>({slowest, slow, quick, alsoQuick}),
+            longestFirst(allPoints()));
+}
@@ -0,0 +1,118 @@
+#include "mull/MutationPointArena.h"
+
+#include "mull/Config/Configuration.h"
+#include "mull/Filter.h"
+#include "mull/MullModule.h"
+#include "mull/MutationPoint.h"
+#include "mull/MutationsFinder.h"
+#include "mull/Mutators/MathAddMutator.h"
+#include "mull/Program/Program.h"
+#include "mull/SourceLocation.h"
+#include "mull/Testee.h"
+
+#include <llvm/AsmParser/Parser.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/SourceMgr.h>
+
+#include "gtest/gtest.h"
+
+using namespace mull;
+using namespace llvm;
+
+static const char *const Assembly = R"IR(
+define i32 @sum(i32 %a, i32 %b) {
+  %first = add i32 %a, %b
+  %second = add i32 %first, %b
+  %third = sub i32 %second, %a
+  ret i32 %third
+}
+)IR";
+
+static std::unique_ptr<MullModule> parseModule(LLVMContext &context) {
+  SMDiagnostic error;
+  auto llvmModule = parseAssemblyString(Assembly, error, context);
+  EXPECT_NE(nullptr, llvmModule);
+  return make_unique<MullModule>(std::move(llvmModule),
+                                 std::unique_ptr<MemoryBuffer>(), "hash");
+}
+
+TEST(MutationPointArena, internsTheSharedStrings) {
+  LLVMContext context;
+  auto module = parseModule(context);
+  auto function = module->getModule()->getFunction("sum");
+  MathAddMutator mutator;
+
+  auto first = module->createMutationPoint(
+      &mutator, MutationPointAddress(0, 0, 0), nullptr, function,
+      "Math Add: replaced + with -", SourceLocation::nullSourceLocation());
+  auto second = module->createMutationPoint(
+      &mutator, MutationPointAddress(0, 0, 1), nullptr, function,
+      "Math Add: replaced + with -", SourceLocation::nullSourceLocation());
+
+  ASSERT_EQ("Math Add: replaced + with -", first->getDiagnostics());
+  ASSERT_EQ(&first->getDiagnostics(), &second->getDiagnostics());
+
+  ASSERT_EQ("", first->getFunctionHash());
+  first->setFunctionHash("function");
+  second->setFunctionHash(std::string("function"));
+  ASSERT_EQ("function", second->getFunctionHash());
+  ASSERT_EQ(&first->getFunctionHash(), &second->getFunctionHash());
+
+  second->setMutantHash("mutant");
+  ASSERT_EQ("", first->getMutantHash());
+  ASSERT_EQ("mutant", second->getMutantHash());
+}
+
+TEST(MutationPointArena, derivesTheIdentifiers) {
+  LLVMContext context;
+  auto module = parseModule(context);
+  auto function = module->getModule()->getFunction("sum");
+  MathAddMutator mutator;
+
+  auto point = module->createMutationPoint(
+      &mutator, MutationPointAddress(0, 1, 2), nullptr, function, "",
+      SourceLocation::nullSourceLocation());
+
+  ASSERT_EQ("0_1_2", point->getAddress().getIdentifier());
+  ASSERT_EQ(module->getUniqueIdentifier() + "_0_1_2_" +
+                mutator.getUniqueIdentifier(),
+            point->getUniqueIdentifier());
+  ASSERT_EQ(point->getUniqueIdentifier(), point->getMutatedFunctionName());
+}
+
+TEST(MutationPointArena, pointsOfAFunctionShareTheirStringsAndTests) {
+  LLVMContext context;
+  std::vector<std::unique_ptr<MullModule>> modules;
+  modules.push_back(parseModule(context));
+  auto module = modules.front().get();
+  Program program({}, {}, std::move(modules));
+
+  std::vector<std::unique_ptr<Testee>> testees;
+  testees.emplace_back(
+      make_unique<Testee>(module->getModule()->getFunction("sum"), nullptr, 1));
+  auto merged = mergeTestees(testees);
+
+  Configuration configuration;
+  Filter filter;
+  std::vector<std::unique_ptr<Mutator>> mutators;
+  mutators.emplace_back(make_unique<MathAddMutator>());
+  MutationsFinder finder(std::move(mutators), configuration);
+  auto points = finder.getMutationPoints(program, merged, filter);
+
+  ASSERT_EQ(2U, points.size());
+  for (auto point : points) {
+    ASSERT_EQ(module, point->getOriginalModule());
+    ASSERT_EQ("Math Add: replaced + with -", point->getDiagnostics());
+    ASSERT_FALSE(point->getFunctionHash().empty());
+  }
+  ASSERT_EQ(&points[0]->getDiagnostics(), &points[1]->getDiagnostics());
+  ASSERT_EQ(&points[0]->getFunctionHash(), &points[1]->getFunctionHash());
+  ASSERT_NE(points[0]->getUniqueIdentifier(), points[1]->getUniqueIdentifier());
+
+  /// The points refer to the list of the testee rather than copy it
+  ASSERT_EQ(merged.front().getSharedReachableTests(),
+            points[0]->getSharedReachableTests());
+  ASSERT_EQ(merged.front().getSharedReachableTests(),
+            points[1]->getSharedReachableTests());
+}
@@ -22,6 +22,7 @@
 #include <llvm/IR/Instructions.h>
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Module.h>
+#include <llvm/IR/Verifier.h>
 #include <llvm/Support/SourceMgr.h>
 #include <llvm/Transforms/Utils/Cloning.h>
 
@@ -408,3 +409,287 @@ TEST(MutationPoint, SimpleTest_ReplaceAssignmentMutator_applyMutation) {
       mutationPoint->getOriginalFunction());
   ASSERT_TRUE(isa<StoreInst>(mutatedInstruction));
 }
+
+TEST(MutationPoint, SimpleTest_findInstruction_usesKnownInstruction) {
+  LLVMContext llvmContext;
+  ModuleLoader loader;
+  auto ModuleWithTestees = loader.loadModuleAtPath(
+      fixtures::simple_test_count_letters_count_letters_bc_path(), llvmContext);
+
+  std::vector<std::unique_ptr<MullModule>> modules;
+  modules.push_back(std::move(ModuleWithTestees));
+  Program program({}, {}, std::move(modules));
+
+  Configuration configuration;
+
+  std::vector<std::unique_ptr<Mutator>> mutators;
+  mutators.emplace_back(make_unique<MathAddMutator>());
+  MutationsFinder finder(std::move(mutators), configuration);
+
+  Function *testeeFunction = program.lookupDefinedFunction("count_letters");
+  std::vector<std::unique_ptr<Testee>> testees;
+  testees.emplace_back(make_unique<Testee>(testeeFunction, nullptr, 1));
+  auto mergedTestees = mergeTestees(testees);
+
+  Filter filter;
+  std::vector<MutationPoint *> mutationPoints =
+      finder.getMutationPoints(program, mergedTestees, filter);
+  ASSERT_EQ(1U, mutationPoints.size());
+
+  MutationPoint *mutationPoint = mutationPoints.front();
+  MullModule *module = mutationPoint->getOriginalModule();
+  ASSERT_EQ(module->getFunctionIndex(testeeFunction),
+            mutationPoint->getAddress().getFnIndex());
+  ASSERT_EQ(mutationPoint->getOriginalValue(),
+            &mutationPoint->getAddress().findInstruction(testeeFunction));
+
+  module->prepareMutations();
+  Function *mutatedFunction = module->getModule()->getFunction(
+      mutationPoint->getMutatedFunctionName());
+  ASSERT_NE(nullptr, mutatedFunction);
+  ASSERT_NE(testeeFunction, mutatedFunction);
+  ASSERT_EQ(module->getFunctionIndex(testeeFunction),
+            mutationPoint->getAddress().getFnIndex());
+
+  Instruction &mutatedInstruction =
+      mutationPoint->getAddress().findInstruction(mutatedFunction);
+  ASSERT_EQ(mutatedFunction, mutatedInstruction.getParent()->getParent());
+  ASSERT_EQ(Instruction::Add, mutatedInstruction.getOpcode());
+}
+
+TEST(MutationPoint, SimpleTest_hashMutations_detectsEquivalentMutants) {
+  LLVMContext llvmContext;
+  ModuleLoader loader;
+  auto ModuleWithTestees = loader.loadModuleAtPath(
+      fixtures::simple_test_count_letters_count_letters_bc_path(), llvmContext);
+
+  std::vector<std::unique_ptr<MullModule>> modules;
+  modules.push_back(std::move(ModuleWithTestees));
+  Program program({}, {}, std::move(modules));
+
+  Configuration configuration;
+
+  std::vector<std::unique_ptr<Mutator>> mutators;
+  mutators.emplace_back(make_unique<MathAddMutator>());
+  MutationsFinder finder(std::move(mutators), configuration);
+
+  Function *testeeFunction = program.lookupDefinedFunction("count_letters");
+  std::vector<std::unique_ptr<Testee>> testees;
+  testees.emplace_back(make_unique<Testee>(testeeFunction, nullptr, 1));
+  auto mergedTestees = mergeTestees(testees);
+
+  Filter filter;
+  std::vector<MutationPoint *> mutationPoints =
+      finder.getMutationPoints(program, mergedTestees, filter);
+  ASSERT_EQ(1U, mutationPoints.size());
+
+  MutationPoint *mutationPoint = mutationPoints.front();
+  MullModule *module = mutationPoint->getOriginalModule();
+  module->prepareMutations();
+  size_t functionCount = module->getModule()->size();
+
+  /// Until the mutation is applied the clone is the original function
+  module->hashMutations();
+  ASSERT_FALSE(mutationPoint->getMutantHash().empty());
+  ASSERT_TRUE(mutationPoint->isEquivalent());
+  auto equivalentHash = mutationPoint->getMutantHash();
+
+  mutationPoint->applyMutation();
+  module->hashMutations();
+  ASSERT_FALSE(mutationPoint->isEquivalent());
+  ASSERT_NE(equivalentHash, mutationPoint->getMutantHash());
+
+  /// The canonicalized clones do not stay in the module
+  ASSERT_EQ(functionCount, module->getModule()->size());
+}
+
+TEST(MutationPoint, SimpleTest_prepareMutations_guardsMutantsInOneClone) {
+  LLVMContext llvmContext;
+  ModuleLoader loader;
+  auto ModuleWithTestees = loader.loadModuleAtPath(
+      fixtures::simple_test_count_letters_count_letters_bc_path(), llvmContext);
+
+  std::vector<std::unique_ptr<MullModule>> modules;
+  modules.push_back(std::move(ModuleWithTestees));
+  Program program({}, {}, std::move(modules));
+
+  Configuration configuration;
+
+  std::vector<std::unique_ptr<Mutator>> mutators;
+  mutators.emplace_back(make_unique<MathAddMutator>());
+  MutationsFinder finder(std::move(mutators), configuration);
+
+  Function *testeeFunction = program.lookupDefinedFunction("count_letters");
+  std::vector<std::unique_ptr<Testee>> testees;
+  testees.emplace_back(make_unique<Testee>(testeeFunction, nullptr, 1));
+  auto mergedTestees = mergeTestees(testees);
+
+  Filter filter;
+  std::vector<MutationPoint *> mutationPoints =
+      finder.getMutationPoints(program, mergedTestees, filter);
+  ASSERT_EQ(1U, mutationPoints.size());
+
+  MutationPoint *mutationPoint = mutationPoints.front();
+  MullModule *module = mutationPoint->getOriginalModule();
+  module->prepareMutations(true, true);
+
+  Function *guarded = module->getModule()->getFunction(
+      mutationPoint->getGuardedFunctionName());
+  ASSERT_NE(nullptr, guarded);
+  ASSERT_EQ(guarded, mutationPoint->getMutatedFunction());
+  ASSERT_EQ(1, mutationPoint->getSchemaIndex());
+
+  /// The copy of the instruction runs in a block of its own
+  Instruction &mutatedInstruction =
+      mutationPoint->getAddress().findInstruction(guarded);
+  ASSERT_EQ(guarded, mutatedInstruction.getParent()->getParent());
+  ASSERT_EQ(Instruction::Add, mutatedInstruction.getOpcode());
+  ASSERT_EQ("mutant", mutatedInstruction.getParent()->getName());
+
+  mutationPoint->applyMutation();
+  module->inlineSchemata();
+  ASSERT_FALSE(verifyModule(*module->getModule(), &errs()));
+}
+
+TEST(MutationPoint, SimpleTest_releaseIR_keepsNamesAndIdentifiers) {
+  LLVMContext llvmContext;
+  ModuleLoader loader;
+  auto ModuleWithTestees = loader.loadModuleAtPath(
+      fixtures::simple_test_count_letters_count_letters_bc_path(), llvmContext);
+
+  std::vector<std::unique_ptr<MullModule>> modules;
+  modules.push_back(std::move(ModuleWithTestees));
+  Program program({}, {}, std::move(modules));
+
+  Configuration configuration;
+
+  std::vector<std::unique_ptr<Mutator>> mutators;
+  mutators.emplace_back(make_unique<MathAddMutator>());
+  MutationsFinder finder(std::move(mutators), configuration);
+
+  Function *testeeFunction = program.lookupDefinedFunction("count_letters");
+  std::vector<std::unique_ptr<Testee>> testees;
+  testees.emplace_back(make_unique<Testee>(testeeFunction, nullptr, 1));
+  auto mergedTestees = mergeTestees(testees);
+
+  Filter filter;
+  std::vector<MutationPoint *> mutationPoints =
+      finder.getMutationPoints(program, mergedTestees, filter);
+  ASSERT_EQ(1U, mutationPoints.size());
+
+  MutationPoint *mutationPoint = mutationPoints.front();
+  auto moduleIdentifier =
+      mutationPoint->getOriginalModule()->getModule()->getModuleIdentifier();
+  auto uniqueIdentifier = mutationPoint->getUniqueIdentifier();
+  auto trampolineName = mutationPoint->getTrampolineName();
+
+  program.releaseIR();
+
+  ASSERT_EQ(nullptr, mutationPoint->getOriginalModule()->getModule());
+  ASSERT_EQ(nullptr, mutationPoint->getOriginalFunction());
+  ASSERT_EQ(nullptr, mutationPoint->getOriginalValue());
+  ASSERT_EQ(nullptr, program.lookupDefinedFunction("count_letters"));
+  ASSERT_EQ("count_letters", mutationPoint->getFunctionName());
+  ASSERT_EQ(moduleIdentifier,
+            mutationPoint->getOriginalModule()->getModuleIdentifier());
+  ASSERT_EQ(uniqueIdentifier, mutationPoint->getUniqueIdentifier());
+  ASSERT_EQ(trampolineName, mutationPoint->getTrampolineName());
+}
+
+TEST(MutationPoint, SimpleTest_stripDebugInfo_keepsTheLocations) {
+  for (bool keepLineTables : {false, true}) {
+    LLVMContext llvmContext;
+    ModuleLoader loader;
+    std::vector<std::unique_ptr<MullModule>> modules;
+    modules.push_back(loader.loadModuleAtPath(
+        fixtures::simple_test_count_letters_count_letters_bc_path(),
+        llvmContext));
+    Program program({}, {}, std::move(modules));
+
+    Configuration configuration;
+    std::vector<std::unique_ptr<Mutator>> mutators;
+    mutators.emplace_back(make_unique<MathAddMutator>());
+    MutationsFinder finder(std::move(mutators), configuration);
+
+    Function *testeeFunction = program.lookupDefinedFunction("count_letters");
+    std::vector<std::unique_ptr<Testee>> testees;
+    testees.emplace_back(make_unique<Testee>(testeeFunction, nullptr, 1));
+    auto mergedTestees = mergeTestees(testees);
+
+    Filter filter;
+    std::vector<MutationPoint *> mutationPoints =
+        finder.getMutationPoints(program, mergedTestees, filter);
+    ASSERT_EQ(1U, mutationPoints.size());
+
+    MutationPoint *mutationPoint = mutationPoints.front();
+    auto location = mutationPoint->getSourceLocation();
+    ASSERT_FALSE(location.isNull());
+
+    MullModule *module = mutationPoint->getOriginalModule();
+    module->prepareMutations();
+    mutationPoint->applyMutation();
+    module->stripDebugInfo(keepLineTables);
+    ASSERT_FALSE(verifyModule(*module->getModule(), &errs()));
+
+    auto instruction = cast<Instruction>(mutationPoint->getOriginalValue());
+    ASSERT_EQ(keepLineTables, bool(instruction->getDebugLoc()));
+    if (!keepLineTables) {
+      ASSERT_EQ(nullptr, testeeFunction->getSubprogram());
+    }
+    ASSERT_EQ(location.filePath(),
+              mutationPoint->getSourceLocation().filePath());
+    ASSERT_EQ(location.line, mutationPoint->getSourceLocation().line);
+    ASSERT_EQ(location.column, mutationPoint->getSourceLocation().column);
+  }
+}
+
+TEST(MutationPoint, SimpleTest_prepareMutations_keepsTrampolinesOfOdrCopies) {
+  LLVMContext llvmContext;
+  ModuleLoader loader;
+  std::vector<std::unique_ptr<Program>> programs;
+  std::vector<MutationPoint *> copies;
+  for (int copy = 0; copy < 2; copy++) {
+    std::vector<std::unique_ptr<MullModule>> modules;
+    modules.push_back(loader.loadModuleAtPath(
+        fixtures::simple_test_count_letters_count_letters_bc_path(),
+        llvmContext));
+    programs.push_back(
+        make_unique<Program>(std::vector<std::string>(), ObjectFiles(),
+                             std::move(modules)));
+
+    Configuration configuration;
+    std::vector<std::unique_ptr<Mutator>> mutators;
+    mutators.emplace_back(make_unique<MathAddMutator>());
+    MutationsFinder finder(std::move(mutators), configuration);
+
+    Function *testeeFunction =
+        programs.back()->lookupDefinedFunction("count_letters");
+    std::vector<std::unique_ptr<Testee>> testees;
+    testees.emplace_back(make_unique<Testee>(testeeFunction, nullptr, 1));
+    auto mergedTestees = mergeTestees(testees);
+
+    Filter filter;
+    auto mutationPoints =
+        finder.getMutationPoints(*programs.back(), mergedTestees, filter);
+    ASSERT_EQ(1U, mutationPoints.size());
+    copies.push_back(mutationPoints.front());
+  }
+
+  MutationPoint *canonical = copies[0];
+  MutationPoint *copy = copies[1];
+  copy->setCanonical(canonical);
+  ASSERT_EQ(nullptr, canonical->getCanonical());
+  ASSERT_EQ(canonical, copy->getCanonical());
+  ASSERT_EQ(std::vector<MutationPoint *>({copy}), canonical->getOdrCopies());
+  ASSERT_TRUE(copy->getOdrCopies().empty());
+
+  /// The copy is not cloned, its function still goes through the trampoline
+  MullModule *module = copy->getOriginalModule();
+  module->prepareMutations();
+  ASSERT_EQ(nullptr, copy->getMutatedFunction());
+  ASSERT_EQ(std::vector<std::string>({copy->getTrampolineName()}),
+            module->getTrampolineNames());
+  ASSERT_NE(nullptr, module->getModule()->getFunction(
+                         copy->getOriginalFunctionName()));
+  ASSERT_FALSE(verifyModule(*module->getModule(), &errs()));
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "mull/MullModule.h"
+#include "mull/MutationPoint.h"
+#include "mull/Mutators/MathAddMutator.h"
+#include "mull/SourceLocation.h"
+
+#include <llvm/AsmParser/Parser.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/SourceMgr.h>
+
+#include "gtest/gtest.h"
+
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace llvm;
+using namespace mull;
+
+/// Mutation points in a module of empty functions, for the tests of what
+/// happens to the mutants rather than of the mutations themselves
+class MutationPointsFixture : public ::testing::Test {
+protected:
+  void SetUp() override { parseModule({"mutated"}); }
+
+  void parseModule(std::initializer_list<const char *> functions) {
+    std::string assembly;
+    for (auto function : functions) {
+      assembly += std::string("define void @") + function + "() {\n" +
+                  "  ret void\n" + "}\n";
+    }
+    SMDiagnostic error;
+    auto llvmModule = parseAssemblyString(assembly, error, context);
+    ASSERT_NE(nullptr, llvmModule);
+    module = make_unique<MullModule>(std::move(llvmModule),
+                                     std::unique_ptr<MemoryBuffer>(), "hash");
+  }
+
+  /// Every point gets an address of its own
+  MutationPoint *addPoint(Mutator &pointMutator, const char *function,
+                          const SourceLocation &location) {
+    points.push_back(make_unique<MutationPoint>(
+        &pointMutator, MutationPointAddress(0, 0, points.size()), nullptr,
+        module->getModule()->getFunction(function), "", location,
+        module.get()));
+    return points.back().get();
+  }
+
+  MutationPoint *addPoint(const char *function = "mutated") {
+    return addPoint(mutator, function, SourceLocation::nullSourceLocation());
+  }
+
+  std::vector<MutationPoint *> allPoints() const {
+    std::vector<MutationPoint *> all;
+    for (auto &point : points) {
+      all.push_back(point.get());
+    }
+    return all;
+  }
+
+  LLVMContext context;
+  std::unique_ptr<MullModule> module;
+  MathAddMutator mutator;
+  std::vector<std::unique_ptr<MutationPoint>> points;
+};
@@ -0,0 +1,167 @@
+#include "mull/MutationResultTable.h"
+
+#include "mull/TestFrameworks/Test.h"
+
+#include "MutationPointsFixture.h"
+
+#include "gtest/gtest.h"
+
+using namespace mull;
+using namespace llvm;
+
+class MutationResultTableTest : public MutationPointsFixture {
+protected:
+  void SetUp() override {
+    MutationPointsFixture::SetUp();
+    for (int index = 0; index < 3; index++) {
+      addPoint();
+      tests.push_back(make_unique<mull::Test>(
+          "test" + std::to_string(index), "mull", "mull",
+          std::vector<std::string>(), nullptr));
+    }
+  }
+
+  MutationResult result(int point, int test, ExecutionStatus status,
+                        long long runningTime,
+                        const std::string &output = "") {
+    ExecutionResult executionResult;
+    executionResult.status = status;
+    executionResult.exitStatus = point + test;
+    executionResult.runningTime = runningTime;
+    executionResult.stderrOutput = output;
+    return MutationResult(executionResult, points[point].get(), test + 1,
+                          tests[test].get());
+  }
+
+  static void expectRow(const MutationResult &expected,
+                        const MutationResult &row) {
+    EXPECT_EQ(expected.getMutationPoint(), row.getMutationPoint());
+    EXPECT_EQ(expected.getTest(), row.getTest());
+    EXPECT_EQ(expected.getMutationDistance(), row.getMutationDistance());
+    auto &expectedResult = expected.getExecutionResult();
+    auto &result = row.getExecutionResult();
+    EXPECT_EQ(expectedResult.status, result.status);
+    EXPECT_EQ(expectedResult.exitStatus, result.exitStatus);
+    EXPECT_EQ(expectedResult.runningTime, result.runningTime);
+    EXPECT_EQ(expectedResult.stderrOutput.str(), result.stderrOutput.str());
+    EXPECT_TRUE(result.stdoutOutput.empty());
+  }
+
+  std::vector<std::unique_ptr<mull::Test>> tests;
+};
+
+TEST_F(MutationResultTableTest, readsTheRowsBack) {
+  std::vector<MutationResult> expected(
+      {result(0, 0, Failed, 10, "assertion failed"), result(0, 1, Passed, 20),
+       result(1, 0, Crashed, 30, "segfault"), result(0, 2, Timedout, 40)});
+  MutationResultTable table;
+  for (auto &row : expected) {
+    table.add(row);
+  }
+
+  ASSERT_EQ(expected.size(), table.size());
+  size_t index = 0;
+  for (auto row : table) {
+    expectRow(expected[index++], row);
+  }
+  ASSERT_EQ(Crashed, table.getStatus(2));
+  ASSERT_EQ(points[1].get(), table.getMutationPoint(2));
+}
+
+TEST_F(MutationResultTableTest, appendsTheTablesOfTheWorkers) {
+  std::vector<MutationResult> expected(
+      {result(0, 0, Failed, 10, "first"), result(0, 1, Passed, 20),
+       result(1, 1, Failed, 30, "second"), result(2, 0, Passed, 40),
+       result(2, 2, Crashed, 50, "third")});
+  std::vector<MutationResultTable> storages(2);
+  storages[0].add(expected[0]);
+  storages[0].add(expected[1]);
+  storages[1].add(expected[2]);
+  storages[1].add(expected[3]);
+  storages[1].add(expected[4]);
+
+  MutationResultTable table;
+  appendStorages(table, storages);
+
+  ASSERT_EQ(expected.size(), table.size());
+  for (size_t row = 0; row < table.size(); row++) {
+    expectRow(expected[row], table[row]);
+  }
+  ASSERT_TRUE(storages[0].empty());
+  ASSERT_TRUE(storages[1].empty());
+}
+
+TEST_F(MutationResultTableTest, reordersTheRows) {
+  std::vector<MutationResult> expected(
+      {result(2, 0, Passed, 10), result(0, 0, Failed, 20, "killed"),
+       result(1, 1, Passed, 30)});
+  MutationResultTable table;
+  for (auto &row : expected) {
+    table.add(row);
+  }
+
+  table.reorder({1, 2, 0});
+
+  expectRow(expected[1], table[0]);
+  expectRow(expected[2], table[1]);
+  expectRow(expected[0], table[2]);
+}
+
+TEST_F(MutationResultTableTest, restoresTheOrderOfTheMutants) {
+  /// The rows as the workers return them, in the order of the schedule
+  std::vector<MutationResult> expected(
+      {result(2, 0, Passed, 10), result(0, 1, Failed, 20),
+       result(2, 1, Passed, 30), result(1, 0, Passed, 40),
+       result(0, 0, Passed, 50)});
+  MutationResultTable table;
+  for (auto &row : expected) {
+    table.add(row);
+  }
+
+  table.restoreMutantsOrder(allPoints());
+
+  /// The rows of a mutant keep their order
+  expectRow(expected[1], table[0]);
+  expectRow(expected[4], table[1]);
+  expectRow(expected[3], table[2]);
+  expectRow(expected[0], table[3]);
+  expectRow(expected[2], table[4]);
+}
+
+TEST_F(MutationResultTableTest, spillsTheRowsPastTheBudget) {
+  std::vector<MutationResult> expected;
+  for (int row = 0; row < 30; row++) {
+    expected.push_back(result(row % 3, (row / 3) % 3,
+                              row % 2 ? Passed : Failed, row,
+                              row % 2 ? "" : "output " + std::to_string(row)));
+  }
+
+  /// A few rows per segment
+  setResultMemoryBudget(100);
+  std::vector<MutationResultTable> storages(2);
+  for (size_t row = 0; row < expected.size(); row++) {
+    storages[row * 2 / expected.size()].add(expected[row]);
+  }
+  ASSERT_NE(0U, storages[0].getSpilledRows());
+  ASSERT_NE(0U, storages[1].getSpilledRows());
+
+  MutationResultTable table;
+  appendStorages(table, storages);
+  ASSERT_EQ(expected.size(), table.size());
+  size_t index = 0;
+  for (auto row : table) {
+    expectRow(expected[index++], row);
+  }
+
+  std::vector<size_t> order;
+  for (size_t row = expected.size(); row != 0; row--) {
+    order.push_back(row - 1);
+  }
+  table.reorder(order);
+  setResultMemoryBudget(0);
+
+  ASSERT_EQ(expected.size(), table.size());
+  for (size_t row = 0; row < table.size(); row++) {
+    expectRow(expected[expected.size() - 1 - row], table[row]);
+  }
+}
@@ -0,0 +1,102 @@
+#include "mull/MutationSearchCache.h"
+
+#include "CacheDirectoryFixture.h"
+#include "FixturePaths.h"
+#include "mull/Config/Configuration.h"
+#include "mull/Filter.h"
+#include "mull/ModuleLoader.h"
+#include "mull/MutationsFinder.h"
+#include "mull/Mutators/MathAddMutator.h"
+#include "mull/Program/Program.h"
+#include "mull/Testee.h"
+
+#include <llvm/IR/LLVMContext.h>
+
+#include "gtest/gtest.h"
+
+using namespace mull;
+using namespace llvm;
+
+class MutationSearchCacheTest : public CacheDirectoryFixture {};
+
+static std::unique_ptr<Program> loadProgram(LLVMContext &context) {
+  ModuleLoader loader;
+  std::vector<std::unique_ptr<MullModule>> modules;
+  modules.push_back(loader.loadModuleAtPath(
+      fixtures::simple_test_count_letters_count_letters_bc_path(), context));
+  return make_unique<Program>(std::vector<std::string>(), ObjectFiles(),
+                              std::move(modules));
+}
+
+TEST_F(MutationSearchCacheTest, storesThePointsUnderTheSearchKey) {
+  auto directory = createCacheDirectory();
+  LLVMContext context;
+  auto program = loadProgram(context);
+  auto &module = *program->modules().front();
+
+  MutationSearchCache::FunctionPoints points;
+  points.points.push_back({1, 2, 3});
+  points.deadValues = 4;
+  {
+    MutationSearchCache cache(directory, "1");
+    cache.setSearchKey("key");
+    cache.store(module, "count_letters", points);
+    cache.save();
+  }
+
+  MutationSearchCache cache(directory, "1");
+  cache.setSearchKey("key");
+  MutationSearchCache::FunctionPoints stored;
+  ASSERT_TRUE(cache.lookup(module, "count_letters", stored));
+  ASSERT_EQ(1U, stored.points.size());
+  ASSERT_EQ(1U, stored.points[0].mutator);
+  ASSERT_EQ(2, stored.points[0].basicBlock);
+  ASSERT_EQ(3, stored.points[0].instruction);
+  ASSERT_EQ(4U, stored.deadValues);
+  ASSERT_EQ(0U, stored.deadStores);
+  ASSERT_FALSE(cache.lookup(module, "main", stored));
+  ASSERT_EQ(1U, cache.getHits());
+
+  /// Another filter or other mutators find other points
+  cache.setSearchKey("other key");
+  ASSERT_FALSE(cache.lookup(module, "count_letters", stored));
+}
+
+static std::vector<std::string>
+searchPoints(const Configuration &configuration, uint64_t &cachedFunctions) {
+  LLVMContext context;
+  auto program = loadProgram(context);
+
+  std::vector<std::unique_ptr<Mutator>> mutators;
+  mutators.emplace_back(make_unique<MathAddMutator>());
+  MutationsFinder finder(std::move(mutators), configuration);
+
+  std::vector<std::unique_ptr<Testee>> testees;
+  testees.emplace_back(make_unique<Testee>(
+      program->lookupDefinedFunction("count_letters"), nullptr, 1));
+  auto mergedTestees = mergeTestees(testees);
+  Filter filter;
+
+  std::vector<std::string> identifiers;
+  for (auto point : finder.getMutationPoints(*program, mergedTestees, filter)) {
+    identifiers.push_back(point->getUniqueIdentifier());
+  }
+  cachedFunctions = finder.getCachedFunctions();
+  return identifiers;
+}
+
+TEST_F(MutationSearchCacheTest, findsTheSamePointsWithoutTheSearch) {
+  Configuration configuration;
+  configuration.cacheEnabled = true;
+  configuration.cacheDirectory = createCacheDirectory();
+  configuration.mutationSearchCacheEnabled = true;
+
+  uint64_t cachedFunctions = 0;
+  auto searched = searchPoints(configuration, cachedFunctions);
+  ASSERT_FALSE(searched.empty());
+  ASSERT_EQ(0U, cachedFunctions);
+
+  auto restored = searchPoints(configuration, cachedFunctions);
+  ASSERT_EQ(1U, cachedFunctions);
+  ASSERT_EQ(searched, restored);
+}
@@ -0,0 +1,193 @@
+#include "FixturePaths.h"
+#include "mull/Config/Configuration.h"
+#include "mull/Filter.h"
+#include "mull/ModuleLoader.h"
+#include "mull/MutationPoint.h"
+#include "mull/MutationsFinder.h"
+#include "mull/Mutators/AndOrReplacementMutator.h"
+#include "mull/Mutators/MutatorsFactory.h"
+#include "mull/Program/Program.h"
+#include "mull/Testee.h"
+
+#include <llvm/IR/InstIterator.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <iostream>
+#include <set>
+
+using namespace mull;
+using namespace llvm;
+
+static std::unique_ptr<Program> loadLargeProgram(LLVMContext &context) {
+  ModuleLoader loader;
+  auto module = loader.loadModuleAtPath(
+      fixtures::hardcode_openssl_bio_enc_test_oll_path(), context);
+
+  std::vector<std::unique_ptr<MullModule>> modules;
+  modules.push_back(std::move(module));
+  return make_unique<Program>(std::vector<std::string>(), ObjectFiles(),
+                              std::move(modules));
+}
+
+static std::vector<MergedTestee> allFunctions(Program &program) {
+  std::vector<std::unique_ptr<Testee>> testees;
+  for (auto &module : program.modules()) {
+    for (auto &function : module->getModule()->functions()) {
+      if (!function.isDeclaration()) {
+        testees.emplace_back(make_unique<Testee>(&function, nullptr, 1));
+      }
+    }
+  }
+  return mergeTestees(testees);
+}
+
+static long long millisecondsSince(std::chrono::steady_clock::time_point t) {
+  auto elapsed = std::chrono::steady_clock::now() - t;
+  return std::chrono::duration_cast<std::chrono::milliseconds>(elapsed)
+      .count();
+}
+
+/// Compares the search with all mutators at once, which walks every function
+/// once, against a search per mutator, which is what the search used to do
+TEST(MutationsFinderBenchmark, searchesAllMutatorsInOnePass) {
+  Configuration configuration;
+  Filter filter;
+  MutatorsFactory factory;
+
+  LLVMContext onePassContext;
+  auto onePassProgram = loadLargeProgram(onePassContext);
+  auto onePassTestees = allFunctions(*onePassProgram);
+  MutationsFinder onePassFinder(factory.mutators({"all"}), configuration);
+
+  auto start = std::chrono::steady_clock::now();
+  auto points =
+      onePassFinder.getMutationPoints(*onePassProgram, onePassTestees, filter);
+  auto onePassTime = millisecondsSince(start);
+
+  LLVMContext perMutatorContext;
+  auto perMutatorProgram = loadLargeProgram(perMutatorContext);
+  auto perMutatorTestees = allFunctions(*perMutatorProgram);
+  std::vector<std::unique_ptr<MutationsFinder>> perMutatorFinders;
+  for (auto &mutator : factory.mutators({"all"})) {
+    std::vector<std::unique_ptr<Mutator>> mutators;
+    mutators.push_back(std::move(mutator));
+    perMutatorFinders.push_back(
+        make_unique<MutationsFinder>(std::move(mutators), configuration));
+  }
+
+  std::vector<MutationPoint *> perMutatorPoints;
+  start = std::chrono::steady_clock::now();
+  for (auto &finder : perMutatorFinders) {
+    auto found = finder->getMutationPoints(*perMutatorProgram,
+                                           perMutatorTestees, filter);
+    perMutatorPoints.insert(perMutatorPoints.end(), found.begin(),
+                            found.end());
+  }
+  auto perMutatorTime = millisecondsSince(start);
+
+  std::cout << "[ BENCH    ] " << points.size() << " points, one pass "
+            << onePassTime << " ms, one pass per mutator " << perMutatorTime
+            << " ms\n";
+
+  std::multiset<std::string> onePassIdentifiers;
+  for (auto point : points) {
+    onePassIdentifiers.insert(point->getUniqueIdentifier());
+  }
+  std::multiset<std::string> perMutatorIdentifiers;
+  for (auto point : perMutatorPoints) {
+    perMutatorIdentifiers.insert(point->getUniqueIdentifier());
+  }
+
+  ASSERT_FALSE(points.empty());
+  ASSERT_EQ(perMutatorIdentifiers, onePassIdentifiers);
+}
+
+TEST(MutationsFinderBenchmark, keepsOrderOfMutatorsWithinFunction) {
+  Configuration configuration;
+  Filter filter;
+  MutatorsFactory factory;
+
+  LLVMContext context;
+  auto program = loadLargeProgram(context);
+  auto testees = allFunctions(*program);
+  MutationsFinder finder(factory.mutators({"all"}), configuration);
+  auto points = finder.getMutationPoints(*program, testees, filter);
+
+  auto mutators = factory.mutators({"all"});
+  auto mutatorIndex = [&mutators](MutationPoint *point) {
+    for (size_t i = 0; i < mutators.size(); i++) {
+      if (mutators[i]->getUniqueIdentifier() ==
+          point->getMutator()->getUniqueIdentifier()) {
+        return i;
+      }
+    }
+    return mutators.size();
+  };
+
+  for (size_t i = 1; i < points.size(); i++) {
+    auto previous = points[i - 1];
+    auto current = points[i];
+    if (previous->getOriginalFunction() != current->getOriginalFunction()) {
+      continue;
+    }
+    ASSERT_LE(mutatorIndex(previous), mutatorIndex(current));
+    if (mutatorIndex(previous) == mutatorIndex(current)) {
+      auto previousAddress = previous->getAddress();
+      auto currentAddress = current->getAddress();
+      ASSERT_LE(std::make_pair(previousAddress.getBBIndex(),
+                               previousAddress.getIIndex()),
+                std::make_pair(currentAddress.getBBIndex(),
+                               currentAddress.getIIndex()));
+    }
+  }
+}
+
+/// The search looks up the branch that completes a && or a || in an index
+/// of the function, canBeApplied walks the rest of the function instead
+TEST(MutationsFinderBenchmark, findsAndOrPatternsWithoutRescanningFunction) {
+  Configuration configuration;
+  Filter filter;
+  MutatorsFactory factory;
+
+  LLVMContext context;
+  ModuleLoader loader;
+  auto module = loader.loadModuleAtPath(
+      fixtures::mutators_and_or_replacement_switch_module_bc_path(), context);
+  std::vector<std::unique_ptr<MullModule>> modules;
+  modules.push_back(std::move(module));
+  Program program(std::vector<std::string>(), ObjectFiles(),
+                  std::move(modules));
+  auto testees = allFunctions(program);
+
+  MutationsFinder finder(factory.mutators({AndOrReplacementMutator::ID}),
+                         configuration);
+  auto start = std::chrono::steady_clock::now();
+  auto points = finder.getMutationPoints(program, testees, filter);
+  auto indexTime = millisecondsSince(start);
+
+  std::set<Value *> indexed;
+  for (auto point : points) {
+    indexed.insert(point->getOriginalValue());
+  }
+
+  AndOrReplacementMutator mutator;
+  std::set<Value *> scanned;
+  start = std::chrono::steady_clock::now();
+  for (auto &instruction :
+       instructions(program.lookupDefinedFunction("dispatch"))) {
+    if (mutator.canBeApplied(instruction)) {
+      scanned.insert(&instruction);
+    }
+  }
+  auto scanTime = millisecondsSince(start);
+
+  std::cout << "[ BENCH    ] " << points.size() << " points, index "
+            << indexTime << " ms, scan per branch " << scanTime << " ms\n";
+
+  ASSERT_FALSE(points.empty());
+  ASSERT_EQ(scanned, indexed);
+}
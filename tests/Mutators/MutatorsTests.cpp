@@ -8,6 +8,7 @@
 #include <llvm/IR/Function.h>
 #include <llvm/IR/InstrTypes.h>
 #include <llvm/IR/Instructions.h>
+#include <llvm/IR/Intrinsics.h>
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Module.h>
 #include <llvm/IR/Type.h>
@@ -38,3 +39,24 @@ TEST(Mutators, MathAddMutator) {
   std::unique_ptr<BinaryOperator> FSub(BinaryOperator::CreateFSub(FA, FB));
   EXPECT_EQ(false, mutator.canBeApplied(*FSub));
 }
+
+TEST(Mutators, MathAddMutator_AddWithOverflow) {
+  Module module("overflow", Ctx);
+  IntegerType *int32 = Type::getInt32Ty(Ctx);
+  ConstantInt *A = ConstantInt::get(int32, 42, 0);
+  ConstantInt *B = ConstantInt::get(int32, 43, 0);
+
+  MathAddMutator mutator;
+
+  Function *sadd =
+      Intrinsic::getDeclaration(&module, Intrinsic::sadd_with_overflow,
+                                {int32});
+  std::unique_ptr<CallInst> addWithOverflow(CallInst::Create(sadd, {A, B}));
+  EXPECT_EQ(true, mutator.canBeApplied(*addWithOverflow));
+
+  Function *ssub =
+      Intrinsic::getDeclaration(&module, Intrinsic::ssub_with_overflow,
+                                {int32});
+  std::unique_ptr<CallInst> subWithOverflow(CallInst::Create(ssub, {A, B}));
+  EXPECT_EQ(false, mutator.canBeApplied(*subWithOverflow));
+}
@@ -0,0 +1,362 @@
+#include "CacheDirectoryFixture.h"
+#include "FixturePaths.h"
+#include "mull/Config/Configuration.h"
+#include "mull/ModuleLoader.h"
+#include "mull/Toolchain/ObjectCache.h"
+#include "mull/Toolchain/ObjectCacheBackend.h"
+#include "mull/Toolchain/Toolchain.h"
+
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include "gtest/gtest.h"
+
+#include <future>
+#include <map>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace mull;
+using namespace llvm;
+
+namespace {
+class InMemoryBackend : public ObjectCacheBackend {
+public:
+  explicit InMemoryBackend(std::map<std::string, std::string> &objects)
+      : objects(objects) {}
+
+  bool fetch(const std::string &key, std::string &contents) override {
+    auto object = objects.find(key);
+    if (object == objects.end()) {
+      return false;
+    }
+    contents = object->second;
+    return true;
+  }
+
+  bool store(const std::string &key, StringRef contents) override {
+    objects[key] = contents.str();
+    return true;
+  }
+
+private:
+  std::map<std::string, std::string> &objects;
+};
+} // namespace
+
+/// Holds the uploads until released
+class BlockingBackend : public InMemoryBackend {
+public:
+  BlockingBackend(std::map<std::string, std::string> &objects,
+                  std::shared_future<void> released)
+      : InMemoryBackend(objects), released(std::move(released)) {}
+
+  bool store(const std::string &key, StringRef contents) override {
+    released.wait();
+    return InMemoryBackend::store(key, contents);
+  }
+
+private:
+  std::shared_future<void> released;
+};
+
+/// Answers a single request with the response, on a port of localhost
+class OneShotServer {
+public:
+  explicit OneShotServer(std::string response) : listener(-1), port(0) {
+    listener = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t size = sizeof(address);
+    if (bind(listener, (struct sockaddr *)&address, size) != 0 ||
+        listen(listener, 1) != 0 ||
+        getsockname(listener, (struct sockaddr *)&address, &size) != 0) {
+      return;
+    }
+    port = ntohs(address.sin_port);
+    server = std::thread([this, response]() {
+      int connection = accept(listener, nullptr, nullptr);
+      std::string request;
+      char buffer[1024];
+      while (request.find("\r\n\r\n") == std::string::npos) {
+        ssize_t bytes = recv(connection, buffer, sizeof(buffer), 0);
+        if (bytes <= 0) {
+          break;
+        }
+        request.append(buffer, bytes);
+      }
+      ssize_t sent = send(connection, response.data(), response.size(), 0);
+      (void)sent;
+      close(connection);
+    });
+  }
+
+  ~OneShotServer() {
+    if (server.joinable()) {
+      server.join();
+    }
+    close(listener);
+  }
+
+  std::string url() const {
+    return "http://127.0.0.1:" + std::to_string(port) + "/cache";
+  }
+
+private:
+  int listener;
+  int port;
+  std::thread server;
+};
+
+class ObjectCacheTest : public CacheDirectoryFixture {};
+
+TEST_F(ObjectCacheTest, storesAndLoadsObjects) {
+  Configuration configuration;
+  Toolchain toolchain(configuration);
+
+  LLVMContext context;
+  ModuleLoader loader;
+  auto module = loader.loadModuleAtPath(
+      fixtures::simple_test_count_letters_count_letters_bc_path(), context);
+  auto object = toolchain.compiler().compileModule(module->getModule(),
+                                                   toolchain.targetMachine());
+  auto size = object.getBinary()->getMemoryBufferRef().getBufferSize();
+
+  for (bool compression : {false, true}) {
+    auto directory = createCacheDirectory();
+    ObjectCache cache(true, directory, compression);
+
+    ASSERT_EQ(nullptr, cache.getObject(*module).getBinary());
+    cache.putObject(object, *module);
+
+    auto cached = cache.getObject(*module);
+    ASSERT_NE(nullptr, cached.getBinary());
+    ASSERT_EQ(object.getBinary()->getMemoryBufferRef().getBuffer(),
+              cached.getBinary()->getMemoryBufferRef().getBuffer());
+
+    /// Another process sees the objects written into a shared directory
+    ObjectCache otherCache(true, directory, !compression);
+    ASSERT_NE(nullptr, otherCache.getObject(*module).getBinary());
+
+    auto metrics = cache.getMetrics();
+    ASSERT_EQ(1u, metrics.hits);
+    ASSERT_EQ(1u, metrics.misses);
+    ASSERT_EQ(size, metrics.bytesWritten);
+    if (!compression) {
+      ASSERT_EQ(0u, metrics.bytesSaved);
+    }
+  }
+}
+
+TEST_F(ObjectCacheTest, sharesMappedObjects) {
+  Configuration configuration;
+  Toolchain toolchain(configuration);
+
+  LLVMContext context;
+  ModuleLoader loader;
+  auto module = loader.loadModuleAtPath(
+      fixtures::simple_test_count_letters_count_letters_bc_path(), context);
+  auto object = toolchain.compiler().compileModule(module->getModule(),
+                                                   toolchain.targetMachine());
+
+  ObjectCache cache(true, createCacheDirectory(), false, 0, true);
+  cache.putObject(object, *module);
+
+  /// Both lookups point into the same mapping instead of their own copies
+  auto first = cache.getObject(*module);
+  auto second = cache.getObject(*module);
+  ASSERT_NE(nullptr, first.getBinary());
+  ASSERT_EQ(first.getBinary()->getMemoryBufferRef().getBufferStart(),
+            second.getBinary()->getMemoryBufferRef().getBufferStart());
+}
+
+TEST_F(ObjectCacheTest, writesTheObjectsInTheBackground) {
+  Configuration configuration;
+  Toolchain toolchain(configuration);
+
+  LLVMContext context;
+  ModuleLoader loader;
+  auto module = loader.loadModuleAtPath(
+      fixtures::simple_test_count_letters_count_letters_bc_path(), context);
+  auto object = toolchain.compiler().compileModule(module->getModule(),
+                                                   toolchain.targetMachine());
+  auto size = object.getBinary()->getMemoryBufferRef().getBufferSize();
+
+  auto directory = createCacheDirectory();
+  ObjectCache cache(true, directory);
+  cache.putObject(object, *module);
+  cache.putInstrumentedObject(object, *module);
+  cache.flush();
+  ASSERT_EQ(2 * size, cache.getMetrics().bytesWritten);
+
+  ObjectCache otherCache(true, directory);
+  ASSERT_NE(nullptr, otherCache.getObject(*module).getBinary());
+  ASSERT_NE(nullptr, otherCache.getInstrumentedObject(*module).getBinary());
+}
+
+TEST_F(ObjectCacheTest, readsTheObjectsOfThePreviousRunAhead) {
+  Configuration configuration;
+  Toolchain toolchain(configuration);
+
+  LLVMContext context;
+  ModuleLoader loader;
+  auto module = loader.loadModuleAtPath(
+      fixtures::simple_test_count_letters_count_letters_bc_path(), context);
+  auto object = toolchain.compiler().compileModule(module->getModule(),
+                                                   toolchain.targetMachine());
+
+  auto directory = createCacheDirectory();
+  {
+    ObjectCache cache(true, directory);
+    cache.prefetchObjects(*module, 1, true);
+    ASSERT_EQ(0u, cache.getMetrics().prefetches);
+    cache.putObject(object, *module);
+    cache.rememberObject(*module);
+  }
+
+  ObjectCache cache(true, directory);
+  cache.prefetchObjects(*module, 1, true);
+  ASSERT_EQ(1u, cache.getMetrics().prefetches);
+  /// The same object is read ahead once
+  cache.prefetchObjects(*module, 1, false);
+  ASSERT_EQ(1u, cache.getMetrics().prefetches);
+  ASSERT_NE(nullptr, cache.getObject(*module).getBinary());
+}
+
+TEST_F(ObjectCacheTest, evictsObjectsOverSizeLimit) {
+  Configuration configuration;
+  Toolchain toolchain(configuration);
+
+  LLVMContext context;
+  ModuleLoader loader;
+  auto module = loader.loadModuleAtPath(
+      fixtures::simple_test_count_letters_count_letters_bc_path(), context);
+  auto object = toolchain.compiler().compileModule(module->getModule(),
+                                                   toolchain.targetMachine());
+
+  auto directory = createCacheDirectory();
+  {
+    ObjectCache cache(true, directory);
+    cache.putObject(object, *module);
+    cache.putInstrumentedObject(object, *module);
+  }
+
+  /// Both objects do not fit into one byte, so the next run evicts them
+  ObjectCache cache(true, directory, false, 1);
+  ASSERT_EQ(nullptr, cache.getObject(*module).getBinary());
+  ASSERT_EQ(nullptr, cache.getInstrumentedObject(*module).getBinary());
+  ASSERT_NE(0u, cache.getMetrics().bytesEvicted);
+}
+
+static void writeFile(const std::string &path) {
+  ASSERT_FALSE(sys::fs::create_directories(sys::path::parent_path(path)));
+  std::error_code error;
+  raw_fd_ostream file(path, error, sys::fs::F_None);
+  ASSERT_FALSE(error);
+  file << "contents";
+}
+
+TEST_F(ObjectCacheTest, evictsOnlyTheObjectShards) {
+  auto directory = createCacheDirectory();
+  std::string object = directory + "/ab/cdef.o";
+  std::vector<std::string> others = {
+      directory + "/junk/0123456789abcdef",
+      directory + "/programs/input-01234567.o",
+      /// An object another mull is writing right now
+      directory + "/ab/cdef.o.tmp-01234567",
+  };
+  writeFile(object);
+  for (auto &path : others) {
+    writeFile(path);
+  }
+
+  ObjectCache cache(true, directory, false, 1);
+  ASSERT_FALSE(sys::fs::exists(object));
+  for (auto &path : others) {
+    ASSERT_TRUE(sys::fs::exists(path)) << path;
+  }
+}
+
+TEST_F(ObjectCacheTest, dropsUploadsPastPendingLimit) {
+  std::map<std::string, std::string> remoteObjects;
+  std::promise<void> release;
+  {
+    AsyncObjectCacheBackend backend(
+        make_unique<BlockingBackend>(remoteObjects,
+                                     release.get_future().share()),
+        16);
+    ASSERT_TRUE(backend.store("first", "0123456789"));
+    ASSERT_FALSE(backend.store("second", "0123456789"));
+    release.set_value();
+  }
+  ASSERT_EQ(1u, remoteObjects.size());
+  ASSERT_EQ(1u, remoteObjects.count("first"));
+}
+
+TEST_F(ObjectCacheTest, fetchesCompleteHTTPResponses) {
+  std::string contents;
+  {
+    OneShotServer server("HTTP/1.0 200 OK\r\nContent-Length: 6\r\n\r\n"
+                         "object");
+    HTTPObjectCacheBackend backend(server.url());
+    ASSERT_TRUE(backend.fetch("key", contents));
+    ASSERT_EQ("object", contents);
+  }
+  {
+    /// The server went away in the middle of the body
+    OneShotServer server("HTTP/1.0 200 OK\r\nContent-Length: 10\r\n\r\n"
+                         "object");
+    HTTPObjectCacheBackend backend(server.url());
+    ASSERT_FALSE(backend.fetch("key", contents));
+  }
+  {
+    OneShotServer server("HTTP/1.0 200 OK\r\n\r\nobject");
+    HTTPObjectCacheBackend backend(server.url());
+    ASSERT_FALSE(backend.fetch("key", contents));
+  }
+}
+
+TEST_F(ObjectCacheTest, readsThroughRemoteBackend) {
+  Configuration configuration;
+  Toolchain toolchain(configuration);
+
+  LLVMContext context;
+  ModuleLoader loader;
+  auto module = loader.loadModuleAtPath(
+      fixtures::simple_test_count_letters_count_letters_bc_path(), context);
+  auto object = toolchain.compiler().compileModule(module->getModule(),
+                                                   toolchain.targetMachine());
+
+  std::map<std::string, std::string> remoteObjects;
+  {
+    ObjectCache cache(true, createCacheDirectory(), false, 0, false,
+                      make_unique<AsyncObjectCacheBackend>(
+                          make_unique<InMemoryBackend>(remoteObjects)));
+    cache.putObject(object, *module);
+  }
+  ASSERT_EQ(1u, remoteObjects.size());
+
+  /// Another machine with an empty cache gets the object from the remote
+  /// cache, and keeps it locally for the next runs
+  auto directory = createCacheDirectory();
+  {
+    ObjectCache cache(true, directory, false, 0, false,
+                      make_unique<InMemoryBackend>(remoteObjects));
+    auto cached = cache.getObject(*module);
+    ASSERT_NE(nullptr, cached.getBinary());
+    ASSERT_EQ(object.getBinary()->getMemoryBufferRef().getBuffer(),
+              cached.getBinary()->getMemoryBufferRef().getBuffer());
+    ASSERT_EQ(1u, cache.getMetrics().remoteHits);
+  }
+
+  remoteObjects.clear();
+  ObjectCache cache(true, directory);
+  ASSERT_NE(nullptr, cache.getObject(*module).getBinary());
+}
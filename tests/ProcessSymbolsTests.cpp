@@ -0,0 +1,33 @@
+#include "mull/Toolchain/Resolvers/ProcessSymbols.h"
+
+#include <llvm/Support/DynamicLibrary.h>
+
+#include "gtest/gtest.h"
+
+using namespace mull;
+using namespace llvm;
+
+TEST(ProcessSymbols, searchesEveryNameOnce) {
+  sys::DynamicLibrary::LoadLibraryPermanently(nullptr);
+  ProcessSymbols symbols;
+
+  auto address = symbols.getAddress("malloc");
+  ASSERT_NE(0U, address);
+  ASSERT_EQ(address, symbols.getAddress("malloc"));
+  ASSERT_EQ(1U, symbols.size());
+
+  ASSERT_EQ(0U, symbols.getAddress("mull_process_symbols_missing"));
+  ASSERT_EQ(0U, symbols.getAddress("mull_process_symbols_missing"));
+  ASSERT_EQ(2U, symbols.size());
+}
+
+TEST(ProcessSymbols, searchesTheMissingSymbolsAgainAfterLoadingLibraries) {
+  sys::DynamicLibrary::LoadLibraryPermanently(nullptr);
+  ProcessSymbols symbols;
+  symbols.getAddress("malloc");
+  symbols.getAddress("mull_process_symbols_missing");
+
+  symbols.forgetMissingSymbols();
+  ASSERT_EQ(1U, symbols.size());
+  ASSERT_NE(0U, symbols.getAddress("malloc"));
+}
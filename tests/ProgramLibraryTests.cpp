@@ -0,0 +1,109 @@
+#include "mull/Toolchain/ProgramLibrary.h"
+#include "mull/Config/Configuration.h"
+#include "mull/Instrumentation/Instrumentation.h"
+#include "mull/Toolchain/Toolchain.h"
+
+#include "CacheDirectoryFixture.h"
+
+#include <llvm/AsmParser/Parser.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/SourceMgr.h>
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+using namespace mull;
+using namespace llvm;
+
+static const char *ProgramModule =
+    "@mull_instrumentation_info = external global i8*\n"
+    "@mull_function_index_offset_program = external global i32\n"
+    "@__dso_handle = external hidden global i8\n"
+    "@constructed = global i32 0\n"
+    "@destructed = global i32 0\n"
+    "@llvm.global_ctors = appending global [1 x { i32, void ()*, i8* }] "
+    "[{ i32, void ()*, i8* } { i32 65535, void ()* @constructor, i8* null }]\n"
+    "declare i32 @__cxa_atexit(void (i8*)*, i8*, i8*)\n"
+    "define internal void @constructor() {\n"
+    "  store i32 1, i32* @constructed\n"
+    "  ret void\n"
+    "}\n"
+    "define internal void @destructor(i8*) {\n"
+    "  store i32 1, i32* @destructed\n"
+    "  ret void\n"
+    "}\n"
+    "define i32 @registerDestructor() {\n"
+    "  %r = call i32 @__cxa_atexit(void (i8*)* @destructor, i8* null, "
+    "i8* @__dso_handle)\n"
+    "  ret i32 %r\n"
+    "}\n"
+    "define i8* @instrumentationInfo() {\n"
+    "  %info = load i8*, i8** @mull_instrumentation_info\n"
+    "  ret i8* %info\n"
+    "}\n"
+    "define i32 @functionIndexOffset() {\n"
+    "  %offset = load i32, i32* @mull_function_index_offset_program\n"
+    "  ret i32 %offset\n"
+    "}\n";
+
+class ProgramLibraryTest : public CacheDirectoryFixture {};
+
+template <typename Function>
+static Function *function(ProgramLibrary &library, const char *name) {
+  return reinterpret_cast<Function *>(library.getAddress(name));
+}
+
+TEST_F(ProgramLibraryTest, linksTheObjectsOnceAndLoadsTheLibrary) {
+  if (!ProgramLibrary::isSupported()) {
+    return;
+  }
+  Configuration configuration;
+  configuration.cacheEnabled = true;
+  configuration.cacheDirectory = createCacheDirectory();
+  configuration.programLibraryEnabled = true;
+  Toolchain toolchain(configuration);
+  ASSERT_TRUE(toolchain.isPositionIndependent());
+
+  LLVMContext context;
+  SMDiagnostic error;
+  auto module = parseAssemblyString(ProgramModule, error, context);
+  ASSERT_NE(nullptr, module);
+  ProgramLibrary::dropStaticConstructors(*module);
+  auto object = toolchain.compiler().compileModule(module.get(),
+                                                   toolchain.targetMachine());
+  std::vector<object::ObjectFile *> objectFiles({object.getBinary()});
+
+  ProgramLibrary library(configuration.cacheDirectory);
+  ASSERT_TRUE(library.load(objectFiles, toolchain.targetMachine()));
+  ASSERT_TRUE(sys::fs::exists(library.getPath()));
+
+  /// dlopen did not run the constructor, the test runner finds it
+  ASSERT_EQ(0, *function<int>(library, "constructed"));
+  ASSERT_NE(0U, library.getAddress("constructor"));
+
+  Instrumentation instrumentation;
+  instrumentation.getFunctionOffsetMapping()["program"] = 7;
+  llvm_compat::CXXRuntimeOverrides overrides(
+      [](const char *name) { return std::string(name); });
+  auto trampoline = library.bindSlots(instrumentation, overrides);
+  ASSERT_NE(nullptr, trampoline);
+
+  int info = 0;
+  *trampoline = reinterpret_cast<InstrumentationInfo *>(&info);
+  ASSERT_EQ(&info, function<void *()>(library, "instrumentationInfo")());
+  ASSERT_EQ(7, function<int()>(library, "functionIndexOffset")());
+
+  /// The destructors are registered with the test runner rather than libc
+  ASSERT_EQ(0, function<int()>(library, "registerDestructor")());
+  ASSERT_EQ(0, *function<int>(library, "destructed"));
+  overrides.runDestructors();
+  ASSERT_EQ(1, *function<int>(library, "destructed"));
+
+  /// The next run finds the library of the same objects in the cache
+  ProgramLibrary cached(configuration.cacheDirectory);
+  ASSERT_TRUE(cached.load(objectFiles, toolchain.targetMachine()));
+  ASSERT_EQ(library.getPath(), cached.getPath());
+}
@@ -0,0 +1,123 @@
+#include "mull/Instrumentation/ReachabilityCache.h"
+
+#include "CacheDirectoryFixture.h"
+#include "FixturePaths.h"
+#include "mull/ModuleLoader.h"
+#include "mull/Program/Program.h"
+#include "mull/TestFrameworks/Test.h"
+
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/LLVMContext.h>
+
+#include "gtest/gtest.h"
+
+using namespace mull;
+using namespace llvm;
+
+class ReachabilityCacheTest : public CacheDirectoryFixture {
+protected:
+  void SetUp() override {
+    directory = createCacheDirectory();
+    ModuleLoader loader;
+    std::vector<std::unique_ptr<MullModule>> modules;
+    modules.push_back(loader.loadModuleAtPath(
+        fixtures::simple_test_count_letters_test_count_letters_bc_path(),
+        context));
+    modules.push_back(loader.loadModuleAtPath(
+        fixtures::simple_test_count_letters_count_letters_bc_path(),
+        context));
+    program = make_unique<Program>(std::vector<std::string>(),
+                                   ObjectFiles(), std::move(modules));
+    testBody = program->lookupDefinedFunction("test_count_letters");
+    testee = program->lookupDefinedFunction("count_letters");
+  }
+
+  mull::Test passedTest() {
+    mull::Test test("test_count_letters", "mull", "mull", {}, testBody);
+    ExecutionResult result;
+    result.status = Passed;
+    result.runningTime = 7;
+    test.setExecutionResult(result);
+    test.addRunningTime(1000);
+    test.addRunningTime(2000);
+    return test;
+  }
+
+  void storeCalls() {
+    ReachabilityCache cache(directory, "1");
+    cache.load(*program);
+    auto test = passedTest();
+    cache.store(test, {{nullptr, testBody}, {testBody, testee}});
+    cache.save();
+  }
+
+  std::string directory;
+  LLVMContext context;
+  std::unique_ptr<Program> program;
+  Function *testBody;
+  Function *testee;
+};
+
+TEST_F(ReachabilityCacheTest, restoresCallsOfUnchangedFunctions) {
+  storeCalls();
+
+  ReachabilityCache cache(directory, "1");
+  cache.load(*program);
+  mull::Test test("test_count_letters", "mull", "mull", {}, testBody);
+  Instrumentation::Calls calls;
+  ASSERT_TRUE(cache.restore(test, calls));
+  ASSERT_EQ(1U, cache.getHits());
+
+  ASSERT_EQ(2U, calls.size());
+  ASSERT_EQ(nullptr, calls[0].first);
+  ASSERT_EQ(testBody, calls[0].second);
+  ASSERT_EQ(testBody, calls[1].first);
+  ASSERT_EQ(testee, calls[1].second);
+
+  ASSERT_EQ(Passed, test.getExecutionResult().status);
+  ASSERT_EQ(7, test.getExecutionResult().runningTime);
+  ASSERT_EQ(std::vector<int64_t>({1000, 2000}), test.getRunningTimes());
+
+  mull::Test otherTest("other_test", "mull", "mull", {}, testBody);
+  ASSERT_FALSE(cache.restore(otherTest, calls));
+}
+
+TEST_F(ReachabilityCacheTest, doesNotRestoreCallsOfChangedFunctions) {
+  storeCalls();
+
+  IRBuilder<> builder(&testee->getEntryBlock().front());
+  builder.CreateAlloca(builder.getInt32Ty());
+
+  ReachabilityCache cache(directory, "1");
+  cache.load(*program);
+  mull::Test test("test_count_letters", "mull", "mull", {}, testBody);
+  Instrumentation::Calls calls;
+  ASSERT_FALSE(cache.restore(test, calls));
+  ASSERT_EQ(0U, cache.getHits());
+}
+
+TEST_F(ReachabilityCacheTest, keepsTheCallsOfEveryVersionApart) {
+  storeCalls();
+
+  ReachabilityCache cache(directory, "2");
+  cache.load(*program);
+  mull::Test test("test_count_letters", "mull", "mull", {}, testBody);
+  Instrumentation::Calls calls;
+  ASSERT_FALSE(cache.restore(test, calls));
+}
+
+TEST_F(ReachabilityCacheTest, doesNotStoreFailedTests) {
+  ReachabilityCache cache(directory, "1");
+  cache.load(*program);
+  mull::Test test("test_count_letters", "mull", "mull", {}, testBody);
+  ExecutionResult result;
+  result.status = Failed;
+  test.setExecutionResult(result);
+  cache.store(test, {{nullptr, testBody}});
+  cache.save();
+
+  ReachabilityCache reloaded(directory, "1");
+  reloaded.load(*program);
+  Instrumentation::Calls calls;
+  ASSERT_FALSE(reloaded.restore(test, calls));
+}
@@ -0,0 +1,85 @@
+#include "mull/ResultsDiff.h"
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+
+#include <map>
+#include <sqlite3.h>
+
+#include "gtest/gtest.h"
+
+using namespace mull;
+using namespace llvm;
+
+/// The tables of the SQLite reporter the diff reads, with a mutant per
+/// status: 1 is Failed, 2 is Passed
+static std::string createDatabase(const char *rows) {
+  SmallString<128> path;
+  if (sys::fs::createTemporaryFile("mull-diff", "sqlite", path)) {
+    return std::string();
+  }
+  sys::fs::remove(path);
+  sqlite3 *database = nullptr;
+  sqlite3_open(path.c_str(), &database);
+  std::string sql = "CREATE TABLE mutation_point (unique_id TEXT, mutator "
+                    "TEXT, filename TEXT, line_number INT, column_number "
+                    "INT, function_hash TEXT);"
+                    "CREATE TABLE execution_result (test_id TEXT, "
+                    "mutation_point_id TEXT, status INT, duration INT, "
+                    "stdout TEXT, stderr TEXT);";
+  sql += rows;
+  EXPECT_EQ(SQLITE_OK,
+            sqlite3_exec(database, sql.c_str(), nullptr, nullptr, nullptr));
+  sqlite3_close(database);
+  return path.str().str();
+}
+
+TEST(ResultsDiff, reportsTheMutantsThatChanged) {
+  auto previous = createDatabase(
+      "INSERT INTO mutation_point VALUES "
+      "('a1', 'add', 'a.cpp', 1, 1, 'h'), ('a2', 'add', 'a.cpp', 2, 1, 'h'),"
+      "('a3', 'sub', 'a.cpp', 3, 1, 'h'), ('a4', 'add', 'a.cpp', 4, 1, 'h');"
+      "INSERT INTO execution_result VALUES "
+      "('t', '', 2, 0, '', ''),"
+      "('t', 'a1', 2, 0, '', ''), ('u', 'a1', 1, 0, '', ''),"
+      "('t', 'a2', 2, 0, '', ''), ('t', 'a3', 1, 0, '', ''),"
+      "('t', 'a4', 2, 0, '', '');");
+  /// The identifiers change with the modules, the mutants stay the same
+  auto current = createDatabase(
+      "INSERT INTO mutation_point VALUES "
+      "('b1', 'add', 'a.cpp', 1, 1, 'h'), ('b2', 'add', 'a.cpp', 2, 1, 'h'),"
+      "('b4', 'add', 'a.cpp', 4, 1, 'h'), ('b5', 'add', 'b.cpp', 1, 1, 'h');"
+      "INSERT INTO execution_result VALUES "
+      "('t', 'b1', 2, 0, '', ''), ('u', 'b1', 2, 0, '', ''),"
+      "('t', 'b2', 3, 0, '', ''), ('t', 'b4', 2, 0, '', ''),"
+      "('t', 'b5', 2, 0, '', '');");
+  ASSERT_FALSE(previous.empty());
+  ASSERT_FALSE(current.empty());
+
+  std::map<MutantChange, std::vector<std::string>> changes;
+  std::string error;
+  ASSERT_TRUE(diffResults(
+      previous, current,
+      [&](MutantChange change, const DiffedMutant &mutant) {
+        changes[change].push_back(mutant.mutator + " " + mutant.file + ":" +
+                                  std::to_string(mutant.line));
+      },
+      error))
+      << error;
+
+  ASSERT_EQ(4U, changes.size());
+  ASSERT_EQ(std::vector<std::string>({"add a.cpp:1"}),
+            changes[MutantChange::NewlySurvived]);
+  ASSERT_EQ(std::vector<std::string>({"add a.cpp:2"}),
+            changes[MutantChange::NewlyKilled]);
+  ASSERT_EQ(std::vector<std::string>({"add b.cpp:1"}),
+            changes[MutantChange::Added]);
+  ASSERT_EQ(std::vector<std::string>({"sub a.cpp:3"}),
+            changes[MutantChange::Removed]);
+
+  ASSERT_FALSE(diffResults(previous, "/non-existing/results.sqlite",
+                           [](MutantChange, const DiffedMutant &) {}, error));
+
+  sys::fs::remove(previous);
+  sys::fs::remove(current);
+}
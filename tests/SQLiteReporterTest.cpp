@@ -1,6 +1,7 @@
 #include "mull/Reporters/SQLiteReporter.h"
 #include "FixturePaths.h"
 #include "TestModuleFactory.h"
+#include "mull/Checkpoint.h"
 #include "mull/Config/Configuration.h"
 #include "mull/Config/RawConfig.h"
 #include "mull/Filter.h"
@@ -8,6 +9,7 @@
 #include "mull/ModuleLoader.h"
 #include "mull/MutationsFinder.h"
 #include "mull/Mutators/MathAddMutator.h"
+#include "mull/PreviousResults.h"
 #include "mull/Program/Program.h"
 #include "mull/Result.h"
 #include "mull/TestFrameworks/SimpleTest/SimpleTestFinder.h"
@@ -21,6 +23,7 @@
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Module.h>
 #include <llvm/IR/Type.h>
+#include <llvm/Support/FileSystem.h>
 #include <sqlite3.h>
 
 using namespace mull;
@@ -156,12 +159,14 @@ TEST(SQLiteReporter, integrationTest) {
         ASSERT_EQ(column_status, executionResults[numberOfRows].status);
         ASSERT_EQ(column_duration, executionResults[numberOfRows].runningTime);
 
-        ASSERT_EQ(strcmp((const char *)column_stdout,
-                         executionResults[numberOfRows].stdoutOutput.c_str()),
-                  0);
-        ASSERT_EQ(strcmp((const char *)column_stderr,
-                         executionResults[numberOfRows].stderrOutput.c_str()),
-                  0);
+        ASSERT_EQ(
+            strcmp((const char *)column_stdout,
+                   executionResults[numberOfRows].stdoutOutput.str().c_str()),
+            0);
+        ASSERT_EQ(
+            strcmp((const char *)column_stderr,
+                   executionResults[numberOfRows].stderrOutput.str().c_str()),
+            0);
 
         numberOfRows++;
       } else if (stepResult == SQLITE_DONE) {
@@ -655,3 +660,438 @@ TEST(SQLiteReporter, do_not_emitDebugInfo) {
   sqlite3_finalize(selectStmt);
   sqlite3_close(database);
 }
+
+static int countRows(sqlite3 *database, const std::string &query) {
+  sqlite3_stmt *selectStmt;
+  sqlite3_prepare_v2(database, query.c_str(), query.size(), &selectStmt,
+                     nullptr);
+  int count = -1;
+  if (sqlite3_step(selectStmt) == SQLITE_ROW) {
+    count = sqlite3_column_int(selectStmt, 0);
+  }
+  sqlite3_finalize(selectStmt);
+  return count;
+}
+
+TEST(SQLiteReporter, streamsMutationResults) {
+  LLVMContext llvmContext;
+  ModuleLoader loader;
+  std::vector<std::unique_ptr<MullModule>> modules;
+  modules.push_back(loader.loadModuleAtPath(
+      fixtures::simple_test_count_letters_test_count_letters_bc_path(),
+      llvmContext));
+  modules.push_back(loader.loadModuleAtPath(
+      fixtures::simple_test_count_letters_count_letters_bc_path(),
+      llvmContext));
+  Program program({}, {}, std::move(modules));
+  Configuration configuration;
+
+  std::vector<std::unique_ptr<Mutator>> mutators;
+  mutators.emplace_back(make_unique<MathAddMutator>());
+  MutationsFinder mutationsFinder(std::move(mutators), configuration);
+  Filter filter;
+
+  SimpleTestFinder testFinder;
+  auto tests = testFinder.findTests(program, filter);
+  auto &test = tests.front();
+
+  Function *testeeFunction = program.lookupDefinedFunction("count_letters");
+  std::vector<std::unique_ptr<Testee>> testees;
+  testees.emplace_back(make_unique<Testee>(testeeFunction, nullptr, 1));
+  auto mergedTestees = mergeTestees(testees);
+  std::vector<MutationPoint *> mutationPoints =
+      mutationsFinder.getMutationPoints(program, mergedTestees, filter);
+  ASSERT_EQ(1U, mutationPoints.size());
+
+  SQLiteReporter reporter("streaming test");
+  reporter.beginStreaming();
+
+  std::vector<std::unique_ptr<MutationResult>> mutationResults;
+  for (int run = 0; run < 3; run++) {
+    ExecutionResult executionResult;
+    executionResult.status = Failed;
+    mutationResults.push_back(make_unique<MutationResult>(
+        executionResult, mutationPoints.front(), 1, &test));
+    reporter.reportMutationResult(*mutationResults.back());
+  }
+
+  Result result(std::move(tests), std::move(mutationResults), mutationPoints);
+  Metrics metrics;
+  metrics.setDriverRunTime(MetricsMeasure());
+  SandboxTimings timings;
+  timings.fork = 2000;
+  timings.test = 5000;
+  metrics.addSandboxTimings(timings);
+  metrics.addSandboxTimings(timings);
+  ChildUsage usage;
+  usage.userTime = 3000;
+  usage.maxResident = 2048;
+  metrics.addChildUsage(usage);
+  usage.maxResident = 1024;
+  metrics.addChildUsage(usage);
+  reporter.reportResults(result, RawConfig(), metrics);
+
+  sqlite3 *database;
+  sqlite3_open(reporter.getDatabasePath().c_str(), &database);
+
+  /// Every stage of the forked runs is measured, the swap was not
+  ASSERT_EQ(5, countRows(database, "SELECT COUNT(*) FROM latency"));
+  ASSERT_EQ(1, countRows(database, "SELECT COUNT(*) FROM latency WHERE "
+                                   "stage = 'fork' AND count = 2 AND "
+                                   "p50 = 2000 AND max = 2000"));
+  ASSERT_EQ(1, countRows(database, "SELECT COUNT(*) FROM resource_usage WHERE "
+                                   "runs = 2 AND user_time = 6000 AND "
+                                   "max_resident = 2048"));
+
+  /// The streamed results are not inserted a second time
+  ASSERT_EQ(3, countRows(database, "SELECT COUNT(*) FROM mutation_result"));
+  ASSERT_EQ(4, countRows(database, "SELECT COUNT(*) FROM execution_result"));
+  ASSERT_EQ(1, countRows(database, "SELECT COUNT(*) FROM test"));
+  ASSERT_EQ(1, countRows(database, "SELECT COUNT(*) FROM mutation_point"));
+  ASSERT_EQ(3, countRows(database, "SELECT COUNT(*) FROM sqlite_master "
+                                   "WHERE type = 'index' AND sql IS NOT NULL"));
+
+  sqlite3_close(database);
+}
+
+TEST(SQLiteReporter, writersMergeTheirShardsIntoTheReport) {
+  LLVMContext llvmContext;
+  ModuleLoader loader;
+  std::vector<std::unique_ptr<MullModule>> modules;
+  modules.push_back(loader.loadModuleAtPath(
+      fixtures::simple_test_count_letters_test_count_letters_bc_path(),
+      llvmContext));
+  modules.push_back(loader.loadModuleAtPath(
+      fixtures::simple_test_count_letters_count_letters_bc_path(),
+      llvmContext));
+  Program program({}, {}, std::move(modules));
+  Configuration configuration;
+
+  std::vector<std::unique_ptr<Mutator>> mutators;
+  mutators.emplace_back(make_unique<MathAddMutator>());
+  MutationsFinder mutationsFinder(std::move(mutators), configuration);
+  Filter filter;
+
+  SimpleTestFinder testFinder;
+  auto tests = testFinder.findTests(program, filter);
+  auto &test = tests.front();
+
+  Function *testeeFunction = program.lookupDefinedFunction("count_letters");
+  std::vector<std::unique_ptr<Testee>> testees;
+  testees.emplace_back(make_unique<Testee>(testeeFunction, nullptr, 1));
+  auto mergedTestees = mergeTestees(testees);
+  std::vector<MutationPoint *> mutationPoints =
+      mutationsFinder.getMutationPoints(program, mergedTestees, filter);
+  ASSERT_EQ(1U, mutationPoints.size());
+
+  SQLiteReporter reporter("sharded test", SQLiteSchema::Default, 3);
+  reporter.beginStreaming();
+
+  std::vector<std::unique_ptr<MutationResult>> mutationResults;
+  for (int run = 0; run < 7; run++) {
+    ExecutionResult executionResult;
+    executionResult.status = Failed;
+    mutationResults.push_back(make_unique<MutationResult>(
+        executionResult, mutationPoints.front(), 1, &test));
+    reporter.reportMutationResult(*mutationResults.back());
+  }
+
+  Result result(std::move(tests), std::move(mutationResults), mutationPoints);
+  Metrics metrics;
+  metrics.setDriverRunTime(MetricsMeasure());
+  reporter.reportResults(result, RawConfig(), metrics);
+
+  sqlite3 *database;
+  sqlite3_open(reporter.getDatabasePath().c_str(), &database);
+  ASSERT_EQ(7, countRows(database, "SELECT COUNT(*) FROM mutation_result"));
+  ASSERT_EQ(8, countRows(database, "SELECT COUNT(*) FROM execution_result"));
+  ASSERT_EQ(1, countRows(database, "SELECT COUNT(*) FROM test"));
+  ASSERT_EQ(1, countRows(database, "SELECT COUNT(*) FROM config"));
+  sqlite3_close(database);
+
+  /// The shards are gone once merged
+  for (int index = 0; index < 3; index++) {
+    ASSERT_FALSE(llvm::sys::fs::exists(reporter.getDatabasePath() +
+                                       ".shard-" + std::to_string(index)));
+  }
+}
+
+TEST(SQLiteReporter, normalizedSchemaKeepsTheDefaultTablesAsViews) {
+  RawConfig rawConfig(
+      "", "normalized test", "SimpleTest", {"add_mutation"}, {}, "", "", {},
+      {}, {}, RawConfig::Fork::Enabled, RawConfig::DryRunMode::Disabled,
+      RawConfig::FailFastMode::Disabled, RawConfig::UseCache::No,
+      RawConfig::EmitDebugInfo::Yes, Diagnostics::None, 42, 10, "",
+      JunkDetectionConfig::disabled(), ParallelizationConfig::defaultConfig());
+
+  LLVMContext llvmContext;
+  ModuleLoader loader;
+  std::vector<std::unique_ptr<MullModule>> modules;
+  modules.push_back(loader.loadModuleAtPath(
+      fixtures::simple_test_count_letters_test_count_letters_bc_path(),
+      llvmContext));
+  modules.push_back(loader.loadModuleAtPath(
+      fixtures::simple_test_count_letters_count_letters_bc_path(),
+      llvmContext));
+  Program program({}, {}, std::move(modules));
+  Configuration configuration;
+
+  std::vector<std::unique_ptr<Mutator>> mutators;
+  mutators.emplace_back(make_unique<MathAddMutator>());
+  MutationsFinder mutationsFinder(std::move(mutators), configuration);
+  Filter filter;
+
+  SimpleTestFinder testFinder;
+  auto tests = testFinder.findTests(program, filter);
+  auto &test = tests.front();
+
+  Function *testeeFunction = program.lookupDefinedFunction("count_letters");
+  std::vector<std::unique_ptr<Testee>> testees;
+  testees.emplace_back(make_unique<Testee>(testeeFunction, nullptr, 1));
+  auto mergedTestees = mergeTestees(testees);
+  std::vector<MutationPoint *> mutationPoints =
+      mutationsFinder.getMutationPoints(program, mergedTestees, filter);
+  ASSERT_EQ(1U, mutationPoints.size());
+  std::string mutationPointId = mutationPoints.front()->getUniqueIdentifier();
+
+  ExecutionResult testExecutionResult;
+  testExecutionResult.status = Passed;
+  testExecutionResult.stdoutOutput = "same output";
+  test.setExecutionResult(testExecutionResult);
+
+  SQLiteReporter reporter("normalized test", SQLiteSchema::Normalized);
+  reporter.beginStreaming();
+
+  ExecutionResult mutatedTestExecutionResult;
+  mutatedTestExecutionResult.status = Failed;
+  mutatedTestExecutionResult.stdoutOutput = "same output";
+  std::vector<std::unique_ptr<MutationResult>> mutationResults;
+  mutationResults.push_back(make_unique<MutationResult>(
+      mutatedTestExecutionResult, mutationPoints.front(), 1, &test));
+  reporter.reportMutationResult(*mutationResults.back());
+
+  Result result(std::move(tests), std::move(mutationResults), mutationPoints);
+  Metrics metrics;
+  metrics.setDriverRunTime(MetricsMeasure());
+  reporter.reportResults(result, rawConfig, metrics);
+
+  sqlite3 *database;
+  sqlite3_open(reporter.getDatabasePath().c_str(), &database);
+
+  ASSERT_EQ(2, countRows(database, "SELECT COUNT(*) FROM execution_result"));
+  ASSERT_EQ(1, countRows(database, "SELECT COUNT(*) FROM execution_result "
+                                   "WHERE mutation_point_id = '' AND "
+                                   "status = 2 AND stdout = 'same output'"));
+  ASSERT_EQ(1, countRows(database, "SELECT COUNT(*) FROM execution_result "
+                                   "WHERE mutation_point_id = '" +
+                                       mutationPointId +
+                                       "' AND status = 1 AND "
+                                       "stdout = 'same output'"));
+  ASSERT_EQ(1, countRows(database, "SELECT COUNT(*) FROM mutation_result "
+                                   "WHERE mutation_point_id = '" +
+                                       mutationPointId + "'"));
+  ASSERT_EQ(1, countRows(database, "SELECT COUNT(*) FROM test "
+                                   "WHERE test_name IS NOT NULL"));
+  ASSERT_EQ(1, countRows(database, "SELECT COUNT(*) FROM mutation_point "
+                                   "WHERE function_name = 'count_letters'"));
+  ASSERT_EQ(1, countRows(database, "SELECT COUNT(*) FROM mutation_point_debug "
+                                   "WHERE function IS NOT NULL"));
+
+  /// The outputs are stored once
+  ASSERT_EQ(1, countRows(database, "SELECT COUNT(*) FROM content "
+                                   "WHERE text = 'same output'"));
+
+  sqlite3_close(database);
+}
+
+TEST(SQLiteReporter, previousResultsReadTheDatabaseBack) {
+  LLVMContext llvmContext;
+  ModuleLoader loader;
+  std::vector<std::unique_ptr<MullModule>> modules;
+  modules.push_back(loader.loadModuleAtPath(
+      fixtures::simple_test_count_letters_test_count_letters_bc_path(),
+      llvmContext));
+  modules.push_back(loader.loadModuleAtPath(
+      fixtures::simple_test_count_letters_count_letters_bc_path(),
+      llvmContext));
+  Program program({}, {}, std::move(modules));
+  Configuration configuration;
+
+  std::vector<std::unique_ptr<Mutator>> mutators;
+  mutators.emplace_back(make_unique<MathAddMutator>());
+  MutationsFinder mutationsFinder(std::move(mutators), configuration);
+  Filter filter;
+
+  SimpleTestFinder testFinder;
+  auto tests = testFinder.findTests(program, filter);
+  auto &test = tests.front();
+
+  Function *testeeFunction = program.lookupDefinedFunction("count_letters");
+  std::vector<std::unique_ptr<Testee>> testees;
+  testees.emplace_back(make_unique<Testee>(testeeFunction, nullptr, 1));
+  auto mergedTestees = mergeTestees(testees);
+  std::vector<MutationPoint *> mutationPoints =
+      mutationsFinder.getMutationPoints(program, mergedTestees, filter);
+  ASSERT_EQ(1U, mutationPoints.size());
+  auto point = mutationPoints.front();
+  ASSERT_FALSE(point->getFunctionHash().empty());
+
+  ExecutionResult executionResult;
+  executionResult.status = Failed;
+  executionResult.runningTime = 42;
+  executionResult.stdoutOutput = "out";
+  std::vector<std::unique_ptr<MutationResult>> mutationResults;
+  mutationResults.push_back(
+      make_unique<MutationResult>(executionResult, point, 1, &test));
+
+  Result result(std::move(tests), std::move(mutationResults), mutationPoints);
+  SQLiteReporter reporter("previous results test");
+  reporter.reportResults(result, RawConfig(), Metrics());
+
+  PreviousResults previousResults;
+  std::string error;
+  ASSERT_TRUE(previousResults.load(reporter.getDatabasePath(), error))
+      << error;
+  ASSERT_EQ(1U, previousResults.size());
+
+  auto stored = previousResults.find(*point);
+  ASSERT_NE(nullptr, stored);
+  ASSERT_EQ(point->getFunctionHash(), stored->functionHash);
+  ASSERT_EQ(1U, stored->results.size());
+  auto &storedResult = stored->results.at(test.getUniqueIdentifier());
+  ASSERT_EQ(Failed, storedResult.status);
+  ASSERT_EQ(42, storedResult.runningTime);
+  ASSERT_EQ("out", storedResult.stdoutOutput.str());
+
+  auto &killRates = previousResults.getKillRates();
+  ASSERT_EQ(1U, killRates.size());
+  ASSERT_EQ(1.0, killRates.at(test.getUniqueIdentifier()));
+}
+
+TEST(SQLiteReporter, checkpointReadsTheStreamedResultsBack) {
+  LLVMContext llvmContext;
+  ModuleLoader loader;
+  std::vector<std::unique_ptr<MullModule>> modules;
+  modules.push_back(loader.loadModuleAtPath(
+      fixtures::simple_test_count_letters_test_count_letters_bc_path(),
+      llvmContext));
+  modules.push_back(loader.loadModuleAtPath(
+      fixtures::simple_test_count_letters_count_letters_bc_path(),
+      llvmContext));
+  Program program({}, {}, std::move(modules));
+  Configuration configuration;
+
+  std::vector<std::unique_ptr<Mutator>> mutators;
+  mutators.emplace_back(make_unique<MathAddMutator>());
+  MutationsFinder mutationsFinder(std::move(mutators), configuration);
+  Filter filter;
+
+  SimpleTestFinder testFinder;
+  auto tests = testFinder.findTests(program, filter);
+  auto &test = tests.front();
+
+  Function *testeeFunction = program.lookupDefinedFunction("count_letters");
+  std::vector<std::unique_ptr<Testee>> testees;
+  testees.emplace_back(make_unique<Testee>(testeeFunction, nullptr, 1));
+  auto mergedTestees = mergeTestees(testees);
+  std::vector<MutationPoint *> mutationPoints =
+      mutationsFinder.getMutationPoints(program, mergedTestees, filter);
+  ASSERT_EQ(1U, mutationPoints.size());
+  auto point = mutationPoints.front();
+
+  ExecutionResult executionResult;
+  executionResult.status = Failed;
+  executionResult.runningTime = 42;
+  executionResult.stdoutOutput = "out";
+  MutationResult mutationResult(executionResult, point, 1, &test);
+
+  std::string databasePath;
+  {
+    /// The run dies before the results are reported
+    SQLiteReporter reporter("checkpoint test");
+    reporter.beginStreaming();
+    reporter.reportMutationResult(mutationResult);
+    databasePath = reporter.getDatabasePath();
+  }
+
+  Checkpoint checkpoint;
+  std::string error;
+  ASSERT_TRUE(checkpoint.load(databasePath, error)) << error;
+  ASSERT_EQ(1U, checkpoint.size());
+
+  auto stored = checkpoint.find(*point);
+  ASSERT_NE(nullptr, stored);
+  ASSERT_EQ(1U, stored->size());
+  auto &storedResult = stored->at(test.getUniqueIdentifier());
+  ASSERT_EQ(Failed, storedResult.status);
+  ASSERT_EQ(42, storedResult.runningTime);
+  ASSERT_EQ("out", storedResult.stdoutOutput.str());
+}
+
+TEST(SQLiteReporter, mergeSQLiteDatabasesCombinesTheShards) {
+  LLVMContext llvmContext;
+  ModuleLoader loader;
+  std::vector<std::unique_ptr<MullModule>> modules;
+  modules.push_back(loader.loadModuleAtPath(
+      fixtures::simple_test_count_letters_test_count_letters_bc_path(),
+      llvmContext));
+  modules.push_back(loader.loadModuleAtPath(
+      fixtures::simple_test_count_letters_count_letters_bc_path(),
+      llvmContext));
+  Program program({}, {}, std::move(modules));
+  Configuration configuration;
+
+  std::vector<std::unique_ptr<Mutator>> mutators;
+  mutators.emplace_back(make_unique<MathAddMutator>());
+  MutationsFinder mutationsFinder(std::move(mutators), configuration);
+  Filter filter;
+
+  SimpleTestFinder testFinder;
+  auto tests = testFinder.findTests(program, filter);
+  auto &test = tests.front();
+
+  Function *testeeFunction = program.lookupDefinedFunction("count_letters");
+  std::vector<std::unique_ptr<Testee>> testees;
+  testees.emplace_back(make_unique<Testee>(testeeFunction, nullptr, 1));
+  auto mergedTestees = mergeTestees(testees);
+  std::vector<MutationPoint *> mutationPoints =
+      mutationsFinder.getMutationPoints(program, mergedTestees, filter);
+  ASSERT_EQ(1U, mutationPoints.size());
+
+  /// The shard with the mutant, and a normalized one with no mutants
+  ExecutionResult executionResult;
+  executionResult.status = Failed;
+  std::vector<std::unique_ptr<MutationResult>> mutationResults;
+  mutationResults.push_back(make_unique<MutationResult>(
+      executionResult, mutationPoints.front(), 1, &test));
+  Result result(std::move(tests), std::move(mutationResults), mutationPoints);
+  SQLiteReporter reporter("shard 0");
+  reporter.reportResults(result, RawConfig(), Metrics());
+
+  Result emptyResult(testFinder.findTests(program, filter),
+                     std::vector<std::unique_ptr<MutationResult>>(),
+                     std::vector<MutationPoint *>());
+  SQLiteReporter emptyReporter("shard 1", SQLiteSchema::Normalized);
+  emptyReporter.reportResults(emptyResult, RawConfig(), Metrics());
+
+  std::string mergedPath = reporter.getDatabasePath() + ".merged";
+  std::string error;
+  ASSERT_TRUE(mergeSQLiteDatabases(
+      mergedPath,
+      {emptyReporter.getDatabasePath(), reporter.getDatabasePath()}, error))
+      << error;
+  ASSERT_FALSE(mergeSQLiteDatabases(
+      mergedPath, {reporter.getDatabasePath()}, error));
+
+  sqlite3 *database;
+  sqlite3_open(mergedPath.c_str(), &database);
+  ASSERT_EQ(1, countRows(database, "SELECT COUNT(*) FROM test"));
+  ASSERT_EQ(1, countRows(database, "SELECT COUNT(*) FROM mutation_point"));
+  ASSERT_EQ(1, countRows(database, "SELECT COUNT(*) FROM mutation_result"));
+  /// The original run of the test is only taken from the first shard
+  ASSERT_EQ(2, countRows(database, "SELECT COUNT(*) FROM execution_result"));
+  ASSERT_EQ(1, countRows(database, "SELECT COUNT(*) FROM execution_result "
+                                   "WHERE mutation_point_id = ''"));
+  ASSERT_EQ(1, countRows(database, "SELECT COUNT(*) FROM config"));
+  sqlite3_close(database);
+}
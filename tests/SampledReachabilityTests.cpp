@@ -0,0 +1,123 @@
+#include "mull/Instrumentation/SampledReachability.h"
+#include "mull/Instrumentation/CallSampler.h"
+#include "mull/TestFrameworks/Test.h"
+#include "mull/Testee.h"
+
+#include <llvm/IR/DerivedTypes.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/LLVMContext.h>
+
+#include <set>
+#include <string>
+#include <utility>
+
+#include "gtest/gtest.h"
+
+using namespace mull;
+using namespace llvm;
+
+static LLVMContext context;
+
+static Function *function(const char *name) {
+  auto type = FunctionType::get(Type::getVoidTy(context), false);
+  return Function::Create(type, Function::ExternalLinkage, name, nullptr);
+}
+
+static std::set<std::pair<std::string, std::string>>
+reached(const std::vector<std::unique_ptr<Testee>> &testees) {
+  std::set<std::pair<std::string, std::string>> pairs;
+  for (auto &testee : testees) {
+    pairs.emplace(testee->getTest()->getTestName(),
+                  testee->getTesteeFunction()->getName().str());
+  }
+  return pairs;
+}
+
+TEST(FunctionAddresses, findsTheFunctionAnAddressIsIn) {
+  auto first = function("first");
+  auto second = function("second");
+  FunctionAddresses addresses;
+  addresses.add(second, 0x2000, 0x10);
+  addresses.add(first, 0x1000, 0x100);
+  addresses.sort();
+
+  ASSERT_EQ(nullptr, addresses.find(0xfff));
+  ASSERT_EQ(first, addresses.find(0x1000));
+  ASSERT_EQ(first, addresses.find(0x10ff));
+  ASSERT_EQ(nullptr, addresses.find(0x1100));
+  ASSERT_EQ(second, addresses.find(0x200f));
+  ASSERT_EQ(nullptr, addresses.find(0x2010));
+}
+
+TEST(SampledReachability, leavesOutTheTestBodyAndTheRepeatedFunctions) {
+  auto body = function("body");
+  auto callee = function("callee");
+  FunctionAddresses addresses;
+  addresses.add(body, 0x1000, 0x100);
+  addresses.add(callee, 0x2000, 0x100);
+  addresses.sort();
+  mull::Test test("test", "", "", {}, body);
+
+  auto testees =
+      sampledTestees(addresses, {0x1010, 0x2010, 0x2020, 0x9000}, test);
+
+  ASSERT_EQ(1U, testees.size());
+  ASSERT_EQ(callee, testees[0]->getTesteeFunction());
+  ASSERT_EQ(1, testees[0]->getDistance());
+}
+
+TEST(SampledReachability, narrowsTheHotFunctionsToTheTestsSampledInThem) {
+  auto hot = function("hot");
+  auto cold = function("cold");
+  auto missed = function("missed");
+  std::vector<mull::Test> tests;
+  tests.emplace_back("first", "", "", std::vector<std::string>(), nullptr);
+  tests.emplace_back("second", "", "", std::vector<std::string>(), nullptr);
+  auto &first = tests[0];
+  auto &second = tests[1];
+
+  std::vector<std::unique_ptr<Testee>> staticTestees;
+  staticTestees.push_back(make_unique<Testee>(hot, &first, 1));
+  staticTestees.push_back(make_unique<Testee>(cold, &first, 2));
+  staticTestees.push_back(make_unique<Testee>(hot, &second, 1));
+  staticTestees.push_back(make_unique<Testee>(cold, &second, 2));
+  std::vector<std::unique_ptr<Testee>> sampled;
+  sampled.push_back(make_unique<Testee>(hot, &first, 1));
+  sampled.push_back(make_unique<Testee>(missed, &second, 1));
+
+  auto testees = narrowBySamples(staticTestees, sampled);
+
+  std::set<std::pair<std::string, std::string>> expected = {
+      {"first", "hot"},
+      {"first", "cold"},
+      {"second", "cold"},
+      {"second", "missed"}};
+  ASSERT_EQ(expected, reached(testees));
+  ASSERT_EQ(4U, testees.size());
+  /// The hot function keeps the distance of the call graph
+  ASSERT_EQ(hot, testees[0]->getTesteeFunction());
+  ASSERT_EQ(1, testees[0]->getDistance());
+}
+
+TEST(CallSampler, samplesNothingWithoutAPeriod) {
+  CallSampler sampler(0);
+  ASSERT_FALSE(sampler.isSampling());
+
+  uint64_t samples[4] = {42, 0, 0, 0};
+  sampler.drain(samples, 3);
+  ASSERT_EQ(0U, samples[0]);
+}
+
+/// The machine may not allow the sampling, e.g. in a container
+TEST(CallSampler, neverWritesPastTheCapacity) {
+  CallSampler sampler(10000);
+  volatile uint64_t sum = 0;
+  for (uint64_t i = 0; i < 10000000; i++) {
+    sum += i;
+  }
+
+  uint64_t samples[5] = {0, 0, 0, 0, 0xdead};
+  sampler.drain(samples, 3);
+  ASSERT_LE(samples[0], 3U);
+  ASSERT_EQ(0xdeadU, samples[4]);
+}
@@ -0,0 +1,96 @@
+#include "mull/Parallelization/Tasks/SearchMutationPointsTask.h"
+
+#include "mull/Config/Configuration.h"
+#include "mull/Filter.h"
+#include "mull/MullModule.h"
+#include "mull/MutationsFinder.h"
+#include "mull/Program/Program.h"
+#include "mull/Testee.h"
+
+#include <llvm/AsmParser/Parser.h>
+#include <llvm/IR/Instruction.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/SourceMgr.h>
+
+#include "gtest/gtest.h"
+
+using namespace mull;
+using namespace llvm;
+
+static const char *const Assembly = R"IR(
+define i32 @sum(i32 %a, i32 %b) {
+  %first = add i32 %a, %b
+  %second = sub i32 %first, %b
+  ret i32 %second
+}
+)IR";
+
+namespace {
+
+/// Notes the opcodes of the instructions it is handed and mutates none
+class RecordingMutator : public Mutator {
+public:
+  RecordingMutator(std::vector<unsigned> opcodes, std::vector<unsigned> &seen)
+      : opcodes(std::move(opcodes)), seen(seen) {}
+
+  MutationPoint *getMutationPoint(MullModule *module, Function *function,
+                                  Instruction *instruction,
+                                  SourceLocation &sourceLocation,
+                                  MutationPointAddress &address) override {
+    seen.push_back(instruction->getOpcode());
+    return nullptr;
+  }
+
+  std::string getUniqueIdentifier() override { return "recording"; }
+  std::string getUniqueIdentifier() const override { return "recording"; }
+  std::string getDescription() const override { return ""; }
+  std::vector<unsigned> getOpcodes() const override { return opcodes; }
+  bool canBeApplied(Value &V) override { return false; }
+  Value *applyMutation(Function *function,
+                       MutationPointAddress &address) override {
+    return nullptr;
+  }
+
+private:
+  std::vector<unsigned> opcodes;
+  std::vector<unsigned> &seen;
+};
+
+} // namespace
+
+TEST(SearchMutationPointsTask, handsAMutatorOnlyItsOpcodes) {
+  LLVMContext context;
+  SMDiagnostic error;
+  auto llvmModule = parseAssemblyString(Assembly, error, context);
+  ASSERT_NE(nullptr, llvmModule);
+  std::vector<std::unique_ptr<MullModule>> modules;
+  modules.push_back(make_unique<MullModule>(
+      std::move(llvmModule), std::unique_ptr<MemoryBuffer>(), "hash"));
+  auto function = modules.front()->getModule()->getFunction("sum");
+  Program program({}, {}, std::move(modules));
+
+  std::vector<std::unique_ptr<Testee>> testees;
+  testees.emplace_back(make_unique<Testee>(function, nullptr, 1));
+  auto merged = mergeTestees(testees);
+
+  std::vector<unsigned> addsSeen;
+  std::vector<unsigned> allSeen;
+  std::vector<std::unique_ptr<Mutator>> mutators;
+  mutators.emplace_back(make_unique<RecordingMutator>(
+      std::vector<unsigned>({Instruction::Add}), addsSeen));
+  /// No opcodes stands for every instruction
+  mutators.emplace_back(
+      make_unique<RecordingMutator>(std::vector<unsigned>(), allSeen));
+
+  Configuration configuration;
+  Filter filter;
+  MutationsFinder finder(std::move(mutators), configuration);
+  auto points = finder.getMutationPoints(program, merged, filter);
+
+  ASSERT_TRUE(points.empty());
+  ASSERT_EQ(std::vector<unsigned>({Instruction::Add}), addsSeen);
+  ASSERT_EQ(std::vector<unsigned>(
+                {Instruction::Add, Instruction::Sub, Instruction::Ret}),
+            allSeen);
+}
@@ -0,0 +1,59 @@
+#include "mull/Toolchain/SlabMemoryManager.h"
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+
+using namespace mull;
+
+TEST(SlabMemoryManager, reservedSectionsAreAdjacent) {
+  SlabMemoryManager manager;
+  manager.reserveAllocationSpace(300, 16, 100, 8, 200, 8);
+
+  auto first = manager.allocateCodeSection(100, 16, 1, "first");
+  auto second = manager.allocateCodeSection(100, 16, 2, "second");
+  auto third = manager.allocateCodeSection(100, 16, 3, "third");
+  ASSERT_NE(first, nullptr);
+  ASSERT_EQ(first + 112, second);
+  ASSERT_EQ(second + 112, third);
+  ASSERT_EQ(0U, reinterpret_cast<uintptr_t>(first) % 16);
+
+  auto readOnly = manager.allocateDataSection(100, 8, 4, "readOnly", true);
+  auto writable = manager.allocateDataSection(100, 8, 5, "writable", false);
+  ASSERT_NE(readOnly, nullptr);
+  ASSERT_NE(writable, nullptr);
+  ASSERT_TRUE(readOnly + 100 <= first || first + 300 <= readOnly);
+  ASSERT_TRUE(writable + 100 <= readOnly || readOnly + 100 <= writable);
+}
+
+TEST(SlabMemoryManager, finalizeKeepsWritableDataWritable) {
+  SlabMemoryManager manager;
+  auto code = manager.allocateCodeSection(16, 16, 1, "code");
+  auto writable = manager.allocateDataSection(16, 8, 2, "writable", false);
+  memset(code, 0xc3, 16);
+  memset(writable, 1, 16);
+
+  std::string error;
+  ASSERT_FALSE(manager.finalizeMemory(&error)) << error;
+  memset(writable, 2, 16);
+  ASSERT_EQ(2, writable[15]);
+  ASSERT_EQ(0xc3, code[0]);
+
+  /// The finalized slab is not written again
+  auto nextCode = manager.allocateCodeSection(16, 16, 3, "nextCode");
+  ASSERT_NE(nextCode, nullptr);
+  ASSERT_NE(code + 16, nextCode);
+  memset(nextCode, 0xc3, 16);
+  ASSERT_FALSE(manager.finalizeMemory(&error)) << error;
+}
+
+TEST(SlabMemoryManager, slabsAreUnmapped) {
+  auto before = SlabMemoryManager::mappedBytes();
+  {
+    SlabMemoryManager manager;
+    ASSERT_NE(manager.allocateCodeSection(1024 * 1024, 16, 1, "large"),
+              nullptr);
+    ASSERT_LT(before, SlabMemoryManager::mappedBytes());
+  }
+  ASSERT_EQ(before, SlabMemoryManager::mappedBytes());
+}
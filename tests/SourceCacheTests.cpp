@@ -0,0 +1,50 @@
+#include "mull/SourceCache.h"
+
+#include "gtest/gtest.h"
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <string>
+
+using namespace mull;
+using namespace llvm;
+
+TEST(SourceCache, ReturnsTheLinesOfAFile) {
+  SmallString<128> path;
+  int descriptor = -1;
+  ASSERT_FALSE(sys::fs::createTemporaryFile("source", "c", descriptor, path));
+  {
+    raw_fd_ostream stream(descriptor, true);
+    stream << "int sum(int a, int b) {\n"
+              "\treturn a + b;\n"
+              "\n"
+              "}";
+  }
+  std::string filePath(path.str());
+
+  SourceCache cache;
+  ASSERT_EQ("int sum(int a, int b) {\n", cache.getLine(filePath, 1).str());
+  ASSERT_EQ("\treturn a + b;\n", cache.getLine(filePath, 2).str());
+  ASSERT_EQ("\n", cache.getLine(filePath, 3).str());
+  ASSERT_EQ("}", cache.getLine(filePath, 4).str());
+  ASSERT_TRUE(cache.getLine(filePath, 5).empty());
+  ASSERT_TRUE(cache.getLine(filePath, 0).empty());
+
+  /// The file is read once, the lines stay valid
+  sys::fs::remove(path);
+  ASSERT_EQ("\treturn a + b;\n", cache.getLine(filePath, 2).str());
+}
+
+TEST(SourceCache, MissingFileHasNoLines) {
+  SourceCache cache;
+  ASSERT_TRUE(cache.getLine("/no/such/file.c", 1).empty());
+}
+
+TEST(SourceCache, CaretKeepsTheTabs) {
+  ASSERT_EQ("\t       ^", SourceCache::caret("\treturn a + b;\n", 9));
+  ASSERT_EQ("^", SourceCache::caret("\treturn a + b;\n", 1));
+  ASSERT_TRUE(SourceCache::caret("}", 2).empty());
+  ASSERT_TRUE(SourceCache::caret("}", 0).empty());
+}
@@ -0,0 +1,82 @@
+#include "mull/SourceLocation.h"
+
+#include "gtest/gtest.h"
+
+#include <llvm/AsmParser/Parser.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/SourceMgr.h>
+
+using namespace mull;
+using namespace llvm;
+
+static const char *const ModuleWithDebugInfo = R"(
+define i32 @sum(i32 %a, i32 %b) !dbg !4 {
+  %result = add i32 %a, %b, !dbg !7
+  ret i32 %result, !dbg !8
+}
+
+!llvm.dbg.cu = !{!0}
+!llvm.module.flags = !{!3}
+
+!0 = distinct !DICompileUnit(language: DW_LANG_C99, file: !1, emissionKind: FullDebug)
+!1 = !DIFile(filename: "src/sum.c", directory: "/home/project")
+!3 = !{i32 2, !"Debug Info Version", i32 3}
+!4 = distinct !DISubprogram(name: "sum", scope: !1, file: !1, line: 3, type: !5, isDefinition: true, unit: !0)
+!5 = !DISubroutineType(types: !6)
+!6 = !{null}
+!7 = !DILocation(line: 4, column: 12, scope: !4)
+!8 = !DILocation(line: 4, column: 3, scope: !4)
+)";
+
+static std::unique_ptr<Module> loadModule(LLVMContext &context) {
+  SMDiagnostic error;
+  return parseAssemblyString(ModuleWithDebugInfo, error, context);
+}
+
+TEST(SourceLocation, sharesFileBetweenLocations) {
+  LLVMContext context;
+  auto module = loadModule(context);
+  ASSERT_TRUE(module != nullptr);
+  Function *sum = module->getFunction("sum");
+
+  auto &add = sum->front().front();
+  auto addLocation = SourceLocation::sourceLocationFromInstruction(&add);
+  auto returnLocation =
+      SourceLocation::sourceLocationFromInstruction(add.getNextNode());
+  auto functionLocation = SourceLocation::sourceLocationFromFunction(sum);
+
+  ASSERT_FALSE(addLocation.isNull());
+  ASSERT_EQ("/home/project", addLocation.directory());
+  ASSERT_EQ("/home/project/src/sum.c", addLocation.filePath());
+  ASSERT_EQ(4, addLocation.line);
+  ASSERT_EQ(12, addLocation.column);
+  ASSERT_EQ(3, functionLocation.line);
+
+  ASSERT_EQ(addLocation.file, returnLocation.file);
+  ASSERT_EQ(addLocation.file, functionLocation.file);
+  ASSERT_EQ(&addLocation.filePath(), &functionLocation.filePath());
+
+  SourceLocation sameFile("/home/project", "/home/project/src/sum.c", 1, 1);
+  ASSERT_EQ(addLocation.file, sameFile.file);
+
+  /// The same file seen from another context is the same file
+  LLVMContext otherContext;
+  auto otherModule = loadModule(otherContext);
+  auto otherLocation =
+      SourceLocation::sourceLocationFromFunction(otherModule->getFunction(
+          "sum"));
+  ASSERT_EQ(addLocation.file, otherLocation.file);
+}
+
+TEST(SourceLocation, nullLocation) {
+  auto location = SourceLocation::nullSourceLocation();
+  ASSERT_TRUE(location.isNull());
+  ASSERT_EQ("", location.directory());
+  ASSERT_EQ("", location.filePath());
+
+  SourceLocation other("/tmp", "/tmp/other.c", 2, 3);
+  ASSERT_FALSE(other.isNull());
+  ASSERT_NE(location.file, other.file);
+  ASSERT_EQ("/tmp/other.c", other.filePath());
+}
@@ -0,0 +1,118 @@
+#include "mull/Instrumentation/StaticCallGraph.h"
+#include "mull/Filter.h"
+#include "mull/TestFrameworks/Test.h"
+#include "mull/Testee.h"
+
+#include <llvm/AsmParser/Parser.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/SourceMgr.h>
+
+#include <map>
+#include <string>
+
+#include "gtest/gtest.h"
+
+using namespace mull;
+using namespace llvm;
+
+static const char *TestModule = "declare void @helper()\n"
+                                "define internal void @leaf() {\n"
+                                "  ret void\n"
+                                "}\n"
+                                "define void @test() {\n"
+                                "  call void @helper()\n"
+                                "  call void @helper()\n"
+                                "  ret void\n"
+                                "}\n";
+
+static const char *CodeModule =
+    "@callback = global void ()* @target\n"
+    "define void @helper() {\n"
+    "  call void @leaf()\n"
+    "  %f = load void ()*, void ()** @callback\n"
+    "  call void %f()\n"
+    "  ret void\n"
+    "}\n"
+    "define internal void @leaf() {\n"
+    "  ret void\n"
+    "}\n"
+    "define void @target() {\n"
+    "  call void @far()\n"
+    "  ret void\n"
+    "}\n"
+    "define void @far() {\n"
+    "  ret void\n"
+    "}\n"
+    "define void @unreached() {\n"
+    "  ret void\n"
+    "}\n";
+
+class StaticCallGraphTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    SMDiagnostic error;
+    testModule = parseAssemblyString(TestModule, error, testContext);
+    codeModule = parseAssemblyString(CodeModule, error, codeContext);
+    ASSERT_NE(nullptr, testModule);
+    ASSERT_NE(nullptr, codeModule);
+  }
+
+  /// The distance of every testee, by the name of its module and function
+  std::map<std::string, int> distances(int maxDistance, Filter &filter) {
+    StaticCallGraph callGraph({testModule.get(), codeModule.get()});
+    mull::Test test("test", "", "", {}, testModule->getFunction("test"));
+    std::map<std::string, int> reached;
+    for (auto &testee : callGraph.getTestees(test, filter, maxDistance)) {
+      auto function = testee->getTesteeFunction();
+      auto module = function->getParent() == testModule.get() ? "test:"
+                                                              : "code:";
+      reached[module + function->getName().str()] = testee->getDistance();
+    }
+    return reached;
+  }
+
+  LLVMContext testContext;
+  LLVMContext codeContext;
+  std::unique_ptr<Module> testModule;
+  std::unique_ptr<Module> codeModule;
+};
+
+TEST_F(StaticCallGraphTest, followsTheCallsAcrossModules) {
+  Filter filter;
+  auto reached = distances(128, filter);
+
+  std::map<std::string, int> expected = {{"test:test", 0},
+                                         {"code:helper", 1},
+                                         {"code:leaf", 2},
+                                         {"code:target", 2},
+                                         {"code:far", 3}};
+  ASSERT_EQ(expected, reached);
+}
+
+TEST_F(StaticCallGraphTest, stopsAtTheMaxDistance) {
+  Filter filter;
+  auto reached = distances(1, filter);
+
+  std::map<std::string, int> expected = {{"test:test", 0},
+                                         {"code:helper", 1}};
+  ASSERT_EQ(expected, reached);
+}
+
+TEST_F(StaticCallGraphTest, doesNotFollowTheFilteredFunctions) {
+  Filter filter;
+  filter.skipByName("target");
+  auto reached = distances(128, filter);
+
+  std::map<std::string, int> expected = {
+      {"test:test", 0}, {"code:helper", 1}, {"code:leaf", 2}};
+  ASSERT_EQ(expected, reached);
+}
+
+TEST_F(StaticCallGraphTest, countsEachCallOnce) {
+  StaticCallGraph callGraph({testModule.get(), codeModule.get()});
+
+  ASSERT_EQ(7U, callGraph.getFunctionCount());
+  /// test -> helper, helper -> leaf, target -> far
+  ASSERT_EQ(3U, callGraph.getCallCount());
+}
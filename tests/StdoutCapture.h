@@ -0,0 +1,37 @@
+#pragma once
+
+#include <llvm/Support/raw_ostream.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <unistd.h>
+
+/// Points stdout at a temporary file for the lifetime of the capture
+class StdoutCapture {
+public:
+  StdoutCapture() : path("/tmp/mull-stdout-capture.XXXXXX") {
+    int file = mkstemp(&path[0]);
+    llvm::outs().flush();
+    saved = dup(STDOUT_FILENO);
+    dup2(file, STDOUT_FILENO);
+    close(file);
+  }
+
+  std::string finish() {
+    llvm::outs().flush();
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+    std::ifstream file(path);
+    std::stringstream content;
+    content << file.rdbuf();
+    std::remove(path.c_str());
+    return content.str();
+  }
+
+private:
+  std::string path;
+  int saved;
+};
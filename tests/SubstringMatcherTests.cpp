@@ -0,0 +1,40 @@
+#include "mull/SubstringMatcher.h"
+
+#include "gtest/gtest.h"
+
+using namespace mull;
+
+TEST(SubstringMatcher, matchesLikeFind) {
+  std::vector<std::string> patterns(
+      {"he", "she", "his", "hers", "gtest", "include/c++/v1", "a"});
+  std::vector<std::string> texts(
+      {"", "h", "ushers", "this", "hi", "/usr/include/c++/v1/vector",
+       "/usr/include/c++/v2/vector", "googletest", "gtes", "xyz", "ahishers",
+       "abc", "shhis"});
+
+  for (size_t count = 0; count <= patterns.size(); count++) {
+    SubstringMatcher matcher;
+    for (size_t i = 0; i < count; i++) {
+      matcher.addPattern(patterns[i]);
+    }
+    ASSERT_EQ(count == 0, matcher.empty());
+
+    for (auto &text : texts) {
+      bool found = false;
+      for (size_t i = 0; i < count; i++) {
+        found |= text.find(patterns[i]) != std::string::npos;
+      }
+      ASSERT_EQ(found, matcher.matches(text)) << text << " " << count;
+    }
+  }
+}
+
+TEST(SubstringMatcher, emptyPatternMatchesAnything) {
+  SubstringMatcher matcher;
+  matcher.addPattern("abc");
+  ASSERT_FALSE(matcher.matches("xyz"));
+
+  matcher.addPattern("");
+  ASSERT_TRUE(matcher.matches("xyz"));
+  ASSERT_TRUE(matcher.matches(""));
+}
@@ -0,0 +1,52 @@
+#include "FixturePaths.h"
+#include "mull/Config/Configuration.h"
+#include "mull/ModuleLoader.h"
+#include "mull/Toolchain/SymbolIndex.h"
+#include "mull/Toolchain/Toolchain.h"
+
+#include <llvm/IR/LLVMContext.h>
+
+#include "gtest/gtest.h"
+
+using namespace mull;
+using namespace llvm;
+
+TEST(SymbolIndex, lookup) {
+  Configuration configuration;
+  Toolchain toolchain(configuration);
+
+  LLVMContext context;
+  ModuleLoader loader;
+  auto tests = loader.loadModuleAtPath(
+      fixtures::simple_test_count_letters_test_count_letters_bc_path(),
+      context);
+  auto testees = loader.loadModuleAtPath(
+      fixtures::simple_test_count_letters_count_letters_bc_path(), context);
+
+  auto testsObject = toolchain.compiler().compileModule(
+      tests->getModule(), toolchain.targetMachine());
+  auto testeesObject = toolchain.compiler().compileModule(
+      testees->getModule(), toolchain.targetMachine());
+
+  std::vector<object::ObjectFile *> objectFiles(
+      {testsObject.getBinary(), testeesObject.getBinary()});
+  SymbolIndex index(objectFiles);
+
+  ASSERT_TRUE(index.indexes(objectFiles));
+  ASSERT_FALSE(index.indexes({testeesObject.getBinary()}));
+
+  size_t objectIndex = 0;
+  auto &mangler = toolchain.mangler();
+
+  /// The module with tests only references count_letters, so it is not
+  /// counted as a definition
+  ASSERT_TRUE(
+      index.lookup(mangler.getNameWithPrefix("count_letters"), objectIndex));
+  ASSERT_EQ(1u, objectIndex);
+
+  ASSERT_TRUE(index.lookup(mangler.getNameWithPrefix("test_count_letters"),
+                           objectIndex));
+  ASSERT_EQ(0u, objectIndex);
+
+  ASSERT_FALSE(index.lookup("no_such_symbol", objectIndex));
+}
@@ -1,7 +1,14 @@
 #include "gtest/gtest.h"
 
+#include "mull/Config/ConfigurationOptions.h"
 #include "mull/Parallelization/Parallelization.h"
 
+#include <llvm/Support/raw_ostream.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
 #include <vector>
 
 using namespace mull;
@@ -20,6 +27,26 @@ public:
   }
 };
 
+/// Tags every item with the task that consumed it
+class TagTask {
+public:
+  using In = std::vector<int>;
+  using Out = std::vector<std::pair<int, int>>;
+  using iterator = In::const_iterator;
+
+  explicit TagTask(int tag) : tag(tag) {}
+
+  void operator()(iterator begin, iterator end, Out &storage,
+                  progress_counter &counter) {
+    for (auto it = begin; it != end; ++it, counter.increment()) {
+      storage.emplace_back(*it, tag);
+    }
+  }
+
+private:
+  int tag;
+};
+
 class EmptyTask {
 public:
   using In = std::vector<int>;
@@ -114,3 +141,351 @@ TEST(TaskExecutor, SequentialExecution_EmptyTask_MoreWorkers) {
 
   ASSERT_EQ(expected, out);
 }
+
+TEST(TaskExecutor, ParallelExecution_AddNumber_PreservesOrder) {
+  int workers = 4;
+  std::vector<AddNumberTask> tasks;
+  for (int i = 0; i < workers; i++) {
+    tasks.emplace_back(AddNumberTask());
+  }
+
+  std::vector<int> in;
+  std::vector<int> expected;
+  for (int i = 0; i < 1000; i++) {
+    in.push_back(i);
+    expected.push_back(i + 1);
+  }
+  std::vector<int> out;
+
+  TaskExecutor<AddNumberTask> executor("increment numbers", in, out,
+                                       std::move(tasks));
+  executor.execute();
+
+  ASSERT_EQ(expected, out);
+  ASSERT_EQ(size_t(workers), executor.getWorkersMetrics().size());
+}
+
+/// Cancels the run once it comes across the item
+class CancellingTask {
+public:
+  using In = std::vector<int>;
+  using Out = std::vector<int>;
+  using iterator = In::const_iterator;
+
+  explicit CancellingTask(int last) : last(last) {}
+
+  void operator()(iterator begin, iterator end, Out &storage,
+                  progress_counter &counter) {
+    for (auto it = begin; it != end; ++it, counter.increment()) {
+      storage.push_back(*it);
+      if (*it == last) {
+        Cancellation::shared().cancel(Cancellation::Reason::Survivor);
+      }
+    }
+  }
+
+private:
+  int last;
+};
+
+TEST(TaskExecutor, Cancellation_SequentialExecutionKeepsTheItemsThatRan) {
+  std::vector<CancellingTask> tasks(1, CancellingTask(10));
+  std::vector<int> in(100);
+  for (int i = 0; i < int(in.size()); i++) {
+    in[i] = i;
+  }
+  std::vector<int> out;
+
+  TaskExecutor<CancellingTask> executor("cancelling", in, out,
+                                        std::move(tasks),
+                                        TaskDispatch::OneByOne);
+  executor.execute();
+  auto reason = Cancellation::shared().reason();
+  Cancellation::shared().reset();
+
+  ASSERT_EQ(std::vector<int>(in.begin(), in.begin() + 11), out);
+  ASSERT_EQ(Cancellation::Reason::Survivor, reason);
+}
+
+TEST(TaskExecutor, Cancellation_ParallelExecutionStopsHandingOutItems) {
+  std::vector<CancellingTask> tasks(4, CancellingTask(10));
+  std::vector<int> in(1000);
+  for (int i = 0; i < int(in.size()); i++) {
+    in[i] = i;
+  }
+  std::vector<int> out;
+
+  TaskExecutor<CancellingTask> executor("cancelling", in, out,
+                                        std::move(tasks),
+                                        TaskDispatch::OneByOne);
+  executor.execute();
+  Cancellation::shared().reset();
+
+  /// The workers finish the items they had, in the order of the input
+  ASSERT_NE(out.end(), std::find(out.begin(), out.end(), 10));
+  ASSERT_TRUE(std::is_sorted(out.begin(), out.end()));
+  ASSERT_LT(out.size(), size_t(20));
+}
+
+TEST(Cancellation, TheFirstReasonSticks) {
+  Cancellation::shared().setDeadline(3600);
+  ASSERT_FALSE(Cancellation::shared().cancelled());
+
+  Cancellation::shared().cancel(Cancellation::Reason::Interrupted);
+  Cancellation::shared().cancel(Cancellation::Reason::Survivor);
+  ASSERT_TRUE(Cancellation::shared().cancelled());
+  ASSERT_EQ(Cancellation::Reason::Interrupted,
+            Cancellation::shared().reason());
+
+  Cancellation::shared().reset();
+  ASSERT_FALSE(Cancellation::shared().cancelled());
+  ASSERT_EQ(Cancellation::Reason::None, Cancellation::shared().reason());
+}
+
+TEST(TaskExecutor, TaskChunks) {
+  std::vector<int> chunks = taskChunks(100, 4);
+
+  int total = 0;
+  for (auto chunk : chunks) {
+    ASSERT_GE(chunk, 1);
+    total += chunk;
+  }
+  ASSERT_EQ(100, total);
+
+  ASSERT_EQ(12, chunks.front());
+  ASSERT_EQ(1, chunks.back());
+  ASSERT_TRUE(std::is_sorted(chunks.rbegin(), chunks.rend()));
+}
+
+TEST(TaskExecutor, TaskChunks_SingleItemPerWorker) {
+  std::vector<int> chunks = taskChunks(3, 3);
+  ASSERT_EQ(std::vector<int>({1, 1, 1}), chunks);
+}
+
+TEST(TaskExecutor, LargestFirst) {
+  std::vector<uint64_t> sizes({10, 500, 20, 500, 0, 300});
+  std::vector<size_t> expected({1, 3, 5, 2, 0, 4});
+  ASSERT_EQ(expected, largestFirst(sizes));
+  ASSERT_TRUE(largestFirst({}).empty());
+}
+
+TEST(StreamingTaskExecutor, ConsumesItemsWhileTheyAreProduced) {
+  int workers = 3;
+  std::vector<AddNumberTask> tasks;
+  for (int i = 0; i < workers; i++) {
+    tasks.emplace_back(AddNumberTask());
+  }
+
+  /// The queue is smaller than the input, so the producer can only finish
+  /// when the consumers are already running
+  BoundedQueue<int> queue(2);
+  std::vector<int> out;
+  StreamingTaskExecutor<AddNumberTask> executor("increment numbers", queue,
+                                                out, std::move(tasks));
+  executor.start();
+  for (int i = 0; i < 100; i++) {
+    queue.push(i);
+  }
+  queue.close();
+  executor.wait();
+
+  std::vector<int> expected;
+  for (int i = 0; i < 100; i++) {
+    expected.push_back(i + 1);
+  }
+  std::sort(out.begin(), out.end());
+  ASSERT_EQ(expected, out);
+  ASSERT_EQ(size_t(workers), executor.getWorkersMetrics().size());
+}
+
+TEST(StreamingTaskExecutor, ConsumesEveryPartitionOnItsOwnTask) {
+  int workers = 3;
+  std::vector<TagTask> tasks;
+  for (int i = 0; i < workers; i++) {
+    tasks.emplace_back(i);
+  }
+
+  PartitionedQueue<int> queue(workers, 2);
+  std::vector<std::pair<int, int>> out;
+  StreamingTaskExecutor<TagTask> executor("tag numbers", queue, out,
+                                          std::move(tasks));
+  executor.start();
+  for (int i = 0; i < 100; i++) {
+    queue.push(size_t(i), i);
+  }
+  queue.close();
+  executor.wait();
+
+  ASSERT_EQ(100U, out.size());
+  for (auto &numberAndTag : out) {
+    ASSERT_EQ(numberAndTag.first % workers, numberAndTag.second);
+  }
+}
+
+TEST(ProgressCounter, CountersDoNotShareCacheLines) {
+  std::vector<progress_counter> counters(2);
+  auto first = reinterpret_cast<uintptr_t>(&counters[0]);
+  auto second = reinterpret_cast<uintptr_t>(&counters[1]);
+  ASSERT_GE(second - first, progress_counter::CacheLineSize);
+
+  counters[1].increment();
+  ASSERT_EQ(0u, counters[0].get());
+  ASSERT_EQ(1u, counters[1].get());
+}
+
+TEST(ProgressReporter, StopsOnceCompletedEvenIfCountersLag) {
+  std::string name("lagging phase");
+  std::vector<progress_counter> counters(1);
+  counters[0].increment();
+
+  std::string output;
+  llvm::raw_string_ostream stream(output);
+  progress_completion completion;
+  std::thread reporter(
+      progress_reporter{name, counters, 10, 1, stream, &completion});
+  completion.finish();
+  reporter.join();
+
+  ASSERT_NE(std::string::npos,
+            stream.str().find("\"phase\": \"lagging phase\", \"threads\": 1, "
+                              "\"done\": 1, \"total\": 10}"));
+}
+
+TEST(ProgressReporter, ReportsTheTimeLeftGivenAnEstimate) {
+  std::string name("estimated phase");
+  std::vector<progress_counter> counters(1);
+
+  std::string output;
+  llvm::raw_string_ostream stream(output);
+  progress_reporter reporter{name, counters, 10, 1, stream};
+  reporter.setEstimate(int64_t(100) * 1000 * 1000 * 1000);
+  reporter.printProgress(5, 10, true);
+  reporter.printProgress(10, 10, true);
+
+  ASSERT_NE(std::string::npos,
+            stream.str().find("\"done\": 5, \"total\": 10, \"eta_seconds\": "));
+  ASSERT_NE(std::string::npos,
+            stream.str().find("\"done\": 10, \"total\": 10}"));
+}
+
+TEST(ThreadPool, ReusesThreadsAcrossPhases) {
+  ThreadPool pool;
+  ParallelizationConfig config;
+  config.workers = 2;
+  pool.configure(config);
+  ASSERT_EQ(2u, pool.size());
+
+  for (int phase = 0; phase < 3; phase++) {
+    std::atomic<int> done(0);
+    WorkerGroup group(pool);
+    group.run([&done]() { done++; });
+    group.run([&done]() { done++; });
+    group.wait();
+    ASSERT_EQ(2, done.load());
+  }
+  ASSERT_EQ(2u, pool.size());
+}
+
+TEST(ThreadPool, GrowsWhenJobsWaitForEachOther) {
+  ThreadPool pool;
+  BoundedQueue<int> queue(1);
+  std::atomic<int> consumed(0);
+
+  WorkerGroup consumers(pool);
+  consumers.run([&]() {
+    int item;
+    while (queue.pop(item)) {
+      consumed++;
+    }
+  });
+
+  WorkerGroup producers(pool);
+  producers.run([&]() {
+    for (int i = 0; i < 10; i++) {
+      queue.push(i);
+    }
+    queue.close();
+  });
+  producers.wait();
+  consumers.wait();
+  ASSERT_EQ(10, consumed.load());
+}
+
+TEST(ThreadPool, InterleavesTheCPUsOfNUMANodes) {
+  ASSERT_EQ(std::vector<int>({0, 1, 2, 3, 8, 10, 11}),
+            parseCPUList("0-3,8,10-11\n"));
+
+  std::vector<std::vector<int>> nodes({{0, 1, 2}, {4, 5}});
+  ASSERT_EQ(std::vector<int>({0, 4, 1, 5, 2}), interleaveCPUs(nodes));
+}
+
+TEST(ThreadPool, PinnedThreadsRunJobs) {
+  ThreadPool pool;
+  ParallelizationConfig config;
+  config.workers = 2;
+  config.pinWorkers = true;
+  pool.configure(config);
+
+  std::atomic<int> done(0);
+  WorkerGroup group(pool);
+  for (int job = 0; job < 4; job++) {
+    group.run([&done]() {
+      std::vector<char> memory(1024 * 1024, 1);
+      done += memory.back();
+    });
+  }
+  group.wait();
+  ASSERT_EQ(4, done.load());
+}
+
+TEST(TaskExecutor, calibrationSlices) {
+  using Slices = std::vector<std::pair<size_t, size_t>>;
+  ASSERT_EQ(Slices({{2, 4}, {4, 8}, {8, 16}}), calibrationSlices(200, 8));
+  ASSERT_EQ(Slices({{2, 1000}, {4, 1000}, {8, 1000}}),
+            calibrationSlices(300000, 8));
+  ASSERT_EQ(Slices({{1, 2}, {2, 4}}), calibrationSlices(100, 2));
+  ASSERT_TRUE(calibrationSlices(100, 1).empty());
+  ASSERT_TRUE(calibrationSlices(50, 8).empty());
+}
+
+/// Every item takes longer the more items run at once
+class ContendedTask {
+public:
+  using In = std::vector<int>;
+  using Out = std::vector<int>;
+  using iterator = In::const_iterator;
+
+  explicit ContendedTask(std::atomic<int> &running) : running(running) {}
+
+  void operator()(iterator begin, iterator end, Out &storage,
+                  progress_counter &counter) {
+    for (auto it = begin; it != end; ++it, counter.increment()) {
+      int concurrent = ++running;
+      std::this_thread::sleep_for(
+          std::chrono::milliseconds(2 * concurrent * concurrent));
+      running--;
+      storage.push_back(*it);
+    }
+  }
+
+private:
+  std::atomic<int> &running;
+};
+
+TEST(TaskExecutor, autoTune_SettlesOnTheFastestWorkers) {
+  std::atomic<int> running(0);
+  std::vector<ContendedTask> tasks(4, ContendedTask(running));
+  std::vector<int> in(200);
+  for (int i = 0; i < int(in.size()); i++) {
+    in[i] = i;
+  }
+  std::vector<int> out;
+
+  TaskExecutor<ContendedTask> executor("contended", in, out, std::move(tasks),
+                                       TaskDispatch::OneByOne);
+  executor.setAutoTune(true);
+  executor.execute();
+
+  ASSERT_EQ(in, out);
+  ASSERT_EQ(1U, executor.getTunedWorkers());
+}
@@ -0,0 +1,120 @@
+#include "mull/TestPrioritization.h"
+
+#include "mull/ChangedLines.h"
+#include "mull/TestFrameworks/Test.h"
+
+#include "MutationPointsFixture.h"
+
+#include "gtest/gtest.h"
+
+using namespace mull;
+using namespace llvm;
+
+class TestPrioritizationTest : public MutationPointsFixture {
+protected:
+  void SetUp() override {
+    MutationPointsFixture::SetUp();
+    point = addPoint();
+
+    /// Discovered slow and far first
+    slowFar = addTest("slow_far", 900, 3);
+    fastFar = addTest("fast_far", 10, 3);
+    slowNear = addTest("slow_near", 500, 1);
+    fastNear = addTest("fast_near", 10, 1);
+  }
+
+  mull::Test *addTest(const std::string &name, long long runningTime,
+                      int distance) {
+    tests.push_back(make_unique<mull::Test>(
+        name, "mull", "mull", std::vector<std::string>(), nullptr));
+    ExecutionResult result;
+    result.status = Passed;
+    result.runningTime = runningTime;
+    tests.back()->setExecutionResult(result);
+    point->addReachableTest(tests.back().get(), distance);
+    return tests.back().get();
+  }
+
+  std::vector<mull::Test *> order() {
+    std::vector<mull::Test *> tests;
+    for (auto reachableTest : point->getReachableTests()) {
+      tests.push_back(reachableTest.first);
+    }
+    return tests;
+  }
+
+  void prioritize(TestOrder testOrder,
+                  const std::unordered_map<std::string, double> &rates = {}) {
+    prioritizeReachableTests({point}, testOrder, rates);
+  }
+
+  MutationPoint *point;
+  std::vector<std::unique_ptr<mull::Test>> tests;
+  mull::Test *slowFar;
+  mull::Test *fastFar;
+  mull::Test *slowNear;
+  mull::Test *fastNear;
+};
+
+TEST_F(TestPrioritizationTest, keepsTheDiscoveryOrder) {
+  prioritize(TestOrder::Discovery);
+  ASSERT_EQ(std::vector<mull::Test *>({slowFar, fastFar, slowNear, fastNear}),
+            order());
+}
+
+TEST_F(TestPrioritizationTest, runsTheNearestTestsFirst) {
+  prioritize(TestOrder::Distance);
+  ASSERT_EQ(std::vector<mull::Test *>({fastNear, slowNear, fastFar, slowFar}),
+            order());
+  ASSERT_EQ(1, point->getReachableTests().front().second);
+}
+
+TEST_F(TestPrioritizationTest, runsTheFastestTestsFirst) {
+  prioritize(TestOrder::Runtime);
+  ASSERT_EQ(std::vector<mull::Test *>({fastNear, fastFar, slowNear, slowFar}),
+            order());
+}
+
+TEST_F(TestPrioritizationTest, runsTheTestsThatKilledTheMostFirst) {
+  prioritize(TestOrder::KillRate,
+             {{slowFar->getUniqueIdentifier(), 0.75},
+              {fastFar->getUniqueIdentifier(), 0.25},
+              {slowNear->getUniqueIdentifier(), 0.75}});
+  ASSERT_EQ(std::vector<mull::Test *>({slowNear, slowFar, fastFar, fastNear}),
+            order());
+}
+
+TEST_F(TestPrioritizationTest, sortsTheListOfAFunctionOnce) {
+  auto sibling = addPoint();
+  auto discovered = point->getSharedReachableTests();
+  sibling->setReachableTests(discovered);
+
+  prioritizeReachableTests({point, sibling}, TestOrder::Distance, {});
+
+  ASSERT_EQ(std::vector<mull::Test *>({fastNear, slowNear, fastFar, slowFar}),
+            order());
+  ASSERT_EQ(point->getSharedReachableTests(),
+            sibling->getSharedReachableTests());
+  /// The list in the discovery order is left as it was
+  ASSERT_EQ(slowFar, discovered->front().first);
+}
+
+TEST_F(TestPrioritizationTest, runsTheMutantsOnTheChangedLinesFirst) {
+  SourceLocation line10("/src", "/src/a.cpp", 10, 1);
+  SourceLocation line20("/src", "/src/a.cpp", 20, 1);
+  SourceLocation otherFile("/src", "/src/b.cpp", 20, 1);
+  auto unchanged = addPoint(mutator, "mutated", line10);
+  auto changed = addPoint(mutator, "mutated", line20);
+  auto elsewhere = addPoint(mutator, "mutated", otherFile);
+  ChangedLines changes;
+  changes.addLine("a.cpp", 20);
+
+  auto ordered = feedbackFirst({point, unchanged, changed, elsewhere},
+                               &changes, nullptr);
+
+  ASSERT_EQ(std::vector<MutationPoint *>(
+                {changed, point, unchanged, elsewhere}),
+            ordered);
+  ASSERT_EQ(std::vector<MutationPoint *>({point, unchanged}),
+            feedbackFirst({point, unchanged}, nullptr, nullptr));
+}
@@ -2,10 +2,15 @@
 #include "TestModuleFactory.h"
 #include "mull/Config/Configuration.h"
 #include "mull/Filter.h"
+#include "mull/Instrumentation/Instrumentation.h"
+#include "mull/Metrics/Metrics.h"
 #include "mull/ModuleLoader.h"
 #include "mull/MutationsFinder.h"
 #include "mull/Mutators/MathAddMutator.h"
+#include "mull/Parallelization/Progress.h"
+#include "mull/Parallelization/Tasks/InstrumentedCompilationTask.h"
 #include "mull/Program/Program.h"
+#include "mull/TestFrameworks/GoogleTest/GoogleTestRunner.h"
 #include "mull/TestFrameworks/NativeTestRunner.h"
 #include "mull/TestFrameworks/SimpleTest/SimpleTestFinder.h"
 #include "mull/Testee.h"
@@ -119,3 +124,214 @@ TEST(NativeTestRunner, runTest) {
 
   ASSERT_EQ(ExecutionStatus::Failed, testRunner.runTest(jit, program, test));
 }
+
+TEST(NativeTestRunner, runTest_LazyJIT) {
+  Configuration configuration;
+
+  Toolchain toolchain(configuration);
+
+  LLVMContext llvmContext;
+  ModuleLoader loader;
+  auto ownedModuleWithTests = loader.loadModuleAtPath(
+      fixtures::simple_test_count_letters_test_count_letters_bc_path(),
+      llvmContext);
+  auto ownedModuleWithTestees = loader.loadModuleAtPath(
+      fixtures::simple_test_count_letters_count_letters_bc_path(), llvmContext);
+
+  Module *moduleWithTests = ownedModuleWithTests->getModule();
+  Module *moduleWithTestees = ownedModuleWithTestees->getModule();
+
+  std::vector<std::unique_ptr<MullModule>> modules;
+  modules.push_back(std::move(ownedModuleWithTestees));
+  modules.push_back(std::move(ownedModuleWithTests));
+  Program program({}, {}, std::move(modules));
+
+  NativeTestRunner testRunner(toolchain.mangler());
+  NativeTestRunner::ObjectFiles objectFiles;
+  NativeTestRunner::OwnedObjectFiles ownedObjectFiles;
+
+  std::vector<std::unique_ptr<Mutator>> mutators;
+  mutators.emplace_back(make_unique<MathAddMutator>());
+  MutationsFinder mutationsFinder(std::move(mutators), configuration);
+  Filter filter;
+
+  Function *testeeFunction = program.lookupDefinedFunction("count_letters");
+  std::vector<std::unique_ptr<Testee>> testees;
+  testees.emplace_back(make_unique<Testee>(testeeFunction, nullptr, 1));
+  auto mergedTestees = mergeTestees(testees);
+
+  std::vector<MutationPoint *> mutationPoints =
+      mutationsFinder.getMutationPoints(program, mergedTestees, filter);
+
+  MutationPoint *mutationPoint = mutationPoints.front();
+
+  SimpleTestFinder testFinder;
+
+  auto tests = testFinder.findTests(program, filter);
+
+  ASSERT_NE(0U, tests.size());
+
+  auto &test = tests.front();
+
+  /// Same as above, but the objects are relocated on the first lookup of
+  /// their symbols instead of up front
+  JITEngine jit(JITLinking::Lazy);
+
+  auto mutatedFunctions =
+      mutationPoint->getOriginalModule()->prepareMutations();
+  mutationPoint->applyMutation();
+
+  {
+    auto owningBinary = toolchain.compiler().compileModule(
+        moduleWithTests, toolchain.targetMachine());
+    objectFiles.push_back(owningBinary.getBinary());
+    ownedObjectFiles.push_back(std::move(owningBinary));
+  }
+
+  {
+    auto owningBinary = toolchain.compiler().compileModule(
+        moduleWithTestees, toolchain.targetMachine());
+    objectFiles.push_back(owningBinary.getBinary());
+    ownedObjectFiles.push_back(std::move(owningBinary));
+  }
+
+  Trampolines trampolines(mutatedFunctions);
+
+  testRunner.loadMutatedProgram(objectFiles, trampolines, jit);
+  trampolines.fixupOriginalFunctions(jit);
+  ASSERT_EQ(ExecutionStatus::Passed, testRunner.runTest(jit, program, test));
+
+  auto &mangler = toolchain.mangler();
+
+  auto name = mutationPoint->getOriginalFunction()->getName().str();
+  auto moduleId = mutationPoint->getOriginalModule()->getUniqueIdentifier();
+  auto trampolineName =
+      mangler.getNameWithPrefix(mutationPoint->getTrampolineName());
+  auto mutatedFunctionName =
+      mangler.getNameWithPrefix(mutationPoint->getMutatedFunctionName());
+  uint64_t *trampoline = trampolines.findTrampoline(trampolineName);
+  uint64_t address =
+      llvm_compat::JITSymbolAddress(jit.getSymbol(mutatedFunctionName));
+  assert(address);
+  *trampoline = address;
+
+  ASSERT_EQ(ExecutionStatus::Failed, testRunner.runTest(jit, program, test));
+}
+
+TEST(NativeTestRunner, runTest_ObjectsLinkedAsTheyAreCompiled) {
+  Configuration configuration;
+
+  Toolchain toolchain(configuration);
+
+  LLVMContext llvmContext;
+  ModuleLoader loader;
+  std::vector<std::unique_ptr<MullModule>> modules;
+  modules.push_back(loader.loadModuleAtPath(
+      fixtures::simple_test_count_letters_count_letters_bc_path(),
+      llvmContext));
+  modules.push_back(loader.loadModuleAtPath(
+      fixtures::simple_test_count_letters_test_count_letters_bc_path(),
+      llvmContext));
+  Program program({}, {}, std::move(modules));
+
+  Instrumentation instrumentation;
+  for (auto &module : program.modules()) {
+    instrumentation.recordFunctions(module->getModule());
+  }
+
+  Filter filter;
+  SimpleTestFinder testFinder;
+  auto tests = testFinder.findTests(program, filter);
+  ASSERT_NE(0U, tests.size());
+  auto &test = tests.front();
+
+  NativeTestRunner testRunner(toolchain.mangler());
+  JITEngine jit;
+  testRunner.beginInstrumentedProgram(instrumentation, jit);
+
+  Metrics metrics;
+  InstrumentedCompilationTask task(instrumentation, toolchain, metrics, &jit);
+  InstrumentedCompilationTask::Out objectFiles;
+  progress_counter counter;
+  task(program.modules().begin(), program.modules().end(), objectFiles,
+       counter);
+  ASSERT_EQ(2U, objectFiles.size());
+  jit.finishObjectFiles();
+
+  instrumentation.setupInstrumentationInfo(test);
+  ASSERT_EQ(ExecutionStatus::Passed, testRunner.runTest(jit, program, test));
+  instrumentation.cleanupInstrumentationInfo(test);
+}
+
+TEST(GoogleTestRunner, runsMainWithoutGoogleTest) {
+  Configuration configuration;
+
+  Toolchain toolchain(configuration);
+
+  LLVMContext llvmContext;
+  ModuleLoader loader;
+  auto ownedModuleWithTests = loader.loadModuleAtPath(
+      fixtures::simple_test_count_letters_test_count_letters_bc_path(),
+      llvmContext);
+  auto ownedModuleWithTestees = loader.loadModuleAtPath(
+      fixtures::simple_test_count_letters_count_letters_bc_path(), llvmContext);
+
+  Module *moduleWithTests = ownedModuleWithTests->getModule();
+  Module *moduleWithTestees = ownedModuleWithTestees->getModule();
+
+  std::vector<std::unique_ptr<MullModule>> modules;
+  modules.push_back(std::move(ownedModuleWithTestees));
+  modules.push_back(std::move(ownedModuleWithTests));
+  Program program({}, {}, std::move(modules));
+
+  /// The program does not define the functions of GoogleTest, the tests
+  /// run through main as with the native runner
+  GoogleTestRunner testRunner(toolchain.mangler());
+  NativeTestRunner::ObjectFiles objectFiles;
+  NativeTestRunner::OwnedObjectFiles ownedObjectFiles;
+
+  Filter filter;
+  SimpleTestFinder testFinder;
+  auto tests = testFinder.findTests(program, filter);
+  ASSERT_NE(0U, tests.size());
+  auto &test = tests.front();
+
+  JITEngine jit;
+
+  for (auto module : {moduleWithTests, moduleWithTestees}) {
+    auto owningBinary =
+        toolchain.compiler().compileModule(module, toolchain.targetMachine());
+    objectFiles.push_back(owningBinary.getBinary());
+    ownedObjectFiles.push_back(std::move(owningBinary));
+  }
+
+  std::vector<std::string> unmutatedFunctions;
+  Trampolines trampolines(unmutatedFunctions);
+  testRunner.loadMutatedProgram(objectFiles, trampolines, jit);
+  trampolines.fixupOriginalFunctions(jit);
+  ASSERT_EQ(ExecutionStatus::Passed, testRunner.runTest(jit, program, test));
+
+  testRunner.runStaticConstructors(jit, program);
+  ASSERT_EQ(ExecutionStatus::Passed, testRunner.runInitializedTest(jit, test));
+}
+
+TEST(ArgumentVector, laysOutTheProgramNameFirst) {
+  mull::Test test("suite.test", "program", "main",
+                  {"--gtest_filter=suite.test", ""}, nullptr);
+  auto &arguments = test.getArgumentVector();
+  ASSERT_EQ(3, arguments.getArgc());
+
+  SmallVector<char *, 4> argv;
+  arguments.getArgv(argv);
+  ASSERT_EQ(4U, argv.size());
+  ASSERT_STREQ("program", argv[0]);
+  ASSERT_STREQ("--gtest_filter=suite.test", argv[1]);
+  ASSERT_STREQ("", argv[2]);
+  ASSERT_EQ(nullptr, argv[3]);
+
+  /// The copies of the test share the block
+  mull::Test copy = test;
+  SmallVector<char *, 4> copiedArgv;
+  copy.getArgumentVector().getArgv(copiedArgv);
+  ASSERT_EQ(argv[1], copiedArgv[1]);
+}
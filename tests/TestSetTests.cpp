@@ -0,0 +1,69 @@
+#include "mull/TestSet.h"
+
+#include "mull/ReachableTests.h"
+#include "mull/TestFrameworks/Test.h"
+
+#include "gtest/gtest.h"
+
+using namespace mull;
+
+TEST(TestSet, insertsInAnyOrder) {
+  TestSet set;
+  ASSERT_TRUE(set.empty());
+  ASSERT_TRUE(set.insert(200));
+  ASSERT_TRUE(set.insert(3));
+  ASSERT_TRUE(set.insert(64));
+  ASSERT_TRUE(set.insert(5));
+  ASSERT_FALSE(set.insert(64));
+
+  ASSERT_EQ(4U, set.size());
+  ASSERT_TRUE(set.contains(3));
+  ASSERT_TRUE(set.contains(200));
+  ASSERT_FALSE(set.contains(4));
+  ASSERT_FALSE(set.contains(1000));
+  ASSERT_EQ(std::vector<uint32_t>({3, 5, 64, 200}), set.ids());
+}
+
+TEST(TestSet, unitesAndIntersects) {
+  TestSet left;
+  TestSet right;
+  for (uint32_t id : {1, 2, 70, 300}) {
+    left.insert(id);
+  }
+  for (uint32_t id : {2, 71, 500}) {
+    right.insert(id);
+  }
+
+  ASSERT_TRUE(left.intersects(right));
+  ASSERT_EQ(1U, left.intersectionSize(right));
+
+  TestSet disjoint;
+  disjoint.insert(0);
+  disjoint.insert(129);
+  ASSERT_FALSE(left.intersects(disjoint));
+  ASSERT_EQ(0U, left.intersectionSize(disjoint));
+
+  left.unite(right);
+  ASSERT_EQ(std::vector<uint32_t>({1, 2, 70, 71, 300, 500}), left.ids());
+}
+
+TEST(TestSet, reachableTestsKeepTheirOrder) {
+  mull::Test first("first", "", "", {}, nullptr);
+  mull::Test second("second", "", "", {}, nullptr);
+  mull::Test third("third", "", "", {}, nullptr);
+  ASSERT_NE(first.getId(), second.getId());
+
+  ReachableTests tests;
+  tests.add(&second, 1);
+  tests.add(&first, 2);
+  ReachableTests others;
+  others.add(&third, 1);
+  tests.append(others);
+
+  ASSERT_EQ(&second, tests.test(0));
+  ASSERT_EQ(&third, tests.test(2));
+  ASSERT_TRUE(tests.contains(first));
+  ASSERT_TRUE(tests.contains(third));
+  ASSERT_EQ(3U, tests.getTestSet().size());
+  ASSERT_FALSE(others.contains(first));
+}
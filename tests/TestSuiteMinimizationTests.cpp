@@ -0,0 +1,92 @@
+#include "mull/TestSuiteMinimization.h"
+
+#include "mull/KillMatrix.h"
+#include "mull/TestFrameworks/Test.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include <unistd.h>
+
+#include "MutationPointsFixture.h"
+
+#include "gtest/gtest.h"
+
+using namespace mull;
+using namespace llvm;
+
+class TestSuiteMinimizationTest : public MutationPointsFixture {
+protected:
+  void SetUp() override {
+    MutationPointsFixture::SetUp();
+    for (int index = 0; index < 70; index++) {
+      rows.push_back(addPoint());
+    }
+    for (int index = 0; index < 5; index++) {
+      tests.emplace_back("test" + std::to_string(index), "mull", "mull",
+                         std::vector<std::string>(), nullptr);
+    }
+
+    path = "/tmp/mull-minimization-test.XXXXXX";
+    close(mkstemp(&path[0]));
+  }
+
+  void TearDown() override { std::remove(path.c_str()); }
+
+  std::vector<MutationPoint *> rows;
+  std::vector<mull::Test> tests;
+  std::string path;
+};
+
+TEST_F(TestSuiteMinimizationTest, picksTheTestsThatKillTheMost) {
+  KillMatrix matrix(path, rows, tests);
+  /// test1 kills the first 40 mutants, test3 the last 40 of them and test0
+  /// a few in the middle, test4 survives them all, test2 crashes on one
+  for (size_t row = 0; row < 70; row++) {
+    matrix.set(*rows[row], tests[1],
+               row < 40 ? ExecutionStatus::Failed : ExecutionStatus::Passed);
+    matrix.set(*rows[row], tests[3],
+               row >= 30 ? ExecutionStatus::Failed : ExecutionStatus::Passed);
+    matrix.set(*rows[row], tests[4], ExecutionStatus::Passed);
+  }
+  for (size_t row = 35; row < 45; row++) {
+    matrix.set(*rows[row], tests[0], ExecutionStatus::Failed);
+  }
+  matrix.set(*rows[69], tests[2], ExecutionStatus::Crashed);
+
+  for (size_t workers : {1, 2, 8}) {
+    ASSERT_EQ(std::vector<size_t>({1, 3}), minimizeTestSuite(matrix, workers));
+  }
+}
+
+TEST_F(TestSuiteMinimizationTest, keepsTheMutantsOnlyOneTestKills) {
+  KillMatrix matrix(path, rows, tests);
+  for (size_t row = 0; row < 70; row++) {
+    matrix.set(*rows[row], tests[0], ExecutionStatus::Failed);
+  }
+  matrix.set(*rows[5], tests[4], ExecutionStatus::Timedout);
+
+  /// The test that kills all but one of the mutants still kills them all
+  ASSERT_EQ(std::vector<size_t>({0}), minimizeTestSuite(matrix, 4));
+
+  matrix.set(*rows[5], tests[0], ExecutionStatus::Passed);
+  ASSERT_EQ(std::vector<size_t>({0, 4}), minimizeTestSuite(matrix, 4));
+}
+
+TEST_F(TestSuiteMinimizationTest, nothingKilled) {
+  KillMatrix matrix(path, rows, tests);
+  ASSERT_TRUE(minimizeTestSuite(matrix, 2).empty());
+}
+
+TEST_F(TestSuiteMinimizationTest, writesTheTestsOfAConfig) {
+  ASSERT_TRUE(writeTestList(path, {"Suite.test", "it's: quoted"}));
+
+  std::ifstream file(path);
+  std::stringstream content;
+  content << file.rdbuf();
+  ASSERT_EQ("tests:\n"
+            "  - 'Suite.test'\n"
+            "  - 'it''s: quoted'\n",
+            content.str());
+}
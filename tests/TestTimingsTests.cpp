@@ -0,0 +1,70 @@
+#include "mull/TestTimings.h"
+
+#include "mull/Program/Program.h"
+#include "mull/TestFrameworks/Test.h"
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+
+#include "gtest/gtest.h"
+
+using namespace mull;
+using namespace llvm;
+
+static mull::Test testThatRan(const std::string &name, int64_t runningTime) {
+  mull::Test test(name, "mull", "mull", {}, nullptr);
+  ExecutionResult result;
+  result.status = Passed;
+  result.runningTime = runningTime;
+  test.setExecutionResult(result);
+  return test;
+}
+
+static std::vector<std::string>
+namesOf(const std::vector<mull::Test *> &tests) {
+  std::vector<std::string> names;
+  for (auto test : tests) {
+    names.push_back(test->getTestName());
+  }
+  return names;
+}
+
+TEST(TestTimings, ordersTheTestsLongestFirst) {
+  SmallString<128> directory;
+  ASSERT_FALSE(sys::fs::createUniqueDirectory("mull-timings", directory));
+  Program program({}, {}, {});
+
+  {
+    TestTimings timings(directory.str().str());
+    timings.load(program);
+    std::vector<mull::Test> tests(
+        {testThatRan("fast", 10), testThatRan("slow", 300),
+         testThatRan("medium", 40)});
+    timings.save(tests);
+  }
+
+  TestTimings timings(directory.str().str());
+  timings.load(program);
+  mull::Test fast("fast", "mull", "mull", {}, nullptr);
+  mull::Test slow("slow", "mull", "mull", {}, nullptr);
+  mull::Test medium("medium", "mull", "mull", {}, nullptr);
+  mull::Test added("added", "mull", "mull", {}, nullptr);
+  std::vector<mull::Test *> tests({&added, &fast, &slow, &medium});
+  ASSERT_TRUE(timings.sortLongestFirst(tests));
+  ASSERT_EQ(std::vector<std::string>({"slow", "medium", "fast", "added"}),
+            namesOf(tests));
+}
+
+TEST(TestTimings, keepsTheOrderWithoutHistory) {
+  SmallString<128> directory;
+  ASSERT_FALSE(sys::fs::createUniqueDirectory("mull-timings", directory));
+  Program program({}, {}, {});
+
+  TestTimings timings(directory.str().str());
+  timings.load(program);
+  mull::Test first("first", "mull", "mull", {}, nullptr);
+  mull::Test second("second", "mull", "mull", {}, nullptr);
+  std::vector<mull::Test *> tests({&first, &second});
+  ASSERT_FALSE(timings.sortLongestFirst(tests));
+  ASSERT_EQ(std::vector<std::string>({"first", "second"}), namesOf(tests));
+}
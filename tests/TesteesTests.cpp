@@ -3,6 +3,10 @@
 #include "mull/Testee.h"
 #include "gtest/gtest.h"
 
+#include <llvm/AsmParser/Parser.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/SourceMgr.h>
+
 using namespace mull;
 
 TEST(Testees, mergeTestees) {
@@ -28,3 +32,92 @@ TEST(Testees, mergeTestees) {
     ASSERT_EQ(size_t(3), merged.getReachableTests().size());
   }
 }
+
+/// The functions known to the instrumentation are merged through their
+/// index, in the order they first appear, the same as the others
+TEST(Testees, mergeTestees_byFunctionIndex) {
+  llvm::LLVMContext llvmContext;
+  llvm::SMDiagnostic error;
+  auto module = llvm::parseAssemblyString("define void @first() {\n"
+                                          "  ret void\n"
+                                          "}\n"
+                                          "define void @second() {\n"
+                                          "  ret void\n"
+                                          "}\n"
+                                          "define void @third() {\n"
+                                          "  ret void\n"
+                                          "}\n",
+                                          error, llvmContext);
+  ASSERT_NE(nullptr, module);
+  auto first = module->getFunction("first");
+  auto second = module->getFunction("second");
+  auto third = module->getFunction("third");
+
+  std::vector<std::unique_ptr<Testee>> testees;
+  testees.push_back(llvm::make_unique<Testee>(third, nullptr, 0, 7));
+  testees.push_back(llvm::make_unique<Testee>(first, nullptr, 1, 2));
+  testees.push_back(llvm::make_unique<Testee>(third, nullptr, 2, 7));
+  testees.push_back(llvm::make_unique<Testee>(second, nullptr, 1));
+  testees.push_back(llvm::make_unique<Testee>(first, nullptr, 3, 2));
+  testees.push_back(llvm::make_unique<Testee>(second, nullptr, 4));
+
+  auto mergedTestees = mergeTestees(testees);
+
+  ASSERT_EQ(size_t(3), mergedTestees.size());
+  ASSERT_EQ(third, mergedTestees[0].getTesteeFunction());
+  ASSERT_EQ(first, mergedTestees[1].getTesteeFunction());
+  ASSERT_EQ(second, mergedTestees[2].getTesteeFunction());
+
+  auto &thirdTests = mergedTestees[0].getReachableTests();
+  ASSERT_EQ(size_t(2), thirdTests.size());
+  ASSERT_EQ(0, thirdTests.distance(0));
+  ASSERT_EQ(2, thirdTests.distance(1));
+  ASSERT_EQ(3, mergedTestees[1].getReachableTests().distance(1));
+  ASSERT_EQ(4, mergedTestees[2].getReachableTests().distance(1));
+}
+
+/// Merging ranges on their own then combining them gives the same testees,
+/// in the same order, as merging all of them at once
+TEST(Testees, mergeTestees_inParallel) {
+  llvm::LLVMContext llvmContext;
+  llvm::SMDiagnostic error;
+  std::string assembly;
+  for (int i = 0; i < 10; i++) {
+    assembly += "define void @f" + std::to_string(i) + "() {\n" +
+                "  ret void\n" + "}\n";
+  }
+  auto module = llvm::parseAssemblyString(assembly, error, llvmContext);
+  ASSERT_NE(nullptr, module);
+
+  std::vector<llvm::Function *> functions;
+  for (auto &function : module->getFunctionList()) {
+    functions.push_back(&function);
+  }
+
+  std::vector<std::unique_ptr<Testee>> testees;
+  for (int distance = 0; distance < 5; distance++) {
+    for (size_t i = 0; i < functions.size(); i++) {
+      auto f = (i * 7 + distance) % functions.size();
+      /// Half of the functions are not known to the instrumentation
+      uint32_t index = f % 2 ? 0 : f + 1;
+      testees.push_back(llvm::make_unique<Testee>(functions[f], nullptr,
+                                                  distance, index));
+    }
+  }
+
+  auto expected = mergeTestees(testees);
+  for (size_t workers : {2, 3, 8}) {
+    auto merged = mergeTestees(testees, workers);
+    ASSERT_EQ(expected.size(), merged.size());
+    for (size_t i = 0; i < merged.size(); i++) {
+      ASSERT_EQ(expected[i].getTesteeFunction(),
+                merged[i].getTesteeFunction());
+      auto &expectedTests = expected[i].getReachableTests();
+      auto &tests = merged[i].getReachableTests();
+      ASSERT_EQ(expectedTests.size(), tests.size());
+      for (size_t t = 0; t < tests.size(); t++) {
+        ASSERT_EQ(expectedTests.distance(t), tests.distance(t));
+      }
+    }
+  }
+}
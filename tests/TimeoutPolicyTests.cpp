@@ -0,0 +1,55 @@
+#include "gtest/gtest.h"
+
+#include "mull/ExecutionResult.h"
+#include "mull/TimeoutPolicy.h"
+
+using namespace mull;
+
+static const int64_t Millisecond = 1000000;
+
+TEST(TimeoutPolicy, DefaultsToTenTimesASingleRun) {
+  TimeoutPolicy policy(TimeoutPolicyConfig(), 1, 4);
+  ASSERT_EQ(2000, policy.timeout({200 * Millisecond}));
+  ASSERT_EQ(30, policy.timeout({1 * Millisecond}));
+}
+
+TEST(TimeoutPolicy, AddsTheDeviationsOfTheRuns) {
+  TimeoutPolicyConfig config;
+  config.deviations = 2;
+  config.multiplier = 1;
+  config.floor = 0;
+  TimeoutPolicy policy(config, 1, 1);
+
+  /// mean 10ms, sample standard deviation 2ms
+  ASSERT_EQ(14, policy.timeout({8 * Millisecond, 10 * Millisecond,
+                                12 * Millisecond}));
+}
+
+TEST(TimeoutPolicy, KeepsTheTimeoutWithinFloorAndCeiling) {
+  TimeoutPolicyConfig config;
+  config.floor = 50;
+  config.ceiling = 5000;
+  TimeoutPolicy policy(config, 1, 1);
+
+  ASSERT_EQ(50, policy.timeout({Millisecond / 2}));
+  ASSERT_EQ(5000, policy.timeout({20000 * Millisecond}));
+}
+
+TEST(TimeoutPolicy, ScalesWithTheLoadOfTheMachine) {
+  TimeoutPolicyConfig config;
+  config.floor = 0;
+  ASSERT_EQ(1.0, TimeoutPolicy(config, 2, 8).getLoad());
+
+  TimeoutPolicy loaded(config, 16, 8);
+  ASSERT_EQ(2.0, loaded.getLoad());
+  ASSERT_EQ(200, loaded.timeout({10 * Millisecond}));
+}
+
+TEST(TimeoutPolicy, PrefersTheRunningTimeMeasuredByTheChild) {
+  ExecutionResult result;
+  result.runningTime = 3;
+  ASSERT_EQ(3 * Millisecond, TimeoutPolicy::runningTime(result));
+
+  result.timings.test = 1500000;
+  ASSERT_EQ(1500000, TimeoutPolicy::runningTime(result));
+}
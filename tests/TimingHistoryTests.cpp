@@ -0,0 +1,77 @@
+#include "mull/Metrics/TimingHistory.h"
+
+#include "mull/Metrics/Metrics.h"
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/FileSystem.h>
+
+#include "gtest/gtest.h"
+
+using namespace mull;
+using namespace llvm;
+
+static std::string historyPath() {
+  SmallString<128> directory;
+  if (sys::fs::createUniqueDirectory("mull-history", directory)) {
+    return std::string();
+  }
+  return directory.str().str() + "/history.sqlite";
+}
+
+TEST(TimingHistory, flagsTheTimingsSlowerThanThePreviousRuns) {
+  auto path = historyPath();
+  ASSERT_FALSE(path.empty());
+
+  {
+    TimingHistory history(path);
+    std::string error;
+    ASSERT_TRUE(history.open(error)) << error;
+    for (double compilation : {100.0, 110.0, 90.0}) {
+      ASSERT_TRUE(history.record(
+          "project", {Timing("compilation", compilation), Timing("run", 10)}));
+    }
+    ASSERT_TRUE(history.record("other", {Timing("compilation", 1000)}));
+  }
+
+  TimingHistory history(path);
+  std::string error;
+  ASSERT_TRUE(history.open(error)) << error;
+
+  auto regressions = history.compare(
+      "project",
+      {Timing("compilation", 300), Timing("run", 12), Timing("added", 500)},
+      10, 1.5, 0);
+  ASSERT_EQ(1U, regressions.size());
+  ASSERT_EQ("compilation", regressions.front().name);
+  ASSERT_EQ(100.0, regressions.front().baseline);
+  ASSERT_EQ(3U, regressions.front().runs);
+
+  /// Only the last run counts, and the difference is within the noise
+  regressions =
+      history.compare("project", {Timing("compilation", 300)}, 1, 1.5, 250);
+  ASSERT_TRUE(regressions.empty());
+  regressions =
+      history.compare("project", {Timing("compilation", 300)}, 1, 1.5, 0);
+  ASSERT_EQ(1U, regressions.size());
+  ASSERT_EQ(90.0, regressions.front().baseline);
+}
+
+TEST(Metrics, TimesTheCompilationOfEveryModule) {
+  LLVMContext context;
+  Module module("module.bc", context);
+  Metrics metrics;
+  metrics.beginLoadModules();
+  metrics.endLoadModules();
+  metrics.beginCompileOriginalModule(&module);
+  metrics.endCompileOriginalModule(&module);
+
+  std::vector<std::string> names;
+  for (auto &timing : metrics.timings()) {
+    names.push_back(timing.name);
+  }
+  ASSERT_EQ(std::vector<std::string>({"load_modules", "original_compilation",
+                                      "original_compilation/module.bc"}),
+            names);
+}
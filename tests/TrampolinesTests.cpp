@@ -0,0 +1,75 @@
+#include "mull/Toolchain/Trampolines.h"
+
+#include "mull/Toolchain/EntryPatch.h"
+#include "mull/Toolchain/Mangler.h"
+
+#include <llvm/IR/DataLayout.h>
+
+#include <cstring>
+#include <sys/mman.h>
+
+#include "gtest/gtest.h"
+
+using namespace mull;
+using namespace llvm;
+
+TEST(Trampolines, liveSideBySideInWholeCacheLines) {
+  Mangler mangler(DataLayout("e-m:o-i64:64-f80:128-n8:16:32:64-S128"));
+  std::vector<std::string> names({"first_trampoline", "second_trampoline",
+                                  "third_trampoline"});
+  Trampolines trampolines(names);
+  trampolines.allocateTrampolines(mangler);
+
+  auto first = trampolines.findTrampoline("_first_trampoline");
+  ASSERT_NE(nullptr, first);
+  ASSERT_EQ(0U, reinterpret_cast<uintptr_t>(first) % 64);
+  ASSERT_EQ(first + 1, trampolines.findTrampoline("_second_trampoline"));
+  ASSERT_EQ(first + 2, trampolines.findTrampoline("_third_trampoline"));
+
+  ASSERT_EQ(nullptr, trampolines.findTrampoline("first_trampoline"));
+  ASSERT_EQ(nullptr, trampolines.findTrampoline("_fourth_trampoline"));
+}
+
+#if defined(__x86_64__) || defined(__aarch64__)
+TEST(EntryPatch, jumpsToTheTargetAndBack) {
+#if defined(__x86_64__)
+  /// mov eax, 1; ret and mov eax, 2; ret
+  const uint8_t one[] = {0xB8, 0x01, 0x00, 0x00, 0x00, 0xC3};
+  const uint8_t two[] = {0xB8, 0x02, 0x00, 0x00, 0x00, 0xC3};
+#else
+  /// mov w0, #1; ret and mov w0, #2; ret
+  const uint8_t one[] = {0x20, 0x00, 0x80, 0x52, 0xC0, 0x03, 0x5F, 0xD6};
+  const uint8_t two[] = {0x40, 0x00, 0x80, 0x52, 0xC0, 0x03, 0x5F, 0xD6};
+#endif
+  const size_t size = 4096;
+  auto page = static_cast<uint8_t *>(mmap(nullptr, size,
+                                          PROT_READ | PROT_WRITE,
+                                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+  ASSERT_NE(MAP_FAILED, static_cast<void *>(page));
+  memcpy(page, one, sizeof(one));
+  memcpy(page + 64, two, sizeof(two));
+  ASSERT_EQ(0, mprotect(page, size, PROT_READ | PROT_EXEC));
+  __builtin___clear_cache(reinterpret_cast<char *>(page),
+                          reinterpret_cast<char *>(page + size));
+
+  typedef int (*Function)();
+  auto entry = reinterpret_cast<uint64_t>(page);
+  auto function = reinterpret_cast<Function>(page);
+  EntryPatch patch(entry);
+  ASSERT_EQ(1, function());
+
+  ASSERT_TRUE(patch.jumpTo(entry + 64));
+  ASSERT_EQ(2, function());
+
+  ASSERT_TRUE(patch.restore());
+  ASSERT_EQ(1, function());
+
+  /// Out of reach the callers go through the entry as it was
+  ASSERT_FALSE(EntryPatch::reaches(entry, entry + (uint64_t(1) << 40)));
+  ASSERT_TRUE(patch.jumpTo(entry + 64));
+  ASSERT_TRUE(patch.jumpTo(entry + (uint64_t(1) << 40)));
+  ASSERT_EQ(1, function());
+
+  munmap(page, size);
+}
+#endif
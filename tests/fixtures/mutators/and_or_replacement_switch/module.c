@@ -0,0 +1,53 @@
+/// A large function in the shape of generated code: a switch over many
+/// cases, each of them with its own && and ||
+
+#define CASE(n)                                                                \
+  case n:                                                                      \
+    if (a < n && b > n) {                                                      \
+      result += n;                                                             \
+    } else if (a == n || c == n) {                                             \
+      result -= n;                                                             \
+    }                                                                          \
+    break;
+
+#define CASES10(n)                                                             \
+  CASE(n##0)                                                                   \
+  CASE(n##1)                                                                   \
+  CASE(n##2)                                                                   \
+  CASE(n##3)                                                                   \
+  CASE(n##4)                                                                   \
+  CASE(n##5)                                                                   \
+  CASE(n##6)                                                                   \
+  CASE(n##7)                                                                   \
+  CASE(n##8)                                                                   \
+  CASE(n##9)
+
+#define CASES100(n)                                                            \
+  CASES10(n##0)                                                                \
+  CASES10(n##1)                                                                \
+  CASES10(n##2)                                                                \
+  CASES10(n##3)                                                                \
+  CASES10(n##4)                                                                \
+  CASES10(n##5)                                                                \
+  CASES10(n##6)                                                                \
+  CASES10(n##7)                                                                \
+  CASES10(n##8)                                                                \
+  CASES10(n##9)
+
+int dispatch(int selector, int a, int b, int c) {
+  int result = 0;
+  switch (selector) {
+    CASES100(1)
+    CASES100(2)
+    CASES100(3)
+    CASES100(4)
+    CASES100(5)
+    CASES100(6)
+    CASES100(7)
+    CASES100(8)
+    CASES100(9)
+  default:
+    break;
+  }
+  return result;
+}
@@ -1,4 +1,5 @@
 #include "DynamicLibraries.h"
+#include "mull/Hash.h"
 #include "mull/Logger.h"
 
 #include <llvm/Object/ELFObjectFile.h>
@@ -7,7 +8,11 @@
 #include <llvm/Support/FileSystem.h>
 #include <llvm/Support/MemoryBuffer.h>
 #include <llvm/Support/Path.h>
+#include <llvm/Support/raw_ostream.h>
 
+#include <set>
+
+#include <sys/stat.h>
 #include <unistd.h>
 
 using namespace llvm::object;
@@ -89,22 +94,24 @@ resolveLibraryPath(const std::string &library,
   return library;
 }
 
-std::vector<std::string>
-mull::findDynamicLibraries(const std::string &executablePath,
-                           std::vector<std::string> &librarySearchPaths) {
+/// The libraries a binary requires, as named by its DT_NEEDED entries or
+/// load commands
+static std::vector<std::string> requiredLibraries(const std::string &path) {
   std::vector<std::string> libraries;
 
-  auto bufferOr = llvm::MemoryBuffer::getFile(executablePath);
+  auto bufferOr = llvm::MemoryBuffer::getFile(path);
   if (!bufferOr) {
-    mull::Logger::error() << "\nCannot open executable: " << executablePath
-                          << "\n";
+    mull::Logger::error() << "\nCannot open executable: " << path << "\n";
+    return libraries;
   }
   std::unique_ptr<llvm::MemoryBuffer> buffer(std::move(bufferOr.get()));
 
   auto symbolicOr = SymbolicFile::createSymbolicFile(buffer->getMemBufferRef());
   if (!symbolicOr) {
-    mull::Logger::error() << "\nCannot create symbolic file from: "
-                          << executablePath << "\n";
+    llvm::consumeError(symbolicOr.takeError());
+    mull::Logger::error() << "\nCannot create symbolic file from: " << path
+                          << "\n";
+    return libraries;
   }
 
   std::unique_ptr<SymbolicFile> symbolicFile(std::move(symbolicOr.get()));
@@ -126,16 +133,146 @@ mull::findDynamicLibraries(const std::string &executablePath,
     }
   }
 
+  return libraries;
+}
+
+/// The libraries of the search paths come after the ones they require, so
+/// that loading them in order never leaves a dependency to the dynamic
+/// loader. The dependencies outside of the search paths, e.g. libc, are
+/// found by the dynamic loader as usual.
+static void
+addDependenciesFirst(const std::string &libraryPath,
+                     const std::vector<std::string> &librarySearchPaths,
+                     std::set<std::string> &visited,
+                     std::vector<std::string> &resolvedLibraries) {
+  if (!visited.insert(libraryPath).second) {
+    return;
+  }
+  for (auto &dependency : requiredLibraries(libraryPath)) {
+    auto dependencyPath = resolveLibraryPath(dependency, librarySearchPaths);
+    if (llvm::sys::fs::exists(dependencyPath)) {
+      addDependenciesFirst(dependencyPath, librarySearchPaths, visited,
+                           resolvedLibraries);
+    }
+  }
+  resolvedLibraries.push_back(libraryPath);
+}
+
+static bool modificationTime(const std::string &path, long long &time) {
+  struct stat status;
+  if (stat(path.c_str(), &status) != 0) {
+    return false;
+  }
+  time = status.st_mtime;
+  return true;
+}
+
+static const char *const CacheHeader = "mull-dynamic-libraries 1";
+
+/// The cache names the executable and the libraries with the times they
+/// were modified at, one per line:
+///
+///     mull-dynamic-libraries 1
+///     <modification time> <executable>
+///     <modification time> <library>
+///
+/// It is only used as long as none of them changed.
+static std::string
+cachePath(const std::string &cacheDirectory, const std::string &executablePath,
+          const std::vector<std::string> &librarySearchPaths) {
+  std::string key = executablePath;
+  for (auto &searchPath : librarySearchPaths) {
+    key += '\0' + searchPath;
+  }
+  return cacheDirectory + "/dynamic-libraries-" +
+         mull::hashOf(key, mull::HashAlgorithm::XXHash64);
+}
+
+static bool readCache(const std::string &path,
+                      const std::string &executablePath,
+                      std::vector<std::string> &libraries) {
+  auto buffer = llvm::MemoryBuffer::getFile(path);
+  if (!buffer) {
+    return false;
+  }
+  llvm::SmallVector<llvm::StringRef, 16> lines;
+  buffer.get()->getBuffer().split(lines, '\n', -1, false);
+  if (lines.size() < 2 || lines[0] != CacheHeader) {
+    return false;
+  }
+
+  std::vector<std::string> cached;
+  for (size_t index = 1; index < lines.size(); index++) {
+    auto timeAndPath = lines[index].split(' ');
+    long long cachedTime = 0;
+    long long time = 0;
+    if (timeAndPath.first.getAsInteger(10, cachedTime) ||
+        !modificationTime(timeAndPath.second.str(), time) ||
+        time != cachedTime) {
+      return false;
+    }
+    cached.push_back(timeAndPath.second.str());
+  }
+  if (cached.front() != executablePath) {
+    return false;
+  }
+
+  libraries.assign(cached.begin() + 1, cached.end());
+  return true;
+}
+
+static void writeCache(const std::string &path,
+                       const std::string &executablePath,
+                       const std::vector<std::string> &libraries) {
+  llvm::sys::fs::create_directories(llvm::sys::path::parent_path(path));
+  std::string content = std::string(CacheHeader) + "\n";
+  std::vector<std::string> paths({executablePath});
+  paths.insert(paths.end(), libraries.begin(), libraries.end());
+  for (auto &file : paths) {
+    long long time = 0;
+    if (!modificationTime(file, time)) {
+      return;
+    }
+    content += std::to_string(time) + " " + file + "\n";
+  }
+
+  std::error_code error;
+  llvm::raw_fd_ostream outfile(path, error, llvm::sys::fs::F_None);
+  if (error) {
+    mull::Logger::warn() << "Cannot cache the dynamic libraries in " << path
+                         << ": " << error.message() << "\n";
+    return;
+  }
+  outfile << content;
+}
+
+std::vector<std::string>
+mull::findDynamicLibraries(const std::string &executablePath,
+                           std::vector<std::string> &librarySearchPaths,
+                           const std::string &cacheDirectory) {
   std::vector<std::string> resolvedLibraries;
-  for (auto &library : libraries) {
+  std::string cache;
+  if (!cacheDirectory.empty()) {
+    cache = cachePath(cacheDirectory, executablePath, librarySearchPaths);
+    if (readCache(cache, executablePath, resolvedLibraries)) {
+      return resolvedLibraries;
+    }
+  }
+
+  std::set<std::string> visited({executablePath});
+  for (auto &library : requiredLibraries(executablePath)) {
     auto libraryPath = resolveLibraryPath(library, librarySearchPaths);
     if (llvm::sys::fs::exists(libraryPath)) {
-      resolvedLibraries.push_back(libraryPath);
+      addDependenciesFirst(libraryPath, librarySearchPaths, visited,
+                           resolvedLibraries);
     } else {
       mull::Logger::error()
           << "Could not find dynamic library: " << library << "\n";
     }
   }
 
+  if (!cache.empty()) {
+    writeCache(cache, executablePath, resolvedLibraries);
+  }
   return resolvedLibraries;
 }
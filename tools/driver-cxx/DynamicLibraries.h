@@ -5,7 +5,12 @@
 
 namespace mull {
 
+/// The libraries the executable requires, found in the search paths, along
+/// with the libraries of the search paths they require in turn. Every
+/// library comes after its dependencies. The libraries are read from the
+/// cache directory instead, unless it is empty or they changed since.
 std::vector<std::string>
 findDynamicLibraries(const std::string &executablePath,
-                     std::vector<std::string> &librarySearchPaths);
+                     std::vector<std::string> &librarySearchPaths,
+                     const std::string &cacheDirectory);
 }
@@ -6,16 +6,26 @@
 #include <ebc/EmbeddedFile.h>
 
 #include <llvm/IR/Module.h>
+#include <llvm/Support/DynamicLibrary.h>
 #include <llvm/Support/MemoryBuffer.h>
 #include <llvm/Support/TargetSelect.h>
 
+#include <algorithm>
 #include <iostream>
+#include <thread>
+#include <unordered_set>
 #include <unistd.h>
 
 #include "DynamicLibraries.h"
+#include "mull/BitcodeCache.h"
 #include "mull/Config/Configuration.h"
+#include "mull/Daemon.h"
 #include "mull/Driver.h"
+#include "mull/EmbeddedBitcode.h"
+#include "mull/Hash.h"
+#include "mull/Heap.h"
 #include "mull/JunkDetection/CXX/CXXJunkDetector.h"
+#include "mull/JunkDetection/DebugInfoJunkDetector.h"
 #include "mull/JunkDetection/JunkDetector.h"
 #include "mull/Metrics/Metrics.h"
 #include "mull/ModuleLoader.h"
@@ -24,6 +34,7 @@
 #include "mull/Parallelization/Parallelization.h"
 #include "mull/Program/Program.h"
 #include "mull/Reporters/IDEReporter.h"
+#include "mull/Reporters/TraceReporter.h"
 #include "mull/Result.h"
 #include "mull/TestFrameworks/TestFrameworkFactory.h"
 #include "mull/Version.h"
@@ -35,54 +46,152 @@
 #include "mull/Metrics/Metrics.h"
 #include "mull/Reporters/SQLiteReporter.h"
 
+class SplitBitcodeSectionTask {
+public:
+  using In = const std::vector<llvm::StringRef>;
+  using Out = std::vector<llvm::StringRef>;
+  using iterator = In::const_iterator;
+
+  void operator()(iterator begin, iterator end, Out &storage,
+                  mull::progress_counter &counter) {
+    for (auto it = begin; it != end; it++, counter.increment()) {
+      for (auto &file : mull::splitBitcodeSection(*it)) {
+        storage.push_back(file);
+      }
+    }
+  }
+};
+
+class HashBitcodeTask {
+public:
+  using In = const std::vector<llvm::StringRef>;
+  using Out = std::vector<std::string>;
+  using iterator = In::const_iterator;
+
+  explicit HashBitcodeTask(mull::HashAlgorithm hashAlgorithm)
+      : hashAlgorithm(hashAlgorithm) {}
+
+  void operator()(iterator begin, iterator end, Out &storage,
+                  mull::progress_counter &counter) {
+    for (auto it = begin; it != end; it++, counter.increment()) {
+      storage.push_back(mull::hashOf(*it, hashAlgorithm));
+    }
+  }
+
+private:
+  mull::HashAlgorithm hashAlgorithm;
+};
+
+/// The buffers refer to the bitcode in place, which outlives the modules.
+/// A file comes with its hash when it is known, otherwise with an empty one.
 class LoadModuleFromBitcodeTask {
 public:
-  using In = std::vector<std::unique_ptr<ebc::EmbeddedFile>>;
+  using In = const std::vector<std::pair<llvm::StringRef, std::string>>;
   using Out = std::vector<std::unique_ptr<mull::MullModule>>;
-  using iterator = In::iterator;
+  using iterator = In::const_iterator;
 
-  explicit LoadModuleFromBitcodeTask(llvm::LLVMContext &context)
-      : context(context) {}
+  LoadModuleFromBitcodeTask(llvm::LLVMContext &context, bool lazy,
+                            mull::HashAlgorithm hashAlgorithm)
+      : context(context), lazy(lazy), hashAlgorithm(hashAlgorithm) {}
 
   void operator()(iterator begin, iterator end, Out &storage,
                   mull::progress_counter &counter) {
     for (auto it = begin; it != end; it++, counter.increment()) {
-      auto pair = (*it)->GetRawBuffer();
-      const auto data = pair.first;
-      const auto size = pair.second;
-      assert(data);
-      assert(size);
-
-      llvm::StringRef bufferView(data, size);
-      auto ownedBuffer = llvm::MemoryBuffer::getMemBufferCopy(bufferView);
+      assert(!it->first.empty());
+
+      bool requiresNullTerminator = false;
+      auto ownedBuffer = llvm::MemoryBuffer::getMemBuffer(
+          it->first, "", requiresNullTerminator);
       auto buffer = ownedBuffer.get();
 
-      auto modulePair = mull::loadModuleFromBuffer(context, *buffer);
+      auto modulePair = mull::loadModuleFromBuffer(
+          context, *buffer, lazy, hashAlgorithm, it->second);
       auto hash = modulePair.first;
       auto module = std::move(modulePair.second);
       assert(module && "Could not load module");
       module->setModuleIdentifier(hash);
 
       auto mullModule = llvm::make_unique<mull::MullModule>(
-          std::move(module), std::move(ownedBuffer), hash);
+          std::move(module), std::move(ownedBuffer), hash, hashAlgorithm);
       storage.push_back(std::move(mullModule));
     }
   }
 
 private:
   llvm::LLVMContext &context;
+  bool lazy;
+  mull::HashAlgorithm hashAlgorithm;
 };
 
 llvm::cl::OptionCategory MullCXXCategory("mull-cxx");
 
-llvm::cl::opt<std::string> InputFile(llvm::cl::Positional,
-                                     llvm::cl::desc("<input file>"),
-                                     llvm::cl::Required);
+/// Several executables are mutated in one process, one after another,
+/// sharing the toolchain, its caches and the workers
+llvm::cl::list<std::string> InputFiles(llvm::cl::Positional,
+                                       llvm::cl::desc("<input files>"),
+                                       llvm::cl::OneOrMore);
 
 llvm::cl::opt<unsigned> Workers("workers", llvm::cl::Optional,
                                 llvm::cl::desc("How many threads to use"),
                                 llvm::cl::cat(MullCXXCategory));
 
+llvm::cl::opt<bool> PinWorkers(
+    "pin-workers", llvm::cl::Optional,
+    llvm::cl::desc("Pins each worker thread to a CPU, spreading the workers "
+                   "over the NUMA nodes, with the memory of the workers and "
+                   "of their children on their own nodes"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(false));
+
+llvm::cl::opt<bool> AutoTune(
+    "auto-tune", llvm::cl::Optional,
+    llvm::cl::desc("Tries fewer workers on the first items of each phase, "
+                   "then runs the rest with the number that did best"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(false));
+
+llvm::cl::opt<unsigned> WorkerProcesses(
+    "worker-processes", llvm::cl::Optional,
+    llvm::cl::desc("Runs the mutants in that many processes forked once the "
+                   "program is loaded, with the workers spread over them"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(1));
+
+llvm::cl::opt<unsigned> JunkDetectionProcesses(
+    "junk-detection-processes", llvm::cl::Optional,
+    llvm::cl::desc("Parses the sources and detects the junk mutants in that "
+                   "many helper processes, 0 does it in this one"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(0));
+
+llvm::cl::opt<unsigned> HeapArenas(
+    "heap-arenas", llvm::cl::Optional,
+    llvm::cl::desc("The most arenas malloc spreads the threads over, "
+                   "0 keeps its default (glibc only)"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(0));
+
+llvm::cl::opt<bool> TrimHeap(
+    "trim-heap", llvm::cl::Optional,
+    llvm::cl::desc("Gives the free memory of malloc back to the system at "
+                   "the end of every phase (glibc only)"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(false));
+
+llvm::cl::opt<unsigned> ResultMemoryBudget(
+    "result-memory-budget", llvm::cl::Optional,
+    llvm::cl::desc("Moves the results of the mutants to temporary files once "
+                   "they take this much memory, 0 keeps them in memory"),
+    llvm::cl::value_desc("megabytes"), llvm::cl::cat(MullCXXCategory),
+    llvm::cl::init(0));
+
+llvm::cl::opt<unsigned> IDEMaxMutantsPerFile(
+    "ide-max-mutants-per-file", llvm::cl::Optional,
+    llvm::cl::desc("Reports up to this many survived mutants per file, the "
+                   "others are only counted. 0 reports them all."),
+    llvm::cl::value_desc("number"), llvm::cl::cat(MullCXXCategory),
+    llvm::cl::init(0));
+
+llvm::cl::opt<bool> Trace(
+    "trace", llvm::cl::Optional,
+    llvm::cl::desc("Writes a trace of the run with a track per thread, "
+                   "to be opened in Perfetto or chrome://tracing"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(false));
+
 llvm::cl::opt<std::string> CompilationDatabasePath(
     "compdb-path", llvm::cl::Optional,
     llvm::cl::desc("Path to a compilation database (compile_commands.json) for "
@@ -94,6 +203,18 @@ llvm::cl::opt<std::string> CompilationFlags(
     llvm::cl::desc("Extra compilation flags for junk detection"),
     llvm::cl::cat(MullCXXCategory), llvm::cl::init(""));
 
+llvm::cl::opt<bool> SharedPrecompiledHeaders(
+    "shared-pch", llvm::cl::Optional,
+    llvm::cl::desc("Parse the headers shared by the source files once into a "
+                   "precompiled header for junk detection"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(false));
+
+llvm::cl::opt<int> JunkMemoryLimit(
+    "junk-memory-limit", llvm::cl::Optional,
+    llvm::cl::desc("How many megabytes the ASTs parsed for junk detection may "
+                   "take, 0 keeps every AST"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(0));
+
 llvm::cl::opt<std::string> CacheDir(
     "cache-dir", llvm::cl::Optional,
     llvm::cl::desc("Where to store cache (defaults to /tmp/mull-cache)"),
@@ -104,6 +225,417 @@ llvm::cl::opt<bool>
                  llvm::cl::desc("Disables cache (enabled by default)"),
                  llvm::cl::cat(MullCXXCategory), llvm::cl::init(false));
 
+llvm::cl::opt<bool> ForkServer(
+    "fork-server", llvm::cl::Optional,
+    llvm::cl::desc("Runs the tests of each mutant from a forked server process "
+                   "instead of forking mull for every test"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(false));
+
+llvm::cl::opt<bool> ForkBatch(
+    "fork-batch", llvm::cl::Optional,
+    llvm::cl::desc("Runs all the tests of each mutant in one forked process, "
+                   "forking again for a test only after a crash"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(false));
+
+llvm::cl::opt<bool> ForkSnapshot(
+    "fork-snapshot", llvm::cl::Optional,
+    llvm::cl::desc("Runs the tests of a mutant in one child and restores the "
+                   "data of the program after each of them, a test that "
+                   "changes the heap gets a new child"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(false));
+
+llvm::cl::opt<bool> MutantSchemata(
+    "mutant-schemata", llvm::cl::Optional,
+    llvm::cl::desc("Compiles all mutants of a function into a single body "
+                   "switching over a mutant id"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(false));
+
+llvm::cl::opt<bool> SplitMutatedFunctions(
+    "split-mutated-functions", llvm::cl::Optional,
+    llvm::cl::desc("Compiles the mutated functions separately from the rest "
+                   "of their modules, which is then reused from cache"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(false));
+
+llvm::cl::opt<bool> PruneEquivalentMutants(
+    "prune-equivalent-mutants", llvm::cl::Optional,
+    llvm::cl::desc("Skips the mutants that optimize to their original "
+                   "function or change values nothing observes, and runs "
+                   "the duplicate mutants once"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(false));
+
+llvm::cl::opt<bool> SharedProgram(
+    "shared-program", llvm::cl::Optional,
+    llvm::cl::desc("Links the mutated program once for all the workers, "
+                   "requires fork"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(false));
+
+llvm::cl::opt<bool> LazyJIT(
+    "lazy-jit", llvm::cl::Optional,
+    llvm::cl::desc("Links the objects only when the tests reach them"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(false));
+
+llvm::cl::opt<bool> ParallelJIT(
+    "parallel-jit", llvm::cl::Optional,
+    llvm::cl::desc("Loads and relocates the objects on several threads"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(false));
+
+llvm::cl::opt<bool> DeferMutantCloning(
+    "defer-mutant-cloning", llvm::cl::Optional,
+    llvm::cl::desc("Clones the mutated functions only for the mutants that "
+                   "are run, not for the filtered out ones"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(false));
+
+llvm::cl::opt<bool> LazyBitcodeLoading(
+    "lazy-bitcode", llvm::cl::Optional,
+    llvm::cl::desc("Reads the bodies of the functions only once the mutation "
+                   "search or the compilation needs them"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(false));
+
+llvm::cl::opt<bool> InlineInstrumentation(
+    "inline-instrumentation", llvm::cl::Optional,
+    llvm::cl::desc(
+        "Record the call tree with inline code instead of runtime calls"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(false));
+
+llvm::cl::opt<bool> CoverageInstrumentation(
+    "coverage-instrumentation", llvm::cl::Optional,
+    llvm::cl::desc(
+        "Record only which functions each test reaches, not the call tree"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(false));
+
+llvm::cl::opt<bool> GuardedInstrumentation(
+    "guarded-instrumentation", llvm::cl::Optional,
+    llvm::cl::desc("Keep the instrumentation off while running the mutants, "
+                   "so that their unmutated modules are not compiled again"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(false));
+
+llvm::cl::opt<bool> ConstructorTemplate(
+    "constructor-template", llvm::cl::Optional,
+    llvm::cl::desc("Run the static constructors once per mutant, in the "
+                   "process its tests are forked from (needs -fork-server "
+                   "or -fork-batch)"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(false));
+
+llvm::cl::opt<bool> DirectTestRun(
+    "direct-test-run", llvm::cl::Optional,
+    llvm::cl::desc("Initialize GoogleTest once and run each test through "
+                   "its UnitTest instead of calling main with a filter"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(false));
+
+llvm::cl::opt<bool> ReleaseIR(
+    "release-ir", llvm::cl::Optional,
+    llvm::cl::desc("Free the bitcode once the mutants are compiled, so that "
+                   "the processes the tests run in are forked off a smaller "
+                   "one (no IR in the SQLite debug tables)"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(false));
+
+llvm::cl::opt<bool> JITHugePages(
+    "jit-huge-pages", llvm::cl::Optional,
+    llvm::cl::desc("Map the code and the data of the JIT on huge pages, "
+                   "fewer TLB misses when the tests run"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(false));
+
+llvm::cl::opt<bool> BlockCoverage(
+    "block-coverage", llvm::cl::Optional,
+    llvm::cl::desc("Record the basic blocks each test executes, a mutant "
+                   "runs only the tests that executed its block and the "
+                   "mutants no test executed do not run"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(false));
+
+llvm::cl::opt<bool> BoundedCallTree(
+    "bounded-call-tree", llvm::cl::Optional,
+    llvm::cl::desc("Stop recording the calls of a test past the max "
+                   "distance from its body, while the test runs"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(false));
+
+llvm::cl::opt<bool> PerfCounters(
+    "perf-counters", llvm::cl::Optional,
+    llvm::cl::desc("Count the instructions, cycles, branch and cache misses "
+                   "of every forked run (Linux only)"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(false));
+
+llvm::cl::opt<bool> DirectCalls(
+    "direct-calls", llvm::cl::Optional,
+    llvm::cl::desc("Patches the entries of the mutated functions with direct "
+                   "jumps in the forked children, rather than going through "
+                   "the trampolines (x86-64 and AArch64)"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(false));
+
+llvm::cl::opt<bool> StopOnSurvivor(
+    "stop-on-survivor", llvm::cl::Optional,
+    llvm::cl::desc("Stop the run as soon as a mutant survives and exit "
+                   "with a failure, e.g. to gate a pull request"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(false));
+
+llvm::cl::opt<bool> StaticReachability(
+    "static-reachability", llvm::cl::Optional,
+    llvm::cl::desc("Find the functions each test reaches in the static call "
+                   "graph, up to the max distance, instead of recording the "
+                   "calls of its original run (indirect calls reach every "
+                   "function whose address is taken)"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(false));
+
+llvm::cl::opt<unsigned> ReachabilitySamplePeriod(
+    "reachability-sample-period", llvm::cl::Optional,
+    llvm::cl::desc("Sample the calls of the original tests with perf every "
+                   "this many cycles instead of recording them, the "
+                   "functions no sample saw are reached as with "
+                   "-static-reachability (Linux only)"),
+    llvm::cl::value_desc("cycles"), llvm::cl::cat(MullCXXCategory),
+    llvm::cl::init(0));
+
+llvm::cl::opt<unsigned> Deadline(
+    "deadline", llvm::cl::Optional,
+    llvm::cl::desc("Stop the run after this many seconds, the mutants that "
+                   "ran by then are reported"),
+    llvm::cl::value_desc("seconds"), llvm::cl::cat(MullCXXCategory),
+    llvm::cl::init(0));
+
+llvm::cl::opt<bool> CacheCompression(
+    "cache-compression", llvm::cl::Optional,
+    llvm::cl::desc("Compresses the objects stored in cache"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(false));
+
+llvm::cl::opt<unsigned> CacheSizeLimit(
+    "cache-size-limit", llvm::cl::Optional,
+    llvm::cl::desc("How many megabytes the cached objects may take on disk, "
+                   "the least recently used ones are evicted (no limit by "
+                   "default)"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(0));
+
+llvm::cl::opt<bool> CachePopulate(
+    "cache-populate", llvm::cl::Optional,
+    llvm::cl::desc("Reads the cached objects ahead when they are mapped"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(false));
+
+llvm::cl::opt<bool> MutationSearchCache(
+    "mutation-search-cache", llvm::cl::Optional,
+    llvm::cl::desc("Keeps the mutation points of every module in the cache, "
+                   "the functions of an unchanged module are not searched "
+                   "again"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(false));
+
+llvm::cl::opt<bool> TestSearchCache(
+    "test-search-cache", llvm::cl::Optional,
+    llvm::cl::desc("Keeps the tests of every module in the cache, the tests "
+                   "of an unchanged module are not searched again"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(false));
+
+llvm::cl::opt<bool> ReachabilityCache(
+    "reachability-cache", llvm::cl::Optional,
+    llvm::cl::desc("Keeps the calls of the original test runs in the cache, "
+                   "a test only runs again once a function it reached "
+                   "changed"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(false));
+
+llvm::cl::opt<bool> ProgramLibrary(
+    "program-library", llvm::cl::Optional,
+    llvm::cl::desc("Links the instrumented program into a shared library kept "
+                   "in the cache with the system linker, the later runs load "
+                   "it with dlopen instead of linking it again (Linux only)"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(false));
+
+llvm::cl::opt<std::string> CacheRemote(
+    "cache-remote", llvm::cl::Optional,
+    llvm::cl::desc("http:// URL of a cache shared between machines, objects "
+                   "missing locally are fetched from it and new objects are "
+                   "uploaded to it in the background"),
+    llvm::cl::value_desc("url"), llvm::cl::cat(MullCXXCategory),
+    llvm::cl::init(""));
+
+llvm::cl::opt<std::string> ChangedLinesPath(
+    "changed-lines", llvm::cl::Optional,
+    llvm::cl::desc("Only mutates the lines a change touched: the output of "
+                   "`git diff`, or a list of path[:first[-last]] entries"),
+    llvm::cl::value_desc("path"), llvm::cl::cat(MullCXXCategory),
+    llvm::cl::init(""));
+
+llvm::cl::opt<std::string> Sampling(
+    "sampling", llvm::cl::Optional,
+    llvm::cl::desc("Runs a sample of the mutants: uniform, per_mutator, "
+                   "per_file, per_function or time_budget"),
+    llvm::cl::value_desc("strategy"), llvm::cl::cat(MullCXXCategory),
+    llvm::cl::init("none"));
+
+llvm::cl::opt<unsigned> SampleSize(
+    "sample-size", llvm::cl::Optional,
+    llvm::cl::desc("How many mutants the sample takes"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(0));
+
+llvm::cl::opt<unsigned> SamplingSeed(
+    "sampling-seed", llvm::cl::Optional,
+    llvm::cl::desc("The same seed picks the same mutants (0 by default)"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(0));
+
+llvm::cl::opt<unsigned> TimeBudget(
+    "time-budget", llvm::cl::Optional,
+    llvm::cl::desc("How many seconds the mutants of the time_budget sample "
+                   "may take, estimated from the original test runs"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(0));
+
+llvm::cl::opt<unsigned> ShardIndex(
+    "shard-index", llvm::cl::Optional,
+    llvm::cl::desc("Which of the -shard-count slices of the mutants to run"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(0));
+
+llvm::cl::opt<unsigned> ShardCount(
+    "shard-count", llvm::cl::Optional,
+    llvm::cl::desc("How many jobs share the mutants, each runs the slice of "
+                   "its -shard-index"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(1));
+
+llvm::cl::opt<std::string> PreviousResultsPath(
+    "previous-results", llvm::cl::Optional,
+    llvm::cl::desc("The SQLite database of a previous run: the mutants "
+                   "that did not change take their results from it"),
+    llvm::cl::value_desc("path"), llvm::cl::cat(MullCXXCategory),
+    llvm::cl::init(""));
+
+llvm::cl::opt<std::string> Resume(
+    "resume", llvm::cl::Optional,
+    llvm::cl::desc("The SQLite database an interrupted run streamed its "
+                   "results to: the mutants it completed do not run again"),
+    llvm::cl::value_desc("path"), llvm::cl::cat(MullCXXCategory),
+    llvm::cl::init(""));
+
+llvm::cl::opt<std::string> KillMatrixPath(
+    "kill-matrix", llvm::cl::Optional,
+    llvm::cl::desc("Run every test that reaches a mutant, without failing "
+                   "fast, and keep the status of each of them in a matrix "
+                   "mapped from the file"),
+    llvm::cl::value_desc("path"), llvm::cl::cat(MullCXXCategory),
+    llvm::cl::init(""));
+
+llvm::cl::opt<std::string> MinimizedTestsPath(
+    "minimized-tests", llvm::cl::Optional,
+    llvm::cl::desc("Write the tests that kill the same mutants as all of "
+                   "them, found in the kill matrix, as a list of tests"),
+    llvm::cl::value_desc("path"), llvm::cl::cat(MullCXXCategory),
+    llvm::cl::init(""));
+
+llvm::cl::opt<std::string> MetricsEndpoint(
+    "metrics-endpoint", llvm::cl::Optional,
+    llvm::cl::desc("Serve the progress of the run to Prometheus at "
+                   "http://<host:port>/metrics, :port listens on every "
+                   "interface"),
+    llvm::cl::value_desc("host:port"), llvm::cl::cat(MullCXXCategory),
+    llvm::cl::init(""));
+
+llvm::cl::opt<std::string> TestOrder(
+    "test-order", llvm::cl::Optional,
+    llvm::cl::desc("The order the tests of a mutant run in: discovery, "
+                   "distance, runtime or kill_rate"),
+    llvm::cl::value_desc("order"), llvm::cl::cat(MullCXXCategory),
+    llvm::cl::init("discovery"));
+
+llvm::cl::opt<std::string> MutantOrder(
+    "mutant-order", llvm::cl::Optional,
+    llvm::cl::desc("The order the mutants run in: longest_first, or feedback "
+                   "for the mutants on the changed lines, then those that "
+                   "survived the previous results, first"),
+    llvm::cl::value_desc("order"), llvm::cl::cat(MullCXXCategory),
+    llvm::cl::init("longest_first"));
+
+llvm::cl::opt<unsigned> BatchKill(
+    "batch-kill", llvm::cl::Optional,
+    llvm::cl::desc("Runs up to this many mutants of different functions "
+                   "together, and only bisects the batches a test fails"),
+    llvm::cl::value_desc("size"), llvm::cl::cat(MullCXXCategory),
+    llvm::cl::init(0));
+
+llvm::cl::opt<unsigned> OriginalTestBatch(
+    "original-test-batch", llvm::cl::Optional,
+    llvm::cl::desc("Runs up to this many original tests one after another "
+                   "in one child, instead of forking a child per test"),
+    llvm::cl::value_desc("size"), llvm::cl::cat(MullCXXCategory),
+    llvm::cl::init(0));
+
+llvm::cl::opt<unsigned> LoopBudget(
+    "loop-budget", llvm::cl::Optional,
+    llvm::cl::desc("Stops a mutant once its mutated functions loop this "
+                   "many times as often as the original run of the test did"),
+    llvm::cl::value_desc("factor"), llvm::cl::cat(MullCXXCategory),
+    llvm::cl::init(0));
+
+llvm::cl::opt<unsigned> StallTimeout(
+    "stall-timeout", llvm::cl::Optional,
+    llvm::cl::desc("Kills a mutant run once it neither ran nor did I/O for "
+                   "this long, e.g. when it waits on a lock forever"),
+    llvm::cl::value_desc("milliseconds"), llvm::cl::cat(MullCXXCategory),
+    llvm::cl::init(0));
+
+llvm::cl::opt<unsigned> FlakyRuns(
+    "flaky-runs", llvm::cl::Optional,
+    llvm::cl::desc("Runs every passing test this many more times at once, "
+                   "the tests whose runs disagree reach no mutant"),
+    llvm::cl::value_desc("runs"), llvm::cl::cat(MullCXXCategory),
+    llvm::cl::init(0));
+
+llvm::cl::opt<std::string> DistributedRole(
+    "distributed-role", llvm::cl::Optional,
+    llvm::cl::desc("Shares the run with other machines: none, coordinator "
+                   "or worker, see -distributed-directory"),
+    llvm::cl::value_desc("role"), llvm::cl::cat(MullCXXCategory),
+    llvm::cl::init("none"));
+
+llvm::cl::opt<std::string> DistributedDirectory(
+    "distributed-directory", llvm::cl::Optional,
+    llvm::cl::desc("The directory all the machines of a distributed run "
+                   "see, where the mutants and their results are exchanged"),
+    llvm::cl::value_desc("path"), llvm::cl::cat(MullCXXCategory),
+    llvm::cl::init(""));
+
+llvm::cl::opt<unsigned> DistributedChunk(
+    "distributed-chunk", llvm::cl::Optional,
+    llvm::cl::desc("How many mutants a machine of a distributed run claims "
+                   "at once"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(16));
+
+llvm::cl::opt<unsigned> DistributedLease(
+    "distributed-lease", llvm::cl::Optional,
+    llvm::cl::desc("How many seconds a machine of a distributed run may "
+                   "not report progress before its mutants run elsewhere"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(300));
+
+llvm::cl::opt<bool> XXHash(
+    "xxhash", llvm::cl::Optional,
+    llvm::cl::desc("Hashes the bitcode into the cache keys with XXH64, which "
+                   "is faster than the default MD5"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(false));
+
+llvm::cl::opt<unsigned> CodegenOptLevel(
+    "codegen-opt-level", llvm::cl::Optional,
+    llvm::cl::desc("Code generation level from 0 to 3 (2 by default), 0 "
+                   "compiles the mutants the fastest"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(2));
+
+llvm::cl::opt<mull::MutantDebugInfo> MutantDebugInfo(
+    "mutant-debug-info", llvm::cl::Optional,
+    llvm::cl::desc("What the mutants keep of their debug info when they are "
+                   "compiled"),
+    llvm::cl::values(
+        clEnumValN(mull::MutantDebugInfo::Full, "full",
+                   "All of it, as in the bitcode"),
+        clEnumValN(mull::MutantDebugInfo::LineTables, "line_tables",
+                   "Only the line tables, for the backtraces of the crashes"),
+        clEnumValN(mull::MutantDebugInfo::None, "none",
+                   "Nothing, the mutants compile the fastest")),
+    llvm::cl::cat(MullCXXCategory),
+    llvm::cl::init(mull::MutantDebugInfo::Full));
+
+llvm::cl::opt<unsigned> ParallelCodegenThreshold(
+    "parallel-codegen-threshold", llvm::cl::Optional,
+    llvm::cl::desc("Splits the modules larger than this many megabytes of "
+                   "bitcode and compiles the parts on all the workers"),
+    llvm::cl::cat(MullCXXCategory), llvm::cl::init(0));
+
+llvm::cl::opt<std::string> DaemonSocket(
+    "daemon", llvm::cl::Optional,
+    llvm::cl::desc("Keeps the program loaded and serves the runs asked for "
+                   "over the Unix domain socket, e.g. "
+                   "printf 'test <name>\\nfile <path>\\n' | nc -U <socket>"),
+    llvm::cl::value_desc("socket"), llvm::cl::cat(MullCXXCategory));
+
 enum MutatorsOptionIndex : int { _mutatorsOptionIndex_unused };
 llvm::cl::list<MutatorsOptionIndex> Mutators("mutators", llvm::cl::ZeroOrMore,
                                              llvm::cl::desc("Choose mutators:"),
@@ -171,14 +703,394 @@ llvm::cl::list<std::string> LDSearchPaths("ld_search_path",
                                           llvm::cl::desc("Library search path"),
                                           llvm::cl::cat(MullCXXCategory));
 
-static void validateInputFile() {
-  if (access(InputFile.getValue().c_str(), R_OK) != 0) {
-    perror(InputFile.getValue().c_str());
+llvm::cl::list<std::string> ExcludeLocations(
+    "exclude-location", llvm::cl::ZeroOrMore,
+    llvm::cl::desc("Skips the code whose path contains the pattern, or "
+                   "matches glob:<pattern> or regex:<pattern>"),
+    llvm::cl::value_desc("pattern"), llvm::cl::cat(MullCXXCategory));
+
+static void validateInputFiles() {
+  for (auto &inputFile : InputFiles) {
+    if (access(inputFile.c_str(), R_OK) != 0) {
+      perror(inputFile.c_str());
+      exit(1);
+    }
+  }
+  if (InputFiles.size() > 1 && !DaemonSocket.empty()) {
+    mull::Logger::error() << "-daemon serves the runs of one executable\n";
+    exit(1);
+  }
+}
+
+static void validateExcludeLocations() {
+  bool valid = true;
+  for (auto &location : ExcludeLocations) {
+    std::string error = mull::Filter::validateLocationPattern(location);
+    if (!error.empty()) {
+      mull::Logger::error() << error << "\n";
+      valid = false;
+    }
+  }
+  if (!valid) {
+    exit(1);
+  }
+}
+
+static mull::SamplingConfig validateSampling() {
+  mull::SamplingConfig sampling;
+  if (!mull::samplingStrategyFromString(Sampling.getValue(),
+                                        sampling.strategy)) {
+    mull::Logger::error() << "Unknown sampling strategy: "
+                          << Sampling.getValue() << "\n";
+    exit(1);
+  }
+  sampling.size = SampleSize.getValue();
+  sampling.seed = SamplingSeed.getValue();
+  sampling.budget = TimeBudget.getValue();
+  if (sampling.strategy == mull::SamplingStrategy::TimeBudget &&
+      sampling.budget == 0) {
+    mull::Logger::error() << "-sampling=time_budget requires -time-budget\n";
+    exit(1);
+  }
+  if (sampling.strategy != mull::SamplingStrategy::None &&
+      sampling.strategy != mull::SamplingStrategy::TimeBudget &&
+      sampling.size == 0) {
+    mull::Logger::error() << "-sampling=" << Sampling.getValue()
+                          << " requires -sample-size\n";
+    exit(1);
+  }
+  return sampling;
+}
+
+static mull::ShardConfig validateShard() {
+  mull::ShardConfig shard;
+  shard.index = ShardIndex.getValue();
+  shard.count = ShardCount.getValue();
+  if (shard.count == 0 || shard.index >= shard.count) {
+    mull::Logger::error() << "-shard-index must be below -shard-count\n";
+    exit(1);
+  }
+  return shard;
+}
+
+static mull::TestOrder validateTestOrder() {
+  mull::TestOrder order = mull::TestOrder::Discovery;
+  if (!mull::testOrderFromString(TestOrder.getValue(), order)) {
+    mull::Logger::error() << "Unknown test order: " << TestOrder.getValue()
+                          << "\n";
+    exit(1);
+  }
+  return order;
+}
+
+static mull::MutantOrder validateMutantOrder() {
+  mull::MutantOrder order = mull::MutantOrder::LongestFirst;
+  if (!mull::mutantOrderFromString(MutantOrder.getValue(), order)) {
+    mull::Logger::error() << "Unknown mutant order: "
+                          << MutantOrder.getValue() << "\n";
+    exit(1);
+  }
+  return order;
+}
+
+static mull::DistributedConfig validateDistributed() {
+  mull::DistributedConfig distributed;
+  if (!mull::distributedRoleFromString(DistributedRole.getValue(),
+                                       distributed.role)) {
+    mull::Logger::error() << "Unknown distributed role: "
+                          << DistributedRole.getValue() << "\n";
+    exit(1);
+  }
+  distributed.directory = DistributedDirectory.getValue();
+  distributed.chunk = DistributedChunk.getValue();
+  distributed.lease = DistributedLease.getValue();
+  if (distributed.role != mull::DistributedRole::None &&
+      distributed.directory.empty()) {
+    mull::Logger::error() << "-distributed-role=" << DistributedRole.getValue()
+                          << " requires -distributed-directory\n";
     exit(1);
   }
+  if (distributed.chunk == 0 || distributed.lease == 0) {
+    mull::Logger::error()
+        << "-distributed-chunk and -distributed-lease must be positive\n";
+    exit(1);
+  }
+  return distributed;
+}
+
+/// The bitcode of an executable, loaded into modules of its own contexts.
+/// The modules read the bitcode in place, from the mapped executable or from
+/// the files extracted from it, which live as long as the modules do.
+struct LoadedExecutable {
+  std::string path;
+  std::vector<std::string> dynamicLibraries;
+  std::unique_ptr<mull::Metrics> metrics;
+  std::unique_ptr<llvm::MemoryBuffer> executable;
+  std::unique_ptr<mull::BitcodeCache> bitcodeCache;
+  std::vector<std::unique_ptr<ebc::EmbeddedFile>> embeddedFiles;
+  std::vector<std::unique_ptr<llvm::LLVMContext>> contexts;
+  std::vector<std::unique_ptr<mull::MullModule>> modules;
+};
+
+static std::unique_ptr<LoadedExecutable>
+loadExecutable(const std::string &path,
+               const mull::Configuration &configuration,
+               const std::vector<std::string> &librarySearchPaths) {
+  auto loaded = llvm::make_unique<LoadedExecutable>();
+  loaded->path = path;
+  loaded->dynamicLibraries = mull::findDynamicLibraries(
+      path, librarySearchPaths, configuration.cacheDirectory);
+
+  /// The libraries are loaded while the bitcode is, one after another so
+  /// that the symbols resolve in the same order on every run. The driver
+  /// loads them again later on, the dynamic loader then only counts the
+  /// references, and reports the libraries that cannot be loaded.
+  auto &dynamicLibraries = loaded->dynamicLibraries;
+  std::thread loadLibraries([&dynamicLibraries] {
+    for (auto &library : dynamicLibraries) {
+      llvm::sys::DynamicLibrary::LoadLibraryPermanently(library.c_str());
+    }
+  });
+
+  loaded->metrics = llvm::make_unique<mull::Metrics>();
+  auto &metrics = *loaded->metrics;
+  if (Trace.getValue()) {
+    metrics.enableTracing();
+  }
+  metrics.beginLoadModules();
+
+  /// The bitcode is read in place from the mapped executable, the sections
+  /// are split on all the workers. ebc copies every file, it only extracts
+  /// what this cannot read, e.g. the bitcode bundles of Mach-O executables.
+  bool requiresNullTerminator = false;
+  auto executable =
+      llvm::MemoryBuffer::getFile(path, -1, requiresNullTerminator);
+  if (executable) {
+    loaded->executable = std::move(executable.get());
+  }
+  /// The files extracted from the executable on an earlier run are mapped
+  /// from the cache along with their hashes
+  auto &bitcodeCache = loaded->bitcodeCache;
+  if (loaded->executable && configuration.cacheEnabled) {
+    bitcodeCache = mull::BitcodeCache::load(
+        configuration.cacheDirectory, path, loaded->executable->getBuffer(),
+        configuration.hashAlgorithm);
+  }
+
+  std::vector<llvm::StringRef> bitcodeFiles;
+  std::vector<std::string> knownHashes;
+  auto &embeddedFiles = loaded->embeddedFiles;
+  std::vector<llvm::StringRef> sections;
+  if (bitcodeCache) {
+    bitcodeFiles = bitcodeCache->getFiles();
+    knownHashes = bitcodeCache->getHashes();
+  } else if (loaded->executable) {
+    mull::findBitcodeSections(loaded->executable->getMemBufferRef(),
+                              sections);
+  }
+
+  if (bitcodeCache) {
+    mull::Logger::info() << "Using the cached bitcode of " << path << "\n";
+  } else if (!sections.empty()) {
+    std::vector<SplitBitcodeSectionTask> splitTasks(
+        configuration.parallelization.workers);
+    mull::TaskExecutor<SplitBitcodeSectionTask> extractBitcodeFiles(
+        "Extracting bitcode from executable", sections, bitcodeFiles,
+        std::move(splitTasks), mull::TaskDispatch::OneByOne);
+    extractBitcodeFiles.execute();
+  } else {
+    mull::SingleTaskExecutor extractBitcodeBuffers(
+        "Extracting bitcode from executable", [&] {
+          ebc::BitcodeRetriever bitcodeRetriever(path);
+          for (auto &bitcodeInfo : bitcodeRetriever.GetBitcodeInfo()) {
+            auto &container = bitcodeInfo.bitcodeContainer;
+            if (container) {
+              for (auto &file : container->GetRawEmbeddedFiles()) {
+                embeddedFiles.push_back(std::move(file));
+              }
+            } else {
+              mull::Logger::warn()
+                  << "No bitcode: " << bitcodeInfo.arch << "\n";
+            }
+          }
+        });
+    extractBitcodeBuffers.execute();
+    for (auto &file : embeddedFiles) {
+      auto pair = file->GetRawBuffer();
+      bitcodeFiles.emplace_back(pair.first, pair.second);
+    }
+  }
+
+  /// A static library linked into several parts of the executable embeds
+  /// the same bitcode more than once. The files are hashed up front, so that
+  /// the identical ones are only loaded once, and the loading does not hash
+  /// them again.
+  if (!bitcodeCache) {
+    std::vector<HashBitcodeTask> hashTasks(
+        configuration.parallelization.workers,
+        HashBitcodeTask(configuration.hashAlgorithm));
+    mull::TaskExecutor<HashBitcodeTask> hashBitcodeFiles(
+        "Hashing bitcode files", bitcodeFiles, knownHashes,
+        std::move(hashTasks));
+    hashBitcodeFiles.execute();
+
+    std::unordered_set<std::string> uniqueHashes;
+    std::vector<llvm::StringRef> uniqueFiles;
+    std::vector<std::string> uniqueFileHashes;
+    for (size_t i = 0; i < bitcodeFiles.size(); i++) {
+      if (uniqueHashes.insert(knownHashes[i]).second) {
+        uniqueFiles.push_back(bitcodeFiles[i]);
+        uniqueFileHashes.push_back(knownHashes[i]);
+      }
+    }
+    if (uniqueFiles.size() != bitcodeFiles.size()) {
+      mull::Logger::info() << "Skipped "
+                           << bitcodeFiles.size() - uniqueFiles.size()
+                           << " identical bitcode files\n";
+    }
+    bitcodeFiles = std::move(uniqueFiles);
+    knownHashes = std::move(uniqueFileHashes);
+  }
+
+  std::vector<LoadModuleFromBitcodeTask> tasks;
+  for (int i = 0; i < configuration.parallelization.workers; i++) {
+    auto context = llvm::make_unique<llvm::LLVMContext>();
+    tasks.emplace_back(LoadModuleFromBitcodeTask(
+        *context, configuration.lazyBitcodeLoadingEnabled,
+        configuration.hashAlgorithm));
+    loaded->contexts.push_back(std::move(context));
+  }
+  /// The largest files are handed out first, so that a worker that got a
+  /// few huge modules does not finish long after the others
+  std::vector<uint64_t> sizes;
+  for (auto &file : bitcodeFiles) {
+    sizes.push_back(file.size());
+  }
+  auto order = mull::largestFirst(sizes);
+  std::vector<std::pair<llvm::StringRef, std::string>> sortedFiles;
+  for (auto index : order) {
+    sortedFiles.emplace_back(bitcodeFiles[index], knownHashes[index]);
+  }
+
+  std::vector<std::unique_ptr<mull::MullModule>> loadedModules;
+  mull::TaskExecutor<LoadModuleFromBitcodeTask> executor(
+      "Loading bitcode files", sortedFiles, loadedModules, std::move(tasks),
+      mull::TaskDispatch::OneByOne);
+  executor.execute();
+
+  /// Every file results in a module, the modules keep the order of the
+  /// files in the executable
+  auto &modules = loaded->modules;
+  modules.resize(loadedModules.size());
+  for (size_t i = 0; i < loadedModules.size(); i++) {
+    modules[order[i]] = std::move(loadedModules[i]);
+  }
+  metrics.endLoadModules();
+
+  if (loaded->executable && configuration.cacheEnabled && !bitcodeCache &&
+      modules.size() == bitcodeFiles.size()) {
+    std::vector<std::string> hashes;
+    for (auto &module : modules) {
+      hashes.push_back(module->getUniqueIdentifier());
+    }
+    mull::BitcodeCache::store(configuration.cacheDirectory, path,
+                              loaded->executable->getBuffer(),
+                              configuration.hashAlgorithm, bitcodeFiles,
+                              hashes);
+  }
+
+  loadLibraries.join();
+  return loaded;
+}
+
+/// Mutates an executable and reports its mutants. The toolchain, with the
+/// objects it compiled and cached, and the junk detector, with the ASTs it
+/// parsed, are shared by all the executables of the batch.
+static int runExecutable(LoadedExecutable &loaded,
+                         mull::Configuration &configuration,
+                         mull::Toolchain &toolchain,
+                         MutatorsCLIOptions &mutatorsOptions,
+                         TestFrameworkCLIOptions &testFrameworkOption,
+                         mull::JunkDetector &junkDetector) {
+  auto &metrics = *loaded.metrics;
+  mull::Program program(loaded.dynamicLibraries, {},
+                        std::move(loaded.modules));
+
+  mull::TestFramework testFramework(
+      testFrameworkOption.testFramework(toolchain, configuration));
+
+  mull::Filter filter;
+  for (auto &location : ExcludeLocations) {
+    filter.skipByLocationPattern(location);
+  }
+  mull::MutationsFinder mutationsFinder(mutatorsOptions.mutators(),
+                                        configuration);
+
+  mull::Driver driver(configuration, program, testFramework, toolchain, filter,
+                      mutationsFinder, metrics, junkDetector);
+
+  if (!DaemonSocket.empty()) {
+    mull::Daemon daemon(DaemonSocket.getValue());
+    if (!daemon.listen()) {
+      return 1;
+    }
+    driver.warmUp();
+    mull::Logger::info() << "Serving the runs on " << DaemonSocket.getValue()
+                         << "\n";
+    daemon.serve([&](const mull::DaemonRequest &request) {
+      mull::ThreadPool::shared().configure(configuration.parallelization);
+      for (auto &test : request.tests) {
+        filter.includeTest(test);
+      }
+      if (!request.files.empty()) {
+        filter.includeChangedLines(request.files);
+      }
+      for (auto &location : request.excludedLocations) {
+        filter.skipByLocationPattern(location);
+      }
+
+      /// Each run is served by a child of its own, so is the reporter
+      mull::IDEReporter ideReporter(IDEMaxMutantsPerFile.getValue());
+      driver.streamResultsTo(ideReporter);
+      metrics.beginRun();
+      auto result = driver.Run();
+      metrics.endRun();
+
+      mull::RawConfig rawConfig;
+      ideReporter.reportResults(*result, rawConfig, metrics);
+      return 0;
+    });
+    return 0;
+  }
+
+  mull::IDEReporter ideReporter(IDEMaxMutantsPerFile.getValue());
+  driver.streamResultsTo(ideReporter);
+  metrics.beginRun();
+  auto result = driver.Run();
+  metrics.endRun();
+
+  mull::RawConfig rawConfig;
+  //  mull::SQLiteReporter reporter;
+  //  reporter.reportResults(*result, rawConfig, metrics);
+
+  metrics.beginReportResult();
+  ideReporter.reportResults(*result, rawConfig, metrics);
+  if (Trace.getValue()) {
+    mull::TraceReporter traceReporter;
+    traceReporter.reportResults(*result, rawConfig, metrics);
+  }
+  metrics.endReportResult();
+
+  if (mull::Cancellation::shared().reason() ==
+      mull::Cancellation::Reason::Survivor) {
+    return 1;
+  }
+  return 0;
 }
 
 int main(int argc, char **argv) {
+  mull::Logger::setAsynchronous(true);
+
   llvm_compat::setVersionPrinter(mull::printVersionInformation,
                                  mull::printVersionInformationStream);
   MutatorsCLIOptions mutatorsOptions(Mutators);
@@ -187,7 +1099,13 @@ int main(int argc, char **argv) {
   llvm::cl::HideUnrelatedOptions(MullCXXCategory);
   llvm::cl::ParseCommandLineOptions(argc, argv);
 
-  validateInputFile();
+  validateInputFiles();
+  validateExcludeLocations();
+  auto sampling = validateSampling();
+  auto shard = validateShard();
+  auto testOrder = validateTestOrder();
+  auto mutantOrder = validateMutantOrder();
+  auto distributed = validateDistributed();
 
   mull::MetricsMeasure totalExecutionTime;
   totalExecutionTime.start();
@@ -202,6 +1120,46 @@ int main(int argc, char **argv) {
   configuration.customTests.push_back(
       mull::CustomTestDefinition("main", "_main", "mull", {}));
   configuration.failFastEnabled = true;
+  configuration.forkServerEnabled = ForkServer.getValue();
+  configuration.forkBatchEnabled = ForkBatch.getValue();
+  configuration.forkSnapshotEnabled = ForkSnapshot.getValue();
+  configuration.mutantSchemataEnabled = MutantSchemata.getValue();
+  configuration.splitMutatedFunctionsEnabled =
+      SplitMutatedFunctions.getValue();
+  configuration.equivalentMutantPruningEnabled =
+      PruneEquivalentMutants.getValue();
+  configuration.sharedProgramEnabled = SharedProgram.getValue();
+  configuration.lazyJITEnabled = LazyJIT.getValue();
+  configuration.parallelJITEnabled = ParallelJIT.getValue();
+  configuration.deferMutantCloningEnabled = DeferMutantCloning.getValue();
+  configuration.lazyBitcodeLoadingEnabled = LazyBitcodeLoading.getValue();
+  configuration.inlineInstrumentationEnabled = InlineInstrumentation.getValue();
+  configuration.coverageInstrumentationEnabled =
+      CoverageInstrumentation.getValue();
+  configuration.guardedInstrumentationEnabled =
+      GuardedInstrumentation.getValue();
+  configuration.constructorTemplateEnabled = ConstructorTemplate.getValue();
+  configuration.directTestRunEnabled = DirectTestRun.getValue();
+  configuration.releaseIREnabled = ReleaseIR.getValue();
+  configuration.jitHugePagesEnabled = JITHugePages.getValue();
+  configuration.blockCoverageEnabled = BlockCoverage.getValue();
+  configuration.boundedCallTreeEnabled = BoundedCallTree.getValue();
+  configuration.perfCountersEnabled = PerfCounters.getValue();
+  configuration.directCallsEnabled = DirectCalls.getValue();
+  configuration.stopOnSurvivorEnabled = StopOnSurvivor.getValue();
+  configuration.staticReachabilityEnabled = StaticReachability.getValue();
+  configuration.reachabilitySamplePeriod = ReachabilitySamplePeriod.getValue();
+  configuration.deadline = Deadline.getValue();
+  configuration.sampling = sampling;
+  configuration.shard = shard;
+  configuration.testOrder = testOrder;
+  configuration.mutantOrder = mutantOrder;
+  configuration.batchKillSize = BatchKill.getValue();
+  configuration.originalTestBatchSize = OriginalTestBatch.getValue();
+  configuration.loopBudget = LoopBudget.getValue();
+  configuration.stallTimeout = StallTimeout.getValue();
+  configuration.flakyRuns = FlakyRuns.getValue();
+  configuration.distributed = distributed;
 
   if (Workers) {
     mull::ParallelizationConfig parallelizationConfig;
@@ -212,56 +1170,51 @@ int main(int argc, char **argv) {
     configuration.parallelization =
         mull::ParallelizationConfig::defaultConfig();
   }
+  configuration.parallelization.pinWorkers = PinWorkers.getValue();
+  configuration.parallelization.autoTune = AutoTune.getValue();
+  configuration.parallelization.workerProcesses =
+      std::max(WorkerProcesses.getValue(), 1u);
+  configuration.parallelization.junkDetectionProcesses =
+      JunkDetectionProcesses.getValue();
+  configuration.heap.arenas = HeapArenas.getValue();
+  configuration.heap.trim = TrimHeap.getValue();
+  mull::configureHeap(configuration.heap);
+  configuration.resultMemoryBudget = ResultMemoryBudget.getValue();
+  mull::setResultMemoryBudget(size_t(configuration.resultMemoryBudget) << 20);
+  mull::ThreadPool::shared().configure(configuration.parallelization);
 
   if (!DisableCache.getValue()) {
     configuration.cacheEnabled = true;
     configuration.cacheDirectory = CacheDir.getValue();
+    configuration.cacheCompressionEnabled = CacheCompression.getValue();
+    configuration.cacheSizeLimit = CacheSizeLimit.getValue();
+    configuration.cachePopulateEnabled = CachePopulate.getValue();
+    configuration.reachabilityCacheEnabled = ReachabilityCache.getValue();
+    configuration.programLibraryEnabled = ProgramLibrary.getValue();
+    configuration.mutationSearchCacheEnabled = MutationSearchCache.getValue();
+    configuration.testSearchCacheEnabled = TestSearchCache.getValue();
+    configuration.cacheRemoteURL = CacheRemote.getValue();
   }
-
-  std::vector<std::unique_ptr<ebc::EmbeddedFile>> embeddedFiles;
-  mull::SingleTaskExecutor extractBitcodeBuffers(
-      "Extracting bitcode from executable", [&] {
-        ebc::BitcodeRetriever bitcodeRetriever(InputFile.getValue());
-        for (auto &bitcodeInfo : bitcodeRetriever.GetBitcodeInfo()) {
-          auto &container = bitcodeInfo.bitcodeContainer;
-          if (container) {
-            for (auto &file : container->GetRawEmbeddedFiles()) {
-              embeddedFiles.push_back(std::move(file));
-            }
-          } else {
-            mull::Logger::warn() << "No bitcode: " << bitcodeInfo.arch << "\n";
-          }
-        }
-      });
-  extractBitcodeBuffers.execute();
-
-  std::vector<std::unique_ptr<llvm::LLVMContext>> contexts;
-  std::vector<LoadModuleFromBitcodeTask> tasks;
-  for (int i = 0; i < configuration.parallelization.workers; i++) {
-    auto context = llvm::make_unique<llvm::LLVMContext>();
-    tasks.emplace_back(LoadModuleFromBitcodeTask(*context));
-    contexts.push_back(std::move(context));
-  }
-  std::vector<std::unique_ptr<mull::MullModule>> modules;
-  mull::TaskExecutor<LoadModuleFromBitcodeTask> executor(
-      "Loading bitcode files", embeddedFiles, modules, std::move(tasks));
-  executor.execute();
+  configuration.changedLinesPath = ChangedLinesPath.getValue();
+  configuration.previousResultsPath = PreviousResultsPath.getValue();
+  configuration.resumePath = Resume.getValue();
+  configuration.killMatrixPath = KillMatrixPath.getValue();
+  configuration.minimizedTestsPath = MinimizedTestsPath.getValue();
+  configuration.metricsEndpoint = MetricsEndpoint.getValue();
+  configuration.codegenOptLevel = std::min(CodegenOptLevel.getValue(), 3u);
+  configuration.mutantDebugInfo = MutantDebugInfo.getValue();
+  configuration.parallelCodegenThreshold = ParallelCodegenThreshold.getValue();
+  configuration.hashAlgorithm = XXHash.getValue()
+                                    ? mull::HashAlgorithm::XXHash64
+                                    : mull::HashAlgorithm::MD5;
 
   std::vector<std::string> librarySearchPaths;
   for (auto &searchPath : LDSearchPaths) {
     librarySearchPaths.push_back(searchPath);
   }
 
-  auto dynamicLibraries =
-      mull::findDynamicLibraries(InputFile.getValue(), librarySearchPaths);
-
-  mull::Program program(dynamicLibraries, {}, std::move(modules));
-
   mull::Toolchain toolchain(configuration);
 
-  mull::TestFramework testFramework(
-      testFrameworkOption.testFramework(toolchain, configuration));
-
   mull::JunkDetectionConfig junkDetectionConfig;
   if (!CompilationFlags.empty()) {
     junkDetectionConfig.cxxCompilationFlags = CompilationFlags.getValue();
@@ -272,26 +1225,70 @@ int main(int argc, char **argv) {
         CompilationDatabasePath.getValue();
     configuration.junkDetectionEnabled = true;
   }
-  mull::CXXJunkDetector junkDetector(junkDetectionConfig);
-
-  mull::Filter filter;
-  mull::MutationsFinder mutationsFinder(mutatorsOptions.mutators(),
-                                        configuration);
-
-  mull::Metrics metrics;
-
-  mull::Driver driver(configuration, program, testFramework, toolchain, filter,
-                      mutationsFinder, metrics, junkDetector);
-  metrics.beginRun();
-  auto result = driver.Run();
-  metrics.endRun();
+  junkDetectionConfig.cxxSharedPrecompiledHeaders =
+      SharedPrecompiledHeaders.getValue();
+  junkDetectionConfig.cxxMemoryLimit = JunkMemoryLimit.getValue();
+  if (configuration.cacheEnabled) {
+    junkDetectionConfig.cacheDirectory = configuration.cacheDirectory;
+  }
+  mull::DebugInfoJunkDetector junkDetector(
+      llvm::make_unique<mull::CXXJunkDetector>(junkDetectionConfig));
 
-  mull::RawConfig rawConfig;
-  //  mull::SQLiteReporter reporter;
-  //  reporter.reportResults(*result, rawConfig, metrics);
+  if (!DaemonSocket.empty()) {
+    auto loaded =
+        loadExecutable(InputFiles.front(), configuration, librarySearchPaths);
+    int status = runExecutable(*loaded, configuration, toolchain,
+                               mutatorsOptions, testFrameworkOption,
+                               junkDetector);
+    llvm::llvm_shutdown();
+    return status;
+  }
 
-  mull::IDEReporter ideReporter;
-  ideReporter.reportResults(*result, rawConfig, metrics);
+  /// The executables of a batch run one after another, each on all the
+  /// workers. The next one is loaded meanwhile, unless the run forks helper
+  /// processes, which expect the thread pool to be idle when they do.
+  const bool prefetch =
+      configuration.parallelization.junkDetectionProcesses == 0 &&
+      configuration.parallelization.workerProcesses <= 1;
+  mull::Cancellation::shared().installSignalHandlers();
+  int status = 0;
+  std::unique_ptr<LoadedExecutable> next =
+      loadExecutable(InputFiles.front(), configuration, librarySearchPaths);
+  for (size_t index = 0; index < InputFiles.size(); index++) {
+    auto loaded = std::move(next);
+    std::thread loadNext;
+    if (index + 1 < InputFiles.size() && prefetch) {
+      loadNext = std::thread([&, index] {
+        next = loadExecutable(InputFiles[index + 1], configuration,
+                              librarySearchPaths);
+      });
+    }
+    if (InputFiles.size() > 1) {
+      mull::Logger::info() << "\nMutating " << loaded->path << " ("
+                           << index + 1 << " of " << InputFiles.size()
+                           << ")\n";
+    }
+    status |= runExecutable(*loaded, configuration, toolchain,
+                            mutatorsOptions, testFrameworkOption,
+                            junkDetector);
+    loaded.reset();
+    if (loadNext.joinable()) {
+      loadNext.join();
+    }
+    if (mull::Cancellation::shared().reason() !=
+        mull::Cancellation::Reason::None) {
+      if (index + 1 < InputFiles.size()) {
+        mull::Logger::warn() << "The batch was cancelled, "
+                             << InputFiles.size() - index - 1
+                             << " executables were not mutated\n";
+      }
+      break;
+    }
+    if (index + 1 < InputFiles.size() && !next) {
+      next = loadExecutable(InputFiles[index + 1], configuration,
+                            librarySearchPaths);
+    }
+  }
   llvm::llvm_shutdown();
 
   totalExecutionTime.finish();
@@ -299,5 +1296,5 @@ int main(int argc, char **argv) {
                        << totalExecutionTime.duration()
                        << mull::MetricsMeasure::precision() << "\n";
 
-  return 0;
+  return status;
 }
@@ -5,18 +5,25 @@
 #include "mull/Config/RawConfig.h"
 #include "mull/Filter.h"
 #include "mull/JunkDetection/CXX/CXXJunkDetector.h"
+#include "mull/JunkDetection/DebugInfoJunkDetector.h"
 #include "mull/JunkDetection/JunkDetector.h"
 #include "mull/Logger.h"
 #include "mull/Metrics/Metrics.h"
 #include "mull/ModuleLoader.h"
 #include "mull/MutationsFinder.h"
 #include "mull/Mutators/MutatorsFactory.h"
+#include "mull/Parallelization/Cancellation.h"
 #include "mull/Parallelization/TaskExecutor.h"
 #include "mull/Parallelization/Tasks/LoadObjectFilesTask.h"
+#include "mull/Parallelization/ThreadPool.h"
 #include "mull/Program/Program.h"
+#include "mull/Reporters/ArrowReporter.h"
+#include "mull/Reporters/JSONReporter.h"
 #include "mull/Reporters/SQLiteReporter.h"
 #include "mull/Reporters/TimeReporter.h"
+#include "mull/Reporters/TraceReporter.h"
 #include "mull/Result.h"
+#include "mull/ResultsDiff.h"
 #include "mull/TestFrameworks/TestFrameworkFactory.h"
 #include "mull/Toolchain/Toolchain.h"
 #include "mull/Version.h"
@@ -28,6 +35,7 @@
 #include <llvm/Support/TargetSelect.h>
 #include <llvm/Support/YAMLParser.h>
 
+#include <map>
 #include <string>
 
 using namespace mull;
@@ -38,7 +46,28 @@ cl::OptionCategory MullOptionCategory("Mull");
 static cl::opt<std::string> ConfigFile(llvm::cl::desc("<config file>"),
                                        llvm::cl::Positional);
 
+static cl::opt<std::string> MergeOutput(
+    "merge-output", cl::Optional,
+    cl::desc("Merges the SQLite databases of the shards given with -merge "
+             "into a new one instead of running"),
+    cl::value_desc("path"), cl::cat(MullOptionCategory));
+
+static cl::list<std::string>
+    MergeInputs("merge", cl::ZeroOrMore, cl::CommaSeparated,
+                cl::desc("The SQLite databases of the shards of a run"),
+                cl::value_desc("path"), cl::cat(MullOptionCategory));
+
+static cl::list<std::string>
+    DiffInputs("diff", cl::ZeroOrMore, cl::CommaSeparated,
+               cl::desc("Prints the mutants that changed between the SQLite "
+                        "databases of two runs, the previous one first, "
+                        "instead of running"),
+               cl::value_desc("previous,current"),
+               cl::cat(MullOptionCategory));
+
 int main(int argc, char *argv[]) {
+  Logger::setAsynchronous(true);
+
   if (argc == 1) {
     // TODO: print friendlier help message here.
     Logger::error() << "Usage: mull-driver path-to-config-file.yml"
@@ -56,6 +85,51 @@ int main(int argc, char *argv[]) {
   cl::HideUnrelatedOptions(MullOptionCategory);
   cl::ParseCommandLineOptions(argc, argv, "Mull");
 
+  if (!MergeOutput.empty()) {
+    std::vector<std::string> partials(MergeInputs.begin(), MergeInputs.end());
+    std::string error;
+    if (partials.empty() ||
+        !mergeSQLiteDatabases(MergeOutput.getValue(), partials, error)) {
+      Logger::error() << "Cannot merge the results: "
+                      << (partials.empty() ? "no -merge databases" : error)
+                      << "\n";
+      exit(1);
+    }
+    Logger::info() << "Merged " << partials.size() << " databases into "
+                   << MergeOutput.getValue() << "\n";
+    return EXIT_SUCCESS;
+  }
+
+  if (!DiffInputs.empty()) {
+    if (DiffInputs.size() != 2) {
+      Logger::error() << "Cannot compare the results: -diff takes two "
+                         "databases\n";
+      exit(1);
+    }
+    std::map<MutantChange, size_t> counts;
+    std::string error;
+    bool compared = diffResults(
+        DiffInputs[0], DiffInputs[1],
+        [&](MutantChange change, const DiffedMutant &mutant) {
+          counts[change]++;
+          llvm::outs() << mutantChangeToString(change) << "\t" << mutant.file
+                       << ":" << mutant.line << ":" << mutant.column << "\t"
+                       << mutant.mutator << "\n";
+        },
+        error);
+    if (!compared) {
+      Logger::error() << "Cannot compare the results: " << error << "\n";
+      exit(1);
+    }
+    llvm::outs().flush();
+    Logger::info() << counts[MutantChange::NewlySurvived]
+                   << " newly survived, " << counts[MutantChange::NewlyKilled]
+                   << " newly killed, " << counts[MutantChange::Added]
+                   << " added, " << counts[MutantChange::Removed]
+                   << " removed mutants\n";
+    return EXIT_SUCCESS;
+  }
+
   ConfigParser Parser;
   auto rawConfig = Parser.loadConfig(ConfigFile.c_str());
 
@@ -72,6 +146,7 @@ int main(int argc, char *argv[]) {
 
   rawConfig.dump();
   Configuration configuration(rawConfig);
+  setResultMemoryBudget(size_t(configuration.resultMemoryBudget) << 20);
 
   InitializeNativeTarget();
   InitializeNativeTargetAsmPrinter();
@@ -81,7 +156,7 @@ int main(int argc, char *argv[]) {
   Filter filter;
 
   for (const std::string &location : rawConfig.getExcludeLocations()) {
-    filter.skipByLocation(location);
+    filter.skipByLocationPattern(location);
   }
 
   for (const std::string &test : rawConfig.getTests()) {
@@ -117,28 +192,61 @@ int main(int argc, char *argv[]) {
     } else if (detector == "none") {
       junkDetector = make_unique<NullJunkDetector>();
     } else if (detector == "cxx") {
-      junkDetector =
-          make_unique<CXXJunkDetector>(rawConfig.junkDetectionConfig());
+      if (configuration.cacheEnabled) {
+        rawConfig.junkDetectionConfig().cacheDirectory =
+            configuration.cacheDirectory;
+      }
+      junkDetector = make_unique<DebugInfoJunkDetector>(
+          make_unique<CXXJunkDetector>(rawConfig.junkDetectionConfig()));
     } else {
       Logger::error() << "mull-driver> Unknown junk detector provided: "
                       << "`" << detector << "`. ";
     }
   }
 
+  Metrics metrics;
   std::vector<std::unique_ptr<Reporter>> reporters;
   if (rawConfig.getReporters().empty()) {
-    reporters.push_back(
-        make_unique<SQLiteReporter>(rawConfig.getProjectName()));
+    reporters.push_back(make_unique<SQLiteReporter>(
+        rawConfig.getProjectName(), SQLiteSchema::Default,
+        rawConfig.getSQLiteWriters()));
   }
 
   for (auto &reporter : rawConfig.getReporters()) {
     if (reporter == "sqlite") {
+      reporters.push_back(make_unique<SQLiteReporter>(
+          rawConfig.getProjectName(), SQLiteSchema::Default,
+          rawConfig.getSQLiteWriters()));
+    }
+
+    else if (reporter == "sqlite_normalized") {
+      reporters.push_back(make_unique<SQLiteReporter>(
+          rawConfig.getProjectName(), SQLiteSchema::Normalized));
+    }
+
+    else if (reporter == "json") {
+      reporters.push_back(make_unique<JSONReporter>(
+          rawConfig.getProjectName(), rawConfig.getJSONFlushInterval()));
+    }
+
+    else if (reporter == "arrow") {
       reporters.push_back(
-          make_unique<SQLiteReporter>(rawConfig.getProjectName()));
+          make_unique<ArrowReporter>(rawConfig.getProjectName()));
     }
 
     else if (reporter == "time") {
-      reporters.push_back(make_unique<TimeReporter>());
+      std::string historyPath;
+      if (configuration.cacheEnabled) {
+        historyPath = configuration.cacheDirectory + "/timings/history.sqlite";
+      }
+      reporters.push_back(
+          make_unique<TimeReporter>(historyPath, rawConfig.getProjectName()));
+    }
+
+    else if (reporter == "trace") {
+      reporters.push_back(
+          make_unique<TraceReporter>(rawConfig.getProjectName()));
+      metrics.enableTracing();
     }
 
     else {
@@ -147,6 +255,9 @@ int main(int argc, char *argv[]) {
     }
   }
 
+  ThreadPool::shared().configure(configuration.parallelization);
+
+  metrics.beginLoadPrecompiledObjectFiles();
   ObjectFiles objectFiles;
   std::vector<LoadObjectFilesTask> tasks;
   for (int i = 0; i < configuration.parallelization.workers; i++) {
@@ -156,22 +267,32 @@ int main(int argc, char *argv[]) {
       "Loading precompiled object files", configuration.objectFilePaths,
       objectFiles, tasks);
   objectsLoader.execute();
+  metrics.endLoadPrecompiledObjectFiles();
 
   ModuleLoader moduleLoader;
+  metrics.beginLoadModules();
+  auto modules = moduleLoader.loadModules(configuration);
+  metrics.endLoadModules();
   Program program(configuration.dynamicLibraryPaths, std::move(objectFiles),
-                  moduleLoader.loadModules(configuration));
+                  std::move(modules));
 
-  Metrics metrics;
   Driver driver(configuration, program, testFramework, toolchain, filter,
                 mutationsFinder, metrics, *junkDetector);
+  for (auto &reporter : reporters) {
+    driver.streamResultsTo(*reporter);
+  }
 
+  /// Ctrl-C stops the run, the mutants that ran by then are reported
+  Cancellation::shared().installSignalHandlers();
   metrics.beginRun();
   auto result = driver.Run();
   metrics.endRun();
 
+  metrics.beginReportResult();
   for (auto &reporter : reporters) {
     reporter->reportResults(*result, rawConfig, metrics);
   }
+  metrics.endReportResult();
 
   llvm_shutdown();
 
@@ -179,5 +300,9 @@ int main(int argc, char *argv[]) {
   Logger::info() << "\nTotal execution time: " << totalExecutionTime.duration()
                  << MetricsMeasure::precision() << "\n";
 
+  /// The gate mode fails the run that found a surviving mutant
+  if (Cancellation::shared().reason() == Cancellation::Reason::Survivor) {
+    return EXIT_FAILURE;
+  }
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,190 @@
+#include "SyntheticProgram.h"
+
+#include "LLVMCompatibility.h"
+
+#include <llvm/AsmParser/Parser.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/SourceMgr.h>
+#include <llvm/Support/raw_ostream.h>
+
+using namespace mull::benchmarks;
+
+/// Each function takes seven lines of the source, the last one comes first
+/// so that every function is defined before it is called:
+///
+///     int f_0_1(int x) {
+///       int y = x + 3;
+///       if (y > 7) {
+///         return f_0_2(y - 1);
+///       }
+///       return y * 2;
+///     }
+static const int LinesPerFunction = 7;
+/// The metadata of the module comes first, six nodes per function follow
+static const int ModuleNodes = 5;
+static const int NodesPerFunction = 6;
+
+static std::string functionName(int module, int function) {
+  return "f_" + std::to_string(module) + "_" + std::to_string(function);
+}
+
+static std::string location(int line, int column, int scope) {
+  return "!DILocation(line: " + std::to_string(line) +
+         ", column: " + std::to_string(column) +
+         ", scope: !" + std::to_string(scope) + ")";
+}
+
+static void writeModule(const std::string &directory, int module,
+                        int functions, std::string &source,
+                        std::string &assembly) {
+  llvm::raw_string_ostream cxx(source);
+  llvm::raw_string_ostream ir(assembly);
+  std::string metadata;
+  llvm::raw_string_ostream nodes(metadata);
+
+  for (int position = 0; position < functions; position++) {
+    int function = functions - 1 - position;
+    bool last = function == functions - 1;
+    auto name = functionName(module, function);
+    auto callee = last ? std::string() : functionName(module, function + 1);
+    int line = 1 + position * LinesPerFunction;
+    int node = ModuleNodes + position * NodesPerFunction;
+
+    cxx << "int " << name << "(int x) {\n"
+        << "  int y = x + 3;\n"
+        << "  if (y > 7) {\n";
+    if (last) {
+      cxx << "    return y - 1;\n";
+    } else {
+      cxx << "    return " << callee << "(y - 1);\n";
+    }
+    cxx << "  }\n"
+        << "  return y * 2;\n"
+        << "}\n";
+
+    ir << "define i32 @" << name << "(i32 %x) !dbg !" << node << " {\n"
+       << "entry:\n"
+       << "  %y = add nsw i32 %x, 3, !dbg !" << node + 1 << "\n"
+       << "  %c = icmp sgt i32 %y, 7, !dbg !" << node + 2 << "\n"
+       << "  br i1 %c, label %then, label %else, !dbg !" << node + 2 << "\n"
+       << "then:\n"
+       << "  %d = sub nsw i32 %y, 1, !dbg !" << node + 3 << "\n";
+    if (last) {
+      ir << "  ret i32 %d, !dbg !" << node + 3 << "\n";
+    } else {
+      ir << "  %r = call i32 @" << callee << "(i32 %d), !dbg !" << node + 4
+         << "\n"
+         << "  ret i32 %r, !dbg !" << node + 4 << "\n";
+    }
+    ir << "else:\n"
+       << "  %m = mul nsw i32 %y, 2, !dbg !" << node + 5 << "\n"
+       << "  ret i32 %m, !dbg !" << node + 5 << "\n"
+       << "}\n\n";
+
+    /// The columns are those of the operators and of the callee
+    int subtraction = last ? 14 : 15 + int(callee.size());
+    nodes << "!" << node << " = distinct !DISubprogram(name: \"" << name
+          << "\", scope: !2, file: !2, line: " << line
+          << ", type: !3, isLocal: false, isDefinition: true, scopeLine: "
+          << line << ", unit: !1)\n"
+          << "!" << node + 1 << " = " << location(line + 1, 13, node) << "\n"
+          << "!" << node + 2 << " = " << location(line + 2, 9, node) << "\n"
+          << "!" << node + 3 << " = "
+          << location(line + 3, subtraction, node) << "\n"
+          << "!" << node + 4 << " = " << location(line + 3, 12, node) << "\n"
+          << "!" << node + 5 << " = " << location(line + 5, 12, node) << "\n";
+  }
+
+  auto file = "module_" + std::to_string(module) + ".cpp";
+  ir << "!llvm.module.flags = !{!0}\n"
+     << "!llvm.dbg.cu = !{!1}\n\n"
+     << "!0 = !{i32 2, !\"Debug Info Version\", i32 3}\n"
+     << "!1 = distinct !DICompileUnit(language: DW_LANG_C_plus_plus, "
+        "file: !2, producer: \"mull-benchmarks\", isOptimized: false, "
+        "runtimeVersion: 0, emissionKind: FullDebug)\n"
+     << "!2 = !DIFile(filename: \"" << file << "\", directory: \""
+     << directory << "\")\n"
+     << "!3 = !DISubroutineType(types: !4)\n"
+     << "!4 = !{null}\n"
+     << nodes.str();
+  cxx.flush();
+  ir.flush();
+}
+
+static std::string mainModule(int modules) {
+  std::string assembly;
+  llvm::raw_string_ostream ir(assembly);
+  for (int module = 0; module < modules; module++) {
+    ir << "declare i32 @" << functionName(module, 0) << "(i32)\n";
+  }
+  ir << "\ndefine i32 @benchmark_test(i32 %argc, i8** %argv) {\n"
+     << "entry:\n";
+  for (int module = 0; module < modules; module++) {
+    ir << "  %r" << module << " = call i32 @" << functionName(module, 0)
+       << "(i32 10)\n";
+  }
+  ir << "  ret i32 0\n"
+     << "}\n";
+  return ir.str();
+}
+
+static bool writeFile(const std::string &path, const std::string &content,
+                      std::string &error) {
+  std::error_code code;
+  llvm::raw_fd_ostream file(path, code, llvm::sys::fs::F_None);
+  if (code) {
+    error = "Cannot write " + path + ": " + code.message();
+    return false;
+  }
+  file << content;
+  return true;
+}
+
+static bool writeBitcode(const std::string &path, const std::string &assembly,
+                         std::string &error) {
+  llvm::LLVMContext context;
+  llvm::SMDiagnostic diagnostic;
+  auto module = llvm::parseAssemblyString(assembly, diagnostic, context);
+  if (!module) {
+    error = "Cannot generate " + path + ": " + diagnostic.getMessage().str();
+    return false;
+  }
+
+  std::error_code code;
+  llvm::raw_fd_ostream file(path, code, llvm::sys::fs::F_None);
+  if (code) {
+    error = "Cannot write " + path + ": " + code.message();
+    return false;
+  }
+  llvm_compat::writeBitcode(*module, file);
+  return true;
+}
+
+bool mull::benchmarks::writeSyntheticProgram(const std::string &directory,
+                                             int modules, int functions,
+                                             SyntheticProgram &program,
+                                             std::string &error) {
+  for (int module = 0; module < modules; module++) {
+    std::string source;
+    std::string assembly;
+    writeModule(directory, module, functions, source, assembly);
+
+    auto path = directory + "/module_" + std::to_string(module);
+    if (!writeFile(path + ".cpp", source, error) ||
+        !writeBitcode(path + ".bc", assembly, error)) {
+      return false;
+    }
+    program.sourcePaths.push_back(path + ".cpp");
+    program.bitcodePaths.push_back(path + ".bc");
+  }
+
+  auto path = directory + "/benchmark_main.bc";
+  if (!writeBitcode(path, mainModule(modules), error)) {
+    return false;
+  }
+  program.bitcodePaths.push_back(path);
+  program.testFunction = "benchmark_test";
+  return true;
+}
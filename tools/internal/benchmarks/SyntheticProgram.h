@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace mull {
+namespace benchmarks {
+
+/// A generated program: `modules` modules of `functions` functions each,
+/// every function adds, compares, subtracts and calls the next one, so the
+/// default mutators find a few mutants per function. The sources the debug
+/// information points to are written next to the bitcode, for the junk
+/// detection. The test `benchmark_test(int, char **)` lives in a module of
+/// its own and calls the first function of every module.
+struct SyntheticProgram {
+  std::vector<std::string> bitcodePaths;
+  std::vector<std::string> sourcePaths;
+  std::string testFunction;
+};
+
+/// False with an error message if a file cannot be written
+bool writeSyntheticProgram(const std::string &directory, int modules,
+                           int functions, SyntheticProgram &program,
+                           std::string &error);
+
+} // namespace benchmarks
+} // namespace mull
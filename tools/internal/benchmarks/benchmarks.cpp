@@ -0,0 +1,591 @@
+#include "SyntheticProgram.h"
+
+#include <llvm/ADT/STLExtras.h>
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/CommandLine.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Format.h>
+#include <llvm/Support/TargetSelect.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <mull/Config/Configuration.h>
+#include <mull/Config/RawConfig.h>
+#include <mull/Filter.h>
+#include <mull/ForkProcessSandbox.h>
+#include <mull/Instrumentation/Instrumentation.h>
+#include <mull/JunkDetection/CXX/CXXJunkDetector.h>
+#include <mull/Metrics/Metrics.h>
+#include <mull/Metrics/TimingHistory.h>
+#include <mull/ModuleLoader.h>
+#include <mull/MutationPoint.h>
+#include <mull/MutationResult.h>
+#include <mull/MutationsFinder.h>
+#include <mull/Mutators/MutatorsFactory.h>
+#include <mull/Program/Program.h>
+#include <mull/Reporters/SQLiteReporter.h>
+#include <mull/Result.h>
+#include <mull/TestFrameworks/NativeTestRunner.h>
+#include <mull/TestFrameworks/Test.h>
+#include <mull/Testee.h>
+#include <mull/Toolchain/JITEngine.h>
+#include <mull/Toolchain/SlabMemoryManager.h>
+#include <mull/Toolchain/Toolchain.h>
+#include <mull/Version.h>
+
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <map>
+#include <string>
+#include <cstring>
+#include <vector>
+
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#endif
+
+using namespace mull;
+using namespace llvm;
+
+static cl::opt<int> Modules("modules", cl::Optional,
+                            cl::desc("How many modules the generated "
+                                     "program has"),
+                            cl::init(20));
+
+static cl::opt<int> Functions("functions", cl::Optional,
+                              cl::desc("How many functions each module of "
+                                       "the generated program has"),
+                              cl::init(50));
+
+static cl::opt<int> Iterations("iterations", cl::Optional,
+                               cl::desc("How many times the whole pipeline "
+                                        "runs"),
+                               cl::init(5));
+
+static cl::opt<int> Runs("runs", cl::Optional,
+                         cl::desc("How many times each iteration runs the "
+                                  "test in the sandbox"),
+                         cl::init(20));
+
+static cl::list<int>
+    ParentSizes("parent-sizes", cl::ZeroOrMore, cl::CommaSeparated,
+                cl::desc("Measures the sandbox runs again with mull grown "
+                         "by each of the sizes, in megabytes of touched "
+                         "memory"));
+
+static cl::opt<bool> JITHugePages("jit-huge-pages", cl::Optional,
+                                  cl::desc("Maps the JIT slabs on huge "
+                                           "pages"),
+                                  cl::init(false));
+
+static cl::opt<std::string>
+    Directory("directory", cl::Optional,
+              cl::desc("Where the generated program is written, a new "
+                       "temporary directory by default"),
+              cl::init(""));
+
+static cl::opt<std::string> JSONPath("json", cl::Optional,
+                                     cl::desc("Writes the results as JSON "
+                                              "to the file"),
+                                     cl::init(""));
+
+static cl::opt<std::string>
+    HistoryPath("history", cl::Optional,
+                cl::desc("Compares the results with the previous runs of "
+                         "the same size in the timing history database, "
+                         "then adds them to it"),
+                cl::init(""));
+
+/// The mean of a benchmark is compared with the median of its last runs
+static const unsigned ComparedRuns = 10;
+static const double RegressionFactor = 1.5;
+static const double NoiseMilliseconds = 0.05;
+
+namespace {
+
+/// The page faults of mull and of the children it waited for, and the iTLB
+/// misses of both where the kernel lets a process count them
+class FaultCounters {
+public:
+  FaultCounters() : itlbCounter(-1) {
+#ifdef __linux__
+    struct perf_event_attr attributes;
+    memset(&attributes, 0, sizeof(attributes));
+    attributes.type = PERF_TYPE_HW_CACHE;
+    attributes.size = sizeof(attributes);
+    attributes.config = PERF_COUNT_HW_CACHE_ITLB |
+                        (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                        (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    /// The children forked from now on add their misses on exit
+    attributes.inherit = 1;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+    itlbCounter = int(syscall(__NR_perf_event_open, &attributes, 0, -1, -1, 0));
+#endif
+  }
+
+  ~FaultCounters() {
+    if (itlbCounter != -1) {
+      close(itlbCounter);
+    }
+  }
+
+  bool countsITLBMisses() const { return itlbCounter != -1; }
+
+  uint64_t pageFaults() const {
+    uint64_t faults = 0;
+    struct rusage usage;
+    for (int who : {RUSAGE_SELF, RUSAGE_CHILDREN}) {
+      if (getrusage(who, &usage) == 0) {
+        faults += uint64_t(usage.ru_minflt) + uint64_t(usage.ru_majflt);
+      }
+    }
+    return faults;
+  }
+
+  uint64_t itlbMisses() const {
+    uint64_t misses = 0;
+    if (itlbCounter == -1 ||
+        read(itlbCounter, &misses, sizeof(misses)) != sizeof(misses)) {
+      return 0;
+    }
+    return misses;
+  }
+
+private:
+  int itlbCounter;
+};
+
+/// The durations of one stage of the pipeline over the iterations, and how
+/// many items (modules, mutants, runs) an iteration of the stage handled,
+/// with the page faults and the iTLB misses of each iteration
+struct Benchmark {
+  std::string name;
+  uint64_t items;
+  std::vector<int64_t> nanoseconds;
+  std::vector<uint64_t> pageFaults;
+  std::vector<uint64_t> itlbMisses;
+
+  Benchmark(std::string name) : name(std::move(name)), items(0) {}
+
+  static uint64_t meanOf(const std::vector<uint64_t> &values) {
+    uint64_t total = 0;
+    for (auto value : values) {
+      total += value;
+    }
+    return values.empty() ? 0 : total / values.size();
+  }
+
+  int64_t min() const {
+    return *std::min_element(nanoseconds.begin(), nanoseconds.end());
+  }
+  int64_t max() const {
+    return *std::max_element(nanoseconds.begin(), nanoseconds.end());
+  }
+  int64_t mean() const {
+    int64_t total = 0;
+    for (auto duration : nanoseconds) {
+      total += duration;
+    }
+    return total / int64_t(nanoseconds.size());
+  }
+};
+
+class Benchmarks {
+public:
+  /// The stage returns how many items it handled
+  template <typename Stage> void measure(const std::string &name, Stage stage) {
+    auto faultsBefore = counters.pageFaults();
+    auto missesBefore = counters.itlbMisses();
+    auto start = std::chrono::steady_clock::now();
+    uint64_t items = stage();
+    auto end = std::chrono::steady_clock::now();
+    auto faultsAfter = counters.pageFaults();
+    auto missesAfter = counters.itlbMisses();
+
+    auto &benchmark = find(name);
+    benchmark.items = items;
+    benchmark.nanoseconds.push_back(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+            .count());
+    benchmark.pageFaults.push_back(faultsAfter - faultsBefore);
+    benchmark.itlbMisses.push_back(missesAfter - missesBefore);
+  }
+
+  void print(raw_ostream &out) const;
+  /// The layout of Google Benchmark, so that the existing tools can compare
+  /// two runs, with the minimum and the maximum added
+  void writeJSON(raw_ostream &out) const;
+  /// The means, as the JSON has them, for the timing history
+  std::vector<Timing> timings() const;
+
+private:
+  std::vector<Benchmark> benchmarks;
+  FaultCounters counters;
+
+  Benchmark &find(const std::string &name) {
+    for (auto &benchmark : benchmarks) {
+      if (benchmark.name == name) {
+        return benchmark;
+      }
+    }
+    benchmarks.emplace_back(name);
+    return benchmarks.back();
+  }
+};
+
+} // namespace
+
+static double milliseconds(int64_t nanoseconds) {
+  return double(nanoseconds) / 1000000.0;
+}
+
+void Benchmarks::print(raw_ostream &out) const {
+  for (auto &benchmark : benchmarks) {
+    out << benchmark.name << ": mean "
+        << format("%.3f", milliseconds(benchmark.mean())) << "ms, min " << format("%.3f", milliseconds(benchmark.min()))
+        << "ms, max " << format("%.3f", milliseconds(benchmark.max()))
+        << "ms, " << benchmark.items << " items, "
+        << Benchmark::meanOf(benchmark.pageFaults) << " page faults";
+    if (counters.countsITLBMisses()) {
+      out << ", " << Benchmark::meanOf(benchmark.itlbMisses)
+          << " iTLB misses";
+    }
+    out << "\n";
+  }
+}
+
+void Benchmarks::writeJSON(raw_ostream &out) const {
+  char date[64] = {0};
+  auto now = std::time(nullptr);
+  std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+  out << "{\n"
+      << "  \"context\": {\n"
+      << "    \"date\": \"" << date << "\",\n"
+      << "    \"executable\": \"mull-benchmarks\",\n"
+      << "    \"mull_version\": \"" << mullVersionString() << "\",\n"
+      << "    \"mull_commit\": \"" << mullCommitString() << "\",\n"
+      << "    \"llvm_version\": \"" << llvmVersionString() << "\",\n"
+      << "    \"modules\": " << Modules << ",\n"
+      << "    \"functions\": " << Functions << ",\n"
+      << "    \"runs\": " << Runs << ",\n"
+      << "    \"jit_huge_pages\": " << (JITHugePages ? "true" : "false")
+      << "\n"
+      << "  },\n"
+      << "  \"benchmarks\": [";
+  for (size_t index = 0; index < benchmarks.size(); index++) {
+    auto &benchmark = benchmarks[index];
+    out << (index ? ",\n" : "\n") << "    {\"name\": \"" << benchmark.name
+        << "\", \"run_type\": \"iteration\", \"iterations\": "
+        << benchmark.nanoseconds.size()
+        << ", \"real_time\": " << format("%.6f", milliseconds(benchmark.mean()))
+        << ", \"min_time\": " << format("%.6f", milliseconds(benchmark.min()))
+        << ", \"max_time\": " << format("%.6f", milliseconds(benchmark.max()))
+        << ", \"time_unit\": \"ms\", \"items\": " << benchmark.items
+        << ", \"page_faults\": " << Benchmark::meanOf(benchmark.pageFaults);
+    if (counters.countsITLBMisses()) {
+      out << ", \"itlb_misses\": "
+          << Benchmark::meanOf(benchmark.itlbMisses);
+    }
+    out << "}";
+  }
+  out << "\n  ]\n"
+      << "}\n";
+}
+
+std::vector<Timing> Benchmarks::timings() const {
+  std::vector<Timing> timings;
+  for (auto &benchmark : benchmarks) {
+    timings.emplace_back(benchmark.name, milliseconds(benchmark.mean()));
+  }
+  return timings;
+}
+
+/// The runs are compared with the previous runs of the same program only
+static bool compareWithHistory(const std::string &path,
+                               const Benchmarks &benchmarks) {
+  TimingHistory history(path);
+  std::string error;
+  if (!history.open(error)) {
+    errs() << "Cannot open " << path << ": " << error << "\n";
+    return false;
+  }
+
+  auto workload = "benchmarks " + std::to_string(Modules) + "x" +
+                  std::to_string(Functions) + "x" + std::to_string(Runs);
+  auto timings = benchmarks.timings();
+  for (auto &regression :
+       history.compare(workload, timings, ComparedRuns, RegressionFactor,
+                       NoiseMilliseconds)) {
+    outs() << "Regression: " << regression.name << " mean "
+           << format("%.3f", regression.milliseconds) << "ms, median of the "
+           << "last " << regression.runs << " runs "
+           << format("%.3f", regression.baseline) << "ms\n";
+  }
+  if (!history.record(workload, timings)) {
+    errs() << "Cannot add the results to " << path << "\n";
+    return false;
+  }
+  return true;
+}
+
+/// One iteration of the pipeline, from the bitcode on disk to the report,
+/// as the driver runs it on one worker
+static bool runPipeline(const benchmarks::SyntheticProgram &synthetic,
+                        Benchmarks &benchmarks) {
+  Configuration configuration;
+  Toolchain toolchain(configuration);
+  Instrumentation instrumentation;
+  Filter filter;
+  Metrics metrics;
+
+  std::vector<std::unique_ptr<LLVMContext>> contexts;
+  std::vector<std::unique_ptr<MullModule>> modules;
+  ModuleLoader loader;
+  benchmarks.measure("load_modules", [&]() {
+    for (auto &path : synthetic.bitcodePaths) {
+      contexts.push_back(make_unique<LLVMContext>());
+      modules.push_back(loader.loadModuleAtPath(path, *contexts.back()));
+    }
+    return modules.size();
+  });
+  for (auto &module : modules) {
+    if (!module) {
+      return false;
+    }
+  }
+  Program program({}, {}, std::move(modules));
+
+  std::vector<object::OwningBinary<object::ObjectFile>> owned;
+  std::vector<object::ObjectFile *> objectFiles;
+  benchmarks.measure("instrumented_compilation", [&]() {
+    for (auto &module : program.modules()) {
+      instrumentation.recordFunctions(module->getModule());
+    }
+    for (auto &module : program.modules()) {
+      LLVMContext instrumentationContext;
+      auto clonedModule = module->clone(instrumentationContext);
+      instrumentation.insertCallbacks(clonedModule->getModule());
+      owned.push_back(toolchain.compiler().compileModule(
+          *clonedModule, toolchain.targetMachine()));
+      objectFiles.push_back(owned.back().getBinary());
+    }
+    return objectFiles.size();
+  });
+
+  NativeTestRunner runner(toolchain.mangler());
+  JITEngine jit;
+  benchmarks.measure("jit_linking", [&]() {
+    runner.loadInstrumentedProgram(objectFiles, instrumentation, jit);
+    return objectFiles.size();
+  });
+
+  Test test("benchmark", "mull", synthetic.testFunction, {},
+            program.lookupDefinedFunction(synthetic.testFunction));
+  ForkProcessSandbox sandbox;
+  bool passed = true;
+  auto runTest = [&]() {
+    instrumentation.setupInstrumentationInfo(test);
+    auto result = sandbox.run(
+        [&]() { return runner.runTest(jit, program, test); },
+        configuration.timeout);
+    passed = passed && result.status == ExecutionStatus::Passed;
+  };
+  benchmarks.measure("sandbox_runs", [&]() {
+    for (int run = 0; run < Runs; run++) {
+      runTest();
+      instrumentation.cleanupInstrumentationInfo(test);
+    }
+    return uint64_t(Runs);
+  });
+
+  /// The calls of the last run make the call tree
+  runTest();
+  if (!passed) {
+    errs() << "The test of the generated program failed\n";
+    return false;
+  }
+  std::vector<std::unique_ptr<Testee>> testees;
+  benchmarks.measure("dynamic_call_tree", [&]() {
+    auto calls = instrumentation.takeCalls(test);
+    testees = instrumentation.getTestees(calls, test, filter,
+                                         configuration.maxDistance);
+    return testees.size();
+  });
+  instrumentation.cleanupInstrumentationInfo(test);
+
+  auto mergedTestees = mergeTestees(testees);
+  MutatorsFactory factory;
+  MutationsFinder finder(factory.mutators({"default"}), configuration);
+  std::vector<MutationPoint *> points;
+  benchmarks.measure("mutation_search", [&]() {
+    points = finder.getMutationPoints(program, mergedTestees, filter);
+    return points.size();
+  });
+
+  JunkDetectionConfig junkDetectionConfig;
+  benchmarks.measure("junk_detection", [&]() {
+    CXXJunkDetector junkDetector(junkDetectionConfig);
+    junkDetector.prepare(synthetic.sourcePaths, 1);
+    for (auto point : points) {
+      junkDetector.isJunk(point);
+    }
+    return points.size();
+  });
+
+  benchmarks.measure("mutation_application", [&]() {
+    std::map<MullModule *, std::vector<MutationPoint *>> pointsByModule;
+    for (auto point : points) {
+      pointsByModule[point->getOriginalModule()].push_back(point);
+    }
+    for (auto &modulePoints : pointsByModule) {
+      modulePoints.first->prepareMutations();
+      for (auto point : modulePoints.second) {
+        point->applyMutation();
+      }
+    }
+    return points.size();
+  });
+
+  benchmarks.measure("reporting", [&]() {
+    std::vector<Test> tests({test});
+    MutationResultTable results;
+    for (auto point : points) {
+      ExecutionResult execution;
+      execution.status = ExecutionStatus::Failed;
+      execution.runningTime = 1;
+      results.add(MutationResult(execution, point, 1, &tests.front()));
+    }
+    auto reported = results.size();
+    Result result(std::move(tests), std::move(results), points);
+    SQLiteReporter reporter("benchmark");
+    RawConfig rawConfig;
+    reporter.reportResults(result, rawConfig, metrics);
+    sys::fs::remove(reporter.getDatabasePath());
+    return reported;
+  });
+
+  return true;
+}
+
+/// What a fork costs as mull grows: the page tables of the parent are
+/// copied on every fork, whatever the child touches
+static void measureForkLatency(Benchmarks &benchmarks) {
+  for (int megabytes : ParentSizes) {
+    size_t size = size_t(std::max(megabytes, 0)) * 1024 * 1024;
+    void *memory = nullptr;
+    if (size != 0) {
+      memory = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (memory == MAP_FAILED) {
+        errs() << "Cannot grow mull by " << megabytes << "MB\n";
+        continue;
+      }
+      memset(memory, 1, size);
+    }
+
+    ForkProcessSandbox sandbox;
+    benchmarks.measure(
+        "sandbox_runs_parent_" + std::to_string(megabytes) + "mb", [&]() {
+          for (int run = 0; run < Runs; run++) {
+            sandbox.run([]() { return ExecutionStatus::Passed; }, 1000);
+          }
+          return uint64_t(Runs);
+        });
+
+    if (memory) {
+      munmap(memory, size);
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  cl::ParseCommandLineOptions(argc, argv, "Benchmarks of the mull pipeline");
+  if (Modules < 1 || Functions < 1 || Iterations < 1 || Runs < 0) {
+    errs() << "The program needs a module and a function, the benchmarks an "
+              "iteration\n";
+    return 1;
+  }
+
+  SlabMemoryManager::setHugePages(JITHugePages);
+
+  InitializeNativeTarget();
+  InitializeNativeTargetAsmPrinter();
+  InitializeNativeTargetAsmParser();
+
+  std::string jsonPath = JSONPath;
+  if (!jsonPath.empty()) {
+    SmallString<256> absolutePath(jsonPath);
+    sys::fs::make_absolute(absolutePath);
+    jsonPath = absolutePath.str().str();
+  }
+
+  std::string historyPath = HistoryPath;
+  if (!historyPath.empty()) {
+    SmallString<256> absolutePath(historyPath);
+    sys::fs::make_absolute(absolutePath);
+    historyPath = absolutePath.str().str();
+  }
+
+  std::string directory = Directory;
+  if (directory.empty()) {
+    SmallString<128> temporary;
+    auto error = sys::fs::createUniqueDirectory("mull-benchmarks", temporary);
+    if (error) {
+      errs() << "Cannot create a directory: " << error.message() << "\n";
+      return 1;
+    }
+    directory = temporary.str().str();
+  } else {
+    SmallString<256> absolutePath(directory);
+    sys::fs::make_absolute(absolutePath);
+    directory = absolutePath.str().str();
+    sys::fs::create_directories(directory);
+  }
+
+  benchmarks::SyntheticProgram synthetic;
+  std::string error;
+  if (!benchmarks::writeSyntheticProgram(directory, Modules, Functions,
+                                         synthetic, error)) {
+    errs() << error << "\n";
+    return 1;
+  }
+  outs() << "Generated " << Modules << " modules of " << Functions
+         << " functions in " << directory << "\n";
+
+  /// The reporters write into the working directory
+  if (chdir(directory.c_str()) != 0) {
+    errs() << "Cannot change to " << directory << "\n";
+    return 1;
+  }
+
+  Benchmarks benchmarks;
+  for (int iteration = 0; iteration < Iterations; iteration++) {
+    if (!runPipeline(synthetic, benchmarks)) {
+      return 1;
+    }
+    measureForkLatency(benchmarks);
+  }
+  benchmarks.print(outs());
+
+  if (!jsonPath.empty()) {
+    std::error_code code;
+    raw_fd_ostream json(jsonPath, code, sys::fs::F_None);
+    if (code) {
+      errs() << "Cannot write " << jsonPath << ": " << code.message() << "\n";
+      return 1;
+    }
+    benchmarks.writeJSON(json);
+  }
+
+  if (!historyPath.empty() && !compareWithHistory(historyPath, benchmarks)) {
+    return 1;
+  }
+  return 0;
+}
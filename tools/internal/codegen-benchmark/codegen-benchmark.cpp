@@ -0,0 +1,93 @@
+#include <cassert>
+#include <chrono>
+#include <utility>
+#include <vector>
+
+#include <llvm/Support/TargetSelect.h>
+
+#include <mull/Config/Configuration.h>
+#include <mull/Instrumentation/Instrumentation.h>
+#include <mull/ModuleLoader.h>
+#include <mull/Program/Program.h>
+#include <mull/TestFrameworks/NativeTestRunner.h>
+#include <mull/TestFrameworks/Test.h>
+#include <mull/Toolchain/JITEngine.h>
+#include <mull/Toolchain/Toolchain.h>
+
+static long long millisecondsBetween(std::chrono::steady_clock::time_point a,
+                                     std::chrono::steady_clock::time_point b) {
+  using namespace std::chrono;
+  return (long long)duration_cast<milliseconds>(b - a).count();
+}
+
+/// Measures how long it takes to compile the instrumented program at a code
+/// generation level, and how long the test then takes to run: the time saved
+/// on compilation is paid back on every run of a mutant
+static void benchmark(int level, const std::string &driverFunction,
+                      mull::Program &program,
+                      mull::Instrumentation &instrumentation) {
+  mull::Configuration configuration;
+  configuration.codegenOptLevel = level;
+  mull::Toolchain toolchain(configuration);
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<llvm::object::OwningBinary<llvm::object::ObjectFile>> owned;
+  std::vector<llvm::object::ObjectFile *> objectFiles;
+  for (auto &module : program.modules()) {
+    llvm::LLVMContext instrumentationContext;
+    auto clonedModule = module->clone(instrumentationContext);
+    instrumentation.insertCallbacks(clonedModule->getModule());
+    owned.push_back(toolchain.compiler().compileModule(
+        *clonedModule, toolchain.workerTargetMachine()));
+    objectFiles.push_back(owned.back().getBinary());
+  }
+  auto compiled = std::chrono::steady_clock::now();
+
+  mull::NativeTestRunner runner(toolchain.mangler());
+  mull::JITEngine jit;
+  runner.loadInstrumentedProgram(objectFiles, instrumentation, jit);
+  auto loaded = std::chrono::steady_clock::now();
+
+  mull::Test test("benchmark", "mull", driverFunction, {}, nullptr);
+  auto status = runner.runTest(jit, program, test);
+  auto finished = std::chrono::steady_clock::now();
+
+  printf("-O%d: compile %lldms, load %lldms, run %lldms, total %lldms%s\n",
+         level, millisecondsBetween(start, compiled),
+         millisecondsBetween(compiled, loaded),
+         millisecondsBetween(loaded, finished),
+         millisecondsBetween(start, finished),
+         status == mull::ExecutionStatus::Passed ? "" : " (test failed)");
+}
+
+int main(int argc, char **argv) {
+  assert(argc >= 3 && "Expect a driver function and paths to bitcode files");
+
+  llvm::InitializeNativeTarget();
+  llvm::InitializeNativeTargetAsmPrinter();
+  llvm::InitializeNativeTargetAsmParser();
+
+  std::string driverFunction(argv[1]);
+
+  mull::ModuleLoader loader;
+  llvm::LLVMContext context;
+  std::vector<std::unique_ptr<mull::MullModule>> modules;
+  for (int i = 2; i < argc; i++) {
+    modules.push_back(loader.loadModuleAtPath(argv[i], context));
+  }
+
+  mull::Instrumentation instrumentation;
+  for (auto &module : modules) {
+    instrumentation.recordFunctions(module->getModule());
+  }
+
+  mull::Program program({}, {}, std::move(modules));
+
+  printf("Loaded %lu modules\n", program.modules().size());
+
+  for (int level = 0; level <= 3; level++) {
+    benchmark(level, driverFunction, program, instrumentation);
+  }
+
+  return 0;
+}
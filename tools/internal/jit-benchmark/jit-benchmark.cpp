@@ -0,0 +1,87 @@
+#include <cassert>
+#include <chrono>
+#include <utility>
+#include <vector>
+
+#include <llvm/Support/TargetSelect.h>
+
+#include <mull/Config/Configuration.h>
+#include <mull/Instrumentation/Instrumentation.h>
+#include <mull/ModuleLoader.h>
+#include <mull/TestFrameworks/NativeTestRunner.h>
+#include <mull/Toolchain/JITEngine.h>
+#include <mull/Toolchain/Mangler.h>
+#include <mull/Toolchain/Toolchain.h>
+
+/// Measures how long it takes to load the instrumented program and to look up
+/// the entry point of a test under eager and lazy linking
+static void benchmark(mull::JITLinking linking, const char *name,
+                      const std::string &symbol,
+                      std::vector<llvm::object::ObjectFile *> &objectFiles,
+                      mull::Instrumentation &instrumentation,
+                      mull::Toolchain &toolchain) {
+  mull::NativeTestRunner runner(toolchain.mangler());
+  mull::JITEngine jit(linking);
+
+  auto start = std::chrono::steady_clock::now();
+  runner.loadInstrumentedProgram(objectFiles, instrumentation, jit);
+  auto loaded = std::chrono::steady_clock::now();
+  auto address = llvm_compat::JITSymbolAddress(
+      jit.getSymbol(toolchain.mangler().getNameWithPrefix(symbol)));
+  auto found = std::chrono::steady_clock::now();
+
+  using std::chrono::duration_cast;
+  using std::chrono::milliseconds;
+  printf("%s: load %lldms, lookup %lldms, total %lldms%s\n", name,
+         (long long)duration_cast<milliseconds>(loaded - start).count(),
+         (long long)duration_cast<milliseconds>(found - loaded).count(),
+         (long long)duration_cast<milliseconds>(found - start).count(),
+         address ? "" : " (symbol not found)");
+}
+
+int main(int argc, char **argv) {
+  assert(argc >= 3 && "Expect a symbol name and paths to bitcode files");
+
+  llvm::InitializeNativeTarget();
+  llvm::InitializeNativeTargetAsmPrinter();
+  llvm::InitializeNativeTargetAsmParser();
+
+  std::string symbol(argv[1]);
+
+  mull::ModuleLoader loader;
+  llvm::LLVMContext context;
+  std::vector<std::unique_ptr<mull::MullModule>> modules;
+  for (int i = 2; i < argc; i++) {
+    modules.push_back(loader.loadModuleAtPath(argv[i], context));
+  }
+
+  mull::Configuration configuration;
+  mull::Toolchain toolchain(configuration);
+  mull::Instrumentation instrumentation;
+
+  for (auto &module : modules) {
+    instrumentation.recordFunctions(module->getModule());
+  }
+
+  std::vector<llvm::object::OwningBinary<llvm::object::ObjectFile>> owned;
+  std::vector<llvm::object::ObjectFile *> objectFiles;
+  for (auto &module : modules) {
+    llvm::LLVMContext instrumentationContext;
+    auto clonedModule = module->clone(instrumentationContext);
+    instrumentation.insertCallbacks(clonedModule->getModule());
+    owned.push_back(toolchain.compiler().compileModule(
+        *clonedModule, toolchain.targetMachine()));
+    objectFiles.push_back(owned.back().getBinary());
+  }
+
+  printf("Loaded %lu objects\n", objectFiles.size());
+
+  benchmark(mull::JITLinking::Eager, "eager", symbol, objectFiles,
+            instrumentation, toolchain);
+  benchmark(mull::JITLinking::Lazy, "lazy", symbol, objectFiles,
+            instrumentation, toolchain);
+  benchmark(mull::JITLinking::Parallel, "parallel", symbol, objectFiles,
+            instrumentation, toolchain);
+
+  return 0;
+}
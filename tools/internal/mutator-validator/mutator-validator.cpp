@@ -1,35 +1,120 @@
-#include <cassert>
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <string>
 #include <utility>
 #include <vector>
 
 #include <llvm/IR/Verifier.h>
+#include <llvm/Support/CommandLine.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Format.h>
+#include <llvm/Support/TargetSelect.h>
+#include <llvm/Support/raw_ostream.h>
 
 #include <mull/Config/Configuration.h>
 #include <mull/Filter.h>
+#include <mull/Metrics/Metrics.h>
 #include <mull/ModuleLoader.h>
+#include <mull/MutationPoint.h>
 #include <mull/MutationsFinder.h>
 #include <mull/Mutators/MutatorsFactory.h>
-#include <mull/Parallelization/TaskExecutor.h>
 #include <mull/Program/Program.h>
 #include <mull/Toolchain/Toolchain.h>
+#include <mull/Version.h>
 
-int main(int argc, char **argv) {
-  assert(argc == 3 && "Expect mutator name and path to a bitcode file");
+using namespace llvm;
+
+static cl::opt<std::string> MutatorGroup(cl::Positional, cl::Required,
+                                         cl::desc("<mutator or group>"));
+
+static cl::opt<std::string> BitcodePath(cl::Positional, cl::Required,
+                                        cl::desc("<bitcode file>"));
+
+static cl::opt<int> Iterations("iterations", cl::Optional,
+                               cl::desc("How many times each mutator of the "
+                                        "group is measured"),
+                               cl::init(1));
+
+static cl::opt<std::string> JSONPath("json", cl::Optional,
+                                     cl::desc("Writes the results as JSON "
+                                              "to the file"),
+                                     cl::init(""));
+
+namespace {
+
+/// The durations of a stage over the iterations
+struct Stage {
+  std::vector<int64_t> nanoseconds;
+
+  int64_t min() const {
+    return *std::min_element(nanoseconds.begin(), nanoseconds.end());
+  }
+  int64_t max() const {
+    return *std::max_element(nanoseconds.begin(), nanoseconds.end());
+  }
+  int64_t mean() const {
+    int64_t total = 0;
+    for (auto duration : nanoseconds) {
+      total += duration;
+    }
+    return total / int64_t(nanoseconds.size());
+  }
+};
+
+/// A mutator of the group, each iteration runs it over a fresh copy of the
+/// module
+struct MutatorBenchmark {
+  std::string mutator;
+  uint64_t points = 0;
+  Stage search;
+  /// Clones the mutated functions, see MullModule::prepareMutations
+  Stage prepare;
+  Stage apply;
+  /// Compiles the mutated module, original functions included
+  Stage codegen;
+  /// What malloc holds once the functions are cloned, see
+  /// MemoryUsage::heapLive
+  std::vector<int64_t> cloneBytes;
+  /// The mutated module passed the verifier on every iteration
+  bool valid = true;
+
+  int64_t meanCloneBytes() const {
+    int64_t total = 0;
+    for (auto bytes : cloneBytes) {
+      total += bytes;
+    }
+    return total / int64_t(cloneBytes.size());
+  }
+};
+
+} // namespace
+
+static int64_t nanosecondsBetween(std::chrono::steady_clock::time_point a,
+                                  std::chrono::steady_clock::time_point b) {
+  using namespace std::chrono;
+  return duration_cast<nanoseconds>(b - a).count();
+}
+
+static double milliseconds(int64_t nanoseconds) {
+  return double(nanoseconds) / 1000000.0;
+}
 
-  std::vector<std::string> mutatorGroups({argv[1]});
-  const char *bitcodePath = argv[2];
+static double perPoint(int64_t value, uint64_t points) {
+  return points == 0 ? 0 : double(value) / double(points);
+}
 
+static void measure(MutatorBenchmark &benchmark, mull::Toolchain &toolchain) {
   mull::ModuleLoader loader;
-  llvm::LLVMContext context;
+  LLVMContext context;
   std::vector<std::unique_ptr<mull::MullModule>> modules;
-  modules.push_back(std::move(loader.loadModuleAtPath(bitcodePath, context)));
+  modules.push_back(loader.loadModuleAtPath(BitcodePath, context));
   mull::Program program({}, {}, std::move(modules));
 
   mull::MutatorsFactory factory;
-  auto mutators = factory.mutators(mutatorGroups);
-
   mull::Configuration configuration;
-  mull::MutationsFinder finder(std::move(mutators), configuration);
+  mull::MutationsFinder finder(factory.mutators({benchmark.mutator}),
+                               configuration);
 
   std::vector<mull::MergedTestee> testees;
   for (auto &module : program.modules()) {
@@ -37,36 +122,167 @@ int main(int argc, char **argv) {
       testees.emplace_back(&function, nullptr, 1);
     }
   }
-
   mull::Filter filter;
 
+  auto start = std::chrono::steady_clock::now();
   auto mutants = finder.getMutationPoints(program, testees, filter);
+  auto searched = std::chrono::steady_clock::now();
+  benchmark.points = mutants.size();
+  benchmark.search.nanoseconds.push_back(nanosecondsBetween(start, searched));
 
-  printf("Found %lu mutants\n", mutants.size());
+  /// The heap is measured outside of the timings, it takes a while
+  auto heapBefore = mull::MemoryUsage::current().heapLive;
+  start = std::chrono::steady_clock::now();
+  for (auto &module : program.modules()) {
+    module->prepareMutations();
+  }
+  auto prepared = std::chrono::steady_clock::now();
+  auto heapAfter = mull::MemoryUsage::current().heapLive;
+  benchmark.prepare.nanoseconds.push_back(nanosecondsBetween(start, prepared));
+  benchmark.cloneBytes.push_back(
+      std::max<int64_t>(0, int64_t(heapAfter) - int64_t(heapBefore)));
 
-  mull::SingleTaskExecutor prepareMutants("Preparing mutants", [&] {
-    for (auto &module : program.modules()) {
-      module->prepareMutations();
-    }
-  });
-  prepareMutants.execute();
+  start = std::chrono::steady_clock::now();
+  for (auto &mutant : mutants) {
+    mutant->applyMutation();
+  }
+  auto applied = std::chrono::steady_clock::now();
+  benchmark.apply.nanoseconds.push_back(nanosecondsBetween(start, applied));
 
-  mull::SingleTaskExecutor applyMutants("Applying mutants", [&] {
-    for (auto &mutant : mutants) {
-      mutant->applyMutation();
+  for (auto &module : program.modules()) {
+    if (verifyModule(*module->getModule(), &errs())) {
+      errs() << benchmark.mutator << " left an invalid module\n";
+      benchmark.valid = false;
     }
-  });
-  applyMutants.execute();
+  }
+
+  start = std::chrono::steady_clock::now();
+  for (auto &module : program.modules()) {
+    toolchain.compiler().compileModule(module->getModule(),
+                                       toolchain.targetMachine());
+  }
+  auto compiled = std::chrono::steady_clock::now();
+  benchmark.codegen.nanoseconds.push_back(nanosecondsBetween(start, compiled));
+}
+
+static void print(raw_ostream &out, const MutatorBenchmark &benchmark) {
+  auto points = benchmark.points;
+  auto search = benchmark.search.mean();
+  out << benchmark.mutator << ": " << points << " points, search "
+      << format("%.3f", milliseconds(search)) << "ms ("
+      << format("%.0f", search == 0 ? 0 : points * 1e9 / search)
+      << " points/s), prepare "
+      << format("%.3f", milliseconds(benchmark.prepare.mean())) << "ms ("
+      << format("%.0f", perPoint(benchmark.meanCloneBytes(), points))
+      << " bytes cloned/mutant), apply "
+      << format("%.3f", milliseconds(benchmark.apply.mean())) << "ms, codegen "
+      << format("%.3f", milliseconds(benchmark.codegen.mean())) << "ms ("
+      << format("%.3f",
+                milliseconds(perPoint(benchmark.codegen.mean(), points)))
+      << "ms/mutant)" << (benchmark.valid ? "" : " (invalid module)") << "\n";
+}
+
+/// An entry of the Google Benchmark layout, with the minimum and the
+/// maximum added, see mull-benchmarks
+static void writeStage(raw_ostream &out, const MutatorBenchmark &benchmark,
+                       const char *name, const Stage &stage, bool first) {
+  out << (first ? "\n" : ",\n") << "    {\"name\": \"" << benchmark.mutator
+      << "/" << name << "\", \"run_type\": \"iteration\", \"iterations\": "
+      << stage.nanoseconds.size()
+      << ", \"real_time\": " << format("%.6f", milliseconds(stage.mean()))
+      << ", \"min_time\": " << format("%.6f", milliseconds(stage.min()))
+      << ", \"max_time\": " << format("%.6f", milliseconds(stage.max()))
+      << ", \"time_unit\": \"ms\", \"items\": " << benchmark.points
+      << ", \"time_per_item\": "
+      << format("%.6f", milliseconds(perPoint(stage.mean(), benchmark.points)));
+}
+
+static void writeJSON(raw_ostream &out,
+                      const std::vector<MutatorBenchmark> &benchmarks) {
+  char date[64] = {0};
+  auto now = std::time(nullptr);
+  std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+  out << "{\n"
+      << "  \"context\": {\n"
+      << "    \"date\": \"" << date << "\",\n"
+      << "    \"executable\": \"mull-mutator-validator\",\n"
+      << "    \"mull_version\": \"" << mull::mullVersionString() << "\",\n"
+      << "    \"mull_commit\": \"" << mull::mullCommitString() << "\",\n"
+      << "    \"llvm_version\": \"" << mull::llvmVersionString() << "\",\n"
+      << "    \"bitcode\": \"" << BitcodePath << "\",\n"
+      << "    \"mutators\": \"" << MutatorGroup << "\"\n"
+      << "  },\n"
+      << "  \"benchmarks\": [";
+  bool first = true;
+  for (auto &benchmark : benchmarks) {
+    auto search = benchmark.search.mean();
+    writeStage(out, benchmark, "search", benchmark.search, first);
+    out << ", \"items_per_second\": "
+        << format("%.3f", search == 0 ? 0 : benchmark.points * 1e9 / search)
+        << "}";
+    writeStage(out, benchmark, "prepare", benchmark.prepare, false);
+    out << ", \"clone_bytes\": " << benchmark.meanCloneBytes()
+        << ", \"clone_bytes_per_item\": "
+        << format("%.1f", perPoint(benchmark.meanCloneBytes(),
+                                   benchmark.points))
+        << "}";
+    writeStage(out, benchmark, "apply", benchmark.apply, false);
+    out << "}";
+    writeStage(out, benchmark, "codegen", benchmark.codegen, false);
+    out << ", \"valid\": " << (benchmark.valid ? "true" : "false") << "}";
+    first = false;
+  }
+  out << "\n  ]\n"
+      << "}\n";
+}
 
+/// Measures each mutator of the group on its own: how long it takes to find
+/// its points, to clone the functions they mutate and how much memory the
+/// clones take, to apply it, and to compile the mutated module. The mutated
+/// module must pass the verifier.
+int main(int argc, char **argv) {
+  cl::ParseCommandLineOptions(argc, argv,
+                              "Validates and benchmarks the mutators");
+  if (Iterations < 1) {
+    errs() << "-iterations must be at least 1\n";
+    return 1;
+  }
+
+  InitializeNativeTarget();
+  InitializeNativeTargetAsmPrinter();
+  InitializeNativeTargetAsmParser();
+
+  std::vector<MutatorBenchmark> benchmarks;
+  mull::MutatorsFactory factory;
+  for (auto &mutator : factory.mutators({MutatorGroup})) {
+    benchmarks.emplace_back();
+    benchmarks.back().mutator = mutator->getUniqueIdentifier();
+  }
+  if (benchmarks.empty()) {
+    return 1;
+  }
+
+  mull::Configuration configuration;
   mull::Toolchain toolchain(configuration);
-  mull::SingleTaskExecutor compileMutants("Compiling mutants", [&] {
-    for (auto &module : program.modules()) {
-      assert(!llvm::verifyModule(*module->getModule(), &llvm::errs()));
-      toolchain.compiler().compileModule(module->getModule(),
-                                         toolchain.targetMachine());
+  bool valid = true;
+  for (auto &benchmark : benchmarks) {
+    for (int iteration = 0; iteration < Iterations; iteration++) {
+      measure(benchmark, toolchain);
+    }
+    print(outs(), benchmark);
+    valid = valid && benchmark.valid;
+  }
+
+  if (!JSONPath.empty()) {
+    std::error_code code;
+    raw_fd_ostream json(JSONPath, code, sys::fs::F_None);
+    if (code) {
+      errs() << "Cannot write " << JSONPath << ": " << code.message() << "\n";
+      return 1;
     }
-  });
-  compileMutants.execute();
+    writeJSON(json, benchmarks);
+  }
 
-  return 0;
+  return valid ? 0 : 1;
 }
@@ -0,0 +1,350 @@
+#include <llvm/AsmParser/Parser.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/CommandLine.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/SourceMgr.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include "LLVMCompatibility.h"
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace llvm;
+
+static cl::opt<std::string> Output("output", cl::Required,
+                                   cl::desc("The directory the bitcode and "
+                                            "the config are written to"),
+                                   cl::value_desc("directory"));
+
+static cl::opt<int> Modules("modules", cl::Optional,
+                            cl::desc("How many modules the program has"),
+                            cl::init(10));
+
+static cl::opt<int> Functions("functions", cl::Optional,
+                              cl::desc("How many functions each module has"),
+                              cl::init(20));
+
+static cl::opt<int> Depth("depth", cl::Optional,
+                          cl::desc("How many functions each call chain of a "
+                                   "module goes through"),
+                          cl::init(4));
+
+static cl::opt<int> Tests("tests", cl::Optional,
+                          cl::desc("How many tests the program has, each test "
+                                   "calls the head of one call chain"),
+                          cl::init(50));
+
+static cl::opt<int> Mutations("mutations", cl::Optional,
+                              cl::desc("How many mutable arithmetic "
+                                       "instructions each function has"),
+                              cl::init(3));
+
+static cl::opt<int> Spin("spin", cl::Optional,
+                         cl::desc("The mean of the iterations a test spins "
+                                  "before it calls the program"),
+                         cl::init(100000));
+
+enum class RuntimeDistribution { Constant, Uniform, Exponential };
+static cl::opt<RuntimeDistribution> Distribution(
+    "runtime-distribution", cl::Optional,
+    cl::desc("How the iterations of the tests are distributed around -spin"),
+    cl::values(clEnumValN(RuntimeDistribution::Constant, "constant",
+                          "Every test spins -spin iterations"),
+               clEnumValN(RuntimeDistribution::Uniform, "uniform",
+                          "From 0 to twice -spin iterations"),
+               clEnumValN(RuntimeDistribution::Exponential, "exponential",
+                          "A few long tests among many short ones")),
+    cl::init(RuntimeDistribution::Constant));
+
+static cl::opt<unsigned> Seed("seed", cl::Optional,
+                              cl::desc("The same seed gives the same program"),
+                              cl::init(1));
+
+static cl::opt<int> Workers("workers", cl::Optional,
+                            cl::desc("The workers the config asks for, the "
+                                     "number of cores by default"),
+                            cl::init(0));
+
+/// std::mt19937 yields the same numbers everywhere, the distributions of the
+/// standard library do not, so the numbers are drawn by hand
+class Random {
+public:
+  explicit Random(unsigned seed) : engine(seed) {}
+
+  uint32_t below(uint32_t bound) { return engine() % bound; }
+  double unit() { return double(engine()) / 4294967296.0; }
+
+private:
+  std::mt19937 engine;
+};
+
+/// An arithmetic instruction of a function, applied to the running value
+struct Operation {
+  const char *opcode;
+  uint32_t constant;
+
+  uint32_t apply(uint32_t value) const {
+    if (opcode[0] == 'a') {
+      return value + constant;
+    }
+    if (opcode[0] == 's') {
+      return value - constant;
+    }
+    return value * constant;
+  }
+};
+
+static std::string functionName(int module, int function) {
+  return "workload_" + std::to_string(module) + "_" + std::to_string(function);
+}
+
+static bool isChainHead(int function) { return function % Depth == 0; }
+
+static bool isChainEnd(int function) {
+  return function == Functions - 1 || isChainHead(function + 1);
+}
+
+/// The operations of every function of a module, drawn up front so that the
+/// expected results of the tests can be computed
+static std::vector<std::vector<Operation>> drawOperations(Random &random) {
+  static const char *opcodes[] = {"add", "sub", "mul"};
+  std::vector<std::vector<Operation>> operations(Functions);
+  for (auto &function : operations) {
+    for (int index = 0; index < Mutations; index++) {
+      Operation operation;
+      operation.opcode = opcodes[random.below(3)];
+      operation.constant = 1 + random.below(97);
+      /// An odd factor keeps every bit of the value alive
+      if (operation.opcode[0] == 'm') {
+        operation.constant |= 1;
+        if (operation.constant == 1) {
+          operation.constant = 3;
+        }
+      }
+      function.push_back(operation);
+    }
+  }
+  return operations;
+}
+
+/// What the chain starting at the head returns for the input
+static uint32_t evaluateChain(const std::vector<std::vector<Operation>> &module,
+                              int head, uint32_t input) {
+  uint32_t value = input;
+  for (int function = head;; function++) {
+    for (auto &operation : module[function]) {
+      value = operation.apply(value);
+    }
+    if (isChainEnd(function)) {
+      return value;
+    }
+  }
+}
+
+static std::string
+moduleAssembly(int module, const std::vector<std::vector<Operation>> &ops) {
+  std::string assembly;
+  raw_string_ostream ir(assembly);
+  for (int function = 0; function < Functions; function++) {
+    ir << "define i32 @" << functionName(module, function) << "(i32 %x0) {\n"
+       << "entry:\n";
+    int index = 0;
+    for (auto &operation : ops[function]) {
+      ir << "  %x" << index + 1 << " = " << operation.opcode << " i32 %x"
+         << index << ", " << operation.constant << "\n";
+      index++;
+    }
+    if (isChainEnd(function)) {
+      ir << "  ret i32 %x" << index << "\n";
+    } else {
+      ir << "  %r = call i32 @" << functionName(module, function + 1)
+         << "(i32 %x" << index << ")\n"
+         << "  ret i32 %r\n";
+    }
+    ir << "}\n\n";
+  }
+  return ir.str();
+}
+
+/// The test spins on a volatile counter so that the optimizer keeps the
+/// loop, calls the chain and fails unless the chain gives what it should.
+/// The counter steps through a getelementptr, which no mutator touches, so
+/// that the mutants of the test itself cannot make the loop endless
+static void testAssembly(raw_ostream &ir, int test, const std::string &head,
+                         uint32_t input, uint32_t expected,
+                         uint64_t iterations) {
+  ir << "define i32 @workload_test_" << test << "(i32 %argc, i8** %argv) {\n"
+     << "entry:\n"
+     << "  br label %loop\n"
+     << "loop:\n"
+     << "  %i = phi i8* [ null, %entry ], [ %next, %loop ]\n"
+     << "  store volatile i8* %i, i8** @workload_counter\n"
+     << "  %next = getelementptr i8, i8* %i, i64 1\n"
+     << "  %spinning = icmp ult i8* %next, inttoptr (i64 " << iterations
+     << " to i8*)\n"
+     << "  br i1 %spinning, label %loop, label %done\n"
+     << "done:\n"
+     << "  %result = call i32 @" << head << "(i32 " << input << ")\n"
+     << "  %failed = icmp ne i32 %result, " << expected << "\n"
+     << "  %status = zext i1 %failed to i32\n"
+     << "  ret i32 %status\n"
+     << "}\n\n";
+}
+
+static uint64_t drawIterations(Random &random) {
+  switch (Distribution) {
+  case RuntimeDistribution::Constant:
+    return Spin;
+  case RuntimeDistribution::Uniform:
+    return random.below(2 * uint32_t(Spin) + 1);
+  case RuntimeDistribution::Exponential:
+    return uint64_t(-double(Spin) * std::log(1.0 - random.unit()));
+  }
+  return Spin;
+}
+
+static bool writeBitcode(const std::string &path, const std::string &assembly) {
+  LLVMContext context;
+  SMDiagnostic diagnostic;
+  auto module = parseAssemblyString(assembly, diagnostic, context);
+  if (!module) {
+    errs() << "Cannot generate " << path << ": " << diagnostic.getMessage()
+           << "\n";
+    return false;
+  }
+
+  std::error_code code;
+  raw_fd_ostream file(path, code, sys::fs::F_None);
+  if (code) {
+    errs() << "Cannot write " << path << ": " << code.message() << "\n";
+    return false;
+  }
+  llvm_compat::writeBitcode(*module, file);
+  return true;
+}
+
+static bool writeFile(const std::string &path, const std::string &content) {
+  std::error_code code;
+  raw_fd_ostream file(path, code, sys::fs::F_None);
+  if (code) {
+    errs() << "Cannot write " << path << ": " << code.message() << "\n";
+    return false;
+  }
+  file << content;
+  return true;
+}
+
+int main(int argc, char **argv) {
+  cl::ParseCommandLineOptions(argc, argv,
+                              "Generates programs of a given shape for the "
+                              "scaling benchmarks of mull");
+  if (Modules < 1 || Functions < 1 || Depth < 1 || Tests < 0 ||
+      Mutations < 0 || Spin < 0) {
+    errs() << "The program needs a module, a function and a depth\n";
+    return 1;
+  }
+
+  SmallString<256> directory(Output);
+  sys::fs::make_absolute(directory);
+  auto error = sys::fs::create_directories(directory);
+  if (error) {
+    errs() << "Cannot create " << directory << ": " << error.message() << "\n";
+    return 1;
+  }
+
+  Random random(Seed);
+  std::vector<std::string> bitcodePaths;
+  std::vector<std::vector<std::vector<Operation>>> operations;
+  for (int module = 0; module < Modules; module++) {
+    operations.push_back(drawOperations(random));
+    auto path = directory.str().str() + "/workload_" + std::to_string(module) +
+                ".bc";
+    if (!writeBitcode(path, moduleAssembly(module, operations.back()))) {
+      return 1;
+    }
+    bitcodePaths.push_back(path);
+  }
+
+  /// The tests go round the heads of the chains of every module
+  std::vector<std::pair<int, int>> heads;
+  for (int function = 0; function < Functions; function++) {
+    for (int module = 0; module < Modules; module++) {
+      if (isChainHead(function)) {
+        heads.emplace_back(module, function);
+      }
+    }
+  }
+
+  std::string assembly;
+  raw_string_ostream tests(assembly);
+  tests << "@workload_counter = global i8* null\n\n";
+  for (auto &head : heads) {
+    tests << "declare i32 @" << functionName(head.first, head.second)
+          << "(i32)\n";
+  }
+  tests << "\n";
+  uint64_t totalIterations = 0;
+  for (int test = 0; test < Tests; test++) {
+    auto &head = heads[test % heads.size()];
+    uint32_t input = uint32_t(test) + 1;
+    uint32_t expected =
+        evaluateChain(operations[head.first], head.second, input);
+    auto iterations = drawIterations(random);
+    totalIterations += iterations;
+    testAssembly(tests, test, functionName(head.first, head.second), input,
+                 expected, iterations);
+  }
+  auto testsPath = directory.str().str() + "/workload_tests.bc";
+  if (!writeBitcode(testsPath, tests.str())) {
+    return 1;
+  }
+  bitcodePaths.push_back(testsPath);
+
+  std::string bitcodeList;
+  for (auto &path : bitcodePaths) {
+    bitcodeList += path + "\n";
+  }
+  auto listPath = directory.str().str() + "/bitcode.list";
+  if (!writeFile(listPath, bitcodeList)) {
+    return 1;
+  }
+
+  /// The distance lets every function of a chain be reached by its test
+  std::string config;
+  raw_string_ostream yaml(config);
+  yaml << "bitcode_file_list: " << listPath << "\n"
+       << "project_name: workload\n"
+       << "test_framework: CustomTest\n"
+       << "max_distance: " << Depth << "\n"
+       << "mutators:\n"
+       << "  - math_add_mutator\n"
+       << "  - math_sub_mutator\n"
+       << "  - math_mul_mutator\n";
+  if (Workers > 0) {
+    yaml << "parallelization:\n"
+         << "  workers: " << Workers << "\n";
+  }
+  yaml << "custom_tests:\n";
+  for (int test = 0; test < Tests; test++) {
+    auto name = "workload_test_" + std::to_string(test);
+    yaml << "  - name: " << name << "\n"
+         << "    method: " << name << "\n"
+         << "    arguments: [ \"" << name << "\" ]\n";
+  }
+  auto configPath = directory.str().str() + "/mull.yml";
+  if (!writeFile(configPath, yaml.str())) {
+    return 1;
+  }
+
+  outs() << "Generated " << Modules << " modules of " << Functions
+         << " functions, " << heads.size() << " call chains, " << Tests
+         << " tests spinning " << totalIterations << " iterations in total, "
+         << Modules * Functions * Mutations << " mutable instructions\n"
+         << "Config: " << configPath << "\n";
+  return 0;
+}